@@ -57,6 +57,10 @@ for f in $sources; do
     else
       echo "Skipping gen/bin/example-$f; run \"wuffs genlib\" first"
     fi
+  elif [ $f = "mzcat" ]; then
+    # example/mzcat is unusual in that it uses multiple threads.
+    echo "Building gen/bin/example-$f"
+    $CXX -O3            example/$f/*.cc -pthread -o gen/bin/example-$f
   elif [ -e example/$f/*.c ]; then
     echo "Building gen/bin/example-$f"
     $CC  -O3            example/$f/*.c  -o gen/bin/example-$f
@@ -404,26 +404,10 @@ redirect:
 void  //
 fill_rectangle(wuffs_base__rect_ie_u32 rect,
                wuffs_base__color_u32_argb_premul color) {
-  if (rect.max_excl_x > g_width) {
-    rect.max_excl_x = g_width;
-  }
-  if (rect.max_excl_y > g_height) {
-    rect.max_excl_y = g_height;
-  }
-  uint32_t nonpremul =
-      wuffs_base__color_u32_argb_premul__as__color_u32_argb_nonpremul(color);
-  wuffs_base__table_u8 tab = wuffs_base__pixel_buffer__plane(&g_pixbuf, 0);
-
-  uint32_t y;
-  for (y = rect.min_incl_y; y < rect.max_excl_y; y++) {
-    uint8_t* p =
-        tab.ptr + (y * tab.stride) + (rect.min_incl_x * BYTES_PER_PIXEL);
-    uint32_t x;
-    for (x = rect.min_incl_x; x < rect.max_excl_x; x++) {
-      wuffs_base__poke_u32le__no_bounds_check(p, nonpremul);
-      p += BYTES_PER_PIXEL;
-    }
-  }
+  wuffs_base__rect_ie_u32 bounds =
+      wuffs_base__pixel_config__bounds(&g_pixbuf.pixcfg);
+  wuffs_base__pixel_buffer__set_color_u32_fill_rect(
+      &g_pixbuf, wuffs_base__rect_ie_u32__intersect(&bounds, rect), color);
 }
 
 void  //
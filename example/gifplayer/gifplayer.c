@@ -200,20 +200,15 @@ parse_flags(int argc, char** argv) {
 
 const char* g_reset_color = "\x1B[0m";
 
-void  //
+wuffs_base__status  //
 restore_background(wuffs_base__pixel_buffer* pb,
                    wuffs_base__rect_ie_u32 bounds,
                    wuffs_base__color_u32_argb_premul background_color) {
-  size_t width4 = (size_t)(wuffs_base__pixel_config__width(&pb->pixcfg)) * 4;
-  size_t y;
-  for (y = bounds.min_incl_y; y < bounds.max_excl_y; y++) {
-    size_t x;
-    uint8_t* d = g_curr_dst_buffer + (y * width4) + (bounds.min_incl_x * 4);
-    for (x = bounds.min_incl_x; x < bounds.max_excl_x; x++) {
-      wuffs_base__poke_u32le__no_bounds_check(d, background_color);
-      d += sizeof(wuffs_base__color_u32_argb_premul);
-    }
-  }
+  wuffs_base__rect_ie_u32 pb_bounds =
+      wuffs_base__pixel_config__bounds(&pb->pixcfg);
+  return wuffs_base__pixel_buffer__set_color_u32_fill_rect(
+      pb, wuffs_base__rect_ie_u32__intersect(&pb_bounds, bounds),
+      background_color);
 }
 
 size_t  //
@@ -404,14 +399,11 @@ play() {
     }
 
     if (wuffs_base__frame_config__index(&fc) == 0) {
-      wuffs_base__color_u32_argb_premul background_color =
-          wuffs_base__frame_config__background_color(&fc);
-      size_t i;
-      size_t n = g_dst_len / sizeof(wuffs_base__color_u32_argb_premul);
-      uint8_t* p = g_curr_dst_buffer;
-      for (i = 0; i < n; i++) {
-        wuffs_base__poke_u32le__no_bounds_check(p, background_color);
-        p += sizeof(wuffs_base__color_u32_argb_premul);
+      wuffs_base__status rb0_status = restore_background(
+          &g_pb, wuffs_base__pixel_config__bounds(&g_ic.pixcfg),
+          wuffs_base__frame_config__background_color(&fc));
+      if (!wuffs_base__status__is_ok(&rb0_status)) {
+        return wuffs_base__status__message(&rb0_status);
       }
     }
 
@@ -436,8 +428,12 @@ play() {
 
     switch (wuffs_base__frame_config__disposal(&fc)) {
       case WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_BACKGROUND: {
-        restore_background(&g_pb, wuffs_base__frame_config__bounds(&fc),
-                           wuffs_base__frame_config__background_color(&fc));
+        wuffs_base__status rb1_status = restore_background(
+            &g_pb, wuffs_base__frame_config__bounds(&fc),
+            wuffs_base__frame_config__background_color(&fc));
+        if (!wuffs_base__status__is_ok(&rb1_status)) {
+          return wuffs_base__status__message(&rb1_status);
+        }
         break;
       }
       case WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_PREVIOUS: {
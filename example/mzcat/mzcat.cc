@@ -0,0 +1,177 @@
+// Copyright 2021 The Wuffs Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// ----------------
+
+/*
+mzcat decodes gzip'ed data to stdout, like example/zcat, but it uses multiple
+threads, via the wuffs_aux::DecodeDeflate function. It reads the entire input
+from stdin into memory, splits it into chunks and decodes those chunks in
+parallel. Unlike example/zcat, it does not self-impose a sandbox, since
+SECCOMP_MODE_STRICT does not permit creating threads (or allocating memory).
+To run:
+
+$CXX mzcat.cc -pthread && ./a.out < ../../test/data/romeo.txt.gz; rm -f a.out
+
+for a C++ compiler $CXX, such as clang++ or g++.
+
+The -threads=N flag sets the maximum number of threads. It defaults to the
+number of hardware threads. With -threads=1, decoding is a single streaming
+pass, like example/zcat.
+*/
+
+#if defined(__cplusplus) && (__cplusplus < 201103L)
+#error "This C++ program requires -std=c++11 or later"
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+
+// Wuffs ships as a "single file C library" or "header file library" as per
+// https://github.com/nothings/stb/blob/master/docs/stb_howto.txt
+//
+// To use that single file as a "foo.c"-like implementation, instead of a
+// "foo.h"-like header, #define WUFFS_IMPLEMENTATION before #include'ing or
+// compiling it.
+#define WUFFS_IMPLEMENTATION
+
+// Defining the WUFFS_CONFIG__MODULE* macros are optional, but it lets users of
+// release/c/etc.c choose which parts of Wuffs to build. That file contains the
+// entire Wuffs standard library, implementing a variety of codecs and file
+// formats. Without this macro definition, an optimizing compiler or linker may
+// very well discard Wuffs code for unused codecs, but listing the Wuffs
+// modules we use makes that process explicit. Preprocessing means that such
+// code simply isn't compiled.
+#define WUFFS_CONFIG__MODULES
+#define WUFFS_CONFIG__MODULE__ADLER32
+#define WUFFS_CONFIG__MODULE__AUX__BASE
+#define WUFFS_CONFIG__MODULE__AUX__DEFLATE
+#define WUFFS_CONFIG__MODULE__BASE
+#define WUFFS_CONFIG__MODULE__CRC32
+#define WUFFS_CONFIG__MODULE__DEFLATE
+#define WUFFS_CONFIG__MODULE__GZIP
+#define WUFFS_CONFIG__MODULE__ZLIB
+
+// If building this program in an environment that doesn't easily accommodate
+// relative includes, you can use the script/inline-c-relative-includes.go
+// program to generate a stand-alone C++ file.
+#include "../../release/c/wuffs-unsupported-snapshot.c"
+
+struct {
+  int remaining_argc;
+  char** remaining_argv;
+
+  uint32_t threads;
+} g_flags = {0};
+
+const char*  //
+parse_flags(int argc, char** argv) {
+  g_flags.threads = std::thread::hardware_concurrency();
+
+  int c = (argc > 0) ? 1 : 0;  // Skip argv[0], the program name.
+  for (; c < argc; c++) {
+    char* arg = argv[c];
+    if (*arg++ != '-') {
+      break;
+    }
+
+    // A double-dash "--foo" is equivalent to a single-dash "-foo". As special
+    // cases, a bare "-" is not a flag (some programs may interpret it as
+    // stdin) and a bare "--" means to stop parsing flags.
+    if (*arg == '\x00') {
+      break;
+    } else if (*arg == '-') {
+      arg++;
+      if (*arg == '\x00') {
+        c++;
+        break;
+      }
+    }
+
+    if (!strncmp(arg, "threads=", 8)) {
+      wuffs_base__result_u64 u = wuffs_base__parse_number_u64(
+          wuffs_base__make_slice_u8((uint8_t*)arg + 8, strlen(arg + 8)),
+          WUFFS_BASE__PARSE_NUMBER_XXX__DEFAULT_OPTIONS);
+      if (u.status.is_ok() && (u.value <= 1024)) {
+        g_flags.threads = (uint32_t)(u.value);
+        continue;
+      }
+      return "main: bad -threads=N flag argument";
+    }
+
+    return "main: unrecognized flag argument";
+  }
+
+  g_flags.remaining_argc = argc - c;
+  g_flags.remaining_argv = argv + c;
+  return nullptr;
+}
+
+// ----
+
+// ignore_return_value suppresses errors from -Wall -Werror.
+static void  //
+ignore_return_value(int ignored) {}
+
+class Callbacks : public wuffs_aux::DecodeDeflateCallbacks {
+ public:
+  std::string Append(const uint8_t* ptr, size_t len) override {
+    // TODO: handle EINTR and other write errors; see "man 2 write".
+    const int stdout_fd = 1;
+    ignore_return_value(write(stdout_fd, ptr, len));
+    return "";
+  }
+};
+
+std::string  //
+main1() {
+  Callbacks callbacks;
+  wuffs_aux::sync_io::FileInput input(stdin);
+  return wuffs_aux::DecodeDeflate(callbacks, input, WUFFS_BASE__FOURCC__GZ,
+                                  g_flags.threads)
+      .error_message;
+}
+
+int  //
+compute_exit_code(std::string status_msg) {
+  if (status_msg.empty()) {
+    return 0;
+  }
+  fprintf(stderr, "%s\n", status_msg.c_str());
+  // Return an exit code of 1 for regular (foreseen) errors, e.g. badly
+  // formatted or unsupported input.
+  //
+  // Return an exit code of 2 for internal (exceptional) errors, e.g. defensive
+  // run-time checks found that an internal invariant did not hold.
+  //
+  // Automated testing, including badly formatted inputs, can therefore
+  // discriminate between expected failure (exit code 1) and unexpected failure
+  // (other non-zero exit codes). Specifically, exit code 2 for internal
+  // invariant violation, exit code 139 (which is 128 + SIGSEGV on x86_64
+  // linux) for a segmentation fault (e.g. null pointer dereference).
+  return (status_msg.find("internal error:") != std::string::npos) ? 2 : 1;
+}
+
+int  //
+main(int argc, char** argv) {
+  const char* z = parse_flags(argc, argv);
+  if (z) {
+    return compute_exit_code(z);
+  }
+  return compute_exit_code(main1());
+}
@@ -99,6 +99,43 @@ allocate_guarded_page(uint8_t** ptr_out, int page_size) {
   return NULL;
 }
 
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+
+// simd_funcs pairs each x86 SIMD swizzler func with its portable equivalent.
+// The SIMD version should produce exactly the same output. The src_over
+// funcs' SIMD versions are only exact for valid premultiplied source pixels,
+// where no color channel exceeds its alpha, so those inputs are clamped first.
+const struct {
+  wuffs_base__pixel_swizzler__func simd;
+  wuffs_base__pixel_swizzler__func scalar;
+  bool clamp_src_to_premul;
+} simd_funcs[] = {
+#define SIMD_FUNC(name, suffix, clamp)                                       \
+  {wuffs_base__pixel_swizzler__##name##__##suffix,                           \
+   wuffs_base__pixel_swizzler__##name, clamp}
+    SIMD_FUNC(bgra_premul__bgra_nonpremul__src, avx2, false),
+    SIMD_FUNC(bgra_premul__bgra_nonpremul_4x16le__src, avx2, false),
+    SIMD_FUNC(bgra_premul__bgra_premul__src_over, avx2, true),
+    SIMD_FUNC(bgra_premul__bgra_premul__src_over, sse42, true),
+    SIMD_FUNC(bgra_premul__rgba_nonpremul__src, avx2, false),
+    SIMD_FUNC(bgra_premul__rgba_nonpremul_4x16le__src, avx2, false),
+    SIMD_FUNC(bgrw__bgr, avx2, false),
+    SIMD_FUNC(bgrw__bgrx, avx2, false),
+    SIMD_FUNC(bgrw__rgb, avx2, false),
+    SIMD_FUNC(bgrw__rgb, sse42, false),
+    SIMD_FUNC(swap_rgbx_bgrx, avx2, false),
+    SIMD_FUNC(swap_rgbx_bgrx, sse42, false),
+    SIMD_FUNC(xxxx__index__src, avx2, false),
+    SIMD_FUNC(xxxx__index__src, sse42, false),
+    SIMD_FUNC(xxxx__index_binary_alpha__src_over, avx2, false),
+    SIMD_FUNC(xxxx__y, avx2, false),
+    SIMD_FUNC(xxxx__y, sse42, false),
+    SIMD_FUNC(xxxx__y_16be, avx2, false),
+#undef SIMD_FUNC
+};
+
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+
 // fuzz tests that, regardless of the randomized inputs, calling
 // wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice will not crash
 // the fuzzer (e.g. due to reads or write past buffer bounds).
@@ -172,10 +209,42 @@ fuzz(wuffs_base__io_buffer* src, uint64_t hash) {
   memcpy(src_slice.ptr, src->data.ptr + src->meta.ri, src_len);
   src->meta.ri += src_len;
 
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+  // If the swizzler picked a SIMD func, run its portable equivalent on a copy
+  // of dst, for comparison below.
+  uint8_t want_array[0x100];
+  wuffs_base__pixel_swizzler__func scalar = NULL;
+  size_t num_simd_funcs = sizeof(simd_funcs) / sizeof(simd_funcs[0]);
+  for (size_t i = 0; i < num_simd_funcs; i++) {
+    if (swizzler.private_impl.func != simd_funcs[i].simd) {
+      continue;
+    }
+    scalar = simd_funcs[i].scalar;
+    if (simd_funcs[i].clamp_src_to_premul) {
+      for (size_t j = 0; (j + 4) <= src_len; j += 4) {
+        uint8_t* s = src_slice.ptr + j;
+        s[0] = wuffs_base__u8__min(s[0], s[3]);
+        s[1] = wuffs_base__u8__min(s[1], s[3]);
+        s[2] = wuffs_base__u8__min(s[2], s[3]);
+      }
+    }
+    memcpy(want_array, dst_slice.ptr, dst_len);
+    (*scalar)(want_array, dst_len, dst_palette.ptr, dst_palette.len,
+              src_slice.ptr, src_len);
+    break;
+  }
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+
   // Calling etc__swizzle_interleaved_from_slice should not crash, whether for
   // reading/writing out of bounds or for other reasons.
   wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(
       &swizzler, dst_slice, dst_palette, src_slice);
 
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+  if (scalar && memcmp(want_array, dst_slice.ptr, dst_len)) {
+    return "fuzz: internal error: SIMD and portable swizzlers differ";
+  }
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+
   return NULL;
 }
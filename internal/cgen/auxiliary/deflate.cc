@@ -0,0 +1,1927 @@
+// After editing this file, run "go generate" in the ../data directory.
+
+// Copyright 2021 The Wuffs Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// ---------------- Auxiliary - Deflate
+
+#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__AUX__DEFLATE)
+
+#include <thread>
+#include <utility>
+#include <vector>
+
+// WUFFS_AUX__DECODE_DEFLATE__CHUNK_LENGTH is the number of compressed bytes
+// that each thread starts with, when decoding in parallel.
+#ifndef WUFFS_AUX__DECODE_DEFLATE__CHUNK_LENGTH
+#define WUFFS_AUX__DECODE_DEFLATE__CHUNK_LENGTH (1024 * 1024)
+#endif
+
+// WUFFS_AUX__DECODE_DEFLATE__MAX_SPECULATIVE_LENGTH is the maximum number of
+// decoded bytes that each thread buffers, when decoding in parallel. Chunks
+// that decode to more than this are instead decoded single-threaded.
+#ifndef WUFFS_AUX__DECODE_DEFLATE__MAX_SPECULATIVE_LENGTH
+#define WUFFS_AUX__DECODE_DEFLATE__MAX_SPECULATIVE_LENGTH (64 * 1024 * 1024)
+#endif
+
+// WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH is the approximate maximum
+// number of decoded bytes, per thread, that DecodeGzipMembers buffers at a
+// time. Members that decode to more than this are decoded single-threaded.
+#ifndef WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH
+#define WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH (4 * 1024 * 1024)
+#endif
+
+namespace wuffs_aux {
+
+DecodeDeflateResult::DecodeDeflateResult(std::string&& error_message0,
+                                         uint64_t num_dst_bytes0)
+    : error_message(std::move(error_message0)),
+      num_dst_bytes(num_dst_bytes0) {}
+
+DecodeDeflateCallbacks::~DecodeDeflateCallbacks() {}
+
+void  //
+DecodeDeflateCallbacks::Done(DecodeDeflateResult& result,
+                             sync_io::Input& input) {}
+
+const char DecodeDeflate_BadChecksum[] =  //
+    "wuffs_aux::DecodeDeflate: bad checksum";
+const char DecodeDeflate_BadHeader[] =  //
+    "wuffs_aux::DecodeDeflate: bad header";
+const char DecodeDeflate_OutOfMemory[] =  //
+    "wuffs_aux::DecodeDeflate: out of memory";
+const char DecodeDeflate_UnexpectedEndOfFile[] =  //
+    "wuffs_aux::DecodeDeflate: unexpected end of file";
+const char DecodeDeflate_UnsupportedFraming[] =  //
+    "wuffs_aux::DecodeDeflate: unsupported framing";
+
+// --------
+
+namespace {
+
+// DecodeDeflateNoPosition is a sentinel bit position.
+const uint64_t DecodeDeflateNoPosition = UINT64_MAX;
+
+const size_t DecodeDeflateScratchLength = 65536;
+
+// DecodeDeflateFill reads more of the input into io_buf, returning an error
+// message (possibly DecodeDeflate_UnexpectedEndOfFile) if it cannot.
+std::string  //
+DecodeDeflateFill(sync_io::Input& input, wuffs_base__io_buffer* io_buf) {
+  if (io_buf->meta.closed) {
+    return DecodeDeflate_UnexpectedEndOfFile;
+  }
+  io_buf->compact();
+  return input.CopyIn(io_buf);
+}
+
+// DecodeDeflateStream runs dec, reading from io_buf (refilled from input),
+// until dec reaches the end of its stream. The output goes through the dst
+// scratch buffer to callbacks.Append.
+std::string  //
+DecodeDeflateStream(DecodeDeflateCallbacks& callbacks,
+                    sync_io::Input& input,
+                    wuffs_base__io_buffer* io_buf,
+                    wuffs_base__io_transformer* dec,
+                    wuffs_base__io_buffer* dst,
+                    uint64_t* num_dst_bytes) {
+  uint8_t work_array[1];
+  while (true) {
+    dst->meta.wi = 0;
+    wuffs_base__status status = dec->transform_io(
+        dst, io_buf, wuffs_base__make_slice_u8(work_array, 0));
+    if (dst->meta.wi > 0) {
+      std::string error_message =
+          callbacks.Append(dst->data.ptr, dst->meta.wi);
+      *num_dst_bytes += dst->meta.wi;
+      if (!error_message.empty()) {
+        return error_message;
+      }
+    }
+
+    if (status.is_ok()) {
+      return "";
+    } else if (status.repr == wuffs_base__suspension__short_read) {
+      std::string error_message = DecodeDeflateFill(input, io_buf);
+      if (!error_message.empty()) {
+        return error_message;
+      }
+    } else if (status.repr != wuffs_base__suspension__short_write) {
+      return status.message();
+    }
+  }
+}
+
+DecodeDeflateResult  //
+DecodeDeflateSerial(DecodeDeflateCallbacks& callbacks,
+                    sync_io::Input& input,
+                    uint32_t framing,
+                    bool ignore_checksum) {
+  wuffs_base__io_transformer::unique_ptr dec(nullptr, &free);
+  switch (framing) {
+    case 0:
+      dec = wuffs_deflate__decoder::alloc_as__wuffs_base__io_transformer();
+      break;
+    case WUFFS_BASE__FOURCC__GZ:
+      dec = wuffs_gzip__decoder::alloc_as__wuffs_base__io_transformer();
+      break;
+    case WUFFS_BASE__FOURCC__ZLIB:
+      dec = wuffs_zlib__decoder::alloc_as__wuffs_base__io_transformer();
+      break;
+    default:
+      return DecodeDeflateResult(DecodeDeflate_UnsupportedFraming, 0);
+  }
+  if (!dec) {
+    return DecodeDeflateResult(DecodeDeflate_OutOfMemory, 0);
+  }
+  dec->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, ignore_checksum);
+
+  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
+  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
+  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
+  if (!io_buf) {
+    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);
+    fallback_io_buf =
+        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);
+    io_buf = &fallback_io_buf;
+  }
+
+  std::unique_ptr<uint8_t[]> dst_array(
+      new uint8_t[DecodeDeflateScratchLength]);
+  wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(
+      dst_array.get(), DecodeDeflateScratchLength);
+  uint64_t num_dst_bytes = 0;
+  std::string error_message = DecodeDeflateStream(
+      callbacks, input, io_buf, dec.get(), &dst, &num_dst_bytes);
+  return DecodeDeflateResult(std::move(error_message), num_dst_bytes);
+}
+
+// DecodeDeflateLooksLikeBlockStart returns the number of block boundaries
+// that DecodeDeflateTrialDecode should get through, if the bit position pos
+// is a plausible start of a stored or dynamic Huffman DEFLATE block, or zero
+// if it is not. Fixed Huffman blocks are not considered: their 3 bit header
+// is too short to distinguish them from random data.
+//
+// It is a cheap filter that rejects almost all bit positions, before trying
+// the more expensive DecodeDeflateTrialDecode.
+uint32_t  //
+DecodeDeflateLooksLikeBlockStart(const uint8_t* ptr,
+                                 size_t len,
+                                 uint64_t pos) {
+  size_t i = (size_t)(pos >> 3);
+  if ((len < 16) || (i > (len - 16))) {
+    return 0;
+  }
+  uint64_t bits = wuffs_base__peek_u64le__no_bounds_check(ptr + i) >> (pos & 7);
+  uint32_t type = (uint32_t)((bits >> 1) & 3);
+
+  if (type == 0) {
+    // A stored block: the LEN and NLEN fields start at the next byte boundary
+    // and should be each other's complement. Only consider the bit position
+    // just before that boundary. Earlier positions would be equivalent (the
+    // padding bits are typically zero) or misleading (treating the previous
+    // block's final bits as this block's header bits).
+    //
+    // With only a 16 bit check, some random data passes as a stored block,
+    // and a stored block's payload is not validated at all, so require the
+    // trial decode to get through more subsequent blocks.
+    if (((pos + 3) & 7) != 0) {
+      return 0;
+    }
+    uint32_t len_nlen =
+        wuffs_base__peek_u32le__no_bounds_check(ptr + ((pos + 3) >> 3));
+    return (((len_nlen ^ (len_nlen >> 16)) & 0xFFFF) == 0xFFFF) ? 8 : 0;
+
+  } else if (type != 2) {
+    return 0;
+  }
+
+  // A dynamic Huffman block: check HLIT, HDIST and that the (up to 19) 3-bit
+  // code lengths for the code length alphabet form a complete prefix code.
+  uint32_t hlit = (uint32_t)((bits >> 3) & 31);
+  uint32_t hdist = (uint32_t)((bits >> 8) & 31);
+  uint32_t hclen = (uint32_t)((bits >> 13) & 15) + 4;
+  if ((hlit > 29) || (hdist > 29)) {
+    return 0;
+  }
+  pos += 17;
+  uint64_t clens = wuffs_base__peek_u64le__no_bounds_check(ptr + (pos >> 3)) >>
+                   (pos & 7);
+  uint32_t kraft = 0;
+  for (uint32_t c = 0; c < hclen; c++) {
+    uint32_t n = (uint32_t)((clens >> (3 * c)) & 7);
+    if (n > 0) {
+      kraft += 128u >> n;
+    }
+  }
+  return (kraft == 128) ? 2 : 0;
+}
+
+// DecodeDeflateEquivalentStarts returns whether decoding from the bit
+// positions p and q are equivalent. Trivially, this is when (p == q), but a
+// stored block's header can also be ambiguous, since its padding bits can
+// also look like a stored block header.
+bool  //
+DecodeDeflateEquivalentStarts(const uint8_t* ptr,
+                              size_t len,
+                              uint64_t p,
+                              uint64_t q) {
+  if (p == q) {
+    return true;
+  } else if ((((p + 3 + 7) >> 3) != ((q + 3 + 7) >> 3)) ||
+             (((q + 3 + 7) >> 3) > len)) {
+    return false;
+  }
+  uint32_t p_header = (uint32_t)(
+      (wuffs_base__peek_u16le__no_bounds_check(ptr + (p >> 3)) >> (p & 7)) &
+      7);
+  uint32_t q_header = (uint32_t)(
+      (wuffs_base__peek_u16le__no_bounds_check(ptr + (q >> 3)) >> (q & 7)) &
+      7);
+  return (p_header == q_header) && ((p_header >> 1) == 0);
+}
+
+// DecodeDeflateState holds the read-only state shared by the threads.
+struct DecodeDeflateState {
+  DecodeDeflateState(const uint8_t* ptr0, size_t len0);
+
+  const uint8_t* ptr;
+  size_t len;
+
+  // history_a, history_b and history_z are placeholder histories. The real
+  // history byte at position p (where 0 is the oldest and 32767 is the most
+  // recent) is represented by history_a[p] and history_b[p] in two parallel
+  // decodings. Bytes that are equal in both decodings are literal bytes
+  // (copies of them). Bytes that differ, a and b, came from the history, at
+  // position ((((b - a - 1) & 0xFF) << 8) | a). history_z is all zeroes.
+  uint8_t history_a[32768];
+  uint8_t history_b[32768];
+  uint8_t history_z[32768];
+};
+
+DecodeDeflateState::DecodeDeflateState(const uint8_t* ptr0, size_t len0)
+    : ptr(ptr0), len(len0) {
+  for (uint32_t p = 0; p < 32768; p++) {
+    history_a[p] = (uint8_t)(p);
+    history_b[p] = (uint8_t)((p & 0xFF) + (p >> 8) + 1);
+    history_z[p] = 0;
+  }
+}
+
+// DecodeDeflateChunk is a contiguous part of the DEFLATE stream, decoded
+// speculatively by one thread.
+struct DecodeDeflateChunk {
+  DecodeDeflateChunk();
+
+  // start_pos is the bit position of a candidate block boundary, found by
+  // DecodeDeflateFindCandidate, or DecodeDeflateNoPosition if none was found.
+  uint64_t start_pos;
+  // stop_pos is where the chunk ends: at the first block boundary at or
+  // after this bit position (or at the end of the DEFLATE stream).
+  uint64_t stop_pos;
+
+  // The remaining fields are set by DecodeDeflateSpeculate.
+  //
+  // ok is whether the speculative decoding succeeded. If so, end_pos is the
+  // bit position of the block boundary where it stopped, final is whether
+  // that was the end of the DEFLATE stream and end_index (only meaningful
+  // when final) is the byte index just after the end of the DEFLATE stream.
+  bool ok;
+  bool final;
+  uint64_t end_pos;
+  size_t end_index;
+
+  // dst_a is the decoded output, using history_a. resolve_b is a prefix of
+  // the decoded output using history_b, long enough to resolve every
+  // placeholder byte in dst_a.
+  std::vector<uint8_t> dst_a;
+  std::vector<uint8_t> resolve_b;
+};
+
+DecodeDeflateChunk::DecodeDeflateChunk()
+    : start_pos(DecodeDeflateNoPosition),
+      stop_pos(DecodeDeflateNoPosition),
+      ok(false),
+      final(false),
+      end_pos(0),
+      end_index(0) {}
+
+// DecodeDeflateRestart re-initializes dec and src so that decoding resumes at
+// the bit position pos, with the given history (which may be empty).
+bool  //
+DecodeDeflateRestart(wuffs_deflate__decoder* dec,
+                     wuffs_base__io_buffer* src,
+                     const uint8_t* ptr,
+                     size_t len,
+                     uint64_t pos,
+                     const uint8_t* history_ptr,
+                     size_t history_len) {
+  wuffs_base__status status =
+      dec->initialize(sizeof__wuffs_deflate__decoder(), WUFFS_VERSION,
+                      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);
+  if (!status.is_ok()) {
+    return false;
+  }
+  dec->set_quirk_enabled(WUFFS_DEFLATE__QUIRK_SUSPEND_AT_BLOCK_BOUNDARIES,
+                         true);
+  if (history_len > 0) {
+    dec->add_history(wuffs_base__make_slice_u8(
+        const_cast<uint8_t*>(history_ptr), history_len));
+  }
+  size_t i = (size_t)(pos >> 3);
+  uint32_t n = (uint32_t)(pos & 7);
+  if (i > len) {
+    return false;
+  } else if (n > 0) {
+    if (i == len) {
+      return false;
+    }
+    dec->set_pending_bits(ptr[i] >> n, 8 - n);
+    i++;
+  }
+  *src = wuffs_base__ptr_u8__reader(const_cast<uint8_t*>(ptr), len, true);
+  src->meta.ri = i;
+  return true;
+}
+
+// DecodeDeflateBoundaryPosition returns the bit position of the block
+// boundary that the decoder is suspended at.
+uint64_t  //
+DecodeDeflateBoundaryPosition(wuffs_deflate__decoder* dec,
+                              wuffs_base__io_buffer* src) {
+  return (((uint64_t)(src->meta.ri)) * 8) - dec->num_pending_bits();
+}
+
+// DecodeDeflateTrialDecode returns whether decoding from the bit position pos
+// (with a placeholder history) gets through want_boundaries block boundaries,
+// or 1 MiB of output, without error. Reaching the end of the DEFLATE stream
+// does not count, as a false positive can look like a short final block.
+bool  //
+DecodeDeflateTrialDecode(const DecodeDeflateState& state,
+                         wuffs_deflate__decoder* dec,
+                         uint8_t* scratch,
+                         uint64_t pos,
+                         uint32_t want_boundaries) {
+  wuffs_base__io_buffer src;
+  if (!DecodeDeflateRestart(dec, &src, state.ptr, state.len, pos,
+                            state.history_z, 32768)) {
+    return false;
+  }
+  uint8_t work_array[1];
+  uint32_t num_boundaries = 0;
+  uint64_t num_dst_bytes = 0;
+  while (num_dst_bytes < (1024 * 1024)) {
+    wuffs_base__io_buffer dst =
+        wuffs_base__ptr_u8__writer(scratch, DecodeDeflateScratchLength);
+    wuffs_base__status status =
+        dec->transform_io(&dst, &src, wuffs_base__make_slice_u8(work_array, 0));
+    num_dst_bytes += dst.meta.wi;
+    if (status.repr == wuffs_deflate__suspension__block_boundary) {
+      if (++num_boundaries >= want_boundaries) {
+        break;
+      }
+    } else if (status.repr != wuffs_base__suspension__short_write) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint64_t  //
+DecodeDeflateFindCandidate(const DecodeDeflateState& state,
+                           uint64_t min_incl_pos,
+                           uint64_t max_excl_pos) {
+  wuffs_deflate__decoder::unique_ptr dec = wuffs_deflate__decoder::alloc();
+  std::unique_ptr<uint8_t[]> scratch(new uint8_t[DecodeDeflateScratchLength]);
+  if (!dec || !scratch) {
+    return DecodeDeflateNoPosition;
+  }
+  for (uint64_t pos = min_incl_pos; pos < max_excl_pos; pos++) {
+    uint32_t want_boundaries =
+        DecodeDeflateLooksLikeBlockStart(state.ptr, state.len, pos);
+    if ((want_boundaries > 0) &&
+        DecodeDeflateTrialDecode(state, dec.get(), scratch.get(), pos,
+                                 want_boundaries)) {
+      return pos;
+    }
+  }
+  return DecodeDeflateNoPosition;
+}
+
+// DecodeDeflateSpeculate decodes the chunk from its start_pos, using
+// history_a (and later history_b) as a placeholder history. Decoding from the
+// very start of the DEFLATE stream (bit position 0) needs no placeholders.
+void  //
+DecodeDeflateSpeculate(const DecodeDeflateState& state,
+                       DecodeDeflateChunk& chunk) {
+  chunk.ok = false;
+  wuffs_deflate__decoder::unique_ptr dec = wuffs_deflate__decoder::alloc();
+  if (!dec) {
+    return;
+  }
+  bool has_history = chunk.start_pos > 0;
+  wuffs_base__io_buffer src;
+  if (!DecodeDeflateRestart(dec.get(), &src, state.ptr, state.len,
+                            chunk.start_pos, state.history_a,
+                            has_history ? 32768 : 0)) {
+    return;
+  }
+
+  // Decode with history_a.
+  uint8_t work_array[1];
+  size_t n = 0;
+  chunk.dst_a.resize(4 * WUFFS_AUX__DECODE_DEFLATE__CHUNK_LENGTH);
+  while (true) {
+    // Each transform_io call starts with an empty dst (with no history), as
+    // the decoder has already copied earlier output into its own history.
+    wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(
+        chunk.dst_a.data() + n, chunk.dst_a.size() - n);
+    wuffs_base__status status =
+        dec->transform_io(&dst, &src, wuffs_base__make_slice_u8(work_array, 0));
+    n += dst.meta.wi;
+    if (status.repr == wuffs_deflate__suspension__block_boundary) {
+      uint64_t pos = DecodeDeflateBoundaryPosition(dec.get(), &src);
+      if (pos >= chunk.stop_pos) {
+        chunk.end_pos = pos;
+        break;
+      }
+    } else if (status.repr == wuffs_base__suspension__short_write) {
+      size_t max = WUFFS_AUX__DECODE_DEFLATE__MAX_SPECULATIVE_LENGTH;
+      if (chunk.dst_a.size() >= max) {
+        return;
+      }
+      size_t new_size = 2 * chunk.dst_a.size();
+      chunk.dst_a.resize((new_size < max) ? new_size : max);
+    } else if (status.is_ok()) {
+      chunk.final = true;
+      chunk.end_pos = ((uint64_t)(src.meta.ri)) * 8;
+      chunk.end_index = src.meta.ri;
+      break;
+    } else {
+      return;
+    }
+  }
+  chunk.dst_a.resize(n);
+  chunk.dst_a.shrink_to_fit();
+  if (!has_history) {
+    chunk.ok = true;
+    return;
+  }
+
+  // Decode again, with history_b, until 32 KiB of output passes by without
+  // any placeholder bytes. After that, no more placeholders can appear.
+  if (!DecodeDeflateRestart(dec.get(), &src, state.ptr, state.len,
+                            chunk.start_pos, state.history_b, 32768)) {
+    return;
+  }
+  std::unique_ptr<uint8_t[]> scratch(new uint8_t[DecodeDeflateScratchLength]);
+  const uint8_t* a = chunk.dst_a.data();
+  size_t num_resolved = 0;
+  size_t last_placeholder_end = 0;
+  while ((num_resolved < n) &&
+         ((num_resolved - last_placeholder_end) < 32768)) {
+    size_t remaining = n - num_resolved;
+    wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(
+        scratch.get(), (remaining < DecodeDeflateScratchLength)
+                           ? remaining
+                           : DecodeDeflateScratchLength);
+    wuffs_base__status status =
+        dec->transform_io(&dst, &src, wuffs_base__make_slice_u8(work_array, 0));
+    const uint8_t* b = scratch.get();
+    for (size_t i = dst.meta.wi; i > 0; i--) {
+      if (a[num_resolved + i - 1] != b[i - 1]) {
+        last_placeholder_end = num_resolved + i;
+        break;
+      }
+    }
+    chunk.resolve_b.insert(chunk.resolve_b.end(), b, b + dst.meta.wi);
+    num_resolved += dst.meta.wi;
+    if (status.is_error()) {
+      return;
+    } else if (status.is_ok()) {
+      break;
+    }
+  }
+  chunk.resolve_b.resize(last_placeholder_end);
+  chunk.resolve_b.shrink_to_fit();
+  chunk.ok = true;
+}
+
+// DecodeDeflateParallel decodes a complete (in memory) DEFLATE stream. It
+// calls callbacks.Append, in order, from the calling thread.
+class DecodeDeflateParallel {
+ public:
+  DecodeDeflateParallel(DecodeDeflateCallbacks& callbacks,
+                        const uint8_t* ptr,
+                        size_t len,
+                        uint32_t framing,
+                        bool ignore_checksum);
+
+  std::string Decode(uint32_t num_threads, size_t* end_index);
+  uint64_t num_dst_bytes() const { return m_num_dst_bytes; }
+  uint32_t checksum() const { return m_checksum; }
+
+ private:
+  std::string Emit(const uint8_t* ptr, size_t len);
+  std::string DecodeSerially(uint64_t start_pos,
+                             uint64_t stop_pos,
+                             DecodeDeflateChunk& chunk);
+
+  DecodeDeflateCallbacks& m_callbacks;
+  std::unique_ptr<DecodeDeflateState> m_state;
+  uint32_t m_framing;
+  bool m_ignore_checksum;
+
+  wuffs_crc32__ieee_hasher::unique_ptr m_crc32;
+  wuffs_adler32__hasher::unique_ptr m_adler32;
+  uint32_t m_checksum;
+
+  // m_window holds the last 32 KiB of output, oldest first, of which the
+  // final m_window_len bytes are valid.
+  uint8_t m_window[32768];
+  size_t m_window_len;
+  uint64_t m_num_dst_bytes;
+};
+
+DecodeDeflateParallel::DecodeDeflateParallel(DecodeDeflateCallbacks& callbacks,
+                                             const uint8_t* ptr,
+                                             size_t len,
+                                             uint32_t framing,
+                                             bool ignore_checksum)
+    : m_callbacks(callbacks),
+      m_state(new DecodeDeflateState(ptr, len)),
+      m_framing(framing),
+      m_ignore_checksum(ignore_checksum),
+      m_crc32(wuffs_crc32__ieee_hasher::alloc()),
+      m_adler32(wuffs_adler32__hasher::alloc()),
+      m_checksum(0),
+      m_window_len(0),
+      m_num_dst_bytes(0) {}
+
+std::string  //
+DecodeDeflateParallel::Emit(const uint8_t* ptr, size_t len) {
+  if (len == 0) {
+    return "";
+  }
+  if (!m_ignore_checksum) {
+    wuffs_base__slice_u8 s =
+        wuffs_base__make_slice_u8(const_cast<uint8_t*>(ptr), len);
+    if (m_framing == WUFFS_BASE__FOURCC__GZ) {
+      m_checksum = m_crc32->update_u32(s);
+    } else if (m_framing == WUFFS_BASE__FOURCC__ZLIB) {
+      m_checksum = m_adler32->update_u32(s);
+    }
+  }
+  if (len >= 32768) {
+    memcpy(m_window, ptr + len - 32768, 32768);
+    m_window_len = 32768;
+  } else {
+    memmove(m_window, m_window + len, 32768 - len);
+    memcpy(m_window + 32768 - len, ptr, len);
+    m_window_len = (m_window_len + len < 32768) ? (m_window_len + len) : 32768;
+  }
+  m_num_dst_bytes += len;
+  return m_callbacks.Append(ptr, len);
+}
+
+// DecodeSerially decodes (and emits) from start_pos, with the real history,
+// until the first block boundary at or after stop_pos. It sets the chunk's
+// end_pos, final and end_index fields.
+std::string  //
+DecodeDeflateParallel::DecodeSerially(uint64_t start_pos,
+                                      uint64_t stop_pos,
+                                      DecodeDeflateChunk& chunk) {
+  wuffs_deflate__decoder::unique_ptr dec = wuffs_deflate__decoder::alloc();
+  if (!dec) {
+    return DecodeDeflate_OutOfMemory;
+  }
+  wuffs_base__io_buffer src;
+  if (!DecodeDeflateRestart(dec.get(), &src, m_state->ptr, m_state->len,
+                            start_pos, m_window + 32768 - m_window_len,
+                            m_window_len)) {
+    return DecodeDeflate_UnexpectedEndOfFile;
+  }
+  std::unique_ptr<uint8_t[]> dst_array(
+      new uint8_t[DecodeDeflateScratchLength]);
+  uint8_t work_array[1];
+  while (true) {
+    wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(
+        dst_array.get(), DecodeDeflateScratchLength);
+    wuffs_base__status status =
+        dec->transform_io(&dst, &src, wuffs_base__make_slice_u8(work_array, 0));
+    std::string error_message = Emit(dst.data.ptr, dst.meta.wi);
+    if (!error_message.empty()) {
+      return error_message;
+    }
+    if (status.repr == wuffs_deflate__suspension__block_boundary) {
+      uint64_t pos = DecodeDeflateBoundaryPosition(dec.get(), &src);
+      if (pos >= stop_pos) {
+        chunk.end_pos = pos;
+        return "";
+      }
+    } else if (status.repr == wuffs_base__suspension__short_write) {
+      continue;
+    } else if (status.is_ok()) {
+      chunk.final = true;
+      chunk.end_pos = ((uint64_t)(src.meta.ri)) * 8;
+      chunk.end_index = src.meta.ri;
+      return "";
+    } else if (status.repr == wuffs_base__suspension__short_read) {
+      return DecodeDeflate_UnexpectedEndOfFile;
+    } else {
+      return status.message();
+    }
+  }
+}
+
+std::string  //
+DecodeDeflateParallel::Decode(uint32_t num_threads, size_t* end_index) {
+  if (!m_state || !m_crc32 || !m_adler32) {
+    return DecodeDeflate_OutOfMemory;
+  }
+  const size_t chunk_len = WUFFS_AUX__DECODE_DEFLATE__CHUNK_LENGTH;
+  const size_t len = m_state->len;
+  size_t num_chunks = (len / chunk_len) + 1;
+
+  // start_positions[i] is the i'th chunk's candidate start position. The
+  // zeroth chunk always starts at the very start of the DEFLATE stream.
+  std::vector<uint64_t> start_positions(num_chunks + 1,
+                                        DecodeDeflateNoPosition);
+  start_positions[0] = 0;
+
+  uint64_t pos = 0;
+  bool final = false;
+  for (size_t r0 = 0; (r0 < num_chunks) && !final; r0 += num_threads) {
+    size_t r1 = ((num_chunks - r0) < num_threads) ? num_chunks
+                                                  : (r0 + num_threads);
+
+    // Find the candidate start positions for chunks (r0 .. r1], in parallel.
+    // The r0'th chunk's candidate was found by the previous round.
+    {
+      std::vector<std::thread> threads;
+      for (size_t i = r0 + 1; (i <= r1) && (i < num_chunks); i++) {
+        threads.emplace_back([this, &start_positions, chunk_len, i]() {
+          start_positions[i] = DecodeDeflateFindCandidate(
+              *m_state, ((uint64_t)(i * chunk_len)) * 8,
+              ((uint64_t)((i + 1) * chunk_len)) * 8);
+        });
+      }
+      for (auto& t : threads) {
+        t.join();
+      }
+    }
+
+    // Decode chunks [r0 .. r1), in parallel. Each chunk stops at the next
+    // chunk's candidate start position (or the end of this round).
+    std::vector<DecodeDeflateChunk> chunks(r1 - r0);
+    {
+      std::vector<std::thread> threads;
+      for (size_t i = r0; i < r1; i++) {
+        DecodeDeflateChunk& chunk = chunks[i - r0];
+        chunk.start_pos = start_positions[i];
+        chunk.stop_pos = (r1 < num_chunks) ? (((uint64_t)(r1 * chunk_len)) * 8)
+                                           : DecodeDeflateNoPosition;
+        for (size_t j = i + 1; j <= r1; j++) {
+          if (start_positions[j] != DecodeDeflateNoPosition) {
+            chunk.stop_pos = start_positions[j];
+            break;
+          }
+        }
+        if (chunk.start_pos != DecodeDeflateNoPosition) {
+          threads.emplace_back(
+              [this, &chunk]() { DecodeDeflateSpeculate(*m_state, chunk); });
+        }
+      }
+      for (auto& t : threads) {
+        t.join();
+      }
+    }
+
+    // Stitch the chunks together, in order. A speculatively decoded chunk is
+    // used only if it starts exactly where the previous chunk ended and its
+    // placeholders can be resolved. Otherwise, fall back to decoding
+    // serially, with the real history.
+    for (size_t i = r0; (i < r1) && !final; i++) {
+      DecodeDeflateChunk& chunk = chunks[i - r0];
+      if (pos >= chunk.stop_pos) {
+        continue;
+      }
+
+      if (chunk.ok &&
+          DecodeDeflateEquivalentStarts(m_state->ptr, m_state->len,
+                                        chunk.start_pos, pos) &&
+          (chunk.resolve_b.empty() || (m_window_len == 32768))) {
+        uint8_t* a = chunk.dst_a.data();
+        const uint8_t* b = chunk.resolve_b.data();
+        for (size_t j = 0; j < chunk.resolve_b.size(); j++) {
+          if (a[j] != b[j]) {
+            a[j] = m_window[(((b[j] - a[j] - 1) & 0xFF) << 8) | a[j]];
+          }
+        }
+        std::string error_message = Emit(a, chunk.dst_a.size());
+        if (!error_message.empty()) {
+          return error_message;
+        }
+      } else {
+        chunk.final = false;
+        std::string error_message = DecodeSerially(pos, chunk.stop_pos, chunk);
+        if (!error_message.empty()) {
+          return error_message;
+        }
+      }
+      pos = chunk.end_pos;
+      final = chunk.final;
+      *end_index = chunk.end_index;
+
+      chunk.dst_a.clear();
+      chunk.dst_a.shrink_to_fit();
+      chunk.resolve_b.clear();
+      chunk.resolve_b.shrink_to_fit();
+    }
+  }
+  return final ? "" : DecodeDeflate_UnexpectedEndOfFile;
+}
+
+// DecodeDeflateReadAll returns the entire input, either in its own I/O buffer
+// or after copying it into storage.
+std::string  //
+DecodeDeflateReadAll(sync_io::Input& input,
+                     std::vector<uint8_t>& storage,
+                     wuffs_base__slice_u8* all) {
+  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
+  if (io_buf && io_buf->meta.closed) {
+    *all = io_buf->reader_slice();
+    return "";
+  }
+  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
+  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
+  if (!io_buf) {
+    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);
+    fallback_io_buf =
+        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);
+    io_buf = &fallback_io_buf;
+  }
+  while (true) {
+    storage.insert(storage.end(), io_buf->reader_pointer(),
+                   io_buf->reader_pointer() + io_buf->reader_length());
+    io_buf->meta.ri = io_buf->meta.wi;
+    if (io_buf->meta.closed) {
+      break;
+    }
+    io_buf->compact();
+    std::string error_message = input.CopyIn(io_buf);
+    if (!error_message.empty()) {
+      return error_message;
+    }
+  }
+  *all = wuffs_base__make_slice_u8(storage.data(), storage.size());
+  return "";
+}
+
+// DecodeDeflateMessage returns the message (without the leading '#') of a
+// Wuffs error status, such as wuffs_gzip__error__bad_checksum.
+std::string  //
+DecodeDeflateMessage(const char* status_repr) {
+  return wuffs_base__make_status(status_repr).message();
+}
+
+// DecodeDeflateHeaderLength returns the length of the gzip or zlib header at
+// the start of s, or 0 if it is invalid (setting error_message). The error
+// messages match what the (single-threaded) gzip and zlib decoders report.
+size_t  //
+DecodeDeflateHeaderLength(wuffs_base__slice_u8 s,
+                          uint32_t framing,
+                          std::string& error_message) {
+  if (framing == 0) {
+    return 0;
+  } else if (framing == WUFFS_BASE__FOURCC__ZLIB) {
+    if (s.len < 2) {
+      error_message = DecodeDeflate_UnexpectedEndOfFile;
+      return 0;
+    } else if ((s.ptr[0] & 0x0F) != 0x08) {
+      error_message =
+          DecodeDeflateMessage(wuffs_zlib__error__bad_compression_method);
+      return 0;
+    } else if ((s.ptr[0] >> 4) > 7) {
+      error_message =
+          DecodeDeflateMessage(wuffs_zlib__error__bad_compression_window_size);
+      return 0;
+    } else if ((((s.ptr[0] << 8) | s.ptr[1]) % 31) != 0) {
+      error_message = DecodeDeflateMessage(wuffs_zlib__error__bad_parity_check);
+      return 0;
+    } else if (s.ptr[1] & 0x20) {
+      // Preset dictionaries are not supported.
+      error_message = DecodeDeflate_UnsupportedFraming;
+      return 0;
+    }
+    return 2;
+  } else if (framing != WUFFS_BASE__FOURCC__GZ) {
+    error_message = DecodeDeflate_UnsupportedFraming;
+    return 0;
+  }
+
+  // Check the leading bytes before the length, like the gzip decoder does.
+  if (((s.len > 0) && (s.ptr[0] != 0x1F)) ||
+      ((s.len > 1) && (s.ptr[1] != 0x8B))) {
+    error_message = DecodeDeflateMessage(wuffs_gzip__error__bad_header);
+    return 0;
+  } else if ((s.len > 2) && (s.ptr[2] != 0x08)) {
+    error_message =
+        DecodeDeflateMessage(wuffs_gzip__error__bad_compression_method);
+    return 0;
+  } else if (s.len < 10) {
+    error_message = DecodeDeflate_UnexpectedEndOfFile;
+    return 0;
+  }
+  uint8_t flags = s.ptr[3];
+  size_t i = 10;
+  if (flags & 0x04) {  // FEXTRA.
+    if ((s.len - i) < 2) {
+      error_message = DecodeDeflate_UnexpectedEndOfFile;
+      return 0;
+    }
+    i += 2 + wuffs_base__peek_u16le__no_bounds_check(s.ptr + i);
+  }
+  for (uint8_t f = 0x08; f <= 0x10; f <<= 1) {  // FNAME and FCOMMENT.
+    if (flags & f) {
+      while ((i < s.len) && (s.ptr[i] != 0)) {
+        i++;
+      }
+      i++;
+    }
+  }
+  if (flags & 0x02) {  // FHCRC.
+    i += 2;
+  }
+  if (i > s.len) {
+    error_message = DecodeDeflate_UnexpectedEndOfFile;
+    return 0;
+  } else if ((flags & 0xE0) != 0) {
+    error_message = DecodeDeflateMessage(wuffs_gzip__error__bad_encoding_flags);
+    return 0;
+  }
+  return i;
+}
+
+bool  //
+DecodeDeflateIgnoreChecksum(wuffs_base__slice_u32 quirks) {
+  for (size_t i = 0; i < quirks.len; i++) {
+    if (quirks.ptr[i] == WUFFS_BASE__QUIRK_IGNORE_CHECKSUM) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// DecodeDeflateCheckTrailer checks the gzip or zlib trailer, of trailer_len
+// bytes, against the checksum and length of the decoded output. Like
+// DecodeDeflateHeaderLength, its error messages match the gzip and zlib
+// decoders'.
+std::string  //
+DecodeDeflateCheckTrailer(const uint8_t* trailer,
+                          size_t trailer_len,
+                          uint32_t framing,
+                          bool ignore_checksum,
+                          uint32_t checksum,
+                          uint64_t num_dst_bytes) {
+  if (framing == WUFFS_BASE__FOURCC__GZ) {
+    if (trailer_len < 8) {
+      return DecodeDeflate_UnexpectedEndOfFile;
+    } else if (!ignore_checksum &&
+               ((checksum !=
+                 wuffs_base__peek_u32le__no_bounds_check(trailer + 0)) ||
+                (((uint32_t)(num_dst_bytes)) !=
+                 wuffs_base__peek_u32le__no_bounds_check(trailer + 4)))) {
+      return DecodeDeflateMessage(wuffs_gzip__error__bad_checksum);
+    }
+  } else if (framing == WUFFS_BASE__FOURCC__ZLIB) {
+    if (trailer_len < 4) {
+      return DecodeDeflate_UnexpectedEndOfFile;
+    } else if (!ignore_checksum &&
+               (checksum !=
+                wuffs_base__peek_u32be__no_bounds_check(trailer))) {
+      return DecodeDeflateMessage(wuffs_zlib__error__bad_checksum);
+    }
+  }
+  return "";
+}
+
+DecodeDeflateResult  //
+DecodeDeflate0(DecodeDeflateCallbacks& callbacks,
+               sync_io::Input& input,
+               uint32_t framing,
+               uint32_t num_threads,
+               bool ignore_checksum) {
+  std::vector<uint8_t> storage;
+  wuffs_base__slice_u8 all = wuffs_base__empty_slice_u8();
+  std::string error_message = DecodeDeflateReadAll(input, storage, &all);
+  if (!error_message.empty()) {
+    return DecodeDeflateResult(std::move(error_message), 0);
+  }
+  size_t header_len = DecodeDeflateHeaderLength(all, framing, error_message);
+  if (!error_message.empty()) {
+    return DecodeDeflateResult(std::move(error_message), 0);
+  }
+
+  DecodeDeflateParallel p(callbacks, all.ptr + header_len,
+                          all.len - header_len, framing, ignore_checksum);
+  size_t end_index = 0;
+  error_message = p.Decode(num_threads, &end_index);
+  if (!error_message.empty()) {
+    return DecodeDeflateResult(std::move(error_message), p.num_dst_bytes());
+  }
+
+  // Check the gzip or zlib trailer.
+  error_message = DecodeDeflateCheckTrailer(
+      all.ptr + header_len + end_index, all.len - header_len - end_index,
+      framing, ignore_checksum, p.checksum(), p.num_dst_bytes());
+  return DecodeDeflateResult(std::move(error_message), p.num_dst_bytes());
+}
+
+}  // namespace
+
+DecodeDeflateResult  //
+DecodeDeflate(DecodeDeflateCallbacks& callbacks,
+              sync_io::Input& input,
+              uint32_t framing,
+              uint32_t num_threads,
+              wuffs_base__slice_u32 quirks) {
+  bool ignore_checksum = DecodeDeflateIgnoreChecksum(quirks);
+  DecodeDeflateResult result =
+      (num_threads <= 1)
+          ? DecodeDeflateSerial(callbacks, input, framing, ignore_checksum)
+          : DecodeDeflate0(callbacks, input, framing, num_threads,
+                           ignore_checksum);
+  callbacks.Done(result, input);
+  return result;
+}
+
+// --------
+
+namespace {
+
+// DecodeGzipMember is a complete gzip member's compressed and decoded bytes.
+struct DecodeGzipMember {
+  std::vector<uint8_t> src;
+  std::vector<uint8_t> dst;
+  std::string error_message;
+};
+
+// DecodeGzipMemberLength returns the total (compressed) length of the gzip
+// member whose header is at the start of s, if that header's FEXTRA field has
+// a BGZF "BC" subfield, or 0 if it does not.
+size_t  //
+DecodeGzipMemberLength(wuffs_base__slice_u8 s) {
+  if ((s.len < 12) || !(s.ptr[3] & 0x04)) {
+    return 0;
+  }
+  size_t n = wuffs_base__peek_u16le__no_bounds_check(s.ptr + 10);
+  if (n > (s.len - 12)) {
+    return 0;
+  }
+  const uint8_t* p = s.ptr + 12;
+  while (n >= 4) {
+    size_t subfield_len = wuffs_base__peek_u16le__no_bounds_check(p + 2);
+    if (subfield_len > (n - 4)) {
+      break;
+    } else if ((p[0] == 'B') && (p[1] == 'C') && (subfield_len == 2)) {
+      return 1 + (size_t)wuffs_base__peek_u16le__no_bounds_check(p + 4);
+    }
+    p += 4 + subfield_len;
+    n -= 4 + subfield_len;
+  }
+  return 0;
+}
+
+// DecodeGzipMemberDecode decodes m.src into m.dst, which has already been
+// sized (from the member's ISIZE) to fit the decoded bytes plus one.
+void  //
+DecodeGzipMemberDecode(wuffs_gzip__decoder* dec,
+                       DecodeGzipMember& m,
+                       bool ignore_checksum) {
+  wuffs_base__status status =
+      dec->initialize(sizeof__wuffs_gzip__decoder(), WUFFS_VERSION,
+                      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);
+  if (!status.is_ok()) {
+    m.error_message = status.message();
+    return;
+  }
+  dec->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, ignore_checksum);
+
+  wuffs_base__io_buffer src =
+      wuffs_base__ptr_u8__reader(m.src.data(), m.src.size(), true);
+  uint8_t work_array[1];
+  size_t n = 0;
+  while (true) {
+    wuffs_base__io_buffer dst =
+        wuffs_base__ptr_u8__writer(m.dst.data() + n, m.dst.size() - n);
+    status = dec->transform_io(&dst, &src,
+                               wuffs_base__make_slice_u8(work_array, 0));
+    n += dst.meta.wi;
+    if (status.is_ok()) {
+      break;
+    } else if (status.repr == wuffs_base__suspension__short_write) {
+      // The member decodes to more than its ISIZE.
+      if (!ignore_checksum) {
+        m.error_message = DecodeDeflate_BadChecksum;
+        return;
+      }
+      m.dst.resize(2 * m.dst.size());
+    } else if (status.repr == wuffs_base__suspension__short_read) {
+      // The member is longer than its "BC" subfield says.
+      m.error_message = DecodeDeflate_BadHeader;
+      return;
+    } else {
+      m.error_message = status.message();
+      return;
+    }
+  }
+  if (src.meta.ri != src.meta.wi) {
+    // The member is shorter than its "BC" subfield says.
+    m.error_message = DecodeDeflate_BadHeader;
+    return;
+  }
+  m.dst.resize(n);
+}
+
+// DecodeGzipMemberSerially decodes m.src, streaming its output through the
+// dst scratch buffer to callbacks.Append. For a bad or truncated member, this
+// gives the same output and error message as single-threaded decoding.
+std::string  //
+DecodeGzipMemberSerially(DecodeDeflateCallbacks& callbacks,
+                         wuffs_gzip__decoder* dec,
+                         DecodeGzipMember& m,
+                         bool ignore_checksum,
+                         wuffs_base__io_buffer* dst,
+                         uint64_t* num_dst_bytes) {
+  wuffs_base__status status =
+      dec->initialize(sizeof__wuffs_gzip__decoder(), WUFFS_VERSION,
+                      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);
+  if (!status.is_ok()) {
+    return status.message();
+  }
+  dec->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, ignore_checksum);
+  sync_io::MemoryInput member_input(m.src.data(), m.src.size());
+  IOBuffer* member_io_buf = member_input.BringsItsOwnIOBuffer();
+  std::string error_message = DecodeDeflateStream(
+      callbacks, member_input, member_io_buf,
+      dec->upcast_as__wuffs_base__io_transformer(), dst, num_dst_bytes);
+  if (error_message.empty() && (member_io_buf->reader_length() > 0)) {
+    // The member is shorter than its "BC" subfield says.
+    error_message = DecodeDeflate_BadHeader;
+  }
+  return error_message;
+}
+
+// DecodeGzipMembersFlush decodes the batch of members, in parallel, and then
+// passes their output, in order, to callbacks.Append. The first bad member is
+// decoded again, serially, so that its valid prefix is also passed on.
+std::string  //
+DecodeGzipMembersFlush(DecodeDeflateCallbacks& callbacks,
+                       std::vector<wuffs_gzip__decoder::unique_ptr>& decs,
+                       std::vector<DecodeGzipMember>& batch,
+                       bool ignore_checksum,
+                       wuffs_base__io_buffer* dst,
+                       uint64_t* num_dst_bytes) {
+  size_t num_threads = (decs.size() < batch.size()) ? decs.size()  //
+                                                    : batch.size();
+  if (num_threads == 1) {
+    DecodeGzipMemberDecode(decs[0].get(), batch[0], ignore_checksum);
+  } else if (num_threads > 1) {
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; t++) {
+      threads.emplace_back(
+          [&decs, &batch, ignore_checksum, num_threads, t]() {
+            for (size_t i = t; i < batch.size(); i += num_threads) {
+              DecodeGzipMemberDecode(decs[t].get(), batch[i],
+                                     ignore_checksum);
+            }
+          });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+  }
+
+  for (auto& m : batch) {
+    if (!m.error_message.empty()) {
+      std::string error_message = DecodeGzipMemberSerially(
+          callbacks, decs[0].get(), m, ignore_checksum, dst, num_dst_bytes);
+      return error_message.empty() ? std::move(m.error_message)
+                                   : error_message;
+    } else if (!m.dst.empty()) {
+      std::string error_message = callbacks.Append(m.dst.data(), m.dst.size());
+      *num_dst_bytes += m.dst.size();
+      if (!error_message.empty()) {
+        return error_message;
+      }
+    }
+  }
+  batch.clear();
+  return "";
+}
+
+DecodeDeflateResult  //
+DecodeGzipMembers0(DecodeDeflateCallbacks& callbacks,
+                   sync_io::Input& input,
+                   uint32_t num_threads,
+                   bool ignore_checksum) {
+  std::vector<wuffs_gzip__decoder::unique_ptr> decs;
+  for (uint32_t t = 0; (t == 0) || (t < num_threads); t++) {
+    decs.push_back(wuffs_gzip__decoder::alloc());
+    if (!decs.back()) {
+      return DecodeDeflateResult(DecodeDeflate_OutOfMemory, 0);
+    }
+  }
+
+  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
+  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
+  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
+  if (!io_buf) {
+    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);
+    fallback_io_buf =
+        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);
+    io_buf = &fallback_io_buf;
+  }
+
+  std::unique_ptr<uint8_t[]> dst_array(
+      new uint8_t[DecodeDeflateScratchLength]);
+  wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(
+      dst_array.get(), DecodeDeflateScratchLength);
+  std::vector<DecodeGzipMember> batch;
+  uint64_t batch_len = 0;
+  uint64_t num_dst_bytes = 0;
+
+  for (bool first = true; true; first = false) {
+    // Read the next member's header, which has to fit in io_buf. Reaching the
+    // end of the input (other than before the first member) is not an error.
+    std::string error_message;
+    size_t header_len = 0;
+    while (true) {
+      if (!first && (io_buf->reader_length() == 0) && io_buf->meta.closed) {
+        break;
+      }
+      header_len = DecodeDeflateHeaderLength(
+          io_buf->reader_slice(), WUFFS_BASE__FOURCC__GZ, error_message);
+      if (error_message.empty() ||
+          (error_message != DecodeDeflate_UnexpectedEndOfFile) ||
+          ((io_buf->meta.ri == 0) && (io_buf->meta.wi == io_buf->data.len))) {
+        break;
+      }
+      error_message = DecodeDeflateFill(input, io_buf);
+      if (!error_message.empty()) {
+        break;
+      }
+    }
+    if (!error_message.empty() || (header_len == 0)) {
+      std::string flush_error_message = DecodeGzipMembersFlush(
+          callbacks, decs, batch, ignore_checksum, &dst, &num_dst_bytes);
+      return DecodeDeflateResult(flush_error_message.empty()
+                                     ? std::move(error_message)
+                                     : std::move(flush_error_message),
+                                 num_dst_bytes);
+    }
+
+    size_t member_len = (num_threads > 1)
+                            ? DecodeGzipMemberLength(io_buf->reader_slice())
+                            : 0;
+    DecodeGzipMember m;
+    if (member_len > 0) {
+      if (member_len < (header_len + 8)) {
+        error_message = DecodeDeflate_BadHeader;
+      }
+      // Read ahead the whole member.
+      m.src.reserve(member_len);
+      while (error_message.empty() && (m.src.size() < member_len)) {
+        size_t n = member_len - m.src.size();
+        if (n > io_buf->reader_length()) {
+          n = io_buf->reader_length();
+        }
+        m.src.insert(m.src.end(), io_buf->reader_pointer(),
+                     io_buf->reader_pointer() + n);
+        io_buf->meta.ri += n;
+        if (m.src.size() < member_len) {
+          error_message = DecodeDeflateFill(input, io_buf);
+        }
+      }
+      if (!error_message.empty()) {
+        // Decode what there is of this (truncated) member, after the batch
+        // so far, as single-threaded decoding would have.
+        std::string other_error_message = DecodeGzipMembersFlush(
+            callbacks, decs, batch, ignore_checksum, &dst, &num_dst_bytes);
+        if (other_error_message.empty() && (m.src.size() >= header_len)) {
+          other_error_message =
+              DecodeGzipMemberSerially(callbacks, decs[0].get(), m,
+                                       ignore_checksum, &dst, &num_dst_bytes);
+        }
+        return DecodeDeflateResult(other_error_message.empty()
+                                       ? std::move(error_message)
+                                       : std::move(other_error_message),
+                                   num_dst_bytes);
+      }
+
+      uint64_t isize = wuffs_base__peek_u32le__no_bounds_check(
+          m.src.data() + member_len - 4);
+      if (isize <= WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH) {
+        m.dst.resize(isize + 1);
+        batch.push_back(std::move(m));
+        batch_len += isize;
+        if (batch_len >=
+            (WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH * decs.size())) {
+          error_message =
+              DecodeGzipMembersFlush(callbacks, decs, batch, ignore_checksum,
+                                     &dst, &num_dst_bytes);
+          batch_len = 0;
+          if (!error_message.empty()) {
+            return DecodeDeflateResult(std::move(error_message),
+                                       num_dst_bytes);
+          }
+        }
+        continue;
+      }
+    }
+
+    // Decode this member single-threaded, after the batch so far.
+    error_message = DecodeGzipMembersFlush(
+        callbacks, decs, batch, ignore_checksum, &dst, &num_dst_bytes);
+    batch_len = 0;
+    if (!error_message.empty()) {
+      return DecodeDeflateResult(std::move(error_message), num_dst_bytes);
+    }
+    if (member_len == 0) {
+      wuffs_base__status status = decs[0]->initialize(
+          sizeof__wuffs_gzip__decoder(), WUFFS_VERSION,
+          WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);
+      if (!status.is_ok()) {
+        return DecodeDeflateResult(status.message(), num_dst_bytes);
+      }
+      decs[0]->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM,
+                                 ignore_checksum);
+      error_message = DecodeDeflateStream(
+          callbacks, input, io_buf,
+          decs[0]->upcast_as__wuffs_base__io_transformer(), &dst,
+          &num_dst_bytes);
+    } else {
+      error_message = DecodeGzipMemberSerially(
+          callbacks, decs[0].get(), m, ignore_checksum, &dst, &num_dst_bytes);
+    }
+    if (!error_message.empty()) {
+      return DecodeDeflateResult(std::move(error_message), num_dst_bytes);
+    }
+  }
+}
+
+}  // namespace
+
+DecodeDeflateResult  //
+DecodeGzipMembers(DecodeDeflateCallbacks& callbacks,
+                  sync_io::Input& input,
+                  uint32_t num_threads,
+                  wuffs_base__slice_u32 quirks) {
+  DecodeDeflateResult result = DecodeGzipMembers0(
+      callbacks, input, num_threads, DecodeDeflateIgnoreChecksum(quirks));
+  callbacks.Done(result, input);
+  return result;
+}
+
+// --------
+
+DecodeDeflateBatchCallbacks::~DecodeDeflateBatchCallbacks() {}
+
+namespace {
+
+// DecodeDeflateBatchDstLength is the length of each lane's dst buffer. When
+// it is full, all but its final 32 KiB is passed to callbacks.Append. Keeping
+// that history in dst means that decode_interleaved can always copy from it.
+const size_t DecodeDeflateBatchDstLength = 128 * 1024;
+
+// DecodeDeflateBatchLane decodes one input at a time. DecodeDeflateBatch
+// interleaves two lanes.
+struct DecodeDeflateBatchLane {
+  DecodeDeflateBatchLane();
+
+  std::string Start(size_t i,
+                    wuffs_base__slice_u8 input,
+                    uint32_t framing0,
+                    bool ignore_checksum0);
+  std::string Advance(DecodeDeflateBatchCallbacks& callbacks);
+  std::string Flush(DecodeDeflateBatchCallbacks& callbacks, size_t keep);
+
+  wuffs_deflate__decoder::unique_ptr dec;
+  wuffs_crc32__ieee_hasher::unique_ptr crc32;
+  wuffs_adler32__hasher::unique_ptr adler32;
+  std::unique_ptr<uint8_t[]> dst_array;
+  wuffs_base__io_buffer dst;
+  wuffs_base__io_buffer src;
+
+  size_t index;
+  uint32_t framing;
+  bool ignore_checksum;
+  // active is whether the lane is decoding an input. ready is whether dec is
+  // suspended with a "$ready to interleave" status.
+  bool active;
+  bool ready;
+  // dst.data.ptr[.. num_appended] has already been passed to Append.
+  size_t num_appended;
+  uint32_t checksum;
+  uint64_t num_dst_bytes;
+};
+
+DecodeDeflateBatchLane::DecodeDeflateBatchLane()
+    : dec(wuffs_deflate__decoder::alloc()),
+      crc32(wuffs_crc32__ieee_hasher::alloc()),
+      adler32(wuffs_adler32__hasher::alloc()),
+      dst_array(new uint8_t[DecodeDeflateBatchDstLength]),
+      dst(wuffs_base__ptr_u8__writer(dst_array.get(),
+                                     DecodeDeflateBatchDstLength)),
+      src(wuffs_base__empty_io_buffer()),
+      index(0),
+      framing(0),
+      ignore_checksum(false),
+      active(false),
+      ready(false),
+      num_appended(0),
+      checksum(0),
+      num_dst_bytes(0) {}
+
+std::string  //
+DecodeDeflateBatchLane::Start(size_t i,
+                              wuffs_base__slice_u8 input,
+                              uint32_t framing0,
+                              bool ignore_checksum0) {
+  index = i;
+  framing = framing0;
+  ignore_checksum = ignore_checksum0;
+  active = false;
+  ready = false;
+  num_appended = 0;
+  checksum = 0;
+  num_dst_bytes = 0;
+  dst.meta.wi = 0;
+
+  std::string error_message;
+  size_t header_len = DecodeDeflateHeaderLength(input, framing, error_message);
+  if (!error_message.empty()) {
+    return error_message;
+  }
+  src = wuffs_base__ptr_u8__reader(input.ptr + header_len,
+                                   input.len - header_len, true);
+
+  wuffs_base__status status =
+      dec->initialize(sizeof__wuffs_deflate__decoder(), WUFFS_VERSION,
+                      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);
+  if (status.is_ok()) {
+    status = crc32->initialize(sizeof__wuffs_crc32__ieee_hasher(),
+                               WUFFS_VERSION, 0);
+  }
+  if (status.is_ok()) {
+    status = adler32->initialize(sizeof__wuffs_adler32__hasher(),
+                                 WUFFS_VERSION, 0);
+  }
+  if (!status.is_ok()) {
+    return status.message();
+  }
+  dec->set_quirk_enabled(WUFFS_DEFLATE__QUIRK_SUSPEND_FOR_INTERLEAVING, true);
+  // Advance resumes with the same dst, which (see Flush) always holds all of
+  // the output so far or its final 32 KiB. The decoder's own copy of that
+  // history would otherwise hold those bytes twice.
+  dec->set_quirk_enabled(WUFFS_DEFLATE__QUIRK_DST_HOLDS_HISTORY, true);
+  active = true;
+  return "";
+}
+
+// Advance runs the lane's decoder until it is ready to interleave (setting
+// ready) or until it is done (clearing active), successfully or otherwise.
+std::string  //
+DecodeDeflateBatchLane::Advance(DecodeDeflateBatchCallbacks& callbacks) {
+  uint8_t work_array[1];
+  ready = false;
+  while (true) {
+    wuffs_base__status status = dec->transform_io(
+        &dst, &src, wuffs_base__make_slice_u8(work_array, 0));
+    if (status.repr == wuffs_deflate__suspension__ready_to_interleave) {
+      ready = true;
+      return "";
+    }
+
+    std::string error_message;
+    if (status.is_ok()) {
+      error_message = Flush(callbacks, 0);
+      if (error_message.empty()) {
+        error_message = DecodeDeflateCheckTrailer(
+            src.reader_pointer(), src.reader_length(), framing,
+            ignore_checksum, checksum, num_dst_bytes);
+      }
+    } else if (status.repr == wuffs_base__suspension__short_write) {
+      error_message = Flush(callbacks, 32768);
+      if (error_message.empty()) {
+        continue;
+      }
+    } else {
+      // Pass on the output before the error, as DecodeDeflate would.
+      error_message = Flush(callbacks, 0);
+      if (error_message.empty()) {
+        error_message = (status.repr == wuffs_base__suspension__short_read)
+                            ? DecodeDeflate_UnexpectedEndOfFile
+                            : status.message();
+      }
+    }
+    active = false;
+    return error_message;
+  }
+}
+
+// Flush passes the not-yet-appended part of dst to callbacks.Append and then
+// moves the final keep bytes of dst (the history) to its start.
+std::string  //
+DecodeDeflateBatchLane::Flush(DecodeDeflateBatchCallbacks& callbacks,
+                              size_t keep) {
+  if (num_appended < dst.meta.wi) {
+    uint8_t* ptr = dst.data.ptr + num_appended;
+    size_t len = dst.meta.wi - num_appended;
+    if (!ignore_checksum) {
+      wuffs_base__slice_u8 s = wuffs_base__make_slice_u8(ptr, len);
+      if (framing == WUFFS_BASE__FOURCC__GZ) {
+        checksum = crc32->update_u32(s);
+      } else if (framing == WUFFS_BASE__FOURCC__ZLIB) {
+        checksum = adler32->update_u32(s);
+      }
+    }
+    num_dst_bytes += len;
+    num_appended = dst.meta.wi;
+    std::string error_message = callbacks.Append(index, ptr, len);
+    if (!error_message.empty()) {
+      return error_message;
+    }
+  }
+  if (keep > dst.meta.wi) {
+    keep = dst.meta.wi;
+  }
+  memmove(dst.data.ptr, dst.data.ptr + dst.meta.wi - keep, keep);
+  dst.meta.wi = keep;
+  num_appended = keep;
+  return "";
+}
+
+}  // namespace
+
+std::vector<DecodeDeflateResult>  //
+DecodeDeflateBatch(DecodeDeflateBatchCallbacks& callbacks,
+                   const std::vector<wuffs_base__slice_u8>& inputs,
+                   uint32_t framing,
+                   wuffs_base__slice_u32 quirks) {
+  bool ignore_checksum = DecodeDeflateIgnoreChecksum(quirks);
+  std::vector<DecodeDeflateResult> results(inputs.size(),
+                                           DecodeDeflateResult("", 0));
+  DecodeDeflateBatchLane lanes[2];
+  for (auto& lane : lanes) {
+    if (!lane.dec || !lane.crc32 || !lane.adler32) {
+      for (auto& result : results) {
+        result.error_message = DecodeDeflate_OutOfMemory;
+      }
+      return results;
+    }
+  }
+
+  size_t next = 0;
+  while (true) {
+    // Run each lane until it is ready to interleave, starting the next input
+    // whenever a lane is done.
+    for (auto& lane : lanes) {
+      while (!lane.ready) {
+        if (!lane.active) {
+          if (next >= inputs.size()) {
+            break;
+          }
+          size_t i = next++;
+          std::string error_message =
+              lane.Start(i, inputs[i], framing, ignore_checksum);
+          if (!error_message.empty()) {
+            results[i] = DecodeDeflateResult(std::move(error_message), 0);
+            continue;
+          }
+        }
+        std::string error_message = lane.Advance(callbacks);
+        if (!lane.active) {
+          results[lane.index] = DecodeDeflateResult(std::move(error_message),
+                                                    lane.num_dst_bytes);
+        }
+      }
+    }
+
+    if (lanes[0].ready && lanes[1].ready) {
+      wuffs_base__status status = lanes[0].dec->decode_interleaved(
+          &lanes[0].dst, &lanes[0].src, lanes[1].dec.get(), &lanes[1].dst,
+          &lanes[1].src);
+      if (!status.is_ok()) {
+        for (auto& lane : lanes) {
+          results[lane.index] =
+              DecodeDeflateResult(status.message(), lane.num_dst_bytes);
+          lane.active = false;
+        }
+      }
+    } else if (!lanes[0].ready && !lanes[1].ready) {
+      break;
+    }
+    // Resume the ready lanes. A lane that has not just been interleaved
+    // decodes the rest of its block by itself.
+    lanes[0].ready = false;
+    lanes[1].ready = false;
+  }
+  return results;
+}
+
+// --------
+
+DecodeDeflateCheckpoint::DecodeDeflateCheckpoint()
+    : dst_pos(0), src_pos(0), pending_bits(0), num_pending_bits(0) {}
+
+DecodeDeflateIndex::DecodeDeflateIndex()
+    : framing(0), spacing(0), num_dst_bytes(0) {}
+
+const DecodeDeflateCheckpoint*  //
+DecodeDeflateIndex::Find(uint64_t dst_pos) const {
+  // Binary search for the number of checkpoints at or before dst_pos.
+  size_t lo = 0;
+  size_t hi = checkpoints.size();
+  while (lo < hi) {
+    size_t mid = lo + ((hi - lo) / 2);
+    if (checkpoints[mid].dst_pos <= dst_pos) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return (lo > 0) ? &checkpoints[lo - 1] : nullptr;
+}
+
+namespace {
+
+void  //
+DecodeDeflateAppendLE(std::string& s, uint64_t x, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    s.push_back((char)(uint8_t)(x >> (8 * i)));
+  }
+}
+
+}  // namespace
+
+std::string  //
+DecodeDeflateIndex::Serialize() const {
+  std::string s("WDIX");
+  DecodeDeflateAppendLE(s, framing, 4);
+  DecodeDeflateAppendLE(s, spacing, 8);
+  DecodeDeflateAppendLE(s, num_dst_bytes, 8);
+  DecodeDeflateAppendLE(s, checkpoints.size(), 4);
+  for (const auto& c : checkpoints) {
+    size_t history_len = (c.history.size() < 32768) ? c.history.size() : 32768;
+    DecodeDeflateAppendLE(s, c.dst_pos, 8);
+    DecodeDeflateAppendLE(s, c.src_pos, 8);
+    DecodeDeflateAppendLE(s, c.num_pending_bits & 7, 1);
+    DecodeDeflateAppendLE(s, c.pending_bits, 1);
+    DecodeDeflateAppendLE(s, history_len, 2);
+    s.append(c.history, c.history.size() - history_len, history_len);
+  }
+  return s;
+}
+
+std::string  //
+DecodeDeflateIndex::Parse(const uint8_t* ptr, size_t len) {
+  framing = 0;
+  spacing = 0;
+  num_dst_bytes = 0;
+  checkpoints.clear();
+
+  if ((len < 28) || (memcmp(ptr, "WDIX", 4) != 0)) {
+    return DecodeDeflate_BadIndex;
+  }
+  uint32_t f = wuffs_base__peek_u32le__no_bounds_check(ptr + 4);
+  uint64_t s = wuffs_base__peek_u64le__no_bounds_check(ptr + 8);
+  uint64_t n = wuffs_base__peek_u64le__no_bounds_check(ptr + 16);
+  uint32_t num_checkpoints = wuffs_base__peek_u32le__no_bounds_check(ptr + 24);
+  ptr += 28;
+  len -= 28;
+
+  std::vector<DecodeDeflateCheckpoint> cs;
+  for (uint32_t i = 0; i < num_checkpoints; i++) {
+    if (len < 20) {
+      return DecodeDeflate_BadIndex;
+    }
+    DecodeDeflateCheckpoint c;
+    c.dst_pos = wuffs_base__peek_u64le__no_bounds_check(ptr + 0);
+    c.src_pos = wuffs_base__peek_u64le__no_bounds_check(ptr + 8);
+    c.num_pending_bits = ptr[16];
+    c.pending_bits = ptr[17];
+    size_t history_len = wuffs_base__peek_u16le__no_bounds_check(ptr + 18);
+    ptr += 20;
+    len -= 20;
+    if ((c.num_pending_bits >= 8) ||
+        ((c.pending_bits >> c.num_pending_bits) != 0) ||
+        (history_len > 32768) || (history_len > len) ||
+        (history_len > c.dst_pos) ||
+        (!cs.empty() && (cs.back().dst_pos > c.dst_pos))) {
+      return DecodeDeflate_BadIndex;
+    }
+    c.history.assign((const char*)ptr, history_len);
+    ptr += history_len;
+    len -= history_len;
+    cs.push_back(std::move(c));
+  }
+  if (len != 0) {
+    return DecodeDeflate_BadIndex;
+  }
+
+  framing = f;
+  spacing = s;
+  num_dst_bytes = n;
+  checkpoints = std::move(cs);
+  return "";
+}
+
+const char DecodeDeflate_BadCheckpoint[] =  //
+    "wuffs_aux::DecodeDeflate: bad checkpoint";
+const char DecodeDeflate_BadIndex[] =  //
+    "wuffs_aux::DecodeDeflate: bad index";
+
+namespace {
+
+DecodeDeflateResult  //
+DecodeDeflateWithIndex0(DecodeDeflateCallbacks& callbacks,
+                        sync_io::Input& input,
+                        DecodeDeflateIndex& index,
+                        uint32_t framing,
+                        uint64_t spacing,
+                        bool ignore_checksum) {
+  index = DecodeDeflateIndex();
+  index.framing = framing;
+  index.spacing = spacing;
+
+  wuffs_deflate__decoder::unique_ptr dec = wuffs_deflate__decoder::alloc();
+  wuffs_crc32__ieee_hasher::unique_ptr crc32 =
+      wuffs_crc32__ieee_hasher::alloc();
+  wuffs_adler32__hasher::unique_ptr adler32 = wuffs_adler32__hasher::alloc();
+  if (!dec || !crc32 || !adler32) {
+    return DecodeDeflateResult(DecodeDeflate_OutOfMemory, 0);
+  }
+  dec->set_quirk_enabled(WUFFS_DEFLATE__QUIRK_SUSPEND_AT_BLOCK_BOUNDARIES,
+                         true);
+
+  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
+  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
+  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
+  if (!io_buf) {
+    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);
+    fallback_io_buf =
+        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);
+    io_buf = &fallback_io_buf;
+  }
+  uint64_t src_pos0 = io_buf->reader_position();
+
+  // Skip the gzip or zlib header, which has to fit in io_buf.
+  while (true) {
+    std::string error_message;
+    size_t header_len = DecodeDeflateHeaderLength(io_buf->reader_slice(),
+                                                  framing, error_message);
+    if (error_message.empty()) {
+      io_buf->meta.ri += header_len;
+      break;
+    } else if ((error_message != DecodeDeflate_UnexpectedEndOfFile) ||
+               ((io_buf->meta.ri == 0) &&
+                (io_buf->meta.wi == io_buf->data.len))) {
+      return DecodeDeflateResult(std::move(error_message), 0);
+    }
+    error_message = DecodeDeflateFill(input, io_buf);
+    if (!error_message.empty()) {
+      return DecodeDeflateResult(std::move(error_message), 0);
+    }
+  }
+  index.checkpoints.push_back(DecodeDeflateCheckpoint());
+  index.checkpoints.back().src_pos = io_buf->reader_position() - src_pos0;
+
+  // dst holds (at least) the most recent 32 KiB of output, as history for
+  // the checkpoints. That history is also valid history for dec.
+  std::unique_ptr<uint8_t[]> dst_array(new uint8_t[3 * 32768]);
+  wuffs_base__io_buffer dst =
+      wuffs_base__ptr_u8__writer(dst_array.get(), 3 * 32768);
+  uint8_t work_array[1];
+  uint32_t checksum = 0;
+
+  while (true) {
+    size_t wi0 = dst.meta.wi;
+    wuffs_base__status status = dec->transform_io(
+        &dst, io_buf, wuffs_base__make_slice_u8(work_array, 0));
+    if (dst.meta.wi > wi0) {
+      wuffs_base__slice_u8 s =
+          wuffs_base__make_slice_u8(dst.data.ptr + wi0, dst.meta.wi - wi0);
+      if (framing == WUFFS_BASE__FOURCC__GZ) {
+        checksum = crc32->update_u32(s);
+      } else if (framing == WUFFS_BASE__FOURCC__ZLIB) {
+        checksum = adler32->update_u32(s);
+      }
+      index.num_dst_bytes += s.len;
+      std::string error_message = callbacks.Append(s.ptr, s.len);
+      if (!error_message.empty()) {
+        return DecodeDeflateResult(std::move(error_message),
+                                   index.num_dst_bytes);
+      }
+    }
+
+    if (status.is_ok()) {
+      break;
+    } else if (status.repr == wuffs_deflate__suspension__block_boundary) {
+      if ((index.num_dst_bytes - index.checkpoints.back().dst_pos) >= spacing) {
+        size_t history_len = (dst.meta.wi < 32768) ? dst.meta.wi : 32768;
+        DecodeDeflateCheckpoint c;
+        c.dst_pos = index.num_dst_bytes;
+        c.src_pos = io_buf->reader_position() - src_pos0;
+        c.pending_bits = dec->pending_bits();
+        c.num_pending_bits = dec->num_pending_bits();
+        c.history.assign(
+            (const char*)(dst.data.ptr + dst.meta.wi - history_len),
+            history_len);
+        index.checkpoints.push_back(std::move(c));
+      }
+    } else if (status.repr == wuffs_base__suspension__short_read) {
+      std::string error_message = DecodeDeflateFill(input, io_buf);
+      if (!error_message.empty()) {
+        return DecodeDeflateResult(std::move(error_message),
+                                   index.num_dst_bytes);
+      }
+    } else if (status.repr != wuffs_base__suspension__short_write) {
+      return DecodeDeflateResult(status.message(), index.num_dst_bytes);
+    }
+
+    if (dst.meta.wi > (2 * 32768)) {
+      memmove(dst.data.ptr, dst.data.ptr + dst.meta.wi - 32768, 32768);
+      dst.meta.wi = 32768;
+    }
+  }
+
+  // Check the gzip or zlib trailer.
+  size_t trailer_len = (framing == WUFFS_BASE__FOURCC__GZ)     ? 8
+                       : (framing == WUFFS_BASE__FOURCC__ZLIB) ? 4
+                                                               : 0;
+  while (io_buf->reader_length() < trailer_len) {
+    std::string error_message = DecodeDeflateFill(input, io_buf);
+    if (!error_message.empty()) {
+      return DecodeDeflateResult(std::move(error_message),
+                                 index.num_dst_bytes);
+    }
+  }
+  const uint8_t* trailer = io_buf->reader_pointer();
+  if (ignore_checksum) {
+    // No-op.
+  } else if (framing == WUFFS_BASE__FOURCC__GZ) {
+    if ((checksum != wuffs_base__peek_u32le__no_bounds_check(trailer + 0)) ||
+        (((uint32_t)(index.num_dst_bytes)) !=
+         wuffs_base__peek_u32le__no_bounds_check(trailer + 4))) {
+      return DecodeDeflateResult(DecodeDeflate_BadChecksum,
+                                 index.num_dst_bytes);
+    }
+  } else if (framing == WUFFS_BASE__FOURCC__ZLIB) {
+    if (checksum != wuffs_base__peek_u32be__no_bounds_check(trailer)) {
+      return DecodeDeflateResult(DecodeDeflate_BadChecksum,
+                                 index.num_dst_bytes);
+    }
+  }
+  io_buf->meta.ri += trailer_len;
+  return DecodeDeflateResult("", index.num_dst_bytes);
+}
+
+DecodeDeflateResult  //
+DecodeDeflateRange0(DecodeDeflateCallbacks& callbacks,
+                    sync_io::Input& input,
+                    const DecodeDeflateCheckpoint& checkpoint,
+                    uint64_t dst_pos,
+                    uint64_t dst_len) {
+  if (checkpoint.dst_pos > dst_pos) {
+    return DecodeDeflateResult(DecodeDeflate_BadCheckpoint, 0);
+  }
+  uint64_t end_pos =
+      (dst_len <= (UINT64_MAX - dst_pos)) ? (dst_pos + dst_len) : UINT64_MAX;
+
+  wuffs_deflate__decoder::unique_ptr dec = wuffs_deflate__decoder::alloc();
+  if (!dec) {
+    return DecodeDeflateResult(DecodeDeflate_OutOfMemory, 0);
+  }
+  std::string error_message = DecodeDeflateRestore(*dec, checkpoint);
+  if (!error_message.empty()) {
+    return DecodeDeflateResult(std::move(error_message), 0);
+  }
+
+  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
+  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
+  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
+  if (!io_buf) {
+    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);
+    fallback_io_buf =
+        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);
+    io_buf = &fallback_io_buf;
+  }
+
+  std::unique_ptr<uint8_t[]> dst_array(
+      new uint8_t[DecodeDeflateScratchLength]);
+  wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(
+      dst_array.get(), DecodeDeflateScratchLength);
+  uint8_t work_array[1];
+  uint64_t pos = checkpoint.dst_pos;
+  uint64_t num_dst_bytes = 0;
+
+  while (pos < end_pos) {
+    dst.meta.wi = 0;
+    wuffs_base__status status = dec->transform_io(
+        &dst, io_buf, wuffs_base__make_slice_u8(work_array, 0));
+
+    // Clip the [pos, pos + dst.meta.wi) output to [dst_pos, end_pos).
+    uint64_t lo = (pos > dst_pos) ? pos : dst_pos;
+    uint64_t hi = ((end_pos - pos) > dst.meta.wi) ? (pos + dst.meta.wi)  //
+                                                  : end_pos;
+    if (lo < hi) {
+      error_message =
+          callbacks.Append(dst.data.ptr + (lo - pos), (size_t)(hi - lo));
+      num_dst_bytes += hi - lo;
+      if (!error_message.empty()) {
+        return DecodeDeflateResult(std::move(error_message), num_dst_bytes);
+      }
+    }
+    pos += dst.meta.wi;
+
+    if (status.is_ok()) {
+      break;
+    } else if (status.repr == wuffs_base__suspension__short_read) {
+      error_message = DecodeDeflateFill(input, io_buf);
+      if (!error_message.empty()) {
+        return DecodeDeflateResult(std::move(error_message), num_dst_bytes);
+      }
+    } else if (status.repr != wuffs_base__suspension__short_write) {
+      return DecodeDeflateResult(status.message(), num_dst_bytes);
+    }
+  }
+  return DecodeDeflateResult("", num_dst_bytes);
+}
+
+}  // namespace
+
+DecodeDeflateResult  //
+DecodeDeflateWithIndex(DecodeDeflateCallbacks& callbacks,
+                       sync_io::Input& input,
+                       DecodeDeflateIndex& index,
+                       uint32_t framing,
+                       uint64_t spacing,
+                       wuffs_base__slice_u32 quirks) {
+  DecodeDeflateResult result =
+      DecodeDeflateWithIndex0(callbacks, input, index, framing, spacing,
+                              DecodeDeflateIgnoreChecksum(quirks));
+  callbacks.Done(result, input);
+  return result;
+}
+
+std::string  //
+DecodeDeflateRestore(wuffs_deflate__decoder& dec,
+                     const DecodeDeflateCheckpoint& checkpoint) {
+  if ((checkpoint.num_pending_bits >= 8) ||
+      (checkpoint.history.size() > 32768)) {
+    return DecodeDeflate_BadCheckpoint;
+  }
+  wuffs_base__status status =
+      dec.initialize(sizeof__wuffs_deflate__decoder(), WUFFS_VERSION,
+                     WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);
+  if (!status.is_ok()) {
+    return status.message();
+  }
+  if (!checkpoint.history.empty()) {
+    dec.add_history(wuffs_base__make_slice_u8(
+        (uint8_t*)(const_cast<char*>(checkpoint.history.data())),
+        checkpoint.history.size()));
+  }
+  dec.set_pending_bits(checkpoint.pending_bits, checkpoint.num_pending_bits);
+  return "";
+}
+
+DecodeDeflateResult  //
+DecodeDeflateRange(DecodeDeflateCallbacks& callbacks,
+                   sync_io::Input& input,
+                   const DecodeDeflateCheckpoint& checkpoint,
+                   uint64_t dst_pos,
+                   uint64_t dst_len) {
+  DecodeDeflateResult result =
+      DecodeDeflateRange0(callbacks, input, checkpoint, dst_pos, dst_len);
+  callbacks.Done(result, input);
+  return result;
+}
+
+}  // namespace wuffs_aux
+
+#endif  // !defined(WUFFS_CONFIG__MODULES) ||
+        // defined(WUFFS_CONFIG__MODULE__AUX__DEFLATE)
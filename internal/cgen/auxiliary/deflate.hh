@@ -0,0 +1,239 @@
+// After editing this file, run "go generate" in the ../data directory.
+
+// Copyright 2021 The Wuffs Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// ---------------- Auxiliary - Deflate
+
+#include <vector>
+
+namespace wuffs_aux {
+
+struct DecodeDeflateResult {
+  DecodeDeflateResult(std::string&& error_message0, uint64_t num_dst_bytes0);
+
+  std::string error_message;
+  uint64_t num_dst_bytes;
+};
+
+class DecodeDeflateCallbacks {
+ public:
+  virtual ~DecodeDeflateCallbacks();
+
+  // Append is called with the decoded output, in order. Each call's ptr is
+  // only valid for the duration of that call. Returning a non-empty string
+  // stops the decoding, with that string as the error_message.
+  //
+  // Even when DecodeDeflate uses multiple threads, Append is only ever called
+  // from the thread that called DecodeDeflate.
+  virtual std::string Append(const uint8_t* ptr, size_t len) = 0;
+
+  // Done is always the last Callback method called by DecodeDeflate, whether
+  // or not decoding the input encountered an error.
+  //
+  // The default Done implementation is a no-op.
+  virtual void  //
+  Done(DecodeDeflateResult& result, sync_io::Input& input);
+};
+
+extern const char DecodeDeflate_BadChecksum[];
+extern const char DecodeDeflate_BadHeader[];
+extern const char DecodeDeflate_OutOfMemory[];
+extern const char DecodeDeflate_UnexpectedEndOfFile[];
+extern const char DecodeDeflate_UnsupportedFraming[];
+
+// DecodeDeflate decodes the compressed data in input, calling callbacks.Append
+// with the decoded output.
+//
+// The framing is one of:
+//  - 0, meaning raw DEFLATE (RFC 1951).
+//  - WUFFS_BASE__FOURCC__GZ, meaning gzip (RFC 1952).
+//  - WUFFS_BASE__FOURCC__ZLIB, meaning zlib (RFC 1950).
+// Only the first gzip member is decoded and zlib preset dictionaries are not
+// supported.
+//
+// When num_threads is 0 or 1, decoding is a single streaming pass that uses
+// O(1) memory. Otherwise, the entire input is read into memory (unless it is
+// already there: a sync_io::MemoryInput) and then split into chunks that are
+// decoded speculatively and in parallel, up to num_threads chunks at a time:
+//  1. Each thread looks for a likely DEFLATE block boundary within its chunk,
+//     confirming it with a trial decode.
+//  2. Each thread decodes from that boundary with a placeholder 32 KiB
+//     history, since the real history (the previous chunk's output) is not
+//     yet known. Back-references into the history produce placeholder bytes.
+//     Decoding is run twice (with two different placeholder histories) to
+//     tell literal bytes apart from placeholders and to identify which
+//     history position each placeholder refers to.
+//  3. The chunks are stitched together in order, replacing placeholders once
+//     the real history is known. A chunk whose speculative starting point
+//     does not line up with where its predecessor actually ended (e.g. a
+//     false positive block boundary) is instead decoded conventionally, so
+//     that the output is always identical to single-threaded decoding.
+//
+// Peak memory usage is therefore the input size plus a bounded amount (on
+// the order of 64 MiB) per thread.
+//
+// WUFFS_BASE__QUIRK_IGNORE_CHECKSUM is the only quirk that has an effect.
+DecodeDeflateResult  //
+DecodeDeflate(DecodeDeflateCallbacks& callbacks,
+              sync_io::Input& input,
+              uint32_t framing = 0,
+              uint32_t num_threads = 1,
+              wuffs_base__slice_u32 quirks = wuffs_base__empty_slice_u32());
+
+// DecodeGzipMembers decodes all of the concatenated gzip members (RFC 1952
+// section 2.2) in input, calling callbacks.Append with the decoded output. The
+// CRC-32 and ISIZE of each member are checked separately.
+//
+// BGZF files (as used by e.g. samtools) are gzip members whose FEXTRA field
+// holds a "BC" subfield: the member's compressed size. When num_threads is
+// more than 1, such members are read ahead (without decoding) and then
+// decoded in parallel, in batches, by a pool of per-thread gzip decoders. The
+// batches are bounded (WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH, 4 MiB by
+// default, of decoded output per thread) and the output is reassembled in
+// order. Members without a "BC" subfield are decoded single-threaded, as
+// their length is not known up front. For well-formed BGZF "BC" subfields,
+// the output and any error message are the same as for num_threads == 1.
+//
+// WUFFS_BASE__QUIRK_IGNORE_CHECKSUM is the only quirk that has an effect.
+DecodeDeflateResult  //
+DecodeGzipMembers(DecodeDeflateCallbacks& callbacks,
+                  sync_io::Input& input,
+                  uint32_t num_threads = 1,
+                  wuffs_base__slice_u32 quirks = wuffs_base__empty_slice_u32());
+
+// --------
+
+class DecodeDeflateBatchCallbacks {
+ public:
+  virtual ~DecodeDeflateBatchCallbacks();
+
+  // Append is called with the i'th input's decoded output, in order. Calls
+  // for different inputs can be interleaved. Each call's ptr is only valid
+  // for the duration of that call. Returning a non-empty string stops the
+  // decoding of the i'th input, with that string as its error_message.
+  virtual std::string Append(size_t i, const uint8_t* ptr, size_t len) = 0;
+};
+
+// DecodeDeflateBatch decodes each of the inputs, independent compressed
+// streams that are entirely in memory, calling callbacks.Append with their
+// decoded output. It returns one DecodeDeflateResult per input. The framing
+// is as for DecodeDeflate.
+//
+// It is optimized for many small inputs. Decoding a Huffman-compressed block
+// is usually bound by the latency of its (dependent) table lookups, so two
+// inputs are decoded at a time, on the calling thread, with their blocks'
+// symbols decoded in one interleaved loop (see the deflate decoder's
+// decode_interleaved method) to overlap those lookups. Each input's output
+// and result are the same as DecodeDeflate's (single-threaded) would be.
+//
+// WUFFS_BASE__QUIRK_IGNORE_CHECKSUM is the only quirk that has an effect.
+std::vector<DecodeDeflateResult>  //
+DecodeDeflateBatch(
+    DecodeDeflateBatchCallbacks& callbacks,
+    const std::vector<wuffs_base__slice_u8>& inputs,
+    uint32_t framing = 0,
+    wuffs_base__slice_u32 quirks = wuffs_base__empty_slice_u32());
+
+// --------
+
+// DecodeDeflateCheckpoint is a point in a DEFLATE stream (always a block
+// boundary) from which decoding can resume, without having to decode
+// everything before it.
+struct DecodeDeflateCheckpoint {
+  DecodeDeflateCheckpoint();
+
+  // dst_pos is the position in the decoded output.
+  uint64_t dst_pos;
+  // src_pos is the position in the compressed input (including any gzip or
+  // zlib header) of the first whole byte after the block boundary.
+  uint64_t src_pos;
+  // pending_bits and num_pending_bits (less than 8) are the bits of the byte
+  // at src_pos-1 that are after the block boundary.
+  uint32_t pending_bits;
+  uint32_t num_pending_bits;
+  // history is the (up to) 32 KiB of decoded output just before dst_pos.
+  std::string history;
+};
+
+// DecodeDeflateIndex is a list of DecodeDeflateCheckpoints, in increasing
+// dst_pos order. It is similar to zlib's examples/zran.c program.
+struct DecodeDeflateIndex {
+  DecodeDeflateIndex();
+
+  // Find returns the last checkpoint whose dst_pos is at or before dst_pos,
+  // or nullptr if there is no such checkpoint.
+  const DecodeDeflateCheckpoint* Find(uint64_t dst_pos) const;
+
+  // Serialize returns the index in a compact binary format that Parse reads.
+  // All integers are little-endian:
+  //  - 4 byte magic "WDIX", then u32 framing, u64 spacing, u64 num_dst_bytes
+  //    and u32 number of checkpoints.
+  //  - For each checkpoint: u64 dst_pos, u64 src_pos, u8 num_pending_bits, u8
+  //    pending_bits, u16 history length and then the history bytes.
+  std::string Serialize() const;
+
+  // Parse replaces the index's contents with the serialized form in (ptr,
+  // len). It returns an empty string on success or an error message.
+  std::string Parse(const uint8_t* ptr, size_t len);
+
+  uint32_t framing;
+  uint64_t spacing;
+  uint64_t num_dst_bytes;
+  std::vector<DecodeDeflateCheckpoint> checkpoints;
+};
+
+extern const char DecodeDeflate_BadCheckpoint[];
+extern const char DecodeDeflate_BadIndex[];
+
+// DecodeDeflateWithIndex is like single-threaded DecodeDeflate but also
+// replaces index's contents with checkpoints. The first checkpoint is at the
+// start of the DEFLATE stream. Each subsequent checkpoint is at the first
+// block boundary that is at least spacing bytes (of decoded output) after
+// the previous checkpoint.
+//
+// With a spacing of N, decoding from a checkpoint to reach any given position
+// decodes at most N bytes plus the length of one DEFLATE block.
+DecodeDeflateResult  //
+DecodeDeflateWithIndex(
+    DecodeDeflateCallbacks& callbacks,
+    sync_io::Input& input,
+    DecodeDeflateIndex& index,
+    uint32_t framing = 0,
+    uint64_t spacing = 1024 * 1024,
+    wuffs_base__slice_u32 quirks = wuffs_base__empty_slice_u32());
+
+// DecodeDeflateRestore re-initializes dec so that it resumes decoding at the
+// checkpoint. The caller is responsible for then feeding dec the compressed
+// input starting at checkpoint.src_pos. It returns an empty string on success
+// or an error message.
+std::string  //
+DecodeDeflateRestore(wuffs_deflate__decoder& dec,
+                     const DecodeDeflateCheckpoint& checkpoint);
+
+// DecodeDeflateRange calls callbacks.Append with the decoded output in the
+// range [dst_pos, dst_pos + dst_len), clipped to the end of the DEFLATE
+// stream, by decoding from the checkpoint. The checkpoint is typically
+// index.Find(dst_pos) and its dst_pos must not be after dst_pos.
+//
+// The input must start at checkpoint.src_pos, e.g. after a fseek call. Since
+// decoding does not start at the beginning, no checksums are verified.
+DecodeDeflateResult  //
+DecodeDeflateRange(DecodeDeflateCallbacks& callbacks,
+                   sync_io::Input& input,
+                   const DecodeDeflateCheckpoint& checkpoint,
+                   uint64_t dst_pos,
+                   uint64_t dst_len);
+
+}  // namespace wuffs_aux
@@ -18,7 +18,20 @@
 
 #if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__AUX__IMAGE)
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <utility>
+#include <vector>
+
+// WUFFS_AUX__DECODE_IMAGE__PNG_NUM_BATCHES is the number of batches (of
+// decompressed IDAT data) that the pipelined PNG decoder's inflating thread
+// can run ahead by.
+#ifndef WUFFS_AUX__DECODE_IMAGE__PNG_NUM_BATCHES
+#define WUFFS_AUX__DECODE_IMAGE__PNG_NUM_BATCHES 8
+#endif
 
 namespace wuffs_aux {
 
@@ -163,6 +176,8 @@ const char DecodeImage_OutOfMemory[] =  //
     "wuffs_aux::DecodeImage: out of memory";
 const char DecodeImage_UnexpectedEndOfFile[] =  //
     "wuffs_aux::DecodeImage: unexpected end of file";
+const char DecodeImage_UnsupportedDownscaleShift[] =  //
+    "wuffs_aux::DecodeImage: unsupported downscale shift";
 const char DecodeImage_UnsupportedImageFormat[] =  //
     "wuffs_aux::DecodeImage: unsupported image format";
 const char DecodeImage_UnsupportedPixelBlend[] =  //
@@ -206,6 +221,41 @@ DecodeImageAdvanceIOBuf(sync_io::Input& input,
   return "";
 }
 
+// DecodeImageDownscale box filters src, a full size BGRA_PREMUL pixel buffer,
+// down to dst. It is for image formats whose decoders cannot downscale as
+// they decode.
+std::string  //
+DecodeImageDownscale(wuffs_base__pixel_buffer& dst,
+                     wuffs_base__pixel_buffer& src,
+                     wuffs_base__pixel_blend pixel_blend,
+                     uint32_t downscale_shift) {
+  uint8_t dst_palette_array[1024];
+  wuffs_base__slice_u8 dst_palette = dst.palette_or_else(
+      wuffs_base__make_slice_u8(dst_palette_array, 1024));
+  wuffs_base__pixel_swizzler swizzler;
+  wuffs_base__status status = swizzler.prepare_downscaled(
+      dst.pixel_format(), dst_palette, src.pixel_format(),
+      wuffs_base__empty_slice_u8(), pixel_blend);
+  if (status.repr != nullptr) {
+    return status.message();
+  }
+
+  uint32_t w = src.pixcfg.width();
+  uint32_t h = src.pixcfg.height();
+  std::vector<uint8_t> accum(8 * (((size_t)(w >> downscale_shift)) + 2));
+  wuffs_base__table_u8 dst_tab = dst.plane(0);
+  wuffs_base__table_u8 src_tab = src.plane(0);
+  for (uint32_t y = 0; y < h; y++) {
+    wuffs_base__slice_u8 row = wuffs_base__table_u8__row(src_tab, y);
+    row.len = std::min(row.len, 4 * ((size_t)w));
+    swizzler.swizzle_downscaled_from_slice(
+        dst_tab, dst_palette,
+        wuffs_base__make_slice_u8(accum.data(), accum.size()), row,
+        downscale_shift, 0, y, 0, h);
+  }
+  return "";
+}
+
 DecodeImageResult  //
 DecodeImage0(wuffs_base__image_decoder::unique_ptr& image_decoder,
              DecodeImageCallbacks& callbacks,
@@ -213,7 +263,8 @@ DecodeImage0(wuffs_base__image_decoder::unique_ptr& image_decoder,
              wuffs_base__io_buffer& io_buf,
              wuffs_base__pixel_blend pixel_blend,
              wuffs_base__color_u32_argb_premul background_color,
-             uint32_t max_incl_dimension) {
+             uint32_t max_incl_dimension,
+             uint32_t downscale_shift) {
   // Check args.
   switch (pixel_blend) {
     case WUFFS_BASE__PIXEL_BLEND__SRC:
@@ -222,6 +273,9 @@ DecodeImage0(wuffs_base__image_decoder::unique_ptr& image_decoder,
     default:
       return DecodeImageResult(DecodeImage_UnsupportedPixelBlend);
   }
+  if (downscale_shift > 3) {
+    return DecodeImageResult(DecodeImage_UnsupportedDownscaleShift);
+  }
 
   wuffs_base__image_config image_config = wuffs_base__null_image_config();
   uint64_t start_pos = io_buf.reader_position();
@@ -327,6 +381,42 @@ redirect:
                             WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, w, h);
   }
 
+  // Downscale. The PNG and GIF decoders can do so as they decode. Other
+  // image formats are decoded, at full size, to a temporary BGRA_PREMUL pixel
+  // buffer that is then box filtered down to the allocated pixel buffer.
+  wuffs_base__decode_frame_options decode_frame_options = {};
+  wuffs_base__pixel_buffer full_pixel_buffer = {};
+  MemOwner full_mem_owner(nullptr, &free);
+  if (downscale_shift > 0) {
+    if ((fourcc == WUFFS_BASE__FOURCC__PNG) ||
+        (fourcc == WUFFS_BASE__FOURCC__GIF)) {
+      decode_frame_options.set_downscale_shift(downscale_shift);
+    } else {
+      wuffs_base__pixel_config full_pixcfg;
+      full_pixcfg.set(WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL,
+                      WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, w, h);
+      uint64_t len = full_pixcfg.pixbuf_len();
+      if ((len == 0) || (SIZE_MAX < len)) {
+        return DecodeImageResult(DecodeImage_UnsupportedPixelConfiguration);
+      }
+      void* ptr = calloc((size_t)len, 1);
+      if (!ptr) {
+        return DecodeImageResult(DecodeImage_OutOfMemory);
+      }
+      full_mem_owner.reset(ptr);
+      wuffs_base__status status = full_pixel_buffer.set_from_slice(
+          &full_pixcfg, wuffs_base__make_slice_u8((uint8_t*)ptr, (size_t)len));
+      if (status.repr != nullptr) {
+        return DecodeImageResult(status.message());
+      }
+    }
+    uint32_t mask = (1u << downscale_shift) - 1;
+    image_config.pixcfg.set(image_config.pixcfg.pixel_format().repr,
+                            WUFFS_BASE__PIXEL_SUBSAMPLING__NONE,
+                            (w >> downscale_shift) + ((w & mask) ? 1 : 0),
+                            (h >> downscale_shift) + ((h & mask) ? 1 : 0));
+  }
+
   // Allocate the pixel buffer.
   bool valid_background_color =
       wuffs_base__color_u32_argb_premul__is_valid(background_color);
@@ -345,8 +435,12 @@ redirect:
   }
 
   // Allocate the work buffer. Wuffs' decoders conventionally assume that this
-  // can be uninitialized memory.
+  // can be uninitialized memory. Downscaling decoders need more than the
+  // minimum length, so ask for the maximum.
   wuffs_base__range_ii_u64 workbuf_len = image_decoder->workbuf_len();
+  if (decode_frame_options.downscale_shift() > 0) {
+    workbuf_len.min_incl = workbuf_len.max_incl;
+  }
   DecodeImageCallbacks::AllocWorkbufResult alloc_workbuf_result =
       callbacks.AllocWorkbuf(workbuf_len, true);
   if (!alloc_workbuf_result.error_message.empty()) {
@@ -383,10 +477,12 @@ redirect:
       frame_config.overwrite_instead_of_blend()) {
     pixel_blend = WUFFS_BASE__PIXEL_BLEND__SRC;
   }
+  bool full_size = full_mem_owner != nullptr;
   while (true) {
-    wuffs_base__status id_df_status =
-        image_decoder->decode_frame(&pixel_buffer, &io_buf, pixel_blend,
-                                    alloc_workbuf_result.workbuf, nullptr);
+    wuffs_base__status id_df_status = image_decoder->decode_frame(
+        full_size ? &full_pixel_buffer : &pixel_buffer, &io_buf,
+        full_size ? WUFFS_BASE__PIXEL_BLEND__SRC : pixel_blend,
+        alloc_workbuf_result.workbuf, &decode_frame_options);
     if (id_df_status.repr == nullptr) {
       break;
     } else if (id_df_status.repr != wuffs_base__suspension__short_read) {
@@ -403,18 +499,381 @@ redirect:
       }
     }
   }
+  if (full_size) {
+    std::string error_message = DecodeImageDownscale(
+        pixel_buffer, full_pixel_buffer, pixel_blend, downscale_shift);
+    if (message.empty()) {
+      message = std::move(error_message);
+    }
+  }
   return DecodeImageResult(std::move(alloc_pixbuf_result.mem_owner),
                            pixel_buffer, std::move(message));
 }
 
-}  // namespace
+// DecodeImageReadAll returns the entire input, either in its own I/O buffer
+// or after copying it into storage.
+std::string  //
+DecodeImageReadAll(sync_io::Input& input,
+                   std::vector<uint8_t>& storage,
+                   wuffs_base__slice_u8* all) {
+  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
+  if (io_buf && io_buf->meta.closed) {
+    *all = io_buf->reader_slice();
+    return "";
+  }
+  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
+  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
+  if (!io_buf) {
+    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);
+    fallback_io_buf =
+        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);
+    io_buf = &fallback_io_buf;
+  }
+  while (true) {
+    storage.insert(storage.end(), io_buf->reader_pointer(),
+                   io_buf->reader_pointer() + io_buf->reader_length());
+    io_buf->meta.ri = io_buf->meta.wi;
+    if (io_buf->meta.closed) {
+      break;
+    }
+    io_buf->compact();
+    std::string error_message = input.CopyIn(io_buf);
+    if (!error_message.empty()) {
+      return error_message;
+    }
+  }
+  *all = wuffs_base__make_slice_u8(storage.data(), storage.size());
+  return "";
+}
 
+#if !defined(WUFFS_CONFIG__MODULES) ||                                      \
+    (defined(WUFFS_CONFIG__MODULE__ADLER32) &&                              \
+     defined(WUFFS_CONFIG__MODULE__CRC32) &&                                \
+     defined(WUFFS_CONFIG__MODULE__PNG) && defined(WUFFS_CONFIG__MODULE__ZLIB))
+#define WUFFS_AUX__DECODE_IMAGE__PNG_PIPELINE
+#endif
+
+#if defined(WUFFS_AUX__DECODE_IMAGE__PNG_PIPELINE)
+
+// DecodeImageFindIDAT returns the position of the first IDAT chunk (its
+// length field) in the PNG image s, or 0 if s is not a PNG image or has no
+// IDAT chunk.
+size_t  //
+DecodeImageFindIDAT(wuffs_base__slice_u8 s) {
+  static const uint8_t signature[8] = {
+      0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A,
+  };
+  if ((s.len < 8) || memcmp(s.ptr, signature, 8)) {
+    return 0;
+  }
+  size_t pos = 8;
+  while ((s.len - pos) >= 12) {
+    uint32_t chunk_len = wuffs_base__peek_u32be__no_bounds_check(s.ptr + pos);
+    uint32_t chunk_type =
+        wuffs_base__peek_u32le__no_bounds_check(s.ptr + pos + 4);
+    if (chunk_type == 0x54414449) {  // "IDAT" as a little-endian u32.
+      return pos;
+    } else if ((s.len - pos - 12) < chunk_len) {
+      break;
+    }
+    pos += 12 + (size_t)chunk_len;
+  }
+  return 0;
+}
+
+// DecodeImagePngPipeline is a sync_io::Input that splits decoding a PNG
+// image across two threads. A second thread inflates the IDAT chunks' zlib
+// stream, a batch at a time, into a bounded ring of batches. The calling
+// thread reads those batches back as a new but equivalent PNG image, whose
+// IDAT chunks hold the decompressed data as zlib stored (uncompressed)
+// blocks, so that the regular PNG decoder (which then only has to copy the
+// stored blocks before un-filtering and swizzling) runs concurrently with
+// the inflating.
+//
+// The IDAT chunks' CRC-32 and the zlib stream's Adler-32 checksums of the
+// original image are not verified. Those of the new image are valid.
+class DecodeImagePngPipeline : public sync_io::Input {
+ public:
+  DecodeImagePngPipeline(wuffs_base__slice_u8 src, size_t idat_pos);
+  ~DecodeImagePngPipeline();
+
+  virtual std::string CopyIn(IOBuffer* dst);
+
+ private:
+  // kBatchLength is the maximum length of a zlib stored block.
+  static const size_t kBatchLength = 65535;
+
+  void Inflate();
+  std::string Inflate0();
+  bool Push(std::vector<uint8_t>&& batch);
+
+  wuffs_base__slice_u8 m_src;
+  size_t m_idat_pos;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  std::deque<std::vector<uint8_t>> m_batches;
+  std::string m_error_message;
+  bool m_done;
+  bool m_cancelled;
+
+  // Only the calling thread uses m_curr and m_curr_ri.
+  std::vector<uint8_t> m_curr;
+  size_t m_curr_ri;
+
+  std::thread m_thread;
+
+  // Delete the copy and assign constructors.
+  DecodeImagePngPipeline(const DecodeImagePngPipeline&) = delete;
+  DecodeImagePngPipeline& operator=(const DecodeImagePngPipeline&) = delete;
+};
+
+DecodeImagePngPipeline::DecodeImagePngPipeline(wuffs_base__slice_u8 src,
+                                               size_t idat_pos)
+    : m_src(src),
+      m_idat_pos(idat_pos),
+      m_done(false),
+      m_cancelled(false),
+      m_curr(src.ptr, src.ptr + idat_pos),
+      m_curr_ri(0),
+      m_thread(&DecodeImagePngPipeline::Inflate, this) {}
+
+DecodeImagePngPipeline::~DecodeImagePngPipeline() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cancelled = true;
+  }
+  m_cond.notify_all();
+  m_thread.join();
+}
+
+std::string  //
+DecodeImagePngPipeline::CopyIn(IOBuffer* dst) {
+  if (!dst) {
+    return "wuffs_aux::DecodeImagePngPipeline: nullptr IOBuffer";
+  } else if (dst->meta.closed) {
+    return "wuffs_aux::DecodeImagePngPipeline: end of file";
+  }
+  dst->compact();
+  while (dst->writer_length() > 0) {
+    if (m_curr_ri < m_curr.size()) {
+      size_t n = std::min(dst->writer_length(), m_curr.size() - m_curr_ri);
+      memcpy(dst->writer_pointer(), m_curr.data() + m_curr_ri, n);
+      dst->meta.wi += n;
+      m_curr_ri += n;
+      continue;
+    } else if (dst->reader_length() > 0) {
+      // Return what we have instead of waiting for the next batch.
+      break;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cond.wait(lock, [this] { return !m_batches.empty() || m_done; });
+    if (m_batches.empty()) {
+      dst->meta.closed = true;
+      return m_error_message;
+    }
+    m_curr = std::move(m_batches.front());
+    m_curr_ri = 0;
+    m_batches.pop_front();
+    lock.unlock();
+    m_cond.notify_all();
+  }
+  return "";
+}
+
+void  //
+DecodeImagePngPipeline::Inflate() {
+  std::string error_message = Inflate0();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_error_message = std::move(error_message);
+    m_done = true;
+  }
+  m_cond.notify_all();
+}
+
+// Inflate0 runs on the second thread. It returns an empty string on success
+// or an error message.
+std::string  //
+DecodeImagePngPipeline::Inflate0() {
+  auto dec = wuffs_zlib__decoder::alloc();
+  auto crc32 = wuffs_crc32__ieee_hasher::alloc();
+  auto adler32 = wuffs_adler32__hasher::alloc();
+  if (!dec || !crc32 || !adler32) {
+    return DecodeImage_OutOfMemory;
+  }
+  dec->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, true);
+
+  // Each batch is one IDAT chunk: an 8 byte chunk header, the 2 byte zlib
+  // header (for the first batch only), a 5 byte stored block header, up to
+  // kBatchLength bytes of decompressed data and a 4 byte CRC-32.
+  static const size_t max_batch_len = 8 + 2 + 5 + kBatchLength + 4;
+  static const size_t work_len =
+      WUFFS_ZLIB__DECODER_WORKBUF_LEN_MAX_INCL_WORST_CASE;
+  uint8_t work_array[work_len];
+  size_t pos = m_idat_pos;
+  uint32_t idat_remaining = 0;
+  bool first_batch = true;
+  bool eof = false;
+  std::string error_message;
+  while (!eof && error_message.empty()) {
+    std::vector<uint8_t> batch(max_batch_len);
+    size_t data_pos = first_batch ? 15 : 13;
+    size_t n = 0;
+    while (n < kBatchLength) {
+      // Find the next IDAT chunk's payload, when we have finished the last.
+      if (idat_remaining == 0) {
+        if ((m_src.len - pos) < 8) {
+          error_message = DecodeImage_UnexpectedEndOfFile;
+          break;
+        }
+        uint32_t chunk_len =
+            wuffs_base__peek_u32be__no_bounds_check(m_src.ptr + pos);
+        uint32_t chunk_type =
+            wuffs_base__peek_u32le__no_bounds_check(m_src.ptr + pos + 4);
+        if (chunk_type != 0x54414449) {  // "IDAT" as a little-endian u32.
+          // The zlib stream has not finished, yet there is no more IDAT data.
+          error_message = DecodeImage_UnexpectedEndOfFile;
+          break;
+        }
+        pos += 8;
+        // Like the single-threaded decoder, decompress as much of a truncated
+        // chunk's payload as there is.
+        idat_remaining = (uint32_t)std::min<size_t>(chunk_len, m_src.len - pos);
+        if (idat_remaining == 0) {
+          pos = std::min(m_src.len, pos + 4);
+          if (chunk_len > 0) {
+            error_message = DecodeImage_UnexpectedEndOfFile;
+            break;
+          }
+          continue;
+        }
+      }
+
+      // Each transform_io call starts with an empty dst (with no history), as
+      // the decoder has already copied earlier output into its own history.
+      wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(
+          batch.data() + data_pos + n, kBatchLength - n);
+      wuffs_base__io_buffer src =
+          wuffs_base__ptr_u8__reader(m_src.ptr + pos, idat_remaining, false);
+      wuffs_base__status status = dec->transform_io(
+          &dst, &src, wuffs_base__make_slice_u8(work_array, work_len));
+      n += dst.meta.wi;
+      pos += src.meta.ri;
+      idat_remaining -= (uint32_t)src.meta.ri;
+      if (idat_remaining == 0) {
+        pos = std::min(m_src.len, pos + 4);  // Skip the CRC-32.
+      }
+      if (status.repr == nullptr) {
+        eof = true;
+        break;
+      } else if ((status.repr != wuffs_base__suspension__short_read) &&
+                 (status.repr != wuffs_base__suspension__short_write)) {
+        error_message = status.message();
+        break;
+      }
+    }
+
+    // Pass on what was decompressed, even after an error, so that the
+    // calling thread can still decode a partial image.
+    adler32->update_u32(wuffs_base__make_slice_u8(batch.data() + data_pos, n));
+    uint8_t* p = batch.data();
+    wuffs_base__poke_u32be__no_bounds_check(p + 0,
+                                            (uint32_t)(data_pos - 8 + n));
+    wuffs_base__poke_u32le__no_bounds_check(p + 4, 0x54414449);
+    if (first_batch) {
+      // 0x7801 is a valid zlib header (with no preset dictionary). The window
+      // size is irrelevant for stored blocks.
+      p[8] = 0x78;
+      p[9] = 0x01;
+    }
+    p[data_pos - 5] = 0x00;  // A non-final stored block.
+    wuffs_base__poke_u16le__no_bounds_check(p + data_pos - 4, (uint16_t)n);
+    wuffs_base__poke_u16le__no_bounds_check(p + data_pos - 2,
+                                            (uint16_t)(n ^ 0xFFFF));
+    wuffs_base__poke_u32be__no_bounds_check(
+        p + data_pos + n,
+        crc32->update_u32(wuffs_base__make_slice_u8(p + 4, data_pos - 4 + n)));
+    batch.resize(data_pos + n + 4);
+    wuffs_base__status status =
+        crc32->initialize(sizeof__wuffs_crc32__ieee_hasher(), WUFFS_VERSION, 0);
+    if (!status.is_ok()) {
+      return status.message();
+    }
+    first_batch = false;
+    if (!Push(std::move(batch))) {
+      return "";
+    }
+  }
+  if (!error_message.empty()) {
+    return error_message;
+  }
+
+  // Skip the rest of the zlib stream's IDAT chunks: any bytes after the end of
+  // the stream and any further IDAT chunks.
+  if (idat_remaining > 0) {
+    pos = std::min(m_src.len, pos + idat_remaining + 4);
+  }
+  while ((m_src.len - pos) >= 8) {
+    uint32_t chunk_len =
+        wuffs_base__peek_u32be__no_bounds_check(m_src.ptr + pos);
+    uint32_t chunk_type =
+        wuffs_base__peek_u32le__no_bounds_check(m_src.ptr + pos + 4);
+    if (chunk_type != 0x54414449) {  // "IDAT" as a little-endian u32.
+      break;
+    }
+    pos += std::min<size_t>(m_src.len - pos, 12 + (size_t)chunk_len);
+  }
+
+  // Finish with an IDAT chunk that holds a final (and empty) stored block and
+  // the zlib Adler-32 checksum, then the original bytes after the IDAT chunks
+  // (such as tEXt chunks and the IEND chunk), so that decoding metadata that
+  // comes after the pixel data sees the same chunks as single-threaded
+  // decoding does.
+  std::vector<uint8_t> batch(8 + 9 + 4);
+  uint8_t* p = batch.data();
+  wuffs_base__poke_u32be__no_bounds_check(p + 0, 9);
+  wuffs_base__poke_u32le__no_bounds_check(p + 4, 0x54414449);
+  p[8] = 0x01;
+  wuffs_base__poke_u32be__no_bounds_check(p + 9, 0x0000FFFF);
+  wuffs_base__poke_u32be__no_bounds_check(
+      p + 13, adler32->update_u32(wuffs_base__empty_slice_u8()));
+  wuffs_base__poke_u32be__no_bounds_check(
+      p + 17, crc32->update_u32(wuffs_base__make_slice_u8(p + 4, 13)));
+  batch.insert(batch.end(), m_src.ptr + pos, m_src.ptr + m_src.len);
+  Push(std::move(batch));
+  return "";
+}
+
+// Push adds a batch to the ring, waiting until there is room for it. It
+// returns false if the calling thread has given up on decoding.
+bool  //
+DecodeImagePngPipeline::Push(std::vector<uint8_t>&& batch) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cond.wait(lock, [this] {
+    return (m_batches.size() < WUFFS_AUX__DECODE_IMAGE__PNG_NUM_BATCHES) ||
+           m_cancelled;
+  });
+  if (m_cancelled) {
+    return false;
+  }
+  m_batches.push_back(std::move(batch));
+  lock.unlock();
+  m_cond.notify_all();
+  return true;
+}
+
+#endif  // defined(WUFFS_AUX__DECODE_IMAGE__PNG_PIPELINE)
+
+// DecodeImage1 is DecodeImage, single-threaded.
 DecodeImageResult  //
-DecodeImage(DecodeImageCallbacks& callbacks,
-            sync_io::Input& input,
-            wuffs_base__pixel_blend pixel_blend,
-            wuffs_base__color_u32_argb_premul background_color,
-            uint32_t max_incl_dimension) {
+DecodeImage1(DecodeImageCallbacks& callbacks,
+             sync_io::Input& input,
+             wuffs_base__pixel_blend pixel_blend,
+             wuffs_base__color_u32_argb_premul background_color,
+             uint32_t max_incl_dimension,
+             uint32_t downscale_shift) {
   wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
   wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
   std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
@@ -428,11 +887,674 @@ DecodeImage(DecodeImageCallbacks& callbacks,
   wuffs_base__image_decoder::unique_ptr image_decoder(nullptr, &free);
   DecodeImageResult result =
       DecodeImage0(image_decoder, callbacks, input, *io_buf, pixel_blend,
-                   background_color, max_incl_dimension);
+                   background_color, max_incl_dimension, downscale_shift);
   callbacks.Done(result, input, *io_buf, std::move(image_decoder));
   return result;
 }
 
+}  // namespace
+
+DecodeImageResult  //
+DecodeImage(DecodeImageCallbacks& callbacks,
+            sync_io::Input& input,
+            wuffs_base__pixel_blend pixel_blend,
+            wuffs_base__color_u32_argb_premul background_color,
+            uint32_t max_incl_dimension,
+            uint32_t num_threads,
+            uint32_t downscale_shift) {
+#if defined(WUFFS_AUX__DECODE_IMAGE__PNG_PIPELINE)
+  if (num_threads > 1) {
+    std::vector<uint8_t> storage;
+    wuffs_base__slice_u8 all = wuffs_base__empty_slice_u8();
+    std::string error_message = DecodeImageReadAll(input, storage, &all);
+    if (!error_message.empty()) {
+      DecodeImageResult result(std::move(error_message));
+      wuffs_base__io_buffer empty_io_buf = wuffs_base__empty_io_buffer();
+      callbacks.Done(result, input, empty_io_buf,
+                     wuffs_base__image_decoder::unique_ptr(nullptr, &free));
+      return result;
+    }
+    size_t idat_pos = DecodeImageFindIDAT(all);
+    if (idat_pos > 0) {
+      DecodeImagePngPipeline pipeline(all, idat_pos);
+      return DecodeImage1(callbacks, pipeline, pixel_blend, background_color,
+                          max_incl_dimension, downscale_shift);
+    }
+    sync_io::MemoryInput memory_input(all.ptr, all.len);
+    return DecodeImage1(callbacks, memory_input, pixel_blend, background_color,
+                        max_incl_dimension, downscale_shift);
+  }
+#endif  // defined(WUFFS_AUX__DECODE_IMAGE__PNG_PIPELINE)
+
+  return DecodeImage1(callbacks, input, pixel_blend, background_color,
+                      max_incl_dimension, downscale_shift);
+}
+
+// --------
+
+IndexFramesResult::IndexFramesResult(wuffs_base__image_config image_config0,
+                                     std::vector<Frame>&& frames0,
+                                     std::string&& error_message0)
+    : image_config(image_config0),
+      frames(std::move(frames0)),
+      error_message(std::move(error_message0)) {}
+
+size_t  //
+IndexFramesResult::KeyframeFor(size_t n) const {
+  if (frames.empty()) {
+    return 0;
+  }
+  n = std::min(n, frames.size() - 1);
+  while ((n > 0) && !frames[n].keyframe) {
+    n--;
+  }
+  return n;
+}
+
+IndexFramesResult  //
+IndexFrames(wuffs_base__image_decoder& image_decoder, sync_io::Input& input) {
+  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
+  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
+  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
+  if (!io_buf) {
+    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);
+    fallback_io_buf =
+        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);
+    io_buf = &fallback_io_buf;
+  }
+
+  wuffs_base__image_config image_config = wuffs_base__null_image_config();
+  std::vector<IndexFramesResult::Frame> frames;
+  while (true) {
+    wuffs_base__status status =
+        image_decoder.decode_image_config(&image_config, io_buf);
+    if (status.repr == nullptr) {
+      break;
+    } else if (status.repr == wuffs_base__note__i_o_redirect) {
+      return IndexFramesResult(image_config, std::move(frames),
+                               DecodeImage_UnsupportedImageFormat);
+    } else if (status.repr != wuffs_base__suspension__short_read) {
+      return IndexFramesResult(image_config, std::move(frames),
+                               status.message());
+    } else if (io_buf->meta.closed) {
+      return IndexFramesResult(image_config, std::move(frames),
+                               DecodeImage_UnexpectedEndOfFile);
+    }
+    std::string error_message = input.CopyIn(io_buf);
+    if (!error_message.empty()) {
+      return IndexFramesResult(image_config, std::move(frames),
+                               std::move(error_message));
+    }
+  }
+
+  wuffs_base__rect_ie_u32 canvas = image_config.pixcfg.bounds();
+  // The canvas starts out cleared, so the first frame is a keyframe.
+  bool cleared = true;
+  while (true) {
+    wuffs_base__frame_config frame_config = wuffs_base__null_frame_config();
+    wuffs_base__status status =
+        image_decoder.decode_frame_config(&frame_config, io_buf);
+    if (status.repr == wuffs_base__note__end_of_data) {
+      break;
+    } else if (status.repr == wuffs_base__suspension__short_read) {
+      if (io_buf->meta.closed) {
+        return IndexFramesResult(image_config, std::move(frames),
+                                 DecodeImage_UnexpectedEndOfFile);
+      }
+      std::string error_message = input.CopyIn(io_buf);
+      if (!error_message.empty()) {
+        return IndexFramesResult(image_config, std::move(frames),
+                                 std::move(error_message));
+      }
+      continue;
+    } else if (status.repr != nullptr) {
+      return IndexFramesResult(image_config, std::move(frames),
+                               status.message());
+    }
+
+    bool covers_canvas = frame_config.bounds().contains_rect(canvas);
+    IndexFramesResult::Frame frame;
+    frame.io_position = frame_config.io_position();
+    frame.bounds = frame_config.bounds();
+    frame.duration = frame_config.duration();
+    frame.disposal = frame_config.disposal();
+    frame.keyframe =
+        cleared ||
+        (covers_canvas &&
+         (frame.disposal != WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_PREVIOUS) &&
+         (frame_config.opaque_within_bounds() ||
+          frame_config.overwrite_instead_of_blend()));
+    frames.push_back(frame);
+    cleared = covers_canvas &&
+              (frame.disposal ==
+               WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_BACKGROUND);
+  }
+  return IndexFramesResult(image_config, std::move(frames), "");
+}
+
+// --------
+
+#if !defined(WUFFS_CONFIG__MODULES) || \
+    (defined(WUFFS_CONFIG__MODULE__GIF) && defined(WUFFS_CONFIG__MODULE__LZW))
+#define WUFFS_AUX__DECODE_GIF_FRAMES
+#endif
+
+#if defined(WUFFS_AUX__DECODE_GIF_FRAMES)
+
+DecodeGifFramesCallbacks::~DecodeGifFramesCallbacks() {}
+
+DecodeGifFramesResult::DecodeGifFramesResult(uint64_t num_frames0,
+                                             std::string&& error_message0)
+    : num_frames(num_frames0), error_message(std::move(error_message0)) {}
+
+const char DecodeGifFrames_OutOfMemory[] =  //
+    "wuffs_aux::DecodeGifFrames: out of memory";
+
+namespace {
+
+// DecodeGifFramesSlot holds one decoded frame: its palette indices, in an
+// INDEXED__BGRA_BINARY pixel buffer the size of the whole image, of which
+// only the dirty_rect is meaningful.
+struct DecodeGifFramesSlot {
+  std::vector<uint8_t> memory;
+  wuffs_base__pixel_buffer pixbuf;
+  wuffs_base__frame_config frame_config;
+  wuffs_base__rect_ie_u32 dirty_rect;
+  std::string error_message;
+};
+
+// DecodeGifFramesCanvas composites DecodeGifFramesSlots, in frame order, and
+// applies each frame's disposal afterwards.
+class DecodeGifFramesCanvas {
+ public:
+  std::string Init(const wuffs_base__image_config& image_config,
+                   std::vector<DecodeGifFramesSlot>& slots);
+  std::string Composite(DecodeGifFramesCallbacks& callbacks,
+                        DecodeGifFramesSlot& slot);
+
+ private:
+  std::vector<uint8_t> m_memory;
+  std::vector<uint8_t> m_saved;
+  wuffs_base__pixel_buffer m_pixbuf;
+};
+
+std::string  //
+DecodeGifFramesCanvas::Init(const wuffs_base__image_config& image_config,
+                            std::vector<DecodeGifFramesSlot>& slots) {
+  uint32_t w = image_config.pixcfg.width();
+  uint32_t h = image_config.pixcfg.height();
+  uint64_t wh = (uint64_t)w * (uint64_t)h;
+  if (wh > (SIZE_MAX / 4)) {
+    return DecodeGifFrames_OutOfMemory;
+  }
+  m_memory.assign(4 * (size_t)wh, 0);
+  wuffs_base__pixel_config pixcfg;
+  pixcfg.set(WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL,
+             WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, w, h);
+  wuffs_base__status status = m_pixbuf.set_from_slice(
+      &pixcfg, wuffs_base__make_slice_u8(m_memory.data(), m_memory.size()));
+  if (!status.is_ok()) {
+    return status.message();
+  }
+
+  pixcfg.set(WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_BINARY,
+             WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, w, h);
+  for (auto& slot : slots) {
+    slot.memory.resize(
+        WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH + (size_t)wh);
+    status = slot.pixbuf.set_from_slice(
+        &pixcfg, wuffs_base__make_slice_u8(slot.memory.data(),
+                                           slot.memory.size()));
+    if (!status.is_ok()) {
+      return status.message();
+    }
+  }
+  return "";
+}
+
+std::string  //
+DecodeGifFramesCanvas::Composite(DecodeGifFramesCallbacks& callbacks,
+                                 DecodeGifFramesSlot& slot) {
+  const wuffs_base__frame_config& fc = slot.frame_config;
+  if (fc.disposal() == WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_PREVIOUS) {
+    m_saved = m_memory;
+  }
+
+  // The swizzler converts the frame's palette to the canvas' pixel format,
+  // in dst_palette.
+  uint8_t dst_palette_array[1024];
+  wuffs_base__slice_u8 dst_palette =
+      wuffs_base__make_slice_u8(dst_palette_array, 1024);
+  wuffs_base__pixel_swizzler swizzler;
+  wuffs_base__status status = swizzler.prepare(
+      m_pixbuf.pixel_format(), dst_palette, slot.pixbuf.pixel_format(),
+      slot.pixbuf.palette(),
+      fc.overwrite_instead_of_blend() ? WUFFS_BASE__PIXEL_BLEND__SRC
+                                      : WUFFS_BASE__PIXEL_BLEND__SRC_OVER);
+  if (!status.is_ok()) {
+    return status.message();
+  }
+  wuffs_base__rect_ie_u32 r = slot.dirty_rect;
+  wuffs_base__table_u8 dst_tab = m_pixbuf.plane(0);
+  wuffs_base__table_u8 src_tab = slot.pixbuf.plane(0);
+  for (uint32_t y = r.min_incl_y; y < r.max_excl_y; y++) {
+    wuffs_base__slice_u8 dst = wuffs_base__table_u8__row(dst_tab, y);
+    wuffs_base__slice_u8 src = wuffs_base__table_u8__row(src_tab, y);
+    swizzler.swizzle_interleaved_from_slice(
+        wuffs_base__slice_u8__subslice_ij(dst, 4 * (size_t)r.min_incl_x,
+                                          4 * (size_t)r.max_excl_x),
+        dst_palette,
+        wuffs_base__slice_u8__subslice_ij(src, r.min_incl_x, r.max_excl_x));
+  }
+
+  std::string error_message = callbacks.Frame(fc, m_pixbuf);
+
+  if (fc.disposal() == WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_BACKGROUND) {
+    wuffs_base__rect_ie_u32 b = fc.bounds();
+    wuffs_base__color_u32_argb_premul color = fc.background_color();
+    for (uint32_t y = b.min_incl_y; y < b.max_excl_y; y++) {
+      uint8_t* p = wuffs_base__table_u8__row(dst_tab, y).ptr;
+      for (uint32_t x = b.min_incl_x; x < b.max_excl_x; x++) {
+        wuffs_base__poke_u32le__no_bounds_check(p + (4 * (size_t)x), color);
+      }
+    }
+  } else if (fc.disposal() ==
+             WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_PREVIOUS) {
+    std::copy(m_saved.begin(), m_saved.end(), m_memory.begin());
+  }
+  return error_message;
+}
+
+// DecodeGifFramesOne decodes the frame at index i of all, the entire input,
+// into slot. The image_decoder must have already decoded the image config.
+void  //
+DecodeGifFramesOne(wuffs_base__image_decoder& image_decoder,
+                   wuffs_base__slice_u8 all,
+                   const IndexFramesResult::Frame& frame,
+                   uint64_t i,
+                   DecodeGifFramesSlot& slot) {
+  slot.error_message.clear();
+  wuffs_base__status status =
+      image_decoder.restart_frame(i, frame.io_position);
+  if (!status.is_ok()) {
+    slot.error_message = status.message();
+    return;
+  } else if (frame.io_position > all.len) {
+    slot.error_message = DecodeImage_UnexpectedEndOfFile;
+    return;
+  }
+  wuffs_base__io_buffer src =
+      wuffs_base__ptr_u8__reader(all.ptr, all.len, true);
+  src.meta.ri = (size_t)frame.io_position;
+
+  status = image_decoder.decode_frame_config(&slot.frame_config, &src);
+  if (status.is_ok()) {
+    status = image_decoder.decode_frame(&slot.pixbuf, &src,
+                                        WUFFS_BASE__PIXEL_BLEND__SRC,
+                                        wuffs_base__empty_slice_u8(), nullptr);
+  }
+  if (status.repr == wuffs_base__suspension__short_read) {
+    slot.error_message = DecodeImage_UnexpectedEndOfFile;
+  } else if (!status.is_ok()) {
+    slot.error_message = status.message();
+  }
+  slot.dirty_rect = image_decoder.frame_dirty_rect();
+}
+
+DecodeGifFramesResult  //
+DecodeGifFramesSerial(DecodeGifFramesCallbacks& callbacks,
+                      sync_io::Input& input) {
+  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
+  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
+  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
+  if (!io_buf) {
+    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);
+    fallback_io_buf =
+        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);
+    io_buf = &fallback_io_buf;
+  }
+
+  auto dec = wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder();
+  if (!dec) {
+    return DecodeGifFramesResult(0, DecodeGifFrames_OutOfMemory);
+  }
+  std::vector<DecodeGifFramesSlot> slots(1);
+  DecodeGifFramesSlot& slot = slots[0];
+  DecodeGifFramesCanvas canvas;
+  uint64_t num_frames = 0;
+  wuffs_base__image_config image_config = wuffs_base__null_image_config();
+
+  // Each call (decode_image_config, decode_frame_config or decode_frame) is
+  // retried after short reads.
+  for (int stage = 0; true;) {
+    wuffs_base__status status;
+    if (stage == 0) {
+      status = dec->decode_image_config(&image_config, io_buf);
+    } else if (stage == 1) {
+      status = dec->decode_frame_config(&slot.frame_config, io_buf);
+    } else {
+      status = dec->decode_frame(&slot.pixbuf, io_buf,
+                                 WUFFS_BASE__PIXEL_BLEND__SRC,
+                                 wuffs_base__empty_slice_u8(), nullptr);
+    }
+
+    if (status.repr == wuffs_base__suspension__short_read) {
+      if (io_buf->meta.closed) {
+        return DecodeGifFramesResult(num_frames,
+                                     DecodeImage_UnexpectedEndOfFile);
+      }
+      std::string error_message = input.CopyIn(io_buf);
+      if (!error_message.empty()) {
+        return DecodeGifFramesResult(num_frames, std::move(error_message));
+      }
+      continue;
+    } else if ((stage == 1) && (status.repr == wuffs_base__note__end_of_data)) {
+      break;
+    } else if (!status.is_ok()) {
+      return DecodeGifFramesResult(num_frames, status.message());
+    }
+
+    if (stage == 0) {
+      std::string error_message = canvas.Init(image_config, slots);
+      if (!error_message.empty()) {
+        return DecodeGifFramesResult(num_frames, std::move(error_message));
+      }
+      stage = 1;
+    } else if (stage == 1) {
+      stage = 2;
+    } else {
+      slot.dirty_rect = dec->frame_dirty_rect();
+      std::string error_message = canvas.Composite(callbacks, slot);
+      num_frames++;
+      if (!error_message.empty()) {
+        return DecodeGifFramesResult(num_frames, std::move(error_message));
+      }
+      stage = 1;
+    }
+  }
+  return DecodeGifFramesResult(num_frames, "");
+}
+
+}  // namespace
+
+DecodeGifFramesResult  //
+DecodeGifFrames(DecodeGifFramesCallbacks& callbacks,
+                sync_io::Input& input,
+                uint32_t num_threads) {
+  if (num_threads <= 1) {
+    return DecodeGifFramesSerial(callbacks, input);
+  }
+
+  std::vector<uint8_t> storage;
+  wuffs_base__slice_u8 all = wuffs_base__empty_slice_u8();
+  std::string error_message = DecodeImageReadAll(input, storage, &all);
+  if (!error_message.empty()) {
+    return DecodeGifFramesResult(0, std::move(error_message));
+  }
+
+  // Index the frames. The indexing decoder is then the calling thread's
+  // decoder. The other threads' decoders are created lazily, as not every
+  // animation has num_threads frames.
+  std::vector<wuffs_base__image_decoder::unique_ptr> decoders;
+  decoders.push_back(wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder());
+  if (!decoders[0]) {
+    return DecodeGifFramesResult(0, DecodeGifFrames_OutOfMemory);
+  }
+  sync_io::MemoryInput memory_input(all.ptr, all.len);
+  IndexFramesResult index = IndexFrames(*decoders[0], memory_input);
+  const size_t num_frames = index.frames.size();
+  if (num_frames == 0) {
+    return DecodeGifFramesResult(0, std::move(index.error_message));
+  } else if (!index.error_message.empty()) {
+    // The indexing decoder stopped mid-way through a suspended
+    // decode_frame_config call, so it cannot restart_frame.
+    decoders.clear();
+  }
+
+  std::vector<DecodeGifFramesSlot> slots(
+      std::min<size_t>(num_threads, std::max<size_t>(num_frames, 1)));
+  DecodeGifFramesCanvas canvas;
+  error_message = canvas.Init(index.image_config, slots);
+  if (!error_message.empty()) {
+    return DecodeGifFramesResult(0, std::move(error_message));
+  }
+  while (decoders.size() < slots.size()) {
+    auto dec = wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder();
+    if (!dec) {
+      return DecodeGifFramesResult(0, DecodeGifFrames_OutOfMemory);
+    }
+    wuffs_base__io_buffer src =
+        wuffs_base__ptr_u8__reader(all.ptr, all.len, true);
+    wuffs_base__status status = dec->decode_image_config(nullptr, &src);
+    if (!status.is_ok()) {
+      return DecodeGifFramesResult(0, status.message());
+    }
+    decoders.push_back(std::move(dec));
+  }
+
+  // Decode each round's frames concurrently, the first on this thread, and
+  // then composite them in order.
+  for (size_t r0 = 0; r0 < num_frames; r0 += slots.size()) {
+    size_t r1 = std::min(num_frames, r0 + slots.size());
+    std::vector<std::thread> threads;
+    for (size_t i = r0 + 1; i < r1; i++) {
+      threads.emplace_back([&, i]() {
+        DecodeGifFramesOne(*decoders[i - r0], all, index.frames[i], i,
+                           slots[i - r0]);
+      });
+    }
+    DecodeGifFramesOne(*decoders[0], all, index.frames[r0], r0, slots[0]);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (size_t i = r0; i < r1; i++) {
+      DecodeGifFramesSlot& slot = slots[i - r0];
+      if (!slot.error_message.empty()) {
+        return DecodeGifFramesResult(i, std::move(slot.error_message));
+      }
+      error_message = canvas.Composite(callbacks, slot);
+      if (!error_message.empty()) {
+        return DecodeGifFramesResult(i + 1, std::move(error_message));
+      }
+    }
+  }
+  return DecodeGifFramesResult(num_frames, std::move(index.error_message));
+}
+
+#endif  // defined(WUFFS_AUX__DECODE_GIF_FRAMES)
+
+// --------
+
+#if !defined(WUFFS_CONFIG__MODULES) ||                                      \
+    (defined(WUFFS_CONFIG__MODULE__ADLER32) &&                              \
+     defined(WUFFS_CONFIG__MODULE__CRC32) &&                                \
+     defined(WUFFS_CONFIG__MODULE__DEFLATE) &&                              \
+     defined(WUFFS_CONFIG__MODULE__PNG))
+#define WUFFS_AUX__ENCODE_PNG
+#endif
+
+#if defined(WUFFS_AUX__ENCODE_PNG)
+
+EncodePngResult::EncodePngResult(std::string&& dst0,
+                                 std::string&& error_message0)
+    : dst(std::move(dst0)), error_message(std::move(error_message0)) {}
+
+const char EncodePng_OutOfMemory[] =  //
+    "wuffs_aux::EncodePng: out of memory";
+
+namespace {
+
+// EncodePngRows appends, to dst, either the complete PNG image (if y1 is
+// zero) or the zlib-compressed IDAT data for the rows y0 .. y1. For the
+// latter, it also sets *strip_adler32 to that data's uncompressed Adler-32
+// checksum.
+std::string  //
+EncodePngRows(std::string& dst,
+              uint32_t* strip_adler32,
+              wuffs_base__pixel_buffer& src,
+              uint32_t level,
+              uint32_t y0,
+              uint32_t y1) {
+  wuffs_png__encoder::unique_ptr enc = wuffs_png__encoder::alloc();
+  if (!enc) {
+    return EncodePng_OutOfMemory;
+  }
+  enc->set_level(level);
+  wuffs_base__status status = enc->prepare(&src);
+  if (!status.is_ok()) {
+    return status.message();
+  }
+  std::vector<uint8_t> workbuf(enc->workbuf_len().max_incl);
+  wuffs_base__slice_u8 w =
+      wuffs_base__make_slice_u8(workbuf.data(), workbuf.size());
+
+  uint8_t buf[32768];
+  while (true) {
+    wuffs_base__io_buffer io_buf = wuffs_base__ptr_u8__writer(buf, sizeof buf);
+    status = (y1 == 0) ? enc->encode_image(&io_buf, &src, w)
+                       : enc->encode_strip(&io_buf, &src, y0, y1, w);
+    dst.append(reinterpret_cast<const char*>(buf), io_buf.meta.wi);
+    if (status.repr != wuffs_base__suspension__short_write) {
+      break;
+    }
+  }
+  if (!status.is_ok()) {
+    return status.message();
+  }
+  if (strip_adler32) {
+    *strip_adler32 = enc->strip_adler32();
+  }
+  return "";
+}
+
+// EncodePngChunk appends a PNG chunk, with the given type and payload, to
+// dst. Long payloads are split over multiple chunks of the same type.
+std::string  //
+EncodePngChunk(std::string& dst, uint32_t chunk_type, std::string& data) {
+  // kMaxChunkLength is well under the PNG specification's 0x7FFF_FFFF limit.
+  static const size_t kMaxChunkLength = 0x100000;
+  auto crc32 = wuffs_crc32__ieee_hasher::alloc();
+  if (!crc32) {
+    return EncodePng_OutOfMemory;
+  }
+  size_t i = 0;
+  do {
+    size_t n = std::min(data.size() - i, kMaxChunkLength);
+    uint8_t header[8];
+    wuffs_base__poke_u32be__no_bounds_check(header + 0, (uint32_t)n);
+    wuffs_base__poke_u32be__no_bounds_check(header + 4, chunk_type);
+    crc32->update_u32(wuffs_base__make_slice_u8(header + 4, 4));
+    uint8_t footer[4];
+    wuffs_base__poke_u32be__no_bounds_check(
+        footer, crc32->update_u32(wuffs_base__make_slice_u8(
+                    reinterpret_cast<uint8_t*>(&data[0]) + i, n)));
+    dst.append(reinterpret_cast<const char*>(header), 8);
+    dst.append(data, i, n);
+    dst.append(reinterpret_cast<const char*>(footer), 4);
+    i += n;
+
+    wuffs_base__status status =
+        crc32->initialize(sizeof__wuffs_crc32__ieee_hasher(), WUFFS_VERSION, 0);
+    if (!status.is_ok()) {
+      return status.message();
+    }
+  } while (i < data.size());
+  return "";
+}
+
+}  // namespace
+
+EncodePngResult  //
+EncodePng(wuffs_base__pixel_buffer& src,
+          uint32_t level,
+          uint32_t num_threads) {
+  std::string dst;
+  uint32_t height = src.pixcfg.height();
+  uint32_t num_strips = std::min(num_threads, height);
+  if (num_strips <= 1) {
+    std::string error_message = EncodePngRows(dst, nullptr, src, level, 0, 0);
+    if (!error_message.empty()) {
+      return EncodePngResult("", std::move(error_message));
+    }
+    return EncodePngResult(std::move(dst), "");
+  }
+
+  // Compress the strips concurrently, the first on this thread.
+  std::vector<std::string> strips(num_strips);
+  std::vector<uint32_t> strip_adler32s(num_strips);
+  std::vector<std::string> error_messages(num_strips);
+  auto encode_strip = [&](uint32_t i) {
+    uint32_t y0 = (uint32_t)(((uint64_t)height * (i + 0)) / num_strips);
+    uint32_t y1 = (uint32_t)(((uint64_t)height * (i + 1)) / num_strips);
+    error_messages[i] =
+        EncodePngRows(strips[i], &strip_adler32s[i], src, level, y0, y1);
+  };
+  std::vector<std::thread> threads;
+  for (uint32_t i = 1; i < num_strips; i++) {
+    threads.emplace_back(encode_strip, i);
+  }
+  encode_strip(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& error_message : error_messages) {
+    if (!error_message.empty()) {
+      return EncodePngResult("", std::move(error_message));
+    }
+  }
+
+  // The zlib checksum is the strips' checksums, combined. Each strip's
+  // uncompressed data is one filter byte and then the pixel bytes per row.
+  auto adler32 = wuffs_adler32__hasher::alloc();
+  if (!adler32) {
+    return EncodePngResult("", EncodePng_OutOfMemory);
+  }
+  wuffs_base__pixel_format pixfmt = src.pixcfg.pixel_format();
+  uint32_t bits_per_pixel = pixfmt.bits_per_pixel();
+  uint64_t bytes_per_row =
+      1 + ((uint64_t)src.pixcfg.width() * (bits_per_pixel / 8));
+  uint32_t checksum = 1;
+  for (uint32_t i = 0; i < num_strips; i++) {
+    uint32_t y0 = (uint32_t)(((uint64_t)height * (i + 0)) / num_strips);
+    uint32_t y1 = (uint32_t)(((uint64_t)height * (i + 1)) / num_strips);
+    checksum = adler32->combine_u32(checksum, strip_adler32s[i],
+                                    (y1 - y0) * bytes_per_row);
+  }
+  uint8_t checksum_bytes[4];
+  wuffs_base__poke_u32be__no_bounds_check(checksum_bytes, checksum);
+  strips.back().append(reinterpret_cast<const char*>(checksum_bytes), 4);
+
+  // The signature, the IHDR chunk, the IDAT chunks and the IEND chunk. The
+  // pixel buffer's format was already checked by the wuffs_png__encoders.
+  dst.append("\x89PNG\r\n\x1A\n", 8);
+  uint8_t ihdr[13];
+  wuffs_base__poke_u32be__no_bounds_check(ihdr + 0, src.pixcfg.width());
+  wuffs_base__poke_u32be__no_bounds_check(ihdr + 4, height);
+  ihdr[8] = 8;
+  ihdr[9] = (bits_per_pixel == 8) ? 0 : (bits_per_pixel == 24) ? 2 : 6;
+  ihdr[10] = 0;
+  ihdr[11] = 0;
+  ihdr[12] = 0;
+  std::string chunk(reinterpret_cast<const char*>(ihdr), 13);
+  std::string error_message =
+      EncodePngChunk(dst, 0x49484452, chunk);  // "IHDR" as a big-endian u32.
+  for (uint32_t i = 0; error_message.empty() && (i < num_strips); i++) {
+    error_message = EncodePngChunk(dst, 0x49444154, strips[i]);  // "IDAT".
+    strips[i].clear();
+  }
+  if (error_message.empty()) {
+    chunk.clear();
+    error_message = EncodePngChunk(dst, 0x49454E44, chunk);  // "IEND".
+  }
+  if (!error_message.empty()) {
+    return EncodePngResult("", std::move(error_message));
+  }
+  return EncodePngResult(std::move(dst), "");
+}
+
+#endif  // defined(WUFFS_AUX__ENCODE_PNG)
+
 }  // namespace wuffs_aux
 
 #endif  // !defined(WUFFS_CONFIG__MODULES) ||
@@ -16,6 +16,8 @@
 
 // ---------------- Auxiliary - Image
 
+#include <vector>
+
 namespace wuffs_aux {
 
 struct DecodeImageResult {
@@ -160,6 +162,7 @@ extern const char DecodeImage_BufferIsTooShort[];
 extern const char DecodeImage_MaxInclDimensionExceeded[];
 extern const char DecodeImage_OutOfMemory[];
 extern const char DecodeImage_UnexpectedEndOfFile[];
+extern const char DecodeImage_UnsupportedDownscaleShift[];
 extern const char DecodeImage_UnsupportedImageFormat[];
 extern const char DecodeImage_UnsupportedPixelBlend[];
 extern const char DecodeImage_UnsupportedPixelConfiguration[];
@@ -208,11 +211,153 @@ extern const char DecodeImage_UnsupportedPixelFormat[];
 //
 // Decoding fails (with DecodeImage_MaxInclDimensionExceeded) if the image's
 // width or height is greater than max_incl_dimension.
+//
+// When num_threads is 0 or 1, decoding is single-threaded and streams the
+// input. Otherwise, the entire input is read into memory (unless it is already
+// there: a sync_io::MemoryInput) and, for PNG images, decoding is pipelined
+// across two threads. A second thread inflates the zlib-compressed IDAT data
+// while the calling thread un-filters and swizzles rows that have already
+// been inflated. All of the callbacks are still called from the calling
+// thread, but the IDAT chunks' CRC-32 and the zlib Adler-32 checksums are not
+// verified. Other image formats are decoded single-threaded. Either way, the
+// input passed to Done is then the in-memory input that was decoded, which
+// continues after the image data just like the original input would.
+//
+// When downscale_shift is 1, 2 or 3, the image is reduced to 1/2, 1/4 or 1/8
+// of its width and height (rounding up), e.g. for thumbnails, and AllocPixbuf
+// is only asked for that reduced size. Each pixel is the average of a block of
+// full size pixels (see wuffs_base__decode_frame_options__set_downscale_shift).
+// PNG and GIF images are downscaled as they are decoded (stopping early for
+// interlaced images). Other image formats are decoded to a temporary, full
+// size, pixel buffer first. The max_incl_dimension applies to the full size.
+// Larger shifts fail with DecodeImage_UnsupportedDownscaleShift.
 DecodeImageResult  //
 DecodeImage(DecodeImageCallbacks& callbacks,
             sync_io::Input& input,
             wuffs_base__pixel_blend pixel_blend = WUFFS_BASE__PIXEL_BLEND__SRC,
             wuffs_base__color_u32_argb_premul background_color = 1,  // Invalid.
-            uint32_t max_incl_dimension = 1048575);  // 0x000F_FFFF
+            uint32_t max_incl_dimension = 1048575,  // 0x000F_FFFF
+            uint32_t num_threads = 1,
+            uint32_t downscale_shift = 0);
+
+// --------
+
+struct IndexFramesResult {
+  // Frame is an animation frame's entry in the index. A keyframe can be
+  // composited without any earlier frames, starting from a canvas cleared to
+  // the background: either it is the first frame, or the previous frame's
+  // disposal restores the whole canvas to the background, or it covers the
+  // whole canvas and replaces every pixel (because it is opaque or because
+  // it overwrites instead of blends). In that last case, its own disposal
+  // must not be RESTORE_PREVIOUS, as later frames would then need the canvas
+  // from before it.
+  struct Frame {
+    uint64_t io_position;
+    wuffs_base__rect_ie_u32 bounds;
+    wuffs_base__flicks duration;
+    wuffs_base__animation_disposal disposal;
+    bool keyframe;
+  };
+
+  IndexFramesResult(wuffs_base__image_config image_config0,
+                    std::vector<Frame>&& frames0,
+                    std::string&& error_message0);
+
+  // KeyframeFor returns the index of the nearest keyframe at or before frame
+  // n. Rendering frame n only needs frames from there onwards.
+  size_t KeyframeFor(size_t n) const;
+
+  wuffs_base__image_config image_config;
+  std::vector<Frame> frames;
+  std::string error_message;
+};
+
+// IndexFrames walks an animated image once, with decode_frame_config, to
+// record every frame's io_position, bounds, duration and disposal. The pixel
+// data is skipped, not decoded. The image_decoder must be freshly created
+// (e.g. by wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder) and
+// afterwards it can seek to frame n, for any index n, by calling
+// restart_frame(k, frames[k].io_position), with k being KeyframeFor(n), then
+// decoding frames k to n from that io_position in its input.
+//
+// On failure (including a truncated input), error_message is non-empty but
+// frames still lists the frames indexed before the failure. The image_decoder
+// may then be mid-way through a suspended call and cannot seek: decode those
+// frames with another (fresh) decoder instead.
+IndexFramesResult  //
+IndexFrames(wuffs_base__image_decoder& image_decoder, sync_io::Input& input);
+
+// --------
+
+class DecodeGifFramesCallbacks {
+ public:
+  virtual ~DecodeGifFramesCallbacks();
+
+  // Frame is called from the calling thread, once per frame and in frame
+  // order, after that frame has been composited onto the canvas. The canvas
+  // is a BGRA_PREMUL pixel buffer the size of the whole image, and is only
+  // valid for the duration of the call. Returning a non-empty string stops
+  // decoding, with that string as the error_message.
+  virtual std::string  //
+  Frame(const wuffs_base__frame_config& frame_config,
+        const wuffs_base__pixel_buffer& canvas) = 0;
+};
+
+struct DecodeGifFramesResult {
+  DecodeGifFramesResult(uint64_t num_frames0, std::string&& error_message0);
+  // num_frames is the number of callbacks.Frame calls.
+  uint64_t num_frames;
+  std::string error_message;
+};
+
+extern const char DecodeGifFrames_OutOfMemory[];
+
+// DecodeGifFrames decodes every frame of an (animated) GIF image, compositing
+// each over the canvas left by the previous frame's disposal.
+//
+// When num_threads is 0 or 1, frames are decoded one at a time. Otherwise,
+// the entire input is read into memory and indexed (see IndexFrames). Frames
+// are then decoded in rounds of num_threads frames, each frame's palette
+// indices into its own buffer on its own thread, by a per-thread
+// wuffs_gif__decoder (and its wuffs_lzw__decoder) that is re-used from one
+// round to the next via restart_frame. LZW decoding is independent from one
+// frame to the next. Compositing is not, so after each round the calling
+// thread composites that round's frames, in order.
+DecodeGifFramesResult  //
+DecodeGifFrames(DecodeGifFramesCallbacks& callbacks,
+                sync_io::Input& input,
+                uint32_t num_threads = 1);
+
+// --------
+
+struct EncodePngResult {
+  EncodePngResult(std::string&& dst0, std::string&& error_message0);
+
+  std::string dst;
+  std::string error_message;
+};
+
+extern const char EncodePng_OutOfMemory[];
+
+// EncodePng encodes the src pixel buffer as a PNG image. Its pixel format
+// must be 8 (Y), 24 (e.g. BGR or RGB) or 32 (e.g. BGRA_PREMUL or
+// RGBA_NONPREMUL) bits per pixel, giving a gray, RGB or RGBA PNG image. The
+// level is the compression level, from 0 (no compression) to 9 (best).
+//
+// When num_threads is 0 or 1, encoding is single-threaded. Otherwise, the
+// image is split into num_threads horizontal strips (or fewer, for very short
+// images). Each strip is filtered and compressed on its own thread, by its own
+// wuffs_png__encoder, as DEFLATE blocks that end with a full flush. The
+// calling thread then joins the strips, one or more IDAT chunks each, as a
+// single zlib stream and combines the strips' Adler-32 checksums. Compression
+// is slightly worse than single-threaded, since no strip can refer back to an
+// earlier strip's data.
+//
+// On success, the EncodePngResult's error_message is empty and dst holds the
+// PNG image. On failure, error_message is non-empty.
+EncodePngResult  //
+EncodePng(wuffs_base__pixel_buffer& src,
+          uint32_t level = 6,
+          uint32_t num_threads = 1);
 
 }  // namespace wuffs_aux
@@ -78,6 +78,10 @@
 // POPCNT. This is checked at runtime via cpuid, not at compile time.
 //
 // Likewise, "cpu_arch >= x86_avx2" also requires PCLMUL, POPCNT and SSE4.2.
+//
+// And "cpu_arch >= x86_avx512" requires AVX-512F, AVX-512BW, AVX-512VL and
+// VPCLMULQDQ (Ice Lake, Zen 4 or later), as well as everything that
+// "cpu_arch >= x86_avx2" requires.
 #if defined(__x86_64__) && !defined(__native_client__)
 #include <cpuid.h>
 #include <x86intrin.h>
@@ -196,6 +200,71 @@ wuffs_base__cpu_arch__have_x86_avx2() {
   return false;
 }
 
+static inline bool  //
+wuffs_base__cpu_arch__have_x86_avx512() {
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+  // GCC defines these macros but MSVC does not.
+  //  - bit_AVX2     = (1 <<  5)
+  //  - bit_AVX512F  = (1 << 16)
+  //  - bit_AVX512BW = (1 << 30)
+  //  - bit_AVX512VL = (1 << 31)
+  const unsigned int avx512_ebx7 = 0xC0010020;
+  // GCC defines these macros but MSVC does not.
+  //  - bit_VPCLMULQDQ = (1 << 10)
+  const unsigned int avx512_ecx7 = 0x00000400;
+  // GCC defines these macros but MSVC does not.
+  //  - bit_PCLMUL  = (1 <<  1)
+  //  - bit_POPCNT  = (1 << 23)
+  //  - bit_SSE4_2  = (1 << 20)
+  //  - bit_OSXSAVE = (1 << 27)
+  const unsigned int avx512_ecx1 = 0x08900002;
+  // The OS must also save and restore the AVX-512 register state: XCR0 bits 1
+  // (SSE), 2 (AVX), 5 (opmask), 6 (ZMM_Hi256) and 7 (Hi16_ZMM).
+  const unsigned int avx512_xcr0 = 0x000000E6;
+
+  // clang defines __GNUC__ and clang-cl defines _MSC_VER (but not __GNUC__).
+#if defined(__GNUC__)
+  unsigned int eax7 = 0;
+  unsigned int ebx7 = 0;
+  unsigned int ecx7 = 0;
+  unsigned int edx7 = 0;
+  if (__get_cpuid_count(7, 0, &eax7, &ebx7, &ecx7, &edx7) &&
+      ((ebx7 & avx512_ebx7) == avx512_ebx7) &&
+      ((ecx7 & avx512_ecx7) == avx512_ecx7)) {
+    unsigned int eax1 = 0;
+    unsigned int ebx1 = 0;
+    unsigned int ecx1 = 0;
+    unsigned int edx1 = 0;
+    if (__get_cpuid(1, &eax1, &ebx1, &ecx1, &edx1) &&
+        ((ecx1 & avx512_ecx1) == avx512_ecx1)) {
+      // Use inline assembly, as the _xgetbv intrinsic needs "-mxsave".
+      unsigned int xcr0_lo = 0;
+      unsigned int xcr0_hi = 0;
+      __asm__ __volatile__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+      if ((xcr0_lo & avx512_xcr0) == avx512_xcr0) {
+        return true;
+      }
+    }
+  }
+#elif defined(_MSC_VER)  // defined(__GNUC__)
+  int x7[4];
+  __cpuidex(x7, 7, 0);
+  if (((((unsigned int)(x7[1])) & avx512_ebx7) == avx512_ebx7) &&
+      ((((unsigned int)(x7[2])) & avx512_ecx7) == avx512_ecx7)) {
+    int x1[4];
+    __cpuid(x1, 1);
+    if (((((unsigned int)(x1[2])) & avx512_ecx1) == avx512_ecx1) &&
+        ((((unsigned int)(_xgetbv(0))) & avx512_xcr0) == avx512_xcr0)) {
+      return true;
+    }
+  }
+#else
+#error "WUFFS_BASE__CPU_ARCH__ETC combined with an unsupported compiler"
+#endif  // defined(__GNUC__); defined(_MSC_VER)
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+  return false;
+}
+
 static inline bool  //
 wuffs_base__cpu_arch__have_x86_bmi2() {
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
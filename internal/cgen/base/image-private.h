@@ -42,4 +42,6 @@ wuffs_base__pixel_swizzler__swizzle_interleaved_transparent_black(
 
 // ---------------- Images (Utility)
 
+#define wuffs_base__utility__make_pixel_blend(repr) \
+  ((wuffs_base__pixel_blend)(repr))
 #define wuffs_base__utility__make_pixel_format wuffs_base__make_pixel_format
@@ -1128,6 +1128,12 @@ typedef struct wuffs_base__pixel_buffer__struct {
   inline wuffs_base__status set_color_u32_fill_rect(
       wuffs_base__rect_ie_u32 rect,
       wuffs_base__color_u32_argb_premul color);
+  inline wuffs_base__status composite(
+      const struct wuffs_base__pixel_buffer__struct* src,
+      uint32_t dst_x,
+      uint32_t dst_y,
+      wuffs_base__rect_ie_u32 clip,
+      wuffs_base__pixel_blend blend);
 #endif  // __cplusplus
 
 } wuffs_base__pixel_buffer;
@@ -1374,6 +1380,27 @@ wuffs_base__pixel_buffer__set_color_u32_fill_rect(
     wuffs_base__rect_ie_u32 rect,
     wuffs_base__color_u32_argb_premul color);
 
+// wuffs_base__pixel_buffer__composite draws src onto pb, converting pixel
+// formats as necessary, with src's top-left pixel at (dst_x, dst_y). Only
+// those pb pixels inside both clip and pb's bounds are modified, so that a
+// src that extends past pb's edges is not an error. The two pixel buffers'
+// memory must not overlap.
+//
+// The blend is typically WUFFS_BASE__PIXEL_BLEND__SRC, for replacing pixels
+// (as GIF frame disposal does), or WUFFS_BASE__PIXEL_BLEND__SRC_OVER, for
+// compositing a partially transparent frame over the previous one.
+//
+// For modular builds that divide the base module into sub-modules, using this
+// function requires the WUFFS_CONFIG__MODULE__BASE__PIXCONV sub-module, not
+// just WUFFS_CONFIG__MODULE__BASE__CORE.
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status  //
+wuffs_base__pixel_buffer__composite(wuffs_base__pixel_buffer* pb,
+                                    const wuffs_base__pixel_buffer* src,
+                                    uint32_t dst_x,
+                                    uint32_t dst_y,
+                                    wuffs_base__rect_ie_u32 clip,
+                                    wuffs_base__pixel_blend blend);
+
 #ifdef __cplusplus
 
 inline wuffs_base__status  //
@@ -1447,6 +1474,16 @@ wuffs_base__pixel_buffer::set_color_u32_fill_rect(
   return wuffs_base__pixel_buffer__set_color_u32_fill_rect(this, rect, color);
 }
 
+inline wuffs_base__status  //
+wuffs_base__pixel_buffer::composite(const wuffs_base__pixel_buffer* src,
+                                    uint32_t dst_x,
+                                    uint32_t dst_y,
+                                    wuffs_base__rect_ie_u32 clip,
+                                    wuffs_base__pixel_blend blend) {
+  return wuffs_base__pixel_buffer__composite(this, src, dst_x, dst_y, clip,
+                                             blend);
+}
+
 #endif  // __cplusplus
 
 // --------
@@ -1455,16 +1492,157 @@ typedef struct wuffs_base__decode_frame_options__struct {
   // Do not access the private_impl's fields directly. There is no API/ABI
   // compatibility or safety guarantee if you do so.
   struct {
-    uint8_t TODO;
+    bool has_roi;
+    wuffs_base__rect_ie_u32 roi;
+    uint32_t downscale_shift;
   } private_impl;
 
 #ifdef __cplusplus
+  inline void set_downscale_shift(uint32_t shift);
+  inline uint32_t downscale_shift() const;
+  inline void set_roi(wuffs_base__rect_ie_u32 roi);
+  inline wuffs_base__rect_ie_u32 roi() const;
+  inline uint32_t roi_min_incl_x() const;
+  inline uint32_t roi_min_incl_y() const;
+  inline uint32_t roi_max_excl_x() const;
+  inline uint32_t roi_max_excl_y() const;
 #endif  // __cplusplus
 
 } wuffs_base__decode_frame_options;
 
+// wuffs_base__decode_frame_options__set_downscale_shift asks for the frame to
+// be decoded at a reduced size: 1/2, 1/4 or 1/8 (in each dimension) for a
+// shift of 1, 2 or 3. The destination pixel buffer then only needs to be
+// ((w + (1 << shift) - 1) >> shift) by ((h + (1 << shift) - 1) >> shift)
+// pixels, for a w by h image. Each destination pixel is the average (a box
+// filter, in premultiplied alpha space) of the corresponding (1 << shift) by
+// (1 << shift) block of source pixels, except that for interlaced images,
+// decoders may stop after an early interlacing pass and sample one source
+// pixel per block instead. The frame's dirty rect is also in that reduced
+// coordinate space.
+//
+// Decoders that support this may need a longer work buffer, for the running
+// sums, than their workbuf_len's min_incl. Passing a work buffer of max_incl
+// length is always enough. Decoders that do not support this ignore it, so
+// callers should check for support (e.g. wuffs_aux::DecodeImage does that per
+// image format) before relying on it.
+//
+// A zero-valued wuffs_base__decode_frame_options has a shift of zero: no
+// downscaling. Shifts above 3 are unsupported.
+static inline void  //
+wuffs_base__decode_frame_options__set_downscale_shift(
+    wuffs_base__decode_frame_options* o,
+    uint32_t shift) {
+  if (o) {
+    o->private_impl.downscale_shift = shift;
+  }
+}
+
+static inline uint32_t  //
+wuffs_base__decode_frame_options__downscale_shift(
+    const wuffs_base__decode_frame_options* o) {
+  return o ? o->private_impl.downscale_shift : 0;
+}
+
+// wuffs_base__decode_frame_options__set_roi sets the region of interest: the
+// part of the frame that the caller wants decoded. A decoder may then skip
+// writing (and possibly stop decoding) pixels outside of that rectangle, and
+// those pixels in the destination pixel buffer are left as they were. The ROI
+// is in the image's coordinate space (the same space as the frame config's
+// bounds). Some decoders, or some images (e.g. interlaced ones), still have to
+// decompress all of the frame's pixel data but can skip the swizzling for
+// pixels outside of the ROI.
+//
+// A zero-valued wuffs_base__decode_frame_options has no ROI, which is
+// equivalent to an unbounded ROI: the whole frame is decoded.
+static inline void  //
+wuffs_base__decode_frame_options__set_roi(wuffs_base__decode_frame_options* o,
+                                          wuffs_base__rect_ie_u32 roi) {
+  if (o) {
+    o->private_impl.has_roi = true;
+    o->private_impl.roi = roi;
+  }
+}
+
+// wuffs_base__decode_frame_options__roi returns the region of interest, or the
+// maximal (0, 0, 0xFFFFFFFF, 0xFFFFFFFF) rectangle if there is no ROI.
+static inline wuffs_base__rect_ie_u32  //
+wuffs_base__decode_frame_options__roi(
+    const wuffs_base__decode_frame_options* o) {
+  if (o && o->private_impl.has_roi) {
+    return o->private_impl.roi;
+  }
+  return wuffs_base__make_rect_ie_u32(0, 0, UINT32_MAX, UINT32_MAX);
+}
+
+static inline uint32_t  //
+wuffs_base__decode_frame_options__roi_min_incl_x(
+    const wuffs_base__decode_frame_options* o) {
+  return (o && o->private_impl.has_roi) ? o->private_impl.roi.min_incl_x : 0;
+}
+
+static inline uint32_t  //
+wuffs_base__decode_frame_options__roi_min_incl_y(
+    const wuffs_base__decode_frame_options* o) {
+  return (o && o->private_impl.has_roi) ? o->private_impl.roi.min_incl_y : 0;
+}
+
+static inline uint32_t  //
+wuffs_base__decode_frame_options__roi_max_excl_x(
+    const wuffs_base__decode_frame_options* o) {
+  return (o && o->private_impl.has_roi) ? o->private_impl.roi.max_excl_x
+                                        : UINT32_MAX;
+}
+
+static inline uint32_t  //
+wuffs_base__decode_frame_options__roi_max_excl_y(
+    const wuffs_base__decode_frame_options* o) {
+  return (o && o->private_impl.has_roi) ? o->private_impl.roi.max_excl_y
+                                        : UINT32_MAX;
+}
+
 #ifdef __cplusplus
 
+inline void  //
+wuffs_base__decode_frame_options::set_downscale_shift(uint32_t shift) {
+  wuffs_base__decode_frame_options__set_downscale_shift(this, shift);
+}
+
+inline uint32_t  //
+wuffs_base__decode_frame_options::downscale_shift() const {
+  return wuffs_base__decode_frame_options__downscale_shift(this);
+}
+
+inline void  //
+wuffs_base__decode_frame_options::set_roi(wuffs_base__rect_ie_u32 roi) {
+  wuffs_base__decode_frame_options__set_roi(this, roi);
+}
+
+inline wuffs_base__rect_ie_u32  //
+wuffs_base__decode_frame_options::roi() const {
+  return wuffs_base__decode_frame_options__roi(this);
+}
+
+inline uint32_t  //
+wuffs_base__decode_frame_options::roi_min_incl_x() const {
+  return wuffs_base__decode_frame_options__roi_min_incl_x(this);
+}
+
+inline uint32_t  //
+wuffs_base__decode_frame_options::roi_min_incl_y() const {
+  return wuffs_base__decode_frame_options__roi_min_incl_y(this);
+}
+
+inline uint32_t  //
+wuffs_base__decode_frame_options::roi_max_excl_x() const {
+  return wuffs_base__decode_frame_options__roi_max_excl_x(this);
+}
+
+inline uint32_t  //
+wuffs_base__decode_frame_options::roi_max_excl_y() const {
+  return wuffs_base__decode_frame_options__roi_max_excl_y(this);
+}
+
 #endif  // __cplusplus
 
 // --------
@@ -1510,6 +1688,9 @@ typedef struct wuffs_base__pixel_swizzler__struct {
     wuffs_base__pixel_swizzler__transparent_black_func transparent_black_func;
     uint32_t dst_pixfmt_bytes_per_pixel;
     uint32_t src_pixfmt_bytes_per_pixel;
+    // downscale_func, if non-NULL, converts from BGRA_PREMUL to the dst pixel
+    // format, and func converts from the src pixel format to BGRA_PREMUL.
+    wuffs_base__pixel_swizzler__func downscale_func;
   } private_impl;
 
 #ifdef __cplusplus
@@ -1522,6 +1703,22 @@ typedef struct wuffs_base__pixel_swizzler__struct {
       wuffs_base__slice_u8 dst,
       wuffs_base__slice_u8 dst_palette,
       wuffs_base__slice_u8 src) const;
+  inline wuffs_base__status prepare_downscaled(
+      wuffs_base__pixel_format dst_pixfmt,
+      wuffs_base__slice_u8 dst_palette,
+      wuffs_base__pixel_format src_pixfmt,
+      wuffs_base__slice_u8 src_palette,
+      wuffs_base__pixel_blend blend);
+  inline uint64_t swizzle_downscaled_from_slice(
+      wuffs_base__table_u8 dst,
+      wuffs_base__slice_u8 dst_palette,
+      wuffs_base__slice_u8 accum,
+      wuffs_base__slice_u8 src,
+      uint32_t shift,
+      uint32_t x,
+      uint32_t y,
+      uint32_t y0,
+      uint32_t y1) const;
 #endif  // __cplusplus
 
 } wuffs_base__pixel_swizzler;
@@ -1553,6 +1750,59 @@ wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(
     wuffs_base__slice_u8 dst_palette,
     wuffs_base__slice_u8 src);
 
+// wuffs_base__pixel_swizzler__prepare_downscaled is like
+// wuffs_base__pixel_swizzler__prepare but readies the pixel swizzler for
+// wuffs_base__pixel_swizzler__swizzle_downscaled_from_slice instead of its
+// other methods. The dst_palette is used as scratch space (for the src
+// palette converted to premultiplied alpha) and so must be 1024 bytes long
+// if the src pixel format is indexed, even if the dst pixel format is not.
+//
+// For modular builds that divide the base module into sub-modules, using this
+// function requires the WUFFS_CONFIG__MODULE__BASE__PIXCONV sub-module, not
+// just WUFFS_CONFIG__MODULE__BASE__CORE.
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status  //
+wuffs_base__pixel_swizzler__prepare_downscaled(
+    wuffs_base__pixel_swizzler* p,
+    wuffs_base__pixel_format dst_pixfmt,
+    wuffs_base__slice_u8 dst_palette,
+    wuffs_base__pixel_format src_pixfmt,
+    wuffs_base__slice_u8 src_palette,
+    wuffs_base__pixel_blend blend);
+
+// wuffs_base__pixel_swizzler__swizzle_downscaled_from_slice adds one row of
+// source pixels to a running sum and, after the last source row for a
+// destination row, writes that destination row. It returns the number of
+// source pixels consumed: zero if any argument is invalid.
+//
+// The src holds whole pixels of source row y, from source column x onwards.
+// The dst is the whole (downscaled) destination plane: source pixel (x, y)
+// maps to destination pixel (x >> shift, y >> shift). Each destination pixel
+// is the premultiplied alpha average of its source pixels that are within
+// rows y0 (inclusive) to y1 (exclusive). Passing (y, y+1) for (y0, y1) means
+// that only row y is sampled for its destination row. The shift must be at
+// most 3.
+//
+// Calls for the same destination row have to pass source rows in increasing
+// order, each in a single call and with the same x and src length. The accum
+// slice holds the running sums between those calls and must be at least
+// (8 * ((n >> shift) + 2)) bytes long, for n source pixels.
+//
+// For modular builds that divide the base module into sub-modules, using this
+// function requires the WUFFS_CONFIG__MODULE__BASE__PIXCONV sub-module, not
+// just WUFFS_CONFIG__MODULE__BASE__CORE.
+WUFFS_BASE__MAYBE_STATIC uint64_t  //
+wuffs_base__pixel_swizzler__swizzle_downscaled_from_slice(
+    const wuffs_base__pixel_swizzler* p,
+    wuffs_base__table_u8 dst,
+    wuffs_base__slice_u8 dst_palette,
+    wuffs_base__slice_u8 accum,
+    wuffs_base__slice_u8 src,
+    uint32_t shift,
+    uint32_t x,
+    uint32_t y,
+    uint32_t y0,
+    uint32_t y1);
+
 #ifdef __cplusplus
 
 inline wuffs_base__status  //
@@ -1574,4 +1824,30 @@ wuffs_base__pixel_swizzler::swizzle_interleaved_from_slice(
       this, dst, dst_palette, src);
 }
 
+inline wuffs_base__status  //
+wuffs_base__pixel_swizzler::prepare_downscaled(
+    wuffs_base__pixel_format dst_pixfmt,
+    wuffs_base__slice_u8 dst_palette,
+    wuffs_base__pixel_format src_pixfmt,
+    wuffs_base__slice_u8 src_palette,
+    wuffs_base__pixel_blend blend) {
+  return wuffs_base__pixel_swizzler__prepare_downscaled(
+      this, dst_pixfmt, dst_palette, src_pixfmt, src_palette, blend);
+}
+
+inline uint64_t  //
+wuffs_base__pixel_swizzler::swizzle_downscaled_from_slice(
+    wuffs_base__table_u8 dst,
+    wuffs_base__slice_u8 dst_palette,
+    wuffs_base__slice_u8 accum,
+    wuffs_base__slice_u8 src,
+    uint32_t shift,
+    uint32_t x,
+    uint32_t y,
+    uint32_t y0,
+    uint32_t y1) const {
+  return wuffs_base__pixel_swizzler__swizzle_downscaled_from_slice(
+      this, dst, dst_palette, accum, src, shift, x, y, y0, y1);
+}
+
 #endif  // __cplusplus
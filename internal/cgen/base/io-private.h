@@ -349,6 +349,23 @@ wuffs_base__io_writer__limited_copy_u32_from_slice(uint8_t** ptr_iop_w,
   return (uint32_t)(n);
 }
 
+// wuffs_base__io_writer__limited_write_u64le_fast writes all 8 bytes of x but
+// only advances *ptr_iop_w by length bytes. The other (8 - length) bytes are
+// scratch space, for subsequent writes to overwrite.
+//
+// The caller needs to prove that:
+//  - length <= 8
+//  - 8      <= (io2_w - *ptr_iop_w)
+static inline uint32_t  //
+wuffs_base__io_writer__limited_write_u64le_fast(uint8_t** ptr_iop_w,
+                                                uint8_t* io2_w,
+                                                uint32_t length,
+                                                uint64_t x) {
+  wuffs_base__poke_u64le__no_bounds_check(*ptr_iop_w, x);
+  *ptr_iop_w += length;
+  return length;
+}
+
 static inline wuffs_base__io_buffer*  //
 wuffs_base__io_writer__set(wuffs_base__io_buffer* b,
                            uint8_t** ptr_iop_w,
@@ -296,6 +296,54 @@ wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxx(
   }
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static void  //
+wuffs_base__pixel_buffer__fill_u32le__avx2(uint8_t* ptr,
+                                           size_t n,
+                                           uint32_t color) {
+  __m256i x = _mm256_set1_epi32((int32_t)color);
+  for (; n >= 8; n -= 8) {
+    _mm256_storeu_si256((__m256i*)(void*)ptr, x);
+    ptr += 8 * 4;
+  }
+  for (; n > 0; n--) {
+    wuffs_base__poke_u32le__no_bounds_check(ptr, color);
+    ptr += 4;
+  }
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static void  //
+wuffs_base__pixel_buffer__fill_u32le__sse42(uint8_t* ptr,
+                                            size_t n,
+                                            uint32_t color) {
+  __m128i x = _mm_set1_epi32((int32_t)color);
+  for (; n >= 4; n -= 4) {
+    _mm_storeu_si128((__m128i*)(void*)ptr, x);
+    ptr += 4 * 4;
+  }
+  for (; n > 0; n--) {
+    wuffs_base__poke_u32le__no_bounds_check(ptr, color);
+    ptr += 4;
+  }
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
+
+static void  //
+wuffs_base__pixel_buffer__fill_u32le(uint8_t* ptr, size_t n, uint32_t color) {
+  for (; n > 0; n--) {
+    wuffs_base__poke_u32le__no_bounds_check(ptr, color);
+    ptr += 4;
+  }
+}
+
 static inline void  //
 wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxx(
     wuffs_base__pixel_buffer* pb,
@@ -303,15 +351,25 @@ wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxx(
     uint32_t color) {
   size_t stride = pb->private_impl.planes[0].stride;
   uint32_t width = wuffs_base__rect_ie_u32__width(&rect);
+  uint32_t height = wuffs_base__rect_ie_u32__height(&rect);
+
+  void (*fill)(uint8_t*, size_t, uint32_t) =
+      wuffs_base__pixel_buffer__fill_u32le;
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+  // Tiny fills don't pay for the cpuid checks.
+  if ((((uint64_t)width) * ((uint64_t)height)) >= 64) {
+    if (wuffs_base__cpu_arch__have_x86_avx2()) {
+      fill = wuffs_base__pixel_buffer__fill_u32le__avx2;
+    } else if (wuffs_base__cpu_arch__have_x86_sse42()) {
+      fill = wuffs_base__pixel_buffer__fill_u32le__sse42;
+    }
+  }
+#endif
+
   if ((stride == (4 * ((uint64_t)width))) && (rect.min_incl_x == 0)) {
     uint8_t* ptr =
         pb->private_impl.planes[0].ptr + (stride * ((size_t)rect.min_incl_y));
-    uint32_t height = wuffs_base__rect_ie_u32__height(&rect);
-    size_t n;
-    for (n = ((size_t)width) * ((size_t)height); n > 0; n--) {
-      wuffs_base__poke_u32le__no_bounds_check(ptr, color);
-      ptr += 4;
-    }
+    (*fill)(ptr, ((size_t)width) * ((size_t)height), color);
     return;
   }
 
@@ -319,11 +377,7 @@ wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxx(
   for (y = rect.min_incl_y; y < rect.max_excl_y; y++) {
     uint8_t* ptr = pb->private_impl.planes[0].ptr + (stride * ((size_t)y)) +
                    (4 * ((size_t)rect.min_incl_x));
-    uint32_t n;
-    for (n = width; n > 0; n--) {
-      wuffs_base__poke_u32le__no_bounds_check(ptr, color);
-      ptr += 4;
-    }
+    (*fill)(ptr, width, color);
   }
 }
 
@@ -437,6 +491,104 @@ wuffs_base__pixel_buffer__set_color_u32_fill_rect(
 
 // --------
 
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status  //
+wuffs_base__pixel_buffer__composite(wuffs_base__pixel_buffer* pb,
+                                    const wuffs_base__pixel_buffer* src,
+                                    uint32_t dst_x,
+                                    uint32_t dst_y,
+                                    wuffs_base__rect_ie_u32 clip,
+                                    wuffs_base__pixel_blend blend) {
+  if (!pb) {
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+  } else if (!src) {
+    return wuffs_base__make_status(wuffs_base__error__bad_argument);
+  } else if (
+      wuffs_base__pixel_format__is_planar(&pb->pixcfg.private_impl.pixfmt) ||
+      wuffs_base__pixel_format__is_planar(&src->pixcfg.private_impl.pixfmt)) {
+    // TODO: support planar formats.
+    return wuffs_base__make_status(wuffs_base__error__unsupported_option);
+  }
+
+  uint32_t dst_bits_per_pixel = wuffs_base__pixel_format__bits_per_pixel(
+      &pb->pixcfg.private_impl.pixfmt);
+  uint32_t src_bits_per_pixel = wuffs_base__pixel_format__bits_per_pixel(
+      &src->pixcfg.private_impl.pixfmt);
+  if ((dst_bits_per_pixel == 0) || ((dst_bits_per_pixel % 8) != 0) ||
+      (src_bits_per_pixel == 0) || ((src_bits_per_pixel % 8) != 0)) {
+    // TODO: support fraction-of-byte pixels, e.g. 1 bit per pixel?
+    return wuffs_base__make_status(wuffs_base__error__unsupported_option);
+  }
+  size_t dst_bytes_per_pixel = dst_bits_per_pixel / 8;
+  size_t src_bytes_per_pixel = src_bits_per_pixel / 8;
+
+  // Clip to pb's bounds and to src's bounds, translated by (dst_x, dst_y).
+  // Any src pixels beyond (0xFFFFFFFF, 0xFFFFFFFF) are already outside pb.
+  uint64_t src_max_excl_x =
+      ((uint64_t)dst_x) + ((uint64_t)(src->pixcfg.private_impl.width));
+  uint64_t src_max_excl_y =
+      ((uint64_t)dst_y) + ((uint64_t)(src->pixcfg.private_impl.height));
+  wuffs_base__rect_ie_u32 bounds =
+      wuffs_base__pixel_config__bounds(&pb->pixcfg);
+  wuffs_base__rect_ie_u32 r = wuffs_base__rect_ie_u32__intersect(
+      &bounds, wuffs_base__make_rect_ie_u32(
+                   dst_x, dst_y,
+                   (uint32_t)wuffs_base__u64__min(src_max_excl_x, 0xFFFFFFFF),
+                   (uint32_t)wuffs_base__u64__min(src_max_excl_y, 0xFFFFFFFF)));
+  r = wuffs_base__rect_ie_u32__intersect(&r, clip);
+  if (wuffs_base__rect_ie_u32__is_empty(&r)) {
+    return wuffs_base__make_status(NULL);
+  }
+
+  // For a non-indexed pb, the swizzler still needs somewhere to hold an
+  // indexed src's palette, converted to pb's pixel format.
+  uint8_t scratch[WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH];
+  wuffs_base__slice_u8 dst_palette = wuffs_base__pixel_buffer__palette_or_else(
+      pb, wuffs_base__make_slice_u8(
+              scratch, WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH));
+  wuffs_base__slice_u8 src_palette = wuffs_base__empty_slice_u8();
+  if (wuffs_base__pixel_format__is_indexed(&src->pixcfg.private_impl.pixfmt)) {
+    const wuffs_base__table_u8* tab =
+        &src->private_impl
+             .planes[WUFFS_BASE__PIXEL_FORMAT__INDEXED__COLOR_PLANE];
+    if ((tab->width ==
+         WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) &&
+        (tab->height == 1)) {
+      src_palette = wuffs_base__make_slice_u8(
+          tab->ptr, WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH);
+    }
+  }
+
+  wuffs_base__pixel_swizzler swizzler;
+  wuffs_base__status status = wuffs_base__pixel_swizzler__prepare(
+      &swizzler, pb->pixcfg.private_impl.pixfmt, dst_palette,
+      src->pixcfg.private_impl.pixfmt, src_palette, blend);
+  if (status.repr) {
+    return status;
+  }
+
+  size_t width = (size_t)wuffs_base__rect_ie_u32__width(&r);
+  const wuffs_base__table_u8* dst_tab = &pb->private_impl.planes[0];
+  const wuffs_base__table_u8* src_tab = &src->private_impl.planes[0];
+  uint8_t* d = dst_tab->ptr + (dst_tab->stride * ((size_t)r.min_incl_y)) +
+               (dst_bytes_per_pixel * ((size_t)r.min_incl_x));
+  uint8_t* s = src_tab->ptr +
+               (src_tab->stride * ((size_t)(r.min_incl_y - dst_y))) +
+               (src_bytes_per_pixel * ((size_t)(r.min_incl_x - dst_x)));
+
+  uint32_t y;
+  for (y = r.min_incl_y; y < r.max_excl_y; y++) {
+    wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(
+        &swizzler, wuffs_base__make_slice_u8(d, dst_bytes_per_pixel * width),
+        dst_palette,
+        wuffs_base__make_slice_u8(s, src_bytes_per_pixel * width));
+    d += dst_tab->stride;
+    s += src_tab->stride;
+  }
+  return wuffs_base__make_status(NULL);
+}
+
+// --------
+
 WUFFS_BASE__MAYBE_STATIC uint8_t  //
 wuffs_base__pixel_palette__closest_element(
     wuffs_base__slice_u8 palette_slice,
@@ -811,6 +963,61 @@ wuffs_base__pixel_swizzler__swap_rgb_bgr(uint8_t* dst_ptr,
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__swap_rgbx_bgrx__avx2(uint8_t* dst_ptr,
+                                                 size_t dst_len,
+                                                 uint8_t* dst_palette_ptr,
+                                                 size_t dst_palette_len,
+                                                 const uint8_t* src_ptr,
+                                                 size_t src_len) {
+  size_t len = (dst_len < src_len ? dst_len : src_len) / 4;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  __m256i shuffle = _mm256_set_epi8(+0x0F, +0x0C, +0x0D, +0x0E,  //
+                                    +0x0B, +0x08, +0x09, +0x0A,  //
+                                    +0x07, +0x04, +0x05, +0x06,  //
+                                    +0x03, +0x00, +0x01, +0x02,  //
+                                    +0x0F, +0x0C, +0x0D, +0x0E,  //
+                                    +0x0B, +0x08, +0x09, +0x0A,  //
+                                    +0x07, +0x04, +0x05, +0x06,  //
+                                    +0x03, +0x00, +0x01, +0x02);
+
+  while (n >= 8) {
+    __m256i x;
+    x = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+    x = _mm256_shuffle_epi8(x, shuffle);
+    _mm256_storeu_si256((__m256i*)(void*)d, x);
+
+    s += 8 * 4;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    uint8_t s0 = s[0];
+    uint8_t s1 = s[1];
+    uint8_t s2 = s[2];
+    uint8_t s3 = s[3];
+    d[0] = s2;
+    d[1] = s1;
+    d[2] = s0;
+    d[3] = s3;
+
+    s += 1 * 4;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 // ‼ WUFFS MULTI-FILE SECTION +x86_sse42
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
 WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
@@ -2690,8 +2897,11 @@ wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__rgba_premul__src_over(
 
 // --------
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
 static uint64_t  //
-wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src(
+wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src__avx2(
     uint8_t* dst_ptr,
     size_t dst_len,
     uint8_t* dst_palette_ptr,
@@ -2705,7 +2915,55 @@ wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src(
   const uint8_t* s = src_ptr;
   size_t n = len;
 
-  // TODO: unroll.
+  // As per wuffs_base__color_u32_argb_nonpremul__as__color_u32_argb_premul,
+  // each premultiplied color channel is (((c * a * 0x10201) / 0xFFFF) >> 8)
+  // for 8-bit c and a. That equals (mulhi(c * a, 0x8101) >> 7), where
+  // mulhi(x, y) is ((x * y) >> 16), as verified exhaustively over all (c, a)
+  // pairs. Multiplying the alpha channel by 0xFF leaves it unchanged.
+  __m256i zero = _mm256_setzero_si256();
+  __m256i u16_0x8101 = _mm256_set1_epi16(-0x7EFF);
+  __m256i alpha_ff = _mm256_set_epi16(0xFF, 0x00, 0x00, 0x00,  //
+                                      0xFF, 0x00, 0x00, 0x00,  //
+                                      0xFF, 0x00, 0x00, 0x00,  //
+                                      0xFF, 0x00, 0x00, 0x00);
+  __m256i shuffle_lo = _mm256_set_epi8(-0x01, -0x01, -0x01, +0x07,  //
+                                       -0x01, +0x07, -0x01, +0x07,  //
+                                       -0x01, -0x01, -0x01, +0x03,  //
+                                       -0x01, +0x03, -0x01, +0x03,  //
+                                       -0x01, -0x01, -0x01, +0x07,  //
+                                       -0x01, +0x07, -0x01, +0x07,  //
+                                       -0x01, -0x01, -0x01, +0x03,  //
+                                       -0x01, +0x03, -0x01, +0x03);
+  __m256i shuffle_hi = _mm256_set_epi8(-0x01, -0x01, -0x01, +0x0F,  //
+                                       -0x01, +0x0F, -0x01, +0x0F,  //
+                                       -0x01, -0x01, -0x01, +0x0B,  //
+                                       -0x01, +0x0B, -0x01, +0x0B,  //
+                                       -0x01, -0x01, -0x01, +0x0F,  //
+                                       -0x01, +0x0F, -0x01, +0x0F,  //
+                                       -0x01, -0x01, -0x01, +0x0B,  //
+                                       -0x01, +0x0B, -0x01, +0x0B);
+
+  while (n >= 8) {
+    __m256i x = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+
+    // Per 128-bit lane, the multipliers for pixels 0, 1 (a_lo) and 2, 3 (a_hi)
+    // in 16-bit B, G, R, A order: the pixel's alpha, three times, then 0xFF.
+    __m256i a_lo =
+        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle_lo), alpha_ff);
+    __m256i a_hi =
+        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle_hi), alpha_ff);
+
+    __m256i p_lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(x, zero), a_lo);
+    __m256i p_hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(x, zero), a_hi);
+    p_lo = _mm256_srli_epi16(_mm256_mulhi_epu16(p_lo, u16_0x8101), 7);
+    p_hi = _mm256_srli_epi16(_mm256_mulhi_epu16(p_hi, u16_0x8101), 7);
+
+    _mm256_storeu_si256((__m256i*)(void*)d, _mm256_packus_epi16(p_lo, p_hi));
+
+    s += 8 * 4;
+    d += 8 * 4;
+    n -= 8;
+  }
 
   while (n >= 1) {
     uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));
@@ -2720,9 +2978,11 @@ wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src(
 
   return len;
 }
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
 
 static uint64_t  //
-wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src(
+wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src(
     uint8_t* dst_ptr,
     size_t dst_len,
     uint8_t* dst_palette_ptr,
@@ -2730,8 +2990,8 @@ wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src(
     const uint8_t* src_ptr,
     size_t src_len) {
   size_t dst_len4 = dst_len / 4;
-  size_t src_len8 = src_len / 8;
-  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;
+  size_t src_len4 = src_len / 4;
+  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;
   uint8_t* d = dst_ptr;
   const uint8_t* s = src_ptr;
   size_t n = len;
@@ -2739,12 +2999,12 @@ wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src(
   // TODO: unroll.
 
   while (n >= 1) {
-    uint64_t s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));
+    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));
     wuffs_base__poke_u32le__no_bounds_check(
         d + (0 * 4),
-        wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul(s0));
+        wuffs_base__color_u32_argb_nonpremul__as__color_u32_argb_premul(s0));
 
-    s += 1 * 8;
+    s += 1 * 4;
     d += 1 * 4;
     n -= 1;
   }
@@ -2752,8 +3012,11 @@ wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src(
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
 static uint64_t  //
-wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src_over(
+wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src__avx2(
     uint8_t* dst_ptr,
     size_t dst_len,
     uint8_t* dst_palette_ptr,
@@ -2761,30 +3024,79 @@ wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src_over(
     const uint8_t* src_ptr,
     size_t src_len) {
   size_t dst_len4 = dst_len / 4;
-  size_t src_len4 = src_len / 4;
-  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;
+  size_t src_len8 = src_len / 8;
+  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;
   uint8_t* d = dst_ptr;
   const uint8_t* s = src_ptr;
   size_t n = len;
 
-  // TODO: unroll.
+  // As per wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul,
+  // each premultiplied color channel is (((c * a) / 0xFFFF) >> 8) for 16-bit
+  // c and a. For x up to (0xFFFF * 0xFFFF), (x / 0xFFFF) equals
+  // ((x + (x >> 16) + 1) >> 16), as verified exhaustively. Multiplying the
+  // alpha channel by 0xFFFF leaves it unchanged.
+  __m256i shuffle = _mm256_set_epi8(-0x01, -0x01, +0x0F, +0x0E,  //
+                                    +0x0F, +0x0E, +0x0F, +0x0E,  //
+                                    -0x01, -0x01, +0x07, +0x06,  //
+                                    +0x07, +0x06, +0x07, +0x06,  //
+                                    -0x01, -0x01, +0x0F, +0x0E,  //
+                                    +0x0F, +0x0E, +0x0F, +0x0E,  //
+                                    -0x01, -0x01, +0x07, +0x06,  //
+                                    +0x07, +0x06, +0x07, +0x06);
+  __m256i zero = _mm256_setzero_si256();
+  __m256i u32_1 = _mm256_set1_epi32(1);
+  __m256i alpha_ffff = _mm256_set_epi16(-0x01, 0x00, 0x00, 0x00,  //
+                                        -0x01, 0x00, 0x00, 0x00,  //
+                                        -0x01, 0x00, 0x00, 0x00,  //
+                                        -0x01, 0x00, 0x00, 0x00);
+
+  while (n >= 4) {
+    __m256i x = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+    __m256i a =
+        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle), alpha_ffff);
+
+    // Per 128-bit lane, p_lo and p_hi hold pixels 0 and 1 in 32-bit lanes.
+    __m256i p_lo = _mm256_mullo_epi32(_mm256_unpacklo_epi16(x, zero),
+                                      _mm256_unpacklo_epi16(a, zero));
+    __m256i p_hi = _mm256_mullo_epi32(_mm256_unpackhi_epi16(x, zero),
+                                      _mm256_unpackhi_epi16(a, zero));
+    p_lo = _mm256_srli_epi32(
+        _mm256_add_epi32(_mm256_add_epi32(p_lo, _mm256_srli_epi32(p_lo, 16)),
+                         u32_1),
+        24);
+    p_hi = _mm256_srli_epi32(
+        _mm256_add_epi32(_mm256_add_epi32(p_hi, _mm256_srli_epi32(p_hi, 16)),
+                         u32_1),
+        24);
+
+    // Pack to 8-bit channels and gather the low 64 bits of each 128-bit lane.
+    __m256i y = _mm256_packus_epi32(p_lo, p_hi);
+    y = _mm256_permute4x64_epi64(_mm256_packus_epi16(y, y), 0x08);
+    _mm_storeu_si128((__m128i*)(void*)d, _mm256_castsi256_si128(y));
+
+    s += 4 * 8;
+    d += 4 * 4;
+    n -= 4;
+  }
 
   while (n >= 1) {
-    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));
-    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));
+    uint64_t s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));
     wuffs_base__poke_u32le__no_bounds_check(
-        d + (0 * 4), wuffs_base__composite_premul_nonpremul_u32_axxx(d0, s0));
+        d + (0 * 4),
+        wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul(s0));
 
-    s += 1 * 4;
+    s += 1 * 8;
     d += 1 * 4;
     n -= 1;
   }
 
   return len;
 }
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
 
 static uint64_t  //
-wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src_over(
+wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src(
     uint8_t* dst_ptr,
     size_t dst_len,
     uint8_t* dst_palette_ptr,
@@ -2801,13 +3113,10 @@ wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src_over(
   // TODO: unroll.
 
   while (n >= 1) {
-    uint64_t d0 = wuffs_base__color_u32__as__color_u64(
-        wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4)));
     uint64_t s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));
     wuffs_base__poke_u32le__no_bounds_check(
         d + (0 * 4),
-        wuffs_base__color_u64__as__color_u32(
-            wuffs_base__composite_premul_nonpremul_u64_axxx(d0, s0)));
+        wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul(s0));
 
     s += 1 * 8;
     d += 1 * 4;
@@ -2818,7 +3127,7 @@ wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src_over(
 }
 
 static uint64_t  //
-wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over(
+wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src_over(
     uint8_t* dst_ptr,
     size_t dst_len,
     uint8_t* dst_palette_ptr,
@@ -2838,7 +3147,7 @@ wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over(
     uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));
     uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));
     wuffs_base__poke_u32le__no_bounds_check(
-        d + (0 * 4), wuffs_base__composite_premul_premul_u32_axxx(d0, s0));
+        d + (0 * 4), wuffs_base__composite_premul_nonpremul_u32_axxx(d0, s0));
 
     s += 1 * 4;
     d += 1 * 4;
@@ -2849,19 +3158,16 @@ wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over(
 }
 
 static uint64_t  //
-wuffs_base__pixel_swizzler__bgra_premul__index_bgra_nonpremul__src_over(
+wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src_over(
     uint8_t* dst_ptr,
     size_t dst_len,
     uint8_t* dst_palette_ptr,
     size_t dst_palette_len,
     const uint8_t* src_ptr,
     size_t src_len) {
-  if (dst_palette_len !=
-      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {
-    return 0;
-  }
   size_t dst_len4 = dst_len / 4;
-  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;
+  size_t src_len8 = src_len / 8;
+  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;
   uint8_t* d = dst_ptr;
   const uint8_t* s = src_ptr;
   size_t n = len;
@@ -2869,13 +3175,15 @@ wuffs_base__pixel_swizzler__bgra_premul__index_bgra_nonpremul__src_over(
   // TODO: unroll.
 
   while (n >= 1) {
-    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));
-    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +
-                                                          ((size_t)s[0] * 4));
+    uint64_t d0 = wuffs_base__color_u32__as__color_u64(
+        wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4)));
+    uint64_t s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));
     wuffs_base__poke_u32le__no_bounds_check(
-        d + (0 * 4), wuffs_base__composite_premul_nonpremul_u32_axxx(d0, s0));
+        d + (0 * 4),
+        wuffs_base__color_u64__as__color_u32(
+            wuffs_base__composite_premul_nonpremul_u64_axxx(d0, s0)));
 
-    s += 1 * 1;
+    s += 1 * 8;
     d += 1 * 4;
     n -= 1;
   }
@@ -2883,8 +3191,22 @@ wuffs_base__pixel_swizzler__bgra_premul__index_bgra_nonpremul__src_over(
   return len;
 }
 
+// The SIMD bgra_premul__bgra_premul__src_over implementations work in 16-bit
+// lanes. For each channel (including alpha) with 8-bit values s (src), d (dst)
+// and sa (src alpha), the scalar code computes:
+//
+//   ((0x101 * s) + (((0x101 * d) * (0xFFFF - (0x101 * sa))) / 0xFFFF)) >> 8
+//
+// With p = d * (0xFF - sa), that equals ((0x101 * s) + p + mulhi(p, 514)) >> 8,
+// where mulhi(x, y) is ((x * y) >> 16), and none of the 16-bit additions
+// overflow, provided that the src is validly premultiplied (s <= sa). This
+// was verified exhaustively over all (s, d, sa) triples.
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
 static uint64_t  //
-wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src(
+wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__avx2(
     uint8_t* dst_ptr,
     size_t dst_len,
     uint8_t* dst_palette_ptr,
@@ -2898,14 +3220,65 @@ wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src(
   const uint8_t* s = src_ptr;
   size_t n = len;
 
-  // TODO: unroll.
+  __m256i zero = _mm256_setzero_si256();
+  __m256i u16_0xFF = _mm256_set1_epi16(0xFF);
+  __m256i u16_514 = _mm256_set1_epi16(514);
+  __m256i shuffle_lo = _mm256_set_epi8(-0x01, +0x07, -0x01, +0x07,  //
+                                       -0x01, +0x07, -0x01, +0x07,  //
+                                       -0x01, +0x03, -0x01, +0x03,  //
+                                       -0x01, +0x03, -0x01, +0x03,  //
+                                       -0x01, +0x07, -0x01, +0x07,  //
+                                       -0x01, +0x07, -0x01, +0x07,  //
+                                       -0x01, +0x03, -0x01, +0x03,  //
+                                       -0x01, +0x03, -0x01, +0x03);
+  __m256i shuffle_hi = _mm256_set_epi8(-0x01, +0x0F, -0x01, +0x0F,  //
+                                       -0x01, +0x0F, -0x01, +0x0F,  //
+                                       -0x01, +0x0B, -0x01, +0x0B,  //
+                                       -0x01, +0x0B, -0x01, +0x0B,  //
+                                       -0x01, +0x0F, -0x01, +0x0F,  //
+                                       -0x01, +0x0F, -0x01, +0x0F,  //
+                                       -0x01, +0x0B, -0x01, +0x0B,  //
+                                       -0x01, +0x0B, -0x01, +0x0B);
+
+  while (n >= 8) {
+    __m256i sx = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+    __m256i dx = _mm256_lddqu_si256((const __m256i*)(const void*)d);
+
+    // The unpack, shuffle and pack instructions work within each 128-bit
+    // lane. Per lane, these are the alphas of pixels 0, 1 (sa_lo) and 2, 3
+    // (sa_hi), spread over the 16-bit B, G, R and A channels.
+    __m256i sa_lo = _mm256_shuffle_epi8(sx, shuffle_lo);
+    __m256i sa_hi = _mm256_shuffle_epi8(sx, shuffle_hi);
+
+    __m256i s_lo = _mm256_unpacklo_epi8(sx, zero);
+    __m256i s_hi = _mm256_unpackhi_epi8(sx, zero);
+    __m256i p_lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(dx, zero),
+                                      _mm256_sub_epi16(u16_0xFF, sa_lo));
+    __m256i p_hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(dx, zero),
+                                      _mm256_sub_epi16(u16_0xFF, sa_hi));
+
+    __m256i o_lo = _mm256_add_epi16(
+        _mm256_add_epi16(_mm256_slli_epi16(s_lo, 8), s_lo),
+        _mm256_add_epi16(p_lo, _mm256_mulhi_epu16(p_lo, u16_514)));
+    __m256i o_hi = _mm256_add_epi16(
+        _mm256_add_epi16(_mm256_slli_epi16(s_hi, 8), s_hi),
+        _mm256_add_epi16(p_hi, _mm256_mulhi_epu16(p_hi, u16_514)));
+
+    _mm256_storeu_si256(
+        (__m256i*)(void*)d,
+        _mm256_packus_epi16(_mm256_srli_epi16(o_lo, 8),
+                            _mm256_srli_epi16(o_hi, 8)));
+
+    s += 8 * 4;
+    d += 8 * 4;
+    n -= 8;
+  }
 
   while (n >= 1) {
-    uint32_t s0 = wuffs_base__swap_u32_argb_abgr(
-        wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));
+    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));
+    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));
     wuffs_base__poke_u32le__no_bounds_check(
-        d + (0 * 4),
-        wuffs_base__color_u32_argb_nonpremul__as__color_u32_argb_premul(s0));
+        d + (0 * 4), wuffs_base__composite_premul_premul_u32_axxx(d0, s0));
 
     s += 1 * 4;
     d += 1 * 4;
@@ -2914,9 +3287,14 @@ wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src(
 
   return len;
 }
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
 static uint64_t  //
-wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src_over(
+wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__sse42(
     uint8_t* dst_ptr,
     size_t dst_len,
     uint8_t* dst_palette_ptr,
@@ -2930,14 +3308,55 @@ wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src_over(
   const uint8_t* s = src_ptr;
   size_t n = len;
 
-  // TODO: unroll.
+  __m128i zero = _mm_setzero_si128();
+  __m128i u16_0xFF = _mm_set1_epi16(0xFF);
+  __m128i u16_514 = _mm_set1_epi16(514);
+  __m128i shuffle_lo = _mm_set_epi8(-0x01, +0x07, -0x01, +0x07,  //
+                                    -0x01, +0x07, -0x01, +0x07,  //
+                                    -0x01, +0x03, -0x01, +0x03,  //
+                                    -0x01, +0x03, -0x01, +0x03);
+  __m128i shuffle_hi = _mm_set_epi8(-0x01, +0x0F, -0x01, +0x0F,  //
+                                    -0x01, +0x0F, -0x01, +0x0F,  //
+                                    -0x01, +0x0B, -0x01, +0x0B,  //
+                                    -0x01, +0x0B, -0x01, +0x0B);
+
+  while (n >= 4) {
+    __m128i sx = _mm_lddqu_si128((const __m128i*)(const void*)s);
+    __m128i dx = _mm_lddqu_si128((const __m128i*)(const void*)d);
+
+    // The alphas of pixels 0, 1 (sa_lo) and 2, 3 (sa_hi), spread over the
+    // 16-bit B, G, R and A channels.
+    __m128i sa_lo = _mm_shuffle_epi8(sx, shuffle_lo);
+    __m128i sa_hi = _mm_shuffle_epi8(sx, shuffle_hi);
+
+    __m128i s_lo = _mm_unpacklo_epi8(sx, zero);
+    __m128i s_hi = _mm_unpackhi_epi8(sx, zero);
+    __m128i p_lo = _mm_mullo_epi16(_mm_unpacklo_epi8(dx, zero),
+                                   _mm_sub_epi16(u16_0xFF, sa_lo));
+    __m128i p_hi = _mm_mullo_epi16(_mm_unpackhi_epi8(dx, zero),
+                                   _mm_sub_epi16(u16_0xFF, sa_hi));
+
+    __m128i o_lo =
+        _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(s_lo, 8), s_lo),
+                      _mm_add_epi16(p_lo, _mm_mulhi_epu16(p_lo, u16_514)));
+    __m128i o_hi =
+        _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(s_hi, 8), s_hi),
+                      _mm_add_epi16(p_hi, _mm_mulhi_epu16(p_hi, u16_514)));
+
+    _mm_storeu_si128(
+        (__m128i*)(void*)d,
+        _mm_packus_epi16(_mm_srli_epi16(o_lo, 8), _mm_srli_epi16(o_hi, 8)));
+
+    s += 4 * 4;
+    d += 4 * 4;
+    n -= 4;
+  }
 
   while (n >= 1) {
     uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));
-    uint32_t s0 = wuffs_base__swap_u32_argb_abgr(
-        wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));
+    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));
     wuffs_base__poke_u32le__no_bounds_check(
-        d + (0 * 4), wuffs_base__composite_premul_nonpremul_u32_axxx(d0, s0));
+        d + (0 * 4), wuffs_base__composite_premul_premul_u32_axxx(d0, s0));
 
     s += 1 * 4;
     d += 1 * 4;
@@ -2946,9 +3365,11 @@ wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src_over(
 
   return len;
 }
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
 
 static uint64_t  //
-wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src(
+wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over(
     uint8_t* dst_ptr,
     size_t dst_len,
     uint8_t* dst_palette_ptr,
@@ -2956,8 +3377,8 @@ wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src(
     const uint8_t* src_ptr,
     size_t src_len) {
   size_t dst_len4 = dst_len / 4;
-  size_t src_len8 = src_len / 8;
-  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;
+  size_t src_len4 = src_len / 4;
+  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;
   uint8_t* d = dst_ptr;
   const uint8_t* s = src_ptr;
   size_t n = len;
@@ -2965,14 +3386,12 @@ wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src(
   // TODO: unroll.
 
   while (n >= 1) {
-    uint64_t s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));
+    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));
+    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));
     wuffs_base__poke_u32le__no_bounds_check(
-        d + (0 * 4),
-        wuffs_base__swap_u32_argb_abgr(
-            wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul(
-                s0)));
+        d + (0 * 4), wuffs_base__composite_premul_premul_u32_axxx(d0, s0));
 
-    s += 1 * 8;
+    s += 1 * 4;
     d += 1 * 4;
     n -= 1;
   }
@@ -2981,16 +3400,19 @@ wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src(
 }
 
 static uint64_t  //
-wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src_over(
+wuffs_base__pixel_swizzler__bgra_premul__index_bgra_nonpremul__src_over(
     uint8_t* dst_ptr,
     size_t dst_len,
     uint8_t* dst_palette_ptr,
     size_t dst_palette_len,
     const uint8_t* src_ptr,
     size_t src_len) {
+  if (dst_palette_len !=
+      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {
+    return 0;
+  }
   size_t dst_len4 = dst_len / 4;
-  size_t src_len8 = src_len / 8;
-  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;
+  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;
   uint8_t* d = dst_ptr;
   const uint8_t* s = src_ptr;
   size_t n = len;
@@ -2998,16 +3420,13 @@ wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src_over(
   // TODO: unroll.
 
   while (n >= 1) {
-    uint64_t d0 = wuffs_base__color_u32__as__color_u64(
-        wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4)));
-    uint64_t s0 = wuffs_base__swap_u64_argb_abgr(
-        wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8)));
+    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));
+    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +
+                                                          ((size_t)s[0] * 4));
     wuffs_base__poke_u32le__no_bounds_check(
-        d + (0 * 4),
-        wuffs_base__color_u64__as__color_u32(
-            wuffs_base__composite_premul_nonpremul_u64_axxx(d0, s0)));
+        d + (0 * 4), wuffs_base__composite_premul_nonpremul_u32_axxx(d0, s0));
 
-    s += 1 * 8;
+    s += 1 * 1;
     d += 1 * 4;
     n -= 1;
   }
@@ -3015,8 +3434,11 @@ wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src_over(
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
 static uint64_t  //
-wuffs_base__pixel_swizzler__bgra_premul__rgba_premul__src_over(
+wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src__avx2(
     uint8_t* dst_ptr,
     size_t dst_len,
     uint8_t* dst_palette_ptr,
@@ -3030,12 +3452,68 @@ wuffs_base__pixel_swizzler__bgra_premul__rgba_premul__src_over(
   const uint8_t* s = src_ptr;
   size_t n = len;
 
+  // See the bgra_premul__bgra_nonpremul__src__avx2 comments. This function
+  // also swaps the R and B channels.
+  __m256i swap = _mm256_set_epi8(+0x0F, +0x0C, +0x0D, +0x0E,  //
+                                 +0x0B, +0x08, +0x09, +0x0A,  //
+                                 +0x07, +0x04, +0x05, +0x06,  //
+                                 +0x03, +0x00, +0x01, +0x02,  //
+                                 +0x0F, +0x0C, +0x0D, +0x0E,  //
+                                 +0x0B, +0x08, +0x09, +0x0A,  //
+                                 +0x07, +0x04, +0x05, +0x06,  //
+                                 +0x03, +0x00, +0x01, +0x02);
+  __m256i zero = _mm256_setzero_si256();
+  __m256i u16_0x8101 = _mm256_set1_epi16(-0x7EFF);
+  __m256i alpha_ff = _mm256_set_epi16(0xFF, 0x00, 0x00, 0x00,  //
+                                      0xFF, 0x00, 0x00, 0x00,  //
+                                      0xFF, 0x00, 0x00, 0x00,  //
+                                      0xFF, 0x00, 0x00, 0x00);
+  __m256i shuffle_lo = _mm256_set_epi8(-0x01, -0x01, -0x01, +0x07,  //
+                                       -0x01, +0x07, -0x01, +0x07,  //
+                                       -0x01, -0x01, -0x01, +0x03,  //
+                                       -0x01, +0x03, -0x01, +0x03,  //
+                                       -0x01, -0x01, -0x01, +0x07,  //
+                                       -0x01, +0x07, -0x01, +0x07,  //
+                                       -0x01, -0x01, -0x01, +0x03,  //
+                                       -0x01, +0x03, -0x01, +0x03);
+  __m256i shuffle_hi = _mm256_set_epi8(-0x01, -0x01, -0x01, +0x0F,  //
+                                       -0x01, +0x0F, -0x01, +0x0F,  //
+                                       -0x01, -0x01, -0x01, +0x0B,  //
+                                       -0x01, +0x0B, -0x01, +0x0B,  //
+                                       -0x01, -0x01, -0x01, +0x0F,  //
+                                       -0x01, +0x0F, -0x01, +0x0F,  //
+                                       -0x01, -0x01, -0x01, +0x0B,  //
+                                       -0x01, +0x0B, -0x01, +0x0B);
+
+  while (n >= 8) {
+    __m256i x = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+    x = _mm256_shuffle_epi8(x, swap);
+
+    // Per 128-bit lane, the multipliers for pixels 0, 1 (a_lo) and 2, 3 (a_hi)
+    // in 16-bit B, G, R, A order: the pixel's alpha, three times, then 0xFF.
+    __m256i a_lo =
+        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle_lo), alpha_ff);
+    __m256i a_hi =
+        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle_hi), alpha_ff);
+
+    __m256i p_lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(x, zero), a_lo);
+    __m256i p_hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(x, zero), a_hi);
+    p_lo = _mm256_srli_epi16(_mm256_mulhi_epu16(p_lo, u16_0x8101), 7);
+    p_hi = _mm256_srli_epi16(_mm256_mulhi_epu16(p_hi, u16_0x8101), 7);
+
+    _mm256_storeu_si256((__m256i*)(void*)d, _mm256_packus_epi16(p_lo, p_hi));
+
+    s += 8 * 4;
+    d += 8 * 4;
+    n -= 8;
+  }
+
   while (n >= 1) {
-    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));
     uint32_t s0 = wuffs_base__swap_u32_argb_abgr(
         wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));
     wuffs_base__poke_u32le__no_bounds_check(
-        d + (0 * 4), wuffs_base__composite_premul_premul_u32_axxx(d0, s0));
+        d + (0 * 4),
+        wuffs_base__color_u32_argb_nonpremul__as__color_u32_argb_premul(s0));
 
     s += 1 * 4;
     d += 1 * 4;
@@ -3044,12 +3522,324 @@ wuffs_base__pixel_swizzler__bgra_premul__rgba_premul__src_over(
 
   return len;
 }
-
-// --------
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
 
 static uint64_t  //
-wuffs_base__pixel_swizzler__bgrw__bgr(uint8_t* dst_ptr,
-                                      size_t dst_len,
+wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src(
+    uint8_t* dst_ptr,
+    size_t dst_len,
+    uint8_t* dst_palette_ptr,
+    size_t dst_palette_len,
+    const uint8_t* src_ptr,
+    size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len4 = src_len / 4;
+  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  // TODO: unroll.
+
+  while (n >= 1) {
+    uint32_t s0 = wuffs_base__swap_u32_argb_abgr(
+        wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4),
+        wuffs_base__color_u32_argb_nonpremul__as__color_u32_argb_premul(s0));
+
+    s += 1 * 4;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src_over(
+    uint8_t* dst_ptr,
+    size_t dst_len,
+    uint8_t* dst_palette_ptr,
+    size_t dst_palette_len,
+    const uint8_t* src_ptr,
+    size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len4 = src_len / 4;
+  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  // TODO: unroll.
+
+  while (n >= 1) {
+    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));
+    uint32_t s0 = wuffs_base__swap_u32_argb_abgr(
+        wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4), wuffs_base__composite_premul_nonpremul_u32_axxx(d0, s0));
+
+    s += 1 * 4;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src__avx2(
+    uint8_t* dst_ptr,
+    size_t dst_len,
+    uint8_t* dst_palette_ptr,
+    size_t dst_palette_len,
+    const uint8_t* src_ptr,
+    size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len8 = src_len / 8;
+  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  // See the bgra_premul__bgra_nonpremul_4x16le__src__avx2 comments. This
+  // function also swaps the R and B channels.
+  __m256i swap = _mm256_set_epi8(+0x0F, +0x0E, +0x09, +0x08,  //
+                                 +0x0B, +0x0A, +0x0D, +0x0C,  //
+                                 +0x07, +0x06, +0x01, +0x00,  //
+                                 +0x03, +0x02, +0x05, +0x04,  //
+                                 +0x0F, +0x0E, +0x09, +0x08,  //
+                                 +0x0B, +0x0A, +0x0D, +0x0C,  //
+                                 +0x07, +0x06, +0x01, +0x00,  //
+                                 +0x03, +0x02, +0x05, +0x04);
+  __m256i shuffle = _mm256_set_epi8(-0x01, -0x01, +0x0F, +0x0E,  //
+                                    +0x0F, +0x0E, +0x0F, +0x0E,  //
+                                    -0x01, -0x01, +0x07, +0x06,  //
+                                    +0x07, +0x06, +0x07, +0x06,  //
+                                    -0x01, -0x01, +0x0F, +0x0E,  //
+                                    +0x0F, +0x0E, +0x0F, +0x0E,  //
+                                    -0x01, -0x01, +0x07, +0x06,  //
+                                    +0x07, +0x06, +0x07, +0x06);
+  __m256i zero = _mm256_setzero_si256();
+  __m256i u32_1 = _mm256_set1_epi32(1);
+  __m256i alpha_ffff = _mm256_set_epi16(-0x01, 0x00, 0x00, 0x00,  //
+                                        -0x01, 0x00, 0x00, 0x00,  //
+                                        -0x01, 0x00, 0x00, 0x00,  //
+                                        -0x01, 0x00, 0x00, 0x00);
+
+  while (n >= 4) {
+    __m256i x = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+    x = _mm256_shuffle_epi8(x, swap);
+    __m256i a =
+        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle), alpha_ffff);
+
+    // Per 128-bit lane, p_lo and p_hi hold pixels 0 and 1 in 32-bit lanes.
+    __m256i p_lo = _mm256_mullo_epi32(_mm256_unpacklo_epi16(x, zero),
+                                      _mm256_unpacklo_epi16(a, zero));
+    __m256i p_hi = _mm256_mullo_epi32(_mm256_unpackhi_epi16(x, zero),
+                                      _mm256_unpackhi_epi16(a, zero));
+    p_lo = _mm256_srli_epi32(
+        _mm256_add_epi32(_mm256_add_epi32(p_lo, _mm256_srli_epi32(p_lo, 16)),
+                         u32_1),
+        24);
+    p_hi = _mm256_srli_epi32(
+        _mm256_add_epi32(_mm256_add_epi32(p_hi, _mm256_srli_epi32(p_hi, 16)),
+                         u32_1),
+        24);
+
+    // Pack to 8-bit channels and gather the low 64 bits of each 128-bit lane.
+    __m256i y = _mm256_packus_epi32(p_lo, p_hi);
+    y = _mm256_permute4x64_epi64(_mm256_packus_epi16(y, y), 0x08);
+    _mm_storeu_si128((__m128i*)(void*)d, _mm256_castsi256_si128(y));
+
+    s += 4 * 8;
+    d += 4 * 4;
+    n -= 4;
+  }
+
+  while (n >= 1) {
+    uint64_t s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4),
+        wuffs_base__swap_u32_argb_abgr(
+            wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul(
+                s0)));
+
+    s += 1 * 8;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src(
+    uint8_t* dst_ptr,
+    size_t dst_len,
+    uint8_t* dst_palette_ptr,
+    size_t dst_palette_len,
+    const uint8_t* src_ptr,
+    size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len8 = src_len / 8;
+  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  // TODO: unroll.
+
+  while (n >= 1) {
+    uint64_t s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4),
+        wuffs_base__swap_u32_argb_abgr(
+            wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul(
+                s0)));
+
+    s += 1 * 8;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src_over(
+    uint8_t* dst_ptr,
+    size_t dst_len,
+    uint8_t* dst_palette_ptr,
+    size_t dst_palette_len,
+    const uint8_t* src_ptr,
+    size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len8 = src_len / 8;
+  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  // TODO: unroll.
+
+  while (n >= 1) {
+    uint64_t d0 = wuffs_base__color_u32__as__color_u64(
+        wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4)));
+    uint64_t s0 = wuffs_base__swap_u64_argb_abgr(
+        wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8)));
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4),
+        wuffs_base__color_u64__as__color_u32(
+            wuffs_base__composite_premul_nonpremul_u64_axxx(d0, s0)));
+
+    s += 1 * 8;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgra_premul__rgba_premul__src_over(
+    uint8_t* dst_ptr,
+    size_t dst_len,
+    uint8_t* dst_palette_ptr,
+    size_t dst_palette_len,
+    const uint8_t* src_ptr,
+    size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len4 = src_len / 4;
+  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  while (n >= 1) {
+    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));
+    uint32_t s0 = wuffs_base__swap_u32_argb_abgr(
+        wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4), wuffs_base__composite_premul_premul_u32_axxx(d0, s0));
+
+    s += 1 * 4;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+
+// --------
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgrw__bgr__avx2(uint8_t* dst_ptr,
+                                            size_t dst_len,
+                                            uint8_t* dst_palette_ptr,
+                                            size_t dst_palette_len,
+                                            const uint8_t* src_ptr,
+                                            size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len3 = src_len / 3;
+  size_t len = (dst_len4 < src_len3) ? dst_len4 : src_len3;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  __m256i shuffle = _mm256_set_epi8(-0x01, +0x0B, +0x0A, +0x09,  //
+                                    -0x01, +0x08, +0x07, +0x06,  //
+                                    -0x01, +0x05, +0x04, +0x03,  //
+                                    -0x01, +0x02, +0x01, +0x00,  //
+                                    -0x01, +0x0B, +0x0A, +0x09,  //
+                                    -0x01, +0x08, +0x07, +0x06,  //
+                                    -0x01, +0x05, +0x04, +0x03,  //
+                                    -0x01, +0x02, +0x01, +0x00);
+  __m256i or_ff = _mm256_set1_epi32(-0x01000000);
+
+  while (n >= 10) {
+    // The second 128-bit lane starts 4 pixels (12 bytes) after the first.
+    __m256i x;
+    x = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_lddqu_si128((const __m128i*)(const void*)s)),
+        _mm_lddqu_si128((const __m128i*)(const void*)(s + (4 * 3))), 1);
+    x = _mm256_shuffle_epi8(x, shuffle);
+    x = _mm256_or_si256(x, or_ff);
+    _mm256_storeu_si256((__m256i*)(void*)d, x);
+
+    s += 8 * 3;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4),
+        0xFF000000 | wuffs_base__peek_u24le__no_bounds_check(s + (0 * 3)));
+
+    s += 1 * 3;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgrw__bgr(uint8_t* dst_ptr,
+                                      size_t dst_len,
                                       uint8_t* dst_palette_ptr,
                                       size_t dst_palette_len,
                                       const uint8_t* src_ptr,
@@ -3105,6 +3895,51 @@ wuffs_base__pixel_swizzler__bgrw__bgr_565(uint8_t* dst_ptr,
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgrw__bgrx__avx2(uint8_t* dst_ptr,
+                                             size_t dst_len,
+                                             uint8_t* dst_palette_ptr,
+                                             size_t dst_palette_len,
+                                             const uint8_t* src_ptr,
+                                             size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len4 = src_len / 4;
+  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  __m256i or_ff = _mm256_set1_epi32(-0x01000000);
+
+  while (n >= 8) {
+    __m256i x;
+    x = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+    x = _mm256_or_si256(x, or_ff);
+    _mm256_storeu_si256((__m256i*)(void*)d, x);
+
+    s += 8 * 4;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4),
+        0xFF000000 | wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));
+
+    s += 1 * 4;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 static uint64_t  //
 wuffs_base__pixel_swizzler__bgrw__bgrx(uint8_t* dst_ptr,
                                        size_t dst_len,
@@ -3134,6 +3969,67 @@ wuffs_base__pixel_swizzler__bgrw__bgrx(uint8_t* dst_ptr,
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgrw__rgb__avx2(uint8_t* dst_ptr,
+                                            size_t dst_len,
+                                            uint8_t* dst_palette_ptr,
+                                            size_t dst_palette_len,
+                                            const uint8_t* src_ptr,
+                                            size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len3 = src_len / 3;
+  size_t len = (dst_len4 < src_len3) ? dst_len4 : src_len3;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  __m256i shuffle = _mm256_set_epi8(-0x01, +0x09, +0x0A, +0x0B,  //
+                                    -0x01, +0x06, +0x07, +0x08,  //
+                                    -0x01, +0x03, +0x04, +0x05,  //
+                                    -0x01, +0x00, +0x01, +0x02,  //
+                                    -0x01, +0x09, +0x0A, +0x0B,  //
+                                    -0x01, +0x06, +0x07, +0x08,  //
+                                    -0x01, +0x03, +0x04, +0x05,  //
+                                    -0x01, +0x00, +0x01, +0x02);
+  __m256i or_ff = _mm256_set1_epi32(-0x01000000);
+
+  while (n >= 10) {
+    // The second 128-bit lane starts 4 pixels (12 bytes) after the first.
+    __m256i x;
+    x = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_lddqu_si128((const __m128i*)(const void*)s)),
+        _mm_lddqu_si128((const __m128i*)(const void*)(s + (4 * 3))), 1);
+    x = _mm256_shuffle_epi8(x, shuffle);
+    x = _mm256_or_si256(x, or_ff);
+    _mm256_storeu_si256((__m256i*)(void*)d, x);
+
+    s += 8 * 3;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    uint8_t b0 = s[0];
+    uint8_t b1 = s[1];
+    uint8_t b2 = s[2];
+    d[0] = b2;
+    d[1] = b1;
+    d[2] = b0;
+    d[3] = 0xFF;
+
+    s += 1 * 3;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 // ‼ WUFFS MULTI-FILE SECTION +x86_sse42
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
 WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
@@ -3702,36 +4598,319 @@ wuffs_base__pixel_swizzler__xxx__y(uint8_t* dst_ptr,
 }
 
 static uint64_t  //
-wuffs_base__pixel_swizzler__xxx__y_16be(uint8_t* dst_ptr,
-                                        size_t dst_len,
-                                        uint8_t* dst_palette_ptr,
-                                        size_t dst_palette_len,
-                                        const uint8_t* src_ptr,
-                                        size_t src_len) {
-  size_t dst_len3 = dst_len / 3;
-  size_t src_len2 = src_len / 2;
-  size_t len = (dst_len3 < src_len2) ? dst_len3 : src_len2;
+wuffs_base__pixel_swizzler__xxx__y_16be(uint8_t* dst_ptr,
+                                        size_t dst_len,
+                                        uint8_t* dst_palette_ptr,
+                                        size_t dst_palette_len,
+                                        const uint8_t* src_ptr,
+                                        size_t src_len) {
+  size_t dst_len3 = dst_len / 3;
+  size_t src_len2 = src_len / 2;
+  size_t len = (dst_len3 < src_len2) ? dst_len3 : src_len2;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  // TODO: unroll.
+
+  while (n >= 1) {
+    uint8_t s0 = s[0];
+    d[0] = s0;
+    d[1] = s0;
+    d[2] = s0;
+
+    s += 1 * 2;
+    d += 1 * 3;
+    n -= 1;
+  }
+
+  return len;
+}
+
+// --------
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// wuffs_base__pixel_swizzler__transpose_palette16__sse42 splits the first 16
+// (4 bytes per entry) palette entries into four 16-byte tables, one per
+// channel, for use as _mm_shuffle_epi8 lookup tables.
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static inline void  //
+wuffs_base__pixel_swizzler__transpose_palette16__sse42(
+    __m128i* tab_b,
+    __m128i* tab_g,
+    __m128i* tab_r,
+    __m128i* tab_a,
+    const uint8_t* palette_ptr) {
+  __m128i shuffle = _mm_set_epi8(+0x0F, +0x0B, +0x07, +0x03,  //
+                                 +0x0E, +0x0A, +0x06, +0x02,  //
+                                 +0x0D, +0x09, +0x05, +0x01,  //
+                                 +0x0C, +0x08, +0x04, +0x00);
+  // Each qi holds entries (4*i) to (4*i + 3), grouped by channel.
+  __m128i q0 = _mm_shuffle_epi8(
+      _mm_lddqu_si128((const __m128i*)(const void*)(palette_ptr + 0x00)),
+      shuffle);
+  __m128i q1 = _mm_shuffle_epi8(
+      _mm_lddqu_si128((const __m128i*)(const void*)(palette_ptr + 0x10)),
+      shuffle);
+  __m128i q2 = _mm_shuffle_epi8(
+      _mm_lddqu_si128((const __m128i*)(const void*)(palette_ptr + 0x20)),
+      shuffle);
+  __m128i q3 = _mm_shuffle_epi8(
+      _mm_lddqu_si128((const __m128i*)(const void*)(palette_ptr + 0x30)),
+      shuffle);
+  __m128i bg01 = _mm_unpacklo_epi32(q0, q1);
+  __m128i ra01 = _mm_unpackhi_epi32(q0, q1);
+  __m128i bg23 = _mm_unpacklo_epi32(q2, q3);
+  __m128i ra23 = _mm_unpackhi_epi32(q2, q3);
+  *tab_b = _mm_unpacklo_epi64(bg01, bg23);
+  *tab_g = _mm_unpackhi_epi64(bg01, bg23);
+  *tab_r = _mm_unpacklo_epi64(ra01, ra23);
+  *tab_a = _mm_unpackhi_epi64(ra01, ra23);
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// wuffs_base__pixel_swizzler__transpose_palette16__avx2 is like the sse42
+// version but repeats each table in both 128-bit lanes.
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static inline void  //
+wuffs_base__pixel_swizzler__transpose_palette16__avx2(
+    __m256i* tabs,
+    const uint8_t* palette_ptr) {
+  __m128i tab_b;
+  __m128i tab_g;
+  __m128i tab_r;
+  __m128i tab_a;
+  wuffs_base__pixel_swizzler__transpose_palette16__sse42(
+      &tab_b, &tab_g, &tab_r, &tab_a, palette_ptr);
+  tabs[0] = _mm256_broadcastsi128_si256(tab_b);
+  tabs[1] = _mm256_broadcastsi128_si256(tab_g);
+  tabs[2] = _mm256_broadcastsi128_si256(tab_r);
+  tabs[3] = _mm256_broadcastsi128_si256(tab_a);
+}
+
+// wuffs_base__pixel_swizzler__lookup_palette16__avx2 looks up 32 indexes,
+// each below 16, in the transposed palette tabs. It sets x[0] to the 4-byte
+// pixels for indexes 0 to 7, x[1] for indexes 8 to 15 and so on.
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static inline void  //
+wuffs_base__pixel_swizzler__lookup_palette16__avx2(__m256i* x,
+                                                   const __m256i* tabs,
+                                                   __m256i indexes) {
+  __m256i b = _mm256_shuffle_epi8(tabs[0], indexes);
+  __m256i g = _mm256_shuffle_epi8(tabs[1], indexes);
+  __m256i r = _mm256_shuffle_epi8(tabs[2], indexes);
+  __m256i a = _mm256_shuffle_epi8(tabs[3], indexes);
+  __m256i bg_lo = _mm256_unpacklo_epi8(b, g);
+  __m256i bg_hi = _mm256_unpackhi_epi8(b, g);
+  __m256i ra_lo = _mm256_unpacklo_epi8(r, a);
+  __m256i ra_hi = _mm256_unpackhi_epi8(r, a);
+  // Each 128-bit lane is unpacked separately, so x0 holds pixels 0..3 and
+  // 16..19, x1 holds 4..7 and 20..23, and so on.
+  __m256i x0 = _mm256_unpacklo_epi16(bg_lo, ra_lo);
+  __m256i x1 = _mm256_unpackhi_epi16(bg_lo, ra_lo);
+  __m256i x2 = _mm256_unpacklo_epi16(bg_hi, ra_hi);
+  __m256i x3 = _mm256_unpackhi_epi16(bg_hi, ra_hi);
+  x[0] = _mm256_permute2x128_si256(x0, x1, 0x20);
+  x[1] = _mm256_permute2x128_si256(x2, x3, 0x20);
+  x[2] = _mm256_permute2x128_si256(x0, x1, 0x31);
+  x[3] = _mm256_permute2x128_si256(x2, x3, 0x31);
+}
+
+// wuffs_base__pixel_swizzler__lookup_palette256__avx2 is like
+// wuffs_base__pixel_swizzler__lookup_palette16__avx2 but the indexes can be
+// any value and palette points to all 256 entries.
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static inline void  //
+wuffs_base__pixel_swizzler__lookup_palette256__avx2(__m256i* x,
+                                                    const int* palette,
+                                                    __m256i indexes) {
+  __m128i i_lo = _mm256_castsi256_si128(indexes);
+  __m128i i_hi = _mm256_extracti128_si256(indexes, 1);
+  x[0] = _mm256_i32gather_epi32(palette, _mm256_cvtepu8_epi32(i_lo), 4);
+  x[1] = _mm256_i32gather_epi32(
+      palette, _mm256_cvtepu8_epi32(_mm_srli_si128(i_lo, 8)), 4);
+  x[2] = _mm256_i32gather_epi32(palette, _mm256_cvtepu8_epi32(i_hi), 4);
+  x[3] = _mm256_i32gather_epi32(
+      palette, _mm256_cvtepu8_epi32(_mm_srli_si128(i_hi, 8)), 4);
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__xxxx__index__src__avx2(uint8_t* dst_ptr,
+                                                   size_t dst_len,
+                                                   uint8_t* dst_palette_ptr,
+                                                   size_t dst_palette_len,
+                                                   const uint8_t* src_ptr,
+                                                   size_t src_len) {
+  if (dst_palette_len !=
+      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {
+    return 0;
+  }
+  size_t dst_len4 = dst_len / 4;
+  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  // Runs of 32 indexes that are all below 16 (e.g. from 1, 2 or 4 bit PNGs
+  // or from GIFs with small palettes) are looked up with _mm256_shuffle_epi8
+  // in per-channel tables of the first 16 palette entries. Other runs use
+  // _mm256_i32gather_epi32 on the whole palette.
+  __m256i tabs[4];
+  wuffs_base__pixel_swizzler__transpose_palette16__avx2(tabs, dst_palette_ptr);
+  __m256i high_nibbles = _mm256_set1_epi8(-0x10);
+  const int* palette = (const int*)(const void*)dst_palette_ptr;
+
+  while (n >= 32) {
+    __m256i indexes = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+
+    if (_mm256_testz_si256(indexes, high_nibbles)) {
+      __m256i x[4];
+      wuffs_base__pixel_swizzler__lookup_palette16__avx2(x, tabs, indexes);
+      _mm256_storeu_si256((__m256i*)(void*)(d + (0 * 4)), x[0]);
+      _mm256_storeu_si256((__m256i*)(void*)(d + (8 * 4)), x[1]);
+      _mm256_storeu_si256((__m256i*)(void*)(d + (16 * 4)), x[2]);
+      _mm256_storeu_si256((__m256i*)(void*)(d + (24 * 4)), x[3]);
+
+    } else {
+      __m256i x[4];
+      wuffs_base__pixel_swizzler__lookup_palette256__avx2(x, palette, indexes);
+      _mm256_storeu_si256((__m256i*)(void*)(d + (0 * 4)), x[0]);
+      _mm256_storeu_si256((__m256i*)(void*)(d + (8 * 4)), x[1]);
+      _mm256_storeu_si256((__m256i*)(void*)(d + (16 * 4)), x[2]);
+      _mm256_storeu_si256((__m256i*)(void*)(d + (24 * 4)), x[3]);
+    }
+
+    s += 32 * 1;
+    d += 32 * 4;
+    n -= 32;
+  }
+
+  while (n >= 8) {
+    __m256i x = _mm256_i32gather_epi32(
+        palette,
+        _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(
+            (int64_t)wuffs_base__peek_u64le__no_bounds_check(s))),
+        4);
+    _mm256_storeu_si256((__m256i*)(void*)d, x);
+
+    s += 8 * 1;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4), wuffs_base__peek_u32le__no_bounds_check(
+                         dst_palette_ptr + ((size_t)s[0] * 4)));
+
+    s += 1 * 1;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__xxxx__index__src__sse42(uint8_t* dst_ptr,
+                                                    size_t dst_len,
+                                                    uint8_t* dst_palette_ptr,
+                                                    size_t dst_palette_len,
+                                                    const uint8_t* src_ptr,
+                                                    size_t src_len) {
+  if (dst_palette_len !=
+      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {
+    return 0;
+  }
+  size_t dst_len4 = dst_len / 4;
+  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;
   uint8_t* d = dst_ptr;
   const uint8_t* s = src_ptr;
   size_t n = len;
 
-  // TODO: unroll.
+  // Runs of 16 indexes that are all below 16 are looked up with
+  // _mm_shuffle_epi8 in per-channel tables of the first 16 palette entries.
+  // Other runs fall back to one lookup per pixel.
+  __m128i tab_b;
+  __m128i tab_g;
+  __m128i tab_r;
+  __m128i tab_a;
+  wuffs_base__pixel_swizzler__transpose_palette16__sse42(
+      &tab_b, &tab_g, &tab_r, &tab_a, dst_palette_ptr);
+  __m128i high_nibbles = _mm_set1_epi8(-0x10);
+
+  while (n >= 16) {
+    __m128i indexes = _mm_lddqu_si128((const __m128i*)(const void*)s);
+
+    if (_mm_testz_si128(indexes, high_nibbles)) {
+      __m128i b = _mm_shuffle_epi8(tab_b, indexes);
+      __m128i g = _mm_shuffle_epi8(tab_g, indexes);
+      __m128i r = _mm_shuffle_epi8(tab_r, indexes);
+      __m128i a = _mm_shuffle_epi8(tab_a, indexes);
+      __m128i bg_lo = _mm_unpacklo_epi8(b, g);
+      __m128i bg_hi = _mm_unpackhi_epi8(b, g);
+      __m128i ra_lo = _mm_unpacklo_epi8(r, a);
+      __m128i ra_hi = _mm_unpackhi_epi8(r, a);
+      _mm_storeu_si128((__m128i*)(void*)(d + (0 * 4)),
+                       _mm_unpacklo_epi16(bg_lo, ra_lo));
+      _mm_storeu_si128((__m128i*)(void*)(d + (4 * 4)),
+                       _mm_unpackhi_epi16(bg_lo, ra_lo));
+      _mm_storeu_si128((__m128i*)(void*)(d + (8 * 4)),
+                       _mm_unpacklo_epi16(bg_hi, ra_hi));
+      _mm_storeu_si128((__m128i*)(void*)(d + (12 * 4)),
+                       _mm_unpackhi_epi16(bg_hi, ra_hi));
+
+    } else {
+      size_t i;
+      for (i = 0; i < 16; i += 4) {
+        wuffs_base__poke_u32le__no_bounds_check(
+            d + ((i + 0) * 4), wuffs_base__peek_u32le__no_bounds_check(
+                                   dst_palette_ptr + ((size_t)s[i + 0] * 4)));
+        wuffs_base__poke_u32le__no_bounds_check(
+            d + ((i + 1) * 4), wuffs_base__peek_u32le__no_bounds_check(
+                                   dst_palette_ptr + ((size_t)s[i + 1] * 4)));
+        wuffs_base__poke_u32le__no_bounds_check(
+            d + ((i + 2) * 4), wuffs_base__peek_u32le__no_bounds_check(
+                                   dst_palette_ptr + ((size_t)s[i + 2] * 4)));
+        wuffs_base__poke_u32le__no_bounds_check(
+            d + ((i + 3) * 4), wuffs_base__peek_u32le__no_bounds_check(
+                                   dst_palette_ptr + ((size_t)s[i + 3] * 4)));
+      }
+    }
+
+    s += 16 * 1;
+    d += 16 * 4;
+    n -= 16;
+  }
 
   while (n >= 1) {
-    uint8_t s0 = s[0];
-    d[0] = s0;
-    d[1] = s0;
-    d[2] = s0;
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4), wuffs_base__peek_u32le__no_bounds_check(
+                         dst_palette_ptr + ((size_t)s[0] * 4)));
 
-    s += 1 * 2;
-    d += 1 * 3;
+    s += 1 * 1;
+    d += 1 * 4;
     n -= 1;
   }
 
   return len;
 }
-
-// --------
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
 
 static uint64_t  //
 wuffs_base__pixel_swizzler__xxxx__index__src(uint8_t* dst_ptr,
@@ -3784,6 +4963,77 @@ wuffs_base__pixel_swizzler__xxxx__index__src(uint8_t* dst_ptr,
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over__avx2(
+    uint8_t* dst_ptr,
+    size_t dst_len,
+    uint8_t* dst_palette_ptr,
+    size_t dst_palette_len,
+    const uint8_t* src_ptr,
+    size_t src_len) {
+  if (dst_palette_len !=
+      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {
+    return 0;
+  }
+  size_t dst_len4 = dst_len / 4;
+  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  // Palette lookups are as per
+  // wuffs_base__pixel_swizzler__xxxx__index__src__avx2.
+  __m256i tabs[4];
+  wuffs_base__pixel_swizzler__transpose_palette16__avx2(tabs, dst_palette_ptr);
+  const int* palette = (const int*)(const void*)dst_palette_ptr;
+  __m256i high_nibbles = _mm256_set1_epi8(-0x10);
+  __m256i zero = _mm256_setzero_si256();
+
+  while (n >= 32) {
+    __m256i indexes = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+
+    __m256i x[4];
+    if (_mm256_testz_si256(indexes, high_nibbles)) {
+      wuffs_base__pixel_swizzler__lookup_palette16__avx2(x, tabs, indexes);
+    } else {
+      wuffs_base__pixel_swizzler__lookup_palette256__avx2(x, palette, indexes);
+    }
+
+    size_t i;
+    for (i = 0; i < 4; i++) {
+      // Keep the dst pixel wherever the palette entry is all zeroes.
+      __m256i keep = _mm256_cmpeq_epi32(x[i], zero);
+      __m256i y =
+          _mm256_lddqu_si256((const __m256i*)(const void*)(d + (i * 32)));
+      _mm256_storeu_si256((__m256i*)(void*)(d + (i * 32)),
+                          _mm256_blendv_epi8(x[i], y, keep));
+    }
+
+    s += 32 * 1;
+    d += 32 * 4;
+    n -= 32;
+  }
+
+  while (n >= 1) {
+    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +
+                                                          ((size_t)s[0] * 4));
+    if (s0) {
+      wuffs_base__poke_u32le__no_bounds_check(d + (0 * 4), s0);
+    }
+
+    s += 1 * 1;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 static uint64_t  //
 wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over(
     uint8_t* dst_ptr,
@@ -3846,6 +5096,59 @@ wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over(
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__xxxx__y__avx2(uint8_t* dst_ptr,
+                                          size_t dst_len,
+                                          uint8_t* dst_palette_ptr,
+                                          size_t dst_palette_len,
+                                          const uint8_t* src_ptr,
+                                          size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  __m256i shuffle = _mm256_set_epi8(-0x01, +0x07, +0x07, +0x07,  //
+                                    -0x01, +0x06, +0x06, +0x06,  //
+                                    -0x01, +0x05, +0x05, +0x05,  //
+                                    -0x01, +0x04, +0x04, +0x04,  //
+                                    -0x01, +0x03, +0x03, +0x03,  //
+                                    -0x01, +0x02, +0x02, +0x02,  //
+                                    -0x01, +0x01, +0x01, +0x01,  //
+                                    -0x01, +0x00, +0x00, +0x00);
+  __m256i or_ff = _mm256_set1_epi32(-0x01000000);
+
+  while (n >= 8) {
+    __m256i x;
+    x = _mm256_set1_epi64x(
+        (int64_t)wuffs_base__peek_u64le__no_bounds_check(s + (0 * 1)));
+    x = _mm256_shuffle_epi8(x, shuffle);
+    x = _mm256_or_si256(x, or_ff);
+    _mm256_storeu_si256((__m256i*)(void*)d, x);
+
+    s += 8 * 1;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4), 0xFF000000 | (0x010101 * (uint32_t)s[0]));
+
+    s += 1 * 1;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 // ‼ WUFFS MULTI-FILE SECTION +x86_sse42
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
 WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
@@ -3922,6 +5225,60 @@ wuffs_base__pixel_swizzler__xxxx__y(uint8_t* dst_ptr,
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__xxxx__y_16be__avx2(uint8_t* dst_ptr,
+                                               size_t dst_len,
+                                               uint8_t* dst_palette_ptr,
+                                               size_t dst_palette_len,
+                                               const uint8_t* src_ptr,
+                                               size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len2 = src_len / 2;
+  size_t len = (dst_len4 < src_len2) ? dst_len4 : src_len2;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  __m256i shuffle = _mm256_set_epi8(-0x01, +0x0E, +0x0E, +0x0E,  //
+                                    -0x01, +0x0C, +0x0C, +0x0C,  //
+                                    -0x01, +0x0A, +0x0A, +0x0A,  //
+                                    -0x01, +0x08, +0x08, +0x08,  //
+                                    -0x01, +0x06, +0x06, +0x06,  //
+                                    -0x01, +0x04, +0x04, +0x04,  //
+                                    -0x01, +0x02, +0x02, +0x02,  //
+                                    -0x01, +0x00, +0x00, +0x00);
+  __m256i or_ff = _mm256_set1_epi32(-0x01000000);
+
+  while (n >= 8) {
+    __m256i x;
+    x = _mm256_broadcastsi128_si256(
+        _mm_lddqu_si128((const __m128i*)(const void*)s));
+    x = _mm256_shuffle_epi8(x, shuffle);
+    x = _mm256_or_si256(x, or_ff);
+    _mm256_storeu_si256((__m256i*)(void*)d, x);
+
+    s += 8 * 2;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4), 0xFF000000 | (0x010101 * (uint32_t)s[0]));
+
+    s += 1 * 2;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 static uint64_t  //
 wuffs_base__pixel_swizzler__xxxx__y_16be(uint8_t* dst_ptr,
                                          size_t dst_len,
@@ -4183,6 +5540,9 @@ wuffs_base__pixel_swizzler__prepare__y(wuffs_base__pixel_swizzler* p,
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:
     case WUFFS_BASE__PIXEL_FORMAT__RGBX:
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      if (wuffs_base__cpu_arch__have_x86_avx2()) {
+        return wuffs_base__pixel_swizzler__xxxx__y__avx2;
+      }
       if (wuffs_base__cpu_arch__have_x86_sse42()) {
         return wuffs_base__pixel_swizzler__xxxx__y__sse42;
       }
@@ -4229,6 +5589,11 @@ wuffs_base__pixel_swizzler__prepare__y_16be(wuffs_base__pixel_swizzler* p,
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:
     case WUFFS_BASE__PIXEL_FORMAT__RGBX:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      if (wuffs_base__cpu_arch__have_x86_avx2()) {
+        return wuffs_base__pixel_swizzler__xxxx__y_16be__avx2;
+      }
+#endif
       return wuffs_base__pixel_swizzler__xxxx__y_16be;
 
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:
@@ -4304,6 +5669,14 @@ wuffs_base__pixel_swizzler__prepare__indexed__bgra_nonpremul(
       }
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;
+          }
+          if (wuffs_base__cpu_arch__have_x86_sse42()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;
+          }
+#endif
           return wuffs_base__pixel_swizzler__xxxx__index__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           return wuffs_base__pixel_swizzler__bgra_nonpremul__index_bgra_nonpremul__src_over;
@@ -4332,6 +5705,14 @@ wuffs_base__pixel_swizzler__prepare__indexed__bgra_nonpremul(
               (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {
             return NULL;
           }
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;
+          }
+          if (wuffs_base__cpu_arch__have_x86_sse42()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;
+          }
+#endif
           return wuffs_base__pixel_swizzler__xxxx__index__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=
@@ -4355,6 +5736,14 @@ wuffs_base__pixel_swizzler__prepare__indexed__bgra_nonpremul(
       }
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;
+          }
+          if (wuffs_base__cpu_arch__have_x86_sse42()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;
+          }
+#endif
           return wuffs_base__pixel_swizzler__xxxx__index__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           return wuffs_base__pixel_swizzler__bgra_nonpremul__index_bgra_nonpremul__src_over;
@@ -4370,6 +5759,14 @@ wuffs_base__pixel_swizzler__prepare__indexed__bgra_nonpremul(
               (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {
             return NULL;
           }
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;
+          }
+          if (wuffs_base__cpu_arch__have_x86_sse42()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;
+          }
+#endif
           return wuffs_base__pixel_swizzler__xxxx__index__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           if (wuffs_base__pixel_swizzler__swap_rgbx_bgrx(
@@ -4447,8 +5844,21 @@ wuffs_base__pixel_swizzler__prepare__indexed__bgra_binary(
       }
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;
+          }
+          if (wuffs_base__cpu_arch__have_x86_sse42()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;
+          }
+#endif
           return wuffs_base__pixel_swizzler__xxxx__index__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over__avx2;
+          }
+#endif
           return wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over;
       }
       return NULL;
@@ -4493,8 +5903,21 @@ wuffs_base__pixel_swizzler__prepare__indexed__bgra_binary(
       }
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;
+          }
+          if (wuffs_base__cpu_arch__have_x86_sse42()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;
+          }
+#endif
           return wuffs_base__pixel_swizzler__xxxx__index__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over__avx2;
+          }
+#endif
           return wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over;
       }
       return NULL;
@@ -4552,6 +5975,11 @@ wuffs_base__pixel_swizzler__prepare__bgr(wuffs_base__pixel_swizzler* p,
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:
     case WUFFS_BASE__PIXEL_FORMAT__BGRX:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      if (wuffs_base__cpu_arch__have_x86_avx2()) {
+        return wuffs_base__pixel_swizzler__bgrw__bgr__avx2;
+      }
+#endif
       return wuffs_base__pixel_swizzler__bgrw__bgr;
 
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:
@@ -4566,6 +5994,9 @@ wuffs_base__pixel_swizzler__prepare__bgr(wuffs_base__pixel_swizzler* p,
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:
     case WUFFS_BASE__PIXEL_FORMAT__RGBX:
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      if (wuffs_base__cpu_arch__have_x86_avx2()) {
+        return wuffs_base__pixel_swizzler__bgrw__rgb__avx2;
+      }
       if (wuffs_base__cpu_arch__have_x86_sse42()) {
         return wuffs_base__pixel_swizzler__bgrw__rgb__sse42;
       }
@@ -4622,6 +6053,11 @@ wuffs_base__pixel_swizzler__prepare__bgra_nonpremul(
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src__avx2;
+          }
+#endif
           return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src_over;
@@ -4641,6 +6077,9 @@ wuffs_base__pixel_swizzler__prepare__bgra_nonpremul(
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__avx2;
+          }
           if (wuffs_base__cpu_arch__have_x86_sse42()) {
             return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42;
           }
@@ -4654,6 +6093,11 @@ wuffs_base__pixel_swizzler__prepare__bgra_nonpremul(
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src__avx2;
+          }
+#endif
           return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src_over;
@@ -4715,6 +6159,11 @@ wuffs_base__pixel_swizzler__prepare__bgra_nonpremul_4x16le(
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src__avx2;
+          }
+#endif
           return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src_over;
@@ -4742,6 +6191,11 @@ wuffs_base__pixel_swizzler__prepare__bgra_nonpremul_4x16le(
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src__avx2;
+          }
+#endif
           return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src_over;
@@ -4805,6 +6259,14 @@ wuffs_base__pixel_swizzler__prepare__bgra_premul(
         case WUFFS_BASE__PIXEL_BLEND__SRC:
           return wuffs_base__pixel_swizzler__copy_4_4;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__avx2;
+          }
+          if (wuffs_base__cpu_arch__have_x86_sse42()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__sse42;
+          }
+#endif
           return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over;
       }
       return NULL;
@@ -4822,6 +6284,9 @@ wuffs_base__pixel_swizzler__prepare__bgra_premul(
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__avx2;
+          }
           if (wuffs_base__cpu_arch__have_x86_sse42()) {
             return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42;
           }
@@ -4851,6 +6316,11 @@ wuffs_base__pixel_swizzler__prepare__bgrx(wuffs_base__pixel_swizzler* p,
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      if (wuffs_base__cpu_arch__have_x86_avx2()) {
+        return wuffs_base__pixel_swizzler__bgrw__bgrx__avx2;
+      }
+#endif
       return wuffs_base__pixel_swizzler__bgrw__bgrx;
 
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:
@@ -4890,6 +6360,9 @@ wuffs_base__pixel_swizzler__prepare__rgb(wuffs_base__pixel_swizzler* p,
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:
     case WUFFS_BASE__PIXEL_FORMAT__BGRX:
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      if (wuffs_base__cpu_arch__have_x86_avx2()) {
+        return wuffs_base__pixel_swizzler__bgrw__rgb__avx2;
+      }
       if (wuffs_base__cpu_arch__have_x86_sse42()) {
         return wuffs_base__pixel_swizzler__bgrw__rgb__sse42;
       }
@@ -4906,6 +6379,11 @@ wuffs_base__pixel_swizzler__prepare__rgb(wuffs_base__pixel_swizzler* p,
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:
     case WUFFS_BASE__PIXEL_FORMAT__RGBX:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      if (wuffs_base__cpu_arch__have_x86_avx2()) {
+        return wuffs_base__pixel_swizzler__bgrw__bgr__avx2;
+      }
+#endif
       return wuffs_base__pixel_swizzler__bgrw__bgr;
   }
   return NULL;
@@ -4941,6 +6419,9 @@ wuffs_base__pixel_swizzler__prepare__rgba_nonpremul(
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__avx2;
+          }
           if (wuffs_base__cpu_arch__have_x86_sse42()) {
             return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42;
           }
@@ -4963,6 +6444,11 @@ wuffs_base__pixel_swizzler__prepare__rgba_nonpremul(
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src__avx2;
+          }
+#endif
           return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src_over;
@@ -4990,6 +6476,11 @@ wuffs_base__pixel_swizzler__prepare__rgba_nonpremul(
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src__avx2;
+          }
+#endif
           return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src_over;
@@ -5052,6 +6543,9 @@ wuffs_base__pixel_swizzler__prepare__rgba_premul(
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__avx2;
+          }
           if (wuffs_base__cpu_arch__have_x86_sse42()) {
             return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42;
           }
@@ -5076,6 +6570,14 @@ wuffs_base__pixel_swizzler__prepare__rgba_premul(
         case WUFFS_BASE__PIXEL_BLEND__SRC:
           return wuffs_base__pixel_swizzler__copy_4_4;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__avx2;
+          }
+          if (wuffs_base__cpu_arch__have_x86_sse42()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__sse42;
+          }
+#endif
           return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over;
       }
       return NULL;
@@ -5099,6 +6601,7 @@ wuffs_base__pixel_swizzler__prepare(wuffs_base__pixel_swizzler* p,
   p->private_impl.transparent_black_func = NULL;
   p->private_impl.dst_pixfmt_bytes_per_pixel = 0;
   p->private_impl.src_pixfmt_bytes_per_pixel = 0;
+  p->private_impl.downscale_func = NULL;
 
   wuffs_base__pixel_swizzler__func func = NULL;
   wuffs_base__pixel_swizzler__transparent_black_func transparent_black_func =
@@ -5209,6 +6712,165 @@ wuffs_base__pixel_swizzler__prepare(wuffs_base__pixel_swizzler* p,
       func ? NULL : wuffs_base__error__unsupported_pixel_swizzler_option);
 }
 
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status  //
+wuffs_base__pixel_swizzler__prepare_downscaled(
+    wuffs_base__pixel_swizzler* p,
+    wuffs_base__pixel_format dst_pixfmt,
+    wuffs_base__slice_u8 dst_palette,
+    wuffs_base__pixel_format src_pixfmt,
+    wuffs_base__slice_u8 src_palette,
+    wuffs_base__pixel_blend blend) {
+  wuffs_base__pixel_format premul =
+      wuffs_base__make_pixel_format(WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL);
+
+  // The second half converts the averaged pixels to the dst pixel format.
+  wuffs_base__pixel_swizzler q;
+  wuffs_base__status status = wuffs_base__pixel_swizzler__prepare(
+      &q, dst_pixfmt, dst_palette, premul, wuffs_base__empty_slice_u8(),
+      blend);
+  if (status.repr) {
+    if (p) {
+      p->private_impl.func = NULL;
+      p->private_impl.downscale_func = NULL;
+    }
+    return status;
+  }
+
+  // The first half converts the src pixels to premultiplied BGRA, which can
+  // be summed channel by channel.
+  status = wuffs_base__pixel_swizzler__prepare(
+      p, premul, dst_palette, src_pixfmt, src_palette,
+      WUFFS_BASE__PIXEL_BLEND__SRC);
+  if (status.repr) {
+    return status;
+  }
+  p->private_impl.transparent_black_func = q.private_impl.transparent_black_func;
+  p->private_impl.dst_pixfmt_bytes_per_pixel =
+      q.private_impl.dst_pixfmt_bytes_per_pixel;
+  p->private_impl.downscale_func = q.private_impl.func;
+  return wuffs_base__make_status(NULL);
+}
+
+WUFFS_BASE__MAYBE_STATIC uint64_t  //
+wuffs_base__pixel_swizzler__swizzle_downscaled_from_slice(
+    const wuffs_base__pixel_swizzler* p,
+    wuffs_base__table_u8 dst,
+    wuffs_base__slice_u8 dst_palette,
+    wuffs_base__slice_u8 accum,
+    wuffs_base__slice_u8 src,
+    uint32_t shift,
+    uint32_t x,
+    uint32_t y,
+    uint32_t y0,
+    uint32_t y1) {
+  if (!p || !p->private_impl.func || !p->private_impl.downscale_func ||
+      (shift > 3) || (y < y0) || (y >= y1)) {
+    return 0;
+  }
+  size_t src_bytes_per_pixel = p->private_impl.src_pixfmt_bytes_per_pixel;
+  if (src_bytes_per_pixel == 0) {
+    return 0;
+  }
+  uint64_t n = src.len / src_bytes_per_pixel;
+  if ((n == 0) || (n > (((uint64_t)UINT32_MAX) - ((uint64_t)x)))) {
+    return 0;
+  }
+
+  // The source pixels are columns [x, x_end). They map to the destination
+  // columns [dx0, dx0 + num_dx). Rows [by0, by1) map to the destination row
+  // (y >> shift).
+  uint64_t x_end = ((uint64_t)x) + n;
+  uint64_t dx0 = ((uint64_t)x) >> shift;
+  uint64_t num_dx = ((x_end - 1) >> shift) + 1 - dx0;
+  if ((accum.len / 8) < num_dx) {
+    return 0;
+  }
+  uint64_t block_y = ((uint64_t)(y >> shift)) << shift;
+  uint64_t by0 = wuffs_base__u64__max(y0, block_y);
+  uint64_t by1 = wuffs_base__u64__min(y1, block_y + (1u << shift));
+  if (y == by0) {
+    memset(accum.ptr, 0, (size_t)(8 * num_dx));
+  }
+
+  // Convert the src pixels to premultiplied BGRA, a chunk at a time, and add
+  // them to the accumulators, which are pairs of little-endian bytes.
+  uint8_t buf[64 * 4];
+  const uint8_t* s = src.ptr;
+  uint64_t sx = x;
+  while (sx < x_end) {
+    size_t m = (size_t)(wuffs_base__u64__min(x_end - sx, 64));
+    (*p->private_impl.func)(buf, sizeof(buf), dst_palette.ptr, dst_palette.len,
+                            s, m * src_bytes_per_pixel);
+    size_t i;
+    for (i = 0; i < m; i++) {
+      uint8_t* a = accum.ptr + (8 * (((sx + i) >> shift) - dx0));
+      wuffs_base__poke_u16le__no_bounds_check(
+          a + 0, (uint16_t)(wuffs_base__peek_u16le__no_bounds_check(a + 0) +
+                            buf[(4 * i) + 0]));
+      wuffs_base__poke_u16le__no_bounds_check(
+          a + 2, (uint16_t)(wuffs_base__peek_u16le__no_bounds_check(a + 2) +
+                            buf[(4 * i) + 1]));
+      wuffs_base__poke_u16le__no_bounds_check(
+          a + 4, (uint16_t)(wuffs_base__peek_u16le__no_bounds_check(a + 4) +
+                            buf[(4 * i) + 2]));
+      wuffs_base__poke_u16le__no_bounds_check(
+          a + 6, (uint16_t)(wuffs_base__peek_u16le__no_bounds_check(a + 6) +
+                            buf[(4 * i) + 3]));
+    }
+    s += m * src_bytes_per_pixel;
+    sx += m;
+  }
+  if ((((uint64_t)y) + 1) != by1) {
+    return n;
+  }
+
+  // That was the block's last row. Divide the sums by the number of source
+  // pixels in each block (fewer at the edges) and convert to the dst format.
+  wuffs_base__slice_u8 row = wuffs_base__table_u8__row(dst, y >> shift);
+  uint64_t dst_bytes_per_pixel = p->private_impl.dst_pixfmt_bytes_per_pixel;
+  if ((dst_bytes_per_pixel == 0) ||
+      ((row.len / dst_bytes_per_pixel) <= dx0)) {
+    return n;
+  }
+  row.ptr += dx0 * dst_bytes_per_pixel;
+  row.len -= dx0 * dst_bytes_per_pixel;
+  uint64_t num_rows = by1 - by0;
+  uint64_t dx = 0;
+  while (dx < num_dx) {
+    size_t m = (size_t)(wuffs_base__u64__min(num_dx - dx, 64));
+    size_t i;
+    for (i = 0; i < m; i++) {
+      uint64_t cx = (dx0 + dx + i) << shift;
+      uint64_t num_cols =
+          wuffs_base__u64__min(x_end, cx + (1u << shift)) -
+          wuffs_base__u64__max(x, cx);
+      uint32_t count = (uint32_t)(num_cols * num_rows);
+      const uint8_t* a = accum.ptr + (8 * (dx + i));
+      buf[(4 * i) + 0] = (uint8_t)(
+          (wuffs_base__peek_u16le__no_bounds_check(a + 0) + (count / 2)) /
+          count);
+      buf[(4 * i) + 1] = (uint8_t)(
+          (wuffs_base__peek_u16le__no_bounds_check(a + 2) + (count / 2)) /
+          count);
+      buf[(4 * i) + 2] = (uint8_t)(
+          (wuffs_base__peek_u16le__no_bounds_check(a + 4) + (count / 2)) /
+          count);
+      buf[(4 * i) + 3] = (uint8_t)(
+          (wuffs_base__peek_u16le__no_bounds_check(a + 6) + (count / 2)) /
+          count);
+    }
+    uint64_t k = (*p->private_impl.downscale_func)(
+        row.ptr, row.len, dst_palette.ptr, dst_palette.len, buf, 4 * m);
+    if (k < m) {
+      break;
+    }
+    row.ptr += k * dst_bytes_per_pixel;
+    row.len -= k * dst_bytes_per_pixel;
+    dx += k;
+  }
+  return n;
+}
+
 WUFFS_BASE__MAYBE_STATIC uint64_t  //
 wuffs_base__pixel_swizzler__limited_swizzle_u32_interleaved_from_reader(
     const wuffs_base__pixel_swizzler* p,
@@ -814,6 +814,11 @@ wuffs_base__rect_ie_u32::height() const {
 // The flavor field follows the base38 namespace
 // convention](/doc/note/base38-and-fourcc.md). The other fields' semantics
 // depends on the flavor.
+//
+// For the METADATA flavor, w is the metadata's FourCC and [y, z) is the
+// io_position range of its bytes. A non-zero x is the FourCC of an encoding,
+// such as WUFFS_BASE__FOURCC__ZLIB, that the caller has to undo to get the
+// metadata itself. A zero x means that the bytes are the metadata as is.
 typedef struct wuffs_base__more_information__struct {
   uint32_t flavor;
   uint32_t w;
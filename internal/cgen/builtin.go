@@ -346,6 +346,11 @@ func (g *gen) writeBuiltinIOWriter(b *buffer, recv *a.Expr, method t.ID, args []
 			iopPrefix, recvName, io2Prefix, recvName)
 		return g.writeArgs(b, args, depth)
 
+	case t.IDLimitedWriteU64LEFast:
+		b.printf("wuffs_base__io_writer__limited_write_u64le_fast(\n&%s%s, %s%s,",
+			iopPrefix, recvName, io2Prefix, recvName)
+		return g.writeArgs(b, args, depth)
+
 	case t.IDCountSince:
 		b.printf("wuffs_base__io__count_since(")
 		if err := g.writeExpr(b, args[0].AsArg().Value(), false, depth); err != nil {
@@ -453,7 +458,8 @@ func (g *gen) writeBuiltinCPUArch(b *buffer, recv *a.Expr, method t.ID, args []*
 	case id.IsBuiltInCPUArchARMNeon():
 		return g.writeBuiltinCPUArchARMNeon(b, recv, method, args, sideEffectsOnly, depth)
 	case id == t.IDX86SSE42Utility, id == t.IDX86M128I,
-		id == t.IDX86AVX2Utility, id == t.IDX86M256I:
+		id == t.IDX86AVX2Utility, id == t.IDX86M256I,
+		id == t.IDX86AVX512Utility, id == t.IDX86M512I:
 		return g.writeBuiltinCPUArchX86(b, recv, method, args, sideEffectsOnly, depth)
 	}
 	return fmt.Errorf("internal error: unsupported cpu_arch method %s.%s",
@@ -652,6 +658,20 @@ func (g *gen) writeBuiltinCPUArchX86(b *buffer, recv *a.Expr, method t.ID, args
 			fName, tName, ptr = "_mm256_lddqu_si256", "const __m256i*)(const void*", true
 		case "make_m256i_zeroes":
 			fName, tName = "_mm256_setzero_si256", ""
+
+		case "make_m512i_single_u32":
+			// The 0x0001 mask sets the lowest 32-bit element and zeroes the
+			// rest. It's like _mm_cvtsi32_si128 but for 512-bit registers.
+			b.writes("_mm512_maskz_set1_epi32(0x0001, (int32_t)(")
+			if err := g.writeExpr(b, args[0].AsArg().Value(), false, depth); err != nil {
+				return err
+			}
+			b.writes("))")
+			return nil
+		case "make_m512i_slice512":
+			fName, tName, ptr = "_mm512_loadu_si512", "const void*", true
+		case "make_m512i_zeroes":
+			fName, tName = "_mm512_setzero_si512", ""
 		default:
 			return fmt.Errorf("internal error: unsupported cpu_arch method %q", methodStr)
 		}
@@ -714,6 +734,50 @@ func (g *gen) writeBuiltinCPUArchX86(b *buffer, recv *a.Expr, method t.ID, args
 		b.writes(")))")
 		return nil
 
+	} else if strings.HasPrefix(methodStr, "_mm_crc32_u") {
+		// The 64-bit variant takes and returns a uint64_t CRC state, even
+		// though only the low 32 bits are used.
+		size := methodStr[len("_mm_crc32_u"):]
+		crcType := "uint32_t"
+		if size == "64" {
+			crcType = "uint64_t"
+		}
+		b.printf("((uint32_t)(_mm_crc32_u%s((%s)(", size, crcType)
+		if err := g.writeExpr(b, args[0].AsArg().Value(), false, depth); err != nil {
+			return err
+		}
+		b.printf("), (uint%s_t)(", size)
+		if err := g.writeExpr(b, args[1].AsArg().Value(), false, depth); err != nil {
+			return err
+		}
+		b.writes("))))")
+		return nil
+
+	} else if methodStr == "_mm_movemask_epi8" {
+		b.writes("((uint32_t)(_mm_movemask_epi8(")
+		if err := g.writeExpr(b, recv, false, depth); err != nil {
+			return err
+		}
+		b.writes(")))")
+		return nil
+
+	} else if methodStr == "_mm512_maskz_extracti32x4_epi32" {
+		// The C intrinsic takes the mask before the (receiver) vector.
+		b.writes("_mm512_maskz_extracti32x4_epi32((__mmask8)(")
+		if err := g.writeExpr(b, args[0].AsArg().Value(), false, depth); err != nil {
+			return err
+		}
+		b.writes("), ")
+		if err := g.writeExpr(b, recv, false, depth); err != nil {
+			return err
+		}
+		b.writes(", (int32_t)(")
+		if err := g.writeExpr(b, args[1].AsArg().Value(), false, depth); err != nil {
+			return err
+		}
+		b.writes("))")
+		return nil
+
 	} else if strings.HasPrefix(methodStr, "_mm_extract_epi") {
 		size := methodStr[len("_mm_extract_epi"):]
 		b.printf("((uint%s_t)(_mm_extract_epi%s(", size, size)
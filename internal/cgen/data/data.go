@@ -55,16 +55,18 @@ const BaseFundamentalPublicH = "" +
 	"fine WUFFS_VERSION_PRE_RELEASE_LABEL \"work.in.progress\"\n#define WUFFS_VERSION_BUILD_METADATA_COMMIT_COUNT 0\n#define WUFFS_VERSION_BUILD_METADATA_COMMIT_DATE 0\n#define WUFFS_VERSION_STRING \"0.0.0+0.00000000\"\n\n" +
 	"" +
 	"// ---------------- Configuration\n\n// Define WUFFS_CONFIG__AVOID_CPU_ARCH to avoid any code tied to a specific CPU\n// architecture, such as SSE SIMD for the x86 CPU family.\n#if defined(WUFFS_CONFIG__AVOID_CPU_ARCH)  // (#if-chain ref AVOID_CPU_ARCH_0)\n// No-op.\n#else  // (#if-chain ref AVOID_CPU_ARCH_0)\n\n// The \"defined(__clang__)\" isn't redundant. While vanilla clang defines\n// __GNUC__, clang-cl (which mimics MSVC's cl.exe) does not.\n#if defined(__GNUC__) || defined(__clang__)\n#define WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(arg) __attribute__((target(arg)))\n#else\n#define WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(arg)\n#endif  // defined(__GNUC__) || defined(__clang__)\n\n#if defined(__GNUC__)  // (#if-chain ref AVOID_CPU_ARCH_1)\n\n// To simplify Wuffs code, \"cpu_arch >= arm_xxx\" requires xxx but also\n// unaligned little-endian load/stores.\n#if defined(__ARM_FEATURE_UNALIGNED) && !defined(__native_client__) && \\\n    defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)\n// Not all gcc versions define __ARM_A" +
-	"CLE, even if they support crc32\n// intrinsics. Look for __ARM_FEATURE_CRC32 instead.\n#if defined(__ARM_FEATURE_CRC32)\n#include <arm_acle.h>\n#define WUFFS_BASE__CPU_ARCH__ARM_CRC32\n#endif  // defined(__ARM_FEATURE_CRC32)\n#if defined(__ARM_NEON)\n#include <arm_neon.h>\n#define WUFFS_BASE__CPU_ARCH__ARM_NEON\n#endif  // defined(__ARM_NEON)\n#endif  // defined(__ARM_FEATURE_UNALIGNED) etc\n\n// Similarly, \"cpu_arch >= x86_sse42\" requires SSE4.2 but also PCLMUL and\n// POPCNT. This is checked at runtime via cpuid, not at compile time.\n//\n// Likewise, \"cpu_arch >= x86_avx2\" also requires PCLMUL, POPCNT and SSE4.2.\n#if defined(__x86_64__) && !defined(__native_client__)\n#include <cpuid.h>\n#include <x86intrin.h>\n#define WUFFS_BASE__CPU_ARCH__X86_64\n#endif  // defined(__x86_64__) && !defined(__native_client__)\n\n#elif defined(_MSC_VER)  // (#if-chain ref AVOID_CPU_ARCH_1)\n\n#if defined(_M_X64)\n#if defined(__AVX__) || defined(__clang__)\n\n// We need <intrin.h> for the __cpuid function.\n#include <intrin.h>\n// That's not enough for" +
-	" X64 SIMD, with clang-cl, if we want to use\n// \"__attribute__((target(arg)))\" without e.g. \"/arch:AVX\".\n//\n// Some web pages suggest that <immintrin.h> is all you need, as it pulls in\n// the earlier SIMD families like SSE4.2, but that doesn't seem to work in\n// practice, possibly for the same reason that just <intrin.h> doesn't work.\n#include <immintrin.h>  // AVX, AVX2, FMA, POPCNT\n#include <nmmintrin.h>  // SSE4.2\n#include <wmmintrin.h>  // AES, PCLMUL\n#define WUFFS_BASE__CPU_ARCH__X86_64\n\n#else  // defined(__AVX__) || defined(__clang__)\n\n// clang-cl (which defines both __clang__ and _MSC_VER) supports\n// \"__attribute__((target(arg)))\".\n//\n// For MSVC's cl.exe (unlike clang or gcc), SIMD capability is a compile-time\n// property of the source file (e.g. a /arch:AVX or -mavx compiler flag), not\n// of individual functions (that can be conditionally selected at runtime).\n#pragma message(\"Wuffs with MSVC+X64 needs /arch:AVX for best performance\")\n\n#endif  // defined(__AVX__) || defined(__clang__)\n#endif  // defi" +
-	"ned(_M_X64)\n\n#endif  // (#if-chain ref AVOID_CPU_ARCH_1)\n#endif  // (#if-chain ref AVOID_CPU_ARCH_0)\n\n" +
+	"CLE, even if they support crc32\n// intrinsics. Look for __ARM_FEATURE_CRC32 instead.\n#if defined(__ARM_FEATURE_CRC32)\n#include <arm_acle.h>\n#define WUFFS_BASE__CPU_ARCH__ARM_CRC32\n#endif  // defined(__ARM_FEATURE_CRC32)\n#if defined(__ARM_NEON)\n#include <arm_neon.h>\n#define WUFFS_BASE__CPU_ARCH__ARM_NEON\n#endif  // defined(__ARM_NEON)\n#endif  // defined(__ARM_FEATURE_UNALIGNED) etc\n\n// Similarly, \"cpu_arch >= x86_sse42\" requires SSE4.2 but also PCLMUL and\n// POPCNT. This is checked at runtime via cpuid, not at compile time.\n//\n// Likewise, \"cpu_arch >= x86_avx2\" also requires PCLMUL, POPCNT and SSE4.2.\n//\n// And \"cpu_arch >= x86_avx512\" requires AVX-512F, AVX-512BW, AVX-512VL and\n// VPCLMULQDQ (Ice Lake, Zen 4 or later), as well as everything that\n// \"cpu_arch >= x86_avx2\" requires.\n#if defined(__x86_64__) && !defined(__native_client__)\n#include <cpuid.h>\n#include <x86intrin.h>\n#define WUFFS_BASE__CPU_ARCH__X86_64\n#endif  // defined(__x86_64__) && !defined(__native_client__)\n\n#elif defined(_MSC_VER)  // (#if-c" +
+	"hain ref AVOID_CPU_ARCH_1)\n\n#if defined(_M_X64)\n#if defined(__AVX__) || defined(__clang__)\n\n// We need <intrin.h> for the __cpuid function.\n#include <intrin.h>\n// That's not enough for X64 SIMD, with clang-cl, if we want to use\n// \"__attribute__((target(arg)))\" without e.g. \"/arch:AVX\".\n//\n// Some web pages suggest that <immintrin.h> is all you need, as it pulls in\n// the earlier SIMD families like SSE4.2, but that doesn't seem to work in\n// practice, possibly for the same reason that just <intrin.h> doesn't work.\n#include <immintrin.h>  // AVX, AVX2, FMA, POPCNT\n#include <nmmintrin.h>  // SSE4.2\n#include <wmmintrin.h>  // AES, PCLMUL\n#define WUFFS_BASE__CPU_ARCH__X86_64\n\n#else  // defined(__AVX__) || defined(__clang__)\n\n// clang-cl (which defines both __clang__ and _MSC_VER) supports\n// \"__attribute__((target(arg)))\".\n//\n// For MSVC's cl.exe (unlike clang or gcc), SIMD capability is a compile-time\n// property of the source file (e.g. a /arch:AVX or -mavx compiler flag), not\n// of individual functions (that c" +
+	"an be conditionally selected at runtime).\n#pragma message(\"Wuffs with MSVC+X64 needs /arch:AVX for best performance\")\n\n#endif  // defined(__AVX__) || defined(__clang__)\n#endif  // defined(_M_X64)\n\n#endif  // (#if-chain ref AVOID_CPU_ARCH_1)\n#endif  // (#if-chain ref AVOID_CPU_ARCH_0)\n\n" +
 	"" +
 	"// --------\n\n// Define WUFFS_CONFIG__STATIC_FUNCTIONS to make all of Wuffs' functions have\n// static storage. The motivation is discussed in the \"ALLOW STATIC\n// IMPLEMENTATION\" section of\n// https://raw.githubusercontent.com/nothings/stb/master/docs/stb_howto.txt\n#if defined(WUFFS_CONFIG__STATIC_FUNCTIONS)\n#define WUFFS_BASE__MAYBE_STATIC static\n#else\n#define WUFFS_BASE__MAYBE_STATIC\n#endif  // defined(WUFFS_CONFIG__STATIC_FUNCTIONS)\n\n" +
 	"" +
 	"// ---------------- CPU Architecture\n\nstatic inline bool  //\nwuffs_base__cpu_arch__have_arm_crc32() {\n#if defined(WUFFS_BASE__CPU_ARCH__ARM_CRC32)\n  return true;\n#else\n  return false;\n#endif  // defined(WUFFS_BASE__CPU_ARCH__ARM_CRC32)\n}\n\nstatic inline bool  //\nwuffs_base__cpu_arch__have_arm_neon() {\n#if defined(WUFFS_BASE__CPU_ARCH__ARM_NEON)\n  return true;\n#else\n  return false;\n#endif  // defined(WUFFS_BASE__CPU_ARCH__ARM_NEON)\n}\n\nstatic inline bool  //\nwuffs_base__cpu_arch__have_x86_avx2() {\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n  // GCC defines these macros but MSVC does not.\n  //  - bit_AVX2 = (1 <<  5)\n  const unsigned int avx2_ebx7 = 0x00000020;\n  // GCC defines these macros but MSVC does not.\n  //  - bit_PCLMUL = (1 <<  1)\n  //  - bit_POPCNT = (1 << 23)\n  //  - bit_SSE4_2 = (1 << 20)\n  const unsigned int avx2_ecx1 = 0x00900002;\n\n  // clang defines __GNUC__ and clang-cl defines _MSC_VER (but not __GNUC__).\n#if defined(__GNUC__)\n  unsigned int eax7 = 0;\n  unsigned int ebx7 = 0;\n  unsigned int ecx7 =" +
-	" 0;\n  unsigned int edx7 = 0;\n  if (__get_cpuid_count(7, 0, &eax7, &ebx7, &ecx7, &edx7) &&\n      ((ebx7 & avx2_ebx7) == avx2_ebx7)) {\n    unsigned int eax1 = 0;\n    unsigned int ebx1 = 0;\n    unsigned int ecx1 = 0;\n    unsigned int edx1 = 0;\n    if (__get_cpuid(1, &eax1, &ebx1, &ecx1, &edx1) &&\n        ((ecx1 & avx2_ecx1) == avx2_ecx1)) {\n      return true;\n    }\n  }\n#elif defined(_MSC_VER)  // defined(__GNUC__)\n  int x7[4];\n  __cpuidex(x7, 7, 0);\n  if ((((unsigned int)(x7[1])) & avx2_ebx7) == avx2_ebx7) {\n    int x1[4];\n    __cpuid(x1, 1);\n    if ((((unsigned int)(x1[2])) & avx2_ecx1) == avx2_ecx1) {\n      return true;\n    }\n  }\n#else\n#error \"WUFFS_BASE__CPU_ARCH__ETC combined with an unsupported compiler\"\n#endif  // defined(__GNUC__); defined(_MSC_VER)\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n  return false;\n}\n\nstatic inline bool  //\nwuffs_base__cpu_arch__have_x86_bmi2() {\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n  // GCC defines these macros but MSVC does not.\n  //  - bit_BMI2 = (1 <<  8)\n  const u" +
-	"nsigned int bmi2_ebx7 = 0x00000100;\n\n  // clang defines __GNUC__ and clang-cl defines _MSC_VER (but not __GNUC__).\n#if defined(__GNUC__)\n  unsigned int eax7 = 0;\n  unsigned int ebx7 = 0;\n  unsigned int ecx7 = 0;\n  unsigned int edx7 = 0;\n  if (__get_cpuid_count(7, 0, &eax7, &ebx7, &ecx7, &edx7) &&\n      ((ebx7 & bmi2_ebx7) == bmi2_ebx7)) {\n    return true;\n  }\n#elif defined(_MSC_VER)  // defined(__GNUC__)\n  int x7[4];\n  __cpuidex(x7, 7, 0);\n  if ((((unsigned int)(x7[1])) & bmi2_ebx7) == bmi2_ebx7) {\n    return true;\n  }\n#else\n#error \"WUFFS_BASE__CPU_ARCH__ETC combined with an unsupported compiler\"\n#endif  // defined(__GNUC__); defined(_MSC_VER)\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n  return false;\n}\n\nstatic inline bool  //\nwuffs_base__cpu_arch__have_x86_sse42() {\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n  // GCC defines these macros but MSVC does not.\n  //  - bit_PCLMUL = (1 <<  1)\n  //  - bit_POPCNT = (1 << 23)\n  //  - bit_SSE4_2 = (1 << 20)\n  const unsigned int sse42_ecx1 = 0x00900002;\n\n  // clan" +
-	"g defines __GNUC__ and clang-cl defines _MSC_VER (but not __GNUC__).\n#if defined(__GNUC__)\n  unsigned int eax1 = 0;\n  unsigned int ebx1 = 0;\n  unsigned int ecx1 = 0;\n  unsigned int edx1 = 0;\n  if (__get_cpuid(1, &eax1, &ebx1, &ecx1, &edx1) &&\n      ((ecx1 & sse42_ecx1) == sse42_ecx1)) {\n    return true;\n  }\n#elif defined(_MSC_VER)  // defined(__GNUC__)\n  int x1[4];\n  __cpuid(x1, 1);\n  if ((((unsigned int)(x1[2])) & sse42_ecx1) == sse42_ecx1) {\n    return true;\n  }\n#else\n#error \"WUFFS_BASE__CPU_ARCH__ETC combined with an unsupported compiler\"\n#endif  // defined(__GNUC__); defined(_MSC_VER)\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n  return false;\n}\n\n" +
+	" 0;\n  unsigned int edx7 = 0;\n  if (__get_cpuid_count(7, 0, &eax7, &ebx7, &ecx7, &edx7) &&\n      ((ebx7 & avx2_ebx7) == avx2_ebx7)) {\n    unsigned int eax1 = 0;\n    unsigned int ebx1 = 0;\n    unsigned int ecx1 = 0;\n    unsigned int edx1 = 0;\n    if (__get_cpuid(1, &eax1, &ebx1, &ecx1, &edx1) &&\n        ((ecx1 & avx2_ecx1) == avx2_ecx1)) {\n      return true;\n    }\n  }\n#elif defined(_MSC_VER)  // defined(__GNUC__)\n  int x7[4];\n  __cpuidex(x7, 7, 0);\n  if ((((unsigned int)(x7[1])) & avx2_ebx7) == avx2_ebx7) {\n    int x1[4];\n    __cpuid(x1, 1);\n    if ((((unsigned int)(x1[2])) & avx2_ecx1) == avx2_ecx1) {\n      return true;\n    }\n  }\n#else\n#error \"WUFFS_BASE__CPU_ARCH__ETC combined with an unsupported compiler\"\n#endif  // defined(__GNUC__); defined(_MSC_VER)\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n  return false;\n}\n\nstatic inline bool  //\nwuffs_base__cpu_arch__have_x86_avx512() {\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n  // GCC defines these macros but MSVC does not.\n  //  - bit_AVX2     = (1 <<  5)\n  /" +
+	"/  - bit_AVX512F  = (1 << 16)\n  //  - bit_AVX512BW = (1 << 30)\n  //  - bit_AVX512VL = (1 << 31)\n  const unsigned int avx512_ebx7 = 0xC0010020;\n  // GCC defines these macros but MSVC does not.\n  //  - bit_VPCLMULQDQ = (1 << 10)\n  const unsigned int avx512_ecx7 = 0x00000400;\n  // GCC defines these macros but MSVC does not.\n  //  - bit_PCLMUL  = (1 <<  1)\n  //  - bit_POPCNT  = (1 << 23)\n  //  - bit_SSE4_2  = (1 << 20)\n  //  - bit_OSXSAVE = (1 << 27)\n  const unsigned int avx512_ecx1 = 0x08900002;\n  // The OS must also save and restore the AVX-512 register state: XCR0 bits 1\n  // (SSE), 2 (AVX), 5 (opmask), 6 (ZMM_Hi256) and 7 (Hi16_ZMM).\n  const unsigned int avx512_xcr0 = 0x000000E6;\n\n  // clang defines __GNUC__ and clang-cl defines _MSC_VER (but not __GNUC__).\n#if defined(__GNUC__)\n  unsigned int eax7 = 0;\n  unsigned int ebx7 = 0;\n  unsigned int ecx7 = 0;\n  unsigned int edx7 = 0;\n  if (__get_cpuid_count(7, 0, &eax7, &ebx7, &ecx7, &edx7) &&\n      ((ebx7 & avx512_ebx7) == avx512_ebx7) &&\n      ((ecx7 & avx512_ecx7" +
+	") == avx512_ecx7)) {\n    unsigned int eax1 = 0;\n    unsigned int ebx1 = 0;\n    unsigned int ecx1 = 0;\n    unsigned int edx1 = 0;\n    if (__get_cpuid(1, &eax1, &ebx1, &ecx1, &edx1) &&\n        ((ecx1 & avx512_ecx1) == avx512_ecx1)) {\n      // Use inline assembly, as the _xgetbv intrinsic needs \"-mxsave\".\n      unsigned int xcr0_lo = 0;\n      unsigned int xcr0_hi = 0;\n      __asm__ __volatile__(\"xgetbv\" : \"=a\"(xcr0_lo), \"=d\"(xcr0_hi) : \"c\"(0));\n      if ((xcr0_lo & avx512_xcr0) == avx512_xcr0) {\n        return true;\n      }\n    }\n  }\n#elif defined(_MSC_VER)  // defined(__GNUC__)\n  int x7[4];\n  __cpuidex(x7, 7, 0);\n  if (((((unsigned int)(x7[1])) & avx512_ebx7) == avx512_ebx7) &&\n      ((((unsigned int)(x7[2])) & avx512_ecx7) == avx512_ecx7)) {\n    int x1[4];\n    __cpuid(x1, 1);\n    if (((((unsigned int)(x1[2])) & avx512_ecx1) == avx512_ecx1) &&\n        ((((unsigned int)(_xgetbv(0))) & avx512_xcr0) == avx512_xcr0)) {\n      return true;\n    }\n  }\n#else\n#error \"WUFFS_BASE__CPU_ARCH__ETC combined with an unsupported" +
+	" compiler\"\n#endif  // defined(__GNUC__); defined(_MSC_VER)\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n  return false;\n}\n\nstatic inline bool  //\nwuffs_base__cpu_arch__have_x86_bmi2() {\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n  // GCC defines these macros but MSVC does not.\n  //  - bit_BMI2 = (1 <<  8)\n  const unsigned int bmi2_ebx7 = 0x00000100;\n\n  // clang defines __GNUC__ and clang-cl defines _MSC_VER (but not __GNUC__).\n#if defined(__GNUC__)\n  unsigned int eax7 = 0;\n  unsigned int ebx7 = 0;\n  unsigned int ecx7 = 0;\n  unsigned int edx7 = 0;\n  if (__get_cpuid_count(7, 0, &eax7, &ebx7, &ecx7, &edx7) &&\n      ((ebx7 & bmi2_ebx7) == bmi2_ebx7)) {\n    return true;\n  }\n#elif defined(_MSC_VER)  // defined(__GNUC__)\n  int x7[4];\n  __cpuidex(x7, 7, 0);\n  if ((((unsigned int)(x7[1])) & bmi2_ebx7) == bmi2_ebx7) {\n    return true;\n  }\n#else\n#error \"WUFFS_BASE__CPU_ARCH__ETC combined with an unsupported compiler\"\n#endif  // defined(__GNUC__); defined(_MSC_VER)\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n  re" +
+	"turn false;\n}\n\nstatic inline bool  //\nwuffs_base__cpu_arch__have_x86_sse42() {\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n  // GCC defines these macros but MSVC does not.\n  //  - bit_PCLMUL = (1 <<  1)\n  //  - bit_POPCNT = (1 << 23)\n  //  - bit_SSE4_2 = (1 << 20)\n  const unsigned int sse42_ecx1 = 0x00900002;\n\n  // clang defines __GNUC__ and clang-cl defines _MSC_VER (but not __GNUC__).\n#if defined(__GNUC__)\n  unsigned int eax1 = 0;\n  unsigned int ebx1 = 0;\n  unsigned int ecx1 = 0;\n  unsigned int edx1 = 0;\n  if (__get_cpuid(1, &eax1, &ebx1, &ecx1, &edx1) &&\n      ((ecx1 & sse42_ecx1) == sse42_ecx1)) {\n    return true;\n  }\n#elif defined(_MSC_VER)  // defined(__GNUC__)\n  int x1[4];\n  __cpuid(x1, 1);\n  if ((((unsigned int)(x1[2])) & sse42_ecx1) == sse42_ecx1) {\n    return true;\n  }\n#else\n#error \"WUFFS_BASE__CPU_ARCH__ETC combined with an unsupported compiler\"\n#endif  // defined(__GNUC__); defined(_MSC_VER)\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n  return false;\n}\n\n" +
 	"" +
 	"// ---------------- Fundamentals\n\n// Wuffs assumes that:\n//  - converting a uint32_t to a size_t will never overflow.\n//  - converting a size_t to a uint64_t will never overflow.\n#if defined(__WORDSIZE)\n#if (__WORDSIZE != 32) && (__WORDSIZE != 64)\n#error \"Wuffs requires a word size of either 32 or 64 bits\"\n#endif\n#endif\n\n// Clang also defines \"__GNUC__\".\n#if defined(__GNUC__)\n#define WUFFS_BASE__POTENTIALLY_UNUSED __attribute__((unused))\n#define WUFFS_BASE__WARN_UNUSED_RESULT __attribute__((warn_unused_result))\n#else\n#define WUFFS_BASE__POTENTIALLY_UNUSED\n#define WUFFS_BASE__WARN_UNUSED_RESULT\n#endif\n\n" +
 	"" +
@@ -142,7 +144,7 @@ const BaseMemoryPublicH = "" +
 const BaseImagePrivateH = "" +
 	"// ---------------- Images\n\nWUFFS_BASE__MAYBE_STATIC uint64_t  //\nwuffs_base__pixel_swizzler__limited_swizzle_u32_interleaved_from_reader(\n    const wuffs_base__pixel_swizzler* p,\n    uint32_t up_to_num_pixels,\n    wuffs_base__slice_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    const uint8_t** ptr_iop_r,\n    const uint8_t* io2_r);\n\nWUFFS_BASE__MAYBE_STATIC uint64_t  //\nwuffs_base__pixel_swizzler__swizzle_interleaved_from_reader(\n    const wuffs_base__pixel_swizzler* p,\n    wuffs_base__slice_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    const uint8_t** ptr_iop_r,\n    const uint8_t* io2_r);\n\nWUFFS_BASE__MAYBE_STATIC uint64_t  //\nwuffs_base__pixel_swizzler__swizzle_interleaved_transparent_black(\n    const wuffs_base__pixel_swizzler* p,\n    wuffs_base__slice_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    uint64_t num_pixels);\n\n" +
 	"" +
-	"// ---------------- Images (Utility)\n\n#define wuffs_base__utility__make_pixel_format wuffs_base__make_pixel_format\n" +
+	"// ---------------- Images (Utility)\n\n#define wuffs_base__utility__make_pixel_blend(repr) \\\n  ((wuffs_base__pixel_blend)(repr))\n#define wuffs_base__utility__make_pixel_format wuffs_base__make_pixel_format\n" +
 	""
 
 const BaseImagePublicH = "" +
@@ -195,28 +197,38 @@ const BaseImagePublicH = "" +
 	"ase__frame_config::index() const {\n  return wuffs_base__frame_config__index(this);\n}\n\ninline uint64_t  //\nwuffs_base__frame_config::io_position() const {\n  return wuffs_base__frame_config__io_position(this);\n}\n\ninline wuffs_base__animation_disposal  //\nwuffs_base__frame_config::disposal() const {\n  return wuffs_base__frame_config__disposal(this);\n}\n\ninline bool  //\nwuffs_base__frame_config::opaque_within_bounds() const {\n  return wuffs_base__frame_config__opaque_within_bounds(this);\n}\n\ninline bool  //\nwuffs_base__frame_config::overwrite_instead_of_blend() const {\n  return wuffs_base__frame_config__overwrite_instead_of_blend(this);\n}\n\ninline wuffs_base__color_u32_argb_premul  //\nwuffs_base__frame_config::background_color() const {\n  return wuffs_base__frame_config__background_color(this);\n}\n\n#endif  // __cplusplus\n\n" +
 	"" +
 	"// --------\n\ntypedef struct wuffs_base__pixel_buffer__struct {\n  wuffs_base__pixel_config pixcfg;\n\n  // Do not access the private_impl's fields directly. There is no API/ABI\n  // compatibility or safety guarantee if you do so.\n  struct {\n    wuffs_base__table_u8 planes[WUFFS_BASE__PIXEL_FORMAT__NUM_PLANES_MAX];\n    // TODO: color spaces.\n  } private_impl;\n\n#ifdef __cplusplus\n  inline wuffs_base__status set_interleaved(\n      const wuffs_base__pixel_config* pixcfg,\n      wuffs_base__table_u8 primary_memory,\n      wuffs_base__slice_u8 palette_memory);\n  inline wuffs_base__status set_from_slice(\n      const wuffs_base__pixel_config* pixcfg,\n      wuffs_base__slice_u8 pixbuf_memory);\n  inline wuffs_base__status set_from_table(\n      const wuffs_base__pixel_config* pixcfg,\n      wuffs_base__table_u8 primary_memory);\n  inline wuffs_base__slice_u8 palette();\n  inline wuffs_base__slice_u8 palette_or_else(wuffs_base__slice_u8 fallback);\n  inline wuffs_base__pixel_format pixel_format() const;\n  inline wuffs_base__table" +
-	"_u8 plane(uint32_t p);\n  inline wuffs_base__color_u32_argb_premul color_u32_at(uint32_t x,\n                                                        uint32_t y) const;\n  inline wuffs_base__status set_color_u32_at(\n      uint32_t x,\n      uint32_t y,\n      wuffs_base__color_u32_argb_premul color);\n  inline wuffs_base__status set_color_u32_fill_rect(\n      wuffs_base__rect_ie_u32 rect,\n      wuffs_base__color_u32_argb_premul color);\n#endif  // __cplusplus\n\n} wuffs_base__pixel_buffer;\n\nstatic inline wuffs_base__pixel_buffer  //\nwuffs_base__null_pixel_buffer() {\n  wuffs_base__pixel_buffer ret;\n  ret.pixcfg = wuffs_base__null_pixel_config();\n  ret.private_impl.planes[0] = wuffs_base__empty_table_u8();\n  ret.private_impl.planes[1] = wuffs_base__empty_table_u8();\n  ret.private_impl.planes[2] = wuffs_base__empty_table_u8();\n  ret.private_impl.planes[3] = wuffs_base__empty_table_u8();\n  return ret;\n}\n\nstatic inline wuffs_base__status  //\nwuffs_base__pixel_buffer__set_interleaved(\n    wuffs_base__pixel_buffer* pb,\n    co" +
-	"nst wuffs_base__pixel_config* pixcfg,\n    wuffs_base__table_u8 primary_memory,\n    wuffs_base__slice_u8 palette_memory) {\n  if (!pb) {\n    return wuffs_base__make_status(wuffs_base__error__bad_receiver);\n  }\n  memset(pb, 0, sizeof(*pb));\n  if (!pixcfg ||\n      wuffs_base__pixel_format__is_planar(&pixcfg->private_impl.pixfmt)) {\n    return wuffs_base__make_status(wuffs_base__error__bad_argument);\n  }\n  if (wuffs_base__pixel_format__is_indexed(&pixcfg->private_impl.pixfmt) &&\n      (palette_memory.len <\n       WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH)) {\n    return wuffs_base__make_status(\n        wuffs_base__error__bad_argument_length_too_short);\n  }\n  uint32_t bits_per_pixel =\n      wuffs_base__pixel_format__bits_per_pixel(&pixcfg->private_impl.pixfmt);\n  if ((bits_per_pixel == 0) || ((bits_per_pixel % 8) != 0)) {\n    // TODO: support fraction-of-byte pixels, e.g. 1 bit per pixel?\n    return wuffs_base__make_status(wuffs_base__error__unsupported_option);\n  }\n  uint64_t bytes_per_pixel = bits_per" +
-	"_pixel / 8;\n\n  uint64_t width_in_bytes =\n      ((uint64_t)pixcfg->private_impl.width) * bytes_per_pixel;\n  if ((width_in_bytes > primary_memory.width) ||\n      (pixcfg->private_impl.height > primary_memory.height)) {\n    return wuffs_base__make_status(wuffs_base__error__bad_argument);\n  }\n\n  pb->pixcfg = *pixcfg;\n  pb->private_impl.planes[0] = primary_memory;\n  if (wuffs_base__pixel_format__is_indexed(&pixcfg->private_impl.pixfmt)) {\n    wuffs_base__table_u8* tab =\n        &pb->private_impl\n             .planes[WUFFS_BASE__PIXEL_FORMAT__INDEXED__COLOR_PLANE];\n    tab->ptr = palette_memory.ptr;\n    tab->width = WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH;\n    tab->height = 1;\n    tab->stride = WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH;\n  }\n  return wuffs_base__make_status(NULL);\n}\n\nstatic inline wuffs_base__status  //\nwuffs_base__pixel_buffer__set_from_slice(wuffs_base__pixel_buffer* pb,\n                                         const wuffs_base__pixel_config* pixcfg,\n                   " +
-	"                      wuffs_base__slice_u8 pixbuf_memory) {\n  if (!pb) {\n    return wuffs_base__make_status(wuffs_base__error__bad_receiver);\n  }\n  memset(pb, 0, sizeof(*pb));\n  if (!pixcfg) {\n    return wuffs_base__make_status(wuffs_base__error__bad_argument);\n  }\n  if (wuffs_base__pixel_format__is_planar(&pixcfg->private_impl.pixfmt)) {\n    // TODO: support planar pixel formats, concious of pixel subsampling.\n    return wuffs_base__make_status(wuffs_base__error__unsupported_option);\n  }\n  uint32_t bits_per_pixel =\n      wuffs_base__pixel_format__bits_per_pixel(&pixcfg->private_impl.pixfmt);\n  if ((bits_per_pixel == 0) || ((bits_per_pixel % 8) != 0)) {\n    // TODO: support fraction-of-byte pixels, e.g. 1 bit per pixel?\n    return wuffs_base__make_status(wuffs_base__error__unsupported_option);\n  }\n  uint64_t bytes_per_pixel = bits_per_pixel / 8;\n\n  uint8_t* ptr = pixbuf_memory.ptr;\n  uint64_t len = pixbuf_memory.len;\n  if (wuffs_base__pixel_format__is_indexed(&pixcfg->private_impl.pixfmt)) {\n    // Split a WU" +
-	"FFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH byte\n    // chunk (1024 bytes = 256 palette entries × 4 bytes per entry) from the\n    // start of pixbuf_memory. We split from the start, not the end, so that\n    // the both chunks' pointers have the same alignment as the original\n    // pointer, up to an alignment of 1024.\n    if (len < WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n      return wuffs_base__make_status(\n          wuffs_base__error__bad_argument_length_too_short);\n    }\n    wuffs_base__table_u8* tab =\n        &pb->private_impl\n             .planes[WUFFS_BASE__PIXEL_FORMAT__INDEXED__COLOR_PLANE];\n    tab->ptr = ptr;\n    tab->width = WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH;\n    tab->height = 1;\n    tab->stride = WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH;\n    ptr += WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH;\n    len -= WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH;\n  }\n\n  uint64_t wh = ((uint64_t)pixcfg->private_impl.width) *\n     " +
-	"           ((uint64_t)pixcfg->private_impl.height);\n  size_t width = (size_t)(pixcfg->private_impl.width);\n  if ((wh > (UINT64_MAX / bytes_per_pixel)) ||\n      (width > (SIZE_MAX / bytes_per_pixel))) {\n    return wuffs_base__make_status(wuffs_base__error__bad_argument);\n  }\n  wh *= bytes_per_pixel;\n  width = ((size_t)(width * bytes_per_pixel));\n  if (wh > len) {\n    return wuffs_base__make_status(\n        wuffs_base__error__bad_argument_length_too_short);\n  }\n\n  pb->pixcfg = *pixcfg;\n  wuffs_base__table_u8* tab = &pb->private_impl.planes[0];\n  tab->ptr = ptr;\n  tab->width = width;\n  tab->height = pixcfg->private_impl.height;\n  tab->stride = width;\n  return wuffs_base__make_status(NULL);\n}\n\n// Deprecated: does not handle indexed pixel configurations. Use\n// wuffs_base__pixel_buffer__set_interleaved instead.\nstatic inline wuffs_base__status  //\nwuffs_base__pixel_buffer__set_from_table(wuffs_base__pixel_buffer* pb,\n                                         const wuffs_base__pixel_config* pixcfg,\n                 " +
-	"                        wuffs_base__table_u8 primary_memory) {\n  if (!pb) {\n    return wuffs_base__make_status(wuffs_base__error__bad_receiver);\n  }\n  memset(pb, 0, sizeof(*pb));\n  if (!pixcfg ||\n      wuffs_base__pixel_format__is_indexed(&pixcfg->private_impl.pixfmt) ||\n      wuffs_base__pixel_format__is_planar(&pixcfg->private_impl.pixfmt)) {\n    return wuffs_base__make_status(wuffs_base__error__bad_argument);\n  }\n  uint32_t bits_per_pixel =\n      wuffs_base__pixel_format__bits_per_pixel(&pixcfg->private_impl.pixfmt);\n  if ((bits_per_pixel == 0) || ((bits_per_pixel % 8) != 0)) {\n    // TODO: support fraction-of-byte pixels, e.g. 1 bit per pixel?\n    return wuffs_base__make_status(wuffs_base__error__unsupported_option);\n  }\n  uint64_t bytes_per_pixel = bits_per_pixel / 8;\n\n  uint64_t width_in_bytes =\n      ((uint64_t)pixcfg->private_impl.width) * bytes_per_pixel;\n  if ((width_in_bytes > primary_memory.width) ||\n      (pixcfg->private_impl.height > primary_memory.height)) {\n    return wuffs_base__make_status(" +
-	"wuffs_base__error__bad_argument);\n  }\n\n  pb->pixcfg = *pixcfg;\n  pb->private_impl.planes[0] = primary_memory;\n  return wuffs_base__make_status(NULL);\n}\n\n// wuffs_base__pixel_buffer__palette returns the palette color data. If\n// non-empty, it will have length\n// WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH.\nstatic inline wuffs_base__slice_u8  //\nwuffs_base__pixel_buffer__palette(wuffs_base__pixel_buffer* pb) {\n  if (pb &&\n      wuffs_base__pixel_format__is_indexed(&pb->pixcfg.private_impl.pixfmt)) {\n    wuffs_base__table_u8* tab =\n        &pb->private_impl\n             .planes[WUFFS_BASE__PIXEL_FORMAT__INDEXED__COLOR_PLANE];\n    if ((tab->width ==\n         WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) &&\n        (tab->height == 1)) {\n      return wuffs_base__make_slice_u8(\n          tab->ptr, WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH);\n    }\n  }\n  return wuffs_base__make_slice_u8(NULL, 0);\n}\n\nstatic inline wuffs_base__slice_u8  //\nwuffs_base__pixel_buffer__palette_or_else(wuffs" +
-	"_base__pixel_buffer* pb,\n                                          wuffs_base__slice_u8 fallback) {\n  if (pb &&\n      wuffs_base__pixel_format__is_indexed(&pb->pixcfg.private_impl.pixfmt)) {\n    wuffs_base__table_u8* tab =\n        &pb->private_impl\n             .planes[WUFFS_BASE__PIXEL_FORMAT__INDEXED__COLOR_PLANE];\n    if ((tab->width ==\n         WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) &&\n        (tab->height == 1)) {\n      return wuffs_base__make_slice_u8(\n          tab->ptr, WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH);\n    }\n  }\n  return fallback;\n}\n\nstatic inline wuffs_base__pixel_format  //\nwuffs_base__pixel_buffer__pixel_format(const wuffs_base__pixel_buffer* pb) {\n  if (pb) {\n    return pb->pixcfg.private_impl.pixfmt;\n  }\n  return wuffs_base__make_pixel_format(WUFFS_BASE__PIXEL_FORMAT__INVALID);\n}\n\nstatic inline wuffs_base__table_u8  //\nwuffs_base__pixel_buffer__plane(wuffs_base__pixel_buffer* pb, uint32_t p) {\n  if (pb && (p < WUFFS_BASE__PIXEL_FORMAT__NUM_PLANES_MAX)) {\n " +
-	"   return pb->private_impl.planes[p];\n  }\n\n  wuffs_base__table_u8 ret;\n  ret.ptr = NULL;\n  ret.width = 0;\n  ret.height = 0;\n  ret.stride = 0;\n  return ret;\n}\n\nWUFFS_BASE__MAYBE_STATIC wuffs_base__color_u32_argb_premul  //\nwuffs_base__pixel_buffer__color_u32_at(const wuffs_base__pixel_buffer* pb,\n                                       uint32_t x,\n                                       uint32_t y);\n\nWUFFS_BASE__MAYBE_STATIC wuffs_base__status  //\nwuffs_base__pixel_buffer__set_color_u32_at(\n    wuffs_base__pixel_buffer* pb,\n    uint32_t x,\n    uint32_t y,\n    wuffs_base__color_u32_argb_premul color);\n\nWUFFS_BASE__MAYBE_STATIC wuffs_base__status  //\nwuffs_base__pixel_buffer__set_color_u32_fill_rect(\n    wuffs_base__pixel_buffer* pb,\n    wuffs_base__rect_ie_u32 rect,\n    wuffs_base__color_u32_argb_premul color);\n\n#ifdef __cplusplus\n\ninline wuffs_base__status  //\nwuffs_base__pixel_buffer::set_interleaved(\n    const wuffs_base__pixel_config* pixcfg_arg,\n    wuffs_base__table_u8 primary_memory,\n    wuffs_base__slice_" +
-	"u8 palette_memory) {\n  return wuffs_base__pixel_buffer__set_interleaved(\n      this, pixcfg_arg, primary_memory, palette_memory);\n}\n\ninline wuffs_base__status  //\nwuffs_base__pixel_buffer::set_from_slice(\n    const wuffs_base__pixel_config* pixcfg_arg,\n    wuffs_base__slice_u8 pixbuf_memory) {\n  return wuffs_base__pixel_buffer__set_from_slice(this, pixcfg_arg,\n                                                  pixbuf_memory);\n}\n\ninline wuffs_base__status  //\nwuffs_base__pixel_buffer::set_from_table(\n    const wuffs_base__pixel_config* pixcfg_arg,\n    wuffs_base__table_u8 primary_memory) {\n  return wuffs_base__pixel_buffer__set_from_table(this, pixcfg_arg,\n                                                  primary_memory);\n}\n\ninline wuffs_base__slice_u8  //\nwuffs_base__pixel_buffer::palette() {\n  return wuffs_base__pixel_buffer__palette(this);\n}\n\ninline wuffs_base__slice_u8  //\nwuffs_base__pixel_buffer::palette_or_else(wuffs_base__slice_u8 fallback) {\n  return wuffs_base__pixel_buffer__palette_or_else(this, fall" +
-	"back);\n}\n\ninline wuffs_base__pixel_format  //\nwuffs_base__pixel_buffer::pixel_format() const {\n  return wuffs_base__pixel_buffer__pixel_format(this);\n}\n\ninline wuffs_base__table_u8  //\nwuffs_base__pixel_buffer::plane(uint32_t p) {\n  return wuffs_base__pixel_buffer__plane(this, p);\n}\n\ninline wuffs_base__color_u32_argb_premul  //\nwuffs_base__pixel_buffer::color_u32_at(uint32_t x, uint32_t y) const {\n  return wuffs_base__pixel_buffer__color_u32_at(this, x, y);\n}\n\nWUFFS_BASE__MAYBE_STATIC wuffs_base__status  //\nwuffs_base__pixel_buffer__set_color_u32_fill_rect(\n    wuffs_base__pixel_buffer* pb,\n    wuffs_base__rect_ie_u32 rect,\n    wuffs_base__color_u32_argb_premul color);\n\ninline wuffs_base__status  //\nwuffs_base__pixel_buffer::set_color_u32_at(\n    uint32_t x,\n    uint32_t y,\n    wuffs_base__color_u32_argb_premul color) {\n  return wuffs_base__pixel_buffer__set_color_u32_at(this, x, y, color);\n}\n\ninline wuffs_base__status  //\nwuffs_base__pixel_buffer::set_color_u32_fill_rect(\n    wuffs_base__rect_ie_u32 rect,\n  " +
-	"  wuffs_base__color_u32_argb_premul color) {\n  return wuffs_base__pixel_buffer__set_color_u32_fill_rect(this, rect, color);\n}\n\n#endif  // __cplusplus\n\n" +
-	"" +
-	"// --------\n\ntypedef struct wuffs_base__decode_frame_options__struct {\n  // Do not access the private_impl's fields directly. There is no API/ABI\n  // compatibility or safety guarantee if you do so.\n  struct {\n    uint8_t TODO;\n  } private_impl;\n\n#ifdef __cplusplus\n#endif  // __cplusplus\n\n} wuffs_base__decode_frame_options;\n\n#ifdef __cplusplus\n\n#endif  // __cplusplus\n\n" +
+	"_u8 plane(uint32_t p);\n  inline wuffs_base__color_u32_argb_premul color_u32_at(uint32_t x,\n                                                        uint32_t y) const;\n  inline wuffs_base__status set_color_u32_at(\n      uint32_t x,\n      uint32_t y,\n      wuffs_base__color_u32_argb_premul color);\n  inline wuffs_base__status set_color_u32_fill_rect(\n      wuffs_base__rect_ie_u32 rect,\n      wuffs_base__color_u32_argb_premul color);\n  inline wuffs_base__status composite(\n      const struct wuffs_base__pixel_buffer__struct* src,\n      uint32_t dst_x,\n      uint32_t dst_y,\n      wuffs_base__rect_ie_u32 clip,\n      wuffs_base__pixel_blend blend);\n#endif  // __cplusplus\n\n} wuffs_base__pixel_buffer;\n\nstatic inline wuffs_base__pixel_buffer  //\nwuffs_base__null_pixel_buffer() {\n  wuffs_base__pixel_buffer ret;\n  ret.pixcfg = wuffs_base__null_pixel_config();\n  ret.private_impl.planes[0] = wuffs_base__empty_table_u8();\n  ret.private_impl.planes[1] = wuffs_base__empty_table_u8();\n  ret.private_impl.planes[2] = wuffs_base__e" +
+	"mpty_table_u8();\n  ret.private_impl.planes[3] = wuffs_base__empty_table_u8();\n  return ret;\n}\n\nstatic inline wuffs_base__status  //\nwuffs_base__pixel_buffer__set_interleaved(\n    wuffs_base__pixel_buffer* pb,\n    const wuffs_base__pixel_config* pixcfg,\n    wuffs_base__table_u8 primary_memory,\n    wuffs_base__slice_u8 palette_memory) {\n  if (!pb) {\n    return wuffs_base__make_status(wuffs_base__error__bad_receiver);\n  }\n  memset(pb, 0, sizeof(*pb));\n  if (!pixcfg ||\n      wuffs_base__pixel_format__is_planar(&pixcfg->private_impl.pixfmt)) {\n    return wuffs_base__make_status(wuffs_base__error__bad_argument);\n  }\n  if (wuffs_base__pixel_format__is_indexed(&pixcfg->private_impl.pixfmt) &&\n      (palette_memory.len <\n       WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH)) {\n    return wuffs_base__make_status(\n        wuffs_base__error__bad_argument_length_too_short);\n  }\n  uint32_t bits_per_pixel =\n      wuffs_base__pixel_format__bits_per_pixel(&pixcfg->private_impl.pixfmt);\n  if ((bits_per_pixel == 0) || " +
+	"((bits_per_pixel % 8) != 0)) {\n    // TODO: support fraction-of-byte pixels, e.g. 1 bit per pixel?\n    return wuffs_base__make_status(wuffs_base__error__unsupported_option);\n  }\n  uint64_t bytes_per_pixel = bits_per_pixel / 8;\n\n  uint64_t width_in_bytes =\n      ((uint64_t)pixcfg->private_impl.width) * bytes_per_pixel;\n  if ((width_in_bytes > primary_memory.width) ||\n      (pixcfg->private_impl.height > primary_memory.height)) {\n    return wuffs_base__make_status(wuffs_base__error__bad_argument);\n  }\n\n  pb->pixcfg = *pixcfg;\n  pb->private_impl.planes[0] = primary_memory;\n  if (wuffs_base__pixel_format__is_indexed(&pixcfg->private_impl.pixfmt)) {\n    wuffs_base__table_u8* tab =\n        &pb->private_impl\n             .planes[WUFFS_BASE__PIXEL_FORMAT__INDEXED__COLOR_PLANE];\n    tab->ptr = palette_memory.ptr;\n    tab->width = WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH;\n    tab->height = 1;\n    tab->stride = WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH;\n  }\n  return wuffs_base__make_status(NUL" +
+	"L);\n}\n\nstatic inline wuffs_base__status  //\nwuffs_base__pixel_buffer__set_from_slice(wuffs_base__pixel_buffer* pb,\n                                         const wuffs_base__pixel_config* pixcfg,\n                                         wuffs_base__slice_u8 pixbuf_memory) {\n  if (!pb) {\n    return wuffs_base__make_status(wuffs_base__error__bad_receiver);\n  }\n  memset(pb, 0, sizeof(*pb));\n  if (!pixcfg) {\n    return wuffs_base__make_status(wuffs_base__error__bad_argument);\n  }\n  if (wuffs_base__pixel_format__is_planar(&pixcfg->private_impl.pixfmt)) {\n    // TODO: support planar pixel formats, concious of pixel subsampling.\n    return wuffs_base__make_status(wuffs_base__error__unsupported_option);\n  }\n  uint32_t bits_per_pixel =\n      wuffs_base__pixel_format__bits_per_pixel(&pixcfg->private_impl.pixfmt);\n  if ((bits_per_pixel == 0) || ((bits_per_pixel % 8) != 0)) {\n    // TODO: support fraction-of-byte pixels, e.g. 1 bit per pixel?\n    return wuffs_base__make_status(wuffs_base__error__unsupported_option);\n  }\n" +
+	"  uint64_t bytes_per_pixel = bits_per_pixel / 8;\n\n  uint8_t* ptr = pixbuf_memory.ptr;\n  uint64_t len = pixbuf_memory.len;\n  if (wuffs_base__pixel_format__is_indexed(&pixcfg->private_impl.pixfmt)) {\n    // Split a WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH byte\n    // chunk (1024 bytes = 256 palette entries × 4 bytes per entry) from the\n    // start of pixbuf_memory. We split from the start, not the end, so that\n    // the both chunks' pointers have the same alignment as the original\n    // pointer, up to an alignment of 1024.\n    if (len < WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n      return wuffs_base__make_status(\n          wuffs_base__error__bad_argument_length_too_short);\n    }\n    wuffs_base__table_u8* tab =\n        &pb->private_impl\n             .planes[WUFFS_BASE__PIXEL_FORMAT__INDEXED__COLOR_PLANE];\n    tab->ptr = ptr;\n    tab->width = WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH;\n    tab->height = 1;\n    tab->stride = WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE" +
+	"_BYTE_LENGTH;\n    ptr += WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH;\n    len -= WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH;\n  }\n\n  uint64_t wh = ((uint64_t)pixcfg->private_impl.width) *\n                ((uint64_t)pixcfg->private_impl.height);\n  size_t width = (size_t)(pixcfg->private_impl.width);\n  if ((wh > (UINT64_MAX / bytes_per_pixel)) ||\n      (width > (SIZE_MAX / bytes_per_pixel))) {\n    return wuffs_base__make_status(wuffs_base__error__bad_argument);\n  }\n  wh *= bytes_per_pixel;\n  width = ((size_t)(width * bytes_per_pixel));\n  if (wh > len) {\n    return wuffs_base__make_status(\n        wuffs_base__error__bad_argument_length_too_short);\n  }\n\n  pb->pixcfg = *pixcfg;\n  wuffs_base__table_u8* tab = &pb->private_impl.planes[0];\n  tab->ptr = ptr;\n  tab->width = width;\n  tab->height = pixcfg->private_impl.height;\n  tab->stride = width;\n  return wuffs_base__make_status(NULL);\n}\n\n// Deprecated: does not handle indexed pixel configurations. Use\n// wuffs_base__pixel_buffer__set_interleaved " +
+	"instead.\nstatic inline wuffs_base__status  //\nwuffs_base__pixel_buffer__set_from_table(wuffs_base__pixel_buffer* pb,\n                                         const wuffs_base__pixel_config* pixcfg,\n                                         wuffs_base__table_u8 primary_memory) {\n  if (!pb) {\n    return wuffs_base__make_status(wuffs_base__error__bad_receiver);\n  }\n  memset(pb, 0, sizeof(*pb));\n  if (!pixcfg ||\n      wuffs_base__pixel_format__is_indexed(&pixcfg->private_impl.pixfmt) ||\n      wuffs_base__pixel_format__is_planar(&pixcfg->private_impl.pixfmt)) {\n    return wuffs_base__make_status(wuffs_base__error__bad_argument);\n  }\n  uint32_t bits_per_pixel =\n      wuffs_base__pixel_format__bits_per_pixel(&pixcfg->private_impl.pixfmt);\n  if ((bits_per_pixel == 0) || ((bits_per_pixel % 8) != 0)) {\n    // TODO: support fraction-of-byte pixels, e.g. 1 bit per pixel?\n    return wuffs_base__make_status(wuffs_base__error__unsupported_option);\n  }\n  uint64_t bytes_per_pixel = bits_per_pixel / 8;\n\n  uint64_t width_in_byte" +
+	"s =\n      ((uint64_t)pixcfg->private_impl.width) * bytes_per_pixel;\n  if ((width_in_bytes > primary_memory.width) ||\n      (pixcfg->private_impl.height > primary_memory.height)) {\n    return wuffs_base__make_status(wuffs_base__error__bad_argument);\n  }\n\n  pb->pixcfg = *pixcfg;\n  pb->private_impl.planes[0] = primary_memory;\n  return wuffs_base__make_status(NULL);\n}\n\n// wuffs_base__pixel_buffer__palette returns the palette color data. If\n// non-empty, it will have length\n// WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH.\nstatic inline wuffs_base__slice_u8  //\nwuffs_base__pixel_buffer__palette(wuffs_base__pixel_buffer* pb) {\n  if (pb &&\n      wuffs_base__pixel_format__is_indexed(&pb->pixcfg.private_impl.pixfmt)) {\n    wuffs_base__table_u8* tab =\n        &pb->private_impl\n             .planes[WUFFS_BASE__PIXEL_FORMAT__INDEXED__COLOR_PLANE];\n    if ((tab->width ==\n         WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) &&\n        (tab->height == 1)) {\n      return wuffs_base__make_slice_u8(\n      " +
+	"    tab->ptr, WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH);\n    }\n  }\n  return wuffs_base__make_slice_u8(NULL, 0);\n}\n\nstatic inline wuffs_base__slice_u8  //\nwuffs_base__pixel_buffer__palette_or_else(wuffs_base__pixel_buffer* pb,\n                                          wuffs_base__slice_u8 fallback) {\n  if (pb &&\n      wuffs_base__pixel_format__is_indexed(&pb->pixcfg.private_impl.pixfmt)) {\n    wuffs_base__table_u8* tab =\n        &pb->private_impl\n             .planes[WUFFS_BASE__PIXEL_FORMAT__INDEXED__COLOR_PLANE];\n    if ((tab->width ==\n         WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) &&\n        (tab->height == 1)) {\n      return wuffs_base__make_slice_u8(\n          tab->ptr, WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH);\n    }\n  }\n  return fallback;\n}\n\nstatic inline wuffs_base__pixel_format  //\nwuffs_base__pixel_buffer__pixel_format(const wuffs_base__pixel_buffer* pb) {\n  if (pb) {\n    return pb->pixcfg.private_impl.pixfmt;\n  }\n  return wuffs_base__make_pixel_format(WU" +
+	"FFS_BASE__PIXEL_FORMAT__INVALID);\n}\n\nstatic inline wuffs_base__table_u8  //\nwuffs_base__pixel_buffer__plane(wuffs_base__pixel_buffer* pb, uint32_t p) {\n  if (pb && (p < WUFFS_BASE__PIXEL_FORMAT__NUM_PLANES_MAX)) {\n    return pb->private_impl.planes[p];\n  }\n\n  wuffs_base__table_u8 ret;\n  ret.ptr = NULL;\n  ret.width = 0;\n  ret.height = 0;\n  ret.stride = 0;\n  return ret;\n}\n\nWUFFS_BASE__MAYBE_STATIC wuffs_base__color_u32_argb_premul  //\nwuffs_base__pixel_buffer__color_u32_at(const wuffs_base__pixel_buffer* pb,\n                                       uint32_t x,\n                                       uint32_t y);\n\nWUFFS_BASE__MAYBE_STATIC wuffs_base__status  //\nwuffs_base__pixel_buffer__set_color_u32_at(\n    wuffs_base__pixel_buffer* pb,\n    uint32_t x,\n    uint32_t y,\n    wuffs_base__color_u32_argb_premul color);\n\nWUFFS_BASE__MAYBE_STATIC wuffs_base__status  //\nwuffs_base__pixel_buffer__set_color_u32_fill_rect(\n    wuffs_base__pixel_buffer* pb,\n    wuffs_base__rect_ie_u32 rect,\n    wuffs_base__color_u32_argb_premu" +
+	"l color);\n\n// wuffs_base__pixel_buffer__composite draws src onto pb, converting pixel\n// formats as necessary, with src's top-left pixel at (dst_x, dst_y). Only\n// those pb pixels inside both clip and pb's bounds are modified, so that a\n// src that extends past pb's edges is not an error. The two pixel buffers'\n// memory must not overlap.\n//\n// The blend is typically WUFFS_BASE__PIXEL_BLEND__SRC, for replacing pixels\n// (as GIF frame disposal does), or WUFFS_BASE__PIXEL_BLEND__SRC_OVER, for\n// compositing a partially transparent frame over the previous one.\n//\n// For modular builds that divide the base module into sub-modules, using this\n// function requires the WUFFS_CONFIG__MODULE__BASE__PIXCONV sub-module, not\n// just WUFFS_CONFIG__MODULE__BASE__CORE.\nWUFFS_BASE__MAYBE_STATIC wuffs_base__status  //\nwuffs_base__pixel_buffer__composite(wuffs_base__pixel_buffer* pb,\n                                    const wuffs_base__pixel_buffer* src,\n                                    uint32_t dst_x,\n                    " +
+	"                uint32_t dst_y,\n                                    wuffs_base__rect_ie_u32 clip,\n                                    wuffs_base__pixel_blend blend);\n\n#ifdef __cplusplus\n\ninline wuffs_base__status  //\nwuffs_base__pixel_buffer::set_interleaved(\n    const wuffs_base__pixel_config* pixcfg_arg,\n    wuffs_base__table_u8 primary_memory,\n    wuffs_base__slice_u8 palette_memory) {\n  return wuffs_base__pixel_buffer__set_interleaved(\n      this, pixcfg_arg, primary_memory, palette_memory);\n}\n\ninline wuffs_base__status  //\nwuffs_base__pixel_buffer::set_from_slice(\n    const wuffs_base__pixel_config* pixcfg_arg,\n    wuffs_base__slice_u8 pixbuf_memory) {\n  return wuffs_base__pixel_buffer__set_from_slice(this, pixcfg_arg,\n                                                  pixbuf_memory);\n}\n\ninline wuffs_base__status  //\nwuffs_base__pixel_buffer::set_from_table(\n    const wuffs_base__pixel_config* pixcfg_arg,\n    wuffs_base__table_u8 primary_memory) {\n  return wuffs_base__pixel_buffer__set_from_table(this, pi" +
+	"xcfg_arg,\n                                                  primary_memory);\n}\n\ninline wuffs_base__slice_u8  //\nwuffs_base__pixel_buffer::palette() {\n  return wuffs_base__pixel_buffer__palette(this);\n}\n\ninline wuffs_base__slice_u8  //\nwuffs_base__pixel_buffer::palette_or_else(wuffs_base__slice_u8 fallback) {\n  return wuffs_base__pixel_buffer__palette_or_else(this, fallback);\n}\n\ninline wuffs_base__pixel_format  //\nwuffs_base__pixel_buffer::pixel_format() const {\n  return wuffs_base__pixel_buffer__pixel_format(this);\n}\n\ninline wuffs_base__table_u8  //\nwuffs_base__pixel_buffer::plane(uint32_t p) {\n  return wuffs_base__pixel_buffer__plane(this, p);\n}\n\ninline wuffs_base__color_u32_argb_premul  //\nwuffs_base__pixel_buffer::color_u32_at(uint32_t x, uint32_t y) const {\n  return wuffs_base__pixel_buffer__color_u32_at(this, x, y);\n}\n\nWUFFS_BASE__MAYBE_STATIC wuffs_base__status  //\nwuffs_base__pixel_buffer__set_color_u32_fill_rect(\n    wuffs_base__pixel_buffer* pb,\n    wuffs_base__rect_ie_u32 rect,\n    wuffs_base__color" +
+	"_u32_argb_premul color);\n\ninline wuffs_base__status  //\nwuffs_base__pixel_buffer::set_color_u32_at(\n    uint32_t x,\n    uint32_t y,\n    wuffs_base__color_u32_argb_premul color) {\n  return wuffs_base__pixel_buffer__set_color_u32_at(this, x, y, color);\n}\n\ninline wuffs_base__status  //\nwuffs_base__pixel_buffer::set_color_u32_fill_rect(\n    wuffs_base__rect_ie_u32 rect,\n    wuffs_base__color_u32_argb_premul color) {\n  return wuffs_base__pixel_buffer__set_color_u32_fill_rect(this, rect, color);\n}\n\ninline wuffs_base__status  //\nwuffs_base__pixel_buffer::composite(const wuffs_base__pixel_buffer* src,\n                                    uint32_t dst_x,\n                                    uint32_t dst_y,\n                                    wuffs_base__rect_ie_u32 clip,\n                                    wuffs_base__pixel_blend blend) {\n  return wuffs_base__pixel_buffer__composite(this, src, dst_x, dst_y, clip,\n                                             blend);\n}\n\n#endif  // __cplusplus\n\n" +
+	"" +
+	"// --------\n\ntypedef struct wuffs_base__decode_frame_options__struct {\n  // Do not access the private_impl's fields directly. There is no API/ABI\n  // compatibility or safety guarantee if you do so.\n  struct {\n    bool has_roi;\n    wuffs_base__rect_ie_u32 roi;\n    uint32_t downscale_shift;\n  } private_impl;\n\n#ifdef __cplusplus\n  inline void set_downscale_shift(uint32_t shift);\n  inline uint32_t downscale_shift() const;\n  inline void set_roi(wuffs_base__rect_ie_u32 roi);\n  inline wuffs_base__rect_ie_u32 roi() const;\n  inline uint32_t roi_min_incl_x() const;\n  inline uint32_t roi_min_incl_y() const;\n  inline uint32_t roi_max_excl_x() const;\n  inline uint32_t roi_max_excl_y() const;\n#endif  // __cplusplus\n\n} wuffs_base__decode_frame_options;\n\n// wuffs_base__decode_frame_options__set_downscale_shift asks for the frame to\n// be decoded at a reduced size: 1/2, 1/4 or 1/8 (in each dimension) for a\n// shift of 1, 2 or 3. The destination pixel buffer then only needs to be\n// ((w + (1 << shift) - 1) >> shift) by ((h + " +
+	"(1 << shift) - 1) >> shift)\n// pixels, for a w by h image. Each destination pixel is the average (a box\n// filter, in premultiplied alpha space) of the corresponding (1 << shift) by\n// (1 << shift) block of source pixels, except that for interlaced images,\n// decoders may stop after an early interlacing pass and sample one source\n// pixel per block instead. The frame's dirty rect is also in that reduced\n// coordinate space.\n//\n// Decoders that support this may need a longer work buffer, for the running\n// sums, than their workbuf_len's min_incl. Passing a work buffer of max_incl\n// length is always enough. Decoders that do not support this ignore it, so\n// callers should check for support (e.g. wuffs_aux::DecodeImage does that per\n// image format) before relying on it.\n//\n// A zero-valued wuffs_base__decode_frame_options has a shift of zero: no\n// downscaling. Shifts above 3 are unsupported.\nstatic inline void  //\nwuffs_base__decode_frame_options__set_downscale_shift(\n    wuffs_base__decode_frame_options* o,\n" +
+	"    uint32_t shift) {\n  if (o) {\n    o->private_impl.downscale_shift = shift;\n  }\n}\n\nstatic inline uint32_t  //\nwuffs_base__decode_frame_options__downscale_shift(\n    const wuffs_base__decode_frame_options* o) {\n  return o ? o->private_impl.downscale_shift : 0;\n}\n\n// wuffs_base__decode_frame_options__set_roi sets the region of interest: the\n// part of the frame that the caller wants decoded. A decoder may then skip\n// writing (and possibly stop decoding) pixels outside of that rectangle, and\n// those pixels in the destination pixel buffer are left as they were. The ROI\n// is in the image's coordinate space (the same space as the frame config's\n// bounds). Some decoders, or some images (e.g. interlaced ones), still have to\n// decompress all of the frame's pixel data but can skip the swizzling for\n// pixels outside of the ROI.\n//\n// A zero-valued wuffs_base__decode_frame_options has no ROI, which is\n// equivalent to an unbounded ROI: the whole frame is decoded.\nstatic inline void  //\nwuffs_base__decode_frame_op" +
+	"tions__set_roi(wuffs_base__decode_frame_options* o,\n                                          wuffs_base__rect_ie_u32 roi) {\n  if (o) {\n    o->private_impl.has_roi = true;\n    o->private_impl.roi = roi;\n  }\n}\n\n// wuffs_base__decode_frame_options__roi returns the region of interest, or the\n// maximal (0, 0, 0xFFFFFFFF, 0xFFFFFFFF) rectangle if there is no ROI.\nstatic inline wuffs_base__rect_ie_u32  //\nwuffs_base__decode_frame_options__roi(\n    const wuffs_base__decode_frame_options* o) {\n  if (o && o->private_impl.has_roi) {\n    return o->private_impl.roi;\n  }\n  return wuffs_base__make_rect_ie_u32(0, 0, UINT32_MAX, UINT32_MAX);\n}\n\nstatic inline uint32_t  //\nwuffs_base__decode_frame_options__roi_min_incl_x(\n    const wuffs_base__decode_frame_options* o) {\n  return (o && o->private_impl.has_roi) ? o->private_impl.roi.min_incl_x : 0;\n}\n\nstatic inline uint32_t  //\nwuffs_base__decode_frame_options__roi_min_incl_y(\n    const wuffs_base__decode_frame_options* o) {\n  return (o && o->private_impl.has_roi) ? o->private_" +
+	"impl.roi.min_incl_y : 0;\n}\n\nstatic inline uint32_t  //\nwuffs_base__decode_frame_options__roi_max_excl_x(\n    const wuffs_base__decode_frame_options* o) {\n  return (o && o->private_impl.has_roi) ? o->private_impl.roi.max_excl_x\n                                        : UINT32_MAX;\n}\n\nstatic inline uint32_t  //\nwuffs_base__decode_frame_options__roi_max_excl_y(\n    const wuffs_base__decode_frame_options* o) {\n  return (o && o->private_impl.has_roi) ? o->private_impl.roi.max_excl_y\n                                        : UINT32_MAX;\n}\n\n#ifdef __cplusplus\n\ninline void  //\nwuffs_base__decode_frame_options::set_downscale_shift(uint32_t shift) {\n  wuffs_base__decode_frame_options__set_downscale_shift(this, shift);\n}\n\ninline uint32_t  //\nwuffs_base__decode_frame_options::downscale_shift() const {\n  return wuffs_base__decode_frame_options__downscale_shift(this);\n}\n\ninline void  //\nwuffs_base__decode_frame_options::set_roi(wuffs_base__rect_ie_u32 roi) {\n  wuffs_base__decode_frame_options__set_roi(this, roi);\n}\n\ninline" +
+	" wuffs_base__rect_ie_u32  //\nwuffs_base__decode_frame_options::roi() const {\n  return wuffs_base__decode_frame_options__roi(this);\n}\n\ninline uint32_t  //\nwuffs_base__decode_frame_options::roi_min_incl_x() const {\n  return wuffs_base__decode_frame_options__roi_min_incl_x(this);\n}\n\ninline uint32_t  //\nwuffs_base__decode_frame_options::roi_min_incl_y() const {\n  return wuffs_base__decode_frame_options__roi_min_incl_y(this);\n}\n\ninline uint32_t  //\nwuffs_base__decode_frame_options::roi_max_excl_x() const {\n  return wuffs_base__decode_frame_options__roi_max_excl_x(this);\n}\n\ninline uint32_t  //\nwuffs_base__decode_frame_options::roi_max_excl_y() const {\n  return wuffs_base__decode_frame_options__roi_max_excl_y(this);\n}\n\n#endif  // __cplusplus\n\n" +
 	"" +
 	"// --------\n\n// wuffs_base__pixel_palette__closest_element returns the index of the palette\n// element that minimizes the sum of squared differences of the four ARGB\n// channels, working in premultiplied alpha. Ties favor the smaller index.\n//\n// The palette_slice.len may equal (N*4), for N less than 256, which means that\n// only the first N palette elements are considered. It returns 0 when N is 0.\n//\n// Applying this function on a per-pixel basis will not produce whole-of-image\n// dithering.\nWUFFS_BASE__MAYBE_STATIC uint8_t  //\nwuffs_base__pixel_palette__closest_element(\n    wuffs_base__slice_u8 palette_slice,\n    wuffs_base__pixel_format palette_format,\n    wuffs_base__color_u32_argb_premul c);\n\n" +
 	"" +
 	"// --------\n\n// TODO: should the func type take restrict pointers?\ntypedef uint64_t (*wuffs_base__pixel_swizzler__func)(uint8_t* dst_ptr,\n                                                     size_t dst_len,\n                                                     uint8_t* dst_palette_ptr,\n                                                     size_t dst_palette_len,\n                                                     const uint8_t* src_ptr,\n                                                     size_t src_len);\n\ntypedef uint64_t (*wuffs_base__pixel_swizzler__transparent_black_func)(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    uint64_t num_pixels,\n    uint32_t dst_pixfmt_bytes_per_pixel);\n\ntypedef struct wuffs_base__pixel_swizzler__struct {\n  // Do not access the private_impl's fields directly. There is no API/ABI\n  // compatibility or safety guarantee if you do so.\n  struct {\n    wuffs_base__pixel_swizzler__func func;\n    wuffs_base__pixel_swizzler__transpa" +
-	"rent_black_func transparent_black_func;\n    uint32_t dst_pixfmt_bytes_per_pixel;\n    uint32_t src_pixfmt_bytes_per_pixel;\n  } private_impl;\n\n#ifdef __cplusplus\n  inline wuffs_base__status prepare(wuffs_base__pixel_format dst_pixfmt,\n                                    wuffs_base__slice_u8 dst_palette,\n                                    wuffs_base__pixel_format src_pixfmt,\n                                    wuffs_base__slice_u8 src_palette,\n                                    wuffs_base__pixel_blend blend);\n  inline uint64_t swizzle_interleaved_from_slice(\n      wuffs_base__slice_u8 dst,\n      wuffs_base__slice_u8 dst_palette,\n      wuffs_base__slice_u8 src) const;\n#endif  // __cplusplus\n\n} wuffs_base__pixel_swizzler;\n\n// wuffs_base__pixel_swizzler__prepare readies the pixel swizzler so that its\n// other methods may be called.\n//\n// For modular builds that divide the base module into sub-modules, using this\n// function requires the WUFFS_CONFIG__MODULE__BASE__PIXCONV sub-module, not\n// just WUFFS_CONFIG__MOD" +
-	"ULE__BASE__CORE.\nWUFFS_BASE__MAYBE_STATIC wuffs_base__status  //\nwuffs_base__pixel_swizzler__prepare(wuffs_base__pixel_swizzler* p,\n                                    wuffs_base__pixel_format dst_pixfmt,\n                                    wuffs_base__slice_u8 dst_palette,\n                                    wuffs_base__pixel_format src_pixfmt,\n                                    wuffs_base__slice_u8 src_palette,\n                                    wuffs_base__pixel_blend blend);\n\n// wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice converts pixels\n// from a source format to a destination format.\n//\n// For modular builds that divide the base module into sub-modules, using this\n// function requires the WUFFS_CONFIG__MODULE__BASE__PIXCONV sub-module, not\n// just WUFFS_CONFIG__MODULE__BASE__CORE.\nWUFFS_BASE__MAYBE_STATIC uint64_t  //\nwuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(\n    const wuffs_base__pixel_swizzler* p,\n    wuffs_base__slice_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n  " +
-	"  wuffs_base__slice_u8 src);\n\n#ifdef __cplusplus\n\ninline wuffs_base__status  //\nwuffs_base__pixel_swizzler::prepare(wuffs_base__pixel_format dst_pixfmt,\n                                    wuffs_base__slice_u8 dst_palette,\n                                    wuffs_base__pixel_format src_pixfmt,\n                                    wuffs_base__slice_u8 src_palette,\n                                    wuffs_base__pixel_blend blend) {\n  return wuffs_base__pixel_swizzler__prepare(this, dst_pixfmt, dst_palette,\n                                             src_pixfmt, src_palette, blend);\n}\n\nuint64_t  //\nwuffs_base__pixel_swizzler::swizzle_interleaved_from_slice(\n    wuffs_base__slice_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src) const {\n  return wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(\n      this, dst, dst_palette, src);\n}\n\n#endif  // __cplusplus\n" +
+	"rent_black_func transparent_black_func;\n    uint32_t dst_pixfmt_bytes_per_pixel;\n    uint32_t src_pixfmt_bytes_per_pixel;\n    // downscale_func, if non-NULL, converts from BGRA_PREMUL to the dst pixel\n    // format, and func converts from the src pixel format to BGRA_PREMUL.\n    wuffs_base__pixel_swizzler__func downscale_func;\n  } private_impl;\n\n#ifdef __cplusplus\n  inline wuffs_base__status prepare(wuffs_base__pixel_format dst_pixfmt,\n                                    wuffs_base__slice_u8 dst_palette,\n                                    wuffs_base__pixel_format src_pixfmt,\n                                    wuffs_base__slice_u8 src_palette,\n                                    wuffs_base__pixel_blend blend);\n  inline uint64_t swizzle_interleaved_from_slice(\n      wuffs_base__slice_u8 dst,\n      wuffs_base__slice_u8 dst_palette,\n      wuffs_base__slice_u8 src) const;\n  inline wuffs_base__status prepare_downscaled(\n      wuffs_base__pixel_format dst_pixfmt,\n      wuffs_base__slice_u8 dst_palette,\n      wuffs" +
+	"_base__pixel_format src_pixfmt,\n      wuffs_base__slice_u8 src_palette,\n      wuffs_base__pixel_blend blend);\n  inline uint64_t swizzle_downscaled_from_slice(\n      wuffs_base__table_u8 dst,\n      wuffs_base__slice_u8 dst_palette,\n      wuffs_base__slice_u8 accum,\n      wuffs_base__slice_u8 src,\n      uint32_t shift,\n      uint32_t x,\n      uint32_t y,\n      uint32_t y0,\n      uint32_t y1) const;\n#endif  // __cplusplus\n\n} wuffs_base__pixel_swizzler;\n\n// wuffs_base__pixel_swizzler__prepare readies the pixel swizzler so that its\n// other methods may be called.\n//\n// For modular builds that divide the base module into sub-modules, using this\n// function requires the WUFFS_CONFIG__MODULE__BASE__PIXCONV sub-module, not\n// just WUFFS_CONFIG__MODULE__BASE__CORE.\nWUFFS_BASE__MAYBE_STATIC wuffs_base__status  //\nwuffs_base__pixel_swizzler__prepare(wuffs_base__pixel_swizzler* p,\n                                    wuffs_base__pixel_format dst_pixfmt,\n                                    wuffs_base__slice_u8 dst_palette,\n" +
+	"                                    wuffs_base__pixel_format src_pixfmt,\n                                    wuffs_base__slice_u8 src_palette,\n                                    wuffs_base__pixel_blend blend);\n\n// wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice converts pixels\n// from a source format to a destination format.\n//\n// For modular builds that divide the base module into sub-modules, using this\n// function requires the WUFFS_CONFIG__MODULE__BASE__PIXCONV sub-module, not\n// just WUFFS_CONFIG__MODULE__BASE__CORE.\nWUFFS_BASE__MAYBE_STATIC uint64_t  //\nwuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(\n    const wuffs_base__pixel_swizzler* p,\n    wuffs_base__slice_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src);\n\n// wuffs_base__pixel_swizzler__prepare_downscaled is like\n// wuffs_base__pixel_swizzler__prepare but readies the pixel swizzler for\n// wuffs_base__pixel_swizzler__swizzle_downscaled_from_slice instead of its\n// other methods. The dst_palette is " +
+	"used as scratch space (for the src\n// palette converted to premultiplied alpha) and so must be 1024 bytes long\n// if the src pixel format is indexed, even if the dst pixel format is not.\n//\n// For modular builds that divide the base module into sub-modules, using this\n// function requires the WUFFS_CONFIG__MODULE__BASE__PIXCONV sub-module, not\n// just WUFFS_CONFIG__MODULE__BASE__CORE.\nWUFFS_BASE__MAYBE_STATIC wuffs_base__status  //\nwuffs_base__pixel_swizzler__prepare_downscaled(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__pixel_format src_pixfmt,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend);\n\n// wuffs_base__pixel_swizzler__swizzle_downscaled_from_slice adds one row of\n// source pixels to a running sum and, after the last source row for a\n// destination row, writes that destination row. It returns the number of\n// source pixels consumed: zero if any argument is invalid.\n//\n// The src holds whole pi" +
+	"xels of source row y, from source column x onwards.\n// The dst is the whole (downscaled) destination plane: source pixel (x, y)\n// maps to destination pixel (x >> shift, y >> shift). Each destination pixel\n// is the premultiplied alpha average of its source pixels that are within\n// rows y0 (inclusive) to y1 (exclusive). Passing (y, y+1) for (y0, y1) means\n// that only row y is sampled for its destination row. The shift must be at\n// most 3.\n//\n// Calls for the same destination row have to pass source rows in increasing\n// order, each in a single call and with the same x and src length. The accum\n// slice holds the running sums between those calls and must be at least\n// (8 * ((n >> shift) + 2)) bytes long, for n source pixels.\n//\n// For modular builds that divide the base module into sub-modules, using this\n// function requires the WUFFS_CONFIG__MODULE__BASE__PIXCONV sub-module, not\n// just WUFFS_CONFIG__MODULE__BASE__CORE.\nWUFFS_BASE__MAYBE_STATIC uint64_t  //\nwuffs_base__pixel_swizzler__swizzle_downscaled_" +
+	"from_slice(\n    const wuffs_base__pixel_swizzler* p,\n    wuffs_base__table_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 accum,\n    wuffs_base__slice_u8 src,\n    uint32_t shift,\n    uint32_t x,\n    uint32_t y,\n    uint32_t y0,\n    uint32_t y1);\n\n#ifdef __cplusplus\n\ninline wuffs_base__status  //\nwuffs_base__pixel_swizzler::prepare(wuffs_base__pixel_format dst_pixfmt,\n                                    wuffs_base__slice_u8 dst_palette,\n                                    wuffs_base__pixel_format src_pixfmt,\n                                    wuffs_base__slice_u8 src_palette,\n                                    wuffs_base__pixel_blend blend) {\n  return wuffs_base__pixel_swizzler__prepare(this, dst_pixfmt, dst_palette,\n                                             src_pixfmt, src_palette, blend);\n}\n\nuint64_t  //\nwuffs_base__pixel_swizzler::swizzle_interleaved_from_slice(\n    wuffs_base__slice_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src) const {\n  return wuf" +
+	"fs_base__pixel_swizzler__swizzle_interleaved_from_slice(\n      this, dst, dst_palette, src);\n}\n\ninline wuffs_base__status  //\nwuffs_base__pixel_swizzler::prepare_downscaled(\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__pixel_format src_pixfmt,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  return wuffs_base__pixel_swizzler__prepare_downscaled(\n      this, dst_pixfmt, dst_palette, src_pixfmt, src_palette, blend);\n}\n\ninline uint64_t  //\nwuffs_base__pixel_swizzler::swizzle_downscaled_from_slice(\n    wuffs_base__table_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 accum,\n    wuffs_base__slice_u8 src,\n    uint32_t shift,\n    uint32_t x,\n    uint32_t y,\n    uint32_t y0,\n    uint32_t y1) const {\n  return wuffs_base__pixel_swizzler__swizzle_downscaled_from_slice(\n      this, dst, dst_palette, accum, src, shift, x, y, y0, y1);\n}\n\n#endif  // __cplusplus\n" +
 	""
 
 const BaseIOPrivateH = "" +
@@ -232,8 +244,8 @@ const BaseIOPrivateH = "" +
 	"ance_1_fast\n// copies the previous byte (the one immediately before *ptr_iop_w), copying 8\n// byte chunks at a time. Each chunk contains 8 repetitions of the same byte.\n//\n// In terms of number of bytes copied, length is rounded up to a multiple of 8.\n// As a special case, a zero length rounds up to 8 (even though 0 is already a\n// multiple of 8), since there is always at least one 8 byte chunk copied.\n//\n// In terms of advancing *ptr_iop_w, length is not rounded up.\n//\n// The caller needs to prove that:\n//  - (length + 8) <= (io2_w      - *ptr_iop_w)\n//  - distance     == 1\n//  - distance     <= (*ptr_iop_w - io1_w)\nstatic inline uint32_t  //\nwuffs_base__io_writer__limited_copy_u32_from_history_8_byte_chunks_distance_1_fast(\n    uint8_t** ptr_iop_w,\n    uint8_t* io1_w,\n    uint8_t* io2_w,\n    uint32_t length,\n    uint32_t distance) {\n  uint8_t* p = *ptr_iop_w;\n  uint64_t x = p[-1];\n  x |= x << 8;\n  x |= x << 16;\n  x |= x << 32;\n  uint32_t n = length;\n  while (1) {\n    wuffs_base__poke_u64le__no_bounds_check(" +
 	"p, x);\n    if (n <= 8) {\n      p += n;\n      break;\n    }\n    p += 8;\n    n -= 8;\n  }\n  *ptr_iop_w = p;\n  return length;\n}\n\n// wuffs_base__io_writer__limited_copy_u32_from_history_8_byte_chunks_fast is\n// like the wuffs_base__io_writer__limited_copy_u32_from_history_fast function\n// above, but copies 8 byte chunks at a time.\n//\n// In terms of number of bytes copied, length is rounded up to a multiple of 8.\n// As a special case, a zero length rounds up to 8 (even though 0 is already a\n// multiple of 8), since there is always at least one 8 byte chunk copied.\n//\n// In terms of advancing *ptr_iop_w, length is not rounded up.\n//\n// The caller needs to prove that:\n//  - (length + 8) <= (io2_w      - *ptr_iop_w)\n//  - distance     >= 8\n//  - distance     <= (*ptr_iop_w - io1_w)\nstatic inline uint32_t  //\nwuffs_base__io_writer__limited_copy_u32_from_history_8_byte_chunks_fast(\n    uint8_t** ptr_iop_w,\n    uint8_t* io1_w,\n    uint8_t* io2_w,\n    uint32_t length,\n    uint32_t distance) {\n  uint8_t* p = *ptr_iop_w;\n  u" +
 	"int8_t* q = p - distance;\n  uint32_t n = length;\n  while (1) {\n    memcpy(p, q, 8);\n    if (n <= 8) {\n      p += n;\n      break;\n    }\n    p += 8;\n    q += 8;\n    n -= 8;\n  }\n  *ptr_iop_w = p;\n  return length;\n}\n\nstatic inline uint32_t  //\nwuffs_base__io_writer__limited_copy_u32_from_reader(uint8_t** ptr_iop_w,\n                                                    uint8_t* io2_w,\n                                                    uint32_t length,\n                                                    const uint8_t** ptr_iop_r,\n                                                    const uint8_t* io2_r) {\n  uint8_t* iop_w = *ptr_iop_w;\n  size_t n = length;\n  if (n > ((size_t)(io2_w - iop_w))) {\n    n = (size_t)(io2_w - iop_w);\n  }\n  const uint8_t* iop_r = *ptr_iop_r;\n  if (n > ((size_t)(io2_r - iop_r))) {\n    n = (size_t)(io2_r - iop_r);\n  }\n  if (n > 0) {\n    memmove(iop_w, iop_r, n);\n    *ptr_iop_w += n;\n    *ptr_iop_r += n;\n  }\n  return (uint32_t)(n);\n}\n\nstatic inline uint32_t  //\nwuffs_base__io_writer__limited_co" +
-	"py_u32_from_slice(uint8_t** ptr_iop_w,\n                                                   uint8_t* io2_w,\n                                                   uint32_t length,\n                                                   wuffs_base__slice_u8 src) {\n  uint8_t* iop_w = *ptr_iop_w;\n  size_t n = src.len;\n  if (n > length) {\n    n = length;\n  }\n  if (n > ((size_t)(io2_w - iop_w))) {\n    n = (size_t)(io2_w - iop_w);\n  }\n  if (n > 0) {\n    memmove(iop_w, src.ptr, n);\n    *ptr_iop_w += n;\n  }\n  return (uint32_t)(n);\n}\n\nstatic inline wuffs_base__io_buffer*  //\nwuffs_base__io_writer__set(wuffs_base__io_buffer* b,\n                           uint8_t** ptr_iop_w,\n                           uint8_t** ptr_io0_w,\n                           uint8_t** ptr_io1_w,\n                           uint8_t** ptr_io2_w,\n                           wuffs_base__slice_u8 data) {\n  b->data = data;\n  b->meta.wi = 0;\n  b->meta.ri = 0;\n  b->meta.pos = 0;\n  b->meta.closed = false;\n\n  *ptr_iop_w = data.ptr;\n  *ptr_io0_w = data.ptr;\n  *ptr_io1_" +
-	"w = data.ptr;\n  *ptr_io2_w = data.ptr + data.len;\n\n  return b;\n}\n\n" +
+	"py_u32_from_slice(uint8_t** ptr_iop_w,\n                                                   uint8_t* io2_w,\n                                                   uint32_t length,\n                                                   wuffs_base__slice_u8 src) {\n  uint8_t* iop_w = *ptr_iop_w;\n  size_t n = src.len;\n  if (n > length) {\n    n = length;\n  }\n  if (n > ((size_t)(io2_w - iop_w))) {\n    n = (size_t)(io2_w - iop_w);\n  }\n  if (n > 0) {\n    memmove(iop_w, src.ptr, n);\n    *ptr_iop_w += n;\n  }\n  return (uint32_t)(n);\n}\n\n// wuffs_base__io_writer__limited_write_u64le_fast writes all 8 bytes of x but\n// only advances *ptr_iop_w by length bytes. The other (8 - length) bytes are\n// scratch space, for subsequent writes to overwrite.\n//\n// The caller needs to prove that:\n//  - length <= 8\n//  - 8      <= (io2_w - *ptr_iop_w)\nstatic inline uint32_t  //\nwuffs_base__io_writer__limited_write_u64le_fast(uint8_t** ptr_iop_w,\n                                                uint8_t* io2_w,\n                                       " +
+	"         uint32_t length,\n                                                uint64_t x) {\n  wuffs_base__poke_u64le__no_bounds_check(*ptr_iop_w, x);\n  *ptr_iop_w += length;\n  return length;\n}\n\nstatic inline wuffs_base__io_buffer*  //\nwuffs_base__io_writer__set(wuffs_base__io_buffer* b,\n                           uint8_t** ptr_iop_w,\n                           uint8_t** ptr_io0_w,\n                           uint8_t** ptr_io1_w,\n                           uint8_t** ptr_io2_w,\n                           wuffs_base__slice_u8 data) {\n  b->data = data;\n  b->meta.wi = 0;\n  b->meta.ri = 0;\n  b->meta.pos = 0;\n  b->meta.closed = false;\n\n  *ptr_iop_w = data.ptr;\n  *ptr_io0_w = data.ptr;\n  *ptr_io1_w = data.ptr;\n  *ptr_io2_w = data.ptr + data.len;\n\n  return b;\n}\n\n" +
 	"" +
 	"// ---------------- I/O (Utility)\n\n#define wuffs_base__utility__empty_io_reader wuffs_base__empty_io_reader\n#define wuffs_base__utility__empty_io_writer wuffs_base__empty_io_writer\n" +
 	""
@@ -289,10 +301,11 @@ const BaseRangePublicH = "" +
 	"tains(const wuffs_base__rect_ie_u32* r,\n                                  uint32_t x,\n                                  uint32_t y) {\n  return (r->min_incl_x <= x) && (x < r->max_excl_x) && (r->min_incl_y <= y) &&\n         (y < r->max_excl_y);\n}\n\nstatic inline bool  //\nwuffs_base__rect_ie_u32__contains_rect(const wuffs_base__rect_ie_u32* r,\n                                       wuffs_base__rect_ie_u32 s) {\n  return wuffs_base__rect_ie_u32__equals(\n      &s, wuffs_base__rect_ie_u32__intersect(r, s));\n}\n\nstatic inline uint32_t  //\nwuffs_base__rect_ie_u32__width(const wuffs_base__rect_ie_u32* r) {\n  return wuffs_base__u32__sat_sub(r->max_excl_x, r->min_incl_x);\n}\n\nstatic inline uint32_t  //\nwuffs_base__rect_ie_u32__height(const wuffs_base__rect_ie_u32* r) {\n  return wuffs_base__u32__sat_sub(r->max_excl_y, r->min_incl_y);\n}\n\n#ifdef __cplusplus\n\ninline bool  //\nwuffs_base__rect_ie_u32::is_empty() const {\n  return wuffs_base__rect_ie_u32__is_empty(this);\n}\n\ninline bool  //\nwuffs_base__rect_ie_u32::equals(wuffs_bas" +
 	"e__rect_ie_u32 s) const {\n  return wuffs_base__rect_ie_u32__equals(this, s);\n}\n\ninline wuffs_base__rect_ie_u32  //\nwuffs_base__rect_ie_u32::intersect(wuffs_base__rect_ie_u32 s) const {\n  return wuffs_base__rect_ie_u32__intersect(this, s);\n}\n\ninline wuffs_base__rect_ie_u32  //\nwuffs_base__rect_ie_u32::unite(wuffs_base__rect_ie_u32 s) const {\n  return wuffs_base__rect_ie_u32__unite(this, s);\n}\n\ninline bool  //\nwuffs_base__rect_ie_u32::contains(uint32_t x, uint32_t y) const {\n  return wuffs_base__rect_ie_u32__contains(this, x, y);\n}\n\ninline bool  //\nwuffs_base__rect_ie_u32::contains_rect(wuffs_base__rect_ie_u32 s) const {\n  return wuffs_base__rect_ie_u32__contains_rect(this, s);\n}\n\ninline uint32_t  //\nwuffs_base__rect_ie_u32::width() const {\n  return wuffs_base__rect_ie_u32__width(this);\n}\n\ninline uint32_t  //\nwuffs_base__rect_ie_u32::height() const {\n  return wuffs_base__rect_ie_u32__height(this);\n}\n\n#endif  // __cplusplus\n\n" +
 	"" +
-	"// ---------------- More Information\n\n// wuffs_base__more_information holds additional fields, typically when a Wuffs\n// method returns a [note status](/doc/note/statuses.md).\n//\n// The flavor field follows the base38 namespace\n// convention](/doc/note/base38-and-fourcc.md). The other fields' semantics\n// depends on the flavor.\ntypedef struct wuffs_base__more_information__struct {\n  uint32_t flavor;\n  uint32_t w;\n  uint64_t x;\n  uint64_t y;\n  uint64_t z;\n\n#ifdef __cplusplus\n  inline void set(uint32_t flavor_arg,\n                  uint32_t w_arg,\n                  uint64_t x_arg,\n                  uint64_t y_arg,\n                  uint64_t z_arg);\n  inline uint32_t io_redirect__fourcc() const;\n  inline wuffs_base__range_ie_u64 io_redirect__range() const;\n  inline uint64_t io_seek__position() const;\n  inline uint32_t metadata__fourcc() const;\n  inline wuffs_base__range_ie_u64 metadata__range() const;\n#endif  // __cplusplus\n\n} wuffs_base__more_information;\n\n#define WUFFS_BASE__MORE_INFORMATION__FLAVOR__IO_REDIRE" +
-	"CT 1\n#define WUFFS_BASE__MORE_INFORMATION__FLAVOR__IO_SEEK 2\n#define WUFFS_BASE__MORE_INFORMATION__FLAVOR__METADATA 3\n\nstatic inline wuffs_base__more_information  //\nwuffs_base__empty_more_information() {\n  wuffs_base__more_information ret;\n  ret.flavor = 0;\n  ret.w = 0;\n  ret.x = 0;\n  ret.y = 0;\n  ret.z = 0;\n  return ret;\n}\n\nstatic inline void  //\nwuffs_base__more_information__set(wuffs_base__more_information* m,\n                                  uint32_t flavor,\n                                  uint32_t w,\n                                  uint64_t x,\n                                  uint64_t y,\n                                  uint64_t z) {\n  if (!m) {\n    return;\n  }\n  m->flavor = flavor;\n  m->w = w;\n  m->x = x;\n  m->y = y;\n  m->z = z;\n}\n\nstatic inline uint32_t  //\nwuffs_base__more_information__io_redirect__fourcc(\n    const wuffs_base__more_information* m) {\n  return m->w;\n}\n\nstatic inline wuffs_base__range_ie_u64  //\nwuffs_base__more_information__io_redirect__range(\n    const wuffs_base__more_informa" +
-	"tion* m) {\n  wuffs_base__range_ie_u64 ret;\n  ret.min_incl = m->y;\n  ret.max_excl = m->z;\n  return ret;\n}\n\nstatic inline uint64_t  //\nwuffs_base__more_information__io_seek__position(\n    const wuffs_base__more_information* m) {\n  return m->x;\n}\n\nstatic inline uint32_t  //\nwuffs_base__more_information__metadata__fourcc(\n    const wuffs_base__more_information* m) {\n  return m->w;\n}\n\nstatic inline wuffs_base__range_ie_u64  //\nwuffs_base__more_information__metadata__range(\n    const wuffs_base__more_information* m) {\n  wuffs_base__range_ie_u64 ret;\n  ret.min_incl = m->y;\n  ret.max_excl = m->z;\n  return ret;\n}\n\n#ifdef __cplusplus\n\ninline void  //\nwuffs_base__more_information::set(uint32_t flavor_arg,\n                                  uint32_t w_arg,\n                                  uint64_t x_arg,\n                                  uint64_t y_arg,\n                                  uint64_t z_arg) {\n  wuffs_base__more_information__set(this, flavor_arg, w_arg, x_arg, y_arg,\n                                    z_arg);" +
-	"\n}\n\ninline uint32_t  //\nwuffs_base__more_information::io_redirect__fourcc() const {\n  return wuffs_base__more_information__io_redirect__fourcc(this);\n}\n\ninline wuffs_base__range_ie_u64  //\nwuffs_base__more_information::io_redirect__range() const {\n  return wuffs_base__more_information__io_redirect__range(this);\n}\n\ninline uint64_t  //\nwuffs_base__more_information::io_seek__position() const {\n  return wuffs_base__more_information__io_seek__position(this);\n}\n\ninline uint32_t  //\nwuffs_base__more_information::metadata__fourcc() const {\n  return wuffs_base__more_information__metadata__fourcc(this);\n}\n\ninline wuffs_base__range_ie_u64  //\nwuffs_base__more_information::metadata__range() const {\n  return wuffs_base__more_information__metadata__range(this);\n}\n\n#endif  // __cplusplus\n" +
+	"// ---------------- More Information\n\n// wuffs_base__more_information holds additional fields, typically when a Wuffs\n// method returns a [note status](/doc/note/statuses.md).\n//\n// The flavor field follows the base38 namespace\n// convention](/doc/note/base38-and-fourcc.md). The other fields' semantics\n// depends on the flavor.\n//\n// For the METADATA flavor, w is the metadata's FourCC and [y, z) is the\n// io_position range of its bytes. A non-zero x is the FourCC of an encoding,\n// such as WUFFS_BASE__FOURCC__ZLIB, that the caller has to undo to get the\n// metadata itself. A zero x means that the bytes are the metadata as is.\ntypedef struct wuffs_base__more_information__struct {\n  uint32_t flavor;\n  uint32_t w;\n  uint64_t x;\n  uint64_t y;\n  uint64_t z;\n\n#ifdef __cplusplus\n  inline void set(uint32_t flavor_arg,\n                  uint32_t w_arg,\n                  uint64_t x_arg,\n                  uint64_t y_arg,\n                  uint64_t z_arg);\n  inline uint32_t io_redirect__fourcc() const;\n  inline wuffs_bas" +
+	"e__range_ie_u64 io_redirect__range() const;\n  inline uint64_t io_seek__position() const;\n  inline uint32_t metadata__fourcc() const;\n  inline wuffs_base__range_ie_u64 metadata__range() const;\n#endif  // __cplusplus\n\n} wuffs_base__more_information;\n\n#define WUFFS_BASE__MORE_INFORMATION__FLAVOR__IO_REDIRECT 1\n#define WUFFS_BASE__MORE_INFORMATION__FLAVOR__IO_SEEK 2\n#define WUFFS_BASE__MORE_INFORMATION__FLAVOR__METADATA 3\n\nstatic inline wuffs_base__more_information  //\nwuffs_base__empty_more_information() {\n  wuffs_base__more_information ret;\n  ret.flavor = 0;\n  ret.w = 0;\n  ret.x = 0;\n  ret.y = 0;\n  ret.z = 0;\n  return ret;\n}\n\nstatic inline void  //\nwuffs_base__more_information__set(wuffs_base__more_information* m,\n                                  uint32_t flavor,\n                                  uint32_t w,\n                                  uint64_t x,\n                                  uint64_t y,\n                                  uint64_t z) {\n  if (!m) {\n    return;\n  }\n  m->flavor = flavor;\n  m->w = w;\n  m" +
+	"->x = x;\n  m->y = y;\n  m->z = z;\n}\n\nstatic inline uint32_t  //\nwuffs_base__more_information__io_redirect__fourcc(\n    const wuffs_base__more_information* m) {\n  return m->w;\n}\n\nstatic inline wuffs_base__range_ie_u64  //\nwuffs_base__more_information__io_redirect__range(\n    const wuffs_base__more_information* m) {\n  wuffs_base__range_ie_u64 ret;\n  ret.min_incl = m->y;\n  ret.max_excl = m->z;\n  return ret;\n}\n\nstatic inline uint64_t  //\nwuffs_base__more_information__io_seek__position(\n    const wuffs_base__more_information* m) {\n  return m->x;\n}\n\nstatic inline uint32_t  //\nwuffs_base__more_information__metadata__fourcc(\n    const wuffs_base__more_information* m) {\n  return m->w;\n}\n\nstatic inline wuffs_base__range_ie_u64  //\nwuffs_base__more_information__metadata__range(\n    const wuffs_base__more_information* m) {\n  wuffs_base__range_ie_u64 ret;\n  ret.min_incl = m->y;\n  ret.max_excl = m->z;\n  return ret;\n}\n\n#ifdef __cplusplus\n\ninline void  //\nwuffs_base__more_information::set(uint32_t flavor_arg,\n                " +
+	"                  uint32_t w_arg,\n                                  uint64_t x_arg,\n                                  uint64_t y_arg,\n                                  uint64_t z_arg) {\n  wuffs_base__more_information__set(this, flavor_arg, w_arg, x_arg, y_arg,\n                                    z_arg);\n}\n\ninline uint32_t  //\nwuffs_base__more_information::io_redirect__fourcc() const {\n  return wuffs_base__more_information__io_redirect__fourcc(this);\n}\n\ninline wuffs_base__range_ie_u64  //\nwuffs_base__more_information::io_redirect__range() const {\n  return wuffs_base__more_information__io_redirect__range(this);\n}\n\ninline uint64_t  //\nwuffs_base__more_information::io_seek__position() const {\n  return wuffs_base__more_information__io_seek__position(this);\n}\n\ninline uint32_t  //\nwuffs_base__more_information::metadata__fourcc() const {\n  return wuffs_base__more_information__metadata__fourcc(this);\n}\n\ninline wuffs_base__range_ie_u64  //\nwuffs_base__more_information::metadata__range() const {\n  return wuffs_base__mor" +
+	"e_information__metadata__range(this);\n}\n\n#endif  // __cplusplus\n" +
 	""
 
 const BaseStrConvPrivateH = "" +
@@ -577,11 +590,19 @@ const BasePixConvSubmoduleC = "" +
 	"" +
 	"// --------\n\nstatic inline void  //\nwuffs_base__pixel_buffer__set_color_u32_fill_rect__xx(\n    wuffs_base__pixel_buffer* pb,\n    wuffs_base__rect_ie_u32 rect,\n    uint16_t color) {\n  size_t stride = pb->private_impl.planes[0].stride;\n  uint32_t width = wuffs_base__rect_ie_u32__width(&rect);\n  if ((stride == (2 * ((uint64_t)width))) && (rect.min_incl_x == 0)) {\n    uint8_t* ptr =\n        pb->private_impl.planes[0].ptr + (stride * ((size_t)rect.min_incl_y));\n    uint32_t height = wuffs_base__rect_ie_u32__height(&rect);\n    size_t n;\n    for (n = ((size_t)width) * ((size_t)height); n > 0; n--) {\n      wuffs_base__poke_u16le__no_bounds_check(ptr, color);\n      ptr += 2;\n    }\n    return;\n  }\n\n  uint32_t y;\n  for (y = rect.min_incl_y; y < rect.max_excl_y; y++) {\n    uint8_t* ptr = pb->private_impl.planes[0].ptr + (stride * ((size_t)y)) +\n                   (2 * ((size_t)rect.min_incl_x));\n    uint32_t n;\n    for (n = width; n > 0; n--) {\n      wuffs_base__poke_u16le__no_bounds_check(ptr, color);\n      ptr += 2;\n  " +
 	"  }\n  }\n}\n\nstatic inline void  //\nwuffs_base__pixel_buffer__set_color_u32_fill_rect__xxx(\n    wuffs_base__pixel_buffer* pb,\n    wuffs_base__rect_ie_u32 rect,\n    uint32_t color) {\n  size_t stride = pb->private_impl.planes[0].stride;\n  uint32_t width = wuffs_base__rect_ie_u32__width(&rect);\n  if ((stride == (3 * ((uint64_t)width))) && (rect.min_incl_x == 0)) {\n    uint8_t* ptr =\n        pb->private_impl.planes[0].ptr + (stride * ((size_t)rect.min_incl_y));\n    uint32_t height = wuffs_base__rect_ie_u32__height(&rect);\n    size_t n;\n    for (n = ((size_t)width) * ((size_t)height); n > 0; n--) {\n      wuffs_base__poke_u24le__no_bounds_check(ptr, color);\n      ptr += 3;\n    }\n    return;\n  }\n\n  uint32_t y;\n  for (y = rect.min_incl_y; y < rect.max_excl_y; y++) {\n    uint8_t* ptr = pb->private_impl.planes[0].ptr + (stride * ((size_t)y)) +\n                   (3 * ((size_t)rect.min_incl_x));\n    uint32_t n;\n    for (n = width; n > 0; n--) {\n      wuffs_base__poke_u24le__no_bounds_check(ptr, color);\n      ptr += 3;\n   " +
-	" }\n  }\n}\n\nstatic inline void  //\nwuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxx(\n    wuffs_base__pixel_buffer* pb,\n    wuffs_base__rect_ie_u32 rect,\n    uint32_t color) {\n  size_t stride = pb->private_impl.planes[0].stride;\n  uint32_t width = wuffs_base__rect_ie_u32__width(&rect);\n  if ((stride == (4 * ((uint64_t)width))) && (rect.min_incl_x == 0)) {\n    uint8_t* ptr =\n        pb->private_impl.planes[0].ptr + (stride * ((size_t)rect.min_incl_y));\n    uint32_t height = wuffs_base__rect_ie_u32__height(&rect);\n    size_t n;\n    for (n = ((size_t)width) * ((size_t)height); n > 0; n--) {\n      wuffs_base__poke_u32le__no_bounds_check(ptr, color);\n      ptr += 4;\n    }\n    return;\n  }\n\n  uint32_t y;\n  for (y = rect.min_incl_y; y < rect.max_excl_y; y++) {\n    uint8_t* ptr = pb->private_impl.planes[0].ptr + (stride * ((size_t)y)) +\n                   (4 * ((size_t)rect.min_incl_x));\n    uint32_t n;\n    for (n = width; n > 0; n--) {\n      wuffs_base__poke_u32le__no_bounds_check(ptr, color);\n      ptr += 4;\n   " +
-	" }\n  }\n}\n\nstatic inline void  //\nwuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxxxxxx(\n    wuffs_base__pixel_buffer* pb,\n    wuffs_base__rect_ie_u32 rect,\n    uint64_t color) {\n  size_t stride = pb->private_impl.planes[0].stride;\n  uint32_t width = wuffs_base__rect_ie_u32__width(&rect);\n  if ((stride == (8 * ((uint64_t)width))) && (rect.min_incl_x == 0)) {\n    uint8_t* ptr =\n        pb->private_impl.planes[0].ptr + (stride * ((size_t)rect.min_incl_y));\n    uint32_t height = wuffs_base__rect_ie_u32__height(&rect);\n    size_t n;\n    for (n = ((size_t)width) * ((size_t)height); n > 0; n--) {\n      wuffs_base__poke_u64le__no_bounds_check(ptr, color);\n      ptr += 8;\n    }\n    return;\n  }\n\n  uint32_t y;\n  for (y = rect.min_incl_y; y < rect.max_excl_y; y++) {\n    uint8_t* ptr = pb->private_impl.planes[0].ptr + (stride * ((size_t)y)) +\n                   (8 * ((size_t)rect.min_incl_x));\n    uint32_t n;\n    for (n = width; n > 0; n--) {\n      wuffs_base__poke_u64le__no_bounds_check(ptr, color);\n      ptr += 8;" +
-	"\n    }\n  }\n}\n\nWUFFS_BASE__MAYBE_STATIC wuffs_base__status  //\nwuffs_base__pixel_buffer__set_color_u32_fill_rect(\n    wuffs_base__pixel_buffer* pb,\n    wuffs_base__rect_ie_u32 rect,\n    wuffs_base__color_u32_argb_premul color) {\n  if (!pb) {\n    return wuffs_base__make_status(wuffs_base__error__bad_receiver);\n  } else if (wuffs_base__rect_ie_u32__is_empty(&rect)) {\n    return wuffs_base__make_status(NULL);\n  }\n  wuffs_base__rect_ie_u32 bounds =\n      wuffs_base__pixel_config__bounds(&pb->pixcfg);\n  if (!wuffs_base__rect_ie_u32__contains_rect(&bounds, rect)) {\n    return wuffs_base__make_status(wuffs_base__error__bad_argument);\n  }\n\n  if (wuffs_base__pixel_format__is_planar(&pb->pixcfg.private_impl.pixfmt)) {\n    // TODO: support planar formats.\n    return wuffs_base__make_status(wuffs_base__error__unsupported_option);\n  }\n\n  switch (pb->pixcfg.private_impl.pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n      wuffs_base__pixel_buffer__set_color_u32_fill_r" +
-	"ect__xxxx(pb, rect, color);\n      return wuffs_base__make_status(NULL);\n\n      // Common formats above. Rarer formats below.\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      wuffs_base__pixel_buffer__set_color_u32_fill_rect__xx(\n          pb, rect,\n          wuffs_base__color_u32_argb_premul__as__color_u16_rgb_565(color));\n      return wuffs_base__make_status(NULL);\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxx(pb, rect, color);\n      return wuffs_base__make_status(NULL);\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxx(\n          pb, rect,\n          wuffs_base__color_u32_argb_premul__as__color_u32_argb_nonpremul(\n              color));\n      return wuffs_base__make_status(NULL);\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxxxxxx(\n          pb, rect,\n          wuffs_base__color_u32_argb_premul__as__color_u64_argb_no" +
-	"npremul(\n              color));\n      return wuffs_base__make_status(NULL);\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxx(\n          pb, rect,\n          wuffs_base__color_u32_argb_premul__as__color_u32_argb_nonpremul(\n              wuffs_base__swap_u32_argb_abgr(color)));\n      return wuffs_base__make_status(NULL);\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n      wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxx(\n          pb, rect, wuffs_base__swap_u32_argb_abgr(color));\n      return wuffs_base__make_status(NULL);\n  }\n\n  uint32_t y;\n  for (y = rect.min_incl_y; y < rect.max_excl_y; y++) {\n    uint32_t x;\n    for (x = rect.min_incl_x; x < rect.max_excl_x; x++) {\n      wuffs_base__pixel_buffer__set_color_u32_at(pb, x, y, color);\n    }\n  }\n  return wuffs_base__make_status(NULL);\n}\n\n" +
+	" }\n  }\n}\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_avx2\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2\")\nstatic void  //\nwuffs_base__pixel_buffer__fill_u32le__avx2(uint8_t* ptr,\n                                           size_t n,\n                                           uint32_t color) {\n  __m256i x = _mm256_set1_epi32((int32_t)color);\n  for (; n >= 8; n -= 8) {\n    _mm256_storeu_si256((__m256i*)(void*)ptr, x);\n    ptr += 8 * 4;\n  }\n  for (; n > 0; n--) {\n    wuffs_base__poke_u32le__no_bounds_check(ptr, color);\n    ptr += 4;\n  }\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_avx2\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_sse42\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2\")\nstatic void  //\nwuffs_base__pixel_buffer__fill_u32le__sse42(uint8_t* ptr,\n                                            size_t n,\n                                            uint32_t color) {\n  __m" +
+	"128i x = _mm_set1_epi32((int32_t)color);\n  for (; n >= 4; n -= 4) {\n    _mm_storeu_si128((__m128i*)(void*)ptr, x);\n    ptr += 4 * 4;\n  }\n  for (; n > 0; n--) {\n    wuffs_base__poke_u32le__no_bounds_check(ptr, color);\n    ptr += 4;\n  }\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_sse42\n\nstatic void  //\nwuffs_base__pixel_buffer__fill_u32le(uint8_t* ptr, size_t n, uint32_t color) {\n  for (; n > 0; n--) {\n    wuffs_base__poke_u32le__no_bounds_check(ptr, color);\n    ptr += 4;\n  }\n}\n\nstatic inline void  //\nwuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxx(\n    wuffs_base__pixel_buffer* pb,\n    wuffs_base__rect_ie_u32 rect,\n    uint32_t color) {\n  size_t stride = pb->private_impl.planes[0].stride;\n  uint32_t width = wuffs_base__rect_ie_u32__width(&rect);\n  uint32_t height = wuffs_base__rect_ie_u32__height(&rect);\n\n  void (*fill)(uint8_t*, size_t, uint32_t) =\n      wuffs_base__pixel_buffer__fill_u32le;\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n  // Tiny fills don't pay" +
+	" for the cpuid checks.\n  if ((((uint64_t)width) * ((uint64_t)height)) >= 64) {\n    if (wuffs_base__cpu_arch__have_x86_avx2()) {\n      fill = wuffs_base__pixel_buffer__fill_u32le__avx2;\n    } else if (wuffs_base__cpu_arch__have_x86_sse42()) {\n      fill = wuffs_base__pixel_buffer__fill_u32le__sse42;\n    }\n  }\n#endif\n\n  if ((stride == (4 * ((uint64_t)width))) && (rect.min_incl_x == 0)) {\n    uint8_t* ptr =\n        pb->private_impl.planes[0].ptr + (stride * ((size_t)rect.min_incl_y));\n    (*fill)(ptr, ((size_t)width) * ((size_t)height), color);\n    return;\n  }\n\n  uint32_t y;\n  for (y = rect.min_incl_y; y < rect.max_excl_y; y++) {\n    uint8_t* ptr = pb->private_impl.planes[0].ptr + (stride * ((size_t)y)) +\n                   (4 * ((size_t)rect.min_incl_x));\n    (*fill)(ptr, width, color);\n  }\n}\n\nstatic inline void  //\nwuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxxxxxx(\n    wuffs_base__pixel_buffer* pb,\n    wuffs_base__rect_ie_u32 rect,\n    uint64_t color) {\n  size_t stride = pb->private_impl.planes[0].st" +
+	"ride;\n  uint32_t width = wuffs_base__rect_ie_u32__width(&rect);\n  if ((stride == (8 * ((uint64_t)width))) && (rect.min_incl_x == 0)) {\n    uint8_t* ptr =\n        pb->private_impl.planes[0].ptr + (stride * ((size_t)rect.min_incl_y));\n    uint32_t height = wuffs_base__rect_ie_u32__height(&rect);\n    size_t n;\n    for (n = ((size_t)width) * ((size_t)height); n > 0; n--) {\n      wuffs_base__poke_u64le__no_bounds_check(ptr, color);\n      ptr += 8;\n    }\n    return;\n  }\n\n  uint32_t y;\n  for (y = rect.min_incl_y; y < rect.max_excl_y; y++) {\n    uint8_t* ptr = pb->private_impl.planes[0].ptr + (stride * ((size_t)y)) +\n                   (8 * ((size_t)rect.min_incl_x));\n    uint32_t n;\n    for (n = width; n > 0; n--) {\n      wuffs_base__poke_u64le__no_bounds_check(ptr, color);\n      ptr += 8;\n    }\n  }\n}\n\nWUFFS_BASE__MAYBE_STATIC wuffs_base__status  //\nwuffs_base__pixel_buffer__set_color_u32_fill_rect(\n    wuffs_base__pixel_buffer* pb,\n    wuffs_base__rect_ie_u32 rect,\n    wuffs_base__color_u32_argb_premul color) {\n  i" +
+	"f (!pb) {\n    return wuffs_base__make_status(wuffs_base__error__bad_receiver);\n  } else if (wuffs_base__rect_ie_u32__is_empty(&rect)) {\n    return wuffs_base__make_status(NULL);\n  }\n  wuffs_base__rect_ie_u32 bounds =\n      wuffs_base__pixel_config__bounds(&pb->pixcfg);\n  if (!wuffs_base__rect_ie_u32__contains_rect(&bounds, rect)) {\n    return wuffs_base__make_status(wuffs_base__error__bad_argument);\n  }\n\n  if (wuffs_base__pixel_format__is_planar(&pb->pixcfg.private_impl.pixfmt)) {\n    // TODO: support planar formats.\n    return wuffs_base__make_status(wuffs_base__error__unsupported_option);\n  }\n\n  switch (pb->pixcfg.private_impl.pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n      wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxx(pb, rect, color);\n      return wuffs_base__make_status(NULL);\n\n      // Common formats above. Rarer formats below.\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      wuffs_base__pixel_buffer__set_color_u32_fill_rect__xx(\n" +
+	"          pb, rect,\n          wuffs_base__color_u32_argb_premul__as__color_u16_rgb_565(color));\n      return wuffs_base__make_status(NULL);\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxx(pb, rect, color);\n      return wuffs_base__make_status(NULL);\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxx(\n          pb, rect,\n          wuffs_base__color_u32_argb_premul__as__color_u32_argb_nonpremul(\n              color));\n      return wuffs_base__make_status(NULL);\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxxxxxx(\n          pb, rect,\n          wuffs_base__color_u32_argb_premul__as__color_u64_argb_nonpremul(\n              color));\n      return wuffs_base__make_status(NULL);\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxx(\n          pb, rect,\n          wuffs_base" +
+	"__color_u32_argb_premul__as__color_u32_argb_nonpremul(\n              wuffs_base__swap_u32_argb_abgr(color)));\n      return wuffs_base__make_status(NULL);\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n      wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxx(\n          pb, rect, wuffs_base__swap_u32_argb_abgr(color));\n      return wuffs_base__make_status(NULL);\n  }\n\n  uint32_t y;\n  for (y = rect.min_incl_y; y < rect.max_excl_y; y++) {\n    uint32_t x;\n    for (x = rect.min_incl_x; x < rect.max_excl_x; x++) {\n      wuffs_base__pixel_buffer__set_color_u32_at(pb, x, y, color);\n    }\n  }\n  return wuffs_base__make_status(NULL);\n}\n\n" +
+	"" +
+	"// --------\n\nWUFFS_BASE__MAYBE_STATIC wuffs_base__status  //\nwuffs_base__pixel_buffer__composite(wuffs_base__pixel_buffer* pb,\n                                    const wuffs_base__pixel_buffer* src,\n                                    uint32_t dst_x,\n                                    uint32_t dst_y,\n                                    wuffs_base__rect_ie_u32 clip,\n                                    wuffs_base__pixel_blend blend) {\n  if (!pb) {\n    return wuffs_base__make_status(wuffs_base__error__bad_receiver);\n  } else if (!src) {\n    return wuffs_base__make_status(wuffs_base__error__bad_argument);\n  } else if (\n      wuffs_base__pixel_format__is_planar(&pb->pixcfg.private_impl.pixfmt) ||\n      wuffs_base__pixel_format__is_planar(&src->pixcfg.private_impl.pixfmt)) {\n    // TODO: support planar formats.\n    return wuffs_base__make_status(wuffs_base__error__unsupported_option);\n  }\n\n  uint32_t dst_bits_per_pixel = wuffs_base__pixel_format__bits_per_pixel(\n      &pb->pixcfg.private_impl.pixfmt);\n  uint32_t " +
+	"src_bits_per_pixel = wuffs_base__pixel_format__bits_per_pixel(\n      &src->pixcfg.private_impl.pixfmt);\n  if ((dst_bits_per_pixel == 0) || ((dst_bits_per_pixel % 8) != 0) ||\n      (src_bits_per_pixel == 0) || ((src_bits_per_pixel % 8) != 0)) {\n    // TODO: support fraction-of-byte pixels, e.g. 1 bit per pixel?\n    return wuffs_base__make_status(wuffs_base__error__unsupported_option);\n  }\n  size_t dst_bytes_per_pixel = dst_bits_per_pixel / 8;\n  size_t src_bytes_per_pixel = src_bits_per_pixel / 8;\n\n  // Clip to pb's bounds and to src's bounds, translated by (dst_x, dst_y).\n  // Any src pixels beyond (0xFFFFFFFF, 0xFFFFFFFF) are already outside pb.\n  uint64_t src_max_excl_x =\n      ((uint64_t)dst_x) + ((uint64_t)(src->pixcfg.private_impl.width));\n  uint64_t src_max_excl_y =\n      ((uint64_t)dst_y) + ((uint64_t)(src->pixcfg.private_impl.height));\n  wuffs_base__rect_ie_u32 bounds =\n      wuffs_base__pixel_config__bounds(&pb->pixcfg);\n  wuffs_base__rect_ie_u32 r = wuffs_base__rect_ie_u32__intersect(\n      &bounds, " +
+	"wuffs_base__make_rect_ie_u32(\n                   dst_x, dst_y,\n                   (uint32_t)wuffs_base__u64__min(src_max_excl_x, 0xFFFFFFFF),\n                   (uint32_t)wuffs_base__u64__min(src_max_excl_y, 0xFFFFFFFF)));\n  r = wuffs_base__rect_ie_u32__intersect(&r, clip);\n  if (wuffs_base__rect_ie_u32__is_empty(&r)) {\n    return wuffs_base__make_status(NULL);\n  }\n\n  // For a non-indexed pb, the swizzler still needs somewhere to hold an\n  // indexed src's palette, converted to pb's pixel format.\n  uint8_t scratch[WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH];\n  wuffs_base__slice_u8 dst_palette = wuffs_base__pixel_buffer__palette_or_else(\n      pb, wuffs_base__make_slice_u8(\n              scratch, WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH));\n  wuffs_base__slice_u8 src_palette = wuffs_base__empty_slice_u8();\n  if (wuffs_base__pixel_format__is_indexed(&src->pixcfg.private_impl.pixfmt)) {\n    const wuffs_base__table_u8* tab =\n        &src->private_impl\n             .planes[WUFFS_BASE__PIXE" +
+	"L_FORMAT__INDEXED__COLOR_PLANE];\n    if ((tab->width ==\n         WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) &&\n        (tab->height == 1)) {\n      src_palette = wuffs_base__make_slice_u8(\n          tab->ptr, WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH);\n    }\n  }\n\n  wuffs_base__pixel_swizzler swizzler;\n  wuffs_base__status status = wuffs_base__pixel_swizzler__prepare(\n      &swizzler, pb->pixcfg.private_impl.pixfmt, dst_palette,\n      src->pixcfg.private_impl.pixfmt, src_palette, blend);\n  if (status.repr) {\n    return status;\n  }\n\n  size_t width = (size_t)wuffs_base__rect_ie_u32__width(&r);\n  const wuffs_base__table_u8* dst_tab = &pb->private_impl.planes[0];\n  const wuffs_base__table_u8* src_tab = &src->private_impl.planes[0];\n  uint8_t* d = dst_tab->ptr + (dst_tab->stride * ((size_t)r.min_incl_y)) +\n               (dst_bytes_per_pixel * ((size_t)r.min_incl_x));\n  uint8_t* s = src_tab->ptr +\n               (src_tab->stride * ((size_t)(r.min_incl_y - dst_y))) +\n               (src_byte" +
+	"s_per_pixel * ((size_t)(r.min_incl_x - dst_x)));\n\n  uint32_t y;\n  for (y = r.min_incl_y; y < r.max_excl_y; y++) {\n    wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(\n        &swizzler, wuffs_base__make_slice_u8(d, dst_bytes_per_pixel * width),\n        dst_palette,\n        wuffs_base__make_slice_u8(s, src_bytes_per_pixel * width));\n    d += dst_tab->stride;\n    s += src_tab->stride;\n  }\n  return wuffs_base__make_status(NULL);\n}\n\n" +
 	"" +
 	"// --------\n\nWUFFS_BASE__MAYBE_STATIC uint8_t  //\nwuffs_base__pixel_palette__closest_element(\n    wuffs_base__slice_u8 palette_slice,\n    wuffs_base__pixel_format palette_format,\n    wuffs_base__color_u32_argb_premul c) {\n  size_t n = palette_slice.len / 4;\n  if (n > (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n    n = (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4);\n  }\n  size_t best_index = 0;\n  uint64_t best_score = 0xFFFFFFFFFFFFFFFF;\n\n  // Work in 16-bit color.\n  uint32_t ca = 0x101 * (0xFF & (c >> 24));\n  uint32_t cr = 0x101 * (0xFF & (c >> 16));\n  uint32_t cg = 0x101 * (0xFF & (c >> 8));\n  uint32_t cb = 0x101 * (0xFF & (c >> 0));\n\n  switch (palette_format.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_BINARY: {\n      bool nonpremul = palette_format.repr ==\n                       WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_NONPREMUL;\n\n      size_t i;\n" +
 	"      for (i = 0; i < n; i++) {\n        // Work in 16-bit color.\n        uint32_t pb = 0x101 * ((uint32_t)(palette_slice.ptr[(4 * i) + 0]));\n        uint32_t pg = 0x101 * ((uint32_t)(palette_slice.ptr[(4 * i) + 1]));\n        uint32_t pr = 0x101 * ((uint32_t)(palette_slice.ptr[(4 * i) + 2]));\n        uint32_t pa = 0x101 * ((uint32_t)(palette_slice.ptr[(4 * i) + 3]));\n\n        // Convert to premultiplied alpha.\n        if (nonpremul && (pa != 0xFFFF)) {\n          pb = (pb * pa) / 0xFFFF;\n          pg = (pg * pa) / 0xFFFF;\n          pr = (pr * pa) / 0xFFFF;\n        }\n\n        // These deltas are conceptually int32_t (signed) but after squaring,\n        // it's equivalent to work in uint32_t (unsigned).\n        pb -= cb;\n        pg -= cg;\n        pr -= cr;\n        pa -= ca;\n        uint64_t score = ((uint64_t)(pb * pb)) + ((uint64_t)(pg * pg)) +\n                         ((uint64_t)(pr * pr)) + ((uint64_t)(pa * pa));\n        if (best_score > score) {\n          best_score = score;\n          best_index = i;\n        " +
@@ -600,9 +621,11 @@ const BasePixConvSubmoduleC = "" +
 	"// --------\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__squash_align4_bgr_565_8888(uint8_t* dst_ptr,\n                                                       size_t dst_len,\n                                                       const uint8_t* src_ptr,\n                                                       size_t src_len,\n                                                       bool nonpremul) {\n  size_t len = (dst_len < src_len ? dst_len : src_len) / 4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n\n  size_t n = len;\n  while (n--) {\n    uint32_t argb = wuffs_base__peek_u32le__no_bounds_check(s);\n    if (nonpremul) {\n      argb =\n          wuffs_base__color_u32_argb_nonpremul__as__color_u32_argb_premul(argb);\n    }\n    uint32_t b5 = 0x1F & (argb >> (8 - 5));\n    uint32_t g6 = 0x3F & (argb >> (16 - 6));\n    uint32_t r5 = 0x1F & (argb >> (24 - 5));\n    uint32_t alpha = argb & 0xFF000000;\n    wuffs_base__poke_u32le__no_bounds_check(\n        d, alpha | (r5 << 11) | (g6 << 5) | (b5 << 0));\n    s += 4;\n   " +
 	" d += 4;\n  }\n  return len;\n}\n\n" +
 	"" +
-	"// --------\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__swap_rgb_bgr(uint8_t* dst_ptr,\n                                         size_t dst_len,\n                                         uint8_t* dst_palette_ptr,\n                                         size_t dst_palette_len,\n                                         const uint8_t* src_ptr,\n                                         size_t src_len) {\n  size_t len = (dst_len < src_len ? dst_len : src_len) / 3;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n\n  size_t n = len;\n  while (n--) {\n    uint8_t s0 = s[0];\n    uint8_t s1 = s[1];\n    uint8_t s2 = s[2];\n    d[0] = s2;\n    d[1] = s1;\n    d[2] = s0;\n    s += 3;\n    d += 3;\n  }\n  return len;\n}\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_sse42\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42(uint8_t* dst_ptr,\n                                                  size_t dst_len,\n             " +
-	"                                     uint8_t* dst_palette_ptr,\n                                                  size_t dst_palette_len,\n                                                  const uint8_t* src_ptr,\n                                                  size_t src_len) {\n  size_t len = (dst_len < src_len ? dst_len : src_len) / 4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  __m128i shuffle = _mm_set_epi8(+0x0F, +0x0C, +0x0D, +0x0E,  //\n                                 +0x0B, +0x08, +0x09, +0x0A,  //\n                                 +0x07, +0x04, +0x05, +0x06,  //\n                                 +0x03, +0x00, +0x01, +0x02);\n\n  while (n >= 4) {\n    __m128i x;\n    x = _mm_lddqu_si128((const __m128i*)(const void*)s);\n    x = _mm_shuffle_epi8(x, shuffle);\n    _mm_storeu_si128((__m128i*)(void*)d, x);\n\n    s += 4 * 4;\n    d += 4 * 4;\n    n -= 4;\n  }\n\n  while (n--) {\n    uint8_t s0 = s[0];\n    uint8_t s1 = s[1];\n    uint8_t s2 = s[2];\n    uint8_t s3 = s[3];\n    d[0] = s2;\n    d[1" +
-	"] = s1;\n    d[2] = s0;\n    d[3] = s3;\n    s += 4;\n    d += 4;\n  }\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_sse42\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__swap_rgbx_bgrx(uint8_t* dst_ptr,\n                                           size_t dst_len,\n                                           uint8_t* dst_palette_ptr,\n                                           size_t dst_palette_len,\n                                           const uint8_t* src_ptr,\n                                           size_t src_len) {\n  size_t len = (dst_len < src_len ? dst_len : src_len) / 4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n\n  size_t n = len;\n  while (n--) {\n    uint8_t s0 = s[0];\n    uint8_t s1 = s[1];\n    uint8_t s2 = s[2];\n    uint8_t s3 = s[3];\n    d[0] = s2;\n    d[1] = s1;\n    d[2] = s0;\n    d[3] = s3;\n    s += 4;\n    d += 4;\n  }\n  return len;\n}\n\n" +
+	"// --------\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__swap_rgb_bgr(uint8_t* dst_ptr,\n                                         size_t dst_len,\n                                         uint8_t* dst_palette_ptr,\n                                         size_t dst_palette_len,\n                                         const uint8_t* src_ptr,\n                                         size_t src_len) {\n  size_t len = (dst_len < src_len ? dst_len : src_len) / 3;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n\n  size_t n = len;\n  while (n--) {\n    uint8_t s0 = s[0];\n    uint8_t s1 = s[1];\n    uint8_t s2 = s[2];\n    d[0] = s2;\n    d[1] = s1;\n    d[2] = s0;\n    s += 3;\n    d += 3;\n  }\n  return len;\n}\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_avx2\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__swap_rgbx_bgrx__avx2(uint8_t* dst_ptr,\n                                                 size_t dst_len,\n           " +
+	"                                      uint8_t* dst_palette_ptr,\n                                                 size_t dst_palette_len,\n                                                 const uint8_t* src_ptr,\n                                                 size_t src_len) {\n  size_t len = (dst_len < src_len ? dst_len : src_len) / 4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  __m256i shuffle = _mm256_set_epi8(+0x0F, +0x0C, +0x0D, +0x0E,  //\n                                    +0x0B, +0x08, +0x09, +0x0A,  //\n                                    +0x07, +0x04, +0x05, +0x06,  //\n                                    +0x03, +0x00, +0x01, +0x02,  //\n                                    +0x0F, +0x0C, +0x0D, +0x0E,  //\n                                    +0x0B, +0x08, +0x09, +0x0A,  //\n                                    +0x07, +0x04, +0x05, +0x06,  //\n                                    +0x03, +0x00, +0x01, +0x02);\n\n  while (n >= 8) {\n    __m256i x;\n    x = _mm256_lddqu_si256((const __m2" +
+	"56i*)(const void*)s);\n    x = _mm256_shuffle_epi8(x, shuffle);\n    _mm256_storeu_si256((__m256i*)(void*)d, x);\n\n    s += 8 * 4;\n    d += 8 * 4;\n    n -= 8;\n  }\n\n  while (n >= 1) {\n    uint8_t s0 = s[0];\n    uint8_t s1 = s[1];\n    uint8_t s2 = s[2];\n    uint8_t s3 = s[3];\n    d[0] = s2;\n    d[1] = s1;\n    d[2] = s0;\n    d[3] = s3;\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_avx2\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_sse42\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42(uint8_t* dst_ptr,\n                                                  size_t dst_len,\n                                                  uint8_t* dst_palette_ptr,\n                                                  size_t dst_palette_len,\n                                                  const uint8_t* src_ptr,\n            " +
+	"                                      size_t src_len) {\n  size_t len = (dst_len < src_len ? dst_len : src_len) / 4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  __m128i shuffle = _mm_set_epi8(+0x0F, +0x0C, +0x0D, +0x0E,  //\n                                 +0x0B, +0x08, +0x09, +0x0A,  //\n                                 +0x07, +0x04, +0x05, +0x06,  //\n                                 +0x03, +0x00, +0x01, +0x02);\n\n  while (n >= 4) {\n    __m128i x;\n    x = _mm_lddqu_si128((const __m128i*)(const void*)s);\n    x = _mm_shuffle_epi8(x, shuffle);\n    _mm_storeu_si128((__m128i*)(void*)d, x);\n\n    s += 4 * 4;\n    d += 4 * 4;\n    n -= 4;\n  }\n\n  while (n--) {\n    uint8_t s0 = s[0];\n    uint8_t s1 = s[1];\n    uint8_t s2 = s[2];\n    uint8_t s3 = s[3];\n    d[0] = s2;\n    d[1] = s1;\n    d[2] = s0;\n    d[3] = s3;\n    s += 4;\n    d += 4;\n  }\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_sse42\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__" +
+	"swap_rgbx_bgrx(uint8_t* dst_ptr,\n                                           size_t dst_len,\n                                           uint8_t* dst_palette_ptr,\n                                           size_t dst_palette_len,\n                                           const uint8_t* src_ptr,\n                                           size_t src_len) {\n  size_t len = (dst_len < src_len ? dst_len : src_len) / 4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n\n  size_t n = len;\n  while (n--) {\n    uint8_t s0 = s[0];\n    uint8_t s1 = s[1];\n    uint8_t s2 = s[2];\n    uint8_t s3 = s[3];\n    d[0] = s2;\n    d[1] = s1;\n    d[2] = s0;\n    d[3] = s3;\n    s += 4;\n    d += 4;\n  }\n  return len;\n}\n\n" +
 	"" +
 	"// --------\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__copy_1_1(uint8_t* dst_ptr,\n                                     size_t dst_len,\n                                     uint8_t* dst_palette_ptr,\n                                     size_t dst_palette_len,\n                                     const uint8_t* src_ptr,\n                                     size_t src_len) {\n  size_t len = (dst_len < src_len) ? dst_len : src_len;\n  if (len > 0) {\n    memmove(dst_ptr, src_ptr, len);\n  }\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__copy_2_2(uint8_t* dst_ptr,\n                                     size_t dst_len,\n                                     uint8_t* dst_palette_ptr,\n                                     size_t dst_palette_len,\n                                     const uint8_t* src_ptr,\n                                     size_t src_len) {\n  size_t dst_len2 = dst_len / 2;\n  size_t src_len2 = src_len / 2;\n  size_t len = (dst_len2 < src_len2) ? dst_len2 : src_len2;\n  if (len > 0) {\n  " +
 	"  memmove(dst_ptr, src_ptr, len * 2);\n  }\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__copy_3_3(uint8_t* dst_ptr,\n                                     size_t dst_len,\n                                     uint8_t* dst_palette_ptr,\n                                     size_t dst_palette_len,\n                                     const uint8_t* src_ptr,\n                                     size_t src_len) {\n  size_t dst_len3 = dst_len / 3;\n  size_t src_len3 = src_len / 3;\n  size_t len = (dst_len3 < src_len3) ? dst_len3 : src_len3;\n  if (len > 0) {\n    memmove(dst_ptr, src_ptr, len * 3);\n  }\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__copy_4_4(uint8_t* dst_ptr,\n                                     size_t dst_len,\n                                     uint8_t* dst_palette_ptr,\n                                     size_t dst_palette_len,\n                                     const uint8_t* src_ptr,\n                                     size_t src_len) {\n  size_t dst_len4 = dst_l" +
@@ -664,23 +687,50 @@ const BasePixConvSubmoduleC = "" +
 	"s0 = wuffs_base__color_u32__as__color_u64(\n        wuffs_base__color_u32_argb_premul__as__color_u32_argb_nonpremul(\n            wuffs_base__swap_u32_argb_abgr(\n                wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)))));\n    wuffs_base__poke_u64le__no_bounds_check(d + (0 * 8), s0);\n\n    s += 1 * 4;\n    d += 1 * 8;\n    n -= 1;\n  }\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__rgba_premul__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len8 = dst_len / 8;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len8 < src_len4) ? dst_len8 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n\n  size_t n = len;\n  while (n >= 1) {\n    uint64_t d0 = wuffs_base__peek_u64le__no_bounds_check(d + (0 * 8));\n    uint64_t s0 =\n        wuffs_base__color_u32__as__color_u64(wuffs_base__swap_u32_argb_abgr(\n            wuffs_base__peek_u32le" +
 	"__no_bounds_check(s + (0 * 4))));\n    wuffs_base__poke_u64le__no_bounds_check(\n        d + (0 * 8), wuffs_base__composite_nonpremul_premul_u64_axxx(d0, s0));\n\n    s += 1 * 4;\n    d += 1 * 8;\n    n -= 1;\n  }\n  return len;\n}\n\n" +
 	"" +
-	"// --------\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        wuffs_base__color_u32_argb_nonpremul__as__color_u32_argb_premul(s0));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 =" +
-	" dst_len / 4;\n  size_t src_len8 = src_len / 8;\n  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint64_t s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul(s0));\n\n    s += 1 * 8;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint32_t d0 = wuffs_base__peek_u32le__no_bo" +
-	"unds_check(d + (0 * 4));\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__composite_premul_nonpremul_u32_axxx(d0, s0));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len8 = src_len / 8;\n  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint64_t d0 = wuffs_base__color_u32__as__color_u64(\n        wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4)));\n    uint64_t s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4" +
-	"),\n        wuffs_base__color_u64__as__color_u32(\n            wuffs_base__composite_premul_nonpremul_u64_axxx(d0, s0)));\n\n    s += 1 * 8;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__composite_premul_premul_u32_axxx(d0, s0));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__p" +
-	"ixel_swizzler__bgra_premul__index_bgra_nonpremul__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  if (dst_palette_len !=\n      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n    return 0;\n  }\n  size_t dst_len4 = dst_len / 4;\n  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +\n                                                          ((size_t)s[0] * 4));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__composite_premul_nonpremul_u32_axxx(d0, s0));\n\n    s += 1 * 1;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src(\n    " +
-	"uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint32_t s0 = wuffs_base__swap_u32_argb_abgr(\n        wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        wuffs_base__color_u32_argb_nonpremul__as__color_u32_argb_premul(s0));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len " +
-	"= (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));\n    uint32_t s0 = wuffs_base__swap_u32_argb_abgr(\n        wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__composite_premul_nonpremul_u32_axxx(d0, s0));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len8 = src_len / 8;\n  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint64_t" +
-	" s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        wuffs_base__swap_u32_argb_abgr(\n            wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul(\n                s0)));\n\n    s += 1 * 8;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len8 = src_len / 8;\n  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint64_t d0 = wuffs_base__color_u32__as__color_u64(\n        wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4)));\n    uint64_t s0 = wuffs_base__swap_u64_argb_abgr(\n        wuffs_base__peek_u64le__no_bound" +
-	"s_check(s + (0 * 8)));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        wuffs_base__color_u64__as__color_u32(\n            wuffs_base__composite_premul_nonpremul_u64_axxx(d0, s0)));\n\n    s += 1 * 8;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__rgba_premul__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  while (n >= 1) {\n    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));\n    uint32_t s0 = wuffs_base__swap_u32_argb_abgr(\n        wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__composite_premul_premul_u32_axxx(d0," +
-	" s0));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n" +
-	"" +
-	"// --------\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw__bgr(uint8_t* dst_ptr,\n                                      size_t dst_len,\n                                      uint8_t* dst_palette_ptr,\n                                      size_t dst_palette_len,\n                                      const uint8_t* src_ptr,\n                                      size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len3 = src_len / 3;\n  size_t len = (dst_len4 < src_len3) ? dst_len4 : src_len3;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        0xFF000000 | wuffs_base__peek_u24le__no_bounds_check(s + (0 * 3)));\n\n    s += 1 * 3;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw__bgr_565(uint8_t* dst_ptr,\n                                          size_t dst_len,\n                                          uint8_t* d" +
-	"st_palette_ptr,\n                                          size_t dst_palette_len,\n                                          const uint8_t* src_ptr,\n                                          size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len2 = src_len / 2;\n  size_t len = (dst_len4 < src_len2) ? dst_len4 : src_len2;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__color_u16_rgb_565__as__color_u32_argb_premul(\n                         wuffs_base__peek_u16le__no_bounds_check(s + (0 * 2))));\n\n    s += 1 * 2;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw__bgrx(uint8_t* dst_ptr,\n                                       size_t dst_len,\n                                       uint8_t* dst_palette_ptr,\n                                       size_t dst_palette_len,\n                                       const u" +
-	"int8_t* src_ptr,\n                                       size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        0xFF000000 | wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_sse42\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw__rgb__sse42(uint8_t* dst_ptr,\n                                             size_t dst_len,\n                                             uint8_t* dst_palette_ptr,\n                                             size_t dst_palette_len,\n                                             const uint8_t* src_ptr,\n      " +
-	"                                       size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len3 = src_len / 3;\n  size_t len = (dst_len4 < src_len3) ? dst_len4 : src_len3;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  __m128i shuffle = _mm_set_epi8(+0x00, +0x09, +0x0A, +0x0B,  //\n                                 +0x00, +0x06, +0x07, +0x08,  //\n                                 +0x00, +0x03, +0x04, +0x05,  //\n                                 +0x00, +0x00, +0x01, +0x02);\n  __m128i or_ff = _mm_set_epi8(-0x01, +0x00, +0x00, +0x00,  //\n                               -0x01, +0x00, +0x00, +0x00,  //\n                               -0x01, +0x00, +0x00, +0x00,  //\n                               -0x01, +0x00, +0x00, +0x00);\n\n  while (n >= 6) {\n    __m128i x;\n    x = _mm_lddqu_si128((const __m128i*)(const void*)s);\n    x = _mm_shuffle_epi8(x, shuffle);\n    x = _mm_or_si128(x, or_ff);\n    _mm_storeu_si128((__m128i*)(void*)d, x);\n\n    s += 4 * 3;\n    d += 4 * 4;\n    n -= 4;\n  }\n\n  whi" +
-	"le (n >= 1) {\n    uint8_t b0 = s[0];\n    uint8_t b1 = s[1];\n    uint8_t b2 = s[2];\n    d[0] = b2;\n    d[1] = b1;\n    d[2] = b0;\n    d[3] = 0xFF;\n\n    s += 1 * 3;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_sse42\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw__rgb(uint8_t* dst_ptr,\n                                      size_t dst_len,\n                                      uint8_t* dst_palette_ptr,\n                                      size_t dst_palette_len,\n                                      const uint8_t* src_ptr,\n                                      size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len3 = src_len / 3;\n  size_t len = (dst_len4 < src_len3) ? dst_len4 : src_len3;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  while (n >= 1) {\n    uint8_t b0 = s[0];\n    uint8_t b1 = s[1];\n    uint8_t b2 = s[2];\n    d[0] = b2;\n    d[1] = b1;\n    d[2] = b0;\n    d[3] = 0xF" +
-	"F;\n\n    s += 1 * 3;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw__rgbx(uint8_t* dst_ptr,\n                                       size_t dst_len,\n                                       uint8_t* dst_palette_ptr,\n                                       size_t dst_palette_len,\n                                       const uint8_t* src_ptr,\n                                       size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint8_t b0 = s[0];\n    uint8_t b1 = s[1];\n    uint8_t b2 = s[2];\n    d[0] = b2;\n    d[1] = b1;\n    d[2] = b0;\n    d[3] = 0xFF;\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n" +
+	"// --------\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_avx2\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src__avx2(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // As per wuffs_base__color_u32_argb_nonpremul__as__color_u32_argb_premul,\n  // each premultiplied color channel is (((c * a * 0x10201) / 0xFFFF) >> 8)\n  // for 8-bit c and a. That equals (mulhi(c * a, 0x8101) >> 7), where\n  // mulhi(x, y) is ((x * y) >> 16), as verified exhaustively over all (c, a)\n  // pairs. Multiplying the alpha channel by 0xFF leaves it unchanged.\n  __m256i zero = _mm256_setzero_si256();\n  __m256i u" +
+	"16_0x8101 = _mm256_set1_epi16(-0x7EFF);\n  __m256i alpha_ff = _mm256_set_epi16(0xFF, 0x00, 0x00, 0x00,  //\n                                      0xFF, 0x00, 0x00, 0x00,  //\n                                      0xFF, 0x00, 0x00, 0x00,  //\n                                      0xFF, 0x00, 0x00, 0x00);\n  __m256i shuffle_lo = _mm256_set_epi8(-0x01, -0x01, -0x01, +0x07,  //\n                                       -0x01, +0x07, -0x01, +0x07,  //\n                                       -0x01, -0x01, -0x01, +0x03,  //\n                                       -0x01, +0x03, -0x01, +0x03,  //\n                                       -0x01, -0x01, -0x01, +0x07,  //\n                                       -0x01, +0x07, -0x01, +0x07,  //\n                                       -0x01, -0x01, -0x01, +0x03,  //\n                                       -0x01, +0x03, -0x01, +0x03);\n  __m256i shuffle_hi = _mm256_set_epi8(-0x01, -0x01, -0x01, +0x0F,  //\n                                       -0x01, +0x0F, -0x01, +0x0F,  //\n                " +
+	"                       -0x01, -0x01, -0x01, +0x0B,  //\n                                       -0x01, +0x0B, -0x01, +0x0B,  //\n                                       -0x01, -0x01, -0x01, +0x0F,  //\n                                       -0x01, +0x0F, -0x01, +0x0F,  //\n                                       -0x01, -0x01, -0x01, +0x0B,  //\n                                       -0x01, +0x0B, -0x01, +0x0B);\n\n  while (n >= 8) {\n    __m256i x = _mm256_lddqu_si256((const __m256i*)(const void*)s);\n\n    // Per 128-bit lane, the multipliers for pixels 0, 1 (a_lo) and 2, 3 (a_hi)\n    // in 16-bit B, G, R, A order: the pixel's alpha, three times, then 0xFF.\n    __m256i a_lo =\n        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle_lo), alpha_ff);\n    __m256i a_hi =\n        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle_hi), alpha_ff);\n\n    __m256i p_lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(x, zero), a_lo);\n    __m256i p_hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(x, zero), a_hi);\n    p_lo = _mm256_srli_epi16(_mm256_m" +
+	"ulhi_epu16(p_lo, u16_0x8101), 7);\n    p_hi = _mm256_srli_epi16(_mm256_mulhi_epu16(p_hi, u16_0x8101), 7);\n\n    _mm256_storeu_si256((__m256i*)(void*)d, _mm256_packus_epi16(p_lo, p_hi));\n\n    s += 8 * 4;\n    d += 8 * 4;\n    n -= 8;\n  }\n\n  while (n >= 1) {\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        wuffs_base__color_u32_argb_nonpremul__as__color_u32_argb_premul(s0));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_avx2\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t" +
+	"* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        wuffs_base__color_u32_argb_nonpremul__as__color_u32_argb_premul(s0));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_avx2\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src__avx2(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len8 = src_len / 8;\n  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // As per wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul," +
+	"\n  // each premultiplied color channel is (((c * a) / 0xFFFF) >> 8) for 16-bit\n  // c and a. For x up to (0xFFFF * 0xFFFF), (x / 0xFFFF) equals\n  // ((x + (x >> 16) + 1) >> 16), as verified exhaustively. Multiplying the\n  // alpha channel by 0xFFFF leaves it unchanged.\n  __m256i shuffle = _mm256_set_epi8(-0x01, -0x01, +0x0F, +0x0E,  //\n                                    +0x0F, +0x0E, +0x0F, +0x0E,  //\n                                    -0x01, -0x01, +0x07, +0x06,  //\n                                    +0x07, +0x06, +0x07, +0x06,  //\n                                    -0x01, -0x01, +0x0F, +0x0E,  //\n                                    +0x0F, +0x0E, +0x0F, +0x0E,  //\n                                    -0x01, -0x01, +0x07, +0x06,  //\n                                    +0x07, +0x06, +0x07, +0x06);\n  __m256i zero = _mm256_setzero_si256();\n  __m256i u32_1 = _mm256_set1_epi32(1);\n  __m256i alpha_ffff = _mm256_set_epi16(-0x01, 0x00, 0x00, 0x00,  //\n                                        -0x01, 0x00, 0x00, 0x00" +
+	",  //\n                                        -0x01, 0x00, 0x00, 0x00,  //\n                                        -0x01, 0x00, 0x00, 0x00);\n\n  while (n >= 4) {\n    __m256i x = _mm256_lddqu_si256((const __m256i*)(const void*)s);\n    __m256i a =\n        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle), alpha_ffff);\n\n    // Per 128-bit lane, p_lo and p_hi hold pixels 0 and 1 in 32-bit lanes.\n    __m256i p_lo = _mm256_mullo_epi32(_mm256_unpacklo_epi16(x, zero),\n                                      _mm256_unpacklo_epi16(a, zero));\n    __m256i p_hi = _mm256_mullo_epi32(_mm256_unpackhi_epi16(x, zero),\n                                      _mm256_unpackhi_epi16(a, zero));\n    p_lo = _mm256_srli_epi32(\n        _mm256_add_epi32(_mm256_add_epi32(p_lo, _mm256_srli_epi32(p_lo, 16)),\n                         u32_1),\n        24);\n    p_hi = _mm256_srli_epi32(\n        _mm256_add_epi32(_mm256_add_epi32(p_hi, _mm256_srli_epi32(p_hi, 16)),\n                         u32_1),\n        24);\n\n    // Pack to 8-bit channels and gather " +
+	"the low 64 bits of each 128-bit lane.\n    __m256i y = _mm256_packus_epi32(p_lo, p_hi);\n    y = _mm256_permute4x64_epi64(_mm256_packus_epi16(y, y), 0x08);\n    _mm_storeu_si128((__m128i*)(void*)d, _mm256_castsi256_si128(y));\n\n    s += 4 * 8;\n    d += 4 * 4;\n    n -= 4;\n  }\n\n  while (n >= 1) {\n    uint64_t s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul(s0));\n\n    s += 1 * 8;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_avx2\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len8 = src_len / 8;\n  size_t len = (dst_len4 < src_len8) ? dst_len4 : src" +
+	"_len8;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint64_t s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul(s0));\n\n    s += 1 * 8;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));\n   " +
+	" wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__composite_premul_nonpremul_u32_axxx(d0, s0));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len8 = src_len / 8;\n  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint64_t d0 = wuffs_base__color_u32__as__color_u64(\n        wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4)));\n    uint64_t s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        wuffs_base__color_u64__as__color_u32(\n            wuffs_base__composite_premul_nonpremul_" +
+	"u64_axxx(d0, s0)));\n\n    s += 1 * 8;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n// The SIMD bgra_premul__bgra_premul__src_over implementations work in 16-bit\n// lanes. For each channel (including alpha) with 8-bit values s (src), d (dst)\n// and sa (src alpha), the scalar code computes:\n//\n//   ((0x101 * s) + (((0x101 * d) * (0xFFFF - (0x101 * sa))) / 0xFFFF)) >> 8\n//\n// With p = d * (0xFF - sa), that equals ((0x101 * s) + p + mulhi(p, 514)) >> 8,\n// where mulhi(x, y) is ((x * y) >> 16), and none of the 16-bit additions\n// overflow, provided that the src is validly premultiplied (s <= sa). This\n// was verified exhaustively over all (s, d, sa) triples.\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_avx2\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__avx2(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* " +
+	"src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  __m256i zero = _mm256_setzero_si256();\n  __m256i u16_0xFF = _mm256_set1_epi16(0xFF);\n  __m256i u16_514 = _mm256_set1_epi16(514);\n  __m256i shuffle_lo = _mm256_set_epi8(-0x01, +0x07, -0x01, +0x07,  //\n                                       -0x01, +0x07, -0x01, +0x07,  //\n                                       -0x01, +0x03, -0x01, +0x03,  //\n                                       -0x01, +0x03, -0x01, +0x03,  //\n                                       -0x01, +0x07, -0x01, +0x07,  //\n                                       -0x01, +0x07, -0x01, +0x07,  //\n                                       -0x01, +0x03, -0x01, +0x03,  //\n                                       -0x01, +0x03, -0x01, +0x03);\n  __m256i shuffle_hi = _mm256_set_epi8(-0x01, +0x0F, -0x01, +0x0F,  //\n                           " +
+	"            -0x01, +0x0F, -0x01, +0x0F,  //\n                                       -0x01, +0x0B, -0x01, +0x0B,  //\n                                       -0x01, +0x0B, -0x01, +0x0B,  //\n                                       -0x01, +0x0F, -0x01, +0x0F,  //\n                                       -0x01, +0x0F, -0x01, +0x0F,  //\n                                       -0x01, +0x0B, -0x01, +0x0B,  //\n                                       -0x01, +0x0B, -0x01, +0x0B);\n\n  while (n >= 8) {\n    __m256i sx = _mm256_lddqu_si256((const __m256i*)(const void*)s);\n    __m256i dx = _mm256_lddqu_si256((const __m256i*)(const void*)d);\n\n    // The unpack, shuffle and pack instructions work within each 128-bit\n    // lane. Per lane, these are the alphas of pixels 0, 1 (sa_lo) and 2, 3\n    // (sa_hi), spread over the 16-bit B, G, R and A channels.\n    __m256i sa_lo = _mm256_shuffle_epi8(sx, shuffle_lo);\n    __m256i sa_hi = _mm256_shuffle_epi8(sx, shuffle_hi);\n\n    __m256i s_lo = _mm256_unpacklo_epi8(sx, zero);\n    __m256i s_hi = " +
+	"_mm256_unpackhi_epi8(sx, zero);\n    __m256i p_lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(dx, zero),\n                                      _mm256_sub_epi16(u16_0xFF, sa_lo));\n    __m256i p_hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(dx, zero),\n                                      _mm256_sub_epi16(u16_0xFF, sa_hi));\n\n    __m256i o_lo = _mm256_add_epi16(\n        _mm256_add_epi16(_mm256_slli_epi16(s_lo, 8), s_lo),\n        _mm256_add_epi16(p_lo, _mm256_mulhi_epu16(p_lo, u16_514)));\n    __m256i o_hi = _mm256_add_epi16(\n        _mm256_add_epi16(_mm256_slli_epi16(s_hi, 8), s_hi),\n        _mm256_add_epi16(p_hi, _mm256_mulhi_epu16(p_hi, u16_514)));\n\n    _mm256_storeu_si256(\n        (__m256i*)(void*)d,\n        _mm256_packus_epi16(_mm256_srli_epi16(o_lo, 8),\n                            _mm256_srli_epi16(o_hi, 8)));\n\n    s += 8 * 4;\n    d += 8 * 4;\n    n -= 8;\n  }\n\n  while (n >= 1) {\n    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0" +
+	" * 4));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__composite_premul_premul_u32_axxx(d0, s0));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_avx2\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_sse42\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__sse42(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  __m128i zero = _mm_setzero_si128();\n  __m128i u16_0xFF = _mm_set1_epi16(0xFF);\n  __m128i u16_514 = _mm_set1_epi16(514);\n  __m128i shuffle_lo = _mm_set_" +
+	"epi8(-0x01, +0x07, -0x01, +0x07,  //\n                                    -0x01, +0x07, -0x01, +0x07,  //\n                                    -0x01, +0x03, -0x01, +0x03,  //\n                                    -0x01, +0x03, -0x01, +0x03);\n  __m128i shuffle_hi = _mm_set_epi8(-0x01, +0x0F, -0x01, +0x0F,  //\n                                    -0x01, +0x0F, -0x01, +0x0F,  //\n                                    -0x01, +0x0B, -0x01, +0x0B,  //\n                                    -0x01, +0x0B, -0x01, +0x0B);\n\n  while (n >= 4) {\n    __m128i sx = _mm_lddqu_si128((const __m128i*)(const void*)s);\n    __m128i dx = _mm_lddqu_si128((const __m128i*)(const void*)d);\n\n    // The alphas of pixels 0, 1 (sa_lo) and 2, 3 (sa_hi), spread over the\n    // 16-bit B, G, R and A channels.\n    __m128i sa_lo = _mm_shuffle_epi8(sx, shuffle_lo);\n    __m128i sa_hi = _mm_shuffle_epi8(sx, shuffle_hi);\n\n    __m128i s_lo = _mm_unpacklo_epi8(sx, zero);\n    __m128i s_hi = _mm_unpackhi_epi8(sx, zero);\n    __m128i p_lo = _mm_mullo_epi16(_mm_unpackl" +
+	"o_epi8(dx, zero),\n                                   _mm_sub_epi16(u16_0xFF, sa_lo));\n    __m128i p_hi = _mm_mullo_epi16(_mm_unpackhi_epi8(dx, zero),\n                                   _mm_sub_epi16(u16_0xFF, sa_hi));\n\n    __m128i o_lo =\n        _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(s_lo, 8), s_lo),\n                      _mm_add_epi16(p_lo, _mm_mulhi_epu16(p_lo, u16_514)));\n    __m128i o_hi =\n        _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(s_hi, 8), s_hi),\n                      _mm_add_epi16(p_hi, _mm_mulhi_epu16(p_hi, u16_514)));\n\n    _mm_storeu_si128(\n        (__m128i*)(void*)d,\n        _mm_packus_epi16(_mm_srli_epi16(o_lo, 8), _mm_srli_epi16(o_hi, 8)));\n\n    s += 4 * 4;\n    d += 4 * 4;\n    n -= 4;\n  }\n\n  while (n >= 1) {\n    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__composite_premul_premul_u32_axxx(d0, s0));\n\n    s += 1 * 4;\n" +
+	"    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_sse42\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__composite_premul_premul_u32_axxx(d0, s0));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__index_bgra_nonpre" +
+	"mul__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  if (dst_palette_len !=\n      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n    return 0;\n  }\n  size_t dst_len4 = dst_len / 4;\n  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +\n                                                          ((size_t)s[0] * 4));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__composite_premul_nonpremul_u32_axxx(d0, s0));\n\n    s += 1 * 1;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_avx2\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popc" +
+	"nt,sse4.2,avx2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src__avx2(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // See the bgra_premul__bgra_nonpremul__src__avx2 comments. This function\n  // also swaps the R and B channels.\n  __m256i swap = _mm256_set_epi8(+0x0F, +0x0C, +0x0D, +0x0E,  //\n                                 +0x0B, +0x08, +0x09, +0x0A,  //\n                                 +0x07, +0x04, +0x05, +0x06,  //\n                                 +0x03, +0x00, +0x01, +0x02,  //\n                                 +0x0F, +0x0C, +0x0D, +0x0E,  //\n                                 +0x0B, +0x08, +0x09, +0x0A,  //\n                                 +0x07, +0x04, +0x05, +0x06,  //\n " +
+	"                                +0x03, +0x00, +0x01, +0x02);\n  __m256i zero = _mm256_setzero_si256();\n  __m256i u16_0x8101 = _mm256_set1_epi16(-0x7EFF);\n  __m256i alpha_ff = _mm256_set_epi16(0xFF, 0x00, 0x00, 0x00,  //\n                                      0xFF, 0x00, 0x00, 0x00,  //\n                                      0xFF, 0x00, 0x00, 0x00,  //\n                                      0xFF, 0x00, 0x00, 0x00);\n  __m256i shuffle_lo = _mm256_set_epi8(-0x01, -0x01, -0x01, +0x07,  //\n                                       -0x01, +0x07, -0x01, +0x07,  //\n                                       -0x01, -0x01, -0x01, +0x03,  //\n                                       -0x01, +0x03, -0x01, +0x03,  //\n                                       -0x01, -0x01, -0x01, +0x07,  //\n                                       -0x01, +0x07, -0x01, +0x07,  //\n                                       -0x01, -0x01, -0x01, +0x03,  //\n                                       -0x01, +0x03, -0x01, +0x03);\n  __m256i shuffle_hi = _mm256_set_epi8(-0x01," +
+	" -0x01, -0x01, +0x0F,  //\n                                       -0x01, +0x0F, -0x01, +0x0F,  //\n                                       -0x01, -0x01, -0x01, +0x0B,  //\n                                       -0x01, +0x0B, -0x01, +0x0B,  //\n                                       -0x01, -0x01, -0x01, +0x0F,  //\n                                       -0x01, +0x0F, -0x01, +0x0F,  //\n                                       -0x01, -0x01, -0x01, +0x0B,  //\n                                       -0x01, +0x0B, -0x01, +0x0B);\n\n  while (n >= 8) {\n    __m256i x = _mm256_lddqu_si256((const __m256i*)(const void*)s);\n    x = _mm256_shuffle_epi8(x, swap);\n\n    // Per 128-bit lane, the multipliers for pixels 0, 1 (a_lo) and 2, 3 (a_hi)\n    // in 16-bit B, G, R, A order: the pixel's alpha, three times, then 0xFF.\n    __m256i a_lo =\n        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle_lo), alpha_ff);\n    __m256i a_hi =\n        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle_hi), alpha_ff);\n\n    __m256i p_lo = _mm256_mullo_epi16(" +
+	"_mm256_unpacklo_epi8(x, zero), a_lo);\n    __m256i p_hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(x, zero), a_hi);\n    p_lo = _mm256_srli_epi16(_mm256_mulhi_epu16(p_lo, u16_0x8101), 7);\n    p_hi = _mm256_srli_epi16(_mm256_mulhi_epu16(p_hi, u16_0x8101), 7);\n\n    _mm256_storeu_si256((__m256i*)(void*)d, _mm256_packus_epi16(p_lo, p_hi));\n\n    s += 8 * 4;\n    d += 8 * 4;\n    n -= 8;\n  }\n\n  while (n >= 1) {\n    uint32_t s0 = wuffs_base__swap_u32_argb_abgr(\n        wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        wuffs_base__color_u32_argb_nonpremul__as__color_u32_argb_premul(s0));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_avx2\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_" +
+	"ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint32_t s0 = wuffs_base__swap_u32_argb_abgr(\n        wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        wuffs_base__color_u32_argb_nonpremul__as__color_u32_argb_premul(s0));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n" +
+	"\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));\n    uint32_t s0 = wuffs_base__swap_u32_argb_abgr(\n        wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__composite_premul_nonpremul_u32_axxx(d0, s0));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_avx2\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src__avx2(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len8 = src_len / 8;\n  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // See the bgr" +
+	"a_premul__bgra_nonpremul_4x16le__src__avx2 comments. This\n  // function also swaps the R and B channels.\n  __m256i swap = _mm256_set_epi8(+0x0F, +0x0E, +0x09, +0x08,  //\n                                 +0x0B, +0x0A, +0x0D, +0x0C,  //\n                                 +0x07, +0x06, +0x01, +0x00,  //\n                                 +0x03, +0x02, +0x05, +0x04,  //\n                                 +0x0F, +0x0E, +0x09, +0x08,  //\n                                 +0x0B, +0x0A, +0x0D, +0x0C,  //\n                                 +0x07, +0x06, +0x01, +0x00,  //\n                                 +0x03, +0x02, +0x05, +0x04);\n  __m256i shuffle = _mm256_set_epi8(-0x01, -0x01, +0x0F, +0x0E,  //\n                                    +0x0F, +0x0E, +0x0F, +0x0E,  //\n                                    -0x01, -0x01, +0x07, +0x06,  //\n                                    +0x07, +0x06, +0x07, +0x06,  //\n                                    -0x01, -0x01, +0x0F, +0x0E,  //\n                                    +0x0F, +0x0E, +0x0F, +0x0E" +
+	",  //\n                                    -0x01, -0x01, +0x07, +0x06,  //\n                                    +0x07, +0x06, +0x07, +0x06);\n  __m256i zero = _mm256_setzero_si256();\n  __m256i u32_1 = _mm256_set1_epi32(1);\n  __m256i alpha_ffff = _mm256_set_epi16(-0x01, 0x00, 0x00, 0x00,  //\n                                        -0x01, 0x00, 0x00, 0x00,  //\n                                        -0x01, 0x00, 0x00, 0x00,  //\n                                        -0x01, 0x00, 0x00, 0x00);\n\n  while (n >= 4) {\n    __m256i x = _mm256_lddqu_si256((const __m256i*)(const void*)s);\n    x = _mm256_shuffle_epi8(x, swap);\n    __m256i a =\n        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle), alpha_ffff);\n\n    // Per 128-bit lane, p_lo and p_hi hold pixels 0 and 1 in 32-bit lanes.\n    __m256i p_lo = _mm256_mullo_epi32(_mm256_unpacklo_epi16(x, zero),\n                                      _mm256_unpacklo_epi16(a, zero));\n    __m256i p_hi = _mm256_mullo_epi32(_mm256_unpackhi_epi16(x, zero),\n                               " +
+	"       _mm256_unpackhi_epi16(a, zero));\n    p_lo = _mm256_srli_epi32(\n        _mm256_add_epi32(_mm256_add_epi32(p_lo, _mm256_srli_epi32(p_lo, 16)),\n                         u32_1),\n        24);\n    p_hi = _mm256_srli_epi32(\n        _mm256_add_epi32(_mm256_add_epi32(p_hi, _mm256_srli_epi32(p_hi, 16)),\n                         u32_1),\n        24);\n\n    // Pack to 8-bit channels and gather the low 64 bits of each 128-bit lane.\n    __m256i y = _mm256_packus_epi32(p_lo, p_hi);\n    y = _mm256_permute4x64_epi64(_mm256_packus_epi16(y, y), 0x08);\n    _mm_storeu_si128((__m128i*)(void*)d, _mm256_castsi256_si128(y));\n\n    s += 4 * 8;\n    d += 4 * 4;\n    n -= 4;\n  }\n\n  while (n >= 1) {\n    uint64_t s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        wuffs_base__swap_u32_argb_abgr(\n            wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul(\n                s0)));\n\n    s += 1 * 8;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n" +
+	"}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_avx2\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len8 = src_len / 8;\n  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint64_t s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        wuffs_base__swap_u32_argb_abgr(\n            wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul(\n                s0)));\n\n    s += 1 * 8;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src_over(\n    uint8_t* d" +
+	"st_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len8 = src_len / 8;\n  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint64_t d0 = wuffs_base__color_u32__as__color_u64(\n        wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4)));\n    uint64_t s0 = wuffs_base__swap_u64_argb_abgr(\n        wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8)));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        wuffs_base__color_u64__as__color_u32(\n            wuffs_base__composite_premul_nonpremul_u64_axxx(d0, s0)));\n\n    s += 1 * 8;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgra_premul__rgba_premul__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t d" +
+	"st_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  while (n >= 1) {\n    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));\n    uint32_t s0 = wuffs_base__swap_u32_argb_abgr(\n        wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__composite_premul_premul_u32_axxx(d0, s0));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n" +
+	"" +
+	"// --------\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_avx2\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw__bgr__avx2(uint8_t* dst_ptr,\n                                            size_t dst_len,\n                                            uint8_t* dst_palette_ptr,\n                                            size_t dst_palette_len,\n                                            const uint8_t* src_ptr,\n                                            size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len3 = src_len / 3;\n  size_t len = (dst_len4 < src_len3) ? dst_len4 : src_len3;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  __m256i shuffle = _mm256_set_epi8(-0x01, +0x0B, +0x0A, +0x09,  //\n                                    -0x01, +0x08, +0x07, +0x06,  //\n                                    -0x01, +0x05, +0x04, +0x03,  //\n                                    -0x01, +0x02, " +
+	"+0x01, +0x00,  //\n                                    -0x01, +0x0B, +0x0A, +0x09,  //\n                                    -0x01, +0x08, +0x07, +0x06,  //\n                                    -0x01, +0x05, +0x04, +0x03,  //\n                                    -0x01, +0x02, +0x01, +0x00);\n  __m256i or_ff = _mm256_set1_epi32(-0x01000000);\n\n  while (n >= 10) {\n    // The second 128-bit lane starts 4 pixels (12 bytes) after the first.\n    __m256i x;\n    x = _mm256_inserti128_si256(\n        _mm256_castsi128_si256(_mm_lddqu_si128((const __m128i*)(const void*)s)),\n        _mm_lddqu_si128((const __m128i*)(const void*)(s + (4 * 3))), 1);\n    x = _mm256_shuffle_epi8(x, shuffle);\n    x = _mm256_or_si256(x, or_ff);\n    _mm256_storeu_si256((__m256i*)(void*)d, x);\n\n    s += 8 * 3;\n    d += 8 * 4;\n    n -= 8;\n  }\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        0xFF000000 | wuffs_base__peek_u24le__no_bounds_check(s + (0 * 3)));\n\n    s += 1 * 3;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  re" +
+	"turn len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_avx2\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw__bgr(uint8_t* dst_ptr,\n                                      size_t dst_len,\n                                      uint8_t* dst_palette_ptr,\n                                      size_t dst_palette_len,\n                                      const uint8_t* src_ptr,\n                                      size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len3 = src_len / 3;\n  size_t len = (dst_len4 < src_len3) ? dst_len4 : src_len3;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        0xFF000000 | wuffs_base__peek_u24le__no_bounds_check(s + (0 * 3)));\n\n    s += 1 * 3;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw__bgr_565(uint8_t* dst_ptr,\n                   " +
+	"                       size_t dst_len,\n                                          uint8_t* dst_palette_ptr,\n                                          size_t dst_palette_len,\n                                          const uint8_t* src_ptr,\n                                          size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len2 = src_len / 2;\n  size_t len = (dst_len4 < src_len2) ? dst_len4 : src_len2;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__color_u16_rgb_565__as__color_u32_argb_premul(\n                         wuffs_base__peek_u16le__no_bounds_check(s + (0 * 2))));\n\n    s += 1 * 2;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_avx2\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw__bgrx__avx2(ui" +
+	"nt8_t* dst_ptr,\n                                             size_t dst_len,\n                                             uint8_t* dst_palette_ptr,\n                                             size_t dst_palette_len,\n                                             const uint8_t* src_ptr,\n                                             size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  __m256i or_ff = _mm256_set1_epi32(-0x01000000);\n\n  while (n >= 8) {\n    __m256i x;\n    x = _mm256_lddqu_si256((const __m256i*)(const void*)s);\n    x = _mm256_or_si256(x, or_ff);\n    _mm256_storeu_si256((__m256i*)(void*)d, x);\n\n    s += 8 * 4;\n    d += 8 * 4;\n    n -= 8;\n  }\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        0xFF000000 | wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    " +
+	"n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_avx2\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw__bgrx(uint8_t* dst_ptr,\n                                       size_t dst_len,\n                                       uint8_t* dst_palette_ptr,\n                                       size_t dst_palette_len,\n                                       const uint8_t* src_ptr,\n                                       size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4),\n        0xFF000000 | wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_avx2\n#if defined(WUFFS_BASE__CPU_ARCH__" +
+	"X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw__rgb__avx2(uint8_t* dst_ptr,\n                                            size_t dst_len,\n                                            uint8_t* dst_palette_ptr,\n                                            size_t dst_palette_len,\n                                            const uint8_t* src_ptr,\n                                            size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len3 = src_len / 3;\n  size_t len = (dst_len4 < src_len3) ? dst_len4 : src_len3;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  __m256i shuffle = _mm256_set_epi8(-0x01, +0x09, +0x0A, +0x0B,  //\n                                    -0x01, +0x06, +0x07, +0x08,  //\n                                    -0x01, +0x03, +0x04, +0x05,  //\n                                    -0x01, +0x00, +0x01, +0x02,  //\n                                    -0x01, +0x09, +0x0A, +0x0B,  //\n   " +
+	"                                 -0x01, +0x06, +0x07, +0x08,  //\n                                    -0x01, +0x03, +0x04, +0x05,  //\n                                    -0x01, +0x00, +0x01, +0x02);\n  __m256i or_ff = _mm256_set1_epi32(-0x01000000);\n\n  while (n >= 10) {\n    // The second 128-bit lane starts 4 pixels (12 bytes) after the first.\n    __m256i x;\n    x = _mm256_inserti128_si256(\n        _mm256_castsi128_si256(_mm_lddqu_si128((const __m128i*)(const void*)s)),\n        _mm_lddqu_si128((const __m128i*)(const void*)(s + (4 * 3))), 1);\n    x = _mm256_shuffle_epi8(x, shuffle);\n    x = _mm256_or_si256(x, or_ff);\n    _mm256_storeu_si256((__m256i*)(void*)d, x);\n\n    s += 8 * 3;\n    d += 8 * 4;\n    n -= 8;\n  }\n\n  while (n >= 1) {\n    uint8_t b0 = s[0];\n    uint8_t b1 = s[1];\n    uint8_t b2 = s[2];\n    d[0] = b2;\n    d[1] = b1;\n    d[2] = b0;\n    d[3] = 0xFF;\n\n    s += 1 * 3;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_av" +
+	"x2\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_sse42\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw__rgb__sse42(uint8_t* dst_ptr,\n                                             size_t dst_len,\n                                             uint8_t* dst_palette_ptr,\n                                             size_t dst_palette_len,\n                                             const uint8_t* src_ptr,\n                                             size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len3 = src_len / 3;\n  size_t len = (dst_len4 < src_len3) ? dst_len4 : src_len3;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  __m128i shuffle = _mm_set_epi8(+0x00, +0x09, +0x0A, +0x0B,  //\n                                 +0x00, +0x06, +0x07, +0x08,  //\n                                 +0x00, +0x03, +0x04, +0x05,  //\n                                 +0x00, +0x00, +0x01, +0x02);\n  __" +
+	"m128i or_ff = _mm_set_epi8(-0x01, +0x00, +0x00, +0x00,  //\n                               -0x01, +0x00, +0x00, +0x00,  //\n                               -0x01, +0x00, +0x00, +0x00,  //\n                               -0x01, +0x00, +0x00, +0x00);\n\n  while (n >= 6) {\n    __m128i x;\n    x = _mm_lddqu_si128((const __m128i*)(const void*)s);\n    x = _mm_shuffle_epi8(x, shuffle);\n    x = _mm_or_si128(x, or_ff);\n    _mm_storeu_si128((__m128i*)(void*)d, x);\n\n    s += 4 * 3;\n    d += 4 * 4;\n    n -= 4;\n  }\n\n  while (n >= 1) {\n    uint8_t b0 = s[0];\n    uint8_t b1 = s[1];\n    uint8_t b2 = s[2];\n    d[0] = b2;\n    d[1] = b1;\n    d[2] = b0;\n    d[3] = 0xFF;\n\n    s += 1 * 3;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_sse42\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw__rgb(uint8_t* dst_ptr,\n                                      size_t dst_len,\n                                      uint8_t* dst_palette_ptr,\n                   " +
+	"                   size_t dst_palette_len,\n                                      const uint8_t* src_ptr,\n                                      size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len3 = src_len / 3;\n  size_t len = (dst_len4 < src_len3) ? dst_len4 : src_len3;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  while (n >= 1) {\n    uint8_t b0 = s[0];\n    uint8_t b1 = s[1];\n    uint8_t b2 = s[2];\n    d[0] = b2;\n    d[1] = b1;\n    d[2] = b0;\n    d[3] = 0xFF;\n\n    s += 1 * 3;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw__rgbx(uint8_t* dst_ptr,\n                                       size_t dst_len,\n                                       uint8_t* dst_palette_ptr,\n                                       size_t dst_palette_len,\n                                       const uint8_t* src_ptr,\n                                       size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len4 = src_len / 4;\n " +
+	" size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint8_t b0 = s[0];\n    uint8_t b1 = s[1];\n    uint8_t b2 = s[2];\n    d[0] = b2;\n    d[1] = b1;\n    d[2] = b0;\n    d[3] = 0xFF;\n\n    s += 1 * 4;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n" +
 	"" +
 	"// --------\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw_4x16le__bgr(uint8_t* dst_ptr,\n                                             size_t dst_len,\n                                             uint8_t* dst_palette_ptr,\n                                             size_t dst_palette_len,\n                                             const uint8_t* src_ptr,\n                                             size_t src_len) {\n  size_t dst_len8 = dst_len / 8;\n  size_t src_len3 = src_len / 3;\n  size_t len = (dst_len8 < src_len3) ? dst_len8 : src_len3;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  while (n >= 1) {\n    uint8_t s0 = s[0];\n    uint8_t s1 = s[1];\n    uint8_t s2 = s[2];\n    d[0] = s0;\n    d[1] = s0;\n    d[2] = s1;\n    d[3] = s1;\n    d[4] = s2;\n    d[5] = s2;\n    d[6] = 0xFF;\n    d[7] = 0xFF;\n\n    s += 1 * 3;\n    d += 1 * 8;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw_4x16le__bgr_565(uint8_t* dst_ptr,\n                              " +
 	"                   size_t dst_len,\n                                                 uint8_t* dst_palette_ptr,\n                                                 size_t dst_palette_len,\n                                                 const uint8_t* src_ptr,\n                                                 size_t src_len) {\n  size_t dst_len8 = dst_len / 8;\n  size_t src_len2 = src_len / 2;\n  size_t len = (dst_len8 < src_len2) ? dst_len8 : src_len2;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  while (n >= 1) {\n    wuffs_base__poke_u64le__no_bounds_check(\n        d + (0 * 8),\n        wuffs_base__color_u32__as__color_u64(\n            wuffs_base__color_u16_rgb_565__as__color_u32_argb_premul(\n                wuffs_base__peek_u16le__no_bounds_check(s + (0 * 2)))));\n\n    s += 1 * 2;\n    d += 1 * 8;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__bgrw_4x16le__bgrx(uint8_t* dst_ptr,\n                                              size_t dst_len,\n               " +
@@ -701,13 +751,31 @@ const BasePixConvSubmoduleC = "" +
 	" uint8_t* dst_palette_ptr,\n                                   size_t dst_palette_len,\n                                   const uint8_t* src_ptr,\n                                   size_t src_len) {\n  size_t dst_len3 = dst_len / 3;\n  size_t len = (dst_len3 < src_len) ? dst_len3 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint8_t s0 = s[0];\n    d[0] = s0;\n    d[1] = s0;\n    d[2] = s0;\n\n    s += 1 * 1;\n    d += 1 * 3;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxx__y_16be(uint8_t* dst_ptr,\n                                        size_t dst_len,\n                                        uint8_t* dst_palette_ptr,\n                                        size_t dst_palette_len,\n                                        const uint8_t* src_ptr,\n                                        size_t src_len) {\n  size_t dst_len3 = dst_len / 3;\n  size_t src_len2 = src_len / 2;\n  size_t len = (dst_len3 < src_len2)" +
 	" ? dst_len3 : src_len2;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // TODO: unroll.\n\n  while (n >= 1) {\n    uint8_t s0 = s[0];\n    d[0] = s0;\n    d[1] = s0;\n    d[2] = s0;\n\n    s += 1 * 2;\n    d += 1 * 3;\n    n -= 1;\n  }\n\n  return len;\n}\n\n" +
 	"" +
-	"// --------\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxx__index__src(uint8_t* dst_ptr,\n                                             size_t dst_len,\n                                             uint8_t* dst_palette_ptr,\n                                             size_t dst_palette_len,\n                                             const uint8_t* src_ptr,\n                                             size_t src_len) {\n  if (dst_palette_len !=\n      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n    return 0;\n  }\n  size_t dst_len4 = dst_len / 4;\n  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  const size_t loop_unroll_count = 4;\n\n  while (n >= loop_unroll_count) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__peek_u32le__no_bounds_check(\n                         dst_palette_ptr + ((size_t)s[0] * 4)));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (1 * 4), wuffs_base__" +
-	"peek_u32le__no_bounds_check(\n                         dst_palette_ptr + ((size_t)s[1] * 4)));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (2 * 4), wuffs_base__peek_u32le__no_bounds_check(\n                         dst_palette_ptr + ((size_t)s[2] * 4)));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (3 * 4), wuffs_base__peek_u32le__no_bounds_check(\n                         dst_palette_ptr + ((size_t)s[3] * 4)));\n\n    s += loop_unroll_count * 1;\n    d += loop_unroll_count * 4;\n    n -= loop_unroll_count;\n  }\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__peek_u32le__no_bounds_check(\n                         dst_palette_ptr + ((size_t)s[0] * 4)));\n\n    s += 1 * 1;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len" +
-	") {\n  if (dst_palette_len !=\n      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n    return 0;\n  }\n  size_t dst_len4 = dst_len / 4;\n  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  const size_t loop_unroll_count = 4;\n\n  while (n >= loop_unroll_count) {\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +\n                                                          ((size_t)s[0] * 4));\n    if (s0) {\n      wuffs_base__poke_u32le__no_bounds_check(d + (0 * 4), s0);\n    }\n    uint32_t s1 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +\n                                                          ((size_t)s[1] * 4));\n    if (s1) {\n      wuffs_base__poke_u32le__no_bounds_check(d + (1 * 4), s1);\n    }\n    uint32_t s2 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +\n                                                          ((size_t)s[2] * 4));\n    if (s2) {\n      wuffs_base__poke_u32le" +
-	"__no_bounds_check(d + (2 * 4), s2);\n    }\n    uint32_t s3 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +\n                                                          ((size_t)s[3] * 4));\n    if (s3) {\n      wuffs_base__poke_u32le__no_bounds_check(d + (3 * 4), s3);\n    }\n\n    s += loop_unroll_count * 1;\n    d += loop_unroll_count * 4;\n    n -= loop_unroll_count;\n  }\n\n  while (n >= 1) {\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +\n                                                          ((size_t)s[0] * 4));\n    if (s0) {\n      wuffs_base__poke_u32le__no_bounds_check(d + (0 * 4), s0);\n    }\n\n    s += 1 * 1;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_sse42\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxx__y__sse42(uint8_t* dst_ptr,\n                                           size_t dst_len,\n                                    " +
-	"       uint8_t* dst_palette_ptr,\n                                           size_t dst_palette_len,\n                                           const uint8_t* src_ptr,\n                                           size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  __m128i shuffle = _mm_set_epi8(+0x03, +0x03, +0x03, +0x03,  //\n                                 +0x02, +0x02, +0x02, +0x02,  //\n                                 +0x01, +0x01, +0x01, +0x01,  //\n                                 +0x00, +0x00, +0x00, +0x00);\n  __m128i or_ff = _mm_set_epi8(-0x01, +0x00, +0x00, +0x00,  //\n                               -0x01, +0x00, +0x00, +0x00,  //\n                               -0x01, +0x00, +0x00, +0x00,  //\n                               -0x01, +0x00, +0x00, +0x00);\n\n  while (n >= 4) {\n    __m128i x;\n    x = _mm_cvtsi32_si128((int)(wuffs_base__peek_u32le__no_bounds_check(s)));\n    x = _mm_s" +
-	"huffle_epi8(x, shuffle);\n    x = _mm_or_si128(x, or_ff);\n    _mm_storeu_si128((__m128i*)(void*)d, x);\n\n    s += 4 * 1;\n    d += 4 * 4;\n    n -= 4;\n  }\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), 0xFF000000 | (0x010101 * (uint32_t)s[0]));\n\n    s += 1 * 1;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_sse42\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxx__y(uint8_t* dst_ptr,\n                                    size_t dst_len,\n                                    uint8_t* dst_palette_ptr,\n                                    size_t dst_palette_len,\n                                    const uint8_t* src_ptr,\n                                    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_ch" +
-	"eck(\n        d + (0 * 4), 0xFF000000 | (0x010101 * (uint32_t)s[0]));\n\n    s += 1 * 1;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxx__y_16be(uint8_t* dst_ptr,\n                                         size_t dst_len,\n                                         uint8_t* dst_palette_ptr,\n                                         size_t dst_palette_len,\n                                         const uint8_t* src_ptr,\n                                         size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len2 = src_len / 2;\n  size_t len = (dst_len4 < src_len2) ? dst_len4 : src_len2;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), 0xFF000000 | (0x010101 * (uint32_t)s[0]));\n\n    s += 1 * 2;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n" +
+	"// --------\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_sse42\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// wuffs_base__pixel_swizzler__transpose_palette16__sse42 splits the first 16\n// (4 bytes per entry) palette entries into four 16-byte tables, one per\n// channel, for use as _mm_shuffle_epi8 lookup tables.\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2\")\nstatic inline void  //\nwuffs_base__pixel_swizzler__transpose_palette16__sse42(\n    __m128i* tab_b,\n    __m128i* tab_g,\n    __m128i* tab_r,\n    __m128i* tab_a,\n    const uint8_t* palette_ptr) {\n  __m128i shuffle = _mm_set_epi8(+0x0F, +0x0B, +0x07, +0x03,  //\n                                 +0x0E, +0x0A, +0x06, +0x02,  //\n                                 +0x0D, +0x09, +0x05, +0x01,  //\n                                 +0x0C, +0x08, +0x04, +0x00);\n  // Each qi holds entries (4*i) to (4*i + 3), grouped by channel.\n  __m128i q0 = _mm_shuffle_epi8(\n      _mm_lddqu_si128((const __m128i*)(const void*)(palette_ptr + 0x00)),\n      shuffle);\n  __m128i q1 = _mm_sh" +
+	"uffle_epi8(\n      _mm_lddqu_si128((const __m128i*)(const void*)(palette_ptr + 0x10)),\n      shuffle);\n  __m128i q2 = _mm_shuffle_epi8(\n      _mm_lddqu_si128((const __m128i*)(const void*)(palette_ptr + 0x20)),\n      shuffle);\n  __m128i q3 = _mm_shuffle_epi8(\n      _mm_lddqu_si128((const __m128i*)(const void*)(palette_ptr + 0x30)),\n      shuffle);\n  __m128i bg01 = _mm_unpacklo_epi32(q0, q1);\n  __m128i ra01 = _mm_unpackhi_epi32(q0, q1);\n  __m128i bg23 = _mm_unpacklo_epi32(q2, q3);\n  __m128i ra23 = _mm_unpackhi_epi32(q2, q3);\n  *tab_b = _mm_unpacklo_epi64(bg01, bg23);\n  *tab_g = _mm_unpackhi_epi64(bg01, bg23);\n  *tab_r = _mm_unpacklo_epi64(ra01, ra23);\n  *tab_a = _mm_unpackhi_epi64(ra01, ra23);\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_sse42\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_avx2\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// wuffs_base__pixel_swizzler__transpose_palette16__avx2 is like the sse42\n// version but repeats each table in both 128-bit lanes.\nWUFFS_BASE__M" +
+	"AYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2\")\nstatic inline void  //\nwuffs_base__pixel_swizzler__transpose_palette16__avx2(\n    __m256i* tabs,\n    const uint8_t* palette_ptr) {\n  __m128i tab_b;\n  __m128i tab_g;\n  __m128i tab_r;\n  __m128i tab_a;\n  wuffs_base__pixel_swizzler__transpose_palette16__sse42(\n      &tab_b, &tab_g, &tab_r, &tab_a, palette_ptr);\n  tabs[0] = _mm256_broadcastsi128_si256(tab_b);\n  tabs[1] = _mm256_broadcastsi128_si256(tab_g);\n  tabs[2] = _mm256_broadcastsi128_si256(tab_r);\n  tabs[3] = _mm256_broadcastsi128_si256(tab_a);\n}\n\n// wuffs_base__pixel_swizzler__lookup_palette16__avx2 looks up 32 indexes,\n// each below 16, in the transposed palette tabs. It sets x[0] to the 4-byte\n// pixels for indexes 0 to 7, x[1] for indexes 8 to 15 and so on.\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2\")\nstatic inline void  //\nwuffs_base__pixel_swizzler__lookup_palette16__avx2(__m256i* x,\n                                                   const __m256i* tabs,\n                             " +
+	"                      __m256i indexes) {\n  __m256i b = _mm256_shuffle_epi8(tabs[0], indexes);\n  __m256i g = _mm256_shuffle_epi8(tabs[1], indexes);\n  __m256i r = _mm256_shuffle_epi8(tabs[2], indexes);\n  __m256i a = _mm256_shuffle_epi8(tabs[3], indexes);\n  __m256i bg_lo = _mm256_unpacklo_epi8(b, g);\n  __m256i bg_hi = _mm256_unpackhi_epi8(b, g);\n  __m256i ra_lo = _mm256_unpacklo_epi8(r, a);\n  __m256i ra_hi = _mm256_unpackhi_epi8(r, a);\n  // Each 128-bit lane is unpacked separately, so x0 holds pixels 0..3 and\n  // 16..19, x1 holds 4..7 and 20..23, and so on.\n  __m256i x0 = _mm256_unpacklo_epi16(bg_lo, ra_lo);\n  __m256i x1 = _mm256_unpackhi_epi16(bg_lo, ra_lo);\n  __m256i x2 = _mm256_unpacklo_epi16(bg_hi, ra_hi);\n  __m256i x3 = _mm256_unpackhi_epi16(bg_hi, ra_hi);\n  x[0] = _mm256_permute2x128_si256(x0, x1, 0x20);\n  x[1] = _mm256_permute2x128_si256(x2, x3, 0x20);\n  x[2] = _mm256_permute2x128_si256(x0, x1, 0x31);\n  x[3] = _mm256_permute2x128_si256(x2, x3, 0x31);\n}\n\n// wuffs_base__pixel_swizzler__lookup_palette256__a" +
+	"vx2 is like\n// wuffs_base__pixel_swizzler__lookup_palette16__avx2 but the indexes can be\n// any value and palette points to all 256 entries.\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2\")\nstatic inline void  //\nwuffs_base__pixel_swizzler__lookup_palette256__avx2(__m256i* x,\n                                                    const int* palette,\n                                                    __m256i indexes) {\n  __m128i i_lo = _mm256_castsi256_si128(indexes);\n  __m128i i_hi = _mm256_extracti128_si256(indexes, 1);\n  x[0] = _mm256_i32gather_epi32(palette, _mm256_cvtepu8_epi32(i_lo), 4);\n  x[1] = _mm256_i32gather_epi32(\n      palette, _mm256_cvtepu8_epi32(_mm_srli_si128(i_lo, 8)), 4);\n  x[2] = _mm256_i32gather_epi32(palette, _mm256_cvtepu8_epi32(i_hi), 4);\n  x[3] = _mm256_i32gather_epi32(\n      palette, _mm256_cvtepu8_epi32(_mm_srli_si128(i_hi, 8)), 4);\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_avx2\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_avx2\n#if " +
+	"defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxx__index__src__avx2(uint8_t* dst_ptr,\n                                                   size_t dst_len,\n                                                   uint8_t* dst_palette_ptr,\n                                                   size_t dst_palette_len,\n                                                   const uint8_t* src_ptr,\n                                                   size_t src_len) {\n  if (dst_palette_len !=\n      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n    return 0;\n  }\n  size_t dst_len4 = dst_len / 4;\n  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // Runs of 32 indexes that are all below 16 (e.g. from 1, 2 or 4 bit PNGs\n  // or from GIFs with small palettes) are looked up with _mm256_shuffle_epi8\n  // in per-channel tables of the first 16 pa" +
+	"lette entries. Other runs use\n  // _mm256_i32gather_epi32 on the whole palette.\n  __m256i tabs[4];\n  wuffs_base__pixel_swizzler__transpose_palette16__avx2(tabs, dst_palette_ptr);\n  __m256i high_nibbles = _mm256_set1_epi8(-0x10);\n  const int* palette = (const int*)(const void*)dst_palette_ptr;\n\n  while (n >= 32) {\n    __m256i indexes = _mm256_lddqu_si256((const __m256i*)(const void*)s);\n\n    if (_mm256_testz_si256(indexes, high_nibbles)) {\n      __m256i x[4];\n      wuffs_base__pixel_swizzler__lookup_palette16__avx2(x, tabs, indexes);\n      _mm256_storeu_si256((__m256i*)(void*)(d + (0 * 4)), x[0]);\n      _mm256_storeu_si256((__m256i*)(void*)(d + (8 * 4)), x[1]);\n      _mm256_storeu_si256((__m256i*)(void*)(d + (16 * 4)), x[2]);\n      _mm256_storeu_si256((__m256i*)(void*)(d + (24 * 4)), x[3]);\n\n    } else {\n      __m256i x[4];\n      wuffs_base__pixel_swizzler__lookup_palette256__avx2(x, palette, indexes);\n      _mm256_storeu_si256((__m256i*)(void*)(d + (0 * 4)), x[0]);\n      _mm256_storeu_si256((__m256i*)(void*)(" +
+	"d + (8 * 4)), x[1]);\n      _mm256_storeu_si256((__m256i*)(void*)(d + (16 * 4)), x[2]);\n      _mm256_storeu_si256((__m256i*)(void*)(d + (24 * 4)), x[3]);\n    }\n\n    s += 32 * 1;\n    d += 32 * 4;\n    n -= 32;\n  }\n\n  while (n >= 8) {\n    __m256i x = _mm256_i32gather_epi32(\n        palette,\n        _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(\n            (int64_t)wuffs_base__peek_u64le__no_bounds_check(s))),\n        4);\n    _mm256_storeu_si256((__m256i*)(void*)d, x);\n\n    s += 8 * 1;\n    d += 8 * 4;\n    n -= 8;\n  }\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__peek_u32le__no_bounds_check(\n                         dst_palette_ptr + ((size_t)s[0] * 4)));\n\n    s += 1 * 1;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_avx2\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_sse42\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2\")\nstatic uint64_t  /" +
+	"/\nwuffs_base__pixel_swizzler__xxxx__index__src__sse42(uint8_t* dst_ptr,\n                                                    size_t dst_len,\n                                                    uint8_t* dst_palette_ptr,\n                                                    size_t dst_palette_len,\n                                                    const uint8_t* src_ptr,\n                                                    size_t src_len) {\n  if (dst_palette_len !=\n      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n    return 0;\n  }\n  size_t dst_len4 = dst_len / 4;\n  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // Runs of 16 indexes that are all below 16 are looked up with\n  // _mm_shuffle_epi8 in per-channel tables of the first 16 palette entries.\n  // Other runs fall back to one lookup per pixel.\n  __m128i tab_b;\n  __m128i tab_g;\n  __m128i tab_r;\n  __m128i tab_a;\n  wuffs_base__pixel_swizzler__transpose_palette16__s" +
+	"se42(\n      &tab_b, &tab_g, &tab_r, &tab_a, dst_palette_ptr);\n  __m128i high_nibbles = _mm_set1_epi8(-0x10);\n\n  while (n >= 16) {\n    __m128i indexes = _mm_lddqu_si128((const __m128i*)(const void*)s);\n\n    if (_mm_testz_si128(indexes, high_nibbles)) {\n      __m128i b = _mm_shuffle_epi8(tab_b, indexes);\n      __m128i g = _mm_shuffle_epi8(tab_g, indexes);\n      __m128i r = _mm_shuffle_epi8(tab_r, indexes);\n      __m128i a = _mm_shuffle_epi8(tab_a, indexes);\n      __m128i bg_lo = _mm_unpacklo_epi8(b, g);\n      __m128i bg_hi = _mm_unpackhi_epi8(b, g);\n      __m128i ra_lo = _mm_unpacklo_epi8(r, a);\n      __m128i ra_hi = _mm_unpackhi_epi8(r, a);\n      _mm_storeu_si128((__m128i*)(void*)(d + (0 * 4)),\n                       _mm_unpacklo_epi16(bg_lo, ra_lo));\n      _mm_storeu_si128((__m128i*)(void*)(d + (4 * 4)),\n                       _mm_unpackhi_epi16(bg_lo, ra_lo));\n      _mm_storeu_si128((__m128i*)(void*)(d + (8 * 4)),\n                       _mm_unpacklo_epi16(bg_hi, ra_hi));\n      _mm_storeu_si128((__m128i*)(voi" +
+	"d*)(d + (12 * 4)),\n                       _mm_unpackhi_epi16(bg_hi, ra_hi));\n\n    } else {\n      size_t i;\n      for (i = 0; i < 16; i += 4) {\n        wuffs_base__poke_u32le__no_bounds_check(\n            d + ((i + 0) * 4), wuffs_base__peek_u32le__no_bounds_check(\n                                   dst_palette_ptr + ((size_t)s[i + 0] * 4)));\n        wuffs_base__poke_u32le__no_bounds_check(\n            d + ((i + 1) * 4), wuffs_base__peek_u32le__no_bounds_check(\n                                   dst_palette_ptr + ((size_t)s[i + 1] * 4)));\n        wuffs_base__poke_u32le__no_bounds_check(\n            d + ((i + 2) * 4), wuffs_base__peek_u32le__no_bounds_check(\n                                   dst_palette_ptr + ((size_t)s[i + 2] * 4)));\n        wuffs_base__poke_u32le__no_bounds_check(\n            d + ((i + 3) * 4), wuffs_base__peek_u32le__no_bounds_check(\n                                   dst_palette_ptr + ((size_t)s[i + 3] * 4)));\n      }\n    }\n\n    s += 16 * 1;\n    d += 16 * 4;\n    n -= 16;\n  }\n\n  while (n >= " +
+	"1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__peek_u32le__no_bounds_check(\n                         dst_palette_ptr + ((size_t)s[0] * 4)));\n\n    s += 1 * 1;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_sse42\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxx__index__src(uint8_t* dst_ptr,\n                                             size_t dst_len,\n                                             uint8_t* dst_palette_ptr,\n                                             size_t dst_palette_len,\n                                             const uint8_t* src_ptr,\n                                             size_t src_len) {\n  if (dst_palette_len !=\n      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n    return 0;\n  }\n  size_t dst_len4 = dst_len / 4;\n  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n " +
+	" const size_t loop_unroll_count = 4;\n\n  while (n >= loop_unroll_count) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__peek_u32le__no_bounds_check(\n                         dst_palette_ptr + ((size_t)s[0] * 4)));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (1 * 4), wuffs_base__peek_u32le__no_bounds_check(\n                         dst_palette_ptr + ((size_t)s[1] * 4)));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (2 * 4), wuffs_base__peek_u32le__no_bounds_check(\n                         dst_palette_ptr + ((size_t)s[2] * 4)));\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (3 * 4), wuffs_base__peek_u32le__no_bounds_check(\n                         dst_palette_ptr + ((size_t)s[3] * 4)));\n\n    s += loop_unroll_count * 1;\n    d += loop_unroll_count * 4;\n    n -= loop_unroll_count;\n  }\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), wuffs_base__peek_u32le__no_bounds_check(\n                         dst_palette_pt" +
+	"r + ((size_t)s[0] * 4)));\n\n    s += 1 * 1;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_avx2\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over__avx2(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  if (dst_palette_len !=\n      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n    return 0;\n  }\n  size_t dst_len4 = dst_len / 4;\n  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  // Palette lookups are as per\n  // wuffs_base__pixel_swizzler__xxxx__index__src__avx2.\n  __m256i tabs[4];\n  wuffs_base__pixel_swizzler__transpose_palette16__avx2(tabs, dst_palette_ptr);\n  const int* palette = (const int*)(const void*)dst_palette_ptr;\n  __m256i high_nibb" +
+	"les = _mm256_set1_epi8(-0x10);\n  __m256i zero = _mm256_setzero_si256();\n\n  while (n >= 32) {\n    __m256i indexes = _mm256_lddqu_si256((const __m256i*)(const void*)s);\n\n    __m256i x[4];\n    if (_mm256_testz_si256(indexes, high_nibbles)) {\n      wuffs_base__pixel_swizzler__lookup_palette16__avx2(x, tabs, indexes);\n    } else {\n      wuffs_base__pixel_swizzler__lookup_palette256__avx2(x, palette, indexes);\n    }\n\n    size_t i;\n    for (i = 0; i < 4; i++) {\n      // Keep the dst pixel wherever the palette entry is all zeroes.\n      __m256i keep = _mm256_cmpeq_epi32(x[i], zero);\n      __m256i y =\n          _mm256_lddqu_si256((const __m256i*)(const void*)(d + (i * 32)));\n      _mm256_storeu_si256((__m256i*)(void*)(d + (i * 32)),\n                          _mm256_blendv_epi8(x[i], y, keep));\n    }\n\n    s += 32 * 1;\n    d += 32 * 4;\n    n -= 32;\n  }\n\n  while (n >= 1) {\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +\n                                                          ((size_t)s[0] * " +
+	"4));\n    if (s0) {\n      wuffs_base__poke_u32le__no_bounds_check(d + (0 * 4), s0);\n    }\n\n    s += 1 * 1;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_avx2\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  if (dst_palette_len !=\n      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n    return 0;\n  }\n  size_t dst_len4 = dst_len / 4;\n  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  const size_t loop_unroll_count = 4;\n\n  while (n >= loop_unroll_count) {\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +\n                                                          ((size_t)s[0] * 4));\n    if (s0) {\n      wuffs_base__poke_u32le_" +
+	"_no_bounds_check(d + (0 * 4), s0);\n    }\n    uint32_t s1 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +\n                                                          ((size_t)s[1] * 4));\n    if (s1) {\n      wuffs_base__poke_u32le__no_bounds_check(d + (1 * 4), s1);\n    }\n    uint32_t s2 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +\n                                                          ((size_t)s[2] * 4));\n    if (s2) {\n      wuffs_base__poke_u32le__no_bounds_check(d + (2 * 4), s2);\n    }\n    uint32_t s3 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +\n                                                          ((size_t)s[3] * 4));\n    if (s3) {\n      wuffs_base__poke_u32le__no_bounds_check(d + (3 * 4), s3);\n    }\n\n    s += loop_unroll_count * 1;\n    d += loop_unroll_count * 4;\n    n -= loop_unroll_count;\n  }\n\n  while (n >= 1) {\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +\n                                                          ((size_t)s[0] *" +
+	" 4));\n    if (s0) {\n      wuffs_base__poke_u32le__no_bounds_check(d + (0 * 4), s0);\n    }\n\n    s += 1 * 1;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_avx2\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxx__y__avx2(uint8_t* dst_ptr,\n                                          size_t dst_len,\n                                          uint8_t* dst_palette_ptr,\n                                          size_t dst_palette_len,\n                                          const uint8_t* src_ptr,\n                                          size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  __m256i shuffle = _mm256_set_epi8(-0x01, +0x07, +0x07, +0x07,  //\n                                    -0x01, +0x06, +0x06, +0x06,  //\n                     " +
+	"               -0x01, +0x05, +0x05, +0x05,  //\n                                    -0x01, +0x04, +0x04, +0x04,  //\n                                    -0x01, +0x03, +0x03, +0x03,  //\n                                    -0x01, +0x02, +0x02, +0x02,  //\n                                    -0x01, +0x01, +0x01, +0x01,  //\n                                    -0x01, +0x00, +0x00, +0x00);\n  __m256i or_ff = _mm256_set1_epi32(-0x01000000);\n\n  while (n >= 8) {\n    __m256i x;\n    x = _mm256_set1_epi64x(\n        (int64_t)wuffs_base__peek_u64le__no_bounds_check(s + (0 * 1)));\n    x = _mm256_shuffle_epi8(x, shuffle);\n    x = _mm256_or_si256(x, or_ff);\n    _mm256_storeu_si256((__m256i*)(void*)d, x);\n\n    s += 8 * 1;\n    d += 8 * 4;\n    n -= 8;\n  }\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), 0xFF000000 | (0x010101 * (uint32_t)s[0]));\n\n    s += 1 * 1;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_a" +
+	"vx2\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_sse42\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxx__y__sse42(uint8_t* dst_ptr,\n                                           size_t dst_len,\n                                           uint8_t* dst_palette_ptr,\n                                           size_t dst_palette_len,\n                                           const uint8_t* src_ptr,\n                                           size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  __m128i shuffle = _mm_set_epi8(+0x03, +0x03, +0x03, +0x03,  //\n                                 +0x02, +0x02, +0x02, +0x02,  //\n                                 +0x01, +0x01, +0x01, +0x01,  //\n                                 +0x00, +0x00, +0x00, +0x00);\n  __m128i or_ff = _mm_set_epi8(-0x01, +0x00, +0x00" +
+	", +0x00,  //\n                               -0x01, +0x00, +0x00, +0x00,  //\n                               -0x01, +0x00, +0x00, +0x00,  //\n                               -0x01, +0x00, +0x00, +0x00);\n\n  while (n >= 4) {\n    __m128i x;\n    x = _mm_cvtsi32_si128((int)(wuffs_base__peek_u32le__no_bounds_check(s)));\n    x = _mm_shuffle_epi8(x, shuffle);\n    x = _mm_or_si128(x, or_ff);\n    _mm_storeu_si128((__m128i*)(void*)d, x);\n\n    s += 4 * 1;\n    d += 4 * 4;\n    n -= 4;\n  }\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), 0xFF000000 | (0x010101 * (uint32_t)s[0]));\n\n    s += 1 * 1;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_sse42\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxx__y(uint8_t* dst_ptr,\n                                    size_t dst_len,\n                                    uint8_t* dst_palette_ptr,\n                                    size_t dst_palette_len,\n            " +
+	"                        const uint8_t* src_ptr,\n                                    size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), 0xFF000000 | (0x010101 * (uint32_t)s[0]));\n\n    s += 1 * 1;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n// ‼ WUFFS MULTI-FILE SECTION +x86_avx2\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\nWUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2\")\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxx__y_16be__avx2(uint8_t* dst_ptr,\n                                               size_t dst_len,\n                                               uint8_t* dst_palette_ptr,\n                                               size_t dst_palette_len,\n                                               const uint8_t* src_ptr,\n                                               size_" +
+	"t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len2 = src_len / 2;\n  size_t len = (dst_len4 < src_len2) ? dst_len4 : src_len2;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  __m256i shuffle = _mm256_set_epi8(-0x01, +0x0E, +0x0E, +0x0E,  //\n                                    -0x01, +0x0C, +0x0C, +0x0C,  //\n                                    -0x01, +0x0A, +0x0A, +0x0A,  //\n                                    -0x01, +0x08, +0x08, +0x08,  //\n                                    -0x01, +0x06, +0x06, +0x06,  //\n                                    -0x01, +0x04, +0x04, +0x04,  //\n                                    -0x01, +0x02, +0x02, +0x02,  //\n                                    -0x01, +0x00, +0x00, +0x00);\n  __m256i or_ff = _mm256_set1_epi32(-0x01000000);\n\n  while (n >= 8) {\n    __m256i x;\n    x = _mm256_broadcastsi128_si256(\n        _mm_lddqu_si128((const __m128i*)(const void*)s));\n    x = _mm256_shuffle_epi8(x, shuffle);\n    x = _mm256_or_si256(x, or_ff);\n    _mm256_stor" +
+	"eu_si256((__m256i*)(void*)d, x);\n\n    s += 8 * 2;\n    d += 8 * 4;\n    n -= 8;\n  }\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n        d + (0 * 4), 0xFF000000 | (0x010101 * (uint32_t)s[0]));\n\n    s += 1 * 2;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)\n// ‼ WUFFS MULTI-FILE SECTION -x86_avx2\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxx__y_16be(uint8_t* dst_ptr,\n                                         size_t dst_len,\n                                         uint8_t* dst_palette_ptr,\n                                         size_t dst_palette_len,\n                                         const uint8_t* src_ptr,\n                                         size_t src_len) {\n  size_t dst_len4 = dst_len / 4;\n  size_t src_len2 = src_len / 2;\n  size_t len = (dst_len4 < src_len2) ? dst_len4 : src_len2;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  while (n >= 1) {\n    wuffs_base__poke_u32le__no_bounds_check(\n" +
+	"        d + (0 * 4), 0xFF000000 | (0x010101 * (uint32_t)s[0]));\n\n    s += 1 * 2;\n    d += 1 * 4;\n    n -= 1;\n  }\n\n  return len;\n}\n\n" +
 	"" +
 	"// --------\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxxxxxx__index__src(uint8_t* dst_ptr,\n                                                 size_t dst_len,\n                                                 uint8_t* dst_palette_ptr,\n                                                 size_t dst_palette_len,\n                                                 const uint8_t* src_ptr,\n                                                 size_t src_len) {\n  if (dst_palette_len !=\n      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n    return 0;\n  }\n  size_t dst_len8 = dst_len / 8;\n  size_t len = (dst_len8 < src_len) ? dst_len8 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  while (n >= 1) {\n    wuffs_base__poke_u64le__no_bounds_check(\n        d + (0 * 8), wuffs_base__color_u32__as__color_u64(\n                         wuffs_base__peek_u32le__no_bounds_check(\n                             dst_palette_ptr + ((size_t)s[0] * 4))));\n\n    s += 1 * 1;\n    d += 1 * 8;\n    n -=" +
 	" 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxxxxxx__index_binary_alpha__src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    const uint8_t* src_ptr,\n    size_t src_len) {\n  if (dst_palette_len !=\n      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n    return 0;\n  }\n  size_t dst_len8 = dst_len / 8;\n  size_t len = (dst_len8 < src_len) ? dst_len8 : src_len;\n  uint8_t* d = dst_ptr;\n  const uint8_t* s = src_ptr;\n  size_t n = len;\n\n  while (n >= 1) {\n    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +\n                                                          ((size_t)s[0] * 4));\n    if (s0) {\n      wuffs_base__poke_u64le__no_bounds_check(\n          d + (0 * 8), wuffs_base__color_u32__as__color_u64(s0));\n    }\n\n    s += 1 * 1;\n    d += 1 * 8;\n    n -= 1;\n  }\n\n  return len;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__xxxxxxxx__y(uint8_t* dst_ptr,\n                                     " +
@@ -720,48 +788,59 @@ const BasePixConvSubmoduleC = "" +
 	"// --------\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__transparent_black_src(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    uint64_t num_pixels,\n    uint32_t dst_pixfmt_bytes_per_pixel) {\n  uint64_t n = ((uint64_t)dst_len) / dst_pixfmt_bytes_per_pixel;\n  if (n > num_pixels) {\n    n = num_pixels;\n  }\n  memset(dst_ptr, 0, ((size_t)(n * dst_pixfmt_bytes_per_pixel)));\n  return n;\n}\n\nstatic uint64_t  //\nwuffs_base__pixel_swizzler__transparent_black_src_over(\n    uint8_t* dst_ptr,\n    size_t dst_len,\n    uint8_t* dst_palette_ptr,\n    size_t dst_palette_len,\n    uint64_t num_pixels,\n    uint32_t dst_pixfmt_bytes_per_pixel) {\n  uint64_t n = ((uint64_t)dst_len) / dst_pixfmt_bytes_per_pixel;\n  if (n > num_pixels) {\n    n = num_pixels;\n  }\n  return n;\n}\n\n" +
 	"" +
 	"// --------\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__y(wuffs_base__pixel_swizzler* p,\n                                       wuffs_base__pixel_format dst_pixfmt,\n                                       wuffs_base__slice_u8 dst_palette,\n                                       wuffs_base__slice_u8 src_palette,\n                                       wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__Y:\n      return wuffs_base__pixel_swizzler__copy_1_1;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      return wuffs_base__pixel_swizzler__bgr_565__y;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      return wuffs_base__pixel_swizzler__xxx__y;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n    case WUFFS_BA" +
-	"SE__PIXEL_FORMAT__RGBA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n      if (wuffs_base__cpu_arch__have_x86_sse42()) {\n        return wuffs_base__pixel_swizzler__xxxx__y__sse42;\n      }\n#endif\n      return wuffs_base__pixel_swizzler__xxxx__y;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL_4X16LE:\n      return wuffs_base__pixel_swizzler__xxxxxxxx__y;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__y_16be(wuffs_base__pixel_swizzler* p,\n                                            wuffs_base__pixel_format dst_pixfmt,\n                                            wuffs_base__slice_u8 dst_palette,\n                                            wuffs_base__slice_u8 src_palette,\n                           " +
-	"                 wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__Y:\n      return wuffs_base__pixel_swizzler__y__y_16be;\n\n    case WUFFS_BASE__PIXEL_FORMAT__Y_16LE:\n      return wuffs_base__pixel_swizzler__y_16le__y_16be;\n\n    case WUFFS_BASE__PIXEL_FORMAT__Y_16BE:\n      return wuffs_base__pixel_swizzler__copy_2_2;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      return wuffs_base__pixel_swizzler__bgr_565__y_16be;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      return wuffs_base__pixel_swizzler__xxx__y_16be;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n      return wuffs_base__pixel_swizzler__xxx" +
-	"x__y_16be;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL_4X16LE:\n      return wuffs_base__pixel_swizzler__xxxxxxxx__y_16be;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__indexed__bgra_nonpremul(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_NONPREMUL:\n      if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n          WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__copy_1_1;\n      }\n      return NULL;" +
-	"\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          if (wuffs_base__pixel_swizzler__squash_align4_bgr_565_8888(\n                  dst_palette.ptr, dst_palette.len, src_palette.ptr,\n                  src_palette.len, true) !=\n              (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n            return NULL;\n          }\n          return wuffs_base__pixel_swizzler__bgr_565__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n              WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n            return NULL;\n          }\n          return wuffs_base__pixel_swizzler__bgr_565__index_bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          if (wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src(\n              " +
-	"    dst_palette.ptr, dst_palette.len, NULL, 0, src_palette.ptr,\n                  src_palette.len) !=\n              (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n            return NULL;\n          }\n          return wuffs_base__pixel_swizzler__xxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n              WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n            return NULL;\n          }\n          return wuffs_base__pixel_swizzler__xxx__index_bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n          WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__xxxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_O" +
-	"VER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__index_bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n          WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__xxxxxxxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__index_bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          if (wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src(\n                  dst_palette.ptr, dst_palette.len, NULL, 0, src_palette.ptr,\n                  src_palette.len) !=\n              (WUFFS_BASE__PIXEL_FORMAT__INDEXED__P" +
-	"ALETTE_BYTE_LENGTH / 4)) {\n            return NULL;\n          }\n          return wuffs_base__pixel_swizzler__xxxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n              WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n            return NULL;\n          }\n          return wuffs_base__pixel_swizzler__bgra_premul__index_bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      // TODO.\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      if (wuffs_base__pixel_swizzler__swap_rgbx_bgrx(\n              dst_palette.ptr, dst_palette.len, NULL, 0, src_palette.ptr,\n              src_palette.len) !=\n          (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__xxxx__index__src;\n        case WUFFS_BASE__PI" +
-	"XEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__index_bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          if (wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src(\n                  dst_palette.ptr, dst_palette.len, NULL, 0, src_palette.ptr,\n                  src_palette.len) !=\n              (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n            return NULL;\n          }\n          return wuffs_base__pixel_swizzler__xxxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          if (wuffs_base__pixel_swizzler__swap_rgbx_bgrx(\n                  dst_palette.ptr, dst_palette.len, NULL, 0, src_palette.ptr,\n                  src_palette.len) !=\n              (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n            return NULL;\n          }\n          return wuffs_base__pixel_swizzler__bgra_premul__ind" +
-	"ex_bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n      // TODO.\n      break;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__indexed__bgra_binary(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_BINARY:\n      if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n          WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__copy_1_1;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      if (wuff" +
-	"s_base__pixel_swizzler__squash_align4_bgr_565_8888(\n              dst_palette.ptr, dst_palette.len, src_palette.ptr,\n              src_palette.len, false) !=\n          (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr_565__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr_565__index_binary_alpha__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n          WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__xxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__xxx__index_binary_alpha__src_over;\n " +
-	"     }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n      if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n          WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__xxxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL_4X16LE:\n      if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n          WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_sw" +
-	"izzler__xxxxxxxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__xxxxxxxx__index_binary_alpha__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      if (wuffs_base__pixel_swizzler__swap_rgbx_bgrx(\n              dst_palette.ptr, dst_palette.len, NULL, 0, src_palette.ptr,\n              src_palette.len) !=\n          (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__xxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__xxx__index_binary_alpha__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n      if (wuffs_base__pixel_swizzler__swap_rgbx_bgrx(\n              dst_palette.ptr, dst_palette." +
-	"len, NULL, 0, src_palette.ptr,\n              src_palette.len) !=\n          (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__xxxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over;\n      }\n      return NULL;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__bgr_565(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      return wuffs_base__pixel_swizzler__copy_2_2;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      return wuffs_base__pixel_swizzler__bgr__bgr_565;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL" +
-	":\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n      return wuffs_base__pixel_swizzler__bgrw__bgr_565;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL_4X16LE:\n      return wuffs_base__pixel_swizzler__bgrw_4x16le__bgr_565;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n      return wuffs_base__pixel_swizzler__rgbw__bgr_565;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__bgr(wuffs_base__pixel_swizzler* p,\n                                         wuffs_base__pixel_format dst_pixfmt,\n                                         wuffs_base__slice_u8 dst_palette,\n                                         wuffs_base__slice_u8 src_palette,\n                                         " +
-	"wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      return wuffs_base__pixel_swizzler__bgr_565__bgr;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      return wuffs_base__pixel_swizzler__copy_3_3;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n      return wuffs_base__pixel_swizzler__bgrw__bgr;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL_4X16LE:\n      return wuffs_base__pixel_swizzler__bgrw_4x16le__bgr;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      return wuffs_base__pixel_swizzler__swap_rgb_bgr;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n      if (wuffs_base__cpu_arch" +
-	"__have_x86_sse42()) {\n        return wuffs_base__pixel_swizzler__bgrw__rgb__sse42;\n      }\n#endif\n      return wuffs_base__pixel_swizzler__bgrw__rgb;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__bgra_nonpremul(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr_565__bgra_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr_565__bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr__bgra_nonpremul__src;\n        case WUFFS_" +
-	"BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr__bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__copy_4_4;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__bgra_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_premul__b" +
-	"gra_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n      // TODO.\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      // TODO.\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_sse42()) {\n            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__swap_rgbx_bgrx;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__rgba_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          retur" +
-	"n wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n      // TODO.\n      break;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__bgra_nonpremul_4x16le(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr_565__bgra_nonpremul_4x16le__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr_565__bgra_nonpremul_4x16le__src_over;\n      }\n    " +
-	"  return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr__bgra_nonpremul_4x16le__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr__bgra_nonpremul_4x16le__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__bgra_nonpremul_4x16le__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__bgra_nonpremul_4x16le__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__copy_8_8;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x" +
-	"16le__bgra_nonpremul_4x16le__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n      // TODO.\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      // TODO.\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__rgba_nonpremul__bgra_nonpremul_4x16le__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__rgba_nonpremul__bgra_nonpremul_4x16le__src_over;\n      }\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT" +
-	"__RGBA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n      // TODO.\n      break;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__bgra_premul(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr_565__bgra_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n         " +
-	" return wuffs_base__pixel_swizzler__bgr_565__bgra_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr__bgra_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr__bgra_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__bgra_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__bgra_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__bgra_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__S" +
-	"RC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__bgra_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__copy_4_4;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__rgba_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__rgba_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_sse42()) {\n  " +
-	"          return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__swap_rgbx_bgrx;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__rgba_premul__src_over;\n      }\n      return NULL;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__bgrx(wuffs_base__pixel_swizzler* p,\n                                          wuffs_base__pixel_format dst_pixfmt,\n                                          wuffs_base__slice_u8 dst_palette,\n                                          wuffs_base__slice_u8 src_palette,\n                                          wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      return wuffs_base__pixel_swizzler__bgr_565__bgrx;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      return wuffs_base__pixel_swizzler__xxx__xxxx;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n " +
-	"   case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n      return wuffs_base__pixel_swizzler__bgrw__bgrx;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      return wuffs_base__pixel_swizzler__bgrw_4x16le__bgrx;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n      return wuffs_base__pixel_swizzler__copy_4_4;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      // TODO.\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n      return wuffs_base__pixel_swizzler__bgrw__rgbx;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__rgb(wuffs_base__pixel_swizzler* p,\n                                         wuffs_base__pixel_format dst_pixfmt,\n                                         wuffs_base__slice_u8 dst_palette,\n                                         wuffs_base__slice_u8 " +
-	"src_palette,\n                                         wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      return wuffs_base__pixel_swizzler__bgr_565__rgb;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      return wuffs_base__pixel_swizzler__swap_rgb_bgr;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n      if (wuffs_base__cpu_arch__have_x86_sse42()) {\n        return wuffs_base__pixel_swizzler__bgrw__rgb__sse42;\n      }\n#endif\n      return wuffs_base__pixel_swizzler__bgrw__rgb;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      return wuffs_base__pixel_swizzler__bgrw_4x16le__rgb;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      return wuffs_base__pixel_swizzler__copy_3_3;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_" +
-	"PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n      return wuffs_base__pixel_swizzler__bgrw__bgr;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__rgba_nonpremul(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr_565__rgba_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr_565__rgba_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr__rgba_nonpremul__src;\n        case WUFFS_B" +
-	"ASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr__rgba_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_sse42()) {\n            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__swap_rgbx_bgrx;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__rgba_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__rgba_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__rgba_nonpremul__src_over;\n      }\n " +
-	"     return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n      // TODO.\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      // TODO.\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__copy_4_4;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return" +
-	" wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n      // TODO.\n      break;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__rgba_premul(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr_565__rgba_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr_565__rgba_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_" +
-	"BASE__PIXEL_FORMAT__BGR:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr__rgba_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr__rgba_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__rgba_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__rgba_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__rgba_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__rgba_premul__src_over;\n      }\n   " +
-	"   return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_sse42()) {\n            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__swap_rgbx_bgrx;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__rgba_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__bgra_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__bgra_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return w" +
-	"uffs_base__pixel_swizzler__copy_4_4;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over;\n      }\n      return NULL;\n  }\n  return NULL;\n}\n\n" +
-	"" +
-	"// --------\n\nWUFFS_BASE__MAYBE_STATIC wuffs_base__status  //\nwuffs_base__pixel_swizzler__prepare(wuffs_base__pixel_swizzler* p,\n                                    wuffs_base__pixel_format dst_pixfmt,\n                                    wuffs_base__slice_u8 dst_palette,\n                                    wuffs_base__pixel_format src_pixfmt,\n                                    wuffs_base__slice_u8 src_palette,\n                                    wuffs_base__pixel_blend blend) {\n  if (!p) {\n    return wuffs_base__make_status(wuffs_base__error__bad_receiver);\n  }\n  p->private_impl.func = NULL;\n  p->private_impl.transparent_black_func = NULL;\n  p->private_impl.dst_pixfmt_bytes_per_pixel = 0;\n  p->private_impl.src_pixfmt_bytes_per_pixel = 0;\n\n  wuffs_base__pixel_swizzler__func func = NULL;\n  wuffs_base__pixel_swizzler__transparent_black_func transparent_black_func =\n      NULL;\n\n  uint32_t dst_pixfmt_bits_per_pixel =\n      wuffs_base__pixel_format__bits_per_pixel(&dst_pixfmt);\n  if ((dst_pixfmt_bits_per_pixel == " +
-	"0) ||\n      ((dst_pixfmt_bits_per_pixel & 7) != 0)) {\n    return wuffs_base__make_status(\n        wuffs_base__error__unsupported_pixel_swizzler_option);\n  }\n\n  uint32_t src_pixfmt_bits_per_pixel =\n      wuffs_base__pixel_format__bits_per_pixel(&src_pixfmt);\n  if ((src_pixfmt_bits_per_pixel == 0) ||\n      ((src_pixfmt_bits_per_pixel & 7) != 0)) {\n    return wuffs_base__make_status(\n        wuffs_base__error__unsupported_pixel_swizzler_option);\n  }\n\n  // TODO: support many more formats.\n\n  switch (blend) {\n    case WUFFS_BASE__PIXEL_BLEND__SRC:\n      transparent_black_func =\n          wuffs_base__pixel_swizzler__transparent_black_src;\n      break;\n\n    case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n      transparent_black_func =\n          wuffs_base__pixel_swizzler__transparent_black_src_over;\n      break;\n  }\n\n  switch (src_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__Y:\n      func = wuffs_base__pixel_swizzler__prepare__y(p, dst_pixfmt, dst_palette,\n                                                    src_palette" +
-	", blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__Y_16BE:\n      func = wuffs_base__pixel_swizzler__prepare__y_16be(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_NONPREMUL:\n      func = wuffs_base__pixel_swizzler__prepare__indexed__bgra_nonpremul(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_BINARY:\n      func = wuffs_base__pixel_swizzler__prepare__indexed__bgra_binary(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      func = wuffs_base__pixel_swizzler__prepare__bgr_565(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      func = wuffs_base__pixel_swizzler__prepare__bgr(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      func = wuffs_ba" +
-	"se__pixel_swizzler__prepare__bgra_nonpremul(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      func = wuffs_base__pixel_swizzler__prepare__bgra_nonpremul_4x16le(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n      func = wuffs_base__pixel_swizzler__prepare__bgra_premul(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n      func = wuffs_base__pixel_swizzler__prepare__bgrx(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      func = wuffs_base__pixel_swizzler__prepare__rgb(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      func = wuffs_base__pixel_swizzler__prepare__rgba_nonpremul(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n    " +
-	"  break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n      func = wuffs_base__pixel_swizzler__prepare__rgba_premul(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n  }\n\n  p->private_impl.func = func;\n  p->private_impl.transparent_black_func = transparent_black_func;\n  p->private_impl.dst_pixfmt_bytes_per_pixel = dst_pixfmt_bits_per_pixel / 8;\n  p->private_impl.src_pixfmt_bytes_per_pixel = src_pixfmt_bits_per_pixel / 8;\n  return wuffs_base__make_status(\n      func ? NULL : wuffs_base__error__unsupported_pixel_swizzler_option);\n}\n\nWUFFS_BASE__MAYBE_STATIC uint64_t  //\nwuffs_base__pixel_swizzler__limited_swizzle_u32_interleaved_from_reader(\n    const wuffs_base__pixel_swizzler* p,\n    uint32_t up_to_num_pixels,\n    wuffs_base__slice_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    const uint8_t** ptr_iop_r,\n    const uint8_t* io2_r) {\n  if (p && p->private_impl.func) {\n    const uint8_t* iop_r = *ptr_iop_r;\n    uint64_t src_len = wuffs_base__u64__min(\n        ((uint64_t)up_to_num_pi" +
-	"xels) *\n            ((uint64_t)p->private_impl.src_pixfmt_bytes_per_pixel),\n        ((uint64_t)(io2_r - iop_r)));\n    uint64_t n =\n        (*p->private_impl.func)(dst.ptr, dst.len, dst_palette.ptr,\n                                dst_palette.len, iop_r, (size_t)src_len);\n    *ptr_iop_r += n * p->private_impl.src_pixfmt_bytes_per_pixel;\n    return n;\n  }\n  return 0;\n}\n\nWUFFS_BASE__MAYBE_STATIC uint64_t  //\nwuffs_base__pixel_swizzler__swizzle_interleaved_from_reader(\n    const wuffs_base__pixel_swizzler* p,\n    wuffs_base__slice_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    const uint8_t** ptr_iop_r,\n    const uint8_t* io2_r) {\n  if (p && p->private_impl.func) {\n    const uint8_t* iop_r = *ptr_iop_r;\n    uint64_t src_len = ((uint64_t)(io2_r - iop_r));\n    uint64_t n =\n        (*p->private_impl.func)(dst.ptr, dst.len, dst_palette.ptr,\n                                dst_palette.len, iop_r, (size_t)src_len);\n    *ptr_iop_r += n * p->private_impl.src_pixfmt_bytes_per_pixel;\n    return n;\n  }\n  return 0;\n}\n\nWUF" +
-	"FS_BASE__MAYBE_STATIC uint64_t  //\nwuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(\n    const wuffs_base__pixel_swizzler* p,\n    wuffs_base__slice_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src) {\n  if (p && p->private_impl.func) {\n    return (*p->private_impl.func)(dst.ptr, dst.len, dst_palette.ptr,\n                                   dst_palette.len, src.ptr, src.len);\n  }\n  return 0;\n}\n\nWUFFS_BASE__MAYBE_STATIC uint64_t  //\nwuffs_base__pixel_swizzler__swizzle_interleaved_transparent_black(\n    const wuffs_base__pixel_swizzler* p,\n    wuffs_base__slice_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    uint64_t num_pixels) {\n  if (p && p->private_impl.transparent_black_func) {\n    return (*p->private_impl.transparent_black_func)(\n        dst.ptr, dst.len, dst_palette.ptr, dst_palette.len, num_pixels,\n        p->private_impl.dst_pixfmt_bytes_per_pixel);\n  }\n  return 0;\n}\n" +
+	"SE__PIXEL_FORMAT__RGBA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n      if (wuffs_base__cpu_arch__have_x86_avx2()) {\n        return wuffs_base__pixel_swizzler__xxxx__y__avx2;\n      }\n      if (wuffs_base__cpu_arch__have_x86_sse42()) {\n        return wuffs_base__pixel_swizzler__xxxx__y__sse42;\n      }\n#endif\n      return wuffs_base__pixel_swizzler__xxxx__y;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL_4X16LE:\n      return wuffs_base__pixel_swizzler__xxxxxxxx__y;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__y_16be(wuffs_base__pixel_swizzler* p,\n                                            wuffs_base__pixel_format dst_pixfmt,\n                                            wuffs_base__slice_u8 d" +
+	"st_palette,\n                                            wuffs_base__slice_u8 src_palette,\n                                            wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__Y:\n      return wuffs_base__pixel_swizzler__y__y_16be;\n\n    case WUFFS_BASE__PIXEL_FORMAT__Y_16LE:\n      return wuffs_base__pixel_swizzler__y_16le__y_16be;\n\n    case WUFFS_BASE__PIXEL_FORMAT__Y_16BE:\n      return wuffs_base__pixel_swizzler__copy_2_2;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      return wuffs_base__pixel_swizzler__bgr_565__y_16be;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      return wuffs_base__pixel_swizzler__xxx__y_16be;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n    case WUFFS_B" +
+	"ASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n      if (wuffs_base__cpu_arch__have_x86_avx2()) {\n        return wuffs_base__pixel_swizzler__xxxx__y_16be__avx2;\n      }\n#endif\n      return wuffs_base__pixel_swizzler__xxxx__y_16be;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL_4X16LE:\n      return wuffs_base__pixel_swizzler__xxxxxxxx__y_16be;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__indexed__bgra_nonpremul(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_NONPREMUL:\n      if (wuffs_base__slice_u8__c" +
+	"opy_from_slice(dst_palette, src_palette) !=\n          WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__copy_1_1;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          if (wuffs_base__pixel_swizzler__squash_align4_bgr_565_8888(\n                  dst_palette.ptr, dst_palette.len, src_palette.ptr,\n                  src_palette.len, true) !=\n              (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n            return NULL;\n          }\n          return wuffs_base__pixel_swizzler__bgr_565__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n              WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n            return NULL;\n          }\n          return wuffs" +
+	"_base__pixel_swizzler__bgr_565__index_bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          if (wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src(\n                  dst_palette.ptr, dst_palette.len, NULL, 0, src_palette.ptr,\n                  src_palette.len) !=\n              (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n            return NULL;\n          }\n          return wuffs_base__pixel_swizzler__xxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n              WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n            return NULL;\n          }\n          return wuffs_base__pixel_swizzler__xxx__index_bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      if (wuffs_base__slice_u8__copy_from_slice(dst_palett" +
+	"e, src_palette) !=\n          WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;\n          }\n          if (wuffs_base__cpu_arch__have_x86_sse42()) {\n            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__xxxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__index_bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n          WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIX" +
+	"EL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__xxxxxxxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__index_bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          if (wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src(\n                  dst_palette.ptr, dst_palette.len, NULL, 0, src_palette.ptr,\n                  src_palette.len) !=\n              (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n            return NULL;\n          }\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;\n          }\n          if (wuffs_base__cpu_arch__have_x86_sse42()) {\n            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;\n          }\n#endif\n          return w" +
+	"uffs_base__pixel_swizzler__xxxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n              WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n            return NULL;\n          }\n          return wuffs_base__pixel_swizzler__bgra_premul__index_bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      // TODO.\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      if (wuffs_base__pixel_swizzler__swap_rgbx_bgrx(\n              dst_palette.ptr, dst_palette.len, NULL, 0, src_palette.ptr,\n              src_palette.len) !=\n          (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;\n    " +
+	"      }\n          if (wuffs_base__cpu_arch__have_x86_sse42()) {\n            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__xxxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__index_bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          if (wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src(\n                  dst_palette.ptr, dst_palette.len, NULL, 0, src_palette.ptr,\n                  src_palette.len) !=\n              (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n            return NULL;\n          }\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;\n          }\n          if (wuffs_base__cpu_arch__" +
+	"have_x86_sse42()) {\n            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__xxxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          if (wuffs_base__pixel_swizzler__swap_rgbx_bgrx(\n                  dst_palette.ptr, dst_palette.len, NULL, 0, src_palette.ptr,\n                  src_palette.len) !=\n              (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n            return NULL;\n          }\n          return wuffs_base__pixel_swizzler__bgra_premul__index_bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n      // TODO.\n      break;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__indexed__bgra_binary(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  switch (ds" +
+	"t_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_BINARY:\n      if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n          WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__copy_1_1;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      if (wuffs_base__pixel_swizzler__squash_align4_bgr_565_8888(\n              dst_palette.ptr, dst_palette.len, src_palette.ptr,\n              src_palette.len, false) !=\n          (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr_565__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          r" +
+	"eturn wuffs_base__pixel_swizzler__bgr_565__index_binary_alpha__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n          WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__xxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__xxx__index_binary_alpha__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n      if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n          WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_" +
+	"64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;\n          }\n          if (wuffs_base__cpu_arch__have_x86_sse42()) {\n            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__xxxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over__avx2;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL_4X16LE:\n      if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=\n          WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {\n        return NULL;\n      }\n      switch (blend) {\n" +
+	"        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__xxxxxxxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__xxxxxxxx__index_binary_alpha__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      if (wuffs_base__pixel_swizzler__swap_rgbx_bgrx(\n              dst_palette.ptr, dst_palette.len, NULL, 0, src_palette.ptr,\n              src_palette.len) !=\n          (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__xxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__xxx__index_binary_alpha__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n      if (wuffs_b" +
+	"ase__pixel_swizzler__swap_rgbx_bgrx(\n              dst_palette.ptr, dst_palette.len, NULL, 0, src_palette.ptr,\n              src_palette.len) !=\n          (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {\n        return NULL;\n      }\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;\n          }\n          if (wuffs_base__cpu_arch__have_x86_sse42()) {\n            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__xxxx__index__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over__avx2;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__xxxx__index_binary_alp" +
+	"ha__src_over;\n      }\n      return NULL;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__bgr_565(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      return wuffs_base__pixel_swizzler__copy_2_2;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      return wuffs_base__pixel_swizzler__bgr__bgr_565;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n      return wuffs_base__pixel_swizzler__bgrw__bgr_565;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL_4X16LE:\n      return wuffs_base__pixel_swizzler__bgrw_4x16le__bgr_565;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA" +
+	"_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n      return wuffs_base__pixel_swizzler__rgbw__bgr_565;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__bgr(wuffs_base__pixel_swizzler* p,\n                                         wuffs_base__pixel_format dst_pixfmt,\n                                         wuffs_base__slice_u8 dst_palette,\n                                         wuffs_base__slice_u8 src_palette,\n                                         wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      return wuffs_base__pixel_swizzler__bgr_565__bgr;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      return wuffs_base__pixel_swizzler__copy_3_3;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n    case WU" +
+	"FFS_BASE__PIXEL_FORMAT__BGRX:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n      if (wuffs_base__cpu_arch__have_x86_avx2()) {\n        return wuffs_base__pixel_swizzler__bgrw__bgr__avx2;\n      }\n#endif\n      return wuffs_base__pixel_swizzler__bgrw__bgr;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL_4X16LE:\n      return wuffs_base__pixel_swizzler__bgrw_4x16le__bgr;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      return wuffs_base__pixel_swizzler__swap_rgb_bgr;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n      if (wuffs_base__cpu_arch__have_x86_avx2()) {\n        return wuffs_base__pixel_swizzler__bgrw__rgb__avx2;\n      }\n      if (wuffs_base__cpu_arch__have_x86_sse42()) {\n        return wuffs_base__pixel_swizzler__bgrw__rgb__sse42;\n      }\n#endif\n      return wuffs_base__pi" +
+	"xel_swizzler__bgrw__rgb;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__bgra_nonpremul(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr_565__bgra_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr_565__bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr__bgra_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr__bgra_nonpremul__src_over;\n      }\n      return" +
+	" NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__copy_4_4;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__bgra_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src__avx2;\n" +
+	"          }\n#endif\n          return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n      // TODO.\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      // TODO.\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__avx2;\n          }\n          if (wuffs_base__cpu_arch__have_x86_sse42()) {\n            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__swap_rgbx_bgrx;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__p" +
+	"ixel_swizzler__bgra_nonpremul__rgba_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src__avx2;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n      // TODO.\n      break;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__bgra_nonpremul_4x16le(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 s" +
+	"rc_palette,\n    wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr_565__bgra_nonpremul_4x16le__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr_565__bgra_nonpremul_4x16le__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr__bgra_nonpremul_4x16le__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr__bgra_nonpremul_4x16le__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__bgra_nonpremul_4x16le__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_" +
+	"OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__bgra_nonpremul_4x16le__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__copy_8_8;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__bgra_nonpremul_4x16le__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src__avx2;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__s" +
+	"rc_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n      // TODO.\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      // TODO.\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__rgba_nonpremul__bgra_nonpremul_4x16le__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__rgba_nonpremul__bgra_nonpremul_4x16le__src_over;\n      }\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src__avx2;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src;\n        case WUFFS_B" +
+	"ASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n      // TODO.\n      break;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__bgra_premul(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr_565__bgra_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr_565__bgra_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      switch (blend) {\n        case WUFFS_BASE__PIX" +
+	"EL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr__bgra_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr__bgra_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__bgra_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__bgra_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__bgra_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__bgra_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n      switc" +
+	"h (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__copy_4_4;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__avx2;\n          }\n          if (wuffs_base__cpu_arch__have_x86_sse42()) {\n            return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__sse42;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__rgba_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__rgba_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB" +
+	"A_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__avx2;\n          }\n          if (wuffs_base__cpu_arch__have_x86_sse42()) {\n            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__swap_rgbx_bgrx;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__rgba_premul__src_over;\n      }\n      return NULL;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__bgrx(wuffs_base__pixel_swizzler* p,\n                                          wuffs_base__pixel_format dst_pixfmt,\n                                          wuffs_base__slice_u8 dst_palette,\n                                          wuffs_base__slice_u8 src_palette,\n                                      " +
+	"    wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      return wuffs_base__pixel_swizzler__bgr_565__bgrx;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      return wuffs_base__pixel_swizzler__xxx__xxxx;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n      if (wuffs_base__cpu_arch__have_x86_avx2()) {\n        return wuffs_base__pixel_swizzler__bgrw__bgrx__avx2;\n      }\n#endif\n      return wuffs_base__pixel_swizzler__bgrw__bgrx;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      return wuffs_base__pixel_swizzler__bgrw_4x16le__bgrx;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n      return wuffs_base__pixel_swizzler__copy_4_4;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      // TODO.\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n    case WUFFS" +
+	"_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n      return wuffs_base__pixel_swizzler__bgrw__rgbx;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__rgb(wuffs_base__pixel_swizzler* p,\n                                         wuffs_base__pixel_format dst_pixfmt,\n                                         wuffs_base__slice_u8 dst_palette,\n                                         wuffs_base__slice_u8 src_palette,\n                                         wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      return wuffs_base__pixel_swizzler__bgr_565__rgb;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      return wuffs_base__pixel_swizzler__swap_rgb_bgr;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n " +
+	"     if (wuffs_base__cpu_arch__have_x86_avx2()) {\n        return wuffs_base__pixel_swizzler__bgrw__rgb__avx2;\n      }\n      if (wuffs_base__cpu_arch__have_x86_sse42()) {\n        return wuffs_base__pixel_swizzler__bgrw__rgb__sse42;\n      }\n#endif\n      return wuffs_base__pixel_swizzler__bgrw__rgb;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      return wuffs_base__pixel_swizzler__bgrw_4x16le__rgb;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      return wuffs_base__pixel_swizzler__copy_3_3;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n      if (wuffs_base__cpu_arch__have_x86_avx2()) {\n        return wuffs_base__pixel_swizzler__bgrw__bgr__avx2;\n      }\n#endif\n      return wuffs_base__pixel_swizzler__bgrw__bgr;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__rgba" +
+	"_nonpremul(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr_565__rgba_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr_565__rgba_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr__rgba_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr__rgba_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if def" +
+	"ined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__avx2;\n          }\n          if (wuffs_base__cpu_arch__have_x86_sse42()) {\n            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__swap_rgbx_bgrx;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__rgba_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__rgba_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__rgba_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL" +
+	"_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src__avx2;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n      // TODO.\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      // TODO.\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__copy_4_4;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:" +
+	"\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src__avx2;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:\n    case WUFFS_BASE__PIXEL_FORMAT__RGBX:\n      // TODO.\n      break;\n  }\n  return NULL;\n}\n\nstatic wuffs_base__pixel_swizzler__func  //\nwuffs_base__pixel_swizzler__prepare__rgba_premul(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  switch (dst_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      switch (blend)" +
+	" {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr_565__rgba_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr_565__rgba_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgr__rgba_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgr__rgba_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__rgba_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__rgba_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      switch (bl" +
+	"end) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__rgba_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__rgba_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__avx2;\n          }\n          if (wuffs_base__cpu_arch__have_x86_sse42()) {\n            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__swap_rgbx_bgrx;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_premul__rgba_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      switch (b" +
+	"lend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__bgra_premul__src;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n          return wuffs_base__pixel_swizzler__bgra_nonpremul__bgra_premul__src_over;\n      }\n      return NULL;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n      switch (blend) {\n        case WUFFS_BASE__PIXEL_BLEND__SRC:\n          return wuffs_base__pixel_swizzler__copy_4_4;\n        case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n#if defined(WUFFS_BASE__CPU_ARCH__X86_64)\n          if (wuffs_base__cpu_arch__have_x86_avx2()) {\n            return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__avx2;\n          }\n          if (wuffs_base__cpu_arch__have_x86_sse42()) {\n            return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__sse42;\n          }\n#endif\n          return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over;\n      }\n      return NULL;\n  }\n  return NULL;\n}\n\n" +
+	"" +
+	"// --------\n\nWUFFS_BASE__MAYBE_STATIC wuffs_base__status  //\nwuffs_base__pixel_swizzler__prepare(wuffs_base__pixel_swizzler* p,\n                                    wuffs_base__pixel_format dst_pixfmt,\n                                    wuffs_base__slice_u8 dst_palette,\n                                    wuffs_base__pixel_format src_pixfmt,\n                                    wuffs_base__slice_u8 src_palette,\n                                    wuffs_base__pixel_blend blend) {\n  if (!p) {\n    return wuffs_base__make_status(wuffs_base__error__bad_receiver);\n  }\n  p->private_impl.func = NULL;\n  p->private_impl.transparent_black_func = NULL;\n  p->private_impl.dst_pixfmt_bytes_per_pixel = 0;\n  p->private_impl.src_pixfmt_bytes_per_pixel = 0;\n  p->private_impl.downscale_func = NULL;\n\n  wuffs_base__pixel_swizzler__func func = NULL;\n  wuffs_base__pixel_swizzler__transparent_black_func transparent_black_func =\n      NULL;\n\n  uint32_t dst_pixfmt_bits_per_pixel =\n      wuffs_base__pixel_format__bits_per_pixel(&dst_pixf" +
+	"mt);\n  if ((dst_pixfmt_bits_per_pixel == 0) ||\n      ((dst_pixfmt_bits_per_pixel & 7) != 0)) {\n    return wuffs_base__make_status(\n        wuffs_base__error__unsupported_pixel_swizzler_option);\n  }\n\n  uint32_t src_pixfmt_bits_per_pixel =\n      wuffs_base__pixel_format__bits_per_pixel(&src_pixfmt);\n  if ((src_pixfmt_bits_per_pixel == 0) ||\n      ((src_pixfmt_bits_per_pixel & 7) != 0)) {\n    return wuffs_base__make_status(\n        wuffs_base__error__unsupported_pixel_swizzler_option);\n  }\n\n  // TODO: support many more formats.\n\n  switch (blend) {\n    case WUFFS_BASE__PIXEL_BLEND__SRC:\n      transparent_black_func =\n          wuffs_base__pixel_swizzler__transparent_black_src;\n      break;\n\n    case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n      transparent_black_func =\n          wuffs_base__pixel_swizzler__transparent_black_src_over;\n      break;\n  }\n\n  switch (src_pixfmt.repr) {\n    case WUFFS_BASE__PIXEL_FORMAT__Y:\n      func = wuffs_base__pixel_swizzler__prepare__y(p, dst_pixfmt, dst_palette,\n                      " +
+	"                              src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__Y_16BE:\n      func = wuffs_base__pixel_swizzler__prepare__y_16be(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_NONPREMUL:\n      func = wuffs_base__pixel_swizzler__prepare__indexed__bgra_nonpremul(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_BINARY:\n      func = wuffs_base__pixel_swizzler__prepare__indexed__bgra_binary(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      func = wuffs_base__pixel_swizzler__prepare__bgr_565(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      func = wuffs_base__pixel_swizzler__prepare__bgr(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORM" +
+	"AT__BGRA_NONPREMUL:\n      func = wuffs_base__pixel_swizzler__prepare__bgra_nonpremul(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      func = wuffs_base__pixel_swizzler__prepare__bgra_nonpremul_4x16le(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n      func = wuffs_base__pixel_swizzler__prepare__bgra_premul(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__BGRX:\n      func = wuffs_base__pixel_swizzler__prepare__bgrx(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGB:\n      func = wuffs_base__pixel_swizzler__prepare__rgb(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      func = wuffs_base__pixel_swizzler__prepare__rgba_nonpremul(\n          p, dst_pixfm" +
+	"t, dst_palette, src_palette, blend);\n      break;\n\n    case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n      func = wuffs_base__pixel_swizzler__prepare__rgba_premul(\n          p, dst_pixfmt, dst_palette, src_palette, blend);\n      break;\n  }\n\n  p->private_impl.func = func;\n  p->private_impl.transparent_black_func = transparent_black_func;\n  p->private_impl.dst_pixfmt_bytes_per_pixel = dst_pixfmt_bits_per_pixel / 8;\n  p->private_impl.src_pixfmt_bytes_per_pixel = src_pixfmt_bits_per_pixel / 8;\n  return wuffs_base__make_status(\n      func ? NULL : wuffs_base__error__unsupported_pixel_swizzler_option);\n}\n\nWUFFS_BASE__MAYBE_STATIC wuffs_base__status  //\nwuffs_base__pixel_swizzler__prepare_downscaled(\n    wuffs_base__pixel_swizzler* p,\n    wuffs_base__pixel_format dst_pixfmt,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__pixel_format src_pixfmt,\n    wuffs_base__slice_u8 src_palette,\n    wuffs_base__pixel_blend blend) {\n  wuffs_base__pixel_format premul =\n      wuffs_base__make_pixel_format(WUFFS_BASE__PIXEL_FOR" +
+	"MAT__BGRA_PREMUL);\n\n  // The second half converts the averaged pixels to the dst pixel format.\n  wuffs_base__pixel_swizzler q;\n  wuffs_base__status status = wuffs_base__pixel_swizzler__prepare(\n      &q, dst_pixfmt, dst_palette, premul, wuffs_base__empty_slice_u8(),\n      blend);\n  if (status.repr) {\n    if (p) {\n      p->private_impl.func = NULL;\n      p->private_impl.downscale_func = NULL;\n    }\n    return status;\n  }\n\n  // The first half converts the src pixels to premultiplied BGRA, which can\n  // be summed channel by channel.\n  status = wuffs_base__pixel_swizzler__prepare(\n      p, premul, dst_palette, src_pixfmt, src_palette,\n      WUFFS_BASE__PIXEL_BLEND__SRC);\n  if (status.repr) {\n    return status;\n  }\n  p->private_impl.transparent_black_func = q.private_impl.transparent_black_func;\n  p->private_impl.dst_pixfmt_bytes_per_pixel =\n      q.private_impl.dst_pixfmt_bytes_per_pixel;\n  p->private_impl.downscale_func = q.private_impl.func;\n  return wuffs_base__make_status(NULL);\n}\n\nWUFFS_BASE__MAYBE_STATIC u" +
+	"int64_t  //\nwuffs_base__pixel_swizzler__swizzle_downscaled_from_slice(\n    const wuffs_base__pixel_swizzler* p,\n    wuffs_base__table_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 accum,\n    wuffs_base__slice_u8 src,\n    uint32_t shift,\n    uint32_t x,\n    uint32_t y,\n    uint32_t y0,\n    uint32_t y1) {\n  if (!p || !p->private_impl.func || !p->private_impl.downscale_func ||\n      (shift > 3) || (y < y0) || (y >= y1)) {\n    return 0;\n  }\n  size_t src_bytes_per_pixel = p->private_impl.src_pixfmt_bytes_per_pixel;\n  if (src_bytes_per_pixel == 0) {\n    return 0;\n  }\n  uint64_t n = src.len / src_bytes_per_pixel;\n  if ((n == 0) || (n > (((uint64_t)UINT32_MAX) - ((uint64_t)x)))) {\n    return 0;\n  }\n\n  // The source pixels are columns [x, x_end). They map to the destination\n  // columns [dx0, dx0 + num_dx). Rows [by0, by1) map to the destination row\n  // (y >> shift).\n  uint64_t x_end = ((uint64_t)x) + n;\n  uint64_t dx0 = ((uint64_t)x) >> shift;\n  uint64_t num_dx = ((x_end - 1) >> shift) + 1 -" +
+	" dx0;\n  if ((accum.len / 8) < num_dx) {\n    return 0;\n  }\n  uint64_t block_y = ((uint64_t)(y >> shift)) << shift;\n  uint64_t by0 = wuffs_base__u64__max(y0, block_y);\n  uint64_t by1 = wuffs_base__u64__min(y1, block_y + (1u << shift));\n  if (y == by0) {\n    memset(accum.ptr, 0, (size_t)(8 * num_dx));\n  }\n\n  // Convert the src pixels to premultiplied BGRA, a chunk at a time, and add\n  // them to the accumulators, which are pairs of little-endian bytes.\n  uint8_t buf[64 * 4];\n  const uint8_t* s = src.ptr;\n  uint64_t sx = x;\n  while (sx < x_end) {\n    size_t m = (size_t)(wuffs_base__u64__min(x_end - sx, 64));\n    (*p->private_impl.func)(buf, sizeof(buf), dst_palette.ptr, dst_palette.len,\n                            s, m * src_bytes_per_pixel);\n    size_t i;\n    for (i = 0; i < m; i++) {\n      uint8_t* a = accum.ptr + (8 * (((sx + i) >> shift) - dx0));\n      wuffs_base__poke_u16le__no_bounds_check(\n          a + 0, (uint16_t)(wuffs_base__peek_u16le__no_bounds_check(a + 0) +\n                            buf[(4 * i) +" +
+	" 0]));\n      wuffs_base__poke_u16le__no_bounds_check(\n          a + 2, (uint16_t)(wuffs_base__peek_u16le__no_bounds_check(a + 2) +\n                            buf[(4 * i) + 1]));\n      wuffs_base__poke_u16le__no_bounds_check(\n          a + 4, (uint16_t)(wuffs_base__peek_u16le__no_bounds_check(a + 4) +\n                            buf[(4 * i) + 2]));\n      wuffs_base__poke_u16le__no_bounds_check(\n          a + 6, (uint16_t)(wuffs_base__peek_u16le__no_bounds_check(a + 6) +\n                            buf[(4 * i) + 3]));\n    }\n    s += m * src_bytes_per_pixel;\n    sx += m;\n  }\n  if ((((uint64_t)y) + 1) != by1) {\n    return n;\n  }\n\n  // That was the block's last row. Divide the sums by the number of source\n  // pixels in each block (fewer at the edges) and convert to the dst format.\n  wuffs_base__slice_u8 row = wuffs_base__table_u8__row(dst, y >> shift);\n  uint64_t dst_bytes_per_pixel = p->private_impl.dst_pixfmt_bytes_per_pixel;\n  if ((dst_bytes_per_pixel == 0) ||\n      ((row.len / dst_bytes_per_pixel) <= dx0)) {" +
+	"\n    return n;\n  }\n  row.ptr += dx0 * dst_bytes_per_pixel;\n  row.len -= dx0 * dst_bytes_per_pixel;\n  uint64_t num_rows = by1 - by0;\n  uint64_t dx = 0;\n  while (dx < num_dx) {\n    size_t m = (size_t)(wuffs_base__u64__min(num_dx - dx, 64));\n    size_t i;\n    for (i = 0; i < m; i++) {\n      uint64_t cx = (dx0 + dx + i) << shift;\n      uint64_t num_cols =\n          wuffs_base__u64__min(x_end, cx + (1u << shift)) -\n          wuffs_base__u64__max(x, cx);\n      uint32_t count = (uint32_t)(num_cols * num_rows);\n      const uint8_t* a = accum.ptr + (8 * (dx + i));\n      buf[(4 * i) + 0] = (uint8_t)(\n          (wuffs_base__peek_u16le__no_bounds_check(a + 0) + (count / 2)) /\n          count);\n      buf[(4 * i) + 1] = (uint8_t)(\n          (wuffs_base__peek_u16le__no_bounds_check(a + 2) + (count / 2)) /\n          count);\n      buf[(4 * i) + 2] = (uint8_t)(\n          (wuffs_base__peek_u16le__no_bounds_check(a + 4) + (count / 2)) /\n          count);\n      buf[(4 * i) + 3] = (uint8_t)(\n          (wuffs_base__peek_u16le__no_b" +
+	"ounds_check(a + 6) + (count / 2)) /\n          count);\n    }\n    uint64_t k = (*p->private_impl.downscale_func)(\n        row.ptr, row.len, dst_palette.ptr, dst_palette.len, buf, 4 * m);\n    if (k < m) {\n      break;\n    }\n    row.ptr += k * dst_bytes_per_pixel;\n    row.len -= k * dst_bytes_per_pixel;\n    dx += k;\n  }\n  return n;\n}\n\nWUFFS_BASE__MAYBE_STATIC uint64_t  //\nwuffs_base__pixel_swizzler__limited_swizzle_u32_interleaved_from_reader(\n    const wuffs_base__pixel_swizzler* p,\n    uint32_t up_to_num_pixels,\n    wuffs_base__slice_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    const uint8_t** ptr_iop_r,\n    const uint8_t* io2_r) {\n  if (p && p->private_impl.func) {\n    const uint8_t* iop_r = *ptr_iop_r;\n    uint64_t src_len = wuffs_base__u64__min(\n        ((uint64_t)up_to_num_pixels) *\n            ((uint64_t)p->private_impl.src_pixfmt_bytes_per_pixel),\n        ((uint64_t)(io2_r - iop_r)));\n    uint64_t n =\n        (*p->private_impl.func)(dst.ptr, dst.len, dst_palette.ptr,\n                                d" +
+	"st_palette.len, iop_r, (size_t)src_len);\n    *ptr_iop_r += n * p->private_impl.src_pixfmt_bytes_per_pixel;\n    return n;\n  }\n  return 0;\n}\n\nWUFFS_BASE__MAYBE_STATIC uint64_t  //\nwuffs_base__pixel_swizzler__swizzle_interleaved_from_reader(\n    const wuffs_base__pixel_swizzler* p,\n    wuffs_base__slice_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    const uint8_t** ptr_iop_r,\n    const uint8_t* io2_r) {\n  if (p && p->private_impl.func) {\n    const uint8_t* iop_r = *ptr_iop_r;\n    uint64_t src_len = ((uint64_t)(io2_r - iop_r));\n    uint64_t n =\n        (*p->private_impl.func)(dst.ptr, dst.len, dst_palette.ptr,\n                                dst_palette.len, iop_r, (size_t)src_len);\n    *ptr_iop_r += n * p->private_impl.src_pixfmt_bytes_per_pixel;\n    return n;\n  }\n  return 0;\n}\n\nWUFFS_BASE__MAYBE_STATIC uint64_t  //\nwuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(\n    const wuffs_base__pixel_swizzler* p,\n    wuffs_base__slice_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    wuffs_base__slice_u8 sr" +
+	"c) {\n  if (p && p->private_impl.func) {\n    return (*p->private_impl.func)(dst.ptr, dst.len, dst_palette.ptr,\n                                   dst_palette.len, src.ptr, src.len);\n  }\n  return 0;\n}\n\nWUFFS_BASE__MAYBE_STATIC uint64_t  //\nwuffs_base__pixel_swizzler__swizzle_interleaved_transparent_black(\n    const wuffs_base__pixel_swizzler* p,\n    wuffs_base__slice_u8 dst,\n    wuffs_base__slice_u8 dst_palette,\n    uint64_t num_pixels) {\n  if (p && p->private_impl.transparent_black_func) {\n    return (*p->private_impl.transparent_black_func)(\n        dst.ptr, dst.len, dst_palette.ptr, dst_palette.len, num_pixels,\n        p->private_impl.dst_pixfmt_bytes_per_pixel);\n  }\n  return 0;\n}\n" +
 	""
 
 const BaseUTF8SubmoduleC = "" +
@@ -822,37 +901,189 @@ const AuxCborHh = "" +
 	";\n\n// DecodeCbor calls callbacks based on the CBOR-formatted data in input.\n//\n// On success, the returned error_message is empty and cursor_position counts\n// the number of bytes consumed. On failure, error_message is non-empty and\n// cursor_position is the location of the error. That error may be a content\n// error (invalid CBOR) or an input error (e.g. network failure).\nDecodeCborResult  //\nDecodeCbor(DecodeCborCallbacks& callbacks,\n           sync_io::Input& input,\n           wuffs_base__slice_u32 quirks = wuffs_base__empty_slice_u32());\n\n}  // namespace wuffs_aux\n" +
 	""
 
+const AuxDeflateCc = "" +
+	"// ---------------- Auxiliary - Deflate\n\n#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__AUX__DEFLATE)\n\n#include <thread>\n#include <utility>\n#include <vector>\n\n// WUFFS_AUX__DECODE_DEFLATE__CHUNK_LENGTH is the number of compressed bytes\n// that each thread starts with, when decoding in parallel.\n#ifndef WUFFS_AUX__DECODE_DEFLATE__CHUNK_LENGTH\n#define WUFFS_AUX__DECODE_DEFLATE__CHUNK_LENGTH (1024 * 1024)\n#endif\n\n// WUFFS_AUX__DECODE_DEFLATE__MAX_SPECULATIVE_LENGTH is the maximum number of\n// decoded bytes that each thread buffers, when decoding in parallel. Chunks\n// that decode to more than this are instead decoded single-threaded.\n#ifndef WUFFS_AUX__DECODE_DEFLATE__MAX_SPECULATIVE_LENGTH\n#define WUFFS_AUX__DECODE_DEFLATE__MAX_SPECULATIVE_LENGTH (64 * 1024 * 1024)\n#endif\n\n// WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH is the approximate maximum\n// number of decoded bytes, per thread, that DecodeGzipMembers buffers at a\n// time. Members that decode to more than this are decoded single-thr" +
+	"eaded.\n#ifndef WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH\n#define WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH (4 * 1024 * 1024)\n#endif\n\nnamespace wuffs_aux {\n\nDecodeDeflateResult::DecodeDeflateResult(std::string&& error_message0,\n                                         uint64_t num_dst_bytes0)\n    : error_message(std::move(error_message0)),\n      num_dst_bytes(num_dst_bytes0) {}\n\nDecodeDeflateCallbacks::~DecodeDeflateCallbacks() {}\n\nvoid  //\nDecodeDeflateCallbacks::Done(DecodeDeflateResult& result,\n                             sync_io::Input& input) {}\n\nconst char DecodeDeflate_BadChecksum[] =  //\n    \"wuffs_aux::DecodeDeflate: bad checksum\";\nconst char DecodeDeflate_BadHeader[] =  //\n    \"wuffs_aux::DecodeDeflate: bad header\";\nconst char DecodeDeflate_OutOfMemory[] =  //\n    \"wuffs_aux::DecodeDeflate: out of memory\";\nconst char DecodeDeflate_UnexpectedEndOfFile[] =  //\n    \"wuffs_aux::DecodeDeflate: unexpected end of file\";\nconst char DecodeDeflate_UnsupportedFraming[] =  //\n    \"wuffs_aux::DecodeDeflate" +
+	": unsupported framing\";\n\n" +
+	"" +
+	"// --------\n\nnamespace {\n\n// DecodeDeflateNoPosition is a sentinel bit position.\nconst uint64_t DecodeDeflateNoPosition = UINT64_MAX;\n\nconst size_t DecodeDeflateScratchLength = 65536;\n\n// DecodeDeflateFill reads more of the input into io_buf, returning an error\n// message (possibly DecodeDeflate_UnexpectedEndOfFile) if it cannot.\nstd::string  //\nDecodeDeflateFill(sync_io::Input& input, wuffs_base__io_buffer* io_buf) {\n  if (io_buf->meta.closed) {\n    return DecodeDeflate_UnexpectedEndOfFile;\n  }\n  io_buf->compact();\n  return input.CopyIn(io_buf);\n}\n\n// DecodeDeflateStream runs dec, reading from io_buf (refilled from input),\n// until dec reaches the end of its stream. The output goes through the dst\n// scratch buffer to callbacks.Append.\nstd::string  //\nDecodeDeflateStream(DecodeDeflateCallbacks& callbacks,\n                    sync_io::Input& input,\n                    wuffs_base__io_buffer* io_buf,\n                    wuffs_base__io_transformer* dec,\n                    wuffs_base__io_buffer* dst,\n           " +
+	"         uint64_t* num_dst_bytes) {\n  uint8_t work_array[1];\n  while (true) {\n    dst->meta.wi = 0;\n    wuffs_base__status status = dec->transform_io(\n        dst, io_buf, wuffs_base__make_slice_u8(work_array, 0));\n    if (dst->meta.wi > 0) {\n      std::string error_message =\n          callbacks.Append(dst->data.ptr, dst->meta.wi);\n      *num_dst_bytes += dst->meta.wi;\n      if (!error_message.empty()) {\n        return error_message;\n      }\n    }\n\n    if (status.is_ok()) {\n      return \"\";\n    } else if (status.repr == wuffs_base__suspension__short_read) {\n      std::string error_message = DecodeDeflateFill(input, io_buf);\n      if (!error_message.empty()) {\n        return error_message;\n      }\n    } else if (status.repr != wuffs_base__suspension__short_write) {\n      return status.message();\n    }\n  }\n}\n\nDecodeDeflateResult  //\nDecodeDeflateSerial(DecodeDeflateCallbacks& callbacks,\n                    sync_io::Input& input,\n                    uint32_t framing,\n                    bool ignore_checksum) {\n " +
+	" wuffs_base__io_transformer::unique_ptr dec(nullptr, &free);\n  switch (framing) {\n    case 0:\n      dec = wuffs_deflate__decoder::alloc_as__wuffs_base__io_transformer();\n      break;\n    case WUFFS_BASE__FOURCC__GZ:\n      dec = wuffs_gzip__decoder::alloc_as__wuffs_base__io_transformer();\n      break;\n    case WUFFS_BASE__FOURCC__ZLIB:\n      dec = wuffs_zlib__decoder::alloc_as__wuffs_base__io_transformer();\n      break;\n    default:\n      return DecodeDeflateResult(DecodeDeflate_UnsupportedFraming, 0);\n  }\n  if (!dec) {\n    return DecodeDeflateResult(DecodeDeflate_OutOfMemory, 0);\n  }\n  dec->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, ignore_checksum);\n\n  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();\n  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();\n  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);\n  if (!io_buf) {\n    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);\n    fallback_io_buf =\n        wuffs_base__ptr_u8__writer(fallback_io_ar" +
+	"ray.get(), 32768);\n    io_buf = &fallback_io_buf;\n  }\n\n  std::unique_ptr<uint8_t[]> dst_array(\n      new uint8_t[DecodeDeflateScratchLength]);\n  wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(\n      dst_array.get(), DecodeDeflateScratchLength);\n  uint64_t num_dst_bytes = 0;\n  std::string error_message = DecodeDeflateStream(\n      callbacks, input, io_buf, dec.get(), &dst, &num_dst_bytes);\n  return DecodeDeflateResult(std::move(error_message), num_dst_bytes);\n}\n\n// DecodeDeflateLooksLikeBlockStart returns the number of block boundaries\n// that DecodeDeflateTrialDecode should get through, if the bit position pos\n// is a plausible start of a stored or dynamic Huffman DEFLATE block, or zero\n// if it is not. Fixed Huffman blocks are not considered: their 3 bit header\n// is too short to distinguish them from random data.\n//\n// It is a cheap filter that rejects almost all bit positions, before trying\n// the more expensive DecodeDeflateTrialDecode.\nuint32_t  //\nDecodeDeflateLooksLikeBlockStart(const uint8_t* " +
+	"ptr,\n                                 size_t len,\n                                 uint64_t pos) {\n  size_t i = (size_t)(pos >> 3);\n  if ((len < 16) || (i > (len - 16))) {\n    return 0;\n  }\n  uint64_t bits = wuffs_base__peek_u64le__no_bounds_check(ptr + i) >> (pos & 7);\n  uint32_t type = (uint32_t)((bits >> 1) & 3);\n\n  if (type == 0) {\n    // A stored block: the LEN and NLEN fields start at the next byte boundary\n    // and should be each other's complement. Only consider the bit position\n    // just before that boundary. Earlier positions would be equivalent (the\n    // padding bits are typically zero) or misleading (treating the previous\n    // block's final bits as this block's header bits).\n    //\n    // With only a 16 bit check, some random data passes as a stored block,\n    // and a stored block's payload is not validated at all, so require the\n    // trial decode to get through more subsequent blocks.\n    if (((pos + 3) & 7) != 0) {\n      return 0;\n    }\n    uint32_t len_nlen =\n        wuffs_base__peek" +
+	"_u32le__no_bounds_check(ptr + ((pos + 3) >> 3));\n    return (((len_nlen ^ (len_nlen >> 16)) & 0xFFFF) == 0xFFFF) ? 8 : 0;\n\n  } else if (type != 2) {\n    return 0;\n  }\n\n  // A dynamic Huffman block: check HLIT, HDIST and that the (up to 19) 3-bit\n  // code lengths for the code length alphabet form a complete prefix code.\n  uint32_t hlit = (uint32_t)((bits >> 3) & 31);\n  uint32_t hdist = (uint32_t)((bits >> 8) & 31);\n  uint32_t hclen = (uint32_t)((bits >> 13) & 15) + 4;\n  if ((hlit > 29) || (hdist > 29)) {\n    return 0;\n  }\n  pos += 17;\n  uint64_t clens = wuffs_base__peek_u64le__no_bounds_check(ptr + (pos >> 3)) >>\n                   (pos & 7);\n  uint32_t kraft = 0;\n  for (uint32_t c = 0; c < hclen; c++) {\n    uint32_t n = (uint32_t)((clens >> (3 * c)) & 7);\n    if (n > 0) {\n      kraft += 128u >> n;\n    }\n  }\n  return (kraft == 128) ? 2 : 0;\n}\n\n// DecodeDeflateEquivalentStarts returns whether decoding from the bit\n// positions p and q are equivalent. Trivially, this is when (p == q), but a\n// stored block's he" +
+	"ader can also be ambiguous, since its padding bits can\n// also look like a stored block header.\nbool  //\nDecodeDeflateEquivalentStarts(const uint8_t* ptr,\n                              size_t len,\n                              uint64_t p,\n                              uint64_t q) {\n  if (p == q) {\n    return true;\n  } else if ((((p + 3 + 7) >> 3) != ((q + 3 + 7) >> 3)) ||\n             (((q + 3 + 7) >> 3) > len)) {\n    return false;\n  }\n  uint32_t p_header = (uint32_t)(\n      (wuffs_base__peek_u16le__no_bounds_check(ptr + (p >> 3)) >> (p & 7)) &\n      7);\n  uint32_t q_header = (uint32_t)(\n      (wuffs_base__peek_u16le__no_bounds_check(ptr + (q >> 3)) >> (q & 7)) &\n      7);\n  return (p_header == q_header) && ((p_header >> 1) == 0);\n}\n\n// DecodeDeflateState holds the read-only state shared by the threads.\nstruct DecodeDeflateState {\n  DecodeDeflateState(const uint8_t* ptr0, size_t len0);\n\n  const uint8_t* ptr;\n  size_t len;\n\n  // history_a, history_b and history_z are placeholder histories. The real\n  // histor" +
+	"y byte at position p (where 0 is the oldest and 32767 is the most\n  // recent) is represented by history_a[p] and history_b[p] in two parallel\n  // decodings. Bytes that are equal in both decodings are literal bytes\n  // (copies of them). Bytes that differ, a and b, came from the history, at\n  // position ((((b - a - 1) & 0xFF) << 8) | a). history_z is all zeroes.\n  uint8_t history_a[32768];\n  uint8_t history_b[32768];\n  uint8_t history_z[32768];\n};\n\nDecodeDeflateState::DecodeDeflateState(const uint8_t* ptr0, size_t len0)\n    : ptr(ptr0), len(len0) {\n  for (uint32_t p = 0; p < 32768; p++) {\n    history_a[p] = (uint8_t)(p);\n    history_b[p] = (uint8_t)((p & 0xFF) + (p >> 8) + 1);\n    history_z[p] = 0;\n  }\n}\n\n// DecodeDeflateChunk is a contiguous part of the DEFLATE stream, decoded\n// speculatively by one thread.\nstruct DecodeDeflateChunk {\n  DecodeDeflateChunk();\n\n  // start_pos is the bit position of a candidate block boundary, found by\n  // DecodeDeflateFindCandidate, or DecodeDeflateNoPosition if none was f" +
+	"ound.\n  uint64_t start_pos;\n  // stop_pos is where the chunk ends: at the first block boundary at or\n  // after this bit position (or at the end of the DEFLATE stream).\n  uint64_t stop_pos;\n\n  // The remaining fields are set by DecodeDeflateSpeculate.\n  //\n  // ok is whether the speculative decoding succeeded. If so, end_pos is the\n  // bit position of the block boundary where it stopped, final is whether\n  // that was the end of the DEFLATE stream and end_index (only meaningful\n  // when final) is the byte index just after the end of the DEFLATE stream.\n  bool ok;\n  bool final;\n  uint64_t end_pos;\n  size_t end_index;\n\n  // dst_a is the decoded output, using history_a. resolve_b is a prefix of\n  // the decoded output using history_b, long enough to resolve every\n  // placeholder byte in dst_a.\n  std::vector<uint8_t> dst_a;\n  std::vector<uint8_t> resolve_b;\n};\n\nDecodeDeflateChunk::DecodeDeflateChunk()\n    : start_pos(DecodeDeflateNoPosition),\n      stop_pos(DecodeDeflateNoPosition),\n      ok(false),\n      fina" +
+	"l(false),\n      end_pos(0),\n      end_index(0) {}\n\n// DecodeDeflateRestart re-initializes dec and src so that decoding resumes at\n// the bit position pos, with the given history (which may be empty).\nbool  //\nDecodeDeflateRestart(wuffs_deflate__decoder* dec,\n                     wuffs_base__io_buffer* src,\n                     const uint8_t* ptr,\n                     size_t len,\n                     uint64_t pos,\n                     const uint8_t* history_ptr,\n                     size_t history_len) {\n  wuffs_base__status status =\n      dec->initialize(sizeof__wuffs_deflate__decoder(), WUFFS_VERSION,\n                      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);\n  if (!status.is_ok()) {\n    return false;\n  }\n  dec->set_quirk_enabled(WUFFS_DEFLATE__QUIRK_SUSPEND_AT_BLOCK_BOUNDARIES,\n                         true);\n  if (history_len > 0) {\n    dec->add_history(wuffs_base__make_slice_u8(\n        const_cast<uint8_t*>(history_ptr), history_len));\n  }\n  size_t i = (size_t)(pos >> 3);\n  uint32_t n " +
+	"= (uint32_t)(pos & 7);\n  if (i > len) {\n    return false;\n  } else if (n > 0) {\n    if (i == len) {\n      return false;\n    }\n    dec->set_pending_bits(ptr[i] >> n, 8 - n);\n    i++;\n  }\n  *src = wuffs_base__ptr_u8__reader(const_cast<uint8_t*>(ptr), len, true);\n  src->meta.ri = i;\n  return true;\n}\n\n// DecodeDeflateBoundaryPosition returns the bit position of the block\n// boundary that the decoder is suspended at.\nuint64_t  //\nDecodeDeflateBoundaryPosition(wuffs_deflate__decoder* dec,\n                              wuffs_base__io_buffer* src) {\n  return (((uint64_t)(src->meta.ri)) * 8) - dec->num_pending_bits();\n}\n\n// DecodeDeflateTrialDecode returns whether decoding from the bit position pos\n// (with a placeholder history) gets through want_boundaries block boundaries,\n// or 1 MiB of output, without error. Reaching the end of the DEFLATE stream\n// does not count, as a false positive can look like a short final block.\nbool  //\nDecodeDeflateTrialDecode(const DecodeDeflateState& state,\n                         wuf" +
+	"fs_deflate__decoder* dec,\n                         uint8_t* scratch,\n                         uint64_t pos,\n                         uint32_t want_boundaries) {\n  wuffs_base__io_buffer src;\n  if (!DecodeDeflateRestart(dec, &src, state.ptr, state.len, pos,\n                            state.history_z, 32768)) {\n    return false;\n  }\n  uint8_t work_array[1];\n  uint32_t num_boundaries = 0;\n  uint64_t num_dst_bytes = 0;\n  while (num_dst_bytes < (1024 * 1024)) {\n    wuffs_base__io_buffer dst =\n        wuffs_base__ptr_u8__writer(scratch, DecodeDeflateScratchLength);\n    wuffs_base__status status =\n        dec->transform_io(&dst, &src, wuffs_base__make_slice_u8(work_array, 0));\n    num_dst_bytes += dst.meta.wi;\n    if (status.repr == wuffs_deflate__suspension__block_boundary) {\n      if (++num_boundaries >= want_boundaries) {\n        break;\n      }\n    } else if (status.repr != wuffs_base__suspension__short_write) {\n      return false;\n    }\n  }\n  return true;\n}\n\nuint64_t  //\nDecodeDeflateFindCandidate(const DecodeDe" +
+	"flateState& state,\n                           uint64_t min_incl_pos,\n                           uint64_t max_excl_pos) {\n  wuffs_deflate__decoder::unique_ptr dec = wuffs_deflate__decoder::alloc();\n  std::unique_ptr<uint8_t[]> scratch(new uint8_t[DecodeDeflateScratchLength]);\n  if (!dec || !scratch) {\n    return DecodeDeflateNoPosition;\n  }\n  for (uint64_t pos = min_incl_pos; pos < max_excl_pos; pos++) {\n    uint32_t want_boundaries =\n        DecodeDeflateLooksLikeBlockStart(state.ptr, state.len, pos);\n    if ((want_boundaries > 0) &&\n        DecodeDeflateTrialDecode(state, dec.get(), scratch.get(), pos,\n                                 want_boundaries)) {\n      return pos;\n    }\n  }\n  return DecodeDeflateNoPosition;\n}\n\n// DecodeDeflateSpeculate decodes the chunk from its start_pos, using\n// history_a (and later history_b) as a placeholder history. Decoding from the\n// very start of the DEFLATE stream (bit position 0) needs no placeholders.\nvoid  //\nDecodeDeflateSpeculate(const DecodeDeflateState& state,\n     " +
+	"                  DecodeDeflateChunk& chunk) {\n  chunk.ok = false;\n  wuffs_deflate__decoder::unique_ptr dec = wuffs_deflate__decoder::alloc();\n  if (!dec) {\n    return;\n  }\n  bool has_history = chunk.start_pos > 0;\n  wuffs_base__io_buffer src;\n  if (!DecodeDeflateRestart(dec.get(), &src, state.ptr, state.len,\n                            chunk.start_pos, state.history_a,\n                            has_history ? 32768 : 0)) {\n    return;\n  }\n\n  // Decode with history_a.\n  uint8_t work_array[1];\n  size_t n = 0;\n  chunk.dst_a.resize(4 * WUFFS_AUX__DECODE_DEFLATE__CHUNK_LENGTH);\n  while (true) {\n    // Each transform_io call starts with an empty dst (with no history), as\n    // the decoder has already copied earlier output into its own history.\n    wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(\n        chunk.dst_a.data() + n, chunk.dst_a.size() - n);\n    wuffs_base__status status =\n        dec->transform_io(&dst, &src, wuffs_base__make_slice_u8(work_array, 0));\n    n += dst.meta.wi;\n    if (status.repr =" +
+	"= wuffs_deflate__suspension__block_boundary) {\n      uint64_t pos = DecodeDeflateBoundaryPosition(dec.get(), &src);\n      if (pos >= chunk.stop_pos) {\n        chunk.end_pos = pos;\n        break;\n      }\n    } else if (status.repr == wuffs_base__suspension__short_write) {\n      size_t max = WUFFS_AUX__DECODE_DEFLATE__MAX_SPECULATIVE_LENGTH;\n      if (chunk.dst_a.size() >= max) {\n        return;\n      }\n      size_t new_size = 2 * chunk.dst_a.size();\n      chunk.dst_a.resize((new_size < max) ? new_size : max);\n    } else if (status.is_ok()) {\n      chunk.final = true;\n      chunk.end_pos = ((uint64_t)(src.meta.ri)) * 8;\n      chunk.end_index = src.meta.ri;\n      break;\n    } else {\n      return;\n    }\n  }\n  chunk.dst_a.resize(n);\n  chunk.dst_a.shrink_to_fit();\n  if (!has_history) {\n    chunk.ok = true;\n    return;\n  }\n\n  // Decode again, with history_b, until 32 KiB of output passes by without\n  // any placeholder bytes. After that, no more placeholders can appear.\n  if (!DecodeDeflateRestart(dec.get(), &src, s" +
+	"tate.ptr, state.len,\n                            chunk.start_pos, state.history_b, 32768)) {\n    return;\n  }\n  std::unique_ptr<uint8_t[]> scratch(new uint8_t[DecodeDeflateScratchLength]);\n  const uint8_t* a = chunk.dst_a.data();\n  size_t num_resolved = 0;\n  size_t last_placeholder_end = 0;\n  while ((num_resolved < n) &&\n         ((num_resolved - last_placeholder_end) < 32768)) {\n    size_t remaining = n - num_resolved;\n    wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(\n        scratch.get(), (remaining < DecodeDeflateScratchLength)\n                           ? remaining\n                           : DecodeDeflateScratchLength);\n    wuffs_base__status status =\n        dec->transform_io(&dst, &src, wuffs_base__make_slice_u8(work_array, 0));\n    const uint8_t* b = scratch.get();\n    for (size_t i = dst.meta.wi; i > 0; i--) {\n      if (a[num_resolved + i - 1] != b[i - 1]) {\n        last_placeholder_end = num_resolved + i;\n        break;\n      }\n    }\n    chunk.resolve_b.insert(chunk.resolve_b.end(), b, b " +
+	"+ dst.meta.wi);\n    num_resolved += dst.meta.wi;\n    if (status.is_error()) {\n      return;\n    } else if (status.is_ok()) {\n      break;\n    }\n  }\n  chunk.resolve_b.resize(last_placeholder_end);\n  chunk.resolve_b.shrink_to_fit();\n  chunk.ok = true;\n}\n\n// DecodeDeflateParallel decodes a complete (in memory) DEFLATE stream. It\n// calls callbacks.Append, in order, from the calling thread.\nclass DecodeDeflateParallel {\n public:\n  DecodeDeflateParallel(DecodeDeflateCallbacks& callbacks,\n                        const uint8_t* ptr,\n                        size_t len,\n                        uint32_t framing,\n                        bool ignore_checksum);\n\n  std::string Decode(uint32_t num_threads, size_t* end_index);\n  uint64_t num_dst_bytes() const { return m_num_dst_bytes; }\n  uint32_t checksum() const { return m_checksum; }\n\n private:\n  std::string Emit(const uint8_t* ptr, size_t len);\n  std::string DecodeSerially(uint64_t start_pos,\n                             uint64_t stop_pos,\n                             De" +
+	"codeDeflateChunk& chunk);\n\n  DecodeDeflateCallbacks& m_callbacks;\n  std::unique_ptr<DecodeDeflateState> m_state;\n  uint32_t m_framing;\n  bool m_ignore_checksum;\n\n  wuffs_crc32__ieee_hasher::unique_ptr m_crc32;\n  wuffs_adler32__hasher::unique_ptr m_adler32;\n  uint32_t m_checksum;\n\n  // m_window holds the last 32 KiB of output, oldest first, of which the\n  // final m_window_len bytes are valid.\n  uint8_t m_window[32768];\n  size_t m_window_len;\n  uint64_t m_num_dst_bytes;\n};\n\nDecodeDeflateParallel::DecodeDeflateParallel(DecodeDeflateCallbacks& callbacks,\n                                             const uint8_t* ptr,\n                                             size_t len,\n                                             uint32_t framing,\n                                             bool ignore_checksum)\n    : m_callbacks(callbacks),\n      m_state(new DecodeDeflateState(ptr, len)),\n      m_framing(framing),\n      m_ignore_checksum(ignore_checksum),\n      m_crc32(wuffs_crc32__ieee_hasher::alloc()),\n      m_adler32(w" +
+	"uffs_adler32__hasher::alloc()),\n      m_checksum(0),\n      m_window_len(0),\n      m_num_dst_bytes(0) {}\n\nstd::string  //\nDecodeDeflateParallel::Emit(const uint8_t* ptr, size_t len) {\n  if (len == 0) {\n    return \"\";\n  }\n  if (!m_ignore_checksum) {\n    wuffs_base__slice_u8 s =\n        wuffs_base__make_slice_u8(const_cast<uint8_t*>(ptr), len);\n    if (m_framing == WUFFS_BASE__FOURCC__GZ) {\n      m_checksum = m_crc32->update_u32(s);\n    } else if (m_framing == WUFFS_BASE__FOURCC__ZLIB) {\n      m_checksum = m_adler32->update_u32(s);\n    }\n  }\n  if (len >= 32768) {\n    memcpy(m_window, ptr + len - 32768, 32768);\n    m_window_len = 32768;\n  } else {\n    memmove(m_window, m_window + len, 32768 - len);\n    memcpy(m_window + 32768 - len, ptr, len);\n    m_window_len = (m_window_len + len < 32768) ? (m_window_len + len) : 32768;\n  }\n  m_num_dst_bytes += len;\n  return m_callbacks.Append(ptr, len);\n}\n\n// DecodeSerially decodes (and emits) from start_pos, with the real history,\n// until the first block boundary at or after" +
+	" stop_pos. It sets the chunk's\n// end_pos, final and end_index fields.\nstd::string  //\nDecodeDeflateParallel::DecodeSerially(uint64_t start_pos,\n                                      uint64_t stop_pos,\n                                      DecodeDeflateChunk& chunk) {\n  wuffs_deflate__decoder::unique_ptr dec = wuffs_deflate__decoder::alloc();\n  if (!dec) {\n    return DecodeDeflate_OutOfMemory;\n  }\n  wuffs_base__io_buffer src;\n  if (!DecodeDeflateRestart(dec.get(), &src, m_state->ptr, m_state->len,\n                            start_pos, m_window + 32768 - m_window_len,\n                            m_window_len)) {\n    return DecodeDeflate_UnexpectedEndOfFile;\n  }\n  std::unique_ptr<uint8_t[]> dst_array(\n      new uint8_t[DecodeDeflateScratchLength]);\n  uint8_t work_array[1];\n  while (true) {\n    wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(\n        dst_array.get(), DecodeDeflateScratchLength);\n    wuffs_base__status status =\n        dec->transform_io(&dst, &src, wuffs_base__make_slice_u8(work_array, 0)" +
+	");\n    std::string error_message = Emit(dst.data.ptr, dst.meta.wi);\n    if (!error_message.empty()) {\n      return error_message;\n    }\n    if (status.repr == wuffs_deflate__suspension__block_boundary) {\n      uint64_t pos = DecodeDeflateBoundaryPosition(dec.get(), &src);\n      if (pos >= stop_pos) {\n        chunk.end_pos = pos;\n        return \"\";\n      }\n    } else if (status.repr == wuffs_base__suspension__short_write) {\n      continue;\n    } else if (status.is_ok()) {\n      chunk.final = true;\n      chunk.end_pos = ((uint64_t)(src.meta.ri)) * 8;\n      chunk.end_index = src.meta.ri;\n      return \"\";\n    } else if (status.repr == wuffs_base__suspension__short_read) {\n      return DecodeDeflate_UnexpectedEndOfFile;\n    } else {\n      return status.message();\n    }\n  }\n}\n\nstd::string  //\nDecodeDeflateParallel::Decode(uint32_t num_threads, size_t* end_index) {\n  if (!m_state || !m_crc32 || !m_adler32) {\n    return DecodeDeflate_OutOfMemory;\n  }\n  const size_t chunk_len = WUFFS_AUX__DECODE_DEFLATE__CHUNK_LENGTH;" +
+	"\n  const size_t len = m_state->len;\n  size_t num_chunks = (len / chunk_len) + 1;\n\n  // start_positions[i] is the i'th chunk's candidate start position. The\n  // zeroth chunk always starts at the very start of the DEFLATE stream.\n  std::vector<uint64_t> start_positions(num_chunks + 1,\n                                        DecodeDeflateNoPosition);\n  start_positions[0] = 0;\n\n  uint64_t pos = 0;\n  bool final = false;\n  for (size_t r0 = 0; (r0 < num_chunks) && !final; r0 += num_threads) {\n    size_t r1 = ((num_chunks - r0) < num_threads) ? num_chunks\n                                                  : (r0 + num_threads);\n\n    // Find the candidate start positions for chunks (r0 .. r1], in parallel.\n    // The r0'th chunk's candidate was found by the previous round.\n    {\n      std::vector<std::thread> threads;\n      for (size_t i = r0 + 1; (i <= r1) && (i < num_chunks); i++) {\n        threads.emplace_back([this, &start_positions, chunk_len, i]() {\n          start_positions[i] = DecodeDeflateFindCandidate(\n     " +
+	"         *m_state, ((uint64_t)(i * chunk_len)) * 8,\n              ((uint64_t)((i + 1) * chunk_len)) * 8);\n        });\n      }\n      for (auto& t : threads) {\n        t.join();\n      }\n    }\n\n    // Decode chunks [r0 .. r1), in parallel. Each chunk stops at the next\n    // chunk's candidate start position (or the end of this round).\n    std::vector<DecodeDeflateChunk> chunks(r1 - r0);\n    {\n      std::vector<std::thread> threads;\n      for (size_t i = r0; i < r1; i++) {\n        DecodeDeflateChunk& chunk = chunks[i - r0];\n        chunk.start_pos = start_positions[i];\n        chunk.stop_pos = (r1 < num_chunks) ? (((uint64_t)(r1 * chunk_len)) * 8)\n                                           : DecodeDeflateNoPosition;\n        for (size_t j = i + 1; j <= r1; j++) {\n          if (start_positions[j] != DecodeDeflateNoPosition) {\n            chunk.stop_pos = start_positions[j];\n            break;\n          }\n        }\n        if (chunk.start_pos != DecodeDeflateNoPosition) {\n          threads.emplace_back(\n            " +
+	"  [this, &chunk]() { DecodeDeflateSpeculate(*m_state, chunk); });\n        }\n      }\n      for (auto& t : threads) {\n        t.join();\n      }\n    }\n\n    // Stitch the chunks together, in order. A speculatively decoded chunk is\n    // used only if it starts exactly where the previous chunk ended and its\n    // placeholders can be resolved. Otherwise, fall back to decoding\n    // serially, with the real history.\n    for (size_t i = r0; (i < r1) && !final; i++) {\n      DecodeDeflateChunk& chunk = chunks[i - r0];\n      if (pos >= chunk.stop_pos) {\n        continue;\n      }\n\n      if (chunk.ok &&\n          DecodeDeflateEquivalentStarts(m_state->ptr, m_state->len,\n                                        chunk.start_pos, pos) &&\n          (chunk.resolve_b.empty() || (m_window_len == 32768))) {\n        uint8_t* a = chunk.dst_a.data();\n        const uint8_t* b = chunk.resolve_b.data();\n        for (size_t j = 0; j < chunk.resolve_b.size(); j++) {\n          if (a[j] != b[j]) {\n            a[j] = m_window[(((b[j] - a[j]" +
+	" - 1) & 0xFF) << 8) | a[j]];\n          }\n        }\n        std::string error_message = Emit(a, chunk.dst_a.size());\n        if (!error_message.empty()) {\n          return error_message;\n        }\n      } else {\n        chunk.final = false;\n        std::string error_message = DecodeSerially(pos, chunk.stop_pos, chunk);\n        if (!error_message.empty()) {\n          return error_message;\n        }\n      }\n      pos = chunk.end_pos;\n      final = chunk.final;\n      *end_index = chunk.end_index;\n\n      chunk.dst_a.clear();\n      chunk.dst_a.shrink_to_fit();\n      chunk.resolve_b.clear();\n      chunk.resolve_b.shrink_to_fit();\n    }\n  }\n  return final ? \"\" : DecodeDeflate_UnexpectedEndOfFile;\n}\n\n// DecodeDeflateReadAll returns the entire input, either in its own I/O buffer\n// or after copying it into storage.\nstd::string  //\nDecodeDeflateReadAll(sync_io::Input& input,\n                     std::vector<uint8_t>& storage,\n                     wuffs_base__slice_u8* all) {\n  wuffs_base__io_buffer* io_buf = input.Bring" +
+	"sItsOwnIOBuffer();\n  if (io_buf && io_buf->meta.closed) {\n    *all = io_buf->reader_slice();\n    return \"\";\n  }\n  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();\n  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);\n  if (!io_buf) {\n    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);\n    fallback_io_buf =\n        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);\n    io_buf = &fallback_io_buf;\n  }\n  while (true) {\n    storage.insert(storage.end(), io_buf->reader_pointer(),\n                   io_buf->reader_pointer() + io_buf->reader_length());\n    io_buf->meta.ri = io_buf->meta.wi;\n    if (io_buf->meta.closed) {\n      break;\n    }\n    io_buf->compact();\n    std::string error_message = input.CopyIn(io_buf);\n    if (!error_message.empty()) {\n      return error_message;\n    }\n  }\n  *all = wuffs_base__make_slice_u8(storage.data(), storage.size());\n  return \"\";\n}\n\n// DecodeDeflateMessage returns the message (without the leading '#') of a\n// Wuffs error status," +
+	" such as wuffs_gzip__error__bad_checksum.\nstd::string  //\nDecodeDeflateMessage(const char* status_repr) {\n  return wuffs_base__make_status(status_repr).message();\n}\n\n// DecodeDeflateHeaderLength returns the length of the gzip or zlib header at\n// the start of s, or 0 if it is invalid (setting error_message). The error\n// messages match what the (single-threaded) gzip and zlib decoders report.\nsize_t  //\nDecodeDeflateHeaderLength(wuffs_base__slice_u8 s,\n                          uint32_t framing,\n                          std::string& error_message) {\n  if (framing == 0) {\n    return 0;\n  } else if (framing == WUFFS_BASE__FOURCC__ZLIB) {\n    if (s.len < 2) {\n      error_message = DecodeDeflate_UnexpectedEndOfFile;\n      return 0;\n    } else if ((s.ptr[0] & 0x0F) != 0x08) {\n      error_message =\n          DecodeDeflateMessage(wuffs_zlib__error__bad_compression_method);\n      return 0;\n    } else if ((s.ptr[0] >> 4) > 7) {\n      error_message =\n          DecodeDeflateMessage(wuffs_zlib__error__bad_compression_wi" +
+	"ndow_size);\n      return 0;\n    } else if ((((s.ptr[0] << 8) | s.ptr[1]) % 31) != 0) {\n      error_message = DecodeDeflateMessage(wuffs_zlib__error__bad_parity_check);\n      return 0;\n    } else if (s.ptr[1] & 0x20) {\n      // Preset dictionaries are not supported.\n      error_message = DecodeDeflate_UnsupportedFraming;\n      return 0;\n    }\n    return 2;\n  } else if (framing != WUFFS_BASE__FOURCC__GZ) {\n    error_message = DecodeDeflate_UnsupportedFraming;\n    return 0;\n  }\n\n  // Check the leading bytes before the length, like the gzip decoder does.\n  if (((s.len > 0) && (s.ptr[0] != 0x1F)) ||\n      ((s.len > 1) && (s.ptr[1] != 0x8B))) {\n    error_message = DecodeDeflateMessage(wuffs_gzip__error__bad_header);\n    return 0;\n  } else if ((s.len > 2) && (s.ptr[2] != 0x08)) {\n    error_message =\n        DecodeDeflateMessage(wuffs_gzip__error__bad_compression_method);\n    return 0;\n  } else if (s.len < 10) {\n    error_message = DecodeDeflate_UnexpectedEndOfFile;\n    return 0;\n  }\n  uint8_t flags = s.ptr[3];\n  siz" +
+	"e_t i = 10;\n  if (flags & 0x04) {  // FEXTRA.\n    if ((s.len - i) < 2) {\n      error_message = DecodeDeflate_UnexpectedEndOfFile;\n      return 0;\n    }\n    i += 2 + wuffs_base__peek_u16le__no_bounds_check(s.ptr + i);\n  }\n  for (uint8_t f = 0x08; f <= 0x10; f <<= 1) {  // FNAME and FCOMMENT.\n    if (flags & f) {\n      while ((i < s.len) && (s.ptr[i] != 0)) {\n        i++;\n      }\n      i++;\n    }\n  }\n  if (flags & 0x02) {  // FHCRC.\n    i += 2;\n  }\n  if (i > s.len) {\n    error_message = DecodeDeflate_UnexpectedEndOfFile;\n    return 0;\n  } else if ((flags & 0xE0) != 0) {\n    error_message = DecodeDeflateMessage(wuffs_gzip__error__bad_encoding_flags);\n    return 0;\n  }\n  return i;\n}\n\nbool  //\nDecodeDeflateIgnoreChecksum(wuffs_base__slice_u32 quirks) {\n  for (size_t i = 0; i < quirks.len; i++) {\n    if (quirks.ptr[i] == WUFFS_BASE__QUIRK_IGNORE_CHECKSUM) {\n      return true;\n    }\n  }\n  return false;\n}\n\n// DecodeDeflateCheckTrailer checks the gzip or zlib trailer, of trailer_len\n// bytes, against the checksum and " +
+	"length of the decoded output. Like\n// DecodeDeflateHeaderLength, its error messages match the gzip and zlib\n// decoders'.\nstd::string  //\nDecodeDeflateCheckTrailer(const uint8_t* trailer,\n                          size_t trailer_len,\n                          uint32_t framing,\n                          bool ignore_checksum,\n                          uint32_t checksum,\n                          uint64_t num_dst_bytes) {\n  if (framing == WUFFS_BASE__FOURCC__GZ) {\n    if (trailer_len < 8) {\n      return DecodeDeflate_UnexpectedEndOfFile;\n    } else if (!ignore_checksum &&\n               ((checksum !=\n                 wuffs_base__peek_u32le__no_bounds_check(trailer + 0)) ||\n                (((uint32_t)(num_dst_bytes)) !=\n                 wuffs_base__peek_u32le__no_bounds_check(trailer + 4)))) {\n      return DecodeDeflateMessage(wuffs_gzip__error__bad_checksum);\n    }\n  } else if (framing == WUFFS_BASE__FOURCC__ZLIB) {\n    if (trailer_len < 4) {\n      return DecodeDeflate_UnexpectedEndOfFile;\n    } else if (!ignor" +
+	"e_checksum &&\n               (checksum !=\n                wuffs_base__peek_u32be__no_bounds_check(trailer))) {\n      return DecodeDeflateMessage(wuffs_zlib__error__bad_checksum);\n    }\n  }\n  return \"\";\n}\n\nDecodeDeflateResult  //\nDecodeDeflate0(DecodeDeflateCallbacks& callbacks,\n               sync_io::Input& input,\n               uint32_t framing,\n               uint32_t num_threads,\n               bool ignore_checksum) {\n  std::vector<uint8_t> storage;\n  wuffs_base__slice_u8 all = wuffs_base__empty_slice_u8();\n  std::string error_message = DecodeDeflateReadAll(input, storage, &all);\n  if (!error_message.empty()) {\n    return DecodeDeflateResult(std::move(error_message), 0);\n  }\n  size_t header_len = DecodeDeflateHeaderLength(all, framing, error_message);\n  if (!error_message.empty()) {\n    return DecodeDeflateResult(std::move(error_message), 0);\n  }\n\n  DecodeDeflateParallel p(callbacks, all.ptr + header_len,\n                          all.len - header_len, framing, ignore_checksum);\n  size_t end_index = 0;\n  " +
+	"error_message = p.Decode(num_threads, &end_index);\n  if (!error_message.empty()) {\n    return DecodeDeflateResult(std::move(error_message), p.num_dst_bytes());\n  }\n\n  // Check the gzip or zlib trailer.\n  error_message = DecodeDeflateCheckTrailer(\n      all.ptr + header_len + end_index, all.len - header_len - end_index,\n      framing, ignore_checksum, p.checksum(), p.num_dst_bytes());\n  return DecodeDeflateResult(std::move(error_message), p.num_dst_bytes());\n}\n\n}  // namespace\n\nDecodeDeflateResult  //\nDecodeDeflate(DecodeDeflateCallbacks& callbacks,\n              sync_io::Input& input,\n              uint32_t framing,\n              uint32_t num_threads,\n              wuffs_base__slice_u32 quirks) {\n  bool ignore_checksum = DecodeDeflateIgnoreChecksum(quirks);\n  DecodeDeflateResult result =\n      (num_threads <= 1)\n          ? DecodeDeflateSerial(callbacks, input, framing, ignore_checksum)\n          : DecodeDeflate0(callbacks, input, framing, num_threads,\n                           ignore_checksum);\n  callbacks." +
+	"Done(result, input);\n  return result;\n}\n\n" +
+	"" +
+	"// --------\n\nnamespace {\n\n// DecodeGzipMember is a complete gzip member's compressed and decoded bytes.\nstruct DecodeGzipMember {\n  std::vector<uint8_t> src;\n  std::vector<uint8_t> dst;\n  std::string error_message;\n};\n\n// DecodeGzipMemberLength returns the total (compressed) length of the gzip\n// member whose header is at the start of s, if that header's FEXTRA field has\n// a BGZF \"BC\" subfield, or 0 if it does not.\nsize_t  //\nDecodeGzipMemberLength(wuffs_base__slice_u8 s) {\n  if ((s.len < 12) || !(s.ptr[3] & 0x04)) {\n    return 0;\n  }\n  size_t n = wuffs_base__peek_u16le__no_bounds_check(s.ptr + 10);\n  if (n > (s.len - 12)) {\n    return 0;\n  }\n  const uint8_t* p = s.ptr + 12;\n  while (n >= 4) {\n    size_t subfield_len = wuffs_base__peek_u16le__no_bounds_check(p + 2);\n    if (subfield_len > (n - 4)) {\n      break;\n    } else if ((p[0] == 'B') && (p[1] == 'C') && (subfield_len == 2)) {\n      return 1 + (size_t)wuffs_base__peek_u16le__no_bounds_check(p + 4);\n    }\n    p += 4 + subfield_len;\n    n -= 4 + subfield" +
+	"_len;\n  }\n  return 0;\n}\n\n// DecodeGzipMemberDecode decodes m.src into m.dst, which has already been\n// sized (from the member's ISIZE) to fit the decoded bytes plus one.\nvoid  //\nDecodeGzipMemberDecode(wuffs_gzip__decoder* dec,\n                       DecodeGzipMember& m,\n                       bool ignore_checksum) {\n  wuffs_base__status status =\n      dec->initialize(sizeof__wuffs_gzip__decoder(), WUFFS_VERSION,\n                      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);\n  if (!status.is_ok()) {\n    m.error_message = status.message();\n    return;\n  }\n  dec->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, ignore_checksum);\n\n  wuffs_base__io_buffer src =\n      wuffs_base__ptr_u8__reader(m.src.data(), m.src.size(), true);\n  uint8_t work_array[1];\n  size_t n = 0;\n  while (true) {\n    wuffs_base__io_buffer dst =\n        wuffs_base__ptr_u8__writer(m.dst.data() + n, m.dst.size() - n);\n    status = dec->transform_io(&dst, &src,\n                               wuffs_base__make_slice_u8(work_arr" +
+	"ay, 0));\n    n += dst.meta.wi;\n    if (status.is_ok()) {\n      break;\n    } else if (status.repr == wuffs_base__suspension__short_write) {\n      // The member decodes to more than its ISIZE.\n      if (!ignore_checksum) {\n        m.error_message = DecodeDeflate_BadChecksum;\n        return;\n      }\n      m.dst.resize(2 * m.dst.size());\n    } else if (status.repr == wuffs_base__suspension__short_read) {\n      // The member is longer than its \"BC\" subfield says.\n      m.error_message = DecodeDeflate_BadHeader;\n      return;\n    } else {\n      m.error_message = status.message();\n      return;\n    }\n  }\n  if (src.meta.ri != src.meta.wi) {\n    // The member is shorter than its \"BC\" subfield says.\n    m.error_message = DecodeDeflate_BadHeader;\n    return;\n  }\n  m.dst.resize(n);\n}\n\n// DecodeGzipMemberSerially decodes m.src, streaming its output through the\n// dst scratch buffer to callbacks.Append. For a bad or truncated member, this\n// gives the same output and error message as single-threaded decoding.\nstd::string  " +
+	"//\nDecodeGzipMemberSerially(DecodeDeflateCallbacks& callbacks,\n                         wuffs_gzip__decoder* dec,\n                         DecodeGzipMember& m,\n                         bool ignore_checksum,\n                         wuffs_base__io_buffer* dst,\n                         uint64_t* num_dst_bytes) {\n  wuffs_base__status status =\n      dec->initialize(sizeof__wuffs_gzip__decoder(), WUFFS_VERSION,\n                      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);\n  if (!status.is_ok()) {\n    return status.message();\n  }\n  dec->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, ignore_checksum);\n  sync_io::MemoryInput member_input(m.src.data(), m.src.size());\n  IOBuffer* member_io_buf = member_input.BringsItsOwnIOBuffer();\n  std::string error_message = DecodeDeflateStream(\n      callbacks, member_input, member_io_buf,\n      dec->upcast_as__wuffs_base__io_transformer(), dst, num_dst_bytes);\n  if (error_message.empty() && (member_io_buf->reader_length() > 0)) {\n    // The member is shorter" +
+	" than its \"BC\" subfield says.\n    error_message = DecodeDeflate_BadHeader;\n  }\n  return error_message;\n}\n\n// DecodeGzipMembersFlush decodes the batch of members, in parallel, and then\n// passes their output, in order, to callbacks.Append. The first bad member is\n// decoded again, serially, so that its valid prefix is also passed on.\nstd::string  //\nDecodeGzipMembersFlush(DecodeDeflateCallbacks& callbacks,\n                       std::vector<wuffs_gzip__decoder::unique_ptr>& decs,\n                       std::vector<DecodeGzipMember>& batch,\n                       bool ignore_checksum,\n                       wuffs_base__io_buffer* dst,\n                       uint64_t* num_dst_bytes) {\n  size_t num_threads = (decs.size() < batch.size()) ? decs.size()  //\n                                                    : batch.size();\n  if (num_threads == 1) {\n    DecodeGzipMemberDecode(decs[0].get(), batch[0], ignore_checksum);\n  } else if (num_threads > 1) {\n    std::vector<std::thread> threads;\n    for (size_t t = 0; t < nu" +
+	"m_threads; t++) {\n      threads.emplace_back(\n          [&decs, &batch, ignore_checksum, num_threads, t]() {\n            for (size_t i = t; i < batch.size(); i += num_threads) {\n              DecodeGzipMemberDecode(decs[t].get(), batch[i],\n                                     ignore_checksum);\n            }\n          });\n    }\n    for (auto& t : threads) {\n      t.join();\n    }\n  }\n\n  for (auto& m : batch) {\n    if (!m.error_message.empty()) {\n      std::string error_message = DecodeGzipMemberSerially(\n          callbacks, decs[0].get(), m, ignore_checksum, dst, num_dst_bytes);\n      return error_message.empty() ? std::move(m.error_message)\n                                   : error_message;\n    } else if (!m.dst.empty()) {\n      std::string error_message = callbacks.Append(m.dst.data(), m.dst.size());\n      *num_dst_bytes += m.dst.size();\n      if (!error_message.empty()) {\n        return error_message;\n      }\n    }\n  }\n  batch.clear();\n  return \"\";\n}\n\nDecodeDeflateResult  //\nDecodeGzipMembers0(DecodeDeflat" +
+	"eCallbacks& callbacks,\n                   sync_io::Input& input,\n                   uint32_t num_threads,\n                   bool ignore_checksum) {\n  std::vector<wuffs_gzip__decoder::unique_ptr> decs;\n  for (uint32_t t = 0; (t == 0) || (t < num_threads); t++) {\n    decs.push_back(wuffs_gzip__decoder::alloc());\n    if (!decs.back()) {\n      return DecodeDeflateResult(DecodeDeflate_OutOfMemory, 0);\n    }\n  }\n\n  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();\n  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();\n  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);\n  if (!io_buf) {\n    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);\n    fallback_io_buf =\n        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);\n    io_buf = &fallback_io_buf;\n  }\n\n  std::unique_ptr<uint8_t[]> dst_array(\n      new uint8_t[DecodeDeflateScratchLength]);\n  wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(\n      dst_array.get(), DecodeDeflateScratchLength);\n  std" +
+	"::vector<DecodeGzipMember> batch;\n  uint64_t batch_len = 0;\n  uint64_t num_dst_bytes = 0;\n\n  for (bool first = true; true; first = false) {\n    // Read the next member's header, which has to fit in io_buf. Reaching the\n    // end of the input (other than before the first member) is not an error.\n    std::string error_message;\n    size_t header_len = 0;\n    while (true) {\n      if (!first && (io_buf->reader_length() == 0) && io_buf->meta.closed) {\n        break;\n      }\n      header_len = DecodeDeflateHeaderLength(\n          io_buf->reader_slice(), WUFFS_BASE__FOURCC__GZ, error_message);\n      if (error_message.empty() ||\n          (error_message != DecodeDeflate_UnexpectedEndOfFile) ||\n          ((io_buf->meta.ri == 0) && (io_buf->meta.wi == io_buf->data.len))) {\n        break;\n      }\n      error_message = DecodeDeflateFill(input, io_buf);\n      if (!error_message.empty()) {\n        break;\n      }\n    }\n    if (!error_message.empty() || (header_len == 0)) {\n      std::string flush_error_message = DecodeGzipM" +
+	"embersFlush(\n          callbacks, decs, batch, ignore_checksum, &dst, &num_dst_bytes);\n      return DecodeDeflateResult(flush_error_message.empty()\n                                     ? std::move(error_message)\n                                     : std::move(flush_error_message),\n                                 num_dst_bytes);\n    }\n\n    size_t member_len = (num_threads > 1)\n                            ? DecodeGzipMemberLength(io_buf->reader_slice())\n                            : 0;\n    DecodeGzipMember m;\n    if (member_len > 0) {\n      if (member_len < (header_len + 8)) {\n        error_message = DecodeDeflate_BadHeader;\n      }\n      // Read ahead the whole member.\n      m.src.reserve(member_len);\n      while (error_message.empty() && (m.src.size() < member_len)) {\n        size_t n = member_len - m.src.size();\n        if (n > io_buf->reader_length()) {\n          n = io_buf->reader_length();\n        }\n        m.src.insert(m.src.end(), io_buf->reader_pointer(),\n                     io_buf->reader_pointer()" +
+	" + n);\n        io_buf->meta.ri += n;\n        if (m.src.size() < member_len) {\n          error_message = DecodeDeflateFill(input, io_buf);\n        }\n      }\n      if (!error_message.empty()) {\n        // Decode what there is of this (truncated) member, after the batch\n        // so far, as single-threaded decoding would have.\n        std::string other_error_message = DecodeGzipMembersFlush(\n            callbacks, decs, batch, ignore_checksum, &dst, &num_dst_bytes);\n        if (other_error_message.empty() && (m.src.size() >= header_len)) {\n          other_error_message =\n              DecodeGzipMemberSerially(callbacks, decs[0].get(), m,\n                                       ignore_checksum, &dst, &num_dst_bytes);\n        }\n        return DecodeDeflateResult(other_error_message.empty()\n                                       ? std::move(error_message)\n                                       : std::move(other_error_message),\n                                   num_dst_bytes);\n      }\n\n      uint64_t isize = wuffs_" +
+	"base__peek_u32le__no_bounds_check(\n          m.src.data() + member_len - 4);\n      if (isize <= WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH) {\n        m.dst.resize(isize + 1);\n        batch.push_back(std::move(m));\n        batch_len += isize;\n        if (batch_len >=\n            (WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH * decs.size())) {\n          error_message =\n              DecodeGzipMembersFlush(callbacks, decs, batch, ignore_checksum,\n                                     &dst, &num_dst_bytes);\n          batch_len = 0;\n          if (!error_message.empty()) {\n            return DecodeDeflateResult(std::move(error_message),\n                                       num_dst_bytes);\n          }\n        }\n        continue;\n      }\n    }\n\n    // Decode this member single-threaded, after the batch so far.\n    error_message = DecodeGzipMembersFlush(\n        callbacks, decs, batch, ignore_checksum, &dst, &num_dst_bytes);\n    batch_len = 0;\n    if (!error_message.empty()) {\n      return DecodeDeflateResult(std::m" +
+	"ove(error_message), num_dst_bytes);\n    }\n    if (member_len == 0) {\n      wuffs_base__status status = decs[0]->initialize(\n          sizeof__wuffs_gzip__decoder(), WUFFS_VERSION,\n          WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);\n      if (!status.is_ok()) {\n        return DecodeDeflateResult(status.message(), num_dst_bytes);\n      }\n      decs[0]->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM,\n                                 ignore_checksum);\n      error_message = DecodeDeflateStream(\n          callbacks, input, io_buf,\n          decs[0]->upcast_as__wuffs_base__io_transformer(), &dst,\n          &num_dst_bytes);\n    } else {\n      error_message = DecodeGzipMemberSerially(\n          callbacks, decs[0].get(), m, ignore_checksum, &dst, &num_dst_bytes);\n    }\n    if (!error_message.empty()) {\n      return DecodeDeflateResult(std::move(error_message), num_dst_bytes);\n    }\n  }\n}\n\n}  // namespace\n\nDecodeDeflateResult  //\nDecodeGzipMembers(DecodeDeflateCallbacks& callbacks,\n                  " +
+	"sync_io::Input& input,\n                  uint32_t num_threads,\n                  wuffs_base__slice_u32 quirks) {\n  DecodeDeflateResult result = DecodeGzipMembers0(\n      callbacks, input, num_threads, DecodeDeflateIgnoreChecksum(quirks));\n  callbacks.Done(result, input);\n  return result;\n}\n\n" +
+	"" +
+	"// --------\n\nDecodeDeflateBatchCallbacks::~DecodeDeflateBatchCallbacks() {}\n\nnamespace {\n\n// DecodeDeflateBatchDstLength is the length of each lane's dst buffer. When\n// it is full, all but its final 32 KiB is passed to callbacks.Append. Keeping\n// that history in dst means that decode_interleaved can always copy from it.\nconst size_t DecodeDeflateBatchDstLength = 128 * 1024;\n\n// DecodeDeflateBatchLane decodes one input at a time. DecodeDeflateBatch\n// interleaves two lanes.\nstruct DecodeDeflateBatchLane {\n  DecodeDeflateBatchLane();\n\n  std::string Start(size_t i,\n                    wuffs_base__slice_u8 input,\n                    uint32_t framing0,\n                    bool ignore_checksum0);\n  std::string Advance(DecodeDeflateBatchCallbacks& callbacks);\n  std::string Flush(DecodeDeflateBatchCallbacks& callbacks, size_t keep);\n\n  wuffs_deflate__decoder::unique_ptr dec;\n  wuffs_crc32__ieee_hasher::unique_ptr crc32;\n  wuffs_adler32__hasher::unique_ptr adler32;\n  std::unique_ptr<uint8_t[]> dst_array;\n  wuffs_bas" +
+	"e__io_buffer dst;\n  wuffs_base__io_buffer src;\n\n  size_t index;\n  uint32_t framing;\n  bool ignore_checksum;\n  // active is whether the lane is decoding an input. ready is whether dec is\n  // suspended with a \"$ready to interleave\" status.\n  bool active;\n  bool ready;\n  // dst.data.ptr[.. num_appended] has already been passed to Append.\n  size_t num_appended;\n  uint32_t checksum;\n  uint64_t num_dst_bytes;\n};\n\nDecodeDeflateBatchLane::DecodeDeflateBatchLane()\n    : dec(wuffs_deflate__decoder::alloc()),\n      crc32(wuffs_crc32__ieee_hasher::alloc()),\n      adler32(wuffs_adler32__hasher::alloc()),\n      dst_array(new uint8_t[DecodeDeflateBatchDstLength]),\n      dst(wuffs_base__ptr_u8__writer(dst_array.get(),\n                                     DecodeDeflateBatchDstLength)),\n      src(wuffs_base__empty_io_buffer()),\n      index(0),\n      framing(0),\n      ignore_checksum(false),\n      active(false),\n      ready(false),\n      num_appended(0),\n      checksum(0),\n      num_dst_bytes(0) {}\n\nstd::string  //\nDecodeDefla" +
+	"teBatchLane::Start(size_t i,\n                              wuffs_base__slice_u8 input,\n                              uint32_t framing0,\n                              bool ignore_checksum0) {\n  index = i;\n  framing = framing0;\n  ignore_checksum = ignore_checksum0;\n  active = false;\n  ready = false;\n  num_appended = 0;\n  checksum = 0;\n  num_dst_bytes = 0;\n  dst.meta.wi = 0;\n\n  std::string error_message;\n  size_t header_len = DecodeDeflateHeaderLength(input, framing, error_message);\n  if (!error_message.empty()) {\n    return error_message;\n  }\n  src = wuffs_base__ptr_u8__reader(input.ptr + header_len,\n                                   input.len - header_len, true);\n\n  wuffs_base__status status =\n      dec->initialize(sizeof__wuffs_deflate__decoder(), WUFFS_VERSION,\n                      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);\n  if (status.is_ok()) {\n    status = crc32->initialize(sizeof__wuffs_crc32__ieee_hasher(),\n                               WUFFS_VERSION, 0);\n  }\n  if (status.is_ok()) {\n  " +
+	"  status = adler32->initialize(sizeof__wuffs_adler32__hasher(),\n                                 WUFFS_VERSION, 0);\n  }\n  if (!status.is_ok()) {\n    return status.message();\n  }\n  dec->set_quirk_enabled(WUFFS_DEFLATE__QUIRK_SUSPEND_FOR_INTERLEAVING, true);\n  // Advance resumes with the same dst, which (see Flush) always holds all of\n  // the output so far or its final 32 KiB. The decoder's own copy of that\n  // history would otherwise hold those bytes twice.\n  dec->set_quirk_enabled(WUFFS_DEFLATE__QUIRK_DST_HOLDS_HISTORY, true);\n  active = true;\n  return \"\";\n}\n\n// Advance runs the lane's decoder until it is ready to interleave (setting\n// ready) or until it is done (clearing active), successfully or otherwise.\nstd::string  //\nDecodeDeflateBatchLane::Advance(DecodeDeflateBatchCallbacks& callbacks) {\n  uint8_t work_array[1];\n  ready = false;\n  while (true) {\n    wuffs_base__status status = dec->transform_io(\n        &dst, &src, wuffs_base__make_slice_u8(work_array, 0));\n    if (status.repr == wuffs_deflate__sus" +
+	"pension__ready_to_interleave) {\n      ready = true;\n      return \"\";\n    }\n\n    std::string error_message;\n    if (status.is_ok()) {\n      error_message = Flush(callbacks, 0);\n      if (error_message.empty()) {\n        error_message = DecodeDeflateCheckTrailer(\n            src.reader_pointer(), src.reader_length(), framing,\n            ignore_checksum, checksum, num_dst_bytes);\n      }\n    } else if (status.repr == wuffs_base__suspension__short_write) {\n      error_message = Flush(callbacks, 32768);\n      if (error_message.empty()) {\n        continue;\n      }\n    } else {\n      // Pass on the output before the error, as DecodeDeflate would.\n      error_message = Flush(callbacks, 0);\n      if (error_message.empty()) {\n        error_message = (status.repr == wuffs_base__suspension__short_read)\n                            ? DecodeDeflate_UnexpectedEndOfFile\n                            : status.message();\n      }\n    }\n    active = false;\n    return error_message;\n  }\n}\n\n// Flush passes the not-yet-appended part " +
+	"of dst to callbacks.Append and then\n// moves the final keep bytes of dst (the history) to its start.\nstd::string  //\nDecodeDeflateBatchLane::Flush(DecodeDeflateBatchCallbacks& callbacks,\n                              size_t keep) {\n  if (num_appended < dst.meta.wi) {\n    uint8_t* ptr = dst.data.ptr + num_appended;\n    size_t len = dst.meta.wi - num_appended;\n    if (!ignore_checksum) {\n      wuffs_base__slice_u8 s = wuffs_base__make_slice_u8(ptr, len);\n      if (framing == WUFFS_BASE__FOURCC__GZ) {\n        checksum = crc32->update_u32(s);\n      } else if (framing == WUFFS_BASE__FOURCC__ZLIB) {\n        checksum = adler32->update_u32(s);\n      }\n    }\n    num_dst_bytes += len;\n    num_appended = dst.meta.wi;\n    std::string error_message = callbacks.Append(index, ptr, len);\n    if (!error_message.empty()) {\n      return error_message;\n    }\n  }\n  if (keep > dst.meta.wi) {\n    keep = dst.meta.wi;\n  }\n  memmove(dst.data.ptr, dst.data.ptr + dst.meta.wi - keep, keep);\n  dst.meta.wi = keep;\n  num_appended = keep;\n  " +
+	"return \"\";\n}\n\n}  // namespace\n\nstd::vector<DecodeDeflateResult>  //\nDecodeDeflateBatch(DecodeDeflateBatchCallbacks& callbacks,\n                   const std::vector<wuffs_base__slice_u8>& inputs,\n                   uint32_t framing,\n                   wuffs_base__slice_u32 quirks) {\n  bool ignore_checksum = DecodeDeflateIgnoreChecksum(quirks);\n  std::vector<DecodeDeflateResult> results(inputs.size(),\n                                           DecodeDeflateResult(\"\", 0));\n  DecodeDeflateBatchLane lanes[2];\n  for (auto& lane : lanes) {\n    if (!lane.dec || !lane.crc32 || !lane.adler32) {\n      for (auto& result : results) {\n        result.error_message = DecodeDeflate_OutOfMemory;\n      }\n      return results;\n    }\n  }\n\n  size_t next = 0;\n  while (true) {\n    // Run each lane until it is ready to interleave, starting the next input\n    // whenever a lane is done.\n    for (auto& lane : lanes) {\n      while (!lane.ready) {\n        if (!lane.active) {\n          if (next >= inputs.size()) {\n            break;\n     " +
+	"     }\n          size_t i = next++;\n          std::string error_message =\n              lane.Start(i, inputs[i], framing, ignore_checksum);\n          if (!error_message.empty()) {\n            results[i] = DecodeDeflateResult(std::move(error_message), 0);\n            continue;\n          }\n        }\n        std::string error_message = lane.Advance(callbacks);\n        if (!lane.active) {\n          results[lane.index] = DecodeDeflateResult(std::move(error_message),\n                                                    lane.num_dst_bytes);\n        }\n      }\n    }\n\n    if (lanes[0].ready && lanes[1].ready) {\n      wuffs_base__status status = lanes[0].dec->decode_interleaved(\n          &lanes[0].dst, &lanes[0].src, lanes[1].dec.get(), &lanes[1].dst,\n          &lanes[1].src);\n      if (!status.is_ok()) {\n        for (auto& lane : lanes) {\n          results[lane.index] =\n              DecodeDeflateResult(status.message(), lane.num_dst_bytes);\n          lane.active = false;\n        }\n      }\n    } else if (!lanes[0].read" +
+	"y && !lanes[1].ready) {\n      break;\n    }\n    // Resume the ready lanes. A lane that has not just been interleaved\n    // decodes the rest of its block by itself.\n    lanes[0].ready = false;\n    lanes[1].ready = false;\n  }\n  return results;\n}\n\n" +
+	"" +
+	"// --------\n\nDecodeDeflateCheckpoint::DecodeDeflateCheckpoint()\n    : dst_pos(0), src_pos(0), pending_bits(0), num_pending_bits(0) {}\n\nDecodeDeflateIndex::DecodeDeflateIndex()\n    : framing(0), spacing(0), num_dst_bytes(0) {}\n\nconst DecodeDeflateCheckpoint*  //\nDecodeDeflateIndex::Find(uint64_t dst_pos) const {\n  // Binary search for the number of checkpoints at or before dst_pos.\n  size_t lo = 0;\n  size_t hi = checkpoints.size();\n  while (lo < hi) {\n    size_t mid = lo + ((hi - lo) / 2);\n    if (checkpoints[mid].dst_pos <= dst_pos) {\n      lo = mid + 1;\n    } else {\n      hi = mid;\n    }\n  }\n  return (lo > 0) ? &checkpoints[lo - 1] : nullptr;\n}\n\nnamespace {\n\nvoid  //\nDecodeDeflateAppendLE(std::string& s, uint64_t x, size_t n) {\n  for (size_t i = 0; i < n; i++) {\n    s.push_back((char)(uint8_t)(x >> (8 * i)));\n  }\n}\n\n}  // namespace\n\nstd::string  //\nDecodeDeflateIndex::Serialize() const {\n  std::string s(\"WDIX\");\n  DecodeDeflateAppendLE(s, framing, 4);\n  DecodeDeflateAppendLE(s, spacing, 8);\n  DecodeDeflateAp" +
+	"pendLE(s, num_dst_bytes, 8);\n  DecodeDeflateAppendLE(s, checkpoints.size(), 4);\n  for (const auto& c : checkpoints) {\n    size_t history_len = (c.history.size() < 32768) ? c.history.size() : 32768;\n    DecodeDeflateAppendLE(s, c.dst_pos, 8);\n    DecodeDeflateAppendLE(s, c.src_pos, 8);\n    DecodeDeflateAppendLE(s, c.num_pending_bits & 7, 1);\n    DecodeDeflateAppendLE(s, c.pending_bits, 1);\n    DecodeDeflateAppendLE(s, history_len, 2);\n    s.append(c.history, c.history.size() - history_len, history_len);\n  }\n  return s;\n}\n\nstd::string  //\nDecodeDeflateIndex::Parse(const uint8_t* ptr, size_t len) {\n  framing = 0;\n  spacing = 0;\n  num_dst_bytes = 0;\n  checkpoints.clear();\n\n  if ((len < 28) || (memcmp(ptr, \"WDIX\", 4) != 0)) {\n    return DecodeDeflate_BadIndex;\n  }\n  uint32_t f = wuffs_base__peek_u32le__no_bounds_check(ptr + 4);\n  uint64_t s = wuffs_base__peek_u64le__no_bounds_check(ptr + 8);\n  uint64_t n = wuffs_base__peek_u64le__no_bounds_check(ptr + 16);\n  uint32_t num_checkpoints = wuffs_base__peek_u32le__no_bo" +
+	"unds_check(ptr + 24);\n  ptr += 28;\n  len -= 28;\n\n  std::vector<DecodeDeflateCheckpoint> cs;\n  for (uint32_t i = 0; i < num_checkpoints; i++) {\n    if (len < 20) {\n      return DecodeDeflate_BadIndex;\n    }\n    DecodeDeflateCheckpoint c;\n    c.dst_pos = wuffs_base__peek_u64le__no_bounds_check(ptr + 0);\n    c.src_pos = wuffs_base__peek_u64le__no_bounds_check(ptr + 8);\n    c.num_pending_bits = ptr[16];\n    c.pending_bits = ptr[17];\n    size_t history_len = wuffs_base__peek_u16le__no_bounds_check(ptr + 18);\n    ptr += 20;\n    len -= 20;\n    if ((c.num_pending_bits >= 8) ||\n        ((c.pending_bits >> c.num_pending_bits) != 0) ||\n        (history_len > 32768) || (history_len > len) ||\n        (history_len > c.dst_pos) ||\n        (!cs.empty() && (cs.back().dst_pos > c.dst_pos))) {\n      return DecodeDeflate_BadIndex;\n    }\n    c.history.assign((const char*)ptr, history_len);\n    ptr += history_len;\n    len -= history_len;\n    cs.push_back(std::move(c));\n  }\n  if (len != 0) {\n    return DecodeDeflate_BadIndex;\n  }\n\n" +
+	"  framing = f;\n  spacing = s;\n  num_dst_bytes = n;\n  checkpoints = std::move(cs);\n  return \"\";\n}\n\nconst char DecodeDeflate_BadCheckpoint[] =  //\n    \"wuffs_aux::DecodeDeflate: bad checkpoint\";\nconst char DecodeDeflate_BadIndex[] =  //\n    \"wuffs_aux::DecodeDeflate: bad index\";\n\nnamespace {\n\nDecodeDeflateResult  //\nDecodeDeflateWithIndex0(DecodeDeflateCallbacks& callbacks,\n                        sync_io::Input& input,\n                        DecodeDeflateIndex& index,\n                        uint32_t framing,\n                        uint64_t spacing,\n                        bool ignore_checksum) {\n  index = DecodeDeflateIndex();\n  index.framing = framing;\n  index.spacing = spacing;\n\n  wuffs_deflate__decoder::unique_ptr dec = wuffs_deflate__decoder::alloc();\n  wuffs_crc32__ieee_hasher::unique_ptr crc32 =\n      wuffs_crc32__ieee_hasher::alloc();\n  wuffs_adler32__hasher::unique_ptr adler32 = wuffs_adler32__hasher::alloc();\n  if (!dec || !crc32 || !adler32) {\n    return DecodeDeflateResult(DecodeDeflate_OutOfMemo" +
+	"ry, 0);\n  }\n  dec->set_quirk_enabled(WUFFS_DEFLATE__QUIRK_SUSPEND_AT_BLOCK_BOUNDARIES,\n                         true);\n\n  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();\n  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();\n  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);\n  if (!io_buf) {\n    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);\n    fallback_io_buf =\n        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);\n    io_buf = &fallback_io_buf;\n  }\n  uint64_t src_pos0 = io_buf->reader_position();\n\n  // Skip the gzip or zlib header, which has to fit in io_buf.\n  while (true) {\n    std::string error_message;\n    size_t header_len = DecodeDeflateHeaderLength(io_buf->reader_slice(),\n                                                  framing, error_message);\n    if (error_message.empty()) {\n      io_buf->meta.ri += header_len;\n      break;\n    } else if ((error_message != DecodeDeflate_UnexpectedEndOfFile) ||\n               ((io_buf->meta.ri" +
+	" == 0) &&\n                (io_buf->meta.wi == io_buf->data.len))) {\n      return DecodeDeflateResult(std::move(error_message), 0);\n    }\n    error_message = DecodeDeflateFill(input, io_buf);\n    if (!error_message.empty()) {\n      return DecodeDeflateResult(std::move(error_message), 0);\n    }\n  }\n  index.checkpoints.push_back(DecodeDeflateCheckpoint());\n  index.checkpoints.back().src_pos = io_buf->reader_position() - src_pos0;\n\n  // dst holds (at least) the most recent 32 KiB of output, as history for\n  // the checkpoints. That history is also valid history for dec.\n  std::unique_ptr<uint8_t[]> dst_array(new uint8_t[3 * 32768]);\n  wuffs_base__io_buffer dst =\n      wuffs_base__ptr_u8__writer(dst_array.get(), 3 * 32768);\n  uint8_t work_array[1];\n  uint32_t checksum = 0;\n\n  while (true) {\n    size_t wi0 = dst.meta.wi;\n    wuffs_base__status status = dec->transform_io(\n        &dst, io_buf, wuffs_base__make_slice_u8(work_array, 0));\n    if (dst.meta.wi > wi0) {\n      wuffs_base__slice_u8 s =\n          wuffs_base_" +
+	"_make_slice_u8(dst.data.ptr + wi0, dst.meta.wi - wi0);\n      if (framing == WUFFS_BASE__FOURCC__GZ) {\n        checksum = crc32->update_u32(s);\n      } else if (framing == WUFFS_BASE__FOURCC__ZLIB) {\n        checksum = adler32->update_u32(s);\n      }\n      index.num_dst_bytes += s.len;\n      std::string error_message = callbacks.Append(s.ptr, s.len);\n      if (!error_message.empty()) {\n        return DecodeDeflateResult(std::move(error_message),\n                                   index.num_dst_bytes);\n      }\n    }\n\n    if (status.is_ok()) {\n      break;\n    } else if (status.repr == wuffs_deflate__suspension__block_boundary) {\n      if ((index.num_dst_bytes - index.checkpoints.back().dst_pos) >= spacing) {\n        size_t history_len = (dst.meta.wi < 32768) ? dst.meta.wi : 32768;\n        DecodeDeflateCheckpoint c;\n        c.dst_pos = index.num_dst_bytes;\n        c.src_pos = io_buf->reader_position() - src_pos0;\n        c.pending_bits = dec->pending_bits();\n        c.num_pending_bits = dec->num_pending_bits();\n" +
+	"        c.history.assign(\n            (const char*)(dst.data.ptr + dst.meta.wi - history_len),\n            history_len);\n        index.checkpoints.push_back(std::move(c));\n      }\n    } else if (status.repr == wuffs_base__suspension__short_read) {\n      std::string error_message = DecodeDeflateFill(input, io_buf);\n      if (!error_message.empty()) {\n        return DecodeDeflateResult(std::move(error_message),\n                                   index.num_dst_bytes);\n      }\n    } else if (status.repr != wuffs_base__suspension__short_write) {\n      return DecodeDeflateResult(status.message(), index.num_dst_bytes);\n    }\n\n    if (dst.meta.wi > (2 * 32768)) {\n      memmove(dst.data.ptr, dst.data.ptr + dst.meta.wi - 32768, 32768);\n      dst.meta.wi = 32768;\n    }\n  }\n\n  // Check the gzip or zlib trailer.\n  size_t trailer_len = (framing == WUFFS_BASE__FOURCC__GZ)     ? 8\n                       : (framing == WUFFS_BASE__FOURCC__ZLIB) ? 4\n                                                               : 0;\n  while (io" +
+	"_buf->reader_length() < trailer_len) {\n    std::string error_message = DecodeDeflateFill(input, io_buf);\n    if (!error_message.empty()) {\n      return DecodeDeflateResult(std::move(error_message),\n                                 index.num_dst_bytes);\n    }\n  }\n  const uint8_t* trailer = io_buf->reader_pointer();\n  if (ignore_checksum) {\n    // No-op.\n  } else if (framing == WUFFS_BASE__FOURCC__GZ) {\n    if ((checksum != wuffs_base__peek_u32le__no_bounds_check(trailer + 0)) ||\n        (((uint32_t)(index.num_dst_bytes)) !=\n         wuffs_base__peek_u32le__no_bounds_check(trailer + 4))) {\n      return DecodeDeflateResult(DecodeDeflate_BadChecksum,\n                                 index.num_dst_bytes);\n    }\n  } else if (framing == WUFFS_BASE__FOURCC__ZLIB) {\n    if (checksum != wuffs_base__peek_u32be__no_bounds_check(trailer)) {\n      return DecodeDeflateResult(DecodeDeflate_BadChecksum,\n                                 index.num_dst_bytes);\n    }\n  }\n  io_buf->meta.ri += trailer_len;\n  return DecodeDeflateRes" +
+	"ult(\"\", index.num_dst_bytes);\n}\n\nDecodeDeflateResult  //\nDecodeDeflateRange0(DecodeDeflateCallbacks& callbacks,\n                    sync_io::Input& input,\n                    const DecodeDeflateCheckpoint& checkpoint,\n                    uint64_t dst_pos,\n                    uint64_t dst_len) {\n  if (checkpoint.dst_pos > dst_pos) {\n    return DecodeDeflateResult(DecodeDeflate_BadCheckpoint, 0);\n  }\n  uint64_t end_pos =\n      (dst_len <= (UINT64_MAX - dst_pos)) ? (dst_pos + dst_len) : UINT64_MAX;\n\n  wuffs_deflate__decoder::unique_ptr dec = wuffs_deflate__decoder::alloc();\n  if (!dec) {\n    return DecodeDeflateResult(DecodeDeflate_OutOfMemory, 0);\n  }\n  std::string error_message = DecodeDeflateRestore(*dec, checkpoint);\n  if (!error_message.empty()) {\n    return DecodeDeflateResult(std::move(error_message), 0);\n  }\n\n  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();\n  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();\n  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);\n  if" +
+	" (!io_buf) {\n    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);\n    fallback_io_buf =\n        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);\n    io_buf = &fallback_io_buf;\n  }\n\n  std::unique_ptr<uint8_t[]> dst_array(\n      new uint8_t[DecodeDeflateScratchLength]);\n  wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(\n      dst_array.get(), DecodeDeflateScratchLength);\n  uint8_t work_array[1];\n  uint64_t pos = checkpoint.dst_pos;\n  uint64_t num_dst_bytes = 0;\n\n  while (pos < end_pos) {\n    dst.meta.wi = 0;\n    wuffs_base__status status = dec->transform_io(\n        &dst, io_buf, wuffs_base__make_slice_u8(work_array, 0));\n\n    // Clip the [pos, pos + dst.meta.wi) output to [dst_pos, end_pos).\n    uint64_t lo = (pos > dst_pos) ? pos : dst_pos;\n    uint64_t hi = ((end_pos - pos) > dst.meta.wi) ? (pos + dst.meta.wi)  //\n                                                  : end_pos;\n    if (lo < hi) {\n      error_message =\n          callbacks.Append(dst.data.ptr + (lo - pos), (siz" +
+	"e_t)(hi - lo));\n      num_dst_bytes += hi - lo;\n      if (!error_message.empty()) {\n        return DecodeDeflateResult(std::move(error_message), num_dst_bytes);\n      }\n    }\n    pos += dst.meta.wi;\n\n    if (status.is_ok()) {\n      break;\n    } else if (status.repr == wuffs_base__suspension__short_read) {\n      error_message = DecodeDeflateFill(input, io_buf);\n      if (!error_message.empty()) {\n        return DecodeDeflateResult(std::move(error_message), num_dst_bytes);\n      }\n    } else if (status.repr != wuffs_base__suspension__short_write) {\n      return DecodeDeflateResult(status.message(), num_dst_bytes);\n    }\n  }\n  return DecodeDeflateResult(\"\", num_dst_bytes);\n}\n\n}  // namespace\n\nDecodeDeflateResult  //\nDecodeDeflateWithIndex(DecodeDeflateCallbacks& callbacks,\n                       sync_io::Input& input,\n                       DecodeDeflateIndex& index,\n                       uint32_t framing,\n                       uint64_t spacing,\n                       wuffs_base__slice_u32 quirks) {\n  DecodeDe" +
+	"flateResult result =\n      DecodeDeflateWithIndex0(callbacks, input, index, framing, spacing,\n                              DecodeDeflateIgnoreChecksum(quirks));\n  callbacks.Done(result, input);\n  return result;\n}\n\nstd::string  //\nDecodeDeflateRestore(wuffs_deflate__decoder& dec,\n                     const DecodeDeflateCheckpoint& checkpoint) {\n  if ((checkpoint.num_pending_bits >= 8) ||\n      (checkpoint.history.size() > 32768)) {\n    return DecodeDeflate_BadCheckpoint;\n  }\n  wuffs_base__status status =\n      dec.initialize(sizeof__wuffs_deflate__decoder(), WUFFS_VERSION,\n                     WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);\n  if (!status.is_ok()) {\n    return status.message();\n  }\n  if (!checkpoint.history.empty()) {\n    dec.add_history(wuffs_base__make_slice_u8(\n        (uint8_t*)(const_cast<char*>(checkpoint.history.data())),\n        checkpoint.history.size()));\n  }\n  dec.set_pending_bits(checkpoint.pending_bits, checkpoint.num_pending_bits);\n  return \"\";\n}\n\nDecodeDeflateResult  //" +
+	"\nDecodeDeflateRange(DecodeDeflateCallbacks& callbacks,\n                   sync_io::Input& input,\n                   const DecodeDeflateCheckpoint& checkpoint,\n                   uint64_t dst_pos,\n                   uint64_t dst_len) {\n  DecodeDeflateResult result =\n      DecodeDeflateRange0(callbacks, input, checkpoint, dst_pos, dst_len);\n  callbacks.Done(result, input);\n  return result;\n}\n\n}  // namespace wuffs_aux\n\n#endif  // !defined(WUFFS_CONFIG__MODULES) ||\n        // defined(WUFFS_CONFIG__MODULE__AUX__DEFLATE)\n" +
+	""
+
+const AuxDeflateHh = "" +
+	"// ---------------- Auxiliary - Deflate\n\n#include <vector>\n\nnamespace wuffs_aux {\n\nstruct DecodeDeflateResult {\n  DecodeDeflateResult(std::string&& error_message0, uint64_t num_dst_bytes0);\n\n  std::string error_message;\n  uint64_t num_dst_bytes;\n};\n\nclass DecodeDeflateCallbacks {\n public:\n  virtual ~DecodeDeflateCallbacks();\n\n  // Append is called with the decoded output, in order. Each call's ptr is\n  // only valid for the duration of that call. Returning a non-empty string\n  // stops the decoding, with that string as the error_message.\n  //\n  // Even when DecodeDeflate uses multiple threads, Append is only ever called\n  // from the thread that called DecodeDeflate.\n  virtual std::string Append(const uint8_t* ptr, size_t len) = 0;\n\n  // Done is always the last Callback method called by DecodeDeflate, whether\n  // or not decoding the input encountered an error.\n  //\n  // The default Done implementation is a no-op.\n  virtual void  //\n  Done(DecodeDeflateResult& result, sync_io::Input& input);\n};\n\nextern const " +
+	"char DecodeDeflate_BadChecksum[];\nextern const char DecodeDeflate_BadHeader[];\nextern const char DecodeDeflate_OutOfMemory[];\nextern const char DecodeDeflate_UnexpectedEndOfFile[];\nextern const char DecodeDeflate_UnsupportedFraming[];\n\n// DecodeDeflate decodes the compressed data in input, calling callbacks.Append\n// with the decoded output.\n//\n// The framing is one of:\n//  - 0, meaning raw DEFLATE (RFC 1951).\n//  - WUFFS_BASE__FOURCC__GZ, meaning gzip (RFC 1952).\n//  - WUFFS_BASE__FOURCC__ZLIB, meaning zlib (RFC 1950).\n// Only the first gzip member is decoded and zlib preset dictionaries are not\n// supported.\n//\n// When num_threads is 0 or 1, decoding is a single streaming pass that uses\n// O(1) memory. Otherwise, the entire input is read into memory (unless it is\n// already there: a sync_io::MemoryInput) and then split into chunks that are\n// decoded speculatively and in parallel, up to num_threads chunks at a time:\n//  1. Each thread looks for a likely DEFLATE block boundary within its chunk,\n//     confir" +
+	"ming it with a trial decode.\n//  2. Each thread decodes from that boundary with a placeholder 32 KiB\n//     history, since the real history (the previous chunk's output) is not\n//     yet known. Back-references into the history produce placeholder bytes.\n//     Decoding is run twice (with two different placeholder histories) to\n//     tell literal bytes apart from placeholders and to identify which\n//     history position each placeholder refers to.\n//  3. The chunks are stitched together in order, replacing placeholders once\n//     the real history is known. A chunk whose speculative starting point\n//     does not line up with where its predecessor actually ended (e.g. a\n//     false positive block boundary) is instead decoded conventionally, so\n//     that the output is always identical to single-threaded decoding.\n//\n// Peak memory usage is therefore the input size plus a bounded amount (on\n// the order of 64 MiB) per thread.\n//\n// WUFFS_BASE__QUIRK_IGNORE_CHECKSUM is the only quirk that has an effect.\nDec" +
+	"odeDeflateResult  //\nDecodeDeflate(DecodeDeflateCallbacks& callbacks,\n              sync_io::Input& input,\n              uint32_t framing = 0,\n              uint32_t num_threads = 1,\n              wuffs_base__slice_u32 quirks = wuffs_base__empty_slice_u32());\n\n// DecodeGzipMembers decodes all of the concatenated gzip members (RFC 1952\n// section 2.2) in input, calling callbacks.Append with the decoded output. The\n// CRC-32 and ISIZE of each member are checked separately.\n//\n// BGZF files (as used by e.g. samtools) are gzip members whose FEXTRA field\n// holds a \"BC\" subfield: the member's compressed size. When num_threads is\n// more than 1, such members are read ahead (without decoding) and then\n// decoded in parallel, in batches, by a pool of per-thread gzip decoders. The\n// batches are bounded (WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH, 4 MiB by\n// default, of decoded output per thread) and the output is reassembled in\n// order. Members without a \"BC\" subfield are decoded single-threaded, as\n// their leng" +
+	"th is not known up front. For well-formed BGZF \"BC\" subfields,\n// the output and any error message are the same as for num_threads == 1.\n//\n// WUFFS_BASE__QUIRK_IGNORE_CHECKSUM is the only quirk that has an effect.\nDecodeDeflateResult  //\nDecodeGzipMembers(DecodeDeflateCallbacks& callbacks,\n                  sync_io::Input& input,\n                  uint32_t num_threads = 1,\n                  wuffs_base__slice_u32 quirks = wuffs_base__empty_slice_u32());\n\n" +
+	"" +
+	"// --------\n\nclass DecodeDeflateBatchCallbacks {\n public:\n  virtual ~DecodeDeflateBatchCallbacks();\n\n  // Append is called with the i'th input's decoded output, in order. Calls\n  // for different inputs can be interleaved. Each call's ptr is only valid\n  // for the duration of that call. Returning a non-empty string stops the\n  // decoding of the i'th input, with that string as its error_message.\n  virtual std::string Append(size_t i, const uint8_t* ptr, size_t len) = 0;\n};\n\n// DecodeDeflateBatch decodes each of the inputs, independent compressed\n// streams that are entirely in memory, calling callbacks.Append with their\n// decoded output. It returns one DecodeDeflateResult per input. The framing\n// is as for DecodeDeflate.\n//\n// It is optimized for many small inputs. Decoding a Huffman-compressed block\n// is usually bound by the latency of its (dependent) table lookups, so two\n// inputs are decoded at a time, on the calling thread, with their blocks'\n// symbols decoded in one interleaved loop (see the deflat" +
+	"e decoder's\n// decode_interleaved method) to overlap those lookups. Each input's output\n// and result are the same as DecodeDeflate's (single-threaded) would be.\n//\n// WUFFS_BASE__QUIRK_IGNORE_CHECKSUM is the only quirk that has an effect.\nstd::vector<DecodeDeflateResult>  //\nDecodeDeflateBatch(\n    DecodeDeflateBatchCallbacks& callbacks,\n    const std::vector<wuffs_base__slice_u8>& inputs,\n    uint32_t framing = 0,\n    wuffs_base__slice_u32 quirks = wuffs_base__empty_slice_u32());\n\n" +
+	"" +
+	"// --------\n\n// DecodeDeflateCheckpoint is a point in a DEFLATE stream (always a block\n// boundary) from which decoding can resume, without having to decode\n// everything before it.\nstruct DecodeDeflateCheckpoint {\n  DecodeDeflateCheckpoint();\n\n  // dst_pos is the position in the decoded output.\n  uint64_t dst_pos;\n  // src_pos is the position in the compressed input (including any gzip or\n  // zlib header) of the first whole byte after the block boundary.\n  uint64_t src_pos;\n  // pending_bits and num_pending_bits (less than 8) are the bits of the byte\n  // at src_pos-1 that are after the block boundary.\n  uint32_t pending_bits;\n  uint32_t num_pending_bits;\n  // history is the (up to) 32 KiB of decoded output just before dst_pos.\n  std::string history;\n};\n\n// DecodeDeflateIndex is a list of DecodeDeflateCheckpoints, in increasing\n// dst_pos order. It is similar to zlib's examples/zran.c program.\nstruct DecodeDeflateIndex {\n  DecodeDeflateIndex();\n\n  // Find returns the last checkpoint whose dst_pos is at or b" +
+	"efore dst_pos,\n  // or nullptr if there is no such checkpoint.\n  const DecodeDeflateCheckpoint* Find(uint64_t dst_pos) const;\n\n  // Serialize returns the index in a compact binary format that Parse reads.\n  // All integers are little-endian:\n  //  - 4 byte magic \"WDIX\", then u32 framing, u64 spacing, u64 num_dst_bytes\n  //    and u32 number of checkpoints.\n  //  - For each checkpoint: u64 dst_pos, u64 src_pos, u8 num_pending_bits, u8\n  //    pending_bits, u16 history length and then the history bytes.\n  std::string Serialize() const;\n\n  // Parse replaces the index's contents with the serialized form in (ptr,\n  // len). It returns an empty string on success or an error message.\n  std::string Parse(const uint8_t* ptr, size_t len);\n\n  uint32_t framing;\n  uint64_t spacing;\n  uint64_t num_dst_bytes;\n  std::vector<DecodeDeflateCheckpoint> checkpoints;\n};\n\nextern const char DecodeDeflate_BadCheckpoint[];\nextern const char DecodeDeflate_BadIndex[];\n\n// DecodeDeflateWithIndex is like single-threaded DecodeDeflate but " +
+	"also\n// replaces index's contents with checkpoints. The first checkpoint is at the\n// start of the DEFLATE stream. Each subsequent checkpoint is at the first\n// block boundary that is at least spacing bytes (of decoded output) after\n// the previous checkpoint.\n//\n// With a spacing of N, decoding from a checkpoint to reach any given position\n// decodes at most N bytes plus the length of one DEFLATE block.\nDecodeDeflateResult  //\nDecodeDeflateWithIndex(\n    DecodeDeflateCallbacks& callbacks,\n    sync_io::Input& input,\n    DecodeDeflateIndex& index,\n    uint32_t framing = 0,\n    uint64_t spacing = 1024 * 1024,\n    wuffs_base__slice_u32 quirks = wuffs_base__empty_slice_u32());\n\n// DecodeDeflateRestore re-initializes dec so that it resumes decoding at the\n// checkpoint. The caller is responsible for then feeding dec the compressed\n// input starting at checkpoint.src_pos. It returns an empty string on success\n// or an error message.\nstd::string  //\nDecodeDeflateRestore(wuffs_deflate__decoder& dec,\n                 " +
+	"    const DecodeDeflateCheckpoint& checkpoint);\n\n// DecodeDeflateRange calls callbacks.Append with the decoded output in the\n// range [dst_pos, dst_pos + dst_len), clipped to the end of the DEFLATE\n// stream, by decoding from the checkpoint. The checkpoint is typically\n// index.Find(dst_pos) and its dst_pos must not be after dst_pos.\n//\n// The input must start at checkpoint.src_pos, e.g. after a fseek call. Since\n// decoding does not start at the beginning, no checksums are verified.\nDecodeDeflateResult  //\nDecodeDeflateRange(DecodeDeflateCallbacks& callbacks,\n                   sync_io::Input& input,\n                   const DecodeDeflateCheckpoint& checkpoint,\n                   uint64_t dst_pos,\n                   uint64_t dst_len);\n\n}  // namespace wuffs_aux\n" +
+	""
+
 const AuxImageCc = "" +
-	"// ---------------- Auxiliary - Image\n\n#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__AUX__IMAGE)\n\n#include <utility>\n\nnamespace wuffs_aux {\n\nDecodeImageResult::DecodeImageResult(MemOwner&& pixbuf_mem_owner0,\n                                     wuffs_base__pixel_buffer pixbuf0,\n                                     std::string&& error_message0)\n    : pixbuf_mem_owner(std::move(pixbuf_mem_owner0)),\n      pixbuf(pixbuf0),\n      error_message(std::move(error_message0)) {}\n\nDecodeImageResult::DecodeImageResult(std::string&& error_message0)\n    : pixbuf_mem_owner(nullptr, &free),\n      pixbuf(wuffs_base__null_pixel_buffer()),\n      error_message(std::move(error_message0)) {}\n\nDecodeImageCallbacks::~DecodeImageCallbacks() {}\n\nDecodeImageCallbacks::AllocPixbufResult::AllocPixbufResult(\n    MemOwner&& mem_owner0,\n    wuffs_base__pixel_buffer pixbuf0)\n    : mem_owner(std::move(mem_owner0)), pixbuf(pixbuf0), error_message(\"\") {}\n\nDecodeImageCallbacks::AllocPixbufResult::AllocPixbufResult(\n    std:" +
-	":string&& error_message0)\n    : mem_owner(nullptr, &free),\n      pixbuf(wuffs_base__null_pixel_buffer()),\n      error_message(std::move(error_message0)) {}\n\nDecodeImageCallbacks::AllocWorkbufResult::AllocWorkbufResult(\n    MemOwner&& mem_owner0,\n    wuffs_base__slice_u8 workbuf0)\n    : mem_owner(std::move(mem_owner0)), workbuf(workbuf0), error_message(\"\") {}\n\nDecodeImageCallbacks::AllocWorkbufResult::AllocWorkbufResult(\n    std::string&& error_message0)\n    : mem_owner(nullptr, &free),\n      workbuf(wuffs_base__empty_slice_u8()),\n      error_message(std::move(error_message0)) {}\n\nwuffs_base__image_decoder::unique_ptr  //\nDecodeImageCallbacks::SelectDecoder(uint32_t fourcc,\n                                    wuffs_base__slice_u8 prefix) {\n  switch (fourcc) {\n#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__BMP)\n    case WUFFS_BASE__FOURCC__BMP:\n      return wuffs_bmp__decoder::alloc_as__wuffs_base__image_decoder();\n#endif\n\n#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE" +
-	"__GIF)\n    case WUFFS_BASE__FOURCC__GIF:\n      return wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder();\n#endif\n\n#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__NIE)\n    case WUFFS_BASE__FOURCC__NIE:\n      return wuffs_nie__decoder::alloc_as__wuffs_base__image_decoder();\n#endif\n\n#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__PNG)\n    case WUFFS_BASE__FOURCC__PNG: {\n      auto dec = wuffs_png__decoder::alloc_as__wuffs_base__image_decoder();\n      // Favor faster decodes over rejecting invalid checksums.\n      dec->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, true);\n      return dec;\n    }\n#endif\n\n#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__WBMP)\n    case WUFFS_BASE__FOURCC__WBMP:\n      return wuffs_wbmp__decoder::alloc_as__wuffs_base__image_decoder();\n#endif\n  }\n\n  return wuffs_base__image_decoder::unique_ptr(nullptr, &free);\n}\n\nwuffs_base__pixel_format  //\nDecodeImageCallbacks::SelectPixfmt(\n    const wuffs_base__image_config&" +
-	" image_config) {\n  return wuffs_base__make_pixel_format(WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL);\n}\n\nDecodeImageCallbacks::AllocPixbufResult  //\nDecodeImageCallbacks::AllocPixbuf(const wuffs_base__image_config& image_config,\n                                  bool allow_uninitialized_memory) {\n  uint32_t w = image_config.pixcfg.width();\n  uint32_t h = image_config.pixcfg.height();\n  if ((w == 0) || (h == 0)) {\n    return AllocPixbufResult(\"\");\n  }\n  uint64_t len = image_config.pixcfg.pixbuf_len();\n  if ((len == 0) || (SIZE_MAX < len)) {\n    return AllocPixbufResult(DecodeImage_UnsupportedPixelConfiguration);\n  }\n  void* ptr =\n      allow_uninitialized_memory ? malloc((size_t)len) : calloc((size_t)len, 1);\n  if (!ptr) {\n    return AllocPixbufResult(DecodeImage_OutOfMemory);\n  }\n  wuffs_base__pixel_buffer pixbuf;\n  wuffs_base__status status = pixbuf.set_from_slice(\n      &image_config.pixcfg,\n      wuffs_base__make_slice_u8((uint8_t*)ptr, (size_t)len));\n  if (!status.is_ok()) {\n    free(ptr);\n    return AllocPixbu" +
-	"fResult(status.message());\n  }\n  return AllocPixbufResult(MemOwner(ptr, &free), pixbuf);\n}\n\nDecodeImageCallbacks::AllocWorkbufResult  //\nDecodeImageCallbacks::AllocWorkbuf(wuffs_base__range_ii_u64 len_range,\n                                   bool allow_uninitialized_memory) {\n  uint64_t len = len_range.max_incl;\n  if (len == 0) {\n    return AllocWorkbufResult(\"\");\n  } else if (SIZE_MAX < len) {\n    return AllocWorkbufResult(DecodeImage_OutOfMemory);\n  }\n  void* ptr =\n      allow_uninitialized_memory ? malloc((size_t)len) : calloc((size_t)len, 1);\n  if (!ptr) {\n    return AllocWorkbufResult(DecodeImage_OutOfMemory);\n  }\n  return AllocWorkbufResult(\n      MemOwner(ptr, &free),\n      wuffs_base__make_slice_u8((uint8_t*)ptr, (size_t)len));\n}\n\nvoid  //\nDecodeImageCallbacks::Done(\n    DecodeImageResult& result,\n    sync_io::Input& input,\n    IOBuffer& buffer,\n    wuffs_base__image_decoder::unique_ptr image_decoder) {}\n\nconst char DecodeImage_BufferIsTooShort[] =  //\n    \"wuffs_aux::DecodeImage: buffer is too short" +
-	"\";\nconst char DecodeImage_MaxInclDimensionExceeded[] =  //\n    \"wuffs_aux::DecodeImage: max_incl_dimension exceeded\";\nconst char DecodeImage_OutOfMemory[] =  //\n    \"wuffs_aux::DecodeImage: out of memory\";\nconst char DecodeImage_UnexpectedEndOfFile[] =  //\n    \"wuffs_aux::DecodeImage: unexpected end of file\";\nconst char DecodeImage_UnsupportedImageFormat[] =  //\n    \"wuffs_aux::DecodeImage: unsupported image format\";\nconst char DecodeImage_UnsupportedPixelBlend[] =  //\n    \"wuffs_aux::DecodeImage: unsupported pixel blend\";\nconst char DecodeImage_UnsupportedPixelConfiguration[] =  //\n    \"wuffs_aux::DecodeImage: unsupported pixel configuration\";\nconst char DecodeImage_UnsupportedPixelFormat[] =  //\n    \"wuffs_aux::DecodeImage: unsupported pixel format\";\n\n" +
-	"" +
-	"// --------\n\nnamespace {\n\nstd::string  //\nDecodeImageAdvanceIOBuf(sync_io::Input& input,\n                        wuffs_base__io_buffer& io_buf,\n                        bool compactable,\n                        uint64_t min_excl_pos,\n                        uint64_t pos) {\n  if ((pos <= min_excl_pos) || (pos < io_buf.reader_position())) {\n    // Redirects must go forward.\n    return DecodeImage_UnsupportedImageFormat;\n  }\n  while (true) {\n    uint64_t relative_pos = pos - io_buf.reader_position();\n    if (relative_pos <= io_buf.reader_length()) {\n      io_buf.meta.ri += (size_t)relative_pos;\n      break;\n    } else if (io_buf.meta.closed) {\n      return DecodeImage_UnexpectedEndOfFile;\n    }\n    io_buf.meta.ri = io_buf.meta.wi;\n    if (compactable) {\n      io_buf.compact();\n    }\n    std::string error_message = input.CopyIn(&io_buf);\n    if (!error_message.empty()) {\n      return error_message;\n    }\n  }\n  return \"\";\n}\n\nDecodeImageResult  //\nDecodeImage0(wuffs_base__image_decoder::unique_ptr& image_decoder,\n  " +
-	"           DecodeImageCallbacks& callbacks,\n             sync_io::Input& input,\n             wuffs_base__io_buffer& io_buf,\n             wuffs_base__pixel_blend pixel_blend,\n             wuffs_base__color_u32_argb_premul background_color,\n             uint32_t max_incl_dimension) {\n  // Check args.\n  switch (pixel_blend) {\n    case WUFFS_BASE__PIXEL_BLEND__SRC:\n    case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n      break;\n    default:\n      return DecodeImageResult(DecodeImage_UnsupportedPixelBlend);\n  }\n\n  wuffs_base__image_config image_config = wuffs_base__null_image_config();\n  uint64_t start_pos = io_buf.reader_position();\n  bool redirected = false;\n  int32_t fourcc = 0;\nredirect:\n  do {\n    // Determine the image format.\n    if (!redirected) {\n      while (true) {\n        fourcc = wuffs_base__magic_number_guess_fourcc(io_buf.reader_slice());\n        if (fourcc > 0) {\n          break;\n        } else if ((fourcc == 0) && (io_buf.reader_length() >= 64)) {\n          break;\n        } else if (io_buf.meta.closed ||" +
-	" (io_buf.writer_length() == 0)) {\n          fourcc = 0;\n          break;\n        }\n        std::string error_message = input.CopyIn(&io_buf);\n        if (!error_message.empty()) {\n          return DecodeImageResult(std::move(error_message));\n        }\n      }\n    } else {\n      wuffs_base__io_buffer empty = wuffs_base__empty_io_buffer();\n      wuffs_base__more_information minfo = wuffs_base__empty_more_information();\n      wuffs_base__status tmm_status =\n          image_decoder->tell_me_more(&empty, &minfo, &io_buf);\n      if (tmm_status.repr != nullptr) {\n        return DecodeImageResult(tmm_status.message());\n      }\n      if (minfo.flavor != WUFFS_BASE__MORE_INFORMATION__FLAVOR__IO_REDIRECT) {\n        return DecodeImageResult(DecodeImage_UnsupportedImageFormat);\n      }\n      uint64_t pos = minfo.io_redirect__range().min_incl;\n      std::string error_message = DecodeImageAdvanceIOBuf(\n          input, io_buf, !input.BringsItsOwnIOBuffer(), start_pos, pos);\n      if (!error_message.empty()) {\n        return" +
-	" DecodeImageResult(std::move(error_message));\n      }\n      fourcc = (int32_t)(minfo.io_redirect__fourcc());\n      if (fourcc == 0) {\n        return DecodeImageResult(DecodeImage_UnsupportedImageFormat);\n      }\n      image_decoder.reset();\n    }\n\n    // Select the image decoder.\n    image_decoder = callbacks.SelectDecoder(\n        (uint32_t)fourcc,\n        fourcc ? wuffs_base__empty_slice_u8() : io_buf.reader_slice());\n    if (!image_decoder) {\n      return DecodeImageResult(DecodeImage_UnsupportedImageFormat);\n    }\n\n    // Decode the image config.\n    while (true) {\n      wuffs_base__status id_dic_status =\n          image_decoder->decode_image_config(&image_config, &io_buf);\n      if (id_dic_status.repr == nullptr) {\n        break;\n      } else if (id_dic_status.repr == wuffs_base__note__i_o_redirect) {\n        if (redirected) {\n          return DecodeImageResult(DecodeImage_UnsupportedImageFormat);\n        }\n        redirected = true;\n        goto redirect;\n      } else if (id_dic_status.repr != wuffs_bas" +
-	"e__suspension__short_read) {\n        return DecodeImageResult(id_dic_status.message());\n      } else if (io_buf.meta.closed) {\n        return DecodeImageResult(DecodeImage_UnexpectedEndOfFile);\n      } else {\n        std::string error_message = input.CopyIn(&io_buf);\n        if (!error_message.empty()) {\n          return DecodeImageResult(std::move(error_message));\n        }\n      }\n    }\n  } while (false);\n\n  // Select the pixel format.\n  uint32_t w = image_config.pixcfg.width();\n  uint32_t h = image_config.pixcfg.height();\n  if ((w > max_incl_dimension) || (h > max_incl_dimension)) {\n    return DecodeImageResult(DecodeImage_MaxInclDimensionExceeded);\n  }\n  wuffs_base__pixel_format pixel_format = callbacks.SelectPixfmt(image_config);\n  if (pixel_format.repr != image_config.pixcfg.pixel_format().repr) {\n    switch (pixel_format.repr) {\n      case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      case WUFFS_BASE__PIXEL_FORMAT" +
-	"__BGRA_NONPREMUL_4X16LE:\n      case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n      case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n        break;\n      default:\n        return DecodeImageResult(DecodeImage_UnsupportedPixelFormat);\n    }\n    image_config.pixcfg.set(pixel_format.repr,\n                            WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, w, h);\n  }\n\n  // Allocate the pixel buffer.\n  bool valid_background_color =\n      wuffs_base__color_u32_argb_premul__is_valid(background_color);\n  DecodeImageCallbacks::AllocPixbufResult alloc_pixbuf_result =\n      callbacks.AllocPixbuf(image_config, valid_background_color);\n  if (!alloc_pixbuf_result.error_message.empty()) {\n    return DecodeImageResult(std::move(alloc_pixbuf_result.error_message));\n  }\n  wuffs_base__pixel_buffer pixel_buffer = alloc_pixbuf_result.pixbuf;\n  if (valid_background_color) {\n    wuffs_base__status pb_scufr_status = pixel_buffer.set_color_u32_fill_rect(\n        pixel_buffer.pixcfg.bounds(), b" +
-	"ackground_color);\n    if (pb_scufr_status.repr != nullptr) {\n      return DecodeImageResult(pb_scufr_status.message());\n    }\n  }\n\n  // Allocate the work buffer. Wuffs' decoders conventionally assume that this\n  // can be uninitialized memory.\n  wuffs_base__range_ii_u64 workbuf_len = image_decoder->workbuf_len();\n  DecodeImageCallbacks::AllocWorkbufResult alloc_workbuf_result =\n      callbacks.AllocWorkbuf(workbuf_len, true);\n  if (!alloc_workbuf_result.error_message.empty()) {\n    return DecodeImageResult(std::move(alloc_workbuf_result.error_message));\n  } else if (alloc_workbuf_result.workbuf.len < workbuf_len.min_incl) {\n    return DecodeImageResult(DecodeImage_BufferIsTooShort);\n  }\n\n  // Decode the frame config.\n  wuffs_base__frame_config frame_config = wuffs_base__null_frame_config();\n  while (true) {\n    wuffs_base__status id_dfc_status =\n        image_decoder->decode_frame_config(&frame_config, &io_buf);\n    if (id_dfc_status.repr == nullptr) {\n      break;\n    } else if (id_dfc_status.repr != wuffs_b" +
-	"ase__suspension__short_read) {\n      return DecodeImageResult(id_dfc_status.message());\n    } else if (io_buf.meta.closed) {\n      return DecodeImageResult(DecodeImage_UnexpectedEndOfFile);\n    } else {\n      std::string error_message = input.CopyIn(&io_buf);\n      if (!error_message.empty()) {\n        return DecodeImageResult(std::move(error_message));\n      }\n    }\n  }\n\n  // Decode the frame (the pixels).\n  //\n  // From here on, always returns the pixel_buffer. If we get this far, we can\n  // still display a partial image, even if we encounter an error.\n  std::string message(\"\");\n  if ((pixel_blend == WUFFS_BASE__PIXEL_BLEND__SRC_OVER) &&\n      frame_config.overwrite_instead_of_blend()) {\n    pixel_blend = WUFFS_BASE__PIXEL_BLEND__SRC;\n  }\n  while (true) {\n    wuffs_base__status id_df_status =\n        image_decoder->decode_frame(&pixel_buffer, &io_buf, pixel_blend,\n                                    alloc_workbuf_result.workbuf, nullptr);\n    if (id_df_status.repr == nullptr) {\n      break;\n    } else if (" +
-	"id_df_status.repr != wuffs_base__suspension__short_read) {\n      message = id_df_status.message();\n      break;\n    } else if (io_buf.meta.closed) {\n      message = DecodeImage_UnexpectedEndOfFile;\n      break;\n    } else {\n      std::string error_message = input.CopyIn(&io_buf);\n      if (!error_message.empty()) {\n        message = std::move(error_message);\n        break;\n      }\n    }\n  }\n  return DecodeImageResult(std::move(alloc_pixbuf_result.mem_owner),\n                           pixel_buffer, std::move(message));\n}\n\n}  // namespace\n\nDecodeImageResult  //\nDecodeImage(DecodeImageCallbacks& callbacks,\n            sync_io::Input& input,\n            wuffs_base__pixel_blend pixel_blend,\n            wuffs_base__color_u32_argb_premul background_color,\n            uint32_t max_incl_dimension) {\n  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();\n  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();\n  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);\n  if (!io_buf) {\n    fallba" +
-	"ck_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);\n    fallback_io_buf =\n        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);\n    io_buf = &fallback_io_buf;\n  }\n\n  wuffs_base__image_decoder::unique_ptr image_decoder(nullptr, &free);\n  DecodeImageResult result =\n      DecodeImage0(image_decoder, callbacks, input, *io_buf, pixel_blend,\n                   background_color, max_incl_dimension);\n  callbacks.Done(result, input, *io_buf, std::move(image_decoder));\n  return result;\n}\n\n}  // namespace wuffs_aux\n\n#endif  // !defined(WUFFS_CONFIG__MODULES) ||\n        // defined(WUFFS_CONFIG__MODULE__AUX__IMAGE)\n" +
+	"// ---------------- Auxiliary - Image\n\n#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__AUX__IMAGE)\n\n#include <algorithm>\n#include <condition_variable>\n#include <deque>\n#include <mutex>\n#include <thread>\n#include <utility>\n#include <vector>\n\n// WUFFS_AUX__DECODE_IMAGE__PNG_NUM_BATCHES is the number of batches (of\n// decompressed IDAT data) that the pipelined PNG decoder's inflating thread\n// can run ahead by.\n#ifndef WUFFS_AUX__DECODE_IMAGE__PNG_NUM_BATCHES\n#define WUFFS_AUX__DECODE_IMAGE__PNG_NUM_BATCHES 8\n#endif\n\nnamespace wuffs_aux {\n\nDecodeImageResult::DecodeImageResult(MemOwner&& pixbuf_mem_owner0,\n                                     wuffs_base__pixel_buffer pixbuf0,\n                                     std::string&& error_message0)\n    : pixbuf_mem_owner(std::move(pixbuf_mem_owner0)),\n      pixbuf(pixbuf0),\n      error_message(std::move(error_message0)) {}\n\nDecodeImageResult::DecodeImageResult(std::string&& error_message0)\n    : pixbuf_mem_owner(nullptr, &free),\n      pixbuf(wuffs_b" +
+	"ase__null_pixel_buffer()),\n      error_message(std::move(error_message0)) {}\n\nDecodeImageCallbacks::~DecodeImageCallbacks() {}\n\nDecodeImageCallbacks::AllocPixbufResult::AllocPixbufResult(\n    MemOwner&& mem_owner0,\n    wuffs_base__pixel_buffer pixbuf0)\n    : mem_owner(std::move(mem_owner0)), pixbuf(pixbuf0), error_message(\"\") {}\n\nDecodeImageCallbacks::AllocPixbufResult::AllocPixbufResult(\n    std::string&& error_message0)\n    : mem_owner(nullptr, &free),\n      pixbuf(wuffs_base__null_pixel_buffer()),\n      error_message(std::move(error_message0)) {}\n\nDecodeImageCallbacks::AllocWorkbufResult::AllocWorkbufResult(\n    MemOwner&& mem_owner0,\n    wuffs_base__slice_u8 workbuf0)\n    : mem_owner(std::move(mem_owner0)), workbuf(workbuf0), error_message(\"\") {}\n\nDecodeImageCallbacks::AllocWorkbufResult::AllocWorkbufResult(\n    std::string&& error_message0)\n    : mem_owner(nullptr, &free),\n      workbuf(wuffs_base__empty_slice_u8()),\n      error_message(std::move(error_message0)) {}\n\nwuffs_base__image_decoder::unique_ptr" +
+	"  //\nDecodeImageCallbacks::SelectDecoder(uint32_t fourcc,\n                                    wuffs_base__slice_u8 prefix) {\n  switch (fourcc) {\n#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__BMP)\n    case WUFFS_BASE__FOURCC__BMP:\n      return wuffs_bmp__decoder::alloc_as__wuffs_base__image_decoder();\n#endif\n\n#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__GIF)\n    case WUFFS_BASE__FOURCC__GIF:\n      return wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder();\n#endif\n\n#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__NIE)\n    case WUFFS_BASE__FOURCC__NIE:\n      return wuffs_nie__decoder::alloc_as__wuffs_base__image_decoder();\n#endif\n\n#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__PNG)\n    case WUFFS_BASE__FOURCC__PNG: {\n      auto dec = wuffs_png__decoder::alloc_as__wuffs_base__image_decoder();\n      // Favor faster decodes over rejecting invalid checksums.\n      dec->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, t" +
+	"rue);\n      return dec;\n    }\n#endif\n\n#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__WBMP)\n    case WUFFS_BASE__FOURCC__WBMP:\n      return wuffs_wbmp__decoder::alloc_as__wuffs_base__image_decoder();\n#endif\n  }\n\n  return wuffs_base__image_decoder::unique_ptr(nullptr, &free);\n}\n\nwuffs_base__pixel_format  //\nDecodeImageCallbacks::SelectPixfmt(\n    const wuffs_base__image_config& image_config) {\n  return wuffs_base__make_pixel_format(WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL);\n}\n\nDecodeImageCallbacks::AllocPixbufResult  //\nDecodeImageCallbacks::AllocPixbuf(const wuffs_base__image_config& image_config,\n                                  bool allow_uninitialized_memory) {\n  uint32_t w = image_config.pixcfg.width();\n  uint32_t h = image_config.pixcfg.height();\n  if ((w == 0) || (h == 0)) {\n    return AllocPixbufResult(\"\");\n  }\n  uint64_t len = image_config.pixcfg.pixbuf_len();\n  if ((len == 0) || (SIZE_MAX < len)) {\n    return AllocPixbufResult(DecodeImage_UnsupportedPixelConfiguration);\n  }\n  void*" +
+	" ptr =\n      allow_uninitialized_memory ? malloc((size_t)len) : calloc((size_t)len, 1);\n  if (!ptr) {\n    return AllocPixbufResult(DecodeImage_OutOfMemory);\n  }\n  wuffs_base__pixel_buffer pixbuf;\n  wuffs_base__status status = pixbuf.set_from_slice(\n      &image_config.pixcfg,\n      wuffs_base__make_slice_u8((uint8_t*)ptr, (size_t)len));\n  if (!status.is_ok()) {\n    free(ptr);\n    return AllocPixbufResult(status.message());\n  }\n  return AllocPixbufResult(MemOwner(ptr, &free), pixbuf);\n}\n\nDecodeImageCallbacks::AllocWorkbufResult  //\nDecodeImageCallbacks::AllocWorkbuf(wuffs_base__range_ii_u64 len_range,\n                                   bool allow_uninitialized_memory) {\n  uint64_t len = len_range.max_incl;\n  if (len == 0) {\n    return AllocWorkbufResult(\"\");\n  } else if (SIZE_MAX < len) {\n    return AllocWorkbufResult(DecodeImage_OutOfMemory);\n  }\n  void* ptr =\n      allow_uninitialized_memory ? malloc((size_t)len) : calloc((size_t)len, 1);\n  if (!ptr) {\n    return AllocWorkbufResult(DecodeImage_OutOfMemory);\n" +
+	"  }\n  return AllocWorkbufResult(\n      MemOwner(ptr, &free),\n      wuffs_base__make_slice_u8((uint8_t*)ptr, (size_t)len));\n}\n\nvoid  //\nDecodeImageCallbacks::Done(\n    DecodeImageResult& result,\n    sync_io::Input& input,\n    IOBuffer& buffer,\n    wuffs_base__image_decoder::unique_ptr image_decoder) {}\n\nconst char DecodeImage_BufferIsTooShort[] =  //\n    \"wuffs_aux::DecodeImage: buffer is too short\";\nconst char DecodeImage_MaxInclDimensionExceeded[] =  //\n    \"wuffs_aux::DecodeImage: max_incl_dimension exceeded\";\nconst char DecodeImage_OutOfMemory[] =  //\n    \"wuffs_aux::DecodeImage: out of memory\";\nconst char DecodeImage_UnexpectedEndOfFile[] =  //\n    \"wuffs_aux::DecodeImage: unexpected end of file\";\nconst char DecodeImage_UnsupportedDownscaleShift[] =  //\n    \"wuffs_aux::DecodeImage: unsupported downscale shift\";\nconst char DecodeImage_UnsupportedImageFormat[] =  //\n    \"wuffs_aux::DecodeImage: unsupported image format\";\nconst char DecodeImage_UnsupportedPixelBlend[] =  //\n    \"wuffs_aux::DecodeImage: unsup" +
+	"ported pixel blend\";\nconst char DecodeImage_UnsupportedPixelConfiguration[] =  //\n    \"wuffs_aux::DecodeImage: unsupported pixel configuration\";\nconst char DecodeImage_UnsupportedPixelFormat[] =  //\n    \"wuffs_aux::DecodeImage: unsupported pixel format\";\n\n" +
+	"" +
+	"// --------\n\nnamespace {\n\nstd::string  //\nDecodeImageAdvanceIOBuf(sync_io::Input& input,\n                        wuffs_base__io_buffer& io_buf,\n                        bool compactable,\n                        uint64_t min_excl_pos,\n                        uint64_t pos) {\n  if ((pos <= min_excl_pos) || (pos < io_buf.reader_position())) {\n    // Redirects must go forward.\n    return DecodeImage_UnsupportedImageFormat;\n  }\n  while (true) {\n    uint64_t relative_pos = pos - io_buf.reader_position();\n    if (relative_pos <= io_buf.reader_length()) {\n      io_buf.meta.ri += (size_t)relative_pos;\n      break;\n    } else if (io_buf.meta.closed) {\n      return DecodeImage_UnexpectedEndOfFile;\n    }\n    io_buf.meta.ri = io_buf.meta.wi;\n    if (compactable) {\n      io_buf.compact();\n    }\n    std::string error_message = input.CopyIn(&io_buf);\n    if (!error_message.empty()) {\n      return error_message;\n    }\n  }\n  return \"\";\n}\n\n// DecodeImageDownscale box filters src, a full size BGRA_PREMUL pixel buffer,\n// down to d" +
+	"st. It is for image formats whose decoders cannot downscale as\n// they decode.\nstd::string  //\nDecodeImageDownscale(wuffs_base__pixel_buffer& dst,\n                     wuffs_base__pixel_buffer& src,\n                     wuffs_base__pixel_blend pixel_blend,\n                     uint32_t downscale_shift) {\n  uint8_t dst_palette_array[1024];\n  wuffs_base__slice_u8 dst_palette = dst.palette_or_else(\n      wuffs_base__make_slice_u8(dst_palette_array, 1024));\n  wuffs_base__pixel_swizzler swizzler;\n  wuffs_base__status status = swizzler.prepare_downscaled(\n      dst.pixel_format(), dst_palette, src.pixel_format(),\n      wuffs_base__empty_slice_u8(), pixel_blend);\n  if (status.repr != nullptr) {\n    return status.message();\n  }\n\n  uint32_t w = src.pixcfg.width();\n  uint32_t h = src.pixcfg.height();\n  std::vector<uint8_t> accum(8 * (((size_t)(w >> downscale_shift)) + 2));\n  wuffs_base__table_u8 dst_tab = dst.plane(0);\n  wuffs_base__table_u8 src_tab = src.plane(0);\n  for (uint32_t y = 0; y < h; y++) {\n    wuffs_base__s" +
+	"lice_u8 row = wuffs_base__table_u8__row(src_tab, y);\n    row.len = std::min(row.len, 4 * ((size_t)w));\n    swizzler.swizzle_downscaled_from_slice(\n        dst_tab, dst_palette,\n        wuffs_base__make_slice_u8(accum.data(), accum.size()), row,\n        downscale_shift, 0, y, 0, h);\n  }\n  return \"\";\n}\n\nDecodeImageResult  //\nDecodeImage0(wuffs_base__image_decoder::unique_ptr& image_decoder,\n             DecodeImageCallbacks& callbacks,\n             sync_io::Input& input,\n             wuffs_base__io_buffer& io_buf,\n             wuffs_base__pixel_blend pixel_blend,\n             wuffs_base__color_u32_argb_premul background_color,\n             uint32_t max_incl_dimension,\n             uint32_t downscale_shift) {\n  // Check args.\n  switch (pixel_blend) {\n    case WUFFS_BASE__PIXEL_BLEND__SRC:\n    case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:\n      break;\n    default:\n      return DecodeImageResult(DecodeImage_UnsupportedPixelBlend);\n  }\n  if (downscale_shift > 3) {\n    return DecodeImageResult(DecodeImage_UnsupportedDowns" +
+	"caleShift);\n  }\n\n  wuffs_base__image_config image_config = wuffs_base__null_image_config();\n  uint64_t start_pos = io_buf.reader_position();\n  bool redirected = false;\n  int32_t fourcc = 0;\nredirect:\n  do {\n    // Determine the image format.\n    if (!redirected) {\n      while (true) {\n        fourcc = wuffs_base__magic_number_guess_fourcc(io_buf.reader_slice());\n        if (fourcc > 0) {\n          break;\n        } else if ((fourcc == 0) && (io_buf.reader_length() >= 64)) {\n          break;\n        } else if (io_buf.meta.closed || (io_buf.writer_length() == 0)) {\n          fourcc = 0;\n          break;\n        }\n        std::string error_message = input.CopyIn(&io_buf);\n        if (!error_message.empty()) {\n          return DecodeImageResult(std::move(error_message));\n        }\n      }\n    } else {\n      wuffs_base__io_buffer empty = wuffs_base__empty_io_buffer();\n      wuffs_base__more_information minfo = wuffs_base__empty_more_information();\n      wuffs_base__status tmm_status =\n          image_decoder->tell_" +
+	"me_more(&empty, &minfo, &io_buf);\n      if (tmm_status.repr != nullptr) {\n        return DecodeImageResult(tmm_status.message());\n      }\n      if (minfo.flavor != WUFFS_BASE__MORE_INFORMATION__FLAVOR__IO_REDIRECT) {\n        return DecodeImageResult(DecodeImage_UnsupportedImageFormat);\n      }\n      uint64_t pos = minfo.io_redirect__range().min_incl;\n      std::string error_message = DecodeImageAdvanceIOBuf(\n          input, io_buf, !input.BringsItsOwnIOBuffer(), start_pos, pos);\n      if (!error_message.empty()) {\n        return DecodeImageResult(std::move(error_message));\n      }\n      fourcc = (int32_t)(minfo.io_redirect__fourcc());\n      if (fourcc == 0) {\n        return DecodeImageResult(DecodeImage_UnsupportedImageFormat);\n      }\n      image_decoder.reset();\n    }\n\n    // Select the image decoder.\n    image_decoder = callbacks.SelectDecoder(\n        (uint32_t)fourcc,\n        fourcc ? wuffs_base__empty_slice_u8() : io_buf.reader_slice());\n    if (!image_decoder) {\n      return DecodeImageResult(DecodeIm" +
+	"age_UnsupportedImageFormat);\n    }\n\n    // Decode the image config.\n    while (true) {\n      wuffs_base__status id_dic_status =\n          image_decoder->decode_image_config(&image_config, &io_buf);\n      if (id_dic_status.repr == nullptr) {\n        break;\n      } else if (id_dic_status.repr == wuffs_base__note__i_o_redirect) {\n        if (redirected) {\n          return DecodeImageResult(DecodeImage_UnsupportedImageFormat);\n        }\n        redirected = true;\n        goto redirect;\n      } else if (id_dic_status.repr != wuffs_base__suspension__short_read) {\n        return DecodeImageResult(id_dic_status.message());\n      } else if (io_buf.meta.closed) {\n        return DecodeImageResult(DecodeImage_UnexpectedEndOfFile);\n      } else {\n        std::string error_message = input.CopyIn(&io_buf);\n        if (!error_message.empty()) {\n          return DecodeImageResult(std::move(error_message));\n        }\n      }\n    }\n  } while (false);\n\n  // Select the pixel format.\n  uint32_t w = image_config.pixcfg.width();\n  u" +
+	"int32_t h = image_config.pixcfg.height();\n  if ((w > max_incl_dimension) || (h > max_incl_dimension)) {\n    return DecodeImageResult(DecodeImage_MaxInclDimensionExceeded);\n  }\n  wuffs_base__pixel_format pixel_format = callbacks.SelectPixfmt(image_config);\n  if (pixel_format.repr != image_config.pixcfg.pixel_format().repr) {\n    switch (pixel_format.repr) {\n      case WUFFS_BASE__PIXEL_FORMAT__BGR_565:\n      case WUFFS_BASE__PIXEL_FORMAT__BGR:\n      case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:\n      case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:\n      case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:\n      case WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL:\n      case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:\n        break;\n      default:\n        return DecodeImageResult(DecodeImage_UnsupportedPixelFormat);\n    }\n    image_config.pixcfg.set(pixel_format.repr,\n                            WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, w, h);\n  }\n\n  // Downscale. The PNG and GIF decoders can do so as they decode. Other\n  // ima" +
+	"ge formats are decoded, at full size, to a temporary BGRA_PREMUL pixel\n  // buffer that is then box filtered down to the allocated pixel buffer.\n  wuffs_base__decode_frame_options decode_frame_options = {};\n  wuffs_base__pixel_buffer full_pixel_buffer = {};\n  MemOwner full_mem_owner(nullptr, &free);\n  if (downscale_shift > 0) {\n    if ((fourcc == WUFFS_BASE__FOURCC__PNG) ||\n        (fourcc == WUFFS_BASE__FOURCC__GIF)) {\n      decode_frame_options.set_downscale_shift(downscale_shift);\n    } else {\n      wuffs_base__pixel_config full_pixcfg;\n      full_pixcfg.set(WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL,\n                      WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, w, h);\n      uint64_t len = full_pixcfg.pixbuf_len();\n      if ((len == 0) || (SIZE_MAX < len)) {\n        return DecodeImageResult(DecodeImage_UnsupportedPixelConfiguration);\n      }\n      void* ptr = calloc((size_t)len, 1);\n      if (!ptr) {\n        return DecodeImageResult(DecodeImage_OutOfMemory);\n      }\n      full_mem_owner.reset(ptr);\n      wuffs_bas" +
+	"e__status status = full_pixel_buffer.set_from_slice(\n          &full_pixcfg, wuffs_base__make_slice_u8((uint8_t*)ptr, (size_t)len));\n      if (status.repr != nullptr) {\n        return DecodeImageResult(status.message());\n      }\n    }\n    uint32_t mask = (1u << downscale_shift) - 1;\n    image_config.pixcfg.set(image_config.pixcfg.pixel_format().repr,\n                            WUFFS_BASE__PIXEL_SUBSAMPLING__NONE,\n                            (w >> downscale_shift) + ((w & mask) ? 1 : 0),\n                            (h >> downscale_shift) + ((h & mask) ? 1 : 0));\n  }\n\n  // Allocate the pixel buffer.\n  bool valid_background_color =\n      wuffs_base__color_u32_argb_premul__is_valid(background_color);\n  DecodeImageCallbacks::AllocPixbufResult alloc_pixbuf_result =\n      callbacks.AllocPixbuf(image_config, valid_background_color);\n  if (!alloc_pixbuf_result.error_message.empty()) {\n    return DecodeImageResult(std::move(alloc_pixbuf_result.error_message));\n  }\n  wuffs_base__pixel_buffer pixel_buffer = alloc_pixbuf" +
+	"_result.pixbuf;\n  if (valid_background_color) {\n    wuffs_base__status pb_scufr_status = pixel_buffer.set_color_u32_fill_rect(\n        pixel_buffer.pixcfg.bounds(), background_color);\n    if (pb_scufr_status.repr != nullptr) {\n      return DecodeImageResult(pb_scufr_status.message());\n    }\n  }\n\n  // Allocate the work buffer. Wuffs' decoders conventionally assume that this\n  // can be uninitialized memory. Downscaling decoders need more than the\n  // minimum length, so ask for the maximum.\n  wuffs_base__range_ii_u64 workbuf_len = image_decoder->workbuf_len();\n  if (decode_frame_options.downscale_shift() > 0) {\n    workbuf_len.min_incl = workbuf_len.max_incl;\n  }\n  DecodeImageCallbacks::AllocWorkbufResult alloc_workbuf_result =\n      callbacks.AllocWorkbuf(workbuf_len, true);\n  if (!alloc_workbuf_result.error_message.empty()) {\n    return DecodeImageResult(std::move(alloc_workbuf_result.error_message));\n  } else if (alloc_workbuf_result.workbuf.len < workbuf_len.min_incl) {\n    return DecodeImageResult(DecodeI" +
+	"mage_BufferIsTooShort);\n  }\n\n  // Decode the frame config.\n  wuffs_base__frame_config frame_config = wuffs_base__null_frame_config();\n  while (true) {\n    wuffs_base__status id_dfc_status =\n        image_decoder->decode_frame_config(&frame_config, &io_buf);\n    if (id_dfc_status.repr == nullptr) {\n      break;\n    } else if (id_dfc_status.repr != wuffs_base__suspension__short_read) {\n      return DecodeImageResult(id_dfc_status.message());\n    } else if (io_buf.meta.closed) {\n      return DecodeImageResult(DecodeImage_UnexpectedEndOfFile);\n    } else {\n      std::string error_message = input.CopyIn(&io_buf);\n      if (!error_message.empty()) {\n        return DecodeImageResult(std::move(error_message));\n      }\n    }\n  }\n\n  // Decode the frame (the pixels).\n  //\n  // From here on, always returns the pixel_buffer. If we get this far, we can\n  // still display a partial image, even if we encounter an error.\n  std::string message(\"\");\n  if ((pixel_blend == WUFFS_BASE__PIXEL_BLEND__SRC_OVER) &&\n      frame_config." +
+	"overwrite_instead_of_blend()) {\n    pixel_blend = WUFFS_BASE__PIXEL_BLEND__SRC;\n  }\n  bool full_size = full_mem_owner != nullptr;\n  while (true) {\n    wuffs_base__status id_df_status = image_decoder->decode_frame(\n        full_size ? &full_pixel_buffer : &pixel_buffer, &io_buf,\n        full_size ? WUFFS_BASE__PIXEL_BLEND__SRC : pixel_blend,\n        alloc_workbuf_result.workbuf, &decode_frame_options);\n    if (id_df_status.repr == nullptr) {\n      break;\n    } else if (id_df_status.repr != wuffs_base__suspension__short_read) {\n      message = id_df_status.message();\n      break;\n    } else if (io_buf.meta.closed) {\n      message = DecodeImage_UnexpectedEndOfFile;\n      break;\n    } else {\n      std::string error_message = input.CopyIn(&io_buf);\n      if (!error_message.empty()) {\n        message = std::move(error_message);\n        break;\n      }\n    }\n  }\n  if (full_size) {\n    std::string error_message = DecodeImageDownscale(\n        pixel_buffer, full_pixel_buffer, pixel_blend, downscale_shift);\n    if (mess" +
+	"age.empty()) {\n      message = std::move(error_message);\n    }\n  }\n  return DecodeImageResult(std::move(alloc_pixbuf_result.mem_owner),\n                           pixel_buffer, std::move(message));\n}\n\n// DecodeImageReadAll returns the entire input, either in its own I/O buffer\n// or after copying it into storage.\nstd::string  //\nDecodeImageReadAll(sync_io::Input& input,\n                   std::vector<uint8_t>& storage,\n                   wuffs_base__slice_u8* all) {\n  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();\n  if (io_buf && io_buf->meta.closed) {\n    *all = io_buf->reader_slice();\n    return \"\";\n  }\n  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();\n  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);\n  if (!io_buf) {\n    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);\n    fallback_io_buf =\n        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);\n    io_buf = &fallback_io_buf;\n  }\n  while (true) {\n    storage.insert(storage.end(), i" +
+	"o_buf->reader_pointer(),\n                   io_buf->reader_pointer() + io_buf->reader_length());\n    io_buf->meta.ri = io_buf->meta.wi;\n    if (io_buf->meta.closed) {\n      break;\n    }\n    io_buf->compact();\n    std::string error_message = input.CopyIn(io_buf);\n    if (!error_message.empty()) {\n      return error_message;\n    }\n  }\n  *all = wuffs_base__make_slice_u8(storage.data(), storage.size());\n  return \"\";\n}\n\n#if !defined(WUFFS_CONFIG__MODULES) ||                                      \\\n    (defined(WUFFS_CONFIG__MODULE__ADLER32) &&                              \\\n     defined(WUFFS_CONFIG__MODULE__CRC32) &&                                \\\n     defined(WUFFS_CONFIG__MODULE__PNG) && defined(WUFFS_CONFIG__MODULE__ZLIB))\n#define WUFFS_AUX__DECODE_IMAGE__PNG_PIPELINE\n#endif\n\n#if defined(WUFFS_AUX__DECODE_IMAGE__PNG_PIPELINE)\n\n// DecodeImageFindIDAT returns the position of the first IDAT chunk (its\n// length field) in the PNG image s, or 0 if s is not a PNG image or has no\n// IDAT chunk.\nsize_t  //\nDecodeImag" +
+	"eFindIDAT(wuffs_base__slice_u8 s) {\n  static const uint8_t signature[8] = {\n      0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A,\n  };\n  if ((s.len < 8) || memcmp(s.ptr, signature, 8)) {\n    return 0;\n  }\n  size_t pos = 8;\n  while ((s.len - pos) >= 12) {\n    uint32_t chunk_len = wuffs_base__peek_u32be__no_bounds_check(s.ptr + pos);\n    uint32_t chunk_type =\n        wuffs_base__peek_u32le__no_bounds_check(s.ptr + pos + 4);\n    if (chunk_type == 0x54414449) {  // \"IDAT\" as a little-endian u32.\n      return pos;\n    } else if ((s.len - pos - 12) < chunk_len) {\n      break;\n    }\n    pos += 12 + (size_t)chunk_len;\n  }\n  return 0;\n}\n\n// DecodeImagePngPipeline is a sync_io::Input that splits decoding a PNG\n// image across two threads. A second thread inflates the IDAT chunks' zlib\n// stream, a batch at a time, into a bounded ring of batches. The calling\n// thread reads those batches back as a new but equivalent PNG image, whose\n// IDAT chunks hold the decompressed data as zlib stored (uncompressed)\n// blocks, so th" +
+	"at the regular PNG decoder (which then only has to copy the\n// stored blocks before un-filtering and swizzling) runs concurrently with\n// the inflating.\n//\n// The IDAT chunks' CRC-32 and the zlib stream's Adler-32 checksums of the\n// original image are not verified. Those of the new image are valid.\nclass DecodeImagePngPipeline : public sync_io::Input {\n public:\n  DecodeImagePngPipeline(wuffs_base__slice_u8 src, size_t idat_pos);\n  ~DecodeImagePngPipeline();\n\n  virtual std::string CopyIn(IOBuffer* dst);\n\n private:\n  // kBatchLength is the maximum length of a zlib stored block.\n  static const size_t kBatchLength = 65535;\n\n  void Inflate();\n  std::string Inflate0();\n  bool Push(std::vector<uint8_t>&& batch);\n\n  wuffs_base__slice_u8 m_src;\n  size_t m_idat_pos;\n\n  std::mutex m_mutex;\n  std::condition_variable m_cond;\n  std::deque<std::vector<uint8_t>> m_batches;\n  std::string m_error_message;\n  bool m_done;\n  bool m_cancelled;\n\n  // Only the calling thread uses m_curr and m_curr_ri.\n  std::vector<uint8_t> m_curr;" +
+	"\n  size_t m_curr_ri;\n\n  std::thread m_thread;\n\n  // Delete the copy and assign constructors.\n  DecodeImagePngPipeline(const DecodeImagePngPipeline&) = delete;\n  DecodeImagePngPipeline& operator=(const DecodeImagePngPipeline&) = delete;\n};\n\nDecodeImagePngPipeline::DecodeImagePngPipeline(wuffs_base__slice_u8 src,\n                                               size_t idat_pos)\n    : m_src(src),\n      m_idat_pos(idat_pos),\n      m_done(false),\n      m_cancelled(false),\n      m_curr(src.ptr, src.ptr + idat_pos),\n      m_curr_ri(0),\n      m_thread(&DecodeImagePngPipeline::Inflate, this) {}\n\nDecodeImagePngPipeline::~DecodeImagePngPipeline() {\n  {\n    std::lock_guard<std::mutex> lock(m_mutex);\n    m_cancelled = true;\n  }\n  m_cond.notify_all();\n  m_thread.join();\n}\n\nstd::string  //\nDecodeImagePngPipeline::CopyIn(IOBuffer* dst) {\n  if (!dst) {\n    return \"wuffs_aux::DecodeImagePngPipeline: nullptr IOBuffer\";\n  } else if (dst->meta.closed) {\n    return \"wuffs_aux::DecodeImagePngPipeline: end of file\";\n  }\n  dst->compact" +
+	"();\n  while (dst->writer_length() > 0) {\n    if (m_curr_ri < m_curr.size()) {\n      size_t n = std::min(dst->writer_length(), m_curr.size() - m_curr_ri);\n      memcpy(dst->writer_pointer(), m_curr.data() + m_curr_ri, n);\n      dst->meta.wi += n;\n      m_curr_ri += n;\n      continue;\n    } else if (dst->reader_length() > 0) {\n      // Return what we have instead of waiting for the next batch.\n      break;\n    }\n\n    std::unique_lock<std::mutex> lock(m_mutex);\n    m_cond.wait(lock, [this] { return !m_batches.empty() || m_done; });\n    if (m_batches.empty()) {\n      dst->meta.closed = true;\n      return m_error_message;\n    }\n    m_curr = std::move(m_batches.front());\n    m_curr_ri = 0;\n    m_batches.pop_front();\n    lock.unlock();\n    m_cond.notify_all();\n  }\n  return \"\";\n}\n\nvoid  //\nDecodeImagePngPipeline::Inflate() {\n  std::string error_message = Inflate0();\n  {\n    std::lock_guard<std::mutex> lock(m_mutex);\n    m_error_message = std::move(error_message);\n    m_done = true;\n  }\n  m_cond.notify_all();\n}\n\n// In" +
+	"flate0 runs on the second thread. It returns an empty string on success\n// or an error message.\nstd::string  //\nDecodeImagePngPipeline::Inflate0() {\n  auto dec = wuffs_zlib__decoder::alloc();\n  auto crc32 = wuffs_crc32__ieee_hasher::alloc();\n  auto adler32 = wuffs_adler32__hasher::alloc();\n  if (!dec || !crc32 || !adler32) {\n    return DecodeImage_OutOfMemory;\n  }\n  dec->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, true);\n\n  // Each batch is one IDAT chunk: an 8 byte chunk header, the 2 byte zlib\n  // header (for the first batch only), a 5 byte stored block header, up to\n  // kBatchLength bytes of decompressed data and a 4 byte CRC-32.\n  static const size_t max_batch_len = 8 + 2 + 5 + kBatchLength + 4;\n  static const size_t work_len =\n      WUFFS_ZLIB__DECODER_WORKBUF_LEN_MAX_INCL_WORST_CASE;\n  uint8_t work_array[work_len];\n  size_t pos = m_idat_pos;\n  uint32_t idat_remaining = 0;\n  bool first_batch = true;\n  bool eof = false;\n  std::string error_message;\n  while (!eof && error_message.empty()) {\n    " +
+	"std::vector<uint8_t> batch(max_batch_len);\n    size_t data_pos = first_batch ? 15 : 13;\n    size_t n = 0;\n    while (n < kBatchLength) {\n      // Find the next IDAT chunk's payload, when we have finished the last.\n      if (idat_remaining == 0) {\n        if ((m_src.len - pos) < 8) {\n          error_message = DecodeImage_UnexpectedEndOfFile;\n          break;\n        }\n        uint32_t chunk_len =\n            wuffs_base__peek_u32be__no_bounds_check(m_src.ptr + pos);\n        uint32_t chunk_type =\n            wuffs_base__peek_u32le__no_bounds_check(m_src.ptr + pos + 4);\n        if (chunk_type != 0x54414449) {  // \"IDAT\" as a little-endian u32.\n          // The zlib stream has not finished, yet there is no more IDAT data.\n          error_message = DecodeImage_UnexpectedEndOfFile;\n          break;\n        }\n        pos += 8;\n        // Like the single-threaded decoder, decompress as much of a truncated\n        // chunk's payload as there is.\n        idat_remaining = (uint32_t)std::min<size_t>(chunk_len, m_src.len -" +
+	" pos);\n        if (idat_remaining == 0) {\n          pos = std::min(m_src.len, pos + 4);\n          if (chunk_len > 0) {\n            error_message = DecodeImage_UnexpectedEndOfFile;\n            break;\n          }\n          continue;\n        }\n      }\n\n      // Each transform_io call starts with an empty dst (with no history), as\n      // the decoder has already copied earlier output into its own history.\n      wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(\n          batch.data() + data_pos + n, kBatchLength - n);\n      wuffs_base__io_buffer src =\n          wuffs_base__ptr_u8__reader(m_src.ptr + pos, idat_remaining, false);\n      wuffs_base__status status = dec->transform_io(\n          &dst, &src, wuffs_base__make_slice_u8(work_array, work_len));\n      n += dst.meta.wi;\n      pos += src.meta.ri;\n      idat_remaining -= (uint32_t)src.meta.ri;\n      if (idat_remaining == 0) {\n        pos = std::min(m_src.len, pos + 4);  // Skip the CRC-32.\n      }\n      if (status.repr == nullptr) {\n        eof = true;\n  " +
+	"      break;\n      } else if ((status.repr != wuffs_base__suspension__short_read) &&\n                 (status.repr != wuffs_base__suspension__short_write)) {\n        error_message = status.message();\n        break;\n      }\n    }\n\n    // Pass on what was decompressed, even after an error, so that the\n    // calling thread can still decode a partial image.\n    adler32->update_u32(wuffs_base__make_slice_u8(batch.data() + data_pos, n));\n    uint8_t* p = batch.data();\n    wuffs_base__poke_u32be__no_bounds_check(p + 0,\n                                            (uint32_t)(data_pos - 8 + n));\n    wuffs_base__poke_u32le__no_bounds_check(p + 4, 0x54414449);\n    if (first_batch) {\n      // 0x7801 is a valid zlib header (with no preset dictionary). The window\n      // size is irrelevant for stored blocks.\n      p[8] = 0x78;\n      p[9] = 0x01;\n    }\n    p[data_pos - 5] = 0x00;  // A non-final stored block.\n    wuffs_base__poke_u16le__no_bounds_check(p + data_pos - 4, (uint16_t)n);\n    wuffs_base__poke_u16le__no_bounds_c" +
+	"heck(p + data_pos - 2,\n                                            (uint16_t)(n ^ 0xFFFF));\n    wuffs_base__poke_u32be__no_bounds_check(\n        p + data_pos + n,\n        crc32->update_u32(wuffs_base__make_slice_u8(p + 4, data_pos - 4 + n)));\n    batch.resize(data_pos + n + 4);\n    wuffs_base__status status =\n        crc32->initialize(sizeof__wuffs_crc32__ieee_hasher(), WUFFS_VERSION, 0);\n    if (!status.is_ok()) {\n      return status.message();\n    }\n    first_batch = false;\n    if (!Push(std::move(batch))) {\n      return \"\";\n    }\n  }\n  if (!error_message.empty()) {\n    return error_message;\n  }\n\n  // Skip the rest of the zlib stream's IDAT chunks: any bytes after the end of\n  // the stream and any further IDAT chunks.\n  if (idat_remaining > 0) {\n    pos = std::min(m_src.len, pos + idat_remaining + 4);\n  }\n  while ((m_src.len - pos) >= 8) {\n    uint32_t chunk_len =\n        wuffs_base__peek_u32be__no_bounds_check(m_src.ptr + pos);\n    uint32_t chunk_type =\n        wuffs_base__peek_u32le__no_bounds_check(m_sr" +
+	"c.ptr + pos + 4);\n    if (chunk_type != 0x54414449) {  // \"IDAT\" as a little-endian u32.\n      break;\n    }\n    pos += std::min<size_t>(m_src.len - pos, 12 + (size_t)chunk_len);\n  }\n\n  // Finish with an IDAT chunk that holds a final (and empty) stored block and\n  // the zlib Adler-32 checksum, then the original bytes after the IDAT chunks\n  // (such as tEXt chunks and the IEND chunk), so that decoding metadata that\n  // comes after the pixel data sees the same chunks as single-threaded\n  // decoding does.\n  std::vector<uint8_t> batch(8 + 9 + 4);\n  uint8_t* p = batch.data();\n  wuffs_base__poke_u32be__no_bounds_check(p + 0, 9);\n  wuffs_base__poke_u32le__no_bounds_check(p + 4, 0x54414449);\n  p[8] = 0x01;\n  wuffs_base__poke_u32be__no_bounds_check(p + 9, 0x0000FFFF);\n  wuffs_base__poke_u32be__no_bounds_check(\n      p + 13, adler32->update_u32(wuffs_base__empty_slice_u8()));\n  wuffs_base__poke_u32be__no_bounds_check(\n      p + 17, crc32->update_u32(wuffs_base__make_slice_u8(p + 4, 13)));\n  batch.insert(batch.end()," +
+	" m_src.ptr + pos, m_src.ptr + m_src.len);\n  Push(std::move(batch));\n  return \"\";\n}\n\n// Push adds a batch to the ring, waiting until there is room for it. It\n// returns false if the calling thread has given up on decoding.\nbool  //\nDecodeImagePngPipeline::Push(std::vector<uint8_t>&& batch) {\n  std::unique_lock<std::mutex> lock(m_mutex);\n  m_cond.wait(lock, [this] {\n    return (m_batches.size() < WUFFS_AUX__DECODE_IMAGE__PNG_NUM_BATCHES) ||\n           m_cancelled;\n  });\n  if (m_cancelled) {\n    return false;\n  }\n  m_batches.push_back(std::move(batch));\n  lock.unlock();\n  m_cond.notify_all();\n  return true;\n}\n\n#endif  // defined(WUFFS_AUX__DECODE_IMAGE__PNG_PIPELINE)\n\n// DecodeImage1 is DecodeImage, single-threaded.\nDecodeImageResult  //\nDecodeImage1(DecodeImageCallbacks& callbacks,\n             sync_io::Input& input,\n             wuffs_base__pixel_blend pixel_blend,\n             wuffs_base__color_u32_argb_premul background_color,\n             uint32_t max_incl_dimension,\n             uint32_t downscale_shift) {" +
+	"\n  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();\n  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();\n  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);\n  if (!io_buf) {\n    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);\n    fallback_io_buf =\n        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);\n    io_buf = &fallback_io_buf;\n  }\n\n  wuffs_base__image_decoder::unique_ptr image_decoder(nullptr, &free);\n  DecodeImageResult result =\n      DecodeImage0(image_decoder, callbacks, input, *io_buf, pixel_blend,\n                   background_color, max_incl_dimension, downscale_shift);\n  callbacks.Done(result, input, *io_buf, std::move(image_decoder));\n  return result;\n}\n\n}  // namespace\n\nDecodeImageResult  //\nDecodeImage(DecodeImageCallbacks& callbacks,\n            sync_io::Input& input,\n            wuffs_base__pixel_blend pixel_blend,\n            wuffs_base__color_u32_argb_premul background_color,\n            uint32_t max_incl_dimension,\n    " +
+	"        uint32_t num_threads,\n            uint32_t downscale_shift) {\n#if defined(WUFFS_AUX__DECODE_IMAGE__PNG_PIPELINE)\n  if (num_threads > 1) {\n    std::vector<uint8_t> storage;\n    wuffs_base__slice_u8 all = wuffs_base__empty_slice_u8();\n    std::string error_message = DecodeImageReadAll(input, storage, &all);\n    if (!error_message.empty()) {\n      DecodeImageResult result(std::move(error_message));\n      wuffs_base__io_buffer empty_io_buf = wuffs_base__empty_io_buffer();\n      callbacks.Done(result, input, empty_io_buf,\n                     wuffs_base__image_decoder::unique_ptr(nullptr, &free));\n      return result;\n    }\n    size_t idat_pos = DecodeImageFindIDAT(all);\n    if (idat_pos > 0) {\n      DecodeImagePngPipeline pipeline(all, idat_pos);\n      return DecodeImage1(callbacks, pipeline, pixel_blend, background_color,\n                          max_incl_dimension, downscale_shift);\n    }\n    sync_io::MemoryInput memory_input(all.ptr, all.len);\n    return DecodeImage1(callbacks, memory_input, pixel_ble" +
+	"nd, background_color,\n                        max_incl_dimension, downscale_shift);\n  }\n#endif  // defined(WUFFS_AUX__DECODE_IMAGE__PNG_PIPELINE)\n\n  return DecodeImage1(callbacks, input, pixel_blend, background_color,\n                      max_incl_dimension, downscale_shift);\n}\n\n" +
+	"" +
+	"// --------\n\nIndexFramesResult::IndexFramesResult(wuffs_base__image_config image_config0,\n                                     std::vector<Frame>&& frames0,\n                                     std::string&& error_message0)\n    : image_config(image_config0),\n      frames(std::move(frames0)),\n      error_message(std::move(error_message0)) {}\n\nsize_t  //\nIndexFramesResult::KeyframeFor(size_t n) const {\n  if (frames.empty()) {\n    return 0;\n  }\n  n = std::min(n, frames.size() - 1);\n  while ((n > 0) && !frames[n].keyframe) {\n    n--;\n  }\n  return n;\n}\n\nIndexFramesResult  //\nIndexFrames(wuffs_base__image_decoder& image_decoder, sync_io::Input& input) {\n  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();\n  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();\n  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);\n  if (!io_buf) {\n    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);\n    fallback_io_buf =\n        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 327" +
+	"68);\n    io_buf = &fallback_io_buf;\n  }\n\n  wuffs_base__image_config image_config = wuffs_base__null_image_config();\n  std::vector<IndexFramesResult::Frame> frames;\n  while (true) {\n    wuffs_base__status status =\n        image_decoder.decode_image_config(&image_config, io_buf);\n    if (status.repr == nullptr) {\n      break;\n    } else if (status.repr == wuffs_base__note__i_o_redirect) {\n      return IndexFramesResult(image_config, std::move(frames),\n                               DecodeImage_UnsupportedImageFormat);\n    } else if (status.repr != wuffs_base__suspension__short_read) {\n      return IndexFramesResult(image_config, std::move(frames),\n                               status.message());\n    } else if (io_buf->meta.closed) {\n      return IndexFramesResult(image_config, std::move(frames),\n                               DecodeImage_UnexpectedEndOfFile);\n    }\n    std::string error_message = input.CopyIn(io_buf);\n    if (!error_message.empty()) {\n      return IndexFramesResult(image_config, std::move(fram" +
+	"es),\n                               std::move(error_message));\n    }\n  }\n\n  wuffs_base__rect_ie_u32 canvas = image_config.pixcfg.bounds();\n  // The canvas starts out cleared, so the first frame is a keyframe.\n  bool cleared = true;\n  while (true) {\n    wuffs_base__frame_config frame_config = wuffs_base__null_frame_config();\n    wuffs_base__status status =\n        image_decoder.decode_frame_config(&frame_config, io_buf);\n    if (status.repr == wuffs_base__note__end_of_data) {\n      break;\n    } else if (status.repr == wuffs_base__suspension__short_read) {\n      if (io_buf->meta.closed) {\n        return IndexFramesResult(image_config, std::move(frames),\n                                 DecodeImage_UnexpectedEndOfFile);\n      }\n      std::string error_message = input.CopyIn(io_buf);\n      if (!error_message.empty()) {\n        return IndexFramesResult(image_config, std::move(frames),\n                                 std::move(error_message));\n      }\n      continue;\n    } else if (status.repr != nullptr) {\n      " +
+	"return IndexFramesResult(image_config, std::move(frames),\n                               status.message());\n    }\n\n    bool covers_canvas = frame_config.bounds().contains_rect(canvas);\n    IndexFramesResult::Frame frame;\n    frame.io_position = frame_config.io_position();\n    frame.bounds = frame_config.bounds();\n    frame.duration = frame_config.duration();\n    frame.disposal = frame_config.disposal();\n    frame.keyframe =\n        cleared ||\n        (covers_canvas &&\n         (frame.disposal != WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_PREVIOUS) &&\n         (frame_config.opaque_within_bounds() ||\n          frame_config.overwrite_instead_of_blend()));\n    frames.push_back(frame);\n    cleared = covers_canvas &&\n              (frame.disposal ==\n               WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_BACKGROUND);\n  }\n  return IndexFramesResult(image_config, std::move(frames), \"\");\n}\n\n" +
+	"" +
+	"// --------\n\n#if !defined(WUFFS_CONFIG__MODULES) || \\\n    (defined(WUFFS_CONFIG__MODULE__GIF) && defined(WUFFS_CONFIG__MODULE__LZW))\n#define WUFFS_AUX__DECODE_GIF_FRAMES\n#endif\n\n#if defined(WUFFS_AUX__DECODE_GIF_FRAMES)\n\nDecodeGifFramesCallbacks::~DecodeGifFramesCallbacks() {}\n\nDecodeGifFramesResult::DecodeGifFramesResult(uint64_t num_frames0,\n                                             std::string&& error_message0)\n    : num_frames(num_frames0), error_message(std::move(error_message0)) {}\n\nconst char DecodeGifFrames_OutOfMemory[] =  //\n    \"wuffs_aux::DecodeGifFrames: out of memory\";\n\nnamespace {\n\n// DecodeGifFramesSlot holds one decoded frame: its palette indices, in an\n// INDEXED__BGRA_BINARY pixel buffer the size of the whole image, of which\n// only the dirty_rect is meaningful.\nstruct DecodeGifFramesSlot {\n  std::vector<uint8_t> memory;\n  wuffs_base__pixel_buffer pixbuf;\n  wuffs_base__frame_config frame_config;\n  wuffs_base__rect_ie_u32 dirty_rect;\n  std::string error_message;\n};\n\n// DecodeGifFramesCanv" +
+	"as composites DecodeGifFramesSlots, in frame order, and\n// applies each frame's disposal afterwards.\nclass DecodeGifFramesCanvas {\n public:\n  std::string Init(const wuffs_base__image_config& image_config,\n                   std::vector<DecodeGifFramesSlot>& slots);\n  std::string Composite(DecodeGifFramesCallbacks& callbacks,\n                        DecodeGifFramesSlot& slot);\n\n private:\n  std::vector<uint8_t> m_memory;\n  std::vector<uint8_t> m_saved;\n  wuffs_base__pixel_buffer m_pixbuf;\n};\n\nstd::string  //\nDecodeGifFramesCanvas::Init(const wuffs_base__image_config& image_config,\n                            std::vector<DecodeGifFramesSlot>& slots) {\n  uint32_t w = image_config.pixcfg.width();\n  uint32_t h = image_config.pixcfg.height();\n  uint64_t wh = (uint64_t)w * (uint64_t)h;\n  if (wh > (SIZE_MAX / 4)) {\n    return DecodeGifFrames_OutOfMemory;\n  }\n  m_memory.assign(4 * (size_t)wh, 0);\n  wuffs_base__pixel_config pixcfg;\n  pixcfg.set(WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL,\n             WUFFS_BASE__PIXEL_SUBSAM" +
+	"PLING__NONE, w, h);\n  wuffs_base__status status = m_pixbuf.set_from_slice(\n      &pixcfg, wuffs_base__make_slice_u8(m_memory.data(), m_memory.size()));\n  if (!status.is_ok()) {\n    return status.message();\n  }\n\n  pixcfg.set(WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_BINARY,\n             WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, w, h);\n  for (auto& slot : slots) {\n    slot.memory.resize(\n        WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH + (size_t)wh);\n    status = slot.pixbuf.set_from_slice(\n        &pixcfg, wuffs_base__make_slice_u8(slot.memory.data(),\n                                           slot.memory.size()));\n    if (!status.is_ok()) {\n      return status.message();\n    }\n  }\n  return \"\";\n}\n\nstd::string  //\nDecodeGifFramesCanvas::Composite(DecodeGifFramesCallbacks& callbacks,\n                                 DecodeGifFramesSlot& slot) {\n  const wuffs_base__frame_config& fc = slot.frame_config;\n  if (fc.disposal() == WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_PREVIOUS) {\n    m_saved = m_memory;\n  }\n\n " +
+	" // The swizzler converts the frame's palette to the canvas' pixel format,\n  // in dst_palette.\n  uint8_t dst_palette_array[1024];\n  wuffs_base__slice_u8 dst_palette =\n      wuffs_base__make_slice_u8(dst_palette_array, 1024);\n  wuffs_base__pixel_swizzler swizzler;\n  wuffs_base__status status = swizzler.prepare(\n      m_pixbuf.pixel_format(), dst_palette, slot.pixbuf.pixel_format(),\n      slot.pixbuf.palette(),\n      fc.overwrite_instead_of_blend() ? WUFFS_BASE__PIXEL_BLEND__SRC\n                                      : WUFFS_BASE__PIXEL_BLEND__SRC_OVER);\n  if (!status.is_ok()) {\n    return status.message();\n  }\n  wuffs_base__rect_ie_u32 r = slot.dirty_rect;\n  wuffs_base__table_u8 dst_tab = m_pixbuf.plane(0);\n  wuffs_base__table_u8 src_tab = slot.pixbuf.plane(0);\n  for (uint32_t y = r.min_incl_y; y < r.max_excl_y; y++) {\n    wuffs_base__slice_u8 dst = wuffs_base__table_u8__row(dst_tab, y);\n    wuffs_base__slice_u8 src = wuffs_base__table_u8__row(src_tab, y);\n    swizzler.swizzle_interleaved_from_slice(\n        w" +
+	"uffs_base__slice_u8__subslice_ij(dst, 4 * (size_t)r.min_incl_x,\n                                          4 * (size_t)r.max_excl_x),\n        dst_palette,\n        wuffs_base__slice_u8__subslice_ij(src, r.min_incl_x, r.max_excl_x));\n  }\n\n  std::string error_message = callbacks.Frame(fc, m_pixbuf);\n\n  if (fc.disposal() == WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_BACKGROUND) {\n    wuffs_base__rect_ie_u32 b = fc.bounds();\n    wuffs_base__color_u32_argb_premul color = fc.background_color();\n    for (uint32_t y = b.min_incl_y; y < b.max_excl_y; y++) {\n      uint8_t* p = wuffs_base__table_u8__row(dst_tab, y).ptr;\n      for (uint32_t x = b.min_incl_x; x < b.max_excl_x; x++) {\n        wuffs_base__poke_u32le__no_bounds_check(p + (4 * (size_t)x), color);\n      }\n    }\n  } else if (fc.disposal() ==\n             WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_PREVIOUS) {\n    std::copy(m_saved.begin(), m_saved.end(), m_memory.begin());\n  }\n  return error_message;\n}\n\n// DecodeGifFramesOne decodes the frame at index i of all, the enti" +
+	"re input,\n// into slot. The image_decoder must have already decoded the image config.\nvoid  //\nDecodeGifFramesOne(wuffs_base__image_decoder& image_decoder,\n                   wuffs_base__slice_u8 all,\n                   const IndexFramesResult::Frame& frame,\n                   uint64_t i,\n                   DecodeGifFramesSlot& slot) {\n  slot.error_message.clear();\n  wuffs_base__status status =\n      image_decoder.restart_frame(i, frame.io_position);\n  if (!status.is_ok()) {\n    slot.error_message = status.message();\n    return;\n  } else if (frame.io_position > all.len) {\n    slot.error_message = DecodeImage_UnexpectedEndOfFile;\n    return;\n  }\n  wuffs_base__io_buffer src =\n      wuffs_base__ptr_u8__reader(all.ptr, all.len, true);\n  src.meta.ri = (size_t)frame.io_position;\n\n  status = image_decoder.decode_frame_config(&slot.frame_config, &src);\n  if (status.is_ok()) {\n    status = image_decoder.decode_frame(&slot.pixbuf, &src,\n                                        WUFFS_BASE__PIXEL_BLEND__SRC,\n             " +
+	"                           wuffs_base__empty_slice_u8(), nullptr);\n  }\n  if (status.repr == wuffs_base__suspension__short_read) {\n    slot.error_message = DecodeImage_UnexpectedEndOfFile;\n  } else if (!status.is_ok()) {\n    slot.error_message = status.message();\n  }\n  slot.dirty_rect = image_decoder.frame_dirty_rect();\n}\n\nDecodeGifFramesResult  //\nDecodeGifFramesSerial(DecodeGifFramesCallbacks& callbacks,\n                      sync_io::Input& input) {\n  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();\n  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();\n  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);\n  if (!io_buf) {\n    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);\n    fallback_io_buf =\n        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);\n    io_buf = &fallback_io_buf;\n  }\n\n  auto dec = wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder();\n  if (!dec) {\n    return DecodeGifFramesResult(0, DecodeGifFrames_OutOfMemory);\n  }\n  s" +
+	"td::vector<DecodeGifFramesSlot> slots(1);\n  DecodeGifFramesSlot& slot = slots[0];\n  DecodeGifFramesCanvas canvas;\n  uint64_t num_frames = 0;\n  wuffs_base__image_config image_config = wuffs_base__null_image_config();\n\n  // Each call (decode_image_config, decode_frame_config or decode_frame) is\n  // retried after short reads.\n  for (int stage = 0; true;) {\n    wuffs_base__status status;\n    if (stage == 0) {\n      status = dec->decode_image_config(&image_config, io_buf);\n    } else if (stage == 1) {\n      status = dec->decode_frame_config(&slot.frame_config, io_buf);\n    } else {\n      status = dec->decode_frame(&slot.pixbuf, io_buf,\n                                 WUFFS_BASE__PIXEL_BLEND__SRC,\n                                 wuffs_base__empty_slice_u8(), nullptr);\n    }\n\n    if (status.repr == wuffs_base__suspension__short_read) {\n      if (io_buf->meta.closed) {\n        return DecodeGifFramesResult(num_frames,\n                                     DecodeImage_UnexpectedEndOfFile);\n      }\n      std::string e" +
+	"rror_message = input.CopyIn(io_buf);\n      if (!error_message.empty()) {\n        return DecodeGifFramesResult(num_frames, std::move(error_message));\n      }\n      continue;\n    } else if ((stage == 1) && (status.repr == wuffs_base__note__end_of_data)) {\n      break;\n    } else if (!status.is_ok()) {\n      return DecodeGifFramesResult(num_frames, status.message());\n    }\n\n    if (stage == 0) {\n      std::string error_message = canvas.Init(image_config, slots);\n      if (!error_message.empty()) {\n        return DecodeGifFramesResult(num_frames, std::move(error_message));\n      }\n      stage = 1;\n    } else if (stage == 1) {\n      stage = 2;\n    } else {\n      slot.dirty_rect = dec->frame_dirty_rect();\n      std::string error_message = canvas.Composite(callbacks, slot);\n      num_frames++;\n      if (!error_message.empty()) {\n        return DecodeGifFramesResult(num_frames, std::move(error_message));\n      }\n      stage = 1;\n    }\n  }\n  return DecodeGifFramesResult(num_frames, \"\");\n}\n\n}  // namespace\n\nDecodeGifFr" +
+	"amesResult  //\nDecodeGifFrames(DecodeGifFramesCallbacks& callbacks,\n                sync_io::Input& input,\n                uint32_t num_threads) {\n  if (num_threads <= 1) {\n    return DecodeGifFramesSerial(callbacks, input);\n  }\n\n  std::vector<uint8_t> storage;\n  wuffs_base__slice_u8 all = wuffs_base__empty_slice_u8();\n  std::string error_message = DecodeImageReadAll(input, storage, &all);\n  if (!error_message.empty()) {\n    return DecodeGifFramesResult(0, std::move(error_message));\n  }\n\n  // Index the frames. The indexing decoder is then the calling thread's\n  // decoder. The other threads' decoders are created lazily, as not every\n  // animation has num_threads frames.\n  std::vector<wuffs_base__image_decoder::unique_ptr> decoders;\n  decoders.push_back(wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder());\n  if (!decoders[0]) {\n    return DecodeGifFramesResult(0, DecodeGifFrames_OutOfMemory);\n  }\n  sync_io::MemoryInput memory_input(all.ptr, all.len);\n  IndexFramesResult index = IndexFrames(*decoders[0]," +
+	" memory_input);\n  const size_t num_frames = index.frames.size();\n  if (num_frames == 0) {\n    return DecodeGifFramesResult(0, std::move(index.error_message));\n  } else if (!index.error_message.empty()) {\n    // The indexing decoder stopped mid-way through a suspended\n    // decode_frame_config call, so it cannot restart_frame.\n    decoders.clear();\n  }\n\n  std::vector<DecodeGifFramesSlot> slots(\n      std::min<size_t>(num_threads, std::max<size_t>(num_frames, 1)));\n  DecodeGifFramesCanvas canvas;\n  error_message = canvas.Init(index.image_config, slots);\n  if (!error_message.empty()) {\n    return DecodeGifFramesResult(0, std::move(error_message));\n  }\n  while (decoders.size() < slots.size()) {\n    auto dec = wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder();\n    if (!dec) {\n      return DecodeGifFramesResult(0, DecodeGifFrames_OutOfMemory);\n    }\n    wuffs_base__io_buffer src =\n        wuffs_base__ptr_u8__reader(all.ptr, all.len, true);\n    wuffs_base__status status = dec->decode_image_config(nullptr, &" +
+	"src);\n    if (!status.is_ok()) {\n      return DecodeGifFramesResult(0, status.message());\n    }\n    decoders.push_back(std::move(dec));\n  }\n\n  // Decode each round's frames concurrently, the first on this thread, and\n  // then composite them in order.\n  for (size_t r0 = 0; r0 < num_frames; r0 += slots.size()) {\n    size_t r1 = std::min(num_frames, r0 + slots.size());\n    std::vector<std::thread> threads;\n    for (size_t i = r0 + 1; i < r1; i++) {\n      threads.emplace_back([&, i]() {\n        DecodeGifFramesOne(*decoders[i - r0], all, index.frames[i], i,\n                           slots[i - r0]);\n      });\n    }\n    DecodeGifFramesOne(*decoders[0], all, index.frames[r0], r0, slots[0]);\n    for (auto& thread : threads) {\n      thread.join();\n    }\n\n    for (size_t i = r0; i < r1; i++) {\n      DecodeGifFramesSlot& slot = slots[i - r0];\n      if (!slot.error_message.empty()) {\n        return DecodeGifFramesResult(i, std::move(slot.error_message));\n      }\n      error_message = canvas.Composite(callbacks, slot);\n " +
+	"     if (!error_message.empty()) {\n        return DecodeGifFramesResult(i + 1, std::move(error_message));\n      }\n    }\n  }\n  return DecodeGifFramesResult(num_frames, std::move(index.error_message));\n}\n\n#endif  // defined(WUFFS_AUX__DECODE_GIF_FRAMES)\n\n" +
+	"" +
+	"// --------\n\n#if !defined(WUFFS_CONFIG__MODULES) ||                                      \\\n    (defined(WUFFS_CONFIG__MODULE__ADLER32) &&                              \\\n     defined(WUFFS_CONFIG__MODULE__CRC32) &&                                \\\n     defined(WUFFS_CONFIG__MODULE__DEFLATE) &&                              \\\n     defined(WUFFS_CONFIG__MODULE__PNG))\n#define WUFFS_AUX__ENCODE_PNG\n#endif\n\n#if defined(WUFFS_AUX__ENCODE_PNG)\n\nEncodePngResult::EncodePngResult(std::string&& dst0,\n                                 std::string&& error_message0)\n    : dst(std::move(dst0)), error_message(std::move(error_message0)) {}\n\nconst char EncodePng_OutOfMemory[] =  //\n    \"wuffs_aux::EncodePng: out of memory\";\n\nnamespace {\n\n// EncodePngRows appends, to dst, either the complete PNG image (if y1 is\n// zero) or the zlib-compressed IDAT data for the rows y0 .. y1. For the\n// latter, it also sets *strip_adler32 to that data's uncompressed Adler-32\n// checksum.\nstd::string  //\nEncodePngRows(std::string& dst,\n             " +
+	" uint32_t* strip_adler32,\n              wuffs_base__pixel_buffer& src,\n              uint32_t level,\n              uint32_t y0,\n              uint32_t y1) {\n  wuffs_png__encoder::unique_ptr enc = wuffs_png__encoder::alloc();\n  if (!enc) {\n    return EncodePng_OutOfMemory;\n  }\n  enc->set_level(level);\n  wuffs_base__status status = enc->prepare(&src);\n  if (!status.is_ok()) {\n    return status.message();\n  }\n  std::vector<uint8_t> workbuf(enc->workbuf_len().max_incl);\n  wuffs_base__slice_u8 w =\n      wuffs_base__make_slice_u8(workbuf.data(), workbuf.size());\n\n  uint8_t buf[32768];\n  while (true) {\n    wuffs_base__io_buffer io_buf = wuffs_base__ptr_u8__writer(buf, sizeof buf);\n    status = (y1 == 0) ? enc->encode_image(&io_buf, &src, w)\n                       : enc->encode_strip(&io_buf, &src, y0, y1, w);\n    dst.append(reinterpret_cast<const char*>(buf), io_buf.meta.wi);\n    if (status.repr != wuffs_base__suspension__short_write) {\n      break;\n    }\n  }\n  if (!status.is_ok()) {\n    return status.message();\n  }" +
+	"\n  if (strip_adler32) {\n    *strip_adler32 = enc->strip_adler32();\n  }\n  return \"\";\n}\n\n// EncodePngChunk appends a PNG chunk, with the given type and payload, to\n// dst. Long payloads are split over multiple chunks of the same type.\nstd::string  //\nEncodePngChunk(std::string& dst, uint32_t chunk_type, std::string& data) {\n  // kMaxChunkLength is well under the PNG specification's 0x7FFF_FFFF limit.\n  static const size_t kMaxChunkLength = 0x100000;\n  auto crc32 = wuffs_crc32__ieee_hasher::alloc();\n  if (!crc32) {\n    return EncodePng_OutOfMemory;\n  }\n  size_t i = 0;\n  do {\n    size_t n = std::min(data.size() - i, kMaxChunkLength);\n    uint8_t header[8];\n    wuffs_base__poke_u32be__no_bounds_check(header + 0, (uint32_t)n);\n    wuffs_base__poke_u32be__no_bounds_check(header + 4, chunk_type);\n    crc32->update_u32(wuffs_base__make_slice_u8(header + 4, 4));\n    uint8_t footer[4];\n    wuffs_base__poke_u32be__no_bounds_check(\n        footer, crc32->update_u32(wuffs_base__make_slice_u8(\n                    reinterpre" +
+	"t_cast<uint8_t*>(&data[0]) + i, n)));\n    dst.append(reinterpret_cast<const char*>(header), 8);\n    dst.append(data, i, n);\n    dst.append(reinterpret_cast<const char*>(footer), 4);\n    i += n;\n\n    wuffs_base__status status =\n        crc32->initialize(sizeof__wuffs_crc32__ieee_hasher(), WUFFS_VERSION, 0);\n    if (!status.is_ok()) {\n      return status.message();\n    }\n  } while (i < data.size());\n  return \"\";\n}\n\n}  // namespace\n\nEncodePngResult  //\nEncodePng(wuffs_base__pixel_buffer& src,\n          uint32_t level,\n          uint32_t num_threads) {\n  std::string dst;\n  uint32_t height = src.pixcfg.height();\n  uint32_t num_strips = std::min(num_threads, height);\n  if (num_strips <= 1) {\n    std::string error_message = EncodePngRows(dst, nullptr, src, level, 0, 0);\n    if (!error_message.empty()) {\n      return EncodePngResult(\"\", std::move(error_message));\n    }\n    return EncodePngResult(std::move(dst), \"\");\n  }\n\n  // Compress the strips concurrently, the first on this thread.\n  std::vector<std::string> strip" +
+	"s(num_strips);\n  std::vector<uint32_t> strip_adler32s(num_strips);\n  std::vector<std::string> error_messages(num_strips);\n  auto encode_strip = [&](uint32_t i) {\n    uint32_t y0 = (uint32_t)(((uint64_t)height * (i + 0)) / num_strips);\n    uint32_t y1 = (uint32_t)(((uint64_t)height * (i + 1)) / num_strips);\n    error_messages[i] =\n        EncodePngRows(strips[i], &strip_adler32s[i], src, level, y0, y1);\n  };\n  std::vector<std::thread> threads;\n  for (uint32_t i = 1; i < num_strips; i++) {\n    threads.emplace_back(encode_strip, i);\n  }\n  encode_strip(0);\n  for (auto& thread : threads) {\n    thread.join();\n  }\n  for (auto& error_message : error_messages) {\n    if (!error_message.empty()) {\n      return EncodePngResult(\"\", std::move(error_message));\n    }\n  }\n\n  // The zlib checksum is the strips' checksums, combined. Each strip's\n  // uncompressed data is one filter byte and then the pixel bytes per row.\n  auto adler32 = wuffs_adler32__hasher::alloc();\n  if (!adler32) {\n    return EncodePngResult(\"\", EncodePng_O" +
+	"utOfMemory);\n  }\n  wuffs_base__pixel_format pixfmt = src.pixcfg.pixel_format();\n  uint32_t bits_per_pixel = pixfmt.bits_per_pixel();\n  uint64_t bytes_per_row =\n      1 + ((uint64_t)src.pixcfg.width() * (bits_per_pixel / 8));\n  uint32_t checksum = 1;\n  for (uint32_t i = 0; i < num_strips; i++) {\n    uint32_t y0 = (uint32_t)(((uint64_t)height * (i + 0)) / num_strips);\n    uint32_t y1 = (uint32_t)(((uint64_t)height * (i + 1)) / num_strips);\n    checksum = adler32->combine_u32(checksum, strip_adler32s[i],\n                                    (y1 - y0) * bytes_per_row);\n  }\n  uint8_t checksum_bytes[4];\n  wuffs_base__poke_u32be__no_bounds_check(checksum_bytes, checksum);\n  strips.back().append(reinterpret_cast<const char*>(checksum_bytes), 4);\n\n  // The signature, the IHDR chunk, the IDAT chunks and the IEND chunk. The\n  // pixel buffer's format was already checked by the wuffs_png__encoders.\n  dst.append(\"\\x89PNG\\r\\n\\x1A\\n\", 8);\n  uint8_t ihdr[13];\n  wuffs_base__poke_u32be__no_bounds_check(ihdr + 0, src.pixcfg.widt" +
+	"h());\n  wuffs_base__poke_u32be__no_bounds_check(ihdr + 4, height);\n  ihdr[8] = 8;\n  ihdr[9] = (bits_per_pixel == 8) ? 0 : (bits_per_pixel == 24) ? 2 : 6;\n  ihdr[10] = 0;\n  ihdr[11] = 0;\n  ihdr[12] = 0;\n  std::string chunk(reinterpret_cast<const char*>(ihdr), 13);\n  std::string error_message =\n      EncodePngChunk(dst, 0x49484452, chunk);  // \"IHDR\" as a big-endian u32.\n  for (uint32_t i = 0; error_message.empty() && (i < num_strips); i++) {\n    error_message = EncodePngChunk(dst, 0x49444154, strips[i]);  // \"IDAT\".\n    strips[i].clear();\n  }\n  if (error_message.empty()) {\n    chunk.clear();\n    error_message = EncodePngChunk(dst, 0x49454E44, chunk);  // \"IEND\".\n  }\n  if (!error_message.empty()) {\n    return EncodePngResult(\"\", std::move(error_message));\n  }\n  return EncodePngResult(std::move(dst), \"\");\n}\n\n#endif  // defined(WUFFS_AUX__ENCODE_PNG)\n\n}  // namespace wuffs_aux\n\n#endif  // !defined(WUFFS_CONFIG__MODULES) ||\n        // defined(WUFFS_CONFIG__MODULE__AUX__IMAGE)\n" +
 	""
 
 const AuxImageHh = "" +
-	"// ---------------- Auxiliary - Image\n\nnamespace wuffs_aux {\n\nstruct DecodeImageResult {\n  DecodeImageResult(MemOwner&& pixbuf_mem_owner0,\n                    wuffs_base__pixel_buffer pixbuf0,\n                    std::string&& error_message0);\n  DecodeImageResult(std::string&& error_message0);\n\n  MemOwner pixbuf_mem_owner;\n  wuffs_base__pixel_buffer pixbuf;\n  std::string error_message;\n};\n\n// DecodeImageCallbacks are the callbacks given to DecodeImage. They are always\n// called in this order:\n//  1. SelectDecoder\n//  2. SelectPixfmt\n//  3. AllocPixbuf\n//  4. AllocWorkbuf\n//  5. Done\n//\n// It may return early - the third callback might not be invoked if the second\n// one fails - but the final callback (Done) is always invoked.\nclass DecodeImageCallbacks {\n public:\n  // AllocPixbufResult holds a memory allocation (the result of malloc or new,\n  // a statically allocated pointer, etc), or an error message. The memory is\n  // de-allocated when mem_owner goes out of scope and is destroyed.\n  struct AllocPixbufResu" +
-	"lt {\n    AllocPixbufResult(MemOwner&& mem_owner0, wuffs_base__pixel_buffer pixbuf0);\n    AllocPixbufResult(std::string&& error_message0);\n\n    MemOwner mem_owner;\n    wuffs_base__pixel_buffer pixbuf;\n    std::string error_message;\n  };\n\n  // AllocWorkbufResult holds a memory allocation (the result of malloc or new,\n  // a statically allocated pointer, etc), or an error message. The memory is\n  // de-allocated when mem_owner goes out of scope and is destroyed.\n  struct AllocWorkbufResult {\n    AllocWorkbufResult(MemOwner&& mem_owner0, wuffs_base__slice_u8 workbuf0);\n    AllocWorkbufResult(std::string&& error_message0);\n\n    MemOwner mem_owner;\n    wuffs_base__slice_u8 workbuf;\n    std::string error_message;\n  };\n\n  virtual ~DecodeImageCallbacks();\n\n  // SelectDecoder returns the image decoder for the input data's file format.\n  // Returning a nullptr means failure (DecodeImage_UnsupportedImageFormat).\n  //\n  // Common formats will have a FourCC value in the range [1 ..= 0x7FFF_FFFF],\n  // such as WUFFS_BASE__F" +
-	"OURCC__JPEG. A zero FourCC value means that the\n  // caller is responsible for examining the opening bytes (a prefix) of the\n  // input data. SelectDecoder implementations should not modify those bytes.\n  //\n  // SelectDecoder might be called more than once, since some image file\n  // formats can wrap others. For example, a nominal BMP file can actually\n  // contain a JPEG or a PNG.\n  //\n  // The default SelectDecoder accepts the FOURCC codes listed below. For\n  // modular builds (i.e. when #define'ing WUFFS_CONFIG__MODULES), acceptance\n  // of the ETC file format is optional (for each value of ETC) and depends on\n  // the corresponding module to be enabled at compile time (i.e. #define'ing\n  // WUFFS_CONFIG__MODULE__ETC).\n  //  - WUFFS_BASE__FOURCC__BMP\n  //  - WUFFS_BASE__FOURCC__GIF\n  //  - WUFFS_BASE__FOURCC__NIE\n  //  - WUFFS_BASE__FOURCC__PNG\n  //  - WUFFS_BASE__FOURCC__WBMP\n  virtual wuffs_base__image_decoder::unique_ptr  //\n  SelectDecoder(uint32_t fourcc, wuffs_base__slice_u8 prefix);\n\n  // SelectPix" +
-	"fmt returns the destination pixel format for AllocPixbuf. It\n  // should return wuffs_base__make_pixel_format(etc) called with one of:\n  //  - WUFFS_BASE__PIXEL_FORMAT__BGR_565\n  //  - WUFFS_BASE__PIXEL_FORMAT__BGR\n  //  - WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL\n  //  - WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE\n  //  - WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL\n  //  - WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL\n  //  - WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL\n  // or return image_config.pixcfg.pixel_format(). The latter means to use the\n  // image file's natural pixel format. For example, GIF images' natural pixel\n  // format is an indexed one.\n  //\n  // Returning otherwise means failure (DecodeImage_UnsupportedPixelFormat).\n  //\n  // The default SelectPixfmt implementation returns\n  // wuffs_base__make_pixel_format(WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL) which\n  // is 4 bytes per pixel (8 bits per channel × 4 channels).\n  virtual wuffs_base__pixel_format  //\n  SelectPixfmt(const wuffs_base__image_config& image_" +
-	"config);\n\n  // AllocPixbuf allocates the pixel buffer.\n  //\n  // allow_uninitialized_memory will be true if a valid background_color was\n  // passed to DecodeImage, since the pixel buffer's contents will be\n  // overwritten with that color after AllocPixbuf returns.\n  //\n  // The default AllocPixbuf implementation allocates either uninitialized or\n  // zeroed memory. Zeroed memory typically corresponds to filling with opaque\n  // black or transparent black, depending on the pixel format.\n  virtual AllocPixbufResult  //\n  AllocPixbuf(const wuffs_base__image_config& image_config,\n              bool allow_uninitialized_memory);\n\n  // AllocWorkbuf allocates the work buffer. The allocated buffer's length\n  // should be at least len_range.min_incl, but larger allocations (up to\n  // len_range.max_incl) may have better performance (by using more memory).\n  //\n  // The default AllocWorkbuf implementation allocates len_range.max_incl bytes\n  // of either uninitialized or zeroed memory.\n  virtual AllocWorkbufResult  //" +
-	"\n  AllocWorkbuf(wuffs_base__range_ii_u64 len_range,\n               bool allow_uninitialized_memory);\n\n  // Done is always the last Callback method called by DecodeImage, whether or\n  // not parsing the input encountered an error. Even when successful, trailing\n  // data may remain in input and buffer.\n  //\n  // The image_decoder is the one returned by SelectDecoder (if SelectDecoder\n  // was successful), or a no-op unique_ptr otherwise. Like any unique_ptr,\n  // ownership moves to the Done implementation.\n  //\n  // Do not keep a reference to buffer or buffer.data.ptr after Done returns,\n  // as DecodeImage may then de-allocate the backing array.\n  //\n  // The default Done implementation is a no-op, other than running the\n  // image_decoder unique_ptr destructor.\n  virtual void  //\n  Done(DecodeImageResult& result,\n       sync_io::Input& input,\n       IOBuffer& buffer,\n       wuffs_base__image_decoder::unique_ptr image_decoder);\n};\n\nextern const char DecodeImage_BufferIsTooShort[];\nextern const char DecodeImag" +
-	"e_MaxInclDimensionExceeded[];\nextern const char DecodeImage_OutOfMemory[];\nextern const char DecodeImage_UnexpectedEndOfFile[];\nextern const char DecodeImage_UnsupportedImageFormat[];\nextern const char DecodeImage_UnsupportedPixelBlend[];\nextern const char DecodeImage_UnsupportedPixelConfiguration[];\nextern const char DecodeImage_UnsupportedPixelFormat[];\n\n// DecodeImage decodes the image data in input. A variety of image file formats\n// can be decoded, depending on what callbacks.SelectDecoder returns.\n//\n// For animated formats, only the first frame is returned, since the API is\n// simpler for synchronous I/O and having DecodeImage only return when\n// completely done, but rendering animation often involves handling other\n// events in between animation frames. To decode multiple frames of animated\n// images, or for asynchronous I/O (e.g. when decoding an image streamed over\n// the network), use Wuffs' lower level C API instead of its higher level,\n// simplified C++ API (the wuffs_aux API).\n//\n// The DecodeIm" +
-	"ageResult's fields depend on whether decoding succeeded:\n//  - On total success, the error_message is empty and pixbuf.pixcfg.is_valid()\n//    is true.\n//  - On partial success (e.g. the input file was truncated but we are still\n//    able to decode some of the pixels), error_message is non-empty but\n//    pixbuf.pixcfg.is_valid() is still true. It is up to the caller whether to\n//    accept or reject partial success.\n//  - On failure, the error_message is non_empty and pixbuf.pixcfg.is_valid()\n//    is false.\n//\n// The callbacks allocate the pixel buffer memory and work buffer memory. On\n// success, pixel buffer memory ownership is passed to the DecodeImage caller\n// as the returned pixbuf_mem_owner. Regardless of success or failure, the work\n// buffer memory is deleted.\n//\n// The pixel_blend (one of the constants listed below) determines how to\n// composite the decoded image over the pixel buffer's original pixels (as\n// returned by callbacks.AllocPixbuf):\n//  - WUFFS_BASE__PIXEL_BLEND__SRC\n//  - WUFFS_BASE" +
-	"__PIXEL_BLEND__SRC_OVER\n//\n// The background_color is used to fill the pixel buffer after\n// callbacks.AllocPixbuf returns, if it is valid in the\n// wuffs_base__color_u32_argb_premul__is_valid sense. The default value,\n// 0x0000_0001, is not valid since its Blue channel value (0x01) is greater\n// than its Alpha channel value (0x00). A valid background_color will typically\n// be overwritten when pixel_blend is WUFFS_BASE__PIXEL_BLEND__SRC, but might\n// still be visible on partial (not total) success or when pixel_blend is\n// WUFFS_BASE__PIXEL_BLEND__SRC_OVER and the decoded image is not fully opaque.\n//\n// Decoding fails (with DecodeImage_MaxInclDimensionExceeded) if the image's\n// width or height is greater than max_incl_dimension.\nDecodeImageResult  //\nDecodeImage(DecodeImageCallbacks& callbacks,\n            sync_io::Input& input,\n            wuffs_base__pixel_blend pixel_blend = WUFFS_BASE__PIXEL_BLEND__SRC,\n            wuffs_base__color_u32_argb_premul background_color = 1,  // Invalid.\n            uint32_" +
-	"t max_incl_dimension = 1048575);  // 0x000F_FFFF\n\n}  // namespace wuffs_aux\n" +
+	"// ---------------- Auxiliary - Image\n\n#include <vector>\n\nnamespace wuffs_aux {\n\nstruct DecodeImageResult {\n  DecodeImageResult(MemOwner&& pixbuf_mem_owner0,\n                    wuffs_base__pixel_buffer pixbuf0,\n                    std::string&& error_message0);\n  DecodeImageResult(std::string&& error_message0);\n\n  MemOwner pixbuf_mem_owner;\n  wuffs_base__pixel_buffer pixbuf;\n  std::string error_message;\n};\n\n// DecodeImageCallbacks are the callbacks given to DecodeImage. They are always\n// called in this order:\n//  1. SelectDecoder\n//  2. SelectPixfmt\n//  3. AllocPixbuf\n//  4. AllocWorkbuf\n//  5. Done\n//\n// It may return early - the third callback might not be invoked if the second\n// one fails - but the final callback (Done) is always invoked.\nclass DecodeImageCallbacks {\n public:\n  // AllocPixbufResult holds a memory allocation (the result of malloc or new,\n  // a statically allocated pointer, etc), or an error message. The memory is\n  // de-allocated when mem_owner goes out of scope and is destroyed.\n  str" +
+	"uct AllocPixbufResult {\n    AllocPixbufResult(MemOwner&& mem_owner0, wuffs_base__pixel_buffer pixbuf0);\n    AllocPixbufResult(std::string&& error_message0);\n\n    MemOwner mem_owner;\n    wuffs_base__pixel_buffer pixbuf;\n    std::string error_message;\n  };\n\n  // AllocWorkbufResult holds a memory allocation (the result of malloc or new,\n  // a statically allocated pointer, etc), or an error message. The memory is\n  // de-allocated when mem_owner goes out of scope and is destroyed.\n  struct AllocWorkbufResult {\n    AllocWorkbufResult(MemOwner&& mem_owner0, wuffs_base__slice_u8 workbuf0);\n    AllocWorkbufResult(std::string&& error_message0);\n\n    MemOwner mem_owner;\n    wuffs_base__slice_u8 workbuf;\n    std::string error_message;\n  };\n\n  virtual ~DecodeImageCallbacks();\n\n  // SelectDecoder returns the image decoder for the input data's file format.\n  // Returning a nullptr means failure (DecodeImage_UnsupportedImageFormat).\n  //\n  // Common formats will have a FourCC value in the range [1 ..= 0x7FFF_FFFF],\n  // su" +
+	"ch as WUFFS_BASE__FOURCC__JPEG. A zero FourCC value means that the\n  // caller is responsible for examining the opening bytes (a prefix) of the\n  // input data. SelectDecoder implementations should not modify those bytes.\n  //\n  // SelectDecoder might be called more than once, since some image file\n  // formats can wrap others. For example, a nominal BMP file can actually\n  // contain a JPEG or a PNG.\n  //\n  // The default SelectDecoder accepts the FOURCC codes listed below. For\n  // modular builds (i.e. when #define'ing WUFFS_CONFIG__MODULES), acceptance\n  // of the ETC file format is optional (for each value of ETC) and depends on\n  // the corresponding module to be enabled at compile time (i.e. #define'ing\n  // WUFFS_CONFIG__MODULE__ETC).\n  //  - WUFFS_BASE__FOURCC__BMP\n  //  - WUFFS_BASE__FOURCC__GIF\n  //  - WUFFS_BASE__FOURCC__NIE\n  //  - WUFFS_BASE__FOURCC__PNG\n  //  - WUFFS_BASE__FOURCC__WBMP\n  virtual wuffs_base__image_decoder::unique_ptr  //\n  SelectDecoder(uint32_t fourcc, wuffs_base__slice_u8 prefi" +
+	"x);\n\n  // SelectPixfmt returns the destination pixel format for AllocPixbuf. It\n  // should return wuffs_base__make_pixel_format(etc) called with one of:\n  //  - WUFFS_BASE__PIXEL_FORMAT__BGR_565\n  //  - WUFFS_BASE__PIXEL_FORMAT__BGR\n  //  - WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL\n  //  - WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE\n  //  - WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL\n  //  - WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL\n  //  - WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL\n  // or return image_config.pixcfg.pixel_format(). The latter means to use the\n  // image file's natural pixel format. For example, GIF images' natural pixel\n  // format is an indexed one.\n  //\n  // Returning otherwise means failure (DecodeImage_UnsupportedPixelFormat).\n  //\n  // The default SelectPixfmt implementation returns\n  // wuffs_base__make_pixel_format(WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL) which\n  // is 4 bytes per pixel (8 bits per channel × 4 channels).\n  virtual wuffs_base__pixel_format  //\n  SelectPixfmt(const wuffs_base__i" +
+	"mage_config& image_config);\n\n  // AllocPixbuf allocates the pixel buffer.\n  //\n  // allow_uninitialized_memory will be true if a valid background_color was\n  // passed to DecodeImage, since the pixel buffer's contents will be\n  // overwritten with that color after AllocPixbuf returns.\n  //\n  // The default AllocPixbuf implementation allocates either uninitialized or\n  // zeroed memory. Zeroed memory typically corresponds to filling with opaque\n  // black or transparent black, depending on the pixel format.\n  virtual AllocPixbufResult  //\n  AllocPixbuf(const wuffs_base__image_config& image_config,\n              bool allow_uninitialized_memory);\n\n  // AllocWorkbuf allocates the work buffer. The allocated buffer's length\n  // should be at least len_range.min_incl, but larger allocations (up to\n  // len_range.max_incl) may have better performance (by using more memory).\n  //\n  // The default AllocWorkbuf implementation allocates len_range.max_incl bytes\n  // of either uninitialized or zeroed memory.\n  virtual All" +
+	"ocWorkbufResult  //\n  AllocWorkbuf(wuffs_base__range_ii_u64 len_range,\n               bool allow_uninitialized_memory);\n\n  // Done is always the last Callback method called by DecodeImage, whether or\n  // not parsing the input encountered an error. Even when successful, trailing\n  // data may remain in input and buffer.\n  //\n  // The image_decoder is the one returned by SelectDecoder (if SelectDecoder\n  // was successful), or a no-op unique_ptr otherwise. Like any unique_ptr,\n  // ownership moves to the Done implementation.\n  //\n  // Do not keep a reference to buffer or buffer.data.ptr after Done returns,\n  // as DecodeImage may then de-allocate the backing array.\n  //\n  // The default Done implementation is a no-op, other than running the\n  // image_decoder unique_ptr destructor.\n  virtual void  //\n  Done(DecodeImageResult& result,\n       sync_io::Input& input,\n       IOBuffer& buffer,\n       wuffs_base__image_decoder::unique_ptr image_decoder);\n};\n\nextern const char DecodeImage_BufferIsTooShort[];\nextern co" +
+	"nst char DecodeImage_MaxInclDimensionExceeded[];\nextern const char DecodeImage_OutOfMemory[];\nextern const char DecodeImage_UnexpectedEndOfFile[];\nextern const char DecodeImage_UnsupportedDownscaleShift[];\nextern const char DecodeImage_UnsupportedImageFormat[];\nextern const char DecodeImage_UnsupportedPixelBlend[];\nextern const char DecodeImage_UnsupportedPixelConfiguration[];\nextern const char DecodeImage_UnsupportedPixelFormat[];\n\n// DecodeImage decodes the image data in input. A variety of image file formats\n// can be decoded, depending on what callbacks.SelectDecoder returns.\n//\n// For animated formats, only the first frame is returned, since the API is\n// simpler for synchronous I/O and having DecodeImage only return when\n// completely done, but rendering animation often involves handling other\n// events in between animation frames. To decode multiple frames of animated\n// images, or for asynchronous I/O (e.g. when decoding an image streamed over\n// the network), use Wuffs' lower level C API instead of i" +
+	"ts higher level,\n// simplified C++ API (the wuffs_aux API).\n//\n// The DecodeImageResult's fields depend on whether decoding succeeded:\n//  - On total success, the error_message is empty and pixbuf.pixcfg.is_valid()\n//    is true.\n//  - On partial success (e.g. the input file was truncated but we are still\n//    able to decode some of the pixels), error_message is non-empty but\n//    pixbuf.pixcfg.is_valid() is still true. It is up to the caller whether to\n//    accept or reject partial success.\n//  - On failure, the error_message is non_empty and pixbuf.pixcfg.is_valid()\n//    is false.\n//\n// The callbacks allocate the pixel buffer memory and work buffer memory. On\n// success, pixel buffer memory ownership is passed to the DecodeImage caller\n// as the returned pixbuf_mem_owner. Regardless of success or failure, the work\n// buffer memory is deleted.\n//\n// The pixel_blend (one of the constants listed below) determines how to\n// composite the decoded image over the pixel buffer's original pixels (as\n// returned " +
+	"by callbacks.AllocPixbuf):\n//  - WUFFS_BASE__PIXEL_BLEND__SRC\n//  - WUFFS_BASE__PIXEL_BLEND__SRC_OVER\n//\n// The background_color is used to fill the pixel buffer after\n// callbacks.AllocPixbuf returns, if it is valid in the\n// wuffs_base__color_u32_argb_premul__is_valid sense. The default value,\n// 0x0000_0001, is not valid since its Blue channel value (0x01) is greater\n// than its Alpha channel value (0x00). A valid background_color will typically\n// be overwritten when pixel_blend is WUFFS_BASE__PIXEL_BLEND__SRC, but might\n// still be visible on partial (not total) success or when pixel_blend is\n// WUFFS_BASE__PIXEL_BLEND__SRC_OVER and the decoded image is not fully opaque.\n//\n// Decoding fails (with DecodeImage_MaxInclDimensionExceeded) if the image's\n// width or height is greater than max_incl_dimension.\n//\n// When num_threads is 0 or 1, decoding is single-threaded and streams the\n// input. Otherwise, the entire input is read into memory (unless it is already\n// there: a sync_io::MemoryInput) and, for PNG" +
+	" images, decoding is pipelined\n// across two threads. A second thread inflates the zlib-compressed IDAT data\n// while the calling thread un-filters and swizzles rows that have already\n// been inflated. All of the callbacks are still called from the calling\n// thread, but the IDAT chunks' CRC-32 and the zlib Adler-32 checksums are not\n// verified. Other image formats are decoded single-threaded. Either way, the\n// input passed to Done is then the in-memory input that was decoded, which\n// continues after the image data just like the original input would.\n//\n// When downscale_shift is 1, 2 or 3, the image is reduced to 1/2, 1/4 or 1/8\n// of its width and height (rounding up), e.g. for thumbnails, and AllocPixbuf\n// is only asked for that reduced size. Each pixel is the average of a block of\n// full size pixels (see wuffs_base__decode_frame_options__set_downscale_shift).\n// PNG and GIF images are downscaled as they are decoded (stopping early for\n// interlaced images). Other image formats are decoded to a tempor" +
+	"ary, full\n// size, pixel buffer first. The max_incl_dimension applies to the full size.\n// Larger shifts fail with DecodeImage_UnsupportedDownscaleShift.\nDecodeImageResult  //\nDecodeImage(DecodeImageCallbacks& callbacks,\n            sync_io::Input& input,\n            wuffs_base__pixel_blend pixel_blend = WUFFS_BASE__PIXEL_BLEND__SRC,\n            wuffs_base__color_u32_argb_premul background_color = 1,  // Invalid.\n            uint32_t max_incl_dimension = 1048575,  // 0x000F_FFFF\n            uint32_t num_threads = 1,\n            uint32_t downscale_shift = 0);\n\n" +
+	"" +
+	"// --------\n\nstruct IndexFramesResult {\n  // Frame is an animation frame's entry in the index. A keyframe can be\n  // composited without any earlier frames, starting from a canvas cleared to\n  // the background: either it is the first frame, or the previous frame's\n  // disposal restores the whole canvas to the background, or it covers the\n  // whole canvas and replaces every pixel (because it is opaque or because\n  // it overwrites instead of blends). In that last case, its own disposal\n  // must not be RESTORE_PREVIOUS, as later frames would then need the canvas\n  // from before it.\n  struct Frame {\n    uint64_t io_position;\n    wuffs_base__rect_ie_u32 bounds;\n    wuffs_base__flicks duration;\n    wuffs_base__animation_disposal disposal;\n    bool keyframe;\n  };\n\n  IndexFramesResult(wuffs_base__image_config image_config0,\n                    std::vector<Frame>&& frames0,\n                    std::string&& error_message0);\n\n  // KeyframeFor returns the index of the nearest keyframe at or before frame\n  // n. Re" +
+	"ndering frame n only needs frames from there onwards.\n  size_t KeyframeFor(size_t n) const;\n\n  wuffs_base__image_config image_config;\n  std::vector<Frame> frames;\n  std::string error_message;\n};\n\n// IndexFrames walks an animated image once, with decode_frame_config, to\n// record every frame's io_position, bounds, duration and disposal. The pixel\n// data is skipped, not decoded. The image_decoder must be freshly created\n// (e.g. by wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder) and\n// afterwards it can seek to frame n, for any index n, by calling\n// restart_frame(k, frames[k].io_position), with k being KeyframeFor(n), then\n// decoding frames k to n from that io_position in its input.\n//\n// On failure (including a truncated input), error_message is non-empty but\n// frames still lists the frames indexed before the failure. The image_decoder\n// may then be mid-way through a suspended call and cannot seek: decode those\n// frames with another (fresh) decoder instead.\nIndexFramesResult  //\nIndexFrames(wuff" +
+	"s_base__image_decoder& image_decoder, sync_io::Input& input);\n\n" +
+	"" +
+	"// --------\n\nclass DecodeGifFramesCallbacks {\n public:\n  virtual ~DecodeGifFramesCallbacks();\n\n  // Frame is called from the calling thread, once per frame and in frame\n  // order, after that frame has been composited onto the canvas. The canvas\n  // is a BGRA_PREMUL pixel buffer the size of the whole image, and is only\n  // valid for the duration of the call. Returning a non-empty string stops\n  // decoding, with that string as the error_message.\n  virtual std::string  //\n  Frame(const wuffs_base__frame_config& frame_config,\n        const wuffs_base__pixel_buffer& canvas) = 0;\n};\n\nstruct DecodeGifFramesResult {\n  DecodeGifFramesResult(uint64_t num_frames0, std::string&& error_message0);\n  // num_frames is the number of callbacks.Frame calls.\n  uint64_t num_frames;\n  std::string error_message;\n};\n\nextern const char DecodeGifFrames_OutOfMemory[];\n\n// DecodeGifFrames decodes every frame of an (animated) GIF image, compositing\n// each over the canvas left by the previous frame's disposal.\n//\n// When num_threads " +
+	"is 0 or 1, frames are decoded one at a time. Otherwise,\n// the entire input is read into memory and indexed (see IndexFrames). Frames\n// are then decoded in rounds of num_threads frames, each frame's palette\n// indices into its own buffer on its own thread, by a per-thread\n// wuffs_gif__decoder (and its wuffs_lzw__decoder) that is re-used from one\n// round to the next via restart_frame. LZW decoding is independent from one\n// frame to the next. Compositing is not, so after each round the calling\n// thread composites that round's frames, in order.\nDecodeGifFramesResult  //\nDecodeGifFrames(DecodeGifFramesCallbacks& callbacks,\n                sync_io::Input& input,\n                uint32_t num_threads = 1);\n\n" +
+	"" +
+	"// --------\n\nstruct EncodePngResult {\n  EncodePngResult(std::string&& dst0, std::string&& error_message0);\n\n  std::string dst;\n  std::string error_message;\n};\n\nextern const char EncodePng_OutOfMemory[];\n\n// EncodePng encodes the src pixel buffer as a PNG image. Its pixel format\n// must be 8 (Y), 24 (e.g. BGR or RGB) or 32 (e.g. BGRA_PREMUL or\n// RGBA_NONPREMUL) bits per pixel, giving a gray, RGB or RGBA PNG image. The\n// level is the compression level, from 0 (no compression) to 9 (best).\n//\n// When num_threads is 0 or 1, encoding is single-threaded. Otherwise, the\n// image is split into num_threads horizontal strips (or fewer, for very short\n// images). Each strip is filtered and compressed on its own thread, by its own\n// wuffs_png__encoder, as DEFLATE blocks that end with a full flush. The\n// calling thread then joins the strips, one or more IDAT chunks each, as a\n// single zlib stream and combines the strips' Adler-32 checksums. Compression\n// is slightly worse than single-threaded, since no strip can ref" +
+	"er back to an\n// earlier strip's data.\n//\n// On success, the EncodePngResult's error_message is empty and dst holds the\n// PNG image. On failure, error_message is non-empty.\nEncodePngResult  //\nEncodePng(wuffs_base__pixel_buffer& src,\n          uint32_t level = 6,\n          uint32_t num_threads = 1);\n\n}  // namespace wuffs_aux\n" +
 	""
 
 const AuxJsonCc = "" +
@@ -892,12 +1123,14 @@ const AuxJsonHh = "" +
 
 var AuxNonBaseCcFiles = []string{
 	AuxCborCc,
+	AuxDeflateCc,
 	AuxImageCc,
 	AuxJsonCc,
 }
 
 var AuxNonBaseHhFiles = []string{
 	AuxCborHh,
+	AuxDeflateHh,
 	AuxImageHh,
 	AuxJsonHh,
 }
@@ -156,14 +156,17 @@ func (g *gen) writeExprOther(b *buffer, n *a.Expr, sideEffectsOnly bool, depth u
 		rcv := (*big.Int)(nil)
 		lhsIsArray := lhs.MType().IsArrayType()
 		if lhsIsArray {
-			if (mhs != nil) && (mhs.ConstValue() != nil) {
-				mcv = mhs.ConstValue()
-				mhs = nil
-			}
 			if (rhs != nil) && (rhs.ConstValue() != nil) {
 				rcv = rhs.ConstValue()
 				rhs = nil
 			}
+			// A non-zero constant mhs can only be folded into the pointer
+			// if rhs is too, as a subslice_j's j is relative to that pointer.
+			if (mhs != nil) && (mhs.ConstValue() != nil) &&
+				((rhs == nil) || (mhs.ConstValue().Sign() == 0)) {
+				mcv = mhs.ConstValue()
+				mhs = nil
+			}
 		}
 
 		switch {
@@ -588,6 +591,7 @@ var cTypeNames = [...]string{
 	t.IDARMNeonU64x2: "uint64x2_t",
 	t.IDX86M128I:     "__m128i",
 	t.IDX86M256I:     "__m256i",
+	t.IDX86M512I:     "__m512i",
 }
 
 const noSuchCOperator = " no_such_C_operator "
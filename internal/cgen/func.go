@@ -626,7 +626,7 @@ func (g *gen) writeFuncImplArgChecks(b *buffer, n *a.Func) error {
 	}
 	b.writes(") {\n")
 	b.writes("self->private_impl.magic = WUFFS_BASE__DISABLED;\n")
-	if g.currFunk.astFunc.Effect().Coroutine() {
+	if out := n.Out(); g.currFunk.astFunc.Effect().Coroutine() || ((out != nil) && out.IsStatus()) {
 		b.writes("return wuffs_base__make_status(wuffs_base__error__bad_argument);\n")
 	} else {
 		// TODO: don't assume that the return type is empty.
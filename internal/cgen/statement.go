@@ -85,7 +85,7 @@ func (g *gen) writeStatementAssign(b *buffer, op t.ID, lhs *a.Expr, rhs *a.Expr,
 	depth++
 
 	needWriteLoadExprDerivedVars := false
-	if (len(g.currFunk.derivedVars) > 0) &&
+	if (g.currFunk.derivedVars != nil) &&
 		(rhs.Operator() == a.ExprOperatorCall) {
 		method := rhs.LHS().AsExpr()
 		recvTyp := method.LHS().MType().Pointee()
@@ -287,6 +287,10 @@ func cpuArchCNames(asserts []*a.Node) (caMacro string, caName string, caAttribut
 				caMacro, caName, caAttribute =
 					"X86_64", "x86_bmi2",
 					"WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"bmi2\")"
+			case t.IDX86AVX512:
+				caMacro, caName, caAttribute =
+					"X86_64", "x86_avx512",
+					"WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET(\"pclmul,popcnt,sse4.2,avx2,avx512f,avx512bw,avx512vl,vpclmulqdq\")"
 			}
 		}
 	}
@@ -89,6 +89,28 @@ func (g *gen) findDerivedVars() {
 		}
 		g.currFunk.derivedVars[o.Name()] = struct{}{}
 	}
+
+	// An io_bind'ed local variable also has derived variables, even if none
+	// of the function's arguments do. They need to be saved before (and
+	// loaded after) passing that variable to another function.
+	if g.currFunk.derivedVars == nil && g.hasIOBind() {
+		g.currFunk.derivedVars = map[t.ID]struct{}{}
+	}
+}
+
+func (g *gen) hasIOBind() bool {
+	for _, o := range g.currFunk.astFunc.Body() {
+		err := o.Walk(func(p *a.Node) error {
+			if p.Kind() == a.KIOBind {
+				return errNeedDerivedVar
+			}
+			return nil
+		})
+		if err == errNeedDerivedVar {
+			return true
+		}
+	}
+	return false
 }
 
 func (g *gen) derivedVarCNames(typ *a.TypeExpr) (elem string, i1 string, i2 string, isWriter bool, retErr error) {
@@ -34,7 +34,9 @@ var FourCCs = [...][2]string{
 	{"CBOR", "Concise Binary Object Representation"},
 	{"CSS ", "Cascading Style Sheets"},
 	{"EPS ", "Encapsulated PostScript"},
+	{"EXIF", "Exchangeable Image File Format"},
 	{"FLAC", "Free Lossless Audio Codec"},
+	{"GAMA", "Gamma Correction"},
 	{"GIF ", "Graphics Interchange Format"},
 	{"GZ  ", "GNU Zip"},
 	{"HEIF", "High Efficiency Image File"},
@@ -47,6 +49,7 @@ var FourCCs = [...][2]string{
 	{"JS  ", "JavaScript"},
 	{"JSON", "JavaScript Object Notation"},
 	{"JWCC", "JSON With Commas and Comments"},
+	{"KVP ", "Key-Value Pair"},
 	{"LZ4 ", "Lempel–Ziv 4"},
 	{"MD  ", "Markdown"},
 	{"MP3 ", "MPEG-1 Audio Layer III"},
@@ -309,6 +312,9 @@ var Types = []string{
 
 	"x86_avx2_utility",
 	"x86_m256i",
+
+	"x86_avx512_utility",
+	"x86_m512i",
 }
 
 var Funcs = [][]string{
@@ -349,6 +355,7 @@ var funcsOther = [...]string{
 	"utility.empty_rect_ii_u32() rect_ii_u32",
 	"utility.empty_rect_ie_u32() rect_ie_u32",
 	"utility.empty_slice_u8() slice u8",
+	"utility.make_pixel_blend(repr: u8[..= 1]) pixel_blend",
 	"utility.make_pixel_format(repr: u32) pixel_format",
 	"utility.make_range_ii_u32(min_incl: u32, max_incl: u32) range_ii_u32",
 	"utility.make_range_ie_u32(min_incl: u32, max_excl: u32) range_ie_u32",
@@ -559,6 +566,11 @@ var funcsOther = [...]string{
 	// For now, that's all implicitly checked (i.e. hard coded).
 	"io_writer.limited_copy_u32_from_history_8_byte_chunks_distance_1_fast!(up_to: u32, distance: u32) u32",
 
+	// limited_write_u64le_fast writes all 8 bytes of a but only advances by
+	// up_to bytes. Like write_u64le_fast, it has an implicit pre-condition
+	// "length() >= 8".
+	"io_writer.limited_write_u64le_fast!(up_to: u32[..= 8], a: u64) u32",
+
 	// ---- token_writer
 
 	"token_writer.write_simple_token_fast!(" +
@@ -570,6 +582,14 @@ var funcsOther = [...]string{
 
 	"token_writer.length() u64",
 
+	// ---- decode_frame_options
+
+	"decode_frame_options.downscale_shift() u32",
+	"decode_frame_options.roi_max_excl_x() u32",
+	"decode_frame_options.roi_max_excl_y() u32",
+	"decode_frame_options.roi_min_incl_x() u32",
+	"decode_frame_options.roi_min_incl_y() u32",
+
 	// ---- frame_config
 
 	"frame_config.blend() u8",
@@ -603,6 +623,9 @@ var funcsOther = [...]string{
 	"pixel_swizzler.prepare!(" +
 		"dst_pixfmt: pixel_format, dst_palette: slice u8," +
 		"src_pixfmt: pixel_format, src_palette: slice u8, blend: pixel_blend) status",
+	"pixel_swizzler.prepare_downscaled!(" +
+		"dst_pixfmt: pixel_format, dst_palette: slice u8," +
+		"src_pixfmt: pixel_format, src_palette: slice u8, blend: pixel_blend) status",
 
 	"pixel_swizzler.limited_swizzle_u32_interleaved_from_reader!(" +
 		"up_to_num_pixels: u32, dst: slice u8, dst_palette: slice u8, src: io_reader) u64",
@@ -610,6 +633,9 @@ var funcsOther = [...]string{
 		"dst: slice u8, dst_palette: slice u8, src: io_reader) u64",
 	"pixel_swizzler.swizzle_interleaved_from_slice!(" +
 		"dst: slice u8, dst_palette: slice u8, src: slice u8) u64",
+	"pixel_swizzler.swizzle_downscaled_from_slice!(" +
+		"dst: table u8, dst_palette: slice u8, accum: slice u8, src: slice u8," +
+		"shift: u32, x: u32, y: u32, y0: u32, y1: u32) u64",
 	"pixel_swizzler.swizzle_interleaved_transparent_black!(" +
 		"dst: slice u8, dst_palette: slice u8, num_pixels: u64) u64",
 
@@ -708,6 +734,13 @@ var funcsOther = [...]string{
 
 	"x86_sse42_utility.make_m128i_zeroes() x86_m128i",
 
+	// The _mm_crc32_uNN methods compute the CRC-32C (Castagnoli), not the
+	// CRC-32 (IEEE) checksum. The a arg is the (not bit-flipped) CRC state.
+	"x86_sse42_utility._mm_crc32_u8(a: u32, b: u8) u32",
+	"x86_sse42_utility._mm_crc32_u16(a: u32, b: u16) u32",
+	"x86_sse42_utility._mm_crc32_u32(a: u32, b: u32) u32",
+	"x86_sse42_utility._mm_crc32_u64(a: u32, b: u64) u32",
+
 	// ---- x86_m128i
 
 	"x86_m128i.store_slice64!(a: slice base.u8)",
@@ -751,6 +784,7 @@ var funcsOther = [...]string{
 	"x86_m128i._mm_min_epu16(b: x86_m128i) x86_m128i",
 	"x86_m128i._mm_min_epu32(b: x86_m128i) x86_m128i",
 	"x86_m128i._mm_min_epu8(b: x86_m128i) x86_m128i",
+	"x86_m128i._mm_movemask_epi8() u32",
 	"x86_m128i._mm_packus_epi16(b: x86_m128i) x86_m128i",
 	"x86_m128i._mm_sad_epu8(b: x86_m128i) x86_m128i",
 	"x86_m128i._mm_shuffle_epi32(imm8: u32) x86_m128i",
@@ -828,6 +862,24 @@ var funcsOther = [...]string{
 	"x86_m256i._mm256_srli_epi32(imm8: u32) x86_m256i",
 	"x86_m256i._mm256_srli_epi64(imm8: u32) x86_m256i",
 	"x86_m256i._mm256_srli_si256(imm8: u32) x86_m256i",
+
+	// ---- x86_avx512_utility
+
+	"x86_avx512_utility.make_m512i_single_u32(a: u32) x86_m512i",
+
+	"x86_avx512_utility.make_m512i_slice512(a: slice base.u8) x86_m512i",
+
+	"x86_avx512_utility.make_m512i_zeroes() x86_m512i",
+
+	// ---- x86_m512i
+
+	// TODO: generate these methods automatically?
+
+	"x86_m512i._mm512_clmulepi64_epi128(b: x86_m512i, imm8: u32) x86_m512i",
+	"x86_m512i._mm512_extracti32x4_epi32(imm8: u32) x86_m128i",
+	"x86_m512i._mm512_maskz_extracti32x4_epi32(k: u8, imm8: u32) x86_m128i",
+	"x86_m512i._mm512_ternarylogic_epi64(b: x86_m512i, c: x86_m512i, imm8: u32) x86_m512i",
+	"x86_m512i._mm512_xor_si512(b: x86_m512i) x86_m512i",
 }
 
 var Interfaces = []string{
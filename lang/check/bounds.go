@@ -1175,6 +1175,11 @@ func (q *checker) bcheckExprCallSpecialCases(n *a.Expr, depth uint32) (bounds, e
 				return bounds{}, err
 			}
 
+		} else if method == t.IDLimitedWriteU64LEFast {
+			// This writes 8 bytes but advances by at most 8 bytes, so it is
+			// conservative to treat it like write_u64le_fast.
+			advance, update = eight, true
+
 		} else if method == t.IDSkipU32Fast {
 			args := n.Args()
 			if len(args) != 2 {
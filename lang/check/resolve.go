@@ -94,6 +94,9 @@ var (
 	typeExprX86AVX2Utility = a.NewTypeExpr(0, t.IDBase, t.IDX86AVX2Utility, nil, nil, nil)
 	typeExprX86M256I       = a.NewTypeExpr(0, t.IDBase, t.IDX86M256I, nil, nil, nil)
 
+	typeExprX86AVX512Utility = a.NewTypeExpr(0, t.IDBase, t.IDX86AVX512Utility, nil, nil, nil)
+	typeExprX86M512I         = a.NewTypeExpr(0, t.IDBase, t.IDX86M512I, nil, nil, nil)
+
 	typeExprSliceU8 = a.NewTypeExpr(t.IDSlice, 0, 0, nil, nil, typeExprU8)
 	typeExprTableU8 = a.NewTypeExpr(t.IDTable, 0, 0, nil, nil, typeExprU8)
 )
@@ -160,6 +163,9 @@ var builtInTypeMap = typeMap{
 
 	t.IDX86AVX2Utility: typeExprX86AVX2Utility,
 	t.IDX86M256I:       typeExprX86M256I,
+
+	t.IDX86AVX512Utility: typeExprX86AVX512Utility,
+	t.IDX86M512I:         typeExprX86M512I,
 }
 
 func (c *Checker) parseBuiltInFuncs(m map[t.QQID]*a.Func, ss []string) error {
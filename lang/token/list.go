@@ -140,7 +140,8 @@ func (x ID) IsEtcUtility() bool {
 		case IDARMCRC32Utility,
 			IDARMNeonUtility,
 			IDX86SSE42Utility,
-			IDX86AVX2Utility:
+			IDX86AVX2Utility,
+			IDX86AVX512Utility:
 			return true
 		}
 	}
@@ -512,6 +513,7 @@ const (
 	IDLimitedCopyU32FromReader                          = ID(0x175)
 	IDLimitedCopyU32FromSlice                           = ID(0x176)
 	IDLimitedCopyU32ToSlice                             = ID(0x177)
+	IDLimitedWriteU64LEFast                             = ID(0x178)
 
 	// -------- 0x180 block.
 
@@ -706,14 +708,17 @@ const (
 	IDARMNeonU32x4 = ID(0x322)
 	IDARMNeonU64x2 = ID(0x323)
 
-	IDX86SSE42        = ID(0x390)
-	IDX86SSE42Utility = ID(0x391)
-	IDX86AVX2         = ID(0x392)
-	IDX86AVX2Utility  = ID(0x393)
-	IDX86BMI2         = ID(0x394)
+	IDX86SSE42         = ID(0x390)
+	IDX86SSE42Utility  = ID(0x391)
+	IDX86AVX2          = ID(0x392)
+	IDX86AVX2Utility   = ID(0x393)
+	IDX86BMI2          = ID(0x394)
+	IDX86AVX512        = ID(0x395)
+	IDX86AVX512Utility = ID(0x396)
 
 	IDX86M128I = ID(0x3A0)
 	IDX86M256I = ID(0x3A1)
+	IDX86M512I = ID(0x3A2)
 )
 
 var builtInsByID = [nBuiltInIDs]string{
@@ -939,6 +944,7 @@ var builtInsByID = [nBuiltInIDs]string{
 	IDLimitedCopyU32FromReader:                          "limited_copy_u32_from_reader",
 	IDLimitedCopyU32FromSlice:                           "limited_copy_u32_from_slice",
 	IDLimitedCopyU32ToSlice:                             "limited_copy_u32_to_slice",
+	IDLimitedWriteU64LEFast:                             "limited_write_u64le_fast",
 
 	// -------- 0x180 block.
 
@@ -1120,14 +1126,17 @@ var builtInsByID = [nBuiltInIDs]string{
 	IDARMNeonU32x4: "arm_neon_u32x4",
 	IDARMNeonU64x2: "arm_neon_u64x2",
 
-	IDX86SSE42:        "x86_sse42",
-	IDX86SSE42Utility: "x86_sse42_utility",
-	IDX86AVX2:         "x86_avx2",
-	IDX86AVX2Utility:  "x86_avx2_utility",
-	IDX86BMI2:         "x86_bmi2",
+	IDX86SSE42:         "x86_sse42",
+	IDX86SSE42Utility:  "x86_sse42_utility",
+	IDX86AVX2:          "x86_avx2",
+	IDX86AVX2Utility:   "x86_avx2_utility",
+	IDX86BMI2:          "x86_bmi2",
+	IDX86AVX512:        "x86_avx512",
+	IDX86AVX512Utility: "x86_avx512_utility",
 
 	IDX86M128I: "x86_m128i",
 	IDX86M256I: "x86_m256i",
+	IDX86M512I: "x86_m512i",
 }
 
 var builtInsByName = map[string]ID{}
@@ -129,6 +129,10 @@ extern "C" {
 // POPCNT. This is checked at runtime via cpuid, not at compile time.
 //
 // Likewise, "cpu_arch >= x86_avx2" also requires PCLMUL, POPCNT and SSE4.2.
+//
+// And "cpu_arch >= x86_avx512" requires AVX-512F, AVX-512BW, AVX-512VL and
+// VPCLMULQDQ (Ice Lake, Zen 4 or later), as well as everything that
+// "cpu_arch >= x86_avx2" requires.
 #if defined(__x86_64__) && !defined(__native_client__)
 #include <cpuid.h>
 #include <x86intrin.h>
@@ -247,6 +251,71 @@ wuffs_base__cpu_arch__have_x86_avx2() {
   return false;
 }
 
+static inline bool  //
+wuffs_base__cpu_arch__have_x86_avx512() {
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+  // GCC defines these macros but MSVC does not.
+  //  - bit_AVX2     = (1 <<  5)
+  //  - bit_AVX512F  = (1 << 16)
+  //  - bit_AVX512BW = (1 << 30)
+  //  - bit_AVX512VL = (1 << 31)
+  const unsigned int avx512_ebx7 = 0xC0010020;
+  // GCC defines these macros but MSVC does not.
+  //  - bit_VPCLMULQDQ = (1 << 10)
+  const unsigned int avx512_ecx7 = 0x00000400;
+  // GCC defines these macros but MSVC does not.
+  //  - bit_PCLMUL  = (1 <<  1)
+  //  - bit_POPCNT  = (1 << 23)
+  //  - bit_SSE4_2  = (1 << 20)
+  //  - bit_OSXSAVE = (1 << 27)
+  const unsigned int avx512_ecx1 = 0x08900002;
+  // The OS must also save and restore the AVX-512 register state: XCR0 bits 1
+  // (SSE), 2 (AVX), 5 (opmask), 6 (ZMM_Hi256) and 7 (Hi16_ZMM).
+  const unsigned int avx512_xcr0 = 0x000000E6;
+
+  // clang defines __GNUC__ and clang-cl defines _MSC_VER (but not __GNUC__).
+#if defined(__GNUC__)
+  unsigned int eax7 = 0;
+  unsigned int ebx7 = 0;
+  unsigned int ecx7 = 0;
+  unsigned int edx7 = 0;
+  if (__get_cpuid_count(7, 0, &eax7, &ebx7, &ecx7, &edx7) &&
+      ((ebx7 & avx512_ebx7) == avx512_ebx7) &&
+      ((ecx7 & avx512_ecx7) == avx512_ecx7)) {
+    unsigned int eax1 = 0;
+    unsigned int ebx1 = 0;
+    unsigned int ecx1 = 0;
+    unsigned int edx1 = 0;
+    if (__get_cpuid(1, &eax1, &ebx1, &ecx1, &edx1) &&
+        ((ecx1 & avx512_ecx1) == avx512_ecx1)) {
+      // Use inline assembly, as the _xgetbv intrinsic needs "-mxsave".
+      unsigned int xcr0_lo = 0;
+      unsigned int xcr0_hi = 0;
+      __asm__ __volatile__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+      if ((xcr0_lo & avx512_xcr0) == avx512_xcr0) {
+        return true;
+      }
+    }
+  }
+#elif defined(_MSC_VER)  // defined(__GNUC__)
+  int x7[4];
+  __cpuidex(x7, 7, 0);
+  if (((((unsigned int)(x7[1])) & avx512_ebx7) == avx512_ebx7) &&
+      ((((unsigned int)(x7[2])) & avx512_ecx7) == avx512_ecx7)) {
+    int x1[4];
+    __cpuid(x1, 1);
+    if (((((unsigned int)(x1[2])) & avx512_ecx1) == avx512_ecx1) &&
+        ((((unsigned int)(_xgetbv(0))) & avx512_xcr0) == avx512_xcr0)) {
+      return true;
+    }
+  }
+#else
+#error "WUFFS_BASE__CPU_ARCH__ETC combined with an unsupported compiler"
+#endif  // defined(__GNUC__); defined(_MSC_VER)
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+  return false;
+}
+
 static inline bool  //
 wuffs_base__cpu_arch__have_x86_bmi2() {
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
@@ -569,9 +638,15 @@ typedef struct wuffs_base__transform__output__struct {
 // Encapsulated PostScript.
 #define WUFFS_BASE__FOURCC__EPS 0x45505320
 
+// Exchangeable Image File Format.
+#define WUFFS_BASE__FOURCC__EXIF 0x45584946
+
 // Free Lossless Audio Codec.
 #define WUFFS_BASE__FOURCC__FLAC 0x464C4143
 
+// Gamma Correction.
+#define WUFFS_BASE__FOURCC__GAMA 0x47414D41
+
 // Graphics Interchange Format.
 #define WUFFS_BASE__FOURCC__GIF 0x47494620
 
@@ -608,6 +683,9 @@ typedef struct wuffs_base__transform__output__struct {
 // JSON With Commas and Comments.
 #define WUFFS_BASE__FOURCC__JWCC 0x4A574343
 
+// Key-Value Pair.
+#define WUFFS_BASE__FOURCC__KVP 0x4B565020
+
 // Lempel–Ziv 4.
 #define WUFFS_BASE__FOURCC__LZ4 0x4C5A3420
 
@@ -2427,6 +2505,11 @@ wuffs_base__rect_ie_u32::height() const {
 // The flavor field follows the base38 namespace
 // convention](/doc/note/base38-and-fourcc.md). The other fields' semantics
 // depends on the flavor.
+//
+// For the METADATA flavor, w is the metadata's FourCC and [y, z) is the
+// io_position range of its bytes. A non-zero x is the FourCC of an encoding,
+// such as WUFFS_BASE__FOURCC__ZLIB, that the caller has to undo to get the
+// metadata itself. A zero x means that the bytes are the metadata as is.
 typedef struct wuffs_base__more_information__struct {
   uint32_t flavor;
   uint32_t w;
@@ -4528,6 +4611,12 @@ typedef struct wuffs_base__pixel_buffer__struct {
   inline wuffs_base__status set_color_u32_fill_rect(
       wuffs_base__rect_ie_u32 rect,
       wuffs_base__color_u32_argb_premul color);
+  inline wuffs_base__status composite(
+      const struct wuffs_base__pixel_buffer__struct* src,
+      uint32_t dst_x,
+      uint32_t dst_y,
+      wuffs_base__rect_ie_u32 clip,
+      wuffs_base__pixel_blend blend);
 #endif  // __cplusplus
 
 } wuffs_base__pixel_buffer;
@@ -4774,6 +4863,27 @@ wuffs_base__pixel_buffer__set_color_u32_fill_rect(
     wuffs_base__rect_ie_u32 rect,
     wuffs_base__color_u32_argb_premul color);
 
+// wuffs_base__pixel_buffer__composite draws src onto pb, converting pixel
+// formats as necessary, with src's top-left pixel at (dst_x, dst_y). Only
+// those pb pixels inside both clip and pb's bounds are modified, so that a
+// src that extends past pb's edges is not an error. The two pixel buffers'
+// memory must not overlap.
+//
+// The blend is typically WUFFS_BASE__PIXEL_BLEND__SRC, for replacing pixels
+// (as GIF frame disposal does), or WUFFS_BASE__PIXEL_BLEND__SRC_OVER, for
+// compositing a partially transparent frame over the previous one.
+//
+// For modular builds that divide the base module into sub-modules, using this
+// function requires the WUFFS_CONFIG__MODULE__BASE__PIXCONV sub-module, not
+// just WUFFS_CONFIG__MODULE__BASE__CORE.
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status  //
+wuffs_base__pixel_buffer__composite(wuffs_base__pixel_buffer* pb,
+                                    const wuffs_base__pixel_buffer* src,
+                                    uint32_t dst_x,
+                                    uint32_t dst_y,
+                                    wuffs_base__rect_ie_u32 clip,
+                                    wuffs_base__pixel_blend blend);
+
 #ifdef __cplusplus
 
 inline wuffs_base__status  //
@@ -4847,6 +4957,16 @@ wuffs_base__pixel_buffer::set_color_u32_fill_rect(
   return wuffs_base__pixel_buffer__set_color_u32_fill_rect(this, rect, color);
 }
 
+inline wuffs_base__status  //
+wuffs_base__pixel_buffer::composite(const wuffs_base__pixel_buffer* src,
+                                    uint32_t dst_x,
+                                    uint32_t dst_y,
+                                    wuffs_base__rect_ie_u32 clip,
+                                    wuffs_base__pixel_blend blend) {
+  return wuffs_base__pixel_buffer__composite(this, src, dst_x, dst_y, clip,
+                                             blend);
+}
+
 #endif  // __cplusplus
 
 // --------
@@ -4855,16 +4975,157 @@ typedef struct wuffs_base__decode_frame_options__struct {
   // Do not access the private_impl's fields directly. There is no API/ABI
   // compatibility or safety guarantee if you do so.
   struct {
-    uint8_t TODO;
+    bool has_roi;
+    wuffs_base__rect_ie_u32 roi;
+    uint32_t downscale_shift;
   } private_impl;
 
 #ifdef __cplusplus
+  inline void set_downscale_shift(uint32_t shift);
+  inline uint32_t downscale_shift() const;
+  inline void set_roi(wuffs_base__rect_ie_u32 roi);
+  inline wuffs_base__rect_ie_u32 roi() const;
+  inline uint32_t roi_min_incl_x() const;
+  inline uint32_t roi_min_incl_y() const;
+  inline uint32_t roi_max_excl_x() const;
+  inline uint32_t roi_max_excl_y() const;
 #endif  // __cplusplus
 
 } wuffs_base__decode_frame_options;
 
+// wuffs_base__decode_frame_options__set_downscale_shift asks for the frame to
+// be decoded at a reduced size: 1/2, 1/4 or 1/8 (in each dimension) for a
+// shift of 1, 2 or 3. The destination pixel buffer then only needs to be
+// ((w + (1 << shift) - 1) >> shift) by ((h + (1 << shift) - 1) >> shift)
+// pixels, for a w by h image. Each destination pixel is the average (a box
+// filter, in premultiplied alpha space) of the corresponding (1 << shift) by
+// (1 << shift) block of source pixels, except that for interlaced images,
+// decoders may stop after an early interlacing pass and sample one source
+// pixel per block instead. The frame's dirty rect is also in that reduced
+// coordinate space.
+//
+// Decoders that support this may need a longer work buffer, for the running
+// sums, than their workbuf_len's min_incl. Passing a work buffer of max_incl
+// length is always enough. Decoders that do not support this ignore it, so
+// callers should check for support (e.g. wuffs_aux::DecodeImage does that per
+// image format) before relying on it.
+//
+// A zero-valued wuffs_base__decode_frame_options has a shift of zero: no
+// downscaling. Shifts above 3 are unsupported.
+static inline void  //
+wuffs_base__decode_frame_options__set_downscale_shift(
+    wuffs_base__decode_frame_options* o,
+    uint32_t shift) {
+  if (o) {
+    o->private_impl.downscale_shift = shift;
+  }
+}
+
+static inline uint32_t  //
+wuffs_base__decode_frame_options__downscale_shift(
+    const wuffs_base__decode_frame_options* o) {
+  return o ? o->private_impl.downscale_shift : 0;
+}
+
+// wuffs_base__decode_frame_options__set_roi sets the region of interest: the
+// part of the frame that the caller wants decoded. A decoder may then skip
+// writing (and possibly stop decoding) pixels outside of that rectangle, and
+// those pixels in the destination pixel buffer are left as they were. The ROI
+// is in the image's coordinate space (the same space as the frame config's
+// bounds). Some decoders, or some images (e.g. interlaced ones), still have to
+// decompress all of the frame's pixel data but can skip the swizzling for
+// pixels outside of the ROI.
+//
+// A zero-valued wuffs_base__decode_frame_options has no ROI, which is
+// equivalent to an unbounded ROI: the whole frame is decoded.
+static inline void  //
+wuffs_base__decode_frame_options__set_roi(wuffs_base__decode_frame_options* o,
+                                          wuffs_base__rect_ie_u32 roi) {
+  if (o) {
+    o->private_impl.has_roi = true;
+    o->private_impl.roi = roi;
+  }
+}
+
+// wuffs_base__decode_frame_options__roi returns the region of interest, or the
+// maximal (0, 0, 0xFFFFFFFF, 0xFFFFFFFF) rectangle if there is no ROI.
+static inline wuffs_base__rect_ie_u32  //
+wuffs_base__decode_frame_options__roi(
+    const wuffs_base__decode_frame_options* o) {
+  if (o && o->private_impl.has_roi) {
+    return o->private_impl.roi;
+  }
+  return wuffs_base__make_rect_ie_u32(0, 0, UINT32_MAX, UINT32_MAX);
+}
+
+static inline uint32_t  //
+wuffs_base__decode_frame_options__roi_min_incl_x(
+    const wuffs_base__decode_frame_options* o) {
+  return (o && o->private_impl.has_roi) ? o->private_impl.roi.min_incl_x : 0;
+}
+
+static inline uint32_t  //
+wuffs_base__decode_frame_options__roi_min_incl_y(
+    const wuffs_base__decode_frame_options* o) {
+  return (o && o->private_impl.has_roi) ? o->private_impl.roi.min_incl_y : 0;
+}
+
+static inline uint32_t  //
+wuffs_base__decode_frame_options__roi_max_excl_x(
+    const wuffs_base__decode_frame_options* o) {
+  return (o && o->private_impl.has_roi) ? o->private_impl.roi.max_excl_x
+                                        : UINT32_MAX;
+}
+
+static inline uint32_t  //
+wuffs_base__decode_frame_options__roi_max_excl_y(
+    const wuffs_base__decode_frame_options* o) {
+  return (o && o->private_impl.has_roi) ? o->private_impl.roi.max_excl_y
+                                        : UINT32_MAX;
+}
+
 #ifdef __cplusplus
 
+inline void  //
+wuffs_base__decode_frame_options::set_downscale_shift(uint32_t shift) {
+  wuffs_base__decode_frame_options__set_downscale_shift(this, shift);
+}
+
+inline uint32_t  //
+wuffs_base__decode_frame_options::downscale_shift() const {
+  return wuffs_base__decode_frame_options__downscale_shift(this);
+}
+
+inline void  //
+wuffs_base__decode_frame_options::set_roi(wuffs_base__rect_ie_u32 roi) {
+  wuffs_base__decode_frame_options__set_roi(this, roi);
+}
+
+inline wuffs_base__rect_ie_u32  //
+wuffs_base__decode_frame_options::roi() const {
+  return wuffs_base__decode_frame_options__roi(this);
+}
+
+inline uint32_t  //
+wuffs_base__decode_frame_options::roi_min_incl_x() const {
+  return wuffs_base__decode_frame_options__roi_min_incl_x(this);
+}
+
+inline uint32_t  //
+wuffs_base__decode_frame_options::roi_min_incl_y() const {
+  return wuffs_base__decode_frame_options__roi_min_incl_y(this);
+}
+
+inline uint32_t  //
+wuffs_base__decode_frame_options::roi_max_excl_x() const {
+  return wuffs_base__decode_frame_options__roi_max_excl_x(this);
+}
+
+inline uint32_t  //
+wuffs_base__decode_frame_options::roi_max_excl_y() const {
+  return wuffs_base__decode_frame_options__roi_max_excl_y(this);
+}
+
 #endif  // __cplusplus
 
 // --------
@@ -4910,6 +5171,9 @@ typedef struct wuffs_base__pixel_swizzler__struct {
     wuffs_base__pixel_swizzler__transparent_black_func transparent_black_func;
     uint32_t dst_pixfmt_bytes_per_pixel;
     uint32_t src_pixfmt_bytes_per_pixel;
+    // downscale_func, if non-NULL, converts from BGRA_PREMUL to the dst pixel
+    // format, and func converts from the src pixel format to BGRA_PREMUL.
+    wuffs_base__pixel_swizzler__func downscale_func;
   } private_impl;
 
 #ifdef __cplusplus
@@ -4922,6 +5186,22 @@ typedef struct wuffs_base__pixel_swizzler__struct {
       wuffs_base__slice_u8 dst,
       wuffs_base__slice_u8 dst_palette,
       wuffs_base__slice_u8 src) const;
+  inline wuffs_base__status prepare_downscaled(
+      wuffs_base__pixel_format dst_pixfmt,
+      wuffs_base__slice_u8 dst_palette,
+      wuffs_base__pixel_format src_pixfmt,
+      wuffs_base__slice_u8 src_palette,
+      wuffs_base__pixel_blend blend);
+  inline uint64_t swizzle_downscaled_from_slice(
+      wuffs_base__table_u8 dst,
+      wuffs_base__slice_u8 dst_palette,
+      wuffs_base__slice_u8 accum,
+      wuffs_base__slice_u8 src,
+      uint32_t shift,
+      uint32_t x,
+      uint32_t y,
+      uint32_t y0,
+      uint32_t y1) const;
 #endif  // __cplusplus
 
 } wuffs_base__pixel_swizzler;
@@ -4953,6 +5233,59 @@ wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(
     wuffs_base__slice_u8 dst_palette,
     wuffs_base__slice_u8 src);
 
+// wuffs_base__pixel_swizzler__prepare_downscaled is like
+// wuffs_base__pixel_swizzler__prepare but readies the pixel swizzler for
+// wuffs_base__pixel_swizzler__swizzle_downscaled_from_slice instead of its
+// other methods. The dst_palette is used as scratch space (for the src
+// palette converted to premultiplied alpha) and so must be 1024 bytes long
+// if the src pixel format is indexed, even if the dst pixel format is not.
+//
+// For modular builds that divide the base module into sub-modules, using this
+// function requires the WUFFS_CONFIG__MODULE__BASE__PIXCONV sub-module, not
+// just WUFFS_CONFIG__MODULE__BASE__CORE.
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status  //
+wuffs_base__pixel_swizzler__prepare_downscaled(
+    wuffs_base__pixel_swizzler* p,
+    wuffs_base__pixel_format dst_pixfmt,
+    wuffs_base__slice_u8 dst_palette,
+    wuffs_base__pixel_format src_pixfmt,
+    wuffs_base__slice_u8 src_palette,
+    wuffs_base__pixel_blend blend);
+
+// wuffs_base__pixel_swizzler__swizzle_downscaled_from_slice adds one row of
+// source pixels to a running sum and, after the last source row for a
+// destination row, writes that destination row. It returns the number of
+// source pixels consumed: zero if any argument is invalid.
+//
+// The src holds whole pixels of source row y, from source column x onwards.
+// The dst is the whole (downscaled) destination plane: source pixel (x, y)
+// maps to destination pixel (x >> shift, y >> shift). Each destination pixel
+// is the premultiplied alpha average of its source pixels that are within
+// rows y0 (inclusive) to y1 (exclusive). Passing (y, y+1) for (y0, y1) means
+// that only row y is sampled for its destination row. The shift must be at
+// most 3.
+//
+// Calls for the same destination row have to pass source rows in increasing
+// order, each in a single call and with the same x and src length. The accum
+// slice holds the running sums between those calls and must be at least
+// (8 * ((n >> shift) + 2)) bytes long, for n source pixels.
+//
+// For modular builds that divide the base module into sub-modules, using this
+// function requires the WUFFS_CONFIG__MODULE__BASE__PIXCONV sub-module, not
+// just WUFFS_CONFIG__MODULE__BASE__CORE.
+WUFFS_BASE__MAYBE_STATIC uint64_t  //
+wuffs_base__pixel_swizzler__swizzle_downscaled_from_slice(
+    const wuffs_base__pixel_swizzler* p,
+    wuffs_base__table_u8 dst,
+    wuffs_base__slice_u8 dst_palette,
+    wuffs_base__slice_u8 accum,
+    wuffs_base__slice_u8 src,
+    uint32_t shift,
+    uint32_t x,
+    uint32_t y,
+    uint32_t y0,
+    uint32_t y1);
+
 #ifdef __cplusplus
 
 inline wuffs_base__status  //
@@ -4974,6 +5307,32 @@ wuffs_base__pixel_swizzler::swizzle_interleaved_from_slice(
       this, dst, dst_palette, src);
 }
 
+inline wuffs_base__status  //
+wuffs_base__pixel_swizzler::prepare_downscaled(
+    wuffs_base__pixel_format dst_pixfmt,
+    wuffs_base__slice_u8 dst_palette,
+    wuffs_base__pixel_format src_pixfmt,
+    wuffs_base__slice_u8 src_palette,
+    wuffs_base__pixel_blend blend) {
+  return wuffs_base__pixel_swizzler__prepare_downscaled(
+      this, dst_pixfmt, dst_palette, src_pixfmt, src_palette, blend);
+}
+
+inline uint64_t  //
+wuffs_base__pixel_swizzler::swizzle_downscaled_from_slice(
+    wuffs_base__table_u8 dst,
+    wuffs_base__slice_u8 dst_palette,
+    wuffs_base__slice_u8 accum,
+    wuffs_base__slice_u8 src,
+    uint32_t shift,
+    uint32_t x,
+    uint32_t y,
+    uint32_t y0,
+    uint32_t y1) const {
+  return wuffs_base__pixel_swizzler__swizzle_downscaled_from_slice(
+      this, dst, dst_palette, accum, src, shift, x, y, y0, y1);
+}
+
 #endif  // __cplusplus
 
 // ---------------- String Conversions
@@ -6107,6 +6466,13 @@ wuffs_adler32__hasher__update_u32(
     wuffs_adler32__hasher* self,
     wuffs_base__slice_u8 a_x);
 
+WUFFS_BASE__MAYBE_STATIC uint32_t
+wuffs_adler32__hasher__combine_u32(
+    const wuffs_adler32__hasher* self,
+    uint32_t a_adler_a,
+    uint32_t a_adler_b,
+    uint64_t a_length_b);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -6217,6 +6583,14 @@ struct wuffs_adler32__hasher__struct {
     return wuffs_adler32__hasher__update_u32(this, a_x);
   }
 
+  inline uint32_t
+  combine_u32(
+      uint32_t a_adler_a,
+      uint32_t a_adler_b,
+      uint64_t a_length_b) const {
+    return wuffs_adler32__hasher__combine_u32(this, a_adler_a, a_adler_b, a_length_b);
+  }
+
 #endif  // __cplusplus
 };  // struct wuffs_adler32__hasher__struct
 
@@ -6396,6 +6770,10 @@ struct wuffs_bmp__decoder__struct {
     uint32_t f_dst_x;
     uint32_t f_dst_y;
     uint32_t f_dst_y_inc;
+    uint32_t f_roi_x0;
+    uint32_t f_roi_y0;
+    uint32_t f_roi_x1;
+    uint32_t f_roi_y1;
     uint32_t f_pending_pad;
     uint32_t f_rle_state;
     uint32_t f_rle_length;
@@ -6418,6 +6796,7 @@ struct wuffs_bmp__decoder__struct {
     } s_decode_image_config[1];
     struct {
       wuffs_base__status v_status;
+      uint64_t v_bytes_per_row;
       uint64_t scratch;
     } s_decode_frame[1];
     struct {
@@ -6803,6 +7182,8 @@ struct wuffs_cbor__decoder__struct {
 
 // ---------------- Struct Declarations
 
+typedef struct wuffs_crc32__castagnoli_hasher__struct wuffs_crc32__castagnoli_hasher;
+
 typedef struct wuffs_crc32__ieee_hasher__struct wuffs_crc32__ieee_hasher;
 
 #ifdef __cplusplus
@@ -6817,6 +7198,16 @@ extern "C" {
 // Pass sizeof(*self) and WUFFS_VERSION for sizeof_star_self and wuffs_version.
 // Pass 0 (or some combination of WUFFS_INITIALIZE__XXX) for options.
 
+wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
+wuffs_crc32__castagnoli_hasher__initialize(
+    wuffs_crc32__castagnoli_hasher* self,
+    size_t sizeof_star_self,
+    uint64_t wuffs_version,
+    uint32_t options);
+
+size_t
+sizeof__wuffs_crc32__castagnoli_hasher();
+
 wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
 wuffs_crc32__ieee_hasher__initialize(
     wuffs_crc32__ieee_hasher* self,
@@ -6835,6 +7226,14 @@ sizeof__wuffs_crc32__ieee_hasher();
 // calling free on the returned pointer. That pointer is effectively a C++
 // std::unique_ptr<T, decltype(&free)>.
 
+wuffs_crc32__castagnoli_hasher*
+wuffs_crc32__castagnoli_hasher__alloc();
+
+static inline wuffs_base__hasher_u32*
+wuffs_crc32__castagnoli_hasher__alloc_as__wuffs_base__hasher_u32() {
+  return (wuffs_base__hasher_u32*)(wuffs_crc32__castagnoli_hasher__alloc());
+}
+
 wuffs_crc32__ieee_hasher*
 wuffs_crc32__ieee_hasher__alloc();
 
@@ -6845,6 +7244,12 @@ wuffs_crc32__ieee_hasher__alloc_as__wuffs_base__hasher_u32() {
 
 // ---------------- Upcasts
 
+static inline wuffs_base__hasher_u32*
+wuffs_crc32__castagnoli_hasher__upcast_as__wuffs_base__hasher_u32(
+    wuffs_crc32__castagnoli_hasher* p) {
+  return (wuffs_base__hasher_u32*)p;
+}
+
 static inline wuffs_base__hasher_u32*
 wuffs_crc32__ieee_hasher__upcast_as__wuffs_base__hasher_u32(
     wuffs_crc32__ieee_hasher* p) {
@@ -6853,6 +7258,17 @@ wuffs_crc32__ieee_hasher__upcast_as__wuffs_base__hasher_u32(
 
 // ---------------- Public Function Prototypes
 
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_crc32__castagnoli_hasher__set_quirk_enabled(
+    wuffs_crc32__castagnoli_hasher* self,
+    uint32_t a_quirk,
+    bool a_enabled);
+
+WUFFS_BASE__MAYBE_STATIC uint32_t
+wuffs_crc32__castagnoli_hasher__update_u32(
+    wuffs_crc32__castagnoli_hasher* self,
+    wuffs_base__slice_u8 a_x);
+
 WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
 wuffs_crc32__ieee_hasher__set_quirk_enabled(
     wuffs_crc32__ieee_hasher* self,
@@ -6864,6 +7280,13 @@ wuffs_crc32__ieee_hasher__update_u32(
     wuffs_crc32__ieee_hasher* self,
     wuffs_base__slice_u8 a_x);
 
+WUFFS_BASE__MAYBE_STATIC uint32_t
+wuffs_crc32__ieee_hasher__combine_u32(
+    const wuffs_crc32__ieee_hasher* self,
+    uint32_t a_crc_a,
+    uint32_t a_crc_b,
+    uint64_t a_length_b);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -6877,6 +7300,105 @@ wuffs_crc32__ieee_hasher__update_u32(
 
 #if defined(__cplusplus) || defined(WUFFS_IMPLEMENTATION)
 
+struct wuffs_crc32__castagnoli_hasher__struct {
+  // Do not access the private_impl's or private_data's fields directly. There
+  // is no API/ABI compatibility or safety guarantee if you do so. Instead, use
+  // the wuffs_foo__bar__baz functions.
+  //
+  // It is a struct, not a struct*, so that the outermost wuffs_foo__bar struct
+  // can be stack allocated when WUFFS_IMPLEMENTATION is defined.
+
+  struct {
+    uint32_t magic;
+    uint32_t active_coroutine;
+    wuffs_base__vtable vtable_for__wuffs_base__hasher_u32;
+    wuffs_base__vtable null_vtable;
+
+    uint32_t f_state;
+
+    wuffs_base__empty_struct (*choosy_up)(
+        wuffs_crc32__castagnoli_hasher* self,
+        wuffs_base__slice_u8 a_x);
+  } private_impl;
+
+#ifdef __cplusplus
+#if defined(WUFFS_BASE__HAVE_UNIQUE_PTR)
+  using unique_ptr = std::unique_ptr<wuffs_crc32__castagnoli_hasher, decltype(&free)>;
+
+  // On failure, the alloc_etc functions return nullptr. They don't throw.
+
+  static inline unique_ptr
+  alloc() {
+    return unique_ptr(wuffs_crc32__castagnoli_hasher__alloc(), &free);
+  }
+
+  static inline wuffs_base__hasher_u32::unique_ptr
+  alloc_as__wuffs_base__hasher_u32() {
+    return wuffs_base__hasher_u32::unique_ptr(
+        wuffs_crc32__castagnoli_hasher__alloc_as__wuffs_base__hasher_u32(), &free);
+  }
+#endif  // defined(WUFFS_BASE__HAVE_UNIQUE_PTR)
+
+#if defined(WUFFS_BASE__HAVE_EQ_DELETE) && !defined(WUFFS_IMPLEMENTATION)
+  // Disallow constructing or copying an object via standard C++ mechanisms,
+  // e.g. the "new" operator, as this struct is intentionally opaque. Its total
+  // size and field layout is not part of the public, stable, memory-safe API.
+  // Use malloc or memcpy and the sizeof__wuffs_foo__bar function instead, and
+  // call wuffs_foo__bar__baz methods (which all take a "this"-like pointer as
+  // their first argument) rather than tweaking bar.private_impl.qux fields.
+  //
+  // In C, we can just leave wuffs_foo__bar as an incomplete type (unless
+  // WUFFS_IMPLEMENTATION is #define'd). In C++, we define a complete type in
+  // order to provide convenience methods. These forward on "this", so that you
+  // can write "bar->baz(etc)" instead of "wuffs_foo__bar__baz(bar, etc)".
+  wuffs_crc32__castagnoli_hasher__struct() = delete;
+  wuffs_crc32__castagnoli_hasher__struct(const wuffs_crc32__castagnoli_hasher__struct&) = delete;
+  wuffs_crc32__castagnoli_hasher__struct& operator=(
+      const wuffs_crc32__castagnoli_hasher__struct&) = delete;
+#endif  // defined(WUFFS_BASE__HAVE_EQ_DELETE) && !defined(WUFFS_IMPLEMENTATION)
+
+#if !defined(WUFFS_IMPLEMENTATION)
+  // As above, the size of the struct is not part of the public API, and unless
+  // WUFFS_IMPLEMENTATION is #define'd, this struct type T should be heap
+  // allocated, not stack allocated. Its size is not intended to be known at
+  // compile time, but it is unfortunately divulged as a side effect of
+  // defining C++ convenience methods. Use "sizeof__T()", calling the function,
+  // instead of "sizeof T", invoking the operator. To make the two values
+  // different, so that passing the latter will be rejected by the initialize
+  // function, we add an arbitrary amount of dead weight.
+  uint8_t dead_weight[123000000];  // 123 MB.
+#endif  // !defined(WUFFS_IMPLEMENTATION)
+
+  inline wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
+  initialize(
+      size_t sizeof_star_self,
+      uint64_t wuffs_version,
+      uint32_t options) {
+    return wuffs_crc32__castagnoli_hasher__initialize(
+        this, sizeof_star_self, wuffs_version, options);
+  }
+
+  inline wuffs_base__hasher_u32*
+  upcast_as__wuffs_base__hasher_u32() {
+    return (wuffs_base__hasher_u32*)this;
+  }
+
+  inline wuffs_base__empty_struct
+  set_quirk_enabled(
+      uint32_t a_quirk,
+      bool a_enabled) {
+    return wuffs_crc32__castagnoli_hasher__set_quirk_enabled(this, a_quirk, a_enabled);
+  }
+
+  inline uint32_t
+  update_u32(
+      wuffs_base__slice_u8 a_x) {
+    return wuffs_crc32__castagnoli_hasher__update_u32(this, a_x);
+  }
+
+#endif  // __cplusplus
+};  // struct wuffs_crc32__castagnoli_hasher__struct
+
 struct wuffs_crc32__ieee_hasher__struct {
   // Do not access the private_impl's or private_data's fields directly. There
   // is no API/ABI compatibility or safety guarantee if you do so. Instead, use
@@ -6973,6 +7495,14 @@ struct wuffs_crc32__ieee_hasher__struct {
     return wuffs_crc32__ieee_hasher__update_u32(this, a_x);
   }
 
+  inline uint32_t
+  combine_u32(
+      uint32_t a_crc_a,
+      uint32_t a_crc_b,
+      uint64_t a_length_b) const {
+    return wuffs_crc32__ieee_hasher__combine_u32(this, a_crc_a, a_crc_b, a_length_b);
+  }
+
 #endif  // __cplusplus
 };  // struct wuffs_crc32__ieee_hasher__struct
 
@@ -6993,15 +7523,33 @@ extern const char wuffs_deflate__error__bad_literal_length_code_count[];
 extern const char wuffs_deflate__error__inconsistent_stored_block_length[];
 extern const char wuffs_deflate__error__missing_end_of_block_code[];
 extern const char wuffs_deflate__error__no_huffman_codes[];
+extern const char wuffs_deflate__suspension__block_boundary[];
+extern const char wuffs_deflate__suspension__ready_to_interleave[];
 
 // ---------------- Public Consts
 
 #define WUFFS_DEFLATE__DECODER_WORKBUF_LEN_MAX_INCL_WORST_CASE 1
 
+#define WUFFS_DEFLATE__QUIRK_SUSPEND_AT_BLOCK_BOUNDARIES 867177472
+
+#define WUFFS_DEFLATE__QUIRK_SUSPEND_FOR_INTERLEAVING 867177473
+
+#define WUFFS_DEFLATE__QUIRK_DST_HOLDS_HISTORY 867177474
+
+#define WUFFS_DEFLATE__ENCODER_WORKBUF_LEN_MAX_INCL_WORST_CASE 0
+
+#define WUFFS_DEFLATE__ENCODER_LEVEL_FAST 1
+
+#define WUFFS_DEFLATE__ENCODER_LEVEL_DEFAULT 6
+
+#define WUFFS_DEFLATE__ENCODER_LEVEL_HIGH 9
+
 // ---------------- Struct Declarations
 
 typedef struct wuffs_deflate__decoder__struct wuffs_deflate__decoder;
 
+typedef struct wuffs_deflate__encoder__struct wuffs_deflate__encoder;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -7024,6 +7572,16 @@ wuffs_deflate__decoder__initialize(
 size_t
 sizeof__wuffs_deflate__decoder();
 
+wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
+wuffs_deflate__encoder__initialize(
+    wuffs_deflate__encoder* self,
+    size_t sizeof_star_self,
+    uint64_t wuffs_version,
+    uint32_t options);
+
+size_t
+sizeof__wuffs_deflate__encoder();
+
 // ---------------- Allocs
 
 // These functions allocate and initialize Wuffs structs. They return NULL if
@@ -7040,6 +7598,14 @@ wuffs_deflate__decoder__alloc_as__wuffs_base__io_transformer() {
   return (wuffs_base__io_transformer*)(wuffs_deflate__decoder__alloc());
 }
 
+wuffs_deflate__encoder*
+wuffs_deflate__encoder__alloc();
+
+static inline wuffs_base__io_transformer*
+wuffs_deflate__encoder__alloc_as__wuffs_base__io_transformer() {
+  return (wuffs_base__io_transformer*)(wuffs_deflate__encoder__alloc());
+}
+
 // ---------------- Upcasts
 
 static inline wuffs_base__io_transformer*
@@ -7048,6 +7614,12 @@ wuffs_deflate__decoder__upcast_as__wuffs_base__io_transformer(
   return (wuffs_base__io_transformer*)p;
 }
 
+static inline wuffs_base__io_transformer*
+wuffs_deflate__encoder__upcast_as__wuffs_base__io_transformer(
+    wuffs_deflate__encoder* p) {
+  return (wuffs_base__io_transformer*)p;
+}
+
 // ---------------- Public Function Prototypes
 
 WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
@@ -7061,6 +7633,20 @@ wuffs_deflate__decoder__set_quirk_enabled(
     uint32_t a_quirk,
     bool a_enabled);
 
+WUFFS_BASE__MAYBE_STATIC uint32_t
+wuffs_deflate__decoder__pending_bits(
+    const wuffs_deflate__decoder* self);
+
+WUFFS_BASE__MAYBE_STATIC uint32_t
+wuffs_deflate__decoder__num_pending_bits(
+    const wuffs_deflate__decoder* self);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_deflate__decoder__set_pending_bits(
+    wuffs_deflate__decoder* self,
+    uint32_t a_bits,
+    uint32_t a_n_bits);
+
 WUFFS_BASE__MAYBE_STATIC wuffs_base__range_ii_u64
 wuffs_deflate__decoder__workbuf_len(
     const wuffs_deflate__decoder* self);
@@ -7072,6 +7658,42 @@ wuffs_deflate__decoder__transform_io(
     wuffs_base__io_buffer* a_src,
     wuffs_base__slice_u8 a_workbuf);
 
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_deflate__decoder__decode_interleaved(
+    wuffs_deflate__decoder* self,
+    wuffs_base__io_buffer* a_dst,
+    wuffs_base__io_buffer* a_src,
+    wuffs_deflate__decoder* a_peer,
+    wuffs_base__io_buffer* a_peer_dst,
+    wuffs_base__io_buffer* a_peer_src);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_deflate__encoder__set_level(
+    wuffs_deflate__encoder* self,
+    uint32_t a_level);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_deflate__encoder__set_quirk_enabled(
+    wuffs_deflate__encoder* self,
+    uint32_t a_quirk,
+    bool a_enabled);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_deflate__encoder__end_input(
+    wuffs_deflate__encoder* self,
+    bool a_full_flush);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__range_ii_u64
+wuffs_deflate__encoder__workbuf_len(
+    const wuffs_deflate__encoder* self);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_deflate__encoder__transform_io(
+    wuffs_deflate__encoder* self,
+    wuffs_base__io_buffer* a_dst,
+    wuffs_base__io_buffer* a_src,
+    wuffs_base__slice_u8 a_workbuf);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -7104,6 +7726,9 @@ struct wuffs_deflate__decoder__struct {
     uint32_t f_history_index;
     uint32_t f_n_huffs_bits[2];
     bool f_end_of_block;
+    bool f_quirks[3];
+    bool f_ready_to_interleave;
+    bool f_interleaved;
 
     uint32_t p_transform_io[1];
     uint32_t p_decode_blocks[1];
@@ -7123,6 +7748,7 @@ struct wuffs_deflate__decoder__struct {
 
     struct {
       uint32_t v_final;
+      bool v_previous;
     } s_decode_blocks[1];
     struct {
       uint32_t v_length;
@@ -7233,6 +7859,23 @@ struct wuffs_deflate__decoder__struct {
     return wuffs_deflate__decoder__set_quirk_enabled(this, a_quirk, a_enabled);
   }
 
+  inline uint32_t
+  pending_bits() const {
+    return wuffs_deflate__decoder__pending_bits(this);
+  }
+
+  inline uint32_t
+  num_pending_bits() const {
+    return wuffs_deflate__decoder__num_pending_bits(this);
+  }
+
+  inline wuffs_base__empty_struct
+  set_pending_bits(
+      uint32_t a_bits,
+      uint32_t a_n_bits) {
+    return wuffs_deflate__decoder__set_pending_bits(this, a_bits, a_n_bits);
+  }
+
   inline wuffs_base__range_ii_u64
   workbuf_len() const {
     return wuffs_deflate__decoder__workbuf_len(this);
@@ -7246,9 +7889,189 @@ struct wuffs_deflate__decoder__struct {
     return wuffs_deflate__decoder__transform_io(this, a_dst, a_src, a_workbuf);
   }
 
+  inline wuffs_base__status
+  decode_interleaved(
+      wuffs_base__io_buffer* a_dst,
+      wuffs_base__io_buffer* a_src,
+      wuffs_deflate__decoder* a_peer,
+      wuffs_base__io_buffer* a_peer_dst,
+      wuffs_base__io_buffer* a_peer_src) {
+    return wuffs_deflate__decoder__decode_interleaved(this, a_dst, a_src, a_peer, a_peer_dst, a_peer_src);
+  }
+
 #endif  // __cplusplus
 };  // struct wuffs_deflate__decoder__struct
 
+struct wuffs_deflate__encoder__struct {
+  // Do not access the private_impl's or private_data's fields directly. There
+  // is no API/ABI compatibility or safety guarantee if you do so. Instead, use
+  // the wuffs_foo__bar__baz functions.
+  //
+  // It is a struct, not a struct*, so that the outermost wuffs_foo__bar struct
+  // can be stack allocated when WUFFS_IMPLEMENTATION is defined.
+
+  struct {
+    uint32_t magic;
+    uint32_t active_coroutine;
+    wuffs_base__vtable vtable_for__wuffs_base__io_transformer;
+    wuffs_base__vtable null_vtable;
+
+    uint32_t f_level;
+    bool f_level_is_set;
+    bool f_started;
+    bool f_end_of_data;
+    bool f_input_ended;
+    bool f_full_flush;
+    uint64_t f_bits;
+    uint32_t f_n_bits;
+    uint32_t f_wnd_p;
+    uint32_t f_wnd_n;
+    uint32_t f_out_ri;
+    uint32_t f_out_wi;
+    uint32_t f_n_syms;
+    uint8_t f_llens[288];
+    uint8_t f_dlens[32];
+    uint8_t f_cllens[19];
+    uint8_t f_cl_seq[320];
+    uint8_t f_h_lengths[288];
+
+    uint32_t p_transform_io[1];
+    uint32_t (*choosy_longest_match)(
+        wuffs_deflate__encoder* self,
+        uint32_t a_cur,
+        uint32_t a_head,
+        uint32_t a_max_len,
+        uint32_t a_min_len,
+        uint32_t a_chain,
+        uint32_t a_nice);
+  } private_impl;
+
+  struct {
+    uint8_t f_window[65824];
+    uint16_t f_head[32768];
+    uint16_t f_prev[32768];
+    uint32_t f_syms[32768];
+    uint32_t f_lfreqs[288];
+    uint32_t f_dfreqs[32];
+    uint16_t f_lcodes[288];
+    uint16_t f_dcodes[32];
+    uint16_t f_clcodes[19];
+    uint16_t f_rle[320];
+    uint32_t f_h_freqs[288];
+    uint16_t f_h_codes[288];
+    uint16_t f_h_sorted[288];
+    uint32_t f_h_nfreqs[1024];
+    uint16_t f_h_nparent[1024];
+    uint8_t f_h_depths[1024];
+    uint32_t f_h_counts[16];
+    uint32_t f_h_next[16];
+    uint8_t f_out[65544];
+    uint16_t f_opt_lens[32768];
+    uint16_t f_opt_dists[32768];
+    uint16_t f_opt_choices[32768];
+    uint32_t f_opt_costs[33027];
+    uint32_t f_opt_lcosts[256];
+    uint32_t f_opt_lencost[259];
+    uint32_t f_opt_dcosts[32];
+  } private_data;
+
+#ifdef __cplusplus
+#if defined(WUFFS_BASE__HAVE_UNIQUE_PTR)
+  using unique_ptr = std::unique_ptr<wuffs_deflate__encoder, decltype(&free)>;
+
+  // On failure, the alloc_etc functions return nullptr. They don't throw.
+
+  static inline unique_ptr
+  alloc() {
+    return unique_ptr(wuffs_deflate__encoder__alloc(), &free);
+  }
+
+  static inline wuffs_base__io_transformer::unique_ptr
+  alloc_as__wuffs_base__io_transformer() {
+    return wuffs_base__io_transformer::unique_ptr(
+        wuffs_deflate__encoder__alloc_as__wuffs_base__io_transformer(), &free);
+  }
+#endif  // defined(WUFFS_BASE__HAVE_UNIQUE_PTR)
+
+#if defined(WUFFS_BASE__HAVE_EQ_DELETE) && !defined(WUFFS_IMPLEMENTATION)
+  // Disallow constructing or copying an object via standard C++ mechanisms,
+  // e.g. the "new" operator, as this struct is intentionally opaque. Its total
+  // size and field layout is not part of the public, stable, memory-safe API.
+  // Use malloc or memcpy and the sizeof__wuffs_foo__bar function instead, and
+  // call wuffs_foo__bar__baz methods (which all take a "this"-like pointer as
+  // their first argument) rather than tweaking bar.private_impl.qux fields.
+  //
+  // In C, we can just leave wuffs_foo__bar as an incomplete type (unless
+  // WUFFS_IMPLEMENTATION is #define'd). In C++, we define a complete type in
+  // order to provide convenience methods. These forward on "this", so that you
+  // can write "bar->baz(etc)" instead of "wuffs_foo__bar__baz(bar, etc)".
+  wuffs_deflate__encoder__struct() = delete;
+  wuffs_deflate__encoder__struct(const wuffs_deflate__encoder__struct&) = delete;
+  wuffs_deflate__encoder__struct& operator=(
+      const wuffs_deflate__encoder__struct&) = delete;
+#endif  // defined(WUFFS_BASE__HAVE_EQ_DELETE) && !defined(WUFFS_IMPLEMENTATION)
+
+#if !defined(WUFFS_IMPLEMENTATION)
+  // As above, the size of the struct is not part of the public API, and unless
+  // WUFFS_IMPLEMENTATION is #define'd, this struct type T should be heap
+  // allocated, not stack allocated. Its size is not intended to be known at
+  // compile time, but it is unfortunately divulged as a side effect of
+  // defining C++ convenience methods. Use "sizeof__T()", calling the function,
+  // instead of "sizeof T", invoking the operator. To make the two values
+  // different, so that passing the latter will be rejected by the initialize
+  // function, we add an arbitrary amount of dead weight.
+  uint8_t dead_weight[123000000];  // 123 MB.
+#endif  // !defined(WUFFS_IMPLEMENTATION)
+
+  inline wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
+  initialize(
+      size_t sizeof_star_self,
+      uint64_t wuffs_version,
+      uint32_t options) {
+    return wuffs_deflate__encoder__initialize(
+        this, sizeof_star_self, wuffs_version, options);
+  }
+
+  inline wuffs_base__io_transformer*
+  upcast_as__wuffs_base__io_transformer() {
+    return (wuffs_base__io_transformer*)this;
+  }
+
+  inline wuffs_base__empty_struct
+  set_level(
+      uint32_t a_level) {
+    return wuffs_deflate__encoder__set_level(this, a_level);
+  }
+
+  inline wuffs_base__empty_struct
+  set_quirk_enabled(
+      uint32_t a_quirk,
+      bool a_enabled) {
+    return wuffs_deflate__encoder__set_quirk_enabled(this, a_quirk, a_enabled);
+  }
+
+  inline wuffs_base__empty_struct
+  end_input(
+      bool a_full_flush) {
+    return wuffs_deflate__encoder__end_input(this, a_full_flush);
+  }
+
+  inline wuffs_base__range_ii_u64
+  workbuf_len() const {
+    return wuffs_deflate__encoder__workbuf_len(this);
+  }
+
+  inline wuffs_base__status
+  transform_io(
+      wuffs_base__io_buffer* a_dst,
+      wuffs_base__io_buffer* a_src,
+      wuffs_base__slice_u8 a_workbuf) {
+    return wuffs_deflate__encoder__transform_io(this, a_dst, a_src, a_workbuf);
+  }
+
+#endif  // __cplusplus
+};  // struct wuffs_deflate__encoder__struct
+
 #endif  // defined(__cplusplus) || defined(WUFFS_IMPLEMENTATION)
 
 // ---------------- Status Codes
@@ -7688,12 +8511,19 @@ struct wuffs_gif__decoder__struct {
     uint32_t f_frame_rect_y0;
     uint32_t f_frame_rect_x1;
     uint32_t f_frame_rect_y1;
+    uint32_t f_roi_x0;
+    uint32_t f_roi_y0;
+    uint32_t f_roi_x1;
+    uint32_t f_roi_y1;
+    uint32_t f_downscale_shift;
+    uint8_t f_downscale_stop_interlace;
     uint32_t f_dst_x;
     uint32_t f_dst_y;
     uint32_t f_dirty_max_excl_y;
     uint64_t f_compressed_ri;
     uint64_t f_compressed_wi;
     wuffs_base__pixel_swizzler f_swizzler;
+    wuffs_base__pixel_swizzler f_downscaler;
 
     uint32_t p_decode_image_config[1];
     uint32_t p_tell_me_more[1];
@@ -7724,6 +8554,9 @@ struct wuffs_gif__decoder__struct {
     struct {
       uint64_t scratch;
     } s_skip_frame[1];
+    struct {
+      uint32_t v_shift;
+    } s_decode_frame[1];
     struct {
       uint8_t v_c[6];
       uint32_t v_i;
@@ -7922,10 +8755,14 @@ extern const char wuffs_gzip__error__bad_header[];
 
 #define WUFFS_GZIP__DECODER_WORKBUF_LEN_MAX_INCL_WORST_CASE 1
 
+#define WUFFS_GZIP__ENCODER_WORKBUF_LEN_MAX_INCL_WORST_CASE 0
+
 // ---------------- Struct Declarations
 
 typedef struct wuffs_gzip__decoder__struct wuffs_gzip__decoder;
 
+typedef struct wuffs_gzip__encoder__struct wuffs_gzip__encoder;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -7948,6 +8785,16 @@ wuffs_gzip__decoder__initialize(
 size_t
 sizeof__wuffs_gzip__decoder();
 
+wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
+wuffs_gzip__encoder__initialize(
+    wuffs_gzip__encoder* self,
+    size_t sizeof_star_self,
+    uint64_t wuffs_version,
+    uint32_t options);
+
+size_t
+sizeof__wuffs_gzip__encoder();
+
 // ---------------- Allocs
 
 // These functions allocate and initialize Wuffs structs. They return NULL if
@@ -7964,6 +8811,14 @@ wuffs_gzip__decoder__alloc_as__wuffs_base__io_transformer() {
   return (wuffs_base__io_transformer*)(wuffs_gzip__decoder__alloc());
 }
 
+wuffs_gzip__encoder*
+wuffs_gzip__encoder__alloc();
+
+static inline wuffs_base__io_transformer*
+wuffs_gzip__encoder__alloc_as__wuffs_base__io_transformer() {
+  return (wuffs_base__io_transformer*)(wuffs_gzip__encoder__alloc());
+}
+
 // ---------------- Upcasts
 
 static inline wuffs_base__io_transformer*
@@ -7972,6 +8827,12 @@ wuffs_gzip__decoder__upcast_as__wuffs_base__io_transformer(
   return (wuffs_base__io_transformer*)p;
 }
 
+static inline wuffs_base__io_transformer*
+wuffs_gzip__encoder__upcast_as__wuffs_base__io_transformer(
+    wuffs_gzip__encoder* p) {
+  return (wuffs_base__io_transformer*)p;
+}
+
 // ---------------- Public Function Prototypes
 
 WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
@@ -7991,6 +8852,28 @@ wuffs_gzip__decoder__transform_io(
     wuffs_base__io_buffer* a_src,
     wuffs_base__slice_u8 a_workbuf);
 
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_gzip__encoder__set_level(
+    wuffs_gzip__encoder* self,
+    uint32_t a_level);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_gzip__encoder__set_quirk_enabled(
+    wuffs_gzip__encoder* self,
+    uint32_t a_quirk,
+    bool a_enabled);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__range_ii_u64
+wuffs_gzip__encoder__workbuf_len(
+    const wuffs_gzip__encoder* self);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_gzip__encoder__transform_io(
+    wuffs_gzip__encoder* self,
+    wuffs_base__io_buffer* a_dst,
+    wuffs_base__io_buffer* a_src,
+    wuffs_base__slice_u8 a_workbuf);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -8121,6 +9004,131 @@ struct wuffs_gzip__decoder__struct {
 #endif  // __cplusplus
 };  // struct wuffs_gzip__decoder__struct
 
+struct wuffs_gzip__encoder__struct {
+  // Do not access the private_impl's or private_data's fields directly. There
+  // is no API/ABI compatibility or safety guarantee if you do so. Instead, use
+  // the wuffs_foo__bar__baz functions.
+  //
+  // It is a struct, not a struct*, so that the outermost wuffs_foo__bar struct
+  // can be stack allocated when WUFFS_IMPLEMENTATION is defined.
+
+  struct {
+    uint32_t magic;
+    uint32_t active_coroutine;
+    wuffs_base__vtable vtable_for__wuffs_base__io_transformer;
+    wuffs_base__vtable null_vtable;
+
+    uint32_t f_level;
+    bool f_level_is_set;
+    bool f_started;
+
+    uint32_t p_transform_io[1];
+  } private_impl;
+
+  struct {
+    wuffs_crc32__ieee_hasher f_checksum;
+    wuffs_deflate__encoder f_flate;
+
+    struct {
+      uint32_t v_i;
+      uint8_t v_xfl;
+      uint32_t v_checksum;
+      uint32_t v_length;
+      uint64_t scratch;
+    } s_transform_io[1];
+  } private_data;
+
+#ifdef __cplusplus
+#if defined(WUFFS_BASE__HAVE_UNIQUE_PTR)
+  using unique_ptr = std::unique_ptr<wuffs_gzip__encoder, decltype(&free)>;
+
+  // On failure, the alloc_etc functions return nullptr. They don't throw.
+
+  static inline unique_ptr
+  alloc() {
+    return unique_ptr(wuffs_gzip__encoder__alloc(), &free);
+  }
+
+  static inline wuffs_base__io_transformer::unique_ptr
+  alloc_as__wuffs_base__io_transformer() {
+    return wuffs_base__io_transformer::unique_ptr(
+        wuffs_gzip__encoder__alloc_as__wuffs_base__io_transformer(), &free);
+  }
+#endif  // defined(WUFFS_BASE__HAVE_UNIQUE_PTR)
+
+#if defined(WUFFS_BASE__HAVE_EQ_DELETE) && !defined(WUFFS_IMPLEMENTATION)
+  // Disallow constructing or copying an object via standard C++ mechanisms,
+  // e.g. the "new" operator, as this struct is intentionally opaque. Its total
+  // size and field layout is not part of the public, stable, memory-safe API.
+  // Use malloc or memcpy and the sizeof__wuffs_foo__bar function instead, and
+  // call wuffs_foo__bar__baz methods (which all take a "this"-like pointer as
+  // their first argument) rather than tweaking bar.private_impl.qux fields.
+  //
+  // In C, we can just leave wuffs_foo__bar as an incomplete type (unless
+  // WUFFS_IMPLEMENTATION is #define'd). In C++, we define a complete type in
+  // order to provide convenience methods. These forward on "this", so that you
+  // can write "bar->baz(etc)" instead of "wuffs_foo__bar__baz(bar, etc)".
+  wuffs_gzip__encoder__struct() = delete;
+  wuffs_gzip__encoder__struct(const wuffs_gzip__encoder__struct&) = delete;
+  wuffs_gzip__encoder__struct& operator=(
+      const wuffs_gzip__encoder__struct&) = delete;
+#endif  // defined(WUFFS_BASE__HAVE_EQ_DELETE) && !defined(WUFFS_IMPLEMENTATION)
+
+#if !defined(WUFFS_IMPLEMENTATION)
+  // As above, the size of the struct is not part of the public API, and unless
+  // WUFFS_IMPLEMENTATION is #define'd, this struct type T should be heap
+  // allocated, not stack allocated. Its size is not intended to be known at
+  // compile time, but it is unfortunately divulged as a side effect of
+  // defining C++ convenience methods. Use "sizeof__T()", calling the function,
+  // instead of "sizeof T", invoking the operator. To make the two values
+  // different, so that passing the latter will be rejected by the initialize
+  // function, we add an arbitrary amount of dead weight.
+  uint8_t dead_weight[123000000];  // 123 MB.
+#endif  // !defined(WUFFS_IMPLEMENTATION)
+
+  inline wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
+  initialize(
+      size_t sizeof_star_self,
+      uint64_t wuffs_version,
+      uint32_t options) {
+    return wuffs_gzip__encoder__initialize(
+        this, sizeof_star_self, wuffs_version, options);
+  }
+
+  inline wuffs_base__io_transformer*
+  upcast_as__wuffs_base__io_transformer() {
+    return (wuffs_base__io_transformer*)this;
+  }
+
+  inline wuffs_base__empty_struct
+  set_level(
+      uint32_t a_level) {
+    return wuffs_gzip__encoder__set_level(this, a_level);
+  }
+
+  inline wuffs_base__empty_struct
+  set_quirk_enabled(
+      uint32_t a_quirk,
+      bool a_enabled) {
+    return wuffs_gzip__encoder__set_quirk_enabled(this, a_quirk, a_enabled);
+  }
+
+  inline wuffs_base__range_ii_u64
+  workbuf_len() const {
+    return wuffs_gzip__encoder__workbuf_len(this);
+  }
+
+  inline wuffs_base__status
+  transform_io(
+      wuffs_base__io_buffer* a_dst,
+      wuffs_base__io_buffer* a_src,
+      wuffs_base__slice_u8 a_workbuf) {
+    return wuffs_gzip__encoder__transform_io(this, a_dst, a_src, a_workbuf);
+  }
+
+#endif  // __cplusplus
+};  // struct wuffs_gzip__encoder__struct
+
 #endif  // defined(__cplusplus) || defined(WUFFS_IMPLEMENTATION)
 
 // ---------------- Status Codes
@@ -8725,10 +9733,14 @@ extern const char wuffs_zlib__error__incorrect_dictionary[];
 
 #define WUFFS_ZLIB__DECODER_WORKBUF_LEN_MAX_INCL_WORST_CASE 1
 
+#define WUFFS_ZLIB__ENCODER_WORKBUF_LEN_MAX_INCL_WORST_CASE 0
+
 // ---------------- Struct Declarations
 
 typedef struct wuffs_zlib__decoder__struct wuffs_zlib__decoder;
 
+typedef struct wuffs_zlib__encoder__struct wuffs_zlib__encoder;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -8751,6 +9763,16 @@ wuffs_zlib__decoder__initialize(
 size_t
 sizeof__wuffs_zlib__decoder();
 
+wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
+wuffs_zlib__encoder__initialize(
+    wuffs_zlib__encoder* self,
+    size_t sizeof_star_self,
+    uint64_t wuffs_version,
+    uint32_t options);
+
+size_t
+sizeof__wuffs_zlib__encoder();
+
 // ---------------- Allocs
 
 // These functions allocate and initialize Wuffs structs. They return NULL if
@@ -8767,6 +9789,14 @@ wuffs_zlib__decoder__alloc_as__wuffs_base__io_transformer() {
   return (wuffs_base__io_transformer*)(wuffs_zlib__decoder__alloc());
 }
 
+wuffs_zlib__encoder*
+wuffs_zlib__encoder__alloc();
+
+static inline wuffs_base__io_transformer*
+wuffs_zlib__encoder__alloc_as__wuffs_base__io_transformer() {
+  return (wuffs_base__io_transformer*)(wuffs_zlib__encoder__alloc());
+}
+
 // ---------------- Upcasts
 
 static inline wuffs_base__io_transformer*
@@ -8775,6 +9805,12 @@ wuffs_zlib__decoder__upcast_as__wuffs_base__io_transformer(
   return (wuffs_base__io_transformer*)p;
 }
 
+static inline wuffs_base__io_transformer*
+wuffs_zlib__encoder__upcast_as__wuffs_base__io_transformer(
+    wuffs_zlib__encoder* p) {
+  return (wuffs_base__io_transformer*)p;
+}
+
 // ---------------- Public Function Prototypes
 
 WUFFS_BASE__MAYBE_STATIC uint32_t
@@ -8803,6 +9839,28 @@ wuffs_zlib__decoder__transform_io(
     wuffs_base__io_buffer* a_src,
     wuffs_base__slice_u8 a_workbuf);
 
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_zlib__encoder__set_level(
+    wuffs_zlib__encoder* self,
+    uint32_t a_level);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_zlib__encoder__set_quirk_enabled(
+    wuffs_zlib__encoder* self,
+    uint32_t a_quirk,
+    bool a_enabled);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__range_ii_u64
+wuffs_zlib__encoder__workbuf_len(
+    const wuffs_zlib__encoder* self);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_zlib__encoder__transform_io(
+    wuffs_zlib__encoder* self,
+    wuffs_base__io_buffer* a_dst,
+    wuffs_base__io_buffer* a_src,
+    wuffs_base__slice_u8 a_workbuf);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -8948,25 +10006,153 @@ struct wuffs_zlib__decoder__struct {
 #endif  // __cplusplus
 };  // struct wuffs_zlib__decoder__struct
 
+struct wuffs_zlib__encoder__struct {
+  // Do not access the private_impl's or private_data's fields directly. There
+  // is no API/ABI compatibility or safety guarantee if you do so. Instead, use
+  // the wuffs_foo__bar__baz functions.
+  //
+  // It is a struct, not a struct*, so that the outermost wuffs_foo__bar struct
+  // can be stack allocated when WUFFS_IMPLEMENTATION is defined.
+
+  struct {
+    uint32_t magic;
+    uint32_t active_coroutine;
+    wuffs_base__vtable vtable_for__wuffs_base__io_transformer;
+    wuffs_base__vtable null_vtable;
+
+    uint32_t f_level;
+    bool f_level_is_set;
+    bool f_started;
+
+    uint32_t p_transform_io[1];
+  } private_impl;
+
+  struct {
+    wuffs_adler32__hasher f_checksum;
+    wuffs_deflate__encoder f_flate;
+
+    struct {
+      uint32_t v_checksum;
+      uint64_t scratch;
+    } s_transform_io[1];
+  } private_data;
+
+#ifdef __cplusplus
+#if defined(WUFFS_BASE__HAVE_UNIQUE_PTR)
+  using unique_ptr = std::unique_ptr<wuffs_zlib__encoder, decltype(&free)>;
+
+  // On failure, the alloc_etc functions return nullptr. They don't throw.
+
+  static inline unique_ptr
+  alloc() {
+    return unique_ptr(wuffs_zlib__encoder__alloc(), &free);
+  }
+
+  static inline wuffs_base__io_transformer::unique_ptr
+  alloc_as__wuffs_base__io_transformer() {
+    return wuffs_base__io_transformer::unique_ptr(
+        wuffs_zlib__encoder__alloc_as__wuffs_base__io_transformer(), &free);
+  }
+#endif  // defined(WUFFS_BASE__HAVE_UNIQUE_PTR)
+
+#if defined(WUFFS_BASE__HAVE_EQ_DELETE) && !defined(WUFFS_IMPLEMENTATION)
+  // Disallow constructing or copying an object via standard C++ mechanisms,
+  // e.g. the "new" operator, as this struct is intentionally opaque. Its total
+  // size and field layout is not part of the public, stable, memory-safe API.
+  // Use malloc or memcpy and the sizeof__wuffs_foo__bar function instead, and
+  // call wuffs_foo__bar__baz methods (which all take a "this"-like pointer as
+  // their first argument) rather than tweaking bar.private_impl.qux fields.
+  //
+  // In C, we can just leave wuffs_foo__bar as an incomplete type (unless
+  // WUFFS_IMPLEMENTATION is #define'd). In C++, we define a complete type in
+  // order to provide convenience methods. These forward on "this", so that you
+  // can write "bar->baz(etc)" instead of "wuffs_foo__bar__baz(bar, etc)".
+  wuffs_zlib__encoder__struct() = delete;
+  wuffs_zlib__encoder__struct(const wuffs_zlib__encoder__struct&) = delete;
+  wuffs_zlib__encoder__struct& operator=(
+      const wuffs_zlib__encoder__struct&) = delete;
+#endif  // defined(WUFFS_BASE__HAVE_EQ_DELETE) && !defined(WUFFS_IMPLEMENTATION)
+
+#if !defined(WUFFS_IMPLEMENTATION)
+  // As above, the size of the struct is not part of the public API, and unless
+  // WUFFS_IMPLEMENTATION is #define'd, this struct type T should be heap
+  // allocated, not stack allocated. Its size is not intended to be known at
+  // compile time, but it is unfortunately divulged as a side effect of
+  // defining C++ convenience methods. Use "sizeof__T()", calling the function,
+  // instead of "sizeof T", invoking the operator. To make the two values
+  // different, so that passing the latter will be rejected by the initialize
+  // function, we add an arbitrary amount of dead weight.
+  uint8_t dead_weight[123000000];  // 123 MB.
+#endif  // !defined(WUFFS_IMPLEMENTATION)
+
+  inline wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
+  initialize(
+      size_t sizeof_star_self,
+      uint64_t wuffs_version,
+      uint32_t options) {
+    return wuffs_zlib__encoder__initialize(
+        this, sizeof_star_self, wuffs_version, options);
+  }
+
+  inline wuffs_base__io_transformer*
+  upcast_as__wuffs_base__io_transformer() {
+    return (wuffs_base__io_transformer*)this;
+  }
+
+  inline wuffs_base__empty_struct
+  set_level(
+      uint32_t a_level) {
+    return wuffs_zlib__encoder__set_level(this, a_level);
+  }
+
+  inline wuffs_base__empty_struct
+  set_quirk_enabled(
+      uint32_t a_quirk,
+      bool a_enabled) {
+    return wuffs_zlib__encoder__set_quirk_enabled(this, a_quirk, a_enabled);
+  }
+
+  inline wuffs_base__range_ii_u64
+  workbuf_len() const {
+    return wuffs_zlib__encoder__workbuf_len(this);
+  }
+
+  inline wuffs_base__status
+  transform_io(
+      wuffs_base__io_buffer* a_dst,
+      wuffs_base__io_buffer* a_src,
+      wuffs_base__slice_u8 a_workbuf) {
+    return wuffs_zlib__encoder__transform_io(this, a_dst, a_src, a_workbuf);
+  }
+
+#endif  // __cplusplus
+};  // struct wuffs_zlib__encoder__struct
+
 #endif  // defined(__cplusplus) || defined(WUFFS_IMPLEMENTATION)
 
 // ---------------- Status Codes
 
+extern const char wuffs_png__error__bad_animation_sequence_number[];
 extern const char wuffs_png__error__bad_checksum[];
 extern const char wuffs_png__error__bad_chunk[];
 extern const char wuffs_png__error__bad_filter[];
 extern const char wuffs_png__error__bad_header[];
 extern const char wuffs_png__error__missing_palette[];
 extern const char wuffs_png__error__unsupported_png_file[];
+extern const char wuffs_png__error__unsupported_image_dimensions[];
 
 // ---------------- Public Consts
 
 #define WUFFS_PNG__DECODER_WORKBUF_LEN_MAX_INCL_WORST_CASE 0
 
+#define WUFFS_PNG__ENCODER_WORKBUF_LEN_MAX_INCL_WORST_CASE 0
+
 // ---------------- Struct Declarations
 
 typedef struct wuffs_png__decoder__struct wuffs_png__decoder;
 
+typedef struct wuffs_png__encoder__struct wuffs_png__encoder;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -8989,6 +10175,16 @@ wuffs_png__decoder__initialize(
 size_t
 sizeof__wuffs_png__decoder();
 
+wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
+wuffs_png__encoder__initialize(
+    wuffs_png__encoder* self,
+    size_t sizeof_star_self,
+    uint64_t wuffs_version,
+    uint32_t options);
+
+size_t
+sizeof__wuffs_png__encoder();
+
 // ---------------- Allocs
 
 // These functions allocate and initialize Wuffs structs. They return NULL if
@@ -9005,6 +10201,9 @@ wuffs_png__decoder__alloc_as__wuffs_base__image_decoder() {
   return (wuffs_base__image_decoder*)(wuffs_png__decoder__alloc());
 }
 
+wuffs_png__encoder*
+wuffs_png__encoder__alloc();
+
 // ---------------- Upcasts
 
 static inline wuffs_base__image_decoder*
@@ -9081,6 +10280,46 @@ WUFFS_BASE__MAYBE_STATIC wuffs_base__range_ii_u64
 wuffs_png__decoder__workbuf_len(
     const wuffs_png__decoder* self);
 
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_png__encoder__set_level(
+    wuffs_png__encoder* self,
+    uint32_t a_level);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_png__encoder__set_quirk_enabled(
+    wuffs_png__encoder* self,
+    uint32_t a_quirk,
+    bool a_enabled);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_png__encoder__prepare(
+    wuffs_png__encoder* self,
+    wuffs_base__pixel_buffer* a_src);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__range_ii_u64
+wuffs_png__encoder__workbuf_len(
+    const wuffs_png__encoder* self);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_png__encoder__encode_image(
+    wuffs_png__encoder* self,
+    wuffs_base__io_buffer* a_dst,
+    wuffs_base__pixel_buffer* a_src,
+    wuffs_base__slice_u8 a_workbuf);
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_png__encoder__encode_strip(
+    wuffs_png__encoder* self,
+    wuffs_base__io_buffer* a_dst,
+    wuffs_base__pixel_buffer* a_src,
+    uint32_t a_y0,
+    uint32_t a_y1,
+    wuffs_base__slice_u8 a_workbuf);
+
+WUFFS_BASE__MAYBE_STATIC uint32_t
+wuffs_png__encoder__strip_adler32(
+    const wuffs_png__encoder* self);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -9114,21 +10353,58 @@ struct wuffs_png__decoder__struct {
     uint64_t f_workbuf_wi;
     uint64_t f_overall_workbuf_length;
     uint64_t f_pass_workbuf_length;
+    uint64_t f_min_workbuf_length;
+    uint64_t f_max_workbuf_length;
+    uint32_t f_dst_y;
     uint8_t f_call_sequence;
     bool f_ignore_checksum;
+    bool f_ignore_metadata;
+    bool f_report_metadata_exif;
+    bool f_report_metadata_gama;
+    bool f_report_metadata_iccp;
+    bool f_report_metadata_kvp;
+    uint32_t f_metadata_fourcc;
+    uint64_t f_metadata_y;
+    uint64_t f_metadata_z;
     uint8_t f_depth;
     uint8_t f_color_type;
     uint8_t f_filter_distance;
     uint8_t f_interlace_pass;
+    bool f_seen_actl;
+    bool f_seen_fctl;
     bool f_seen_plte;
     bool f_seen_trns;
+    bool f_zlib_is_dirty;
     uint32_t f_dst_pixfmt;
     uint32_t f_src_pixfmt;
     uint32_t f_chunk_type;
     uint8_t f_chunk_type_array[4];
     uint64_t f_chunk_length;
+    uint32_t f_frame_rect_x0;
+    uint32_t f_frame_rect_y0;
+    uint32_t f_frame_rect_x1;
+    uint32_t f_frame_rect_y1;
+    uint32_t f_roi_x0;
+    uint32_t f_roi_y0;
+    uint32_t f_roi_x1;
+    uint32_t f_roi_y1;
+    uint32_t f_downscale_shift;
+    uint64_t f_downscale_workbuf_length;
+    uint64_t f_frame_duration;
+    uint8_t f_frame_disposal;
+    bool f_frame_overwrite_instead_of_blend;
+    uint64_t f_first_duration;
+    uint8_t f_first_disposal;
+    bool f_first_overwrite_instead_of_blend;
+    uint32_t f_num_animation_loops_value;
+    uint64_t f_num_decoded_frame_configs_value;
+    uint64_t f_num_decoded_frames_value;
+    uint32_t f_next_animation_seq_num;
+    uint64_t f_first_idat_chunk_length;
     uint64_t f_frame_config_io_position;
+    bool f_restarted;
     wuffs_base__pixel_swizzler f_swizzler;
+    wuffs_base__pixel_swizzler f_downscaler;
 
     wuffs_base__empty_struct (*choosy_filter_1)(
         wuffs_png__decoder* self,
@@ -9144,15 +10420,29 @@ struct wuffs_png__decoder__struct {
     uint32_t p_decode_image_config[1];
     uint32_t p_decode_ihdr[1];
     uint32_t p_decode_other_chunk[1];
+    uint32_t p_decode_actl[1];
+    uint32_t p_decode_fctl[1];
     uint32_t p_decode_plte[1];
     uint32_t p_decode_trns[1];
     uint32_t p_decode_frame_config[1];
+    uint32_t p_skip_frame[1];
+    uint32_t p_skip_data_chunks[1];
+    uint32_t p_decode_up_to_fdat[1];
+    uint32_t p_read_data_chunk_header[1];
     uint32_t p_decode_frame[1];
     uint32_t p_decode_pass[1];
+    uint32_t p_tell_me_more[1];
     wuffs_base__status (*choosy_filter_and_swizzle)(
         wuffs_png__decoder* self,
         wuffs_base__pixel_buffer* a_dst,
-        wuffs_base__slice_u8 a_workbuf);
+        wuffs_base__slice_u8 a_prev,
+        wuffs_base__slice_u8 a_workbuf,
+        wuffs_base__slice_u8 a_downscale);
+    uint64_t (*choosy_unpack_bits)(
+        wuffs_png__decoder* self,
+        wuffs_base__slice_u8 a_dst,
+        wuffs_base__slice_u8 a_src,
+        uint8_t a_multiplier);
   } private_impl;
 
   struct {
@@ -9171,6 +10461,17 @@ struct wuffs_png__decoder__struct {
     struct {
       uint64_t scratch;
     } s_decode_other_chunk[1];
+    struct {
+      uint64_t scratch;
+    } s_decode_actl[1];
+    struct {
+      uint32_t v_a32;
+      uint32_t v_width;
+      uint32_t v_height;
+      uint32_t v_x0;
+      uint32_t v_num;
+      uint64_t scratch;
+    } s_decode_fctl[1];
     struct {
       uint32_t v_num_entries;
       uint32_t v_i;
@@ -9180,10 +10481,34 @@ struct wuffs_png__decoder__struct {
       uint32_t v_num_entries;
       uint32_t v_i;
     } s_decode_trns[1];
+    struct {
+      uint64_t scratch;
+    } s_skip_data_chunks[1];
+    struct {
+      uint64_t scratch;
+    } s_decode_up_to_fdat[1];
+    struct {
+      uint32_t v_chunk_type;
+      uint64_t scratch;
+    } s_read_data_chunk_header[1];
+    struct {
+      uint32_t v_frame_width;
+      uint32_t v_frame_height;
+      uint32_t v_pass_width;
+      uint32_t v_pass_height;
+      uint32_t v_shift;
+    } s_decode_frame[1];
     struct {
       uint32_t v_checksum_have;
+      uint64_t v_strip_length;
+      uint64_t v_strip_wi;
+      bool v_strip_parity;
+      uint64_t v_ds_length;
       uint64_t scratch;
     } s_decode_pass[1];
+    struct {
+      uint32_t v_transform;
+    } s_tell_me_more[1];
   } private_data;
 
 #ifdef __cplusplus
@@ -9329,6 +10654,172 @@ struct wuffs_png__decoder__struct {
 #endif  // __cplusplus
 };  // struct wuffs_png__decoder__struct
 
+struct wuffs_png__encoder__struct {
+  // Do not access the private_impl's or private_data's fields directly. There
+  // is no API/ABI compatibility or safety guarantee if you do so. Instead, use
+  // the wuffs_foo__bar__baz functions.
+  //
+  // It is a struct, not a struct*, so that the outermost wuffs_foo__bar struct
+  // can be stack allocated when WUFFS_IMPLEMENTATION is defined.
+
+  struct {
+    uint32_t magic;
+    uint32_t active_coroutine;
+    wuffs_base__vtable null_vtable;
+
+    uint32_t f_width;
+    uint32_t f_height;
+    uint32_t f_bytes_per_row;
+    uint32_t f_filter_distance;
+    uint8_t f_color_type;
+    uint32_t f_level;
+    bool f_level_is_set;
+    uint8_t f_call_sequence;
+    uint32_t f_y;
+    uint32_t f_filtered_ri;
+    uint32_t f_filtered_n;
+    uint32_t f_buf_ri;
+    uint32_t f_buf_wi;
+    uint32_t f_adler32_state;
+    uint64_t f_costs[5];
+    wuffs_base__pixel_swizzler f_swizzler;
+
+    wuffs_base__empty_struct (*choosy_accumulate_costs)(
+        wuffs_png__encoder* self,
+        wuffs_base__slice_u8 a_x,
+        wuffs_base__slice_u8 a_a,
+        wuffs_base__slice_u8 a_b,
+        wuffs_base__slice_u8 a_c);
+    wuffs_base__empty_struct (*choosy_write_residuals)(
+        wuffs_png__encoder* self,
+        wuffs_base__slice_u8 a_dst,
+        wuffs_base__slice_u8 a_x,
+        wuffs_base__slice_u8 a_a,
+        wuffs_base__slice_u8 a_b,
+        wuffs_base__slice_u8 a_c,
+        uint32_t a_filter);
+    uint32_t p_encode_image[1];
+    uint32_t p_encode_strip[1];
+    uint32_t p_encode_rows[1];
+    uint32_t p_write_buf[1];
+    uint32_t p_write_idat[1];
+  } private_impl;
+
+  struct {
+    wuffs_adler32__hasher f_adler32;
+    wuffs_crc32__ieee_hasher f_crc32;
+    wuffs_deflate__encoder f_flate;
+    uint8_t f_buf[32800];
+
+    struct {
+      uint64_t scratch;
+    } s_encode_strip[1];
+    struct {
+      wuffs_base__status v_status;
+    } s_encode_rows[1];
+  } private_data;
+
+#ifdef __cplusplus
+#if defined(WUFFS_BASE__HAVE_UNIQUE_PTR)
+  using unique_ptr = std::unique_ptr<wuffs_png__encoder, decltype(&free)>;
+
+  // On failure, the alloc_etc functions return nullptr. They don't throw.
+
+  static inline unique_ptr
+  alloc() {
+    return unique_ptr(wuffs_png__encoder__alloc(), &free);
+  }
+#endif  // defined(WUFFS_BASE__HAVE_UNIQUE_PTR)
+
+#if defined(WUFFS_BASE__HAVE_EQ_DELETE) && !defined(WUFFS_IMPLEMENTATION)
+  // Disallow constructing or copying an object via standard C++ mechanisms,
+  // e.g. the "new" operator, as this struct is intentionally opaque. Its total
+  // size and field layout is not part of the public, stable, memory-safe API.
+  // Use malloc or memcpy and the sizeof__wuffs_foo__bar function instead, and
+  // call wuffs_foo__bar__baz methods (which all take a "this"-like pointer as
+  // their first argument) rather than tweaking bar.private_impl.qux fields.
+  //
+  // In C, we can just leave wuffs_foo__bar as an incomplete type (unless
+  // WUFFS_IMPLEMENTATION is #define'd). In C++, we define a complete type in
+  // order to provide convenience methods. These forward on "this", so that you
+  // can write "bar->baz(etc)" instead of "wuffs_foo__bar__baz(bar, etc)".
+  wuffs_png__encoder__struct() = delete;
+  wuffs_png__encoder__struct(const wuffs_png__encoder__struct&) = delete;
+  wuffs_png__encoder__struct& operator=(
+      const wuffs_png__encoder__struct&) = delete;
+#endif  // defined(WUFFS_BASE__HAVE_EQ_DELETE) && !defined(WUFFS_IMPLEMENTATION)
+
+#if !defined(WUFFS_IMPLEMENTATION)
+  // As above, the size of the struct is not part of the public API, and unless
+  // WUFFS_IMPLEMENTATION is #define'd, this struct type T should be heap
+  // allocated, not stack allocated. Its size is not intended to be known at
+  // compile time, but it is unfortunately divulged as a side effect of
+  // defining C++ convenience methods. Use "sizeof__T()", calling the function,
+  // instead of "sizeof T", invoking the operator. To make the two values
+  // different, so that passing the latter will be rejected by the initialize
+  // function, we add an arbitrary amount of dead weight.
+  uint8_t dead_weight[123000000];  // 123 MB.
+#endif  // !defined(WUFFS_IMPLEMENTATION)
+
+  inline wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
+  initialize(
+      size_t sizeof_star_self,
+      uint64_t wuffs_version,
+      uint32_t options) {
+    return wuffs_png__encoder__initialize(
+        this, sizeof_star_self, wuffs_version, options);
+  }
+
+  inline wuffs_base__empty_struct
+  set_level(
+      uint32_t a_level) {
+    return wuffs_png__encoder__set_level(this, a_level);
+  }
+
+  inline wuffs_base__empty_struct
+  set_quirk_enabled(
+      uint32_t a_quirk,
+      bool a_enabled) {
+    return wuffs_png__encoder__set_quirk_enabled(this, a_quirk, a_enabled);
+  }
+
+  inline wuffs_base__status
+  prepare(
+      wuffs_base__pixel_buffer* a_src) {
+    return wuffs_png__encoder__prepare(this, a_src);
+  }
+
+  inline wuffs_base__range_ii_u64
+  workbuf_len() const {
+    return wuffs_png__encoder__workbuf_len(this);
+  }
+
+  inline wuffs_base__status
+  encode_image(
+      wuffs_base__io_buffer* a_dst,
+      wuffs_base__pixel_buffer* a_src,
+      wuffs_base__slice_u8 a_workbuf) {
+    return wuffs_png__encoder__encode_image(this, a_dst, a_src, a_workbuf);
+  }
+
+  inline wuffs_base__status
+  encode_strip(
+      wuffs_base__io_buffer* a_dst,
+      wuffs_base__pixel_buffer* a_src,
+      uint32_t a_y0,
+      uint32_t a_y1,
+      wuffs_base__slice_u8 a_workbuf) {
+    return wuffs_png__encoder__encode_strip(this, a_dst, a_src, a_y0, a_y1, a_workbuf);
+  }
+
+  inline uint32_t
+  strip_adler32() const {
+    return wuffs_png__encoder__strip_adler32(this);
+  }
+
+#endif  // __cplusplus
+};  // struct wuffs_png__encoder__struct
+
 #endif  // defined(__cplusplus) || defined(WUFFS_IMPLEMENTATION)
 
 // ---------------- Status Codes
@@ -9803,8 +11294,234 @@ DecodeCbor(DecodeCborCallbacks& callbacks,
 
 }  // namespace wuffs_aux
 
+// ---------------- Auxiliary - Deflate
+
+#include <vector>
+
+namespace wuffs_aux {
+
+struct DecodeDeflateResult {
+  DecodeDeflateResult(std::string&& error_message0, uint64_t num_dst_bytes0);
+
+  std::string error_message;
+  uint64_t num_dst_bytes;
+};
+
+class DecodeDeflateCallbacks {
+ public:
+  virtual ~DecodeDeflateCallbacks();
+
+  // Append is called with the decoded output, in order. Each call's ptr is
+  // only valid for the duration of that call. Returning a non-empty string
+  // stops the decoding, with that string as the error_message.
+  //
+  // Even when DecodeDeflate uses multiple threads, Append is only ever called
+  // from the thread that called DecodeDeflate.
+  virtual std::string Append(const uint8_t* ptr, size_t len) = 0;
+
+  // Done is always the last Callback method called by DecodeDeflate, whether
+  // or not decoding the input encountered an error.
+  //
+  // The default Done implementation is a no-op.
+  virtual void  //
+  Done(DecodeDeflateResult& result, sync_io::Input& input);
+};
+
+extern const char DecodeDeflate_BadChecksum[];
+extern const char DecodeDeflate_BadHeader[];
+extern const char DecodeDeflate_OutOfMemory[];
+extern const char DecodeDeflate_UnexpectedEndOfFile[];
+extern const char DecodeDeflate_UnsupportedFraming[];
+
+// DecodeDeflate decodes the compressed data in input, calling callbacks.Append
+// with the decoded output.
+//
+// The framing is one of:
+//  - 0, meaning raw DEFLATE (RFC 1951).
+//  - WUFFS_BASE__FOURCC__GZ, meaning gzip (RFC 1952).
+//  - WUFFS_BASE__FOURCC__ZLIB, meaning zlib (RFC 1950).
+// Only the first gzip member is decoded and zlib preset dictionaries are not
+// supported.
+//
+// When num_threads is 0 or 1, decoding is a single streaming pass that uses
+// O(1) memory. Otherwise, the entire input is read into memory (unless it is
+// already there: a sync_io::MemoryInput) and then split into chunks that are
+// decoded speculatively and in parallel, up to num_threads chunks at a time:
+//  1. Each thread looks for a likely DEFLATE block boundary within its chunk,
+//     confirming it with a trial decode.
+//  2. Each thread decodes from that boundary with a placeholder 32 KiB
+//     history, since the real history (the previous chunk's output) is not
+//     yet known. Back-references into the history produce placeholder bytes.
+//     Decoding is run twice (with two different placeholder histories) to
+//     tell literal bytes apart from placeholders and to identify which
+//     history position each placeholder refers to.
+//  3. The chunks are stitched together in order, replacing placeholders once
+//     the real history is known. A chunk whose speculative starting point
+//     does not line up with where its predecessor actually ended (e.g. a
+//     false positive block boundary) is instead decoded conventionally, so
+//     that the output is always identical to single-threaded decoding.
+//
+// Peak memory usage is therefore the input size plus a bounded amount (on
+// the order of 64 MiB) per thread.
+//
+// WUFFS_BASE__QUIRK_IGNORE_CHECKSUM is the only quirk that has an effect.
+DecodeDeflateResult  //
+DecodeDeflate(DecodeDeflateCallbacks& callbacks,
+              sync_io::Input& input,
+              uint32_t framing = 0,
+              uint32_t num_threads = 1,
+              wuffs_base__slice_u32 quirks = wuffs_base__empty_slice_u32());
+
+// DecodeGzipMembers decodes all of the concatenated gzip members (RFC 1952
+// section 2.2) in input, calling callbacks.Append with the decoded output. The
+// CRC-32 and ISIZE of each member are checked separately.
+//
+// BGZF files (as used by e.g. samtools) are gzip members whose FEXTRA field
+// holds a "BC" subfield: the member's compressed size. When num_threads is
+// more than 1, such members are read ahead (without decoding) and then
+// decoded in parallel, in batches, by a pool of per-thread gzip decoders. The
+// batches are bounded (WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH, 4 MiB by
+// default, of decoded output per thread) and the output is reassembled in
+// order. Members without a "BC" subfield are decoded single-threaded, as
+// their length is not known up front. For well-formed BGZF "BC" subfields,
+// the output and any error message are the same as for num_threads == 1.
+//
+// WUFFS_BASE__QUIRK_IGNORE_CHECKSUM is the only quirk that has an effect.
+DecodeDeflateResult  //
+DecodeGzipMembers(DecodeDeflateCallbacks& callbacks,
+                  sync_io::Input& input,
+                  uint32_t num_threads = 1,
+                  wuffs_base__slice_u32 quirks = wuffs_base__empty_slice_u32());
+
+// --------
+
+class DecodeDeflateBatchCallbacks {
+ public:
+  virtual ~DecodeDeflateBatchCallbacks();
+
+  // Append is called with the i'th input's decoded output, in order. Calls
+  // for different inputs can be interleaved. Each call's ptr is only valid
+  // for the duration of that call. Returning a non-empty string stops the
+  // decoding of the i'th input, with that string as its error_message.
+  virtual std::string Append(size_t i, const uint8_t* ptr, size_t len) = 0;
+};
+
+// DecodeDeflateBatch decodes each of the inputs, independent compressed
+// streams that are entirely in memory, calling callbacks.Append with their
+// decoded output. It returns one DecodeDeflateResult per input. The framing
+// is as for DecodeDeflate.
+//
+// It is optimized for many small inputs. Decoding a Huffman-compressed block
+// is usually bound by the latency of its (dependent) table lookups, so two
+// inputs are decoded at a time, on the calling thread, with their blocks'
+// symbols decoded in one interleaved loop (see the deflate decoder's
+// decode_interleaved method) to overlap those lookups. Each input's output
+// and result are the same as DecodeDeflate's (single-threaded) would be.
+//
+// WUFFS_BASE__QUIRK_IGNORE_CHECKSUM is the only quirk that has an effect.
+std::vector<DecodeDeflateResult>  //
+DecodeDeflateBatch(
+    DecodeDeflateBatchCallbacks& callbacks,
+    const std::vector<wuffs_base__slice_u8>& inputs,
+    uint32_t framing = 0,
+    wuffs_base__slice_u32 quirks = wuffs_base__empty_slice_u32());
+
+// --------
+
+// DecodeDeflateCheckpoint is a point in a DEFLATE stream (always a block
+// boundary) from which decoding can resume, without having to decode
+// everything before it.
+struct DecodeDeflateCheckpoint {
+  DecodeDeflateCheckpoint();
+
+  // dst_pos is the position in the decoded output.
+  uint64_t dst_pos;
+  // src_pos is the position in the compressed input (including any gzip or
+  // zlib header) of the first whole byte after the block boundary.
+  uint64_t src_pos;
+  // pending_bits and num_pending_bits (less than 8) are the bits of the byte
+  // at src_pos-1 that are after the block boundary.
+  uint32_t pending_bits;
+  uint32_t num_pending_bits;
+  // history is the (up to) 32 KiB of decoded output just before dst_pos.
+  std::string history;
+};
+
+// DecodeDeflateIndex is a list of DecodeDeflateCheckpoints, in increasing
+// dst_pos order. It is similar to zlib's examples/zran.c program.
+struct DecodeDeflateIndex {
+  DecodeDeflateIndex();
+
+  // Find returns the last checkpoint whose dst_pos is at or before dst_pos,
+  // or nullptr if there is no such checkpoint.
+  const DecodeDeflateCheckpoint* Find(uint64_t dst_pos) const;
+
+  // Serialize returns the index in a compact binary format that Parse reads.
+  // All integers are little-endian:
+  //  - 4 byte magic "WDIX", then u32 framing, u64 spacing, u64 num_dst_bytes
+  //    and u32 number of checkpoints.
+  //  - For each checkpoint: u64 dst_pos, u64 src_pos, u8 num_pending_bits, u8
+  //    pending_bits, u16 history length and then the history bytes.
+  std::string Serialize() const;
+
+  // Parse replaces the index's contents with the serialized form in (ptr,
+  // len). It returns an empty string on success or an error message.
+  std::string Parse(const uint8_t* ptr, size_t len);
+
+  uint32_t framing;
+  uint64_t spacing;
+  uint64_t num_dst_bytes;
+  std::vector<DecodeDeflateCheckpoint> checkpoints;
+};
+
+extern const char DecodeDeflate_BadCheckpoint[];
+extern const char DecodeDeflate_BadIndex[];
+
+// DecodeDeflateWithIndex is like single-threaded DecodeDeflate but also
+// replaces index's contents with checkpoints. The first checkpoint is at the
+// start of the DEFLATE stream. Each subsequent checkpoint is at the first
+// block boundary that is at least spacing bytes (of decoded output) after
+// the previous checkpoint.
+//
+// With a spacing of N, decoding from a checkpoint to reach any given position
+// decodes at most N bytes plus the length of one DEFLATE block.
+DecodeDeflateResult  //
+DecodeDeflateWithIndex(
+    DecodeDeflateCallbacks& callbacks,
+    sync_io::Input& input,
+    DecodeDeflateIndex& index,
+    uint32_t framing = 0,
+    uint64_t spacing = 1024 * 1024,
+    wuffs_base__slice_u32 quirks = wuffs_base__empty_slice_u32());
+
+// DecodeDeflateRestore re-initializes dec so that it resumes decoding at the
+// checkpoint. The caller is responsible for then feeding dec the compressed
+// input starting at checkpoint.src_pos. It returns an empty string on success
+// or an error message.
+std::string  //
+DecodeDeflateRestore(wuffs_deflate__decoder& dec,
+                     const DecodeDeflateCheckpoint& checkpoint);
+
+// DecodeDeflateRange calls callbacks.Append with the decoded output in the
+// range [dst_pos, dst_pos + dst_len), clipped to the end of the DEFLATE
+// stream, by decoding from the checkpoint. The checkpoint is typically
+// index.Find(dst_pos) and its dst_pos must not be after dst_pos.
+//
+// The input must start at checkpoint.src_pos, e.g. after a fseek call. Since
+// decoding does not start at the beginning, no checksums are verified.
+DecodeDeflateResult  //
+DecodeDeflateRange(DecodeDeflateCallbacks& callbacks,
+                   sync_io::Input& input,
+                   const DecodeDeflateCheckpoint& checkpoint,
+                   uint64_t dst_pos,
+                   uint64_t dst_len);
+
+}  // namespace wuffs_aux
+
 // ---------------- Auxiliary - Image
 
+#include <vector>
+
 namespace wuffs_aux {
 
 struct DecodeImageResult {
@@ -9949,6 +11666,7 @@ extern const char DecodeImage_BufferIsTooShort[];
 extern const char DecodeImage_MaxInclDimensionExceeded[];
 extern const char DecodeImage_OutOfMemory[];
 extern const char DecodeImage_UnexpectedEndOfFile[];
+extern const char DecodeImage_UnsupportedDownscaleShift[];
 extern const char DecodeImage_UnsupportedImageFormat[];
 extern const char DecodeImage_UnsupportedPixelBlend[];
 extern const char DecodeImage_UnsupportedPixelConfiguration[];
@@ -9997,12 +11715,154 @@ extern const char DecodeImage_UnsupportedPixelFormat[];
 //
 // Decoding fails (with DecodeImage_MaxInclDimensionExceeded) if the image's
 // width or height is greater than max_incl_dimension.
+//
+// When num_threads is 0 or 1, decoding is single-threaded and streams the
+// input. Otherwise, the entire input is read into memory (unless it is already
+// there: a sync_io::MemoryInput) and, for PNG images, decoding is pipelined
+// across two threads. A second thread inflates the zlib-compressed IDAT data
+// while the calling thread un-filters and swizzles rows that have already
+// been inflated. All of the callbacks are still called from the calling
+// thread, but the IDAT chunks' CRC-32 and the zlib Adler-32 checksums are not
+// verified. Other image formats are decoded single-threaded. Either way, the
+// input passed to Done is then the in-memory input that was decoded, which
+// continues after the image data just like the original input would.
+//
+// When downscale_shift is 1, 2 or 3, the image is reduced to 1/2, 1/4 or 1/8
+// of its width and height (rounding up), e.g. for thumbnails, and AllocPixbuf
+// is only asked for that reduced size. Each pixel is the average of a block of
+// full size pixels (see wuffs_base__decode_frame_options__set_downscale_shift).
+// PNG and GIF images are downscaled as they are decoded (stopping early for
+// interlaced images). Other image formats are decoded to a temporary, full
+// size, pixel buffer first. The max_incl_dimension applies to the full size.
+// Larger shifts fail with DecodeImage_UnsupportedDownscaleShift.
 DecodeImageResult  //
 DecodeImage(DecodeImageCallbacks& callbacks,
             sync_io::Input& input,
             wuffs_base__pixel_blend pixel_blend = WUFFS_BASE__PIXEL_BLEND__SRC,
             wuffs_base__color_u32_argb_premul background_color = 1,  // Invalid.
-            uint32_t max_incl_dimension = 1048575);  // 0x000F_FFFF
+            uint32_t max_incl_dimension = 1048575,  // 0x000F_FFFF
+            uint32_t num_threads = 1,
+            uint32_t downscale_shift = 0);
+
+// --------
+
+struct IndexFramesResult {
+  // Frame is an animation frame's entry in the index. A keyframe can be
+  // composited without any earlier frames, starting from a canvas cleared to
+  // the background: either it is the first frame, or the previous frame's
+  // disposal restores the whole canvas to the background, or it covers the
+  // whole canvas and replaces every pixel (because it is opaque or because
+  // it overwrites instead of blends). In that last case, its own disposal
+  // must not be RESTORE_PREVIOUS, as later frames would then need the canvas
+  // from before it.
+  struct Frame {
+    uint64_t io_position;
+    wuffs_base__rect_ie_u32 bounds;
+    wuffs_base__flicks duration;
+    wuffs_base__animation_disposal disposal;
+    bool keyframe;
+  };
+
+  IndexFramesResult(wuffs_base__image_config image_config0,
+                    std::vector<Frame>&& frames0,
+                    std::string&& error_message0);
+
+  // KeyframeFor returns the index of the nearest keyframe at or before frame
+  // n. Rendering frame n only needs frames from there onwards.
+  size_t KeyframeFor(size_t n) const;
+
+  wuffs_base__image_config image_config;
+  std::vector<Frame> frames;
+  std::string error_message;
+};
+
+// IndexFrames walks an animated image once, with decode_frame_config, to
+// record every frame's io_position, bounds, duration and disposal. The pixel
+// data is skipped, not decoded. The image_decoder must be freshly created
+// (e.g. by wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder) and
+// afterwards it can seek to frame n, for any index n, by calling
+// restart_frame(k, frames[k].io_position), with k being KeyframeFor(n), then
+// decoding frames k to n from that io_position in its input.
+//
+// On failure (including a truncated input), error_message is non-empty but
+// frames still lists the frames indexed before the failure. The image_decoder
+// may then be mid-way through a suspended call and cannot seek: decode those
+// frames with another (fresh) decoder instead.
+IndexFramesResult  //
+IndexFrames(wuffs_base__image_decoder& image_decoder, sync_io::Input& input);
+
+// --------
+
+class DecodeGifFramesCallbacks {
+ public:
+  virtual ~DecodeGifFramesCallbacks();
+
+  // Frame is called from the calling thread, once per frame and in frame
+  // order, after that frame has been composited onto the canvas. The canvas
+  // is a BGRA_PREMUL pixel buffer the size of the whole image, and is only
+  // valid for the duration of the call. Returning a non-empty string stops
+  // decoding, with that string as the error_message.
+  virtual std::string  //
+  Frame(const wuffs_base__frame_config& frame_config,
+        const wuffs_base__pixel_buffer& canvas) = 0;
+};
+
+struct DecodeGifFramesResult {
+  DecodeGifFramesResult(uint64_t num_frames0, std::string&& error_message0);
+  // num_frames is the number of callbacks.Frame calls.
+  uint64_t num_frames;
+  std::string error_message;
+};
+
+extern const char DecodeGifFrames_OutOfMemory[];
+
+// DecodeGifFrames decodes every frame of an (animated) GIF image, compositing
+// each over the canvas left by the previous frame's disposal.
+//
+// When num_threads is 0 or 1, frames are decoded one at a time. Otherwise,
+// the entire input is read into memory and indexed (see IndexFrames). Frames
+// are then decoded in rounds of num_threads frames, each frame's palette
+// indices into its own buffer on its own thread, by a per-thread
+// wuffs_gif__decoder (and its wuffs_lzw__decoder) that is re-used from one
+// round to the next via restart_frame. LZW decoding is independent from one
+// frame to the next. Compositing is not, so after each round the calling
+// thread composites that round's frames, in order.
+DecodeGifFramesResult  //
+DecodeGifFrames(DecodeGifFramesCallbacks& callbacks,
+                sync_io::Input& input,
+                uint32_t num_threads = 1);
+
+// --------
+
+struct EncodePngResult {
+  EncodePngResult(std::string&& dst0, std::string&& error_message0);
+
+  std::string dst;
+  std::string error_message;
+};
+
+extern const char EncodePng_OutOfMemory[];
+
+// EncodePng encodes the src pixel buffer as a PNG image. Its pixel format
+// must be 8 (Y), 24 (e.g. BGR or RGB) or 32 (e.g. BGRA_PREMUL or
+// RGBA_NONPREMUL) bits per pixel, giving a gray, RGB or RGBA PNG image. The
+// level is the compression level, from 0 (no compression) to 9 (best).
+//
+// When num_threads is 0 or 1, encoding is single-threaded. Otherwise, the
+// image is split into num_threads horizontal strips (or fewer, for very short
+// images). Each strip is filtered and compressed on its own thread, by its own
+// wuffs_png__encoder, as DEFLATE blocks that end with a full flush. The
+// calling thread then joins the strips, one or more IDAT chunks each, as a
+// single zlib stream and combines the strips' Adler-32 checksums. Compression
+// is slightly worse than single-threaded, since no strip can refer back to an
+// earlier strip's data.
+//
+// On success, the EncodePngResult's error_message is empty and dst holds the
+// PNG image. On failure, error_message is non-empty.
+EncodePngResult  //
+EncodePng(wuffs_base__pixel_buffer& src,
+          uint32_t level = 6,
+          uint32_t num_threads = 1);
 
 }  // namespace wuffs_aux
 
@@ -10707,6 +12567,23 @@ wuffs_base__io_writer__limited_copy_u32_from_slice(uint8_t** ptr_iop_w,
   return (uint32_t)(n);
 }
 
+// wuffs_base__io_writer__limited_write_u64le_fast writes all 8 bytes of x but
+// only advances *ptr_iop_w by length bytes. The other (8 - length) bytes are
+// scratch space, for subsequent writes to overwrite.
+//
+// The caller needs to prove that:
+//  - length <= 8
+//  - 8      <= (io2_w - *ptr_iop_w)
+static inline uint32_t  //
+wuffs_base__io_writer__limited_write_u64le_fast(uint8_t** ptr_iop_w,
+                                                uint8_t* io2_w,
+                                                uint32_t length,
+                                                uint64_t x) {
+  wuffs_base__poke_u64le__no_bounds_check(*ptr_iop_w, x);
+  *ptr_iop_w += length;
+  return length;
+}
+
 static inline wuffs_base__io_buffer*  //
 wuffs_base__io_writer__set(wuffs_base__io_buffer* b,
                            uint8_t** ptr_iop_w,
@@ -10767,6 +12644,8 @@ wuffs_base__pixel_swizzler__swizzle_interleaved_transparent_black(
 
 // ---------------- Images (Utility)
 
+#define wuffs_base__utility__make_pixel_blend(repr) \
+  ((wuffs_base__pixel_blend)(repr))
 #define wuffs_base__utility__make_pixel_format wuffs_base__make_pixel_format
 
 // ---------------- String Conversions
@@ -15413,6 +17292,54 @@ wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxx(
   }
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static void  //
+wuffs_base__pixel_buffer__fill_u32le__avx2(uint8_t* ptr,
+                                           size_t n,
+                                           uint32_t color) {
+  __m256i x = _mm256_set1_epi32((int32_t)color);
+  for (; n >= 8; n -= 8) {
+    _mm256_storeu_si256((__m256i*)(void*)ptr, x);
+    ptr += 8 * 4;
+  }
+  for (; n > 0; n--) {
+    wuffs_base__poke_u32le__no_bounds_check(ptr, color);
+    ptr += 4;
+  }
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static void  //
+wuffs_base__pixel_buffer__fill_u32le__sse42(uint8_t* ptr,
+                                            size_t n,
+                                            uint32_t color) {
+  __m128i x = _mm_set1_epi32((int32_t)color);
+  for (; n >= 4; n -= 4) {
+    _mm_storeu_si128((__m128i*)(void*)ptr, x);
+    ptr += 4 * 4;
+  }
+  for (; n > 0; n--) {
+    wuffs_base__poke_u32le__no_bounds_check(ptr, color);
+    ptr += 4;
+  }
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
+
+static void  //
+wuffs_base__pixel_buffer__fill_u32le(uint8_t* ptr, size_t n, uint32_t color) {
+  for (; n > 0; n--) {
+    wuffs_base__poke_u32le__no_bounds_check(ptr, color);
+    ptr += 4;
+  }
+}
+
 static inline void  //
 wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxx(
     wuffs_base__pixel_buffer* pb,
@@ -15420,15 +17347,25 @@ wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxx(
     uint32_t color) {
   size_t stride = pb->private_impl.planes[0].stride;
   uint32_t width = wuffs_base__rect_ie_u32__width(&rect);
+  uint32_t height = wuffs_base__rect_ie_u32__height(&rect);
+
+  void (*fill)(uint8_t*, size_t, uint32_t) =
+      wuffs_base__pixel_buffer__fill_u32le;
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+  // Tiny fills don't pay for the cpuid checks.
+  if ((((uint64_t)width) * ((uint64_t)height)) >= 64) {
+    if (wuffs_base__cpu_arch__have_x86_avx2()) {
+      fill = wuffs_base__pixel_buffer__fill_u32le__avx2;
+    } else if (wuffs_base__cpu_arch__have_x86_sse42()) {
+      fill = wuffs_base__pixel_buffer__fill_u32le__sse42;
+    }
+  }
+#endif
+
   if ((stride == (4 * ((uint64_t)width))) && (rect.min_incl_x == 0)) {
     uint8_t* ptr =
         pb->private_impl.planes[0].ptr + (stride * ((size_t)rect.min_incl_y));
-    uint32_t height = wuffs_base__rect_ie_u32__height(&rect);
-    size_t n;
-    for (n = ((size_t)width) * ((size_t)height); n > 0; n--) {
-      wuffs_base__poke_u32le__no_bounds_check(ptr, color);
-      ptr += 4;
-    }
+    (*fill)(ptr, ((size_t)width) * ((size_t)height), color);
     return;
   }
 
@@ -15436,11 +17373,7 @@ wuffs_base__pixel_buffer__set_color_u32_fill_rect__xxxx(
   for (y = rect.min_incl_y; y < rect.max_excl_y; y++) {
     uint8_t* ptr = pb->private_impl.planes[0].ptr + (stride * ((size_t)y)) +
                    (4 * ((size_t)rect.min_incl_x));
-    uint32_t n;
-    for (n = width; n > 0; n--) {
-      wuffs_base__poke_u32le__no_bounds_check(ptr, color);
-      ptr += 4;
-    }
+    (*fill)(ptr, width, color);
   }
 }
 
@@ -15554,6 +17487,104 @@ wuffs_base__pixel_buffer__set_color_u32_fill_rect(
 
 // --------
 
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status  //
+wuffs_base__pixel_buffer__composite(wuffs_base__pixel_buffer* pb,
+                                    const wuffs_base__pixel_buffer* src,
+                                    uint32_t dst_x,
+                                    uint32_t dst_y,
+                                    wuffs_base__rect_ie_u32 clip,
+                                    wuffs_base__pixel_blend blend) {
+  if (!pb) {
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+  } else if (!src) {
+    return wuffs_base__make_status(wuffs_base__error__bad_argument);
+  } else if (
+      wuffs_base__pixel_format__is_planar(&pb->pixcfg.private_impl.pixfmt) ||
+      wuffs_base__pixel_format__is_planar(&src->pixcfg.private_impl.pixfmt)) {
+    // TODO: support planar formats.
+    return wuffs_base__make_status(wuffs_base__error__unsupported_option);
+  }
+
+  uint32_t dst_bits_per_pixel = wuffs_base__pixel_format__bits_per_pixel(
+      &pb->pixcfg.private_impl.pixfmt);
+  uint32_t src_bits_per_pixel = wuffs_base__pixel_format__bits_per_pixel(
+      &src->pixcfg.private_impl.pixfmt);
+  if ((dst_bits_per_pixel == 0) || ((dst_bits_per_pixel % 8) != 0) ||
+      (src_bits_per_pixel == 0) || ((src_bits_per_pixel % 8) != 0)) {
+    // TODO: support fraction-of-byte pixels, e.g. 1 bit per pixel?
+    return wuffs_base__make_status(wuffs_base__error__unsupported_option);
+  }
+  size_t dst_bytes_per_pixel = dst_bits_per_pixel / 8;
+  size_t src_bytes_per_pixel = src_bits_per_pixel / 8;
+
+  // Clip to pb's bounds and to src's bounds, translated by (dst_x, dst_y).
+  // Any src pixels beyond (0xFFFFFFFF, 0xFFFFFFFF) are already outside pb.
+  uint64_t src_max_excl_x =
+      ((uint64_t)dst_x) + ((uint64_t)(src->pixcfg.private_impl.width));
+  uint64_t src_max_excl_y =
+      ((uint64_t)dst_y) + ((uint64_t)(src->pixcfg.private_impl.height));
+  wuffs_base__rect_ie_u32 bounds =
+      wuffs_base__pixel_config__bounds(&pb->pixcfg);
+  wuffs_base__rect_ie_u32 r = wuffs_base__rect_ie_u32__intersect(
+      &bounds, wuffs_base__make_rect_ie_u32(
+                   dst_x, dst_y,
+                   (uint32_t)wuffs_base__u64__min(src_max_excl_x, 0xFFFFFFFF),
+                   (uint32_t)wuffs_base__u64__min(src_max_excl_y, 0xFFFFFFFF)));
+  r = wuffs_base__rect_ie_u32__intersect(&r, clip);
+  if (wuffs_base__rect_ie_u32__is_empty(&r)) {
+    return wuffs_base__make_status(NULL);
+  }
+
+  // For a non-indexed pb, the swizzler still needs somewhere to hold an
+  // indexed src's palette, converted to pb's pixel format.
+  uint8_t scratch[WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH];
+  wuffs_base__slice_u8 dst_palette = wuffs_base__pixel_buffer__palette_or_else(
+      pb, wuffs_base__make_slice_u8(
+              scratch, WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH));
+  wuffs_base__slice_u8 src_palette = wuffs_base__empty_slice_u8();
+  if (wuffs_base__pixel_format__is_indexed(&src->pixcfg.private_impl.pixfmt)) {
+    const wuffs_base__table_u8* tab =
+        &src->private_impl
+             .planes[WUFFS_BASE__PIXEL_FORMAT__INDEXED__COLOR_PLANE];
+    if ((tab->width ==
+         WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) &&
+        (tab->height == 1)) {
+      src_palette = wuffs_base__make_slice_u8(
+          tab->ptr, WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH);
+    }
+  }
+
+  wuffs_base__pixel_swizzler swizzler;
+  wuffs_base__status status = wuffs_base__pixel_swizzler__prepare(
+      &swizzler, pb->pixcfg.private_impl.pixfmt, dst_palette,
+      src->pixcfg.private_impl.pixfmt, src_palette, blend);
+  if (status.repr) {
+    return status;
+  }
+
+  size_t width = (size_t)wuffs_base__rect_ie_u32__width(&r);
+  const wuffs_base__table_u8* dst_tab = &pb->private_impl.planes[0];
+  const wuffs_base__table_u8* src_tab = &src->private_impl.planes[0];
+  uint8_t* d = dst_tab->ptr + (dst_tab->stride * ((size_t)r.min_incl_y)) +
+               (dst_bytes_per_pixel * ((size_t)r.min_incl_x));
+  uint8_t* s = src_tab->ptr +
+               (src_tab->stride * ((size_t)(r.min_incl_y - dst_y))) +
+               (src_bytes_per_pixel * ((size_t)(r.min_incl_x - dst_x)));
+
+  uint32_t y;
+  for (y = r.min_incl_y; y < r.max_excl_y; y++) {
+    wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(
+        &swizzler, wuffs_base__make_slice_u8(d, dst_bytes_per_pixel * width),
+        dst_palette,
+        wuffs_base__make_slice_u8(s, src_bytes_per_pixel * width));
+    d += dst_tab->stride;
+    s += src_tab->stride;
+  }
+  return wuffs_base__make_status(NULL);
+}
+
+// --------
+
 WUFFS_BASE__MAYBE_STATIC uint8_t  //
 wuffs_base__pixel_palette__closest_element(
     wuffs_base__slice_u8 palette_slice,
@@ -15928,6 +17959,61 @@ wuffs_base__pixel_swizzler__swap_rgb_bgr(uint8_t* dst_ptr,
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__swap_rgbx_bgrx__avx2(uint8_t* dst_ptr,
+                                                 size_t dst_len,
+                                                 uint8_t* dst_palette_ptr,
+                                                 size_t dst_palette_len,
+                                                 const uint8_t* src_ptr,
+                                                 size_t src_len) {
+  size_t len = (dst_len < src_len ? dst_len : src_len) / 4;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  __m256i shuffle = _mm256_set_epi8(+0x0F, +0x0C, +0x0D, +0x0E,  //
+                                    +0x0B, +0x08, +0x09, +0x0A,  //
+                                    +0x07, +0x04, +0x05, +0x06,  //
+                                    +0x03, +0x00, +0x01, +0x02,  //
+                                    +0x0F, +0x0C, +0x0D, +0x0E,  //
+                                    +0x0B, +0x08, +0x09, +0x0A,  //
+                                    +0x07, +0x04, +0x05, +0x06,  //
+                                    +0x03, +0x00, +0x01, +0x02);
+
+  while (n >= 8) {
+    __m256i x;
+    x = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+    x = _mm256_shuffle_epi8(x, shuffle);
+    _mm256_storeu_si256((__m256i*)(void*)d, x);
+
+    s += 8 * 4;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    uint8_t s0 = s[0];
+    uint8_t s1 = s[1];
+    uint8_t s2 = s[2];
+    uint8_t s3 = s[3];
+    d[0] = s2;
+    d[1] = s1;
+    d[2] = s0;
+    d[3] = s3;
+
+    s += 1 * 4;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 // ‼ WUFFS MULTI-FILE SECTION +x86_sse42
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
 WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
@@ -17807,6 +19893,90 @@ wuffs_base__pixel_swizzler__bgra_nonpremul_4x16le__rgba_premul__src_over(
 
 // --------
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src__avx2(
+    uint8_t* dst_ptr,
+    size_t dst_len,
+    uint8_t* dst_palette_ptr,
+    size_t dst_palette_len,
+    const uint8_t* src_ptr,
+    size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len4 = src_len / 4;
+  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  // As per wuffs_base__color_u32_argb_nonpremul__as__color_u32_argb_premul,
+  // each premultiplied color channel is (((c * a * 0x10201) / 0xFFFF) >> 8)
+  // for 8-bit c and a. That equals (mulhi(c * a, 0x8101) >> 7), where
+  // mulhi(x, y) is ((x * y) >> 16), as verified exhaustively over all (c, a)
+  // pairs. Multiplying the alpha channel by 0xFF leaves it unchanged.
+  __m256i zero = _mm256_setzero_si256();
+  __m256i u16_0x8101 = _mm256_set1_epi16(-0x7EFF);
+  __m256i alpha_ff = _mm256_set_epi16(0xFF, 0x00, 0x00, 0x00,  //
+                                      0xFF, 0x00, 0x00, 0x00,  //
+                                      0xFF, 0x00, 0x00, 0x00,  //
+                                      0xFF, 0x00, 0x00, 0x00);
+  __m256i shuffle_lo = _mm256_set_epi8(-0x01, -0x01, -0x01, +0x07,  //
+                                       -0x01, +0x07, -0x01, +0x07,  //
+                                       -0x01, -0x01, -0x01, +0x03,  //
+                                       -0x01, +0x03, -0x01, +0x03,  //
+                                       -0x01, -0x01, -0x01, +0x07,  //
+                                       -0x01, +0x07, -0x01, +0x07,  //
+                                       -0x01, -0x01, -0x01, +0x03,  //
+                                       -0x01, +0x03, -0x01, +0x03);
+  __m256i shuffle_hi = _mm256_set_epi8(-0x01, -0x01, -0x01, +0x0F,  //
+                                       -0x01, +0x0F, -0x01, +0x0F,  //
+                                       -0x01, -0x01, -0x01, +0x0B,  //
+                                       -0x01, +0x0B, -0x01, +0x0B,  //
+                                       -0x01, -0x01, -0x01, +0x0F,  //
+                                       -0x01, +0x0F, -0x01, +0x0F,  //
+                                       -0x01, -0x01, -0x01, +0x0B,  //
+                                       -0x01, +0x0B, -0x01, +0x0B);
+
+  while (n >= 8) {
+    __m256i x = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+
+    // Per 128-bit lane, the multipliers for pixels 0, 1 (a_lo) and 2, 3 (a_hi)
+    // in 16-bit B, G, R, A order: the pixel's alpha, three times, then 0xFF.
+    __m256i a_lo =
+        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle_lo), alpha_ff);
+    __m256i a_hi =
+        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle_hi), alpha_ff);
+
+    __m256i p_lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(x, zero), a_lo);
+    __m256i p_hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(x, zero), a_hi);
+    p_lo = _mm256_srli_epi16(_mm256_mulhi_epu16(p_lo, u16_0x8101), 7);
+    p_hi = _mm256_srli_epi16(_mm256_mulhi_epu16(p_hi, u16_0x8101), 7);
+
+    _mm256_storeu_si256((__m256i*)(void*)d, _mm256_packus_epi16(p_lo, p_hi));
+
+    s += 8 * 4;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4),
+        wuffs_base__color_u32_argb_nonpremul__as__color_u32_argb_premul(s0));
+
+    s += 1 * 4;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 static uint64_t  //
 wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src(
     uint8_t* dst_ptr,
@@ -17838,6 +20008,89 @@ wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src(
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src__avx2(
+    uint8_t* dst_ptr,
+    size_t dst_len,
+    uint8_t* dst_palette_ptr,
+    size_t dst_palette_len,
+    const uint8_t* src_ptr,
+    size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len8 = src_len / 8;
+  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  // As per wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul,
+  // each premultiplied color channel is (((c * a) / 0xFFFF) >> 8) for 16-bit
+  // c and a. For x up to (0xFFFF * 0xFFFF), (x / 0xFFFF) equals
+  // ((x + (x >> 16) + 1) >> 16), as verified exhaustively. Multiplying the
+  // alpha channel by 0xFFFF leaves it unchanged.
+  __m256i shuffle = _mm256_set_epi8(-0x01, -0x01, +0x0F, +0x0E,  //
+                                    +0x0F, +0x0E, +0x0F, +0x0E,  //
+                                    -0x01, -0x01, +0x07, +0x06,  //
+                                    +0x07, +0x06, +0x07, +0x06,  //
+                                    -0x01, -0x01, +0x0F, +0x0E,  //
+                                    +0x0F, +0x0E, +0x0F, +0x0E,  //
+                                    -0x01, -0x01, +0x07, +0x06,  //
+                                    +0x07, +0x06, +0x07, +0x06);
+  __m256i zero = _mm256_setzero_si256();
+  __m256i u32_1 = _mm256_set1_epi32(1);
+  __m256i alpha_ffff = _mm256_set_epi16(-0x01, 0x00, 0x00, 0x00,  //
+                                        -0x01, 0x00, 0x00, 0x00,  //
+                                        -0x01, 0x00, 0x00, 0x00,  //
+                                        -0x01, 0x00, 0x00, 0x00);
+
+  while (n >= 4) {
+    __m256i x = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+    __m256i a =
+        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle), alpha_ffff);
+
+    // Per 128-bit lane, p_lo and p_hi hold pixels 0 and 1 in 32-bit lanes.
+    __m256i p_lo = _mm256_mullo_epi32(_mm256_unpacklo_epi16(x, zero),
+                                      _mm256_unpacklo_epi16(a, zero));
+    __m256i p_hi = _mm256_mullo_epi32(_mm256_unpackhi_epi16(x, zero),
+                                      _mm256_unpackhi_epi16(a, zero));
+    p_lo = _mm256_srli_epi32(
+        _mm256_add_epi32(_mm256_add_epi32(p_lo, _mm256_srli_epi32(p_lo, 16)),
+                         u32_1),
+        24);
+    p_hi = _mm256_srli_epi32(
+        _mm256_add_epi32(_mm256_add_epi32(p_hi, _mm256_srli_epi32(p_hi, 16)),
+                         u32_1),
+        24);
+
+    // Pack to 8-bit channels and gather the low 64 bits of each 128-bit lane.
+    __m256i y = _mm256_packus_epi32(p_lo, p_hi);
+    y = _mm256_permute4x64_epi64(_mm256_packus_epi16(y, y), 0x08);
+    _mm_storeu_si128((__m128i*)(void*)d, _mm256_castsi256_si128(y));
+
+    s += 4 * 8;
+    d += 4 * 4;
+    n -= 4;
+  }
+
+  while (n >= 1) {
+    uint64_t s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4),
+        wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul(s0));
+
+    s += 1 * 8;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 static uint64_t  //
 wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src(
     uint8_t* dst_ptr,
@@ -17934,6 +20187,183 @@ wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src_over(
   return len;
 }
 
+// The SIMD bgra_premul__bgra_premul__src_over implementations work in 16-bit
+// lanes. For each channel (including alpha) with 8-bit values s (src), d (dst)
+// and sa (src alpha), the scalar code computes:
+//
+//   ((0x101 * s) + (((0x101 * d) * (0xFFFF - (0x101 * sa))) / 0xFFFF)) >> 8
+//
+// With p = d * (0xFF - sa), that equals ((0x101 * s) + p + mulhi(p, 514)) >> 8,
+// where mulhi(x, y) is ((x * y) >> 16), and none of the 16-bit additions
+// overflow, provided that the src is validly premultiplied (s <= sa). This
+// was verified exhaustively over all (s, d, sa) triples.
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__avx2(
+    uint8_t* dst_ptr,
+    size_t dst_len,
+    uint8_t* dst_palette_ptr,
+    size_t dst_palette_len,
+    const uint8_t* src_ptr,
+    size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len4 = src_len / 4;
+  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  __m256i zero = _mm256_setzero_si256();
+  __m256i u16_0xFF = _mm256_set1_epi16(0xFF);
+  __m256i u16_514 = _mm256_set1_epi16(514);
+  __m256i shuffle_lo = _mm256_set_epi8(-0x01, +0x07, -0x01, +0x07,  //
+                                       -0x01, +0x07, -0x01, +0x07,  //
+                                       -0x01, +0x03, -0x01, +0x03,  //
+                                       -0x01, +0x03, -0x01, +0x03,  //
+                                       -0x01, +0x07, -0x01, +0x07,  //
+                                       -0x01, +0x07, -0x01, +0x07,  //
+                                       -0x01, +0x03, -0x01, +0x03,  //
+                                       -0x01, +0x03, -0x01, +0x03);
+  __m256i shuffle_hi = _mm256_set_epi8(-0x01, +0x0F, -0x01, +0x0F,  //
+                                       -0x01, +0x0F, -0x01, +0x0F,  //
+                                       -0x01, +0x0B, -0x01, +0x0B,  //
+                                       -0x01, +0x0B, -0x01, +0x0B,  //
+                                       -0x01, +0x0F, -0x01, +0x0F,  //
+                                       -0x01, +0x0F, -0x01, +0x0F,  //
+                                       -0x01, +0x0B, -0x01, +0x0B,  //
+                                       -0x01, +0x0B, -0x01, +0x0B);
+
+  while (n >= 8) {
+    __m256i sx = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+    __m256i dx = _mm256_lddqu_si256((const __m256i*)(const void*)d);
+
+    // The unpack, shuffle and pack instructions work within each 128-bit
+    // lane. Per lane, these are the alphas of pixels 0, 1 (sa_lo) and 2, 3
+    // (sa_hi), spread over the 16-bit B, G, R and A channels.
+    __m256i sa_lo = _mm256_shuffle_epi8(sx, shuffle_lo);
+    __m256i sa_hi = _mm256_shuffle_epi8(sx, shuffle_hi);
+
+    __m256i s_lo = _mm256_unpacklo_epi8(sx, zero);
+    __m256i s_hi = _mm256_unpackhi_epi8(sx, zero);
+    __m256i p_lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(dx, zero),
+                                      _mm256_sub_epi16(u16_0xFF, sa_lo));
+    __m256i p_hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(dx, zero),
+                                      _mm256_sub_epi16(u16_0xFF, sa_hi));
+
+    __m256i o_lo = _mm256_add_epi16(
+        _mm256_add_epi16(_mm256_slli_epi16(s_lo, 8), s_lo),
+        _mm256_add_epi16(p_lo, _mm256_mulhi_epu16(p_lo, u16_514)));
+    __m256i o_hi = _mm256_add_epi16(
+        _mm256_add_epi16(_mm256_slli_epi16(s_hi, 8), s_hi),
+        _mm256_add_epi16(p_hi, _mm256_mulhi_epu16(p_hi, u16_514)));
+
+    _mm256_storeu_si256(
+        (__m256i*)(void*)d,
+        _mm256_packus_epi16(_mm256_srli_epi16(o_lo, 8),
+                            _mm256_srli_epi16(o_hi, 8)));
+
+    s += 8 * 4;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));
+    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4), wuffs_base__composite_premul_premul_u32_axxx(d0, s0));
+
+    s += 1 * 4;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__sse42(
+    uint8_t* dst_ptr,
+    size_t dst_len,
+    uint8_t* dst_palette_ptr,
+    size_t dst_palette_len,
+    const uint8_t* src_ptr,
+    size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len4 = src_len / 4;
+  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  __m128i zero = _mm_setzero_si128();
+  __m128i u16_0xFF = _mm_set1_epi16(0xFF);
+  __m128i u16_514 = _mm_set1_epi16(514);
+  __m128i shuffle_lo = _mm_set_epi8(-0x01, +0x07, -0x01, +0x07,  //
+                                    -0x01, +0x07, -0x01, +0x07,  //
+                                    -0x01, +0x03, -0x01, +0x03,  //
+                                    -0x01, +0x03, -0x01, +0x03);
+  __m128i shuffle_hi = _mm_set_epi8(-0x01, +0x0F, -0x01, +0x0F,  //
+                                    -0x01, +0x0F, -0x01, +0x0F,  //
+                                    -0x01, +0x0B, -0x01, +0x0B,  //
+                                    -0x01, +0x0B, -0x01, +0x0B);
+
+  while (n >= 4) {
+    __m128i sx = _mm_lddqu_si128((const __m128i*)(const void*)s);
+    __m128i dx = _mm_lddqu_si128((const __m128i*)(const void*)d);
+
+    // The alphas of pixels 0, 1 (sa_lo) and 2, 3 (sa_hi), spread over the
+    // 16-bit B, G, R and A channels.
+    __m128i sa_lo = _mm_shuffle_epi8(sx, shuffle_lo);
+    __m128i sa_hi = _mm_shuffle_epi8(sx, shuffle_hi);
+
+    __m128i s_lo = _mm_unpacklo_epi8(sx, zero);
+    __m128i s_hi = _mm_unpackhi_epi8(sx, zero);
+    __m128i p_lo = _mm_mullo_epi16(_mm_unpacklo_epi8(dx, zero),
+                                   _mm_sub_epi16(u16_0xFF, sa_lo));
+    __m128i p_hi = _mm_mullo_epi16(_mm_unpackhi_epi8(dx, zero),
+                                   _mm_sub_epi16(u16_0xFF, sa_hi));
+
+    __m128i o_lo =
+        _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(s_lo, 8), s_lo),
+                      _mm_add_epi16(p_lo, _mm_mulhi_epu16(p_lo, u16_514)));
+    __m128i o_hi =
+        _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(s_hi, 8), s_hi),
+                      _mm_add_epi16(p_hi, _mm_mulhi_epu16(p_hi, u16_514)));
+
+    _mm_storeu_si128(
+        (__m128i*)(void*)d,
+        _mm_packus_epi16(_mm_srli_epi16(o_lo, 8), _mm_srli_epi16(o_hi, 8)));
+
+    s += 4 * 4;
+    d += 4 * 4;
+    n -= 4;
+  }
+
+  while (n >= 1) {
+    uint32_t d0 = wuffs_base__peek_u32le__no_bounds_check(d + (0 * 4));
+    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4));
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4), wuffs_base__composite_premul_premul_u32_axxx(d0, s0));
+
+    s += 1 * 4;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
+
 static uint64_t  //
 wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over(
     uint8_t* dst_ptr,
@@ -18000,6 +20430,97 @@ wuffs_base__pixel_swizzler__bgra_premul__index_bgra_nonpremul__src_over(
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src__avx2(
+    uint8_t* dst_ptr,
+    size_t dst_len,
+    uint8_t* dst_palette_ptr,
+    size_t dst_palette_len,
+    const uint8_t* src_ptr,
+    size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len4 = src_len / 4;
+  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  // See the bgra_premul__bgra_nonpremul__src__avx2 comments. This function
+  // also swaps the R and B channels.
+  __m256i swap = _mm256_set_epi8(+0x0F, +0x0C, +0x0D, +0x0E,  //
+                                 +0x0B, +0x08, +0x09, +0x0A,  //
+                                 +0x07, +0x04, +0x05, +0x06,  //
+                                 +0x03, +0x00, +0x01, +0x02,  //
+                                 +0x0F, +0x0C, +0x0D, +0x0E,  //
+                                 +0x0B, +0x08, +0x09, +0x0A,  //
+                                 +0x07, +0x04, +0x05, +0x06,  //
+                                 +0x03, +0x00, +0x01, +0x02);
+  __m256i zero = _mm256_setzero_si256();
+  __m256i u16_0x8101 = _mm256_set1_epi16(-0x7EFF);
+  __m256i alpha_ff = _mm256_set_epi16(0xFF, 0x00, 0x00, 0x00,  //
+                                      0xFF, 0x00, 0x00, 0x00,  //
+                                      0xFF, 0x00, 0x00, 0x00,  //
+                                      0xFF, 0x00, 0x00, 0x00);
+  __m256i shuffle_lo = _mm256_set_epi8(-0x01, -0x01, -0x01, +0x07,  //
+                                       -0x01, +0x07, -0x01, +0x07,  //
+                                       -0x01, -0x01, -0x01, +0x03,  //
+                                       -0x01, +0x03, -0x01, +0x03,  //
+                                       -0x01, -0x01, -0x01, +0x07,  //
+                                       -0x01, +0x07, -0x01, +0x07,  //
+                                       -0x01, -0x01, -0x01, +0x03,  //
+                                       -0x01, +0x03, -0x01, +0x03);
+  __m256i shuffle_hi = _mm256_set_epi8(-0x01, -0x01, -0x01, +0x0F,  //
+                                       -0x01, +0x0F, -0x01, +0x0F,  //
+                                       -0x01, -0x01, -0x01, +0x0B,  //
+                                       -0x01, +0x0B, -0x01, +0x0B,  //
+                                       -0x01, -0x01, -0x01, +0x0F,  //
+                                       -0x01, +0x0F, -0x01, +0x0F,  //
+                                       -0x01, -0x01, -0x01, +0x0B,  //
+                                       -0x01, +0x0B, -0x01, +0x0B);
+
+  while (n >= 8) {
+    __m256i x = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+    x = _mm256_shuffle_epi8(x, swap);
+
+    // Per 128-bit lane, the multipliers for pixels 0, 1 (a_lo) and 2, 3 (a_hi)
+    // in 16-bit B, G, R, A order: the pixel's alpha, three times, then 0xFF.
+    __m256i a_lo =
+        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle_lo), alpha_ff);
+    __m256i a_hi =
+        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle_hi), alpha_ff);
+
+    __m256i p_lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(x, zero), a_lo);
+    __m256i p_hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(x, zero), a_hi);
+    p_lo = _mm256_srli_epi16(_mm256_mulhi_epu16(p_lo, u16_0x8101), 7);
+    p_hi = _mm256_srli_epi16(_mm256_mulhi_epu16(p_hi, u16_0x8101), 7);
+
+    _mm256_storeu_si256((__m256i*)(void*)d, _mm256_packus_epi16(p_lo, p_hi));
+
+    s += 8 * 4;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    uint32_t s0 = wuffs_base__swap_u32_argb_abgr(
+        wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4),
+        wuffs_base__color_u32_argb_nonpremul__as__color_u32_argb_premul(s0));
+
+    s += 1 * 4;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 static uint64_t  //
 wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src(
     uint8_t* dst_ptr,
@@ -18064,6 +20585,97 @@ wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src_over(
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src__avx2(
+    uint8_t* dst_ptr,
+    size_t dst_len,
+    uint8_t* dst_palette_ptr,
+    size_t dst_palette_len,
+    const uint8_t* src_ptr,
+    size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len8 = src_len / 8;
+  size_t len = (dst_len4 < src_len8) ? dst_len4 : src_len8;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  // See the bgra_premul__bgra_nonpremul_4x16le__src__avx2 comments. This
+  // function also swaps the R and B channels.
+  __m256i swap = _mm256_set_epi8(+0x0F, +0x0E, +0x09, +0x08,  //
+                                 +0x0B, +0x0A, +0x0D, +0x0C,  //
+                                 +0x07, +0x06, +0x01, +0x00,  //
+                                 +0x03, +0x02, +0x05, +0x04,  //
+                                 +0x0F, +0x0E, +0x09, +0x08,  //
+                                 +0x0B, +0x0A, +0x0D, +0x0C,  //
+                                 +0x07, +0x06, +0x01, +0x00,  //
+                                 +0x03, +0x02, +0x05, +0x04);
+  __m256i shuffle = _mm256_set_epi8(-0x01, -0x01, +0x0F, +0x0E,  //
+                                    +0x0F, +0x0E, +0x0F, +0x0E,  //
+                                    -0x01, -0x01, +0x07, +0x06,  //
+                                    +0x07, +0x06, +0x07, +0x06,  //
+                                    -0x01, -0x01, +0x0F, +0x0E,  //
+                                    +0x0F, +0x0E, +0x0F, +0x0E,  //
+                                    -0x01, -0x01, +0x07, +0x06,  //
+                                    +0x07, +0x06, +0x07, +0x06);
+  __m256i zero = _mm256_setzero_si256();
+  __m256i u32_1 = _mm256_set1_epi32(1);
+  __m256i alpha_ffff = _mm256_set_epi16(-0x01, 0x00, 0x00, 0x00,  //
+                                        -0x01, 0x00, 0x00, 0x00,  //
+                                        -0x01, 0x00, 0x00, 0x00,  //
+                                        -0x01, 0x00, 0x00, 0x00);
+
+  while (n >= 4) {
+    __m256i x = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+    x = _mm256_shuffle_epi8(x, swap);
+    __m256i a =
+        _mm256_or_si256(_mm256_shuffle_epi8(x, shuffle), alpha_ffff);
+
+    // Per 128-bit lane, p_lo and p_hi hold pixels 0 and 1 in 32-bit lanes.
+    __m256i p_lo = _mm256_mullo_epi32(_mm256_unpacklo_epi16(x, zero),
+                                      _mm256_unpacklo_epi16(a, zero));
+    __m256i p_hi = _mm256_mullo_epi32(_mm256_unpackhi_epi16(x, zero),
+                                      _mm256_unpackhi_epi16(a, zero));
+    p_lo = _mm256_srli_epi32(
+        _mm256_add_epi32(_mm256_add_epi32(p_lo, _mm256_srli_epi32(p_lo, 16)),
+                         u32_1),
+        24);
+    p_hi = _mm256_srli_epi32(
+        _mm256_add_epi32(_mm256_add_epi32(p_hi, _mm256_srli_epi32(p_hi, 16)),
+                         u32_1),
+        24);
+
+    // Pack to 8-bit channels and gather the low 64 bits of each 128-bit lane.
+    __m256i y = _mm256_packus_epi32(p_lo, p_hi);
+    y = _mm256_permute4x64_epi64(_mm256_packus_epi16(y, y), 0x08);
+    _mm_storeu_si128((__m128i*)(void*)d, _mm256_castsi256_si128(y));
+
+    s += 4 * 8;
+    d += 4 * 4;
+    n -= 4;
+  }
+
+  while (n >= 1) {
+    uint64_t s0 = wuffs_base__peek_u64le__no_bounds_check(s + (0 * 8));
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4),
+        wuffs_base__swap_u32_argb_abgr(
+            wuffs_base__color_u64_argb_nonpremul__as__color_u32_argb_premul(
+                s0)));
+
+    s += 1 * 8;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 static uint64_t  //
 wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src(
     uint8_t* dst_ptr,
@@ -18164,6 +20776,63 @@ wuffs_base__pixel_swizzler__bgra_premul__rgba_premul__src_over(
 
 // --------
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgrw__bgr__avx2(uint8_t* dst_ptr,
+                                            size_t dst_len,
+                                            uint8_t* dst_palette_ptr,
+                                            size_t dst_palette_len,
+                                            const uint8_t* src_ptr,
+                                            size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len3 = src_len / 3;
+  size_t len = (dst_len4 < src_len3) ? dst_len4 : src_len3;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  __m256i shuffle = _mm256_set_epi8(-0x01, +0x0B, +0x0A, +0x09,  //
+                                    -0x01, +0x08, +0x07, +0x06,  //
+                                    -0x01, +0x05, +0x04, +0x03,  //
+                                    -0x01, +0x02, +0x01, +0x00,  //
+                                    -0x01, +0x0B, +0x0A, +0x09,  //
+                                    -0x01, +0x08, +0x07, +0x06,  //
+                                    -0x01, +0x05, +0x04, +0x03,  //
+                                    -0x01, +0x02, +0x01, +0x00);
+  __m256i or_ff = _mm256_set1_epi32(-0x01000000);
+
+  while (n >= 10) {
+    // The second 128-bit lane starts 4 pixels (12 bytes) after the first.
+    __m256i x;
+    x = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_lddqu_si128((const __m128i*)(const void*)s)),
+        _mm_lddqu_si128((const __m128i*)(const void*)(s + (4 * 3))), 1);
+    x = _mm256_shuffle_epi8(x, shuffle);
+    x = _mm256_or_si256(x, or_ff);
+    _mm256_storeu_si256((__m256i*)(void*)d, x);
+
+    s += 8 * 3;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4),
+        0xFF000000 | wuffs_base__peek_u24le__no_bounds_check(s + (0 * 3)));
+
+    s += 1 * 3;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 static uint64_t  //
 wuffs_base__pixel_swizzler__bgrw__bgr(uint8_t* dst_ptr,
                                       size_t dst_len,
@@ -18222,6 +20891,51 @@ wuffs_base__pixel_swizzler__bgrw__bgr_565(uint8_t* dst_ptr,
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgrw__bgrx__avx2(uint8_t* dst_ptr,
+                                             size_t dst_len,
+                                             uint8_t* dst_palette_ptr,
+                                             size_t dst_palette_len,
+                                             const uint8_t* src_ptr,
+                                             size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len4 = src_len / 4;
+  size_t len = (dst_len4 < src_len4) ? dst_len4 : src_len4;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  __m256i or_ff = _mm256_set1_epi32(-0x01000000);
+
+  while (n >= 8) {
+    __m256i x;
+    x = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+    x = _mm256_or_si256(x, or_ff);
+    _mm256_storeu_si256((__m256i*)(void*)d, x);
+
+    s += 8 * 4;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4),
+        0xFF000000 | wuffs_base__peek_u32le__no_bounds_check(s + (0 * 4)));
+
+    s += 1 * 4;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 static uint64_t  //
 wuffs_base__pixel_swizzler__bgrw__bgrx(uint8_t* dst_ptr,
                                        size_t dst_len,
@@ -18251,6 +20965,67 @@ wuffs_base__pixel_swizzler__bgrw__bgrx(uint8_t* dst_ptr,
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__bgrw__rgb__avx2(uint8_t* dst_ptr,
+                                            size_t dst_len,
+                                            uint8_t* dst_palette_ptr,
+                                            size_t dst_palette_len,
+                                            const uint8_t* src_ptr,
+                                            size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len3 = src_len / 3;
+  size_t len = (dst_len4 < src_len3) ? dst_len4 : src_len3;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  __m256i shuffle = _mm256_set_epi8(-0x01, +0x09, +0x0A, +0x0B,  //
+                                    -0x01, +0x06, +0x07, +0x08,  //
+                                    -0x01, +0x03, +0x04, +0x05,  //
+                                    -0x01, +0x00, +0x01, +0x02,  //
+                                    -0x01, +0x09, +0x0A, +0x0B,  //
+                                    -0x01, +0x06, +0x07, +0x08,  //
+                                    -0x01, +0x03, +0x04, +0x05,  //
+                                    -0x01, +0x00, +0x01, +0x02);
+  __m256i or_ff = _mm256_set1_epi32(-0x01000000);
+
+  while (n >= 10) {
+    // The second 128-bit lane starts 4 pixels (12 bytes) after the first.
+    __m256i x;
+    x = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_lddqu_si128((const __m128i*)(const void*)s)),
+        _mm_lddqu_si128((const __m128i*)(const void*)(s + (4 * 3))), 1);
+    x = _mm256_shuffle_epi8(x, shuffle);
+    x = _mm256_or_si256(x, or_ff);
+    _mm256_storeu_si256((__m256i*)(void*)d, x);
+
+    s += 8 * 3;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    uint8_t b0 = s[0];
+    uint8_t b1 = s[1];
+    uint8_t b2 = s[2];
+    d[0] = b2;
+    d[1] = b1;
+    d[2] = b0;
+    d[3] = 0xFF;
+
+    s += 1 * 3;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 // ‼ WUFFS MULTI-FILE SECTION +x86_sse42
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
 WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
@@ -18850,6 +21625,289 @@ wuffs_base__pixel_swizzler__xxx__y_16be(uint8_t* dst_ptr,
 
 // --------
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// wuffs_base__pixel_swizzler__transpose_palette16__sse42 splits the first 16
+// (4 bytes per entry) palette entries into four 16-byte tables, one per
+// channel, for use as _mm_shuffle_epi8 lookup tables.
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static inline void  //
+wuffs_base__pixel_swizzler__transpose_palette16__sse42(
+    __m128i* tab_b,
+    __m128i* tab_g,
+    __m128i* tab_r,
+    __m128i* tab_a,
+    const uint8_t* palette_ptr) {
+  __m128i shuffle = _mm_set_epi8(+0x0F, +0x0B, +0x07, +0x03,  //
+                                 +0x0E, +0x0A, +0x06, +0x02,  //
+                                 +0x0D, +0x09, +0x05, +0x01,  //
+                                 +0x0C, +0x08, +0x04, +0x00);
+  // Each qi holds entries (4*i) to (4*i + 3), grouped by channel.
+  __m128i q0 = _mm_shuffle_epi8(
+      _mm_lddqu_si128((const __m128i*)(const void*)(palette_ptr + 0x00)),
+      shuffle);
+  __m128i q1 = _mm_shuffle_epi8(
+      _mm_lddqu_si128((const __m128i*)(const void*)(palette_ptr + 0x10)),
+      shuffle);
+  __m128i q2 = _mm_shuffle_epi8(
+      _mm_lddqu_si128((const __m128i*)(const void*)(palette_ptr + 0x20)),
+      shuffle);
+  __m128i q3 = _mm_shuffle_epi8(
+      _mm_lddqu_si128((const __m128i*)(const void*)(palette_ptr + 0x30)),
+      shuffle);
+  __m128i bg01 = _mm_unpacklo_epi32(q0, q1);
+  __m128i ra01 = _mm_unpackhi_epi32(q0, q1);
+  __m128i bg23 = _mm_unpacklo_epi32(q2, q3);
+  __m128i ra23 = _mm_unpackhi_epi32(q2, q3);
+  *tab_b = _mm_unpacklo_epi64(bg01, bg23);
+  *tab_g = _mm_unpackhi_epi64(bg01, bg23);
+  *tab_r = _mm_unpacklo_epi64(ra01, ra23);
+  *tab_a = _mm_unpackhi_epi64(ra01, ra23);
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// wuffs_base__pixel_swizzler__transpose_palette16__avx2 is like the sse42
+// version but repeats each table in both 128-bit lanes.
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static inline void  //
+wuffs_base__pixel_swizzler__transpose_palette16__avx2(
+    __m256i* tabs,
+    const uint8_t* palette_ptr) {
+  __m128i tab_b;
+  __m128i tab_g;
+  __m128i tab_r;
+  __m128i tab_a;
+  wuffs_base__pixel_swizzler__transpose_palette16__sse42(
+      &tab_b, &tab_g, &tab_r, &tab_a, palette_ptr);
+  tabs[0] = _mm256_broadcastsi128_si256(tab_b);
+  tabs[1] = _mm256_broadcastsi128_si256(tab_g);
+  tabs[2] = _mm256_broadcastsi128_si256(tab_r);
+  tabs[3] = _mm256_broadcastsi128_si256(tab_a);
+}
+
+// wuffs_base__pixel_swizzler__lookup_palette16__avx2 looks up 32 indexes,
+// each below 16, in the transposed palette tabs. It sets x[0] to the 4-byte
+// pixels for indexes 0 to 7, x[1] for indexes 8 to 15 and so on.
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static inline void  //
+wuffs_base__pixel_swizzler__lookup_palette16__avx2(__m256i* x,
+                                                   const __m256i* tabs,
+                                                   __m256i indexes) {
+  __m256i b = _mm256_shuffle_epi8(tabs[0], indexes);
+  __m256i g = _mm256_shuffle_epi8(tabs[1], indexes);
+  __m256i r = _mm256_shuffle_epi8(tabs[2], indexes);
+  __m256i a = _mm256_shuffle_epi8(tabs[3], indexes);
+  __m256i bg_lo = _mm256_unpacklo_epi8(b, g);
+  __m256i bg_hi = _mm256_unpackhi_epi8(b, g);
+  __m256i ra_lo = _mm256_unpacklo_epi8(r, a);
+  __m256i ra_hi = _mm256_unpackhi_epi8(r, a);
+  // Each 128-bit lane is unpacked separately, so x0 holds pixels 0..3 and
+  // 16..19, x1 holds 4..7 and 20..23, and so on.
+  __m256i x0 = _mm256_unpacklo_epi16(bg_lo, ra_lo);
+  __m256i x1 = _mm256_unpackhi_epi16(bg_lo, ra_lo);
+  __m256i x2 = _mm256_unpacklo_epi16(bg_hi, ra_hi);
+  __m256i x3 = _mm256_unpackhi_epi16(bg_hi, ra_hi);
+  x[0] = _mm256_permute2x128_si256(x0, x1, 0x20);
+  x[1] = _mm256_permute2x128_si256(x2, x3, 0x20);
+  x[2] = _mm256_permute2x128_si256(x0, x1, 0x31);
+  x[3] = _mm256_permute2x128_si256(x2, x3, 0x31);
+}
+
+// wuffs_base__pixel_swizzler__lookup_palette256__avx2 is like
+// wuffs_base__pixel_swizzler__lookup_palette16__avx2 but the indexes can be
+// any value and palette points to all 256 entries.
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static inline void  //
+wuffs_base__pixel_swizzler__lookup_palette256__avx2(__m256i* x,
+                                                    const int* palette,
+                                                    __m256i indexes) {
+  __m128i i_lo = _mm256_castsi256_si128(indexes);
+  __m128i i_hi = _mm256_extracti128_si256(indexes, 1);
+  x[0] = _mm256_i32gather_epi32(palette, _mm256_cvtepu8_epi32(i_lo), 4);
+  x[1] = _mm256_i32gather_epi32(
+      palette, _mm256_cvtepu8_epi32(_mm_srli_si128(i_lo, 8)), 4);
+  x[2] = _mm256_i32gather_epi32(palette, _mm256_cvtepu8_epi32(i_hi), 4);
+  x[3] = _mm256_i32gather_epi32(
+      palette, _mm256_cvtepu8_epi32(_mm_srli_si128(i_hi, 8)), 4);
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__xxxx__index__src__avx2(uint8_t* dst_ptr,
+                                                   size_t dst_len,
+                                                   uint8_t* dst_palette_ptr,
+                                                   size_t dst_palette_len,
+                                                   const uint8_t* src_ptr,
+                                                   size_t src_len) {
+  if (dst_palette_len !=
+      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {
+    return 0;
+  }
+  size_t dst_len4 = dst_len / 4;
+  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  // Runs of 32 indexes that are all below 16 (e.g. from 1, 2 or 4 bit PNGs
+  // or from GIFs with small palettes) are looked up with _mm256_shuffle_epi8
+  // in per-channel tables of the first 16 palette entries. Other runs use
+  // _mm256_i32gather_epi32 on the whole palette.
+  __m256i tabs[4];
+  wuffs_base__pixel_swizzler__transpose_palette16__avx2(tabs, dst_palette_ptr);
+  __m256i high_nibbles = _mm256_set1_epi8(-0x10);
+  const int* palette = (const int*)(const void*)dst_palette_ptr;
+
+  while (n >= 32) {
+    __m256i indexes = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+
+    if (_mm256_testz_si256(indexes, high_nibbles)) {
+      __m256i x[4];
+      wuffs_base__pixel_swizzler__lookup_palette16__avx2(x, tabs, indexes);
+      _mm256_storeu_si256((__m256i*)(void*)(d + (0 * 4)), x[0]);
+      _mm256_storeu_si256((__m256i*)(void*)(d + (8 * 4)), x[1]);
+      _mm256_storeu_si256((__m256i*)(void*)(d + (16 * 4)), x[2]);
+      _mm256_storeu_si256((__m256i*)(void*)(d + (24 * 4)), x[3]);
+
+    } else {
+      __m256i x[4];
+      wuffs_base__pixel_swizzler__lookup_palette256__avx2(x, palette, indexes);
+      _mm256_storeu_si256((__m256i*)(void*)(d + (0 * 4)), x[0]);
+      _mm256_storeu_si256((__m256i*)(void*)(d + (8 * 4)), x[1]);
+      _mm256_storeu_si256((__m256i*)(void*)(d + (16 * 4)), x[2]);
+      _mm256_storeu_si256((__m256i*)(void*)(d + (24 * 4)), x[3]);
+    }
+
+    s += 32 * 1;
+    d += 32 * 4;
+    n -= 32;
+  }
+
+  while (n >= 8) {
+    __m256i x = _mm256_i32gather_epi32(
+        palette,
+        _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(
+            (int64_t)wuffs_base__peek_u64le__no_bounds_check(s))),
+        4);
+    _mm256_storeu_si256((__m256i*)(void*)d, x);
+
+    s += 8 * 1;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4), wuffs_base__peek_u32le__no_bounds_check(
+                         dst_palette_ptr + ((size_t)s[0] * 4)));
+
+    s += 1 * 1;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__xxxx__index__src__sse42(uint8_t* dst_ptr,
+                                                    size_t dst_len,
+                                                    uint8_t* dst_palette_ptr,
+                                                    size_t dst_palette_len,
+                                                    const uint8_t* src_ptr,
+                                                    size_t src_len) {
+  if (dst_palette_len !=
+      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {
+    return 0;
+  }
+  size_t dst_len4 = dst_len / 4;
+  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  // Runs of 16 indexes that are all below 16 are looked up with
+  // _mm_shuffle_epi8 in per-channel tables of the first 16 palette entries.
+  // Other runs fall back to one lookup per pixel.
+  __m128i tab_b;
+  __m128i tab_g;
+  __m128i tab_r;
+  __m128i tab_a;
+  wuffs_base__pixel_swizzler__transpose_palette16__sse42(
+      &tab_b, &tab_g, &tab_r, &tab_a, dst_palette_ptr);
+  __m128i high_nibbles = _mm_set1_epi8(-0x10);
+
+  while (n >= 16) {
+    __m128i indexes = _mm_lddqu_si128((const __m128i*)(const void*)s);
+
+    if (_mm_testz_si128(indexes, high_nibbles)) {
+      __m128i b = _mm_shuffle_epi8(tab_b, indexes);
+      __m128i g = _mm_shuffle_epi8(tab_g, indexes);
+      __m128i r = _mm_shuffle_epi8(tab_r, indexes);
+      __m128i a = _mm_shuffle_epi8(tab_a, indexes);
+      __m128i bg_lo = _mm_unpacklo_epi8(b, g);
+      __m128i bg_hi = _mm_unpackhi_epi8(b, g);
+      __m128i ra_lo = _mm_unpacklo_epi8(r, a);
+      __m128i ra_hi = _mm_unpackhi_epi8(r, a);
+      _mm_storeu_si128((__m128i*)(void*)(d + (0 * 4)),
+                       _mm_unpacklo_epi16(bg_lo, ra_lo));
+      _mm_storeu_si128((__m128i*)(void*)(d + (4 * 4)),
+                       _mm_unpackhi_epi16(bg_lo, ra_lo));
+      _mm_storeu_si128((__m128i*)(void*)(d + (8 * 4)),
+                       _mm_unpacklo_epi16(bg_hi, ra_hi));
+      _mm_storeu_si128((__m128i*)(void*)(d + (12 * 4)),
+                       _mm_unpackhi_epi16(bg_hi, ra_hi));
+
+    } else {
+      size_t i;
+      for (i = 0; i < 16; i += 4) {
+        wuffs_base__poke_u32le__no_bounds_check(
+            d + ((i + 0) * 4), wuffs_base__peek_u32le__no_bounds_check(
+                                   dst_palette_ptr + ((size_t)s[i + 0] * 4)));
+        wuffs_base__poke_u32le__no_bounds_check(
+            d + ((i + 1) * 4), wuffs_base__peek_u32le__no_bounds_check(
+                                   dst_palette_ptr + ((size_t)s[i + 1] * 4)));
+        wuffs_base__poke_u32le__no_bounds_check(
+            d + ((i + 2) * 4), wuffs_base__peek_u32le__no_bounds_check(
+                                   dst_palette_ptr + ((size_t)s[i + 2] * 4)));
+        wuffs_base__poke_u32le__no_bounds_check(
+            d + ((i + 3) * 4), wuffs_base__peek_u32le__no_bounds_check(
+                                   dst_palette_ptr + ((size_t)s[i + 3] * 4)));
+      }
+    }
+
+    s += 16 * 1;
+    d += 16 * 4;
+    n -= 16;
+  }
+
+  while (n >= 1) {
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4), wuffs_base__peek_u32le__no_bounds_check(
+                         dst_palette_ptr + ((size_t)s[0] * 4)));
+
+    s += 1 * 1;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
+
 static uint64_t  //
 wuffs_base__pixel_swizzler__xxxx__index__src(uint8_t* dst_ptr,
                                              size_t dst_len,
@@ -18901,6 +21959,77 @@ wuffs_base__pixel_swizzler__xxxx__index__src(uint8_t* dst_ptr,
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over__avx2(
+    uint8_t* dst_ptr,
+    size_t dst_len,
+    uint8_t* dst_palette_ptr,
+    size_t dst_palette_len,
+    const uint8_t* src_ptr,
+    size_t src_len) {
+  if (dst_palette_len !=
+      WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH) {
+    return 0;
+  }
+  size_t dst_len4 = dst_len / 4;
+  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  // Palette lookups are as per
+  // wuffs_base__pixel_swizzler__xxxx__index__src__avx2.
+  __m256i tabs[4];
+  wuffs_base__pixel_swizzler__transpose_palette16__avx2(tabs, dst_palette_ptr);
+  const int* palette = (const int*)(const void*)dst_palette_ptr;
+  __m256i high_nibbles = _mm256_set1_epi8(-0x10);
+  __m256i zero = _mm256_setzero_si256();
+
+  while (n >= 32) {
+    __m256i indexes = _mm256_lddqu_si256((const __m256i*)(const void*)s);
+
+    __m256i x[4];
+    if (_mm256_testz_si256(indexes, high_nibbles)) {
+      wuffs_base__pixel_swizzler__lookup_palette16__avx2(x, tabs, indexes);
+    } else {
+      wuffs_base__pixel_swizzler__lookup_palette256__avx2(x, palette, indexes);
+    }
+
+    size_t i;
+    for (i = 0; i < 4; i++) {
+      // Keep the dst pixel wherever the palette entry is all zeroes.
+      __m256i keep = _mm256_cmpeq_epi32(x[i], zero);
+      __m256i y =
+          _mm256_lddqu_si256((const __m256i*)(const void*)(d + (i * 32)));
+      _mm256_storeu_si256((__m256i*)(void*)(d + (i * 32)),
+                          _mm256_blendv_epi8(x[i], y, keep));
+    }
+
+    s += 32 * 1;
+    d += 32 * 4;
+    n -= 32;
+  }
+
+  while (n >= 1) {
+    uint32_t s0 = wuffs_base__peek_u32le__no_bounds_check(dst_palette_ptr +
+                                                          ((size_t)s[0] * 4));
+    if (s0) {
+      wuffs_base__poke_u32le__no_bounds_check(d + (0 * 4), s0);
+    }
+
+    s += 1 * 1;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 static uint64_t  //
 wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over(
     uint8_t* dst_ptr,
@@ -18963,6 +22092,59 @@ wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over(
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__xxxx__y__avx2(uint8_t* dst_ptr,
+                                          size_t dst_len,
+                                          uint8_t* dst_palette_ptr,
+                                          size_t dst_palette_len,
+                                          const uint8_t* src_ptr,
+                                          size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t len = (dst_len4 < src_len) ? dst_len4 : src_len;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  __m256i shuffle = _mm256_set_epi8(-0x01, +0x07, +0x07, +0x07,  //
+                                    -0x01, +0x06, +0x06, +0x06,  //
+                                    -0x01, +0x05, +0x05, +0x05,  //
+                                    -0x01, +0x04, +0x04, +0x04,  //
+                                    -0x01, +0x03, +0x03, +0x03,  //
+                                    -0x01, +0x02, +0x02, +0x02,  //
+                                    -0x01, +0x01, +0x01, +0x01,  //
+                                    -0x01, +0x00, +0x00, +0x00);
+  __m256i or_ff = _mm256_set1_epi32(-0x01000000);
+
+  while (n >= 8) {
+    __m256i x;
+    x = _mm256_set1_epi64x(
+        (int64_t)wuffs_base__peek_u64le__no_bounds_check(s + (0 * 1)));
+    x = _mm256_shuffle_epi8(x, shuffle);
+    x = _mm256_or_si256(x, or_ff);
+    _mm256_storeu_si256((__m256i*)(void*)d, x);
+
+    s += 8 * 1;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4), 0xFF000000 | (0x010101 * (uint32_t)s[0]));
+
+    s += 1 * 1;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 // ‼ WUFFS MULTI-FILE SECTION +x86_sse42
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
 WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
@@ -19039,6 +22221,60 @@ wuffs_base__pixel_swizzler__xxxx__y(uint8_t* dst_ptr,
   return len;
 }
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static uint64_t  //
+wuffs_base__pixel_swizzler__xxxx__y_16be__avx2(uint8_t* dst_ptr,
+                                               size_t dst_len,
+                                               uint8_t* dst_palette_ptr,
+                                               size_t dst_palette_len,
+                                               const uint8_t* src_ptr,
+                                               size_t src_len) {
+  size_t dst_len4 = dst_len / 4;
+  size_t src_len2 = src_len / 2;
+  size_t len = (dst_len4 < src_len2) ? dst_len4 : src_len2;
+  uint8_t* d = dst_ptr;
+  const uint8_t* s = src_ptr;
+  size_t n = len;
+
+  __m256i shuffle = _mm256_set_epi8(-0x01, +0x0E, +0x0E, +0x0E,  //
+                                    -0x01, +0x0C, +0x0C, +0x0C,  //
+                                    -0x01, +0x0A, +0x0A, +0x0A,  //
+                                    -0x01, +0x08, +0x08, +0x08,  //
+                                    -0x01, +0x06, +0x06, +0x06,  //
+                                    -0x01, +0x04, +0x04, +0x04,  //
+                                    -0x01, +0x02, +0x02, +0x02,  //
+                                    -0x01, +0x00, +0x00, +0x00);
+  __m256i or_ff = _mm256_set1_epi32(-0x01000000);
+
+  while (n >= 8) {
+    __m256i x;
+    x = _mm256_broadcastsi128_si256(
+        _mm_lddqu_si128((const __m128i*)(const void*)s));
+    x = _mm256_shuffle_epi8(x, shuffle);
+    x = _mm256_or_si256(x, or_ff);
+    _mm256_storeu_si256((__m256i*)(void*)d, x);
+
+    s += 8 * 2;
+    d += 8 * 4;
+    n -= 8;
+  }
+
+  while (n >= 1) {
+    wuffs_base__poke_u32le__no_bounds_check(
+        d + (0 * 4), 0xFF000000 | (0x010101 * (uint32_t)s[0]));
+
+    s += 1 * 2;
+    d += 1 * 4;
+    n -= 1;
+  }
+
+  return len;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 static uint64_t  //
 wuffs_base__pixel_swizzler__xxxx__y_16be(uint8_t* dst_ptr,
                                          size_t dst_len,
@@ -19300,6 +22536,9 @@ wuffs_base__pixel_swizzler__prepare__y(wuffs_base__pixel_swizzler* p,
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:
     case WUFFS_BASE__PIXEL_FORMAT__RGBX:
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      if (wuffs_base__cpu_arch__have_x86_avx2()) {
+        return wuffs_base__pixel_swizzler__xxxx__y__avx2;
+      }
       if (wuffs_base__cpu_arch__have_x86_sse42()) {
         return wuffs_base__pixel_swizzler__xxxx__y__sse42;
       }
@@ -19346,6 +22585,11 @@ wuffs_base__pixel_swizzler__prepare__y_16be(wuffs_base__pixel_swizzler* p,
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:
     case WUFFS_BASE__PIXEL_FORMAT__RGBX:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      if (wuffs_base__cpu_arch__have_x86_avx2()) {
+        return wuffs_base__pixel_swizzler__xxxx__y_16be__avx2;
+      }
+#endif
       return wuffs_base__pixel_swizzler__xxxx__y_16be;
 
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:
@@ -19421,6 +22665,14 @@ wuffs_base__pixel_swizzler__prepare__indexed__bgra_nonpremul(
       }
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;
+          }
+          if (wuffs_base__cpu_arch__have_x86_sse42()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;
+          }
+#endif
           return wuffs_base__pixel_swizzler__xxxx__index__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           return wuffs_base__pixel_swizzler__bgra_nonpremul__index_bgra_nonpremul__src_over;
@@ -19449,6 +22701,14 @@ wuffs_base__pixel_swizzler__prepare__indexed__bgra_nonpremul(
               (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {
             return NULL;
           }
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;
+          }
+          if (wuffs_base__cpu_arch__have_x86_sse42()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;
+          }
+#endif
           return wuffs_base__pixel_swizzler__xxxx__index__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           if (wuffs_base__slice_u8__copy_from_slice(dst_palette, src_palette) !=
@@ -19472,6 +22732,14 @@ wuffs_base__pixel_swizzler__prepare__indexed__bgra_nonpremul(
       }
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;
+          }
+          if (wuffs_base__cpu_arch__have_x86_sse42()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;
+          }
+#endif
           return wuffs_base__pixel_swizzler__xxxx__index__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           return wuffs_base__pixel_swizzler__bgra_nonpremul__index_bgra_nonpremul__src_over;
@@ -19487,6 +22755,14 @@ wuffs_base__pixel_swizzler__prepare__indexed__bgra_nonpremul(
               (WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH / 4)) {
             return NULL;
           }
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;
+          }
+          if (wuffs_base__cpu_arch__have_x86_sse42()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;
+          }
+#endif
           return wuffs_base__pixel_swizzler__xxxx__index__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           if (wuffs_base__pixel_swizzler__swap_rgbx_bgrx(
@@ -19564,8 +22840,21 @@ wuffs_base__pixel_swizzler__prepare__indexed__bgra_binary(
       }
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;
+          }
+          if (wuffs_base__cpu_arch__have_x86_sse42()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;
+          }
+#endif
           return wuffs_base__pixel_swizzler__xxxx__index__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over__avx2;
+          }
+#endif
           return wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over;
       }
       return NULL;
@@ -19610,8 +22899,21 @@ wuffs_base__pixel_swizzler__prepare__indexed__bgra_binary(
       }
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__avx2;
+          }
+          if (wuffs_base__cpu_arch__have_x86_sse42()) {
+            return wuffs_base__pixel_swizzler__xxxx__index__src__sse42;
+          }
+#endif
           return wuffs_base__pixel_swizzler__xxxx__index__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over__avx2;
+          }
+#endif
           return wuffs_base__pixel_swizzler__xxxx__index_binary_alpha__src_over;
       }
       return NULL;
@@ -19669,6 +22971,11 @@ wuffs_base__pixel_swizzler__prepare__bgr(wuffs_base__pixel_swizzler* p,
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:
     case WUFFS_BASE__PIXEL_FORMAT__BGRX:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      if (wuffs_base__cpu_arch__have_x86_avx2()) {
+        return wuffs_base__pixel_swizzler__bgrw__bgr__avx2;
+      }
+#endif
       return wuffs_base__pixel_swizzler__bgrw__bgr;
 
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:
@@ -19683,6 +22990,9 @@ wuffs_base__pixel_swizzler__prepare__bgr(wuffs_base__pixel_swizzler* p,
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:
     case WUFFS_BASE__PIXEL_FORMAT__RGBX:
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      if (wuffs_base__cpu_arch__have_x86_avx2()) {
+        return wuffs_base__pixel_swizzler__bgrw__rgb__avx2;
+      }
       if (wuffs_base__cpu_arch__have_x86_sse42()) {
         return wuffs_base__pixel_swizzler__bgrw__rgb__sse42;
       }
@@ -19739,6 +23049,11 @@ wuffs_base__pixel_swizzler__prepare__bgra_nonpremul(
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src__avx2;
+          }
+#endif
           return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src_over;
@@ -19758,6 +23073,9 @@ wuffs_base__pixel_swizzler__prepare__bgra_nonpremul(
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__avx2;
+          }
           if (wuffs_base__cpu_arch__have_x86_sse42()) {
             return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42;
           }
@@ -19771,6 +23089,11 @@ wuffs_base__pixel_swizzler__prepare__bgra_nonpremul(
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src__avx2;
+          }
+#endif
           return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src_over;
@@ -19832,6 +23155,11 @@ wuffs_base__pixel_swizzler__prepare__bgra_nonpremul_4x16le(
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src__avx2;
+          }
+#endif
           return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul_4x16le__src_over;
@@ -19859,6 +23187,11 @@ wuffs_base__pixel_swizzler__prepare__bgra_nonpremul_4x16le(
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src__avx2;
+          }
+#endif
           return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul_4x16le__src_over;
@@ -19922,6 +23255,14 @@ wuffs_base__pixel_swizzler__prepare__bgra_premul(
         case WUFFS_BASE__PIXEL_BLEND__SRC:
           return wuffs_base__pixel_swizzler__copy_4_4;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__avx2;
+          }
+          if (wuffs_base__cpu_arch__have_x86_sse42()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__sse42;
+          }
+#endif
           return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over;
       }
       return NULL;
@@ -19939,6 +23280,9 @@ wuffs_base__pixel_swizzler__prepare__bgra_premul(
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__avx2;
+          }
           if (wuffs_base__cpu_arch__have_x86_sse42()) {
             return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42;
           }
@@ -19968,6 +23312,11 @@ wuffs_base__pixel_swizzler__prepare__bgrx(wuffs_base__pixel_swizzler* p,
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL:
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      if (wuffs_base__cpu_arch__have_x86_avx2()) {
+        return wuffs_base__pixel_swizzler__bgrw__bgrx__avx2;
+      }
+#endif
       return wuffs_base__pixel_swizzler__bgrw__bgrx;
 
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL_4X16LE:
@@ -20007,6 +23356,9 @@ wuffs_base__pixel_swizzler__prepare__rgb(wuffs_base__pixel_swizzler* p,
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_BINARY:
     case WUFFS_BASE__PIXEL_FORMAT__BGRX:
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      if (wuffs_base__cpu_arch__have_x86_avx2()) {
+        return wuffs_base__pixel_swizzler__bgrw__rgb__avx2;
+      }
       if (wuffs_base__cpu_arch__have_x86_sse42()) {
         return wuffs_base__pixel_swizzler__bgrw__rgb__sse42;
       }
@@ -20023,6 +23375,11 @@ wuffs_base__pixel_swizzler__prepare__rgb(wuffs_base__pixel_swizzler* p,
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_BINARY:
     case WUFFS_BASE__PIXEL_FORMAT__RGBX:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      if (wuffs_base__cpu_arch__have_x86_avx2()) {
+        return wuffs_base__pixel_swizzler__bgrw__bgr__avx2;
+      }
+#endif
       return wuffs_base__pixel_swizzler__bgrw__bgr;
   }
   return NULL;
@@ -20058,6 +23415,9 @@ wuffs_base__pixel_swizzler__prepare__rgba_nonpremul(
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__avx2;
+          }
           if (wuffs_base__cpu_arch__have_x86_sse42()) {
             return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42;
           }
@@ -20080,6 +23440,11 @@ wuffs_base__pixel_swizzler__prepare__rgba_nonpremul(
     case WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL:
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src__avx2;
+          }
+#endif
           return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           return wuffs_base__pixel_swizzler__bgra_premul__rgba_nonpremul__src_over;
@@ -20107,6 +23472,11 @@ wuffs_base__pixel_swizzler__prepare__rgba_nonpremul(
     case WUFFS_BASE__PIXEL_FORMAT__RGBA_PREMUL:
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src__avx2;
+          }
+#endif
           return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
           return wuffs_base__pixel_swizzler__bgra_premul__bgra_nonpremul__src_over;
@@ -20169,6 +23539,9 @@ wuffs_base__pixel_swizzler__prepare__rgba_premul(
       switch (blend) {
         case WUFFS_BASE__PIXEL_BLEND__SRC:
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__avx2;
+          }
           if (wuffs_base__cpu_arch__have_x86_sse42()) {
             return wuffs_base__pixel_swizzler__swap_rgbx_bgrx__sse42;
           }
@@ -20193,6 +23566,14 @@ wuffs_base__pixel_swizzler__prepare__rgba_premul(
         case WUFFS_BASE__PIXEL_BLEND__SRC:
           return wuffs_base__pixel_swizzler__copy_4_4;
         case WUFFS_BASE__PIXEL_BLEND__SRC_OVER:
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+          if (wuffs_base__cpu_arch__have_x86_avx2()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__avx2;
+          }
+          if (wuffs_base__cpu_arch__have_x86_sse42()) {
+            return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__sse42;
+          }
+#endif
           return wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over;
       }
       return NULL;
@@ -20216,6 +23597,7 @@ wuffs_base__pixel_swizzler__prepare(wuffs_base__pixel_swizzler* p,
   p->private_impl.transparent_black_func = NULL;
   p->private_impl.dst_pixfmt_bytes_per_pixel = 0;
   p->private_impl.src_pixfmt_bytes_per_pixel = 0;
+  p->private_impl.downscale_func = NULL;
 
   wuffs_base__pixel_swizzler__func func = NULL;
   wuffs_base__pixel_swizzler__transparent_black_func transparent_black_func =
@@ -20326,6 +23708,165 @@ wuffs_base__pixel_swizzler__prepare(wuffs_base__pixel_swizzler* p,
       func ? NULL : wuffs_base__error__unsupported_pixel_swizzler_option);
 }
 
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status  //
+wuffs_base__pixel_swizzler__prepare_downscaled(
+    wuffs_base__pixel_swizzler* p,
+    wuffs_base__pixel_format dst_pixfmt,
+    wuffs_base__slice_u8 dst_palette,
+    wuffs_base__pixel_format src_pixfmt,
+    wuffs_base__slice_u8 src_palette,
+    wuffs_base__pixel_blend blend) {
+  wuffs_base__pixel_format premul =
+      wuffs_base__make_pixel_format(WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL);
+
+  // The second half converts the averaged pixels to the dst pixel format.
+  wuffs_base__pixel_swizzler q;
+  wuffs_base__status status = wuffs_base__pixel_swizzler__prepare(
+      &q, dst_pixfmt, dst_palette, premul, wuffs_base__empty_slice_u8(),
+      blend);
+  if (status.repr) {
+    if (p) {
+      p->private_impl.func = NULL;
+      p->private_impl.downscale_func = NULL;
+    }
+    return status;
+  }
+
+  // The first half converts the src pixels to premultiplied BGRA, which can
+  // be summed channel by channel.
+  status = wuffs_base__pixel_swizzler__prepare(
+      p, premul, dst_palette, src_pixfmt, src_palette,
+      WUFFS_BASE__PIXEL_BLEND__SRC);
+  if (status.repr) {
+    return status;
+  }
+  p->private_impl.transparent_black_func = q.private_impl.transparent_black_func;
+  p->private_impl.dst_pixfmt_bytes_per_pixel =
+      q.private_impl.dst_pixfmt_bytes_per_pixel;
+  p->private_impl.downscale_func = q.private_impl.func;
+  return wuffs_base__make_status(NULL);
+}
+
+WUFFS_BASE__MAYBE_STATIC uint64_t  //
+wuffs_base__pixel_swizzler__swizzle_downscaled_from_slice(
+    const wuffs_base__pixel_swizzler* p,
+    wuffs_base__table_u8 dst,
+    wuffs_base__slice_u8 dst_palette,
+    wuffs_base__slice_u8 accum,
+    wuffs_base__slice_u8 src,
+    uint32_t shift,
+    uint32_t x,
+    uint32_t y,
+    uint32_t y0,
+    uint32_t y1) {
+  if (!p || !p->private_impl.func || !p->private_impl.downscale_func ||
+      (shift > 3) || (y < y0) || (y >= y1)) {
+    return 0;
+  }
+  size_t src_bytes_per_pixel = p->private_impl.src_pixfmt_bytes_per_pixel;
+  if (src_bytes_per_pixel == 0) {
+    return 0;
+  }
+  uint64_t n = src.len / src_bytes_per_pixel;
+  if ((n == 0) || (n > (((uint64_t)UINT32_MAX) - ((uint64_t)x)))) {
+    return 0;
+  }
+
+  // The source pixels are columns [x, x_end). They map to the destination
+  // columns [dx0, dx0 + num_dx). Rows [by0, by1) map to the destination row
+  // (y >> shift).
+  uint64_t x_end = ((uint64_t)x) + n;
+  uint64_t dx0 = ((uint64_t)x) >> shift;
+  uint64_t num_dx = ((x_end - 1) >> shift) + 1 - dx0;
+  if ((accum.len / 8) < num_dx) {
+    return 0;
+  }
+  uint64_t block_y = ((uint64_t)(y >> shift)) << shift;
+  uint64_t by0 = wuffs_base__u64__max(y0, block_y);
+  uint64_t by1 = wuffs_base__u64__min(y1, block_y + (1u << shift));
+  if (y == by0) {
+    memset(accum.ptr, 0, (size_t)(8 * num_dx));
+  }
+
+  // Convert the src pixels to premultiplied BGRA, a chunk at a time, and add
+  // them to the accumulators, which are pairs of little-endian bytes.
+  uint8_t buf[64 * 4];
+  const uint8_t* s = src.ptr;
+  uint64_t sx = x;
+  while (sx < x_end) {
+    size_t m = (size_t)(wuffs_base__u64__min(x_end - sx, 64));
+    (*p->private_impl.func)(buf, sizeof(buf), dst_palette.ptr, dst_palette.len,
+                            s, m * src_bytes_per_pixel);
+    size_t i;
+    for (i = 0; i < m; i++) {
+      uint8_t* a = accum.ptr + (8 * (((sx + i) >> shift) - dx0));
+      wuffs_base__poke_u16le__no_bounds_check(
+          a + 0, (uint16_t)(wuffs_base__peek_u16le__no_bounds_check(a + 0) +
+                            buf[(4 * i) + 0]));
+      wuffs_base__poke_u16le__no_bounds_check(
+          a + 2, (uint16_t)(wuffs_base__peek_u16le__no_bounds_check(a + 2) +
+                            buf[(4 * i) + 1]));
+      wuffs_base__poke_u16le__no_bounds_check(
+          a + 4, (uint16_t)(wuffs_base__peek_u16le__no_bounds_check(a + 4) +
+                            buf[(4 * i) + 2]));
+      wuffs_base__poke_u16le__no_bounds_check(
+          a + 6, (uint16_t)(wuffs_base__peek_u16le__no_bounds_check(a + 6) +
+                            buf[(4 * i) + 3]));
+    }
+    s += m * src_bytes_per_pixel;
+    sx += m;
+  }
+  if ((((uint64_t)y) + 1) != by1) {
+    return n;
+  }
+
+  // That was the block's last row. Divide the sums by the number of source
+  // pixels in each block (fewer at the edges) and convert to the dst format.
+  wuffs_base__slice_u8 row = wuffs_base__table_u8__row(dst, y >> shift);
+  uint64_t dst_bytes_per_pixel = p->private_impl.dst_pixfmt_bytes_per_pixel;
+  if ((dst_bytes_per_pixel == 0) ||
+      ((row.len / dst_bytes_per_pixel) <= dx0)) {
+    return n;
+  }
+  row.ptr += dx0 * dst_bytes_per_pixel;
+  row.len -= dx0 * dst_bytes_per_pixel;
+  uint64_t num_rows = by1 - by0;
+  uint64_t dx = 0;
+  while (dx < num_dx) {
+    size_t m = (size_t)(wuffs_base__u64__min(num_dx - dx, 64));
+    size_t i;
+    for (i = 0; i < m; i++) {
+      uint64_t cx = (dx0 + dx + i) << shift;
+      uint64_t num_cols =
+          wuffs_base__u64__min(x_end, cx + (1u << shift)) -
+          wuffs_base__u64__max(x, cx);
+      uint32_t count = (uint32_t)(num_cols * num_rows);
+      const uint8_t* a = accum.ptr + (8 * (dx + i));
+      buf[(4 * i) + 0] = (uint8_t)(
+          (wuffs_base__peek_u16le__no_bounds_check(a + 0) + (count / 2)) /
+          count);
+      buf[(4 * i) + 1] = (uint8_t)(
+          (wuffs_base__peek_u16le__no_bounds_check(a + 2) + (count / 2)) /
+          count);
+      buf[(4 * i) + 2] = (uint8_t)(
+          (wuffs_base__peek_u16le__no_bounds_check(a + 4) + (count / 2)) /
+          count);
+      buf[(4 * i) + 3] = (uint8_t)(
+          (wuffs_base__peek_u16le__no_bounds_check(a + 6) + (count / 2)) /
+          count);
+    }
+    uint64_t k = (*p->private_impl.downscale_func)(
+        row.ptr, row.len, dst_palette.ptr, dst_palette.len, buf, 4 * m);
+    if (k < m) {
+      break;
+    }
+    row.ptr += k * dst_bytes_per_pixel;
+    row.len -= k * dst_bytes_per_pixel;
+    dx += k;
+  }
+  return n;
+}
+
 WUFFS_BASE__MAYBE_STATIC uint64_t  //
 wuffs_base__pixel_swizzler__limited_swizzle_u32_interleaved_from_reader(
     const wuffs_base__pixel_swizzler* p,
@@ -20651,6 +24192,13 @@ wuffs_adler32__hasher__up_arm_neon(
     wuffs_base__slice_u8 a_x);
 #endif  // defined(WUFFS_BASE__CPU_ARCH__ARM_NEON)
 
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+static wuffs_base__empty_struct
+wuffs_adler32__hasher__up_x86_avx2(
+    wuffs_adler32__hasher* self,
+    wuffs_base__slice_u8 a_x);
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
 static wuffs_base__empty_struct
 wuffs_adler32__hasher__up_x86_sse42(
@@ -20772,6 +24320,9 @@ wuffs_adler32__hasher__update_u32(
 #if defined(WUFFS_BASE__CPU_ARCH__ARM_NEON)
         wuffs_base__cpu_arch__have_arm_neon() ? &wuffs_adler32__hasher__up_arm_neon :
 #endif
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+        wuffs_base__cpu_arch__have_x86_avx2() ? &wuffs_adler32__hasher__up_x86_avx2 :
+#endif
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
         wuffs_base__cpu_arch__have_x86_sse42() ? &wuffs_adler32__hasher__up_x86_sse42 :
 #endif
@@ -20781,6 +24332,43 @@ wuffs_adler32__hasher__update_u32(
   return self->private_impl.f_state;
 }
 
+// -------- func adler32.hasher.combine_u32
+
+WUFFS_BASE__MAYBE_STATIC uint32_t
+wuffs_adler32__hasher__combine_u32(
+    const wuffs_adler32__hasher* self,
+    uint32_t a_adler_a,
+    uint32_t a_adler_b,
+    uint64_t a_length_b) {
+  if (!self) {
+    return 0;
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return 0;
+  }
+
+  uint64_t v_r = 0;
+  uint64_t v_s1a = 0;
+  uint64_t v_s2a = 0;
+  uint64_t v_s1b = 0;
+  uint64_t v_s2b = 0;
+  uint64_t v_s1 = 0;
+  uint64_t v_s2 = 0;
+
+  v_r = (a_length_b % 65521);
+  v_s1a = (((uint64_t)(((a_adler_a) & 0xFFFF))) % 65521);
+  v_s2a = (((uint64_t)(((a_adler_a) >> (32 - (16))))) % 65521);
+  v_s1b = (((uint64_t)(((a_adler_b) & 0xFFFF))) % 65521);
+  v_s2b = (((uint64_t)(((a_adler_b) >> (32 - (16))))) % 65521);
+  v_s1 = ((v_s1a + v_s1b + 65520) % 65521);
+  v_s2 = (((v_s2a +
+      v_s2b +
+      (v_r * v_s1a) +
+      65521) - v_r) % 65521);
+  return ((uint32_t)(((v_s2 << 16) | v_s1)));
+}
+
 // -------- func adler32.hasher.up
 
 static wuffs_base__empty_struct
@@ -20961,6 +24549,98 @@ wuffs_adler32__hasher__up_arm_neon(
 #endif  // defined(WUFFS_BASE__CPU_ARCH__ARM_NEON)
 // ‼ WUFFS MULTI-FILE SECTION -arm_neon
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx2
+// -------- func adler32.hasher.up_x86_avx2
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2")
+static wuffs_base__empty_struct
+wuffs_adler32__hasher__up_x86_avx2(
+    wuffs_adler32__hasher* self,
+    wuffs_base__slice_u8 a_x) {
+  uint32_t v_s1 = 0;
+  uint32_t v_s2 = 0;
+  wuffs_base__slice_u8 v_remaining = {0};
+  wuffs_base__slice_u8 v_p = {0};
+  __m256i v_zeroes = {0};
+  __m256i v_ones = {0};
+  __m256i v_weights = {0};
+  __m256i v_q = {0};
+  __m256i v_v1 = {0};
+  __m256i v_v2 = {0};
+  __m256i v_v2j = {0};
+  __m256i v_v2k = {0};
+  __m128i v_h1 = {0};
+  __m128i v_h2 = {0};
+  uint32_t v_num_iterate_bytes = 0;
+  uint64_t v_tail_index = 0;
+
+  v_zeroes = _mm256_set1_epi16((int16_t)(0));
+  v_ones = _mm256_set1_epi16((int16_t)(1));
+  v_weights = _mm256_set_epi8((int8_t)(1), (int8_t)(2), (int8_t)(3), (int8_t)(4), (int8_t)(5), (int8_t)(6), (int8_t)(7), (int8_t)(8), (int8_t)(9), (int8_t)(10), (int8_t)(11), (int8_t)(12), (int8_t)(13), (int8_t)(14), (int8_t)(15), (int8_t)(16), (int8_t)(17), (int8_t)(18), (int8_t)(19), (int8_t)(20), (int8_t)(21), (int8_t)(22), (int8_t)(23), (int8_t)(24), (int8_t)(25), (int8_t)(26), (int8_t)(27), (int8_t)(28), (int8_t)(29), (int8_t)(30), (int8_t)(31), (int8_t)(32));
+  v_s1 = ((self->private_impl.f_state) & 0xFFFF);
+  v_s2 = ((self->private_impl.f_state) >> (32 - (16)));
+  while (((uint64_t)(a_x.len)) > 0) {
+    v_remaining = wuffs_base__slice_u8__subslice_j(a_x, 0);
+    if (((uint64_t)(a_x.len)) > 5536) {
+      v_remaining = wuffs_base__slice_u8__subslice_i(a_x, 5536);
+      a_x = wuffs_base__slice_u8__subslice_j(a_x, 5536);
+    }
+    v_num_iterate_bytes = ((uint32_t)((((uint64_t)(a_x.len)) & 4294967264)));
+    v_s2 += ((uint32_t)(v_s1 * v_num_iterate_bytes));
+    v_v1 = _mm256_setzero_si256();
+    v_v2j = _mm256_setzero_si256();
+    v_v2k = _mm256_setzero_si256();
+    {
+      wuffs_base__slice_u8 i_slice_p = a_x;
+      v_p.ptr = i_slice_p.ptr;
+      v_p.len = 32;
+      uint8_t* i_end0_p = v_p.ptr + (((i_slice_p.len - (size_t)(v_p.ptr - i_slice_p.ptr)) / 32) * 32);
+      while (v_p.ptr < i_end0_p) {
+        v_q = _mm256_lddqu_si256((const __m256i*)(const void*)(v_p.ptr));
+        v_v2j = _mm256_add_epi32(v_v2j, v_v1);
+        v_v1 = _mm256_add_epi32(v_v1, _mm256_sad_epu8(v_q, v_zeroes));
+        v_v2k = _mm256_add_epi32(v_v2k, _mm256_madd_epi16(v_ones, _mm256_maddubs_epi16(v_q, v_weights)));
+        v_p.ptr += 32;
+      }
+      v_p.len = 0;
+    }
+    v_h1 = _mm256_extracti128_si256(v_v1, (int32_t)(0));
+    v_h1 = _mm_add_epi32(v_h1, _mm256_extracti128_si256(v_v1, (int32_t)(1)));
+    v_h1 = _mm_add_epi32(v_h1, _mm_shuffle_epi32(v_h1, (int32_t)(177)));
+    v_h1 = _mm_add_epi32(v_h1, _mm_shuffle_epi32(v_h1, (int32_t)(78)));
+    v_s1 += ((uint32_t)(_mm_cvtsi128_si32(v_h1)));
+    v_v2 = _mm256_add_epi32(v_v2k, _mm256_slli_epi32(v_v2j, (int32_t)(5)));
+    v_h2 = _mm256_extracti128_si256(v_v2, (int32_t)(0));
+    v_h2 = _mm_add_epi32(v_h2, _mm256_extracti128_si256(v_v2, (int32_t)(1)));
+    v_h2 = _mm_add_epi32(v_h2, _mm_shuffle_epi32(v_h2, (int32_t)(177)));
+    v_h2 = _mm_add_epi32(v_h2, _mm_shuffle_epi32(v_h2, (int32_t)(78)));
+    v_s2 += ((uint32_t)(_mm_cvtsi128_si32(v_h2)));
+    v_tail_index = (((uint64_t)(a_x.len)) & 18446744073709551584u);
+    if (v_tail_index < ((uint64_t)(a_x.len))) {
+      {
+        wuffs_base__slice_u8 i_slice_p = wuffs_base__slice_u8__subslice_i(a_x, v_tail_index);
+        v_p.ptr = i_slice_p.ptr;
+        v_p.len = 1;
+        uint8_t* i_end0_p = i_slice_p.ptr + i_slice_p.len;
+        while (v_p.ptr < i_end0_p) {
+          v_s1 += ((uint32_t)(v_p.ptr[0]));
+          v_s2 += v_s1;
+          v_p.ptr += 1;
+        }
+        v_p.len = 0;
+      }
+    }
+    v_s1 %= 65521;
+    v_s2 %= 65521;
+    a_x = v_remaining;
+  }
+  self->private_impl.f_state = (((v_s2 & 65535) << 16) | (v_s1 & 65535));
+  return wuffs_base__make_empty_struct();
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx2
+
 // ‼ WUFFS MULTI-FILE SECTION +x86_sse42
 // -------- func adler32.hasher.up_x86_sse42
 
@@ -21062,6 +24742,7 @@ wuffs_adler32__hasher__up_x86_sse42(
 const char wuffs_bmp__error__bad_header[] = "#bmp: bad header";
 const char wuffs_bmp__error__bad_rle_compression[] = "#bmp: bad RLE compression";
 const char wuffs_bmp__error__unsupported_bmp_file[] = "#bmp: unsupported BMP file";
+const char wuffs_bmp__error__internal_error_inconsistent_skip_length[] = "#bmp: internal error: inconsistent skip length";
 const char wuffs_bmp__note__internal_note_short_read[] = "@bmp: internal note: short read";
 
 // ---------------- Private Consts
@@ -21122,6 +24803,28 @@ wuffs_bmp__decoder__swizzle_low_bit_depth(
     wuffs_base__pixel_buffer* a_dst,
     wuffs_base__io_buffer* a_src);
 
+static bool
+wuffs_bmp__decoder__is_before_roi(
+    const wuffs_bmp__decoder* self);
+
+static bool
+wuffs_bmp__decoder__is_past_roi(
+    const wuffs_bmp__decoder* self);
+
+static wuffs_base__slice_u8
+wuffs_bmp__decoder__roi_row(
+    const wuffs_bmp__decoder* self,
+    wuffs_base__table_u8 a_tab,
+    uint64_t a_dst_bytes_per_pixel);
+
+static wuffs_base__empty_struct
+wuffs_bmp__decoder__swizzle_from_scratch(
+    wuffs_bmp__decoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_dst_palette,
+    uint64_t a_length,
+    uint64_t a_src_bytes_per_pixel);
+
 static wuffs_base__status
 wuffs_bmp__decoder__read_palette(
     wuffs_bmp__decoder* self,
@@ -22130,6 +25833,10 @@ wuffs_bmp__decoder__decode_image_config(
     } else if (self->private_impl.f_bits_per_pixel == 32) {
       self->private_impl.f_pad_per_row = 0;
     }
+    self->private_impl.f_roi_x0 = 0;
+    self->private_impl.f_roi_y0 = 0;
+    self->private_impl.f_roi_x1 = 4294967295;
+    self->private_impl.f_roi_y1 = 4294967295;
     self->private_impl.f_frame_config_io_position = wuffs_base__u64__sat_add(a_src->meta.pos, ((uint64_t)(iop_a_src - io0_a_src)));
     if (a_dst != NULL) {
       v_dst_pixfmt = 2164295816;
@@ -22312,6 +26019,7 @@ wuffs_bmp__decoder__decode_frame(
   wuffs_base__status status = wuffs_base__make_status(NULL);
 
   wuffs_base__status v_status = wuffs_base__make_status(NULL);
+  uint64_t v_bytes_per_row = 0;
 
   const uint8_t* iop_a_src = NULL;
   const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
@@ -22327,6 +26035,7 @@ wuffs_bmp__decoder__decode_frame(
   uint32_t coro_susp_point = self->private_impl.p_decode_frame[0];
   if (coro_susp_point) {
     v_status = self->private_data.s_decode_frame[0].v_status;
+    v_bytes_per_row = self->private_data.s_decode_frame[0].v_bytes_per_row;
   }
   switch (coro_susp_point) {
     WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
@@ -22357,6 +26066,16 @@ wuffs_bmp__decoder__decode_frame(
       goto suspend;
     }
     iop_a_src += self->private_data.s_decode_frame[0].scratch;
+    self->private_impl.f_roi_x0 = 0;
+    self->private_impl.f_roi_y0 = 0;
+    self->private_impl.f_roi_x1 = 4294967295;
+    self->private_impl.f_roi_y1 = 4294967295;
+    if (a_opts != NULL) {
+      self->private_impl.f_roi_x0 = wuffs_base__decode_frame_options__roi_min_incl_x(a_opts);
+      self->private_impl.f_roi_y0 = wuffs_base__decode_frame_options__roi_min_incl_y(a_opts);
+      self->private_impl.f_roi_x1 = wuffs_base__decode_frame_options__roi_max_excl_x(a_opts);
+      self->private_impl.f_roi_y1 = wuffs_base__decode_frame_options__roi_max_excl_y(a_opts);
+    }
     if ((self->private_impl.f_width > 0) && (self->private_impl.f_height > 0)) {
       self->private_impl.f_dst_x = 0;
       if (self->private_impl.f_top_down) {
@@ -22366,6 +26085,26 @@ wuffs_bmp__decoder__decode_frame(
         self->private_impl.f_dst_y = ((uint32_t)(self->private_impl.f_height - 1));
         self->private_impl.f_dst_y_inc = 4294967295;
       }
+      if ((self->private_impl.f_compression == 0) || (self->private_impl.f_compression == 3) || (self->private_impl.f_compression == 256)) {
+        v_bytes_per_row = ((((((uint64_t)(self->private_impl.f_width)) * ((uint64_t)((self->private_impl.f_bits_per_pixel & 255)))) + 31) / 32) * 4);
+        while ((self->private_impl.f_dst_y < self->private_impl.f_height) && wuffs_bmp__decoder__is_before_roi(self)) {
+          self->private_data.s_decode_frame[0].scratch = v_bytes_per_row;
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+          if (self->private_data.s_decode_frame[0].scratch > ((uint64_t)(io2_a_src - iop_a_src))) {
+            self->private_data.s_decode_frame[0].scratch -= ((uint64_t)(io2_a_src - iop_a_src));
+            iop_a_src = io2_a_src;
+            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+            goto suspend;
+          }
+          iop_a_src += self->private_data.s_decode_frame[0].scratch;
+          self->private_impl.f_dst_y += self->private_impl.f_dst_y_inc;
+        }
+        if ((self->private_impl.f_dst_y >= self->private_impl.f_height) || wuffs_bmp__decoder__is_past_roi(self)) {
+          self->private_impl.f_call_sequence = 255;
+          status = wuffs_base__make_status(NULL);
+          goto ok;
+        }
+      }
       v_status = wuffs_base__pixel_swizzler__prepare(&self->private_impl.f_swizzler,
           wuffs_base__pixel_buffer__pixel_format(a_dst),
           wuffs_base__pixel_buffer__palette_or_else(a_dst, wuffs_base__make_slice_u8((self->private_data.f_scratch) + 1024, 1024)),
@@ -22429,11 +26168,11 @@ wuffs_bmp__decoder__decode_frame(
           goto ok;
         }
         status = wuffs_base__make_status(wuffs_base__suspension__short_read);
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(3);
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(4);
       }
       label__0__break:;
       self->private_data.s_decode_frame[0].scratch = self->private_impl.f_pending_pad;
-      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(5);
       if (self->private_data.s_decode_frame[0].scratch > ((uint64_t)(io2_a_src - iop_a_src))) {
         self->private_data.s_decode_frame[0].scratch -= ((uint64_t)(io2_a_src - iop_a_src));
         iop_a_src = io2_a_src;
@@ -22455,6 +26194,7 @@ wuffs_bmp__decoder__decode_frame(
   self->private_impl.p_decode_frame[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
   self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 3 : 0;
   self->private_data.s_decode_frame[0].v_status = v_status;
+  self->private_data.s_decode_frame[0].v_bytes_per_row = v_bytes_per_row;
 
   goto exit;
   exit:
@@ -22480,12 +26220,13 @@ wuffs_bmp__decoder__swizzle_none(
   wuffs_base__pixel_format v_dst_pixfmt = {0};
   uint32_t v_dst_bits_per_pixel = 0;
   uint64_t v_dst_bytes_per_pixel = 0;
-  uint64_t v_dst_bytes_per_row = 0;
   wuffs_base__slice_u8 v_dst_palette = {0};
   wuffs_base__table_u8 v_tab = {0};
   wuffs_base__slice_u8 v_dst = {0};
   uint64_t v_i = 0;
   uint64_t v_n = 0;
+  uint32_t v_src_bytes_per_pixel = 0;
+  uint32_t v_skip = 0;
 
   const uint8_t* iop_a_src = NULL;
   const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
@@ -22505,9 +26246,14 @@ wuffs_bmp__decoder__swizzle_none(
     goto exit;
   }
   v_dst_bytes_per_pixel = ((uint64_t)((v_dst_bits_per_pixel / 8)));
-  v_dst_bytes_per_row = (((uint64_t)(self->private_impl.f_width)) * v_dst_bytes_per_pixel);
   v_dst_palette = wuffs_base__pixel_buffer__palette_or_else(a_dst, wuffs_base__make_slice_u8((self->private_data.f_scratch) + 1024, 1024));
   v_tab = wuffs_base__pixel_buffer__plane(a_dst, 0);
+  v_src_bytes_per_pixel = 1;
+  if (self->private_impl.f_bits_per_pixel == 24) {
+    v_src_bytes_per_pixel = 3;
+  } else if (self->private_impl.f_bits_per_pixel == 32) {
+    v_src_bytes_per_pixel = 4;
+  }
   label__outer__continue:;
   while (true) {
     while (self->private_impl.f_pending_pad > 0) {
@@ -22523,7 +26269,7 @@ wuffs_bmp__decoder__swizzle_none(
       if (self->private_impl.f_dst_x == self->private_impl.f_width) {
         self->private_impl.f_dst_x = 0;
         self->private_impl.f_dst_y += self->private_impl.f_dst_y_inc;
-        if (self->private_impl.f_dst_y >= self->private_impl.f_height) {
+        if ((self->private_impl.f_dst_y >= self->private_impl.f_height) || wuffs_bmp__decoder__is_past_roi(self)) {
           if (self->private_impl.f_height > 0) {
             self->private_impl.f_pending_pad = self->private_impl.f_pad_per_row;
           }
@@ -22533,25 +26279,45 @@ wuffs_bmp__decoder__swizzle_none(
           goto label__outer__continue;
         }
       }
-      v_dst = wuffs_base__table_u8__row(v_tab, self->private_impl.f_dst_y);
-      if (v_dst_bytes_per_row < ((uint64_t)(v_dst.len))) {
-        v_dst = wuffs_base__slice_u8__subslice_j(v_dst, v_dst_bytes_per_row);
+      if (self->private_impl.f_roi_x0 > self->private_impl.f_dst_x) {
+        v_skip = ((uint32_t)(wuffs_base__u32__min(self->private_impl.f_roi_x0, self->private_impl.f_width) - self->private_impl.f_dst_x));
+      } else {
+        v_dst = wuffs_bmp__decoder__roi_row(self, v_tab, v_dst_bytes_per_pixel);
+        v_i = (((uint64_t)(((uint32_t)(self->private_impl.f_dst_x - self->private_impl.f_roi_x0)))) * v_dst_bytes_per_pixel);
+        if (v_i < ((uint64_t)(v_dst.len))) {
+          v_n = wuffs_base__pixel_swizzler__swizzle_interleaved_from_reader(
+              &self->private_impl.f_swizzler,
+              wuffs_base__slice_u8__subslice_i(v_dst, v_i),
+              v_dst_palette,
+              &iop_a_src,
+              io2_a_src);
+          if (v_n == 0) {
+            status = wuffs_base__make_status(wuffs_bmp__note__internal_note_short_read);
+            goto ok;
+          }
+          wuffs_base__u32__sat_add_indirect(&self->private_impl.f_dst_x, ((uint32_t)((v_n & 4294967295))));
+          goto label__inner__continue;
+        }
+        v_skip = ((uint32_t)(self->private_impl.f_width - self->private_impl.f_dst_x));
       }
-      v_i = (((uint64_t)(self->private_impl.f_dst_x)) * v_dst_bytes_per_pixel);
-      if (v_i >= ((uint64_t)(v_dst.len))) {
-        goto label__inner__continue;
+      v_n = ((uint64_t)(io2_a_src - iop_a_src));
+      if (v_src_bytes_per_pixel == 3) {
+        v_n /= 3;
+      } else if (v_src_bytes_per_pixel == 4) {
+        v_n /= 4;
       }
-      v_n = wuffs_base__pixel_swizzler__swizzle_interleaved_from_reader(
-          &self->private_impl.f_swizzler,
-          wuffs_base__slice_u8__subslice_i(v_dst, v_i),
-          v_dst_palette,
-          &iop_a_src,
-          io2_a_src);
-      if (v_n == 0) {
+      v_skip = wuffs_base__u32__min(wuffs_base__u32__min(v_skip, 65535), ((uint32_t)(wuffs_base__u64__min(v_n, 65535))));
+      if (v_skip == 0) {
         status = wuffs_base__make_status(wuffs_bmp__note__internal_note_short_read);
         goto ok;
       }
-      wuffs_base__u32__sat_add_indirect(&self->private_impl.f_dst_x, ((uint32_t)((v_n & 4294967295))));
+      wuffs_base__u32__sat_add_indirect(&self->private_impl.f_dst_x, v_skip);
+      v_skip *= v_src_bytes_per_pixel;
+      if (((uint64_t)(io2_a_src - iop_a_src)) < ((uint64_t)(v_skip))) {
+        status = wuffs_base__make_status(wuffs_bmp__error__internal_error_inconsistent_skip_length);
+        goto exit;
+      }
+      iop_a_src += v_skip;
     }
   }
   label__outer__break:;
@@ -22580,13 +26346,12 @@ wuffs_bmp__decoder__swizzle_rle(
   wuffs_base__pixel_format v_dst_pixfmt = {0};
   uint32_t v_dst_bits_per_pixel = 0;
   uint64_t v_dst_bytes_per_pixel = 0;
-  uint64_t v_dst_bytes_per_row = 0;
   wuffs_base__slice_u8 v_dst_palette = {0};
   wuffs_base__table_u8 v_tab = {0};
   wuffs_base__slice_u8 v_row = {0};
   wuffs_base__slice_u8 v_dst = {0};
   uint64_t v_i = 0;
-  uint64_t v_n = 0;
+  uint32_t v_n = 0;
   uint32_t v_p0 = 0;
   uint8_t v_code = 0;
   uint8_t v_indexes[2] = {0};
@@ -22612,19 +26377,15 @@ wuffs_bmp__decoder__swizzle_rle(
     goto exit;
   }
   v_dst_bytes_per_pixel = ((uint64_t)((v_dst_bits_per_pixel / 8)));
-  v_dst_bytes_per_row = (((uint64_t)(self->private_impl.f_width)) * v_dst_bytes_per_pixel);
   v_dst_palette = wuffs_base__pixel_buffer__palette_or_else(a_dst, wuffs_base__make_slice_u8((self->private_data.f_scratch) + 1024, 1024));
   v_tab = wuffs_base__pixel_buffer__plane(a_dst, 0);
   v_rle_state = self->private_impl.f_rle_state;
   label__outer__continue:;
   while (true) {
-    v_row = wuffs_base__table_u8__row(v_tab, self->private_impl.f_dst_y);
-    if (v_dst_bytes_per_row < ((uint64_t)(v_row.len))) {
-      v_row = wuffs_base__slice_u8__subslice_j(v_row, v_dst_bytes_per_row);
-    }
+    v_row = wuffs_bmp__decoder__roi_row(self, v_tab, v_dst_bytes_per_pixel);
     label__middle__continue:;
     while (true) {
-      v_i = (((uint64_t)(self->private_impl.f_dst_x)) * v_dst_bytes_per_pixel);
+      v_i = (((uint64_t)(wuffs_base__u32__sat_sub(self->private_impl.f_dst_x, self->private_impl.f_roi_x0))) * v_dst_bytes_per_pixel);
       if (v_i <= ((uint64_t)(v_row.len))) {
         v_dst = wuffs_base__slice_u8__subslice_i(v_row, v_i);
       } else {
@@ -22668,7 +26429,11 @@ wuffs_bmp__decoder__swizzle_rle(
                 v_p0 += 2;
               }
             }
-            wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(&self->private_impl.f_swizzler, v_dst, v_dst_palette, wuffs_base__slice_u8__subslice_j(wuffs_base__make_slice_u8(self->private_data.f_scratch, 2048), self->private_impl.f_rle_length));
+            wuffs_bmp__decoder__swizzle_from_scratch(self,
+                v_dst,
+                v_dst_palette,
+                ((uint64_t)(self->private_impl.f_rle_length)),
+                1);
             wuffs_base__u32__sat_add_indirect(&self->private_impl.f_dst_x, self->private_impl.f_rle_length);
             v_rle_state = 0;
             goto label__middle__continue;
@@ -22686,7 +26451,7 @@ wuffs_bmp__decoder__swizzle_rle(
               wuffs_base__pixel_swizzler__swizzle_interleaved_transparent_black(&self->private_impl.f_swizzler, v_dst, v_dst_palette, 18446744073709551615u);
               self->private_impl.f_dst_x = 0;
               self->private_impl.f_dst_y += self->private_impl.f_dst_y_inc;
-              if (v_code > 0) {
+              if ((v_code > 0) || wuffs_bmp__decoder__is_past_roi(self)) {
                 goto label__outer__break;
               }
               v_rle_state = 0;
@@ -22701,15 +26466,16 @@ wuffs_bmp__decoder__swizzle_rle(
             goto label__inner__continue;
           } else if (v_rle_state == 3) {
             if (self->private_impl.f_bits_per_pixel == 8) {
-              v_n = wuffs_base__pixel_swizzler__limited_swizzle_u32_interleaved_from_reader(
-                  &self->private_impl.f_swizzler,
-                  self->private_impl.f_rle_length,
+              v_n = wuffs_base__io_reader__limited_copy_u32_to_slice(
+                  &iop_a_src, io2_a_src,self->private_impl.f_rle_length, wuffs_base__make_slice_u8(self->private_data.f_scratch, 2048));
+              v_p0 = (v_n & 255);
+              wuffs_bmp__decoder__swizzle_from_scratch(self,
                   v_dst,
                   v_dst_palette,
-                  &iop_a_src,
-                  io2_a_src);
-              wuffs_base__u32__sat_add_indirect(&self->private_impl.f_dst_x, ((uint32_t)((v_n & 4294967295))));
-              wuffs_base__u32__sat_sub_indirect(&self->private_impl.f_rle_length, ((uint32_t)((v_n & 4294967295))));
+                  ((uint64_t)(v_p0)),
+                  1);
+              wuffs_base__u32__sat_add_indirect(&self->private_impl.f_dst_x, v_p0);
+              wuffs_base__u32__sat_sub_indirect(&self->private_impl.f_rle_length, v_p0);
             } else {
               v_chunk_count = ((self->private_impl.f_rle_length + 3) / 4);
               v_p0 = 0;
@@ -22724,7 +26490,11 @@ wuffs_bmp__decoder__swizzle_rle(
                 v_chunk_count -= 1;
               }
               v_p0 = wuffs_base__u32__min(v_p0, self->private_impl.f_rle_length);
-              wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(&self->private_impl.f_swizzler, v_dst, v_dst_palette, wuffs_base__slice_u8__subslice_j(wuffs_base__make_slice_u8(self->private_data.f_scratch, 2048), v_p0));
+              wuffs_bmp__decoder__swizzle_from_scratch(self,
+                  v_dst,
+                  v_dst_palette,
+                  ((uint64_t)(v_p0)),
+                  1);
               wuffs_base__u32__sat_add_indirect(&self->private_impl.f_dst_x, v_p0);
               wuffs_base__u32__sat_sub_indirect(&self->private_impl.f_rle_length, v_p0);
             }
@@ -22755,7 +26525,7 @@ wuffs_bmp__decoder__swizzle_rle(
           v_code = wuffs_base__peek_u8be__no_bounds_check(iop_a_src);
           iop_a_src += 1;
           if (self->private_impl.f_rle_delta_x > 0) {
-            wuffs_base__pixel_swizzler__swizzle_interleaved_transparent_black(&self->private_impl.f_swizzler, v_dst, v_dst_palette, ((uint64_t)(self->private_impl.f_rle_delta_x)));
+            wuffs_base__pixel_swizzler__swizzle_interleaved_transparent_black(&self->private_impl.f_swizzler, v_dst, v_dst_palette, ((uint64_t)(wuffs_base__u32__sat_sub(((uint32_t)(self->private_impl.f_rle_delta_x)), wuffs_base__u32__sat_sub(self->private_impl.f_roi_x0, self->private_impl.f_dst_x)))));
             wuffs_base__u32__sat_add_indirect(&self->private_impl.f_dst_x, ((uint32_t)(self->private_impl.f_rle_delta_x)));
             self->private_impl.f_rle_delta_x = 0;
             if (self->private_impl.f_dst_x > self->private_impl.f_width) {
@@ -22778,12 +26548,9 @@ wuffs_bmp__decoder__swizzle_rle(
                 status = wuffs_base__make_status(wuffs_bmp__error__bad_rle_compression);
                 goto exit;
               }
-              v_row = wuffs_base__table_u8__row(v_tab, self->private_impl.f_dst_y);
-              if (v_dst_bytes_per_row < ((uint64_t)(v_row.len))) {
-                v_row = wuffs_base__slice_u8__subslice_j(v_row, v_dst_bytes_per_row);
-              }
+              v_row = wuffs_bmp__decoder__roi_row(self, v_tab, v_dst_bytes_per_pixel);
               if (v_code <= 0) {
-                wuffs_base__pixel_swizzler__swizzle_interleaved_transparent_black(&self->private_impl.f_swizzler, v_row, v_dst_palette, ((uint64_t)(self->private_impl.f_dst_x)));
+                wuffs_base__pixel_swizzler__swizzle_interleaved_transparent_black(&self->private_impl.f_swizzler, v_row, v_dst_palette, ((uint64_t)(wuffs_base__u32__sat_sub(self->private_impl.f_dst_x, self->private_impl.f_roi_x0))));
                 goto label__0__break;
               }
               wuffs_base__pixel_swizzler__swizzle_interleaved_transparent_black(&self->private_impl.f_swizzler, v_row, v_dst_palette, 18446744073709551615u);
@@ -22809,11 +26576,8 @@ wuffs_bmp__decoder__swizzle_rle(
     }
   }
   label__outer__break:;
-  while (self->private_impl.f_dst_y < self->private_impl.f_height) {
-    v_row = wuffs_base__table_u8__row(v_tab, self->private_impl.f_dst_y);
-    if (v_dst_bytes_per_row < ((uint64_t)(v_row.len))) {
-      v_row = wuffs_base__slice_u8__subslice_j(v_row, v_dst_bytes_per_row);
-    }
+  while ((self->private_impl.f_dst_y < self->private_impl.f_height) &&  ! wuffs_bmp__decoder__is_past_roi(self)) {
+    v_row = wuffs_bmp__decoder__roi_row(self, v_tab, v_dst_bytes_per_pixel);
     wuffs_base__pixel_swizzler__swizzle_interleaved_transparent_black(&self->private_impl.f_swizzler, v_row, v_dst_palette, 18446744073709551615u);
     self->private_impl.f_dst_y += self->private_impl.f_dst_y_inc;
   }
@@ -22842,12 +26606,10 @@ wuffs_bmp__decoder__swizzle_bitfields(
   wuffs_base__pixel_format v_dst_pixfmt = {0};
   uint32_t v_dst_bits_per_pixel = 0;
   uint64_t v_dst_bytes_per_pixel = 0;
-  uint64_t v_dst_bytes_per_row = 0;
   wuffs_base__slice_u8 v_dst_palette = {0};
   wuffs_base__table_u8 v_tab = {0};
   wuffs_base__slice_u8 v_dst = {0};
   uint64_t v_i = 0;
-  uint64_t v_n = 0;
   uint32_t v_p0 = 0;
   uint32_t v_p1 = 0;
   uint32_t v_p1_temp = 0;
@@ -22874,7 +26636,6 @@ wuffs_bmp__decoder__swizzle_bitfields(
     goto exit;
   }
   v_dst_bytes_per_pixel = ((uint64_t)((v_dst_bits_per_pixel / 8)));
-  v_dst_bytes_per_row = (((uint64_t)(self->private_impl.f_width)) * v_dst_bytes_per_pixel);
   v_dst_palette = wuffs_base__pixel_buffer__palette_or_else(a_dst, wuffs_base__make_slice_u8((self->private_data.f_scratch) + 1024, 1024));
   v_tab = wuffs_base__pixel_buffer__plane(a_dst, 0);
   label__outer__continue:;
@@ -22887,12 +26648,11 @@ wuffs_bmp__decoder__swizzle_bitfields(
       self->private_impl.f_pending_pad -= 1;
       iop_a_src += 1;
     }
-    label__inner__continue:;
     while (true) {
       if (self->private_impl.f_dst_x == self->private_impl.f_width) {
         self->private_impl.f_dst_x = 0;
         self->private_impl.f_dst_y += self->private_impl.f_dst_y_inc;
-        if (self->private_impl.f_dst_y >= self->private_impl.f_height) {
+        if ((self->private_impl.f_dst_y >= self->private_impl.f_height) || wuffs_bmp__decoder__is_past_roi(self)) {
           if (self->private_impl.f_height > 0) {
             self->private_impl.f_pending_pad = self->private_impl.f_pad_per_row;
           }
@@ -22903,6 +26663,9 @@ wuffs_bmp__decoder__swizzle_bitfields(
         }
       }
       v_p1_temp = ((uint32_t)(self->private_impl.f_width - self->private_impl.f_dst_x));
+      if (self->private_impl.f_roi_x0 > self->private_impl.f_dst_x) {
+        v_p1_temp = wuffs_base__u32__min(v_p1_temp, (self->private_impl.f_roi_x0 - self->private_impl.f_dst_x));
+      }
       v_p1 = wuffs_base__u32__min(v_p1_temp, 256);
       v_p0 = 0;
       while (v_p0 < v_p1) {
@@ -22940,20 +26703,20 @@ wuffs_bmp__decoder__swizzle_bitfields(
         v_p0 += 1;
       }
       label__0__break:;
-      v_dst = wuffs_base__table_u8__row(v_tab, self->private_impl.f_dst_y);
-      if (v_dst_bytes_per_row < ((uint64_t)(v_dst.len))) {
-        v_dst = wuffs_base__slice_u8__subslice_j(v_dst, v_dst_bytes_per_row);
-      }
-      v_i = (((uint64_t)(self->private_impl.f_dst_x)) * v_dst_bytes_per_pixel);
-      if (v_i >= ((uint64_t)(v_dst.len))) {
-        goto label__inner__continue;
-      }
-      v_n = wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(&self->private_impl.f_swizzler, wuffs_base__slice_u8__subslice_i(v_dst, v_i), v_dst_palette, wuffs_base__slice_u8__subslice_j(wuffs_base__make_slice_u8(self->private_data.f_scratch, 2048), (8 * v_p0)));
-      if (v_n == 0) {
+      if (v_p0 == 0) {
         status = wuffs_base__make_status(wuffs_bmp__note__internal_note_short_read);
         goto ok;
       }
-      wuffs_base__u32__sat_add_indirect(&self->private_impl.f_dst_x, ((uint32_t)((v_n & 4294967295))));
+      v_dst = wuffs_bmp__decoder__roi_row(self, v_tab, v_dst_bytes_per_pixel);
+      v_i = (((uint64_t)(wuffs_base__u32__sat_sub(self->private_impl.f_dst_x, self->private_impl.f_roi_x0))) * v_dst_bytes_per_pixel);
+      if (v_i < ((uint64_t)(v_dst.len))) {
+        wuffs_bmp__decoder__swizzle_from_scratch(self,
+            wuffs_base__slice_u8__subslice_i(v_dst, v_i),
+            v_dst_palette,
+            ((uint64_t)((8 * v_p0))),
+            8);
+      }
+      wuffs_base__u32__sat_add_indirect(&self->private_impl.f_dst_x, v_p0);
     }
   }
   label__outer__break:;
@@ -22982,12 +26745,10 @@ wuffs_bmp__decoder__swizzle_low_bit_depth(
   wuffs_base__pixel_format v_dst_pixfmt = {0};
   uint32_t v_dst_bits_per_pixel = 0;
   uint64_t v_dst_bytes_per_pixel = 0;
-  uint64_t v_dst_bytes_per_row = 0;
   wuffs_base__slice_u8 v_dst_palette = {0};
   wuffs_base__table_u8 v_tab = {0};
   wuffs_base__slice_u8 v_dst = {0};
   uint64_t v_i = 0;
-  uint64_t v_n = 0;
   uint32_t v_p0 = 0;
   uint32_t v_chunk_bits = 0;
   uint32_t v_chunk_count = 0;
@@ -23010,27 +26771,23 @@ wuffs_bmp__decoder__swizzle_low_bit_depth(
     goto exit;
   }
   v_dst_bytes_per_pixel = ((uint64_t)((v_dst_bits_per_pixel / 8)));
-  v_dst_bytes_per_row = (((uint64_t)(self->private_impl.f_width)) * v_dst_bytes_per_pixel);
   v_dst_palette = wuffs_base__pixel_buffer__palette_or_else(a_dst, wuffs_base__make_slice_u8((self->private_data.f_scratch) + 1024, 1024));
   v_tab = wuffs_base__pixel_buffer__plane(a_dst, 0);
-  label__loop__continue:;
   while (true) {
     if (self->private_impl.f_dst_x == self->private_impl.f_width) {
       self->private_impl.f_dst_x = 0;
       self->private_impl.f_dst_y += self->private_impl.f_dst_y_inc;
-      if (self->private_impl.f_dst_y >= self->private_impl.f_height) {
+      if ((self->private_impl.f_dst_y >= self->private_impl.f_height) || wuffs_bmp__decoder__is_past_roi(self)) {
         goto label__loop__break;
       }
     }
-    v_dst = wuffs_base__table_u8__row(v_tab, self->private_impl.f_dst_y);
-    if (v_dst_bytes_per_row < ((uint64_t)(v_dst.len))) {
-      v_dst = wuffs_base__slice_u8__subslice_j(v_dst, v_dst_bytes_per_row);
-    }
-    v_i = (((uint64_t)(self->private_impl.f_dst_x)) * v_dst_bytes_per_pixel);
-    if (v_i >= ((uint64_t)(v_dst.len))) {
-      goto label__loop__continue;
+    v_dst = wuffs_bmp__decoder__roi_row(self, v_tab, v_dst_bytes_per_pixel);
+    v_i = (((uint64_t)(wuffs_base__u32__sat_sub(self->private_impl.f_dst_x, self->private_impl.f_roi_x0))) * v_dst_bytes_per_pixel);
+    if (v_i < ((uint64_t)(v_dst.len))) {
+      v_dst = wuffs_base__slice_u8__subslice_i(v_dst, v_i);
+    } else {
+      v_dst = wuffs_base__utility__empty_slice_u8();
     }
-    v_dst = wuffs_base__slice_u8__subslice_i(v_dst, v_i);
     v_p0 = 0;
     if (self->private_impl.f_bits_per_pixel == 1) {
       v_chunk_count = ((wuffs_base__u32__sat_sub(self->private_impl.f_width, self->private_impl.f_dst_x) + 31) / 32);
@@ -23117,12 +26874,16 @@ wuffs_bmp__decoder__swizzle_low_bit_depth(
       }
     }
     v_p0 = wuffs_base__u32__min(v_p0, wuffs_base__u32__sat_sub(self->private_impl.f_width, self->private_impl.f_dst_x));
-    v_n = wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(&self->private_impl.f_swizzler, v_dst, v_dst_palette, wuffs_base__slice_u8__subslice_j(wuffs_base__make_slice_u8(self->private_data.f_scratch, 2048), v_p0));
-    if (v_n == 0) {
+    if (v_p0 == 0) {
       status = wuffs_base__make_status(wuffs_bmp__note__internal_note_short_read);
       goto ok;
     }
-    wuffs_base__u32__sat_add_indirect(&self->private_impl.f_dst_x, ((uint32_t)((v_n & 4294967295))));
+    wuffs_bmp__decoder__swizzle_from_scratch(self,
+        v_dst,
+        v_dst_palette,
+        ((uint64_t)(v_p0)),
+        1);
+    wuffs_base__u32__sat_add_indirect(&self->private_impl.f_dst_x, v_p0);
   }
   label__loop__break:;
   status = wuffs_base__make_status(NULL);
@@ -23138,6 +26899,72 @@ wuffs_bmp__decoder__swizzle_low_bit_depth(
   return status;
 }
 
+// -------- func bmp.decoder.is_before_roi
+
+static bool
+wuffs_bmp__decoder__is_before_roi(
+    const wuffs_bmp__decoder* self) {
+  if (self->private_impl.f_top_down) {
+    return (self->private_impl.f_dst_y < self->private_impl.f_roi_y0);
+  }
+  return (self->private_impl.f_dst_y >= self->private_impl.f_roi_y1);
+}
+
+// -------- func bmp.decoder.is_past_roi
+
+static bool
+wuffs_bmp__decoder__is_past_roi(
+    const wuffs_bmp__decoder* self) {
+  if (self->private_impl.f_top_down) {
+    return (self->private_impl.f_dst_y >= self->private_impl.f_roi_y1);
+  }
+  return (self->private_impl.f_dst_y < self->private_impl.f_roi_y0);
+}
+
+// -------- func bmp.decoder.roi_row
+
+static wuffs_base__slice_u8
+wuffs_bmp__decoder__roi_row(
+    const wuffs_bmp__decoder* self,
+    wuffs_base__table_u8 a_tab,
+    uint64_t a_dst_bytes_per_pixel) {
+  wuffs_base__slice_u8 v_row = {0};
+  uint64_t v_i = 0;
+  uint64_t v_j = 0;
+
+  if ((self->private_impl.f_dst_y < self->private_impl.f_roi_y0) || (self->private_impl.f_dst_y >= self->private_impl.f_roi_y1)) {
+    return wuffs_base__utility__empty_slice_u8();
+  }
+  v_row = wuffs_base__table_u8__row(a_tab, self->private_impl.f_dst_y);
+  v_j = (((uint64_t)(wuffs_base__u32__min(self->private_impl.f_width, self->private_impl.f_roi_x1))) * a_dst_bytes_per_pixel);
+  if (v_j < ((uint64_t)(v_row.len))) {
+    v_row = wuffs_base__slice_u8__subslice_j(v_row, v_j);
+  }
+  v_i = (((uint64_t)(self->private_impl.f_roi_x0)) * a_dst_bytes_per_pixel);
+  if (v_i < ((uint64_t)(v_row.len))) {
+    return wuffs_base__slice_u8__subslice_i(v_row, v_i);
+  }
+  return wuffs_base__utility__empty_slice_u8();
+}
+
+// -------- func bmp.decoder.swizzle_from_scratch
+
+static wuffs_base__empty_struct
+wuffs_bmp__decoder__swizzle_from_scratch(
+    wuffs_bmp__decoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_dst_palette,
+    uint64_t a_length,
+    uint64_t a_src_bytes_per_pixel) {
+  uint64_t v_i = 0;
+
+  v_i = (((uint64_t)(wuffs_base__u32__sat_sub(self->private_impl.f_roi_x0, self->private_impl.f_dst_x))) * a_src_bytes_per_pixel);
+  if (v_i < a_length) {
+    wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(&self->private_impl.f_swizzler, a_dst, a_dst_palette, wuffs_base__slice_u8__subslice_ij(wuffs_base__make_slice_u8(self->private_data.f_scratch, 2048), v_i, a_length));
+  }
+  return wuffs_base__make_empty_struct();
+}
+
 // -------- func bmp.decoder.frame_dirty_rect
 
 WUFFS_BASE__MAYBE_STATIC wuffs_base__rect_ie_u32
@@ -23151,11 +26978,20 @@ wuffs_bmp__decoder__frame_dirty_rect(
     return wuffs_base__utility__empty_rect_ie_u32();
   }
 
+  uint32_t v_x0 = 0;
+  uint32_t v_y0 = 0;
+  uint32_t v_x1 = 0;
+  uint32_t v_y1 = 0;
+
+  v_x0 = wuffs_base__u32__min(self->private_impl.f_roi_x0, self->private_impl.f_width);
+  v_y0 = wuffs_base__u32__min(self->private_impl.f_roi_y0, self->private_impl.f_height);
+  v_x1 = wuffs_base__u32__max(wuffs_base__u32__min(self->private_impl.f_roi_x1, self->private_impl.f_width), v_x0);
+  v_y1 = wuffs_base__u32__max(wuffs_base__u32__min(self->private_impl.f_roi_y1, self->private_impl.f_height), v_y0);
   return wuffs_base__utility__make_rect_ie_u32(
-      0,
-      0,
-      self->private_impl.f_width,
-      self->private_impl.f_height);
+      v_x0,
+      v_y0,
+      v_x1,
+      v_y1);
 }
 
 // -------- func bmp.decoder.num_animation_loops
@@ -24251,6 +28087,287 @@ wuffs_cbor__decoder__decode_tokens(
 
 // ---------------- Private Consts
 
+static const uint32_t
+WUFFS_CRC32__CASTAGNOLI_TABLE[8][256] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  {
+    0, 4067132163, 3778769143, 324072436, 3348797215, 904991772, 648144872, 3570033899,
+    2329499855, 2024987596, 1809983544, 2575936315, 1296289744, 3207089363, 2893594407, 1578318884,
+    274646895, 3795141740, 4049975192, 51262619, 3619967088, 632279923, 922689671, 3298075524,
+    2592579488, 1760304291, 2075979607, 2312596564, 1562183871, 2943781820, 3156637768, 1313733451,
+    549293790, 3537243613, 3246849577, 871202090, 3878099393, 357341890, 102525238, 4101499445,
+    2858735121, 1477399826, 1264559846, 3107202533, 1845379342, 2677391885, 2361733625, 2125378298,
+    820201905, 3263744690, 3520608582, 598981189, 4151959214, 85089709, 373468761, 3827903834,
+    3124367742, 1213305469, 1526817161, 2842354314, 2107672161, 2412447074, 2627466902, 1861252501,
+    1098587580, 3004210879, 2688576843, 1378610760, 2262928035, 1955203488, 1742404180, 2511436119,
+    3416409459, 969524848, 714683780, 3639785095, 205050476, 4266873199, 3976438427, 526918040,
+    1361435347, 2739821008, 2954799652, 1114974503, 2529119692, 1691668175, 2005155131, 2247081528,
+    3690758684, 697762079, 986182379, 3366744552, 476452099, 3993867776, 4250756596, 255256311,
+    1640403810, 2477592673, 2164122517, 1922457750, 2791048317, 1412925310, 1197962378, 3037525897,
+    3944729517, 427051182, 170179418, 4165941337, 746937522, 3740196785, 3451792453, 1070968646,
+    1905808397, 2213795598, 2426610938, 1657317369, 3053634322, 1147748369, 1463399397, 2773627110,
+    4215344322, 153784257, 444234805, 3893493558, 1021025245, 3467647198, 3722505002, 797665321,
+    2197175160, 1889384571, 1674398607, 2443626636, 1164749927, 3070701412, 2757221520, 1446797203,
+    137323447, 4198817972, 3910406976, 461344835, 3484808360, 1037989803, 781091935, 3705997148,
+    2460548119, 1623424788, 1939049696, 2180517859, 1429367560, 2807687179, 3020495871, 1180866812,
+    410100952, 3927582683, 4182430767, 186734380, 3756733383, 763408580, 1053836080, 3434856499,
+    2722870694, 1344288421, 1131464017, 2971354706, 1708204729, 2545590714, 2229949006, 1988219213,
+    680717673, 3673779818, 3383336350, 1002577565, 4010310262, 493091189, 238226049, 4233660802,
+    2987750089, 1082061258, 1395524158, 2705686845, 1972364758, 2279892693, 2494862625, 1725896226,
+    952904198, 3399985413, 3656866545, 731699698, 4283874585, 222117402, 510512622, 3959836397,
+    3280807620, 837199303, 582374963, 3504198960, 68661723, 4135334616, 3844915500, 390545967,
+    1230274059, 3141532936, 2825850620, 1510247935, 2395924756, 2091215383, 1878366691, 2644384480,
+    3553878443, 565732008, 854102364, 3229815391, 340358836, 3861050807, 4117890627, 119113024,
+    1493875044, 2875275879, 3090270611, 1247431312, 2660249211, 1828433272, 2141937292, 2378227087,
+    3811616794, 291187481, 34330861, 4032846830, 615137029, 3603020806, 3314634738, 939183345,
+    1776939221, 2609017814, 2295496738, 2058945313, 2926798794, 1545135305, 1330124605, 3173225534,
+    4084100981, 17165430, 307568514, 3762199681, 888469610, 3332340585, 3587147933, 665062302,
+    2042050490, 2346497209, 2559330125, 1793573966, 3190661285, 1279665062, 1595330642, 2910671697,
+  }, {
+    0, 329422967, 658845934, 887597209, 1317691868, 1562966443, 1775194418, 2054015301,
+    2635383736, 2394315727, 3125932886, 2851302177, 3550388836, 3225172499, 4108030602, 3883469565,
+    1069937025, 744974838, 411091311, 186800408, 1901039709, 1659701290, 1443537075, 1168652484,
+    2731618873, 2977147470, 2241069783, 2520160928, 3965408229, 4294560658, 3407766283, 3636263804,
+    2139874050, 1814657909, 1489949676, 1265388443, 822182622, 581114537, 373600816, 98970183,
+    3802079418, 4047354061, 3319402580, 3598223395, 2887074150, 3216496913, 2337304968, 2566056447,
+    1078858371, 1408010996, 1728782957, 1957280282, 247755615, 493284136, 696337329, 975428550,
+    3713716539, 3472378188, 4196393429, 3921508770, 2479927527, 2154965136, 3029696521, 2805405822,
+    4279748100, 3971309171, 3629315818, 3421531805, 2979899352, 2722054063, 2530776886, 2239369025,
+    1644365244, 1906417099, 1162229074, 1457827109, 747201632, 1059847191, 197940366, 409914617,
+    3235002245, 3547377650, 3885434731, 4097154844, 2388153945, 2650459694, 2837276343, 3133144768,
+    1573319741, 1315204170, 2055455955, 1763794084, 323786209, 15601046, 873047311, 665533816,
+    2157716742, 2470362481, 2816021992, 3027996063, 3457565914, 3719617709, 3914560564, 4210158659,
+    495511230, 237665993, 986568272, 695160359, 1392674658, 1084235541, 1950857100, 1743073275,
+    3210335367, 2902150384, 2552030313, 2344516638, 4057183579, 3799067948, 3600188853, 3308527042,
+    575477567, 837783368, 84420561, 380288934, 1825011427, 2137386644, 1266828813, 1478549114,
+    4223924985, 3898696334, 3699821079, 3475264096, 3041499941, 2800419666, 2450303947, 2175677372,
+    1725380929, 1970643254, 1100089775, 1378914776, 677206173, 1006616810, 253257843, 482013188,
+    3288730488, 3617886991, 3812834198, 4041319393, 2324458148, 2569990867, 2915654218, 3194733117,
+    1494403264, 1253068983, 2119694382, 1844797529, 395880732, 70922603, 819829234, 595526021,
+    2219317755, 2548728204, 2735548693, 2964304226, 3401742375, 3647004752, 3985066185, 4263891134,
+    425515587, 184435252, 1041885869, 767259354, 1473690527, 1148462056, 1888717681, 1664160518,
+    3146639482, 2821681165, 2630408340, 2406105315, 4110911910, 3869577681, 3527588168, 3252691263,
+    647572418, 893105077, 31202092, 310281051, 1746094622, 2075251305, 1331067632, 1559552647,
+    81018109, 393651338, 596708371, 808686692, 1247698209, 1509737814, 1830514127, 2126116280,
+    2579562309, 2321704754, 3196440491, 2905036764, 3611991705, 3303540462, 4027559543, 3819779584,
+    991022460, 682841355, 475331986, 267806181, 1973136544, 1715025111, 1390320718, 1098646585,
+    2785349316, 3047659187, 2168471082, 2464327261, 3901714200, 4214093679, 3486146550, 3697854337,
+    2069880831, 1761429384, 1545269009, 1337489254, 903200291, 645342804, 311463629, 20059834,
+    3863682119, 4125721648, 3238931625, 3534533854, 2831252891, 3143886316, 2407812469, 2619790594,
+    1150955134, 1463334409, 1675566736, 1887274727, 168841122, 431151061, 760577868, 1056433979,
+    3650022854, 3391911345, 4274773288, 3983099231, 2533657626, 2225476717, 2957098228, 2749572227,
+  }, {
+    0, 2772537982, 1332695565, 3928932467, 2665391130, 1000289892, 3518101015, 1961911401,
+    944848581, 2635115707, 2000579784, 3531603638, 2794429151, 63834273, 3923822802, 1285642924,
+    1889697162, 3588485108, 1070411655, 2592914937, 4001159568, 1262308334, 2702412701, 72489443,
+    1223902031, 3987919153, 127668546, 2732426044, 3593332565, 1936487723, 2571285848, 1006839590,
+    3779394324, 1141205354, 2922096921, 191511399, 2140823310, 3671838064, 821366019, 2511642493,
+    3642082769, 2085902255, 2524616668, 859506082, 1204511179, 3800757173, 144978886, 2917507512,
+    2447804062, 883365088, 3733574803, 2076722925, 255337092, 2860101882, 1079472265, 3843482359,
+    2847389787, 217459237, 3872975446, 1134131240, 929635393, 2452131391, 2013679180, 3712474162,
+    3345318105, 1646531239, 2282410708, 759906474, 1505436867, 4244289213, 383022798, 3012945072,
+    4281646620, 1517628514, 2958814225, 354057839, 1642732038, 3299575928, 780486667, 2344934005,
+    3083337043, 310800173, 4171804510, 1575566624, 689527113, 2354629431, 1719012164, 3275200826,
+    2409022358, 718754280, 3237581211, 1706558437, 289957772, 3020551666, 1579627905, 4217808895,
+    639728589, 2204166579, 1766730176, 3423583166, 3103776727, 499010985, 4153445850, 1389436836,
+    510674184, 3140605814, 1360992005, 4099835259, 2158944530, 636449644, 3485578015, 1786782049,
+    1451427399, 4089615417, 434918474, 3165505076, 3361579613, 1830563875, 2268262480, 577987118,
+    1859270786, 3415452412, 566061711, 2231171313, 4027358360, 1431113446, 3210989205, 438459627,
+    2334619459, 778495293, 3293062478, 1628026672, 368694105, 2964865319, 1519812948, 4292285226,
+    3010873734, 372759544, 4229503883, 1498974709, 766045596, 2297004002, 1657257873, 3347459567,
+    4219800265, 1589942455, 3035257028, 296471226, 1700507347, 3222944941, 708115678, 2406837920,
+    3285464076, 1721083506, 2361091585, 704312447, 1560973334, 4165665384, 308658715, 3072610405,
+    1784908887, 3475119657, 621600346, 2152549412, 4106037325, 1375517235, 3151133248, 513009726,
+    1379054226, 4151517420, 492691615, 3088872161, 3438024328, 1772979446, 2206418053, 650303227,
+    448917981, 3212862371, 1437508560, 4042207662, 2216646087, 559859641, 3413116874, 1848743348,
+    579915544, 2278645094, 1845468437, 3367898987, 3159255810, 420477308, 4079040783, 1449175921,
+    1279457178, 3909314020, 53323159, 2792110057, 3533460352, 2011021822, 2649948557, 951227379,
+    1947453791, 3511835425, 998021970, 2654800172, 3939331397, 1334640443, 2778873672, 14921014,
+    1021348368, 2577471598, 1938806813, 3603843683, 2721984010, 125811828, 3981540359, 1209069177,
+    78755029, 2716870315, 1272899288, 4003427494, 2590970063, 1060012721, 3573564098, 1883361468,
+    2902854798, 138911472, 3798556291, 1193856253, 869836948, 2526624490, 2092432025, 3656804583,
+    2505519691, 806789173, 3661127750, 2138698296, 193566289, 2932343855, 1155974236, 3785840162,
+    3718541572, 2028331898, 2462786313, 931836279, 1132123422, 3862644576, 202737427, 2840860013,
+    3858059201, 1085595071, 2862226892, 266047410, 2066475995, 3731519909, 876919254, 2433035176,
+  }, {
+    0, 3712330424, 3211207553, 1646430521, 2065838579, 2791807819, 3292861042, 419477706,
+    4131677158, 721537374, 1227047015, 2489772767, 2372293141, 1344534701, 838955412, 4014267180,
+    3915690301, 874584965, 1443074748, 2336634884, 2454094030, 1325607542, 757179215, 4033087991,
+    522244827, 3261429859, 2689069402, 2097306594, 1677910824, 3108456848, 3680878761, 102787601,
+    3609531531, 174112307, 1749169930, 3037175218, 2886149496, 1900187584, 325060345, 3458575425,
+    560035693, 4230274517, 2651215084, 1128529492, 1514358430, 2265377830, 3844367647, 945934247,
+    1044489654, 3808694030, 2166785591, 1550003343, 1164153925, 2552643325, 4194613188, 658578812,
+    3355821648, 356543720, 2002970065, 2854702953, 3005740963, 1851940123, 205575202, 3506798234,
+    2879807463, 1994650975, 348224614, 3380926174, 3498339860, 230802604, 1877167509, 2997282605,
+    1575107585, 2158466745, 3800375168, 1069593912, 650120690, 4219840330, 2577870451, 1155695819,
+    1120071386, 2676442210, 4255501659, 551577571, 971038505, 3836048785, 2257058984, 1539462672,
+    3028716860, 1774397316, 199339709, 3601073157, 3483679951, 316741239, 1891868494, 2911254006,
+    2088979308, 2714165716, 3286526189, 513917525, 128023199, 3672428583, 3100006686, 1703146406,
+    2328307850, 1468170802, 899681035, 3907363251, 4058323321, 748729281, 1317157624, 2479329344,
+    2515008081, 1218597097, 713087440, 4156912488, 4005940130, 864051482, 1369630755, 2363966107,
+    1671666103, 3202757391, 3703880246, 25235598, 411150404, 3317957372, 2816904133, 2057511293,
+    1386268991, 2414175111, 3989301950, 813842438, 696449228, 4106703476, 2531646285, 1268806133,
+    2766449369, 2040594529, 461605208, 3334874080, 3754335018, 42152338, 1621211307, 3185840659,
+    3150215170, 1719784122, 77814659, 3655790907, 3236317681, 497279817, 2139187824, 2730803400,
+    1300241380, 2428875100, 4075239525, 799183581, 916597271, 3957817519, 2311391638, 1417716526,
+    2240142772, 1489008396, 987954741, 3886503053, 4272417863, 602031871, 1103155142, 2625987966,
+    1942077010, 2927891690, 3433471443, 300103531, 149131169, 3584435481, 3078925344, 1791035032,
+    1826712713, 2980365873, 3548794632, 247719344, 398679418, 3397842882, 2829352699, 1977734211,
+    2594508655, 1205904855, 633482478, 4169631318, 3783736988, 1019384868, 1591745821, 2208675749,
+    4177958616, 608386144, 1180808537, 2602835937, 2183440171, 1600195987, 1027835050, 3758501394,
+    256046398, 3523698566, 2955269823, 1835039751, 1952498893, 2837802613, 3406292812, 373444084,
+    274868197, 3441921373, 2936341604, 1916841692, 1799362070, 3053829294, 3559339415, 157458223,
+    3861267459, 996404923, 1497458562, 2214907194, 2634315248, 1078058824, 576935537, 4280745161,
+    774079059, 4083558635, 2437194194, 1275136874, 1426174880, 2286164248, 3932590113, 925055641,
+    3630686645, 86133517, 1728102964, 3125110924, 2739261510, 2113960702, 472052679, 3244775807,
+    3343332206, 436378070, 2015367407, 2774907479, 3160736413, 1629530149, 50471196, 3729230756,
+    822300808, 3964074544, 2388947721, 1394727345, 1243701627, 2539965379, 4115022586, 671344706,
+  }, {
+    0, 940666796, 1881333592, 1211347188, 3762667184, 3629437212, 2422694376, 2826309188,
+    3311864721, 4252394557, 3041252553, 2371140453, 623031585, 489937549, 1426090617, 1829832149,
+    2401395155, 3073576575, 4278238859, 3339833639, 1869078371, 1467396303, 524615739, 659845015,
+    1246063170, 1918109166, 979875098, 41343670, 2852181234, 2450635614, 3659664298, 3795018758,
+    464041303, 599382779, 1804233231, 1402668451, 4226616295, 3288097867, 2345653439, 3017718547,
+    3738156742, 3873362282, 2934792606, 2533101106, 1049231478, 110850010, 1319690030, 1991880834,
+    2492126340, 2895887144, 3836218332, 3703137392, 1959750196, 1289618840, 82687340, 1023204032,
+    1374543637, 1778167993, 567214157, 434008033, 2980602277, 2310606345, 3247095549, 4187738449,
+    928082606, 255853826, 1198765558, 2137184858, 3608466462, 4010130354, 2805336902, 2670159082,
+    4063650111, 3391557267, 2182397543, 3120943563, 309583759, 711110691, 1649475799, 1514172283,
+    3094547325, 2153931985, 3360805925, 4030774153, 1479980493, 1613224545, 672426645, 268764473,
+    2098462956, 1157984064, 221700020, 891793432, 2639380060, 2772488688, 3983761668, 3579973288,
+    754573305, 350793813, 1557856417, 1690988301, 3434897737, 4104982245, 3164519953, 2224017853,
+    3919500392, 3515857860, 2579237680, 2712495260, 165374680, 835323252, 2046408064, 1105779244,
+    2749087274, 2613760390, 3556335986, 3957853918, 1134428314, 2072997686, 868016066, 195932270,
+    1723643323, 1588451863, 379480803, 781124943, 2264468235, 3202901159, 4141601875, 3469392895,
+    1856165212, 1454619376, 511707652, 647062952, 2397531116, 3069576256, 4274369716, 3335838488,
+    2881871565, 2480189793, 3689349525, 3824578105, 1266704509, 1938886609, 1000521509, 62115977,
+    3783308431, 3650214691, 2443340759, 2847081595, 29690431, 970220947, 1911018855, 1240906443,
+    619167518, 485937330, 1422221382, 1825837034, 3298951598, 4239617538, 3028344566, 2358358362,
+    1963614219, 1293619111, 86556499, 1027199231, 2505039547, 2908664087, 3849126371, 3715919439,
+    2959960986, 2289828918, 3226449090, 4166966126, 1344853290, 1748613766, 537528946, 404448734,
+    4196925912, 3258543732, 2315968128, 2988159276, 443400040, 578605252, 1783586864, 1381896092,
+    1062144585, 123626981, 1332598033, 2004662973, 3742020857, 3877362517, 2938661793, 2537096205,
+    1509146610, 1642254430, 701587626, 297799430, 3115712834, 2175233774, 3381976602, 4052070838,
+    2626991203, 2760235983, 3971377979, 3567715479, 2094074579, 1153459583, 217306507, 887274023,
+    3604078113, 4005605773, 2800943481, 2665639637, 915693713, 243601213, 1186381769, 2124927077,
+    330749360, 732412444, 1670646504, 1535468868, 4092816128, 3420587180, 2211558488, 3149978612,
+    1113262757, 2051695881, 846845437, 174635601, 2719921173, 2584730553, 3527174989, 3928818913,
+    2268856628, 3207425688, 4145995372, 3473912256, 1736032132, 1600704552, 391864540, 793382768,
+    3447286646, 4117234906, 3176903726, 2236275586, 758961606, 355318378, 1562249886, 1695507762,
+    136208615, 806293323, 2017247167, 1076744211, 3898334807, 3494556155, 2558066959, 2691198627,
+  }, {
+    0, 4012927769, 3683426499, 884788186, 3002414967, 1573215342, 1769576372, 2252995757,
+    1611012127, 2402710278, 3146430684, 1421530053, 3539152744, 1036207217, 159354795, 3863995570,
+    3222024254, 792484647, 461410557, 4105239524, 1928922953, 2647223376, 2843060106, 1178979475,
+    2685020193, 1329218360, 2072414434, 2495013883, 318709590, 4258231375, 3379806101, 641979532,
+    2247366285, 1791262100, 1584969294, 2974342487, 922821114, 3627109091, 3968696633, 62777888,
+    3857845906, 180512139, 1048489553, 3511600456, 1460091365, 3090633468, 2357958950, 1673261631,
+    1173890739, 2865253802, 2658436720, 1900342633, 4144828868, 406682333, 746696967, 3283212830,
+    637419180, 3402519989, 4268924527, 289600886, 2534083035, 2017157826, 1283959064, 2746728961,
+    235166699, 3778294002, 3582524200, 985174065, 3169938588, 1405159301, 1736297567, 2286790470,
+    1845642228, 2167548141, 3046040375, 1522436142, 3707204739, 868687770, 125555776, 3897278297,
+    3456658389, 557318348, 361024278, 4206141455, 2096979106, 2479699899, 2809265249, 1212258168,
+    2920182730, 1094588627, 1971507977, 2595403792, 486229181, 4090179492, 3346523262, 675778407,
+    2347781478, 1690314367, 1350364581, 3209463484, 956660241, 3593801992, 3800685266, 230273483,
+    3958789497, 80100960, 813364666, 3746209443, 1493393934, 3056797975, 2190459597, 1841277396,
+    1274838360, 2764838465, 2423315867, 2134947458, 4178135599, 372842806, 579201772, 3451224565,
+    737830215, 3301576286, 4034315652, 524725917, 2567918128, 1983854889, 1115943667, 2914228714,
+    470333398, 4080590031, 3347322645, 682916876, 2935849121, 1104014264, 1970348130, 2587970427,
+    2081337289, 2470364368, 2810318602, 1219650579, 3472595134, 567014311, 360134781, 4198978404,
+    3691284456, 859106545, 126363435, 3904392242, 1861333151, 2176965510, 3044872284, 1515027269,
+    3154288631, 1395848430, 1737375540, 2294174765, 251111552, 3787965337, 3581610051, 978019162,
+    2583470427, 1993132610, 1114636696, 2906679937, 722048556, 3292134709, 4035262191, 531979766,
+    4193958212, 382390877, 578165127, 3443946142, 1259310643, 2755650858, 2424516336, 2142455273,
+    1508938085, 3066100348, 2189177254, 1833720511, 3943015954, 70634763, 814286545, 3753471432,
+    972458362, 3603358307, 3799656889, 222970528, 2332278285, 1681118484, 1351556814, 3216995799,
+    302836797, 4248602404, 3380628734, 649078759, 2700729162, 1338617939, 2071296905, 2487554192,
+    1913320482, 2637864763, 2844153057, 1186349048, 3237987157, 802138188, 460546966, 4098033807,
+    3523271683, 1026602778, 160201920, 3871086553, 1626729332, 2412085357, 3145288631, 1414078638,
+    2986787868, 1563864837, 1770677471, 2260340678, 15987563, 4022573170, 3682554792, 877607089,
+    2549676720, 2026410409, 1282693747, 2739155306, 621661639, 3393038046, 4269894916, 296814109,
+    4160676527, 416188854, 745685612, 3275893109, 1158403544, 2856042177, 2659677467, 1907826178,
+    1475660430, 3099894167, 2356701773, 1665663316, 3842113017, 171022048, 1049451834, 3518838307,
+    938660497, 3636640136, 3967709778, 55449931, 2231887334, 1782025983, 1586185509, 2981834300,
+  }, {
+    0, 1745038536, 3490077072, 3087365464, 2782971345, 3454265625, 1978047553, 501592201,
+    1311636819, 640602523, 2653660355, 4129851403, 3956095106, 2211320906, 1003184402, 1405636058,
+    2623273638, 4099462766, 1281205046, 610177022, 968572791, 1371018175, 3921503975, 2176731695,
+    3530950645, 3128240957, 40918629, 1785950893, 2006368804, 529919724, 2811272116, 3482564476,
+    1029407677, 1431875445, 3982350893, 2237593317, 2562410092, 4038617764, 1220354044, 549335860,
+    1937145582, 460673574, 2742036350, 3413314486, 3600202559, 3197474807, 110158511, 1855180391,
+    2701162779, 3372438995, 1896226955, 419761219, 81837258, 1826852866, 3571901786, 3169175954,
+    4012737608, 2267981952, 1059839448, 1462300944, 1254965657, 583953745, 2597001225, 4073206977,
+    2058815354, 313797554, 2863750890, 3266474530, 3747070635, 3075796579, 257006395, 1733474291,
+    882571817, 1553585889, 3835470777, 2359267185, 2440708088, 4185461552, 1098671720, 696208032,
+    3874291164, 2398081300, 921347148, 1592363140, 1124874253, 722408645, 2466931101, 4211690837,
+    2831220879, 3233950791, 2026330399, 281310679, 220317022, 1696786838, 3710360782, 3039080454,
+    1206682823, 804235279, 2548751703, 4293521823, 3792453910, 2316266974, 839522438, 1510552654,
+    163674516, 1640125788, 3653705732, 2982415564, 2887892037, 3290599565, 2082989525, 337955101,
+    3686235745, 3014939305, 196159473, 1672612665, 2119678896, 374642552, 2924601888, 3327315688,
+    2509931314, 4254707706, 1167907490, 765458026, 813319907, 1484352043, 3766230899, 2290037691,
+    4117630708, 2641175100, 627595108, 1298889644, 1351535397, 948824045, 2156434101, 3901472381,
+    3141792679, 3544244079, 1799727671, 54953727, 514012790, 1990204094, 3466948582, 2795914030,
+    1765143634, 20371610, 3107171778, 3509616906, 3436523907, 2765495627, 483616787, 1959806171,
+    655886593, 1327179209, 4145959057, 2669509721, 2197343440, 3942375448, 1392416064, 989706632,
+    3358952777, 2687934849, 406050009, 1882257425, 1842694296, 97936464, 3184726280, 3587194304,
+    2249748506, 3994770642, 1444817290, 1042089282, 603502027, 1274779907, 4093570139, 2617098387,
+    1416525807, 1013799719, 2221420159, 3966436023, 4052660798, 2576195318, 562621358, 1233897318,
+    440634044, 1916839540, 3393573676, 2722562020, 3215150957, 3617612709, 1873090301, 128334389,
+    2413365646, 3889833286, 1608470558, 937196758, 708430943, 1111154839, 4198471119, 2453453063,
+    3254056157, 2851592213, 301116749, 2045870469, 1679044876, 202841540, 3021105308, 3692119124,
+    327349032, 2072109024, 3280251576, 2877785712, 3059889913, 3730905649, 1717858153, 241648545,
+    1571753595, 900473523, 2376685547, 3853155107, 4165979050, 2420959074, 675910202, 1078640370,
+    2994899507, 3665929979, 1652872099, 176684907, 392318946, 2137088810, 3345225330, 2942778042,
+    4239357792, 2494323624, 749285104, 1151992376, 1498395313, 827104889, 2303322913, 3779774441,
+    786002069, 1188715613, 4276037893, 2531001805, 2335814980, 3812268428, 1530916052, 859619356,
+    1626639814, 150446350, 2968704086, 3639736478, 3306440727, 2903991519, 353505671, 2098281807,
+  }, {
+    0, 1228700967, 2457401934, 3678701417, 555582061, 1747058506, 3009771555, 4200137988,
+    1111164122, 185039357, 3494117012, 2575270835, 1663469239, 706411408, 4049501433, 3093430750,
+    2222328244, 3444208787, 370078714, 1597148893, 2775288793, 3965187838, 924021143, 2117012656,
+    3326938478, 2406576201, 1412822816, 487164423, 3880816387, 2926375460, 1965585741, 1007945834,
+    218129817, 1144789182, 2675482583, 3594838768, 740157428, 1696701139, 3194297786, 4149829789,
+    1329291587, 101129316, 3712195341, 2491409962, 1848042286, 656055817, 4234025312, 3043124295,
+    2306239533, 3226079498, 453940835, 1379068740, 2825645632, 3780612967, 974328846, 1932486953,
+    3410847991, 2188449232, 1496683193, 269086622, 3931171482, 2741802941, 2015891668, 823422451,
+    436259634, 1396487701, 2289578364, 3242478683, 991775071, 1914778744, 2842014481, 3763981878,
+    1480314856, 285717199, 3393402278, 2206156929, 2032553349, 807022754, 3948853195, 2724383468,
+    2658583174, 3612000161, 202258632, 1160922607, 3211477227, 4132912588, 756267685, 1680852866,
+    3696084572, 2507258747, 1312111634, 118047029, 4249895985, 3026991382, 1864941183, 638894936,
+    385920683, 1581044620, 2239255781, 3427019202, 907881670, 2132890081, 2758137480, 3982076847,
+    1429973617, 470275926, 3343077439, 2390699288, 1948657692, 1025135931, 3864973906, 2942480245,
+    2474026783, 3662338616, 17718609, 1211244662, 2993366386, 4216805461, 538173244, 1764729371,
+    3511526341, 2557599458, 1127569803, 168371372, 4031783336, 3110886543, 1646844902, 722773697,
+    872519268, 2101209923, 2792975402, 4014280973, 354161673, 1545627950, 2271538759, 3461911392,
+    1983550142, 1057419161, 3829557488, 2910721495, 1462178003, 505114100, 3311397533, 2355337146,
+    2960629712, 4182500087, 571434398, 1798510777, 2439650749, 3629539482, 51570675, 1244568276,
+    4065106698, 3144738349, 1614045508, 688397411, 3545307495, 2590860352, 1093264169, 135634446,
+    956429309, 1883082458, 2876836275, 3796202644, 404517264, 1361054903, 2321845214, 3277387513,
+    2067461927, 839289344, 3913420137, 2692640846, 1512535370, 320538733, 3361705732, 2170810915,
+    3178756681, 4098590574, 789512199, 1714650400, 2624223268, 3579184387, 236094058, 1194262349,
+    4283235987, 3060827060, 1832125661, 604535290, 3729882366, 2540503513, 1277789872, 85326743,
+    771841366, 1732059249, 3162089240, 4114995775, 253550395, 1176543772, 2640586101, 3562559570,
+    1815763340, 621159595, 4265780162, 3078545125, 1294457825, 68921030, 3747553711, 2523094152,
+    2859947234, 3813353925, 940551852, 1899221899, 2339034767, 3260459944, 420621505, 1345212902,
+    3897315384, 2708483359, 2050271862, 856217425, 3377582677, 2154671986, 1529423899, 303387964,
+    587282639, 1782400488, 2977546881, 4165320614, 35437218, 1260439429, 2422489324, 3646438859,
+    1631206421, 671498546, 4081239643, 3128867708, 1076346488, 152814431, 3529458742, 2606971153,
+    2809606523, 3997912156, 890227509, 2083763730, 2255139606, 3478572593, 336742744, 1563309183,
+    3846976929, 2893039750, 1999949807, 1040757448, 3293689804, 2372782827, 1445547394, 521482405,
+  },
+};
+
+static const uint8_t
+WUFFS_CRC32__CASTAGNOLI_X86_SSE42_SHIFT_1024[16] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  53, 97, 27, 165, 0, 0, 0, 0,
+  250, 118, 0, 23, 0, 0, 0, 0,
+};
+
+static const uint8_t
+WUFFS_CRC32__CASTAGNOLI_X86_SSE42_SHIFT_128[16] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  134, 43, 224, 185, 0, 0, 0, 0,
+  146, 96, 59, 13, 0, 0, 0, 0,
+};
+
 static const uint32_t
 WUFFS_CRC32__IEEE_TABLE[16][256] WUFFS_BASE__POTENTIALLY_UNUSED = {
   {
@@ -24785,6 +28902,38 @@ WUFFS_CRC32__IEEE_TABLE[16][256] WUFFS_BASE__POTENTIALLY_UNUSED = {
   },
 };
 
+static const uint32_t
+WUFFS_CRC32__IEEE_X2N_TABLE[32] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  1073741824, 536870912, 134217728, 8388608, 32768, 3988292384, 2984685714, 2691310871,
+  3982654894, 2295415911, 3619421802, 3963911953, 2390663536, 1680310286, 1296546528, 167662735,
+  2206543119, 808857370, 2069535939, 838779241, 2683044394, 1821240772, 366380877, 1608415822,
+  3134787127, 776888047, 1319870996, 2829349568, 1117427358, 344797226, 3289097936, 3303156796,
+};
+
+static const uint8_t
+WUFFS_CRC32__IEEE_X86_AVX512_K1K2[64] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  138, 119, 66, 21, 1, 0, 0, 0,
+  48, 20, 45, 50, 1, 0, 0, 0,
+  138, 119, 66, 21, 1, 0, 0, 0,
+  48, 20, 45, 50, 1, 0, 0, 0,
+  138, 119, 66, 21, 1, 0, 0, 0,
+  48, 20, 45, 50, 1, 0, 0, 0,
+  138, 119, 66, 21, 1, 0, 0, 0,
+  48, 20, 45, 50, 1, 0, 0, 0,
+};
+
+static const uint8_t
+WUFFS_CRC32__IEEE_X86_AVX512_K1K2_512[64] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  212, 43, 68, 84, 1, 0, 0, 0,
+  150, 21, 228, 198, 1, 0, 0, 0,
+  212, 43, 68, 84, 1, 0, 0, 0,
+  150, 21, 228, 198, 1, 0, 0, 0,
+  212, 43, 68, 84, 1, 0, 0, 0,
+  150, 21, 228, 198, 1, 0, 0, 0,
+  212, 43, 68, 84, 1, 0, 0, 0,
+  150, 21, 228, 198, 1, 0, 0, 0,
+};
+
 static const uint8_t
 WUFFS_CRC32__IEEE_X86_SSE42_K1K2[16] WUFFS_BASE__POTENTIALLY_UNUSED = {
   212, 43, 68, 84, 1, 0, 0, 0,
@@ -24813,6 +28962,29 @@ WUFFS_CRC32__IEEE_X86_SSE42_PXMU[16] WUFFS_BASE__POTENTIALLY_UNUSED = {
 
 // ---------------- Private Function Prototypes
 
+static wuffs_base__empty_struct
+wuffs_crc32__castagnoli_hasher__up(
+    wuffs_crc32__castagnoli_hasher* self,
+    wuffs_base__slice_u8 a_x);
+
+static wuffs_base__empty_struct
+wuffs_crc32__castagnoli_hasher__up__choosy_default(
+    wuffs_crc32__castagnoli_hasher* self,
+    wuffs_base__slice_u8 a_x);
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+static wuffs_base__empty_struct
+wuffs_crc32__castagnoli_hasher__up_x86_sse42(
+    wuffs_crc32__castagnoli_hasher* self,
+    wuffs_base__slice_u8 a_x);
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+
+static uint32_t
+wuffs_crc32__ieee_hasher__multiply_mod_p(
+    const wuffs_crc32__ieee_hasher* self,
+    uint32_t a_a,
+    uint32_t a_b);
+
 static wuffs_base__empty_struct
 wuffs_crc32__ieee_hasher__up(
     wuffs_crc32__ieee_hasher* self,
@@ -24837,6 +29009,13 @@ wuffs_crc32__ieee_hasher__up_x86_avx2(
     wuffs_base__slice_u8 a_x);
 #endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
 
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+static wuffs_base__empty_struct
+wuffs_crc32__ieee_hasher__up_x86_avx512(
+    wuffs_crc32__ieee_hasher* self,
+    wuffs_base__slice_u8 a_x);
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
 static wuffs_base__empty_struct
 wuffs_crc32__ieee_hasher__up_x86_sse42(
@@ -24846,6 +29025,15 @@ wuffs_crc32__ieee_hasher__up_x86_sse42(
 
 // ---------------- VTables
 
+const wuffs_base__hasher_u32__func_ptrs
+wuffs_crc32__castagnoli_hasher__func_ptrs_for__wuffs_base__hasher_u32 = {
+  (wuffs_base__empty_struct(*)(void*,
+      uint32_t,
+      bool))(&wuffs_crc32__castagnoli_hasher__set_quirk_enabled),
+  (uint32_t(*)(void*,
+      wuffs_base__slice_u8))(&wuffs_crc32__castagnoli_hasher__update_u32),
+};
+
 const wuffs_base__hasher_u32__func_ptrs
 wuffs_crc32__ieee_hasher__func_ptrs_for__wuffs_base__hasher_u32 = {
   (wuffs_base__empty_struct(*)(void*,
@@ -24857,6 +29045,75 @@ wuffs_crc32__ieee_hasher__func_ptrs_for__wuffs_base__hasher_u32 = {
 
 // ---------------- Initializer Implementations
 
+wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
+wuffs_crc32__castagnoli_hasher__initialize(
+    wuffs_crc32__castagnoli_hasher* self,
+    size_t sizeof_star_self,
+    uint64_t wuffs_version,
+    uint32_t options){
+  if (!self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+  }
+  if (sizeof(*self) != sizeof_star_self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_sizeof_receiver);
+  }
+  if (((wuffs_version >> 32) != WUFFS_VERSION_MAJOR) ||
+      (((wuffs_version >> 16) & 0xFFFF) > WUFFS_VERSION_MINOR)) {
+    return wuffs_base__make_status(wuffs_base__error__bad_wuffs_version);
+  }
+
+  if ((options & WUFFS_INITIALIZE__ALREADY_ZEROED) != 0) {
+    // The whole point of this if-check is to detect an uninitialized *self.
+    // We disable the warning on GCC. Clang-5.0 does not have this warning.
+#if !defined(__clang__) && defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+    if (self->private_impl.magic != 0) {
+      return wuffs_base__make_status(wuffs_base__error__initialize_falsely_claimed_already_zeroed);
+    }
+#if !defined(__clang__) && defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+  } else {
+    if ((options & WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED) == 0) {
+      memset(self, 0, sizeof(*self));
+      options |= WUFFS_INITIALIZE__ALREADY_ZEROED;
+    } else {
+      memset(&(self->private_impl), 0, sizeof(self->private_impl));
+    }
+  }
+
+  self->private_impl.choosy_up = &wuffs_crc32__castagnoli_hasher__up__choosy_default;
+
+  self->private_impl.magic = WUFFS_BASE__MAGIC;
+  self->private_impl.vtable_for__wuffs_base__hasher_u32.vtable_name =
+      wuffs_base__hasher_u32__vtable_name;
+  self->private_impl.vtable_for__wuffs_base__hasher_u32.function_pointers =
+      (const void*)(&wuffs_crc32__castagnoli_hasher__func_ptrs_for__wuffs_base__hasher_u32);
+  return wuffs_base__make_status(NULL);
+}
+
+wuffs_crc32__castagnoli_hasher*
+wuffs_crc32__castagnoli_hasher__alloc() {
+  wuffs_crc32__castagnoli_hasher* x =
+      (wuffs_crc32__castagnoli_hasher*)(calloc(sizeof(wuffs_crc32__castagnoli_hasher), 1));
+  if (!x) {
+    return NULL;
+  }
+  if (wuffs_crc32__castagnoli_hasher__initialize(
+      x, sizeof(wuffs_crc32__castagnoli_hasher), WUFFS_VERSION, WUFFS_INITIALIZE__ALREADY_ZEROED).repr) {
+    free(x);
+    return NULL;
+  }
+  return x;
+}
+
+size_t
+sizeof__wuffs_crc32__castagnoli_hasher() {
+  return sizeof(wuffs_crc32__castagnoli_hasher);
+}
+
 wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
 wuffs_crc32__ieee_hasher__initialize(
     wuffs_crc32__ieee_hasher* self,
@@ -24928,6 +29185,239 @@ sizeof__wuffs_crc32__ieee_hasher() {
 
 // ---------------- Function Implementations
 
+// -------- func crc32.castagnoli_hasher.set_quirk_enabled
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_crc32__castagnoli_hasher__set_quirk_enabled(
+    wuffs_crc32__castagnoli_hasher* self,
+    uint32_t a_quirk,
+    bool a_enabled) {
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func crc32.castagnoli_hasher.update_u32
+
+WUFFS_BASE__MAYBE_STATIC uint32_t
+wuffs_crc32__castagnoli_hasher__update_u32(
+    wuffs_crc32__castagnoli_hasher* self,
+    wuffs_base__slice_u8 a_x) {
+  if (!self) {
+    return 0;
+  }
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return 0;
+  }
+
+  if (self->private_impl.f_state == 0) {
+    self->private_impl.choosy_up = (
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+        wuffs_base__cpu_arch__have_x86_sse42() ? &wuffs_crc32__castagnoli_hasher__up_x86_sse42 :
+#endif
+        self->private_impl.choosy_up);
+  }
+  wuffs_crc32__castagnoli_hasher__up(self, a_x);
+  return self->private_impl.f_state;
+}
+
+// -------- func crc32.castagnoli_hasher.up
+
+static wuffs_base__empty_struct
+wuffs_crc32__castagnoli_hasher__up(
+    wuffs_crc32__castagnoli_hasher* self,
+    wuffs_base__slice_u8 a_x) {
+  return (*self->private_impl.choosy_up)(self, a_x);
+}
+
+static wuffs_base__empty_struct
+wuffs_crc32__castagnoli_hasher__up__choosy_default(
+    wuffs_crc32__castagnoli_hasher* self,
+    wuffs_base__slice_u8 a_x) {
+  uint32_t v_s = 0;
+  wuffs_base__slice_u8 v_p = {0};
+
+  v_s = (4294967295 ^ self->private_impl.f_state);
+  {
+    wuffs_base__slice_u8 i_slice_p = a_x;
+    v_p.ptr = i_slice_p.ptr;
+    v_p.len = 8;
+    uint8_t* i_end0_p = v_p.ptr + (((i_slice_p.len - (size_t)(v_p.ptr - i_slice_p.ptr)) / 32) * 32);
+    while (v_p.ptr < i_end0_p) {
+      v_s ^= ((((uint32_t)(v_p.ptr[0])) << 0) |
+          (((uint32_t)(v_p.ptr[1])) << 8) |
+          (((uint32_t)(v_p.ptr[2])) << 16) |
+          (((uint32_t)(v_p.ptr[3])) << 24));
+      v_s = (WUFFS_CRC32__CASTAGNOLI_TABLE[0][v_p.ptr[7]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[1][v_p.ptr[6]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[2][v_p.ptr[5]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[3][v_p.ptr[4]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[4][(255 & (v_s >> 24))] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[5][(255 & (v_s >> 16))] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[6][(255 & (v_s >> 8))] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[7][(255 & (v_s >> 0))]);
+      v_p.ptr += 8;
+      v_s ^= ((((uint32_t)(v_p.ptr[0])) << 0) |
+          (((uint32_t)(v_p.ptr[1])) << 8) |
+          (((uint32_t)(v_p.ptr[2])) << 16) |
+          (((uint32_t)(v_p.ptr[3])) << 24));
+      v_s = (WUFFS_CRC32__CASTAGNOLI_TABLE[0][v_p.ptr[7]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[1][v_p.ptr[6]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[2][v_p.ptr[5]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[3][v_p.ptr[4]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[4][(255 & (v_s >> 24))] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[5][(255 & (v_s >> 16))] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[6][(255 & (v_s >> 8))] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[7][(255 & (v_s >> 0))]);
+      v_p.ptr += 8;
+      v_s ^= ((((uint32_t)(v_p.ptr[0])) << 0) |
+          (((uint32_t)(v_p.ptr[1])) << 8) |
+          (((uint32_t)(v_p.ptr[2])) << 16) |
+          (((uint32_t)(v_p.ptr[3])) << 24));
+      v_s = (WUFFS_CRC32__CASTAGNOLI_TABLE[0][v_p.ptr[7]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[1][v_p.ptr[6]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[2][v_p.ptr[5]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[3][v_p.ptr[4]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[4][(255 & (v_s >> 24))] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[5][(255 & (v_s >> 16))] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[6][(255 & (v_s >> 8))] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[7][(255 & (v_s >> 0))]);
+      v_p.ptr += 8;
+      v_s ^= ((((uint32_t)(v_p.ptr[0])) << 0) |
+          (((uint32_t)(v_p.ptr[1])) << 8) |
+          (((uint32_t)(v_p.ptr[2])) << 16) |
+          (((uint32_t)(v_p.ptr[3])) << 24));
+      v_s = (WUFFS_CRC32__CASTAGNOLI_TABLE[0][v_p.ptr[7]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[1][v_p.ptr[6]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[2][v_p.ptr[5]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[3][v_p.ptr[4]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[4][(255 & (v_s >> 24))] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[5][(255 & (v_s >> 16))] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[6][(255 & (v_s >> 8))] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[7][(255 & (v_s >> 0))]);
+      v_p.ptr += 8;
+    }
+    v_p.len = 8;
+    uint8_t* i_end1_p = v_p.ptr + (((i_slice_p.len - (size_t)(v_p.ptr - i_slice_p.ptr)) / 8) * 8);
+    while (v_p.ptr < i_end1_p) {
+      v_s ^= ((((uint32_t)(v_p.ptr[0])) << 0) |
+          (((uint32_t)(v_p.ptr[1])) << 8) |
+          (((uint32_t)(v_p.ptr[2])) << 16) |
+          (((uint32_t)(v_p.ptr[3])) << 24));
+      v_s = (WUFFS_CRC32__CASTAGNOLI_TABLE[0][v_p.ptr[7]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[1][v_p.ptr[6]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[2][v_p.ptr[5]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[3][v_p.ptr[4]] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[4][(255 & (v_s >> 24))] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[5][(255 & (v_s >> 16))] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[6][(255 & (v_s >> 8))] ^
+          WUFFS_CRC32__CASTAGNOLI_TABLE[7][(255 & (v_s >> 0))]);
+      v_p.ptr += 8;
+    }
+    v_p.len = 1;
+    uint8_t* i_end2_p = i_slice_p.ptr + i_slice_p.len;
+    while (v_p.ptr < i_end2_p) {
+      v_s = (WUFFS_CRC32__CASTAGNOLI_TABLE[0][(((uint8_t)((v_s & 255))) ^ v_p.ptr[0])] ^ (v_s >> 8));
+      v_p.ptr += 1;
+    }
+    v_p.len = 0;
+  }
+  self->private_impl.f_state = (4294967295 ^ v_s);
+  return wuffs_base__make_empty_struct();
+}
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+// -------- func crc32.castagnoli_hasher.up_x86_sse42
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static wuffs_base__empty_struct
+wuffs_crc32__castagnoli_hasher__up_x86_sse42(
+    wuffs_crc32__castagnoli_hasher* self,
+    wuffs_base__slice_u8 a_x) {
+  uint32_t v_s = 0;
+  uint32_t v_s1 = 0;
+  uint32_t v_s2 = 0;
+  wuffs_base__slice_u8 v_p = {0};
+  wuffs_base__slice_u8 v_q0 = {0};
+  wuffs_base__slice_u8 v_q1 = {0};
+  wuffs_base__slice_u8 v_q2 = {0};
+  __m128i v_k = {0};
+  __m128i v_v0 = {0};
+  __m128i v_v1 = {0};
+
+  v_s = (4294967295 ^ self->private_impl.f_state);
+  while ((((uint64_t)(a_x.len)) > 0) && ((7 & ((uint32_t)(0xFFF & (uintptr_t)(a_x.ptr)))) != 0)) {
+    v_s = ((uint32_t)(_mm_crc32_u8((uint32_t)(v_s), (uint8_t)(a_x.ptr[0]))));
+    a_x = wuffs_base__slice_u8__subslice_i(a_x, 1);
+  }
+  v_k = _mm_lddqu_si128((const __m128i*)(const void*)(WUFFS_CRC32__CASTAGNOLI_X86_SSE42_SHIFT_1024));
+  while (((uint64_t)(a_x.len)) >= 3072) {
+    v_q0 = wuffs_base__slice_u8__subslice_ij(a_x, 0, 1024);
+    v_q1 = wuffs_base__slice_u8__subslice_ij(a_x, 1024, 2048);
+    v_q2 = wuffs_base__slice_u8__subslice_ij(a_x, 2048, 3072);
+    a_x = wuffs_base__slice_u8__subslice_i(a_x, 3072);
+    v_s1 = 0;
+    v_s2 = 0;
+    while ((((uint64_t)(v_q0.len)) >= 8) && (((uint64_t)(v_q1.len)) >= 8) && (((uint64_t)(v_q2.len)) >= 8)) {
+      v_s = ((uint32_t)(_mm_crc32_u64((uint64_t)(v_s), (uint64_t)(wuffs_base__peek_u64le__no_bounds_check(v_q0.ptr)))));
+      v_s1 = ((uint32_t)(_mm_crc32_u64((uint64_t)(v_s1), (uint64_t)(wuffs_base__peek_u64le__no_bounds_check(v_q1.ptr)))));
+      v_s2 = ((uint32_t)(_mm_crc32_u64((uint64_t)(v_s2), (uint64_t)(wuffs_base__peek_u64le__no_bounds_check(v_q2.ptr)))));
+      v_q0 = wuffs_base__slice_u8__subslice_i(v_q0, 8);
+      v_q1 = wuffs_base__slice_u8__subslice_i(v_q1, 8);
+      v_q2 = wuffs_base__slice_u8__subslice_i(v_q2, 8);
+    }
+    v_v0 = _mm_cvtsi32_si128((int32_t)(v_s));
+    v_v1 = _mm_cvtsi32_si128((int32_t)(v_s1));
+    v_v0 = _mm_clmulepi64_si128(v_v0, v_k, (int32_t)(0));
+    v_v1 = _mm_clmulepi64_si128(v_v1, v_k, (int32_t)(16));
+    v_v0 = _mm_xor_si128(v_v0, v_v1);
+    v_s = (v_s2 ^ ((uint32_t)(_mm_crc32_u64((uint64_t)(0), (uint64_t)(((uint64_t)(_mm_cvtsi128_si64(v_v0))))))));
+  }
+  v_k = _mm_lddqu_si128((const __m128i*)(const void*)(WUFFS_CRC32__CASTAGNOLI_X86_SSE42_SHIFT_128));
+  while (((uint64_t)(a_x.len)) >= 384) {
+    v_q0 = wuffs_base__slice_u8__subslice_ij(a_x, 0, 128);
+    v_q1 = wuffs_base__slice_u8__subslice_ij(a_x, 128, 256);
+    v_q2 = wuffs_base__slice_u8__subslice_ij(a_x, 256, 384);
+    a_x = wuffs_base__slice_u8__subslice_i(a_x, 384);
+    v_s1 = 0;
+    v_s2 = 0;
+    while ((((uint64_t)(v_q0.len)) >= 8) && (((uint64_t)(v_q1.len)) >= 8) && (((uint64_t)(v_q2.len)) >= 8)) {
+      v_s = ((uint32_t)(_mm_crc32_u64((uint64_t)(v_s), (uint64_t)(wuffs_base__peek_u64le__no_bounds_check(v_q0.ptr)))));
+      v_s1 = ((uint32_t)(_mm_crc32_u64((uint64_t)(v_s1), (uint64_t)(wuffs_base__peek_u64le__no_bounds_check(v_q1.ptr)))));
+      v_s2 = ((uint32_t)(_mm_crc32_u64((uint64_t)(v_s2), (uint64_t)(wuffs_base__peek_u64le__no_bounds_check(v_q2.ptr)))));
+      v_q0 = wuffs_base__slice_u8__subslice_i(v_q0, 8);
+      v_q1 = wuffs_base__slice_u8__subslice_i(v_q1, 8);
+      v_q2 = wuffs_base__slice_u8__subslice_i(v_q2, 8);
+    }
+    v_v0 = _mm_cvtsi32_si128((int32_t)(v_s));
+    v_v1 = _mm_cvtsi32_si128((int32_t)(v_s1));
+    v_v0 = _mm_clmulepi64_si128(v_v0, v_k, (int32_t)(0));
+    v_v1 = _mm_clmulepi64_si128(v_v1, v_k, (int32_t)(16));
+    v_v0 = _mm_xor_si128(v_v0, v_v1);
+    v_s = (v_s2 ^ ((uint32_t)(_mm_crc32_u64((uint64_t)(0), (uint64_t)(((uint64_t)(_mm_cvtsi128_si64(v_v0))))))));
+  }
+  {
+    wuffs_base__slice_u8 i_slice_p = a_x;
+    v_p.ptr = i_slice_p.ptr;
+    v_p.len = 8;
+    uint8_t* i_end0_p = v_p.ptr + (((i_slice_p.len - (size_t)(v_p.ptr - i_slice_p.ptr)) / 8) * 8);
+    while (v_p.ptr < i_end0_p) {
+      v_s = ((uint32_t)(_mm_crc32_u64((uint64_t)(v_s), (uint64_t)(wuffs_base__peek_u64le__no_bounds_check(v_p.ptr)))));
+      v_p.ptr += 8;
+    }
+    v_p.len = 1;
+    uint8_t* i_end1_p = i_slice_p.ptr + i_slice_p.len;
+    while (v_p.ptr < i_end1_p) {
+      v_s = ((uint32_t)(_mm_crc32_u8((uint32_t)(v_s), (uint8_t)(v_p.ptr[0]))));
+      v_p.ptr += 1;
+    }
+    v_p.len = 0;
+  }
+  self->private_impl.f_state = (4294967295 ^ v_s);
+  return wuffs_base__make_empty_struct();
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
+
 // -------- func crc32.ieee_hasher.set_quirk_enabled
 
 WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
@@ -24956,6 +29446,9 @@ wuffs_crc32__ieee_hasher__update_u32(
 #if defined(WUFFS_BASE__CPU_ARCH__ARM_CRC32)
         wuffs_base__cpu_arch__have_arm_crc32() ? &wuffs_crc32__ieee_hasher__up_arm_crc32 :
 #endif
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+        wuffs_base__cpu_arch__have_x86_avx512() ? &wuffs_crc32__ieee_hasher__up_x86_avx512 :
+#endif
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
         wuffs_base__cpu_arch__have_x86_avx2() ? &wuffs_crc32__ieee_hasher__up_x86_avx2 :
 #endif
@@ -24968,6 +29461,66 @@ wuffs_crc32__ieee_hasher__update_u32(
   return self->private_impl.f_state;
 }
 
+// -------- func crc32.ieee_hasher.combine_u32
+
+WUFFS_BASE__MAYBE_STATIC uint32_t
+wuffs_crc32__ieee_hasher__combine_u32(
+    const wuffs_crc32__ieee_hasher* self,
+    uint32_t a_crc_a,
+    uint32_t a_crc_b,
+    uint64_t a_length_b) {
+  if (!self) {
+    return 0;
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return 0;
+  }
+
+  uint32_t v_p = 0;
+  uint64_t v_n = 0;
+  uint32_t v_k = 0;
+
+  v_p = 2147483648;
+  v_n = a_length_b;
+  v_k = 3;
+  while (v_n > 0) {
+    if ((v_n & 1) != 0) {
+      v_p = wuffs_crc32__ieee_hasher__multiply_mod_p(self, WUFFS_CRC32__IEEE_X2N_TABLE[(v_k & 31)], v_p);
+    }
+    v_n >>= 1;
+    v_k += 1;
+  }
+  return (wuffs_crc32__ieee_hasher__multiply_mod_p(self, v_p, a_crc_a) ^ a_crc_b);
+}
+
+// -------- func crc32.ieee_hasher.multiply_mod_p
+
+static uint32_t
+wuffs_crc32__ieee_hasher__multiply_mod_p(
+    const wuffs_crc32__ieee_hasher* self,
+    uint32_t a_a,
+    uint32_t a_b) {
+  uint32_t v_p = 0;
+  uint32_t v_b = 0;
+  uint32_t v_m = 0;
+
+  v_b = a_b;
+  v_m = 2147483648;
+  while (v_m > 0) {
+    if ((a_a & v_m) != 0) {
+      v_p ^= v_b;
+    }
+    if ((v_b & 1) != 0) {
+      v_b = ((v_b >> 1) ^ 3988292384);
+    } else {
+      v_b >>= 1;
+    }
+    v_m >>= 1;
+  }
+  return v_p;
+}
+
 // -------- func crc32.ieee_hasher.up
 
 static wuffs_base__empty_struct
@@ -25265,6 +29818,158 @@ wuffs_crc32__ieee_hasher__up_x86_avx2(
 #endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
 // ‼ WUFFS MULTI-FILE SECTION -x86_avx2
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_avx512
+// -------- func crc32.ieee_hasher.up_x86_avx512
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2,avx2,avx512f,avx512bw,avx512vl,vpclmulqdq")
+static wuffs_base__empty_struct
+wuffs_crc32__ieee_hasher__up_x86_avx512(
+    wuffs_crc32__ieee_hasher* self,
+    wuffs_base__slice_u8 a_x) {
+  uint32_t v_s = 0;
+  wuffs_base__slice_u8 v_p = {0};
+  __m512i v_k = {0};
+  __m512i v_x0 = {0};
+  __m512i v_x1 = {0};
+  __m512i v_x2 = {0};
+  __m512i v_x3 = {0};
+  __m512i v_y0 = {0};
+  __m512i v_y1 = {0};
+  __m512i v_y2 = {0};
+  __m512i v_y3 = {0};
+  __m128i v_k128 = {0};
+  __m128i v_a0 = {0};
+  __m128i v_a1 = {0};
+  __m128i v_a2 = {0};
+  __m128i v_a3 = {0};
+  __m128i v_b0 = {0};
+  uint64_t v_tail_index = 0;
+
+  v_s = (4294967295 ^ self->private_impl.f_state);
+  while ((((uint64_t)(a_x.len)) > 0) && ((63 & ((uint32_t)(0xFFF & (uintptr_t)(a_x.ptr)))) != 0)) {
+    v_s = (WUFFS_CRC32__IEEE_TABLE[0][(((uint8_t)((v_s & 255))) ^ a_x.ptr[0])] ^ (v_s >> 8));
+    a_x = wuffs_base__slice_u8__subslice_i(a_x, 1);
+  }
+  if (((uint64_t)(a_x.len)) >= 256) {
+    v_x0 = _mm512_loadu_si512((const void*)(a_x.ptr + 0));
+    v_x1 = _mm512_loadu_si512((const void*)(a_x.ptr + 64));
+    v_x2 = _mm512_loadu_si512((const void*)(a_x.ptr + 128));
+    v_x3 = _mm512_loadu_si512((const void*)(a_x.ptr + 192));
+    v_x0 = _mm512_xor_si512(v_x0, _mm512_maskz_set1_epi32(0x0001, (int32_t)(v_s)));
+    v_k = _mm512_loadu_si512((const void*)(WUFFS_CRC32__IEEE_X86_AVX512_K1K2));
+    {
+      wuffs_base__slice_u8 i_slice_p = wuffs_base__slice_u8__subslice_i(a_x, 256);
+      v_p.ptr = i_slice_p.ptr;
+      v_p.len = 256;
+      uint8_t* i_end0_p = v_p.ptr + (((i_slice_p.len - (size_t)(v_p.ptr - i_slice_p.ptr)) / 256) * 256);
+      while (v_p.ptr < i_end0_p) {
+        v_y0 = _mm512_clmulepi64_epi128(v_x0, v_k, (int32_t)(0));
+        v_y1 = _mm512_clmulepi64_epi128(v_x1, v_k, (int32_t)(0));
+        v_y2 = _mm512_clmulepi64_epi128(v_x2, v_k, (int32_t)(0));
+        v_y3 = _mm512_clmulepi64_epi128(v_x3, v_k, (int32_t)(0));
+        v_x0 = _mm512_clmulepi64_epi128(v_x0, v_k, (int32_t)(17));
+        v_x1 = _mm512_clmulepi64_epi128(v_x1, v_k, (int32_t)(17));
+        v_x2 = _mm512_clmulepi64_epi128(v_x2, v_k, (int32_t)(17));
+        v_x3 = _mm512_clmulepi64_epi128(v_x3, v_k, (int32_t)(17));
+        v_x0 = _mm512_ternarylogic_epi64(v_x0, v_y0, _mm512_loadu_si512((const void*)(v_p.ptr + 0)), (int32_t)(150));
+        v_x1 = _mm512_ternarylogic_epi64(v_x1, v_y1, _mm512_loadu_si512((const void*)(v_p.ptr + 64)), (int32_t)(150));
+        v_x2 = _mm512_ternarylogic_epi64(v_x2, v_y2, _mm512_loadu_si512((const void*)(v_p.ptr + 128)), (int32_t)(150));
+        v_x3 = _mm512_ternarylogic_epi64(v_x3, v_y3, _mm512_loadu_si512((const void*)(v_p.ptr + 192)), (int32_t)(150));
+        v_p.ptr += 256;
+      }
+      v_p.len = 0;
+    }
+    v_k = _mm512_loadu_si512((const void*)(WUFFS_CRC32__IEEE_X86_AVX512_K1K2_512));
+    v_y0 = _mm512_clmulepi64_epi128(v_x0, v_k, (int32_t)(0));
+    v_x0 = _mm512_clmulepi64_epi128(v_x0, v_k, (int32_t)(17));
+    v_x0 = _mm512_ternarylogic_epi64(v_x0, v_y0, v_x1, (int32_t)(150));
+    v_y0 = _mm512_clmulepi64_epi128(v_x0, v_k, (int32_t)(0));
+    v_x0 = _mm512_clmulepi64_epi128(v_x0, v_k, (int32_t)(17));
+    v_x0 = _mm512_ternarylogic_epi64(v_x0, v_y0, v_x2, (int32_t)(150));
+    v_y0 = _mm512_clmulepi64_epi128(v_x0, v_k, (int32_t)(0));
+    v_x0 = _mm512_clmulepi64_epi128(v_x0, v_k, (int32_t)(17));
+    v_x0 = _mm512_ternarylogic_epi64(v_x0, v_y0, v_x3, (int32_t)(150));
+    v_a0 = _mm512_maskz_extracti32x4_epi32((__mmask8)(15), v_x0, (int32_t)(0));
+    v_a1 = _mm512_maskz_extracti32x4_epi32((__mmask8)(15), v_x0, (int32_t)(1));
+    v_a2 = _mm512_maskz_extracti32x4_epi32((__mmask8)(15), v_x0, (int32_t)(2));
+    v_a3 = _mm512_maskz_extracti32x4_epi32((__mmask8)(15), v_x0, (int32_t)(3));
+    v_k128 = _mm_lddqu_si128((const __m128i*)(const void*)(WUFFS_CRC32__IEEE_X86_SSE42_K3K4));
+    v_b0 = _mm_clmulepi64_si128(v_a0, v_k128, (int32_t)(0));
+    v_a0 = _mm_clmulepi64_si128(v_a0, v_k128, (int32_t)(17));
+    v_a0 = _mm_xor_si128(v_a0, v_a1);
+    v_a0 = _mm_xor_si128(v_a0, v_b0);
+    v_b0 = _mm_clmulepi64_si128(v_a0, v_k128, (int32_t)(0));
+    v_a0 = _mm_clmulepi64_si128(v_a0, v_k128, (int32_t)(17));
+    v_a0 = _mm_xor_si128(v_a0, v_a2);
+    v_a0 = _mm_xor_si128(v_a0, v_b0);
+    v_b0 = _mm_clmulepi64_si128(v_a0, v_k128, (int32_t)(0));
+    v_a0 = _mm_clmulepi64_si128(v_a0, v_k128, (int32_t)(17));
+    v_a0 = _mm_xor_si128(v_a0, v_a3);
+    v_a0 = _mm_xor_si128(v_a0, v_b0);
+    v_a1 = _mm_clmulepi64_si128(v_a0, v_k128, (int32_t)(16));
+    v_a2 = _mm_set_epi32((int32_t)(0), (int32_t)(4294967295), (int32_t)(0), (int32_t)(4294967295));
+    v_a0 = _mm_srli_si128(v_a0, (int32_t)(8));
+    v_a0 = _mm_xor_si128(v_a0, v_a1);
+    v_k128 = _mm_lddqu_si128((const __m128i*)(const void*)(WUFFS_CRC32__IEEE_X86_SSE42_K5ZZ));
+    v_a1 = _mm_srli_si128(v_a0, (int32_t)(4));
+    v_a0 = _mm_and_si128(v_a0, v_a2);
+    v_a0 = _mm_clmulepi64_si128(v_a0, v_k128, (int32_t)(0));
+    v_a0 = _mm_xor_si128(v_a0, v_a1);
+    v_k128 = _mm_lddqu_si128((const __m128i*)(const void*)(WUFFS_CRC32__IEEE_X86_SSE42_PXMU));
+    v_a1 = _mm_and_si128(v_a0, v_a2);
+    v_a1 = _mm_clmulepi64_si128(v_a1, v_k128, (int32_t)(16));
+    v_a1 = _mm_and_si128(v_a1, v_a2);
+    v_a1 = _mm_clmulepi64_si128(v_a1, v_k128, (int32_t)(0));
+    v_a0 = _mm_xor_si128(v_a0, v_a1);
+    v_s = ((uint32_t)(_mm_extract_epi32(v_a0, (int32_t)(1))));
+    v_tail_index = (((uint64_t)(a_x.len)) & 18446744073709551360u);
+    if (v_tail_index <= ((uint64_t)(a_x.len))) {
+      a_x = wuffs_base__slice_u8__subslice_i(a_x, v_tail_index);
+    }
+  }
+  {
+    wuffs_base__slice_u8 i_slice_p = a_x;
+    v_p.ptr = i_slice_p.ptr;
+    v_p.len = 16;
+    uint8_t* i_end0_p = v_p.ptr + (((i_slice_p.len - (size_t)(v_p.ptr - i_slice_p.ptr)) / 16) * 16);
+    while (v_p.ptr < i_end0_p) {
+      v_s ^= ((((uint32_t)(v_p.ptr[0])) << 0) |
+          (((uint32_t)(v_p.ptr[1])) << 8) |
+          (((uint32_t)(v_p.ptr[2])) << 16) |
+          (((uint32_t)(v_p.ptr[3])) << 24));
+      v_s = (WUFFS_CRC32__IEEE_TABLE[0][v_p.ptr[15]] ^
+          WUFFS_CRC32__IEEE_TABLE[1][v_p.ptr[14]] ^
+          WUFFS_CRC32__IEEE_TABLE[2][v_p.ptr[13]] ^
+          WUFFS_CRC32__IEEE_TABLE[3][v_p.ptr[12]] ^
+          WUFFS_CRC32__IEEE_TABLE[4][v_p.ptr[11]] ^
+          WUFFS_CRC32__IEEE_TABLE[5][v_p.ptr[10]] ^
+          WUFFS_CRC32__IEEE_TABLE[6][v_p.ptr[9]] ^
+          WUFFS_CRC32__IEEE_TABLE[7][v_p.ptr[8]] ^
+          WUFFS_CRC32__IEEE_TABLE[8][v_p.ptr[7]] ^
+          WUFFS_CRC32__IEEE_TABLE[9][v_p.ptr[6]] ^
+          WUFFS_CRC32__IEEE_TABLE[10][v_p.ptr[5]] ^
+          WUFFS_CRC32__IEEE_TABLE[11][v_p.ptr[4]] ^
+          WUFFS_CRC32__IEEE_TABLE[12][(255 & (v_s >> 24))] ^
+          WUFFS_CRC32__IEEE_TABLE[13][(255 & (v_s >> 16))] ^
+          WUFFS_CRC32__IEEE_TABLE[14][(255 & (v_s >> 8))] ^
+          WUFFS_CRC32__IEEE_TABLE[15][(255 & (v_s >> 0))]);
+      v_p.ptr += 16;
+    }
+    v_p.len = 1;
+    uint8_t* i_end1_p = i_slice_p.ptr + i_slice_p.len;
+    while (v_p.ptr < i_end1_p) {
+      v_s = (WUFFS_CRC32__IEEE_TABLE[0][(((uint8_t)((v_s & 255))) ^ v_p.ptr[0])] ^ (v_s >> 8));
+      v_p.ptr += 1;
+    }
+    v_p.len = 0;
+  }
+  self->private_impl.f_state = (4294967295 ^ v_s);
+  return wuffs_base__make_empty_struct();
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_avx512
+
 // ‼ WUFFS MULTI-FILE SECTION +x86_sse42
 // -------- func crc32.ieee_hasher.up_x86_sse42
 
@@ -25403,10 +30108,13 @@ const char wuffs_deflate__error__bad_literal_length_code_count[] = "#deflate: ba
 const char wuffs_deflate__error__inconsistent_stored_block_length[] = "#deflate: inconsistent stored block length";
 const char wuffs_deflate__error__missing_end_of_block_code[] = "#deflate: missing end-of-block code";
 const char wuffs_deflate__error__no_huffman_codes[] = "#deflate: no Huffman codes";
+const char wuffs_deflate__suspension__block_boundary[] = "$deflate: block boundary";
+const char wuffs_deflate__suspension__ready_to_interleave[] = "$deflate: ready to interleave";
 const char wuffs_deflate__error__internal_error_inconsistent_huffman_decoder_state[] = "#deflate: internal error: inconsistent Huffman decoder state";
 const char wuffs_deflate__error__internal_error_inconsistent_i_o[] = "#deflate: internal error: inconsistent I/O";
 const char wuffs_deflate__error__internal_error_inconsistent_distance[] = "#deflate: internal error: inconsistent distance";
 const char wuffs_deflate__error__internal_error_inconsistent_n_bits[] = "#deflate: internal error: inconsistent n_bits";
+const char wuffs_deflate__error__internal_error_inconsistent_window[] = "#deflate: internal error: inconsistent window";
 
 // ---------------- Private Consts
 
@@ -25473,6 +30181,146 @@ WUFFS_DEFLATE__DCODE_MAGIC_NUMBERS[32] WUFFS_BASE__POTENTIALLY_UNUSED = {
 
 #define WUFFS_DEFLATE__HUFFS_TABLE_MASK 1023
 
+#define WUFFS_DEFLATE__QUIRKS_BASE 867177472
+
+#define WUFFS_DEFLATE__QUIRKS_COUNT 3
+
+static const uint32_t
+WUFFS_DEFLATE__LEVEL_CHAINS[10] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  0, 4, 8, 32, 16, 32, 128, 256,
+  64, 256,
+};
+
+static const uint32_t
+WUFFS_DEFLATE__LEVEL_NICES[10] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  0, 8, 16, 32, 16, 32, 128, 128,
+  128, 258,
+};
+
+static const uint32_t
+WUFFS_DEFLATE__LEVEL_LAZIES[10] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  0, 4, 5, 6, 4, 16, 16, 32,
+  1, 2,
+};
+
+#define WUFFS_DEFLATE__TOO_FAR 4096
+
+static const uint8_t
+WUFFS_DEFLATE__LCODE_FROM_LENGTH_MINUS_3[256] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  0, 1, 2, 3, 4, 5, 6, 7,
+  8, 8, 9, 9, 10, 10, 11, 11,
+  12, 12, 12, 12, 13, 13, 13, 13,
+  14, 14, 14, 14, 15, 15, 15, 15,
+  16, 16, 16, 16, 16, 16, 16, 16,
+  17, 17, 17, 17, 17, 17, 17, 17,
+  18, 18, 18, 18, 18, 18, 18, 18,
+  19, 19, 19, 19, 19, 19, 19, 19,
+  20, 20, 20, 20, 20, 20, 20, 20,
+  20, 20, 20, 20, 20, 20, 20, 20,
+  21, 21, 21, 21, 21, 21, 21, 21,
+  21, 21, 21, 21, 21, 21, 21, 21,
+  22, 22, 22, 22, 22, 22, 22, 22,
+  22, 22, 22, 22, 22, 22, 22, 22,
+  23, 23, 23, 23, 23, 23, 23, 23,
+  23, 23, 23, 23, 23, 23, 23, 23,
+  24, 24, 24, 24, 24, 24, 24, 24,
+  24, 24, 24, 24, 24, 24, 24, 24,
+  24, 24, 24, 24, 24, 24, 24, 24,
+  24, 24, 24, 24, 24, 24, 24, 24,
+  25, 25, 25, 25, 25, 25, 25, 25,
+  25, 25, 25, 25, 25, 25, 25, 25,
+  25, 25, 25, 25, 25, 25, 25, 25,
+  25, 25, 25, 25, 25, 25, 25, 25,
+  26, 26, 26, 26, 26, 26, 26, 26,
+  26, 26, 26, 26, 26, 26, 26, 26,
+  26, 26, 26, 26, 26, 26, 26, 26,
+  26, 26, 26, 26, 26, 26, 26, 26,
+  27, 27, 27, 27, 27, 27, 27, 27,
+  27, 27, 27, 27, 27, 27, 27, 27,
+  27, 27, 27, 27, 27, 27, 27, 27,
+  27, 27, 27, 27, 27, 27, 27, 28,
+};
+
+static const uint8_t
+WUFFS_DEFLATE__DCODE_FROM_DISTANCE_MINUS_1[512] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  0, 1, 2, 3, 4, 4, 5, 5,
+  6, 6, 6, 6, 7, 7, 7, 7,
+  8, 8, 8, 8, 8, 8, 8, 8,
+  9, 9, 9, 9, 9, 9, 9, 9,
+  10, 10, 10, 10, 10, 10, 10, 10,
+  10, 10, 10, 10, 10, 10, 10, 10,
+  11, 11, 11, 11, 11, 11, 11, 11,
+  11, 11, 11, 11, 11, 11, 11, 11,
+  12, 12, 12, 12, 12, 12, 12, 12,
+  12, 12, 12, 12, 12, 12, 12, 12,
+  12, 12, 12, 12, 12, 12, 12, 12,
+  12, 12, 12, 12, 12, 12, 12, 12,
+  13, 13, 13, 13, 13, 13, 13, 13,
+  13, 13, 13, 13, 13, 13, 13, 13,
+  13, 13, 13, 13, 13, 13, 13, 13,
+  13, 13, 13, 13, 13, 13, 13, 13,
+  14, 14, 14, 14, 14, 14, 14, 14,
+  14, 14, 14, 14, 14, 14, 14, 14,
+  14, 14, 14, 14, 14, 14, 14, 14,
+  14, 14, 14, 14, 14, 14, 14, 14,
+  14, 14, 14, 14, 14, 14, 14, 14,
+  14, 14, 14, 14, 14, 14, 14, 14,
+  14, 14, 14, 14, 14, 14, 14, 14,
+  14, 14, 14, 14, 14, 14, 14, 14,
+  15, 15, 15, 15, 15, 15, 15, 15,
+  15, 15, 15, 15, 15, 15, 15, 15,
+  15, 15, 15, 15, 15, 15, 15, 15,
+  15, 15, 15, 15, 15, 15, 15, 15,
+  15, 15, 15, 15, 15, 15, 15, 15,
+  15, 15, 15, 15, 15, 15, 15, 15,
+  15, 15, 15, 15, 15, 15, 15, 15,
+  15, 15, 15, 15, 15, 15, 15, 15,
+  0, 14, 16, 17, 18, 18, 19, 19,
+  20, 20, 20, 20, 21, 21, 21, 21,
+  22, 22, 22, 22, 22, 22, 22, 22,
+  23, 23, 23, 23, 23, 23, 23, 23,
+  24, 24, 24, 24, 24, 24, 24, 24,
+  24, 24, 24, 24, 24, 24, 24, 24,
+  25, 25, 25, 25, 25, 25, 25, 25,
+  25, 25, 25, 25, 25, 25, 25, 25,
+  26, 26, 26, 26, 26, 26, 26, 26,
+  26, 26, 26, 26, 26, 26, 26, 26,
+  26, 26, 26, 26, 26, 26, 26, 26,
+  26, 26, 26, 26, 26, 26, 26, 26,
+  27, 27, 27, 27, 27, 27, 27, 27,
+  27, 27, 27, 27, 27, 27, 27, 27,
+  27, 27, 27, 27, 27, 27, 27, 27,
+  27, 27, 27, 27, 27, 27, 27, 27,
+  28, 28, 28, 28, 28, 28, 28, 28,
+  28, 28, 28, 28, 28, 28, 28, 28,
+  28, 28, 28, 28, 28, 28, 28, 28,
+  28, 28, 28, 28, 28, 28, 28, 28,
+  28, 28, 28, 28, 28, 28, 28, 28,
+  28, 28, 28, 28, 28, 28, 28, 28,
+  28, 28, 28, 28, 28, 28, 28, 28,
+  28, 28, 28, 28, 28, 28, 28, 28,
+  29, 29, 29, 29, 29, 29, 29, 29,
+  29, 29, 29, 29, 29, 29, 29, 29,
+  29, 29, 29, 29, 29, 29, 29, 29,
+  29, 29, 29, 29, 29, 29, 29, 29,
+  29, 29, 29, 29, 29, 29, 29, 29,
+  29, 29, 29, 29, 29, 29, 29, 29,
+  29, 29, 29, 29, 29, 29, 29, 29,
+  29, 29, 29, 29, 29, 29, 29, 29,
+};
+
+static const uint8_t
+WUFFS_DEFLATE__DEBRUIJN_CTZ[64] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  0, 1, 48, 2, 57, 49, 28, 3,
+  61, 58, 50, 42, 38, 29, 17, 4,
+  62, 55, 59, 36, 53, 51, 43, 22,
+  45, 39, 33, 30, 24, 18, 12, 5,
+  63, 47, 56, 27, 60, 41, 37, 16,
+  54, 35, 52, 21, 44, 32, 23, 11,
+  46, 26, 40, 15, 34, 20, 31, 10,
+  25, 14, 19, 9, 13, 8, 7, 6,
+};
+
 // ---------------- Private Initializer Prototypes
 
 // ---------------- Private Function Prototypes
@@ -25538,6 +30386,173 @@ wuffs_deflate__decoder__decode_huffman_slow(
     wuffs_base__io_buffer* a_dst,
     wuffs_base__io_buffer* a_src);
 
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__slide(
+    wuffs_deflate__encoder* self);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__compress_chunk(
+    wuffs_deflate__encoder* self,
+    bool a_final);
+
+static uint32_t
+wuffs_deflate__encoder__hash(
+    const wuffs_deflate__encoder* self,
+    uint32_t a_p);
+
+static uint32_t
+wuffs_deflate__encoder__insert(
+    wuffs_deflate__encoder* self,
+    uint32_t a_p);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__insert_run(
+    wuffs_deflate__encoder* self,
+    uint32_t a_p,
+    uint32_t a_n,
+    uint32_t a_rem);
+
+static uint32_t
+wuffs_deflate__encoder__dcode(
+    const wuffs_deflate__encoder* self,
+    uint32_t a_dm1);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__record_literal(
+    wuffs_deflate__encoder* self,
+    uint32_t a_b);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__record_match(
+    wuffs_deflate__encoder* self,
+    uint32_t a_len,
+    uint32_t a_dm1);
+
+static uint32_t
+wuffs_deflate__encoder__longest_match(
+    wuffs_deflate__encoder* self,
+    uint32_t a_cur,
+    uint32_t a_head,
+    uint32_t a_max_len,
+    uint32_t a_min_len,
+    uint32_t a_chain,
+    uint32_t a_nice);
+
+static uint32_t
+wuffs_deflate__encoder__longest_match__choosy_default(
+    wuffs_deflate__encoder* self,
+    uint32_t a_cur,
+    uint32_t a_head,
+    uint32_t a_max_len,
+    uint32_t a_min_len,
+    uint32_t a_chain,
+    uint32_t a_nice);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__parse_greedy(
+    wuffs_deflate__encoder* self,
+    uint32_t a_start,
+    uint32_t a_n,
+    uint32_t a_chain,
+    uint32_t a_nice,
+    uint32_t a_max_insert);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__parse_lazy(
+    wuffs_deflate__encoder* self,
+    uint32_t a_start,
+    uint32_t a_n,
+    uint32_t a_chain,
+    uint32_t a_nice,
+    uint32_t a_max_lazy);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__parse_optimal(
+    wuffs_deflate__encoder* self,
+    uint32_t a_start,
+    uint32_t a_n,
+    uint32_t a_chain,
+    uint32_t a_nice,
+    uint32_t a_n_passes);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__opt_walk(
+    wuffs_deflate__encoder* self,
+    uint32_t a_start,
+    uint32_t a_n,
+    bool a_greedy);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__opt_set_costs(
+    wuffs_deflate__encoder* self);
+
+static uint32_t
+wuffs_deflate__encoder__sym_cost(
+    const wuffs_deflate__encoder* self,
+    uint32_t a_len);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__opt_solve(
+    wuffs_deflate__encoder* self,
+    uint32_t a_start,
+    uint32_t a_n,
+    uint32_t a_nice);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__build_huffman(
+    wuffs_deflate__encoder* self,
+    uint32_t a_n,
+    uint32_t a_max_len);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__assign_codes(
+    wuffs_deflate__encoder* self,
+    uint32_t a_n);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__write_bits(
+    wuffs_deflate__encoder* self,
+    uint32_t a_bits,
+    uint32_t a_n_bits);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__write_block(
+    wuffs_deflate__encoder* self,
+    bool a_final,
+    uint32_t a_start,
+    uint32_t a_n,
+    bool a_stored_only);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__write_full_flush(
+    wuffs_deflate__encoder* self);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__finish_block(
+    wuffs_deflate__encoder* self,
+    bool a_final);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__write_syms(
+    wuffs_deflate__encoder* self);
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__flush_bits(
+    wuffs_deflate__encoder* self,
+    uint32_t a_n_bits);
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+static uint32_t
+wuffs_deflate__encoder__longest_match_x86_sse42(
+    wuffs_deflate__encoder* self,
+    uint32_t a_cur,
+    uint32_t a_head,
+    uint32_t a_max_len,
+    uint32_t a_min_len,
+    uint32_t a_chain,
+    uint32_t a_nice);
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+
 // ---------------- VTables
 
 const wuffs_base__io_transformer__func_ptrs
@@ -25552,6 +30567,18 @@ wuffs_deflate__decoder__func_ptrs_for__wuffs_base__io_transformer = {
   (wuffs_base__range_ii_u64(*)(const void*))(&wuffs_deflate__decoder__workbuf_len),
 };
 
+const wuffs_base__io_transformer__func_ptrs
+wuffs_deflate__encoder__func_ptrs_for__wuffs_base__io_transformer = {
+  (wuffs_base__empty_struct(*)(void*,
+      uint32_t,
+      bool))(&wuffs_deflate__encoder__set_quirk_enabled),
+  (wuffs_base__status(*)(void*,
+      wuffs_base__io_buffer*,
+      wuffs_base__io_buffer*,
+      wuffs_base__slice_u8))(&wuffs_deflate__encoder__transform_io),
+  (wuffs_base__range_ii_u64(*)(const void*))(&wuffs_deflate__encoder__workbuf_len),
+};
+
 // ---------------- Initializer Implementations
 
 wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
@@ -25623,6 +30650,75 @@ sizeof__wuffs_deflate__decoder() {
   return sizeof(wuffs_deflate__decoder);
 }
 
+wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
+wuffs_deflate__encoder__initialize(
+    wuffs_deflate__encoder* self,
+    size_t sizeof_star_self,
+    uint64_t wuffs_version,
+    uint32_t options){
+  if (!self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+  }
+  if (sizeof(*self) != sizeof_star_self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_sizeof_receiver);
+  }
+  if (((wuffs_version >> 32) != WUFFS_VERSION_MAJOR) ||
+      (((wuffs_version >> 16) & 0xFFFF) > WUFFS_VERSION_MINOR)) {
+    return wuffs_base__make_status(wuffs_base__error__bad_wuffs_version);
+  }
+
+  if ((options & WUFFS_INITIALIZE__ALREADY_ZEROED) != 0) {
+    // The whole point of this if-check is to detect an uninitialized *self.
+    // We disable the warning on GCC. Clang-5.0 does not have this warning.
+#if !defined(__clang__) && defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+    if (self->private_impl.magic != 0) {
+      return wuffs_base__make_status(wuffs_base__error__initialize_falsely_claimed_already_zeroed);
+    }
+#if !defined(__clang__) && defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+  } else {
+    if ((options & WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED) == 0) {
+      memset(self, 0, sizeof(*self));
+      options |= WUFFS_INITIALIZE__ALREADY_ZEROED;
+    } else {
+      memset(&(self->private_impl), 0, sizeof(self->private_impl));
+    }
+  }
+
+  self->private_impl.choosy_longest_match = &wuffs_deflate__encoder__longest_match__choosy_default;
+
+  self->private_impl.magic = WUFFS_BASE__MAGIC;
+  self->private_impl.vtable_for__wuffs_base__io_transformer.vtable_name =
+      wuffs_base__io_transformer__vtable_name;
+  self->private_impl.vtable_for__wuffs_base__io_transformer.function_pointers =
+      (const void*)(&wuffs_deflate__encoder__func_ptrs_for__wuffs_base__io_transformer);
+  return wuffs_base__make_status(NULL);
+}
+
+wuffs_deflate__encoder*
+wuffs_deflate__encoder__alloc() {
+  wuffs_deflate__encoder* x =
+      (wuffs_deflate__encoder*)(calloc(sizeof(wuffs_deflate__encoder), 1));
+  if (!x) {
+    return NULL;
+  }
+  if (wuffs_deflate__encoder__initialize(
+      x, sizeof(wuffs_deflate__encoder), WUFFS_VERSION, WUFFS_INITIALIZE__ALREADY_ZEROED).repr) {
+    free(x);
+    return NULL;
+  }
+  return x;
+}
+
+size_t
+sizeof__wuffs_deflate__encoder() {
+  return sizeof(wuffs_deflate__encoder);
+}
+
 // ---------------- Function Implementations
 
 // -------- func deflate.decoder.add_history
@@ -25672,6 +30768,75 @@ wuffs_deflate__decoder__set_quirk_enabled(
     wuffs_deflate__decoder* self,
     uint32_t a_quirk,
     bool a_enabled) {
+  if (!self) {
+    return wuffs_base__make_empty_struct();
+  }
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_empty_struct();
+  }
+
+  if (a_quirk >= 867177472) {
+    a_quirk -= 867177472;
+    if (a_quirk < 3) {
+      self->private_impl.f_quirks[a_quirk] = a_enabled;
+    }
+  }
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func deflate.decoder.pending_bits
+
+WUFFS_BASE__MAYBE_STATIC uint32_t
+wuffs_deflate__decoder__pending_bits(
+    const wuffs_deflate__decoder* self) {
+  if (!self) {
+    return 0;
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return 0;
+  }
+
+  return self->private_impl.f_bits;
+}
+
+// -------- func deflate.decoder.num_pending_bits
+
+WUFFS_BASE__MAYBE_STATIC uint32_t
+wuffs_deflate__decoder__num_pending_bits(
+    const wuffs_deflate__decoder* self) {
+  if (!self) {
+    return 0;
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return 0;
+  }
+
+  return self->private_impl.f_n_bits;
+}
+
+// -------- func deflate.decoder.set_pending_bits
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_deflate__decoder__set_pending_bits(
+    wuffs_deflate__decoder* self,
+    uint32_t a_bits,
+    uint32_t a_n_bits) {
+  if (!self) {
+    return wuffs_base__make_empty_struct();
+  }
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_empty_struct();
+  }
+
+  uint32_t v_n = 0;
+
+  if (a_n_bits < 8) {
+    v_n = a_n_bits;
+  }
+  self->private_impl.f_bits = (a_bits & ((((uint32_t)(1)) << v_n) - 1));
+  self->private_impl.f_n_bits = v_n;
   return wuffs_base__make_empty_struct();
 }
 
@@ -25768,7 +30933,9 @@ wuffs_deflate__decoder__transform_io(
         }
         goto ok;
       }
-      wuffs_deflate__decoder__add_history(self, wuffs_base__io__since(v_mark, ((uint64_t)(iop_a_dst - io0_a_dst)), io0_a_dst));
+      if ( ! self->private_impl.f_quirks[2]) {
+        wuffs_deflate__decoder__add_history(self, wuffs_base__io__since(v_mark, ((uint64_t)(iop_a_dst - io0_a_dst)), io0_a_dst));
+      }
       status = v_status;
       WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(1);
     }
@@ -25808,6 +30975,7 @@ wuffs_deflate__decoder__decode_blocks(
   uint32_t v_b0 = 0;
   uint32_t v_type = 0;
   wuffs_base__status v_status = wuffs_base__make_status(NULL);
+  bool v_previous = false;
 
   const uint8_t* iop_a_src = NULL;
   const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
@@ -25823,15 +30991,21 @@ wuffs_deflate__decoder__decode_blocks(
   uint32_t coro_susp_point = self->private_impl.p_decode_blocks[0];
   if (coro_susp_point) {
     v_final = self->private_data.s_decode_blocks[0].v_final;
+    v_previous = self->private_data.s_decode_blocks[0].v_previous;
   }
   switch (coro_susp_point) {
     WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
 
     label__outer__continue:;
     while (v_final == 0) {
+      if (v_previous && self->private_impl.f_quirks[0]) {
+        status = wuffs_base__make_status(wuffs_deflate__suspension__block_boundary);
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(1);
+      }
+      v_previous = true;
       while (self->private_impl.f_n_bits < 3) {
         {
-          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
           if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
             status = wuffs_base__make_status(wuffs_base__suspension__short_read);
             goto suspend;
@@ -25850,7 +31024,7 @@ wuffs_deflate__decoder__decode_blocks(
         if (a_src) {
           a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
         }
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
         status = wuffs_deflate__decoder__decode_uncompressed(self, a_dst, a_src);
         if (a_src) {
           iop_a_src = a_src->data.ptr + a_src->meta.ri;
@@ -25875,7 +31049,7 @@ wuffs_deflate__decoder__decode_blocks(
         if (a_src) {
           a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
         }
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
         status = wuffs_deflate__decoder__init_dynamic_huffman(self, a_src);
         if (a_src) {
           iop_a_src = a_src->data.ptr + a_src->meta.ri;
@@ -25888,6 +31062,19 @@ wuffs_deflate__decoder__decode_blocks(
         goto exit;
       }
       self->private_impl.f_end_of_block = false;
+      while (self->private_impl.f_quirks[1]) {
+        self->private_impl.f_ready_to_interleave = true;
+        self->private_impl.f_interleaved = false;
+        status = wuffs_base__make_status(wuffs_deflate__suspension__ready_to_interleave);
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(5);
+        self->private_impl.f_ready_to_interleave = false;
+        if (self->private_impl.f_end_of_block) {
+          goto label__outer__continue;
+        } else if ( ! self->private_impl.f_interleaved) {
+          goto label__0__break;
+        }
+      }
+      label__0__break:;
       while (true) {
         if (sizeof(void*) == 4) {
           if (a_src) {
@@ -25916,7 +31103,7 @@ wuffs_deflate__decoder__decode_blocks(
         if (a_src) {
           a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
         }
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(6);
         status = wuffs_deflate__decoder__decode_huffman_slow(self, a_dst, a_src);
         if (a_src) {
           iop_a_src = a_src->data.ptr + a_src->meta.ri;
@@ -25939,6 +31126,7 @@ wuffs_deflate__decoder__decode_blocks(
   suspend:
   self->private_impl.p_decode_blocks[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
   self->private_data.s_decode_blocks[0].v_final = v_final;
+  self->private_data.s_decode_blocks[0].v_previous = v_previous;
 
   goto exit;
   exit:
@@ -27672,152 +32860,428 @@ wuffs_deflate__decoder__decode_huffman_slow(
   return status;
 }
 
-#endif  // !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__DEFLATE)
-
-#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__LZW)
-
-// ---------------- Status Codes Implementations
-
-const char wuffs_lzw__error__bad_code[] = "#lzw: bad code";
-const char wuffs_lzw__error__internal_error_inconsistent_i_o[] = "#lzw: internal error: inconsistent I/O";
-
-// ---------------- Private Consts
-
-// ---------------- Private Initializer Prototypes
-
-// ---------------- Private Function Prototypes
-
-static wuffs_base__empty_struct
-wuffs_lzw__decoder__read_from(
-    wuffs_lzw__decoder* self,
-    wuffs_base__io_buffer* a_src);
-
-static wuffs_base__status
-wuffs_lzw__decoder__write_to(
-    wuffs_lzw__decoder* self,
-    wuffs_base__io_buffer* a_dst);
-
-// ---------------- VTables
-
-const wuffs_base__io_transformer__func_ptrs
-wuffs_lzw__decoder__func_ptrs_for__wuffs_base__io_transformer = {
-  (wuffs_base__empty_struct(*)(void*,
-      uint32_t,
-      bool))(&wuffs_lzw__decoder__set_quirk_enabled),
-  (wuffs_base__status(*)(void*,
-      wuffs_base__io_buffer*,
-      wuffs_base__io_buffer*,
-      wuffs_base__slice_u8))(&wuffs_lzw__decoder__transform_io),
-  (wuffs_base__range_ii_u64(*)(const void*))(&wuffs_lzw__decoder__workbuf_len),
-};
-
-// ---------------- Initializer Implementations
+// -------- func deflate.decoder.decode_interleaved
 
-wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
-wuffs_lzw__decoder__initialize(
-    wuffs_lzw__decoder* self,
-    size_t sizeof_star_self,
-    uint64_t wuffs_version,
-    uint32_t options){
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_deflate__decoder__decode_interleaved(
+    wuffs_deflate__decoder* self,
+    wuffs_base__io_buffer* a_dst,
+    wuffs_base__io_buffer* a_src,
+    wuffs_deflate__decoder* a_peer,
+    wuffs_base__io_buffer* a_peer_dst,
+    wuffs_base__io_buffer* a_peer_src) {
   if (!self) {
     return wuffs_base__make_status(wuffs_base__error__bad_receiver);
   }
-  if (sizeof(*self) != sizeof_star_self) {
-    return wuffs_base__make_status(wuffs_base__error__bad_sizeof_receiver);
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_status(
+        (self->private_impl.magic == WUFFS_BASE__DISABLED)
+        ? wuffs_base__error__disabled_by_previous_error
+        : wuffs_base__error__initialize_not_called);
   }
-  if (((wuffs_version >> 32) != WUFFS_VERSION_MAJOR) ||
-      (((wuffs_version >> 16) & 0xFFFF) > WUFFS_VERSION_MINOR)) {
-    return wuffs_base__make_status(wuffs_base__error__bad_wuffs_version);
+  if (!a_dst || !a_src || !a_peer || !a_peer_dst || !a_peer_src) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+    return wuffs_base__make_status(wuffs_base__error__bad_argument);
   }
+  wuffs_base__status status = wuffs_base__make_status(NULL);
 
-  if ((options & WUFFS_INITIALIZE__ALREADY_ZEROED) != 0) {
-    // The whole point of this if-check is to detect an uninitialized *self.
-    // We disable the warning on GCC. Clang-5.0 does not have this warning.
-#if !defined(__clang__) && defined(__GNUC__)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
-#endif
-    if (self->private_impl.magic != 0) {
-      return wuffs_base__make_status(wuffs_base__error__initialize_falsely_claimed_already_zeroed);
+  uint64_t v_bits_a = 0;
+  uint32_t v_n_bits_a = 0;
+  uint64_t v_lmask_a = 0;
+  uint64_t v_dmask_a = 0;
+  uint64_t v_mark_a = 0;
+  bool v_progress_a = false;
+  uint64_t v_bits_b = 0;
+  uint32_t v_n_bits_b = 0;
+  uint64_t v_lmask_b = 0;
+  uint64_t v_dmask_b = 0;
+  uint64_t v_mark_b = 0;
+  bool v_progress_b = false;
+  uint64_t v_saved_bits = 0;
+  uint32_t v_saved_n_bits = 0;
+  bool v_ended = false;
+  uint32_t v_table_entry = 0;
+  uint32_t v_table_entry_n_bits = 0;
+  uint32_t v_redir_top = 0;
+  uint32_t v_redir_mask = 0;
+  uint32_t v_length = 0;
+  uint32_t v_dist_minus_1 = 0;
+
+  uint8_t* iop_a_dst = NULL;
+  uint8_t* io0_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io1_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io2_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_dst) {
+    io0_a_dst = a_dst->data.ptr;
+    io1_a_dst = io0_a_dst + a_dst->meta.wi;
+    iop_a_dst = io1_a_dst;
+    io2_a_dst = io0_a_dst + a_dst->data.len;
+    if (a_dst->meta.closed) {
+      io2_a_dst = iop_a_dst;
     }
-#if !defined(__clang__) && defined(__GNUC__)
-#pragma GCC diagnostic pop
-#endif
-  } else {
-    if ((options & WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED) == 0) {
-      memset(self, 0, sizeof(*self));
-      options |= WUFFS_INITIALIZE__ALREADY_ZEROED;
+  }
+  const uint8_t* iop_a_src = NULL;
+  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_src) {
+    io0_a_src = a_src->data.ptr;
+    io1_a_src = io0_a_src + a_src->meta.ri;
+    iop_a_src = io1_a_src;
+    io2_a_src = io0_a_src + a_src->meta.wi;
+  }
+  uint8_t* iop_a_peer_dst = NULL;
+  uint8_t* io0_a_peer_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io1_a_peer_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io2_a_peer_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_peer_dst) {
+    io0_a_peer_dst = a_peer_dst->data.ptr;
+    io1_a_peer_dst = io0_a_peer_dst + a_peer_dst->meta.wi;
+    iop_a_peer_dst = io1_a_peer_dst;
+    io2_a_peer_dst = io0_a_peer_dst + a_peer_dst->data.len;
+    if (a_peer_dst->meta.closed) {
+      io2_a_peer_dst = iop_a_peer_dst;
+    }
+  }
+  const uint8_t* iop_a_peer_src = NULL;
+  const uint8_t* io0_a_peer_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_a_peer_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_a_peer_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_peer_src) {
+    io0_a_peer_src = a_peer_src->data.ptr;
+    io1_a_peer_src = io0_a_peer_src + a_peer_src->meta.ri;
+    iop_a_peer_src = io1_a_peer_src;
+    io2_a_peer_src = io0_a_peer_src + a_peer_src->meta.wi;
+  }
+
+  if ( ! self->private_impl.f_ready_to_interleave ||  ! a_peer->private_impl.f_ready_to_interleave) {
+    status = wuffs_base__make_status(NULL);
+    goto ok;
+  }
+  if ((self->private_impl.f_n_bits >= 8) ||
+      ((self->private_impl.f_bits >> (self->private_impl.f_n_bits & 7)) != 0) ||
+      (a_peer->private_impl.f_n_bits >= 8) ||
+      ((a_peer->private_impl.f_bits >> (a_peer->private_impl.f_n_bits & 7)) != 0)) {
+    status = wuffs_base__make_status(wuffs_deflate__error__internal_error_inconsistent_n_bits);
+    goto exit;
+  }
+  v_bits_a = ((uint64_t)(self->private_impl.f_bits));
+  v_n_bits_a = self->private_impl.f_n_bits;
+  v_lmask_a = ((((uint64_t)(1)) << self->private_impl.f_n_huffs_bits[0]) - 1);
+  v_dmask_a = ((((uint64_t)(1)) << self->private_impl.f_n_huffs_bits[1]) - 1);
+  v_mark_a = ((uint64_t)(iop_a_dst - io0_a_dst));
+  v_bits_b = ((uint64_t)(a_peer->private_impl.f_bits));
+  v_n_bits_b = a_peer->private_impl.f_n_bits;
+  v_lmask_b = ((((uint64_t)(1)) << a_peer->private_impl.f_n_huffs_bits[0]) - 1);
+  v_dmask_b = ((((uint64_t)(1)) << a_peer->private_impl.f_n_huffs_bits[1]) - 1);
+  v_mark_b = ((uint64_t)(iop_a_peer_dst - io0_a_peer_dst));
+  while ((((uint64_t)(io2_a_dst - iop_a_dst)) >= 266) &&
+      (((uint64_t)(io2_a_src - iop_a_src)) >= 8) &&
+      (((uint64_t)(io2_a_peer_dst - iop_a_peer_dst)) >= 266) &&
+      (((uint64_t)(io2_a_peer_src - iop_a_peer_src)) >= 8)) {
+    v_bits_a |= ((uint64_t)(wuffs_base__peek_u64le__no_bounds_check(iop_a_src) << (v_n_bits_a & 63)));
+    iop_a_src += ((63 - (v_n_bits_a & 63)) >> 3);
+    v_n_bits_a |= 56;
+    v_saved_bits = v_bits_a;
+    v_saved_n_bits = v_n_bits_a;
+    while (true) {
+      v_table_entry = self->private_data.f_huffs[0][(v_bits_a & v_lmask_a)];
+      v_table_entry_n_bits = (v_table_entry & 15);
+      v_bits_a >>= v_table_entry_n_bits;
+      v_n_bits_a -= v_table_entry_n_bits;
+      if ((v_table_entry >> 31) != 0) {
+        (wuffs_base__poke_u8be__no_bounds_check(iop_a_dst, ((uint8_t)(((v_table_entry >> 8) & 255)))), iop_a_dst += 1);
+        goto label__a__break;
+      } else if ((v_table_entry >> 30) != 0) {
+      } else if ((v_table_entry >> 29) != 0) {
+        self->private_impl.f_end_of_block = true;
+        v_ended = true;
+        goto label__loop__break;
+      } else if ((v_table_entry >> 28) != 0) {
+        v_redir_top = ((v_table_entry >> 8) & 65535);
+        v_redir_mask = ((((uint32_t)(1)) << ((v_table_entry >> 4) & 15)) - 1);
+        v_table_entry = self->private_data.f_huffs[0][((v_redir_top + (((uint32_t)((v_bits_a & 4294967295))) & v_redir_mask)) & 1023)];
+        v_table_entry_n_bits = (v_table_entry & 15);
+        v_bits_a >>= v_table_entry_n_bits;
+        v_n_bits_a -= v_table_entry_n_bits;
+        if ((v_table_entry >> 31) != 0) {
+          (wuffs_base__poke_u8be__no_bounds_check(iop_a_dst, ((uint8_t)(((v_table_entry >> 8) & 255)))), iop_a_dst += 1);
+          goto label__a__break;
+        } else if ((v_table_entry >> 30) != 0) {
+        } else if ((v_table_entry >> 29) != 0) {
+          self->private_impl.f_end_of_block = true;
+          v_ended = true;
+          goto label__loop__break;
+        } else {
+          v_bits_a = v_saved_bits;
+          v_n_bits_a = v_saved_n_bits;
+          goto label__loop__break;
+        }
+      } else {
+        v_bits_a = v_saved_bits;
+        v_n_bits_a = v_saved_n_bits;
+        goto label__loop__break;
+      }
+      v_length = (((v_table_entry >> 8) & 255) + 3);
+      v_table_entry_n_bits = ((v_table_entry >> 4) & 15);
+      if (v_table_entry_n_bits > 0) {
+        v_length = (((v_length + 253 + ((uint32_t)(((v_bits_a) & WUFFS_BASE__LOW_BITS_MASK__U64(v_table_entry_n_bits))))) & 255) + 3);
+        v_bits_a >>= v_table_entry_n_bits;
+        v_n_bits_a -= v_table_entry_n_bits;
+      }
+      v_table_entry = self->private_data.f_huffs[1][(v_bits_a & v_dmask_a)];
+      v_table_entry_n_bits = (v_table_entry & 15);
+      v_bits_a >>= v_table_entry_n_bits;
+      v_n_bits_a -= v_table_entry_n_bits;
+      if ((v_table_entry >> 28) == 1) {
+        v_redir_top = ((v_table_entry >> 8) & 65535);
+        v_redir_mask = ((((uint32_t)(1)) << ((v_table_entry >> 4) & 15)) - 1);
+        v_table_entry = self->private_data.f_huffs[1][((v_redir_top + (((uint32_t)((v_bits_a & 4294967295))) & v_redir_mask)) & 1023)];
+        v_table_entry_n_bits = (v_table_entry & 15);
+        v_bits_a >>= v_table_entry_n_bits;
+        v_n_bits_a -= v_table_entry_n_bits;
+      }
+      if ((v_table_entry >> 24) != 64) {
+        v_bits_a = v_saved_bits;
+        v_n_bits_a = v_saved_n_bits;
+        goto label__loop__break;
+      }
+      v_dist_minus_1 = ((v_table_entry >> 8) & 32767);
+      v_table_entry_n_bits = ((v_table_entry >> 4) & 15);
+      v_dist_minus_1 = ((v_dist_minus_1 + ((uint32_t)(((v_bits_a) & WUFFS_BASE__LOW_BITS_MASK__U64(v_table_entry_n_bits))))) & 32767);
+      v_bits_a >>= v_table_entry_n_bits;
+      v_n_bits_a -= v_table_entry_n_bits;
+      if (((uint64_t)((v_dist_minus_1 + 1))) > ((uint64_t)(iop_a_dst - io0_a_dst))) {
+        v_bits_a = v_saved_bits;
+        v_n_bits_a = v_saved_n_bits;
+        goto label__loop__break;
+      }
+      if ((v_dist_minus_1 + 1) >= 8) {
+        wuffs_base__io_writer__limited_copy_u32_from_history_8_byte_chunks_fast(
+            &iop_a_dst, io0_a_dst, io2_a_dst, v_length, (v_dist_minus_1 + 1));
+      } else if ((v_dist_minus_1 + 1) == 1) {
+        wuffs_base__io_writer__limited_copy_u32_from_history_8_byte_chunks_distance_1_fast(
+            &iop_a_dst, io0_a_dst, io2_a_dst, v_length, (v_dist_minus_1 + 1));
+      } else {
+        wuffs_base__io_writer__limited_copy_u32_from_history_fast(
+            &iop_a_dst, io0_a_dst, io2_a_dst, v_length, (v_dist_minus_1 + 1));
+      }
+      goto label__a__break;
+    }
+    label__a__break:;
+    v_progress_a = true;
+    if ((((uint64_t)(io2_a_peer_dst - iop_a_peer_dst)) < 266) || (((uint64_t)(io2_a_peer_src - iop_a_peer_src)) < 8)) {
+      goto label__loop__break;
+    }
+    v_bits_b |= ((uint64_t)(wuffs_base__peek_u64le__no_bounds_check(iop_a_peer_src) << (v_n_bits_b & 63)));
+    iop_a_peer_src += ((63 - (v_n_bits_b & 63)) >> 3);
+    v_n_bits_b |= 56;
+    v_saved_bits = v_bits_b;
+    v_saved_n_bits = v_n_bits_b;
+    while (true) {
+      v_table_entry = a_peer->private_data.f_huffs[0][(v_bits_b & v_lmask_b)];
+      v_table_entry_n_bits = (v_table_entry & 15);
+      v_bits_b >>= v_table_entry_n_bits;
+      v_n_bits_b -= v_table_entry_n_bits;
+      if ((v_table_entry >> 31) != 0) {
+        (wuffs_base__poke_u8be__no_bounds_check(iop_a_peer_dst, ((uint8_t)(((v_table_entry >> 8) & 255)))), iop_a_peer_dst += 1);
+        goto label__b__break;
+      } else if ((v_table_entry >> 30) != 0) {
+      } else if ((v_table_entry >> 29) != 0) {
+        a_peer->private_impl.f_end_of_block = true;
+        v_ended = true;
+        goto label__loop__break;
+      } else if ((v_table_entry >> 28) != 0) {
+        v_redir_top = ((v_table_entry >> 8) & 65535);
+        v_redir_mask = ((((uint32_t)(1)) << ((v_table_entry >> 4) & 15)) - 1);
+        v_table_entry = a_peer->private_data.f_huffs[0][((v_redir_top + (((uint32_t)((v_bits_b & 4294967295))) & v_redir_mask)) & 1023)];
+        v_table_entry_n_bits = (v_table_entry & 15);
+        v_bits_b >>= v_table_entry_n_bits;
+        v_n_bits_b -= v_table_entry_n_bits;
+        if ((v_table_entry >> 31) != 0) {
+          (wuffs_base__poke_u8be__no_bounds_check(iop_a_peer_dst, ((uint8_t)(((v_table_entry >> 8) & 255)))), iop_a_peer_dst += 1);
+          goto label__b__break;
+        } else if ((v_table_entry >> 30) != 0) {
+        } else if ((v_table_entry >> 29) != 0) {
+          a_peer->private_impl.f_end_of_block = true;
+          v_ended = true;
+          goto label__loop__break;
+        } else {
+          v_bits_b = v_saved_bits;
+          v_n_bits_b = v_saved_n_bits;
+          goto label__loop__break;
+        }
+      } else {
+        v_bits_b = v_saved_bits;
+        v_n_bits_b = v_saved_n_bits;
+        goto label__loop__break;
+      }
+      v_length = (((v_table_entry >> 8) & 255) + 3);
+      v_table_entry_n_bits = ((v_table_entry >> 4) & 15);
+      if (v_table_entry_n_bits > 0) {
+        v_length = (((v_length + 253 + ((uint32_t)(((v_bits_b) & WUFFS_BASE__LOW_BITS_MASK__U64(v_table_entry_n_bits))))) & 255) + 3);
+        v_bits_b >>= v_table_entry_n_bits;
+        v_n_bits_b -= v_table_entry_n_bits;
+      }
+      v_table_entry = a_peer->private_data.f_huffs[1][(v_bits_b & v_dmask_b)];
+      v_table_entry_n_bits = (v_table_entry & 15);
+      v_bits_b >>= v_table_entry_n_bits;
+      v_n_bits_b -= v_table_entry_n_bits;
+      if ((v_table_entry >> 28) == 1) {
+        v_redir_top = ((v_table_entry >> 8) & 65535);
+        v_redir_mask = ((((uint32_t)(1)) << ((v_table_entry >> 4) & 15)) - 1);
+        v_table_entry = a_peer->private_data.f_huffs[1][((v_redir_top + (((uint32_t)((v_bits_b & 4294967295))) & v_redir_mask)) & 1023)];
+        v_table_entry_n_bits = (v_table_entry & 15);
+        v_bits_b >>= v_table_entry_n_bits;
+        v_n_bits_b -= v_table_entry_n_bits;
+      }
+      if ((v_table_entry >> 24) != 64) {
+        v_bits_b = v_saved_bits;
+        v_n_bits_b = v_saved_n_bits;
+        goto label__loop__break;
+      }
+      v_dist_minus_1 = ((v_table_entry >> 8) & 32767);
+      v_table_entry_n_bits = ((v_table_entry >> 4) & 15);
+      v_dist_minus_1 = ((v_dist_minus_1 + ((uint32_t)(((v_bits_b) & WUFFS_BASE__LOW_BITS_MASK__U64(v_table_entry_n_bits))))) & 32767);
+      v_bits_b >>= v_table_entry_n_bits;
+      v_n_bits_b -= v_table_entry_n_bits;
+      if (((uint64_t)((v_dist_minus_1 + 1))) > ((uint64_t)(iop_a_peer_dst - io0_a_peer_dst))) {
+        v_bits_b = v_saved_bits;
+        v_n_bits_b = v_saved_n_bits;
+        goto label__loop__break;
+      }
+      if ((v_dist_minus_1 + 1) >= 8) {
+        wuffs_base__io_writer__limited_copy_u32_from_history_8_byte_chunks_fast(
+            &iop_a_peer_dst, io0_a_peer_dst, io2_a_peer_dst, v_length, (v_dist_minus_1 + 1));
+      } else if ((v_dist_minus_1 + 1) == 1) {
+        wuffs_base__io_writer__limited_copy_u32_from_history_8_byte_chunks_distance_1_fast(
+            &iop_a_peer_dst, io0_a_peer_dst, io2_a_peer_dst, v_length, (v_dist_minus_1 + 1));
+      } else {
+        wuffs_base__io_writer__limited_copy_u32_from_history_fast(
+            &iop_a_peer_dst, io0_a_peer_dst, io2_a_peer_dst, v_length, (v_dist_minus_1 + 1));
+      }
+      goto label__b__break;
+    }
+    label__b__break:;
+    v_progress_b = true;
+  }
+  label__loop__break:;
+  if (v_n_bits_a > 63) {
+    status = wuffs_base__make_status(wuffs_deflate__error__internal_error_inconsistent_n_bits);
+    goto exit;
+  }
+  while (v_n_bits_a >= 8) {
+    v_n_bits_a -= 8;
+    if (iop_a_src > io1_a_src) {
+      iop_a_src--;
     } else {
-      memset(&(self->private_impl), 0, sizeof(self->private_impl));
+      status = wuffs_base__make_status(wuffs_deflate__error__internal_error_inconsistent_i_o);
+      goto exit;
+    }
+  }
+  self->private_impl.f_bits = ((uint32_t)((v_bits_a & ((((uint64_t)(1)) << v_n_bits_a) - 1))));
+  self->private_impl.f_n_bits = v_n_bits_a;
+  self->private_impl.f_interleaved = (v_progress_a || (v_ended &&  ! self->private_impl.f_end_of_block));
+  if ( ! self->private_impl.f_quirks[2]) {
+    wuffs_deflate__decoder__add_history(self, wuffs_base__io__since(v_mark_a, ((uint64_t)(iop_a_dst - io0_a_dst)), io0_a_dst));
+  }
+  if (v_n_bits_b > 63) {
+    status = wuffs_base__make_status(wuffs_deflate__error__internal_error_inconsistent_n_bits);
+    goto exit;
+  }
+  while (v_n_bits_b >= 8) {
+    v_n_bits_b -= 8;
+    if (iop_a_peer_src > io1_a_peer_src) {
+      iop_a_peer_src--;
+    } else {
+      status = wuffs_base__make_status(wuffs_deflate__error__internal_error_inconsistent_i_o);
+      goto exit;
     }
   }
+  a_peer->private_impl.f_bits = ((uint32_t)((v_bits_b & ((((uint64_t)(1)) << v_n_bits_b) - 1))));
+  a_peer->private_impl.f_n_bits = v_n_bits_b;
+  a_peer->private_impl.f_interleaved = (v_progress_b || (v_ended &&  ! a_peer->private_impl.f_end_of_block));
+  if ( ! a_peer->private_impl.f_quirks[2]) {
+    wuffs_deflate__decoder__add_history(a_peer, wuffs_base__io__since(v_mark_b, ((uint64_t)(iop_a_peer_dst - io0_a_peer_dst)), io0_a_peer_dst));
+  }
+  status = wuffs_base__make_status(NULL);
+  goto ok;
 
-  self->private_impl.magic = WUFFS_BASE__MAGIC;
-  self->private_impl.vtable_for__wuffs_base__io_transformer.vtable_name =
-      wuffs_base__io_transformer__vtable_name;
-  self->private_impl.vtable_for__wuffs_base__io_transformer.function_pointers =
-      (const void*)(&wuffs_lzw__decoder__func_ptrs_for__wuffs_base__io_transformer);
-  return wuffs_base__make_status(NULL);
+  ok:
+  goto exit;
+  exit:
+  if (a_dst) {
+    a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+  }
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  }
+  if (a_peer_dst) {
+    a_peer_dst->meta.wi = ((size_t)(iop_a_peer_dst - a_peer_dst->data.ptr));
+  }
+  if (a_peer_src) {
+    a_peer_src->meta.ri = ((size_t)(iop_a_peer_src - a_peer_src->data.ptr));
+  }
+
+  if (wuffs_base__status__is_error(&status)) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+  }
+  return status;
 }
 
-wuffs_lzw__decoder*
-wuffs_lzw__decoder__alloc() {
-  wuffs_lzw__decoder* x =
-      (wuffs_lzw__decoder*)(calloc(sizeof(wuffs_lzw__decoder), 1));
-  if (!x) {
-    return NULL;
+// -------- func deflate.encoder.set_level
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_deflate__encoder__set_level(
+    wuffs_deflate__encoder* self,
+    uint32_t a_level) {
+  if (!self) {
+    return wuffs_base__make_empty_struct();
   }
-  if (wuffs_lzw__decoder__initialize(
-      x, sizeof(wuffs_lzw__decoder), WUFFS_VERSION, WUFFS_INITIALIZE__ALREADY_ZEROED).repr) {
-    free(x);
-    return NULL;
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_empty_struct();
   }
-  return x;
-}
 
-size_t
-sizeof__wuffs_lzw__decoder() {
-  return sizeof(wuffs_lzw__decoder);
+  if ( ! self->private_impl.f_started) {
+    self->private_impl.f_level = wuffs_base__u32__min(a_level, 9);
+    self->private_impl.f_level_is_set = true;
+  }
+  return wuffs_base__make_empty_struct();
 }
 
-// ---------------- Function Implementations
-
-// -------- func lzw.decoder.set_quirk_enabled
+// -------- func deflate.encoder.set_quirk_enabled
 
 WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
-wuffs_lzw__decoder__set_quirk_enabled(
-    wuffs_lzw__decoder* self,
+wuffs_deflate__encoder__set_quirk_enabled(
+    wuffs_deflate__encoder* self,
     uint32_t a_quirk,
     bool a_enabled) {
   return wuffs_base__make_empty_struct();
 }
 
-// -------- func lzw.decoder.set_literal_width
+// -------- func deflate.encoder.end_input
 
 WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
-wuffs_lzw__decoder__set_literal_width(
-    wuffs_lzw__decoder* self,
-    uint32_t a_lw) {
+wuffs_deflate__encoder__end_input(
+    wuffs_deflate__encoder* self,
+    bool a_full_flush) {
   if (!self) {
     return wuffs_base__make_empty_struct();
   }
   if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
     return wuffs_base__make_empty_struct();
   }
-  if (a_lw > 8) {
-    self->private_impl.magic = WUFFS_BASE__DISABLED;
-    return wuffs_base__make_empty_struct();
-  }
 
-  self->private_impl.f_set_literal_width_arg = (a_lw + 1);
+  self->private_impl.f_input_ended = true;
+  self->private_impl.f_full_flush = a_full_flush;
   return wuffs_base__make_empty_struct();
 }
 
-// -------- func lzw.decoder.workbuf_len
+// -------- func deflate.encoder.workbuf_len
 
 WUFFS_BASE__MAYBE_STATIC wuffs_base__range_ii_u64
-wuffs_lzw__decoder__workbuf_len(
-    const wuffs_lzw__decoder* self) {
+wuffs_deflate__encoder__workbuf_len(
+    const wuffs_deflate__encoder* self) {
   if (!self) {
     return wuffs_base__utility__empty_range_ii_u64();
   }
@@ -27829,11 +33293,11 @@ wuffs_lzw__decoder__workbuf_len(
   return wuffs_base__utility__make_range_ii_u64(0, 0);
 }
 
-// -------- func lzw.decoder.transform_io
+// -------- func deflate.encoder.transform_io
 
 WUFFS_BASE__MAYBE_STATIC wuffs_base__status
-wuffs_lzw__decoder__transform_io(
-    wuffs_lzw__decoder* self,
+wuffs_deflate__encoder__transform_io(
+    wuffs_deflate__encoder* self,
     wuffs_base__io_buffer* a_dst,
     wuffs_base__io_buffer* a_src,
     wuffs_base__slice_u8 a_workbuf) {
@@ -27858,57 +33322,112 @@ wuffs_lzw__decoder__transform_io(
   self->private_impl.active_coroutine = 0;
   wuffs_base__status status = wuffs_base__make_status(NULL);
 
+  uint64_t v_n = 0;
+  uint32_t v_ri = 0;
+  uint32_t v_n_src = 0;
   uint32_t v_i = 0;
+  bool v_final = false;
+
+  uint8_t* iop_a_dst = NULL;
+  uint8_t* io0_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io1_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io2_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_dst) {
+    io0_a_dst = a_dst->data.ptr;
+    io1_a_dst = io0_a_dst + a_dst->meta.wi;
+    iop_a_dst = io1_a_dst;
+    io2_a_dst = io0_a_dst + a_dst->data.len;
+    if (a_dst->meta.closed) {
+      io2_a_dst = iop_a_dst;
+    }
+  }
+  const uint8_t* iop_a_src = NULL;
+  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_src) {
+    io0_a_src = a_src->data.ptr;
+    io1_a_src = io0_a_src + a_src->meta.ri;
+    iop_a_src = io1_a_src;
+    io2_a_src = io0_a_src + a_src->meta.wi;
+  }
 
   uint32_t coro_susp_point = self->private_impl.p_transform_io[0];
   switch (coro_susp_point) {
     WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
 
-    self->private_impl.f_literal_width = 8;
-    if (self->private_impl.f_set_literal_width_arg > 0) {
-      self->private_impl.f_literal_width = (self->private_impl.f_set_literal_width_arg - 1);
-    }
-    self->private_impl.f_clear_code = (((uint32_t)(1)) << self->private_impl.f_literal_width);
-    self->private_impl.f_end_code = (self->private_impl.f_clear_code + 1);
-    self->private_impl.f_save_code = self->private_impl.f_end_code;
-    self->private_impl.f_prev_code = self->private_impl.f_end_code;
-    self->private_impl.f_width = (self->private_impl.f_literal_width + 1);
-    self->private_impl.f_bits = 0;
-    self->private_impl.f_n_bits = 0;
-    self->private_impl.f_output_ri = 0;
-    self->private_impl.f_output_wi = 0;
-    v_i = 0;
-    while (v_i < self->private_impl.f_clear_code) {
-      self->private_data.f_lm1s[v_i] = 0;
-      self->private_data.f_suffixes[v_i][0] = ((uint8_t)(v_i));
-      v_i += 1;
+    self->private_impl.choosy_longest_match = (
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+        wuffs_base__cpu_arch__have_x86_sse42() ? &wuffs_deflate__encoder__longest_match_x86_sse42 :
+#endif
+        self->private_impl.choosy_longest_match);
+    if ( ! self->private_impl.f_started) {
+      self->private_impl.f_started = true;
+      if ( ! self->private_impl.f_level_is_set) {
+        self->private_impl.f_level = 6;
+      }
+      v_i = 0;
+      while (v_i < 32768) {
+        self->private_data.f_head[v_i] = 0;
+        v_i += 1;
+      }
     }
     label__0__continue:;
     while (true) {
-      wuffs_lzw__decoder__read_from(self, a_src);
-      if (self->private_impl.f_output_wi > 0) {
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
-        status = wuffs_lzw__decoder__write_to(self, a_dst);
-        if (status.repr) {
-          goto suspend;
+      while (self->private_impl.f_out_ri < self->private_impl.f_out_wi) {
+        v_n = wuffs_base__io_writer__copy_from_slice(&iop_a_dst, io2_a_dst,wuffs_base__slice_u8__subslice_ij(wuffs_base__make_slice_u8(self->private_data.f_out,
+            65544),
+            self->private_impl.f_out_ri,
+            self->private_impl.f_out_wi));
+        v_ri = (self->private_impl.f_out_ri + ((uint32_t)(wuffs_base__u64__min(v_n, 65535))));
+        self->private_impl.f_out_ri = wuffs_base__u32__min(v_ri, self->private_impl.f_out_wi);
+        if (self->private_impl.f_out_ri < self->private_impl.f_out_wi) {
+          status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(1);
         }
       }
-      if (self->private_impl.f_read_from_return_value == 0) {
-        goto label__0__break;
-      } else if (self->private_impl.f_read_from_return_value == 1) {
-        goto label__0__continue;
-      } else if (self->private_impl.f_read_from_return_value == 2) {
-        status = wuffs_base__make_status(wuffs_base__suspension__short_read);
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(2);
-      } else if (self->private_impl.f_read_from_return_value == 3) {
-        status = wuffs_base__make_status(wuffs_lzw__error__bad_code);
+      self->private_impl.f_out_ri = 0;
+      self->private_impl.f_out_wi = 0;
+      if (self->private_impl.f_end_of_data) {
+        status = wuffs_base__make_status(NULL);
+        goto ok;
+      }
+      if (self->private_impl.f_wnd_p > 32768) {
+        status = wuffs_base__make_status(wuffs_deflate__error__internal_error_inconsistent_window);
         goto exit;
-      } else {
-        status = wuffs_base__make_status(wuffs_lzw__error__internal_error_inconsistent_i_o);
+      } else if (self->private_impl.f_wnd_n < self->private_impl.f_wnd_p) {
+        status = wuffs_base__make_status(wuffs_deflate__error__internal_error_inconsistent_window);
         goto exit;
+      } else if (self->private_impl.f_wnd_n > (self->private_impl.f_wnd_p + 32768)) {
+        status = wuffs_base__make_status(wuffs_deflate__error__internal_error_inconsistent_window);
+        goto exit;
+      }
+      v_n_src = wuffs_base__io_reader__limited_copy_u32_to_slice(
+          &iop_a_src, io2_a_src,32768, wuffs_base__slice_u8__subslice_ij(wuffs_base__make_slice_u8(self->private_data.f_window,
+          65824),
+          self->private_impl.f_wnd_n,
+          (self->private_impl.f_wnd_p + 32768)));
+      self->private_impl.f_wnd_n += v_n_src;
+      if ((self->private_impl.f_wnd_n < (self->private_impl.f_wnd_p + 32768)) &&  ! (a_src && a_src->meta.closed) &&  ! self->private_impl.f_input_ended) {
+        status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(2);
+        goto label__0__continue;
+      }
+      v_final = (((a_src && a_src->meta.closed) || self->private_impl.f_input_ended) && (((uint64_t)(io2_a_src - iop_a_src)) == 0));
+      wuffs_deflate__encoder__compress_chunk(self, (v_final &&  ! self->private_impl.f_full_flush));
+      if (v_final && self->private_impl.f_full_flush) {
+        wuffs_deflate__encoder__write_full_flush(self);
+      }
+      self->private_impl.f_wnd_p = self->private_impl.f_wnd_n;
+      if (self->private_impl.f_wnd_n >= 65536) {
+        wuffs_deflate__encoder__slide(self);
+        self->private_impl.f_wnd_p = 32768;
+        self->private_impl.f_wnd_n = 32768;
+      }
+      if (v_final) {
+        self->private_impl.f_end_of_data = true;
       }
     }
-    label__0__break:;
 
     ok:
     self->private_impl.p_transform_io[0] = 0;
@@ -27922,453 +33441,1323 @@ wuffs_lzw__decoder__transform_io(
 
   goto exit;
   exit:
+  if (a_dst) {
+    a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+  }
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  }
+
   if (wuffs_base__status__is_error(&status)) {
     self->private_impl.magic = WUFFS_BASE__DISABLED;
   }
   return status;
 }
 
-// -------- func lzw.decoder.read_from
+// -------- func deflate.encoder.slide
 
 static wuffs_base__empty_struct
-wuffs_lzw__decoder__read_from(
-    wuffs_lzw__decoder* self,
-    wuffs_base__io_buffer* a_src) {
-  uint32_t v_clear_code = 0;
-  uint32_t v_end_code = 0;
-  uint32_t v_save_code = 0;
-  uint32_t v_prev_code = 0;
-  uint32_t v_width = 0;
-  uint32_t v_bits = 0;
-  uint32_t v_n_bits = 0;
-  uint32_t v_output_wi = 0;
-  uint32_t v_code = 0;
-  uint32_t v_c = 0;
-  uint32_t v_o = 0;
-  uint32_t v_steps = 0;
-  uint8_t v_first_byte = 0;
-  uint16_t v_lm1_b = 0;
-  uint16_t v_lm1_a = 0;
+wuffs_deflate__encoder__slide(
+    wuffs_deflate__encoder* self) {
+  uint32_t v_i = 0;
 
-  const uint8_t* iop_a_src = NULL;
-  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
-  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
-  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
-  if (a_src) {
-    io0_a_src = a_src->data.ptr;
-    io1_a_src = io0_a_src + a_src->meta.ri;
-    iop_a_src = io1_a_src;
-    io2_a_src = io0_a_src + a_src->meta.wi;
+  wuffs_base__slice_u8__copy_from_slice(wuffs_base__make_slice_u8(self->private_data.f_window, 32768), wuffs_base__make_slice_u8((self->private_data.f_window) + 32768, 32768));
+  while (v_i < 32768) {
+    self->private_data.f_head[v_i] = wuffs_base__u16__sat_sub(self->private_data.f_head[v_i], 32768);
+    self->private_data.f_prev[v_i] = wuffs_base__u16__sat_sub(self->private_data.f_prev[v_i], 32768);
+    v_i += 1;
   }
+  return wuffs_base__make_empty_struct();
+}
 
-  v_clear_code = self->private_impl.f_clear_code;
-  v_end_code = self->private_impl.f_end_code;
-  v_save_code = self->private_impl.f_save_code;
-  v_prev_code = self->private_impl.f_prev_code;
-  v_width = self->private_impl.f_width;
-  v_bits = self->private_impl.f_bits;
-  v_n_bits = self->private_impl.f_n_bits;
-  v_output_wi = self->private_impl.f_output_wi;
-  while (true) {
-    if (v_n_bits < v_width) {
-      if (((uint64_t)(io2_a_src - iop_a_src)) >= 4) {
-        v_bits |= ((uint32_t)(wuffs_base__peek_u32le__no_bounds_check(iop_a_src) << v_n_bits));
-        iop_a_src += ((31 - v_n_bits) >> 3);
-        v_n_bits |= 24;
-      } else if (((uint64_t)(io2_a_src - iop_a_src)) <= 0) {
-        self->private_impl.f_read_from_return_value = 2;
-        goto label__0__break;
-      } else {
-        v_bits |= (((uint32_t)(wuffs_base__peek_u8be__no_bounds_check(iop_a_src))) << v_n_bits);
-        iop_a_src += 1;
-        v_n_bits += 8;
-        if (v_n_bits >= v_width) {
-        } else if (((uint64_t)(io2_a_src - iop_a_src)) <= 0) {
-          self->private_impl.f_read_from_return_value = 2;
-          goto label__0__break;
-        } else {
-          v_bits |= (((uint32_t)(wuffs_base__peek_u8be__no_bounds_check(iop_a_src))) << v_n_bits);
-          iop_a_src += 1;
-          v_n_bits += 8;
-          if (v_n_bits < v_width) {
-            self->private_impl.f_read_from_return_value = 4;
-            goto label__0__break;
-          }
-        }
-      }
-    }
-    v_code = ((v_bits) & WUFFS_BASE__LOW_BITS_MASK__U32(v_width));
-    v_bits >>= v_width;
-    v_n_bits -= v_width;
-    if (v_code < v_clear_code) {
-      self->private_data.f_output[v_output_wi] = ((uint8_t)(v_code));
-      v_output_wi = ((v_output_wi + 1) & 8191);
-      if (v_save_code <= 4095) {
-        v_lm1_a = (((uint16_t)(self->private_data.f_lm1s[v_prev_code] + 1)) & 4095);
-        self->private_data.f_lm1s[v_save_code] = v_lm1_a;
-        if ((v_lm1_a % 8) != 0) {
-          self->private_impl.f_prefixes[v_save_code] = self->private_impl.f_prefixes[v_prev_code];
-          memcpy(self->private_data.f_suffixes[v_save_code],self->private_data.f_suffixes[v_prev_code], sizeof(self->private_data.f_suffixes[v_save_code]));
-          self->private_data.f_suffixes[v_save_code][(v_lm1_a % 8)] = ((uint8_t)(v_code));
-        } else {
-          self->private_impl.f_prefixes[v_save_code] = ((uint16_t)(v_prev_code));
-          self->private_data.f_suffixes[v_save_code][0] = ((uint8_t)(v_code));
-        }
-        v_save_code += 1;
-        if (v_width < 12) {
-          v_width += (1 & (v_save_code >> v_width));
-        }
-        v_prev_code = v_code;
-      }
-    } else if (v_code <= v_end_code) {
-      if (v_code == v_end_code) {
-        self->private_impl.f_read_from_return_value = 0;
-        goto label__0__break;
-      }
-      v_save_code = v_end_code;
-      v_prev_code = v_end_code;
-      v_width = (self->private_impl.f_literal_width + 1);
-    } else if (v_code <= v_save_code) {
-      v_c = v_code;
-      if (v_code == v_save_code) {
-        v_c = v_prev_code;
-      }
-      v_o = ((v_output_wi + (((uint32_t)(self->private_data.f_lm1s[v_c])) & 4294967288)) & 8191);
-      v_output_wi = ((v_output_wi + 1 + ((uint32_t)(self->private_data.f_lm1s[v_c]))) & 8191);
-      v_steps = (((uint32_t)(self->private_data.f_lm1s[v_c])) >> 3);
-      while (true) {
-        memcpy((self->private_data.f_output)+(v_o), (self->private_data.f_suffixes[v_c]), 8);
-        if (v_steps <= 0) {
-          goto label__1__break;
-        }
-        v_steps -= 1;
-        v_o = (((uint32_t)(v_o - 8)) & 8191);
-        v_c = ((uint32_t)(self->private_impl.f_prefixes[v_c]));
-      }
-      label__1__break:;
-      v_first_byte = self->private_data.f_suffixes[v_c][0];
-      if (v_code == v_save_code) {
-        self->private_data.f_output[v_output_wi] = v_first_byte;
-        v_output_wi = ((v_output_wi + 1) & 8191);
-      }
-      if (v_save_code <= 4095) {
-        v_lm1_b = (((uint16_t)(self->private_data.f_lm1s[v_prev_code] + 1)) & 4095);
-        self->private_data.f_lm1s[v_save_code] = v_lm1_b;
-        if ((v_lm1_b % 8) != 0) {
-          self->private_impl.f_prefixes[v_save_code] = self->private_impl.f_prefixes[v_prev_code];
-          memcpy(self->private_data.f_suffixes[v_save_code],self->private_data.f_suffixes[v_prev_code], sizeof(self->private_data.f_suffixes[v_save_code]));
-          self->private_data.f_suffixes[v_save_code][(v_lm1_b % 8)] = v_first_byte;
-        } else {
-          self->private_impl.f_prefixes[v_save_code] = ((uint16_t)(v_prev_code));
-          self->private_data.f_suffixes[v_save_code][0] = ((uint8_t)(v_first_byte));
-        }
-        v_save_code += 1;
-        if (v_width < 12) {
-          v_width += (1 & (v_save_code >> v_width));
-        }
-        v_prev_code = v_code;
-      }
-    } else {
-      self->private_impl.f_read_from_return_value = 3;
-      goto label__0__break;
-    }
-    if (v_output_wi > 4095) {
-      self->private_impl.f_read_from_return_value = 1;
-      goto label__0__break;
-    }
+// -------- func deflate.encoder.compress_chunk
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__compress_chunk(
+    wuffs_deflate__encoder* self,
+    bool a_final) {
+  uint32_t v_start = 0;
+  uint32_t v_n = 0;
+  uint32_t v_level = 0;
+  uint32_t v_x = 0;
+  uint32_t v_i = 0;
+
+  if ((self->private_impl.f_wnd_p > 32768) || (self->private_impl.f_wnd_n < self->private_impl.f_wnd_p)) {
+    return wuffs_base__make_empty_struct();
   }
-  label__0__break:;
-  if (self->private_impl.f_read_from_return_value != 2) {
-    while (v_n_bits >= 8) {
-      v_n_bits -= 8;
-      if (iop_a_src > io1_a_src) {
-        iop_a_src--;
-      } else {
-        self->private_impl.f_read_from_return_value = 4;
-        goto label__2__break;
-      }
-    }
-    label__2__break:;
+  v_start = self->private_impl.f_wnd_p;
+  v_x = (self->private_impl.f_wnd_n - self->private_impl.f_wnd_p);
+  v_n = wuffs_base__u32__min(v_x, 32768);
+  v_level = self->private_impl.f_level;
+  self->private_impl.f_n_syms = 0;
+  v_i = 0;
+  while (v_i < 288) {
+    self->private_data.f_lfreqs[v_i] = 0;
+    v_i += 1;
   }
-  self->private_impl.f_save_code = v_save_code;
-  self->private_impl.f_prev_code = v_prev_code;
-  self->private_impl.f_width = v_width;
-  self->private_impl.f_bits = v_bits;
-  self->private_impl.f_n_bits = v_n_bits;
-  self->private_impl.f_output_wi = v_output_wi;
-  if (a_src) {
-    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  v_i = 0;
+  while (v_i < 32) {
+    self->private_data.f_dfreqs[v_i] = 0;
+    v_i += 1;
   }
-
+  if (v_level == 0) {
+    wuffs_deflate__encoder__write_block(self,
+        a_final,
+        v_start,
+        v_n,
+        true);
+    return wuffs_base__make_empty_struct();
+  }
+  if (v_start >= 32768) {
+    wuffs_deflate__encoder__insert(self, (v_start - 2));
+    wuffs_deflate__encoder__insert(self, (v_start - 1));
+  }
+  if (v_level <= 3) {
+    wuffs_deflate__encoder__parse_greedy(self,
+        v_start,
+        v_n,
+        WUFFS_DEFLATE__LEVEL_CHAINS[v_level],
+        WUFFS_DEFLATE__LEVEL_NICES[v_level],
+        WUFFS_DEFLATE__LEVEL_LAZIES[v_level]);
+  } else if (v_level <= 7) {
+    wuffs_deflate__encoder__parse_lazy(self,
+        v_start,
+        v_n,
+        WUFFS_DEFLATE__LEVEL_CHAINS[v_level],
+        WUFFS_DEFLATE__LEVEL_NICES[v_level],
+        WUFFS_DEFLATE__LEVEL_LAZIES[v_level]);
+  } else {
+    wuffs_deflate__encoder__parse_optimal(self,
+        v_start,
+        v_n,
+        WUFFS_DEFLATE__LEVEL_CHAINS[v_level],
+        WUFFS_DEFLATE__LEVEL_NICES[v_level],
+        WUFFS_DEFLATE__LEVEL_LAZIES[v_level]);
+  }
+  wuffs_deflate__encoder__write_block(self,
+      a_final,
+      v_start,
+      v_n,
+      false);
   return wuffs_base__make_empty_struct();
 }
 
-// -------- func lzw.decoder.write_to
+// -------- func deflate.encoder.hash
 
-static wuffs_base__status
-wuffs_lzw__decoder__write_to(
-    wuffs_lzw__decoder* self,
-    wuffs_base__io_buffer* a_dst) {
-  wuffs_base__status status = wuffs_base__make_status(NULL);
+static uint32_t
+wuffs_deflate__encoder__hash(
+    const wuffs_deflate__encoder* self,
+    uint32_t a_p) {
+  uint32_t v_x = 0;
 
-  wuffs_base__slice_u8 v_s = {0};
-  uint64_t v_n = 0;
+  v_x = (((uint32_t)(self->private_data.f_window[a_p])) | (((uint32_t)(self->private_data.f_window[(a_p + 1)])) << 8) | (((uint32_t)(self->private_data.f_window[(a_p + 2)])) << 16));
+  return (((uint32_t)(v_x * 506832829)) >> 17);
+}
 
-  uint8_t* iop_a_dst = NULL;
-  uint8_t* io0_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
-  uint8_t* io1_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
-  uint8_t* io2_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
-  if (a_dst) {
-    io0_a_dst = a_dst->data.ptr;
-    io1_a_dst = io0_a_dst + a_dst->meta.wi;
-    iop_a_dst = io1_a_dst;
-    io2_a_dst = io0_a_dst + a_dst->data.len;
-    if (a_dst->meta.closed) {
-      io2_a_dst = iop_a_dst;
-    }
-  }
+// -------- func deflate.encoder.insert
 
-  uint32_t coro_susp_point = self->private_impl.p_write_to[0];
-  switch (coro_susp_point) {
-    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+static uint32_t
+wuffs_deflate__encoder__insert(
+    wuffs_deflate__encoder* self,
+    uint32_t a_p) {
+  uint32_t v_h = 0;
+  uint32_t v_ret = 0;
 
-    while (self->private_impl.f_output_wi > 0) {
-      if (self->private_impl.f_output_ri > self->private_impl.f_output_wi) {
-        status = wuffs_base__make_status(wuffs_lzw__error__internal_error_inconsistent_i_o);
-        goto exit;
-      }
-      v_s = wuffs_base__slice_u8__subslice_ij(wuffs_base__make_slice_u8(self->private_data.f_output,
-          8199),
-          self->private_impl.f_output_ri,
-          self->private_impl.f_output_wi);
-      v_n = wuffs_base__io_writer__copy_from_slice(&iop_a_dst, io2_a_dst,v_s);
-      if (v_n == ((uint64_t)(v_s.len))) {
-        self->private_impl.f_output_ri = 0;
-        self->private_impl.f_output_wi = 0;
-        status = wuffs_base__make_status(NULL);
-        goto ok;
-      }
-      self->private_impl.f_output_ri = (((uint32_t)(self->private_impl.f_output_ri + ((uint32_t)((v_n & 4294967295))))) & 8191);
-      status = wuffs_base__make_status(wuffs_base__suspension__short_write);
-      WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(1);
-    }
+  v_h = wuffs_deflate__encoder__hash(self, a_p);
+  v_ret = ((uint32_t)(self->private_data.f_head[v_h]));
+  self->private_data.f_prev[(a_p & 32767)] = ((uint16_t)(v_ret));
+  self->private_data.f_head[v_h] = ((uint16_t)(a_p));
+  return v_ret;
+}
 
-    ok:
-    self->private_impl.p_write_to[0] = 0;
-    goto exit;
-  }
+// -------- func deflate.encoder.insert_run
 
-  goto suspend;
-  suspend:
-  self->private_impl.p_write_to[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__insert_run(
+    wuffs_deflate__encoder* self,
+    uint32_t a_p,
+    uint32_t a_n,
+    uint32_t a_rem) {
+  uint32_t v_j = 0;
+  uint32_t v_lim = 0;
 
-  goto exit;
-  exit:
-  if (a_dst) {
-    a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+  v_lim = wuffs_base__u32__sat_sub(a_rem, 2);
+  v_j = 1;
+  while ((v_j < a_n) && (v_j < v_lim) && (v_j < 258)) {
+    wuffs_deflate__encoder__insert(self, ((a_p + v_j) & 65535));
+    v_j += 1;
   }
-
-  return status;
+  return wuffs_base__make_empty_struct();
 }
 
-// -------- func lzw.decoder.flush
-
-WUFFS_BASE__MAYBE_STATIC wuffs_base__slice_u8
-wuffs_lzw__decoder__flush(
-    wuffs_lzw__decoder* self) {
-  if (!self) {
-    return wuffs_base__make_slice_u8(NULL, 0);
-  }
-  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
-    return wuffs_base__make_slice_u8(NULL, 0);
-  }
-
-  wuffs_base__slice_u8 v_s = {0};
+// -------- func deflate.encoder.dcode
 
-  if (self->private_impl.f_output_ri <= self->private_impl.f_output_wi) {
-    v_s = wuffs_base__slice_u8__subslice_ij(wuffs_base__make_slice_u8(self->private_data.f_output,
-        8199),
-        self->private_impl.f_output_ri,
-        self->private_impl.f_output_wi);
+static uint32_t
+wuffs_deflate__encoder__dcode(
+    const wuffs_deflate__encoder* self,
+    uint32_t a_dm1) {
+  if (a_dm1 < 256) {
+    return ((uint32_t)(WUFFS_DEFLATE__DCODE_FROM_DISTANCE_MINUS_1[a_dm1]));
   }
-  self->private_impl.f_output_ri = 0;
-  self->private_impl.f_output_wi = 0;
-  return v_s;
+  return ((uint32_t)(WUFFS_DEFLATE__DCODE_FROM_DISTANCE_MINUS_1[(256 + (a_dm1 >> 7))]));
 }
 
-#endif  // !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__LZW)
+// -------- func deflate.encoder.record_literal
 
-#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__GIF)
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__record_literal(
+    wuffs_deflate__encoder* self,
+    uint32_t a_b) {
+  self->private_data.f_syms[(self->private_impl.f_n_syms & 32767)] = a_b;
+  self->private_impl.f_n_syms = ((self->private_impl.f_n_syms + 1) & 65535);
+  self->private_data.f_lfreqs[a_b] += 1;
+  return wuffs_base__make_empty_struct();
+}
 
-// ---------------- Status Codes Implementations
+// -------- func deflate.encoder.record_match
 
-const char wuffs_gif__error__bad_extension_label[] = "#gif: bad extension label";
-const char wuffs_gif__error__bad_frame_size[] = "#gif: bad frame size";
-const char wuffs_gif__error__bad_graphic_control[] = "#gif: bad graphic control";
-const char wuffs_gif__error__bad_header[] = "#gif: bad header";
-const char wuffs_gif__error__bad_literal_width[] = "#gif: bad literal width";
-const char wuffs_gif__error__bad_palette[] = "#gif: bad palette";
-const char wuffs_gif__error__internal_error_inconsistent_ri_wi[] = "#gif: internal error: inconsistent ri/wi";
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__record_match(
+    wuffs_deflate__encoder* self,
+    uint32_t a_len,
+    uint32_t a_dm1) {
+  self->private_data.f_syms[(self->private_impl.f_n_syms & 32767)] = ((a_len << 16) | a_dm1);
+  self->private_impl.f_n_syms = ((self->private_impl.f_n_syms + 1) & 65535);
+  self->private_data.f_lfreqs[(257 + ((uint32_t)(WUFFS_DEFLATE__LCODE_FROM_LENGTH_MINUS_3[(((uint32_t)(a_len - 3)) & 255)])))] += 1;
+  self->private_data.f_dfreqs[wuffs_deflate__encoder__dcode(self, a_dm1)] += 1;
+  return wuffs_base__make_empty_struct();
+}
 
-// ---------------- Private Consts
+// -------- func deflate.encoder.longest_match
 
-static const uint32_t
-WUFFS_GIF__INTERLACE_START[5] WUFFS_BASE__POTENTIALLY_UNUSED = {
-  4294967295, 1, 2, 4, 0,
-};
+static uint32_t
+wuffs_deflate__encoder__longest_match(
+    wuffs_deflate__encoder* self,
+    uint32_t a_cur,
+    uint32_t a_head,
+    uint32_t a_max_len,
+    uint32_t a_min_len,
+    uint32_t a_chain,
+    uint32_t a_nice) {
+  return (*self->private_impl.choosy_longest_match)(self, a_cur, a_head, a_max_len, a_min_len, a_chain, a_nice);
+}
 
-static const uint8_t
-WUFFS_GIF__INTERLACE_DELTA[5] WUFFS_BASE__POTENTIALLY_UNUSED = {
-  1, 2, 4, 8, 8,
-};
+static uint32_t
+wuffs_deflate__encoder__longest_match__choosy_default(
+    wuffs_deflate__encoder* self,
+    uint32_t a_cur,
+    uint32_t a_head,
+    uint32_t a_max_len,
+    uint32_t a_min_len,
+    uint32_t a_chain,
+    uint32_t a_nice) {
+  uint32_t v_best_len = 0;
+  uint32_t v_best_dm1 = 0;
+  uint32_t v_chain = 0;
+  uint32_t v_c = 0;
+  uint32_t v_n = 0;
+  uint64_t v_x = 0;
+  wuffs_base__slice_u8 v_sa = {0};
+  wuffs_base__slice_u8 v_sb = {0};
 
-static const uint8_t
-WUFFS_GIF__INTERLACE_COUNT[5] WUFFS_BASE__POTENTIALLY_UNUSED = {
-  0, 1, 2, 4, 8,
-};
+  v_best_len = wuffs_base__u32__max(a_min_len, 2);
+  if (a_max_len <= v_best_len) {
+    return 0;
+  }
+  v_chain = a_chain;
+  v_c = a_head;
+  while (v_chain > 0) {
+    v_chain -= 1;
+    if ((v_c == 0) || (a_cur <= v_c)) {
+      goto label__0__break;
+    } else if ((a_cur - v_c) >= 32768) {
+      goto label__0__break;
+    }
+    if ((self->private_data.f_window[(v_c + v_best_len)] == self->private_data.f_window[(a_cur + v_best_len)]) && (self->private_data.f_window[v_c] == self->private_data.f_window[a_cur])) {
+      v_n = 0;
+      while ((v_n < a_max_len) && (v_n < 258)) {
+        v_sa = wuffs_base__slice_u8__subslice_i(wuffs_base__make_slice_u8(self->private_data.f_window, 65824), (a_cur + v_n));
+        v_sb = wuffs_base__slice_u8__subslice_i(wuffs_base__make_slice_u8(self->private_data.f_window, 65824), (v_c + v_n));
+        if ((((uint64_t)(v_sa.len)) < 8) || (((uint64_t)(v_sb.len)) < 8)) {
+          goto label__1__break;
+        }
+        v_x = (wuffs_base__peek_u64le__no_bounds_check(v_sa.ptr) ^ wuffs_base__peek_u64le__no_bounds_check(v_sb.ptr));
+        if (v_x != 0) {
+          v_n += (((uint32_t)(WUFFS_DEFLATE__DEBRUIJN_CTZ[(((uint64_t)((v_x & ((uint64_t)(0 - v_x))) * 285870213051386505)) >> 58)])) >> 3);
+          goto label__1__break;
+        }
+        v_n += 8;
+      }
+      label__1__break:;
+      v_n = wuffs_base__u32__min(v_n, a_max_len);
+      if (v_best_len < v_n) {
+        v_best_len = v_n;
+        v_best_dm1 = (((uint32_t)(((uint32_t)(a_cur - v_c)) - 1)) & 32767);
+        if ((v_n >= a_nice) || (v_n >= a_max_len)) {
+          goto label__0__break;
+        }
+      }
+    }
+    v_c = ((uint32_t)(self->private_data.f_prev[(v_c & 32767)]));
+  }
+  label__0__break:;
+  if (v_best_len <= wuffs_base__u32__max(a_min_len, 2)) {
+    return 0;
+  }
+  return ((v_best_dm1 << 16) | v_best_len);
+}
 
-static const uint8_t
-WUFFS_GIF__ANIMEXTS1DOT0[11] WUFFS_BASE__POTENTIALLY_UNUSED = {
-  65, 78, 73, 77, 69, 88, 84, 83,
-  49, 46, 48,
-};
+// -------- func deflate.encoder.parse_greedy
 
-static const uint8_t
-WUFFS_GIF__NETSCAPE2DOT0[11] WUFFS_BASE__POTENTIALLY_UNUSED = {
-  78, 69, 84, 83, 67, 65, 80, 69,
-  50, 46, 48,
-};
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__parse_greedy(
+    wuffs_deflate__encoder* self,
+    uint32_t a_start,
+    uint32_t a_n,
+    uint32_t a_chain,
+    uint32_t a_nice,
+    uint32_t a_max_insert) {
+  uint32_t v_i = 0;
+  uint32_t v_p = 0;
+  uint32_t v_rem = 0;
+  uint32_t v_head = 0;
+  uint32_t v_m = 0;
+  uint32_t v_len = 0;
+  uint32_t v_dm1 = 0;
 
-static const uint8_t
-WUFFS_GIF__ICCRGBG1012[11] WUFFS_BASE__POTENTIALLY_UNUSED = {
-  73, 67, 67, 82, 71, 66, 71, 49,
-  48, 49, 50,
-};
+  label__0__continue:;
+  while ((a_n > v_i) && (v_i < 32768)) {
+    v_p = (a_start + v_i);
+    v_len = 0;
+    v_rem = (a_n - v_i);
+    if (v_rem >= 3) {
+      v_head = wuffs_deflate__encoder__insert(self, v_p);
+      v_m = wuffs_deflate__encoder__longest_match(self,
+          v_p,
+          v_head,
+          wuffs_base__u32__min(v_rem, 258),
+          0,
+          a_chain,
+          a_nice);
+      v_len = wuffs_base__u32__min(((v_m) & 0xFFFF), 258);
+      v_dm1 = ((v_m >> 16) & 32767);
+    }
+    if (v_len < 3) {
+      wuffs_deflate__encoder__record_literal(self, ((uint32_t)(self->private_data.f_window[v_p])));
+      v_i += 1;
+      goto label__0__continue;
+    }
+    wuffs_deflate__encoder__record_match(self, v_len, v_dm1);
+    if (v_len <= a_max_insert) {
+      wuffs_deflate__encoder__insert_run(self, v_p, v_len, v_rem);
+    }
+    v_i += v_len;
+  }
+  return wuffs_base__make_empty_struct();
+}
 
-static const uint8_t
-WUFFS_GIF__XMPDATAXMP[11] WUFFS_BASE__POTENTIALLY_UNUSED = {
-  88, 77, 80, 32, 68, 97, 116, 97,
-  88, 77, 80,
-};
+// -------- func deflate.encoder.parse_lazy
 
-#define WUFFS_GIF__QUIRKS_BASE 1041635328
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__parse_lazy(
+    wuffs_deflate__encoder* self,
+    uint32_t a_start,
+    uint32_t a_n,
+    uint32_t a_chain,
+    uint32_t a_nice,
+    uint32_t a_max_lazy) {
+  uint32_t v_i = 0;
+  uint32_t v_p = 0;
+  uint32_t v_rem = 0;
+  uint32_t v_head = 0;
+  uint32_t v_m = 0;
+  uint32_t v_len = 0;
+  uint32_t v_dm1 = 0;
+  uint32_t v_prev_len = 0;
+  uint32_t v_prev_dm1 = 0;
+  uint32_t v_prev_lit = 0;
+  bool v_avail = false;
 
-#define WUFFS_GIF__QUIRKS_COUNT 7
+  label__0__continue:;
+  while ((a_n > v_i) && (v_i < 32768)) {
+    v_p = (a_start + v_i);
+    v_len = 0;
+    v_rem = (a_n - v_i);
+    if (v_rem >= 3) {
+      v_head = wuffs_deflate__encoder__insert(self, v_p);
+      if (v_prev_len < a_max_lazy) {
+        v_m = wuffs_deflate__encoder__longest_match(self,
+            v_p,
+            v_head,
+            wuffs_base__u32__min(v_rem, 258),
+            v_prev_len,
+            a_chain,
+            a_nice);
+        v_len = wuffs_base__u32__min(((v_m) & 0xFFFF), 258);
+        v_dm1 = ((v_m >> 16) & 32767);
+        if ((v_len == 3) && (v_dm1 >= 4096)) {
+          v_len = 0;
+        }
+      }
+    }
+    if ((v_prev_len >= 3) && (v_len <= v_prev_len)) {
+      wuffs_deflate__encoder__record_match(self, v_prev_len, v_prev_dm1);
+      wuffs_deflate__encoder__insert_run(self, v_p, (v_prev_len - 1), v_rem);
+      v_i += (v_prev_len - 1);
+      v_prev_len = 0;
+      v_avail = false;
+      goto label__0__continue;
+    }
+    if (v_avail) {
+      wuffs_deflate__encoder__record_literal(self, v_prev_lit);
+    }
+    v_avail = true;
+    v_prev_len = v_len;
+    v_prev_dm1 = v_dm1;
+    v_prev_lit = ((uint32_t)(self->private_data.f_window[v_p]));
+    v_i += 1;
+  }
+  if (v_avail) {
+    if (v_prev_len >= 3) {
+      wuffs_deflate__encoder__record_match(self, v_prev_len, v_prev_dm1);
+    } else {
+      wuffs_deflate__encoder__record_literal(self, v_prev_lit);
+    }
+  }
+  return wuffs_base__make_empty_struct();
+}
 
-// ---------------- Private Initializer Prototypes
+// -------- func deflate.encoder.parse_optimal
 
-// ---------------- Private Function Prototypes
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__parse_optimal(
+    wuffs_deflate__encoder* self,
+    uint32_t a_start,
+    uint32_t a_n,
+    uint32_t a_chain,
+    uint32_t a_nice,
+    uint32_t a_n_passes) {
+  uint32_t v_i = 0;
+  uint32_t v_p = 0;
+  uint32_t v_rem = 0;
+  uint32_t v_head = 0;
+  uint32_t v_m = 0;
+  uint32_t v_len = 0;
+  uint32_t v_dm1 = 0;
+  uint32_t v_j = 0;
+  uint32_t v_pass = 0;
+
+  while ((a_n > v_i) && (v_i < 32768)) {
+    v_p = (a_start + v_i);
+    v_len = 0;
+    v_dm1 = 0;
+    v_rem = (a_n - v_i);
+    if (v_rem >= 3) {
+      v_head = wuffs_deflate__encoder__insert(self, v_p);
+      v_m = wuffs_deflate__encoder__longest_match(self,
+          v_p,
+          v_head,
+          wuffs_base__u32__min(v_rem, 258),
+          0,
+          a_chain,
+          a_nice);
+      v_len = wuffs_base__u32__min(((v_m) & 0xFFFF), 258);
+      v_dm1 = ((v_m >> 16) & 32767);
+    }
+    self->private_data.f_opt_lens[v_i] = ((uint16_t)(v_len));
+    self->private_data.f_opt_dists[v_i] = ((uint16_t)(v_dm1));
+    v_i += 1;
+    if (v_len >= a_nice) {
+      v_j = 1;
+      while ((v_len > v_j) &&
+          (v_j < 258) &&
+          (a_n > v_i) &&
+          (v_i < 32768)) {
+        v_p = (a_start + v_i);
+        if ((a_n - v_i) >= 3) {
+          wuffs_deflate__encoder__insert(self, v_p);
+        }
+        self->private_data.f_opt_lens[v_i] = 0;
+        self->private_data.f_opt_dists[v_i] = 0;
+        v_i += 1;
+        v_j += 1;
+      }
+    }
+  }
+  wuffs_deflate__encoder__opt_walk(self, a_start, a_n, true);
+  v_pass = a_n_passes;
+  while (v_pass > 0) {
+    v_pass -= 1;
+    wuffs_deflate__encoder__opt_set_costs(self);
+    wuffs_deflate__encoder__opt_solve(self, a_start, a_n, a_nice);
+    wuffs_deflate__encoder__opt_walk(self, a_start, a_n, false);
+  }
+  return wuffs_base__make_empty_struct();
+}
 
-static wuffs_base__status
-wuffs_gif__decoder__skip_frame(
-    wuffs_gif__decoder* self,
-    wuffs_base__io_buffer* a_src);
+// -------- func deflate.encoder.opt_walk
 
 static wuffs_base__empty_struct
-wuffs_gif__decoder__reset_gc(
-    wuffs_gif__decoder* self);
+wuffs_deflate__encoder__opt_walk(
+    wuffs_deflate__encoder* self,
+    uint32_t a_start,
+    uint32_t a_n,
+    bool a_greedy) {
+  uint32_t v_i = 0;
+  uint32_t v_x = 0;
+  uint32_t v_len = 0;
 
-static wuffs_base__status
-wuffs_gif__decoder__decode_up_to_id_part1(
-    wuffs_gif__decoder* self,
-    wuffs_base__io_buffer* a_src);
+  self->private_impl.f_n_syms = 0;
+  v_i = 0;
+  while (v_i < 288) {
+    self->private_data.f_lfreqs[v_i] = 0;
+    v_i += 1;
+  }
+  v_i = 0;
+  while (v_i < 32) {
+    self->private_data.f_dfreqs[v_i] = 0;
+    v_i += 1;
+  }
+  v_i = 0;
+  while ((a_n > v_i) && (v_i < 32768)) {
+    if (a_greedy) {
+      v_x = ((uint32_t)(self->private_data.f_opt_lens[v_i]));
+    } else {
+      v_x = ((uint32_t)(self->private_data.f_opt_choices[v_i]));
+    }
+    v_len = wuffs_base__u32__min(v_x, 258);
+    if (v_len < 3) {
+      wuffs_deflate__encoder__record_literal(self, ((uint32_t)(self->private_data.f_window[(a_start + v_i)])));
+      v_i += 1;
+    } else {
+      wuffs_deflate__encoder__record_match(self, v_len, (((uint32_t)(self->private_data.f_opt_dists[v_i])) & 32767));
+      v_i += v_len;
+    }
+  }
+  return wuffs_base__make_empty_struct();
+}
 
-static wuffs_base__status
-wuffs_gif__decoder__decode_header(
-    wuffs_gif__decoder* self,
-    wuffs_base__io_buffer* a_src);
+// -------- func deflate.encoder.opt_set_costs
 
-static wuffs_base__status
-wuffs_gif__decoder__decode_lsd(
-    wuffs_gif__decoder* self,
-    wuffs_base__io_buffer* a_src);
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__opt_set_costs(
+    wuffs_deflate__encoder* self) {
+  uint32_t v_i = 0;
+  uint32_t v_lc = 0;
+  uint32_t v_extra = 0;
 
-static wuffs_base__status
-wuffs_gif__decoder__decode_extension(
-    wuffs_gif__decoder* self,
-    wuffs_base__io_buffer* a_src);
+  self->private_data.f_lfreqs[256] = 1;
+  v_i = 0;
+  while (v_i < 286) {
+    self->private_data.f_h_freqs[v_i] = self->private_data.f_lfreqs[v_i];
+    v_i += 1;
+  }
+  wuffs_deflate__encoder__build_huffman(self, 286, 15);
+  v_i = 0;
+  while (v_i < 256) {
+    self->private_data.f_opt_lcosts[v_i] = wuffs_deflate__encoder__sym_cost(self, ((uint32_t)(self->private_impl.f_h_lengths[v_i])));
+    v_i += 1;
+  }
+  v_i = 0;
+  while (v_i < 256) {
+    v_lc = ((uint32_t)(WUFFS_DEFLATE__LCODE_FROM_LENGTH_MINUS_3[v_i]));
+    v_extra = ((WUFFS_DEFLATE__LCODE_MAGIC_NUMBERS[v_lc] >> 4) & 15);
+    self->private_data.f_opt_lencost[(v_i + 3)] = (v_extra + wuffs_deflate__encoder__sym_cost(self, ((uint32_t)(self->private_impl.f_h_lengths[(257 + v_lc)]))));
+    v_i += 1;
+  }
+  v_i = 0;
+  while (v_i < 30) {
+    self->private_data.f_h_freqs[v_i] = self->private_data.f_dfreqs[v_i];
+    v_i += 1;
+  }
+  wuffs_deflate__encoder__build_huffman(self, 30, 15);
+  v_i = 0;
+  while (v_i < 30) {
+    v_extra = ((WUFFS_DEFLATE__DCODE_MAGIC_NUMBERS[v_i] >> 4) & 15);
+    self->private_data.f_opt_dcosts[v_i] = (v_extra + wuffs_deflate__encoder__sym_cost(self, ((uint32_t)(self->private_impl.f_h_lengths[v_i]))));
+    v_i += 1;
+  }
+  return wuffs_base__make_empty_struct();
+}
 
-static wuffs_base__status
-wuffs_gif__decoder__skip_blocks(
-    wuffs_gif__decoder* self,
-    wuffs_base__io_buffer* a_src);
+// -------- func deflate.encoder.sym_cost
 
-static wuffs_base__status
-wuffs_gif__decoder__decode_ae(
-    wuffs_gif__decoder* self,
-    wuffs_base__io_buffer* a_src);
+static uint32_t
+wuffs_deflate__encoder__sym_cost(
+    const wuffs_deflate__encoder* self,
+    uint32_t a_len) {
+  if (a_len == 0) {
+    return 15;
+  }
+  return a_len;
+}
 
-static wuffs_base__status
-wuffs_gif__decoder__decode_gc(
-    wuffs_gif__decoder* self,
-    wuffs_base__io_buffer* a_src);
+// -------- func deflate.encoder.opt_solve
 
-static wuffs_base__status
-wuffs_gif__decoder__decode_id_part0(
-    wuffs_gif__decoder* self,
-    wuffs_base__io_buffer* a_src);
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__opt_solve(
+    wuffs_deflate__encoder* self,
+    uint32_t a_start,
+    uint32_t a_n,
+    uint32_t a_nice) {
+  uint32_t v_k = 0;
+  uint32_t v_x = 0;
+  uint32_t v_len = 0;
+  uint32_t v_l = 0;
+  uint32_t v_cost = 0;
+  uint32_t v_c = 0;
+  uint32_t v_dcost = 0;
+
+  self->private_data.f_opt_costs[a_n] = 0;
+  v_k = a_n;
+  while (v_k > 0) {
+    v_k -= 1;
+    v_cost = wuffs_base__u32__sat_add(self->private_data.f_opt_costs[(v_k + 1)], self->private_data.f_opt_lcosts[self->private_data.f_window[(a_start + v_k)]]);
+    self->private_data.f_opt_costs[v_k] = v_cost;
+    self->private_data.f_opt_choices[v_k] = 1;
+    v_x = ((uint32_t)(self->private_data.f_opt_lens[v_k]));
+    v_len = wuffs_base__u32__min(v_x, 258);
+    if (v_len >= 3) {
+      v_dcost = self->private_data.f_opt_dcosts[wuffs_deflate__encoder__dcode(self, (((uint32_t)(self->private_data.f_opt_dists[v_k])) & 32767))];
+      v_l = 3;
+      if (v_len >= a_nice) {
+        v_l = v_len;
+      }
+      while ((v_l <= v_len) && (v_l <= 258)) {
+        v_c = wuffs_base__u32__sat_add(wuffs_base__u32__sat_add(self->private_data.f_opt_lencost[v_l], v_dcost), self->private_data.f_opt_costs[(v_k + v_l)]);
+        if (v_cost > v_c) {
+          v_cost = v_c;
+          self->private_data.f_opt_costs[v_k] = v_c;
+          self->private_data.f_opt_choices[v_k] = ((uint16_t)(v_l));
+        }
+        v_l += 1;
+      }
+    }
+  }
+  return wuffs_base__make_empty_struct();
+}
 
-static wuffs_base__status
-wuffs_gif__decoder__decode_id_part1(
-    wuffs_gif__decoder* self,
-    wuffs_base__pixel_buffer* a_dst,
-    wuffs_base__io_buffer* a_src,
-    wuffs_base__pixel_blend a_blend);
+// -------- func deflate.encoder.build_huffman
 
-static wuffs_base__status
-wuffs_gif__decoder__decode_id_part2(
-    wuffs_gif__decoder* self,
-    wuffs_base__pixel_buffer* a_dst,
-    wuffs_base__io_buffer* a_src,
-    wuffs_base__slice_u8 a_workbuf);
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__build_huffman(
+    wuffs_deflate__encoder* self,
+    uint32_t a_n,
+    uint32_t a_max_len) {
+  uint32_t v_i = 0;
+  uint32_t v_j = 0;
+  uint32_t v_m = 0;
+  uint32_t v_f = 0;
+  uint32_t v_s = 0;
+  uint32_t v_n_nodes = 0;
+  uint32_t v_li = 0;
+  uint32_t v_ni = 0;
+  uint32_t v_nn = 0;
+  uint32_t v_a = 0;
+  uint32_t v_b = 0;
+  uint32_t v_d = 0;
+  uint32_t v_k = 0;
+  uint32_t v_total = 0;
+  uint32_t v_count = 0;
+
+  while ((v_i < a_n) && (v_i < 288)) {
+    self->private_impl.f_h_lengths[v_i] = 0;
+    self->private_data.f_h_codes[v_i] = 0;
+    v_f = self->private_data.f_h_freqs[v_i];
+    if (v_f > 0) {
+      v_j = v_m;
+      while ((v_j > 0) && (v_j < 288)) {
+        v_s = ((uint32_t)(self->private_data.f_h_sorted[(v_j - 1)]));
+        if (self->private_data.f_h_freqs[(v_s % 288)] <= v_f) {
+          goto label__0__break;
+        }
+        self->private_data.f_h_sorted[v_j] = ((uint16_t)(v_s));
+        v_j -= 1;
+      }
+      label__0__break:;
+      if (v_j < 288) {
+        self->private_data.f_h_sorted[v_j] = ((uint16_t)(v_i));
+      }
+      v_m += 1;
+    }
+    v_i += 1;
+  }
+  if (v_m == 0) {
+    self->private_data.f_h_sorted[0] = 0;
+    self->private_data.f_h_sorted[1] = 1;
+    v_m = 2;
+  } else if (v_m == 1) {
+    self->private_data.f_h_sorted[1] = self->private_data.f_h_sorted[0];
+    if (self->private_data.f_h_sorted[1] == 0) {
+      self->private_data.f_h_sorted[0] = 1;
+    } else {
+      self->private_data.f_h_sorted[0] = 0;
+    }
+    v_m = 2;
+  }
+  if ((v_m < 2) || (v_m > 288)) {
+    return wuffs_base__make_empty_struct();
+  }
+  v_n_nodes = ((2 * v_m) - 1);
+  v_i = 0;
+  while ((v_i < v_m) && (v_i < 288)) {
+    self->private_data.f_h_nfreqs[v_i] = self->private_data.f_h_freqs[(((uint32_t)(self->private_data.f_h_sorted[v_i])) % 288)];
+    v_i += 1;
+  }
+  v_li = 0;
+  v_ni = (v_m & 1023);
+  v_nn = v_m;
+  while ((v_nn < v_n_nodes) && (v_nn < 1023)) {
+    if ((v_li < v_m) && ((v_ni >= v_nn) || (self->private_data.f_h_nfreqs[v_li] <= self->private_data.f_h_nfreqs[v_ni]))) {
+      v_a = v_li;
+      v_li = ((v_li + 1) & 1023);
+    } else {
+      v_a = v_ni;
+      v_ni = ((v_ni + 1) & 1023);
+    }
+    if ((v_li < v_m) && ((v_ni >= v_nn) || (self->private_data.f_h_nfreqs[v_li] <= self->private_data.f_h_nfreqs[v_ni]))) {
+      v_b = v_li;
+      v_li = ((v_li + 1) & 1023);
+    } else {
+      v_b = v_ni;
+      v_ni = ((v_ni + 1) & 1023);
+    }
+    self->private_data.f_h_nfreqs[v_nn] = wuffs_base__u32__sat_add(self->private_data.f_h_nfreqs[v_a], self->private_data.f_h_nfreqs[v_b]);
+    self->private_data.f_h_nparent[v_a] = ((uint16_t)(v_nn));
+    self->private_data.f_h_nparent[v_b] = ((uint16_t)(v_nn));
+    v_nn += 1;
+  }
+  if ((v_nn < 3) || (v_nn > 575)) {
+    return wuffs_base__make_empty_struct();
+  }
+  self->private_data.f_h_depths[(v_nn - 1)] = 0;
+  v_j = (v_nn - 1);
+  while ((v_j > 0) && (v_j < 1024)) {
+    v_j -= 1;
+    v_f = ((uint32_t)(self->private_data.f_h_depths[(((uint32_t)(self->private_data.f_h_nparent[v_j])) & 1023)]));
+    v_d = wuffs_base__u32__min(v_f, 14);
+    self->private_data.f_h_depths[v_j] = ((uint8_t)((v_d + 1)));
+  }
+  if (a_max_len == 0) {
+    return wuffs_base__make_empty_struct();
+  }
+  v_k = 0;
+  while (v_k < 15) {
+    self->private_data.f_h_counts[v_k] = 0;
+    v_k += 1;
+  }
+  self->private_data.f_h_counts[15] = 0;
+  v_total = 0;
+  v_i = 0;
+  while ((v_i < v_m) && (v_i < 288)) {
+    v_f = ((uint32_t)(self->private_data.f_h_depths[v_i]));
+    v_d = wuffs_base__u32__min(v_f, a_max_len);
+    self->private_data.f_h_counts[v_d] += 1;
+    v_total += (((uint32_t)(32768)) >> v_d);
+    v_i += 1;
+  }
+  while (v_total > 32768) {
+    if ((a_max_len == 0) || (self->private_data.f_h_counts[a_max_len] <= 0)) {
+      goto label__1__break;
+    }
+    self->private_data.f_h_counts[a_max_len] -= 1;
+    v_k = a_max_len;
+    while (v_k > 1) {
+      v_k -= 1;
+      if (self->private_data.f_h_counts[v_k] > 0) {
+        self->private_data.f_h_counts[v_k] -= 1;
+        self->private_data.f_h_counts[(v_k + 1)] += 2;
+        goto label__2__break;
+      }
+    }
+    label__2__break:;
+    wuffs_base__u32__sat_sub_indirect(&v_total, (((uint32_t)(1)) << (15 - a_max_len)));
+  }
+  label__1__break:;
+  v_j = 0;
+  v_k = a_max_len;
+  while (v_k > 0) {
+    v_count = self->private_data.f_h_counts[v_k];
+    while ((v_count > 0) && (v_j < v_m) && (v_j < 288)) {
+      self->private_impl.f_h_lengths[(((uint32_t)(self->private_data.f_h_sorted[v_j])) % 288)] = ((uint8_t)(v_k));
+      v_count -= 1;
+      v_j += 1;
+    }
+    v_k -= 1;
+  }
+  wuffs_deflate__encoder__assign_codes(self, a_n);
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func deflate.encoder.assign_codes
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__assign_codes(
+    wuffs_deflate__encoder* self,
+    uint32_t a_n) {
+  uint32_t v_i = 0;
+  uint32_t v_k = 0;
+  uint32_t v_code = 0;
+  uint32_t v_len = 0;
+  uint32_t v_c = 0;
+
+  v_k = 0;
+  while (v_k < 16) {
+    self->private_data.f_h_counts[v_k] = 0;
+    v_k += 1;
+  }
+  v_i = 0;
+  while ((v_i < a_n) && (v_i < 288)) {
+    self->private_data.f_h_counts[self->private_impl.f_h_lengths[v_i]] += 1;
+    v_i += 1;
+  }
+  self->private_data.f_h_counts[0] = 0;
+  v_code = 0;
+  v_k = 1;
+  while (v_k < 16) {
+    v_code = (((uint32_t)(((uint32_t)(v_code + self->private_data.f_h_counts[(v_k - 1)])) << 1)) & 65535);
+    self->private_data.f_h_next[v_k] = v_code;
+    v_k += 1;
+  }
+  v_i = 0;
+  while ((v_i < a_n) && (v_i < 288)) {
+    v_len = ((uint32_t)(self->private_impl.f_h_lengths[v_i]));
+    if (v_len > 0) {
+      v_c = (self->private_data.f_h_next[v_len] & 65535);
+      self->private_data.f_h_next[v_len] = ((v_c + 1) & 65535);
+      v_c = ((((uint32_t)(WUFFS_DEFLATE__REVERSE8[(v_c & 255)])) << 8) | ((uint32_t)(WUFFS_DEFLATE__REVERSE8[((v_c >> 8) & 255)])));
+      self->private_data.f_h_codes[v_i] = ((uint16_t)(((v_c >> (16 - v_len)) & 65535)));
+    }
+    v_i += 1;
+  }
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func deflate.encoder.write_bits
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__write_bits(
+    wuffs_deflate__encoder* self,
+    uint32_t a_bits,
+    uint32_t a_n_bits) {
+  uint32_t v_n = 0;
+
+  self->private_impl.f_bits |= (((uint64_t)(a_bits)) << self->private_impl.f_n_bits);
+  v_n = (self->private_impl.f_n_bits + a_n_bits);
+  while (v_n >= 8) {
+    self->private_data.f_out[self->private_impl.f_out_wi] = ((uint8_t)((self->private_impl.f_bits & 255)));
+    self->private_impl.f_out_wi = ((self->private_impl.f_out_wi + 1) & 65535);
+    self->private_impl.f_bits >>= 8;
+    v_n -= 8;
+  }
+  self->private_impl.f_n_bits = v_n;
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func deflate.encoder.write_block
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__write_block(
+    wuffs_deflate__encoder* self,
+    bool a_final,
+    uint32_t a_start,
+    uint32_t a_n,
+    bool a_stored_only) {
+  uint32_t v_f = 0;
+  uint32_t v_i = 0;
+  uint32_t v_s = 0;
+  uint32_t v_fl = 0;
+  uint32_t v_hlit = 0;
+  uint32_t v_hdist = 0;
+  uint32_t v_hclen = 0;
+  uint32_t v_n_seq = 0;
+  uint32_t v_n_rle = 0;
+  uint32_t v_v = 0;
+  uint32_t v_prev = 0;
+  uint32_t v_run = 0;
+  uint32_t v_cl = 0;
+  uint32_t v_wi = 0;
+  uint32_t v_extra = 0;
+  uint64_t v_freq = 0;
+  uint64_t v_c_dyn = 0;
+  uint64_t v_c_fixed = 0;
+  uint64_t v_c_stored = 0;
+
+  if (a_final) {
+    v_f = 1;
+  }
+  if ( ! a_stored_only) {
+    self->private_data.f_lfreqs[256] = 1;
+    v_i = 0;
+    while (v_i < 286) {
+      self->private_data.f_h_freqs[v_i] = self->private_data.f_lfreqs[v_i];
+      v_i += 1;
+    }
+    wuffs_deflate__encoder__build_huffman(self, 286, 15);
+    v_i = 0;
+    while (v_i < 286) {
+      self->private_impl.f_llens[v_i] = self->private_impl.f_h_lengths[v_i];
+      self->private_data.f_lcodes[v_i] = self->private_data.f_h_codes[v_i];
+      v_i += 1;
+    }
+    v_i = 0;
+    while (v_i < 30) {
+      self->private_data.f_h_freqs[v_i] = self->private_data.f_dfreqs[v_i];
+      v_i += 1;
+    }
+    wuffs_deflate__encoder__build_huffman(self, 30, 15);
+    v_i = 0;
+    while (v_i < 30) {
+      self->private_impl.f_dlens[v_i] = self->private_impl.f_h_lengths[v_i];
+      self->private_data.f_dcodes[v_i] = self->private_data.f_h_codes[v_i];
+      v_i += 1;
+    }
+    v_hlit = 286;
+    while ((v_hlit > 257) && (self->private_impl.f_llens[(v_hlit - 1)] == 0)) {
+      v_hlit -= 1;
+    }
+    v_hdist = 30;
+    while ((v_hdist > 1) && (self->private_impl.f_dlens[(v_hdist - 1)] == 0)) {
+      v_hdist -= 1;
+    }
+    v_i = 0;
+    while ((v_i < v_hlit) && (v_i < 286)) {
+      self->private_impl.f_cl_seq[v_i] = self->private_impl.f_llens[v_i];
+      v_i += 1;
+    }
+    v_i = 0;
+    while ((v_i < v_hdist) && (v_i < 30)) {
+      self->private_impl.f_cl_seq[(v_hlit + v_i)] = self->private_impl.f_dlens[v_i];
+      v_i += 1;
+    }
+    v_n_seq = (v_hlit + v_hdist);
+    v_i = 0;
+    while (v_i < 19) {
+      self->private_data.f_h_freqs[v_i] = 0;
+      v_i += 1;
+    }
+    v_prev = 255;
+    v_i = 0;
+    while ((v_i < v_n_seq) && (v_i < 316) && (v_n_rle < 316)) {
+      v_v = ((uint32_t)(self->private_impl.f_cl_seq[v_i]));
+      v_run = 1;
+      while ((v_run < 138) && ((v_i + v_run) < v_n_seq) && ((v_i + v_run) < 316)) {
+        if (((uint32_t)(self->private_impl.f_cl_seq[(v_i + v_run)])) != v_v) {
+          goto label__0__break;
+        }
+        v_run += 1;
+      }
+      label__0__break:;
+      if (v_v == 0) {
+        if (v_run >= 11) {
+          self->private_data.f_rle[v_n_rle] = ((uint16_t)((18 | ((v_run - 11) << 5))));
+          self->private_data.f_h_freqs[18] += 1;
+        } else if (v_run >= 3) {
+          self->private_data.f_rle[v_n_rle] = ((uint16_t)((17 | ((v_run - 3) << 5))));
+          self->private_data.f_h_freqs[17] += 1;
+        } else {
+          self->private_data.f_rle[v_n_rle] = 0;
+          self->private_data.f_h_freqs[0] += 1;
+          v_run = 1;
+        }
+      } else if ((v_v == v_prev) && (v_run >= 3)) {
+        v_run = wuffs_base__u32__min(v_run, 6);
+        self->private_data.f_rle[v_n_rle] = ((uint16_t)((16 | ((v_run - 3) << 5))));
+        self->private_data.f_h_freqs[16] += 1;
+      } else {
+        self->private_data.f_rle[v_n_rle] = ((uint16_t)(v_v));
+        self->private_data.f_h_freqs[v_v] += 1;
+        v_run = 1;
+      }
+      v_prev = v_v;
+      v_i += v_run;
+      v_n_rle += 1;
+    }
+    wuffs_deflate__encoder__build_huffman(self, 19, 7);
+    v_i = 0;
+    while (v_i < 19) {
+      self->private_impl.f_cllens[v_i] = self->private_impl.f_h_lengths[v_i];
+      self->private_data.f_clcodes[v_i] = self->private_data.f_h_codes[v_i];
+      v_i += 1;
+    }
+    v_hclen = 19;
+    while ((v_hclen > 4) && (self->private_impl.f_cllens[WUFFS_DEFLATE__CODE_ORDER[(v_hclen - 1)]] == 0)) {
+      v_hclen -= 1;
+    }
+    v_c_dyn = (17 + (3 * ((uint64_t)(v_hclen))));
+    v_i = 0;
+    while ((v_i < v_n_rle) && (v_i < 316)) {
+      v_s = (((uint32_t)(self->private_data.f_rle[v_i])) & 31);
+      if (v_s < 19) {
+        v_c_dyn += ((uint64_t)(self->private_impl.f_cllens[v_s]));
+        if (v_s == 16) {
+          v_c_dyn += 2;
+        } else if (v_s == 17) {
+          v_c_dyn += 3;
+        } else if (v_s == 18) {
+          v_c_dyn += 7;
+        }
+      }
+      v_i += 1;
+    }
+    v_c_fixed = 3;
+    v_i = 0;
+    while (v_i < 286) {
+      v_freq = ((uint64_t)(self->private_data.f_lfreqs[v_i]));
+      if (v_freq > 0) {
+        v_extra = 0;
+        if (v_i < 144) {
+          v_fl = 8;
+        } else if (v_i < 256) {
+          v_fl = 9;
+        } else if (v_i < 280) {
+          v_fl = 7;
+        } else {
+          v_fl = 8;
+        }
+        if (v_i > 256) {
+          v_extra = ((WUFFS_DEFLATE__LCODE_MAGIC_NUMBERS[((v_i - 257) & 31)] >> 4) & 15);
+        }
+        v_c_dyn += ((uint64_t)(v_freq * ((uint64_t)((((uint32_t)(self->private_impl.f_llens[v_i])) + v_extra)))));
+        v_c_fixed += ((uint64_t)(v_freq * ((uint64_t)((v_fl + v_extra)))));
+      }
+      v_i += 1;
+    }
+    v_i = 0;
+    while (v_i < 30) {
+      v_freq = ((uint64_t)(self->private_data.f_dfreqs[v_i]));
+      if (v_freq > 0) {
+        v_extra = ((WUFFS_DEFLATE__DCODE_MAGIC_NUMBERS[v_i] >> 4) & 15);
+        v_c_dyn += ((uint64_t)(v_freq * ((uint64_t)((((uint32_t)(self->private_impl.f_dlens[v_i])) + v_extra)))));
+        v_c_fixed += ((uint64_t)(v_freq * ((uint64_t)((5 + v_extra)))));
+      }
+      v_i += 1;
+    }
+    v_c_stored = ((uint64_t)((3 +
+        ((8 - ((self->private_impl.f_n_bits + 3) & 7)) & 7) +
+        32 +
+        (8 * a_n))));
+    if ((v_c_dyn < v_c_fixed) && (v_c_dyn < v_c_stored)) {
+      wuffs_deflate__encoder__write_bits(self, (v_f | 4), 3);
+      wuffs_deflate__encoder__write_bits(self, (((uint32_t)(v_hlit - 257)) & 31), 5);
+      wuffs_deflate__encoder__write_bits(self, (((uint32_t)(v_hdist - 1)) & 31), 5);
+      wuffs_deflate__encoder__write_bits(self, (((uint32_t)(v_hclen - 4)) & 15), 4);
+      v_i = 0;
+      while ((v_i < v_hclen) && (v_i < 19)) {
+        wuffs_deflate__encoder__write_bits(self, ((uint32_t)(self->private_impl.f_cllens[WUFFS_DEFLATE__CODE_ORDER[v_i]])), 3);
+        v_i += 1;
+      }
+      v_i = 0;
+      while ((v_i < v_n_rle) && (v_i < 316)) {
+        v_s = ((uint32_t)(self->private_data.f_rle[v_i]));
+        v_cl = wuffs_base__u32__min(((v_s) & 0x1F), 18);
+        wuffs_deflate__encoder__write_bits(self, ((uint32_t)(self->private_data.f_clcodes[v_cl])), ((uint32_t)(self->private_impl.f_cllens[v_cl])));
+        if (v_cl == 16) {
+          wuffs_deflate__encoder__write_bits(self, ((v_s >> 5) & 3), 2);
+        } else if (v_cl == 17) {
+          wuffs_deflate__encoder__write_bits(self, ((v_s >> 5) & 7), 3);
+        } else if (v_cl == 18) {
+          wuffs_deflate__encoder__write_bits(self, ((v_s >> 5) & 127), 7);
+        }
+        v_i += 1;
+      }
+      wuffs_deflate__encoder__write_syms(self);
+      wuffs_deflate__encoder__finish_block(self, a_final);
+      return wuffs_base__make_empty_struct();
+    } else if (v_c_fixed < v_c_stored) {
+      wuffs_deflate__encoder__write_bits(self, (v_f | 2), 3);
+      v_i = 0;
+      while (v_i < 288) {
+        if (v_i < 144) {
+          self->private_impl.f_h_lengths[v_i] = 8;
+        } else if (v_i < 256) {
+          self->private_impl.f_h_lengths[v_i] = 9;
+        } else if (v_i < 280) {
+          self->private_impl.f_h_lengths[v_i] = 7;
+        } else {
+          self->private_impl.f_h_lengths[v_i] = 8;
+        }
+        v_i += 1;
+      }
+      wuffs_deflate__encoder__assign_codes(self, 288);
+      v_i = 0;
+      while (v_i < 288) {
+        self->private_impl.f_llens[v_i] = self->private_impl.f_h_lengths[v_i];
+        self->private_data.f_lcodes[v_i] = self->private_data.f_h_codes[v_i];
+        v_i += 1;
+      }
+      v_i = 0;
+      while (v_i < 30) {
+        self->private_impl.f_h_lengths[v_i] = 5;
+        v_i += 1;
+      }
+      wuffs_deflate__encoder__assign_codes(self, 30);
+      v_i = 0;
+      while (v_i < 30) {
+        self->private_impl.f_dlens[v_i] = self->private_impl.f_h_lengths[v_i];
+        self->private_data.f_dcodes[v_i] = self->private_data.f_h_codes[v_i];
+        v_i += 1;
+      }
+      wuffs_deflate__encoder__write_syms(self);
+      wuffs_deflate__encoder__finish_block(self, a_final);
+      return wuffs_base__make_empty_struct();
+    }
+  }
+  wuffs_deflate__encoder__write_bits(self, v_f, 3);
+  if (self->private_impl.f_n_bits > 0) {
+    wuffs_deflate__encoder__write_bits(self, 0, (8 - self->private_impl.f_n_bits));
+  }
+  wuffs_deflate__encoder__write_bits(self, (a_n & 65535), 16);
+  wuffs_deflate__encoder__write_bits(self, (65535 ^ (a_n & 65535)), 16);
+  v_wi = self->private_impl.f_out_wi;
+  if (v_wi < 32768) {
+    wuffs_base__slice_u8__copy_from_slice(wuffs_base__slice_u8__subslice_ij(wuffs_base__make_slice_u8(self->private_data.f_out, 65544), v_wi, (v_wi + 32768)), wuffs_base__slice_u8__subslice_ij(wuffs_base__make_slice_u8(self->private_data.f_window,
+        65824),
+        a_start,
+        (a_start + a_n)));
+    self->private_impl.f_out_wi = (v_wi + a_n);
+  }
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func deflate.encoder.write_full_flush
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__write_full_flush(
+    wuffs_deflate__encoder* self) {
+  wuffs_deflate__encoder__write_bits(self, 0, 3);
+  if (self->private_impl.f_n_bits > 0) {
+    wuffs_deflate__encoder__write_bits(self, 0, (8 - self->private_impl.f_n_bits));
+  }
+  wuffs_deflate__encoder__write_bits(self, 0, 16);
+  wuffs_deflate__encoder__write_bits(self, 65535, 16);
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func deflate.encoder.finish_block
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__finish_block(
+    wuffs_deflate__encoder* self,
+    bool a_final) {
+  if (a_final && (self->private_impl.f_n_bits > 0)) {
+    wuffs_deflate__encoder__write_bits(self, 0, (8 - self->private_impl.f_n_bits));
+  }
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func deflate.encoder.write_syms
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__write_syms(
+    wuffs_deflate__encoder* self) {
+  uint64_t v_bits = 0;
+  uint32_t v_n_bits = 0;
+  uint32_t v_wi = 0;
+  uint32_t v_i = 0;
+  uint32_t v_sym = 0;
+  uint32_t v_len = 0;
+  uint32_t v_dm1 = 0;
+  uint32_t v_lc = 0;
+  uint32_t v_dc = 0;
+  uint32_t v_magic = 0;
+  wuffs_base__slice_u8 v_s = {0};
+
+  v_bits = self->private_impl.f_bits;
+  v_n_bits = self->private_impl.f_n_bits;
+  v_wi = self->private_impl.f_out_wi;
+  label__0__continue:;
+  while ((v_i < self->private_impl.f_n_syms) && (v_i < 32768)) {
+    v_s = wuffs_base__slice_u8__subslice_i(wuffs_base__make_slice_u8(self->private_data.f_out, 65544), v_wi);
+    if (((uint64_t)(v_s.len)) >= 8) {
+      wuffs_base__poke_u64le__no_bounds_check(v_s.ptr, v_bits);
+    }
+    v_wi = ((v_wi + (v_n_bits >> 3)) & 65535);
+    v_bits >>= (v_n_bits & 56);
+    v_n_bits &= 7;
+    v_sym = self->private_data.f_syms[v_i];
+    v_i += 1;
+    if (v_sym < 256) {
+      v_bits |= ((uint64_t)(((uint64_t)(self->private_data.f_lcodes[v_sym])) << v_n_bits));
+      v_n_bits += ((uint32_t)(self->private_impl.f_llens[v_sym]));
+      goto label__0__continue;
+    }
+    v_len = ((uint32_t)((v_sym >> 16) - 3));
+    v_lc = ((uint32_t)(WUFFS_DEFLATE__LCODE_FROM_LENGTH_MINUS_3[(v_len & 255)]));
+    v_bits |= ((uint64_t)(((uint64_t)(self->private_data.f_lcodes[(257 + v_lc)])) << v_n_bits));
+    v_n_bits += ((uint32_t)(self->private_impl.f_llens[(257 + v_lc)]));
+    v_magic = WUFFS_DEFLATE__LCODE_MAGIC_NUMBERS[v_lc];
+    v_bits |= ((uint64_t)(((uint64_t)((((uint32_t)(v_len - ((v_magic >> 8) & 65535))) & 31))) << v_n_bits));
+    v_n_bits += ((v_magic >> 4) & 15);
+    v_dm1 = (v_sym & 32767);
+    v_dc = wuffs_deflate__encoder__dcode(self, v_dm1);
+    v_bits |= ((uint64_t)(((uint64_t)(self->private_data.f_dcodes[v_dc])) << v_n_bits));
+    v_n_bits += ((uint32_t)(self->private_impl.f_dlens[v_dc]));
+    v_magic = WUFFS_DEFLATE__DCODE_MAGIC_NUMBERS[v_dc];
+    v_bits |= ((uint64_t)(((uint64_t)((((uint32_t)(v_dm1 - ((v_magic >> 8) & 32767))) & 8191))) << v_n_bits));
+    v_n_bits += ((v_magic >> 4) & 15);
+  }
+  v_s = wuffs_base__slice_u8__subslice_i(wuffs_base__make_slice_u8(self->private_data.f_out, 65544), v_wi);
+  if (((uint64_t)(v_s.len)) >= 8) {
+    wuffs_base__poke_u64le__no_bounds_check(v_s.ptr, v_bits);
+  }
+  v_wi = ((v_wi + (v_n_bits >> 3)) & 65535);
+  v_bits >>= (v_n_bits & 56);
+  v_n_bits &= 7;
+  v_bits |= ((uint64_t)(((uint64_t)(self->private_data.f_lcodes[256])) << v_n_bits));
+  v_n_bits += ((uint32_t)(self->private_impl.f_llens[256]));
+  self->private_impl.f_bits = v_bits;
+  self->private_impl.f_n_bits = 0;
+  self->private_impl.f_out_wi = v_wi;
+  wuffs_deflate__encoder__flush_bits(self, v_n_bits);
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func deflate.encoder.flush_bits
+
+static wuffs_base__empty_struct
+wuffs_deflate__encoder__flush_bits(
+    wuffs_deflate__encoder* self,
+    uint32_t a_n_bits) {
+  uint32_t v_n = 0;
+
+  v_n = wuffs_base__u32__min(a_n_bits, 64);
+  while (v_n >= 8) {
+    self->private_data.f_out[self->private_impl.f_out_wi] = ((uint8_t)((self->private_impl.f_bits & 255)));
+    self->private_impl.f_out_wi = ((self->private_impl.f_out_wi + 1) & 65535);
+    self->private_impl.f_bits >>= 8;
+    v_n -= 8;
+  }
+  self->private_impl.f_n_bits = v_n;
+  return wuffs_base__make_empty_struct();
+}
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+// -------- func deflate.encoder.longest_match_x86_sse42
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static uint32_t
+wuffs_deflate__encoder__longest_match_x86_sse42(
+    wuffs_deflate__encoder* self,
+    uint32_t a_cur,
+    uint32_t a_head,
+    uint32_t a_max_len,
+    uint32_t a_min_len,
+    uint32_t a_chain,
+    uint32_t a_nice) {
+  uint32_t v_best_len = 0;
+  uint32_t v_best_dm1 = 0;
+  uint32_t v_chain = 0;
+  uint32_t v_c = 0;
+  uint32_t v_n = 0;
+  uint32_t v_mask = 0;
+  wuffs_base__slice_u8 v_sa = {0};
+  wuffs_base__slice_u8 v_sb = {0};
+  __m128i v_va = {0};
+  __m128i v_vb = {0};
+
+  v_best_len = wuffs_base__u32__max(a_min_len, 2);
+  if (a_max_len <= v_best_len) {
+    return 0;
+  }
+  v_chain = a_chain;
+  v_c = a_head;
+  while (v_chain > 0) {
+    v_chain -= 1;
+    if ((v_c == 0) || (a_cur <= v_c)) {
+      goto label__0__break;
+    } else if ((a_cur - v_c) >= 32768) {
+      goto label__0__break;
+    }
+    if ((self->private_data.f_window[(v_c + v_best_len)] == self->private_data.f_window[(a_cur + v_best_len)]) && (self->private_data.f_window[v_c] == self->private_data.f_window[a_cur])) {
+      v_n = 0;
+      while ((v_n < a_max_len) && (v_n < 258)) {
+        v_sa = wuffs_base__slice_u8__subslice_i(wuffs_base__make_slice_u8(self->private_data.f_window, 65824), (a_cur + v_n));
+        v_sb = wuffs_base__slice_u8__subslice_i(wuffs_base__make_slice_u8(self->private_data.f_window, 65824), (v_c + v_n));
+        if ((((uint64_t)(v_sa.len)) < 16) || (((uint64_t)(v_sb.len)) < 16)) {
+          goto label__1__break;
+        }
+        v_va = _mm_lddqu_si128((const __m128i*)(const void*)(v_sa.ptr));
+        v_vb = _mm_lddqu_si128((const __m128i*)(const void*)(v_sb.ptr));
+        v_mask = ((((uint32_t)(_mm_movemask_epi8(_mm_cmpeq_epi8(v_va, v_vb)))) & 65535) ^ 65535);
+        if (v_mask != 0) {
+          v_n += ((uint32_t)(WUFFS_DEFLATE__DEBRUIJN_CTZ[(((uint64_t)(((uint64_t)((v_mask & ((uint32_t)(0 - v_mask))))) * 285870213051386505)) >> 58)]));
+          goto label__1__break;
+        }
+        v_n += 16;
+      }
+      label__1__break:;
+      v_n = wuffs_base__u32__min(v_n, a_max_len);
+      if (v_best_len < v_n) {
+        v_best_len = v_n;
+        v_best_dm1 = (((uint32_t)(((uint32_t)(a_cur - v_c)) - 1)) & 32767);
+        if ((v_n >= a_nice) || (v_n >= a_max_len)) {
+          goto label__0__break;
+        }
+      }
+    }
+    v_c = ((uint32_t)(self->private_data.f_prev[(v_c & 32767)]));
+  }
+  label__0__break:;
+  if (v_best_len <= wuffs_base__u32__max(a_min_len, 2)) {
+    return 0;
+  }
+  return ((v_best_dm1 << 16) | v_best_len);
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
+
+#endif  // !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__DEFLATE)
+
+#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__LZW)
+
+// ---------------- Status Codes Implementations
+
+const char wuffs_lzw__error__bad_code[] = "#lzw: bad code";
+const char wuffs_lzw__error__internal_error_inconsistent_i_o[] = "#lzw: internal error: inconsistent I/O";
+
+// ---------------- Private Consts
+
+// ---------------- Private Initializer Prototypes
+
+// ---------------- Private Function Prototypes
+
+static wuffs_base__empty_struct
+wuffs_lzw__decoder__read_from(
+    wuffs_lzw__decoder* self,
+    wuffs_base__io_buffer* a_src);
+
+static wuffs_base__empty_struct
+wuffs_lzw__decoder__read_from_fast(
+    wuffs_lzw__decoder* self,
+    wuffs_base__io_buffer* a_dst,
+    wuffs_base__io_buffer* a_src);
 
 static wuffs_base__status
-wuffs_gif__decoder__copy_to_image_buffer(
-    wuffs_gif__decoder* self,
-    wuffs_base__pixel_buffer* a_pb,
-    wuffs_base__slice_u8 a_src);
+wuffs_lzw__decoder__write_to(
+    wuffs_lzw__decoder* self,
+    wuffs_base__io_buffer* a_dst);
 
 // ---------------- VTables
 
-const wuffs_base__image_decoder__func_ptrs
-wuffs_gif__decoder__func_ptrs_for__wuffs_base__image_decoder = {
-  (wuffs_base__status(*)(void*,
-      wuffs_base__pixel_buffer*,
-      wuffs_base__io_buffer*,
-      wuffs_base__pixel_blend,
-      wuffs_base__slice_u8,
-      wuffs_base__decode_frame_options*))(&wuffs_gif__decoder__decode_frame),
-  (wuffs_base__status(*)(void*,
-      wuffs_base__frame_config*,
-      wuffs_base__io_buffer*))(&wuffs_gif__decoder__decode_frame_config),
-  (wuffs_base__status(*)(void*,
-      wuffs_base__image_config*,
-      wuffs_base__io_buffer*))(&wuffs_gif__decoder__decode_image_config),
-  (wuffs_base__rect_ie_u32(*)(const void*))(&wuffs_gif__decoder__frame_dirty_rect),
-  (uint32_t(*)(const void*))(&wuffs_gif__decoder__num_animation_loops),
-  (uint64_t(*)(const void*))(&wuffs_gif__decoder__num_decoded_frame_configs),
-  (uint64_t(*)(const void*))(&wuffs_gif__decoder__num_decoded_frames),
-  (wuffs_base__status(*)(void*,
-      uint64_t,
-      uint64_t))(&wuffs_gif__decoder__restart_frame),
-  (wuffs_base__empty_struct(*)(void*,
-      uint32_t,
-      bool))(&wuffs_gif__decoder__set_quirk_enabled),
+const wuffs_base__io_transformer__func_ptrs
+wuffs_lzw__decoder__func_ptrs_for__wuffs_base__io_transformer = {
   (wuffs_base__empty_struct(*)(void*,
       uint32_t,
-      bool))(&wuffs_gif__decoder__set_report_metadata),
+      bool))(&wuffs_lzw__decoder__set_quirk_enabled),
   (wuffs_base__status(*)(void*,
       wuffs_base__io_buffer*,
-      wuffs_base__more_information*,
-      wuffs_base__io_buffer*))(&wuffs_gif__decoder__tell_me_more),
-  (wuffs_base__range_ii_u64(*)(const void*))(&wuffs_gif__decoder__workbuf_len),
+      wuffs_base__io_buffer*,
+      wuffs_base__slice_u8))(&wuffs_lzw__decoder__transform_io),
+  (wuffs_base__range_ii_u64(*)(const void*))(&wuffs_lzw__decoder__workbuf_len),
 };
 
 // ---------------- Initializer Implementations
 
 wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
-wuffs_gif__decoder__initialize(
-    wuffs_gif__decoder* self,
+wuffs_lzw__decoder__initialize(
+    wuffs_lzw__decoder* self,
     size_t sizeof_star_self,
     uint64_t wuffs_version,
     uint32_t options){
@@ -28405,30 +34794,23 @@ wuffs_gif__decoder__initialize(
     }
   }
 
-  {
-    wuffs_base__status z = wuffs_lzw__decoder__initialize(
-        &self->private_data.f_lzw, sizeof(self->private_data.f_lzw), WUFFS_VERSION, options);
-    if (z.repr) {
-      return z;
-    }
-  }
   self->private_impl.magic = WUFFS_BASE__MAGIC;
-  self->private_impl.vtable_for__wuffs_base__image_decoder.vtable_name =
-      wuffs_base__image_decoder__vtable_name;
-  self->private_impl.vtable_for__wuffs_base__image_decoder.function_pointers =
-      (const void*)(&wuffs_gif__decoder__func_ptrs_for__wuffs_base__image_decoder);
+  self->private_impl.vtable_for__wuffs_base__io_transformer.vtable_name =
+      wuffs_base__io_transformer__vtable_name;
+  self->private_impl.vtable_for__wuffs_base__io_transformer.function_pointers =
+      (const void*)(&wuffs_lzw__decoder__func_ptrs_for__wuffs_base__io_transformer);
   return wuffs_base__make_status(NULL);
 }
 
-wuffs_gif__decoder*
-wuffs_gif__decoder__alloc() {
-  wuffs_gif__decoder* x =
-      (wuffs_gif__decoder*)(calloc(sizeof(wuffs_gif__decoder), 1));
+wuffs_lzw__decoder*
+wuffs_lzw__decoder__alloc() {
+  wuffs_lzw__decoder* x =
+      (wuffs_lzw__decoder*)(calloc(sizeof(wuffs_lzw__decoder), 1));
   if (!x) {
     return NULL;
   }
-  if (wuffs_gif__decoder__initialize(
-      x, sizeof(wuffs_gif__decoder), WUFFS_VERSION, WUFFS_INITIALIZE__ALREADY_ZEROED).repr) {
+  if (wuffs_lzw__decoder__initialize(
+      x, sizeof(wuffs_lzw__decoder), WUFFS_VERSION, WUFFS_INITIALIZE__ALREADY_ZEROED).repr) {
     free(x);
     return NULL;
   }
@@ -28436,42 +34818,67 @@ wuffs_gif__decoder__alloc() {
 }
 
 size_t
-sizeof__wuffs_gif__decoder() {
-  return sizeof(wuffs_gif__decoder);
+sizeof__wuffs_lzw__decoder() {
+  return sizeof(wuffs_lzw__decoder);
 }
 
 // ---------------- Function Implementations
 
-// -------- func gif.decoder.set_quirk_enabled
+// -------- func lzw.decoder.set_quirk_enabled
 
 WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
-wuffs_gif__decoder__set_quirk_enabled(
-    wuffs_gif__decoder* self,
+wuffs_lzw__decoder__set_quirk_enabled(
+    wuffs_lzw__decoder* self,
     uint32_t a_quirk,
     bool a_enabled) {
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func lzw.decoder.set_literal_width
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_lzw__decoder__set_literal_width(
+    wuffs_lzw__decoder* self,
+    uint32_t a_lw) {
   if (!self) {
     return wuffs_base__make_empty_struct();
   }
   if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
     return wuffs_base__make_empty_struct();
   }
-
-  if ((self->private_impl.f_call_sequence == 0) && (a_quirk >= 1041635328)) {
-    a_quirk -= 1041635328;
-    if (a_quirk < 7) {
-      self->private_impl.f_quirks[a_quirk] = a_enabled;
-    }
+  if (a_lw > 8) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+    return wuffs_base__make_empty_struct();
   }
+
+  self->private_impl.f_set_literal_width_arg = (a_lw + 1);
   return wuffs_base__make_empty_struct();
 }
 
-// -------- func gif.decoder.decode_image_config
+// -------- func lzw.decoder.workbuf_len
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__range_ii_u64
+wuffs_lzw__decoder__workbuf_len(
+    const wuffs_lzw__decoder* self) {
+  if (!self) {
+    return wuffs_base__utility__empty_range_ii_u64();
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return wuffs_base__utility__empty_range_ii_u64();
+  }
+
+  return wuffs_base__utility__make_range_ii_u64(0, 0);
+}
+
+// -------- func lzw.decoder.transform_io
 
 WUFFS_BASE__MAYBE_STATIC wuffs_base__status
-wuffs_gif__decoder__decode_image_config(
-    wuffs_gif__decoder* self,
-    wuffs_base__image_config* a_dst,
-    wuffs_base__io_buffer* a_src) {
+wuffs_lzw__decoder__transform_io(
+    wuffs_lzw__decoder* self,
+    wuffs_base__io_buffer* a_dst,
+    wuffs_base__io_buffer* a_src,
+    wuffs_base__slice_u8 a_workbuf) {
   if (!self) {
     return wuffs_base__make_status(wuffs_base__error__bad_receiver);
   }
@@ -28481,7 +34888,7 @@ wuffs_gif__decoder__decode_image_config(
         ? wuffs_base__error__disabled_by_previous_error
         : wuffs_base__error__initialize_not_called);
   }
-  if (!a_src) {
+  if (!a_dst || !a_src) {
     self->private_impl.magic = WUFFS_BASE__DISABLED;
     return wuffs_base__make_status(wuffs_base__error__bad_argument);
   }
@@ -28493,129 +34900,345 @@ wuffs_gif__decoder__decode_image_config(
   self->private_impl.active_coroutine = 0;
   wuffs_base__status status = wuffs_base__make_status(NULL);
 
-  bool v_ffio = false;
+  uint32_t v_i = 0;
 
-  uint32_t coro_susp_point = self->private_impl.p_decode_image_config[0];
+  uint8_t* iop_a_dst = NULL;
+  uint8_t* io0_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io1_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io2_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_dst) {
+    io0_a_dst = a_dst->data.ptr;
+    io1_a_dst = io0_a_dst + a_dst->meta.wi;
+    iop_a_dst = io1_a_dst;
+    io2_a_dst = io0_a_dst + a_dst->data.len;
+    if (a_dst->meta.closed) {
+      io2_a_dst = iop_a_dst;
+    }
+  }
+  const uint8_t* iop_a_src = NULL;
+  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_src) {
+    io0_a_src = a_src->data.ptr;
+    io1_a_src = io0_a_src + a_src->meta.ri;
+    iop_a_src = io1_a_src;
+    io2_a_src = io0_a_src + a_src->meta.wi;
+  }
+
+  uint32_t coro_susp_point = self->private_impl.p_transform_io[0];
   switch (coro_susp_point) {
     WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
 
-    if (self->private_impl.f_call_sequence == 0) {
-      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
-      status = wuffs_gif__decoder__decode_header(self, a_src);
-      if (status.repr) {
-        goto suspend;
-      }
-      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
-      status = wuffs_gif__decoder__decode_lsd(self, a_src);
-      if (status.repr) {
-        goto suspend;
-      }
-    } else if (self->private_impl.f_call_sequence != 2) {
-      status = wuffs_base__make_status(wuffs_base__error__bad_call_sequence);
-      goto exit;
-    }
-    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
-    status = wuffs_gif__decoder__decode_up_to_id_part1(self, a_src);
-    if (status.repr) {
-      goto suspend;
-    }
-    v_ffio =  ! self->private_impl.f_gc_has_transparent_index;
-    if ( ! self->private_impl.f_quirks[2]) {
-      v_ffio = (v_ffio &&
-          (self->private_impl.f_frame_rect_x0 == 0) &&
-          (self->private_impl.f_frame_rect_y0 == 0) &&
-          (self->private_impl.f_frame_rect_x1 == self->private_impl.f_width) &&
-          (self->private_impl.f_frame_rect_y1 == self->private_impl.f_height));
-    } else if (v_ffio) {
-      self->private_impl.f_black_color_u32_argb_premul = 4278190080;
+    self->private_impl.f_literal_width = 8;
+    if (self->private_impl.f_set_literal_width_arg > 0) {
+      self->private_impl.f_literal_width = (self->private_impl.f_set_literal_width_arg - 1);
     }
-    if (self->private_impl.f_background_color_u32_argb_premul == 77) {
-      self->private_impl.f_background_color_u32_argb_premul = self->private_impl.f_black_color_u32_argb_premul;
+    self->private_impl.f_clear_code = (((uint32_t)(1)) << self->private_impl.f_literal_width);
+    self->private_impl.f_end_code = (self->private_impl.f_clear_code + 1);
+    self->private_impl.f_save_code = self->private_impl.f_end_code;
+    self->private_impl.f_prev_code = self->private_impl.f_end_code;
+    self->private_impl.f_width = (self->private_impl.f_literal_width + 1);
+    self->private_impl.f_bits = 0;
+    self->private_impl.f_n_bits = 0;
+    self->private_impl.f_output_ri = 0;
+    self->private_impl.f_output_wi = 0;
+    v_i = 0;
+    while (v_i < self->private_impl.f_clear_code) {
+      self->private_data.f_lm1s[v_i] = 0;
+      self->private_data.f_suffixes[v_i][0] = ((uint8_t)(v_i));
+      v_i += 1;
     }
-    if (a_dst != NULL) {
-      wuffs_base__image_config__set(
-          a_dst,
-          2198077448,
-          0,
-          self->private_impl.f_width,
-          self->private_impl.f_height,
-          self->private_impl.f_frame_config_io_position,
-          v_ffio);
+    label__0__continue:;
+    while (true) {
+      if ((self->private_impl.f_output_wi == 0) && (((uint64_t)(io2_a_dst - iop_a_dst)) >= 4105) && (((uint64_t)(io2_a_src - iop_a_src)) >= 8)) {
+        if (a_dst) {
+          a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+        }
+        if (a_src) {
+          a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+        }
+        wuffs_lzw__decoder__read_from_fast(self, a_dst, a_src);
+        if (a_dst) {
+          iop_a_dst = a_dst->data.ptr + a_dst->meta.wi;
+        }
+        if (a_src) {
+          iop_a_src = a_src->data.ptr + a_src->meta.ri;
+        }
+      } else {
+        if (a_src) {
+          a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+        }
+        wuffs_lzw__decoder__read_from(self, a_src);
+        if (a_src) {
+          iop_a_src = a_src->data.ptr + a_src->meta.ri;
+        }
+        if (self->private_impl.f_output_wi > 0) {
+          if (a_dst) {
+            a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+          }
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+          status = wuffs_lzw__decoder__write_to(self, a_dst);
+          if (a_dst) {
+            iop_a_dst = a_dst->data.ptr + a_dst->meta.wi;
+          }
+          if (status.repr) {
+            goto suspend;
+          }
+        }
+      }
+      if (self->private_impl.f_read_from_return_value == 0) {
+        goto label__0__break;
+      } else if (self->private_impl.f_read_from_return_value == 1) {
+        goto label__0__continue;
+      } else if (self->private_impl.f_read_from_return_value == 2) {
+        status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(2);
+      } else if (self->private_impl.f_read_from_return_value == 3) {
+        status = wuffs_base__make_status(wuffs_lzw__error__bad_code);
+        goto exit;
+      } else {
+        status = wuffs_base__make_status(wuffs_lzw__error__internal_error_inconsistent_i_o);
+        goto exit;
+      }
     }
-    self->private_impl.f_call_sequence = 3;
+    label__0__break:;
 
-    goto ok;
     ok:
-    self->private_impl.p_decode_image_config[0] = 0;
+    self->private_impl.p_transform_io[0] = 0;
     goto exit;
   }
 
   goto suspend;
   suspend:
-  self->private_impl.p_decode_image_config[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+  self->private_impl.p_transform_io[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
   self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 1 : 0;
 
   goto exit;
   exit:
+  if (a_dst) {
+    a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+  }
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  }
+
   if (wuffs_base__status__is_error(&status)) {
     self->private_impl.magic = WUFFS_BASE__DISABLED;
   }
   return status;
 }
 
-// -------- func gif.decoder.set_report_metadata
+// -------- func lzw.decoder.read_from
 
-WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
-wuffs_gif__decoder__set_report_metadata(
-    wuffs_gif__decoder* self,
-    uint32_t a_fourcc,
-    bool a_report) {
-  if (!self) {
-    return wuffs_base__make_empty_struct();
-  }
-  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
-    return wuffs_base__make_empty_struct();
+static wuffs_base__empty_struct
+wuffs_lzw__decoder__read_from(
+    wuffs_lzw__decoder* self,
+    wuffs_base__io_buffer* a_src) {
+  uint32_t v_clear_code = 0;
+  uint32_t v_end_code = 0;
+  uint32_t v_save_code = 0;
+  uint32_t v_prev_code = 0;
+  uint32_t v_width = 0;
+  uint32_t v_bits = 0;
+  uint32_t v_n_bits = 0;
+  uint32_t v_output_wi = 0;
+  uint32_t v_code = 0;
+  uint32_t v_c = 0;
+  uint32_t v_o = 0;
+  uint32_t v_steps = 0;
+  uint8_t v_first_byte = 0;
+  uint16_t v_lm1_b = 0;
+  uint16_t v_lm1_a = 0;
+
+  const uint8_t* iop_a_src = NULL;
+  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_src) {
+    io0_a_src = a_src->data.ptr;
+    io1_a_src = io0_a_src + a_src->meta.ri;
+    iop_a_src = io1_a_src;
+    io2_a_src = io0_a_src + a_src->meta.wi;
   }
 
-  if (a_fourcc == 1229144912) {
-    self->private_impl.f_report_metadata_iccp = a_report;
-  } else if (a_fourcc == 1481461792) {
-    self->private_impl.f_report_metadata_xmp = a_report;
+  v_clear_code = self->private_impl.f_clear_code;
+  v_end_code = self->private_impl.f_end_code;
+  v_save_code = self->private_impl.f_save_code;
+  v_prev_code = self->private_impl.f_prev_code;
+  v_width = self->private_impl.f_width;
+  v_bits = self->private_impl.f_bits;
+  v_n_bits = self->private_impl.f_n_bits;
+  v_output_wi = self->private_impl.f_output_wi;
+  while (true) {
+    if (v_n_bits < v_width) {
+      if (((uint64_t)(io2_a_src - iop_a_src)) >= 4) {
+        v_bits |= ((uint32_t)(wuffs_base__peek_u32le__no_bounds_check(iop_a_src) << v_n_bits));
+        iop_a_src += ((31 - v_n_bits) >> 3);
+        v_n_bits |= 24;
+      } else if (((uint64_t)(io2_a_src - iop_a_src)) <= 0) {
+        self->private_impl.f_read_from_return_value = 2;
+        goto label__0__break;
+      } else {
+        v_bits |= (((uint32_t)(wuffs_base__peek_u8be__no_bounds_check(iop_a_src))) << v_n_bits);
+        iop_a_src += 1;
+        v_n_bits += 8;
+        if (v_n_bits >= v_width) {
+        } else if (((uint64_t)(io2_a_src - iop_a_src)) <= 0) {
+          self->private_impl.f_read_from_return_value = 2;
+          goto label__0__break;
+        } else {
+          v_bits |= (((uint32_t)(wuffs_base__peek_u8be__no_bounds_check(iop_a_src))) << v_n_bits);
+          iop_a_src += 1;
+          v_n_bits += 8;
+          if (v_n_bits < v_width) {
+            self->private_impl.f_read_from_return_value = 4;
+            goto label__0__break;
+          }
+        }
+      }
+    }
+    v_code = ((v_bits) & WUFFS_BASE__LOW_BITS_MASK__U32(v_width));
+    v_bits >>= v_width;
+    v_n_bits -= v_width;
+    if (v_code < v_clear_code) {
+      self->private_data.f_output[v_output_wi] = ((uint8_t)(v_code));
+      v_output_wi = ((v_output_wi + 1) & 8191);
+      if (v_save_code <= 4095) {
+        v_lm1_a = (((uint16_t)(self->private_data.f_lm1s[v_prev_code] + 1)) & 4095);
+        self->private_data.f_lm1s[v_save_code] = v_lm1_a;
+        if ((v_lm1_a % 8) != 0) {
+          self->private_impl.f_prefixes[v_save_code] = self->private_impl.f_prefixes[v_prev_code];
+          memcpy(self->private_data.f_suffixes[v_save_code],self->private_data.f_suffixes[v_prev_code], sizeof(self->private_data.f_suffixes[v_save_code]));
+          self->private_data.f_suffixes[v_save_code][(v_lm1_a % 8)] = ((uint8_t)(v_code));
+        } else {
+          self->private_impl.f_prefixes[v_save_code] = ((uint16_t)(v_prev_code));
+          self->private_data.f_suffixes[v_save_code][0] = ((uint8_t)(v_code));
+        }
+        v_save_code += 1;
+        if (v_width < 12) {
+          v_width += (1 & (v_save_code >> v_width));
+        }
+        v_prev_code = v_code;
+      }
+    } else if (v_code <= v_end_code) {
+      if (v_code == v_end_code) {
+        self->private_impl.f_read_from_return_value = 0;
+        goto label__0__break;
+      }
+      v_save_code = v_end_code;
+      v_prev_code = v_end_code;
+      v_width = (self->private_impl.f_literal_width + 1);
+    } else if (v_code <= v_save_code) {
+      v_c = v_code;
+      if (v_code == v_save_code) {
+        v_c = v_prev_code;
+      }
+      v_o = ((v_output_wi + (((uint32_t)(self->private_data.f_lm1s[v_c])) & 4294967288)) & 8191);
+      v_output_wi = ((v_output_wi + 1 + ((uint32_t)(self->private_data.f_lm1s[v_c]))) & 8191);
+      v_steps = (((uint32_t)(self->private_data.f_lm1s[v_c])) >> 3);
+      while (true) {
+        memcpy((self->private_data.f_output)+(v_o), (self->private_data.f_suffixes[v_c]), 8);
+        if (v_steps <= 0) {
+          goto label__1__break;
+        }
+        v_steps -= 1;
+        v_o = (((uint32_t)(v_o - 8)) & 8191);
+        v_c = ((uint32_t)(self->private_impl.f_prefixes[v_c]));
+      }
+      label__1__break:;
+      v_first_byte = self->private_data.f_suffixes[v_c][0];
+      if (v_code == v_save_code) {
+        self->private_data.f_output[v_output_wi] = v_first_byte;
+        v_output_wi = ((v_output_wi + 1) & 8191);
+      }
+      if (v_save_code <= 4095) {
+        v_lm1_b = (((uint16_t)(self->private_data.f_lm1s[v_prev_code] + 1)) & 4095);
+        self->private_data.f_lm1s[v_save_code] = v_lm1_b;
+        if ((v_lm1_b % 8) != 0) {
+          self->private_impl.f_prefixes[v_save_code] = self->private_impl.f_prefixes[v_prev_code];
+          memcpy(self->private_data.f_suffixes[v_save_code],self->private_data.f_suffixes[v_prev_code], sizeof(self->private_data.f_suffixes[v_save_code]));
+          self->private_data.f_suffixes[v_save_code][(v_lm1_b % 8)] = v_first_byte;
+        } else {
+          self->private_impl.f_prefixes[v_save_code] = ((uint16_t)(v_prev_code));
+          self->private_data.f_suffixes[v_save_code][0] = ((uint8_t)(v_first_byte));
+        }
+        v_save_code += 1;
+        if (v_width < 12) {
+          v_width += (1 & (v_save_code >> v_width));
+        }
+        v_prev_code = v_code;
+      }
+    } else {
+      self->private_impl.f_read_from_return_value = 3;
+      goto label__0__break;
+    }
+    if (v_output_wi > 4095) {
+      self->private_impl.f_read_from_return_value = 1;
+      goto label__0__break;
+    }
+  }
+  label__0__break:;
+  if (self->private_impl.f_read_from_return_value != 2) {
+    while (v_n_bits >= 8) {
+      v_n_bits -= 8;
+      if (iop_a_src > io1_a_src) {
+        iop_a_src--;
+      } else {
+        self->private_impl.f_read_from_return_value = 4;
+        goto label__2__break;
+      }
+    }
+    label__2__break:;
+  }
+  self->private_impl.f_save_code = v_save_code;
+  self->private_impl.f_prev_code = v_prev_code;
+  self->private_impl.f_width = v_width;
+  self->private_impl.f_bits = v_bits;
+  self->private_impl.f_n_bits = v_n_bits;
+  self->private_impl.f_output_wi = v_output_wi;
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
   }
+
   return wuffs_base__make_empty_struct();
 }
 
-// -------- func gif.decoder.tell_me_more
+// -------- func lzw.decoder.read_from_fast
 
-WUFFS_BASE__MAYBE_STATIC wuffs_base__status
-wuffs_gif__decoder__tell_me_more(
-    wuffs_gif__decoder* self,
+static wuffs_base__empty_struct
+wuffs_lzw__decoder__read_from_fast(
+    wuffs_lzw__decoder* self,
     wuffs_base__io_buffer* a_dst,
-    wuffs_base__more_information* a_minfo,
     wuffs_base__io_buffer* a_src) {
-  if (!self) {
-    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
-  }
-  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
-    return wuffs_base__make_status(
-        (self->private_impl.magic == WUFFS_BASE__DISABLED)
-        ? wuffs_base__error__disabled_by_previous_error
-        : wuffs_base__error__initialize_not_called);
-  }
-  if (!a_dst || !a_src) {
-    self->private_impl.magic = WUFFS_BASE__DISABLED;
-    return wuffs_base__make_status(wuffs_base__error__bad_argument);
-  }
-  if ((self->private_impl.active_coroutine != 0) &&
-      (self->private_impl.active_coroutine != 2)) {
-    self->private_impl.magic = WUFFS_BASE__DISABLED;
-    return wuffs_base__make_status(wuffs_base__error__interleaved_coroutine_calls);
-  }
-  self->private_impl.active_coroutine = 0;
-  wuffs_base__status status = wuffs_base__make_status(NULL);
-
-  uint64_t v_chunk_length = 0;
+  uint32_t v_clear_code = 0;
+  uint32_t v_end_code = 0;
+  uint32_t v_save_code = 0;
+  uint32_t v_prev_code = 0;
+  uint32_t v_width = 0;
+  uint64_t v_bits = 0;
+  uint32_t v_n_bits = 0;
+  uint32_t v_code = 0;
+  uint32_t v_c = 0;
+  uint32_t v_o = 0;
+  uint32_t v_n = 0;
+  uint32_t v_steps = 0;
+  uint8_t v_first_byte = 0;
+  uint16_t v_lm1 = 0;
 
+  uint8_t* iop_a_dst = NULL;
+  uint8_t* io0_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io1_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io2_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_dst) {
+    io0_a_dst = a_dst->data.ptr;
+    io1_a_dst = io0_a_dst + a_dst->meta.wi;
+    iop_a_dst = io1_a_dst;
+    io2_a_dst = io0_a_dst + a_dst->data.len;
+    if (a_dst->meta.closed) {
+      io2_a_dst = iop_a_dst;
+    }
+  }
   const uint8_t* iop_a_src = NULL;
   const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
   const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
@@ -28627,232 +35250,494 @@ wuffs_gif__decoder__tell_me_more(
     io2_a_src = io0_a_src + a_src->meta.wi;
   }
 
-  uint32_t coro_susp_point = self->private_impl.p_tell_me_more[0];
-  switch (coro_susp_point) {
-    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
-
-    if (self->private_impl.f_call_sequence != 1) {
-      status = wuffs_base__make_status(wuffs_base__error__bad_call_sequence);
-      goto exit;
-    }
-    if (self->private_impl.f_metadata_fourcc == 0) {
-      status = wuffs_base__make_status(wuffs_base__error__no_more_information);
-      goto exit;
+  v_clear_code = self->private_impl.f_clear_code;
+  v_end_code = self->private_impl.f_end_code;
+  v_save_code = self->private_impl.f_save_code;
+  v_prev_code = self->private_impl.f_prev_code;
+  v_width = self->private_impl.f_width;
+  v_bits = ((uint64_t)(self->private_impl.f_bits));
+  v_n_bits = self->private_impl.f_n_bits;
+  self->private_impl.f_read_from_return_value = 1;
+  label__0__continue:;
+  while ((((uint64_t)(io2_a_dst - iop_a_dst)) >= 4105) && (((uint64_t)(io2_a_src - iop_a_src)) >= 8)) {
+    if (v_n_bits < v_width) {
+      v_bits |= ((uint64_t)(wuffs_base__peek_u64le__no_bounds_check(iop_a_src) << (v_n_bits & 63)));
+      iop_a_src += ((63 - (v_n_bits & 63)) >> 3);
+      v_n_bits |= 56;
     }
-    while (true) {
-      label__0__continue:;
-      while (true) {
-        if (wuffs_base__u64__sat_add(a_src->meta.pos, ((uint64_t)(iop_a_src - io0_a_src))) != self->private_impl.f_metadata_io_position) {
-          if (a_minfo != NULL) {
-            wuffs_base__more_information__set(a_minfo,
-                2,
-                0,
-                self->private_impl.f_metadata_io_position,
-                0,
-                0);
-          }
-          status = wuffs_base__make_status(wuffs_base__suspension__mispositioned_read);
-          WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(1);
-          goto label__0__continue;
+    v_code = ((uint32_t)((((v_bits) & WUFFS_BASE__LOW_BITS_MASK__U64(v_width)) & 4095)));
+    v_bits >>= v_width;
+    v_n_bits -= v_width;
+    if (((uint32_t)(v_code - v_clear_code)) <= 1) {
+      if (v_code == v_end_code) {
+        self->private_impl.f_read_from_return_value = 0;
+        goto label__0__break;
+      }
+      v_save_code = v_end_code;
+      v_prev_code = v_end_code;
+      v_width = (self->private_impl.f_literal_width + 1);
+      goto label__0__continue;
+    } else if (v_code <= v_save_code) {
+      v_c = v_code;
+      if (v_code == v_save_code) {
+        v_c = v_prev_code;
+      }
+      v_n = ((((uint32_t)(self->private_data.f_lm1s[v_c])) & 4095) + 1);
+      if (v_n <= 8) {
+        wuffs_base__io_writer__limited_write_u64le_fast(
+            &iop_a_dst, io2_a_dst,v_n, wuffs_base__peek_u64le__no_bounds_check(wuffs_base__make_slice_u8(self->private_data.f_suffixes[v_c], 8).ptr));
+        v_first_byte = self->private_data.f_suffixes[v_c][0];
+        if (v_code == v_save_code) {
+          (wuffs_base__poke_u8be__no_bounds_check(iop_a_dst, v_first_byte), iop_a_dst += 1);
         }
-        if (((uint64_t)(io2_a_src - iop_a_src)) <= 0) {
-          if (a_minfo != NULL) {
-            wuffs_base__more_information__set(a_minfo,
-                0,
-                0,
-                0,
-                0,
-                0);
+      } else {
+        v_o = (((uint32_t)(self->private_data.f_lm1s[v_c])) & 4088);
+        v_steps = (((uint32_t)(self->private_data.f_lm1s[v_c])) >> 3);
+        while (true) {
+          memcpy((self->private_data.f_output)+(v_o), (self->private_data.f_suffixes[v_c]), 8);
+          if (v_steps <= 0) {
+            goto label__1__break;
           }
-          status = wuffs_base__make_status(wuffs_base__suspension__short_read);
-          WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(2);
-          goto label__0__continue;
+          v_steps -= 1;
+          v_o = (((uint32_t)(v_o - 8)) & 8191);
+          v_c = ((uint32_t)(self->private_impl.f_prefixes[v_c]));
+        }
+        label__1__break:;
+        v_first_byte = self->private_data.f_suffixes[v_c][0];
+        if (v_code == v_save_code) {
+          self->private_data.f_output[v_n] = v_first_byte;
+          wuffs_base__io_writer__copy_from_slice(&iop_a_dst, io2_a_dst,wuffs_base__slice_u8__subslice_j(wuffs_base__make_slice_u8(self->private_data.f_output, 8199), (v_n + 1)));
+        } else {
+          wuffs_base__io_writer__copy_from_slice(&iop_a_dst, io2_a_dst,wuffs_base__slice_u8__subslice_j(wuffs_base__make_slice_u8(self->private_data.f_output, 8199), v_n));
         }
-        goto label__0__break;
-      }
-      label__0__break:;
-      v_chunk_length = ((uint64_t)(wuffs_base__peek_u8be__no_bounds_check(iop_a_src)));
-      if (v_chunk_length <= 0) {
-        iop_a_src += 1;
-        goto label__1__break;
       }
-      if (self->private_impl.f_metadata_fourcc == 1481461792) {
-        v_chunk_length += 1;
+    } else {
+      self->private_impl.f_read_from_return_value = 3;
+      goto label__0__break;
+    }
+    if (v_save_code <= 4095) {
+      v_lm1 = (((uint16_t)(self->private_data.f_lm1s[v_prev_code] + 1)) & 4095);
+      self->private_data.f_lm1s[v_save_code] = v_lm1;
+      if ((v_lm1 % 8) != 0) {
+        self->private_impl.f_prefixes[v_save_code] = self->private_impl.f_prefixes[v_prev_code];
+        memcpy(self->private_data.f_suffixes[v_save_code],self->private_data.f_suffixes[v_prev_code], sizeof(self->private_data.f_suffixes[v_save_code]));
+        self->private_data.f_suffixes[v_save_code][(v_lm1 % 8)] = v_first_byte;
       } else {
-        iop_a_src += 1;
+        self->private_impl.f_prefixes[v_save_code] = ((uint16_t)(v_prev_code));
+        self->private_data.f_suffixes[v_save_code][0] = v_first_byte;
       }
-      self->private_impl.f_metadata_io_position = wuffs_base__u64__sat_add(wuffs_base__u64__sat_add(a_src->meta.pos, ((uint64_t)(iop_a_src - io0_a_src))), v_chunk_length);
-      if (a_minfo != NULL) {
-        wuffs_base__more_information__set(a_minfo,
-            3,
-            self->private_impl.f_metadata_fourcc,
-            0,
-            wuffs_base__u64__sat_add(a_src->meta.pos, ((uint64_t)(iop_a_src - io0_a_src))),
-            self->private_impl.f_metadata_io_position);
+      v_save_code += 1;
+      if (v_width < 12) {
+        v_width += (1 & (v_save_code >> v_width));
       }
-      status = wuffs_base__make_status(wuffs_base__suspension__even_more_information);
-      WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(3);
+      v_prev_code = v_code;
     }
-    label__1__break:;
-    if (a_minfo != NULL) {
-      wuffs_base__more_information__set(a_minfo,
-          3,
-          self->private_impl.f_metadata_fourcc,
-          0,
-          self->private_impl.f_metadata_io_position,
-          self->private_impl.f_metadata_io_position);
+  }
+  label__0__break:;
+  while (v_n_bits >= 8) {
+    v_n_bits -= 8;
+    if (iop_a_src > io1_a_src) {
+      iop_a_src--;
+    } else {
+      self->private_impl.f_read_from_return_value = 4;
+      v_n_bits = 0;
+    }
+  }
+  self->private_impl.f_save_code = v_save_code;
+  self->private_impl.f_prev_code = v_prev_code;
+  self->private_impl.f_width = v_width;
+  self->private_impl.f_bits = ((uint32_t)((v_bits & ((((uint64_t)(1)) << v_n_bits) - 1))));
+  self->private_impl.f_n_bits = v_n_bits;
+  if (a_dst) {
+    a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+  }
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  }
+
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func lzw.decoder.write_to
+
+static wuffs_base__status
+wuffs_lzw__decoder__write_to(
+    wuffs_lzw__decoder* self,
+    wuffs_base__io_buffer* a_dst) {
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  wuffs_base__slice_u8 v_s = {0};
+  uint64_t v_n = 0;
+
+  uint8_t* iop_a_dst = NULL;
+  uint8_t* io0_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io1_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io2_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_dst) {
+    io0_a_dst = a_dst->data.ptr;
+    io1_a_dst = io0_a_dst + a_dst->meta.wi;
+    iop_a_dst = io1_a_dst;
+    io2_a_dst = io0_a_dst + a_dst->data.len;
+    if (a_dst->meta.closed) {
+      io2_a_dst = iop_a_dst;
+    }
+  }
+
+  uint32_t coro_susp_point = self->private_impl.p_write_to[0];
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    while (self->private_impl.f_output_wi > 0) {
+      if (self->private_impl.f_output_ri > self->private_impl.f_output_wi) {
+        status = wuffs_base__make_status(wuffs_lzw__error__internal_error_inconsistent_i_o);
+        goto exit;
+      }
+      v_s = wuffs_base__slice_u8__subslice_ij(wuffs_base__make_slice_u8(self->private_data.f_output,
+          8199),
+          self->private_impl.f_output_ri,
+          self->private_impl.f_output_wi);
+      v_n = wuffs_base__io_writer__copy_from_slice(&iop_a_dst, io2_a_dst,v_s);
+      if (v_n == ((uint64_t)(v_s.len))) {
+        self->private_impl.f_output_ri = 0;
+        self->private_impl.f_output_wi = 0;
+        status = wuffs_base__make_status(NULL);
+        goto ok;
+      }
+      self->private_impl.f_output_ri = (((uint32_t)(self->private_impl.f_output_ri + ((uint32_t)((v_n & 4294967295))))) & 8191);
+      status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(1);
     }
-    self->private_impl.f_call_sequence = 2;
-    self->private_impl.f_metadata_fourcc = 0;
-    self->private_impl.f_metadata_io_position = 0;
-    status = wuffs_base__make_status(NULL);
-    goto ok;
 
     ok:
-    self->private_impl.p_tell_me_more[0] = 0;
+    self->private_impl.p_write_to[0] = 0;
     goto exit;
   }
 
   goto suspend;
   suspend:
-  self->private_impl.p_tell_me_more[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
-  self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 2 : 0;
+  self->private_impl.p_write_to[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
 
   goto exit;
   exit:
-  if (a_src) {
-    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  if (a_dst) {
+    a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
   }
 
-  if (wuffs_base__status__is_error(&status)) {
-    self->private_impl.magic = WUFFS_BASE__DISABLED;
-  }
   return status;
 }
 
-// -------- func gif.decoder.num_animation_loops
+// -------- func lzw.decoder.flush
 
-WUFFS_BASE__MAYBE_STATIC uint32_t
-wuffs_gif__decoder__num_animation_loops(
-    const wuffs_gif__decoder* self) {
+WUFFS_BASE__MAYBE_STATIC wuffs_base__slice_u8
+wuffs_lzw__decoder__flush(
+    wuffs_lzw__decoder* self) {
   if (!self) {
-    return 0;
+    return wuffs_base__make_slice_u8(NULL, 0);
   }
-  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
-      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
-    return 0;
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_slice_u8(NULL, 0);
   }
 
-  if (self->private_impl.f_seen_num_loops) {
-    return self->private_impl.f_num_loops;
+  wuffs_base__slice_u8 v_s = {0};
+
+  if (self->private_impl.f_output_ri <= self->private_impl.f_output_wi) {
+    v_s = wuffs_base__slice_u8__subslice_ij(wuffs_base__make_slice_u8(self->private_data.f_output,
+        8199),
+        self->private_impl.f_output_ri,
+        self->private_impl.f_output_wi);
   }
-  return 1;
+  self->private_impl.f_output_ri = 0;
+  self->private_impl.f_output_wi = 0;
+  return v_s;
 }
 
-// -------- func gif.decoder.num_decoded_frame_configs
+#endif  // !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__LZW)
 
-WUFFS_BASE__MAYBE_STATIC uint64_t
-wuffs_gif__decoder__num_decoded_frame_configs(
-    const wuffs_gif__decoder* self) {
-  if (!self) {
-    return 0;
-  }
-  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
-      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
-    return 0;
-  }
+#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__GIF)
 
-  return self->private_impl.f_num_decoded_frame_configs_value;
-}
+// ---------------- Status Codes Implementations
 
-// -------- func gif.decoder.num_decoded_frames
+const char wuffs_gif__error__bad_extension_label[] = "#gif: bad extension label";
+const char wuffs_gif__error__bad_frame_size[] = "#gif: bad frame size";
+const char wuffs_gif__error__bad_graphic_control[] = "#gif: bad graphic control";
+const char wuffs_gif__error__bad_header[] = "#gif: bad header";
+const char wuffs_gif__error__bad_literal_width[] = "#gif: bad literal width";
+const char wuffs_gif__error__bad_palette[] = "#gif: bad palette";
+const char wuffs_gif__error__internal_error_inconsistent_ri_wi[] = "#gif: internal error: inconsistent ri/wi";
 
-WUFFS_BASE__MAYBE_STATIC uint64_t
-wuffs_gif__decoder__num_decoded_frames(
-    const wuffs_gif__decoder* self) {
-  if (!self) {
-    return 0;
-  }
-  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
-      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
-    return 0;
-  }
+// ---------------- Private Consts
 
-  return self->private_impl.f_num_decoded_frames_value;
-}
+static const uint32_t
+WUFFS_GIF__INTERLACE_START[5] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  4294967295, 1, 2, 4, 0,
+};
 
-// -------- func gif.decoder.frame_dirty_rect
+static const uint8_t
+WUFFS_GIF__INTERLACE_DELTA[5] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  1, 2, 4, 8, 8,
+};
 
-WUFFS_BASE__MAYBE_STATIC wuffs_base__rect_ie_u32
-wuffs_gif__decoder__frame_dirty_rect(
-    const wuffs_gif__decoder* self) {
+static const uint8_t
+WUFFS_GIF__INTERLACE_COUNT[5] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  0, 1, 2, 4, 8,
+};
+
+static const uint8_t
+WUFFS_GIF__ANIMEXTS1DOT0[11] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  65, 78, 73, 77, 69, 88, 84, 83,
+  49, 46, 48,
+};
+
+static const uint8_t
+WUFFS_GIF__NETSCAPE2DOT0[11] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  78, 69, 84, 83, 67, 65, 80, 69,
+  50, 46, 48,
+};
+
+static const uint8_t
+WUFFS_GIF__ICCRGBG1012[11] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  73, 67, 67, 82, 71, 66, 71, 49,
+  48, 49, 50,
+};
+
+static const uint8_t
+WUFFS_GIF__XMPDATAXMP[11] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  88, 77, 80, 32, 68, 97, 116, 97,
+  88, 77, 80,
+};
+
+#define WUFFS_GIF__QUIRKS_BASE 1041635328
+
+#define WUFFS_GIF__QUIRKS_COUNT 7
+
+// ---------------- Private Initializer Prototypes
+
+// ---------------- Private Function Prototypes
+
+static wuffs_base__status
+wuffs_gif__decoder__skip_frame(
+    wuffs_gif__decoder* self,
+    wuffs_base__io_buffer* a_src);
+
+static wuffs_base__empty_struct
+wuffs_gif__decoder__reset_gc(
+    wuffs_gif__decoder* self);
+
+static wuffs_base__status
+wuffs_gif__decoder__decode_up_to_id_part1(
+    wuffs_gif__decoder* self,
+    wuffs_base__io_buffer* a_src);
+
+static wuffs_base__status
+wuffs_gif__decoder__decode_header(
+    wuffs_gif__decoder* self,
+    wuffs_base__io_buffer* a_src);
+
+static wuffs_base__status
+wuffs_gif__decoder__decode_lsd(
+    wuffs_gif__decoder* self,
+    wuffs_base__io_buffer* a_src);
+
+static wuffs_base__status
+wuffs_gif__decoder__decode_extension(
+    wuffs_gif__decoder* self,
+    wuffs_base__io_buffer* a_src);
+
+static wuffs_base__status
+wuffs_gif__decoder__skip_blocks(
+    wuffs_gif__decoder* self,
+    wuffs_base__io_buffer* a_src);
+
+static wuffs_base__status
+wuffs_gif__decoder__decode_ae(
+    wuffs_gif__decoder* self,
+    wuffs_base__io_buffer* a_src);
+
+static wuffs_base__status
+wuffs_gif__decoder__decode_gc(
+    wuffs_gif__decoder* self,
+    wuffs_base__io_buffer* a_src);
+
+static wuffs_base__status
+wuffs_gif__decoder__decode_id_part0(
+    wuffs_gif__decoder* self,
+    wuffs_base__io_buffer* a_src);
+
+static wuffs_base__status
+wuffs_gif__decoder__decode_id_part1(
+    wuffs_gif__decoder* self,
+    wuffs_base__pixel_buffer* a_dst,
+    wuffs_base__io_buffer* a_src,
+    wuffs_base__pixel_blend a_blend);
+
+static wuffs_base__status
+wuffs_gif__decoder__decode_id_part2(
+    wuffs_gif__decoder* self,
+    wuffs_base__pixel_buffer* a_dst,
+    wuffs_base__io_buffer* a_src,
+    wuffs_base__slice_u8 a_workbuf);
+
+static bool
+wuffs_gif__decoder__is_past_roi(
+    const wuffs_gif__decoder* self);
+
+static wuffs_base__status
+wuffs_gif__decoder__copy_to_image_buffer(
+    wuffs_gif__decoder* self,
+    wuffs_base__pixel_buffer* a_pb,
+    wuffs_base__slice_u8 a_src,
+    wuffs_base__slice_u8 a_workbuf);
+
+static wuffs_base__empty_struct
+wuffs_gif__decoder__downscale_row(
+    wuffs_gif__decoder* self,
+    wuffs_base__pixel_buffer* a_pb,
+    wuffs_base__slice_u8 a_row,
+    wuffs_base__slice_u8 a_accum);
+
+// ---------------- VTables
+
+const wuffs_base__image_decoder__func_ptrs
+wuffs_gif__decoder__func_ptrs_for__wuffs_base__image_decoder = {
+  (wuffs_base__status(*)(void*,
+      wuffs_base__pixel_buffer*,
+      wuffs_base__io_buffer*,
+      wuffs_base__pixel_blend,
+      wuffs_base__slice_u8,
+      wuffs_base__decode_frame_options*))(&wuffs_gif__decoder__decode_frame),
+  (wuffs_base__status(*)(void*,
+      wuffs_base__frame_config*,
+      wuffs_base__io_buffer*))(&wuffs_gif__decoder__decode_frame_config),
+  (wuffs_base__status(*)(void*,
+      wuffs_base__image_config*,
+      wuffs_base__io_buffer*))(&wuffs_gif__decoder__decode_image_config),
+  (wuffs_base__rect_ie_u32(*)(const void*))(&wuffs_gif__decoder__frame_dirty_rect),
+  (uint32_t(*)(const void*))(&wuffs_gif__decoder__num_animation_loops),
+  (uint64_t(*)(const void*))(&wuffs_gif__decoder__num_decoded_frame_configs),
+  (uint64_t(*)(const void*))(&wuffs_gif__decoder__num_decoded_frames),
+  (wuffs_base__status(*)(void*,
+      uint64_t,
+      uint64_t))(&wuffs_gif__decoder__restart_frame),
+  (wuffs_base__empty_struct(*)(void*,
+      uint32_t,
+      bool))(&wuffs_gif__decoder__set_quirk_enabled),
+  (wuffs_base__empty_struct(*)(void*,
+      uint32_t,
+      bool))(&wuffs_gif__decoder__set_report_metadata),
+  (wuffs_base__status(*)(void*,
+      wuffs_base__io_buffer*,
+      wuffs_base__more_information*,
+      wuffs_base__io_buffer*))(&wuffs_gif__decoder__tell_me_more),
+  (wuffs_base__range_ii_u64(*)(const void*))(&wuffs_gif__decoder__workbuf_len),
+};
+
+// ---------------- Initializer Implementations
+
+wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
+wuffs_gif__decoder__initialize(
+    wuffs_gif__decoder* self,
+    size_t sizeof_star_self,
+    uint64_t wuffs_version,
+    uint32_t options){
   if (!self) {
-    return wuffs_base__utility__empty_rect_ie_u32();
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
   }
-  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
-      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
-    return wuffs_base__utility__empty_rect_ie_u32();
+  if (sizeof(*self) != sizeof_star_self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_sizeof_receiver);
+  }
+  if (((wuffs_version >> 32) != WUFFS_VERSION_MAJOR) ||
+      (((wuffs_version >> 16) & 0xFFFF) > WUFFS_VERSION_MINOR)) {
+    return wuffs_base__make_status(wuffs_base__error__bad_wuffs_version);
   }
 
-  return wuffs_base__utility__make_rect_ie_u32(
-      wuffs_base__u32__min(self->private_impl.f_frame_rect_x0, self->private_impl.f_width),
-      wuffs_base__u32__min(self->private_impl.f_frame_rect_y0, self->private_impl.f_height),
-      wuffs_base__u32__min(self->private_impl.f_frame_rect_x1, self->private_impl.f_width),
-      wuffs_base__u32__min(self->private_impl.f_dirty_max_excl_y, self->private_impl.f_height));
-}
+  if ((options & WUFFS_INITIALIZE__ALREADY_ZEROED) != 0) {
+    // The whole point of this if-check is to detect an uninitialized *self.
+    // We disable the warning on GCC. Clang-5.0 does not have this warning.
+#if !defined(__clang__) && defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+    if (self->private_impl.magic != 0) {
+      return wuffs_base__make_status(wuffs_base__error__initialize_falsely_claimed_already_zeroed);
+    }
+#if !defined(__clang__) && defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+  } else {
+    if ((options & WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED) == 0) {
+      memset(self, 0, sizeof(*self));
+      options |= WUFFS_INITIALIZE__ALREADY_ZEROED;
+    } else {
+      memset(&(self->private_impl), 0, sizeof(self->private_impl));
+    }
+  }
 
-// -------- func gif.decoder.workbuf_len
+  {
+    wuffs_base__status z = wuffs_lzw__decoder__initialize(
+        &self->private_data.f_lzw, sizeof(self->private_data.f_lzw), WUFFS_VERSION, options);
+    if (z.repr) {
+      return z;
+    }
+  }
+  self->private_impl.magic = WUFFS_BASE__MAGIC;
+  self->private_impl.vtable_for__wuffs_base__image_decoder.vtable_name =
+      wuffs_base__image_decoder__vtable_name;
+  self->private_impl.vtable_for__wuffs_base__image_decoder.function_pointers =
+      (const void*)(&wuffs_gif__decoder__func_ptrs_for__wuffs_base__image_decoder);
+  return wuffs_base__make_status(NULL);
+}
 
-WUFFS_BASE__MAYBE_STATIC wuffs_base__range_ii_u64
-wuffs_gif__decoder__workbuf_len(
-    const wuffs_gif__decoder* self) {
-  if (!self) {
-    return wuffs_base__utility__empty_range_ii_u64();
+wuffs_gif__decoder*
+wuffs_gif__decoder__alloc() {
+  wuffs_gif__decoder* x =
+      (wuffs_gif__decoder*)(calloc(sizeof(wuffs_gif__decoder), 1));
+  if (!x) {
+    return NULL;
   }
-  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
-      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
-    return wuffs_base__utility__empty_range_ii_u64();
+  if (wuffs_gif__decoder__initialize(
+      x, sizeof(wuffs_gif__decoder), WUFFS_VERSION, WUFFS_INITIALIZE__ALREADY_ZEROED).repr) {
+    free(x);
+    return NULL;
   }
+  return x;
+}
 
-  return wuffs_base__utility__make_range_ii_u64(0, 0);
+size_t
+sizeof__wuffs_gif__decoder() {
+  return sizeof(wuffs_gif__decoder);
 }
 
-// -------- func gif.decoder.restart_frame
+// ---------------- Function Implementations
 
-WUFFS_BASE__MAYBE_STATIC wuffs_base__status
-wuffs_gif__decoder__restart_frame(
+// -------- func gif.decoder.set_quirk_enabled
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_gif__decoder__set_quirk_enabled(
     wuffs_gif__decoder* self,
-    uint64_t a_index,
-    uint64_t a_io_position) {
+    uint32_t a_quirk,
+    bool a_enabled) {
   if (!self) {
-    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+    return wuffs_base__make_empty_struct();
   }
   if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
-    return wuffs_base__make_status(
-        (self->private_impl.magic == WUFFS_BASE__DISABLED)
-        ? wuffs_base__error__disabled_by_previous_error
-        : wuffs_base__error__initialize_not_called);
+    return wuffs_base__make_empty_struct();
   }
 
-  if (self->private_impl.f_call_sequence < 3) {
-    return wuffs_base__make_status(wuffs_base__error__bad_call_sequence);
+  if ((self->private_impl.f_call_sequence == 0) && (a_quirk >= 1041635328)) {
+    a_quirk -= 1041635328;
+    if (a_quirk < 7) {
+      self->private_impl.f_quirks[a_quirk] = a_enabled;
+    }
   }
-  self->private_impl.f_delayed_num_decoded_frames = false;
-  self->private_impl.f_end_of_data = false;
-  self->private_impl.f_restarted = true;
-  self->private_impl.f_frame_config_io_position = a_io_position;
-  self->private_impl.f_num_decoded_frame_configs_value = a_index;
-  self->private_impl.f_num_decoded_frames_value = a_index;
-  wuffs_gif__decoder__reset_gc(self);
-  return wuffs_base__make_status(NULL);
+  return wuffs_base__make_empty_struct();
 }
 
-// -------- func gif.decoder.decode_frame_config
+// -------- func gif.decoder.decode_image_config
 
 WUFFS_BASE__MAYBE_STATIC wuffs_base__status
-wuffs_gif__decoder__decode_frame_config(
+wuffs_gif__decoder__decode_image_config(
     wuffs_gif__decoder* self,
-    wuffs_base__frame_config* a_dst,
+    wuffs_base__image_config* a_dst,
     wuffs_base__io_buffer* a_src) {
   if (!self) {
     return wuffs_base__make_status(wuffs_base__error__bad_receiver);
@@ -28868,149 +35753,552 @@ wuffs_gif__decoder__decode_frame_config(
     return wuffs_base__make_status(wuffs_base__error__bad_argument);
   }
   if ((self->private_impl.active_coroutine != 0) &&
-      (self->private_impl.active_coroutine != 3)) {
+      (self->private_impl.active_coroutine != 1)) {
     self->private_impl.magic = WUFFS_BASE__DISABLED;
     return wuffs_base__make_status(wuffs_base__error__interleaved_coroutine_calls);
   }
   self->private_impl.active_coroutine = 0;
   wuffs_base__status status = wuffs_base__make_status(NULL);
 
-  uint32_t v_background_color = 0;
-  uint8_t v_flags = 0;
-
-  const uint8_t* iop_a_src = NULL;
-  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
-  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
-  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
-  if (a_src) {
-    io0_a_src = a_src->data.ptr;
-    io1_a_src = io0_a_src + a_src->meta.ri;
-    iop_a_src = io1_a_src;
-    io2_a_src = io0_a_src + a_src->meta.wi;
-  }
+  bool v_ffio = false;
 
-  uint32_t coro_susp_point = self->private_impl.p_decode_frame_config[0];
-  if (coro_susp_point) {
-    v_background_color = self->private_data.s_decode_frame_config[0].v_background_color;
-  }
+  uint32_t coro_susp_point = self->private_impl.p_decode_image_config[0];
   switch (coro_susp_point) {
     WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
 
-    self->private_impl.f_ignore_metadata = true;
-    self->private_impl.f_dirty_max_excl_y = 0;
-    if ( ! self->private_impl.f_end_of_data) {
-      if (self->private_impl.f_call_sequence == 0) {
-        if (a_src) {
-          a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
-        }
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
-        status = wuffs_gif__decoder__decode_image_config(self, NULL, a_src);
-        if (a_src) {
-          iop_a_src = a_src->data.ptr + a_src->meta.ri;
-        }
-        if (status.repr) {
-          goto suspend;
-        }
-      } else if (self->private_impl.f_call_sequence != 3) {
-        if (self->private_impl.f_call_sequence == 4) {
-          if (a_src) {
-            a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
-          }
-          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
-          status = wuffs_gif__decoder__skip_frame(self, a_src);
-          if (a_src) {
-            iop_a_src = a_src->data.ptr + a_src->meta.ri;
-          }
-          if (status.repr) {
-            goto suspend;
-          }
-        }
-        if (a_src) {
-          a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
-        }
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
-        status = wuffs_gif__decoder__decode_up_to_id_part1(self, a_src);
-        if (a_src) {
-          iop_a_src = a_src->data.ptr + a_src->meta.ri;
-        }
-        if (status.repr) {
-          goto suspend;
-        }
+    if (self->private_impl.f_call_sequence == 0) {
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+      status = wuffs_gif__decoder__decode_header(self, a_src);
+      if (status.repr) {
+        goto suspend;
+      }
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+      status = wuffs_gif__decoder__decode_lsd(self, a_src);
+      if (status.repr) {
+        goto suspend;
       }
+    } else if (self->private_impl.f_call_sequence != 2) {
+      status = wuffs_base__make_status(wuffs_base__error__bad_call_sequence);
+      goto exit;
     }
-    if (self->private_impl.f_end_of_data) {
-      status = wuffs_base__make_status(wuffs_base__note__end_of_data);
-      goto ok;
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+    status = wuffs_gif__decoder__decode_up_to_id_part1(self, a_src);
+    if (status.repr) {
+      goto suspend;
     }
-    v_background_color = self->private_impl.f_black_color_u32_argb_premul;
-    if ( ! self->private_impl.f_gc_has_transparent_index) {
-      v_background_color = self->private_impl.f_background_color_u32_argb_premul;
-      if (self->private_impl.f_quirks[1] && (self->private_impl.f_num_decoded_frame_configs_value == 0)) {
-        while (((uint64_t)(io2_a_src - iop_a_src)) <= 0) {
-          status = wuffs_base__make_status(wuffs_base__suspension__short_read);
-          WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(4);
-        }
-        v_flags = wuffs_base__peek_u8be__no_bounds_check(iop_a_src);
-        if ((v_flags & 128) != 0) {
-          v_background_color = self->private_impl.f_black_color_u32_argb_premul;
-        }
-      }
+    v_ffio =  ! self->private_impl.f_gc_has_transparent_index;
+    if ( ! self->private_impl.f_quirks[2]) {
+      v_ffio = (v_ffio &&
+          (self->private_impl.f_frame_rect_x0 == 0) &&
+          (self->private_impl.f_frame_rect_y0 == 0) &&
+          (self->private_impl.f_frame_rect_x1 == self->private_impl.f_width) &&
+          (self->private_impl.f_frame_rect_y1 == self->private_impl.f_height));
+    } else if (v_ffio) {
+      self->private_impl.f_black_color_u32_argb_premul = 4278190080;
+    }
+    if (self->private_impl.f_background_color_u32_argb_premul == 77) {
+      self->private_impl.f_background_color_u32_argb_premul = self->private_impl.f_black_color_u32_argb_premul;
     }
     if (a_dst != NULL) {
-      wuffs_base__frame_config__set(
+      wuffs_base__image_config__set(
           a_dst,
-          wuffs_base__utility__make_rect_ie_u32(
-          wuffs_base__u32__min(self->private_impl.f_frame_rect_x0, self->private_impl.f_width),
-          wuffs_base__u32__min(self->private_impl.f_frame_rect_y0, self->private_impl.f_height),
-          wuffs_base__u32__min(self->private_impl.f_frame_rect_x1, self->private_impl.f_width),
-          wuffs_base__u32__min(self->private_impl.f_frame_rect_y1, self->private_impl.f_height)),
-          ((wuffs_base__flicks)(self->private_impl.f_gc_duration)),
-          self->private_impl.f_num_decoded_frame_configs_value,
+          2198077448,
+          0,
+          self->private_impl.f_width,
+          self->private_impl.f_height,
           self->private_impl.f_frame_config_io_position,
-          self->private_impl.f_gc_disposal,
-          ! self->private_impl.f_gc_has_transparent_index,
-          false,
-          v_background_color);
+          v_ffio);
     }
-    wuffs_base__u64__sat_add_indirect(&self->private_impl.f_num_decoded_frame_configs_value, 1);
-    self->private_impl.f_call_sequence = 4;
+    self->private_impl.f_call_sequence = 3;
 
+    goto ok;
     ok:
-    self->private_impl.p_decode_frame_config[0] = 0;
+    self->private_impl.p_decode_image_config[0] = 0;
     goto exit;
   }
 
   goto suspend;
   suspend:
-  self->private_impl.p_decode_frame_config[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
-  self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 3 : 0;
-  self->private_data.s_decode_frame_config[0].v_background_color = v_background_color;
+  self->private_impl.p_decode_image_config[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+  self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 1 : 0;
 
   goto exit;
   exit:
-  if (a_src) {
-    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
-  }
-
   if (wuffs_base__status__is_error(&status)) {
     self->private_impl.magic = WUFFS_BASE__DISABLED;
   }
   return status;
 }
 
-// -------- func gif.decoder.skip_frame
+// -------- func gif.decoder.set_report_metadata
 
-static wuffs_base__status
-wuffs_gif__decoder__skip_frame(
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_gif__decoder__set_report_metadata(
     wuffs_gif__decoder* self,
-    wuffs_base__io_buffer* a_src) {
-  wuffs_base__status status = wuffs_base__make_status(NULL);
+    uint32_t a_fourcc,
+    bool a_report) {
+  if (!self) {
+    return wuffs_base__make_empty_struct();
+  }
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_empty_struct();
+  }
 
-  uint8_t v_flags = 0;
-  uint8_t v_lw = 0;
+  if (a_fourcc == 1229144912) {
+    self->private_impl.f_report_metadata_iccp = a_report;
+  } else if (a_fourcc == 1481461792) {
+    self->private_impl.f_report_metadata_xmp = a_report;
+  }
+  return wuffs_base__make_empty_struct();
+}
 
-  const uint8_t* iop_a_src = NULL;
-  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+// -------- func gif.decoder.tell_me_more
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_gif__decoder__tell_me_more(
+    wuffs_gif__decoder* self,
+    wuffs_base__io_buffer* a_dst,
+    wuffs_base__more_information* a_minfo,
+    wuffs_base__io_buffer* a_src) {
+  if (!self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+  }
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_status(
+        (self->private_impl.magic == WUFFS_BASE__DISABLED)
+        ? wuffs_base__error__disabled_by_previous_error
+        : wuffs_base__error__initialize_not_called);
+  }
+  if (!a_dst || !a_src) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+    return wuffs_base__make_status(wuffs_base__error__bad_argument);
+  }
+  if ((self->private_impl.active_coroutine != 0) &&
+      (self->private_impl.active_coroutine != 2)) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+    return wuffs_base__make_status(wuffs_base__error__interleaved_coroutine_calls);
+  }
+  self->private_impl.active_coroutine = 0;
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  uint64_t v_chunk_length = 0;
+
+  const uint8_t* iop_a_src = NULL;
+  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_src) {
+    io0_a_src = a_src->data.ptr;
+    io1_a_src = io0_a_src + a_src->meta.ri;
+    iop_a_src = io1_a_src;
+    io2_a_src = io0_a_src + a_src->meta.wi;
+  }
+
+  uint32_t coro_susp_point = self->private_impl.p_tell_me_more[0];
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    if (self->private_impl.f_call_sequence != 1) {
+      status = wuffs_base__make_status(wuffs_base__error__bad_call_sequence);
+      goto exit;
+    }
+    if (self->private_impl.f_metadata_fourcc == 0) {
+      status = wuffs_base__make_status(wuffs_base__error__no_more_information);
+      goto exit;
+    }
+    while (true) {
+      label__0__continue:;
+      while (true) {
+        if (wuffs_base__u64__sat_add(a_src->meta.pos, ((uint64_t)(iop_a_src - io0_a_src))) != self->private_impl.f_metadata_io_position) {
+          if (a_minfo != NULL) {
+            wuffs_base__more_information__set(a_minfo,
+                2,
+                0,
+                self->private_impl.f_metadata_io_position,
+                0,
+                0);
+          }
+          status = wuffs_base__make_status(wuffs_base__suspension__mispositioned_read);
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(1);
+          goto label__0__continue;
+        }
+        if (((uint64_t)(io2_a_src - iop_a_src)) <= 0) {
+          if (a_minfo != NULL) {
+            wuffs_base__more_information__set(a_minfo,
+                0,
+                0,
+                0,
+                0,
+                0);
+          }
+          status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(2);
+          goto label__0__continue;
+        }
+        goto label__0__break;
+      }
+      label__0__break:;
+      v_chunk_length = ((uint64_t)(wuffs_base__peek_u8be__no_bounds_check(iop_a_src)));
+      if (v_chunk_length <= 0) {
+        iop_a_src += 1;
+        goto label__1__break;
+      }
+      if (self->private_impl.f_metadata_fourcc == 1481461792) {
+        v_chunk_length += 1;
+      } else {
+        iop_a_src += 1;
+      }
+      self->private_impl.f_metadata_io_position = wuffs_base__u64__sat_add(wuffs_base__u64__sat_add(a_src->meta.pos, ((uint64_t)(iop_a_src - io0_a_src))), v_chunk_length);
+      if (a_minfo != NULL) {
+        wuffs_base__more_information__set(a_minfo,
+            3,
+            self->private_impl.f_metadata_fourcc,
+            0,
+            wuffs_base__u64__sat_add(a_src->meta.pos, ((uint64_t)(iop_a_src - io0_a_src))),
+            self->private_impl.f_metadata_io_position);
+      }
+      status = wuffs_base__make_status(wuffs_base__suspension__even_more_information);
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(3);
+    }
+    label__1__break:;
+    if (a_minfo != NULL) {
+      wuffs_base__more_information__set(a_minfo,
+          3,
+          self->private_impl.f_metadata_fourcc,
+          0,
+          self->private_impl.f_metadata_io_position,
+          self->private_impl.f_metadata_io_position);
+    }
+    self->private_impl.f_call_sequence = 2;
+    self->private_impl.f_metadata_fourcc = 0;
+    self->private_impl.f_metadata_io_position = 0;
+    status = wuffs_base__make_status(NULL);
+    goto ok;
+
+    ok:
+    self->private_impl.p_tell_me_more[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_tell_me_more[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+  self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 2 : 0;
+
+  goto exit;
+  exit:
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  }
+
+  if (wuffs_base__status__is_error(&status)) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+  }
+  return status;
+}
+
+// -------- func gif.decoder.num_animation_loops
+
+WUFFS_BASE__MAYBE_STATIC uint32_t
+wuffs_gif__decoder__num_animation_loops(
+    const wuffs_gif__decoder* self) {
+  if (!self) {
+    return 0;
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return 0;
+  }
+
+  if (self->private_impl.f_seen_num_loops) {
+    return self->private_impl.f_num_loops;
+  }
+  return 1;
+}
+
+// -------- func gif.decoder.num_decoded_frame_configs
+
+WUFFS_BASE__MAYBE_STATIC uint64_t
+wuffs_gif__decoder__num_decoded_frame_configs(
+    const wuffs_gif__decoder* self) {
+  if (!self) {
+    return 0;
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return 0;
+  }
+
+  return self->private_impl.f_num_decoded_frame_configs_value;
+}
+
+// -------- func gif.decoder.num_decoded_frames
+
+WUFFS_BASE__MAYBE_STATIC uint64_t
+wuffs_gif__decoder__num_decoded_frames(
+    const wuffs_gif__decoder* self) {
+  if (!self) {
+    return 0;
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return 0;
+  }
+
+  return self->private_impl.f_num_decoded_frames_value;
+}
+
+// -------- func gif.decoder.frame_dirty_rect
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__rect_ie_u32
+wuffs_gif__decoder__frame_dirty_rect(
+    const wuffs_gif__decoder* self) {
+  if (!self) {
+    return wuffs_base__utility__empty_rect_ie_u32();
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return wuffs_base__utility__empty_rect_ie_u32();
+  }
+
+  uint32_t v_x0 = 0;
+  uint32_t v_y0 = 0;
+  uint32_t v_x1 = 0;
+  uint32_t v_y1 = 0;
+  uint32_t v_mask = 0;
+
+  v_x0 = wuffs_base__u32__min(wuffs_base__u32__max(self->private_impl.f_frame_rect_x0, self->private_impl.f_roi_x0), self->private_impl.f_width);
+  v_y0 = wuffs_base__u32__min(wuffs_base__u32__max(self->private_impl.f_frame_rect_y0, self->private_impl.f_roi_y0), self->private_impl.f_height);
+  v_x1 = wuffs_base__u32__min(wuffs_base__u32__min(self->private_impl.f_frame_rect_x1, self->private_impl.f_roi_x1), self->private_impl.f_width);
+  v_y1 = wuffs_base__u32__min(self->private_impl.f_dirty_max_excl_y, self->private_impl.f_height);
+  if (self->private_impl.f_downscale_shift > 0) {
+    v_mask = ((((uint32_t)(1)) << self->private_impl.f_downscale_shift) - 1);
+    v_x0 = (v_x0 >> self->private_impl.f_downscale_shift);
+    v_y0 = (v_y0 >> self->private_impl.f_downscale_shift);
+    v_x1 = (wuffs_base__u32__sat_add(v_x1, v_mask) >> self->private_impl.f_downscale_shift);
+    v_y1 = (wuffs_base__u32__sat_add(v_y1, v_mask) >> self->private_impl.f_downscale_shift);
+  }
+  return wuffs_base__utility__make_rect_ie_u32(
+      v_x0,
+      v_y0,
+      v_x1,
+      v_y1);
+}
+
+// -------- func gif.decoder.workbuf_len
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__range_ii_u64
+wuffs_gif__decoder__workbuf_len(
+    const wuffs_gif__decoder* self) {
+  if (!self) {
+    return wuffs_base__utility__empty_range_ii_u64();
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return wuffs_base__utility__empty_range_ii_u64();
+  }
+
+  return wuffs_base__utility__make_range_ii_u64(0, ((((uint64_t)(self->private_impl.f_width)) * 5) + 16));
+}
+
+// -------- func gif.decoder.restart_frame
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_gif__decoder__restart_frame(
+    wuffs_gif__decoder* self,
+    uint64_t a_index,
+    uint64_t a_io_position) {
+  if (!self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+  }
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_status(
+        (self->private_impl.magic == WUFFS_BASE__DISABLED)
+        ? wuffs_base__error__disabled_by_previous_error
+        : wuffs_base__error__initialize_not_called);
+  }
+
+  if (self->private_impl.f_call_sequence < 3) {
+    return wuffs_base__make_status(wuffs_base__error__bad_call_sequence);
+  }
+  self->private_impl.f_delayed_num_decoded_frames = false;
+  self->private_impl.f_end_of_data = false;
+  self->private_impl.f_restarted = true;
+  self->private_impl.f_frame_config_io_position = a_io_position;
+  self->private_impl.f_num_decoded_frame_configs_value = a_index;
+  self->private_impl.f_num_decoded_frames_value = a_index;
+  wuffs_gif__decoder__reset_gc(self);
+  return wuffs_base__make_status(NULL);
+}
+
+// -------- func gif.decoder.decode_frame_config
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_gif__decoder__decode_frame_config(
+    wuffs_gif__decoder* self,
+    wuffs_base__frame_config* a_dst,
+    wuffs_base__io_buffer* a_src) {
+  if (!self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+  }
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_status(
+        (self->private_impl.magic == WUFFS_BASE__DISABLED)
+        ? wuffs_base__error__disabled_by_previous_error
+        : wuffs_base__error__initialize_not_called);
+  }
+  if (!a_src) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+    return wuffs_base__make_status(wuffs_base__error__bad_argument);
+  }
+  if ((self->private_impl.active_coroutine != 0) &&
+      (self->private_impl.active_coroutine != 3)) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+    return wuffs_base__make_status(wuffs_base__error__interleaved_coroutine_calls);
+  }
+  self->private_impl.active_coroutine = 0;
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  uint32_t v_background_color = 0;
+  uint8_t v_flags = 0;
+
+  const uint8_t* iop_a_src = NULL;
+  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_src) {
+    io0_a_src = a_src->data.ptr;
+    io1_a_src = io0_a_src + a_src->meta.ri;
+    iop_a_src = io1_a_src;
+    io2_a_src = io0_a_src + a_src->meta.wi;
+  }
+
+  uint32_t coro_susp_point = self->private_impl.p_decode_frame_config[0];
+  if (coro_susp_point) {
+    v_background_color = self->private_data.s_decode_frame_config[0].v_background_color;
+  }
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    self->private_impl.f_ignore_metadata = true;
+    self->private_impl.f_dirty_max_excl_y = 0;
+    self->private_impl.f_roi_x0 = 0;
+    self->private_impl.f_roi_y0 = 0;
+    self->private_impl.f_roi_x1 = 4294967295;
+    self->private_impl.f_roi_y1 = 4294967295;
+    if ( ! self->private_impl.f_end_of_data) {
+      if (self->private_impl.f_call_sequence == 0) {
+        if (a_src) {
+          a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+        }
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+        status = wuffs_gif__decoder__decode_image_config(self, NULL, a_src);
+        if (a_src) {
+          iop_a_src = a_src->data.ptr + a_src->meta.ri;
+        }
+        if (status.repr) {
+          goto suspend;
+        }
+      } else if (self->private_impl.f_call_sequence != 3) {
+        if (self->private_impl.f_call_sequence == 4) {
+          if (a_src) {
+            a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+          }
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+          status = wuffs_gif__decoder__skip_frame(self, a_src);
+          if (a_src) {
+            iop_a_src = a_src->data.ptr + a_src->meta.ri;
+          }
+          if (status.repr) {
+            goto suspend;
+          }
+        }
+        if (a_src) {
+          a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+        }
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+        status = wuffs_gif__decoder__decode_up_to_id_part1(self, a_src);
+        if (a_src) {
+          iop_a_src = a_src->data.ptr + a_src->meta.ri;
+        }
+        if (status.repr) {
+          goto suspend;
+        }
+      }
+    }
+    if (self->private_impl.f_end_of_data) {
+      status = wuffs_base__make_status(wuffs_base__note__end_of_data);
+      goto ok;
+    }
+    v_background_color = self->private_impl.f_black_color_u32_argb_premul;
+    if ( ! self->private_impl.f_gc_has_transparent_index) {
+      v_background_color = self->private_impl.f_background_color_u32_argb_premul;
+      if (self->private_impl.f_quirks[1] && (self->private_impl.f_num_decoded_frame_configs_value == 0)) {
+        while (((uint64_t)(io2_a_src - iop_a_src)) <= 0) {
+          status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(4);
+        }
+        v_flags = wuffs_base__peek_u8be__no_bounds_check(iop_a_src);
+        if ((v_flags & 128) != 0) {
+          v_background_color = self->private_impl.f_black_color_u32_argb_premul;
+        }
+      }
+    }
+    if (a_dst != NULL) {
+      wuffs_base__frame_config__set(
+          a_dst,
+          wuffs_base__utility__make_rect_ie_u32(
+          wuffs_base__u32__min(self->private_impl.f_frame_rect_x0, self->private_impl.f_width),
+          wuffs_base__u32__min(self->private_impl.f_frame_rect_y0, self->private_impl.f_height),
+          wuffs_base__u32__min(self->private_impl.f_frame_rect_x1, self->private_impl.f_width),
+          wuffs_base__u32__min(self->private_impl.f_frame_rect_y1, self->private_impl.f_height)),
+          ((wuffs_base__flicks)(self->private_impl.f_gc_duration)),
+          self->private_impl.f_num_decoded_frame_configs_value,
+          self->private_impl.f_frame_config_io_position,
+          self->private_impl.f_gc_disposal,
+          ! self->private_impl.f_gc_has_transparent_index,
+          false,
+          v_background_color);
+    }
+    wuffs_base__u64__sat_add_indirect(&self->private_impl.f_num_decoded_frame_configs_value, 1);
+    self->private_impl.f_call_sequence = 4;
+
+    ok:
+    self->private_impl.p_decode_frame_config[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_decode_frame_config[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+  self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 3 : 0;
+  self->private_data.s_decode_frame_config[0].v_background_color = v_background_color;
+
+  goto exit;
+  exit:
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  }
+
+  if (wuffs_base__status__is_error(&status)) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+  }
+  return status;
+}
+
+// -------- func gif.decoder.skip_frame
+
+static wuffs_base__status
+wuffs_gif__decoder__skip_frame(
+    wuffs_gif__decoder* self,
+    wuffs_base__io_buffer* a_src) {
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  uint8_t v_flags = 0;
+  uint8_t v_lw = 0;
+
+  const uint8_t* iop_a_src = NULL;
+  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
   const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
   const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
   if (a_src) {
@@ -29125,7 +36413,12 @@ wuffs_gif__decoder__decode_frame(
   self->private_impl.active_coroutine = 0;
   wuffs_base__status status = wuffs_base__make_status(NULL);
 
+  uint32_t v_shift = 0;
+
   uint32_t coro_susp_point = self->private_impl.p_decode_frame[0];
+  if (coro_susp_point) {
+    v_shift = self->private_data.s_decode_frame[0].v_shift;
+  }
   switch (coro_susp_point) {
     WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
 
@@ -29137,6 +36430,28 @@ wuffs_gif__decoder__decode_frame(
         goto suspend;
       }
     }
+    if (a_opts != NULL) {
+      self->private_impl.f_roi_x0 = wuffs_base__decode_frame_options__roi_min_incl_x(a_opts);
+      self->private_impl.f_roi_y0 = wuffs_base__decode_frame_options__roi_min_incl_y(a_opts);
+      self->private_impl.f_roi_x1 = wuffs_base__decode_frame_options__roi_max_excl_x(a_opts);
+      self->private_impl.f_roi_y1 = wuffs_base__decode_frame_options__roi_max_excl_y(a_opts);
+      v_shift = wuffs_base__decode_frame_options__downscale_shift(a_opts);
+    }
+    self->private_impl.f_downscale_shift = 0;
+    if (v_shift > 0) {
+      if ((v_shift > 3) ||
+          (self->private_impl.f_roi_x0 > 0) ||
+          (self->private_impl.f_roi_y0 > 0) ||
+          (self->private_impl.f_roi_x1 < 4294967295) ||
+          (self->private_impl.f_roi_y1 < 4294967295)) {
+        status = wuffs_base__make_status(wuffs_base__error__unsupported_option);
+        goto exit;
+      } else if (((uint64_t)(a_workbuf.len)) < ((((uint64_t)(self->private_impl.f_width)) * 5) + 16)) {
+        status = wuffs_base__make_status(wuffs_base__error__bad_workbuf_length);
+        goto exit;
+      }
+      self->private_impl.f_downscale_shift = v_shift;
+    }
     if (self->private_impl.f_quirks[5] && ((self->private_impl.f_frame_rect_x0 == self->private_impl.f_frame_rect_x1) || (self->private_impl.f_frame_rect_y0 == self->private_impl.f_frame_rect_y1))) {
       status = wuffs_base__make_status(wuffs_gif__error__bad_frame_size);
       goto exit;
@@ -29164,6 +36479,7 @@ wuffs_gif__decoder__decode_frame(
   suspend:
   self->private_impl.p_decode_frame[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
   self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 4 : 0;
+  self->private_data.s_decode_frame[0].v_shift = v_shift;
 
   goto exit;
   exit:
@@ -30376,6 +37692,28 @@ wuffs_gif__decoder__decode_id_part1(
       }
       goto ok;
     }
+    self->private_impl.f_downscale_stop_interlace = 0;
+    if (self->private_impl.f_downscale_shift > 0) {
+      v_status = wuffs_base__pixel_swizzler__prepare_downscaled(&self->private_impl.f_downscaler,
+          wuffs_base__pixel_buffer__pixel_format(a_dst),
+          wuffs_base__make_slice_u8(self->private_data.f_dst_palette, 1024),
+          wuffs_base__utility__make_pixel_format(2198077448),
+          wuffs_base__make_slice_u8(self->private_data.f_palettes[v_which_palette], 1024),
+          a_blend);
+      if ( ! wuffs_base__status__is_ok(&v_status)) {
+        status = v_status;
+        if (wuffs_base__status__is_error(&status)) {
+          goto exit;
+        } else if (wuffs_base__status__is_suspension(&status)) {
+          status = wuffs_base__make_status(wuffs_base__error__cannot_return_a_suspension);
+          goto exit;
+        }
+        goto ok;
+      }
+      if (self->private_impl.f_interlace > 0) {
+        self->private_impl.f_downscale_stop_interlace = (1 + ((uint8_t)((self->private_impl.f_downscale_shift & 3))));
+      }
+    }
     if (self->private_impl.f_previous_lzw_decode_ended_abruptly) {
       wuffs_base__ignore_status(wuffs_lzw__decoder__initialize(&self->private_data.f_lzw, sizeof (wuffs_lzw__decoder), WUFFS_VERSION, 0));
     }
@@ -30511,6 +37849,31 @@ wuffs_gif__decoder__decode_id_part2(
       label__0__break:;
       label__inner__continue:;
       while (true) {
+        if (wuffs_gif__decoder__is_past_roi(self)) {
+          if (v_need_block_size || (v_block_size > 0)) {
+            self->private_data.s_decode_id_part2[0].scratch = ((uint32_t)(v_block_size));
+            WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+            if (self->private_data.s_decode_id_part2[0].scratch > ((uint64_t)(io2_a_src - iop_a_src))) {
+              self->private_data.s_decode_id_part2[0].scratch -= ((uint64_t)(io2_a_src - iop_a_src));
+              iop_a_src = io2_a_src;
+              status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+              goto suspend;
+            }
+            iop_a_src += self->private_data.s_decode_id_part2[0].scratch;
+            if (a_src) {
+              a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+            }
+            WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
+            status = wuffs_gif__decoder__skip_blocks(self, a_src);
+            if (a_src) {
+              iop_a_src = a_src->data.ptr + a_src->meta.ri;
+            }
+            if (status.repr) {
+              goto suspend;
+            }
+          }
+          goto label__outer__break;
+        }
         if ((self->private_impl.f_compressed_ri > self->private_impl.f_compressed_wi) || (self->private_impl.f_compressed_wi > 4096)) {
           status = wuffs_base__make_status(wuffs_gif__error__internal_error_inconsistent_ri_wi);
           goto exit;
@@ -30547,7 +37910,7 @@ wuffs_gif__decoder__decode_id_part2(
         }
         v_uncompressed = wuffs_lzw__decoder__flush(&self->private_data.f_lzw);
         if (((uint64_t)(v_uncompressed.len)) > 0) {
-          v_copy_status = wuffs_gif__decoder__copy_to_image_buffer(self, a_dst, v_uncompressed);
+          v_copy_status = wuffs_gif__decoder__copy_to_image_buffer(self, a_dst, v_uncompressed, a_workbuf);
           if (wuffs_base__status__is_error(&v_copy_status)) {
             status = v_copy_status;
             goto exit;
@@ -30557,7 +37920,7 @@ wuffs_gif__decoder__decode_id_part2(
           self->private_impl.f_previous_lzw_decode_ended_abruptly = false;
           if (v_need_block_size || (v_block_size > 0)) {
             self->private_data.s_decode_id_part2[0].scratch = ((uint32_t)(v_block_size));
-            WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+            WUFFS_BASE__COROUTINE_SUSPENSION_POINT(5);
             if (self->private_data.s_decode_id_part2[0].scratch > ((uint64_t)(io2_a_src - iop_a_src))) {
               self->private_data.s_decode_id_part2[0].scratch -= ((uint64_t)(io2_a_src - iop_a_src));
               iop_a_src = io2_a_src;
@@ -30568,7 +37931,7 @@ wuffs_gif__decoder__decode_id_part2(
             if (a_src) {
               a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
             }
-            WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
+            WUFFS_BASE__COROUTINE_SUSPENSION_POINT(6);
             status = wuffs_gif__decoder__skip_blocks(self, a_src);
             if (a_src) {
               iop_a_src = a_src->data.ptr + a_src->meta.ri;
@@ -30596,7 +37959,10 @@ wuffs_gif__decoder__decode_id_part2(
     label__outer__break:;
     self->private_impl.f_compressed_ri = 0;
     self->private_impl.f_compressed_wi = 0;
-    if ((self->private_impl.f_dst_y < self->private_impl.f_frame_rect_y1) && (self->private_impl.f_frame_rect_x0 != self->private_impl.f_frame_rect_x1) && (self->private_impl.f_frame_rect_y0 != self->private_impl.f_frame_rect_y1)) {
+    if ((self->private_impl.f_dst_y < self->private_impl.f_frame_rect_y1) &&
+        (self->private_impl.f_frame_rect_x0 != self->private_impl.f_frame_rect_x1) &&
+        (self->private_impl.f_frame_rect_y0 != self->private_impl.f_frame_rect_y1) &&
+        ! wuffs_gif__decoder__is_past_roi(self)) {
       status = wuffs_base__make_status(wuffs_base__error__not_enough_data);
       goto exit;
     }
@@ -30622,13 +37988,22 @@ wuffs_gif__decoder__decode_id_part2(
   return status;
 }
 
+// -------- func gif.decoder.is_past_roi
+
+static bool
+wuffs_gif__decoder__is_past_roi(
+    const wuffs_gif__decoder* self) {
+  return ((self->private_impl.f_interlace < self->private_impl.f_downscale_stop_interlace) || ((self->private_impl.f_interlace <= 1) && (self->private_impl.f_roi_y1 < self->private_impl.f_frame_rect_y1) && (self->private_impl.f_roi_y1 <= self->private_impl.f_dst_y)));
+}
+
 // -------- func gif.decoder.copy_to_image_buffer
 
 static wuffs_base__status
 wuffs_gif__decoder__copy_to_image_buffer(
     wuffs_gif__decoder* self,
     wuffs_base__pixel_buffer* a_pb,
-    wuffs_base__slice_u8 a_src) {
+    wuffs_base__slice_u8 a_src,
+    wuffs_base__slice_u8 a_workbuf) {
   wuffs_base__slice_u8 v_dst = {0};
   wuffs_base__slice_u8 v_src = {0};
   uint64_t v_width_in_bytes = 0;
@@ -30640,10 +38015,14 @@ wuffs_gif__decoder__copy_to_image_buffer(
   wuffs_base__table_u8 v_tab = {0};
   uint64_t v_i = 0;
   uint64_t v_j = 0;
+  uint64_t v_replicate_x0 = 0;
+  uint64_t v_replicate_x1 = 0;
   uint32_t v_replicate_y0 = 0;
   uint32_t v_replicate_y1 = 0;
   wuffs_base__slice_u8 v_replicate_dst = {0};
   wuffs_base__slice_u8 v_replicate_src = {0};
+  wuffs_base__slice_u8 v_row = {0};
+  wuffs_base__slice_u8 v_accum = {0};
 
   v_pixfmt = wuffs_base__pixel_buffer__pixel_format(a_pb);
   v_bits_per_pixel = wuffs_base__pixel_format__bits_per_pixel(&v_pixfmt);
@@ -30651,25 +38030,51 @@ wuffs_gif__decoder__copy_to_image_buffer(
     return wuffs_base__make_status(wuffs_base__error__unsupported_option);
   }
   v_bytes_per_pixel = (v_bits_per_pixel >> 3);
-  v_width_in_bytes = (((uint64_t)(self->private_impl.f_width)) * ((uint64_t)(v_bytes_per_pixel)));
+  v_width_in_bytes = (((uint64_t)(wuffs_base__u32__min(self->private_impl.f_width, self->private_impl.f_roi_x1))) * ((uint64_t)(v_bytes_per_pixel)));
   v_tab = wuffs_base__pixel_buffer__plane(a_pb, 0);
+  if (self->private_impl.f_downscale_shift > 0) {
+    v_n = ((uint64_t)(self->private_impl.f_width));
+    if (v_n > ((uint64_t)(a_workbuf.len))) {
+      return wuffs_base__make_status(wuffs_base__error__bad_workbuf_length);
+    }
+    v_row = wuffs_base__slice_u8__subslice_j(a_workbuf, v_n);
+    v_accum = wuffs_base__slice_u8__subslice_i(a_workbuf, v_n);
+    v_n = ((uint64_t)(wuffs_base__u32__sat_sub(wuffs_base__u32__min(self->private_impl.f_frame_rect_x1, self->private_impl.f_width), self->private_impl.f_frame_rect_x0)));
+    if (v_n < ((uint64_t)(v_row.len))) {
+      v_row = wuffs_base__slice_u8__subslice_j(v_row, v_n);
+    }
+  }
   label__0__continue:;
   while (v_src_ri < ((uint64_t)(a_src.len))) {
     v_src = wuffs_base__slice_u8__subslice_i(a_src, v_src_ri);
-    if (self->private_impl.f_dst_y >= self->private_impl.f_frame_rect_y1) {
+    if (wuffs_gif__decoder__is_past_roi(self)) {
+      return wuffs_base__make_status(NULL);
+    } else if (self->private_impl.f_dst_y >= self->private_impl.f_frame_rect_y1) {
       if (self->private_impl.f_quirks[3]) {
         return wuffs_base__make_status(NULL);
       }
       return wuffs_base__make_status(wuffs_base__error__too_much_data);
     }
-    v_dst = wuffs_base__table_u8__row(v_tab, self->private_impl.f_dst_y);
-    if (self->private_impl.f_dst_y >= self->private_impl.f_height) {
-      v_dst = wuffs_base__slice_u8__subslice_j(v_dst, 0);
-    } else if (v_width_in_bytes < ((uint64_t)(v_dst.len))) {
-      v_dst = wuffs_base__slice_u8__subslice_j(v_dst, v_width_in_bytes);
+    if (self->private_impl.f_downscale_shift > 0) {
+      v_i = ((uint64_t)(((uint32_t)(self->private_impl.f_dst_x - self->private_impl.f_frame_rect_x0))));
+      if ((self->private_impl.f_dst_y < self->private_impl.f_height) && (v_i < ((uint64_t)(v_row.len)))) {
+        v_n = wuffs_base__slice_u8__copy_from_slice(wuffs_base__slice_u8__subslice_i(v_row, v_i), v_src);
+        wuffs_base__u64__sat_add_indirect(&v_src_ri, v_n);
+        wuffs_base__u32__sat_add_indirect(&self->private_impl.f_dst_x, ((uint32_t)((v_n & 4294967295))));
+        self->private_impl.f_dirty_max_excl_y = wuffs_base__u32__max(self->private_impl.f_dirty_max_excl_y, wuffs_base__u32__sat_add(self->private_impl.f_dst_y, 1));
+      }
+      v_dst = wuffs_base__utility__empty_slice_u8();
+      v_i = 0;
+    } else {
+      v_dst = wuffs_base__table_u8__row(v_tab, self->private_impl.f_dst_y);
+      if ((self->private_impl.f_dst_y >= self->private_impl.f_height) || (self->private_impl.f_dst_y < self->private_impl.f_roi_y0) || (self->private_impl.f_dst_y >= self->private_impl.f_roi_y1)) {
+        v_dst = wuffs_base__slice_u8__subslice_j(v_dst, 0);
+      } else if (v_width_in_bytes < ((uint64_t)(v_dst.len))) {
+        v_dst = wuffs_base__slice_u8__subslice_j(v_dst, v_width_in_bytes);
+      }
+      v_i = (((uint64_t)(self->private_impl.f_dst_x)) * ((uint64_t)(v_bytes_per_pixel)));
     }
-    v_i = (((uint64_t)(self->private_impl.f_dst_x)) * ((uint64_t)(v_bytes_per_pixel)));
-    if (v_i < ((uint64_t)(v_dst.len))) {
+    if ((self->private_impl.f_dst_x >= self->private_impl.f_roi_x0) && (v_i < ((uint64_t)(v_dst.len)))) {
       v_j = (((uint64_t)(self->private_impl.f_frame_rect_x1)) * ((uint64_t)(v_bytes_per_pixel)));
       if ((v_i <= v_j) && (v_j <= ((uint64_t)(v_dst.len)))) {
         v_dst = wuffs_base__slice_u8__subslice_ij(v_dst, v_i, v_j);
@@ -30682,19 +38087,38 @@ wuffs_gif__decoder__copy_to_image_buffer(
       self->private_impl.f_dirty_max_excl_y = wuffs_base__u32__max(self->private_impl.f_dirty_max_excl_y, wuffs_base__u32__sat_add(self->private_impl.f_dst_y, 1));
     }
     if (self->private_impl.f_frame_rect_x1 <= self->private_impl.f_dst_x) {
+      wuffs_gif__decoder__downscale_row(self, a_pb, v_row, v_accum);
       self->private_impl.f_dst_x = self->private_impl.f_frame_rect_x0;
       if (self->private_impl.f_interlace == 0) {
         wuffs_base__u32__sat_add_indirect(&self->private_impl.f_dst_y, 1);
         goto label__0__continue;
       }
-      if ((self->private_impl.f_num_decoded_frames_value == 0) &&  ! self->private_impl.f_gc_has_transparent_index && (self->private_impl.f_interlace > 1)) {
+      if ((self->private_impl.f_num_decoded_frames_value == 0) &&
+          (self->private_impl.f_downscale_shift == 0) &&
+          ! self->private_impl.f_gc_has_transparent_index &&
+          (self->private_impl.f_interlace > 1) &&
+          (self->private_impl.f_dst_y >= self->private_impl.f_roi_y0) &&
+          (self->private_impl.f_dst_y < self->private_impl.f_roi_y1)) {
+        v_replicate_x0 = (((uint64_t)(self->private_impl.f_roi_x0)) * ((uint64_t)(v_bytes_per_pixel)));
+        v_replicate_x1 = (((uint64_t)(self->private_impl.f_roi_x1)) * ((uint64_t)(v_bytes_per_pixel)));
         v_replicate_src = wuffs_base__table_u8__row(v_tab, self->private_impl.f_dst_y);
+        if (v_replicate_x1 < ((uint64_t)(v_replicate_src.len))) {
+          v_replicate_src = wuffs_base__slice_u8__subslice_j(v_replicate_src, v_replicate_x1);
+        }
+        if (v_replicate_x0 < ((uint64_t)(v_replicate_src.len))) {
+          v_replicate_src = wuffs_base__slice_u8__subslice_i(v_replicate_src, v_replicate_x0);
+        } else {
+          v_replicate_src = wuffs_base__utility__empty_slice_u8();
+        }
         v_replicate_y0 = wuffs_base__u32__sat_add(self->private_impl.f_dst_y, 1);
         v_replicate_y1 = wuffs_base__u32__sat_add(self->private_impl.f_dst_y, ((uint32_t)(WUFFS_GIF__INTERLACE_COUNT[self->private_impl.f_interlace])));
-        v_replicate_y1 = wuffs_base__u32__min(v_replicate_y1, self->private_impl.f_frame_rect_y1);
+        v_replicate_y1 = wuffs_base__u32__min(wuffs_base__u32__min(v_replicate_y1, self->private_impl.f_frame_rect_y1), self->private_impl.f_roi_y1);
         while (v_replicate_y0 < v_replicate_y1) {
           v_replicate_dst = wuffs_base__table_u8__row(v_tab, v_replicate_y0);
-          wuffs_base__slice_u8__copy_from_slice(v_replicate_dst, v_replicate_src);
+          if (v_replicate_x0 < ((uint64_t)(v_replicate_dst.len))) {
+            v_replicate_dst = wuffs_base__slice_u8__subslice_i(v_replicate_dst, v_replicate_x0);
+            wuffs_base__slice_u8__copy_from_slice(v_replicate_dst, v_replicate_src);
+          }
           v_replicate_y0 += 1;
         }
         self->private_impl.f_dirty_max_excl_y = wuffs_base__u32__max(self->private_impl.f_dirty_max_excl_y, v_replicate_y1);
@@ -30719,10 +38143,14 @@ wuffs_gif__decoder__copy_to_image_buffer(
       return wuffs_base__make_status(wuffs_gif__error__internal_error_inconsistent_ri_wi);
     }
     v_n = ((uint64_t)((self->private_impl.f_frame_rect_x1 - self->private_impl.f_dst_x)));
+    if (self->private_impl.f_roi_x0 > self->private_impl.f_dst_x) {
+      v_n = wuffs_base__u64__min(v_n, ((uint64_t)((self->private_impl.f_roi_x0 - self->private_impl.f_dst_x))));
+    }
     v_n = wuffs_base__u64__min(v_n, (((uint64_t)(a_src.len)) - v_src_ri));
     wuffs_base__u64__sat_add_indirect(&v_src_ri, v_n);
     wuffs_base__u32__sat_add_indirect(&self->private_impl.f_dst_x, ((uint32_t)((v_n & 4294967295))));
     if (self->private_impl.f_frame_rect_x1 <= self->private_impl.f_dst_x) {
+      wuffs_gif__decoder__downscale_row(self, a_pb, v_row, v_accum);
       self->private_impl.f_dst_x = self->private_impl.f_frame_rect_x0;
       wuffs_base__u32__sat_add_indirect(&self->private_impl.f_dst_y, ((uint32_t)(WUFFS_GIF__INTERLACE_DELTA[self->private_impl.f_interlace])));
       while ((self->private_impl.f_interlace > 0) && (self->private_impl.f_dst_y >= self->private_impl.f_frame_rect_y1)) {
@@ -30738,15 +38166,49 @@ wuffs_gif__decoder__copy_to_image_buffer(
       }
       goto label__0__continue;
     }
-    if (v_src_ri != ((uint64_t)(a_src.len))) {
+    if (v_src_ri == ((uint64_t)(a_src.len))) {
+      goto label__0__break;
+    } else if (self->private_impl.f_dst_x != self->private_impl.f_roi_x0) {
       return wuffs_base__make_status(wuffs_gif__error__internal_error_inconsistent_ri_wi);
     }
-    goto label__0__break;
   }
   label__0__break:;
   return wuffs_base__make_status(NULL);
 }
 
+// -------- func gif.decoder.downscale_row
+
+static wuffs_base__empty_struct
+wuffs_gif__decoder__downscale_row(
+    wuffs_gif__decoder* self,
+    wuffs_base__pixel_buffer* a_pb,
+    wuffs_base__slice_u8 a_row,
+    wuffs_base__slice_u8 a_accum) {
+  uint32_t v_y0 = 0;
+  uint32_t v_y1 = 0;
+
+  if ((self->private_impl.f_downscale_shift == 0) || (self->private_impl.f_dst_y >= self->private_impl.f_height)) {
+    return wuffs_base__make_empty_struct();
+  }
+  v_y0 = self->private_impl.f_frame_rect_y0;
+  v_y1 = wuffs_base__u32__min(self->private_impl.f_frame_rect_y1, self->private_impl.f_height);
+  if (self->private_impl.f_downscale_stop_interlace > 0) {
+    v_y0 = self->private_impl.f_dst_y;
+    v_y1 = wuffs_base__u32__sat_add(self->private_impl.f_dst_y, 1);
+  }
+  wuffs_base__pixel_swizzler__swizzle_downscaled_from_slice(&self->private_impl.f_downscaler,
+      wuffs_base__pixel_buffer__plane(a_pb, 0),
+      wuffs_base__make_slice_u8(self->private_data.f_dst_palette, 1024),
+      a_accum,
+      a_row,
+      self->private_impl.f_downscale_shift,
+      self->private_impl.f_frame_rect_x0,
+      self->private_impl.f_dst_y,
+      v_y0,
+      v_y1);
+  return wuffs_base__make_empty_struct();
+}
+
 #endif  // !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__GIF)
 
 #if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__GZIP)
@@ -30760,6 +38222,8 @@ const char wuffs_gzip__error__bad_header[] = "#gzip: bad header";
 
 // ---------------- Private Consts
 
+#define WUFFS_GZIP__FUSED_CHECKSUM_LENGTH 131072
+
 // ---------------- Private Initializer Prototypes
 
 // ---------------- Private Function Prototypes
@@ -30778,6 +38242,18 @@ wuffs_gzip__decoder__func_ptrs_for__wuffs_base__io_transformer = {
   (wuffs_base__range_ii_u64(*)(const void*))(&wuffs_gzip__decoder__workbuf_len),
 };
 
+const wuffs_base__io_transformer__func_ptrs
+wuffs_gzip__encoder__func_ptrs_for__wuffs_base__io_transformer = {
+  (wuffs_base__empty_struct(*)(void*,
+      uint32_t,
+      bool))(&wuffs_gzip__encoder__set_quirk_enabled),
+  (wuffs_base__status(*)(void*,
+      wuffs_base__io_buffer*,
+      wuffs_base__io_buffer*,
+      wuffs_base__slice_u8))(&wuffs_gzip__encoder__transform_io),
+  (wuffs_base__range_ii_u64(*)(const void*))(&wuffs_gzip__encoder__workbuf_len),
+};
+
 // ---------------- Initializer Implementations
 
 wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
@@ -30861,6 +38337,87 @@ sizeof__wuffs_gzip__decoder() {
   return sizeof(wuffs_gzip__decoder);
 }
 
+wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
+wuffs_gzip__encoder__initialize(
+    wuffs_gzip__encoder* self,
+    size_t sizeof_star_self,
+    uint64_t wuffs_version,
+    uint32_t options){
+  if (!self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+  }
+  if (sizeof(*self) != sizeof_star_self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_sizeof_receiver);
+  }
+  if (((wuffs_version >> 32) != WUFFS_VERSION_MAJOR) ||
+      (((wuffs_version >> 16) & 0xFFFF) > WUFFS_VERSION_MINOR)) {
+    return wuffs_base__make_status(wuffs_base__error__bad_wuffs_version);
+  }
+
+  if ((options & WUFFS_INITIALIZE__ALREADY_ZEROED) != 0) {
+    // The whole point of this if-check is to detect an uninitialized *self.
+    // We disable the warning on GCC. Clang-5.0 does not have this warning.
+#if !defined(__clang__) && defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+    if (self->private_impl.magic != 0) {
+      return wuffs_base__make_status(wuffs_base__error__initialize_falsely_claimed_already_zeroed);
+    }
+#if !defined(__clang__) && defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+  } else {
+    if ((options & WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED) == 0) {
+      memset(self, 0, sizeof(*self));
+      options |= WUFFS_INITIALIZE__ALREADY_ZEROED;
+    } else {
+      memset(&(self->private_impl), 0, sizeof(self->private_impl));
+    }
+  }
+
+  {
+    wuffs_base__status z = wuffs_crc32__ieee_hasher__initialize(
+        &self->private_data.f_checksum, sizeof(self->private_data.f_checksum), WUFFS_VERSION, options);
+    if (z.repr) {
+      return z;
+    }
+  }
+  {
+    wuffs_base__status z = wuffs_deflate__encoder__initialize(
+        &self->private_data.f_flate, sizeof(self->private_data.f_flate), WUFFS_VERSION, options);
+    if (z.repr) {
+      return z;
+    }
+  }
+  self->private_impl.magic = WUFFS_BASE__MAGIC;
+  self->private_impl.vtable_for__wuffs_base__io_transformer.vtable_name =
+      wuffs_base__io_transformer__vtable_name;
+  self->private_impl.vtable_for__wuffs_base__io_transformer.function_pointers =
+      (const void*)(&wuffs_gzip__encoder__func_ptrs_for__wuffs_base__io_transformer);
+  return wuffs_base__make_status(NULL);
+}
+
+wuffs_gzip__encoder*
+wuffs_gzip__encoder__alloc() {
+  wuffs_gzip__encoder* x =
+      (wuffs_gzip__encoder*)(calloc(sizeof(wuffs_gzip__encoder), 1));
+  if (!x) {
+    return NULL;
+  }
+  if (wuffs_gzip__encoder__initialize(
+      x, sizeof(wuffs_gzip__encoder), WUFFS_VERSION, WUFFS_INITIALIZE__ALREADY_ZEROED).repr) {
+    free(x);
+    return NULL;
+  }
+  return x;
+}
+
+size_t
+sizeof__wuffs_gzip__encoder() {
+  return sizeof(wuffs_gzip__encoder);
+}
+
 // ---------------- Function Implementations
 
 // -------- func gzip.decoder.set_quirk_enabled
@@ -30879,6 +38436,8 @@ wuffs_gzip__decoder__set_quirk_enabled(
 
   if (a_quirk == 1) {
     self->private_impl.f_ignore_checksum = a_enabled;
+  } else {
+    wuffs_deflate__decoder__set_quirk_enabled(&self->private_data.f_flate, a_quirk, a_enabled);
   }
   return wuffs_base__make_empty_struct();
 }
@@ -31118,30 +38677,62 @@ wuffs_gzip__decoder__transform_io(
       status = wuffs_base__make_status(wuffs_gzip__error__bad_encoding_flags);
       goto exit;
     }
+    label__2__continue:;
     while (true) {
       v_mark = ((uint64_t)(iop_a_dst - io0_a_dst));
-      {
-        if (a_dst) {
-          a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
-        }
-        if (a_src) {
-          a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
-        }
-        wuffs_base__status t_7 = wuffs_deflate__decoder__transform_io(&self->private_data.f_flate, a_dst, a_src, a_workbuf);
-        v_status = t_7;
-        if (a_dst) {
-          iop_a_dst = a_dst->data.ptr + a_dst->meta.wi;
+      if (self->private_impl.f_ignore_checksum) {
+        {
+          if (a_dst) {
+            a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+          }
+          if (a_src) {
+            a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+          }
+          wuffs_base__status t_7 = wuffs_deflate__decoder__transform_io(&self->private_data.f_flate, a_dst, a_src, a_workbuf);
+          v_status = t_7;
+          if (a_dst) {
+            iop_a_dst = a_dst->data.ptr + a_dst->meta.wi;
+          }
+          if (a_src) {
+            iop_a_src = a_src->data.ptr + a_src->meta.ri;
+          }
         }
-        if (a_src) {
-          iop_a_src = a_src->data.ptr + a_src->meta.ri;
+      } else {
+        {
+          uint8_t *o_0_io2_a_dst = io2_a_dst;
+          wuffs_base__io_writer__limit(&io2_a_dst, iop_a_dst,
+              131072);
+          if (a_dst) {
+            a_dst->data.len = ((size_t)(io2_a_dst - a_dst->data.ptr));
+          }
+          {
+            if (a_dst) {
+              a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+            }
+            if (a_src) {
+              a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+            }
+            wuffs_base__status t_8 = wuffs_deflate__decoder__transform_io(&self->private_data.f_flate, a_dst, a_src, a_workbuf);
+            v_status = t_8;
+            if (a_dst) {
+              iop_a_dst = a_dst->data.ptr + a_dst->meta.wi;
+            }
+            if (a_src) {
+              iop_a_src = a_src->data.ptr + a_src->meta.ri;
+            }
+          }
+          io2_a_dst = o_0_io2_a_dst;
+          if (a_dst) {
+            a_dst->data.len = ((size_t)(io2_a_dst - a_dst->data.ptr));
+          }
         }
-      }
-      if ( ! self->private_impl.f_ignore_checksum) {
         v_checksum_got = wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_checksum, wuffs_base__io__since(v_mark, ((uint64_t)(iop_a_dst - io0_a_dst)), io0_a_dst));
         v_decoded_length_got += ((uint32_t)((wuffs_base__io__count_since(v_mark, ((uint64_t)(iop_a_dst - io0_a_dst))) & 4294967295)));
       }
       if (wuffs_base__status__is_ok(&v_status)) {
         goto label__2__break;
+      } else if ((v_status.repr == wuffs_base__suspension__short_write) && (((uint64_t)(io2_a_dst - iop_a_dst)) > 0) && (wuffs_base__io__count_since(v_mark, ((uint64_t)(iop_a_dst - io0_a_dst))) >= 32768)) {
+        goto label__2__continue;
       }
       status = v_status;
       WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(12);
@@ -31149,9 +38740,9 @@ wuffs_gzip__decoder__transform_io(
     label__2__break:;
     {
       WUFFS_BASE__COROUTINE_SUSPENSION_POINT(13);
-      uint32_t t_8;
+      uint32_t t_9;
       if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
-        t_8 = wuffs_base__peek_u32le__no_bounds_check(iop_a_src);
+        t_9 = wuffs_base__peek_u32le__no_bounds_check(iop_a_src);
         iop_a_src += 4;
       } else {
         self->private_data.s_transform_io[0].scratch = 0;
@@ -31162,25 +38753,25 @@ wuffs_gzip__decoder__transform_io(
             goto suspend;
           }
           uint64_t* scratch = &self->private_data.s_transform_io[0].scratch;
-          uint32_t num_bits_8 = ((uint32_t)(*scratch >> 56));
+          uint32_t num_bits_9 = ((uint32_t)(*scratch >> 56));
           *scratch <<= 8;
           *scratch >>= 8;
-          *scratch |= ((uint64_t)(*iop_a_src++)) << num_bits_8;
-          if (num_bits_8 == 24) {
-            t_8 = ((uint32_t)(*scratch));
+          *scratch |= ((uint64_t)(*iop_a_src++)) << num_bits_9;
+          if (num_bits_9 == 24) {
+            t_9 = ((uint32_t)(*scratch));
             break;
           }
-          num_bits_8 += 8;
-          *scratch |= ((uint64_t)(num_bits_8)) << 56;
+          num_bits_9 += 8;
+          *scratch |= ((uint64_t)(num_bits_9)) << 56;
         }
       }
-      v_checksum_want = t_8;
+      v_checksum_want = t_9;
     }
     {
       WUFFS_BASE__COROUTINE_SUSPENSION_POINT(15);
-      uint32_t t_9;
+      uint32_t t_10;
       if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
-        t_9 = wuffs_base__peek_u32le__no_bounds_check(iop_a_src);
+        t_10 = wuffs_base__peek_u32le__no_bounds_check(iop_a_src);
         iop_a_src += 4;
       } else {
         self->private_data.s_transform_io[0].scratch = 0;
@@ -31191,19 +38782,19 @@ wuffs_gzip__decoder__transform_io(
             goto suspend;
           }
           uint64_t* scratch = &self->private_data.s_transform_io[0].scratch;
-          uint32_t num_bits_9 = ((uint32_t)(*scratch >> 56));
+          uint32_t num_bits_10 = ((uint32_t)(*scratch >> 56));
           *scratch <<= 8;
           *scratch >>= 8;
-          *scratch |= ((uint64_t)(*iop_a_src++)) << num_bits_9;
-          if (num_bits_9 == 24) {
-            t_9 = ((uint32_t)(*scratch));
+          *scratch |= ((uint64_t)(*iop_a_src++)) << num_bits_10;
+          if (num_bits_10 == 24) {
+            t_10 = ((uint32_t)(*scratch));
             break;
           }
-          num_bits_9 += 8;
-          *scratch |= ((uint64_t)(num_bits_9)) << 56;
+          num_bits_10 += 8;
+          *scratch |= ((uint64_t)(num_bits_10)) << 56;
         }
       }
-      v_decoded_length_want = t_9;
+      v_decoded_length_want = t_10;
     }
     if ( ! self->private_impl.f_ignore_checksum && ((v_checksum_got != v_checksum_want) || (v_decoded_length_got != v_decoded_length_want))) {
       status = wuffs_base__make_status(wuffs_gzip__error__bad_checksum);
@@ -31239,6 +38830,268 @@ wuffs_gzip__decoder__transform_io(
   return status;
 }
 
+// -------- func gzip.encoder.set_level
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_gzip__encoder__set_level(
+    wuffs_gzip__encoder* self,
+    uint32_t a_level) {
+  if (!self) {
+    return wuffs_base__make_empty_struct();
+  }
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_empty_struct();
+  }
+
+  if ( ! self->private_impl.f_started) {
+    self->private_impl.f_level = wuffs_base__u32__min(a_level, 9);
+    self->private_impl.f_level_is_set = true;
+    wuffs_deflate__encoder__set_level(&self->private_data.f_flate, self->private_impl.f_level);
+  }
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func gzip.encoder.set_quirk_enabled
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_gzip__encoder__set_quirk_enabled(
+    wuffs_gzip__encoder* self,
+    uint32_t a_quirk,
+    bool a_enabled) {
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func gzip.encoder.workbuf_len
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__range_ii_u64
+wuffs_gzip__encoder__workbuf_len(
+    const wuffs_gzip__encoder* self) {
+  if (!self) {
+    return wuffs_base__utility__empty_range_ii_u64();
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return wuffs_base__utility__empty_range_ii_u64();
+  }
+
+  return wuffs_base__utility__make_range_ii_u64(0, 0);
+}
+
+// -------- func gzip.encoder.transform_io
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_gzip__encoder__transform_io(
+    wuffs_gzip__encoder* self,
+    wuffs_base__io_buffer* a_dst,
+    wuffs_base__io_buffer* a_src,
+    wuffs_base__slice_u8 a_workbuf) {
+  if (!self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+  }
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_status(
+        (self->private_impl.magic == WUFFS_BASE__DISABLED)
+        ? wuffs_base__error__disabled_by_previous_error
+        : wuffs_base__error__initialize_not_called);
+  }
+  if (!a_dst || !a_src) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+    return wuffs_base__make_status(wuffs_base__error__bad_argument);
+  }
+  if ((self->private_impl.active_coroutine != 0) &&
+      (self->private_impl.active_coroutine != 1)) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+    return wuffs_base__make_status(wuffs_base__error__interleaved_coroutine_calls);
+  }
+  self->private_impl.active_coroutine = 0;
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  uint32_t v_i = 0;
+  uint8_t v_xfl = 0;
+  uint32_t v_checksum = 0;
+  uint32_t v_length = 0;
+  wuffs_base__status v_status = wuffs_base__make_status(NULL);
+  uint64_t v_mark = 0;
+
+  uint8_t* iop_a_dst = NULL;
+  uint8_t* io0_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io1_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io2_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_dst) {
+    io0_a_dst = a_dst->data.ptr;
+    io1_a_dst = io0_a_dst + a_dst->meta.wi;
+    iop_a_dst = io1_a_dst;
+    io2_a_dst = io0_a_dst + a_dst->data.len;
+    if (a_dst->meta.closed) {
+      io2_a_dst = iop_a_dst;
+    }
+  }
+  const uint8_t* iop_a_src = NULL;
+  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_src) {
+    io0_a_src = a_src->data.ptr;
+    io1_a_src = io0_a_src + a_src->meta.ri;
+    iop_a_src = io1_a_src;
+    io2_a_src = io0_a_src + a_src->meta.wi;
+  }
+
+  uint32_t coro_susp_point = self->private_impl.p_transform_io[0];
+  if (coro_susp_point) {
+    v_i = self->private_data.s_transform_io[0].v_i;
+    v_xfl = self->private_data.s_transform_io[0].v_xfl;
+    v_checksum = self->private_data.s_transform_io[0].v_checksum;
+    v_length = self->private_data.s_transform_io[0].v_length;
+  }
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    if ( ! self->private_impl.f_started) {
+      if ( ! self->private_impl.f_level_is_set) {
+        wuffs_gzip__encoder__set_level(self, 6);
+      }
+      self->private_impl.f_started = true;
+    }
+    self->private_data.s_transform_io[0].scratch = 31;
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+    if (iop_a_dst == io2_a_dst) {
+      status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+      goto suspend;
+    }
+    *iop_a_dst++ = ((uint8_t)(self->private_data.s_transform_io[0].scratch));
+    self->private_data.s_transform_io[0].scratch = 139;
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+    if (iop_a_dst == io2_a_dst) {
+      status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+      goto suspend;
+    }
+    *iop_a_dst++ = ((uint8_t)(self->private_data.s_transform_io[0].scratch));
+    self->private_data.s_transform_io[0].scratch = 8;
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+    if (iop_a_dst == io2_a_dst) {
+      status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+      goto suspend;
+    }
+    *iop_a_dst++ = ((uint8_t)(self->private_data.s_transform_io[0].scratch));
+    self->private_data.s_transform_io[0].scratch = 0;
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
+    if (iop_a_dst == io2_a_dst) {
+      status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+      goto suspend;
+    }
+    *iop_a_dst++ = ((uint8_t)(self->private_data.s_transform_io[0].scratch));
+    v_i = 0;
+    while (v_i < 4) {
+      self->private_data.s_transform_io[0].scratch = 0;
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(5);
+      if (iop_a_dst == io2_a_dst) {
+        status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+        goto suspend;
+      }
+      *iop_a_dst++ = ((uint8_t)(self->private_data.s_transform_io[0].scratch));
+      v_i += 1;
+    }
+    if (self->private_impl.f_level >= 8) {
+      v_xfl = 2;
+    } else if (self->private_impl.f_level <= 1) {
+      v_xfl = 4;
+    }
+    self->private_data.s_transform_io[0].scratch = v_xfl;
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(6);
+    if (iop_a_dst == io2_a_dst) {
+      status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+      goto suspend;
+    }
+    *iop_a_dst++ = ((uint8_t)(self->private_data.s_transform_io[0].scratch));
+    self->private_data.s_transform_io[0].scratch = 255;
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(7);
+    if (iop_a_dst == io2_a_dst) {
+      status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+      goto suspend;
+    }
+    *iop_a_dst++ = ((uint8_t)(self->private_data.s_transform_io[0].scratch));
+    while (true) {
+      v_mark = ((uint64_t)(iop_a_src - io0_a_src));
+      {
+        if (a_dst) {
+          a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+        }
+        if (a_src) {
+          a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+        }
+        wuffs_base__status t_0 = wuffs_deflate__encoder__transform_io(&self->private_data.f_flate, a_dst, a_src, a_workbuf);
+        v_status = t_0;
+        if (a_dst) {
+          iop_a_dst = a_dst->data.ptr + a_dst->meta.wi;
+        }
+        if (a_src) {
+          iop_a_src = a_src->data.ptr + a_src->meta.ri;
+        }
+      }
+      v_checksum = wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_checksum, wuffs_base__io__since(v_mark, ((uint64_t)(iop_a_src - io0_a_src)), io0_a_src));
+      v_length += ((uint32_t)((wuffs_base__io__count_since(v_mark, ((uint64_t)(iop_a_src - io0_a_src))) & 4294967295)));
+      if (wuffs_base__status__is_ok(&v_status)) {
+        goto label__0__break;
+      }
+      status = v_status;
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(8);
+    }
+    label__0__break:;
+    v_i = 0;
+    while (v_i < 4) {
+      self->private_data.s_transform_io[0].scratch = ((uint8_t)((v_checksum & 255)));
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(9);
+      if (iop_a_dst == io2_a_dst) {
+        status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+        goto suspend;
+      }
+      *iop_a_dst++ = ((uint8_t)(self->private_data.s_transform_io[0].scratch));
+      v_checksum >>= 8;
+      v_i += 1;
+    }
+    v_i = 0;
+    while (v_i < 4) {
+      self->private_data.s_transform_io[0].scratch = ((uint8_t)((v_length & 255)));
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(10);
+      if (iop_a_dst == io2_a_dst) {
+        status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+        goto suspend;
+      }
+      *iop_a_dst++ = ((uint8_t)(self->private_data.s_transform_io[0].scratch));
+      v_length >>= 8;
+      v_i += 1;
+    }
+
+    ok:
+    self->private_impl.p_transform_io[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_transform_io[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+  self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 1 : 0;
+  self->private_data.s_transform_io[0].v_i = v_i;
+  self->private_data.s_transform_io[0].v_xfl = v_xfl;
+  self->private_data.s_transform_io[0].v_checksum = v_checksum;
+  self->private_data.s_transform_io[0].v_length = v_length;
+
+  goto exit;
+  exit:
+  if (a_dst) {
+    a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+  }
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  }
+
+  if (wuffs_base__status__is_error(&status)) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+  }
+  return status;
+}
+
 #endif  // !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__GZIP)
 
 #if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__JSON)
@@ -34317,6 +42170,14 @@ const char wuffs_zlib__error__incorrect_dictionary[] = "#zlib: incorrect diction
 
 // ---------------- Private Consts
 
+#define WUFFS_ZLIB__FUSED_CHECKSUM_LENGTH 131072
+
+static const uint16_t
+WUFFS_ZLIB__HEADERS[10] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  30721, 30721, 30814, 30814, 30814, 30814, 30876, 30938,
+  30938, 30938,
+};
+
 // ---------------- Private Initializer Prototypes
 
 // ---------------- Private Function Prototypes
@@ -34335,6 +42196,18 @@ wuffs_zlib__decoder__func_ptrs_for__wuffs_base__io_transformer = {
   (wuffs_base__range_ii_u64(*)(const void*))(&wuffs_zlib__decoder__workbuf_len),
 };
 
+const wuffs_base__io_transformer__func_ptrs
+wuffs_zlib__encoder__func_ptrs_for__wuffs_base__io_transformer = {
+  (wuffs_base__empty_struct(*)(void*,
+      uint32_t,
+      bool))(&wuffs_zlib__encoder__set_quirk_enabled),
+  (wuffs_base__status(*)(void*,
+      wuffs_base__io_buffer*,
+      wuffs_base__io_buffer*,
+      wuffs_base__slice_u8))(&wuffs_zlib__encoder__transform_io),
+  (wuffs_base__range_ii_u64(*)(const void*))(&wuffs_zlib__encoder__workbuf_len),
+};
+
 // ---------------- Initializer Implementations
 
 wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
@@ -34425,6 +42298,87 @@ sizeof__wuffs_zlib__decoder() {
   return sizeof(wuffs_zlib__decoder);
 }
 
+wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
+wuffs_zlib__encoder__initialize(
+    wuffs_zlib__encoder* self,
+    size_t sizeof_star_self,
+    uint64_t wuffs_version,
+    uint32_t options){
+  if (!self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+  }
+  if (sizeof(*self) != sizeof_star_self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_sizeof_receiver);
+  }
+  if (((wuffs_version >> 32) != WUFFS_VERSION_MAJOR) ||
+      (((wuffs_version >> 16) & 0xFFFF) > WUFFS_VERSION_MINOR)) {
+    return wuffs_base__make_status(wuffs_base__error__bad_wuffs_version);
+  }
+
+  if ((options & WUFFS_INITIALIZE__ALREADY_ZEROED) != 0) {
+    // The whole point of this if-check is to detect an uninitialized *self.
+    // We disable the warning on GCC. Clang-5.0 does not have this warning.
+#if !defined(__clang__) && defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+    if (self->private_impl.magic != 0) {
+      return wuffs_base__make_status(wuffs_base__error__initialize_falsely_claimed_already_zeroed);
+    }
+#if !defined(__clang__) && defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+  } else {
+    if ((options & WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED) == 0) {
+      memset(self, 0, sizeof(*self));
+      options |= WUFFS_INITIALIZE__ALREADY_ZEROED;
+    } else {
+      memset(&(self->private_impl), 0, sizeof(self->private_impl));
+    }
+  }
+
+  {
+    wuffs_base__status z = wuffs_adler32__hasher__initialize(
+        &self->private_data.f_checksum, sizeof(self->private_data.f_checksum), WUFFS_VERSION, options);
+    if (z.repr) {
+      return z;
+    }
+  }
+  {
+    wuffs_base__status z = wuffs_deflate__encoder__initialize(
+        &self->private_data.f_flate, sizeof(self->private_data.f_flate), WUFFS_VERSION, options);
+    if (z.repr) {
+      return z;
+    }
+  }
+  self->private_impl.magic = WUFFS_BASE__MAGIC;
+  self->private_impl.vtable_for__wuffs_base__io_transformer.vtable_name =
+      wuffs_base__io_transformer__vtable_name;
+  self->private_impl.vtable_for__wuffs_base__io_transformer.function_pointers =
+      (const void*)(&wuffs_zlib__encoder__func_ptrs_for__wuffs_base__io_transformer);
+  return wuffs_base__make_status(NULL);
+}
+
+wuffs_zlib__encoder*
+wuffs_zlib__encoder__alloc() {
+  wuffs_zlib__encoder* x =
+      (wuffs_zlib__encoder*)(calloc(sizeof(wuffs_zlib__encoder), 1));
+  if (!x) {
+    return NULL;
+  }
+  if (wuffs_zlib__encoder__initialize(
+      x, sizeof(wuffs_zlib__encoder), WUFFS_VERSION, WUFFS_INITIALIZE__ALREADY_ZEROED).repr) {
+    free(x);
+    return NULL;
+  }
+  return x;
+}
+
+size_t
+sizeof__wuffs_zlib__encoder() {
+  return sizeof(wuffs_zlib__encoder);
+}
+
 // ---------------- Function Implementations
 
 // -------- func zlib.decoder.dictionary_id
@@ -34482,6 +42436,8 @@ wuffs_zlib__decoder__set_quirk_enabled(
 
   if (a_quirk == 1) {
     self->private_impl.f_ignore_checksum = a_enabled;
+  } else {
+    wuffs_deflate__decoder__set_quirk_enabled(&self->private_data.f_flate, a_quirk, a_enabled);
   }
   return wuffs_base__make_empty_struct();
 }
@@ -34660,29 +42616,61 @@ wuffs_zlib__decoder__transform_io(
       goto ok;
     }
     self->private_impl.f_header_complete = true;
+    label__0__continue:;
     while (true) {
       v_mark = ((uint64_t)(iop_a_dst - io0_a_dst));
-      {
-        if (a_dst) {
-          a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
-        }
-        if (a_src) {
-          a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
-        }
-        wuffs_base__status t_2 = wuffs_deflate__decoder__transform_io(&self->private_data.f_flate, a_dst, a_src, a_workbuf);
-        v_status = t_2;
-        if (a_dst) {
-          iop_a_dst = a_dst->data.ptr + a_dst->meta.wi;
+      if (self->private_impl.f_ignore_checksum) {
+        {
+          if (a_dst) {
+            a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+          }
+          if (a_src) {
+            a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+          }
+          wuffs_base__status t_2 = wuffs_deflate__decoder__transform_io(&self->private_data.f_flate, a_dst, a_src, a_workbuf);
+          v_status = t_2;
+          if (a_dst) {
+            iop_a_dst = a_dst->data.ptr + a_dst->meta.wi;
+          }
+          if (a_src) {
+            iop_a_src = a_src->data.ptr + a_src->meta.ri;
+          }
         }
-        if (a_src) {
-          iop_a_src = a_src->data.ptr + a_src->meta.ri;
+      } else {
+        {
+          uint8_t *o_0_io2_a_dst = io2_a_dst;
+          wuffs_base__io_writer__limit(&io2_a_dst, iop_a_dst,
+              131072);
+          if (a_dst) {
+            a_dst->data.len = ((size_t)(io2_a_dst - a_dst->data.ptr));
+          }
+          {
+            if (a_dst) {
+              a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+            }
+            if (a_src) {
+              a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+            }
+            wuffs_base__status t_3 = wuffs_deflate__decoder__transform_io(&self->private_data.f_flate, a_dst, a_src, a_workbuf);
+            v_status = t_3;
+            if (a_dst) {
+              iop_a_dst = a_dst->data.ptr + a_dst->meta.wi;
+            }
+            if (a_src) {
+              iop_a_src = a_src->data.ptr + a_src->meta.ri;
+            }
+          }
+          io2_a_dst = o_0_io2_a_dst;
+          if (a_dst) {
+            a_dst->data.len = ((size_t)(io2_a_dst - a_dst->data.ptr));
+          }
         }
-      }
-      if ( ! self->private_impl.f_ignore_checksum) {
         v_checksum_got = wuffs_adler32__hasher__update_u32(&self->private_data.f_checksum, wuffs_base__io__since(v_mark, ((uint64_t)(iop_a_dst - io0_a_dst)), io0_a_dst));
       }
       if (wuffs_base__status__is_ok(&v_status)) {
         goto label__0__break;
+      } else if ((v_status.repr == wuffs_base__suspension__short_write) && (((uint64_t)(io2_a_dst - iop_a_dst)) > 0) && (wuffs_base__io__count_since(v_mark, ((uint64_t)(iop_a_dst - io0_a_dst))) >= 32768)) {
+        goto label__0__continue;
       }
       status = v_status;
       WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(5);
@@ -34690,9 +42678,9 @@ wuffs_zlib__decoder__transform_io(
     label__0__break:;
     {
       WUFFS_BASE__COROUTINE_SUSPENSION_POINT(6);
-      uint32_t t_3;
+      uint32_t t_4;
       if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
-        t_3 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
+        t_4 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
         iop_a_src += 4;
       } else {
         self->private_data.s_transform_io[0].scratch = 0;
@@ -34703,19 +42691,19 @@ wuffs_zlib__decoder__transform_io(
             goto suspend;
           }
           uint64_t* scratch = &self->private_data.s_transform_io[0].scratch;
-          uint32_t num_bits_3 = ((uint32_t)(*scratch & 0xFF));
+          uint32_t num_bits_4 = ((uint32_t)(*scratch & 0xFF));
           *scratch >>= 8;
           *scratch <<= 8;
-          *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_3);
-          if (num_bits_3 == 24) {
-            t_3 = ((uint32_t)(*scratch >> 32));
+          *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_4);
+          if (num_bits_4 == 24) {
+            t_4 = ((uint32_t)(*scratch >> 32));
             break;
           }
-          num_bits_3 += 8;
-          *scratch |= ((uint64_t)(num_bits_3));
+          num_bits_4 += 8;
+          *scratch |= ((uint64_t)(num_bits_4));
         }
       }
-      v_checksum_want = t_3;
+      v_checksum_want = t_4;
     }
     if ( ! self->private_impl.f_ignore_checksum && (v_checksum_got != v_checksum_want)) {
       status = wuffs_base__make_status(wuffs_zlib__error__bad_checksum);
@@ -34748,12 +42736,226 @@ wuffs_zlib__decoder__transform_io(
   return status;
 }
 
+// -------- func zlib.encoder.set_level
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_zlib__encoder__set_level(
+    wuffs_zlib__encoder* self,
+    uint32_t a_level) {
+  if (!self) {
+    return wuffs_base__make_empty_struct();
+  }
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_empty_struct();
+  }
+
+  if ( ! self->private_impl.f_started) {
+    self->private_impl.f_level = wuffs_base__u32__min(a_level, 9);
+    self->private_impl.f_level_is_set = true;
+    wuffs_deflate__encoder__set_level(&self->private_data.f_flate, self->private_impl.f_level);
+  }
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func zlib.encoder.set_quirk_enabled
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_zlib__encoder__set_quirk_enabled(
+    wuffs_zlib__encoder* self,
+    uint32_t a_quirk,
+    bool a_enabled) {
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func zlib.encoder.workbuf_len
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__range_ii_u64
+wuffs_zlib__encoder__workbuf_len(
+    const wuffs_zlib__encoder* self) {
+  if (!self) {
+    return wuffs_base__utility__empty_range_ii_u64();
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return wuffs_base__utility__empty_range_ii_u64();
+  }
+
+  return wuffs_base__utility__make_range_ii_u64(0, 0);
+}
+
+// -------- func zlib.encoder.transform_io
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_zlib__encoder__transform_io(
+    wuffs_zlib__encoder* self,
+    wuffs_base__io_buffer* a_dst,
+    wuffs_base__io_buffer* a_src,
+    wuffs_base__slice_u8 a_workbuf) {
+  if (!self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+  }
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_status(
+        (self->private_impl.magic == WUFFS_BASE__DISABLED)
+        ? wuffs_base__error__disabled_by_previous_error
+        : wuffs_base__error__initialize_not_called);
+  }
+  if (!a_dst || !a_src) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+    return wuffs_base__make_status(wuffs_base__error__bad_argument);
+  }
+  if ((self->private_impl.active_coroutine != 0) &&
+      (self->private_impl.active_coroutine != 1)) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+    return wuffs_base__make_status(wuffs_base__error__interleaved_coroutine_calls);
+  }
+  self->private_impl.active_coroutine = 0;
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  uint32_t v_checksum = 0;
+  wuffs_base__status v_status = wuffs_base__make_status(NULL);
+  uint64_t v_mark = 0;
+
+  uint8_t* iop_a_dst = NULL;
+  uint8_t* io0_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io1_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io2_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_dst) {
+    io0_a_dst = a_dst->data.ptr;
+    io1_a_dst = io0_a_dst + a_dst->meta.wi;
+    iop_a_dst = io1_a_dst;
+    io2_a_dst = io0_a_dst + a_dst->data.len;
+    if (a_dst->meta.closed) {
+      io2_a_dst = iop_a_dst;
+    }
+  }
+  const uint8_t* iop_a_src = NULL;
+  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_src) {
+    io0_a_src = a_src->data.ptr;
+    io1_a_src = io0_a_src + a_src->meta.ri;
+    iop_a_src = io1_a_src;
+    io2_a_src = io0_a_src + a_src->meta.wi;
+  }
+
+  uint32_t coro_susp_point = self->private_impl.p_transform_io[0];
+  if (coro_susp_point) {
+    v_checksum = self->private_data.s_transform_io[0].v_checksum;
+  }
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    if ( ! self->private_impl.f_started) {
+      if ( ! self->private_impl.f_level_is_set) {
+        wuffs_zlib__encoder__set_level(self, 6);
+      }
+      self->private_impl.f_started = true;
+    }
+    self->private_data.s_transform_io[0].scratch = ((uint8_t)((WUFFS_ZLIB__HEADERS[self->private_impl.f_level] >> 8)));
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+    if (iop_a_dst == io2_a_dst) {
+      status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+      goto suspend;
+    }
+    *iop_a_dst++ = ((uint8_t)(self->private_data.s_transform_io[0].scratch));
+    self->private_data.s_transform_io[0].scratch = ((uint8_t)((WUFFS_ZLIB__HEADERS[self->private_impl.f_level] & 255)));
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+    if (iop_a_dst == io2_a_dst) {
+      status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+      goto suspend;
+    }
+    *iop_a_dst++ = ((uint8_t)(self->private_data.s_transform_io[0].scratch));
+    v_checksum = 1;
+    while (true) {
+      v_mark = ((uint64_t)(iop_a_src - io0_a_src));
+      {
+        if (a_dst) {
+          a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+        }
+        if (a_src) {
+          a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+        }
+        wuffs_base__status t_0 = wuffs_deflate__encoder__transform_io(&self->private_data.f_flate, a_dst, a_src, a_workbuf);
+        v_status = t_0;
+        if (a_dst) {
+          iop_a_dst = a_dst->data.ptr + a_dst->meta.wi;
+        }
+        if (a_src) {
+          iop_a_src = a_src->data.ptr + a_src->meta.ri;
+        }
+      }
+      v_checksum = wuffs_adler32__hasher__update_u32(&self->private_data.f_checksum, wuffs_base__io__since(v_mark, ((uint64_t)(iop_a_src - io0_a_src)), io0_a_src));
+      if (wuffs_base__status__is_ok(&v_status)) {
+        goto label__0__break;
+      }
+      status = v_status;
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(3);
+    }
+    label__0__break:;
+    self->private_data.s_transform_io[0].scratch = ((uint8_t)((v_checksum >> 24)));
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
+    if (iop_a_dst == io2_a_dst) {
+      status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+      goto suspend;
+    }
+    *iop_a_dst++ = ((uint8_t)(self->private_data.s_transform_io[0].scratch));
+    self->private_data.s_transform_io[0].scratch = ((uint8_t)(((v_checksum >> 16) & 255)));
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(5);
+    if (iop_a_dst == io2_a_dst) {
+      status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+      goto suspend;
+    }
+    *iop_a_dst++ = ((uint8_t)(self->private_data.s_transform_io[0].scratch));
+    self->private_data.s_transform_io[0].scratch = ((uint8_t)(((v_checksum >> 8) & 255)));
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(6);
+    if (iop_a_dst == io2_a_dst) {
+      status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+      goto suspend;
+    }
+    *iop_a_dst++ = ((uint8_t)(self->private_data.s_transform_io[0].scratch));
+    self->private_data.s_transform_io[0].scratch = ((uint8_t)((v_checksum & 255)));
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(7);
+    if (iop_a_dst == io2_a_dst) {
+      status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+      goto suspend;
+    }
+    *iop_a_dst++ = ((uint8_t)(self->private_data.s_transform_io[0].scratch));
+
+    ok:
+    self->private_impl.p_transform_io[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_transform_io[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+  self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 1 : 0;
+  self->private_data.s_transform_io[0].v_checksum = v_checksum;
+
+  goto exit;
+  exit:
+  if (a_dst) {
+    a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+  }
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  }
+
+  if (wuffs_base__status__is_error(&status)) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+  }
+  return status;
+}
+
 #endif  // !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__ZLIB)
 
 #if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__PNG)
 
 // ---------------- Status Codes Implementations
 
+const char wuffs_png__error__bad_animation_sequence_number[] = "#png: bad animation sequence number";
 const char wuffs_png__error__bad_checksum[] = "#png: bad checksum";
 const char wuffs_png__error__bad_chunk[] = "#png: bad chunk";
 const char wuffs_png__error__bad_filter[] = "#png: bad filter";
@@ -34762,9 +42964,12 @@ const char wuffs_png__error__missing_palette[] = "#png: missing palette";
 const char wuffs_png__error__unsupported_png_file[] = "#png: unsupported PNG file";
 const char wuffs_png__error__internal_error_inconsistent_workbuf_length[] = "#png: internal error: inconsistent workbuf length";
 const char wuffs_png__error__internal_error_zlib_decoder_did_not_exhaust_its_input[] = "#png: internal error: zlib decoder did not exhaust its input";
+const char wuffs_png__error__unsupported_image_dimensions[] = "#png: unsupported image dimensions";
 
 // ---------------- Private Consts
 
+#define WUFFS_PNG__STRIP_LENGTH_MAX 32768
+
 static const uint8_t
 WUFFS_PNG__INTERLACING[8][6] WUFFS_BASE__POTENTIALLY_UNUSED = {
   {
@@ -34801,6 +43006,16 @@ WUFFS_PNG__NUM_CHANNELS[8] WUFFS_BASE__POTENTIALLY_UNUSED = {
   1, 0, 3, 1, 2, 0, 4, 0,
 };
 
+#define WUFFS_PNG__ENCODER_ROW_PADDING 16
+
+#define WUFFS_PNG__IDAT_LENGTH_MAX 32768
+
+static const uint8_t
+WUFFS_PNG__ZLIB_FLGS[10] WUFFS_BASE__POTENTIALLY_UNUSED = {
+  1, 1, 94, 94, 94, 94, 156, 218,
+  218, 218,
+};
+
 // ---------------- Private Initializer Prototypes
 
 // ---------------- Private Function Prototypes
@@ -34856,6 +43071,11 @@ wuffs_png__decoder__filter_1_distance_4_fallback(
     wuffs_png__decoder* self,
     wuffs_base__slice_u8 a_curr);
 
+static wuffs_base__empty_struct
+wuffs_png__decoder__filter_1_distance_6_fallback(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_curr);
+
 static wuffs_base__empty_struct
 wuffs_png__decoder__filter_2(
     wuffs_png__decoder* self,
@@ -34917,6 +43137,13 @@ wuffs_png__decoder__filter_1_distance_4_x86_sse42(
     wuffs_base__slice_u8 a_curr);
 #endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
 
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+static wuffs_base__empty_struct
+wuffs_png__decoder__filter_1_distance_8_x86_sse42(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_curr);
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
 static wuffs_base__empty_struct
 wuffs_png__decoder__filter_3_distance_4_x86_sse42(
@@ -34925,6 +43152,22 @@ wuffs_png__decoder__filter_3_distance_4_x86_sse42(
     wuffs_base__slice_u8 a_prev);
 #endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
 
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+static wuffs_base__empty_struct
+wuffs_png__decoder__filter_3_distance_6_x86_sse42(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_curr,
+    wuffs_base__slice_u8 a_prev);
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+static wuffs_base__empty_struct
+wuffs_png__decoder__filter_3_distance_8_x86_sse42(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_curr,
+    wuffs_base__slice_u8 a_prev);
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+
 #if defined(WUFFS_BASE__CPU_ARCH__X86_64)
 static wuffs_base__empty_struct
 wuffs_png__decoder__filter_4_distance_3_x86_sse42(
@@ -34941,6 +43184,22 @@ wuffs_png__decoder__filter_4_distance_4_x86_sse42(
     wuffs_base__slice_u8 a_prev);
 #endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
 
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+static wuffs_base__empty_struct
+wuffs_png__decoder__filter_4_distance_6_x86_sse42(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_curr,
+    wuffs_base__slice_u8 a_prev);
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+static wuffs_base__empty_struct
+wuffs_png__decoder__filter_4_distance_8_x86_sse42(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_curr,
+    wuffs_base__slice_u8 a_prev);
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+
 static wuffs_base__status
 wuffs_png__decoder__decode_ihdr(
     wuffs_png__decoder* self,
@@ -34959,11 +43218,25 @@ static wuffs_base__empty_struct
 wuffs_png__decoder__choose_filter_implementations(
     wuffs_png__decoder* self);
 
+static uint32_t
+wuffs_png__decoder__reported_metadata_fourcc(
+    const wuffs_png__decoder* self);
+
 static wuffs_base__status
 wuffs_png__decoder__decode_other_chunk(
     wuffs_png__decoder* self,
     wuffs_base__io_buffer* a_src);
 
+static wuffs_base__status
+wuffs_png__decoder__decode_actl(
+    wuffs_png__decoder* self,
+    wuffs_base__io_buffer* a_src);
+
+static wuffs_base__status
+wuffs_png__decoder__decode_fctl(
+    wuffs_png__decoder* self,
+    wuffs_base__io_buffer* a_src);
+
 static wuffs_base__status
 wuffs_png__decoder__decode_plte(
     wuffs_png__decoder* self,
@@ -34974,30 +43247,218 @@ wuffs_png__decoder__decode_trns(
     wuffs_png__decoder* self,
     wuffs_base__io_buffer* a_src);
 
+static wuffs_base__status
+wuffs_png__decoder__skip_frame(
+    wuffs_png__decoder* self,
+    wuffs_base__io_buffer* a_src);
+
+static wuffs_base__status
+wuffs_png__decoder__skip_data_chunks(
+    wuffs_png__decoder* self,
+    wuffs_base__io_buffer* a_src);
+
+static wuffs_base__status
+wuffs_png__decoder__decode_up_to_fdat(
+    wuffs_png__decoder* self,
+    wuffs_base__io_buffer* a_src);
+
+static wuffs_base__status
+wuffs_png__decoder__read_data_chunk_header(
+    wuffs_png__decoder* self,
+    wuffs_base__io_buffer* a_src);
+
 static wuffs_base__status
 wuffs_png__decoder__decode_pass(
     wuffs_png__decoder* self,
+    wuffs_base__pixel_buffer* a_dst,
     wuffs_base__io_buffer* a_src,
     wuffs_base__slice_u8 a_workbuf);
 
+static bool
+wuffs_png__decoder__is_past_roi(
+    const wuffs_png__decoder* self);
+
 static wuffs_base__status
 wuffs_png__decoder__filter_and_swizzle(
     wuffs_png__decoder* self,
     wuffs_base__pixel_buffer* a_dst,
-    wuffs_base__slice_u8 a_workbuf);
+    wuffs_base__slice_u8 a_prev,
+    wuffs_base__slice_u8 a_workbuf,
+    wuffs_base__slice_u8 a_downscale);
 
 static wuffs_base__status
 wuffs_png__decoder__filter_and_swizzle__choosy_default(
     wuffs_png__decoder* self,
     wuffs_base__pixel_buffer* a_dst,
-    wuffs_base__slice_u8 a_workbuf);
+    wuffs_base__slice_u8 a_prev,
+    wuffs_base__slice_u8 a_workbuf,
+    wuffs_base__slice_u8 a_downscale);
 
 static wuffs_base__status
 wuffs_png__decoder__filter_and_swizzle_tricky(
     wuffs_png__decoder* self,
     wuffs_base__pixel_buffer* a_dst,
+    wuffs_base__slice_u8 a_prev,
+    wuffs_base__slice_u8 a_workbuf,
+    wuffs_base__slice_u8 a_downscale);
+
+static uint64_t
+wuffs_png__decoder__unpack_bits(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_src,
+    uint8_t a_multiplier);
+
+static uint64_t
+wuffs_png__decoder__unpack_bits__choosy_default(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_src,
+    uint8_t a_multiplier);
+
+static uint64_t
+wuffs_png__decoder__unpack_group(
+    const wuffs_png__decoder* self,
+    uint64_t a_packed,
+    uint8_t a_multiplier);
+
+static wuffs_base__empty_struct
+wuffs_png__decoder__put_pixel(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_dst_palette,
+    wuffs_base__slice_u8 a_src);
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+static uint64_t
+wuffs_png__decoder__unpack_bits_x86_sse42(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_src,
+    uint8_t a_multiplier);
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+
+static wuffs_base__empty_struct
+wuffs_png__encoder__filter_row(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_curr,
+    wuffs_base__slice_u8 a_prev);
+
+static wuffs_base__empty_struct
+wuffs_png__encoder__accumulate_costs(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_x,
+    wuffs_base__slice_u8 a_a,
+    wuffs_base__slice_u8 a_b,
+    wuffs_base__slice_u8 a_c);
+
+static wuffs_base__empty_struct
+wuffs_png__encoder__accumulate_costs__choosy_default(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_x,
+    wuffs_base__slice_u8 a_a,
+    wuffs_base__slice_u8 a_b,
+    wuffs_base__slice_u8 a_c);
+
+static wuffs_base__empty_struct
+wuffs_png__encoder__write_residuals(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_x,
+    wuffs_base__slice_u8 a_a,
+    wuffs_base__slice_u8 a_b,
+    wuffs_base__slice_u8 a_c,
+    uint32_t a_filter);
+
+static wuffs_base__empty_struct
+wuffs_png__encoder__write_residuals__choosy_default(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_x,
+    wuffs_base__slice_u8 a_a,
+    wuffs_base__slice_u8 a_b,
+    wuffs_base__slice_u8 a_c,
+    uint32_t a_filter);
+
+static wuffs_base__empty_struct
+wuffs_png__encoder__accumulate_costs_fallback(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_x,
+    wuffs_base__slice_u8 a_a,
+    wuffs_base__slice_u8 a_b,
+    wuffs_base__slice_u8 a_c);
+
+static wuffs_base__empty_struct
+wuffs_png__encoder__write_residuals_fallback(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_x,
+    wuffs_base__slice_u8 a_a,
+    wuffs_base__slice_u8 a_b,
+    wuffs_base__slice_u8 a_c,
+    uint32_t a_filter);
+
+static uint32_t
+wuffs_png__encoder__paeth(
+    const wuffs_png__encoder* self,
+    uint32_t a_a,
+    uint32_t a_b,
+    uint32_t a_c);
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+static wuffs_base__empty_struct
+wuffs_png__encoder__accumulate_costs_x86_sse42(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_x,
+    wuffs_base__slice_u8 a_a,
+    wuffs_base__slice_u8 a_b,
+    wuffs_base__slice_u8 a_c);
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+static wuffs_base__empty_struct
+wuffs_png__encoder__write_residuals_x86_sse42(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_x,
+    wuffs_base__slice_u8 a_a,
+    wuffs_base__slice_u8 a_b,
+    wuffs_base__slice_u8 a_c,
+    uint32_t a_filter);
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+
+static wuffs_base__status
+wuffs_png__encoder__start_rows(
+    wuffs_png__encoder* self,
+    wuffs_base__pixel_buffer* a_src,
+    uint32_t a_y0,
+    wuffs_base__slice_u8 a_workbuf);
+
+static wuffs_base__empty_struct
+wuffs_png__encoder__zero(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_s);
+
+static wuffs_base__status
+wuffs_png__encoder__encode_rows(
+    wuffs_png__encoder* self,
+    wuffs_base__io_buffer* a_dst,
+    wuffs_base__pixel_buffer* a_src,
+    uint32_t a_y1,
+    bool a_full_flush,
     wuffs_base__slice_u8 a_workbuf);
 
+static wuffs_base__status
+wuffs_png__encoder__write_buf(
+    wuffs_png__encoder* self,
+    wuffs_base__io_buffer* a_dst);
+
+static wuffs_base__status
+wuffs_png__encoder__write_idat(
+    wuffs_png__encoder* self,
+    wuffs_base__io_buffer* a_dst);
+
 // ---------------- VTables
 
 const wuffs_base__image_decoder__func_ptrs
@@ -35079,6 +43540,7 @@ wuffs_png__decoder__initialize(
   self->private_impl.choosy_filter_3 = &wuffs_png__decoder__filter_3__choosy_default;
   self->private_impl.choosy_filter_4 = &wuffs_png__decoder__filter_4__choosy_default;
   self->private_impl.choosy_filter_and_swizzle = &wuffs_png__decoder__filter_and_swizzle__choosy_default;
+  self->private_impl.choosy_unpack_bits = &wuffs_png__decoder__unpack_bits__choosy_default;
 
   {
     wuffs_base__status z = wuffs_crc32__ieee_hasher__initialize(
@@ -35122,44 +43584,131 @@ sizeof__wuffs_png__decoder() {
   return sizeof(wuffs_png__decoder);
 }
 
-// ---------------- Function Implementations
+wuffs_base__status WUFFS_BASE__WARN_UNUSED_RESULT
+wuffs_png__encoder__initialize(
+    wuffs_png__encoder* self,
+    size_t sizeof_star_self,
+    uint64_t wuffs_version,
+    uint32_t options){
+  if (!self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+  }
+  if (sizeof(*self) != sizeof_star_self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_sizeof_receiver);
+  }
+  if (((wuffs_version >> 32) != WUFFS_VERSION_MAJOR) ||
+      (((wuffs_version >> 16) & 0xFFFF) > WUFFS_VERSION_MINOR)) {
+    return wuffs_base__make_status(wuffs_base__error__bad_wuffs_version);
+  }
 
-// ‼ WUFFS MULTI-FILE SECTION +arm_neon
-// -------- func png.decoder.filter_1_distance_4_arm_neon
+  if ((options & WUFFS_INITIALIZE__ALREADY_ZEROED) != 0) {
+    // The whole point of this if-check is to detect an uninitialized *self.
+    // We disable the warning on GCC. Clang-5.0 does not have this warning.
+#if !defined(__clang__) && defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+    if (self->private_impl.magic != 0) {
+      return wuffs_base__make_status(wuffs_base__error__initialize_falsely_claimed_already_zeroed);
+    }
+#if !defined(__clang__) && defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+  } else {
+    if ((options & WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED) == 0) {
+      memset(self, 0, sizeof(*self));
+      options |= WUFFS_INITIALIZE__ALREADY_ZEROED;
+    } else {
+      memset(&(self->private_impl), 0, sizeof(self->private_impl));
+    }
+  }
 
-#if defined(WUFFS_BASE__CPU_ARCH__ARM_NEON)
-static wuffs_base__empty_struct
-wuffs_png__decoder__filter_1_distance_4_arm_neon(
-    wuffs_png__decoder* self,
-    wuffs_base__slice_u8 a_curr) {
-  wuffs_base__slice_u8 v_curr = {0};
-  uint8x8_t v_fa = {0};
-  uint8x8_t v_fx = {0};
+  self->private_impl.choosy_accumulate_costs = &wuffs_png__encoder__accumulate_costs__choosy_default;
+  self->private_impl.choosy_write_residuals = &wuffs_png__encoder__write_residuals__choosy_default;
 
   {
-    wuffs_base__slice_u8 i_slice_curr = a_curr;
-    v_curr.ptr = i_slice_curr.ptr;
-    v_curr.len = 4;
-    uint8_t* i_end0_curr = v_curr.ptr + (((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)) / 8) * 8);
-    while (v_curr.ptr < i_end0_curr) {
-      v_fx = vreinterpret_u8_u32(vdup_n_u32(wuffs_base__peek_u32le__no_bounds_check(v_curr.ptr)));
-      v_fx = vadd_u8(v_fx, v_fa);
-      wuffs_base__poke_u32le__no_bounds_check(v_curr.ptr, vget_lane_u32(vreinterpret_u32_u8(v_fx), 0));
-      v_fa = v_fx;
-      v_curr.ptr += 4;
-      v_fx = vreinterpret_u8_u32(vdup_n_u32(wuffs_base__peek_u32le__no_bounds_check(v_curr.ptr)));
-      v_fx = vadd_u8(v_fx, v_fa);
-      wuffs_base__poke_u32le__no_bounds_check(v_curr.ptr, vget_lane_u32(vreinterpret_u32_u8(v_fx), 0));
-      v_fa = v_fx;
-      v_curr.ptr += 4;
+    wuffs_base__status z = wuffs_adler32__hasher__initialize(
+        &self->private_data.f_adler32, sizeof(self->private_data.f_adler32), WUFFS_VERSION, options);
+    if (z.repr) {
+      return z;
     }
-    v_curr.len = 4;
-    uint8_t* i_end1_curr = v_curr.ptr + (((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)) / 4) * 4);
-    while (v_curr.ptr < i_end1_curr) {
-      v_fx = vreinterpret_u8_u32(vdup_n_u32(wuffs_base__peek_u32le__no_bounds_check(v_curr.ptr)));
-      v_fx = vadd_u8(v_fx, v_fa);
-      wuffs_base__poke_u32le__no_bounds_check(v_curr.ptr, vget_lane_u32(vreinterpret_u32_u8(v_fx), 0));
-      v_fa = v_fx;
+  }
+  {
+    wuffs_base__status z = wuffs_crc32__ieee_hasher__initialize(
+        &self->private_data.f_crc32, sizeof(self->private_data.f_crc32), WUFFS_VERSION, options);
+    if (z.repr) {
+      return z;
+    }
+  }
+  {
+    wuffs_base__status z = wuffs_deflate__encoder__initialize(
+        &self->private_data.f_flate, sizeof(self->private_data.f_flate), WUFFS_VERSION, options);
+    if (z.repr) {
+      return z;
+    }
+  }
+  self->private_impl.magic = WUFFS_BASE__MAGIC;
+  return wuffs_base__make_status(NULL);
+}
+
+wuffs_png__encoder*
+wuffs_png__encoder__alloc() {
+  wuffs_png__encoder* x =
+      (wuffs_png__encoder*)(calloc(sizeof(wuffs_png__encoder), 1));
+  if (!x) {
+    return NULL;
+  }
+  if (wuffs_png__encoder__initialize(
+      x, sizeof(wuffs_png__encoder), WUFFS_VERSION, WUFFS_INITIALIZE__ALREADY_ZEROED).repr) {
+    free(x);
+    return NULL;
+  }
+  return x;
+}
+
+size_t
+sizeof__wuffs_png__encoder() {
+  return sizeof(wuffs_png__encoder);
+}
+
+// ---------------- Function Implementations
+
+// ‼ WUFFS MULTI-FILE SECTION +arm_neon
+// -------- func png.decoder.filter_1_distance_4_arm_neon
+
+#if defined(WUFFS_BASE__CPU_ARCH__ARM_NEON)
+static wuffs_base__empty_struct
+wuffs_png__decoder__filter_1_distance_4_arm_neon(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_curr) {
+  wuffs_base__slice_u8 v_curr = {0};
+  uint8x8_t v_fa = {0};
+  uint8x8_t v_fx = {0};
+
+  {
+    wuffs_base__slice_u8 i_slice_curr = a_curr;
+    v_curr.ptr = i_slice_curr.ptr;
+    v_curr.len = 4;
+    uint8_t* i_end0_curr = v_curr.ptr + (((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)) / 8) * 8);
+    while (v_curr.ptr < i_end0_curr) {
+      v_fx = vreinterpret_u8_u32(vdup_n_u32(wuffs_base__peek_u32le__no_bounds_check(v_curr.ptr)));
+      v_fx = vadd_u8(v_fx, v_fa);
+      wuffs_base__poke_u32le__no_bounds_check(v_curr.ptr, vget_lane_u32(vreinterpret_u32_u8(v_fx), 0));
+      v_fa = v_fx;
+      v_curr.ptr += 4;
+      v_fx = vreinterpret_u8_u32(vdup_n_u32(wuffs_base__peek_u32le__no_bounds_check(v_curr.ptr)));
+      v_fx = vadd_u8(v_fx, v_fa);
+      wuffs_base__poke_u32le__no_bounds_check(v_curr.ptr, vget_lane_u32(vreinterpret_u32_u8(v_fx), 0));
+      v_fa = v_fx;
+      v_curr.ptr += 4;
+    }
+    v_curr.len = 4;
+    uint8_t* i_end1_curr = v_curr.ptr + (((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)) / 4) * 4);
+    while (v_curr.ptr < i_end1_curr) {
+      v_fx = vreinterpret_u8_u32(vdup_n_u32(wuffs_base__peek_u32le__no_bounds_check(v_curr.ptr)));
+      v_fx = vadd_u8(v_fx, v_fa);
+      wuffs_base__poke_u32le__no_bounds_check(v_curr.ptr, vget_lane_u32(vreinterpret_u32_u8(v_fx), 0));
+      v_fa = v_fx;
       v_curr.ptr += 4;
     }
     v_curr.len = 0;
@@ -35594,6 +44143,45 @@ wuffs_png__decoder__filter_1_distance_4_fallback(
   return wuffs_base__make_empty_struct();
 }
 
+// -------- func png.decoder.filter_1_distance_6_fallback
+
+static wuffs_base__empty_struct
+wuffs_png__decoder__filter_1_distance_6_fallback(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_curr) {
+  wuffs_base__slice_u8 v_curr = {0};
+  uint8_t v_fa0 = 0;
+  uint8_t v_fa1 = 0;
+  uint8_t v_fa2 = 0;
+  uint8_t v_fa3 = 0;
+  uint8_t v_fa4 = 0;
+  uint8_t v_fa5 = 0;
+
+  {
+    wuffs_base__slice_u8 i_slice_curr = a_curr;
+    v_curr.ptr = i_slice_curr.ptr;
+    v_curr.len = 6;
+    uint8_t* i_end0_curr = v_curr.ptr + (((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)) / 6) * 6);
+    while (v_curr.ptr < i_end0_curr) {
+      v_fa0 = ((uint8_t)(v_fa0 + v_curr.ptr[0]));
+      v_curr.ptr[0] = v_fa0;
+      v_fa1 = ((uint8_t)(v_fa1 + v_curr.ptr[1]));
+      v_curr.ptr[1] = v_fa1;
+      v_fa2 = ((uint8_t)(v_fa2 + v_curr.ptr[2]));
+      v_curr.ptr[2] = v_fa2;
+      v_fa3 = ((uint8_t)(v_fa3 + v_curr.ptr[3]));
+      v_curr.ptr[3] = v_fa3;
+      v_fa4 = ((uint8_t)(v_fa4 + v_curr.ptr[4]));
+      v_curr.ptr[4] = v_fa4;
+      v_fa5 = ((uint8_t)(v_fa5 + v_curr.ptr[5]));
+      v_curr.ptr[5] = v_fa5;
+      v_curr.ptr += 6;
+    }
+    v_curr.len = 0;
+  }
+  return wuffs_base__make_empty_struct();
+}
+
 // -------- func png.decoder.filter_2
 
 static wuffs_base__empty_struct
@@ -36190,6 +44778,52 @@ wuffs_png__decoder__filter_1_distance_4_x86_sse42(
 #endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
 // ‼ WUFFS MULTI-FILE SECTION -x86_sse42
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+// -------- func png.decoder.filter_1_distance_8_x86_sse42
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static wuffs_base__empty_struct
+wuffs_png__decoder__filter_1_distance_8_x86_sse42(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_curr) {
+  wuffs_base__slice_u8 v_curr = {0};
+  __m128i v_x128 = {0};
+  __m128i v_a128 = {0};
+
+  {
+    wuffs_base__slice_u8 i_slice_curr = a_curr;
+    v_curr.ptr = i_slice_curr.ptr;
+    v_curr.len = 8;
+    uint8_t* i_end0_curr = v_curr.ptr + (((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)) / 16) * 16);
+    while (v_curr.ptr < i_end0_curr) {
+      v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+      v_x128 = _mm_add_epi8(v_x128, v_a128);
+      v_a128 = v_x128;
+      wuffs_base__poke_u64le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+      v_curr.ptr += 8;
+      v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+      v_x128 = _mm_add_epi8(v_x128, v_a128);
+      v_a128 = v_x128;
+      wuffs_base__poke_u64le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+      v_curr.ptr += 8;
+    }
+    v_curr.len = 8;
+    uint8_t* i_end1_curr = v_curr.ptr + (((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)) / 8) * 8);
+    while (v_curr.ptr < i_end1_curr) {
+      v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+      v_x128 = _mm_add_epi8(v_x128, v_a128);
+      v_a128 = v_x128;
+      wuffs_base__poke_u64le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+      v_curr.ptr += 8;
+    }
+    v_curr.len = 0;
+  }
+  return wuffs_base__make_empty_struct();
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
+
 // ‼ WUFFS MULTI-FILE SECTION +x86_sse42
 // -------- func png.decoder.filter_3_distance_4_x86_sse42
 
@@ -36295,6 +44929,238 @@ wuffs_png__decoder__filter_3_distance_4_x86_sse42(
 #endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
 // ‼ WUFFS MULTI-FILE SECTION -x86_sse42
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+// -------- func png.decoder.filter_3_distance_6_x86_sse42
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static wuffs_base__empty_struct
+wuffs_png__decoder__filter_3_distance_6_x86_sse42(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_curr,
+    wuffs_base__slice_u8 a_prev) {
+  wuffs_base__slice_u8 v_curr = {0};
+  wuffs_base__slice_u8 v_prev = {0};
+  __m128i v_x128 = {0};
+  __m128i v_a128 = {0};
+  __m128i v_b128 = {0};
+  __m128i v_p128 = {0};
+  __m128i v_k128 = {0};
+
+  if (((uint64_t)(a_prev.len)) == 0) {
+    v_k128 = _mm_set1_epi8((int8_t)(254));
+    {
+      wuffs_base__slice_u8 i_slice_curr = a_curr;
+      v_curr.ptr = i_slice_curr.ptr;
+      v_curr.len = 8;
+      uint8_t* i_end0_curr = v_curr.ptr + wuffs_base__iterate_total_advance((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)), 14, 12);
+      while (v_curr.ptr < i_end0_curr) {
+        v_p128 = _mm_avg_epu8(_mm_and_si128(v_a128, v_k128), v_b128);
+        v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+        v_x128 = _mm_add_epi8(v_x128, v_p128);
+        v_a128 = v_x128;
+        wuffs_base__poke_u48le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+        v_curr.ptr += 6;
+        v_p128 = _mm_avg_epu8(_mm_and_si128(v_a128, v_k128), v_b128);
+        v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+        v_x128 = _mm_add_epi8(v_x128, v_p128);
+        v_a128 = v_x128;
+        wuffs_base__poke_u48le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+        v_curr.ptr += 6;
+      }
+      v_curr.len = 8;
+      uint8_t* i_end1_curr = v_curr.ptr + wuffs_base__iterate_total_advance((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)), 8, 6);
+      while (v_curr.ptr < i_end1_curr) {
+        v_p128 = _mm_avg_epu8(_mm_and_si128(v_a128, v_k128), v_b128);
+        v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+        v_x128 = _mm_add_epi8(v_x128, v_p128);
+        v_a128 = v_x128;
+        wuffs_base__poke_u48le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+        v_curr.ptr += 6;
+      }
+      v_curr.len = 6;
+      uint8_t* i_end2_curr = v_curr.ptr + (((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)) / 6) * 6);
+      while (v_curr.ptr < i_end2_curr) {
+        v_p128 = _mm_avg_epu8(_mm_and_si128(v_a128, v_k128), v_b128);
+        v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u48le__no_bounds_check(v_curr.ptr)));
+        v_x128 = _mm_add_epi8(v_x128, v_p128);
+        wuffs_base__poke_u48le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+        v_curr.ptr += 6;
+      }
+      v_curr.len = 0;
+    }
+  } else {
+    v_k128 = _mm_set1_epi8((int8_t)(1));
+    {
+      wuffs_base__slice_u8 i_slice_curr = a_curr;
+      v_curr.ptr = i_slice_curr.ptr;
+      wuffs_base__slice_u8 i_slice_prev = a_prev;
+      v_prev.ptr = i_slice_prev.ptr;
+      i_slice_curr.len = ((size_t)(wuffs_base__u64__min(i_slice_curr.len, i_slice_prev.len)));
+      v_curr.len = 8;
+      v_prev.len = 8;
+      uint8_t* i_end0_curr = v_curr.ptr + wuffs_base__iterate_total_advance((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)), 14, 12);
+      while (v_curr.ptr < i_end0_curr) {
+        v_b128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_prev.ptr)));
+        v_p128 = _mm_avg_epu8(v_a128, v_b128);
+        v_p128 = _mm_sub_epi8(v_p128, _mm_and_si128(v_k128, _mm_xor_si128(v_a128, v_b128)));
+        v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+        v_x128 = _mm_add_epi8(v_x128, v_p128);
+        v_a128 = v_x128;
+        wuffs_base__poke_u48le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+        v_curr.ptr += 6;
+        v_prev.ptr += 6;
+        v_b128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_prev.ptr)));
+        v_p128 = _mm_avg_epu8(v_a128, v_b128);
+        v_p128 = _mm_sub_epi8(v_p128, _mm_and_si128(v_k128, _mm_xor_si128(v_a128, v_b128)));
+        v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+        v_x128 = _mm_add_epi8(v_x128, v_p128);
+        v_a128 = v_x128;
+        wuffs_base__poke_u48le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+        v_curr.ptr += 6;
+        v_prev.ptr += 6;
+      }
+      v_curr.len = 8;
+      v_prev.len = 8;
+      uint8_t* i_end1_curr = v_curr.ptr + wuffs_base__iterate_total_advance((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)), 8, 6);
+      while (v_curr.ptr < i_end1_curr) {
+        v_b128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_prev.ptr)));
+        v_p128 = _mm_avg_epu8(v_a128, v_b128);
+        v_p128 = _mm_sub_epi8(v_p128, _mm_and_si128(v_k128, _mm_xor_si128(v_a128, v_b128)));
+        v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+        v_x128 = _mm_add_epi8(v_x128, v_p128);
+        v_a128 = v_x128;
+        wuffs_base__poke_u48le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+        v_curr.ptr += 6;
+        v_prev.ptr += 6;
+      }
+      v_curr.len = 6;
+      v_prev.len = 6;
+      uint8_t* i_end2_curr = v_curr.ptr + (((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)) / 6) * 6);
+      while (v_curr.ptr < i_end2_curr) {
+        v_b128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u48le__no_bounds_check(v_prev.ptr)));
+        v_p128 = _mm_avg_epu8(v_a128, v_b128);
+        v_p128 = _mm_sub_epi8(v_p128, _mm_and_si128(v_k128, _mm_xor_si128(v_a128, v_b128)));
+        v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u48le__no_bounds_check(v_curr.ptr)));
+        v_x128 = _mm_add_epi8(v_x128, v_p128);
+        wuffs_base__poke_u48le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+        v_curr.ptr += 6;
+        v_prev.ptr += 6;
+      }
+      v_curr.len = 0;
+      v_prev.len = 0;
+    }
+  }
+  return wuffs_base__make_empty_struct();
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+// -------- func png.decoder.filter_3_distance_8_x86_sse42
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static wuffs_base__empty_struct
+wuffs_png__decoder__filter_3_distance_8_x86_sse42(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_curr,
+    wuffs_base__slice_u8 a_prev) {
+  wuffs_base__slice_u8 v_curr = {0};
+  wuffs_base__slice_u8 v_prev = {0};
+  __m128i v_x128 = {0};
+  __m128i v_a128 = {0};
+  __m128i v_b128 = {0};
+  __m128i v_p128 = {0};
+  __m128i v_k128 = {0};
+
+  if (((uint64_t)(a_prev.len)) == 0) {
+    v_k128 = _mm_set1_epi8((int8_t)(254));
+    {
+      wuffs_base__slice_u8 i_slice_curr = a_curr;
+      v_curr.ptr = i_slice_curr.ptr;
+      v_curr.len = 8;
+      uint8_t* i_end0_curr = v_curr.ptr + (((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)) / 16) * 16);
+      while (v_curr.ptr < i_end0_curr) {
+        v_p128 = _mm_avg_epu8(_mm_and_si128(v_a128, v_k128), v_b128);
+        v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+        v_x128 = _mm_add_epi8(v_x128, v_p128);
+        v_a128 = v_x128;
+        wuffs_base__poke_u64le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+        v_curr.ptr += 8;
+        v_p128 = _mm_avg_epu8(_mm_and_si128(v_a128, v_k128), v_b128);
+        v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+        v_x128 = _mm_add_epi8(v_x128, v_p128);
+        v_a128 = v_x128;
+        wuffs_base__poke_u64le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+        v_curr.ptr += 8;
+      }
+      v_curr.len = 8;
+      uint8_t* i_end1_curr = v_curr.ptr + (((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)) / 8) * 8);
+      while (v_curr.ptr < i_end1_curr) {
+        v_p128 = _mm_avg_epu8(_mm_and_si128(v_a128, v_k128), v_b128);
+        v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+        v_x128 = _mm_add_epi8(v_x128, v_p128);
+        v_a128 = v_x128;
+        wuffs_base__poke_u64le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+        v_curr.ptr += 8;
+      }
+      v_curr.len = 0;
+    }
+  } else {
+    v_k128 = _mm_set1_epi8((int8_t)(1));
+    {
+      wuffs_base__slice_u8 i_slice_curr = a_curr;
+      v_curr.ptr = i_slice_curr.ptr;
+      wuffs_base__slice_u8 i_slice_prev = a_prev;
+      v_prev.ptr = i_slice_prev.ptr;
+      i_slice_curr.len = ((size_t)(wuffs_base__u64__min(i_slice_curr.len, i_slice_prev.len)));
+      v_curr.len = 8;
+      v_prev.len = 8;
+      uint8_t* i_end0_curr = v_curr.ptr + (((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)) / 16) * 16);
+      while (v_curr.ptr < i_end0_curr) {
+        v_b128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_prev.ptr)));
+        v_p128 = _mm_avg_epu8(v_a128, v_b128);
+        v_p128 = _mm_sub_epi8(v_p128, _mm_and_si128(v_k128, _mm_xor_si128(v_a128, v_b128)));
+        v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+        v_x128 = _mm_add_epi8(v_x128, v_p128);
+        v_a128 = v_x128;
+        wuffs_base__poke_u64le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+        v_curr.ptr += 8;
+        v_prev.ptr += 8;
+        v_b128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_prev.ptr)));
+        v_p128 = _mm_avg_epu8(v_a128, v_b128);
+        v_p128 = _mm_sub_epi8(v_p128, _mm_and_si128(v_k128, _mm_xor_si128(v_a128, v_b128)));
+        v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+        v_x128 = _mm_add_epi8(v_x128, v_p128);
+        v_a128 = v_x128;
+        wuffs_base__poke_u64le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+        v_curr.ptr += 8;
+        v_prev.ptr += 8;
+      }
+      v_curr.len = 8;
+      v_prev.len = 8;
+      uint8_t* i_end1_curr = v_curr.ptr + (((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)) / 8) * 8);
+      while (v_curr.ptr < i_end1_curr) {
+        v_b128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_prev.ptr)));
+        v_p128 = _mm_avg_epu8(v_a128, v_b128);
+        v_p128 = _mm_sub_epi8(v_p128, _mm_and_si128(v_k128, _mm_xor_si128(v_a128, v_b128)));
+        v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+        v_x128 = _mm_add_epi8(v_x128, v_p128);
+        v_a128 = v_x128;
+        wuffs_base__poke_u64le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+        v_curr.ptr += 8;
+        v_prev.ptr += 8;
+      }
+      v_curr.len = 0;
+      v_prev.len = 0;
+    }
+  }
+  return wuffs_base__make_empty_struct();
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
+
 // ‼ WUFFS MULTI-FILE SECTION +x86_sse42
 // -------- func png.decoder.filter_4_distance_3_x86_sse42
 
@@ -36525,6 +45391,236 @@ wuffs_png__decoder__filter_4_distance_4_x86_sse42(
 #endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
 // ‼ WUFFS MULTI-FILE SECTION -x86_sse42
 
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+// -------- func png.decoder.filter_4_distance_6_x86_sse42
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static wuffs_base__empty_struct
+wuffs_png__decoder__filter_4_distance_6_x86_sse42(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_curr,
+    wuffs_base__slice_u8 a_prev) {
+  wuffs_base__slice_u8 v_curr = {0};
+  wuffs_base__slice_u8 v_prev = {0};
+  __m128i v_x128 = {0};
+  __m128i v_a128 = {0};
+  __m128i v_b128 = {0};
+  __m128i v_c128 = {0};
+  __m128i v_p128 = {0};
+  __m128i v_pa128 = {0};
+  __m128i v_pb128 = {0};
+  __m128i v_pc128 = {0};
+  __m128i v_smallest128 = {0};
+  __m128i v_z128 = {0};
+
+  {
+    wuffs_base__slice_u8 i_slice_curr = a_curr;
+    v_curr.ptr = i_slice_curr.ptr;
+    wuffs_base__slice_u8 i_slice_prev = a_prev;
+    v_prev.ptr = i_slice_prev.ptr;
+    i_slice_curr.len = ((size_t)(wuffs_base__u64__min(i_slice_curr.len, i_slice_prev.len)));
+    v_curr.len = 8;
+    v_prev.len = 8;
+    uint8_t* i_end0_curr = v_curr.ptr + wuffs_base__iterate_total_advance((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)), 14, 12);
+    while (v_curr.ptr < i_end0_curr) {
+      v_b128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_prev.ptr)));
+      v_b128 = _mm_unpacklo_epi8(v_b128, v_z128);
+      v_pa128 = _mm_sub_epi16(v_b128, v_c128);
+      v_pb128 = _mm_sub_epi16(v_a128, v_c128);
+      v_pc128 = _mm_add_epi16(v_pa128, v_pb128);
+      v_pa128 = _mm_abs_epi16(v_pa128);
+      v_pb128 = _mm_abs_epi16(v_pb128);
+      v_pc128 = _mm_abs_epi16(v_pc128);
+      v_smallest128 = _mm_min_epi16(v_pc128, _mm_min_epi16(v_pb128, v_pa128));
+      v_p128 = _mm_blendv_epi8(_mm_blendv_epi8(v_c128, v_b128, _mm_cmpeq_epi16(v_smallest128, v_pb128)), v_a128, _mm_cmpeq_epi16(v_smallest128, v_pa128));
+      v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+      v_x128 = _mm_unpacklo_epi8(v_x128, v_z128);
+      v_x128 = _mm_add_epi8(v_x128, v_p128);
+      v_a128 = v_x128;
+      v_c128 = v_b128;
+      v_x128 = _mm_packus_epi16(v_x128, v_x128);
+      wuffs_base__poke_u48le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+      v_curr.ptr += 6;
+      v_prev.ptr += 6;
+      v_b128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_prev.ptr)));
+      v_b128 = _mm_unpacklo_epi8(v_b128, v_z128);
+      v_pa128 = _mm_sub_epi16(v_b128, v_c128);
+      v_pb128 = _mm_sub_epi16(v_a128, v_c128);
+      v_pc128 = _mm_add_epi16(v_pa128, v_pb128);
+      v_pa128 = _mm_abs_epi16(v_pa128);
+      v_pb128 = _mm_abs_epi16(v_pb128);
+      v_pc128 = _mm_abs_epi16(v_pc128);
+      v_smallest128 = _mm_min_epi16(v_pc128, _mm_min_epi16(v_pb128, v_pa128));
+      v_p128 = _mm_blendv_epi8(_mm_blendv_epi8(v_c128, v_b128, _mm_cmpeq_epi16(v_smallest128, v_pb128)), v_a128, _mm_cmpeq_epi16(v_smallest128, v_pa128));
+      v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+      v_x128 = _mm_unpacklo_epi8(v_x128, v_z128);
+      v_x128 = _mm_add_epi8(v_x128, v_p128);
+      v_a128 = v_x128;
+      v_c128 = v_b128;
+      v_x128 = _mm_packus_epi16(v_x128, v_x128);
+      wuffs_base__poke_u48le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+      v_curr.ptr += 6;
+      v_prev.ptr += 6;
+    }
+    v_curr.len = 8;
+    v_prev.len = 8;
+    uint8_t* i_end1_curr = v_curr.ptr + wuffs_base__iterate_total_advance((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)), 8, 6);
+    while (v_curr.ptr < i_end1_curr) {
+      v_b128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_prev.ptr)));
+      v_b128 = _mm_unpacklo_epi8(v_b128, v_z128);
+      v_pa128 = _mm_sub_epi16(v_b128, v_c128);
+      v_pb128 = _mm_sub_epi16(v_a128, v_c128);
+      v_pc128 = _mm_add_epi16(v_pa128, v_pb128);
+      v_pa128 = _mm_abs_epi16(v_pa128);
+      v_pb128 = _mm_abs_epi16(v_pb128);
+      v_pc128 = _mm_abs_epi16(v_pc128);
+      v_smallest128 = _mm_min_epi16(v_pc128, _mm_min_epi16(v_pb128, v_pa128));
+      v_p128 = _mm_blendv_epi8(_mm_blendv_epi8(v_c128, v_b128, _mm_cmpeq_epi16(v_smallest128, v_pb128)), v_a128, _mm_cmpeq_epi16(v_smallest128, v_pa128));
+      v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+      v_x128 = _mm_unpacklo_epi8(v_x128, v_z128);
+      v_x128 = _mm_add_epi8(v_x128, v_p128);
+      v_a128 = v_x128;
+      v_c128 = v_b128;
+      v_x128 = _mm_packus_epi16(v_x128, v_x128);
+      wuffs_base__poke_u48le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+      v_curr.ptr += 6;
+      v_prev.ptr += 6;
+    }
+    v_curr.len = 6;
+    v_prev.len = 6;
+    uint8_t* i_end2_curr = v_curr.ptr + (((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)) / 6) * 6);
+    while (v_curr.ptr < i_end2_curr) {
+      v_b128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u48le__no_bounds_check(v_prev.ptr)));
+      v_b128 = _mm_unpacklo_epi8(v_b128, v_z128);
+      v_pa128 = _mm_sub_epi16(v_b128, v_c128);
+      v_pb128 = _mm_sub_epi16(v_a128, v_c128);
+      v_pc128 = _mm_add_epi16(v_pa128, v_pb128);
+      v_pa128 = _mm_abs_epi16(v_pa128);
+      v_pb128 = _mm_abs_epi16(v_pb128);
+      v_pc128 = _mm_abs_epi16(v_pc128);
+      v_smallest128 = _mm_min_epi16(v_pc128, _mm_min_epi16(v_pb128, v_pa128));
+      v_p128 = _mm_blendv_epi8(_mm_blendv_epi8(v_c128, v_b128, _mm_cmpeq_epi16(v_smallest128, v_pb128)), v_a128, _mm_cmpeq_epi16(v_smallest128, v_pa128));
+      v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u48le__no_bounds_check(v_curr.ptr)));
+      v_x128 = _mm_unpacklo_epi8(v_x128, v_z128);
+      v_x128 = _mm_add_epi8(v_x128, v_p128);
+      v_x128 = _mm_packus_epi16(v_x128, v_x128);
+      wuffs_base__poke_u48le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+      v_curr.ptr += 6;
+      v_prev.ptr += 6;
+    }
+    v_curr.len = 0;
+    v_prev.len = 0;
+  }
+  return wuffs_base__make_empty_struct();
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+// -------- func png.decoder.filter_4_distance_8_x86_sse42
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static wuffs_base__empty_struct
+wuffs_png__decoder__filter_4_distance_8_x86_sse42(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_curr,
+    wuffs_base__slice_u8 a_prev) {
+  wuffs_base__slice_u8 v_curr = {0};
+  wuffs_base__slice_u8 v_prev = {0};
+  __m128i v_x128 = {0};
+  __m128i v_a128 = {0};
+  __m128i v_b128 = {0};
+  __m128i v_c128 = {0};
+  __m128i v_p128 = {0};
+  __m128i v_pa128 = {0};
+  __m128i v_pb128 = {0};
+  __m128i v_pc128 = {0};
+  __m128i v_smallest128 = {0};
+  __m128i v_z128 = {0};
+
+  {
+    wuffs_base__slice_u8 i_slice_curr = a_curr;
+    v_curr.ptr = i_slice_curr.ptr;
+    wuffs_base__slice_u8 i_slice_prev = a_prev;
+    v_prev.ptr = i_slice_prev.ptr;
+    i_slice_curr.len = ((size_t)(wuffs_base__u64__min(i_slice_curr.len, i_slice_prev.len)));
+    v_curr.len = 8;
+    v_prev.len = 8;
+    uint8_t* i_end0_curr = v_curr.ptr + (((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)) / 16) * 16);
+    while (v_curr.ptr < i_end0_curr) {
+      v_b128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_prev.ptr)));
+      v_b128 = _mm_unpacklo_epi8(v_b128, v_z128);
+      v_pa128 = _mm_sub_epi16(v_b128, v_c128);
+      v_pb128 = _mm_sub_epi16(v_a128, v_c128);
+      v_pc128 = _mm_add_epi16(v_pa128, v_pb128);
+      v_pa128 = _mm_abs_epi16(v_pa128);
+      v_pb128 = _mm_abs_epi16(v_pb128);
+      v_pc128 = _mm_abs_epi16(v_pc128);
+      v_smallest128 = _mm_min_epi16(v_pc128, _mm_min_epi16(v_pb128, v_pa128));
+      v_p128 = _mm_blendv_epi8(_mm_blendv_epi8(v_c128, v_b128, _mm_cmpeq_epi16(v_smallest128, v_pb128)), v_a128, _mm_cmpeq_epi16(v_smallest128, v_pa128));
+      v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+      v_x128 = _mm_unpacklo_epi8(v_x128, v_z128);
+      v_x128 = _mm_add_epi8(v_x128, v_p128);
+      v_a128 = v_x128;
+      v_c128 = v_b128;
+      v_x128 = _mm_packus_epi16(v_x128, v_x128);
+      wuffs_base__poke_u64le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+      v_curr.ptr += 8;
+      v_prev.ptr += 8;
+      v_b128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_prev.ptr)));
+      v_b128 = _mm_unpacklo_epi8(v_b128, v_z128);
+      v_pa128 = _mm_sub_epi16(v_b128, v_c128);
+      v_pb128 = _mm_sub_epi16(v_a128, v_c128);
+      v_pc128 = _mm_add_epi16(v_pa128, v_pb128);
+      v_pa128 = _mm_abs_epi16(v_pa128);
+      v_pb128 = _mm_abs_epi16(v_pb128);
+      v_pc128 = _mm_abs_epi16(v_pc128);
+      v_smallest128 = _mm_min_epi16(v_pc128, _mm_min_epi16(v_pb128, v_pa128));
+      v_p128 = _mm_blendv_epi8(_mm_blendv_epi8(v_c128, v_b128, _mm_cmpeq_epi16(v_smallest128, v_pb128)), v_a128, _mm_cmpeq_epi16(v_smallest128, v_pa128));
+      v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+      v_x128 = _mm_unpacklo_epi8(v_x128, v_z128);
+      v_x128 = _mm_add_epi8(v_x128, v_p128);
+      v_a128 = v_x128;
+      v_c128 = v_b128;
+      v_x128 = _mm_packus_epi16(v_x128, v_x128);
+      wuffs_base__poke_u64le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+      v_curr.ptr += 8;
+      v_prev.ptr += 8;
+    }
+    v_curr.len = 8;
+    v_prev.len = 8;
+    uint8_t* i_end1_curr = v_curr.ptr + (((i_slice_curr.len - (size_t)(v_curr.ptr - i_slice_curr.ptr)) / 8) * 8);
+    while (v_curr.ptr < i_end1_curr) {
+      v_b128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_prev.ptr)));
+      v_b128 = _mm_unpacklo_epi8(v_b128, v_z128);
+      v_pa128 = _mm_sub_epi16(v_b128, v_c128);
+      v_pb128 = _mm_sub_epi16(v_a128, v_c128);
+      v_pc128 = _mm_add_epi16(v_pa128, v_pb128);
+      v_pa128 = _mm_abs_epi16(v_pa128);
+      v_pb128 = _mm_abs_epi16(v_pb128);
+      v_pc128 = _mm_abs_epi16(v_pc128);
+      v_smallest128 = _mm_min_epi16(v_pc128, _mm_min_epi16(v_pb128, v_pa128));
+      v_p128 = _mm_blendv_epi8(_mm_blendv_epi8(v_c128, v_b128, _mm_cmpeq_epi16(v_smallest128, v_pb128)), v_a128, _mm_cmpeq_epi16(v_smallest128, v_pa128));
+      v_x128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_curr.ptr)));
+      v_x128 = _mm_unpacklo_epi8(v_x128, v_z128);
+      v_x128 = _mm_add_epi8(v_x128, v_p128);
+      v_a128 = v_x128;
+      v_c128 = v_b128;
+      v_x128 = _mm_packus_epi16(v_x128, v_x128);
+      wuffs_base__poke_u64le__no_bounds_check(v_curr.ptr, ((uint64_t)(_mm_cvtsi128_si64(v_x128))));
+      v_curr.ptr += 8;
+      v_prev.ptr += 8;
+    }
+    v_curr.len = 0;
+    v_prev.len = 0;
+  }
+  return wuffs_base__make_empty_struct();
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
+
 // -------- func png.decoder.set_quirk_enabled
 
 WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
@@ -36579,6 +45675,7 @@ wuffs_png__decoder__decode_image_config(
   uint32_t v_checksum_have = 0;
   uint32_t v_checksum_want = 0;
   wuffs_base__status v_status = wuffs_base__make_status(NULL);
+  uint64_t v_position = 0;
 
   const uint8_t* iop_a_src = NULL;
   const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
@@ -36598,147 +45695,172 @@ wuffs_png__decoder__decode_image_config(
   switch (coro_susp_point) {
     WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
 
-    if (self->private_impl.f_call_sequence != 0) {
-      status = wuffs_base__make_status(wuffs_base__error__bad_call_sequence);
-      goto exit;
-    }
-    {
-      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
-      uint64_t t_0;
-      if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 8)) {
-        t_0 = wuffs_base__peek_u64le__no_bounds_check(iop_a_src);
-        iop_a_src += 8;
-      } else {
-        self->private_data.s_decode_image_config[0].scratch = 0;
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
-        while (true) {
-          if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
-            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
-            goto suspend;
+    if (self->private_impl.f_call_sequence == 0) {
+      {
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+        uint64_t t_0;
+        if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 8)) {
+          t_0 = wuffs_base__peek_u64le__no_bounds_check(iop_a_src);
+          iop_a_src += 8;
+        } else {
+          self->private_data.s_decode_image_config[0].scratch = 0;
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+          while (true) {
+            if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+              status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+              goto suspend;
+            }
+            uint64_t* scratch = &self->private_data.s_decode_image_config[0].scratch;
+            uint32_t num_bits_0 = ((uint32_t)(*scratch >> 56));
+            *scratch <<= 8;
+            *scratch >>= 8;
+            *scratch |= ((uint64_t)(*iop_a_src++)) << num_bits_0;
+            if (num_bits_0 == 56) {
+              t_0 = ((uint64_t)(*scratch));
+              break;
+            }
+            num_bits_0 += 8;
+            *scratch |= ((uint64_t)(num_bits_0)) << 56;
           }
-          uint64_t* scratch = &self->private_data.s_decode_image_config[0].scratch;
-          uint32_t num_bits_0 = ((uint32_t)(*scratch >> 56));
-          *scratch <<= 8;
-          *scratch >>= 8;
-          *scratch |= ((uint64_t)(*iop_a_src++)) << num_bits_0;
-          if (num_bits_0 == 56) {
-            t_0 = ((uint64_t)(*scratch));
-            break;
+        }
+        v_magic = t_0;
+      }
+      if (v_magic != 727905341920923785) {
+        status = wuffs_base__make_status(wuffs_png__error__bad_header);
+        goto exit;
+      }
+      {
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+        uint64_t t_1;
+        if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 8)) {
+          t_1 = wuffs_base__peek_u64le__no_bounds_check(iop_a_src);
+          iop_a_src += 8;
+        } else {
+          self->private_data.s_decode_image_config[0].scratch = 0;
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
+          while (true) {
+            if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+              status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+              goto suspend;
+            }
+            uint64_t* scratch = &self->private_data.s_decode_image_config[0].scratch;
+            uint32_t num_bits_1 = ((uint32_t)(*scratch >> 56));
+            *scratch <<= 8;
+            *scratch >>= 8;
+            *scratch |= ((uint64_t)(*iop_a_src++)) << num_bits_1;
+            if (num_bits_1 == 56) {
+              t_1 = ((uint64_t)(*scratch));
+              break;
+            }
+            num_bits_1 += 8;
+            *scratch |= ((uint64_t)(num_bits_1)) << 56;
           }
-          num_bits_0 += 8;
-          *scratch |= ((uint64_t)(num_bits_0)) << 56;
         }
+        v_magic = t_1;
       }
-      v_magic = t_0;
-    }
-    if (v_magic != 727905341920923785) {
-      status = wuffs_base__make_status(wuffs_png__error__bad_header);
-      goto exit;
-    }
-    {
-      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
-      uint64_t t_1;
-      if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 8)) {
-        t_1 = wuffs_base__peek_u64le__no_bounds_check(iop_a_src);
-        iop_a_src += 8;
-      } else {
-        self->private_data.s_decode_image_config[0].scratch = 0;
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
-        while (true) {
-          if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
-            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
-            goto suspend;
+      if (v_magic != 5927942488114331648) {
+        status = wuffs_base__make_status(wuffs_png__error__bad_header);
+        goto exit;
+      }
+      wuffs_base__ignore_status(wuffs_crc32__ieee_hasher__initialize(&self->private_data.f_crc32, sizeof (wuffs_crc32__ieee_hasher), WUFFS_VERSION, 0));
+      self->private_impl.f_chunk_type_array[0] = 73;
+      self->private_impl.f_chunk_type_array[1] = 72;
+      self->private_impl.f_chunk_type_array[2] = 68;
+      self->private_impl.f_chunk_type_array[3] = 82;
+      wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_crc32, wuffs_base__make_slice_u8(self->private_impl.f_chunk_type_array, 4));
+      while (true) {
+        v_mark = ((uint64_t)(iop_a_src - io0_a_src));
+        {
+          if (a_src) {
+            a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
           }
-          uint64_t* scratch = &self->private_data.s_decode_image_config[0].scratch;
-          uint32_t num_bits_1 = ((uint32_t)(*scratch >> 56));
-          *scratch <<= 8;
-          *scratch >>= 8;
-          *scratch |= ((uint64_t)(*iop_a_src++)) << num_bits_1;
-          if (num_bits_1 == 56) {
-            t_1 = ((uint64_t)(*scratch));
-            break;
+          wuffs_base__status t_2 = wuffs_png__decoder__decode_ihdr(self, a_src);
+          v_status = t_2;
+          if (a_src) {
+            iop_a_src = a_src->data.ptr + a_src->meta.ri;
           }
-          num_bits_1 += 8;
-          *scratch |= ((uint64_t)(num_bits_1)) << 56;
         }
+        if ( ! self->private_impl.f_ignore_checksum) {
+          v_checksum_have = wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_crc32, wuffs_base__io__since(v_mark, ((uint64_t)(iop_a_src - io0_a_src)), io0_a_src));
+        }
+        if (wuffs_base__status__is_ok(&v_status)) {
+          goto label__0__break;
+        }
+        status = v_status;
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(5);
       }
-      v_magic = t_1;
-    }
-    if (v_magic != 5927942488114331648) {
-      status = wuffs_base__make_status(wuffs_png__error__bad_header);
-      goto exit;
-    }
-    wuffs_base__ignore_status(wuffs_crc32__ieee_hasher__initialize(&self->private_data.f_crc32, sizeof (wuffs_crc32__ieee_hasher), WUFFS_VERSION, 0));
-    self->private_impl.f_chunk_type_array[0] = 73;
-    self->private_impl.f_chunk_type_array[1] = 72;
-    self->private_impl.f_chunk_type_array[2] = 68;
-    self->private_impl.f_chunk_type_array[3] = 82;
-    wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_crc32, wuffs_base__make_slice_u8(self->private_impl.f_chunk_type_array, 4));
-    while (true) {
-      v_mark = ((uint64_t)(iop_a_src - io0_a_src));
+      label__0__break:;
       {
-        if (a_src) {
-          a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
-        }
-        wuffs_base__status t_2 = wuffs_png__decoder__decode_ihdr(self, a_src);
-        v_status = t_2;
-        if (a_src) {
-          iop_a_src = a_src->data.ptr + a_src->meta.ri;
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(6);
+        uint32_t t_3;
+        if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
+          t_3 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
+          iop_a_src += 4;
+        } else {
+          self->private_data.s_decode_image_config[0].scratch = 0;
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(7);
+          while (true) {
+            if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+              status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+              goto suspend;
+            }
+            uint64_t* scratch = &self->private_data.s_decode_image_config[0].scratch;
+            uint32_t num_bits_3 = ((uint32_t)(*scratch & 0xFF));
+            *scratch >>= 8;
+            *scratch <<= 8;
+            *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_3);
+            if (num_bits_3 == 24) {
+              t_3 = ((uint32_t)(*scratch >> 32));
+              break;
+            }
+            num_bits_3 += 8;
+            *scratch |= ((uint64_t)(num_bits_3));
+          }
         }
+        v_checksum_want = t_3;
       }
-      if ( ! self->private_impl.f_ignore_checksum) {
-        v_checksum_have = wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_crc32, wuffs_base__io__since(v_mark, ((uint64_t)(iop_a_src - io0_a_src)), io0_a_src));
+      if ( ! self->private_impl.f_ignore_checksum && (v_checksum_have != v_checksum_want)) {
+        status = wuffs_base__make_status(wuffs_png__error__bad_checksum);
+        goto exit;
       }
-      if (wuffs_base__status__is_ok(&v_status)) {
-        goto label__0__break;
+    } else if (self->private_impl.f_call_sequence == 2) {
+      v_position = wuffs_base__u64__sat_add(a_src->meta.pos, ((uint64_t)(iop_a_src - io0_a_src)));
+      if (self->private_impl.f_metadata_z < v_position) {
+        status = wuffs_base__make_status(wuffs_base__error__bad_i_o_position);
+        goto exit;
       }
-      status = v_status;
-      WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(5);
-    }
-    label__0__break:;
-    {
-      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(6);
-      uint32_t t_3;
-      if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
-        t_3 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
-        iop_a_src += 4;
-      } else {
-        self->private_data.s_decode_image_config[0].scratch = 0;
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(7);
-        while (true) {
-          if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
-            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
-            goto suspend;
-          }
-          uint64_t* scratch = &self->private_data.s_decode_image_config[0].scratch;
-          uint32_t num_bits_3 = ((uint32_t)(*scratch & 0xFF));
-          *scratch >>= 8;
-          *scratch <<= 8;
-          *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_3);
-          if (num_bits_3 == 24) {
-            t_3 = ((uint32_t)(*scratch >> 32));
-            break;
-          }
-          num_bits_3 += 8;
-          *scratch |= ((uint64_t)(num_bits_3));
-        }
+      self->private_data.s_decode_image_config[0].scratch = (self->private_impl.f_metadata_z - v_position);
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(8);
+      if (self->private_data.s_decode_image_config[0].scratch > ((uint64_t)(io2_a_src - iop_a_src))) {
+        self->private_data.s_decode_image_config[0].scratch -= ((uint64_t)(io2_a_src - iop_a_src));
+        iop_a_src = io2_a_src;
+        status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+        goto suspend;
       }
-      v_checksum_want = t_3;
-    }
-    if ( ! self->private_impl.f_ignore_checksum && (v_checksum_have != v_checksum_want)) {
-      status = wuffs_base__make_status(wuffs_png__error__bad_checksum);
+      iop_a_src += self->private_data.s_decode_image_config[0].scratch;
+      self->private_data.s_decode_image_config[0].scratch = 4;
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(9);
+      if (self->private_data.s_decode_image_config[0].scratch > ((uint64_t)(io2_a_src - iop_a_src))) {
+        self->private_data.s_decode_image_config[0].scratch -= ((uint64_t)(io2_a_src - iop_a_src));
+        iop_a_src = io2_a_src;
+        status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+        goto suspend;
+      }
+      iop_a_src += self->private_data.s_decode_image_config[0].scratch;
+    } else {
+      status = wuffs_base__make_status(wuffs_base__error__bad_call_sequence);
       goto exit;
     }
     while (true) {
       {
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(8);
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(10);
         uint64_t t_4;
         if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
           t_4 = ((uint64_t)(wuffs_base__peek_u32be__no_bounds_check(iop_a_src)));
           iop_a_src += 4;
         } else {
           self->private_data.s_decode_image_config[0].scratch = 0;
-          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(9);
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(11);
           while (true) {
             if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
               status = wuffs_base__make_status(wuffs_base__suspension__short_read);
@@ -36760,14 +45882,14 @@ wuffs_png__decoder__decode_image_config(
         self->private_impl.f_chunk_length = t_4;
       }
       {
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(10);
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(12);
         uint32_t t_5;
         if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
           t_5 = wuffs_base__peek_u32le__no_bounds_check(iop_a_src);
           iop_a_src += 4;
         } else {
           self->private_data.s_decode_image_config[0].scratch = 0;
-          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(11);
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(13);
           while (true) {
             if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
               status = wuffs_base__make_status(wuffs_base__suspension__short_read);
@@ -36799,6 +45921,14 @@ wuffs_png__decoder__decode_image_config(
       if (self->private_impl.f_chunk_type == 1413563465) {
         goto label__1__break;
       }
+      self->private_impl.f_metadata_fourcc = wuffs_png__decoder__reported_metadata_fourcc(self);
+      if (self->private_impl.f_metadata_fourcc != 0) {
+        self->private_impl.f_metadata_y = wuffs_base__u64__sat_add(a_src->meta.pos, ((uint64_t)(iop_a_src - io0_a_src)));
+        self->private_impl.f_metadata_z = wuffs_base__u64__sat_add(self->private_impl.f_metadata_y, self->private_impl.f_chunk_length);
+        self->private_impl.f_call_sequence = 1;
+        status = wuffs_base__make_status(wuffs_base__note__metadata_reported);
+        goto ok;
+      }
       while (true) {
         v_mark = ((uint64_t)(iop_a_src - io0_a_src));
         {
@@ -36818,18 +45948,18 @@ wuffs_png__decoder__decode_image_config(
           goto label__2__break;
         }
         status = v_status;
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(12);
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(14);
       }
       label__2__break:;
       {
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(13);
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(15);
         uint32_t t_7;
         if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
           t_7 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
           iop_a_src += 4;
         } else {
           self->private_data.s_decode_image_config[0].scratch = 0;
-          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(14);
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(16);
           while (true) {
             if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
               status = wuffs_base__make_status(wuffs_base__suspension__short_read);
@@ -36861,6 +45991,7 @@ wuffs_png__decoder__decode_image_config(
       goto exit;
     }
     self->private_impl.f_frame_config_io_position = wuffs_base__u64__sat_add(a_src->meta.pos, ((uint64_t)(iop_a_src - io0_a_src)));
+    self->private_impl.f_first_idat_chunk_length = self->private_impl.f_chunk_length;
     if (a_dst != NULL) {
       wuffs_base__image_config__set(
           a_dst,
@@ -36906,6 +46037,7 @@ wuffs_png__decoder__decode_ihdr(
 
   uint32_t v_a32 = 0;
   uint8_t v_a8 = 0;
+  uint64_t v_row_length = 0;
 
   const uint8_t* iop_a_src = NULL;
   const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
@@ -37069,6 +46201,14 @@ wuffs_png__decoder__decode_ihdr(
       status = wuffs_base__make_status(wuffs_png__error__bad_header);
       goto exit;
     }
+    self->private_impl.f_frame_rect_x0 = 0;
+    self->private_impl.f_frame_rect_y0 = 0;
+    self->private_impl.f_frame_rect_x1 = self->private_impl.f_width;
+    self->private_impl.f_frame_rect_y1 = self->private_impl.f_height;
+    self->private_impl.f_roi_x0 = 0;
+    self->private_impl.f_roi_y0 = 0;
+    self->private_impl.f_roi_x1 = 4294967295;
+    self->private_impl.f_roi_y1 = 4294967295;
     self->private_impl.f_filter_distance = 0;
     wuffs_png__decoder__assign_filter_distance(self);
     if (self->private_impl.f_filter_distance == 0) {
@@ -37076,6 +46216,25 @@ wuffs_png__decoder__decode_ihdr(
       goto exit;
     }
     self->private_impl.f_overall_workbuf_length = (((uint64_t)(self->private_impl.f_height)) * (1 + wuffs_png__decoder__calculate_bytes_per_row(self, self->private_impl.f_width)));
+    v_row_length = (1 + wuffs_png__decoder__calculate_bytes_per_row(self, self->private_impl.f_width));
+    self->private_impl.f_min_workbuf_length = v_row_length;
+    self->private_impl.f_max_workbuf_length = (2 * v_row_length);
+    if (self->private_impl.f_height >= 2) {
+      self->private_impl.f_min_workbuf_length = (2 * v_row_length);
+    }
+    if ((0 < v_row_length) && (v_row_length < 32768)) {
+      self->private_impl.f_max_workbuf_length = (2 * (32768 / v_row_length) * v_row_length);
+    }
+    if (self->private_impl.f_max_workbuf_length > self->private_impl.f_overall_workbuf_length) {
+      self->private_impl.f_max_workbuf_length = self->private_impl.f_overall_workbuf_length;
+    }
+    if (self->private_impl.f_max_workbuf_length < self->private_impl.f_min_workbuf_length) {
+      self->private_impl.f_max_workbuf_length = self->private_impl.f_min_workbuf_length;
+    }
+    self->private_impl.f_downscale_workbuf_length = 0;
+    if (self->private_impl.f_interlace_pass == 0) {
+      self->private_impl.f_downscale_workbuf_length = ((((uint64_t)(self->private_impl.f_width)) * 12) + 16);
+    }
     wuffs_png__decoder__choose_filter_implementations(self);
 
     goto ok;
@@ -37115,6 +46274,11 @@ wuffs_png__decoder__assign_filter_distance(
     self->private_impl.f_filter_distance = 1;
     self->private_impl.choosy_filter_and_swizzle = (
         &wuffs_png__decoder__filter_and_swizzle_tricky);
+    self->private_impl.choosy_unpack_bits = (
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+        wuffs_base__cpu_arch__have_x86_sse42() ? &wuffs_png__decoder__unpack_bits_x86_sse42 :
+#endif
+        self->private_impl.choosy_unpack_bits);
   } else if (self->private_impl.f_color_type == 0) {
     if (self->private_impl.f_depth == 8) {
       self->private_impl.f_dst_pixfmt = 536870920;
@@ -37235,10 +46399,66 @@ wuffs_png__decoder__choose_filter_implementations(
         wuffs_base__cpu_arch__have_x86_sse42() ? &wuffs_png__decoder__filter_4_distance_4_x86_sse42 :
 #endif
         &wuffs_png__decoder__filter_4_distance_4_fallback);
+  } else if (self->private_impl.f_filter_distance == 6) {
+    self->private_impl.choosy_filter_1 = (
+        &wuffs_png__decoder__filter_1_distance_6_fallback);
+    self->private_impl.choosy_filter_3 = (
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+        wuffs_base__cpu_arch__have_x86_sse42() ? &wuffs_png__decoder__filter_3_distance_6_x86_sse42 :
+#endif
+        self->private_impl.choosy_filter_3);
+    self->private_impl.choosy_filter_4 = (
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+        wuffs_base__cpu_arch__have_x86_sse42() ? &wuffs_png__decoder__filter_4_distance_6_x86_sse42 :
+#endif
+        self->private_impl.choosy_filter_4);
+  } else if (self->private_impl.f_filter_distance == 8) {
+    self->private_impl.choosy_filter_1 = (
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+        wuffs_base__cpu_arch__have_x86_sse42() ? &wuffs_png__decoder__filter_1_distance_8_x86_sse42 :
+#endif
+        self->private_impl.choosy_filter_1);
+    self->private_impl.choosy_filter_3 = (
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+        wuffs_base__cpu_arch__have_x86_sse42() ? &wuffs_png__decoder__filter_3_distance_8_x86_sse42 :
+#endif
+        self->private_impl.choosy_filter_3);
+    self->private_impl.choosy_filter_4 = (
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+        wuffs_base__cpu_arch__have_x86_sse42() ? &wuffs_png__decoder__filter_4_distance_8_x86_sse42 :
+#endif
+        self->private_impl.choosy_filter_4);
   }
   return wuffs_base__make_empty_struct();
 }
 
+// -------- func png.decoder.reported_metadata_fourcc
+
+static uint32_t
+wuffs_png__decoder__reported_metadata_fourcc(
+    const wuffs_png__decoder* self) {
+  if (self->private_impl.f_ignore_metadata) {
+    return 0;
+  } else if (self->private_impl.f_chunk_type == 1716082789) {
+    if (self->private_impl.f_report_metadata_exif) {
+      return 1163413830;
+    }
+  } else if (self->private_impl.f_chunk_type == 1095582055) {
+    if (self->private_impl.f_report_metadata_gama && (self->private_impl.f_chunk_length == 4)) {
+      return 1195461953;
+    }
+  } else if (self->private_impl.f_chunk_type == 1346585449) {
+    if (self->private_impl.f_report_metadata_iccp) {
+      return 1229144912;
+    }
+  } else if (self->private_impl.f_chunk_type == 1951942004) {
+    if (self->private_impl.f_report_metadata_kvp) {
+      return 1263947808;
+    }
+  }
+  return 0;
+}
+
 // -------- func png.decoder.decode_other_chunk
 
 static wuffs_base__status
@@ -37296,9 +46516,53 @@ wuffs_png__decoder__decode_other_chunk(
         goto suspend;
       }
       self->private_impl.f_seen_trns = true;
+    } else if (self->private_impl.f_chunk_type == 1280598881) {
+      if (self->private_impl.f_seen_actl) {
+        status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
+        goto exit;
+      }
+      if (a_src) {
+        a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+      }
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+      status = wuffs_png__decoder__decode_actl(self, a_src);
+      if (a_src) {
+        iop_a_src = a_src->data.ptr + a_src->meta.ri;
+      }
+      if (status.repr) {
+        goto suspend;
+      }
+      self->private_impl.f_seen_actl = true;
+    } else if ((self->private_impl.f_chunk_type == 1280598886) && self->private_impl.f_seen_actl) {
+      if (self->private_impl.f_seen_fctl) {
+        status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
+        goto exit;
+      }
+      if (a_src) {
+        a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+      }
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
+      status = wuffs_png__decoder__decode_fctl(self, a_src);
+      if (a_src) {
+        iop_a_src = a_src->data.ptr + a_src->meta.ri;
+      }
+      if (status.repr) {
+        goto suspend;
+      }
+      if ((self->private_impl.f_frame_rect_x0 != 0) ||
+          (self->private_impl.f_frame_rect_y0 != 0) ||
+          (self->private_impl.f_frame_rect_x1 != self->private_impl.f_width) ||
+          (self->private_impl.f_frame_rect_y1 != self->private_impl.f_height)) {
+        status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
+        goto exit;
+      }
+      self->private_impl.f_first_duration = self->private_impl.f_frame_duration;
+      self->private_impl.f_first_disposal = self->private_impl.f_frame_disposal;
+      self->private_impl.f_first_overwrite_instead_of_blend = self->private_impl.f_frame_overwrite_instead_of_blend;
+      self->private_impl.f_seen_fctl = true;
     } else {
       self->private_data.s_decode_other_chunk[0].scratch = self->private_impl.f_chunk_length;
-      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(5);
       if (self->private_data.s_decode_other_chunk[0].scratch > ((uint64_t)(io2_a_src - iop_a_src))) {
         self->private_data.s_decode_other_chunk[0].scratch -= ((uint64_t)(io2_a_src - iop_a_src));
         iop_a_src = io2_a_src;
@@ -37327,17 +46591,15 @@ wuffs_png__decoder__decode_other_chunk(
   return status;
 }
 
-// -------- func png.decoder.decode_plte
+// -------- func png.decoder.decode_actl
 
 static wuffs_base__status
-wuffs_png__decoder__decode_plte(
+wuffs_png__decoder__decode_actl(
     wuffs_png__decoder* self,
     wuffs_base__io_buffer* a_src) {
   wuffs_base__status status = wuffs_base__make_status(NULL);
 
-  uint32_t v_num_entries = 0;
-  uint32_t v_i = 0;
-  uint32_t v_argb = 0;
+  uint32_t v_num_frames = 0;
 
   const uint8_t* iop_a_src = NULL;
   const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
@@ -37350,62 +46612,502 @@ wuffs_png__decoder__decode_plte(
     io2_a_src = io0_a_src + a_src->meta.wi;
   }
 
-  uint32_t coro_susp_point = self->private_impl.p_decode_plte[0];
-  if (coro_susp_point) {
-    v_num_entries = self->private_data.s_decode_plte[0].v_num_entries;
-    v_i = self->private_data.s_decode_plte[0].v_i;
-  }
+  uint32_t coro_susp_point = self->private_impl.p_decode_actl[0];
   switch (coro_susp_point) {
     WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
 
-    if ((self->private_impl.f_chunk_length > 768) || ((self->private_impl.f_chunk_length % 3) != 0)) {
+    if (self->private_impl.f_chunk_length != 8) {
       status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
       goto exit;
     }
-    v_num_entries = (((uint32_t)(self->private_impl.f_chunk_length)) / 3);
-    while (v_i < v_num_entries) {
-      {
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
-        uint32_t t_0;
-        if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 3)) {
-          t_0 = ((uint32_t)(wuffs_base__peek_u24be__no_bounds_check(iop_a_src)));
-          iop_a_src += 3;
-        } else {
-          self->private_data.s_decode_plte[0].scratch = 0;
-          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
-          while (true) {
-            if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
-              status = wuffs_base__make_status(wuffs_base__suspension__short_read);
-              goto suspend;
-            }
-            uint64_t* scratch = &self->private_data.s_decode_plte[0].scratch;
-            uint32_t num_bits_0 = ((uint32_t)(*scratch & 0xFF));
-            *scratch >>= 8;
-            *scratch <<= 8;
-            *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_0);
-            if (num_bits_0 == 16) {
-              t_0 = ((uint32_t)(*scratch >> 40));
-              break;
-            }
-            num_bits_0 += 8;
-            *scratch |= ((uint64_t)(num_bits_0));
+    self->private_impl.f_chunk_length = 0;
+    {
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+      uint32_t t_0;
+      if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
+        t_0 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
+        iop_a_src += 4;
+      } else {
+        self->private_data.s_decode_actl[0].scratch = 0;
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+        while (true) {
+          if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+            goto suspend;
+          }
+          uint64_t* scratch = &self->private_data.s_decode_actl[0].scratch;
+          uint32_t num_bits_0 = ((uint32_t)(*scratch & 0xFF));
+          *scratch >>= 8;
+          *scratch <<= 8;
+          *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_0);
+          if (num_bits_0 == 24) {
+            t_0 = ((uint32_t)(*scratch >> 32));
+            break;
           }
+          num_bits_0 += 8;
+          *scratch |= ((uint64_t)(num_bits_0));
         }
-        v_argb = t_0;
       }
-      v_argb |= 4278190080;
-      self->private_data.f_src_palette[((4 * v_i) + 0)] = ((uint8_t)(((v_argb >> 0) & 255)));
-      self->private_data.f_src_palette[((4 * v_i) + 1)] = ((uint8_t)(((v_argb >> 8) & 255)));
-      self->private_data.f_src_palette[((4 * v_i) + 2)] = ((uint8_t)(((v_argb >> 16) & 255)));
-      self->private_data.f_src_palette[((4 * v_i) + 3)] = ((uint8_t)(((v_argb >> 24) & 255)));
-      v_i += 1;
+      v_num_frames = t_0;
     }
-    while (v_i < 256) {
-      self->private_data.f_src_palette[((4 * v_i) + 0)] = 0;
-      self->private_data.f_src_palette[((4 * v_i) + 1)] = 0;
-      self->private_data.f_src_palette[((4 * v_i) + 2)] = 0;
-      self->private_data.f_src_palette[((4 * v_i) + 3)] = 255;
-      v_i += 1;
+    if (v_num_frames == 0) {
+      status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
+      goto exit;
+    }
+    {
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+      uint32_t t_1;
+      if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
+        t_1 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
+        iop_a_src += 4;
+      } else {
+        self->private_data.s_decode_actl[0].scratch = 0;
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
+        while (true) {
+          if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+            goto suspend;
+          }
+          uint64_t* scratch = &self->private_data.s_decode_actl[0].scratch;
+          uint32_t num_bits_1 = ((uint32_t)(*scratch & 0xFF));
+          *scratch >>= 8;
+          *scratch <<= 8;
+          *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_1);
+          if (num_bits_1 == 24) {
+            t_1 = ((uint32_t)(*scratch >> 32));
+            break;
+          }
+          num_bits_1 += 8;
+          *scratch |= ((uint64_t)(num_bits_1));
+        }
+      }
+      self->private_impl.f_num_animation_loops_value = t_1;
+    }
+
+    goto ok;
+    ok:
+    self->private_impl.p_decode_actl[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_decode_actl[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+
+  goto exit;
+  exit:
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  }
+
+  return status;
+}
+
+// -------- func png.decoder.decode_fctl
+
+static wuffs_base__status
+wuffs_png__decoder__decode_fctl(
+    wuffs_png__decoder* self,
+    wuffs_base__io_buffer* a_src) {
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  uint32_t v_a32 = 0;
+  uint32_t v_width = 0;
+  uint32_t v_height = 0;
+  uint32_t v_x0 = 0;
+  uint32_t v_y0 = 0;
+  uint32_t v_num = 0;
+  uint32_t v_den = 0;
+  uint8_t v_disposal = 0;
+
+  const uint8_t* iop_a_src = NULL;
+  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_src) {
+    io0_a_src = a_src->data.ptr;
+    io1_a_src = io0_a_src + a_src->meta.ri;
+    iop_a_src = io1_a_src;
+    io2_a_src = io0_a_src + a_src->meta.wi;
+  }
+
+  uint32_t coro_susp_point = self->private_impl.p_decode_fctl[0];
+  if (coro_susp_point) {
+    v_a32 = self->private_data.s_decode_fctl[0].v_a32;
+    v_width = self->private_data.s_decode_fctl[0].v_width;
+    v_height = self->private_data.s_decode_fctl[0].v_height;
+    v_x0 = self->private_data.s_decode_fctl[0].v_x0;
+    v_num = self->private_data.s_decode_fctl[0].v_num;
+  }
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    if (self->private_impl.f_chunk_length != 26) {
+      status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
+      goto exit;
+    }
+    self->private_impl.f_chunk_length = 0;
+    {
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+      uint32_t t_0;
+      if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
+        t_0 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
+        iop_a_src += 4;
+      } else {
+        self->private_data.s_decode_fctl[0].scratch = 0;
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+        while (true) {
+          if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+            goto suspend;
+          }
+          uint64_t* scratch = &self->private_data.s_decode_fctl[0].scratch;
+          uint32_t num_bits_0 = ((uint32_t)(*scratch & 0xFF));
+          *scratch >>= 8;
+          *scratch <<= 8;
+          *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_0);
+          if (num_bits_0 == 24) {
+            t_0 = ((uint32_t)(*scratch >> 32));
+            break;
+          }
+          num_bits_0 += 8;
+          *scratch |= ((uint64_t)(num_bits_0));
+        }
+      }
+      v_a32 = t_0;
+    }
+    if ((v_a32 != self->private_impl.f_next_animation_seq_num) &&  ! self->private_impl.f_restarted) {
+      status = wuffs_base__make_status(wuffs_png__error__bad_animation_sequence_number);
+      goto exit;
+    } else if (v_a32 >= 4294967295) {
+      status = wuffs_base__make_status(wuffs_png__error__unsupported_png_file);
+      goto exit;
+    }
+    self->private_impl.f_next_animation_seq_num = (v_a32 + 1);
+    {
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+      uint32_t t_1;
+      if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
+        t_1 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
+        iop_a_src += 4;
+      } else {
+        self->private_data.s_decode_fctl[0].scratch = 0;
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
+        while (true) {
+          if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+            goto suspend;
+          }
+          uint64_t* scratch = &self->private_data.s_decode_fctl[0].scratch;
+          uint32_t num_bits_1 = ((uint32_t)(*scratch & 0xFF));
+          *scratch >>= 8;
+          *scratch <<= 8;
+          *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_1);
+          if (num_bits_1 == 24) {
+            t_1 = ((uint32_t)(*scratch >> 32));
+            break;
+          }
+          num_bits_1 += 8;
+          *scratch |= ((uint64_t)(num_bits_1));
+        }
+      }
+      v_width = t_1;
+    }
+    {
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(5);
+      uint32_t t_2;
+      if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
+        t_2 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
+        iop_a_src += 4;
+      } else {
+        self->private_data.s_decode_fctl[0].scratch = 0;
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(6);
+        while (true) {
+          if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+            goto suspend;
+          }
+          uint64_t* scratch = &self->private_data.s_decode_fctl[0].scratch;
+          uint32_t num_bits_2 = ((uint32_t)(*scratch & 0xFF));
+          *scratch >>= 8;
+          *scratch <<= 8;
+          *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_2);
+          if (num_bits_2 == 24) {
+            t_2 = ((uint32_t)(*scratch >> 32));
+            break;
+          }
+          num_bits_2 += 8;
+          *scratch |= ((uint64_t)(num_bits_2));
+        }
+      }
+      v_height = t_2;
+    }
+    {
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(7);
+      uint32_t t_3;
+      if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
+        t_3 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
+        iop_a_src += 4;
+      } else {
+        self->private_data.s_decode_fctl[0].scratch = 0;
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(8);
+        while (true) {
+          if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+            goto suspend;
+          }
+          uint64_t* scratch = &self->private_data.s_decode_fctl[0].scratch;
+          uint32_t num_bits_3 = ((uint32_t)(*scratch & 0xFF));
+          *scratch >>= 8;
+          *scratch <<= 8;
+          *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_3);
+          if (num_bits_3 == 24) {
+            t_3 = ((uint32_t)(*scratch >> 32));
+            break;
+          }
+          num_bits_3 += 8;
+          *scratch |= ((uint64_t)(num_bits_3));
+        }
+      }
+      v_x0 = t_3;
+    }
+    {
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(9);
+      uint32_t t_4;
+      if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
+        t_4 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
+        iop_a_src += 4;
+      } else {
+        self->private_data.s_decode_fctl[0].scratch = 0;
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(10);
+        while (true) {
+          if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+            goto suspend;
+          }
+          uint64_t* scratch = &self->private_data.s_decode_fctl[0].scratch;
+          uint32_t num_bits_4 = ((uint32_t)(*scratch & 0xFF));
+          *scratch >>= 8;
+          *scratch <<= 8;
+          *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_4);
+          if (num_bits_4 == 24) {
+            t_4 = ((uint32_t)(*scratch >> 32));
+            break;
+          }
+          num_bits_4 += 8;
+          *scratch |= ((uint64_t)(num_bits_4));
+        }
+      }
+      v_y0 = t_4;
+    }
+    if ((v_width == 0) ||
+        (v_height == 0) ||
+        ((((uint64_t)(v_x0)) + ((uint64_t)(v_width))) > ((uint64_t)(self->private_impl.f_width))) ||
+        ((((uint64_t)(v_y0)) + ((uint64_t)(v_height))) > ((uint64_t)(self->private_impl.f_height)))) {
+      status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
+      goto exit;
+    }
+    self->private_impl.f_frame_rect_x0 = (16777215 & v_x0);
+    self->private_impl.f_frame_rect_y0 = (16777215 & v_y0);
+    self->private_impl.f_frame_rect_x1 = (16777215 & ((uint32_t)(v_x0 + v_width)));
+    self->private_impl.f_frame_rect_y1 = (16777215 & ((uint32_t)(v_y0 + v_height)));
+    {
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(11);
+      uint32_t t_5;
+      if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 2)) {
+        t_5 = ((uint32_t)(wuffs_base__peek_u16be__no_bounds_check(iop_a_src)));
+        iop_a_src += 2;
+      } else {
+        self->private_data.s_decode_fctl[0].scratch = 0;
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(12);
+        while (true) {
+          if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+            goto suspend;
+          }
+          uint64_t* scratch = &self->private_data.s_decode_fctl[0].scratch;
+          uint32_t num_bits_5 = ((uint32_t)(*scratch & 0xFF));
+          *scratch >>= 8;
+          *scratch <<= 8;
+          *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_5);
+          if (num_bits_5 == 8) {
+            t_5 = ((uint32_t)(*scratch >> 48));
+            break;
+          }
+          num_bits_5 += 8;
+          *scratch |= ((uint64_t)(num_bits_5));
+        }
+      }
+      v_num = t_5;
+    }
+    {
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(13);
+      uint32_t t_6;
+      if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 2)) {
+        t_6 = ((uint32_t)(wuffs_base__peek_u16be__no_bounds_check(iop_a_src)));
+        iop_a_src += 2;
+      } else {
+        self->private_data.s_decode_fctl[0].scratch = 0;
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(14);
+        while (true) {
+          if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+            goto suspend;
+          }
+          uint64_t* scratch = &self->private_data.s_decode_fctl[0].scratch;
+          uint32_t num_bits_6 = ((uint32_t)(*scratch & 0xFF));
+          *scratch >>= 8;
+          *scratch <<= 8;
+          *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_6);
+          if (num_bits_6 == 8) {
+            t_6 = ((uint32_t)(*scratch >> 48));
+            break;
+          }
+          num_bits_6 += 8;
+          *scratch |= ((uint64_t)(num_bits_6));
+        }
+      }
+      v_den = t_6;
+    }
+    if (v_den == 0) {
+      self->private_impl.f_frame_duration = (((uint64_t)(v_num)) * 7056000);
+    } else if (v_den > 0) {
+      self->private_impl.f_frame_duration = ((((uint64_t)(v_num)) * 705600000) / ((uint64_t)(v_den)));
+    }
+    {
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(15);
+      if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+        status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+        goto suspend;
+      }
+      uint8_t t_7 = *iop_a_src++;
+      v_disposal = t_7;
+    }
+    if (v_disposal > 2) {
+      status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
+      goto exit;
+    } else if ((v_disposal == 2) && (v_a32 == 0)) {
+      v_disposal = 1;
+    }
+    self->private_impl.f_frame_disposal = v_disposal;
+    {
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(16);
+      if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+        status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+        goto suspend;
+      }
+      uint32_t t_8 = *iop_a_src++;
+      v_a32 = t_8;
+    }
+    if (v_a32 > 1) {
+      status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
+      goto exit;
+    }
+    self->private_impl.f_frame_overwrite_instead_of_blend = (v_a32 == 0);
+
+    goto ok;
+    ok:
+    self->private_impl.p_decode_fctl[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_decode_fctl[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+  self->private_data.s_decode_fctl[0].v_a32 = v_a32;
+  self->private_data.s_decode_fctl[0].v_width = v_width;
+  self->private_data.s_decode_fctl[0].v_height = v_height;
+  self->private_data.s_decode_fctl[0].v_x0 = v_x0;
+  self->private_data.s_decode_fctl[0].v_num = v_num;
+
+  goto exit;
+  exit:
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  }
+
+  return status;
+}
+
+// -------- func png.decoder.decode_plte
+
+static wuffs_base__status
+wuffs_png__decoder__decode_plte(
+    wuffs_png__decoder* self,
+    wuffs_base__io_buffer* a_src) {
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  uint32_t v_num_entries = 0;
+  uint32_t v_i = 0;
+  uint32_t v_argb = 0;
+
+  const uint8_t* iop_a_src = NULL;
+  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_src) {
+    io0_a_src = a_src->data.ptr;
+    io1_a_src = io0_a_src + a_src->meta.ri;
+    iop_a_src = io1_a_src;
+    io2_a_src = io0_a_src + a_src->meta.wi;
+  }
+
+  uint32_t coro_susp_point = self->private_impl.p_decode_plte[0];
+  if (coro_susp_point) {
+    v_num_entries = self->private_data.s_decode_plte[0].v_num_entries;
+    v_i = self->private_data.s_decode_plte[0].v_i;
+  }
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    if ((self->private_impl.f_chunk_length > 768) || ((self->private_impl.f_chunk_length % 3) != 0)) {
+      status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
+      goto exit;
+    }
+    v_num_entries = (((uint32_t)(self->private_impl.f_chunk_length)) / 3);
+    while (v_i < v_num_entries) {
+      {
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+        uint32_t t_0;
+        if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 3)) {
+          t_0 = ((uint32_t)(wuffs_base__peek_u24be__no_bounds_check(iop_a_src)));
+          iop_a_src += 3;
+        } else {
+          self->private_data.s_decode_plte[0].scratch = 0;
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+          while (true) {
+            if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+              status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+              goto suspend;
+            }
+            uint64_t* scratch = &self->private_data.s_decode_plte[0].scratch;
+            uint32_t num_bits_0 = ((uint32_t)(*scratch & 0xFF));
+            *scratch >>= 8;
+            *scratch <<= 8;
+            *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_0);
+            if (num_bits_0 == 16) {
+              t_0 = ((uint32_t)(*scratch >> 40));
+              break;
+            }
+            num_bits_0 += 8;
+            *scratch |= ((uint64_t)(num_bits_0));
+          }
+        }
+        v_argb = t_0;
+      }
+      v_argb |= 4278190080;
+      self->private_data.f_src_palette[((4 * v_i) + 0)] = ((uint8_t)(((v_argb >> 0) & 255)));
+      self->private_data.f_src_palette[((4 * v_i) + 1)] = ((uint8_t)(((v_argb >> 8) & 255)));
+      self->private_data.f_src_palette[((4 * v_i) + 2)] = ((uint8_t)(((v_argb >> 16) & 255)));
+      self->private_data.f_src_palette[((4 * v_i) + 3)] = ((uint8_t)(((v_argb >> 24) & 255)));
+      v_i += 1;
+    }
+    while (v_i < 256) {
+      self->private_data.f_src_palette[((4 * v_i) + 0)] = 0;
+      self->private_data.f_src_palette[((4 * v_i) + 1)] = 0;
+      self->private_data.f_src_palette[((4 * v_i) + 2)] = 0;
+      self->private_data.f_src_palette[((4 * v_i) + 3)] = 255;
+      v_i += 1;
     }
 
     goto ok;
@@ -37555,6 +47257,7 @@ wuffs_png__decoder__decode_frame_config(
   switch (coro_susp_point) {
     WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
 
+    self->private_impl.f_ignore_metadata = true;
     if (self->private_impl.f_call_sequence < 3) {
       if (a_src) {
         a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
@@ -37573,10 +47276,73 @@ wuffs_png__decoder__decode_frame_config(
         goto exit;
       }
     } else if (self->private_impl.f_call_sequence == 4) {
-      self->private_impl.f_call_sequence = 255;
-      status = wuffs_base__make_status(wuffs_base__note__end_of_data);
-      goto ok;
-    } else {
+      if (a_src) {
+        a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+      }
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+      status = wuffs_png__decoder__skip_frame(self, a_src);
+      if (a_src) {
+        iop_a_src = a_src->data.ptr + a_src->meta.ri;
+      }
+      if (status.repr) {
+        goto suspend;
+      }
+    } else if (self->private_impl.f_call_sequence == 5) {
+      if (self->private_impl.f_restarted && (self->private_impl.f_frame_config_io_position != wuffs_base__u64__sat_add(a_src->meta.pos, ((uint64_t)(iop_a_src - io0_a_src))))) {
+        status = wuffs_base__make_status(wuffs_base__error__bad_restart);
+        goto exit;
+      }
+    }
+    if (self->private_impl.f_call_sequence == 3) {
+      self->private_impl.f_chunk_type = 1413563465;
+      self->private_impl.f_chunk_length = self->private_impl.f_first_idat_chunk_length;
+      if ( ! self->private_impl.f_ignore_checksum) {
+        wuffs_base__ignore_status(wuffs_crc32__ieee_hasher__initialize(&self->private_data.f_crc32, sizeof (wuffs_crc32__ieee_hasher), WUFFS_VERSION, 0));
+        self->private_impl.f_chunk_type_array[0] = 73;
+        self->private_impl.f_chunk_type_array[1] = 68;
+        self->private_impl.f_chunk_type_array[2] = 65;
+        self->private_impl.f_chunk_type_array[3] = 84;
+        wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_crc32, wuffs_base__make_slice_u8(self->private_impl.f_chunk_type_array, 4));
+      }
+      self->private_impl.f_frame_rect_x0 = 0;
+      self->private_impl.f_frame_rect_y0 = 0;
+      self->private_impl.f_frame_rect_x1 = self->private_impl.f_width;
+      self->private_impl.f_frame_rect_y1 = self->private_impl.f_height;
+      self->private_impl.f_frame_duration = self->private_impl.f_first_duration;
+      self->private_impl.f_frame_disposal = self->private_impl.f_first_disposal;
+      self->private_impl.f_frame_overwrite_instead_of_blend = self->private_impl.f_first_overwrite_instead_of_blend;
+      self->private_impl.f_next_animation_seq_num = 0;
+      if (self->private_impl.f_seen_fctl) {
+        self->private_impl.f_next_animation_seq_num = 1;
+      } else if (self->private_impl.f_seen_actl) {
+        if (a_src) {
+          a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+        }
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+        status = wuffs_png__decoder__skip_data_chunks(self, a_src);
+        if (a_src) {
+          iop_a_src = a_src->data.ptr + a_src->meta.ri;
+        }
+        if (status.repr) {
+          goto suspend;
+        }
+        self->private_impl.f_call_sequence = 5;
+      }
+    }
+    if (self->private_impl.f_call_sequence == 5) {
+      if (a_src) {
+        a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+      }
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
+      status = wuffs_png__decoder__decode_up_to_fdat(self, a_src);
+      if (a_src) {
+        iop_a_src = a_src->data.ptr + a_src->meta.ri;
+      }
+      if (status.repr) {
+        goto suspend;
+      }
+    }
+    if (self->private_impl.f_call_sequence == 255) {
       status = wuffs_base__make_status(wuffs_base__note__end_of_data);
       goto ok;
     }
@@ -37584,52 +47350,2606 @@ wuffs_png__decoder__decode_frame_config(
       wuffs_base__frame_config__set(
           a_dst,
           wuffs_base__utility__make_rect_ie_u32(
-          0,
-          0,
-          self->private_impl.f_width,
-          self->private_impl.f_height),
-          ((wuffs_base__flicks)(0)),
-          0,
+          self->private_impl.f_frame_rect_x0,
+          self->private_impl.f_frame_rect_y0,
+          self->private_impl.f_frame_rect_x1,
+          self->private_impl.f_frame_rect_y1),
+          ((wuffs_base__flicks)(self->private_impl.f_frame_duration)),
+          self->private_impl.f_num_decoded_frame_configs_value,
           self->private_impl.f_frame_config_io_position,
-          0,
-          false,
+          self->private_impl.f_frame_disposal,
           false,
+          self->private_impl.f_frame_overwrite_instead_of_blend,
           0);
     }
+    wuffs_base__u64__sat_add_indirect(&self->private_impl.f_num_decoded_frame_configs_value, 1);
+    self->private_impl.f_restarted = false;
     self->private_impl.f_call_sequence = 4;
 
-    ok:
-    self->private_impl.p_decode_frame_config[0] = 0;
-    goto exit;
+    ok:
+    self->private_impl.p_decode_frame_config[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_decode_frame_config[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+  self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 2 : 0;
+
+  goto exit;
+  exit:
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  }
+
+  if (wuffs_base__status__is_error(&status)) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+  }
+  return status;
+}
+
+// -------- func png.decoder.skip_frame
+
+static wuffs_base__status
+wuffs_png__decoder__skip_frame(
+    wuffs_png__decoder* self,
+    wuffs_base__io_buffer* a_src) {
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  uint32_t coro_susp_point = self->private_impl.p_skip_frame[0];
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    wuffs_base__u64__sat_add_indirect(&self->private_impl.f_num_decoded_frames_value, 1);
+    if ( ! self->private_impl.f_seen_actl) {
+      self->private_impl.f_call_sequence = 255;
+      status = wuffs_base__make_status(NULL);
+      goto ok;
+    }
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+    status = wuffs_png__decoder__skip_data_chunks(self, a_src);
+    if (status.repr) {
+      goto suspend;
+    }
+    self->private_impl.f_call_sequence = 5;
+
+    ok:
+    self->private_impl.p_skip_frame[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_skip_frame[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+
+  goto exit;
+  exit:
+  return status;
+}
+
+// -------- func png.decoder.skip_data_chunks
+
+static wuffs_base__status
+wuffs_png__decoder__skip_data_chunks(
+    wuffs_png__decoder* self,
+    wuffs_base__io_buffer* a_src) {
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  const uint8_t* iop_a_src = NULL;
+  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_src) {
+    io0_a_src = a_src->data.ptr;
+    io1_a_src = io0_a_src + a_src->meta.ri;
+    iop_a_src = io1_a_src;
+    io2_a_src = io0_a_src + a_src->meta.wi;
+  }
+
+  uint32_t coro_susp_point = self->private_impl.p_skip_data_chunks[0];
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    while (true) {
+      self->private_data.s_skip_data_chunks[0].scratch = self->private_impl.f_chunk_length;
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+      if (self->private_data.s_skip_data_chunks[0].scratch > ((uint64_t)(io2_a_src - iop_a_src))) {
+        self->private_data.s_skip_data_chunks[0].scratch -= ((uint64_t)(io2_a_src - iop_a_src));
+        iop_a_src = io2_a_src;
+        status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+        goto suspend;
+      }
+      iop_a_src += self->private_data.s_skip_data_chunks[0].scratch;
+      self->private_data.s_skip_data_chunks[0].scratch = 4;
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+      if (self->private_data.s_skip_data_chunks[0].scratch > ((uint64_t)(io2_a_src - iop_a_src))) {
+        self->private_data.s_skip_data_chunks[0].scratch -= ((uint64_t)(io2_a_src - iop_a_src));
+        iop_a_src = io2_a_src;
+        status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+        goto suspend;
+      }
+      iop_a_src += self->private_data.s_skip_data_chunks[0].scratch;
+      self->private_impl.f_chunk_length = 0;
+      while (((uint64_t)(io2_a_src - iop_a_src)) < 8) {
+        status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(3);
+      }
+      if (self->private_impl.f_chunk_type != ((uint32_t)((wuffs_base__peek_u64le__no_bounds_check(iop_a_src) >> 32)))) {
+        goto label__0__break;
+      }
+      if (a_src) {
+        a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+      }
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
+      status = wuffs_png__decoder__read_data_chunk_header(self, a_src);
+      if (a_src) {
+        iop_a_src = a_src->data.ptr + a_src->meta.ri;
+      }
+      if (status.repr) {
+        goto suspend;
+      }
+    }
+    label__0__break:;
+
+    ok:
+    self->private_impl.p_skip_data_chunks[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_skip_data_chunks[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+
+  goto exit;
+  exit:
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  }
+
+  return status;
+}
+
+// -------- func png.decoder.decode_up_to_fdat
+
+static wuffs_base__status
+wuffs_png__decoder__decode_up_to_fdat(
+    wuffs_png__decoder* self,
+    wuffs_base__io_buffer* a_src) {
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  const uint8_t* iop_a_src = NULL;
+  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_src) {
+    io0_a_src = a_src->data.ptr;
+    io1_a_src = io0_a_src + a_src->meta.ri;
+    iop_a_src = io1_a_src;
+    io2_a_src = io0_a_src + a_src->meta.wi;
+  }
+
+  uint32_t coro_susp_point = self->private_impl.p_decode_up_to_fdat[0];
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    while (true) {
+      self->private_impl.f_frame_config_io_position = wuffs_base__u64__sat_add(a_src->meta.pos, ((uint64_t)(iop_a_src - io0_a_src)));
+      {
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+        uint64_t t_0;
+        if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
+          t_0 = ((uint64_t)(wuffs_base__peek_u32be__no_bounds_check(iop_a_src)));
+          iop_a_src += 4;
+        } else {
+          self->private_data.s_decode_up_to_fdat[0].scratch = 0;
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+          while (true) {
+            if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+              status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+              goto suspend;
+            }
+            uint64_t* scratch = &self->private_data.s_decode_up_to_fdat[0].scratch;
+            uint32_t num_bits_0 = ((uint32_t)(*scratch & 0xFF));
+            *scratch >>= 8;
+            *scratch <<= 8;
+            *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_0);
+            if (num_bits_0 == 24) {
+              t_0 = ((uint64_t)(*scratch >> 32));
+              break;
+            }
+            num_bits_0 += 8;
+            *scratch |= ((uint64_t)(num_bits_0));
+          }
+        }
+        self->private_impl.f_chunk_length = t_0;
+      }
+      {
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+        uint32_t t_1;
+        if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
+          t_1 = wuffs_base__peek_u32le__no_bounds_check(iop_a_src);
+          iop_a_src += 4;
+        } else {
+          self->private_data.s_decode_up_to_fdat[0].scratch = 0;
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
+          while (true) {
+            if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+              status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+              goto suspend;
+            }
+            uint64_t* scratch = &self->private_data.s_decode_up_to_fdat[0].scratch;
+            uint32_t num_bits_1 = ((uint32_t)(*scratch >> 56));
+            *scratch <<= 8;
+            *scratch >>= 8;
+            *scratch |= ((uint64_t)(*iop_a_src++)) << num_bits_1;
+            if (num_bits_1 == 24) {
+              t_1 = ((uint32_t)(*scratch));
+              break;
+            }
+            num_bits_1 += 8;
+            *scratch |= ((uint64_t)(num_bits_1)) << 56;
+          }
+        }
+        self->private_impl.f_chunk_type = t_1;
+      }
+      if (self->private_impl.f_chunk_type == 1280598886) {
+        if (a_src) {
+          a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+        }
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(5);
+        status = wuffs_png__decoder__decode_fctl(self, a_src);
+        if (a_src) {
+          iop_a_src = a_src->data.ptr + a_src->meta.ri;
+        }
+        if (status.repr) {
+          goto suspend;
+        }
+        self->private_data.s_decode_up_to_fdat[0].scratch = 4;
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(6);
+        if (self->private_data.s_decode_up_to_fdat[0].scratch > ((uint64_t)(io2_a_src - iop_a_src))) {
+          self->private_data.s_decode_up_to_fdat[0].scratch -= ((uint64_t)(io2_a_src - iop_a_src));
+          iop_a_src = io2_a_src;
+          status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+          goto suspend;
+        }
+        iop_a_src += self->private_data.s_decode_up_to_fdat[0].scratch;
+        goto label__0__break;
+      } else if (self->private_impl.f_chunk_type == 1145980233) {
+        self->private_impl.f_call_sequence = 255;
+        status = wuffs_base__make_status(NULL);
+        goto ok;
+      } else if (self->private_impl.f_chunk_type == 1413571686) {
+        status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
+        goto exit;
+      }
+      self->private_data.s_decode_up_to_fdat[0].scratch = self->private_impl.f_chunk_length;
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(7);
+      if (self->private_data.s_decode_up_to_fdat[0].scratch > ((uint64_t)(io2_a_src - iop_a_src))) {
+        self->private_data.s_decode_up_to_fdat[0].scratch -= ((uint64_t)(io2_a_src - iop_a_src));
+        iop_a_src = io2_a_src;
+        status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+        goto suspend;
+      }
+      iop_a_src += self->private_data.s_decode_up_to_fdat[0].scratch;
+      self->private_data.s_decode_up_to_fdat[0].scratch = 4;
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(8);
+      if (self->private_data.s_decode_up_to_fdat[0].scratch > ((uint64_t)(io2_a_src - iop_a_src))) {
+        self->private_data.s_decode_up_to_fdat[0].scratch -= ((uint64_t)(io2_a_src - iop_a_src));
+        iop_a_src = io2_a_src;
+        status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+        goto suspend;
+      }
+      iop_a_src += self->private_data.s_decode_up_to_fdat[0].scratch;
+    }
+    label__0__break:;
+    self->private_impl.f_chunk_type = 1413571686;
+    if (a_src) {
+      a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+    }
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(9);
+    status = wuffs_png__decoder__read_data_chunk_header(self, a_src);
+    if (a_src) {
+      iop_a_src = a_src->data.ptr + a_src->meta.ri;
+    }
+    if (status.repr) {
+      goto suspend;
+    }
+
+    ok:
+    self->private_impl.p_decode_up_to_fdat[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_decode_up_to_fdat[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+
+  goto exit;
+  exit:
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  }
+
+  return status;
+}
+
+// -------- func png.decoder.read_data_chunk_header
+
+static wuffs_base__status
+wuffs_png__decoder__read_data_chunk_header(
+    wuffs_png__decoder* self,
+    wuffs_base__io_buffer* a_src) {
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  uint32_t v_chunk_type = 0;
+  uint32_t v_a32 = 0;
+
+  const uint8_t* iop_a_src = NULL;
+  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_src) {
+    io0_a_src = a_src->data.ptr;
+    io1_a_src = io0_a_src + a_src->meta.ri;
+    iop_a_src = io1_a_src;
+    io2_a_src = io0_a_src + a_src->meta.wi;
+  }
+
+  uint32_t coro_susp_point = self->private_impl.p_read_data_chunk_header[0];
+  if (coro_susp_point) {
+    v_chunk_type = self->private_data.s_read_data_chunk_header[0].v_chunk_type;
+  }
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    v_chunk_type = self->private_impl.f_chunk_type;
+    {
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+      uint64_t t_0;
+      if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
+        t_0 = ((uint64_t)(wuffs_base__peek_u32be__no_bounds_check(iop_a_src)));
+        iop_a_src += 4;
+      } else {
+        self->private_data.s_read_data_chunk_header[0].scratch = 0;
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+        while (true) {
+          if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+            goto suspend;
+          }
+          uint64_t* scratch = &self->private_data.s_read_data_chunk_header[0].scratch;
+          uint32_t num_bits_0 = ((uint32_t)(*scratch & 0xFF));
+          *scratch >>= 8;
+          *scratch <<= 8;
+          *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_0);
+          if (num_bits_0 == 24) {
+            t_0 = ((uint64_t)(*scratch >> 32));
+            break;
+          }
+          num_bits_0 += 8;
+          *scratch |= ((uint64_t)(num_bits_0));
+        }
+      }
+      self->private_impl.f_chunk_length = t_0;
+    }
+    {
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+      uint32_t t_1;
+      if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
+        t_1 = wuffs_base__peek_u32le__no_bounds_check(iop_a_src);
+        iop_a_src += 4;
+      } else {
+        self->private_data.s_read_data_chunk_header[0].scratch = 0;
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
+        while (true) {
+          if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+            goto suspend;
+          }
+          uint64_t* scratch = &self->private_data.s_read_data_chunk_header[0].scratch;
+          uint32_t num_bits_1 = ((uint32_t)(*scratch >> 56));
+          *scratch <<= 8;
+          *scratch >>= 8;
+          *scratch |= ((uint64_t)(*iop_a_src++)) << num_bits_1;
+          if (num_bits_1 == 24) {
+            t_1 = ((uint32_t)(*scratch));
+            break;
+          }
+          num_bits_1 += 8;
+          *scratch |= ((uint64_t)(num_bits_1)) << 56;
+        }
+      }
+      self->private_impl.f_chunk_type = t_1;
+    }
+    if (self->private_impl.f_chunk_type != v_chunk_type) {
+      status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
+      goto exit;
+    }
+    if ( ! self->private_impl.f_ignore_checksum) {
+      wuffs_base__ignore_status(wuffs_crc32__ieee_hasher__initialize(&self->private_data.f_crc32, sizeof (wuffs_crc32__ieee_hasher), WUFFS_VERSION, 0));
+      self->private_impl.f_chunk_type_array[0] = ((uint8_t)(((v_chunk_type >> 0) & 255)));
+      self->private_impl.f_chunk_type_array[1] = ((uint8_t)(((v_chunk_type >> 8) & 255)));
+      self->private_impl.f_chunk_type_array[2] = ((uint8_t)(((v_chunk_type >> 16) & 255)));
+      self->private_impl.f_chunk_type_array[3] = ((uint8_t)(((v_chunk_type >> 24) & 255)));
+      wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_crc32, wuffs_base__make_slice_u8(self->private_impl.f_chunk_type_array, 4));
+    }
+    if (v_chunk_type == 1413571686) {
+      if (self->private_impl.f_chunk_length < 4) {
+        status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
+        goto exit;
+      }
+      self->private_impl.f_chunk_length -= 4;
+      {
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(5);
+        uint32_t t_2;
+        if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
+          t_2 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
+          iop_a_src += 4;
+        } else {
+          self->private_data.s_read_data_chunk_header[0].scratch = 0;
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(6);
+          while (true) {
+            if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+              status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+              goto suspend;
+            }
+            uint64_t* scratch = &self->private_data.s_read_data_chunk_header[0].scratch;
+            uint32_t num_bits_2 = ((uint32_t)(*scratch & 0xFF));
+            *scratch >>= 8;
+            *scratch <<= 8;
+            *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_2);
+            if (num_bits_2 == 24) {
+              t_2 = ((uint32_t)(*scratch >> 32));
+              break;
+            }
+            num_bits_2 += 8;
+            *scratch |= ((uint64_t)(num_bits_2));
+          }
+        }
+        v_a32 = t_2;
+      }
+      if (v_a32 != self->private_impl.f_next_animation_seq_num) {
+        status = wuffs_base__make_status(wuffs_png__error__bad_animation_sequence_number);
+        goto exit;
+      } else if (v_a32 >= 4294967295) {
+        status = wuffs_base__make_status(wuffs_png__error__unsupported_png_file);
+        goto exit;
+      }
+      self->private_impl.f_next_animation_seq_num = (v_a32 + 1);
+      if ( ! self->private_impl.f_ignore_checksum) {
+        self->private_impl.f_chunk_type_array[0] = ((uint8_t)(((v_a32 >> 24) & 255)));
+        self->private_impl.f_chunk_type_array[1] = ((uint8_t)(((v_a32 >> 16) & 255)));
+        self->private_impl.f_chunk_type_array[2] = ((uint8_t)(((v_a32 >> 8) & 255)));
+        self->private_impl.f_chunk_type_array[3] = ((uint8_t)(((v_a32 >> 0) & 255)));
+        wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_crc32, wuffs_base__make_slice_u8(self->private_impl.f_chunk_type_array, 4));
+      }
+    }
+
+    goto ok;
+    ok:
+    self->private_impl.p_read_data_chunk_header[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_read_data_chunk_header[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+  self->private_data.s_read_data_chunk_header[0].v_chunk_type = v_chunk_type;
+
+  goto exit;
+  exit:
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  }
+
+  return status;
+}
+
+// -------- func png.decoder.decode_frame
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_png__decoder__decode_frame(
+    wuffs_png__decoder* self,
+    wuffs_base__pixel_buffer* a_dst,
+    wuffs_base__io_buffer* a_src,
+    wuffs_base__pixel_blend a_blend,
+    wuffs_base__slice_u8 a_workbuf,
+    wuffs_base__decode_frame_options* a_opts) {
+  if (!self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+  }
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_status(
+        (self->private_impl.magic == WUFFS_BASE__DISABLED)
+        ? wuffs_base__error__disabled_by_previous_error
+        : wuffs_base__error__initialize_not_called);
+  }
+  if (!a_dst || !a_src) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+    return wuffs_base__make_status(wuffs_base__error__bad_argument);
+  }
+  if ((self->private_impl.active_coroutine != 0) &&
+      (self->private_impl.active_coroutine != 3)) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+    return wuffs_base__make_status(wuffs_base__error__interleaved_coroutine_calls);
+  }
+  self->private_impl.active_coroutine = 0;
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  wuffs_base__status v_status = wuffs_base__make_status(NULL);
+  uint32_t v_frame_width = 0;
+  uint32_t v_frame_height = 0;
+  uint32_t v_pass_width = 0;
+  uint32_t v_pass_height = 0;
+  uint32_t v_shift = 0;
+
+  uint32_t coro_susp_point = self->private_impl.p_decode_frame[0];
+  if (coro_susp_point) {
+    v_frame_width = self->private_data.s_decode_frame[0].v_frame_width;
+    v_frame_height = self->private_data.s_decode_frame[0].v_frame_height;
+    v_pass_width = self->private_data.s_decode_frame[0].v_pass_width;
+    v_pass_height = self->private_data.s_decode_frame[0].v_pass_height;
+    v_shift = self->private_data.s_decode_frame[0].v_shift;
+  }
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    if (self->private_impl.f_call_sequence != 4) {
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+      status = wuffs_png__decoder__decode_frame_config(self, NULL, a_src);
+      if (status.repr) {
+        goto suspend;
+      }
+    }
+    v_status = wuffs_base__pixel_swizzler__prepare(&self->private_impl.f_swizzler,
+        wuffs_base__pixel_buffer__pixel_format(a_dst),
+        wuffs_base__pixel_buffer__palette_or_else(a_dst, wuffs_base__make_slice_u8(self->private_data.f_dst_palette, 1024)),
+        wuffs_base__utility__make_pixel_format(self->private_impl.f_src_pixfmt),
+        wuffs_base__make_slice_u8(self->private_data.f_src_palette, 1024),
+        a_blend);
+    if ( ! wuffs_base__status__is_ok(&v_status)) {
+      status = v_status;
+      if (wuffs_base__status__is_error(&status)) {
+        goto exit;
+      } else if (wuffs_base__status__is_suspension(&status)) {
+        status = wuffs_base__make_status(wuffs_base__error__cannot_return_a_suspension);
+        goto exit;
+      }
+      goto ok;
+    }
+    if (self->private_impl.f_zlib_is_dirty) {
+      wuffs_base__ignore_status(wuffs_zlib__decoder__initialize(&self->private_data.f_zlib, sizeof (wuffs_zlib__decoder), WUFFS_VERSION, 0));
+      wuffs_zlib__decoder__set_quirk_enabled(&self->private_data.f_zlib, 1, self->private_impl.f_ignore_checksum);
+    }
+    self->private_impl.f_zlib_is_dirty = true;
+    self->private_impl.f_roi_x0 = 0;
+    self->private_impl.f_roi_y0 = 0;
+    self->private_impl.f_roi_x1 = 4294967295;
+    self->private_impl.f_roi_y1 = 4294967295;
+    if (a_opts != NULL) {
+      self->private_impl.f_roi_x0 = wuffs_base__decode_frame_options__roi_min_incl_x(a_opts);
+      self->private_impl.f_roi_y0 = wuffs_base__decode_frame_options__roi_min_incl_y(a_opts);
+      self->private_impl.f_roi_x1 = wuffs_base__decode_frame_options__roi_max_excl_x(a_opts);
+      self->private_impl.f_roi_y1 = wuffs_base__decode_frame_options__roi_max_excl_y(a_opts);
+      v_shift = wuffs_base__decode_frame_options__downscale_shift(a_opts);
+    }
+    self->private_impl.f_downscale_shift = 0;
+    if (v_shift > 0) {
+      if ((v_shift > 3) ||
+          (self->private_impl.f_roi_x0 > 0) ||
+          (self->private_impl.f_roi_y0 > 0) ||
+          (self->private_impl.f_roi_x1 < 4294967295) ||
+          (self->private_impl.f_roi_y1 < 4294967295)) {
+        status = wuffs_base__make_status(wuffs_base__error__unsupported_option);
+        goto exit;
+      }
+      self->private_impl.f_downscale_shift = v_shift;
+      if (self->private_impl.f_interlace_pass == 0) {
+        v_status = wuffs_base__pixel_swizzler__prepare_downscaled(&self->private_impl.f_downscaler,
+            wuffs_base__pixel_buffer__pixel_format(a_dst),
+            wuffs_base__pixel_buffer__palette_or_else(a_dst, wuffs_base__make_slice_u8(self->private_data.f_dst_palette, 1024)),
+            wuffs_base__utility__make_pixel_format(self->private_impl.f_src_pixfmt),
+            wuffs_base__make_slice_u8(self->private_data.f_src_palette, 1024),
+            a_blend);
+        if ( ! wuffs_base__status__is_ok(&v_status)) {
+          status = v_status;
+          if (wuffs_base__status__is_error(&status)) {
+            goto exit;
+          } else if (wuffs_base__status__is_suspension(&status)) {
+            status = wuffs_base__make_status(wuffs_base__error__cannot_return_a_suspension);
+            goto exit;
+          }
+          goto ok;
+        }
+      }
+    }
+    v_frame_width = (16777215 & ((uint32_t)(self->private_impl.f_frame_rect_x1 - self->private_impl.f_frame_rect_x0)));
+    v_frame_height = (16777215 & ((uint32_t)(self->private_impl.f_frame_rect_y1 - self->private_impl.f_frame_rect_y0)));
+    while (true) {
+      v_pass_width = (16777215 & ((((uint32_t)(WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][1])) + v_frame_width) >> WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][0]));
+      v_pass_height = (16777215 & ((((uint32_t)(WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][4])) + v_frame_height) >> WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][3]));
+      if ((v_pass_width > 0) && (v_pass_height > 0)) {
+        if (((self->private_impl.f_downscale_shift * 2) + ((uint32_t)(self->private_impl.f_interlace_pass))) > 7) {
+          if (self->private_impl.f_seen_actl) {
+            WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+            status = wuffs_png__decoder__skip_data_chunks(self, a_src);
+            if (status.repr) {
+              goto suspend;
+            }
+          }
+          goto label__0__break;
+        }
+        self->private_impl.f_pass_bytes_per_row = wuffs_png__decoder__calculate_bytes_per_row(self, v_pass_width);
+        self->private_impl.f_pass_workbuf_length = (((uint64_t)(v_pass_height)) * (1 + self->private_impl.f_pass_bytes_per_row));
+        self->private_impl.f_dst_y = (self->private_impl.f_frame_rect_y0 + ((uint32_t)(WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][5])));
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+        status = wuffs_png__decoder__decode_pass(self, a_dst, a_src, a_workbuf);
+        if (status.repr) {
+          goto suspend;
+        }
+      }
+      if ((self->private_impl.f_interlace_pass == 0) || (self->private_impl.f_interlace_pass >= 7)) {
+        goto label__0__break;
+      }
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif
+      self->private_impl.f_interlace_pass += 1;
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+    }
+    label__0__break:;
+    if (self->private_impl.f_interlace_pass >= 1) {
+      self->private_impl.f_interlace_pass = 1;
+    }
+    wuffs_base__u64__sat_add_indirect(&self->private_impl.f_num_decoded_frames_value, 1);
+    if (self->private_impl.f_seen_actl) {
+      self->private_impl.f_call_sequence = 5;
+    } else {
+      self->private_impl.f_call_sequence = 255;
+    }
+
+    ok:
+    self->private_impl.p_decode_frame[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_decode_frame[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+  self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 3 : 0;
+  self->private_data.s_decode_frame[0].v_frame_width = v_frame_width;
+  self->private_data.s_decode_frame[0].v_frame_height = v_frame_height;
+  self->private_data.s_decode_frame[0].v_pass_width = v_pass_width;
+  self->private_data.s_decode_frame[0].v_pass_height = v_pass_height;
+  self->private_data.s_decode_frame[0].v_shift = v_shift;
+
+  goto exit;
+  exit:
+  if (wuffs_base__status__is_error(&status)) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+  }
+  return status;
+}
+
+// -------- func png.decoder.decode_pass
+
+static wuffs_base__status
+wuffs_png__decoder__decode_pass(
+    wuffs_png__decoder* self,
+    wuffs_base__pixel_buffer* a_dst,
+    wuffs_base__io_buffer* a_src,
+    wuffs_base__slice_u8 a_workbuf) {
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  wuffs_base__io_buffer u_w = wuffs_base__empty_io_buffer();
+  wuffs_base__io_buffer* v_w = &u_w;
+  uint8_t* iop_v_w WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io0_v_w WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io1_v_w WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io2_v_w WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint64_t v_w_mark = 0;
+  uint64_t v_r_mark = 0;
+  wuffs_base__status v_zlib_status = wuffs_base__make_status(NULL);
+  uint32_t v_checksum_have = 0;
+  uint32_t v_checksum_want = 0;
+  wuffs_base__status v_status = wuffs_base__make_status(NULL);
+  uint64_t v_row_length = 0;
+  uint64_t v_strip_max = 0;
+  uint64_t v_strip_length = 0;
+  uint64_t v_strip_wi = 0;
+  bool v_strip_parity = false;
+  uint64_t v_remaining = 0;
+  wuffs_base__slice_u8 v_window = {0};
+  wuffs_base__slice_u8 v_curr_strip = {0};
+  wuffs_base__slice_u8 v_prev_strip = {0};
+  wuffs_base__slice_u8 v_workbuf = {0};
+  wuffs_base__slice_u8 v_downscale = {0};
+  uint64_t v_ds_length = 0;
+
+  const uint8_t* iop_a_src = NULL;
+  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_src) {
+    io0_a_src = a_src->data.ptr;
+    io1_a_src = io0_a_src + a_src->meta.ri;
+    iop_a_src = io1_a_src;
+    io2_a_src = io0_a_src + a_src->meta.wi;
+  }
+
+  uint32_t coro_susp_point = self->private_impl.p_decode_pass[0];
+  if (coro_susp_point) {
+    v_checksum_have = self->private_data.s_decode_pass[0].v_checksum_have;
+    v_strip_length = self->private_data.s_decode_pass[0].v_strip_length;
+    v_strip_wi = self->private_data.s_decode_pass[0].v_strip_wi;
+    v_strip_parity = self->private_data.s_decode_pass[0].v_strip_parity;
+    v_ds_length = self->private_data.s_decode_pass[0].v_ds_length;
+  }
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    self->private_impl.f_workbuf_wi = 0;
+    v_row_length = (1 + self->private_impl.f_pass_bytes_per_row);
+    if ((self->private_impl.f_downscale_shift > 0) && (self->private_impl.f_interlace_pass == 0)) {
+      v_ds_length = self->private_impl.f_downscale_workbuf_length;
+    }
+    v_strip_max = 32768;
+    if ((wuffs_base__u64__sat_sub(((uint64_t)(a_workbuf.len)), v_ds_length) / 2) < 32768) {
+      v_strip_max = (wuffs_base__u64__sat_sub(((uint64_t)(a_workbuf.len)), v_ds_length) / 2);
+    }
+    v_strip_length = ((v_strip_max / (1 + self->private_impl.f_pass_bytes_per_row)) * (1 + self->private_impl.f_pass_bytes_per_row));
+    if (v_strip_length < v_row_length) {
+      v_strip_length = v_row_length;
+      if ((self->private_impl.f_pass_workbuf_length > v_row_length) && (wuffs_base__u64__sat_sub(((uint64_t)(a_workbuf.len)), v_ds_length) < (2 * v_row_length))) {
+        status = wuffs_base__make_status(wuffs_base__error__bad_workbuf_length);
+        goto exit;
+      }
+    }
+    label__0__continue:;
+    while (true) {
+      if (wuffs_png__decoder__is_past_roi(self)) {
+        if (self->private_impl.f_seen_actl) {
+          if (a_src) {
+            a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+          }
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+          status = wuffs_png__decoder__skip_data_chunks(self, a_src);
+          if (a_src) {
+            iop_a_src = a_src->data.ptr + a_src->meta.ri;
+          }
+          if (status.repr) {
+            goto suspend;
+          }
+        }
+        status = wuffs_base__make_status(NULL);
+        goto ok;
+      }
+      if (v_ds_length > ((uint64_t)(a_workbuf.len))) {
+        status = wuffs_base__make_status(wuffs_base__error__bad_workbuf_length);
+        goto exit;
+      }
+      v_downscale = wuffs_base__slice_u8__subslice_j(a_workbuf, v_ds_length);
+      v_workbuf = wuffs_base__slice_u8__subslice_i(a_workbuf, v_ds_length);
+      if (v_strip_length > ((uint64_t)(v_workbuf.len))) {
+        status = wuffs_base__make_status(wuffs_base__error__bad_workbuf_length);
+        goto exit;
+      }
+      v_curr_strip = wuffs_base__slice_u8__subslice_j(v_workbuf, v_strip_length);
+      v_prev_strip = wuffs_base__slice_u8__subslice_i(v_workbuf, v_strip_length);
+      if (v_strip_length < ((uint64_t)(v_prev_strip.len))) {
+        v_prev_strip = wuffs_base__slice_u8__subslice_j(v_prev_strip, v_strip_length);
+      }
+      if (v_strip_parity) {
+        v_window = v_curr_strip;
+        v_curr_strip = v_prev_strip;
+        v_prev_strip = v_window;
+      }
+      if (v_strip_wi > ((uint64_t)(v_curr_strip.len))) {
+        status = wuffs_base__make_status(wuffs_base__error__bad_workbuf_length);
+        goto exit;
+      }
+      v_window = wuffs_base__slice_u8__subslice_i(v_curr_strip, v_strip_wi);
+      v_remaining = wuffs_base__u64__sat_sub(self->private_impl.f_pass_workbuf_length, self->private_impl.f_workbuf_wi);
+      if (v_remaining < ((uint64_t)(v_window.len))) {
+        v_window = wuffs_base__slice_u8__subslice_j(v_window, v_remaining);
+      }
+      {
+        wuffs_base__io_buffer* o_0_v_w = v_w;
+        uint8_t *o_0_iop_v_w = iop_v_w;
+        uint8_t *o_0_io0_v_w = io0_v_w;
+        uint8_t *o_0_io1_v_w = io1_v_w;
+        uint8_t *o_0_io2_v_w = io2_v_w;
+        v_w = wuffs_base__io_writer__set(
+            &u_w,
+            &iop_v_w,
+            &io0_v_w,
+            &io1_v_w,
+            &io2_v_w,
+            v_window);
+        {
+          const uint8_t *o_1_io2_a_src = io2_a_src;
+          wuffs_base__io_reader__limit(&io2_a_src, iop_a_src,
+              self->private_impl.f_chunk_length);
+          if (a_src) {
+            a_src->meta.wi = ((size_t)(io2_a_src - a_src->data.ptr));
+          }
+          v_w_mark = ((uint64_t)(iop_v_w - io0_v_w));
+          v_r_mark = ((uint64_t)(iop_a_src - io0_a_src));
+          {
+            u_w.meta.wi = ((size_t)(iop_v_w - u_w.data.ptr));
+            if (a_src) {
+              a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+            }
+            wuffs_base__status t_0 = wuffs_zlib__decoder__transform_io(&self->private_data.f_zlib, v_w, a_src, wuffs_base__utility__empty_slice_u8());
+            v_zlib_status = t_0;
+            iop_v_w = u_w.data.ptr + u_w.meta.wi;
+            if (a_src) {
+              iop_a_src = a_src->data.ptr + a_src->meta.ri;
+            }
+          }
+          if ( ! self->private_impl.f_ignore_checksum) {
+            wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_crc32, wuffs_base__io__since(v_r_mark, ((uint64_t)(iop_a_src - io0_a_src)), io0_a_src));
+          }
+          wuffs_base__u64__sat_sub_indirect(&self->private_impl.f_chunk_length, wuffs_base__io__count_since(v_r_mark, ((uint64_t)(iop_a_src - io0_a_src))));
+          wuffs_base__u64__sat_add_indirect(&self->private_impl.f_workbuf_wi, wuffs_base__io__count_since(v_w_mark, ((uint64_t)(iop_v_w - io0_v_w))));
+          wuffs_base__u64__sat_add_indirect(&v_strip_wi, wuffs_base__io__count_since(v_w_mark, ((uint64_t)(iop_v_w - io0_v_w))));
+          io2_a_src = o_1_io2_a_src;
+          if (a_src) {
+            a_src->meta.wi = ((size_t)(io2_a_src - a_src->data.ptr));
+          }
+        }
+        v_w = o_0_v_w;
+        iop_v_w = o_0_iop_v_w;
+        io0_v_w = o_0_io0_v_w;
+        io1_v_w = o_0_io1_v_w;
+        io2_v_w = o_0_io2_v_w;
+      }
+      if ((v_strip_wi >= v_strip_length) || ((v_strip_wi > 0) && (self->private_impl.f_workbuf_wi >= self->private_impl.f_pass_workbuf_length))) {
+        if (v_strip_wi < ((uint64_t)(v_curr_strip.len))) {
+          v_curr_strip = wuffs_base__slice_u8__subslice_j(v_curr_strip, v_strip_wi);
+        }
+        if (self->private_impl.f_workbuf_wi <= v_strip_length) {
+          v_prev_strip = wuffs_base__utility__empty_slice_u8();
+          if (1 <= ((uint64_t)(v_curr_strip.len))) {
+            if (v_curr_strip.ptr[0] == 4) {
+              v_curr_strip.ptr[0] = 1;
+            }
+          }
+        } else if (self->private_impl.f_pass_bytes_per_row <= ((uint64_t)(v_prev_strip.len))) {
+          v_prev_strip = wuffs_base__slice_u8__suffix(v_prev_strip, self->private_impl.f_pass_bytes_per_row);
+        }
+        v_status = wuffs_png__decoder__filter_and_swizzle(self,
+            a_dst,
+            v_prev_strip,
+            v_curr_strip,
+            v_downscale);
+        if ( ! wuffs_base__status__is_ok(&v_status)) {
+          status = v_status;
+          if (wuffs_base__status__is_error(&status)) {
+            goto exit;
+          } else if (wuffs_base__status__is_suspension(&status)) {
+            status = wuffs_base__make_status(wuffs_base__error__cannot_return_a_suspension);
+            goto exit;
+          }
+          goto ok;
+        }
+        v_strip_wi = 0;
+        v_strip_parity =  ! v_strip_parity;
+      }
+      if (wuffs_base__status__is_ok(&v_zlib_status)) {
+        if ( ! self->private_impl.f_ignore_checksum) {
+          if (self->private_impl.f_chunk_length > 0) {
+            status = wuffs_base__make_status(wuffs_base__error__too_much_data);
+            goto exit;
+          }
+          v_checksum_have = wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_crc32, wuffs_base__utility__empty_slice_u8());
+          {
+            WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+            uint32_t t_1;
+            if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
+              t_1 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
+              iop_a_src += 4;
+            } else {
+              self->private_data.s_decode_pass[0].scratch = 0;
+              WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+              while (true) {
+                if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+                  status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+                  goto suspend;
+                }
+                uint64_t* scratch = &self->private_data.s_decode_pass[0].scratch;
+                uint32_t num_bits_1 = ((uint32_t)(*scratch & 0xFF));
+                *scratch >>= 8;
+                *scratch <<= 8;
+                *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_1);
+                if (num_bits_1 == 24) {
+                  t_1 = ((uint32_t)(*scratch >> 32));
+                  break;
+                }
+                num_bits_1 += 8;
+                *scratch |= ((uint64_t)(num_bits_1));
+              }
+            }
+            v_checksum_want = t_1;
+          }
+          if (v_checksum_have != v_checksum_want) {
+            status = wuffs_base__make_status(wuffs_png__error__bad_checksum);
+            goto exit;
+          }
+        } else if (self->private_impl.f_seen_actl) {
+          self->private_data.s_decode_pass[0].scratch = self->private_impl.f_chunk_length;
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
+          if (self->private_data.s_decode_pass[0].scratch > ((uint64_t)(io2_a_src - iop_a_src))) {
+            self->private_data.s_decode_pass[0].scratch -= ((uint64_t)(io2_a_src - iop_a_src));
+            iop_a_src = io2_a_src;
+            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+            goto suspend;
+          }
+          iop_a_src += self->private_data.s_decode_pass[0].scratch;
+          self->private_data.s_decode_pass[0].scratch = 4;
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(5);
+          if (self->private_data.s_decode_pass[0].scratch > ((uint64_t)(io2_a_src - iop_a_src))) {
+            self->private_data.s_decode_pass[0].scratch -= ((uint64_t)(io2_a_src - iop_a_src));
+            iop_a_src = io2_a_src;
+            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+            goto suspend;
+          }
+          iop_a_src += self->private_data.s_decode_pass[0].scratch;
+          self->private_impl.f_chunk_length = 0;
+        }
+        goto label__0__break;
+      } else if (v_zlib_status.repr == wuffs_base__suspension__short_write) {
+        if (self->private_impl.f_workbuf_wi < self->private_impl.f_pass_workbuf_length) {
+          goto label__0__continue;
+        } else if ((1 <= self->private_impl.f_interlace_pass) && (self->private_impl.f_interlace_pass <= 6)) {
+          goto label__0__break;
+        }
+        status = wuffs_base__make_status(wuffs_base__error__too_much_data);
+        goto exit;
+      } else if (v_zlib_status.repr != wuffs_base__suspension__short_read) {
+        status = v_zlib_status;
+        if (wuffs_base__status__is_error(&status)) {
+          goto exit;
+        } else if (wuffs_base__status__is_suspension(&status)) {
+          status = wuffs_base__make_status(wuffs_base__error__cannot_return_a_suspension);
+          goto exit;
+        }
+        goto ok;
+      } else if (self->private_impl.f_chunk_length == 0) {
+        {
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(6);
+          uint32_t t_2;
+          if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
+            t_2 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
+            iop_a_src += 4;
+          } else {
+            self->private_data.s_decode_pass[0].scratch = 0;
+            WUFFS_BASE__COROUTINE_SUSPENSION_POINT(7);
+            while (true) {
+              if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+                status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+                goto suspend;
+              }
+              uint64_t* scratch = &self->private_data.s_decode_pass[0].scratch;
+              uint32_t num_bits_2 = ((uint32_t)(*scratch & 0xFF));
+              *scratch >>= 8;
+              *scratch <<= 8;
+              *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_2);
+              if (num_bits_2 == 24) {
+                t_2 = ((uint32_t)(*scratch >> 32));
+                break;
+              }
+              num_bits_2 += 8;
+              *scratch |= ((uint64_t)(num_bits_2));
+            }
+          }
+          v_checksum_want = t_2;
+        }
+        if ( ! self->private_impl.f_ignore_checksum) {
+          v_checksum_have = wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_crc32, wuffs_base__utility__empty_slice_u8());
+          if (v_checksum_have != v_checksum_want) {
+            status = wuffs_base__make_status(wuffs_png__error__bad_checksum);
+            goto exit;
+          }
+        }
+        if (a_src) {
+          a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+        }
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(8);
+        status = wuffs_png__decoder__read_data_chunk_header(self, a_src);
+        if (a_src) {
+          iop_a_src = a_src->data.ptr + a_src->meta.ri;
+        }
+        if (status.repr) {
+          goto suspend;
+        }
+        goto label__0__continue;
+      } else if (((uint64_t)(io2_a_src - iop_a_src)) > 0) {
+        status = wuffs_base__make_status(wuffs_png__error__internal_error_zlib_decoder_did_not_exhaust_its_input);
+        goto exit;
+      }
+      status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(9);
+    }
+    label__0__break:;
+    if (self->private_impl.f_workbuf_wi != self->private_impl.f_pass_workbuf_length) {
+      status = wuffs_base__make_status(wuffs_base__error__not_enough_data);
+      goto exit;
+    }
+
+    ok:
+    self->private_impl.p_decode_pass[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_decode_pass[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+  self->private_data.s_decode_pass[0].v_checksum_have = v_checksum_have;
+  self->private_data.s_decode_pass[0].v_strip_length = v_strip_length;
+  self->private_data.s_decode_pass[0].v_strip_wi = v_strip_wi;
+  self->private_data.s_decode_pass[0].v_strip_parity = v_strip_parity;
+  self->private_data.s_decode_pass[0].v_ds_length = v_ds_length;
+
+  goto exit;
+  exit:
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  }
+
+  return status;
+}
+
+// -------- func png.decoder.is_past_roi
+
+static bool
+wuffs_png__decoder__is_past_roi(
+    const wuffs_png__decoder* self) {
+  return (((self->private_impl.f_interlace_pass == 0) || (self->private_impl.f_interlace_pass == 7)) && (self->private_impl.f_roi_y1 < self->private_impl.f_frame_rect_y1) && (self->private_impl.f_roi_y1 <= self->private_impl.f_dst_y));
+}
+
+// -------- func png.decoder.frame_dirty_rect
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__rect_ie_u32
+wuffs_png__decoder__frame_dirty_rect(
+    const wuffs_png__decoder* self) {
+  if (!self) {
+    return wuffs_base__utility__empty_rect_ie_u32();
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return wuffs_base__utility__empty_rect_ie_u32();
+  }
+
+  uint32_t v_x0 = 0;
+  uint32_t v_y0 = 0;
+  uint32_t v_x1 = 0;
+  uint32_t v_y1 = 0;
+  uint32_t v_mask = 0;
+
+  v_x0 = wuffs_base__u32__max(self->private_impl.f_frame_rect_x0, self->private_impl.f_roi_x0);
+  v_y0 = wuffs_base__u32__max(self->private_impl.f_frame_rect_y0, self->private_impl.f_roi_y0);
+  v_x1 = wuffs_base__u32__max(wuffs_base__u32__min(self->private_impl.f_frame_rect_x1, self->private_impl.f_roi_x1), v_x0);
+  v_y1 = wuffs_base__u32__max(wuffs_base__u32__min(self->private_impl.f_frame_rect_y1, self->private_impl.f_roi_y1), v_y0);
+  if (self->private_impl.f_downscale_shift > 0) {
+    v_mask = ((((uint32_t)(1)) << self->private_impl.f_downscale_shift) - 1);
+    v_x0 = (v_x0 >> self->private_impl.f_downscale_shift);
+    v_y0 = (v_y0 >> self->private_impl.f_downscale_shift);
+    v_x1 = (wuffs_base__u32__sat_add(v_x1, v_mask) >> self->private_impl.f_downscale_shift);
+    v_y1 = (wuffs_base__u32__sat_add(v_y1, v_mask) >> self->private_impl.f_downscale_shift);
+  }
+  return wuffs_base__utility__make_rect_ie_u32(
+      v_x0,
+      v_y0,
+      v_x1,
+      v_y1);
+}
+
+// -------- func png.decoder.num_animation_loops
+
+WUFFS_BASE__MAYBE_STATIC uint32_t
+wuffs_png__decoder__num_animation_loops(
+    const wuffs_png__decoder* self) {
+  if (!self) {
+    return 0;
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return 0;
+  }
+
+  if (self->private_impl.f_seen_actl) {
+    return self->private_impl.f_num_animation_loops_value;
+  }
+  return 0;
+}
+
+// -------- func png.decoder.num_decoded_frame_configs
+
+WUFFS_BASE__MAYBE_STATIC uint64_t
+wuffs_png__decoder__num_decoded_frame_configs(
+    const wuffs_png__decoder* self) {
+  if (!self) {
+    return 0;
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return 0;
+  }
+
+  return self->private_impl.f_num_decoded_frame_configs_value;
+}
+
+// -------- func png.decoder.num_decoded_frames
+
+WUFFS_BASE__MAYBE_STATIC uint64_t
+wuffs_png__decoder__num_decoded_frames(
+    const wuffs_png__decoder* self) {
+  if (!self) {
+    return 0;
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return 0;
+  }
+
+  return self->private_impl.f_num_decoded_frames_value;
+}
+
+// -------- func png.decoder.restart_frame
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_png__decoder__restart_frame(
+    wuffs_png__decoder* self,
+    uint64_t a_index,
+    uint64_t a_io_position) {
+  if (!self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+  }
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_status(
+        (self->private_impl.magic == WUFFS_BASE__DISABLED)
+        ? wuffs_base__error__disabled_by_previous_error
+        : wuffs_base__error__initialize_not_called);
+  }
+
+  if (self->private_impl.f_call_sequence < 3) {
+    return wuffs_base__make_status(wuffs_base__error__bad_call_sequence);
+  }
+  if ((a_index == 0) && (self->private_impl.f_seen_fctl ||  ! self->private_impl.f_seen_actl)) {
+    self->private_impl.f_call_sequence = 3;
+  } else if (self->private_impl.f_seen_actl) {
+    self->private_impl.f_call_sequence = 5;
+  } else {
+    return wuffs_base__make_status(wuffs_base__error__bad_argument);
+  }
+  if (self->private_impl.f_interlace_pass >= 1) {
+    self->private_impl.f_interlace_pass = 1;
+  }
+  self->private_impl.f_restarted = true;
+  self->private_impl.f_frame_config_io_position = a_io_position;
+  self->private_impl.f_num_decoded_frame_configs_value = a_index;
+  self->private_impl.f_num_decoded_frames_value = a_index;
+  return wuffs_base__make_status(NULL);
+}
+
+// -------- func png.decoder.set_report_metadata
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_png__decoder__set_report_metadata(
+    wuffs_png__decoder* self,
+    uint32_t a_fourcc,
+    bool a_report) {
+  if (!self) {
+    return wuffs_base__make_empty_struct();
+  }
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_empty_struct();
+  }
+
+  if (a_fourcc == 1163413830) {
+    self->private_impl.f_report_metadata_exif = a_report;
+  } else if (a_fourcc == 1195461953) {
+    self->private_impl.f_report_metadata_gama = a_report;
+  } else if (a_fourcc == 1229144912) {
+    self->private_impl.f_report_metadata_iccp = a_report;
+  } else if (a_fourcc == 1263947808) {
+    self->private_impl.f_report_metadata_kvp = a_report;
+  }
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func png.decoder.tell_me_more
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_png__decoder__tell_me_more(
+    wuffs_png__decoder* self,
+    wuffs_base__io_buffer* a_dst,
+    wuffs_base__more_information* a_minfo,
+    wuffs_base__io_buffer* a_src) {
+  if (!self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+  }
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_status(
+        (self->private_impl.magic == WUFFS_BASE__DISABLED)
+        ? wuffs_base__error__disabled_by_previous_error
+        : wuffs_base__error__initialize_not_called);
+  }
+  if (!a_dst || !a_src) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+    return wuffs_base__make_status(wuffs_base__error__bad_argument);
+  }
+  if ((self->private_impl.active_coroutine != 0) &&
+      (self->private_impl.active_coroutine != 4)) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+    return wuffs_base__make_status(wuffs_base__error__interleaved_coroutine_calls);
+  }
+  self->private_impl.active_coroutine = 0;
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  uint8_t v_c = 0;
+  uint32_t v_transform = 0;
+
+  const uint8_t* iop_a_src = NULL;
+  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_src) {
+    io0_a_src = a_src->data.ptr;
+    io1_a_src = io0_a_src + a_src->meta.ri;
+    iop_a_src = io1_a_src;
+    io2_a_src = io0_a_src + a_src->meta.wi;
+  }
+
+  uint32_t coro_susp_point = self->private_impl.p_tell_me_more[0];
+  if (coro_susp_point) {
+    v_transform = self->private_data.s_tell_me_more[0].v_transform;
+  }
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    if (self->private_impl.f_call_sequence != 1) {
+      status = wuffs_base__make_status(wuffs_base__error__bad_call_sequence);
+      goto exit;
+    }
+    if (self->private_impl.f_metadata_fourcc == 0) {
+      status = wuffs_base__make_status(wuffs_base__error__no_more_information);
+      goto exit;
+    }
+    while (wuffs_base__u64__sat_add(a_src->meta.pos, ((uint64_t)(iop_a_src - io0_a_src))) != self->private_impl.f_metadata_y) {
+      if (a_minfo != NULL) {
+        wuffs_base__more_information__set(a_minfo,
+            2,
+            0,
+            self->private_impl.f_metadata_y,
+            0,
+            0);
+      }
+      status = wuffs_base__make_status(wuffs_base__suspension__mispositioned_read);
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(1);
+    }
+    if (self->private_impl.f_metadata_fourcc == 1229144912) {
+      while (true) {
+        if (wuffs_base__u64__sat_add(a_src->meta.pos, ((uint64_t)(iop_a_src - io0_a_src))) >= self->private_impl.f_metadata_z) {
+          status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
+          goto exit;
+        }
+        {
+          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+          if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+            status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+            goto suspend;
+          }
+          uint8_t t_0 = *iop_a_src++;
+          v_c = t_0;
+        }
+        if (v_c == 0) {
+          goto label__0__break;
+        }
+      }
+      label__0__break:;
+      if (wuffs_base__u64__sat_add(a_src->meta.pos, ((uint64_t)(iop_a_src - io0_a_src))) >= self->private_impl.f_metadata_z) {
+        status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
+        goto exit;
+      }
+      {
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+        if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
+          status = wuffs_base__make_status(wuffs_base__suspension__short_read);
+          goto suspend;
+        }
+        uint8_t t_1 = *iop_a_src++;
+        v_c = t_1;
+      }
+      if (v_c != 0) {
+        status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
+        goto exit;
+      }
+      self->private_impl.f_metadata_y = wuffs_base__u64__sat_add(a_src->meta.pos, ((uint64_t)(iop_a_src - io0_a_src)));
+      v_transform = 1514948930;
+    }
+    if (a_minfo != NULL) {
+      wuffs_base__more_information__set(a_minfo,
+          3,
+          self->private_impl.f_metadata_fourcc,
+          ((uint64_t)(v_transform)),
+          self->private_impl.f_metadata_y,
+          self->private_impl.f_metadata_z);
+    }
+    self->private_impl.f_call_sequence = 2;
+    self->private_impl.f_metadata_fourcc = 0;
+    self->private_impl.f_metadata_y = 0;
+
+    ok:
+    self->private_impl.p_tell_me_more[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_tell_me_more[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+  self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 4 : 0;
+  self->private_data.s_tell_me_more[0].v_transform = v_transform;
+
+  goto exit;
+  exit:
+  if (a_src) {
+    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+  }
+
+  if (wuffs_base__status__is_error(&status)) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+  }
+  return status;
+}
+
+// -------- func png.decoder.workbuf_len
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__range_ii_u64
+wuffs_png__decoder__workbuf_len(
+    const wuffs_png__decoder* self) {
+  if (!self) {
+    return wuffs_base__utility__empty_range_ii_u64();
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return wuffs_base__utility__empty_range_ii_u64();
+  }
+
+  return wuffs_base__utility__make_range_ii_u64(self->private_impl.f_min_workbuf_length, (self->private_impl.f_max_workbuf_length + self->private_impl.f_downscale_workbuf_length));
+}
+
+// -------- func png.decoder.filter_and_swizzle
+
+static wuffs_base__status
+wuffs_png__decoder__filter_and_swizzle(
+    wuffs_png__decoder* self,
+    wuffs_base__pixel_buffer* a_dst,
+    wuffs_base__slice_u8 a_prev,
+    wuffs_base__slice_u8 a_workbuf,
+    wuffs_base__slice_u8 a_downscale) {
+  return (*self->private_impl.choosy_filter_and_swizzle)(self, a_dst, a_prev, a_workbuf, a_downscale);
+}
+
+static wuffs_base__status
+wuffs_png__decoder__filter_and_swizzle__choosy_default(
+    wuffs_png__decoder* self,
+    wuffs_base__pixel_buffer* a_dst,
+    wuffs_base__slice_u8 a_prev,
+    wuffs_base__slice_u8 a_workbuf,
+    wuffs_base__slice_u8 a_downscale) {
+  wuffs_base__pixel_format v_dst_pixfmt = {0};
+  uint32_t v_dst_bits_per_pixel = 0;
+  uint64_t v_dst_bytes_per_pixel = 0;
+  uint64_t v_dst_bytes_per_row0 = 0;
+  uint64_t v_dst_bytes_per_row1 = 0;
+  wuffs_base__slice_u8 v_dst_palette = {0};
+  wuffs_base__table_u8 v_tab = {0};
+  uint64_t v_src_bytes_per_row0 = 0;
+  uint32_t v_x0 = 0;
+  uint32_t v_x1 = 0;
+  uint32_t v_y = 0;
+  uint32_t v_y1 = 0;
+  wuffs_base__slice_u8 v_dst = {0};
+  uint8_t v_filter = 0;
+  wuffs_base__slice_u8 v_curr_row = {0};
+  wuffs_base__slice_u8 v_prev_row = {0};
+
+  v_dst_pixfmt = wuffs_base__pixel_buffer__pixel_format(a_dst);
+  v_dst_bits_per_pixel = wuffs_base__pixel_format__bits_per_pixel(&v_dst_pixfmt);
+  if ((v_dst_bits_per_pixel & 7) != 0) {
+    return wuffs_base__make_status(wuffs_base__error__unsupported_option);
+  }
+  v_dst_bytes_per_pixel = ((uint64_t)((v_dst_bits_per_pixel / 8)));
+  v_x0 = wuffs_base__u32__max(self->private_impl.f_frame_rect_x0, self->private_impl.f_roi_x0);
+  v_x1 = wuffs_base__u32__max(wuffs_base__u32__min(self->private_impl.f_frame_rect_x1, self->private_impl.f_roi_x1), v_x0);
+  v_dst_bytes_per_row0 = (((uint64_t)(v_x0)) * v_dst_bytes_per_pixel);
+  v_dst_bytes_per_row1 = (((uint64_t)(v_x1)) * v_dst_bytes_per_pixel);
+  v_src_bytes_per_row0 = (((uint64_t)(((uint32_t)(v_x0 - self->private_impl.f_frame_rect_x0)))) * ((uint64_t)(self->private_impl.f_filter_distance)));
+  v_dst_palette = wuffs_base__pixel_buffer__palette_or_else(a_dst, wuffs_base__make_slice_u8(self->private_data.f_dst_palette, 1024));
+  v_tab = wuffs_base__pixel_buffer__plane(a_dst, 0);
+  v_y1 = self->private_impl.f_frame_rect_y1;
+  if (self->private_impl.f_roi_y1 < v_y1) {
+    v_y1 = (16777215 & self->private_impl.f_roi_y1);
+  }
+  v_y = self->private_impl.f_dst_y;
+  v_prev_row = a_prev;
+  while (v_y < v_y1) {
+    if (1 > ((uint64_t)(a_workbuf.len))) {
+      goto label__0__break;
+    }
+    v_filter = a_workbuf.ptr[0];
+    a_workbuf = wuffs_base__slice_u8__subslice_i(a_workbuf, 1);
+    if (self->private_impl.f_pass_bytes_per_row > ((uint64_t)(a_workbuf.len))) {
+      return wuffs_base__make_status(wuffs_png__error__internal_error_inconsistent_workbuf_length);
+    }
+    v_curr_row = wuffs_base__slice_u8__subslice_j(a_workbuf, self->private_impl.f_pass_bytes_per_row);
+    a_workbuf = wuffs_base__slice_u8__subslice_i(a_workbuf, self->private_impl.f_pass_bytes_per_row);
+    if (v_filter == 0) {
+    } else if (v_filter == 1) {
+      wuffs_png__decoder__filter_1(self, v_curr_row);
+    } else if (v_filter == 2) {
+      wuffs_png__decoder__filter_2(self, v_curr_row, v_prev_row);
+    } else if (v_filter == 3) {
+      wuffs_png__decoder__filter_3(self, v_curr_row, v_prev_row);
+    } else if (v_filter == 4) {
+      wuffs_png__decoder__filter_4(self, v_curr_row, v_prev_row);
+    } else {
+      return wuffs_base__make_status(wuffs_png__error__bad_filter);
+    }
+    if (self->private_impl.f_downscale_shift > 0) {
+      wuffs_base__pixel_swizzler__swizzle_downscaled_from_slice(&self->private_impl.f_downscaler,
+          v_tab,
+          v_dst_palette,
+          a_downscale,
+          v_curr_row,
+          self->private_impl.f_downscale_shift,
+          self->private_impl.f_frame_rect_x0,
+          v_y,
+          self->private_impl.f_frame_rect_y0,
+          self->private_impl.f_frame_rect_y1);
+    } else if ((self->private_impl.f_roi_y0 <= v_y) && (v_src_bytes_per_row0 <= ((uint64_t)(v_curr_row.len)))) {
+      v_dst = wuffs_base__table_u8__row(v_tab, v_y);
+      if (v_dst_bytes_per_row1 < ((uint64_t)(v_dst.len))) {
+        v_dst = wuffs_base__slice_u8__subslice_j(v_dst, v_dst_bytes_per_row1);
+      }
+      if (v_dst_bytes_per_row0 < ((uint64_t)(v_dst.len))) {
+        v_dst = wuffs_base__slice_u8__subslice_i(v_dst, v_dst_bytes_per_row0);
+      } else {
+        v_dst = wuffs_base__utility__empty_slice_u8();
+      }
+      wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(&self->private_impl.f_swizzler, v_dst, v_dst_palette, wuffs_base__slice_u8__subslice_i(v_curr_row, v_src_bytes_per_row0));
+    }
+    v_prev_row = v_curr_row;
+    v_y += 1;
+  }
+  label__0__break:;
+  self->private_impl.f_dst_y = v_y;
+  return wuffs_base__make_status(NULL);
+}
+
+// -------- func png.decoder.filter_and_swizzle_tricky
+
+static wuffs_base__status
+wuffs_png__decoder__filter_and_swizzle_tricky(
+    wuffs_png__decoder* self,
+    wuffs_base__pixel_buffer* a_dst,
+    wuffs_base__slice_u8 a_prev,
+    wuffs_base__slice_u8 a_workbuf,
+    wuffs_base__slice_u8 a_downscale) {
+  wuffs_base__pixel_format v_dst_pixfmt = {0};
+  uint32_t v_dst_bits_per_pixel = 0;
+  uint64_t v_dst_bytes_per_pixel = 0;
+  uint64_t v_dst_bytes_per_row = 0;
+  wuffs_base__slice_u8 v_dst_palette = {0};
+  wuffs_base__table_u8 v_tab = {0};
+  wuffs_base__pixel_format v_src_pixfmt = {0};
+  uint64_t v_src_bytes_per_pixel = 0;
+  uint32_t v_x = 0;
+  uint32_t v_x_origin = 0;
+  uint32_t v_point_shift = 0;
+  uint32_t v_y = 0;
+  uint32_t v_y1 = 0;
+  uint64_t v_i = 0;
+  uint64_t v_n = 0;
+  wuffs_base__slice_u8 v_accum = {0};
+  wuffs_base__slice_u8 v_scratch = {0};
+  wuffs_base__slice_u8 v_dst = {0};
+  uint8_t v_filter = 0;
+  wuffs_base__slice_u8 v_s = {0};
+  wuffs_base__slice_u8 v_curr_row = {0};
+  wuffs_base__slice_u8 v_prev_row = {0};
+  uint8_t v_bits_unpacked[8] = {0};
+  uint8_t v_bits_packed = 0;
+  uint8_t v_packs_remaining = 0;
+  uint8_t v_multiplier = 0;
+  uint8_t v_shift = 0;
+  uint8_t v_depth = 0;
+  uint8_t v_chunk[64] = {0};
+  uint64_t v_chunk_length = 0;
+  uint64_t v_chunk_skip = 0;
+  wuffs_base__slice_u8 v_c = {0};
+  uint64_t v_j = 0;
+  uint64_t v_packed = 0;
+  uint64_t v_di = 0;
+
+  v_dst_pixfmt = wuffs_base__pixel_buffer__pixel_format(a_dst);
+  v_dst_bits_per_pixel = wuffs_base__pixel_format__bits_per_pixel(&v_dst_pixfmt);
+  if ((v_dst_bits_per_pixel & 7) != 0) {
+    return wuffs_base__make_status(wuffs_base__error__unsupported_option);
+  }
+  v_dst_bytes_per_pixel = ((uint64_t)((v_dst_bits_per_pixel / 8)));
+  v_dst_bytes_per_row = (((uint64_t)(wuffs_base__u32__min(self->private_impl.f_frame_rect_x1, self->private_impl.f_roi_x1))) * v_dst_bytes_per_pixel);
+  v_dst_palette = wuffs_base__pixel_buffer__palette_or_else(a_dst, wuffs_base__make_slice_u8(self->private_data.f_dst_palette, 1024));
+  v_tab = wuffs_base__pixel_buffer__plane(a_dst, 0);
+  v_src_bytes_per_pixel = 1;
+  if (self->private_impl.f_depth >= 8) {
+    v_src_bytes_per_pixel = (((uint64_t)(WUFFS_PNG__NUM_CHANNELS[self->private_impl.f_color_type])) * ((uint64_t)((self->private_impl.f_depth >> 3))));
+  }
+  if (self->private_impl.f_downscale_shift > 0) {
+    if (self->private_impl.f_interlace_pass == 0) {
+      v_n = ((((uint64_t)(self->private_impl.f_width)) * 4) + 16);
+      if (v_n > ((uint64_t)(a_downscale.len))) {
+        return wuffs_base__make_status(wuffs_png__error__internal_error_inconsistent_workbuf_length);
+      }
+      v_accum = wuffs_base__slice_u8__subslice_j(a_downscale, v_n);
+      v_scratch = wuffs_base__slice_u8__subslice_i(a_downscale, v_n);
+      v_src_pixfmt = wuffs_base__utility__make_pixel_format(self->private_impl.f_src_pixfmt);
+      v_dst_bytes_per_pixel = ((uint64_t)((wuffs_base__pixel_format__bits_per_pixel(&v_src_pixfmt) / 8)));
+      v_dst_bytes_per_row = (((uint64_t)(((uint32_t)(self->private_impl.f_frame_rect_x1 - self->private_impl.f_frame_rect_x0)))) * v_dst_bytes_per_pixel);
+      v_x_origin = self->private_impl.f_frame_rect_x0;
+    } else {
+      v_point_shift = self->private_impl.f_downscale_shift;
+    }
+  }
+  v_bits_unpacked[0] = 255;
+  v_bits_unpacked[1] = 255;
+  v_bits_unpacked[2] = 255;
+  v_bits_unpacked[3] = 255;
+  v_bits_unpacked[4] = 255;
+  v_bits_unpacked[5] = 255;
+  v_bits_unpacked[6] = 255;
+  v_bits_unpacked[7] = 255;
+  v_y1 = self->private_impl.f_frame_rect_y1;
+  if (((self->private_impl.f_interlace_pass == 0) || (self->private_impl.f_interlace_pass == 7)) && (self->private_impl.f_roi_y1 < v_y1)) {
+    v_y1 = (16777215 & self->private_impl.f_roi_y1);
+  }
+  v_y = self->private_impl.f_dst_y;
+  v_prev_row = a_prev;
+  label__0__continue:;
+  while (v_y < v_y1) {
+    if (((uint64_t)(v_scratch.len)) > 0) {
+      v_dst = v_scratch;
+    } else {
+      v_dst = wuffs_base__table_u8__row(v_tab, (v_y >> v_point_shift));
+    }
+    if (v_dst_bytes_per_row < ((uint64_t)(v_dst.len))) {
+      v_dst = wuffs_base__slice_u8__subslice_j(v_dst, v_dst_bytes_per_row);
+    }
+    if (1 > ((uint64_t)(a_workbuf.len))) {
+      goto label__0__break;
+    }
+    v_filter = a_workbuf.ptr[0];
+    a_workbuf = wuffs_base__slice_u8__subslice_i(a_workbuf, 1);
+    if (self->private_impl.f_pass_bytes_per_row > ((uint64_t)(a_workbuf.len))) {
+      return wuffs_base__make_status(wuffs_png__error__internal_error_inconsistent_workbuf_length);
+    }
+    v_curr_row = wuffs_base__slice_u8__subslice_j(a_workbuf, self->private_impl.f_pass_bytes_per_row);
+    a_workbuf = wuffs_base__slice_u8__subslice_i(a_workbuf, self->private_impl.f_pass_bytes_per_row);
+    if (v_filter == 0) {
+    } else if (v_filter == 1) {
+      wuffs_png__decoder__filter_1(self, v_curr_row);
+    } else if (v_filter == 2) {
+      wuffs_png__decoder__filter_2(self, v_curr_row, v_prev_row);
+    } else if (v_filter == 3) {
+      wuffs_png__decoder__filter_3(self, v_curr_row, v_prev_row);
+    } else if (v_filter == 4) {
+      wuffs_png__decoder__filter_4(self, v_curr_row, v_prev_row);
+    } else {
+      return wuffs_base__make_status(wuffs_png__error__bad_filter);
+    }
+    if ((v_y < self->private_impl.f_roi_y0) || (self->private_impl.f_roi_y1 <= v_y)) {
+      v_prev_row = v_curr_row;
+      v_y += (((uint32_t)(1)) << WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][3]);
+      goto label__0__continue;
+    }
+    v_s = v_curr_row;
+    v_x = (self->private_impl.f_frame_rect_x0 + ((uint32_t)(WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][2])));
+    if (self->private_impl.f_depth == 8) {
+      while (v_x < self->private_impl.f_frame_rect_x1) {
+        v_i = (((uint64_t)(((((uint32_t)(v_x - v_x_origin)) & 16777215) >> v_point_shift))) * v_dst_bytes_per_pixel);
+        if (v_i <= ((uint64_t)(v_dst.len))) {
+          if (self->private_impl.f_color_type == 4) {
+            if (2 <= ((uint64_t)(v_s.len))) {
+              v_bits_unpacked[0] = v_s.ptr[0];
+              v_bits_unpacked[1] = v_s.ptr[0];
+              v_bits_unpacked[2] = v_s.ptr[0];
+              v_bits_unpacked[3] = v_s.ptr[1];
+              v_s = wuffs_base__slice_u8__subslice_i(v_s, 2);
+              if (v_x >= self->private_impl.f_roi_x0) {
+                wuffs_png__decoder__put_pixel(self, wuffs_base__slice_u8__subslice_i(v_dst, v_i), v_dst_palette, wuffs_base__make_slice_u8(v_bits_unpacked, 4));
+              }
+            }
+          } else if (v_src_bytes_per_pixel <= ((uint64_t)(v_s.len))) {
+            if (v_x >= self->private_impl.f_roi_x0) {
+              wuffs_png__decoder__put_pixel(self, wuffs_base__slice_u8__subslice_i(v_dst, v_i), v_dst_palette, wuffs_base__slice_u8__subslice_j(v_s, v_src_bytes_per_pixel));
+            }
+            v_s = wuffs_base__slice_u8__subslice_i(v_s, v_src_bytes_per_pixel);
+          }
+        }
+        v_x += (((uint32_t)(1)) << WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][0]);
+      }
+    } else if ((self->private_impl.f_depth < 8) && (self->private_impl.f_interlace_pass == 0) && (self->private_impl.f_src_pixfmt != 2164308923)) {
+      v_multiplier = 1;
+      if (self->private_impl.f_color_type == 0) {
+        v_multiplier = WUFFS_PNG__LOW_BIT_DEPTH_MULTIPLIERS[self->private_impl.f_depth];
+      }
+      while (v_x < self->private_impl.f_frame_rect_x1) {
+        v_j = ((uint64_t)(((uint32_t)(self->private_impl.f_frame_rect_x1 - v_x))));
+        v_chunk_length = wuffs_base__u64__min(v_j, 64);
+        v_j = wuffs_png__decoder__unpack_bits(self, wuffs_base__slice_u8__subslice_j(wuffs_base__make_slice_u8(v_chunk, 64), v_chunk_length), v_s, v_multiplier);
+        v_j = wuffs_base__u64__min(v_j, v_chunk_length);
+        v_n = ((v_j / 8) * ((uint64_t)(self->private_impl.f_depth)));
+        if (v_n <= ((uint64_t)(v_s.len))) {
+          v_s = wuffs_base__slice_u8__subslice_i(v_s, v_n);
+        } else {
+          v_s = wuffs_base__slice_u8__subslice_j(v_s, 0);
+        }
+        while (v_j < v_chunk_length) {
+          if (((uint64_t)(v_s.len)) >= 4) {
+            v_packed = ((uint64_t)(wuffs_base__peek_u32le__no_bounds_check(v_s.ptr)));
+          } else if (((uint64_t)(v_s.len)) >= 3) {
+            v_packed = ((uint64_t)(wuffs_base__peek_u24le__no_bounds_check(v_s.ptr)));
+          } else if (((uint64_t)(v_s.len)) >= 2) {
+            v_packed = ((uint64_t)(wuffs_base__peek_u16le__no_bounds_check(v_s.ptr)));
+          } else if (((uint64_t)(v_s.len)) >= 1) {
+            v_packed = ((uint64_t)(wuffs_base__peek_u8__no_bounds_check(v_s.ptr)));
+          } else {
+            v_packed = 0;
+          }
+          v_packed = wuffs_png__decoder__unpack_group(self, v_packed, v_multiplier);
+          v_c = wuffs_base__slice_u8__subslice_i(wuffs_base__make_slice_u8(v_chunk, 64), v_j);
+          if (((uint64_t)(v_c.len)) >= 8) {
+            wuffs_base__poke_u64le__no_bounds_check(v_c.ptr, v_packed);
+          }
+          if (((uint64_t)(self->private_impl.f_depth)) <= ((uint64_t)(v_s.len))) {
+            v_s = wuffs_base__slice_u8__subslice_i(v_s, ((uint64_t)(self->private_impl.f_depth)));
+          } else {
+            v_s = wuffs_base__slice_u8__subslice_j(v_s, 0);
+          }
+          v_j += 8;
+        }
+        v_chunk_skip = 0;
+        if (self->private_impl.f_roi_x0 > v_x) {
+          v_j = ((uint64_t)(((uint32_t)(self->private_impl.f_roi_x0 - v_x))));
+          v_chunk_skip = wuffs_base__u64__min(v_j, 64);
+        }
+        v_di = ((((uint64_t)((((uint32_t)(v_x - v_x_origin)) & 16777215))) + v_chunk_skip) * v_dst_bytes_per_pixel);
+        if ((v_chunk_skip < v_chunk_length) && (v_di <= ((uint64_t)(v_dst.len)))) {
+          wuffs_png__decoder__put_pixel(self, wuffs_base__slice_u8__subslice_i(v_dst, v_di), v_dst_palette, wuffs_base__slice_u8__subslice_ij(wuffs_base__make_slice_u8(v_chunk, 64), v_chunk_skip, v_chunk_length));
+        }
+        v_x += ((uint32_t)(v_chunk_length));
+      }
+    } else if (self->private_impl.f_depth < 8) {
+      v_multiplier = 1;
+      if (self->private_impl.f_color_type == 0) {
+        v_multiplier = WUFFS_PNG__LOW_BIT_DEPTH_MULTIPLIERS[self->private_impl.f_depth];
+      }
+      v_shift = ((8 - self->private_impl.f_depth) & 7);
+      v_depth = self->private_impl.f_depth;
+      v_packs_remaining = 0;
+      while (v_x < self->private_impl.f_frame_rect_x1) {
+        v_i = (((uint64_t)(((((uint32_t)(v_x - v_x_origin)) & 16777215) >> v_point_shift))) * v_dst_bytes_per_pixel);
+        if (v_i <= ((uint64_t)(v_dst.len))) {
+          if ((v_packs_remaining == 0) && (1 <= ((uint64_t)(v_s.len)))) {
+            v_packs_remaining = WUFFS_PNG__LOW_BIT_DEPTH_NUM_PACKS[v_depth];
+            v_bits_packed = v_s.ptr[0];
+            v_s = wuffs_base__slice_u8__subslice_i(v_s, 1);
+          }
+          v_bits_unpacked[0] = ((uint8_t)((v_bits_packed >> v_shift) * v_multiplier));
+          v_bits_packed = ((uint8_t)(v_bits_packed << v_depth));
+          v_packs_remaining = ((uint8_t)(v_packs_remaining - 1));
+          if (v_x >= self->private_impl.f_roi_x0) {
+            wuffs_png__decoder__put_pixel(self, wuffs_base__slice_u8__subslice_i(v_dst, v_i), v_dst_palette, wuffs_base__make_slice_u8(v_bits_unpacked, 1));
+          }
+        }
+        v_x += (((uint32_t)(1)) << WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][0]);
+      }
+    } else {
+      while (v_x < self->private_impl.f_frame_rect_x1) {
+        v_i = (((uint64_t)(((((uint32_t)(v_x - v_x_origin)) & 16777215) >> v_point_shift))) * v_dst_bytes_per_pixel);
+        if (v_i <= ((uint64_t)(v_dst.len))) {
+          if (self->private_impl.f_color_type == 0) {
+            if (2 <= ((uint64_t)(v_s.len))) {
+              v_bits_unpacked[0] = v_s.ptr[1];
+              v_bits_unpacked[1] = v_s.ptr[0];
+              v_bits_unpacked[2] = v_s.ptr[1];
+              v_bits_unpacked[3] = v_s.ptr[0];
+              v_bits_unpacked[4] = v_s.ptr[1];
+              v_bits_unpacked[5] = v_s.ptr[0];
+              v_s = wuffs_base__slice_u8__subslice_i(v_s, 2);
+            }
+          } else if (self->private_impl.f_color_type == 2) {
+            if (6 <= ((uint64_t)(v_s.len))) {
+              v_bits_unpacked[0] = v_s.ptr[5];
+              v_bits_unpacked[1] = v_s.ptr[4];
+              v_bits_unpacked[2] = v_s.ptr[3];
+              v_bits_unpacked[3] = v_s.ptr[2];
+              v_bits_unpacked[4] = v_s.ptr[1];
+              v_bits_unpacked[5] = v_s.ptr[0];
+              v_s = wuffs_base__slice_u8__subslice_i(v_s, 6);
+            }
+          } else if (self->private_impl.f_color_type == 4) {
+            if (4 <= ((uint64_t)(v_s.len))) {
+              v_bits_unpacked[0] = v_s.ptr[1];
+              v_bits_unpacked[1] = v_s.ptr[0];
+              v_bits_unpacked[2] = v_s.ptr[1];
+              v_bits_unpacked[3] = v_s.ptr[0];
+              v_bits_unpacked[4] = v_s.ptr[1];
+              v_bits_unpacked[5] = v_s.ptr[0];
+              v_bits_unpacked[6] = v_s.ptr[3];
+              v_bits_unpacked[7] = v_s.ptr[2];
+              v_s = wuffs_base__slice_u8__subslice_i(v_s, 4);
+            }
+          } else {
+            if (8 <= ((uint64_t)(v_s.len))) {
+              v_bits_unpacked[0] = v_s.ptr[5];
+              v_bits_unpacked[1] = v_s.ptr[4];
+              v_bits_unpacked[2] = v_s.ptr[3];
+              v_bits_unpacked[3] = v_s.ptr[2];
+              v_bits_unpacked[4] = v_s.ptr[1];
+              v_bits_unpacked[5] = v_s.ptr[0];
+              v_bits_unpacked[6] = v_s.ptr[7];
+              v_bits_unpacked[7] = v_s.ptr[6];
+              v_s = wuffs_base__slice_u8__subslice_i(v_s, 8);
+            }
+          }
+          if (v_x >= self->private_impl.f_roi_x0) {
+            wuffs_png__decoder__put_pixel(self, wuffs_base__slice_u8__subslice_i(v_dst, v_i), v_dst_palette, wuffs_base__make_slice_u8(v_bits_unpacked, 8));
+          }
+        }
+        v_x += (((uint32_t)(1)) << WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][0]);
+      }
+    }
+    if (((uint64_t)(v_scratch.len)) > 0) {
+      wuffs_base__pixel_swizzler__swizzle_downscaled_from_slice(&self->private_impl.f_downscaler,
+          v_tab,
+          v_dst_palette,
+          v_accum,
+          v_dst,
+          self->private_impl.f_downscale_shift,
+          self->private_impl.f_frame_rect_x0,
+          v_y,
+          self->private_impl.f_frame_rect_y0,
+          self->private_impl.f_frame_rect_y1);
+    }
+    v_prev_row = v_curr_row;
+    v_y += (((uint32_t)(1)) << WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][3]);
+  }
+  label__0__break:;
+  self->private_impl.f_dst_y = v_y;
+  return wuffs_base__make_status(NULL);
+}
+
+// -------- func png.decoder.unpack_bits
+
+static uint64_t
+wuffs_png__decoder__unpack_bits(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_src,
+    uint8_t a_multiplier) {
+  return (*self->private_impl.choosy_unpack_bits)(self, a_dst, a_src, a_multiplier);
+}
+
+static uint64_t
+wuffs_png__decoder__unpack_bits__choosy_default(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_src,
+    uint8_t a_multiplier) {
+  wuffs_base__slice_u8 v_dst = {0};
+  wuffs_base__slice_u8 v_src = {0};
+  wuffs_base__slice_u8 v_c = {0};
+  uint64_t v_packed = 0;
+  uint64_t v_n = 0;
+
+  v_dst = a_dst;
+  v_src = a_src;
+  if (self->private_impl.f_depth == 1) {
+    while ((((uint64_t)(v_dst.len)) >= 8) && (((uint64_t)(v_src.len)) >= 1)) {
+      v_c = v_dst;
+      v_dst = wuffs_base__slice_u8__subslice_i(v_dst, 8);
+      v_packed = ((uint64_t)(wuffs_base__peek_u8__no_bounds_check(v_src.ptr)));
+      v_src = wuffs_base__slice_u8__subslice_i(v_src, 1);
+      v_packed = wuffs_png__decoder__unpack_group(self, v_packed, a_multiplier);
+      if (((uint64_t)(v_c.len)) >= 8) {
+        wuffs_base__poke_u64le__no_bounds_check(v_c.ptr, v_packed);
+      }
+      v_n += 8;
+    }
+  } else if (self->private_impl.f_depth == 2) {
+    while ((((uint64_t)(v_dst.len)) >= 8) && (((uint64_t)(v_src.len)) >= 2)) {
+      v_c = v_dst;
+      v_dst = wuffs_base__slice_u8__subslice_i(v_dst, 8);
+      v_packed = ((uint64_t)(wuffs_base__peek_u16le__no_bounds_check(v_src.ptr)));
+      v_src = wuffs_base__slice_u8__subslice_i(v_src, 2);
+      v_packed = wuffs_png__decoder__unpack_group(self, v_packed, a_multiplier);
+      if (((uint64_t)(v_c.len)) >= 8) {
+        wuffs_base__poke_u64le__no_bounds_check(v_c.ptr, v_packed);
+      }
+      v_n += 8;
+    }
+  } else if (self->private_impl.f_depth == 4) {
+    while ((((uint64_t)(v_dst.len)) >= 8) && (((uint64_t)(v_src.len)) >= 4)) {
+      v_c = v_dst;
+      v_dst = wuffs_base__slice_u8__subslice_i(v_dst, 8);
+      v_packed = ((uint64_t)(wuffs_base__peek_u32le__no_bounds_check(v_src.ptr)));
+      v_src = wuffs_base__slice_u8__subslice_i(v_src, 4);
+      v_packed = wuffs_png__decoder__unpack_group(self, v_packed, a_multiplier);
+      if (((uint64_t)(v_c.len)) >= 8) {
+        wuffs_base__poke_u64le__no_bounds_check(v_c.ptr, v_packed);
+      }
+      v_n += 8;
+    }
+  }
+  return v_n;
+}
+
+// -------- func png.decoder.unpack_group
+
+static uint64_t
+wuffs_png__decoder__unpack_group(
+    const wuffs_png__decoder* self,
+    uint64_t a_packed,
+    uint8_t a_multiplier) {
+  uint64_t v_packed = 0;
+
+  v_packed = a_packed;
+  if (self->private_impl.f_depth == 1) {
+    v_packed = (((v_packed >> 4) & 15) | ((v_packed & 15) << 32));
+    v_packed = (((v_packed >> 2) & 12884901891) | ((v_packed & 12884901891) << 16));
+    v_packed = (((v_packed >> 1) & 281479271743489) | ((v_packed & 281479271743489) << 8));
+  } else if (self->private_impl.f_depth == 2) {
+    v_packed = ((v_packed & 255) | ((v_packed & 65280) << 24));
+    v_packed = (((v_packed >> 4) & 64424509455) | ((v_packed & 64424509455) << 16));
+    v_packed = (((v_packed >> 2) & 844437815230467) | ((v_packed & 844437815230467) << 8));
+  } else {
+    v_packed = ((v_packed & 255) |
+        ((v_packed & 65280) << 8) |
+        ((v_packed & 16711680) << 16) |
+        ((v_packed & 4278190080) << 24));
+    v_packed = (((v_packed >> 4) & 4222189076152335) | ((v_packed & 4222189076152335) << 8));
+  }
+  return ((uint64_t)(v_packed * ((uint64_t)(a_multiplier))));
+}
+
+// -------- func png.decoder.put_pixel
+
+static wuffs_base__empty_struct
+wuffs_png__decoder__put_pixel(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_dst_palette,
+    wuffs_base__slice_u8 a_src) {
+  if ((self->private_impl.f_downscale_shift > 0) && (self->private_impl.f_interlace_pass == 0)) {
+    wuffs_base__slice_u8__copy_from_slice(a_dst, a_src);
+  } else {
+    wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(&self->private_impl.f_swizzler, a_dst, a_dst_palette, a_src);
+  }
+  return wuffs_base__make_empty_struct();
+}
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+// -------- func png.decoder.unpack_bits_x86_sse42
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static uint64_t
+wuffs_png__decoder__unpack_bits_x86_sse42(
+    wuffs_png__decoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_src,
+    uint8_t a_multiplier) {
+  wuffs_base__slice_u8 v_dst = {0};
+  wuffs_base__slice_u8 v_src = {0};
+  wuffs_base__slice_u8 v_c = {0};
+  uint8_t v_m = 0;
+  uint64_t v_n = 0;
+  __m128i v_x128 = {0};
+  __m128i v_y128 = {0};
+  __m128i v_spread = {0};
+  __m128i v_bits = {0};
+  __m128i v_mask1 = {0};
+  __m128i v_mask2 = {0};
+  __m128i v_mask3 = {0};
+  __m128i v_lut = {0};
+
+  v_dst = a_dst;
+  v_src = a_src;
+  v_m = a_multiplier;
+  if (self->private_impl.f_depth == 1) {
+    v_spread = _mm_set_epi8((int8_t)(1), (int8_t)(1), (int8_t)(1), (int8_t)(1), (int8_t)(1), (int8_t)(1), (int8_t)(1), (int8_t)(1), (int8_t)(0), (int8_t)(0), (int8_t)(0), (int8_t)(0), (int8_t)(0), (int8_t)(0), (int8_t)(0), (int8_t)(0));
+    v_bits = _mm_set_epi8((int8_t)(1), (int8_t)(2), (int8_t)(4), (int8_t)(8), (int8_t)(16), (int8_t)(32), (int8_t)(64), (int8_t)(128), (int8_t)(1), (int8_t)(2), (int8_t)(4), (int8_t)(8), (int8_t)(16), (int8_t)(32), (int8_t)(64), (int8_t)(128));
+    v_lut = _mm_set1_epi8((int8_t)(v_m));
+    while ((((uint64_t)(v_dst.len)) >= 16) && (((uint64_t)(v_src.len)) >= 2)) {
+      v_x128 = _mm_cvtsi32_si128((int32_t)(((uint32_t)(wuffs_base__peek_u16le__no_bounds_check(v_src.ptr)))));
+      v_x128 = _mm_and_si128(_mm_shuffle_epi8(v_x128, v_spread), v_bits);
+      v_x128 = _mm_and_si128(_mm_cmpeq_epi8(v_x128, v_bits), v_lut);
+      v_c = v_dst;
+      v_dst = wuffs_base__slice_u8__subslice_i(v_dst, 16);
+      v_src = wuffs_base__slice_u8__subslice_i(v_src, 2);
+      if (((uint64_t)(v_c.len)) >= 16) {
+        _mm_storeu_si128((__m128i*)(void*)(v_c.ptr), v_x128);
+      }
+      v_n += 16;
+    }
+    return v_n;
+  }
+  v_lut = _mm_set_epi8((int8_t)(((uint8_t)(v_m * 15))), (int8_t)(((uint8_t)(v_m * 14))), (int8_t)(((uint8_t)(v_m * 13))), (int8_t)(((uint8_t)(v_m * 12))), (int8_t)(((uint8_t)(v_m * 11))), (int8_t)(((uint8_t)(v_m * 10))), (int8_t)(((uint8_t)(v_m * 9))), (int8_t)(((uint8_t)(v_m * 8))), (int8_t)(((uint8_t)(v_m * 7))), (int8_t)(((uint8_t)(v_m * 6))), (int8_t)(((uint8_t)(v_m * 5))), (int8_t)(((uint8_t)(v_m * 4))), (int8_t)(((uint8_t)(v_m * 3))), (int8_t)(((uint8_t)(v_m * 2))), (int8_t)(v_m), (int8_t)(0));
+  if (self->private_impl.f_depth == 2) {
+    v_spread = _mm_set_epi8((int8_t)(3), (int8_t)(3), (int8_t)(3), (int8_t)(3), (int8_t)(2), (int8_t)(2), (int8_t)(2), (int8_t)(2), (int8_t)(1), (int8_t)(1), (int8_t)(1), (int8_t)(1), (int8_t)(0), (int8_t)(0), (int8_t)(0), (int8_t)(0));
+    v_mask1 = _mm_set_epi8((int8_t)(0), (int8_t)(0), (int8_t)(255), (int8_t)(0), (int8_t)(0), (int8_t)(0), (int8_t)(255), (int8_t)(0), (int8_t)(0), (int8_t)(0), (int8_t)(255), (int8_t)(0), (int8_t)(0), (int8_t)(0), (int8_t)(255), (int8_t)(0));
+    v_mask2 = _mm_set_epi8((int8_t)(0), (int8_t)(255), (int8_t)(0), (int8_t)(0), (int8_t)(0), (int8_t)(255), (int8_t)(0), (int8_t)(0), (int8_t)(0), (int8_t)(255), (int8_t)(0), (int8_t)(0), (int8_t)(0), (int8_t)(255), (int8_t)(0), (int8_t)(0));
+    v_mask3 = _mm_set_epi8((int8_t)(255), (int8_t)(0), (int8_t)(0), (int8_t)(0), (int8_t)(255), (int8_t)(0), (int8_t)(0), (int8_t)(0), (int8_t)(255), (int8_t)(0), (int8_t)(0), (int8_t)(0), (int8_t)(255), (int8_t)(0), (int8_t)(0), (int8_t)(0));
+    v_bits = _mm_set1_epi8((int8_t)(3));
+    while ((((uint64_t)(v_dst.len)) >= 16) && (((uint64_t)(v_src.len)) >= 4)) {
+      v_y128 = _mm_cvtsi32_si128((int32_t)(wuffs_base__peek_u32le__no_bounds_check(v_src.ptr)));
+      v_y128 = _mm_shuffle_epi8(v_y128, v_spread);
+      v_x128 = _mm_srli_epi16(v_y128, (int32_t)(6));
+      v_x128 = _mm_blendv_epi8(v_x128, _mm_srli_epi16(v_y128, (int32_t)(4)), v_mask1);
+      v_x128 = _mm_blendv_epi8(v_x128, _mm_srli_epi16(v_y128, (int32_t)(2)), v_mask2);
+      v_x128 = _mm_blendv_epi8(v_x128, v_y128, v_mask3);
+      v_x128 = _mm_shuffle_epi8(v_lut, _mm_and_si128(v_x128, v_bits));
+      v_c = v_dst;
+      v_dst = wuffs_base__slice_u8__subslice_i(v_dst, 16);
+      v_src = wuffs_base__slice_u8__subslice_i(v_src, 4);
+      if (((uint64_t)(v_c.len)) >= 16) {
+        _mm_storeu_si128((__m128i*)(void*)(v_c.ptr), v_x128);
+      }
+      v_n += 16;
+    }
+  } else if (self->private_impl.f_depth == 4) {
+    v_spread = _mm_set_epi8((int8_t)(7), (int8_t)(7), (int8_t)(6), (int8_t)(6), (int8_t)(5), (int8_t)(5), (int8_t)(4), (int8_t)(4), (int8_t)(3), (int8_t)(3), (int8_t)(2), (int8_t)(2), (int8_t)(1), (int8_t)(1), (int8_t)(0), (int8_t)(0));
+    v_mask1 = _mm_set_epi8((int8_t)(255), (int8_t)(0), (int8_t)(255), (int8_t)(0), (int8_t)(255), (int8_t)(0), (int8_t)(255), (int8_t)(0), (int8_t)(255), (int8_t)(0), (int8_t)(255), (int8_t)(0), (int8_t)(255), (int8_t)(0), (int8_t)(255), (int8_t)(0));
+    v_bits = _mm_set1_epi8((int8_t)(15));
+    while ((((uint64_t)(v_dst.len)) >= 16) && (((uint64_t)(v_src.len)) >= 8)) {
+      v_y128 = _mm_cvtsi64x_si128((int64_t)(wuffs_base__peek_u64le__no_bounds_check(v_src.ptr)));
+      v_y128 = _mm_shuffle_epi8(v_y128, v_spread);
+      v_x128 = _mm_srli_epi16(v_y128, (int32_t)(4));
+      v_x128 = _mm_blendv_epi8(v_x128, v_y128, v_mask1);
+      v_x128 = _mm_shuffle_epi8(v_lut, _mm_and_si128(v_x128, v_bits));
+      v_c = v_dst;
+      v_dst = wuffs_base__slice_u8__subslice_i(v_dst, 16);
+      v_src = wuffs_base__slice_u8__subslice_i(v_src, 8);
+      if (((uint64_t)(v_c.len)) >= 16) {
+        _mm_storeu_si128((__m128i*)(void*)(v_c.ptr), v_x128);
+      }
+      v_n += 16;
+    }
+  }
+  return v_n;
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
+
+// -------- func png.encoder.filter_row
+
+static wuffs_base__empty_struct
+wuffs_png__encoder__filter_row(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_curr,
+    wuffs_base__slice_u8 a_prev) {
+  uint64_t v_d = 0;
+  uint64_t v_n = 0;
+  wuffs_base__slice_u8 v_dst = {0};
+  wuffs_base__slice_u8 v_x = {0};
+  wuffs_base__slice_u8 v_a = {0};
+  wuffs_base__slice_u8 v_b = {0};
+  wuffs_base__slice_u8 v_c = {0};
+  uint64_t v_best = 0;
+  uint32_t v_f = 0;
+  uint32_t v_i = 0;
+
+  v_d = ((uint64_t)(self->private_impl.f_filter_distance));
+  v_n = ((uint64_t)(self->private_impl.f_bytes_per_row));
+  if ((1 > ((uint64_t)(a_dst.len))) || (v_d > ((uint64_t)(a_curr.len))) || (v_d > ((uint64_t)(a_prev.len)))) {
+    return wuffs_base__make_empty_struct();
+  }
+  v_dst = wuffs_base__slice_u8__subslice_i(a_dst, 1);
+  v_x = wuffs_base__slice_u8__subslice_i(a_curr, v_d);
+  v_b = wuffs_base__slice_u8__subslice_i(a_prev, v_d);
+  if ((v_n > ((uint64_t)(v_dst.len))) ||
+      (v_n > ((uint64_t)(v_x.len))) ||
+      (v_n > ((uint64_t)(v_b.len))) ||
+      (v_n > ((uint64_t)(a_curr.len))) ||
+      (v_n > ((uint64_t)(a_prev.len)))) {
+    return wuffs_base__make_empty_struct();
+  }
+  v_dst = wuffs_base__slice_u8__subslice_j(v_dst, v_n);
+  v_x = wuffs_base__slice_u8__subslice_j(v_x, v_n);
+  v_a = wuffs_base__slice_u8__subslice_j(a_curr, v_n);
+  v_b = wuffs_base__slice_u8__subslice_j(v_b, v_n);
+  v_c = wuffs_base__slice_u8__subslice_j(a_prev, v_n);
+  v_i = 0;
+  while (v_i < 5) {
+    self->private_impl.f_costs[v_i] = 0;
+    v_i += 1;
+  }
+  wuffs_png__encoder__accumulate_costs(self,
+      v_x,
+      v_a,
+      v_b,
+      v_c);
+  v_best = self->private_impl.f_costs[0];
+  v_i = 1;
+  while (v_i < 5) {
+    if (v_best > self->private_impl.f_costs[v_i]) {
+      v_best = self->private_impl.f_costs[v_i];
+      v_f = v_i;
+    }
+    v_i += 1;
+  }
+  if (1 <= ((uint64_t)(a_dst.len))) {
+    a_dst.ptr[0] = ((uint8_t)(v_f));
+  }
+  wuffs_png__encoder__write_residuals(self,
+      v_dst,
+      v_x,
+      v_a,
+      v_b,
+      v_c,
+      v_f);
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func png.encoder.accumulate_costs
+
+static wuffs_base__empty_struct
+wuffs_png__encoder__accumulate_costs(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_x,
+    wuffs_base__slice_u8 a_a,
+    wuffs_base__slice_u8 a_b,
+    wuffs_base__slice_u8 a_c) {
+  return (*self->private_impl.choosy_accumulate_costs)(self, a_x, a_a, a_b, a_c);
+}
+
+static wuffs_base__empty_struct
+wuffs_png__encoder__accumulate_costs__choosy_default(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_x,
+    wuffs_base__slice_u8 a_a,
+    wuffs_base__slice_u8 a_b,
+    wuffs_base__slice_u8 a_c) {
+  wuffs_png__encoder__accumulate_costs_fallback(self,
+      a_x,
+      a_a,
+      a_b,
+      a_c);
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func png.encoder.write_residuals
+
+static wuffs_base__empty_struct
+wuffs_png__encoder__write_residuals(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_x,
+    wuffs_base__slice_u8 a_a,
+    wuffs_base__slice_u8 a_b,
+    wuffs_base__slice_u8 a_c,
+    uint32_t a_filter) {
+  return (*self->private_impl.choosy_write_residuals)(self, a_dst, a_x, a_a, a_b, a_c, a_filter);
+}
+
+static wuffs_base__empty_struct
+wuffs_png__encoder__write_residuals__choosy_default(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_x,
+    wuffs_base__slice_u8 a_a,
+    wuffs_base__slice_u8 a_b,
+    wuffs_base__slice_u8 a_c,
+    uint32_t a_filter) {
+  wuffs_png__encoder__write_residuals_fallback(self,
+      a_dst,
+      a_x,
+      a_a,
+      a_b,
+      a_c,
+      a_filter);
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func png.encoder.accumulate_costs_fallback
+
+static wuffs_base__empty_struct
+wuffs_png__encoder__accumulate_costs_fallback(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_x,
+    wuffs_base__slice_u8 a_a,
+    wuffs_base__slice_u8 a_b,
+    wuffs_base__slice_u8 a_c) {
+  wuffs_base__slice_u8 v_x = {0};
+  wuffs_base__slice_u8 v_a = {0};
+  wuffs_base__slice_u8 v_b = {0};
+  wuffs_base__slice_u8 v_c = {0};
+  uint32_t v_fx = 0;
+  uint32_t v_fa = 0;
+  uint32_t v_fb = 0;
+  uint32_t v_fc = 0;
+  uint32_t v_r = 0;
+  uint64_t v_c0 = 0;
+  uint64_t v_c1 = 0;
+  uint64_t v_c2 = 0;
+  uint64_t v_c3 = 0;
+  uint64_t v_c4 = 0;
+
+  {
+    wuffs_base__slice_u8 i_slice_x = a_x;
+    v_x.ptr = i_slice_x.ptr;
+    wuffs_base__slice_u8 i_slice_a = a_a;
+    v_a.ptr = i_slice_a.ptr;
+    i_slice_x.len = ((size_t)(wuffs_base__u64__min(i_slice_x.len, i_slice_a.len)));
+    wuffs_base__slice_u8 i_slice_b = a_b;
+    v_b.ptr = i_slice_b.ptr;
+    i_slice_x.len = ((size_t)(wuffs_base__u64__min(i_slice_x.len, i_slice_b.len)));
+    wuffs_base__slice_u8 i_slice_c = a_c;
+    v_c.ptr = i_slice_c.ptr;
+    i_slice_x.len = ((size_t)(wuffs_base__u64__min(i_slice_x.len, i_slice_c.len)));
+    v_x.len = 1;
+    v_a.len = 1;
+    v_b.len = 1;
+    v_c.len = 1;
+    uint8_t* i_end0_x = i_slice_x.ptr + i_slice_x.len;
+    while (v_x.ptr < i_end0_x) {
+      v_fx = ((uint32_t)(v_x.ptr[0]));
+      v_fa = ((uint32_t)(v_a.ptr[0]));
+      v_fb = ((uint32_t)(v_b.ptr[0]));
+      v_fc = ((uint32_t)(v_c.ptr[0]));
+      v_r = v_fx;
+      v_c0 += ((uint64_t)(wuffs_base__u32__min(v_r, (256 - v_r))));
+      v_r = (((uint32_t)(v_fx - v_fa)) & 255);
+      v_c1 += ((uint64_t)(wuffs_base__u32__min(v_r, (256 - v_r))));
+      v_r = (((uint32_t)(v_fx - v_fb)) & 255);
+      v_c2 += ((uint64_t)(wuffs_base__u32__min(v_r, (256 - v_r))));
+      v_r = (((uint32_t)(v_fx - ((v_fa + v_fb) / 2))) & 255);
+      v_c3 += ((uint64_t)(wuffs_base__u32__min(v_r, (256 - v_r))));
+      v_r = (((uint32_t)(v_fx - wuffs_png__encoder__paeth(self, v_fa, v_fb, v_fc))) & 255);
+      v_c4 += ((uint64_t)(wuffs_base__u32__min(v_r, (256 - v_r))));
+      v_x.ptr += 1;
+      v_a.ptr += 1;
+      v_b.ptr += 1;
+      v_c.ptr += 1;
+    }
+    v_x.len = 0;
+    v_a.len = 0;
+    v_b.len = 0;
+    v_c.len = 0;
+  }
+  self->private_impl.f_costs[0] += v_c0;
+  self->private_impl.f_costs[1] += v_c1;
+  self->private_impl.f_costs[2] += v_c2;
+  self->private_impl.f_costs[3] += v_c3;
+  self->private_impl.f_costs[4] += v_c4;
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func png.encoder.write_residuals_fallback
+
+static wuffs_base__empty_struct
+wuffs_png__encoder__write_residuals_fallback(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_x,
+    wuffs_base__slice_u8 a_a,
+    wuffs_base__slice_u8 a_b,
+    wuffs_base__slice_u8 a_c,
+    uint32_t a_filter) {
+  wuffs_base__slice_u8 v_dst = {0};
+  wuffs_base__slice_u8 v_x = {0};
+  wuffs_base__slice_u8 v_a = {0};
+  wuffs_base__slice_u8 v_b = {0};
+  wuffs_base__slice_u8 v_c = {0};
+  uint32_t v_fa = 0;
+  uint32_t v_fb = 0;
+  uint32_t v_fp = 0;
+
+  {
+    wuffs_base__slice_u8 i_slice_dst = a_dst;
+    v_dst.ptr = i_slice_dst.ptr;
+    wuffs_base__slice_u8 i_slice_x = a_x;
+    v_x.ptr = i_slice_x.ptr;
+    i_slice_dst.len = ((size_t)(wuffs_base__u64__min(i_slice_dst.len, i_slice_x.len)));
+    wuffs_base__slice_u8 i_slice_a = a_a;
+    v_a.ptr = i_slice_a.ptr;
+    i_slice_dst.len = ((size_t)(wuffs_base__u64__min(i_slice_dst.len, i_slice_a.len)));
+    wuffs_base__slice_u8 i_slice_b = a_b;
+    v_b.ptr = i_slice_b.ptr;
+    i_slice_dst.len = ((size_t)(wuffs_base__u64__min(i_slice_dst.len, i_slice_b.len)));
+    wuffs_base__slice_u8 i_slice_c = a_c;
+    v_c.ptr = i_slice_c.ptr;
+    i_slice_dst.len = ((size_t)(wuffs_base__u64__min(i_slice_dst.len, i_slice_c.len)));
+    v_dst.len = 1;
+    v_x.len = 1;
+    v_a.len = 1;
+    v_b.len = 1;
+    v_c.len = 1;
+    uint8_t* i_end0_dst = i_slice_dst.ptr + i_slice_dst.len;
+    while (v_dst.ptr < i_end0_dst) {
+      v_fa = ((uint32_t)(v_a.ptr[0]));
+      v_fb = ((uint32_t)(v_b.ptr[0]));
+      if (a_filter == 0) {
+        v_fp = 0;
+      } else if (a_filter == 1) {
+        v_fp = v_fa;
+      } else if (a_filter == 2) {
+        v_fp = v_fb;
+      } else if (a_filter == 3) {
+        v_fp = ((v_fa + v_fb) / 2);
+      } else {
+        v_fp = wuffs_png__encoder__paeth(self, v_fa, v_fb, ((uint32_t)(v_c.ptr[0])));
+      }
+      v_dst.ptr[0] = ((uint8_t)((((uint32_t)(((uint32_t)(v_x.ptr[0])) - v_fp)) & 255)));
+      v_dst.ptr += 1;
+      v_x.ptr += 1;
+      v_a.ptr += 1;
+      v_b.ptr += 1;
+      v_c.ptr += 1;
+    }
+    v_dst.len = 0;
+    v_x.len = 0;
+    v_a.len = 0;
+    v_b.len = 0;
+    v_c.len = 0;
+  }
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func png.encoder.paeth
+
+static uint32_t
+wuffs_png__encoder__paeth(
+    const wuffs_png__encoder* self,
+    uint32_t a_a,
+    uint32_t a_b,
+    uint32_t a_c) {
+  uint32_t v_pp = 0;
+  uint32_t v_pa = 0;
+  uint32_t v_pb = 0;
+  uint32_t v_pc = 0;
+
+  v_pp = ((uint32_t)(((uint32_t)(a_a + a_b)) - a_c));
+  v_pa = ((uint32_t)(v_pp - a_a));
+  if (v_pa >= 2147483648) {
+    v_pa = ((uint32_t)(0 - v_pa));
+  }
+  v_pb = ((uint32_t)(v_pp - a_b));
+  if (v_pb >= 2147483648) {
+    v_pb = ((uint32_t)(0 - v_pb));
+  }
+  v_pc = ((uint32_t)(v_pp - a_c));
+  if (v_pc >= 2147483648) {
+    v_pc = ((uint32_t)(0 - v_pc));
+  }
+  if ((v_pa <= v_pb) && (v_pa <= v_pc)) {
+    return a_a;
+  } else if (v_pb <= v_pc) {
+    return a_b;
+  }
+  return a_c;
+}
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+// -------- func png.encoder.accumulate_costs_x86_sse42
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static wuffs_base__empty_struct
+wuffs_png__encoder__accumulate_costs_x86_sse42(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_x,
+    wuffs_base__slice_u8 a_a,
+    wuffs_base__slice_u8 a_b,
+    wuffs_base__slice_u8 a_c) {
+  wuffs_base__slice_u8 v_x = {0};
+  wuffs_base__slice_u8 v_a = {0};
+  wuffs_base__slice_u8 v_b = {0};
+  wuffs_base__slice_u8 v_c = {0};
+  __m128i v_x128 = {0};
+  __m128i v_a128 = {0};
+  __m128i v_b128 = {0};
+  __m128i v_c128 = {0};
+  __m128i v_k128 = {0};
+  __m128i v_z128 = {0};
+  __m128i v_r128 = {0};
+  __m128i v_p128 = {0};
+  __m128i v_plo = {0};
+  __m128i v_phi = {0};
+  __m128i v_alo = {0};
+  __m128i v_blo = {0};
+  __m128i v_clo = {0};
+  __m128i v_pa = {0};
+  __m128i v_pb = {0};
+  __m128i v_pc = {0};
+  __m128i v_pm = {0};
+  __m128i v_acc0 = {0};
+  __m128i v_acc1 = {0};
+  __m128i v_acc2 = {0};
+  __m128i v_acc3 = {0};
+  __m128i v_acc4 = {0};
+
+  v_k128 = _mm_set1_epi8((int8_t)(1));
+  {
+    wuffs_base__slice_u8 i_slice_x = a_x;
+    v_x.ptr = i_slice_x.ptr;
+    wuffs_base__slice_u8 i_slice_a = a_a;
+    v_a.ptr = i_slice_a.ptr;
+    i_slice_x.len = ((size_t)(wuffs_base__u64__min(i_slice_x.len, i_slice_a.len)));
+    wuffs_base__slice_u8 i_slice_b = a_b;
+    v_b.ptr = i_slice_b.ptr;
+    i_slice_x.len = ((size_t)(wuffs_base__u64__min(i_slice_x.len, i_slice_b.len)));
+    wuffs_base__slice_u8 i_slice_c = a_c;
+    v_c.ptr = i_slice_c.ptr;
+    i_slice_x.len = ((size_t)(wuffs_base__u64__min(i_slice_x.len, i_slice_c.len)));
+    v_x.len = 16;
+    v_a.len = 16;
+    v_b.len = 16;
+    v_c.len = 16;
+    uint8_t* i_end0_x = v_x.ptr + (((i_slice_x.len - (size_t)(v_x.ptr - i_slice_x.ptr)) / 16) * 16);
+    while (v_x.ptr < i_end0_x) {
+      v_x128 = _mm_lddqu_si128((const __m128i*)(const void*)(v_x.ptr));
+      v_a128 = _mm_lddqu_si128((const __m128i*)(const void*)(v_a.ptr));
+      v_b128 = _mm_lddqu_si128((const __m128i*)(const void*)(v_b.ptr));
+      v_c128 = _mm_lddqu_si128((const __m128i*)(const void*)(v_c.ptr));
+      v_r128 = v_x128;
+      v_acc0 = _mm_add_epi64(v_acc0, _mm_sad_epu8(_mm_min_epu8(v_r128, _mm_sub_epi8(v_z128, v_r128)), v_z128));
+      v_r128 = _mm_sub_epi8(v_x128, v_a128);
+      v_acc1 = _mm_add_epi64(v_acc1, _mm_sad_epu8(_mm_min_epu8(v_r128, _mm_sub_epi8(v_z128, v_r128)), v_z128));
+      v_r128 = _mm_sub_epi8(v_x128, v_b128);
+      v_acc2 = _mm_add_epi64(v_acc2, _mm_sad_epu8(_mm_min_epu8(v_r128, _mm_sub_epi8(v_z128, v_r128)), v_z128));
+      v_p128 = _mm_avg_epu8(v_a128, v_b128);
+      v_p128 = _mm_sub_epi8(v_p128, _mm_and_si128(v_k128, _mm_xor_si128(v_a128, v_b128)));
+      v_r128 = _mm_sub_epi8(v_x128, v_p128);
+      v_acc3 = _mm_add_epi64(v_acc3, _mm_sad_epu8(_mm_min_epu8(v_r128, _mm_sub_epi8(v_z128, v_r128)), v_z128));
+      v_alo = _mm_unpacklo_epi8(v_a128, v_z128);
+      v_blo = _mm_unpacklo_epi8(v_b128, v_z128);
+      v_clo = _mm_unpacklo_epi8(v_c128, v_z128);
+      v_pa = _mm_sub_epi16(v_blo, v_clo);
+      v_pb = _mm_sub_epi16(v_alo, v_clo);
+      v_pc = _mm_abs_epi16(_mm_add_epi16(v_pa, v_pb));
+      v_pa = _mm_abs_epi16(v_pa);
+      v_pb = _mm_abs_epi16(v_pb);
+      v_pm = _mm_min_epi16(v_pa, _mm_min_epi16(v_pb, v_pc));
+      v_plo = _mm_blendv_epi8(v_clo, v_blo, _mm_cmpeq_epi16(v_pb, v_pm));
+      v_plo = _mm_blendv_epi8(v_plo, v_alo, _mm_cmpeq_epi16(v_pa, v_pm));
+      v_alo = _mm_unpackhi_epi8(v_a128, v_z128);
+      v_blo = _mm_unpackhi_epi8(v_b128, v_z128);
+      v_clo = _mm_unpackhi_epi8(v_c128, v_z128);
+      v_pa = _mm_sub_epi16(v_blo, v_clo);
+      v_pb = _mm_sub_epi16(v_alo, v_clo);
+      v_pc = _mm_abs_epi16(_mm_add_epi16(v_pa, v_pb));
+      v_pa = _mm_abs_epi16(v_pa);
+      v_pb = _mm_abs_epi16(v_pb);
+      v_pm = _mm_min_epi16(v_pa, _mm_min_epi16(v_pb, v_pc));
+      v_phi = _mm_blendv_epi8(v_clo, v_blo, _mm_cmpeq_epi16(v_pb, v_pm));
+      v_phi = _mm_blendv_epi8(v_phi, v_alo, _mm_cmpeq_epi16(v_pa, v_pm));
+      v_r128 = _mm_sub_epi8(v_x128, _mm_packus_epi16(v_plo, v_phi));
+      v_acc4 = _mm_add_epi64(v_acc4, _mm_sad_epu8(_mm_min_epu8(v_r128, _mm_sub_epi8(v_z128, v_r128)), v_z128));
+      v_x.ptr += 16;
+      v_a.ptr += 16;
+      v_b.ptr += 16;
+      v_c.ptr += 16;
+    }
+    v_x.len = 1;
+    v_a.len = 1;
+    v_b.len = 1;
+    v_c.len = 1;
+    uint8_t* i_end1_x = i_slice_x.ptr + i_slice_x.len;
+    while (v_x.ptr < i_end1_x) {
+      wuffs_png__encoder__accumulate_costs_fallback(self,
+          v_x,
+          v_a,
+          v_b,
+          v_c);
+      v_x.ptr += 1;
+      v_a.ptr += 1;
+      v_b.ptr += 1;
+      v_c.ptr += 1;
+    }
+    v_x.len = 0;
+    v_a.len = 0;
+    v_b.len = 0;
+    v_c.len = 0;
+  }
+  self->private_impl.f_costs[0] += ((uint64_t)(((uint64_t)(_mm_extract_epi64(v_acc0, (int32_t)(0)))) + ((uint64_t)(_mm_extract_epi64(v_acc0, (int32_t)(1))))));
+  self->private_impl.f_costs[1] += ((uint64_t)(((uint64_t)(_mm_extract_epi64(v_acc1, (int32_t)(0)))) + ((uint64_t)(_mm_extract_epi64(v_acc1, (int32_t)(1))))));
+  self->private_impl.f_costs[2] += ((uint64_t)(((uint64_t)(_mm_extract_epi64(v_acc2, (int32_t)(0)))) + ((uint64_t)(_mm_extract_epi64(v_acc2, (int32_t)(1))))));
+  self->private_impl.f_costs[3] += ((uint64_t)(((uint64_t)(_mm_extract_epi64(v_acc3, (int32_t)(0)))) + ((uint64_t)(_mm_extract_epi64(v_acc3, (int32_t)(1))))));
+  self->private_impl.f_costs[4] += ((uint64_t)(((uint64_t)(_mm_extract_epi64(v_acc4, (int32_t)(0)))) + ((uint64_t)(_mm_extract_epi64(v_acc4, (int32_t)(1))))));
+  return wuffs_base__make_empty_struct();
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
+
+// ‼ WUFFS MULTI-FILE SECTION +x86_sse42
+// -------- func png.encoder.write_residuals_x86_sse42
+
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+WUFFS_BASE__MAYBE_ATTRIBUTE_TARGET("pclmul,popcnt,sse4.2")
+static wuffs_base__empty_struct
+wuffs_png__encoder__write_residuals_x86_sse42(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_dst,
+    wuffs_base__slice_u8 a_x,
+    wuffs_base__slice_u8 a_a,
+    wuffs_base__slice_u8 a_b,
+    wuffs_base__slice_u8 a_c,
+    uint32_t a_filter) {
+  wuffs_base__slice_u8 v_dst = {0};
+  wuffs_base__slice_u8 v_x = {0};
+  wuffs_base__slice_u8 v_a = {0};
+  wuffs_base__slice_u8 v_b = {0};
+  wuffs_base__slice_u8 v_c = {0};
+  __m128i v_x128 = {0};
+  __m128i v_a128 = {0};
+  __m128i v_b128 = {0};
+  __m128i v_c128 = {0};
+  __m128i v_k128 = {0};
+  __m128i v_z128 = {0};
+  __m128i v_p128 = {0};
+  __m128i v_plo = {0};
+  __m128i v_phi = {0};
+  __m128i v_alo = {0};
+  __m128i v_blo = {0};
+  __m128i v_clo = {0};
+  __m128i v_pa = {0};
+  __m128i v_pb = {0};
+  __m128i v_pc = {0};
+  __m128i v_pm = {0};
+
+  v_k128 = _mm_set1_epi8((int8_t)(1));
+  {
+    wuffs_base__slice_u8 i_slice_dst = a_dst;
+    v_dst.ptr = i_slice_dst.ptr;
+    wuffs_base__slice_u8 i_slice_x = a_x;
+    v_x.ptr = i_slice_x.ptr;
+    i_slice_dst.len = ((size_t)(wuffs_base__u64__min(i_slice_dst.len, i_slice_x.len)));
+    wuffs_base__slice_u8 i_slice_a = a_a;
+    v_a.ptr = i_slice_a.ptr;
+    i_slice_dst.len = ((size_t)(wuffs_base__u64__min(i_slice_dst.len, i_slice_a.len)));
+    wuffs_base__slice_u8 i_slice_b = a_b;
+    v_b.ptr = i_slice_b.ptr;
+    i_slice_dst.len = ((size_t)(wuffs_base__u64__min(i_slice_dst.len, i_slice_b.len)));
+    wuffs_base__slice_u8 i_slice_c = a_c;
+    v_c.ptr = i_slice_c.ptr;
+    i_slice_dst.len = ((size_t)(wuffs_base__u64__min(i_slice_dst.len, i_slice_c.len)));
+    v_dst.len = 16;
+    v_x.len = 16;
+    v_a.len = 16;
+    v_b.len = 16;
+    v_c.len = 16;
+    uint8_t* i_end0_dst = v_dst.ptr + (((i_slice_dst.len - (size_t)(v_dst.ptr - i_slice_dst.ptr)) / 16) * 16);
+    while (v_dst.ptr < i_end0_dst) {
+      v_x128 = _mm_lddqu_si128((const __m128i*)(const void*)(v_x.ptr));
+      if (a_filter == 0) {
+        v_p128 = v_z128;
+      } else if (a_filter == 1) {
+        v_p128 = _mm_lddqu_si128((const __m128i*)(const void*)(v_a.ptr));
+      } else if (a_filter == 2) {
+        v_p128 = _mm_lddqu_si128((const __m128i*)(const void*)(v_b.ptr));
+      } else if (a_filter == 3) {
+        v_a128 = _mm_lddqu_si128((const __m128i*)(const void*)(v_a.ptr));
+        v_b128 = _mm_lddqu_si128((const __m128i*)(const void*)(v_b.ptr));
+        v_p128 = _mm_avg_epu8(v_a128, v_b128);
+        v_p128 = _mm_sub_epi8(v_p128, _mm_and_si128(v_k128, _mm_xor_si128(v_a128, v_b128)));
+      } else {
+        v_a128 = _mm_lddqu_si128((const __m128i*)(const void*)(v_a.ptr));
+        v_b128 = _mm_lddqu_si128((const __m128i*)(const void*)(v_b.ptr));
+        v_c128 = _mm_lddqu_si128((const __m128i*)(const void*)(v_c.ptr));
+        v_alo = _mm_unpacklo_epi8(v_a128, v_z128);
+        v_blo = _mm_unpacklo_epi8(v_b128, v_z128);
+        v_clo = _mm_unpacklo_epi8(v_c128, v_z128);
+        v_pa = _mm_sub_epi16(v_blo, v_clo);
+        v_pb = _mm_sub_epi16(v_alo, v_clo);
+        v_pc = _mm_abs_epi16(_mm_add_epi16(v_pa, v_pb));
+        v_pa = _mm_abs_epi16(v_pa);
+        v_pb = _mm_abs_epi16(v_pb);
+        v_pm = _mm_min_epi16(v_pa, _mm_min_epi16(v_pb, v_pc));
+        v_plo = _mm_blendv_epi8(v_clo, v_blo, _mm_cmpeq_epi16(v_pb, v_pm));
+        v_plo = _mm_blendv_epi8(v_plo, v_alo, _mm_cmpeq_epi16(v_pa, v_pm));
+        v_alo = _mm_unpackhi_epi8(v_a128, v_z128);
+        v_blo = _mm_unpackhi_epi8(v_b128, v_z128);
+        v_clo = _mm_unpackhi_epi8(v_c128, v_z128);
+        v_pa = _mm_sub_epi16(v_blo, v_clo);
+        v_pb = _mm_sub_epi16(v_alo, v_clo);
+        v_pc = _mm_abs_epi16(_mm_add_epi16(v_pa, v_pb));
+        v_pa = _mm_abs_epi16(v_pa);
+        v_pb = _mm_abs_epi16(v_pb);
+        v_pm = _mm_min_epi16(v_pa, _mm_min_epi16(v_pb, v_pc));
+        v_phi = _mm_blendv_epi8(v_clo, v_blo, _mm_cmpeq_epi16(v_pb, v_pm));
+        v_phi = _mm_blendv_epi8(v_phi, v_alo, _mm_cmpeq_epi16(v_pa, v_pm));
+        v_p128 = _mm_packus_epi16(v_plo, v_phi);
+      }
+      _mm_storeu_si128((__m128i*)(void*)(v_dst.ptr), _mm_sub_epi8(v_x128, v_p128));
+      v_dst.ptr += 16;
+      v_x.ptr += 16;
+      v_a.ptr += 16;
+      v_b.ptr += 16;
+      v_c.ptr += 16;
+    }
+    v_dst.len = 1;
+    v_x.len = 1;
+    v_a.len = 1;
+    v_b.len = 1;
+    v_c.len = 1;
+    uint8_t* i_end1_dst = i_slice_dst.ptr + i_slice_dst.len;
+    while (v_dst.ptr < i_end1_dst) {
+      wuffs_png__encoder__write_residuals_fallback(self,
+          v_dst,
+          v_x,
+          v_a,
+          v_b,
+          v_c,
+          a_filter);
+      v_dst.ptr += 1;
+      v_x.ptr += 1;
+      v_a.ptr += 1;
+      v_b.ptr += 1;
+      v_c.ptr += 1;
+    }
+    v_dst.len = 0;
+    v_x.len = 0;
+    v_a.len = 0;
+    v_b.len = 0;
+    v_c.len = 0;
   }
+  return wuffs_base__make_empty_struct();
+}
+#endif  // defined(WUFFS_BASE__CPU_ARCH__X86_64)
+// ‼ WUFFS MULTI-FILE SECTION -x86_sse42
 
-  goto suspend;
-  suspend:
-  self->private_impl.p_decode_frame_config[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
-  self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 2 : 0;
+// -------- func png.encoder.set_level
 
-  goto exit;
-  exit:
-  if (a_src) {
-    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_png__encoder__set_level(
+    wuffs_png__encoder* self,
+    uint32_t a_level) {
+  if (!self) {
+    return wuffs_base__make_empty_struct();
   }
-
-  if (wuffs_base__status__is_error(&status)) {
-    self->private_impl.magic = WUFFS_BASE__DISABLED;
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_empty_struct();
   }
-  return status;
+
+  self->private_impl.f_level = wuffs_base__u32__min(a_level, 9);
+  self->private_impl.f_level_is_set = true;
+  return wuffs_base__make_empty_struct();
 }
 
-// -------- func png.decoder.decode_frame
+// -------- func png.encoder.set_quirk_enabled
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
+wuffs_png__encoder__set_quirk_enabled(
+    wuffs_png__encoder* self,
+    uint32_t a_quirk,
+    bool a_enabled) {
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func png.encoder.prepare
 
 WUFFS_BASE__MAYBE_STATIC wuffs_base__status
-wuffs_png__decoder__decode_frame(
-    wuffs_png__decoder* self,
-    wuffs_base__pixel_buffer* a_dst,
-    wuffs_base__io_buffer* a_src,
-    wuffs_base__pixel_blend a_blend,
-    wuffs_base__slice_u8 a_workbuf,
-    wuffs_base__decode_frame_options* a_opts) {
+wuffs_png__encoder__prepare(
+    wuffs_png__encoder* self,
+    wuffs_base__pixel_buffer* a_src) {
   if (!self) {
     return wuffs_base__make_status(wuffs_base__error__bad_receiver);
   }
@@ -37639,118 +49959,132 @@ wuffs_png__decoder__decode_frame(
         ? wuffs_base__error__disabled_by_previous_error
         : wuffs_base__error__initialize_not_called);
   }
-  if (!a_dst || !a_src) {
+  if (!a_src) {
     self->private_impl.magic = WUFFS_BASE__DISABLED;
     return wuffs_base__make_status(wuffs_base__error__bad_argument);
   }
-  if ((self->private_impl.active_coroutine != 0) &&
-      (self->private_impl.active_coroutine != 3)) {
-    self->private_impl.magic = WUFFS_BASE__DISABLED;
-    return wuffs_base__make_status(wuffs_base__error__interleaved_coroutine_calls);
-  }
-  self->private_impl.active_coroutine = 0;
-  wuffs_base__status status = wuffs_base__make_status(NULL);
 
+  wuffs_base__pixel_format v_src_pixfmt = {0};
+  uint32_t v_dst_repr = 0;
+  uint32_t v_bpp = 0;
   wuffs_base__status v_status = wuffs_base__make_status(NULL);
-  uint32_t v_pass_width = 0;
-  uint32_t v_pass_height = 0;
-
-  uint32_t coro_susp_point = self->private_impl.p_decode_frame[0];
-  switch (coro_susp_point) {
-    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+  wuffs_base__table_u8 v_tab = {0};
+  uint64_t v_w = 0;
+  uint64_t v_h = 0;
 
-    if (self->private_impl.f_call_sequence < 4) {
-      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
-      status = wuffs_png__decoder__decode_frame_config(self, NULL, a_src);
-      if (status.repr) {
-        goto suspend;
-      }
-    } else if (self->private_impl.f_call_sequence == 4) {
-    } else {
-      status = wuffs_base__make_status(wuffs_base__note__end_of_data);
-      goto ok;
-    }
-    v_status = wuffs_base__pixel_swizzler__prepare(&self->private_impl.f_swizzler,
-        wuffs_base__pixel_buffer__pixel_format(a_dst),
-        wuffs_base__pixel_buffer__palette_or_else(a_dst, wuffs_base__make_slice_u8(self->private_data.f_dst_palette, 1024)),
-        wuffs_base__utility__make_pixel_format(self->private_impl.f_src_pixfmt),
-        wuffs_base__make_slice_u8(self->private_data.f_src_palette, 1024),
-        a_blend);
-    if ( ! wuffs_base__status__is_ok(&v_status)) {
-      status = v_status;
-      if (wuffs_base__status__is_error(&status)) {
-        goto exit;
-      } else if (wuffs_base__status__is_suspension(&status)) {
-        status = wuffs_base__make_status(wuffs_base__error__cannot_return_a_suspension);
-        goto exit;
-      }
-      goto ok;
-    }
-    while (true) {
-      v_pass_width = (16777215 & ((((uint32_t)(WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][1])) + self->private_impl.f_width) >> WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][0]));
-      v_pass_height = (16777215 & ((((uint32_t)(WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][4])) + self->private_impl.f_height) >> WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][3]));
-      if ((v_pass_width > 0) && (v_pass_height > 0)) {
-        self->private_impl.f_pass_bytes_per_row = wuffs_png__decoder__calculate_bytes_per_row(self, v_pass_width);
-        self->private_impl.f_pass_workbuf_length = (((uint64_t)(v_pass_height)) * (1 + self->private_impl.f_pass_bytes_per_row));
-        WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
-        status = wuffs_png__decoder__decode_pass(self, a_src, a_workbuf);
-        if (status.repr) {
-          goto suspend;
-        }
-        v_status = wuffs_png__decoder__filter_and_swizzle(self, a_dst, a_workbuf);
-        if ( ! wuffs_base__status__is_ok(&v_status)) {
-          status = v_status;
-          if (wuffs_base__status__is_error(&status)) {
-            goto exit;
-          } else if (wuffs_base__status__is_suspension(&status)) {
-            status = wuffs_base__make_status(wuffs_base__error__cannot_return_a_suspension);
-            goto exit;
-          }
-          goto ok;
-        }
-      }
-      if ((self->private_impl.f_interlace_pass == 0) || (self->private_impl.f_interlace_pass >= 7)) {
-        goto label__0__break;
-      }
-#if defined(__GNUC__)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wconversion"
+  if (self->private_impl.f_call_sequence == 2) {
+    return wuffs_base__make_status(wuffs_base__error__bad_call_sequence);
+  }
+  self->private_impl.f_call_sequence = 0;
+  v_src_pixfmt = wuffs_base__pixel_buffer__pixel_format(a_src);
+  v_bpp = wuffs_base__pixel_format__bits_per_pixel(&v_src_pixfmt);
+  if (v_bpp == 8) {
+    v_dst_repr = 536870920;
+    self->private_impl.f_color_type = 0;
+    self->private_impl.f_filter_distance = 1;
+  } else if (v_bpp == 24) {
+    v_dst_repr = 2684356744;
+    self->private_impl.f_color_type = 2;
+    self->private_impl.f_filter_distance = 3;
+  } else if (v_bpp == 32) {
+    v_dst_repr = 2701166728;
+    self->private_impl.f_color_type = 6;
+    self->private_impl.f_filter_distance = 4;
+  } else {
+    return wuffs_base__make_status(wuffs_base__error__unsupported_pixel_swizzler_option);
+  }
+  v_status = wuffs_base__pixel_swizzler__prepare(&self->private_impl.f_swizzler,
+      wuffs_base__utility__make_pixel_format(v_dst_repr),
+      wuffs_base__utility__empty_slice_u8(),
+      v_src_pixfmt,
+      wuffs_base__pixel_buffer__palette(a_src),
+      wuffs_base__utility__make_pixel_blend(0));
+  if ( ! wuffs_base__status__is_ok(&v_status)) {
+    return wuffs_base__status__ensure_not_a_suspension(v_status);
+  }
+  v_tab = wuffs_base__pixel_buffer__plane(a_src, 0);
+  v_w = ((uint64_t)(v_tab.width));
+  if (self->private_impl.f_filter_distance == 3) {
+    v_w = (v_w / 3);
+  } else if (self->private_impl.f_filter_distance == 4) {
+    v_w = (v_w / 4);
+  }
+  v_h = ((uint64_t)(v_tab.height));
+  if ((v_w <= 0) ||
+      (v_w > 16777215) ||
+      (v_h <= 0) ||
+      (v_h > 16777215)) {
+    return wuffs_base__make_status(wuffs_png__error__unsupported_image_dimensions);
+  }
+  self->private_impl.f_width = ((uint32_t)(v_w));
+  self->private_impl.f_height = ((uint32_t)(v_h));
+  self->private_impl.f_bytes_per_row = (self->private_impl.f_width * self->private_impl.f_filter_distance);
+  self->private_impl.choosy_accumulate_costs = (
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      wuffs_base__cpu_arch__have_x86_sse42() ? &wuffs_png__encoder__accumulate_costs_x86_sse42 :
 #endif
-      self->private_impl.f_interlace_pass += 1;
-#if defined(__GNUC__)
-#pragma GCC diagnostic pop
+      self->private_impl.choosy_accumulate_costs);
+  self->private_impl.choosy_write_residuals = (
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      wuffs_base__cpu_arch__have_x86_sse42() ? &wuffs_png__encoder__write_residuals_x86_sse42 :
 #endif
-    }
-    label__0__break:;
-    self->private_impl.f_call_sequence = 255;
+      self->private_impl.choosy_write_residuals);
+  wuffs_base__ignore_status(wuffs_adler32__hasher__initialize(&self->private_data.f_adler32, sizeof (wuffs_adler32__hasher), WUFFS_VERSION, 0));
+  wuffs_base__ignore_status(wuffs_crc32__ieee_hasher__initialize(&self->private_data.f_crc32, sizeof (wuffs_crc32__ieee_hasher), WUFFS_VERSION, 0));
+  wuffs_base__ignore_status(wuffs_deflate__encoder__initialize(&self->private_data.f_flate, sizeof (wuffs_deflate__encoder), WUFFS_VERSION, 0));
+  self->private_impl.f_call_sequence = 1;
+  return wuffs_base__make_status(NULL);
+}
 
-    ok:
-    self->private_impl.p_decode_frame[0] = 0;
-    goto exit;
+// -------- func png.encoder.workbuf_len
+
+WUFFS_BASE__MAYBE_STATIC wuffs_base__range_ii_u64
+wuffs_png__encoder__workbuf_len(
+    const wuffs_png__encoder* self) {
+  if (!self) {
+    return wuffs_base__utility__empty_range_ii_u64();
+  }
+  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
+      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
+    return wuffs_base__utility__empty_range_ii_u64();
   }
 
-  goto suspend;
-  suspend:
-  self->private_impl.p_decode_frame[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
-  self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 3 : 0;
+  uint64_t v_n = 0;
 
-  goto exit;
-  exit:
-  if (wuffs_base__status__is_error(&status)) {
-    self->private_impl.magic = WUFFS_BASE__DISABLED;
-  }
-  return status;
+  v_n = ((3 * ((uint64_t)(self->private_impl.f_bytes_per_row))) + 32 + 1);
+  return wuffs_base__utility__make_range_ii_u64(v_n, v_n);
 }
 
-// -------- func png.decoder.decode_pass
+// -------- func png.encoder.encode_image
 
-static wuffs_base__status
-wuffs_png__decoder__decode_pass(
-    wuffs_png__decoder* self,
-    wuffs_base__io_buffer* a_src,
+WUFFS_BASE__MAYBE_STATIC wuffs_base__status
+wuffs_png__encoder__encode_image(
+    wuffs_png__encoder* self,
+    wuffs_base__io_buffer* a_dst,
+    wuffs_base__pixel_buffer* a_src,
     wuffs_base__slice_u8 a_workbuf) {
+  if (!self) {
+    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
+  }
+  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
+    return wuffs_base__make_status(
+        (self->private_impl.magic == WUFFS_BASE__DISABLED)
+        ? wuffs_base__error__disabled_by_previous_error
+        : wuffs_base__error__initialize_not_called);
+  }
+  if (!a_dst || !a_src) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+    return wuffs_base__make_status(wuffs_base__error__bad_argument);
+  }
+  if ((self->private_impl.active_coroutine != 0) &&
+      (self->private_impl.active_coroutine != 1)) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+    return wuffs_base__make_status(wuffs_base__error__interleaved_coroutine_calls);
+  }
+  self->private_impl.active_coroutine = 0;
   wuffs_base__status status = wuffs_base__make_status(NULL);
 
+  wuffs_base__status v_status = wuffs_base__make_status(NULL);
   wuffs_base__io_buffer u_w = wuffs_base__empty_io_buffer();
   wuffs_base__io_buffer* v_w = &u_w;
   uint8_t* iop_v_w WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
@@ -37758,36 +50092,54 @@ wuffs_png__decoder__decode_pass(
   uint8_t* io1_v_w WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
   uint8_t* io2_v_w WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
   uint64_t v_w_mark = 0;
-  uint64_t v_r_mark = 0;
-  wuffs_base__status v_zlib_status = wuffs_base__make_status(NULL);
-  uint32_t v_checksum_have = 0;
-  uint32_t v_checksum_want = 0;
+  uint64_t v_n = 0;
+  uint32_t v_wi = 0;
+  uint32_t v_crc = 0;
 
-  const uint8_t* iop_a_src = NULL;
-  const uint8_t* io0_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
-  const uint8_t* io1_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
-  const uint8_t* io2_a_src WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
-  if (a_src) {
-    io0_a_src = a_src->data.ptr;
-    io1_a_src = io0_a_src + a_src->meta.ri;
-    iop_a_src = io1_a_src;
-    io2_a_src = io0_a_src + a_src->meta.wi;
-  }
 
-  uint32_t coro_susp_point = self->private_impl.p_decode_pass[0];
-  if (coro_susp_point) {
-    v_checksum_have = self->private_data.s_decode_pass[0].v_checksum_have;
-  }
+  uint32_t coro_susp_point = self->private_impl.p_encode_image[0];
   switch (coro_susp_point) {
     WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
 
-    self->private_impl.f_workbuf_wi = 0;
-    label__0__continue:;
-    while (true) {
-      if ((self->private_impl.f_workbuf_wi > self->private_impl.f_pass_workbuf_length) || (self->private_impl.f_pass_workbuf_length > ((uint64_t)(a_workbuf.len)))) {
-        status = wuffs_base__make_status(wuffs_base__error__bad_workbuf_length);
+    if (self->private_impl.f_call_sequence != 1) {
+      status = wuffs_base__make_status(wuffs_base__error__bad_call_sequence);
+      goto exit;
+    }
+    v_status = wuffs_png__encoder__start_rows(self, a_src, 0, a_workbuf);
+    if ( ! wuffs_base__status__is_ok(&v_status)) {
+      status = v_status;
+      if (wuffs_base__status__is_error(&status)) {
+        goto exit;
+      } else if (wuffs_base__status__is_suspension(&status)) {
+        status = wuffs_base__make_status(wuffs_base__error__cannot_return_a_suspension);
         goto exit;
       }
+      goto ok;
+    }
+    wuffs_base__poke_u64be__no_bounds_check(wuffs_base__make_slice_u8((self->private_data.f_buf) + 0, 8).ptr, 9894494448401390090u);
+    wuffs_base__poke_u64be__no_bounds_check(wuffs_base__make_slice_u8((self->private_data.f_buf) + 8, 8).ptr, 57064047698);
+    wuffs_base__poke_u32be__no_bounds_check(wuffs_base__make_slice_u8((self->private_data.f_buf) + 16, 16).ptr, self->private_impl.f_width);
+    wuffs_base__poke_u32be__no_bounds_check(wuffs_base__make_slice_u8((self->private_data.f_buf) + 20, 12).ptr, self->private_impl.f_height);
+    self->private_data.f_buf[24] = 8;
+    self->private_data.f_buf[25] = self->private_impl.f_color_type;
+    self->private_data.f_buf[26] = 0;
+    self->private_data.f_buf[27] = 0;
+    self->private_data.f_buf[28] = 0;
+    wuffs_base__ignore_status(wuffs_crc32__ieee_hasher__initialize(&self->private_data.f_crc32, sizeof (wuffs_crc32__ieee_hasher), WUFFS_VERSION, 0));
+    v_crc = wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_crc32, wuffs_base__make_slice_u8((self->private_data.f_buf) + 12, 17));
+    wuffs_base__poke_u32be__no_bounds_check(wuffs_base__make_slice_u8((self->private_data.f_buf) + 29, 4).ptr, v_crc);
+    self->private_impl.f_buf_ri = 0;
+    self->private_impl.f_buf_wi = 33;
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+    status = wuffs_png__encoder__write_buf(self, a_dst);
+    if (status.repr) {
+      goto suspend;
+    }
+    self->private_data.f_buf[8] = 120;
+    self->private_data.f_buf[9] = WUFFS_PNG__ZLIB_FLGS[self->private_impl.f_level];
+    self->private_impl.f_buf_wi = 10;
+    while (true) {
+      v_wi = wuffs_base__u32__min(self->private_impl.f_buf_wi, 32776);
       {
         wuffs_base__io_buffer* o_0_v_w = v_w;
         uint8_t *o_0_iop_v_w = iop_v_w;
@@ -37800,96 +50152,32 @@ wuffs_png__decoder__decode_pass(
             &io0_v_w,
             &io1_v_w,
             &io2_v_w,
-            wuffs_base__slice_u8__subslice_ij(a_workbuf,
-            self->private_impl.f_workbuf_wi,
-            self->private_impl.f_pass_workbuf_length));
+            wuffs_base__slice_u8__subslice_i(wuffs_base__make_slice_u8(self->private_data.f_buf, 32776), v_wi));
+        v_w_mark = ((uint64_t)(iop_v_w - io0_v_w));
         {
-          const uint8_t *o_1_io2_a_src = io2_a_src;
-          wuffs_base__io_reader__limit(&io2_a_src, iop_a_src,
-              self->private_impl.f_chunk_length);
-          if (a_src) {
-            a_src->meta.wi = ((size_t)(io2_a_src - a_src->data.ptr));
-          }
-          v_w_mark = ((uint64_t)(iop_v_w - io0_v_w));
-          v_r_mark = ((uint64_t)(iop_a_src - io0_a_src));
-          {
-            u_w.meta.wi = ((size_t)(iop_v_w - u_w.data.ptr));
-            if (a_src) {
-              a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
-            }
-            wuffs_base__status t_0 = wuffs_zlib__decoder__transform_io(&self->private_data.f_zlib, v_w, a_src, wuffs_base__utility__empty_slice_u8());
-            v_zlib_status = t_0;
-            iop_v_w = u_w.data.ptr + u_w.meta.wi;
-            if (a_src) {
-              iop_a_src = a_src->data.ptr + a_src->meta.ri;
-            }
-          }
-          if ( ! self->private_impl.f_ignore_checksum) {
-            wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_crc32, wuffs_base__io__since(v_r_mark, ((uint64_t)(iop_a_src - io0_a_src)), io0_a_src));
-          }
-          wuffs_base__u64__sat_sub_indirect(&self->private_impl.f_chunk_length, wuffs_base__io__count_since(v_r_mark, ((uint64_t)(iop_a_src - io0_a_src))));
-          wuffs_base__u64__sat_add_indirect(&self->private_impl.f_workbuf_wi, wuffs_base__io__count_since(v_w_mark, ((uint64_t)(iop_v_w - io0_v_w))));
-          io2_a_src = o_1_io2_a_src;
-          if (a_src) {
-            a_src->meta.wi = ((size_t)(io2_a_src - a_src->data.ptr));
-          }
-        }
+          u_w.meta.wi = ((size_t)(iop_v_w - u_w.data.ptr));
+          wuffs_base__status t_0 = wuffs_png__encoder__encode_rows(self,
+              v_w,
+              a_src,
+              self->private_impl.f_height,
+              false,
+              a_workbuf);
+          v_status = t_0;
+          iop_v_w = u_w.data.ptr + u_w.meta.wi;
+        }
+        v_n = wuffs_base__io__count_since(v_w_mark, ((uint64_t)(iop_v_w - io0_v_w)));
         v_w = o_0_v_w;
         iop_v_w = o_0_iop_v_w;
         io0_v_w = o_0_io0_v_w;
         io1_v_w = o_0_io1_v_w;
         io2_v_w = o_0_io2_v_w;
       }
-      if (wuffs_base__status__is_ok(&v_zlib_status)) {
-        if ( ! self->private_impl.f_ignore_checksum) {
-          if (self->private_impl.f_chunk_length > 0) {
-            status = wuffs_base__make_status(wuffs_base__error__too_much_data);
-            goto exit;
-          }
-          v_checksum_have = wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_crc32, wuffs_base__utility__empty_slice_u8());
-          {
-            WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
-            uint32_t t_1;
-            if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
-              t_1 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
-              iop_a_src += 4;
-            } else {
-              self->private_data.s_decode_pass[0].scratch = 0;
-              WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
-              while (true) {
-                if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
-                  status = wuffs_base__make_status(wuffs_base__suspension__short_read);
-                  goto suspend;
-                }
-                uint64_t* scratch = &self->private_data.s_decode_pass[0].scratch;
-                uint32_t num_bits_1 = ((uint32_t)(*scratch & 0xFF));
-                *scratch >>= 8;
-                *scratch <<= 8;
-                *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_1);
-                if (num_bits_1 == 24) {
-                  t_1 = ((uint32_t)(*scratch >> 32));
-                  break;
-                }
-                num_bits_1 += 8;
-                *scratch |= ((uint64_t)(num_bits_1));
-              }
-            }
-            v_checksum_want = t_1;
-          }
-          if (v_checksum_have != v_checksum_want) {
-            status = wuffs_base__make_status(wuffs_png__error__bad_checksum);
-            goto exit;
-          }
-        }
+      v_n = (((uint64_t)(v_wi)) + wuffs_base__u64__min(v_n, ((uint64_t)(32768))));
+      self->private_impl.f_buf_wi = ((uint32_t)(wuffs_base__u64__min(v_n, (8 + ((uint64_t)(32768))))));
+      if (wuffs_base__status__is_ok(&v_status)) {
         goto label__0__break;
-      } else if (v_zlib_status.repr == wuffs_base__suspension__short_write) {
-        if ((1 <= self->private_impl.f_interlace_pass) && (self->private_impl.f_interlace_pass <= 6)) {
-          goto label__0__break;
-        }
-        status = wuffs_base__make_status(wuffs_base__error__too_much_data);
-        goto exit;
-      } else if (v_zlib_status.repr != wuffs_base__suspension__short_read) {
-        status = v_zlib_status;
+      } else if (v_status.repr != wuffs_base__suspension__short_write) {
+        status = v_status;
         if (wuffs_base__status__is_error(&status)) {
           goto exit;
         } else if (wuffs_base__status__is_suspension(&status)) {
@@ -37897,273 +50185,65 @@ wuffs_png__decoder__decode_pass(
           goto exit;
         }
         goto ok;
-      } else if (self->private_impl.f_chunk_length == 0) {
-        {
-          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
-          uint32_t t_2;
-          if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
-            t_2 = wuffs_base__peek_u32be__no_bounds_check(iop_a_src);
-            iop_a_src += 4;
-          } else {
-            self->private_data.s_decode_pass[0].scratch = 0;
-            WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
-            while (true) {
-              if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
-                status = wuffs_base__make_status(wuffs_base__suspension__short_read);
-                goto suspend;
-              }
-              uint64_t* scratch = &self->private_data.s_decode_pass[0].scratch;
-              uint32_t num_bits_2 = ((uint32_t)(*scratch & 0xFF));
-              *scratch >>= 8;
-              *scratch <<= 8;
-              *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_2);
-              if (num_bits_2 == 24) {
-                t_2 = ((uint32_t)(*scratch >> 32));
-                break;
-              }
-              num_bits_2 += 8;
-              *scratch |= ((uint64_t)(num_bits_2));
-            }
-          }
-          v_checksum_want = t_2;
-        }
-        if ( ! self->private_impl.f_ignore_checksum) {
-          v_checksum_have = wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_crc32, wuffs_base__utility__empty_slice_u8());
-          if (v_checksum_have != v_checksum_want) {
-            status = wuffs_base__make_status(wuffs_png__error__bad_checksum);
-            goto exit;
-          }
-        }
-        {
-          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(5);
-          uint64_t t_3;
-          if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
-            t_3 = ((uint64_t)(wuffs_base__peek_u32be__no_bounds_check(iop_a_src)));
-            iop_a_src += 4;
-          } else {
-            self->private_data.s_decode_pass[0].scratch = 0;
-            WUFFS_BASE__COROUTINE_SUSPENSION_POINT(6);
-            while (true) {
-              if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
-                status = wuffs_base__make_status(wuffs_base__suspension__short_read);
-                goto suspend;
-              }
-              uint64_t* scratch = &self->private_data.s_decode_pass[0].scratch;
-              uint32_t num_bits_3 = ((uint32_t)(*scratch & 0xFF));
-              *scratch >>= 8;
-              *scratch <<= 8;
-              *scratch |= ((uint64_t)(*iop_a_src++)) << (56 - num_bits_3);
-              if (num_bits_3 == 24) {
-                t_3 = ((uint64_t)(*scratch >> 32));
-                break;
-              }
-              num_bits_3 += 8;
-              *scratch |= ((uint64_t)(num_bits_3));
-            }
-          }
-          self->private_impl.f_chunk_length = t_3;
-        }
-        {
-          WUFFS_BASE__COROUTINE_SUSPENSION_POINT(7);
-          uint32_t t_4;
-          if (WUFFS_BASE__LIKELY(io2_a_src - iop_a_src >= 4)) {
-            t_4 = wuffs_base__peek_u32le__no_bounds_check(iop_a_src);
-            iop_a_src += 4;
-          } else {
-            self->private_data.s_decode_pass[0].scratch = 0;
-            WUFFS_BASE__COROUTINE_SUSPENSION_POINT(8);
-            while (true) {
-              if (WUFFS_BASE__UNLIKELY(iop_a_src == io2_a_src)) {
-                status = wuffs_base__make_status(wuffs_base__suspension__short_read);
-                goto suspend;
-              }
-              uint64_t* scratch = &self->private_data.s_decode_pass[0].scratch;
-              uint32_t num_bits_4 = ((uint32_t)(*scratch >> 56));
-              *scratch <<= 8;
-              *scratch >>= 8;
-              *scratch |= ((uint64_t)(*iop_a_src++)) << num_bits_4;
-              if (num_bits_4 == 24) {
-                t_4 = ((uint32_t)(*scratch));
-                break;
-              }
-              num_bits_4 += 8;
-              *scratch |= ((uint64_t)(num_bits_4)) << 56;
-            }
-          }
-          self->private_impl.f_chunk_type = t_4;
-        }
-        if (self->private_impl.f_chunk_type != 1413563465) {
-          status = wuffs_base__make_status(wuffs_png__error__bad_chunk);
-          goto exit;
-        }
-        if ( ! self->private_impl.f_ignore_checksum) {
-          wuffs_base__ignore_status(wuffs_crc32__ieee_hasher__initialize(&self->private_data.f_crc32, sizeof (wuffs_crc32__ieee_hasher), WUFFS_VERSION, 0));
-          self->private_impl.f_chunk_type_array[0] = 73;
-          self->private_impl.f_chunk_type_array[1] = 68;
-          self->private_impl.f_chunk_type_array[2] = 65;
-          self->private_impl.f_chunk_type_array[3] = 84;
-          wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_crc32, wuffs_base__make_slice_u8(self->private_impl.f_chunk_type_array, 4));
-        }
-        goto label__0__continue;
-      } else if (((uint64_t)(io2_a_src - iop_a_src)) > 0) {
-        status = wuffs_base__make_status(wuffs_png__error__internal_error_zlib_decoder_did_not_exhaust_its_input);
-        goto exit;
       }
-      status = wuffs_base__make_status(wuffs_base__suspension__short_read);
-      WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(9);
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+      status = wuffs_png__encoder__write_idat(self, a_dst);
+      if (status.repr) {
+        goto suspend;
+      }
     }
     label__0__break:;
-    if (self->private_impl.f_workbuf_wi != self->private_impl.f_pass_workbuf_length) {
-      status = wuffs_base__make_status(wuffs_base__error__not_enough_data);
-      goto exit;
-    } else if (0 < ((uint64_t)(a_workbuf.len))) {
-      if (a_workbuf.ptr[0] == 4) {
-        a_workbuf.ptr[0] = 1;
-      }
+    v_wi = wuffs_base__u32__min(self->private_impl.f_buf_wi, 32776);
+    self->private_data.f_buf[(v_wi + 0)] = ((uint8_t)((self->private_impl.f_adler32_state >> 24)));
+    self->private_data.f_buf[(v_wi + 1)] = ((uint8_t)(((self->private_impl.f_adler32_state >> 16) & 255)));
+    self->private_data.f_buf[(v_wi + 2)] = ((uint8_t)(((self->private_impl.f_adler32_state >> 8) & 255)));
+    self->private_data.f_buf[(v_wi + 3)] = ((uint8_t)((self->private_impl.f_adler32_state & 255)));
+    self->private_impl.f_buf_wi = (v_wi + 4);
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+    status = wuffs_png__encoder__write_idat(self, a_dst);
+    if (status.repr) {
+      goto suspend;
     }
+    wuffs_base__poke_u64be__no_bounds_check(wuffs_base__make_slice_u8((self->private_data.f_buf) + 0, 8).ptr, 1229278788);
+    wuffs_base__poke_u32be__no_bounds_check(wuffs_base__make_slice_u8((self->private_data.f_buf) + 8, 4).ptr, 2923585666);
+    self->private_impl.f_buf_ri = 0;
+    self->private_impl.f_buf_wi = 12;
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(4);
+    status = wuffs_png__encoder__write_buf(self, a_dst);
+    if (status.repr) {
+      goto suspend;
+    }
+    self->private_impl.f_call_sequence = 255;
 
-    ok:
-    self->private_impl.p_decode_pass[0] = 0;
-    goto exit;
-  }
-
-  goto suspend;
-  suspend:
-  self->private_impl.p_decode_pass[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
-  self->private_data.s_decode_pass[0].v_checksum_have = v_checksum_have;
-
-  goto exit;
-  exit:
-  if (a_src) {
-    a_src->meta.ri = ((size_t)(iop_a_src - a_src->data.ptr));
-  }
-
-  return status;
-}
-
-// -------- func png.decoder.frame_dirty_rect
-
-WUFFS_BASE__MAYBE_STATIC wuffs_base__rect_ie_u32
-wuffs_png__decoder__frame_dirty_rect(
-    const wuffs_png__decoder* self) {
-  if (!self) {
-    return wuffs_base__utility__empty_rect_ie_u32();
-  }
-  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
-      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
-    return wuffs_base__utility__empty_rect_ie_u32();
-  }
-
-  return wuffs_base__utility__make_rect_ie_u32(
-      0,
-      0,
-      self->private_impl.f_width,
-      self->private_impl.f_height);
-}
-
-// -------- func png.decoder.num_animation_loops
-
-WUFFS_BASE__MAYBE_STATIC uint32_t
-wuffs_png__decoder__num_animation_loops(
-    const wuffs_png__decoder* self) {
-  if (!self) {
-    return 0;
-  }
-  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
-      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
-    return 0;
-  }
-
-  return 0;
-}
-
-// -------- func png.decoder.num_decoded_frame_configs
-
-WUFFS_BASE__MAYBE_STATIC uint64_t
-wuffs_png__decoder__num_decoded_frame_configs(
-    const wuffs_png__decoder* self) {
-  if (!self) {
-    return 0;
-  }
-  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
-      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
-    return 0;
-  }
-
-  if (self->private_impl.f_call_sequence > 3) {
-    return 1;
-  }
-  return 0;
-}
-
-// -------- func png.decoder.num_decoded_frames
-
-WUFFS_BASE__MAYBE_STATIC uint64_t
-wuffs_png__decoder__num_decoded_frames(
-    const wuffs_png__decoder* self) {
-  if (!self) {
-    return 0;
-  }
-  if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
-      (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
-    return 0;
-  }
-
-  if (self->private_impl.f_call_sequence > 4) {
-    return 1;
-  }
-  return 0;
-}
-
-// -------- func png.decoder.restart_frame
-
-WUFFS_BASE__MAYBE_STATIC wuffs_base__status
-wuffs_png__decoder__restart_frame(
-    wuffs_png__decoder* self,
-    uint64_t a_index,
-    uint64_t a_io_position) {
-  if (!self) {
-    return wuffs_base__make_status(wuffs_base__error__bad_receiver);
-  }
-  if (self->private_impl.magic != WUFFS_BASE__MAGIC) {
-    return wuffs_base__make_status(
-        (self->private_impl.magic == WUFFS_BASE__DISABLED)
-        ? wuffs_base__error__disabled_by_previous_error
-        : wuffs_base__error__initialize_not_called);
+    ok:
+    self->private_impl.p_encode_image[0] = 0;
+    goto exit;
   }
 
-  if (self->private_impl.f_call_sequence < 3) {
-    return wuffs_base__make_status(wuffs_base__error__bad_call_sequence);
-  }
-  if (a_index != 0) {
-    return wuffs_base__make_status(wuffs_base__error__bad_argument);
-  }
-  self->private_impl.f_call_sequence = 3;
-  if (self->private_impl.f_interlace_pass >= 1) {
-    self->private_impl.f_interlace_pass = 1;
-  }
-  self->private_impl.f_frame_config_io_position = a_io_position;
-  return wuffs_base__make_status(NULL);
-}
+  goto suspend;
+  suspend:
+  self->private_impl.p_encode_image[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+  self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 1 : 0;
 
-// -------- func png.decoder.set_report_metadata
+  goto exit;
+  exit:
 
-WUFFS_BASE__MAYBE_STATIC wuffs_base__empty_struct
-wuffs_png__decoder__set_report_metadata(
-    wuffs_png__decoder* self,
-    uint32_t a_fourcc,
-    bool a_report) {
-  return wuffs_base__make_empty_struct();
+  if (wuffs_base__status__is_error(&status)) {
+    self->private_impl.magic = WUFFS_BASE__DISABLED;
+  }
+  return status;
 }
 
-// -------- func png.decoder.tell_me_more
+// -------- func png.encoder.encode_strip
 
 WUFFS_BASE__MAYBE_STATIC wuffs_base__status
-wuffs_png__decoder__tell_me_more(
-    wuffs_png__decoder* self,
+wuffs_png__encoder__encode_strip(
+    wuffs_png__encoder* self,
     wuffs_base__io_buffer* a_dst,
-    wuffs_base__more_information* a_minfo,
-    wuffs_base__io_buffer* a_src) {
+    wuffs_base__pixel_buffer* a_src,
+    uint32_t a_y0,
+    uint32_t a_y1,
+    wuffs_base__slice_u8 a_workbuf) {
   if (!self) {
     return wuffs_base__make_status(wuffs_base__error__bad_receiver);
   }
@@ -38178,291 +50258,510 @@ wuffs_png__decoder__tell_me_more(
     return wuffs_base__make_status(wuffs_base__error__bad_argument);
   }
   if ((self->private_impl.active_coroutine != 0) &&
-      (self->private_impl.active_coroutine != 4)) {
+      (self->private_impl.active_coroutine != 2)) {
     self->private_impl.magic = WUFFS_BASE__DISABLED;
     return wuffs_base__make_status(wuffs_base__error__interleaved_coroutine_calls);
   }
   self->private_impl.active_coroutine = 0;
   wuffs_base__status status = wuffs_base__make_status(NULL);
 
-  status = wuffs_base__make_status(wuffs_base__error__no_more_information);
-  goto exit;
+  wuffs_base__status v_status = wuffs_base__make_status(NULL);
+
+  uint8_t* iop_a_dst = NULL;
+  uint8_t* io0_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io1_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io2_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_dst) {
+    io0_a_dst = a_dst->data.ptr;
+    io1_a_dst = io0_a_dst + a_dst->meta.wi;
+    iop_a_dst = io1_a_dst;
+    io2_a_dst = io0_a_dst + a_dst->data.len;
+    if (a_dst->meta.closed) {
+      io2_a_dst = iop_a_dst;
+    }
+  }
+
+  uint32_t coro_susp_point = self->private_impl.p_encode_strip[0];
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    if (self->private_impl.f_call_sequence != 1) {
+      status = wuffs_base__make_status(wuffs_base__error__bad_call_sequence);
+      goto exit;
+    } else if ((a_y0 >= a_y1) || (a_y1 > self->private_impl.f_height)) {
+      status = wuffs_base__make_status(wuffs_base__error__bad_argument);
+      goto exit;
+    }
+    v_status = wuffs_png__encoder__start_rows(self, a_src, a_y0, a_workbuf);
+    if ( ! wuffs_base__status__is_ok(&v_status)) {
+      status = v_status;
+      if (wuffs_base__status__is_error(&status)) {
+        goto exit;
+      } else if (wuffs_base__status__is_suspension(&status)) {
+        status = wuffs_base__make_status(wuffs_base__error__cannot_return_a_suspension);
+        goto exit;
+      }
+      goto ok;
+    }
+    if (a_y0 == 0) {
+      self->private_data.s_encode_strip[0].scratch = 120;
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+      if (iop_a_dst == io2_a_dst) {
+        status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+        goto suspend;
+      }
+      *iop_a_dst++ = ((uint8_t)(self->private_data.s_encode_strip[0].scratch));
+      self->private_data.s_encode_strip[0].scratch = WUFFS_PNG__ZLIB_FLGS[self->private_impl.f_level];
+      WUFFS_BASE__COROUTINE_SUSPENSION_POINT(2);
+      if (iop_a_dst == io2_a_dst) {
+        status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+        goto suspend;
+      }
+      *iop_a_dst++ = ((uint8_t)(self->private_data.s_encode_strip[0].scratch));
+    }
+    if (a_dst) {
+      a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+    }
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(3);
+    status = wuffs_png__encoder__encode_rows(self,
+        a_dst,
+        a_src,
+        a_y1,
+        (a_y1 < self->private_impl.f_height),
+        a_workbuf);
+    if (a_dst) {
+      iop_a_dst = a_dst->data.ptr + a_dst->meta.wi;
+    }
+    if (status.repr) {
+      goto suspend;
+    }
+    self->private_impl.f_call_sequence = 255;
+
+    ok:
+    self->private_impl.p_encode_strip[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_encode_strip[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+  self->private_impl.active_coroutine = wuffs_base__status__is_suspension(&status) ? 2 : 0;
 
-  goto ok;
-  ok:
   goto exit;
   exit:
+  if (a_dst) {
+    a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+  }
+
   if (wuffs_base__status__is_error(&status)) {
     self->private_impl.magic = WUFFS_BASE__DISABLED;
   }
   return status;
 }
 
-// -------- func png.decoder.workbuf_len
+// -------- func png.encoder.strip_adler32
 
-WUFFS_BASE__MAYBE_STATIC wuffs_base__range_ii_u64
-wuffs_png__decoder__workbuf_len(
-    const wuffs_png__decoder* self) {
+WUFFS_BASE__MAYBE_STATIC uint32_t
+wuffs_png__encoder__strip_adler32(
+    const wuffs_png__encoder* self) {
   if (!self) {
-    return wuffs_base__utility__empty_range_ii_u64();
+    return 0;
   }
   if ((self->private_impl.magic != WUFFS_BASE__MAGIC) &&
       (self->private_impl.magic != WUFFS_BASE__DISABLED)) {
-    return wuffs_base__utility__empty_range_ii_u64();
+    return 0;
   }
 
-  return wuffs_base__utility__make_range_ii_u64(self->private_impl.f_overall_workbuf_length, self->private_impl.f_overall_workbuf_length);
+  return self->private_impl.f_adler32_state;
 }
 
-// -------- func png.decoder.filter_and_swizzle
-
-static wuffs_base__status
-wuffs_png__decoder__filter_and_swizzle(
-    wuffs_png__decoder* self,
-    wuffs_base__pixel_buffer* a_dst,
-    wuffs_base__slice_u8 a_workbuf) {
-  return (*self->private_impl.choosy_filter_and_swizzle)(self, a_dst, a_workbuf);
-}
+// -------- func png.encoder.start_rows
 
 static wuffs_base__status
-wuffs_png__decoder__filter_and_swizzle__choosy_default(
-    wuffs_png__decoder* self,
-    wuffs_base__pixel_buffer* a_dst,
+wuffs_png__encoder__start_rows(
+    wuffs_png__encoder* self,
+    wuffs_base__pixel_buffer* a_src,
+    uint32_t a_y0,
     wuffs_base__slice_u8 a_workbuf) {
-  wuffs_base__pixel_format v_dst_pixfmt = {0};
-  uint32_t v_dst_bits_per_pixel = 0;
-  uint64_t v_dst_bytes_per_pixel = 0;
-  uint64_t v_dst_bytes_per_row = 0;
-  wuffs_base__slice_u8 v_dst_palette = {0};
+  uint64_t v_stride = 0;
+  wuffs_base__slice_u8 v_lo = {0};
+  wuffs_base__slice_u8 v_hi = {0};
   wuffs_base__table_u8 v_tab = {0};
-  uint32_t v_y = 0;
-  wuffs_base__slice_u8 v_dst = {0};
-  uint8_t v_filter = 0;
-  wuffs_base__slice_u8 v_curr_row = {0};
-  wuffs_base__slice_u8 v_prev_row = {0};
 
-  v_dst_pixfmt = wuffs_base__pixel_buffer__pixel_format(a_dst);
-  v_dst_bits_per_pixel = wuffs_base__pixel_format__bits_per_pixel(&v_dst_pixfmt);
-  if ((v_dst_bits_per_pixel & 7) != 0) {
-    return wuffs_base__make_status(wuffs_base__error__unsupported_option);
+  v_stride = (16 + ((uint64_t)(self->private_impl.f_bytes_per_row)));
+  if (((uint64_t)(a_workbuf.len)) < ((2 * v_stride) + 1 + ((uint64_t)(self->private_impl.f_bytes_per_row)))) {
+    return wuffs_base__make_status(wuffs_base__error__bad_workbuf_length);
   }
-  v_dst_bytes_per_pixel = ((uint64_t)((v_dst_bits_per_pixel / 8)));
-  v_dst_bytes_per_row = (((uint64_t)(self->private_impl.f_width)) * v_dst_bytes_per_pixel);
-  v_dst_palette = wuffs_base__pixel_buffer__palette_or_else(a_dst, wuffs_base__make_slice_u8(self->private_data.f_dst_palette, 1024));
-  v_tab = wuffs_base__pixel_buffer__plane(a_dst, 0);
-  while (v_y < self->private_impl.f_height) {
-    v_dst = wuffs_base__table_u8__row(v_tab, v_y);
-    if (v_dst_bytes_per_row < ((uint64_t)(v_dst.len))) {
-      v_dst = wuffs_base__slice_u8__subslice_j(v_dst, v_dst_bytes_per_row);
-    }
-    if (1 > ((uint64_t)(a_workbuf.len))) {
-      return wuffs_base__make_status(wuffs_png__error__internal_error_inconsistent_workbuf_length);
-    }
-    v_filter = a_workbuf.ptr[0];
-    a_workbuf = wuffs_base__slice_u8__subslice_i(a_workbuf, 1);
-    if (self->private_impl.f_pass_bytes_per_row > ((uint64_t)(a_workbuf.len))) {
-      return wuffs_base__make_status(wuffs_png__error__internal_error_inconsistent_workbuf_length);
-    }
-    v_curr_row = wuffs_base__slice_u8__subslice_j(a_workbuf, self->private_impl.f_pass_bytes_per_row);
-    a_workbuf = wuffs_base__slice_u8__subslice_i(a_workbuf, self->private_impl.f_pass_bytes_per_row);
-    if (v_filter == 0) {
-    } else if (v_filter == 1) {
-      wuffs_png__decoder__filter_1(self, v_curr_row);
-    } else if (v_filter == 2) {
-      wuffs_png__decoder__filter_2(self, v_curr_row, v_prev_row);
-    } else if (v_filter == 3) {
-      wuffs_png__decoder__filter_3(self, v_curr_row, v_prev_row);
-    } else if (v_filter == 4) {
-      wuffs_png__decoder__filter_4(self, v_curr_row, v_prev_row);
-    } else {
-      return wuffs_base__make_status(wuffs_png__error__bad_filter);
-    }
-    wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(&self->private_impl.f_swizzler, v_dst, v_dst_palette, v_curr_row);
-    v_prev_row = v_curr_row;
-    v_y += 1;
+  if (v_stride > ((uint64_t)(a_workbuf.len))) {
+    return wuffs_base__make_status(wuffs_base__error__bad_workbuf_length);
+  }
+  v_lo = wuffs_base__slice_u8__subslice_j(a_workbuf, v_stride);
+  v_hi = wuffs_base__slice_u8__subslice_i(a_workbuf, v_stride);
+  if (v_stride > ((uint64_t)(v_hi.len))) {
+    return wuffs_base__make_status(wuffs_base__error__bad_workbuf_length);
   }
+  v_hi = wuffs_base__slice_u8__subslice_j(v_hi, v_stride);
+  if ((16 > ((uint64_t)(v_lo.len))) || (16 > ((uint64_t)(v_hi.len)))) {
+    return wuffs_base__make_status(wuffs_base__error__bad_workbuf_length);
+  }
+  wuffs_png__encoder__zero(self, wuffs_base__slice_u8__subslice_j(v_lo, 16));
+  wuffs_png__encoder__zero(self, wuffs_base__slice_u8__subslice_j(v_hi, 16));
+  if ((a_y0 & 1) == 0) {
+    v_lo = wuffs_base__slice_u8__subslice_i(v_hi, 16);
+  } else {
+    v_lo = wuffs_base__slice_u8__subslice_i(v_lo, 16);
+  }
+  if (a_y0 == 0) {
+    wuffs_png__encoder__zero(self, v_lo);
+  } else {
+    v_tab = wuffs_base__pixel_buffer__plane(a_src, 0);
+    wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(&self->private_impl.f_swizzler, v_lo, wuffs_base__utility__empty_slice_u8(), wuffs_base__table_u8__row(v_tab, (a_y0 - 1)));
+  }
+  if ( ! self->private_impl.f_level_is_set) {
+    self->private_impl.f_level = 6;
+  }
+  wuffs_deflate__encoder__set_level(&self->private_data.f_flate, self->private_impl.f_level);
+  self->private_impl.f_y = a_y0;
+  self->private_impl.f_filtered_ri = 0;
+  self->private_impl.f_filtered_n = 0;
+  self->private_impl.f_call_sequence = 2;
   return wuffs_base__make_status(NULL);
 }
 
-// -------- func png.decoder.filter_and_swizzle_tricky
+// -------- func png.encoder.zero
+
+static wuffs_base__empty_struct
+wuffs_png__encoder__zero(
+    wuffs_png__encoder* self,
+    wuffs_base__slice_u8 a_s) {
+  wuffs_base__slice_u8 v_s = {0};
+
+  {
+    wuffs_base__slice_u8 i_slice_s = a_s;
+    v_s.ptr = i_slice_s.ptr;
+    v_s.len = 8;
+    uint8_t* i_end0_s = v_s.ptr + (((i_slice_s.len - (size_t)(v_s.ptr - i_slice_s.ptr)) / 8) * 8);
+    while (v_s.ptr < i_end0_s) {
+      wuffs_base__poke_u64le__no_bounds_check(v_s.ptr, 0);
+      v_s.ptr += 8;
+    }
+    v_s.len = 1;
+    uint8_t* i_end1_s = i_slice_s.ptr + i_slice_s.len;
+    while (v_s.ptr < i_end1_s) {
+      v_s.ptr[0] = 0;
+      v_s.ptr += 1;
+    }
+    v_s.len = 0;
+  }
+  return wuffs_base__make_empty_struct();
+}
+
+// -------- func png.encoder.encode_rows
 
 static wuffs_base__status
-wuffs_png__decoder__filter_and_swizzle_tricky(
-    wuffs_png__decoder* self,
-    wuffs_base__pixel_buffer* a_dst,
+wuffs_png__encoder__encode_rows(
+    wuffs_png__encoder* self,
+    wuffs_base__io_buffer* a_dst,
+    wuffs_base__pixel_buffer* a_src,
+    uint32_t a_y1,
+    bool a_full_flush,
     wuffs_base__slice_u8 a_workbuf) {
-  wuffs_base__pixel_format v_dst_pixfmt = {0};
-  uint32_t v_dst_bits_per_pixel = 0;
-  uint64_t v_dst_bytes_per_pixel = 0;
-  uint64_t v_dst_bytes_per_row = 0;
-  wuffs_base__slice_u8 v_dst_palette = {0};
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  wuffs_base__status v_status = wuffs_base__make_status(NULL);
+  uint64_t v_stride = 0;
+  uint64_t v_bpr = 0;
+  uint64_t v_d = 0;
+  wuffs_base__slice_u8 v_curr = {0};
+  wuffs_base__slice_u8 v_prev = {0};
+  wuffs_base__slice_u8 v_swap = {0};
+  wuffs_base__slice_u8 v_filtered = {0};
   wuffs_base__table_u8 v_tab = {0};
-  uint64_t v_src_bytes_per_pixel = 0;
-  uint32_t v_x = 0;
-  uint32_t v_y = 0;
+  wuffs_base__io_buffer u_r = wuffs_base__empty_io_buffer();
+  wuffs_base__io_buffer* v_r = &u_r;
+  const uint8_t* iop_v_r WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io0_v_r WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io1_v_r WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  const uint8_t* io2_v_r WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint64_t v_r_mark = 0;
+  uint64_t v_n = 0;
+  uint32_t v_ri = 0;
   uint64_t v_i = 0;
-  wuffs_base__slice_u8 v_dst = {0};
-  uint8_t v_filter = 0;
-  wuffs_base__slice_u8 v_s = {0};
-  wuffs_base__slice_u8 v_curr_row = {0};
-  wuffs_base__slice_u8 v_prev_row = {0};
-  uint8_t v_bits_unpacked[8] = {0};
-  uint8_t v_bits_packed = 0;
-  uint8_t v_packs_remaining = 0;
-  uint8_t v_multiplier = 0;
-  uint8_t v_shift = 0;
+  uint64_t v_j = 0;
 
-  v_dst_pixfmt = wuffs_base__pixel_buffer__pixel_format(a_dst);
-  v_dst_bits_per_pixel = wuffs_base__pixel_format__bits_per_pixel(&v_dst_pixfmt);
-  if ((v_dst_bits_per_pixel & 7) != 0) {
-    return wuffs_base__make_status(wuffs_base__error__unsupported_option);
-  }
-  v_dst_bytes_per_pixel = ((uint64_t)((v_dst_bits_per_pixel / 8)));
-  v_dst_bytes_per_row = (((uint64_t)(self->private_impl.f_width)) * v_dst_bytes_per_pixel);
-  v_dst_palette = wuffs_base__pixel_buffer__palette_or_else(a_dst, wuffs_base__make_slice_u8(self->private_data.f_dst_palette, 1024));
-  v_tab = wuffs_base__pixel_buffer__plane(a_dst, 0);
-  v_src_bytes_per_pixel = 1;
-  if (self->private_impl.f_depth >= 8) {
-    v_src_bytes_per_pixel = (((uint64_t)(WUFFS_PNG__NUM_CHANNELS[self->private_impl.f_color_type])) * ((uint64_t)((self->private_impl.f_depth >> 3))));
+
+  uint32_t coro_susp_point = self->private_impl.p_encode_rows[0];
+  if (coro_susp_point) {
+    v_status = self->private_data.s_encode_rows[0].v_status;
   }
-  v_bits_unpacked[0] = 255;
-  v_bits_unpacked[1] = 255;
-  v_bits_unpacked[2] = 255;
-  v_bits_unpacked[3] = 255;
-  v_bits_unpacked[4] = 255;
-  v_bits_unpacked[5] = 255;
-  v_bits_unpacked[6] = 255;
-  v_bits_unpacked[7] = 255;
-  v_y = ((uint32_t)(WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][5]));
-  while (v_y < self->private_impl.f_height) {
-    v_dst = wuffs_base__table_u8__row(v_tab, v_y);
-    if (v_dst_bytes_per_row < ((uint64_t)(v_dst.len))) {
-      v_dst = wuffs_base__slice_u8__subslice_j(v_dst, v_dst_bytes_per_row);
-    }
-    if (1 > ((uint64_t)(a_workbuf.len))) {
-      return wuffs_base__make_status(wuffs_png__error__internal_error_inconsistent_workbuf_length);
-    }
-    v_filter = a_workbuf.ptr[0];
-    a_workbuf = wuffs_base__slice_u8__subslice_i(a_workbuf, 1);
-    if (self->private_impl.f_pass_bytes_per_row > ((uint64_t)(a_workbuf.len))) {
-      return wuffs_base__make_status(wuffs_png__error__internal_error_inconsistent_workbuf_length);
-    }
-    v_curr_row = wuffs_base__slice_u8__subslice_j(a_workbuf, self->private_impl.f_pass_bytes_per_row);
-    a_workbuf = wuffs_base__slice_u8__subslice_i(a_workbuf, self->private_impl.f_pass_bytes_per_row);
-    if (v_filter == 0) {
-    } else if (v_filter == 1) {
-      wuffs_png__decoder__filter_1(self, v_curr_row);
-    } else if (v_filter == 2) {
-      wuffs_png__decoder__filter_2(self, v_curr_row, v_prev_row);
-    } else if (v_filter == 3) {
-      wuffs_png__decoder__filter_3(self, v_curr_row, v_prev_row);
-    } else if (v_filter == 4) {
-      wuffs_png__decoder__filter_4(self, v_curr_row, v_prev_row);
-    } else {
-      return wuffs_base__make_status(wuffs_png__error__bad_filter);
-    }
-    v_s = v_curr_row;
-    v_x = ((uint32_t)(WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][2]));
-    if (self->private_impl.f_depth == 8) {
-      while (v_x < self->private_impl.f_width) {
-        v_i = (((uint64_t)(v_x)) * v_dst_bytes_per_pixel);
-        if (v_i <= ((uint64_t)(v_dst.len))) {
-          if (self->private_impl.f_color_type == 4) {
-            if (2 <= ((uint64_t)(v_s.len))) {
-              v_bits_unpacked[0] = v_s.ptr[0];
-              v_bits_unpacked[1] = v_s.ptr[0];
-              v_bits_unpacked[2] = v_s.ptr[0];
-              v_bits_unpacked[3] = v_s.ptr[1];
-              v_s = wuffs_base__slice_u8__subslice_i(v_s, 2);
-              wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(&self->private_impl.f_swizzler, wuffs_base__slice_u8__subslice_i(v_dst, v_i), v_dst_palette, wuffs_base__make_slice_u8(v_bits_unpacked, 4));
-            }
-          } else if (v_src_bytes_per_pixel <= ((uint64_t)(v_s.len))) {
-            wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(&self->private_impl.f_swizzler, wuffs_base__slice_u8__subslice_i(v_dst, v_i), v_dst_palette, wuffs_base__slice_u8__subslice_j(v_s, v_src_bytes_per_pixel));
-            v_s = wuffs_base__slice_u8__subslice_i(v_s, v_src_bytes_per_pixel);
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    while (self->private_impl.f_y < a_y1) {
+      v_bpr = ((uint64_t)(self->private_impl.f_bytes_per_row));
+      v_stride = (16 + v_bpr);
+      if (v_stride > ((uint64_t)(a_workbuf.len))) {
+        status = wuffs_base__make_status(wuffs_base__error__bad_workbuf_length);
+        goto exit;
+      }
+      v_curr = wuffs_base__slice_u8__subslice_j(a_workbuf, v_stride);
+      v_prev = wuffs_base__slice_u8__subslice_i(a_workbuf, v_stride);
+      if (v_stride > ((uint64_t)(v_prev.len))) {
+        status = wuffs_base__make_status(wuffs_base__error__bad_workbuf_length);
+        goto exit;
+      }
+      v_filtered = wuffs_base__slice_u8__subslice_i(v_prev, v_stride);
+      v_prev = wuffs_base__slice_u8__subslice_j(v_prev, v_stride);
+      if ((1 + v_bpr) > ((uint64_t)(v_filtered.len))) {
+        status = wuffs_base__make_status(wuffs_base__error__bad_workbuf_length);
+        goto exit;
+      }
+      v_filtered = wuffs_base__slice_u8__subslice_j(v_filtered, (1 + v_bpr));
+      if (self->private_impl.f_filtered_n == 0) {
+        v_d = (16 - ((uint64_t)(self->private_impl.f_filter_distance)));
+        if ((self->private_impl.f_y & 1) != 0) {
+          v_swap = v_curr;
+          v_curr = v_prev;
+          v_prev = v_swap;
+        }
+        if ((v_d > ((uint64_t)(v_curr.len))) || (v_d > ((uint64_t)(v_prev.len)))) {
+          status = wuffs_base__make_status(wuffs_base__error__bad_workbuf_length);
+          goto exit;
+        }
+        v_curr = wuffs_base__slice_u8__subslice_i(v_curr, v_d);
+        v_prev = wuffs_base__slice_u8__subslice_i(v_prev, v_d);
+        v_d = ((uint64_t)(self->private_impl.f_filter_distance));
+        v_tab = wuffs_base__pixel_buffer__plane(a_src, 0);
+        if (v_d <= ((uint64_t)(v_curr.len))) {
+          wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(&self->private_impl.f_swizzler, wuffs_base__slice_u8__subslice_i(v_curr, v_d), wuffs_base__utility__empty_slice_u8(), wuffs_base__table_u8__row(v_tab, self->private_impl.f_y));
+        }
+        wuffs_png__encoder__filter_row(self, v_filtered, v_curr, v_prev);
+        self->private_impl.f_adler32_state = wuffs_adler32__hasher__update_u32(&self->private_data.f_adler32, v_filtered);
+        self->private_impl.f_filtered_ri = 0;
+        self->private_impl.f_filtered_n = (self->private_impl.f_bytes_per_row + 1);
+        if (((uint32_t)(self->private_impl.f_y + 1)) >= a_y1) {
+          wuffs_deflate__encoder__end_input(&self->private_data.f_flate, a_full_flush);
+        }
+      }
+      v_i = ((uint64_t)(self->private_impl.f_filtered_ri));
+      v_j = ((uint64_t)(self->private_impl.f_filtered_n));
+      if ((v_i < v_j) && (v_j <= ((uint64_t)(v_filtered.len)))) {
+        {
+          wuffs_base__io_buffer* o_0_v_r = v_r;
+          const uint8_t *o_0_iop_v_r = iop_v_r;
+          const uint8_t *o_0_io0_v_r = io0_v_r;
+          const uint8_t *o_0_io1_v_r = io1_v_r;
+          const uint8_t *o_0_io2_v_r = io2_v_r;
+          v_r = wuffs_base__io_reader__set(
+              &u_r,
+              &iop_v_r,
+              &io0_v_r,
+              &io1_v_r,
+              &io2_v_r,
+              wuffs_base__slice_u8__subslice_ij(v_filtered, v_i, v_j));
+          v_r_mark = ((uint64_t)(iop_v_r - io0_v_r));
+          {
+            u_r.meta.ri = ((size_t)(iop_v_r - u_r.data.ptr));
+            wuffs_base__status t_0 = wuffs_deflate__encoder__transform_io(&self->private_data.f_flate, a_dst, v_r, wuffs_base__utility__empty_slice_u8());
+            v_status = t_0;
+            iop_v_r = u_r.data.ptr + u_r.meta.ri;
           }
+          v_n = wuffs_base__io__count_since(v_r_mark, ((uint64_t)(iop_v_r - io0_v_r)));
+          v_r = o_0_v_r;
+          iop_v_r = o_0_iop_v_r;
+          io0_v_r = o_0_io0_v_r;
+          io1_v_r = o_0_io1_v_r;
+          io2_v_r = o_0_io2_v_r;
         }
-        v_x += (((uint32_t)(1)) << WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][0]);
+        v_ri = (self->private_impl.f_filtered_ri + ((uint32_t)(wuffs_base__u64__min(v_n, 67108861))));
+        self->private_impl.f_filtered_ri = wuffs_base__u32__min(v_ri, self->private_impl.f_filtered_n);
       }
-    } else if (self->private_impl.f_depth < 8) {
-      v_multiplier = 1;
-      if (self->private_impl.f_color_type == 0) {
-        v_multiplier = WUFFS_PNG__LOW_BIT_DEPTH_MULTIPLIERS[self->private_impl.f_depth];
+      if (self->private_impl.f_filtered_ri >= self->private_impl.f_filtered_n) {
+        self->private_impl.f_y += 1;
+        self->private_impl.f_filtered_n = 0;
       }
-      v_shift = ((8 - self->private_impl.f_depth) & 7);
-      v_packs_remaining = 0;
-      while (v_x < self->private_impl.f_width) {
-        v_i = (((uint64_t)(v_x)) * v_dst_bytes_per_pixel);
-        if (v_i <= ((uint64_t)(v_dst.len))) {
-          if ((v_packs_remaining == 0) && (1 <= ((uint64_t)(v_s.len)))) {
-            v_packs_remaining = WUFFS_PNG__LOW_BIT_DEPTH_NUM_PACKS[self->private_impl.f_depth];
-            v_bits_packed = v_s.ptr[0];
-            v_s = wuffs_base__slice_u8__subslice_i(v_s, 1);
-          }
-          v_bits_unpacked[0] = ((uint8_t)((v_bits_packed >> v_shift) * v_multiplier));
-          v_bits_packed = ((uint8_t)(v_bits_packed << self->private_impl.f_depth));
-          v_packs_remaining = ((uint8_t)(v_packs_remaining - 1));
-          wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(&self->private_impl.f_swizzler, wuffs_base__slice_u8__subslice_i(v_dst, v_i), v_dst_palette, wuffs_base__make_slice_u8(v_bits_unpacked, 1));
+      if (v_status.repr == wuffs_base__suspension__short_write) {
+        status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(1);
+      } else if ( ! wuffs_base__status__is_ok(&v_status) && (v_status.repr != wuffs_base__suspension__short_read)) {
+        status = v_status;
+        if (wuffs_base__status__is_error(&status)) {
+          goto exit;
+        } else if (wuffs_base__status__is_suspension(&status)) {
+          status = wuffs_base__make_status(wuffs_base__error__cannot_return_a_suspension);
+          goto exit;
         }
-        v_x += (((uint32_t)(1)) << WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][0]);
+        goto ok;
       }
-    } else {
-      while (v_x < self->private_impl.f_width) {
-        v_i = (((uint64_t)(v_x)) * v_dst_bytes_per_pixel);
-        if (v_i <= ((uint64_t)(v_dst.len))) {
-          if (self->private_impl.f_color_type == 0) {
-            if (2 <= ((uint64_t)(v_s.len))) {
-              v_bits_unpacked[0] = v_s.ptr[1];
-              v_bits_unpacked[1] = v_s.ptr[0];
-              v_bits_unpacked[2] = v_s.ptr[1];
-              v_bits_unpacked[3] = v_s.ptr[0];
-              v_bits_unpacked[4] = v_s.ptr[1];
-              v_bits_unpacked[5] = v_s.ptr[0];
-              v_s = wuffs_base__slice_u8__subslice_i(v_s, 2);
-            }
-          } else if (self->private_impl.f_color_type == 2) {
-            if (6 <= ((uint64_t)(v_s.len))) {
-              v_bits_unpacked[0] = v_s.ptr[5];
-              v_bits_unpacked[1] = v_s.ptr[4];
-              v_bits_unpacked[2] = v_s.ptr[3];
-              v_bits_unpacked[3] = v_s.ptr[2];
-              v_bits_unpacked[4] = v_s.ptr[1];
-              v_bits_unpacked[5] = v_s.ptr[0];
-              v_s = wuffs_base__slice_u8__subslice_i(v_s, 6);
-            }
-          } else if (self->private_impl.f_color_type == 4) {
-            if (4 <= ((uint64_t)(v_s.len))) {
-              v_bits_unpacked[0] = v_s.ptr[1];
-              v_bits_unpacked[1] = v_s.ptr[0];
-              v_bits_unpacked[2] = v_s.ptr[1];
-              v_bits_unpacked[3] = v_s.ptr[0];
-              v_bits_unpacked[4] = v_s.ptr[1];
-              v_bits_unpacked[5] = v_s.ptr[0];
-              v_bits_unpacked[6] = v_s.ptr[3];
-              v_bits_unpacked[7] = v_s.ptr[2];
-              v_s = wuffs_base__slice_u8__subslice_i(v_s, 4);
-            }
-          } else {
-            if (8 <= ((uint64_t)(v_s.len))) {
-              v_bits_unpacked[0] = v_s.ptr[5];
-              v_bits_unpacked[1] = v_s.ptr[4];
-              v_bits_unpacked[2] = v_s.ptr[3];
-              v_bits_unpacked[3] = v_s.ptr[2];
-              v_bits_unpacked[4] = v_s.ptr[1];
-              v_bits_unpacked[5] = v_s.ptr[0];
-              v_bits_unpacked[6] = v_s.ptr[7];
-              v_bits_unpacked[7] = v_s.ptr[6];
-              v_s = wuffs_base__slice_u8__subslice_i(v_s, 8);
-            }
-          }
-          wuffs_base__pixel_swizzler__swizzle_interleaved_from_slice(&self->private_impl.f_swizzler, wuffs_base__slice_u8__subslice_i(v_dst, v_i), v_dst_palette, wuffs_base__make_slice_u8(v_bits_unpacked, 8));
+      v_status = wuffs_base__make_status(NULL);
+    }
+    label__0__continue:;
+    while (true) {
+      {
+        wuffs_base__io_buffer* o_1_v_r = v_r;
+        const uint8_t *o_1_iop_v_r = iop_v_r;
+        const uint8_t *o_1_io0_v_r = io0_v_r;
+        const uint8_t *o_1_io1_v_r = io1_v_r;
+        const uint8_t *o_1_io2_v_r = io2_v_r;
+        v_r = wuffs_base__io_reader__set(
+            &u_r,
+            &iop_v_r,
+            &io0_v_r,
+            &io1_v_r,
+            &io2_v_r,
+            wuffs_base__utility__empty_slice_u8());
+        {
+          u_r.meta.ri = ((size_t)(iop_v_r - u_r.data.ptr));
+          wuffs_base__status t_1 = wuffs_deflate__encoder__transform_io(&self->private_data.f_flate, a_dst, v_r, wuffs_base__utility__empty_slice_u8());
+          v_status = t_1;
+          iop_v_r = u_r.data.ptr + u_r.meta.ri;
         }
-        v_x += (((uint32_t)(1)) << WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][0]);
+        v_r = o_1_v_r;
+        iop_v_r = o_1_iop_v_r;
+        io0_v_r = o_1_io0_v_r;
+        io1_v_r = o_1_io1_v_r;
+        io2_v_r = o_1_io2_v_r;
+      }
+      if (wuffs_base__status__is_ok(&v_status)) {
+        goto label__0__break;
+      } else if (v_status.repr == wuffs_base__suspension__short_write) {
+        status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(2);
+        goto label__0__continue;
+      }
+      status = v_status;
+      if (wuffs_base__status__is_error(&status)) {
+        goto exit;
+      } else if (wuffs_base__status__is_suspension(&status)) {
+        status = wuffs_base__make_status(wuffs_base__error__cannot_return_a_suspension);
+        goto exit;
       }
+      goto ok;
     }
-    v_prev_row = v_curr_row;
-    v_y += (((uint32_t)(1)) << WUFFS_PNG__INTERLACING[self->private_impl.f_interlace_pass][3]);
+    label__0__break:;
+
+    ok:
+    self->private_impl.p_encode_rows[0] = 0;
+    goto exit;
   }
-  return wuffs_base__make_status(NULL);
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_encode_rows[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+  self->private_data.s_encode_rows[0].v_status = v_status;
+
+  goto exit;
+  exit:
+
+  return status;
+}
+
+// -------- func png.encoder.write_buf
+
+static wuffs_base__status
+wuffs_png__encoder__write_buf(
+    wuffs_png__encoder* self,
+    wuffs_base__io_buffer* a_dst) {
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  uint64_t v_n = 0;
+  uint32_t v_ri = 0;
+
+  uint8_t* iop_a_dst = NULL;
+  uint8_t* io0_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io1_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  uint8_t* io2_a_dst WUFFS_BASE__POTENTIALLY_UNUSED = NULL;
+  if (a_dst) {
+    io0_a_dst = a_dst->data.ptr;
+    io1_a_dst = io0_a_dst + a_dst->meta.wi;
+    iop_a_dst = io1_a_dst;
+    io2_a_dst = io0_a_dst + a_dst->data.len;
+    if (a_dst->meta.closed) {
+      io2_a_dst = iop_a_dst;
+    }
+  }
+
+  uint32_t coro_susp_point = self->private_impl.p_write_buf[0];
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    while (self->private_impl.f_buf_ri < self->private_impl.f_buf_wi) {
+      v_n = wuffs_base__io_writer__copy_from_slice(&iop_a_dst, io2_a_dst,wuffs_base__slice_u8__subslice_ij(wuffs_base__make_slice_u8(self->private_data.f_buf,
+          32800),
+          self->private_impl.f_buf_ri,
+          self->private_impl.f_buf_wi));
+      v_ri = (self->private_impl.f_buf_ri + ((uint32_t)(wuffs_base__u64__min(v_n, 32800))));
+      self->private_impl.f_buf_ri = wuffs_base__u32__min(v_ri, self->private_impl.f_buf_wi);
+      if (self->private_impl.f_buf_ri < self->private_impl.f_buf_wi) {
+        status = wuffs_base__make_status(wuffs_base__suspension__short_write);
+        WUFFS_BASE__COROUTINE_SUSPENSION_POINT_MAYBE_SUSPEND(1);
+      }
+    }
+
+    ok:
+    self->private_impl.p_write_buf[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_write_buf[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+
+  goto exit;
+  exit:
+  if (a_dst) {
+    a_dst->meta.wi = ((size_t)(iop_a_dst - a_dst->data.ptr));
+  }
+
+  return status;
+}
+
+// -------- func png.encoder.write_idat
+
+static wuffs_base__status
+wuffs_png__encoder__write_idat(
+    wuffs_png__encoder* self,
+    wuffs_base__io_buffer* a_dst) {
+  wuffs_base__status status = wuffs_base__make_status(NULL);
+
+  uint32_t v_wi = 0;
+  uint32_t v_crc = 0;
+
+  uint32_t coro_susp_point = self->private_impl.p_write_idat[0];
+  switch (coro_susp_point) {
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT_0;
+
+    v_wi = wuffs_base__u32__min(wuffs_base__u32__max(self->private_impl.f_buf_wi, 8), 32792);
+    wuffs_base__poke_u32be__no_bounds_check(wuffs_base__make_slice_u8((self->private_data.f_buf) + 0, 4).ptr, (v_wi - 8));
+    wuffs_base__poke_u32be__no_bounds_check(wuffs_base__make_slice_u8((self->private_data.f_buf) + 4, 4).ptr, 1229209940);
+    wuffs_base__ignore_status(wuffs_crc32__ieee_hasher__initialize(&self->private_data.f_crc32, sizeof (wuffs_crc32__ieee_hasher), WUFFS_VERSION, 0));
+    v_crc = wuffs_crc32__ieee_hasher__update_u32(&self->private_data.f_crc32, wuffs_base__slice_u8__subslice_ij(wuffs_base__make_slice_u8(self->private_data.f_buf, 32800), 4, v_wi));
+    self->private_data.f_buf[(v_wi + 0)] = ((uint8_t)((v_crc >> 24)));
+    self->private_data.f_buf[(v_wi + 1)] = ((uint8_t)(((v_crc >> 16) & 255)));
+    self->private_data.f_buf[(v_wi + 2)] = ((uint8_t)(((v_crc >> 8) & 255)));
+    self->private_data.f_buf[(v_wi + 3)] = ((uint8_t)((v_crc & 255)));
+    self->private_impl.f_buf_ri = 0;
+    self->private_impl.f_buf_wi = (v_wi + 4);
+    WUFFS_BASE__COROUTINE_SUSPENSION_POINT(1);
+    status = wuffs_png__encoder__write_buf(self, a_dst);
+    if (status.repr) {
+      goto suspend;
+    }
+    self->private_impl.f_buf_wi = 8;
+
+    goto ok;
+    ok:
+    self->private_impl.p_write_idat[0] = 0;
+    goto exit;
+  }
+
+  goto suspend;
+  suspend:
+  self->private_impl.p_write_idat[0] = wuffs_base__status__is_suspension(&status) ? coro_susp_point : 0;
+
+  goto exit;
+  exit:
+  return status;
 }
 
 #endif  // !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__PNG)
@@ -39537,89 +51836,2014 @@ DecodeCbor(DecodeCborCallbacks& callbacks,
           goto fail;
         }
 
-        case WUFFS_BASE__TOKEN__VBC__INLINE_INTEGER_SIGNED: {
-          if (token.continued()) {
-            extension_category = WUFFS_BASE__TOKEN__VBC__INLINE_INTEGER_SIGNED;
-            extension_detail =
-                static_cast<uint64_t>(token.value_base_detail__sign_extended());
-            continue;
-          }
-          ret_error_message =
-              callbacks.AppendI64(token.value_base_detail__sign_extended());
-          goto parsed_a_value;
-        }
+        case WUFFS_BASE__TOKEN__VBC__INLINE_INTEGER_SIGNED: {
+          if (token.continued()) {
+            extension_category = WUFFS_BASE__TOKEN__VBC__INLINE_INTEGER_SIGNED;
+            extension_detail =
+                static_cast<uint64_t>(token.value_base_detail__sign_extended());
+            continue;
+          }
+          ret_error_message =
+              callbacks.AppendI64(token.value_base_detail__sign_extended());
+          goto parsed_a_value;
+        }
+
+        case WUFFS_BASE__TOKEN__VBC__INLINE_INTEGER_UNSIGNED: {
+          if (token.continued()) {
+            extension_category =
+                WUFFS_BASE__TOKEN__VBC__INLINE_INTEGER_UNSIGNED;
+            extension_detail = vbd;
+            continue;
+          }
+          ret_error_message = callbacks.AppendU64(vbd);
+          goto parsed_a_value;
+        }
+      }
+
+      if (token.value_major() == WUFFS_CBOR__TOKEN_VALUE_MAJOR) {
+        uint64_t value_minor = token.value_minor();
+        if (value_minor & WUFFS_CBOR__TOKEN_VALUE_MINOR__MINUS_1_MINUS_X) {
+          if (token_len == 9) {
+            ret_error_message = callbacks.AppendMinus1MinusX(
+                wuffs_base__peek_u64be__no_bounds_check(token_ptr + 1));
+            goto parsed_a_value;
+          }
+        } else if (value_minor & WUFFS_CBOR__TOKEN_VALUE_MINOR__SIMPLE_VALUE) {
+          ret_error_message =
+              callbacks.AppendCborSimpleValue(static_cast<uint8_t>(
+                  value_minor & WUFFS_CBOR__TOKEN_VALUE_MINOR__DETAIL_MASK));
+          goto parsed_a_value;
+        } else if (value_minor & WUFFS_CBOR__TOKEN_VALUE_MINOR__TAG) {
+          if (token.continued()) {
+            extension_category = EXT_CAT__CBOR_TAG;
+            extension_detail =
+                value_minor & WUFFS_CBOR__TOKEN_VALUE_MINOR__DETAIL_MASK;
+            continue;
+          }
+          ret_error_message = callbacks.AppendCborTag(
+              value_minor & WUFFS_CBOR__TOKEN_VALUE_MINOR__DETAIL_MASK);
+          if (!ret_error_message.empty()) {
+            goto done;
+          }
+          continue;
+        }
+      }
+
+    fail:
+      ret_error_message =
+          "wuffs_aux::CborDecoder: internal error: unexpected token";
+      goto done;
+
+    parsed_a_value:
+      if (!ret_error_message.empty() || (depth == 0)) {
+        goto done;
+      }
+    }
+  } while (false);
+
+done:
+  DecodeCborResult result(
+      std::move(ret_error_message),
+      wuffs_base__u64__sat_add(io_buf->meta.pos, cursor_index));
+  callbacks.Done(result, input, *io_buf);
+  return result;
+}
+
+}  // namespace wuffs_aux
+
+#endif  // !defined(WUFFS_CONFIG__MODULES) ||
+        // defined(WUFFS_CONFIG__MODULE__AUX__CBOR)
+
+// ---------------- Auxiliary - Deflate
+
+#if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__AUX__DEFLATE)
+
+#include <thread>
+#include <utility>
+#include <vector>
+
+// WUFFS_AUX__DECODE_DEFLATE__CHUNK_LENGTH is the number of compressed bytes
+// that each thread starts with, when decoding in parallel.
+#ifndef WUFFS_AUX__DECODE_DEFLATE__CHUNK_LENGTH
+#define WUFFS_AUX__DECODE_DEFLATE__CHUNK_LENGTH (1024 * 1024)
+#endif
+
+// WUFFS_AUX__DECODE_DEFLATE__MAX_SPECULATIVE_LENGTH is the maximum number of
+// decoded bytes that each thread buffers, when decoding in parallel. Chunks
+// that decode to more than this are instead decoded single-threaded.
+#ifndef WUFFS_AUX__DECODE_DEFLATE__MAX_SPECULATIVE_LENGTH
+#define WUFFS_AUX__DECODE_DEFLATE__MAX_SPECULATIVE_LENGTH (64 * 1024 * 1024)
+#endif
+
+// WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH is the approximate maximum
+// number of decoded bytes, per thread, that DecodeGzipMembers buffers at a
+// time. Members that decode to more than this are decoded single-threaded.
+#ifndef WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH
+#define WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH (4 * 1024 * 1024)
+#endif
+
+namespace wuffs_aux {
+
+DecodeDeflateResult::DecodeDeflateResult(std::string&& error_message0,
+                                         uint64_t num_dst_bytes0)
+    : error_message(std::move(error_message0)),
+      num_dst_bytes(num_dst_bytes0) {}
+
+DecodeDeflateCallbacks::~DecodeDeflateCallbacks() {}
+
+void  //
+DecodeDeflateCallbacks::Done(DecodeDeflateResult& result,
+                             sync_io::Input& input) {}
+
+const char DecodeDeflate_BadChecksum[] =  //
+    "wuffs_aux::DecodeDeflate: bad checksum";
+const char DecodeDeflate_BadHeader[] =  //
+    "wuffs_aux::DecodeDeflate: bad header";
+const char DecodeDeflate_OutOfMemory[] =  //
+    "wuffs_aux::DecodeDeflate: out of memory";
+const char DecodeDeflate_UnexpectedEndOfFile[] =  //
+    "wuffs_aux::DecodeDeflate: unexpected end of file";
+const char DecodeDeflate_UnsupportedFraming[] =  //
+    "wuffs_aux::DecodeDeflate: unsupported framing";
+
+// --------
+
+namespace {
+
+// DecodeDeflateNoPosition is a sentinel bit position.
+const uint64_t DecodeDeflateNoPosition = UINT64_MAX;
+
+const size_t DecodeDeflateScratchLength = 65536;
+
+// DecodeDeflateFill reads more of the input into io_buf, returning an error
+// message (possibly DecodeDeflate_UnexpectedEndOfFile) if it cannot.
+std::string  //
+DecodeDeflateFill(sync_io::Input& input, wuffs_base__io_buffer* io_buf) {
+  if (io_buf->meta.closed) {
+    return DecodeDeflate_UnexpectedEndOfFile;
+  }
+  io_buf->compact();
+  return input.CopyIn(io_buf);
+}
+
+// DecodeDeflateStream runs dec, reading from io_buf (refilled from input),
+// until dec reaches the end of its stream. The output goes through the dst
+// scratch buffer to callbacks.Append.
+std::string  //
+DecodeDeflateStream(DecodeDeflateCallbacks& callbacks,
+                    sync_io::Input& input,
+                    wuffs_base__io_buffer* io_buf,
+                    wuffs_base__io_transformer* dec,
+                    wuffs_base__io_buffer* dst,
+                    uint64_t* num_dst_bytes) {
+  uint8_t work_array[1];
+  while (true) {
+    dst->meta.wi = 0;
+    wuffs_base__status status = dec->transform_io(
+        dst, io_buf, wuffs_base__make_slice_u8(work_array, 0));
+    if (dst->meta.wi > 0) {
+      std::string error_message =
+          callbacks.Append(dst->data.ptr, dst->meta.wi);
+      *num_dst_bytes += dst->meta.wi;
+      if (!error_message.empty()) {
+        return error_message;
+      }
+    }
+
+    if (status.is_ok()) {
+      return "";
+    } else if (status.repr == wuffs_base__suspension__short_read) {
+      std::string error_message = DecodeDeflateFill(input, io_buf);
+      if (!error_message.empty()) {
+        return error_message;
+      }
+    } else if (status.repr != wuffs_base__suspension__short_write) {
+      return status.message();
+    }
+  }
+}
+
+DecodeDeflateResult  //
+DecodeDeflateSerial(DecodeDeflateCallbacks& callbacks,
+                    sync_io::Input& input,
+                    uint32_t framing,
+                    bool ignore_checksum) {
+  wuffs_base__io_transformer::unique_ptr dec(nullptr, &free);
+  switch (framing) {
+    case 0:
+      dec = wuffs_deflate__decoder::alloc_as__wuffs_base__io_transformer();
+      break;
+    case WUFFS_BASE__FOURCC__GZ:
+      dec = wuffs_gzip__decoder::alloc_as__wuffs_base__io_transformer();
+      break;
+    case WUFFS_BASE__FOURCC__ZLIB:
+      dec = wuffs_zlib__decoder::alloc_as__wuffs_base__io_transformer();
+      break;
+    default:
+      return DecodeDeflateResult(DecodeDeflate_UnsupportedFraming, 0);
+  }
+  if (!dec) {
+    return DecodeDeflateResult(DecodeDeflate_OutOfMemory, 0);
+  }
+  dec->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, ignore_checksum);
+
+  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
+  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
+  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
+  if (!io_buf) {
+    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);
+    fallback_io_buf =
+        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);
+    io_buf = &fallback_io_buf;
+  }
+
+  std::unique_ptr<uint8_t[]> dst_array(
+      new uint8_t[DecodeDeflateScratchLength]);
+  wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(
+      dst_array.get(), DecodeDeflateScratchLength);
+  uint64_t num_dst_bytes = 0;
+  std::string error_message = DecodeDeflateStream(
+      callbacks, input, io_buf, dec.get(), &dst, &num_dst_bytes);
+  return DecodeDeflateResult(std::move(error_message), num_dst_bytes);
+}
+
+// DecodeDeflateLooksLikeBlockStart returns the number of block boundaries
+// that DecodeDeflateTrialDecode should get through, if the bit position pos
+// is a plausible start of a stored or dynamic Huffman DEFLATE block, or zero
+// if it is not. Fixed Huffman blocks are not considered: their 3 bit header
+// is too short to distinguish them from random data.
+//
+// It is a cheap filter that rejects almost all bit positions, before trying
+// the more expensive DecodeDeflateTrialDecode.
+uint32_t  //
+DecodeDeflateLooksLikeBlockStart(const uint8_t* ptr,
+                                 size_t len,
+                                 uint64_t pos) {
+  size_t i = (size_t)(pos >> 3);
+  if ((len < 16) || (i > (len - 16))) {
+    return 0;
+  }
+  uint64_t bits = wuffs_base__peek_u64le__no_bounds_check(ptr + i) >> (pos & 7);
+  uint32_t type = (uint32_t)((bits >> 1) & 3);
+
+  if (type == 0) {
+    // A stored block: the LEN and NLEN fields start at the next byte boundary
+    // and should be each other's complement. Only consider the bit position
+    // just before that boundary. Earlier positions would be equivalent (the
+    // padding bits are typically zero) or misleading (treating the previous
+    // block's final bits as this block's header bits).
+    //
+    // With only a 16 bit check, some random data passes as a stored block,
+    // and a stored block's payload is not validated at all, so require the
+    // trial decode to get through more subsequent blocks.
+    if (((pos + 3) & 7) != 0) {
+      return 0;
+    }
+    uint32_t len_nlen =
+        wuffs_base__peek_u32le__no_bounds_check(ptr + ((pos + 3) >> 3));
+    return (((len_nlen ^ (len_nlen >> 16)) & 0xFFFF) == 0xFFFF) ? 8 : 0;
+
+  } else if (type != 2) {
+    return 0;
+  }
+
+  // A dynamic Huffman block: check HLIT, HDIST and that the (up to 19) 3-bit
+  // code lengths for the code length alphabet form a complete prefix code.
+  uint32_t hlit = (uint32_t)((bits >> 3) & 31);
+  uint32_t hdist = (uint32_t)((bits >> 8) & 31);
+  uint32_t hclen = (uint32_t)((bits >> 13) & 15) + 4;
+  if ((hlit > 29) || (hdist > 29)) {
+    return 0;
+  }
+  pos += 17;
+  uint64_t clens = wuffs_base__peek_u64le__no_bounds_check(ptr + (pos >> 3)) >>
+                   (pos & 7);
+  uint32_t kraft = 0;
+  for (uint32_t c = 0; c < hclen; c++) {
+    uint32_t n = (uint32_t)((clens >> (3 * c)) & 7);
+    if (n > 0) {
+      kraft += 128u >> n;
+    }
+  }
+  return (kraft == 128) ? 2 : 0;
+}
+
+// DecodeDeflateEquivalentStarts returns whether decoding from the bit
+// positions p and q are equivalent. Trivially, this is when (p == q), but a
+// stored block's header can also be ambiguous, since its padding bits can
+// also look like a stored block header.
+bool  //
+DecodeDeflateEquivalentStarts(const uint8_t* ptr,
+                              size_t len,
+                              uint64_t p,
+                              uint64_t q) {
+  if (p == q) {
+    return true;
+  } else if ((((p + 3 + 7) >> 3) != ((q + 3 + 7) >> 3)) ||
+             (((q + 3 + 7) >> 3) > len)) {
+    return false;
+  }
+  uint32_t p_header = (uint32_t)(
+      (wuffs_base__peek_u16le__no_bounds_check(ptr + (p >> 3)) >> (p & 7)) &
+      7);
+  uint32_t q_header = (uint32_t)(
+      (wuffs_base__peek_u16le__no_bounds_check(ptr + (q >> 3)) >> (q & 7)) &
+      7);
+  return (p_header == q_header) && ((p_header >> 1) == 0);
+}
+
+// DecodeDeflateState holds the read-only state shared by the threads.
+struct DecodeDeflateState {
+  DecodeDeflateState(const uint8_t* ptr0, size_t len0);
+
+  const uint8_t* ptr;
+  size_t len;
+
+  // history_a, history_b and history_z are placeholder histories. The real
+  // history byte at position p (where 0 is the oldest and 32767 is the most
+  // recent) is represented by history_a[p] and history_b[p] in two parallel
+  // decodings. Bytes that are equal in both decodings are literal bytes
+  // (copies of them). Bytes that differ, a and b, came from the history, at
+  // position ((((b - a - 1) & 0xFF) << 8) | a). history_z is all zeroes.
+  uint8_t history_a[32768];
+  uint8_t history_b[32768];
+  uint8_t history_z[32768];
+};
+
+DecodeDeflateState::DecodeDeflateState(const uint8_t* ptr0, size_t len0)
+    : ptr(ptr0), len(len0) {
+  for (uint32_t p = 0; p < 32768; p++) {
+    history_a[p] = (uint8_t)(p);
+    history_b[p] = (uint8_t)((p & 0xFF) + (p >> 8) + 1);
+    history_z[p] = 0;
+  }
+}
+
+// DecodeDeflateChunk is a contiguous part of the DEFLATE stream, decoded
+// speculatively by one thread.
+struct DecodeDeflateChunk {
+  DecodeDeflateChunk();
+
+  // start_pos is the bit position of a candidate block boundary, found by
+  // DecodeDeflateFindCandidate, or DecodeDeflateNoPosition if none was found.
+  uint64_t start_pos;
+  // stop_pos is where the chunk ends: at the first block boundary at or
+  // after this bit position (or at the end of the DEFLATE stream).
+  uint64_t stop_pos;
+
+  // The remaining fields are set by DecodeDeflateSpeculate.
+  //
+  // ok is whether the speculative decoding succeeded. If so, end_pos is the
+  // bit position of the block boundary where it stopped, final is whether
+  // that was the end of the DEFLATE stream and end_index (only meaningful
+  // when final) is the byte index just after the end of the DEFLATE stream.
+  bool ok;
+  bool final;
+  uint64_t end_pos;
+  size_t end_index;
+
+  // dst_a is the decoded output, using history_a. resolve_b is a prefix of
+  // the decoded output using history_b, long enough to resolve every
+  // placeholder byte in dst_a.
+  std::vector<uint8_t> dst_a;
+  std::vector<uint8_t> resolve_b;
+};
+
+DecodeDeflateChunk::DecodeDeflateChunk()
+    : start_pos(DecodeDeflateNoPosition),
+      stop_pos(DecodeDeflateNoPosition),
+      ok(false),
+      final(false),
+      end_pos(0),
+      end_index(0) {}
+
+// DecodeDeflateRestart re-initializes dec and src so that decoding resumes at
+// the bit position pos, with the given history (which may be empty).
+bool  //
+DecodeDeflateRestart(wuffs_deflate__decoder* dec,
+                     wuffs_base__io_buffer* src,
+                     const uint8_t* ptr,
+                     size_t len,
+                     uint64_t pos,
+                     const uint8_t* history_ptr,
+                     size_t history_len) {
+  wuffs_base__status status =
+      dec->initialize(sizeof__wuffs_deflate__decoder(), WUFFS_VERSION,
+                      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);
+  if (!status.is_ok()) {
+    return false;
+  }
+  dec->set_quirk_enabled(WUFFS_DEFLATE__QUIRK_SUSPEND_AT_BLOCK_BOUNDARIES,
+                         true);
+  if (history_len > 0) {
+    dec->add_history(wuffs_base__make_slice_u8(
+        const_cast<uint8_t*>(history_ptr), history_len));
+  }
+  size_t i = (size_t)(pos >> 3);
+  uint32_t n = (uint32_t)(pos & 7);
+  if (i > len) {
+    return false;
+  } else if (n > 0) {
+    if (i == len) {
+      return false;
+    }
+    dec->set_pending_bits(ptr[i] >> n, 8 - n);
+    i++;
+  }
+  *src = wuffs_base__ptr_u8__reader(const_cast<uint8_t*>(ptr), len, true);
+  src->meta.ri = i;
+  return true;
+}
+
+// DecodeDeflateBoundaryPosition returns the bit position of the block
+// boundary that the decoder is suspended at.
+uint64_t  //
+DecodeDeflateBoundaryPosition(wuffs_deflate__decoder* dec,
+                              wuffs_base__io_buffer* src) {
+  return (((uint64_t)(src->meta.ri)) * 8) - dec->num_pending_bits();
+}
+
+// DecodeDeflateTrialDecode returns whether decoding from the bit position pos
+// (with a placeholder history) gets through want_boundaries block boundaries,
+// or 1 MiB of output, without error. Reaching the end of the DEFLATE stream
+// does not count, as a false positive can look like a short final block.
+bool  //
+DecodeDeflateTrialDecode(const DecodeDeflateState& state,
+                         wuffs_deflate__decoder* dec,
+                         uint8_t* scratch,
+                         uint64_t pos,
+                         uint32_t want_boundaries) {
+  wuffs_base__io_buffer src;
+  if (!DecodeDeflateRestart(dec, &src, state.ptr, state.len, pos,
+                            state.history_z, 32768)) {
+    return false;
+  }
+  uint8_t work_array[1];
+  uint32_t num_boundaries = 0;
+  uint64_t num_dst_bytes = 0;
+  while (num_dst_bytes < (1024 * 1024)) {
+    wuffs_base__io_buffer dst =
+        wuffs_base__ptr_u8__writer(scratch, DecodeDeflateScratchLength);
+    wuffs_base__status status =
+        dec->transform_io(&dst, &src, wuffs_base__make_slice_u8(work_array, 0));
+    num_dst_bytes += dst.meta.wi;
+    if (status.repr == wuffs_deflate__suspension__block_boundary) {
+      if (++num_boundaries >= want_boundaries) {
+        break;
+      }
+    } else if (status.repr != wuffs_base__suspension__short_write) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint64_t  //
+DecodeDeflateFindCandidate(const DecodeDeflateState& state,
+                           uint64_t min_incl_pos,
+                           uint64_t max_excl_pos) {
+  wuffs_deflate__decoder::unique_ptr dec = wuffs_deflate__decoder::alloc();
+  std::unique_ptr<uint8_t[]> scratch(new uint8_t[DecodeDeflateScratchLength]);
+  if (!dec || !scratch) {
+    return DecodeDeflateNoPosition;
+  }
+  for (uint64_t pos = min_incl_pos; pos < max_excl_pos; pos++) {
+    uint32_t want_boundaries =
+        DecodeDeflateLooksLikeBlockStart(state.ptr, state.len, pos);
+    if ((want_boundaries > 0) &&
+        DecodeDeflateTrialDecode(state, dec.get(), scratch.get(), pos,
+                                 want_boundaries)) {
+      return pos;
+    }
+  }
+  return DecodeDeflateNoPosition;
+}
+
+// DecodeDeflateSpeculate decodes the chunk from its start_pos, using
+// history_a (and later history_b) as a placeholder history. Decoding from the
+// very start of the DEFLATE stream (bit position 0) needs no placeholders.
+void  //
+DecodeDeflateSpeculate(const DecodeDeflateState& state,
+                       DecodeDeflateChunk& chunk) {
+  chunk.ok = false;
+  wuffs_deflate__decoder::unique_ptr dec = wuffs_deflate__decoder::alloc();
+  if (!dec) {
+    return;
+  }
+  bool has_history = chunk.start_pos > 0;
+  wuffs_base__io_buffer src;
+  if (!DecodeDeflateRestart(dec.get(), &src, state.ptr, state.len,
+                            chunk.start_pos, state.history_a,
+                            has_history ? 32768 : 0)) {
+    return;
+  }
+
+  // Decode with history_a.
+  uint8_t work_array[1];
+  size_t n = 0;
+  chunk.dst_a.resize(4 * WUFFS_AUX__DECODE_DEFLATE__CHUNK_LENGTH);
+  while (true) {
+    // Each transform_io call starts with an empty dst (with no history), as
+    // the decoder has already copied earlier output into its own history.
+    wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(
+        chunk.dst_a.data() + n, chunk.dst_a.size() - n);
+    wuffs_base__status status =
+        dec->transform_io(&dst, &src, wuffs_base__make_slice_u8(work_array, 0));
+    n += dst.meta.wi;
+    if (status.repr == wuffs_deflate__suspension__block_boundary) {
+      uint64_t pos = DecodeDeflateBoundaryPosition(dec.get(), &src);
+      if (pos >= chunk.stop_pos) {
+        chunk.end_pos = pos;
+        break;
+      }
+    } else if (status.repr == wuffs_base__suspension__short_write) {
+      size_t max = WUFFS_AUX__DECODE_DEFLATE__MAX_SPECULATIVE_LENGTH;
+      if (chunk.dst_a.size() >= max) {
+        return;
+      }
+      size_t new_size = 2 * chunk.dst_a.size();
+      chunk.dst_a.resize((new_size < max) ? new_size : max);
+    } else if (status.is_ok()) {
+      chunk.final = true;
+      chunk.end_pos = ((uint64_t)(src.meta.ri)) * 8;
+      chunk.end_index = src.meta.ri;
+      break;
+    } else {
+      return;
+    }
+  }
+  chunk.dst_a.resize(n);
+  chunk.dst_a.shrink_to_fit();
+  if (!has_history) {
+    chunk.ok = true;
+    return;
+  }
+
+  // Decode again, with history_b, until 32 KiB of output passes by without
+  // any placeholder bytes. After that, no more placeholders can appear.
+  if (!DecodeDeflateRestart(dec.get(), &src, state.ptr, state.len,
+                            chunk.start_pos, state.history_b, 32768)) {
+    return;
+  }
+  std::unique_ptr<uint8_t[]> scratch(new uint8_t[DecodeDeflateScratchLength]);
+  const uint8_t* a = chunk.dst_a.data();
+  size_t num_resolved = 0;
+  size_t last_placeholder_end = 0;
+  while ((num_resolved < n) &&
+         ((num_resolved - last_placeholder_end) < 32768)) {
+    size_t remaining = n - num_resolved;
+    wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(
+        scratch.get(), (remaining < DecodeDeflateScratchLength)
+                           ? remaining
+                           : DecodeDeflateScratchLength);
+    wuffs_base__status status =
+        dec->transform_io(&dst, &src, wuffs_base__make_slice_u8(work_array, 0));
+    const uint8_t* b = scratch.get();
+    for (size_t i = dst.meta.wi; i > 0; i--) {
+      if (a[num_resolved + i - 1] != b[i - 1]) {
+        last_placeholder_end = num_resolved + i;
+        break;
+      }
+    }
+    chunk.resolve_b.insert(chunk.resolve_b.end(), b, b + dst.meta.wi);
+    num_resolved += dst.meta.wi;
+    if (status.is_error()) {
+      return;
+    } else if (status.is_ok()) {
+      break;
+    }
+  }
+  chunk.resolve_b.resize(last_placeholder_end);
+  chunk.resolve_b.shrink_to_fit();
+  chunk.ok = true;
+}
+
+// DecodeDeflateParallel decodes a complete (in memory) DEFLATE stream. It
+// calls callbacks.Append, in order, from the calling thread.
+class DecodeDeflateParallel {
+ public:
+  DecodeDeflateParallel(DecodeDeflateCallbacks& callbacks,
+                        const uint8_t* ptr,
+                        size_t len,
+                        uint32_t framing,
+                        bool ignore_checksum);
+
+  std::string Decode(uint32_t num_threads, size_t* end_index);
+  uint64_t num_dst_bytes() const { return m_num_dst_bytes; }
+  uint32_t checksum() const { return m_checksum; }
+
+ private:
+  std::string Emit(const uint8_t* ptr, size_t len);
+  std::string DecodeSerially(uint64_t start_pos,
+                             uint64_t stop_pos,
+                             DecodeDeflateChunk& chunk);
+
+  DecodeDeflateCallbacks& m_callbacks;
+  std::unique_ptr<DecodeDeflateState> m_state;
+  uint32_t m_framing;
+  bool m_ignore_checksum;
+
+  wuffs_crc32__ieee_hasher::unique_ptr m_crc32;
+  wuffs_adler32__hasher::unique_ptr m_adler32;
+  uint32_t m_checksum;
+
+  // m_window holds the last 32 KiB of output, oldest first, of which the
+  // final m_window_len bytes are valid.
+  uint8_t m_window[32768];
+  size_t m_window_len;
+  uint64_t m_num_dst_bytes;
+};
+
+DecodeDeflateParallel::DecodeDeflateParallel(DecodeDeflateCallbacks& callbacks,
+                                             const uint8_t* ptr,
+                                             size_t len,
+                                             uint32_t framing,
+                                             bool ignore_checksum)
+    : m_callbacks(callbacks),
+      m_state(new DecodeDeflateState(ptr, len)),
+      m_framing(framing),
+      m_ignore_checksum(ignore_checksum),
+      m_crc32(wuffs_crc32__ieee_hasher::alloc()),
+      m_adler32(wuffs_adler32__hasher::alloc()),
+      m_checksum(0),
+      m_window_len(0),
+      m_num_dst_bytes(0) {}
+
+std::string  //
+DecodeDeflateParallel::Emit(const uint8_t* ptr, size_t len) {
+  if (len == 0) {
+    return "";
+  }
+  if (!m_ignore_checksum) {
+    wuffs_base__slice_u8 s =
+        wuffs_base__make_slice_u8(const_cast<uint8_t*>(ptr), len);
+    if (m_framing == WUFFS_BASE__FOURCC__GZ) {
+      m_checksum = m_crc32->update_u32(s);
+    } else if (m_framing == WUFFS_BASE__FOURCC__ZLIB) {
+      m_checksum = m_adler32->update_u32(s);
+    }
+  }
+  if (len >= 32768) {
+    memcpy(m_window, ptr + len - 32768, 32768);
+    m_window_len = 32768;
+  } else {
+    memmove(m_window, m_window + len, 32768 - len);
+    memcpy(m_window + 32768 - len, ptr, len);
+    m_window_len = (m_window_len + len < 32768) ? (m_window_len + len) : 32768;
+  }
+  m_num_dst_bytes += len;
+  return m_callbacks.Append(ptr, len);
+}
+
+// DecodeSerially decodes (and emits) from start_pos, with the real history,
+// until the first block boundary at or after stop_pos. It sets the chunk's
+// end_pos, final and end_index fields.
+std::string  //
+DecodeDeflateParallel::DecodeSerially(uint64_t start_pos,
+                                      uint64_t stop_pos,
+                                      DecodeDeflateChunk& chunk) {
+  wuffs_deflate__decoder::unique_ptr dec = wuffs_deflate__decoder::alloc();
+  if (!dec) {
+    return DecodeDeflate_OutOfMemory;
+  }
+  wuffs_base__io_buffer src;
+  if (!DecodeDeflateRestart(dec.get(), &src, m_state->ptr, m_state->len,
+                            start_pos, m_window + 32768 - m_window_len,
+                            m_window_len)) {
+    return DecodeDeflate_UnexpectedEndOfFile;
+  }
+  std::unique_ptr<uint8_t[]> dst_array(
+      new uint8_t[DecodeDeflateScratchLength]);
+  uint8_t work_array[1];
+  while (true) {
+    wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(
+        dst_array.get(), DecodeDeflateScratchLength);
+    wuffs_base__status status =
+        dec->transform_io(&dst, &src, wuffs_base__make_slice_u8(work_array, 0));
+    std::string error_message = Emit(dst.data.ptr, dst.meta.wi);
+    if (!error_message.empty()) {
+      return error_message;
+    }
+    if (status.repr == wuffs_deflate__suspension__block_boundary) {
+      uint64_t pos = DecodeDeflateBoundaryPosition(dec.get(), &src);
+      if (pos >= stop_pos) {
+        chunk.end_pos = pos;
+        return "";
+      }
+    } else if (status.repr == wuffs_base__suspension__short_write) {
+      continue;
+    } else if (status.is_ok()) {
+      chunk.final = true;
+      chunk.end_pos = ((uint64_t)(src.meta.ri)) * 8;
+      chunk.end_index = src.meta.ri;
+      return "";
+    } else if (status.repr == wuffs_base__suspension__short_read) {
+      return DecodeDeflate_UnexpectedEndOfFile;
+    } else {
+      return status.message();
+    }
+  }
+}
+
+std::string  //
+DecodeDeflateParallel::Decode(uint32_t num_threads, size_t* end_index) {
+  if (!m_state || !m_crc32 || !m_adler32) {
+    return DecodeDeflate_OutOfMemory;
+  }
+  const size_t chunk_len = WUFFS_AUX__DECODE_DEFLATE__CHUNK_LENGTH;
+  const size_t len = m_state->len;
+  size_t num_chunks = (len / chunk_len) + 1;
+
+  // start_positions[i] is the i'th chunk's candidate start position. The
+  // zeroth chunk always starts at the very start of the DEFLATE stream.
+  std::vector<uint64_t> start_positions(num_chunks + 1,
+                                        DecodeDeflateNoPosition);
+  start_positions[0] = 0;
+
+  uint64_t pos = 0;
+  bool final = false;
+  for (size_t r0 = 0; (r0 < num_chunks) && !final; r0 += num_threads) {
+    size_t r1 = ((num_chunks - r0) < num_threads) ? num_chunks
+                                                  : (r0 + num_threads);
+
+    // Find the candidate start positions for chunks (r0 .. r1], in parallel.
+    // The r0'th chunk's candidate was found by the previous round.
+    {
+      std::vector<std::thread> threads;
+      for (size_t i = r0 + 1; (i <= r1) && (i < num_chunks); i++) {
+        threads.emplace_back([this, &start_positions, chunk_len, i]() {
+          start_positions[i] = DecodeDeflateFindCandidate(
+              *m_state, ((uint64_t)(i * chunk_len)) * 8,
+              ((uint64_t)((i + 1) * chunk_len)) * 8);
+        });
+      }
+      for (auto& t : threads) {
+        t.join();
+      }
+    }
+
+    // Decode chunks [r0 .. r1), in parallel. Each chunk stops at the next
+    // chunk's candidate start position (or the end of this round).
+    std::vector<DecodeDeflateChunk> chunks(r1 - r0);
+    {
+      std::vector<std::thread> threads;
+      for (size_t i = r0; i < r1; i++) {
+        DecodeDeflateChunk& chunk = chunks[i - r0];
+        chunk.start_pos = start_positions[i];
+        chunk.stop_pos = (r1 < num_chunks) ? (((uint64_t)(r1 * chunk_len)) * 8)
+                                           : DecodeDeflateNoPosition;
+        for (size_t j = i + 1; j <= r1; j++) {
+          if (start_positions[j] != DecodeDeflateNoPosition) {
+            chunk.stop_pos = start_positions[j];
+            break;
+          }
+        }
+        if (chunk.start_pos != DecodeDeflateNoPosition) {
+          threads.emplace_back(
+              [this, &chunk]() { DecodeDeflateSpeculate(*m_state, chunk); });
+        }
+      }
+      for (auto& t : threads) {
+        t.join();
+      }
+    }
+
+    // Stitch the chunks together, in order. A speculatively decoded chunk is
+    // used only if it starts exactly where the previous chunk ended and its
+    // placeholders can be resolved. Otherwise, fall back to decoding
+    // serially, with the real history.
+    for (size_t i = r0; (i < r1) && !final; i++) {
+      DecodeDeflateChunk& chunk = chunks[i - r0];
+      if (pos >= chunk.stop_pos) {
+        continue;
+      }
+
+      if (chunk.ok &&
+          DecodeDeflateEquivalentStarts(m_state->ptr, m_state->len,
+                                        chunk.start_pos, pos) &&
+          (chunk.resolve_b.empty() || (m_window_len == 32768))) {
+        uint8_t* a = chunk.dst_a.data();
+        const uint8_t* b = chunk.resolve_b.data();
+        for (size_t j = 0; j < chunk.resolve_b.size(); j++) {
+          if (a[j] != b[j]) {
+            a[j] = m_window[(((b[j] - a[j] - 1) & 0xFF) << 8) | a[j]];
+          }
+        }
+        std::string error_message = Emit(a, chunk.dst_a.size());
+        if (!error_message.empty()) {
+          return error_message;
+        }
+      } else {
+        chunk.final = false;
+        std::string error_message = DecodeSerially(pos, chunk.stop_pos, chunk);
+        if (!error_message.empty()) {
+          return error_message;
+        }
+      }
+      pos = chunk.end_pos;
+      final = chunk.final;
+      *end_index = chunk.end_index;
+
+      chunk.dst_a.clear();
+      chunk.dst_a.shrink_to_fit();
+      chunk.resolve_b.clear();
+      chunk.resolve_b.shrink_to_fit();
+    }
+  }
+  return final ? "" : DecodeDeflate_UnexpectedEndOfFile;
+}
+
+// DecodeDeflateReadAll returns the entire input, either in its own I/O buffer
+// or after copying it into storage.
+std::string  //
+DecodeDeflateReadAll(sync_io::Input& input,
+                     std::vector<uint8_t>& storage,
+                     wuffs_base__slice_u8* all) {
+  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
+  if (io_buf && io_buf->meta.closed) {
+    *all = io_buf->reader_slice();
+    return "";
+  }
+  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
+  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
+  if (!io_buf) {
+    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);
+    fallback_io_buf =
+        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);
+    io_buf = &fallback_io_buf;
+  }
+  while (true) {
+    storage.insert(storage.end(), io_buf->reader_pointer(),
+                   io_buf->reader_pointer() + io_buf->reader_length());
+    io_buf->meta.ri = io_buf->meta.wi;
+    if (io_buf->meta.closed) {
+      break;
+    }
+    io_buf->compact();
+    std::string error_message = input.CopyIn(io_buf);
+    if (!error_message.empty()) {
+      return error_message;
+    }
+  }
+  *all = wuffs_base__make_slice_u8(storage.data(), storage.size());
+  return "";
+}
+
+// DecodeDeflateMessage returns the message (without the leading '#') of a
+// Wuffs error status, such as wuffs_gzip__error__bad_checksum.
+std::string  //
+DecodeDeflateMessage(const char* status_repr) {
+  return wuffs_base__make_status(status_repr).message();
+}
+
+// DecodeDeflateHeaderLength returns the length of the gzip or zlib header at
+// the start of s, or 0 if it is invalid (setting error_message). The error
+// messages match what the (single-threaded) gzip and zlib decoders report.
+size_t  //
+DecodeDeflateHeaderLength(wuffs_base__slice_u8 s,
+                          uint32_t framing,
+                          std::string& error_message) {
+  if (framing == 0) {
+    return 0;
+  } else if (framing == WUFFS_BASE__FOURCC__ZLIB) {
+    if (s.len < 2) {
+      error_message = DecodeDeflate_UnexpectedEndOfFile;
+      return 0;
+    } else if ((s.ptr[0] & 0x0F) != 0x08) {
+      error_message =
+          DecodeDeflateMessage(wuffs_zlib__error__bad_compression_method);
+      return 0;
+    } else if ((s.ptr[0] >> 4) > 7) {
+      error_message =
+          DecodeDeflateMessage(wuffs_zlib__error__bad_compression_window_size);
+      return 0;
+    } else if ((((s.ptr[0] << 8) | s.ptr[1]) % 31) != 0) {
+      error_message = DecodeDeflateMessage(wuffs_zlib__error__bad_parity_check);
+      return 0;
+    } else if (s.ptr[1] & 0x20) {
+      // Preset dictionaries are not supported.
+      error_message = DecodeDeflate_UnsupportedFraming;
+      return 0;
+    }
+    return 2;
+  } else if (framing != WUFFS_BASE__FOURCC__GZ) {
+    error_message = DecodeDeflate_UnsupportedFraming;
+    return 0;
+  }
+
+  // Check the leading bytes before the length, like the gzip decoder does.
+  if (((s.len > 0) && (s.ptr[0] != 0x1F)) ||
+      ((s.len > 1) && (s.ptr[1] != 0x8B))) {
+    error_message = DecodeDeflateMessage(wuffs_gzip__error__bad_header);
+    return 0;
+  } else if ((s.len > 2) && (s.ptr[2] != 0x08)) {
+    error_message =
+        DecodeDeflateMessage(wuffs_gzip__error__bad_compression_method);
+    return 0;
+  } else if (s.len < 10) {
+    error_message = DecodeDeflate_UnexpectedEndOfFile;
+    return 0;
+  }
+  uint8_t flags = s.ptr[3];
+  size_t i = 10;
+  if (flags & 0x04) {  // FEXTRA.
+    if ((s.len - i) < 2) {
+      error_message = DecodeDeflate_UnexpectedEndOfFile;
+      return 0;
+    }
+    i += 2 + wuffs_base__peek_u16le__no_bounds_check(s.ptr + i);
+  }
+  for (uint8_t f = 0x08; f <= 0x10; f <<= 1) {  // FNAME and FCOMMENT.
+    if (flags & f) {
+      while ((i < s.len) && (s.ptr[i] != 0)) {
+        i++;
+      }
+      i++;
+    }
+  }
+  if (flags & 0x02) {  // FHCRC.
+    i += 2;
+  }
+  if (i > s.len) {
+    error_message = DecodeDeflate_UnexpectedEndOfFile;
+    return 0;
+  } else if ((flags & 0xE0) != 0) {
+    error_message = DecodeDeflateMessage(wuffs_gzip__error__bad_encoding_flags);
+    return 0;
+  }
+  return i;
+}
+
+bool  //
+DecodeDeflateIgnoreChecksum(wuffs_base__slice_u32 quirks) {
+  for (size_t i = 0; i < quirks.len; i++) {
+    if (quirks.ptr[i] == WUFFS_BASE__QUIRK_IGNORE_CHECKSUM) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// DecodeDeflateCheckTrailer checks the gzip or zlib trailer, of trailer_len
+// bytes, against the checksum and length of the decoded output. Like
+// DecodeDeflateHeaderLength, its error messages match the gzip and zlib
+// decoders'.
+std::string  //
+DecodeDeflateCheckTrailer(const uint8_t* trailer,
+                          size_t trailer_len,
+                          uint32_t framing,
+                          bool ignore_checksum,
+                          uint32_t checksum,
+                          uint64_t num_dst_bytes) {
+  if (framing == WUFFS_BASE__FOURCC__GZ) {
+    if (trailer_len < 8) {
+      return DecodeDeflate_UnexpectedEndOfFile;
+    } else if (!ignore_checksum &&
+               ((checksum !=
+                 wuffs_base__peek_u32le__no_bounds_check(trailer + 0)) ||
+                (((uint32_t)(num_dst_bytes)) !=
+                 wuffs_base__peek_u32le__no_bounds_check(trailer + 4)))) {
+      return DecodeDeflateMessage(wuffs_gzip__error__bad_checksum);
+    }
+  } else if (framing == WUFFS_BASE__FOURCC__ZLIB) {
+    if (trailer_len < 4) {
+      return DecodeDeflate_UnexpectedEndOfFile;
+    } else if (!ignore_checksum &&
+               (checksum !=
+                wuffs_base__peek_u32be__no_bounds_check(trailer))) {
+      return DecodeDeflateMessage(wuffs_zlib__error__bad_checksum);
+    }
+  }
+  return "";
+}
+
+DecodeDeflateResult  //
+DecodeDeflate0(DecodeDeflateCallbacks& callbacks,
+               sync_io::Input& input,
+               uint32_t framing,
+               uint32_t num_threads,
+               bool ignore_checksum) {
+  std::vector<uint8_t> storage;
+  wuffs_base__slice_u8 all = wuffs_base__empty_slice_u8();
+  std::string error_message = DecodeDeflateReadAll(input, storage, &all);
+  if (!error_message.empty()) {
+    return DecodeDeflateResult(std::move(error_message), 0);
+  }
+  size_t header_len = DecodeDeflateHeaderLength(all, framing, error_message);
+  if (!error_message.empty()) {
+    return DecodeDeflateResult(std::move(error_message), 0);
+  }
+
+  DecodeDeflateParallel p(callbacks, all.ptr + header_len,
+                          all.len - header_len, framing, ignore_checksum);
+  size_t end_index = 0;
+  error_message = p.Decode(num_threads, &end_index);
+  if (!error_message.empty()) {
+    return DecodeDeflateResult(std::move(error_message), p.num_dst_bytes());
+  }
+
+  // Check the gzip or zlib trailer.
+  error_message = DecodeDeflateCheckTrailer(
+      all.ptr + header_len + end_index, all.len - header_len - end_index,
+      framing, ignore_checksum, p.checksum(), p.num_dst_bytes());
+  return DecodeDeflateResult(std::move(error_message), p.num_dst_bytes());
+}
+
+}  // namespace
+
+DecodeDeflateResult  //
+DecodeDeflate(DecodeDeflateCallbacks& callbacks,
+              sync_io::Input& input,
+              uint32_t framing,
+              uint32_t num_threads,
+              wuffs_base__slice_u32 quirks) {
+  bool ignore_checksum = DecodeDeflateIgnoreChecksum(quirks);
+  DecodeDeflateResult result =
+      (num_threads <= 1)
+          ? DecodeDeflateSerial(callbacks, input, framing, ignore_checksum)
+          : DecodeDeflate0(callbacks, input, framing, num_threads,
+                           ignore_checksum);
+  callbacks.Done(result, input);
+  return result;
+}
+
+// --------
+
+namespace {
+
+// DecodeGzipMember is a complete gzip member's compressed and decoded bytes.
+struct DecodeGzipMember {
+  std::vector<uint8_t> src;
+  std::vector<uint8_t> dst;
+  std::string error_message;
+};
+
+// DecodeGzipMemberLength returns the total (compressed) length of the gzip
+// member whose header is at the start of s, if that header's FEXTRA field has
+// a BGZF "BC" subfield, or 0 if it does not.
+size_t  //
+DecodeGzipMemberLength(wuffs_base__slice_u8 s) {
+  if ((s.len < 12) || !(s.ptr[3] & 0x04)) {
+    return 0;
+  }
+  size_t n = wuffs_base__peek_u16le__no_bounds_check(s.ptr + 10);
+  if (n > (s.len - 12)) {
+    return 0;
+  }
+  const uint8_t* p = s.ptr + 12;
+  while (n >= 4) {
+    size_t subfield_len = wuffs_base__peek_u16le__no_bounds_check(p + 2);
+    if (subfield_len > (n - 4)) {
+      break;
+    } else if ((p[0] == 'B') && (p[1] == 'C') && (subfield_len == 2)) {
+      return 1 + (size_t)wuffs_base__peek_u16le__no_bounds_check(p + 4);
+    }
+    p += 4 + subfield_len;
+    n -= 4 + subfield_len;
+  }
+  return 0;
+}
+
+// DecodeGzipMemberDecode decodes m.src into m.dst, which has already been
+// sized (from the member's ISIZE) to fit the decoded bytes plus one.
+void  //
+DecodeGzipMemberDecode(wuffs_gzip__decoder* dec,
+                       DecodeGzipMember& m,
+                       bool ignore_checksum) {
+  wuffs_base__status status =
+      dec->initialize(sizeof__wuffs_gzip__decoder(), WUFFS_VERSION,
+                      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);
+  if (!status.is_ok()) {
+    m.error_message = status.message();
+    return;
+  }
+  dec->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, ignore_checksum);
+
+  wuffs_base__io_buffer src =
+      wuffs_base__ptr_u8__reader(m.src.data(), m.src.size(), true);
+  uint8_t work_array[1];
+  size_t n = 0;
+  while (true) {
+    wuffs_base__io_buffer dst =
+        wuffs_base__ptr_u8__writer(m.dst.data() + n, m.dst.size() - n);
+    status = dec->transform_io(&dst, &src,
+                               wuffs_base__make_slice_u8(work_array, 0));
+    n += dst.meta.wi;
+    if (status.is_ok()) {
+      break;
+    } else if (status.repr == wuffs_base__suspension__short_write) {
+      // The member decodes to more than its ISIZE.
+      if (!ignore_checksum) {
+        m.error_message = DecodeDeflate_BadChecksum;
+        return;
+      }
+      m.dst.resize(2 * m.dst.size());
+    } else if (status.repr == wuffs_base__suspension__short_read) {
+      // The member is longer than its "BC" subfield says.
+      m.error_message = DecodeDeflate_BadHeader;
+      return;
+    } else {
+      m.error_message = status.message();
+      return;
+    }
+  }
+  if (src.meta.ri != src.meta.wi) {
+    // The member is shorter than its "BC" subfield says.
+    m.error_message = DecodeDeflate_BadHeader;
+    return;
+  }
+  m.dst.resize(n);
+}
+
+// DecodeGzipMemberSerially decodes m.src, streaming its output through the
+// dst scratch buffer to callbacks.Append. For a bad or truncated member, this
+// gives the same output and error message as single-threaded decoding.
+std::string  //
+DecodeGzipMemberSerially(DecodeDeflateCallbacks& callbacks,
+                         wuffs_gzip__decoder* dec,
+                         DecodeGzipMember& m,
+                         bool ignore_checksum,
+                         wuffs_base__io_buffer* dst,
+                         uint64_t* num_dst_bytes) {
+  wuffs_base__status status =
+      dec->initialize(sizeof__wuffs_gzip__decoder(), WUFFS_VERSION,
+                      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);
+  if (!status.is_ok()) {
+    return status.message();
+  }
+  dec->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, ignore_checksum);
+  sync_io::MemoryInput member_input(m.src.data(), m.src.size());
+  IOBuffer* member_io_buf = member_input.BringsItsOwnIOBuffer();
+  std::string error_message = DecodeDeflateStream(
+      callbacks, member_input, member_io_buf,
+      dec->upcast_as__wuffs_base__io_transformer(), dst, num_dst_bytes);
+  if (error_message.empty() && (member_io_buf->reader_length() > 0)) {
+    // The member is shorter than its "BC" subfield says.
+    error_message = DecodeDeflate_BadHeader;
+  }
+  return error_message;
+}
+
+// DecodeGzipMembersFlush decodes the batch of members, in parallel, and then
+// passes their output, in order, to callbacks.Append. The first bad member is
+// decoded again, serially, so that its valid prefix is also passed on.
+std::string  //
+DecodeGzipMembersFlush(DecodeDeflateCallbacks& callbacks,
+                       std::vector<wuffs_gzip__decoder::unique_ptr>& decs,
+                       std::vector<DecodeGzipMember>& batch,
+                       bool ignore_checksum,
+                       wuffs_base__io_buffer* dst,
+                       uint64_t* num_dst_bytes) {
+  size_t num_threads = (decs.size() < batch.size()) ? decs.size()  //
+                                                    : batch.size();
+  if (num_threads == 1) {
+    DecodeGzipMemberDecode(decs[0].get(), batch[0], ignore_checksum);
+  } else if (num_threads > 1) {
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; t++) {
+      threads.emplace_back(
+          [&decs, &batch, ignore_checksum, num_threads, t]() {
+            for (size_t i = t; i < batch.size(); i += num_threads) {
+              DecodeGzipMemberDecode(decs[t].get(), batch[i],
+                                     ignore_checksum);
+            }
+          });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+  }
+
+  for (auto& m : batch) {
+    if (!m.error_message.empty()) {
+      std::string error_message = DecodeGzipMemberSerially(
+          callbacks, decs[0].get(), m, ignore_checksum, dst, num_dst_bytes);
+      return error_message.empty() ? std::move(m.error_message)
+                                   : error_message;
+    } else if (!m.dst.empty()) {
+      std::string error_message = callbacks.Append(m.dst.data(), m.dst.size());
+      *num_dst_bytes += m.dst.size();
+      if (!error_message.empty()) {
+        return error_message;
+      }
+    }
+  }
+  batch.clear();
+  return "";
+}
+
+DecodeDeflateResult  //
+DecodeGzipMembers0(DecodeDeflateCallbacks& callbacks,
+                   sync_io::Input& input,
+                   uint32_t num_threads,
+                   bool ignore_checksum) {
+  std::vector<wuffs_gzip__decoder::unique_ptr> decs;
+  for (uint32_t t = 0; (t == 0) || (t < num_threads); t++) {
+    decs.push_back(wuffs_gzip__decoder::alloc());
+    if (!decs.back()) {
+      return DecodeDeflateResult(DecodeDeflate_OutOfMemory, 0);
+    }
+  }
+
+  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
+  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
+  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
+  if (!io_buf) {
+    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);
+    fallback_io_buf =
+        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);
+    io_buf = &fallback_io_buf;
+  }
+
+  std::unique_ptr<uint8_t[]> dst_array(
+      new uint8_t[DecodeDeflateScratchLength]);
+  wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(
+      dst_array.get(), DecodeDeflateScratchLength);
+  std::vector<DecodeGzipMember> batch;
+  uint64_t batch_len = 0;
+  uint64_t num_dst_bytes = 0;
+
+  for (bool first = true; true; first = false) {
+    // Read the next member's header, which has to fit in io_buf. Reaching the
+    // end of the input (other than before the first member) is not an error.
+    std::string error_message;
+    size_t header_len = 0;
+    while (true) {
+      if (!first && (io_buf->reader_length() == 0) && io_buf->meta.closed) {
+        break;
+      }
+      header_len = DecodeDeflateHeaderLength(
+          io_buf->reader_slice(), WUFFS_BASE__FOURCC__GZ, error_message);
+      if (error_message.empty() ||
+          (error_message != DecodeDeflate_UnexpectedEndOfFile) ||
+          ((io_buf->meta.ri == 0) && (io_buf->meta.wi == io_buf->data.len))) {
+        break;
+      }
+      error_message = DecodeDeflateFill(input, io_buf);
+      if (!error_message.empty()) {
+        break;
+      }
+    }
+    if (!error_message.empty() || (header_len == 0)) {
+      std::string flush_error_message = DecodeGzipMembersFlush(
+          callbacks, decs, batch, ignore_checksum, &dst, &num_dst_bytes);
+      return DecodeDeflateResult(flush_error_message.empty()
+                                     ? std::move(error_message)
+                                     : std::move(flush_error_message),
+                                 num_dst_bytes);
+    }
+
+    size_t member_len = (num_threads > 1)
+                            ? DecodeGzipMemberLength(io_buf->reader_slice())
+                            : 0;
+    DecodeGzipMember m;
+    if (member_len > 0) {
+      if (member_len < (header_len + 8)) {
+        error_message = DecodeDeflate_BadHeader;
+      }
+      // Read ahead the whole member.
+      m.src.reserve(member_len);
+      while (error_message.empty() && (m.src.size() < member_len)) {
+        size_t n = member_len - m.src.size();
+        if (n > io_buf->reader_length()) {
+          n = io_buf->reader_length();
+        }
+        m.src.insert(m.src.end(), io_buf->reader_pointer(),
+                     io_buf->reader_pointer() + n);
+        io_buf->meta.ri += n;
+        if (m.src.size() < member_len) {
+          error_message = DecodeDeflateFill(input, io_buf);
+        }
+      }
+      if (!error_message.empty()) {
+        // Decode what there is of this (truncated) member, after the batch
+        // so far, as single-threaded decoding would have.
+        std::string other_error_message = DecodeGzipMembersFlush(
+            callbacks, decs, batch, ignore_checksum, &dst, &num_dst_bytes);
+        if (other_error_message.empty() && (m.src.size() >= header_len)) {
+          other_error_message =
+              DecodeGzipMemberSerially(callbacks, decs[0].get(), m,
+                                       ignore_checksum, &dst, &num_dst_bytes);
+        }
+        return DecodeDeflateResult(other_error_message.empty()
+                                       ? std::move(error_message)
+                                       : std::move(other_error_message),
+                                   num_dst_bytes);
+      }
+
+      uint64_t isize = wuffs_base__peek_u32le__no_bounds_check(
+          m.src.data() + member_len - 4);
+      if (isize <= WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH) {
+        m.dst.resize(isize + 1);
+        batch.push_back(std::move(m));
+        batch_len += isize;
+        if (batch_len >=
+            (WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH * decs.size())) {
+          error_message =
+              DecodeGzipMembersFlush(callbacks, decs, batch, ignore_checksum,
+                                     &dst, &num_dst_bytes);
+          batch_len = 0;
+          if (!error_message.empty()) {
+            return DecodeDeflateResult(std::move(error_message),
+                                       num_dst_bytes);
+          }
+        }
+        continue;
+      }
+    }
+
+    // Decode this member single-threaded, after the batch so far.
+    error_message = DecodeGzipMembersFlush(
+        callbacks, decs, batch, ignore_checksum, &dst, &num_dst_bytes);
+    batch_len = 0;
+    if (!error_message.empty()) {
+      return DecodeDeflateResult(std::move(error_message), num_dst_bytes);
+    }
+    if (member_len == 0) {
+      wuffs_base__status status = decs[0]->initialize(
+          sizeof__wuffs_gzip__decoder(), WUFFS_VERSION,
+          WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);
+      if (!status.is_ok()) {
+        return DecodeDeflateResult(status.message(), num_dst_bytes);
+      }
+      decs[0]->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM,
+                                 ignore_checksum);
+      error_message = DecodeDeflateStream(
+          callbacks, input, io_buf,
+          decs[0]->upcast_as__wuffs_base__io_transformer(), &dst,
+          &num_dst_bytes);
+    } else {
+      error_message = DecodeGzipMemberSerially(
+          callbacks, decs[0].get(), m, ignore_checksum, &dst, &num_dst_bytes);
+    }
+    if (!error_message.empty()) {
+      return DecodeDeflateResult(std::move(error_message), num_dst_bytes);
+    }
+  }
+}
+
+}  // namespace
+
+DecodeDeflateResult  //
+DecodeGzipMembers(DecodeDeflateCallbacks& callbacks,
+                  sync_io::Input& input,
+                  uint32_t num_threads,
+                  wuffs_base__slice_u32 quirks) {
+  DecodeDeflateResult result = DecodeGzipMembers0(
+      callbacks, input, num_threads, DecodeDeflateIgnoreChecksum(quirks));
+  callbacks.Done(result, input);
+  return result;
+}
+
+// --------
+
+DecodeDeflateBatchCallbacks::~DecodeDeflateBatchCallbacks() {}
+
+namespace {
+
+// DecodeDeflateBatchDstLength is the length of each lane's dst buffer. When
+// it is full, all but its final 32 KiB is passed to callbacks.Append. Keeping
+// that history in dst means that decode_interleaved can always copy from it.
+const size_t DecodeDeflateBatchDstLength = 128 * 1024;
+
+// DecodeDeflateBatchLane decodes one input at a time. DecodeDeflateBatch
+// interleaves two lanes.
+struct DecodeDeflateBatchLane {
+  DecodeDeflateBatchLane();
+
+  std::string Start(size_t i,
+                    wuffs_base__slice_u8 input,
+                    uint32_t framing0,
+                    bool ignore_checksum0);
+  std::string Advance(DecodeDeflateBatchCallbacks& callbacks);
+  std::string Flush(DecodeDeflateBatchCallbacks& callbacks, size_t keep);
+
+  wuffs_deflate__decoder::unique_ptr dec;
+  wuffs_crc32__ieee_hasher::unique_ptr crc32;
+  wuffs_adler32__hasher::unique_ptr adler32;
+  std::unique_ptr<uint8_t[]> dst_array;
+  wuffs_base__io_buffer dst;
+  wuffs_base__io_buffer src;
+
+  size_t index;
+  uint32_t framing;
+  bool ignore_checksum;
+  // active is whether the lane is decoding an input. ready is whether dec is
+  // suspended with a "$ready to interleave" status.
+  bool active;
+  bool ready;
+  // dst.data.ptr[.. num_appended] has already been passed to Append.
+  size_t num_appended;
+  uint32_t checksum;
+  uint64_t num_dst_bytes;
+};
+
+DecodeDeflateBatchLane::DecodeDeflateBatchLane()
+    : dec(wuffs_deflate__decoder::alloc()),
+      crc32(wuffs_crc32__ieee_hasher::alloc()),
+      adler32(wuffs_adler32__hasher::alloc()),
+      dst_array(new uint8_t[DecodeDeflateBatchDstLength]),
+      dst(wuffs_base__ptr_u8__writer(dst_array.get(),
+                                     DecodeDeflateBatchDstLength)),
+      src(wuffs_base__empty_io_buffer()),
+      index(0),
+      framing(0),
+      ignore_checksum(false),
+      active(false),
+      ready(false),
+      num_appended(0),
+      checksum(0),
+      num_dst_bytes(0) {}
+
+std::string  //
+DecodeDeflateBatchLane::Start(size_t i,
+                              wuffs_base__slice_u8 input,
+                              uint32_t framing0,
+                              bool ignore_checksum0) {
+  index = i;
+  framing = framing0;
+  ignore_checksum = ignore_checksum0;
+  active = false;
+  ready = false;
+  num_appended = 0;
+  checksum = 0;
+  num_dst_bytes = 0;
+  dst.meta.wi = 0;
+
+  std::string error_message;
+  size_t header_len = DecodeDeflateHeaderLength(input, framing, error_message);
+  if (!error_message.empty()) {
+    return error_message;
+  }
+  src = wuffs_base__ptr_u8__reader(input.ptr + header_len,
+                                   input.len - header_len, true);
+
+  wuffs_base__status status =
+      dec->initialize(sizeof__wuffs_deflate__decoder(), WUFFS_VERSION,
+                      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);
+  if (status.is_ok()) {
+    status = crc32->initialize(sizeof__wuffs_crc32__ieee_hasher(),
+                               WUFFS_VERSION, 0);
+  }
+  if (status.is_ok()) {
+    status = adler32->initialize(sizeof__wuffs_adler32__hasher(),
+                                 WUFFS_VERSION, 0);
+  }
+  if (!status.is_ok()) {
+    return status.message();
+  }
+  dec->set_quirk_enabled(WUFFS_DEFLATE__QUIRK_SUSPEND_FOR_INTERLEAVING, true);
+  // Advance resumes with the same dst, which (see Flush) always holds all of
+  // the output so far or its final 32 KiB. The decoder's own copy of that
+  // history would otherwise hold those bytes twice.
+  dec->set_quirk_enabled(WUFFS_DEFLATE__QUIRK_DST_HOLDS_HISTORY, true);
+  active = true;
+  return "";
+}
+
+// Advance runs the lane's decoder until it is ready to interleave (setting
+// ready) or until it is done (clearing active), successfully or otherwise.
+std::string  //
+DecodeDeflateBatchLane::Advance(DecodeDeflateBatchCallbacks& callbacks) {
+  uint8_t work_array[1];
+  ready = false;
+  while (true) {
+    wuffs_base__status status = dec->transform_io(
+        &dst, &src, wuffs_base__make_slice_u8(work_array, 0));
+    if (status.repr == wuffs_deflate__suspension__ready_to_interleave) {
+      ready = true;
+      return "";
+    }
+
+    std::string error_message;
+    if (status.is_ok()) {
+      error_message = Flush(callbacks, 0);
+      if (error_message.empty()) {
+        error_message = DecodeDeflateCheckTrailer(
+            src.reader_pointer(), src.reader_length(), framing,
+            ignore_checksum, checksum, num_dst_bytes);
+      }
+    } else if (status.repr == wuffs_base__suspension__short_write) {
+      error_message = Flush(callbacks, 32768);
+      if (error_message.empty()) {
+        continue;
+      }
+    } else {
+      // Pass on the output before the error, as DecodeDeflate would.
+      error_message = Flush(callbacks, 0);
+      if (error_message.empty()) {
+        error_message = (status.repr == wuffs_base__suspension__short_read)
+                            ? DecodeDeflate_UnexpectedEndOfFile
+                            : status.message();
+      }
+    }
+    active = false;
+    return error_message;
+  }
+}
+
+// Flush passes the not-yet-appended part of dst to callbacks.Append and then
+// moves the final keep bytes of dst (the history) to its start.
+std::string  //
+DecodeDeflateBatchLane::Flush(DecodeDeflateBatchCallbacks& callbacks,
+                              size_t keep) {
+  if (num_appended < dst.meta.wi) {
+    uint8_t* ptr = dst.data.ptr + num_appended;
+    size_t len = dst.meta.wi - num_appended;
+    if (!ignore_checksum) {
+      wuffs_base__slice_u8 s = wuffs_base__make_slice_u8(ptr, len);
+      if (framing == WUFFS_BASE__FOURCC__GZ) {
+        checksum = crc32->update_u32(s);
+      } else if (framing == WUFFS_BASE__FOURCC__ZLIB) {
+        checksum = adler32->update_u32(s);
+      }
+    }
+    num_dst_bytes += len;
+    num_appended = dst.meta.wi;
+    std::string error_message = callbacks.Append(index, ptr, len);
+    if (!error_message.empty()) {
+      return error_message;
+    }
+  }
+  if (keep > dst.meta.wi) {
+    keep = dst.meta.wi;
+  }
+  memmove(dst.data.ptr, dst.data.ptr + dst.meta.wi - keep, keep);
+  dst.meta.wi = keep;
+  num_appended = keep;
+  return "";
+}
 
-        case WUFFS_BASE__TOKEN__VBC__INLINE_INTEGER_UNSIGNED: {
-          if (token.continued()) {
-            extension_category =
-                WUFFS_BASE__TOKEN__VBC__INLINE_INTEGER_UNSIGNED;
-            extension_detail = vbd;
-            continue;
-          }
-          ret_error_message = callbacks.AppendU64(vbd);
-          goto parsed_a_value;
-        }
+}  // namespace
+
+std::vector<DecodeDeflateResult>  //
+DecodeDeflateBatch(DecodeDeflateBatchCallbacks& callbacks,
+                   const std::vector<wuffs_base__slice_u8>& inputs,
+                   uint32_t framing,
+                   wuffs_base__slice_u32 quirks) {
+  bool ignore_checksum = DecodeDeflateIgnoreChecksum(quirks);
+  std::vector<DecodeDeflateResult> results(inputs.size(),
+                                           DecodeDeflateResult("", 0));
+  DecodeDeflateBatchLane lanes[2];
+  for (auto& lane : lanes) {
+    if (!lane.dec || !lane.crc32 || !lane.adler32) {
+      for (auto& result : results) {
+        result.error_message = DecodeDeflate_OutOfMemory;
       }
+      return results;
+    }
+  }
 
-      if (token.value_major() == WUFFS_CBOR__TOKEN_VALUE_MAJOR) {
-        uint64_t value_minor = token.value_minor();
-        if (value_minor & WUFFS_CBOR__TOKEN_VALUE_MINOR__MINUS_1_MINUS_X) {
-          if (token_len == 9) {
-            ret_error_message = callbacks.AppendMinus1MinusX(
-                wuffs_base__peek_u64be__no_bounds_check(token_ptr + 1));
-            goto parsed_a_value;
+  size_t next = 0;
+  while (true) {
+    // Run each lane until it is ready to interleave, starting the next input
+    // whenever a lane is done.
+    for (auto& lane : lanes) {
+      while (!lane.ready) {
+        if (!lane.active) {
+          if (next >= inputs.size()) {
+            break;
           }
-        } else if (value_minor & WUFFS_CBOR__TOKEN_VALUE_MINOR__SIMPLE_VALUE) {
-          ret_error_message =
-              callbacks.AppendCborSimpleValue(static_cast<uint8_t>(
-                  value_minor & WUFFS_CBOR__TOKEN_VALUE_MINOR__DETAIL_MASK));
-          goto parsed_a_value;
-        } else if (value_minor & WUFFS_CBOR__TOKEN_VALUE_MINOR__TAG) {
-          if (token.continued()) {
-            extension_category = EXT_CAT__CBOR_TAG;
-            extension_detail =
-                value_minor & WUFFS_CBOR__TOKEN_VALUE_MINOR__DETAIL_MASK;
+          size_t i = next++;
+          std::string error_message =
+              lane.Start(i, inputs[i], framing, ignore_checksum);
+          if (!error_message.empty()) {
+            results[i] = DecodeDeflateResult(std::move(error_message), 0);
             continue;
           }
-          ret_error_message = callbacks.AppendCborTag(
-              value_minor & WUFFS_CBOR__TOKEN_VALUE_MINOR__DETAIL_MASK);
-          if (!ret_error_message.empty()) {
-            goto done;
-          }
-          continue;
+        }
+        std::string error_message = lane.Advance(callbacks);
+        if (!lane.active) {
+          results[lane.index] = DecodeDeflateResult(std::move(error_message),
+                                                    lane.num_dst_bytes);
         }
       }
+    }
 
-    fail:
-      ret_error_message =
-          "wuffs_aux::CborDecoder: internal error: unexpected token";
-      goto done;
+    if (lanes[0].ready && lanes[1].ready) {
+      wuffs_base__status status = lanes[0].dec->decode_interleaved(
+          &lanes[0].dst, &lanes[0].src, lanes[1].dec.get(), &lanes[1].dst,
+          &lanes[1].src);
+      if (!status.is_ok()) {
+        for (auto& lane : lanes) {
+          results[lane.index] =
+              DecodeDeflateResult(status.message(), lane.num_dst_bytes);
+          lane.active = false;
+        }
+      }
+    } else if (!lanes[0].ready && !lanes[1].ready) {
+      break;
+    }
+    // Resume the ready lanes. A lane that has not just been interleaved
+    // decodes the rest of its block by itself.
+    lanes[0].ready = false;
+    lanes[1].ready = false;
+  }
+  return results;
+}
 
-    parsed_a_value:
-      if (!ret_error_message.empty() || (depth == 0)) {
-        goto done;
+// --------
+
+DecodeDeflateCheckpoint::DecodeDeflateCheckpoint()
+    : dst_pos(0), src_pos(0), pending_bits(0), num_pending_bits(0) {}
+
+DecodeDeflateIndex::DecodeDeflateIndex()
+    : framing(0), spacing(0), num_dst_bytes(0) {}
+
+const DecodeDeflateCheckpoint*  //
+DecodeDeflateIndex::Find(uint64_t dst_pos) const {
+  // Binary search for the number of checkpoints at or before dst_pos.
+  size_t lo = 0;
+  size_t hi = checkpoints.size();
+  while (lo < hi) {
+    size_t mid = lo + ((hi - lo) / 2);
+    if (checkpoints[mid].dst_pos <= dst_pos) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return (lo > 0) ? &checkpoints[lo - 1] : nullptr;
+}
+
+namespace {
+
+void  //
+DecodeDeflateAppendLE(std::string& s, uint64_t x, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    s.push_back((char)(uint8_t)(x >> (8 * i)));
+  }
+}
+
+}  // namespace
+
+std::string  //
+DecodeDeflateIndex::Serialize() const {
+  std::string s("WDIX");
+  DecodeDeflateAppendLE(s, framing, 4);
+  DecodeDeflateAppendLE(s, spacing, 8);
+  DecodeDeflateAppendLE(s, num_dst_bytes, 8);
+  DecodeDeflateAppendLE(s, checkpoints.size(), 4);
+  for (const auto& c : checkpoints) {
+    size_t history_len = (c.history.size() < 32768) ? c.history.size() : 32768;
+    DecodeDeflateAppendLE(s, c.dst_pos, 8);
+    DecodeDeflateAppendLE(s, c.src_pos, 8);
+    DecodeDeflateAppendLE(s, c.num_pending_bits & 7, 1);
+    DecodeDeflateAppendLE(s, c.pending_bits, 1);
+    DecodeDeflateAppendLE(s, history_len, 2);
+    s.append(c.history, c.history.size() - history_len, history_len);
+  }
+  return s;
+}
+
+std::string  //
+DecodeDeflateIndex::Parse(const uint8_t* ptr, size_t len) {
+  framing = 0;
+  spacing = 0;
+  num_dst_bytes = 0;
+  checkpoints.clear();
+
+  if ((len < 28) || (memcmp(ptr, "WDIX", 4) != 0)) {
+    return DecodeDeflate_BadIndex;
+  }
+  uint32_t f = wuffs_base__peek_u32le__no_bounds_check(ptr + 4);
+  uint64_t s = wuffs_base__peek_u64le__no_bounds_check(ptr + 8);
+  uint64_t n = wuffs_base__peek_u64le__no_bounds_check(ptr + 16);
+  uint32_t num_checkpoints = wuffs_base__peek_u32le__no_bounds_check(ptr + 24);
+  ptr += 28;
+  len -= 28;
+
+  std::vector<DecodeDeflateCheckpoint> cs;
+  for (uint32_t i = 0; i < num_checkpoints; i++) {
+    if (len < 20) {
+      return DecodeDeflate_BadIndex;
+    }
+    DecodeDeflateCheckpoint c;
+    c.dst_pos = wuffs_base__peek_u64le__no_bounds_check(ptr + 0);
+    c.src_pos = wuffs_base__peek_u64le__no_bounds_check(ptr + 8);
+    c.num_pending_bits = ptr[16];
+    c.pending_bits = ptr[17];
+    size_t history_len = wuffs_base__peek_u16le__no_bounds_check(ptr + 18);
+    ptr += 20;
+    len -= 20;
+    if ((c.num_pending_bits >= 8) ||
+        ((c.pending_bits >> c.num_pending_bits) != 0) ||
+        (history_len > 32768) || (history_len > len) ||
+        (history_len > c.dst_pos) ||
+        (!cs.empty() && (cs.back().dst_pos > c.dst_pos))) {
+      return DecodeDeflate_BadIndex;
+    }
+    c.history.assign((const char*)ptr, history_len);
+    ptr += history_len;
+    len -= history_len;
+    cs.push_back(std::move(c));
+  }
+  if (len != 0) {
+    return DecodeDeflate_BadIndex;
+  }
+
+  framing = f;
+  spacing = s;
+  num_dst_bytes = n;
+  checkpoints = std::move(cs);
+  return "";
+}
+
+const char DecodeDeflate_BadCheckpoint[] =  //
+    "wuffs_aux::DecodeDeflate: bad checkpoint";
+const char DecodeDeflate_BadIndex[] =  //
+    "wuffs_aux::DecodeDeflate: bad index";
+
+namespace {
+
+DecodeDeflateResult  //
+DecodeDeflateWithIndex0(DecodeDeflateCallbacks& callbacks,
+                        sync_io::Input& input,
+                        DecodeDeflateIndex& index,
+                        uint32_t framing,
+                        uint64_t spacing,
+                        bool ignore_checksum) {
+  index = DecodeDeflateIndex();
+  index.framing = framing;
+  index.spacing = spacing;
+
+  wuffs_deflate__decoder::unique_ptr dec = wuffs_deflate__decoder::alloc();
+  wuffs_crc32__ieee_hasher::unique_ptr crc32 =
+      wuffs_crc32__ieee_hasher::alloc();
+  wuffs_adler32__hasher::unique_ptr adler32 = wuffs_adler32__hasher::alloc();
+  if (!dec || !crc32 || !adler32) {
+    return DecodeDeflateResult(DecodeDeflate_OutOfMemory, 0);
+  }
+  dec->set_quirk_enabled(WUFFS_DEFLATE__QUIRK_SUSPEND_AT_BLOCK_BOUNDARIES,
+                         true);
+
+  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
+  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
+  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
+  if (!io_buf) {
+    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);
+    fallback_io_buf =
+        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);
+    io_buf = &fallback_io_buf;
+  }
+  uint64_t src_pos0 = io_buf->reader_position();
+
+  // Skip the gzip or zlib header, which has to fit in io_buf.
+  while (true) {
+    std::string error_message;
+    size_t header_len = DecodeDeflateHeaderLength(io_buf->reader_slice(),
+                                                  framing, error_message);
+    if (error_message.empty()) {
+      io_buf->meta.ri += header_len;
+      break;
+    } else if ((error_message != DecodeDeflate_UnexpectedEndOfFile) ||
+               ((io_buf->meta.ri == 0) &&
+                (io_buf->meta.wi == io_buf->data.len))) {
+      return DecodeDeflateResult(std::move(error_message), 0);
+    }
+    error_message = DecodeDeflateFill(input, io_buf);
+    if (!error_message.empty()) {
+      return DecodeDeflateResult(std::move(error_message), 0);
+    }
+  }
+  index.checkpoints.push_back(DecodeDeflateCheckpoint());
+  index.checkpoints.back().src_pos = io_buf->reader_position() - src_pos0;
+
+  // dst holds (at least) the most recent 32 KiB of output, as history for
+  // the checkpoints. That history is also valid history for dec.
+  std::unique_ptr<uint8_t[]> dst_array(new uint8_t[3 * 32768]);
+  wuffs_base__io_buffer dst =
+      wuffs_base__ptr_u8__writer(dst_array.get(), 3 * 32768);
+  uint8_t work_array[1];
+  uint32_t checksum = 0;
+
+  while (true) {
+    size_t wi0 = dst.meta.wi;
+    wuffs_base__status status = dec->transform_io(
+        &dst, io_buf, wuffs_base__make_slice_u8(work_array, 0));
+    if (dst.meta.wi > wi0) {
+      wuffs_base__slice_u8 s =
+          wuffs_base__make_slice_u8(dst.data.ptr + wi0, dst.meta.wi - wi0);
+      if (framing == WUFFS_BASE__FOURCC__GZ) {
+        checksum = crc32->update_u32(s);
+      } else if (framing == WUFFS_BASE__FOURCC__ZLIB) {
+        checksum = adler32->update_u32(s);
+      }
+      index.num_dst_bytes += s.len;
+      std::string error_message = callbacks.Append(s.ptr, s.len);
+      if (!error_message.empty()) {
+        return DecodeDeflateResult(std::move(error_message),
+                                   index.num_dst_bytes);
       }
     }
-  } while (false);
 
-done:
-  DecodeCborResult result(
-      std::move(ret_error_message),
-      wuffs_base__u64__sat_add(io_buf->meta.pos, cursor_index));
-  callbacks.Done(result, input, *io_buf);
+    if (status.is_ok()) {
+      break;
+    } else if (status.repr == wuffs_deflate__suspension__block_boundary) {
+      if ((index.num_dst_bytes - index.checkpoints.back().dst_pos) >= spacing) {
+        size_t history_len = (dst.meta.wi < 32768) ? dst.meta.wi : 32768;
+        DecodeDeflateCheckpoint c;
+        c.dst_pos = index.num_dst_bytes;
+        c.src_pos = io_buf->reader_position() - src_pos0;
+        c.pending_bits = dec->pending_bits();
+        c.num_pending_bits = dec->num_pending_bits();
+        c.history.assign(
+            (const char*)(dst.data.ptr + dst.meta.wi - history_len),
+            history_len);
+        index.checkpoints.push_back(std::move(c));
+      }
+    } else if (status.repr == wuffs_base__suspension__short_read) {
+      std::string error_message = DecodeDeflateFill(input, io_buf);
+      if (!error_message.empty()) {
+        return DecodeDeflateResult(std::move(error_message),
+                                   index.num_dst_bytes);
+      }
+    } else if (status.repr != wuffs_base__suspension__short_write) {
+      return DecodeDeflateResult(status.message(), index.num_dst_bytes);
+    }
+
+    if (dst.meta.wi > (2 * 32768)) {
+      memmove(dst.data.ptr, dst.data.ptr + dst.meta.wi - 32768, 32768);
+      dst.meta.wi = 32768;
+    }
+  }
+
+  // Check the gzip or zlib trailer.
+  size_t trailer_len = (framing == WUFFS_BASE__FOURCC__GZ)     ? 8
+                       : (framing == WUFFS_BASE__FOURCC__ZLIB) ? 4
+                                                               : 0;
+  while (io_buf->reader_length() < trailer_len) {
+    std::string error_message = DecodeDeflateFill(input, io_buf);
+    if (!error_message.empty()) {
+      return DecodeDeflateResult(std::move(error_message),
+                                 index.num_dst_bytes);
+    }
+  }
+  const uint8_t* trailer = io_buf->reader_pointer();
+  if (ignore_checksum) {
+    // No-op.
+  } else if (framing == WUFFS_BASE__FOURCC__GZ) {
+    if ((checksum != wuffs_base__peek_u32le__no_bounds_check(trailer + 0)) ||
+        (((uint32_t)(index.num_dst_bytes)) !=
+         wuffs_base__peek_u32le__no_bounds_check(trailer + 4))) {
+      return DecodeDeflateResult(DecodeDeflate_BadChecksum,
+                                 index.num_dst_bytes);
+    }
+  } else if (framing == WUFFS_BASE__FOURCC__ZLIB) {
+    if (checksum != wuffs_base__peek_u32be__no_bounds_check(trailer)) {
+      return DecodeDeflateResult(DecodeDeflate_BadChecksum,
+                                 index.num_dst_bytes);
+    }
+  }
+  io_buf->meta.ri += trailer_len;
+  return DecodeDeflateResult("", index.num_dst_bytes);
+}
+
+DecodeDeflateResult  //
+DecodeDeflateRange0(DecodeDeflateCallbacks& callbacks,
+                    sync_io::Input& input,
+                    const DecodeDeflateCheckpoint& checkpoint,
+                    uint64_t dst_pos,
+                    uint64_t dst_len) {
+  if (checkpoint.dst_pos > dst_pos) {
+    return DecodeDeflateResult(DecodeDeflate_BadCheckpoint, 0);
+  }
+  uint64_t end_pos =
+      (dst_len <= (UINT64_MAX - dst_pos)) ? (dst_pos + dst_len) : UINT64_MAX;
+
+  wuffs_deflate__decoder::unique_ptr dec = wuffs_deflate__decoder::alloc();
+  if (!dec) {
+    return DecodeDeflateResult(DecodeDeflate_OutOfMemory, 0);
+  }
+  std::string error_message = DecodeDeflateRestore(*dec, checkpoint);
+  if (!error_message.empty()) {
+    return DecodeDeflateResult(std::move(error_message), 0);
+  }
+
+  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
+  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
+  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
+  if (!io_buf) {
+    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);
+    fallback_io_buf =
+        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);
+    io_buf = &fallback_io_buf;
+  }
+
+  std::unique_ptr<uint8_t[]> dst_array(
+      new uint8_t[DecodeDeflateScratchLength]);
+  wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(
+      dst_array.get(), DecodeDeflateScratchLength);
+  uint8_t work_array[1];
+  uint64_t pos = checkpoint.dst_pos;
+  uint64_t num_dst_bytes = 0;
+
+  while (pos < end_pos) {
+    dst.meta.wi = 0;
+    wuffs_base__status status = dec->transform_io(
+        &dst, io_buf, wuffs_base__make_slice_u8(work_array, 0));
+
+    // Clip the [pos, pos + dst.meta.wi) output to [dst_pos, end_pos).
+    uint64_t lo = (pos > dst_pos) ? pos : dst_pos;
+    uint64_t hi = ((end_pos - pos) > dst.meta.wi) ? (pos + dst.meta.wi)  //
+                                                  : end_pos;
+    if (lo < hi) {
+      error_message =
+          callbacks.Append(dst.data.ptr + (lo - pos), (size_t)(hi - lo));
+      num_dst_bytes += hi - lo;
+      if (!error_message.empty()) {
+        return DecodeDeflateResult(std::move(error_message), num_dst_bytes);
+      }
+    }
+    pos += dst.meta.wi;
+
+    if (status.is_ok()) {
+      break;
+    } else if (status.repr == wuffs_base__suspension__short_read) {
+      error_message = DecodeDeflateFill(input, io_buf);
+      if (!error_message.empty()) {
+        return DecodeDeflateResult(std::move(error_message), num_dst_bytes);
+      }
+    } else if (status.repr != wuffs_base__suspension__short_write) {
+      return DecodeDeflateResult(status.message(), num_dst_bytes);
+    }
+  }
+  return DecodeDeflateResult("", num_dst_bytes);
+}
+
+}  // namespace
+
+DecodeDeflateResult  //
+DecodeDeflateWithIndex(DecodeDeflateCallbacks& callbacks,
+                       sync_io::Input& input,
+                       DecodeDeflateIndex& index,
+                       uint32_t framing,
+                       uint64_t spacing,
+                       wuffs_base__slice_u32 quirks) {
+  DecodeDeflateResult result =
+      DecodeDeflateWithIndex0(callbacks, input, index, framing, spacing,
+                              DecodeDeflateIgnoreChecksum(quirks));
+  callbacks.Done(result, input);
+  return result;
+}
+
+std::string  //
+DecodeDeflateRestore(wuffs_deflate__decoder& dec,
+                     const DecodeDeflateCheckpoint& checkpoint) {
+  if ((checkpoint.num_pending_bits >= 8) ||
+      (checkpoint.history.size() > 32768)) {
+    return DecodeDeflate_BadCheckpoint;
+  }
+  wuffs_base__status status =
+      dec.initialize(sizeof__wuffs_deflate__decoder(), WUFFS_VERSION,
+                     WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED);
+  if (!status.is_ok()) {
+    return status.message();
+  }
+  if (!checkpoint.history.empty()) {
+    dec.add_history(wuffs_base__make_slice_u8(
+        (uint8_t*)(const_cast<char*>(checkpoint.history.data())),
+        checkpoint.history.size()));
+  }
+  dec.set_pending_bits(checkpoint.pending_bits, checkpoint.num_pending_bits);
+  return "";
+}
+
+DecodeDeflateResult  //
+DecodeDeflateRange(DecodeDeflateCallbacks& callbacks,
+                   sync_io::Input& input,
+                   const DecodeDeflateCheckpoint& checkpoint,
+                   uint64_t dst_pos,
+                   uint64_t dst_len) {
+  DecodeDeflateResult result =
+      DecodeDeflateRange0(callbacks, input, checkpoint, dst_pos, dst_len);
+  callbacks.Done(result, input);
   return result;
 }
 
 }  // namespace wuffs_aux
 
 #endif  // !defined(WUFFS_CONFIG__MODULES) ||
-        // defined(WUFFS_CONFIG__MODULE__AUX__CBOR)
+        // defined(WUFFS_CONFIG__MODULE__AUX__DEFLATE)
 
 // ---------------- Auxiliary - Image
 
 #if !defined(WUFFS_CONFIG__MODULES) || defined(WUFFS_CONFIG__MODULE__AUX__IMAGE)
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <utility>
+#include <vector>
+
+// WUFFS_AUX__DECODE_IMAGE__PNG_NUM_BATCHES is the number of batches (of
+// decompressed IDAT data) that the pipelined PNG decoder's inflating thread
+// can run ahead by.
+#ifndef WUFFS_AUX__DECODE_IMAGE__PNG_NUM_BATCHES
+#define WUFFS_AUX__DECODE_IMAGE__PNG_NUM_BATCHES 8
+#endif
 
 namespace wuffs_aux {
 
@@ -39764,6 +53988,8 @@ const char DecodeImage_OutOfMemory[] =  //
     "wuffs_aux::DecodeImage: out of memory";
 const char DecodeImage_UnexpectedEndOfFile[] =  //
     "wuffs_aux::DecodeImage: unexpected end of file";
+const char DecodeImage_UnsupportedDownscaleShift[] =  //
+    "wuffs_aux::DecodeImage: unsupported downscale shift";
 const char DecodeImage_UnsupportedImageFormat[] =  //
     "wuffs_aux::DecodeImage: unsupported image format";
 const char DecodeImage_UnsupportedPixelBlend[] =  //
@@ -39807,6 +54033,41 @@ DecodeImageAdvanceIOBuf(sync_io::Input& input,
   return "";
 }
 
+// DecodeImageDownscale box filters src, a full size BGRA_PREMUL pixel buffer,
+// down to dst. It is for image formats whose decoders cannot downscale as
+// they decode.
+std::string  //
+DecodeImageDownscale(wuffs_base__pixel_buffer& dst,
+                     wuffs_base__pixel_buffer& src,
+                     wuffs_base__pixel_blend pixel_blend,
+                     uint32_t downscale_shift) {
+  uint8_t dst_palette_array[1024];
+  wuffs_base__slice_u8 dst_palette = dst.palette_or_else(
+      wuffs_base__make_slice_u8(dst_palette_array, 1024));
+  wuffs_base__pixel_swizzler swizzler;
+  wuffs_base__status status = swizzler.prepare_downscaled(
+      dst.pixel_format(), dst_palette, src.pixel_format(),
+      wuffs_base__empty_slice_u8(), pixel_blend);
+  if (status.repr != nullptr) {
+    return status.message();
+  }
+
+  uint32_t w = src.pixcfg.width();
+  uint32_t h = src.pixcfg.height();
+  std::vector<uint8_t> accum(8 * (((size_t)(w >> downscale_shift)) + 2));
+  wuffs_base__table_u8 dst_tab = dst.plane(0);
+  wuffs_base__table_u8 src_tab = src.plane(0);
+  for (uint32_t y = 0; y < h; y++) {
+    wuffs_base__slice_u8 row = wuffs_base__table_u8__row(src_tab, y);
+    row.len = std::min(row.len, 4 * ((size_t)w));
+    swizzler.swizzle_downscaled_from_slice(
+        dst_tab, dst_palette,
+        wuffs_base__make_slice_u8(accum.data(), accum.size()), row,
+        downscale_shift, 0, y, 0, h);
+  }
+  return "";
+}
+
 DecodeImageResult  //
 DecodeImage0(wuffs_base__image_decoder::unique_ptr& image_decoder,
              DecodeImageCallbacks& callbacks,
@@ -39814,7 +54075,8 @@ DecodeImage0(wuffs_base__image_decoder::unique_ptr& image_decoder,
              wuffs_base__io_buffer& io_buf,
              wuffs_base__pixel_blend pixel_blend,
              wuffs_base__color_u32_argb_premul background_color,
-             uint32_t max_incl_dimension) {
+             uint32_t max_incl_dimension,
+             uint32_t downscale_shift) {
   // Check args.
   switch (pixel_blend) {
     case WUFFS_BASE__PIXEL_BLEND__SRC:
@@ -39823,6 +54085,9 @@ DecodeImage0(wuffs_base__image_decoder::unique_ptr& image_decoder,
     default:
       return DecodeImageResult(DecodeImage_UnsupportedPixelBlend);
   }
+  if (downscale_shift > 3) {
+    return DecodeImageResult(DecodeImage_UnsupportedDownscaleShift);
+  }
 
   wuffs_base__image_config image_config = wuffs_base__null_image_config();
   uint64_t start_pos = io_buf.reader_position();
@@ -39928,6 +54193,42 @@ redirect:
                             WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, w, h);
   }
 
+  // Downscale. The PNG and GIF decoders can do so as they decode. Other
+  // image formats are decoded, at full size, to a temporary BGRA_PREMUL pixel
+  // buffer that is then box filtered down to the allocated pixel buffer.
+  wuffs_base__decode_frame_options decode_frame_options = {};
+  wuffs_base__pixel_buffer full_pixel_buffer = {};
+  MemOwner full_mem_owner(nullptr, &free);
+  if (downscale_shift > 0) {
+    if ((fourcc == WUFFS_BASE__FOURCC__PNG) ||
+        (fourcc == WUFFS_BASE__FOURCC__GIF)) {
+      decode_frame_options.set_downscale_shift(downscale_shift);
+    } else {
+      wuffs_base__pixel_config full_pixcfg;
+      full_pixcfg.set(WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL,
+                      WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, w, h);
+      uint64_t len = full_pixcfg.pixbuf_len();
+      if ((len == 0) || (SIZE_MAX < len)) {
+        return DecodeImageResult(DecodeImage_UnsupportedPixelConfiguration);
+      }
+      void* ptr = calloc((size_t)len, 1);
+      if (!ptr) {
+        return DecodeImageResult(DecodeImage_OutOfMemory);
+      }
+      full_mem_owner.reset(ptr);
+      wuffs_base__status status = full_pixel_buffer.set_from_slice(
+          &full_pixcfg, wuffs_base__make_slice_u8((uint8_t*)ptr, (size_t)len));
+      if (status.repr != nullptr) {
+        return DecodeImageResult(status.message());
+      }
+    }
+    uint32_t mask = (1u << downscale_shift) - 1;
+    image_config.pixcfg.set(image_config.pixcfg.pixel_format().repr,
+                            WUFFS_BASE__PIXEL_SUBSAMPLING__NONE,
+                            (w >> downscale_shift) + ((w & mask) ? 1 : 0),
+                            (h >> downscale_shift) + ((h & mask) ? 1 : 0));
+  }
+
   // Allocate the pixel buffer.
   bool valid_background_color =
       wuffs_base__color_u32_argb_premul__is_valid(background_color);
@@ -39946,8 +54247,12 @@ redirect:
   }
 
   // Allocate the work buffer. Wuffs' decoders conventionally assume that this
-  // can be uninitialized memory.
+  // can be uninitialized memory. Downscaling decoders need more than the
+  // minimum length, so ask for the maximum.
   wuffs_base__range_ii_u64 workbuf_len = image_decoder->workbuf_len();
+  if (decode_frame_options.downscale_shift() > 0) {
+    workbuf_len.min_incl = workbuf_len.max_incl;
+  }
   DecodeImageCallbacks::AllocWorkbufResult alloc_workbuf_result =
       callbacks.AllocWorkbuf(workbuf_len, true);
   if (!alloc_workbuf_result.error_message.empty()) {
@@ -39984,10 +54289,12 @@ redirect:
       frame_config.overwrite_instead_of_blend()) {
     pixel_blend = WUFFS_BASE__PIXEL_BLEND__SRC;
   }
+  bool full_size = full_mem_owner != nullptr;
   while (true) {
-    wuffs_base__status id_df_status =
-        image_decoder->decode_frame(&pixel_buffer, &io_buf, pixel_blend,
-                                    alloc_workbuf_result.workbuf, nullptr);
+    wuffs_base__status id_df_status = image_decoder->decode_frame(
+        full_size ? &full_pixel_buffer : &pixel_buffer, &io_buf,
+        full_size ? WUFFS_BASE__PIXEL_BLEND__SRC : pixel_blend,
+        alloc_workbuf_result.workbuf, &decode_frame_options);
     if (id_df_status.repr == nullptr) {
       break;
     } else if (id_df_status.repr != wuffs_base__suspension__short_read) {
@@ -40004,18 +54311,381 @@ redirect:
       }
     }
   }
+  if (full_size) {
+    std::string error_message = DecodeImageDownscale(
+        pixel_buffer, full_pixel_buffer, pixel_blend, downscale_shift);
+    if (message.empty()) {
+      message = std::move(error_message);
+    }
+  }
   return DecodeImageResult(std::move(alloc_pixbuf_result.mem_owner),
                            pixel_buffer, std::move(message));
 }
 
-}  // namespace
+// DecodeImageReadAll returns the entire input, either in its own I/O buffer
+// or after copying it into storage.
+std::string  //
+DecodeImageReadAll(sync_io::Input& input,
+                   std::vector<uint8_t>& storage,
+                   wuffs_base__slice_u8* all) {
+  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
+  if (io_buf && io_buf->meta.closed) {
+    *all = io_buf->reader_slice();
+    return "";
+  }
+  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
+  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
+  if (!io_buf) {
+    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);
+    fallback_io_buf =
+        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);
+    io_buf = &fallback_io_buf;
+  }
+  while (true) {
+    storage.insert(storage.end(), io_buf->reader_pointer(),
+                   io_buf->reader_pointer() + io_buf->reader_length());
+    io_buf->meta.ri = io_buf->meta.wi;
+    if (io_buf->meta.closed) {
+      break;
+    }
+    io_buf->compact();
+    std::string error_message = input.CopyIn(io_buf);
+    if (!error_message.empty()) {
+      return error_message;
+    }
+  }
+  *all = wuffs_base__make_slice_u8(storage.data(), storage.size());
+  return "";
+}
+
+#if !defined(WUFFS_CONFIG__MODULES) ||                                      \
+    (defined(WUFFS_CONFIG__MODULE__ADLER32) &&                              \
+     defined(WUFFS_CONFIG__MODULE__CRC32) &&                                \
+     defined(WUFFS_CONFIG__MODULE__PNG) && defined(WUFFS_CONFIG__MODULE__ZLIB))
+#define WUFFS_AUX__DECODE_IMAGE__PNG_PIPELINE
+#endif
+
+#if defined(WUFFS_AUX__DECODE_IMAGE__PNG_PIPELINE)
+
+// DecodeImageFindIDAT returns the position of the first IDAT chunk (its
+// length field) in the PNG image s, or 0 if s is not a PNG image or has no
+// IDAT chunk.
+size_t  //
+DecodeImageFindIDAT(wuffs_base__slice_u8 s) {
+  static const uint8_t signature[8] = {
+      0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A,
+  };
+  if ((s.len < 8) || memcmp(s.ptr, signature, 8)) {
+    return 0;
+  }
+  size_t pos = 8;
+  while ((s.len - pos) >= 12) {
+    uint32_t chunk_len = wuffs_base__peek_u32be__no_bounds_check(s.ptr + pos);
+    uint32_t chunk_type =
+        wuffs_base__peek_u32le__no_bounds_check(s.ptr + pos + 4);
+    if (chunk_type == 0x54414449) {  // "IDAT" as a little-endian u32.
+      return pos;
+    } else if ((s.len - pos - 12) < chunk_len) {
+      break;
+    }
+    pos += 12 + (size_t)chunk_len;
+  }
+  return 0;
+}
+
+// DecodeImagePngPipeline is a sync_io::Input that splits decoding a PNG
+// image across two threads. A second thread inflates the IDAT chunks' zlib
+// stream, a batch at a time, into a bounded ring of batches. The calling
+// thread reads those batches back as a new but equivalent PNG image, whose
+// IDAT chunks hold the decompressed data as zlib stored (uncompressed)
+// blocks, so that the regular PNG decoder (which then only has to copy the
+// stored blocks before un-filtering and swizzling) runs concurrently with
+// the inflating.
+//
+// The IDAT chunks' CRC-32 and the zlib stream's Adler-32 checksums of the
+// original image are not verified. Those of the new image are valid.
+class DecodeImagePngPipeline : public sync_io::Input {
+ public:
+  DecodeImagePngPipeline(wuffs_base__slice_u8 src, size_t idat_pos);
+  ~DecodeImagePngPipeline();
+
+  virtual std::string CopyIn(IOBuffer* dst);
+
+ private:
+  // kBatchLength is the maximum length of a zlib stored block.
+  static const size_t kBatchLength = 65535;
+
+  void Inflate();
+  std::string Inflate0();
+  bool Push(std::vector<uint8_t>&& batch);
+
+  wuffs_base__slice_u8 m_src;
+  size_t m_idat_pos;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  std::deque<std::vector<uint8_t>> m_batches;
+  std::string m_error_message;
+  bool m_done;
+  bool m_cancelled;
+
+  // Only the calling thread uses m_curr and m_curr_ri.
+  std::vector<uint8_t> m_curr;
+  size_t m_curr_ri;
+
+  std::thread m_thread;
+
+  // Delete the copy and assign constructors.
+  DecodeImagePngPipeline(const DecodeImagePngPipeline&) = delete;
+  DecodeImagePngPipeline& operator=(const DecodeImagePngPipeline&) = delete;
+};
+
+DecodeImagePngPipeline::DecodeImagePngPipeline(wuffs_base__slice_u8 src,
+                                               size_t idat_pos)
+    : m_src(src),
+      m_idat_pos(idat_pos),
+      m_done(false),
+      m_cancelled(false),
+      m_curr(src.ptr, src.ptr + idat_pos),
+      m_curr_ri(0),
+      m_thread(&DecodeImagePngPipeline::Inflate, this) {}
+
+DecodeImagePngPipeline::~DecodeImagePngPipeline() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cancelled = true;
+  }
+  m_cond.notify_all();
+  m_thread.join();
+}
+
+std::string  //
+DecodeImagePngPipeline::CopyIn(IOBuffer* dst) {
+  if (!dst) {
+    return "wuffs_aux::DecodeImagePngPipeline: nullptr IOBuffer";
+  } else if (dst->meta.closed) {
+    return "wuffs_aux::DecodeImagePngPipeline: end of file";
+  }
+  dst->compact();
+  while (dst->writer_length() > 0) {
+    if (m_curr_ri < m_curr.size()) {
+      size_t n = std::min(dst->writer_length(), m_curr.size() - m_curr_ri);
+      memcpy(dst->writer_pointer(), m_curr.data() + m_curr_ri, n);
+      dst->meta.wi += n;
+      m_curr_ri += n;
+      continue;
+    } else if (dst->reader_length() > 0) {
+      // Return what we have instead of waiting for the next batch.
+      break;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cond.wait(lock, [this] { return !m_batches.empty() || m_done; });
+    if (m_batches.empty()) {
+      dst->meta.closed = true;
+      return m_error_message;
+    }
+    m_curr = std::move(m_batches.front());
+    m_curr_ri = 0;
+    m_batches.pop_front();
+    lock.unlock();
+    m_cond.notify_all();
+  }
+  return "";
+}
+
+void  //
+DecodeImagePngPipeline::Inflate() {
+  std::string error_message = Inflate0();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_error_message = std::move(error_message);
+    m_done = true;
+  }
+  m_cond.notify_all();
+}
+
+// Inflate0 runs on the second thread. It returns an empty string on success
+// or an error message.
+std::string  //
+DecodeImagePngPipeline::Inflate0() {
+  auto dec = wuffs_zlib__decoder::alloc();
+  auto crc32 = wuffs_crc32__ieee_hasher::alloc();
+  auto adler32 = wuffs_adler32__hasher::alloc();
+  if (!dec || !crc32 || !adler32) {
+    return DecodeImage_OutOfMemory;
+  }
+  dec->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, true);
+
+  // Each batch is one IDAT chunk: an 8 byte chunk header, the 2 byte zlib
+  // header (for the first batch only), a 5 byte stored block header, up to
+  // kBatchLength bytes of decompressed data and a 4 byte CRC-32.
+  static const size_t max_batch_len = 8 + 2 + 5 + kBatchLength + 4;
+  static const size_t work_len =
+      WUFFS_ZLIB__DECODER_WORKBUF_LEN_MAX_INCL_WORST_CASE;
+  uint8_t work_array[work_len];
+  size_t pos = m_idat_pos;
+  uint32_t idat_remaining = 0;
+  bool first_batch = true;
+  bool eof = false;
+  std::string error_message;
+  while (!eof && error_message.empty()) {
+    std::vector<uint8_t> batch(max_batch_len);
+    size_t data_pos = first_batch ? 15 : 13;
+    size_t n = 0;
+    while (n < kBatchLength) {
+      // Find the next IDAT chunk's payload, when we have finished the last.
+      if (idat_remaining == 0) {
+        if ((m_src.len - pos) < 8) {
+          error_message = DecodeImage_UnexpectedEndOfFile;
+          break;
+        }
+        uint32_t chunk_len =
+            wuffs_base__peek_u32be__no_bounds_check(m_src.ptr + pos);
+        uint32_t chunk_type =
+            wuffs_base__peek_u32le__no_bounds_check(m_src.ptr + pos + 4);
+        if (chunk_type != 0x54414449) {  // "IDAT" as a little-endian u32.
+          // The zlib stream has not finished, yet there is no more IDAT data.
+          error_message = DecodeImage_UnexpectedEndOfFile;
+          break;
+        }
+        pos += 8;
+        // Like the single-threaded decoder, decompress as much of a truncated
+        // chunk's payload as there is.
+        idat_remaining = (uint32_t)std::min<size_t>(chunk_len, m_src.len - pos);
+        if (idat_remaining == 0) {
+          pos = std::min(m_src.len, pos + 4);
+          if (chunk_len > 0) {
+            error_message = DecodeImage_UnexpectedEndOfFile;
+            break;
+          }
+          continue;
+        }
+      }
+
+      // Each transform_io call starts with an empty dst (with no history), as
+      // the decoder has already copied earlier output into its own history.
+      wuffs_base__io_buffer dst = wuffs_base__ptr_u8__writer(
+          batch.data() + data_pos + n, kBatchLength - n);
+      wuffs_base__io_buffer src =
+          wuffs_base__ptr_u8__reader(m_src.ptr + pos, idat_remaining, false);
+      wuffs_base__status status = dec->transform_io(
+          &dst, &src, wuffs_base__make_slice_u8(work_array, work_len));
+      n += dst.meta.wi;
+      pos += src.meta.ri;
+      idat_remaining -= (uint32_t)src.meta.ri;
+      if (idat_remaining == 0) {
+        pos = std::min(m_src.len, pos + 4);  // Skip the CRC-32.
+      }
+      if (status.repr == nullptr) {
+        eof = true;
+        break;
+      } else if ((status.repr != wuffs_base__suspension__short_read) &&
+                 (status.repr != wuffs_base__suspension__short_write)) {
+        error_message = status.message();
+        break;
+      }
+    }
+
+    // Pass on what was decompressed, even after an error, so that the
+    // calling thread can still decode a partial image.
+    adler32->update_u32(wuffs_base__make_slice_u8(batch.data() + data_pos, n));
+    uint8_t* p = batch.data();
+    wuffs_base__poke_u32be__no_bounds_check(p + 0,
+                                            (uint32_t)(data_pos - 8 + n));
+    wuffs_base__poke_u32le__no_bounds_check(p + 4, 0x54414449);
+    if (first_batch) {
+      // 0x7801 is a valid zlib header (with no preset dictionary). The window
+      // size is irrelevant for stored blocks.
+      p[8] = 0x78;
+      p[9] = 0x01;
+    }
+    p[data_pos - 5] = 0x00;  // A non-final stored block.
+    wuffs_base__poke_u16le__no_bounds_check(p + data_pos - 4, (uint16_t)n);
+    wuffs_base__poke_u16le__no_bounds_check(p + data_pos - 2,
+                                            (uint16_t)(n ^ 0xFFFF));
+    wuffs_base__poke_u32be__no_bounds_check(
+        p + data_pos + n,
+        crc32->update_u32(wuffs_base__make_slice_u8(p + 4, data_pos - 4 + n)));
+    batch.resize(data_pos + n + 4);
+    wuffs_base__status status =
+        crc32->initialize(sizeof__wuffs_crc32__ieee_hasher(), WUFFS_VERSION, 0);
+    if (!status.is_ok()) {
+      return status.message();
+    }
+    first_batch = false;
+    if (!Push(std::move(batch))) {
+      return "";
+    }
+  }
+  if (!error_message.empty()) {
+    return error_message;
+  }
+
+  // Skip the rest of the zlib stream's IDAT chunks: any bytes after the end of
+  // the stream and any further IDAT chunks.
+  if (idat_remaining > 0) {
+    pos = std::min(m_src.len, pos + idat_remaining + 4);
+  }
+  while ((m_src.len - pos) >= 8) {
+    uint32_t chunk_len =
+        wuffs_base__peek_u32be__no_bounds_check(m_src.ptr + pos);
+    uint32_t chunk_type =
+        wuffs_base__peek_u32le__no_bounds_check(m_src.ptr + pos + 4);
+    if (chunk_type != 0x54414449) {  // "IDAT" as a little-endian u32.
+      break;
+    }
+    pos += std::min<size_t>(m_src.len - pos, 12 + (size_t)chunk_len);
+  }
+
+  // Finish with an IDAT chunk that holds a final (and empty) stored block and
+  // the zlib Adler-32 checksum, then the original bytes after the IDAT chunks
+  // (such as tEXt chunks and the IEND chunk), so that decoding metadata that
+  // comes after the pixel data sees the same chunks as single-threaded
+  // decoding does.
+  std::vector<uint8_t> batch(8 + 9 + 4);
+  uint8_t* p = batch.data();
+  wuffs_base__poke_u32be__no_bounds_check(p + 0, 9);
+  wuffs_base__poke_u32le__no_bounds_check(p + 4, 0x54414449);
+  p[8] = 0x01;
+  wuffs_base__poke_u32be__no_bounds_check(p + 9, 0x0000FFFF);
+  wuffs_base__poke_u32be__no_bounds_check(
+      p + 13, adler32->update_u32(wuffs_base__empty_slice_u8()));
+  wuffs_base__poke_u32be__no_bounds_check(
+      p + 17, crc32->update_u32(wuffs_base__make_slice_u8(p + 4, 13)));
+  batch.insert(batch.end(), m_src.ptr + pos, m_src.ptr + m_src.len);
+  Push(std::move(batch));
+  return "";
+}
 
+// Push adds a batch to the ring, waiting until there is room for it. It
+// returns false if the calling thread has given up on decoding.
+bool  //
+DecodeImagePngPipeline::Push(std::vector<uint8_t>&& batch) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cond.wait(lock, [this] {
+    return (m_batches.size() < WUFFS_AUX__DECODE_IMAGE__PNG_NUM_BATCHES) ||
+           m_cancelled;
+  });
+  if (m_cancelled) {
+    return false;
+  }
+  m_batches.push_back(std::move(batch));
+  lock.unlock();
+  m_cond.notify_all();
+  return true;
+}
+
+#endif  // defined(WUFFS_AUX__DECODE_IMAGE__PNG_PIPELINE)
+
+// DecodeImage1 is DecodeImage, single-threaded.
 DecodeImageResult  //
-DecodeImage(DecodeImageCallbacks& callbacks,
-            sync_io::Input& input,
-            wuffs_base__pixel_blend pixel_blend,
-            wuffs_base__color_u32_argb_premul background_color,
-            uint32_t max_incl_dimension) {
+DecodeImage1(DecodeImageCallbacks& callbacks,
+             sync_io::Input& input,
+             wuffs_base__pixel_blend pixel_blend,
+             wuffs_base__color_u32_argb_premul background_color,
+             uint32_t max_incl_dimension,
+             uint32_t downscale_shift) {
   wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
   wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
   std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
@@ -40029,11 +54699,674 @@ DecodeImage(DecodeImageCallbacks& callbacks,
   wuffs_base__image_decoder::unique_ptr image_decoder(nullptr, &free);
   DecodeImageResult result =
       DecodeImage0(image_decoder, callbacks, input, *io_buf, pixel_blend,
-                   background_color, max_incl_dimension);
+                   background_color, max_incl_dimension, downscale_shift);
   callbacks.Done(result, input, *io_buf, std::move(image_decoder));
   return result;
 }
 
+}  // namespace
+
+DecodeImageResult  //
+DecodeImage(DecodeImageCallbacks& callbacks,
+            sync_io::Input& input,
+            wuffs_base__pixel_blend pixel_blend,
+            wuffs_base__color_u32_argb_premul background_color,
+            uint32_t max_incl_dimension,
+            uint32_t num_threads,
+            uint32_t downscale_shift) {
+#if defined(WUFFS_AUX__DECODE_IMAGE__PNG_PIPELINE)
+  if (num_threads > 1) {
+    std::vector<uint8_t> storage;
+    wuffs_base__slice_u8 all = wuffs_base__empty_slice_u8();
+    std::string error_message = DecodeImageReadAll(input, storage, &all);
+    if (!error_message.empty()) {
+      DecodeImageResult result(std::move(error_message));
+      wuffs_base__io_buffer empty_io_buf = wuffs_base__empty_io_buffer();
+      callbacks.Done(result, input, empty_io_buf,
+                     wuffs_base__image_decoder::unique_ptr(nullptr, &free));
+      return result;
+    }
+    size_t idat_pos = DecodeImageFindIDAT(all);
+    if (idat_pos > 0) {
+      DecodeImagePngPipeline pipeline(all, idat_pos);
+      return DecodeImage1(callbacks, pipeline, pixel_blend, background_color,
+                          max_incl_dimension, downscale_shift);
+    }
+    sync_io::MemoryInput memory_input(all.ptr, all.len);
+    return DecodeImage1(callbacks, memory_input, pixel_blend, background_color,
+                        max_incl_dimension, downscale_shift);
+  }
+#endif  // defined(WUFFS_AUX__DECODE_IMAGE__PNG_PIPELINE)
+
+  return DecodeImage1(callbacks, input, pixel_blend, background_color,
+                      max_incl_dimension, downscale_shift);
+}
+
+// --------
+
+IndexFramesResult::IndexFramesResult(wuffs_base__image_config image_config0,
+                                     std::vector<Frame>&& frames0,
+                                     std::string&& error_message0)
+    : image_config(image_config0),
+      frames(std::move(frames0)),
+      error_message(std::move(error_message0)) {}
+
+size_t  //
+IndexFramesResult::KeyframeFor(size_t n) const {
+  if (frames.empty()) {
+    return 0;
+  }
+  n = std::min(n, frames.size() - 1);
+  while ((n > 0) && !frames[n].keyframe) {
+    n--;
+  }
+  return n;
+}
+
+IndexFramesResult  //
+IndexFrames(wuffs_base__image_decoder& image_decoder, sync_io::Input& input) {
+  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
+  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
+  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
+  if (!io_buf) {
+    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);
+    fallback_io_buf =
+        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);
+    io_buf = &fallback_io_buf;
+  }
+
+  wuffs_base__image_config image_config = wuffs_base__null_image_config();
+  std::vector<IndexFramesResult::Frame> frames;
+  while (true) {
+    wuffs_base__status status =
+        image_decoder.decode_image_config(&image_config, io_buf);
+    if (status.repr == nullptr) {
+      break;
+    } else if (status.repr == wuffs_base__note__i_o_redirect) {
+      return IndexFramesResult(image_config, std::move(frames),
+                               DecodeImage_UnsupportedImageFormat);
+    } else if (status.repr != wuffs_base__suspension__short_read) {
+      return IndexFramesResult(image_config, std::move(frames),
+                               status.message());
+    } else if (io_buf->meta.closed) {
+      return IndexFramesResult(image_config, std::move(frames),
+                               DecodeImage_UnexpectedEndOfFile);
+    }
+    std::string error_message = input.CopyIn(io_buf);
+    if (!error_message.empty()) {
+      return IndexFramesResult(image_config, std::move(frames),
+                               std::move(error_message));
+    }
+  }
+
+  wuffs_base__rect_ie_u32 canvas = image_config.pixcfg.bounds();
+  // The canvas starts out cleared, so the first frame is a keyframe.
+  bool cleared = true;
+  while (true) {
+    wuffs_base__frame_config frame_config = wuffs_base__null_frame_config();
+    wuffs_base__status status =
+        image_decoder.decode_frame_config(&frame_config, io_buf);
+    if (status.repr == wuffs_base__note__end_of_data) {
+      break;
+    } else if (status.repr == wuffs_base__suspension__short_read) {
+      if (io_buf->meta.closed) {
+        return IndexFramesResult(image_config, std::move(frames),
+                                 DecodeImage_UnexpectedEndOfFile);
+      }
+      std::string error_message = input.CopyIn(io_buf);
+      if (!error_message.empty()) {
+        return IndexFramesResult(image_config, std::move(frames),
+                                 std::move(error_message));
+      }
+      continue;
+    } else if (status.repr != nullptr) {
+      return IndexFramesResult(image_config, std::move(frames),
+                               status.message());
+    }
+
+    bool covers_canvas = frame_config.bounds().contains_rect(canvas);
+    IndexFramesResult::Frame frame;
+    frame.io_position = frame_config.io_position();
+    frame.bounds = frame_config.bounds();
+    frame.duration = frame_config.duration();
+    frame.disposal = frame_config.disposal();
+    frame.keyframe =
+        cleared ||
+        (covers_canvas &&
+         (frame.disposal != WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_PREVIOUS) &&
+         (frame_config.opaque_within_bounds() ||
+          frame_config.overwrite_instead_of_blend()));
+    frames.push_back(frame);
+    cleared = covers_canvas &&
+              (frame.disposal ==
+               WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_BACKGROUND);
+  }
+  return IndexFramesResult(image_config, std::move(frames), "");
+}
+
+// --------
+
+#if !defined(WUFFS_CONFIG__MODULES) || \
+    (defined(WUFFS_CONFIG__MODULE__GIF) && defined(WUFFS_CONFIG__MODULE__LZW))
+#define WUFFS_AUX__DECODE_GIF_FRAMES
+#endif
+
+#if defined(WUFFS_AUX__DECODE_GIF_FRAMES)
+
+DecodeGifFramesCallbacks::~DecodeGifFramesCallbacks() {}
+
+DecodeGifFramesResult::DecodeGifFramesResult(uint64_t num_frames0,
+                                             std::string&& error_message0)
+    : num_frames(num_frames0), error_message(std::move(error_message0)) {}
+
+const char DecodeGifFrames_OutOfMemory[] =  //
+    "wuffs_aux::DecodeGifFrames: out of memory";
+
+namespace {
+
+// DecodeGifFramesSlot holds one decoded frame: its palette indices, in an
+// INDEXED__BGRA_BINARY pixel buffer the size of the whole image, of which
+// only the dirty_rect is meaningful.
+struct DecodeGifFramesSlot {
+  std::vector<uint8_t> memory;
+  wuffs_base__pixel_buffer pixbuf;
+  wuffs_base__frame_config frame_config;
+  wuffs_base__rect_ie_u32 dirty_rect;
+  std::string error_message;
+};
+
+// DecodeGifFramesCanvas composites DecodeGifFramesSlots, in frame order, and
+// applies each frame's disposal afterwards.
+class DecodeGifFramesCanvas {
+ public:
+  std::string Init(const wuffs_base__image_config& image_config,
+                   std::vector<DecodeGifFramesSlot>& slots);
+  std::string Composite(DecodeGifFramesCallbacks& callbacks,
+                        DecodeGifFramesSlot& slot);
+
+ private:
+  std::vector<uint8_t> m_memory;
+  std::vector<uint8_t> m_saved;
+  wuffs_base__pixel_buffer m_pixbuf;
+};
+
+std::string  //
+DecodeGifFramesCanvas::Init(const wuffs_base__image_config& image_config,
+                            std::vector<DecodeGifFramesSlot>& slots) {
+  uint32_t w = image_config.pixcfg.width();
+  uint32_t h = image_config.pixcfg.height();
+  uint64_t wh = (uint64_t)w * (uint64_t)h;
+  if (wh > (SIZE_MAX / 4)) {
+    return DecodeGifFrames_OutOfMemory;
+  }
+  m_memory.assign(4 * (size_t)wh, 0);
+  wuffs_base__pixel_config pixcfg;
+  pixcfg.set(WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL,
+             WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, w, h);
+  wuffs_base__status status = m_pixbuf.set_from_slice(
+      &pixcfg, wuffs_base__make_slice_u8(m_memory.data(), m_memory.size()));
+  if (!status.is_ok()) {
+    return status.message();
+  }
+
+  pixcfg.set(WUFFS_BASE__PIXEL_FORMAT__INDEXED__BGRA_BINARY,
+             WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, w, h);
+  for (auto& slot : slots) {
+    slot.memory.resize(
+        WUFFS_BASE__PIXEL_FORMAT__INDEXED__PALETTE_BYTE_LENGTH + (size_t)wh);
+    status = slot.pixbuf.set_from_slice(
+        &pixcfg, wuffs_base__make_slice_u8(slot.memory.data(),
+                                           slot.memory.size()));
+    if (!status.is_ok()) {
+      return status.message();
+    }
+  }
+  return "";
+}
+
+std::string  //
+DecodeGifFramesCanvas::Composite(DecodeGifFramesCallbacks& callbacks,
+                                 DecodeGifFramesSlot& slot) {
+  const wuffs_base__frame_config& fc = slot.frame_config;
+  if (fc.disposal() == WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_PREVIOUS) {
+    m_saved = m_memory;
+  }
+
+  // The swizzler converts the frame's palette to the canvas' pixel format,
+  // in dst_palette.
+  uint8_t dst_palette_array[1024];
+  wuffs_base__slice_u8 dst_palette =
+      wuffs_base__make_slice_u8(dst_palette_array, 1024);
+  wuffs_base__pixel_swizzler swizzler;
+  wuffs_base__status status = swizzler.prepare(
+      m_pixbuf.pixel_format(), dst_palette, slot.pixbuf.pixel_format(),
+      slot.pixbuf.palette(),
+      fc.overwrite_instead_of_blend() ? WUFFS_BASE__PIXEL_BLEND__SRC
+                                      : WUFFS_BASE__PIXEL_BLEND__SRC_OVER);
+  if (!status.is_ok()) {
+    return status.message();
+  }
+  wuffs_base__rect_ie_u32 r = slot.dirty_rect;
+  wuffs_base__table_u8 dst_tab = m_pixbuf.plane(0);
+  wuffs_base__table_u8 src_tab = slot.pixbuf.plane(0);
+  for (uint32_t y = r.min_incl_y; y < r.max_excl_y; y++) {
+    wuffs_base__slice_u8 dst = wuffs_base__table_u8__row(dst_tab, y);
+    wuffs_base__slice_u8 src = wuffs_base__table_u8__row(src_tab, y);
+    swizzler.swizzle_interleaved_from_slice(
+        wuffs_base__slice_u8__subslice_ij(dst, 4 * (size_t)r.min_incl_x,
+                                          4 * (size_t)r.max_excl_x),
+        dst_palette,
+        wuffs_base__slice_u8__subslice_ij(src, r.min_incl_x, r.max_excl_x));
+  }
+
+  std::string error_message = callbacks.Frame(fc, m_pixbuf);
+
+  if (fc.disposal() == WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_BACKGROUND) {
+    wuffs_base__rect_ie_u32 b = fc.bounds();
+    wuffs_base__color_u32_argb_premul color = fc.background_color();
+    for (uint32_t y = b.min_incl_y; y < b.max_excl_y; y++) {
+      uint8_t* p = wuffs_base__table_u8__row(dst_tab, y).ptr;
+      for (uint32_t x = b.min_incl_x; x < b.max_excl_x; x++) {
+        wuffs_base__poke_u32le__no_bounds_check(p + (4 * (size_t)x), color);
+      }
+    }
+  } else if (fc.disposal() ==
+             WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_PREVIOUS) {
+    std::copy(m_saved.begin(), m_saved.end(), m_memory.begin());
+  }
+  return error_message;
+}
+
+// DecodeGifFramesOne decodes the frame at index i of all, the entire input,
+// into slot. The image_decoder must have already decoded the image config.
+void  //
+DecodeGifFramesOne(wuffs_base__image_decoder& image_decoder,
+                   wuffs_base__slice_u8 all,
+                   const IndexFramesResult::Frame& frame,
+                   uint64_t i,
+                   DecodeGifFramesSlot& slot) {
+  slot.error_message.clear();
+  wuffs_base__status status =
+      image_decoder.restart_frame(i, frame.io_position);
+  if (!status.is_ok()) {
+    slot.error_message = status.message();
+    return;
+  } else if (frame.io_position > all.len) {
+    slot.error_message = DecodeImage_UnexpectedEndOfFile;
+    return;
+  }
+  wuffs_base__io_buffer src =
+      wuffs_base__ptr_u8__reader(all.ptr, all.len, true);
+  src.meta.ri = (size_t)frame.io_position;
+
+  status = image_decoder.decode_frame_config(&slot.frame_config, &src);
+  if (status.is_ok()) {
+    status = image_decoder.decode_frame(&slot.pixbuf, &src,
+                                        WUFFS_BASE__PIXEL_BLEND__SRC,
+                                        wuffs_base__empty_slice_u8(), nullptr);
+  }
+  if (status.repr == wuffs_base__suspension__short_read) {
+    slot.error_message = DecodeImage_UnexpectedEndOfFile;
+  } else if (!status.is_ok()) {
+    slot.error_message = status.message();
+  }
+  slot.dirty_rect = image_decoder.frame_dirty_rect();
+}
+
+DecodeGifFramesResult  //
+DecodeGifFramesSerial(DecodeGifFramesCallbacks& callbacks,
+                      sync_io::Input& input) {
+  wuffs_base__io_buffer* io_buf = input.BringsItsOwnIOBuffer();
+  wuffs_base__io_buffer fallback_io_buf = wuffs_base__empty_io_buffer();
+  std::unique_ptr<uint8_t[]> fallback_io_array(nullptr);
+  if (!io_buf) {
+    fallback_io_array = std::unique_ptr<uint8_t[]>(new uint8_t[32768]);
+    fallback_io_buf =
+        wuffs_base__ptr_u8__writer(fallback_io_array.get(), 32768);
+    io_buf = &fallback_io_buf;
+  }
+
+  auto dec = wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder();
+  if (!dec) {
+    return DecodeGifFramesResult(0, DecodeGifFrames_OutOfMemory);
+  }
+  std::vector<DecodeGifFramesSlot> slots(1);
+  DecodeGifFramesSlot& slot = slots[0];
+  DecodeGifFramesCanvas canvas;
+  uint64_t num_frames = 0;
+  wuffs_base__image_config image_config = wuffs_base__null_image_config();
+
+  // Each call (decode_image_config, decode_frame_config or decode_frame) is
+  // retried after short reads.
+  for (int stage = 0; true;) {
+    wuffs_base__status status;
+    if (stage == 0) {
+      status = dec->decode_image_config(&image_config, io_buf);
+    } else if (stage == 1) {
+      status = dec->decode_frame_config(&slot.frame_config, io_buf);
+    } else {
+      status = dec->decode_frame(&slot.pixbuf, io_buf,
+                                 WUFFS_BASE__PIXEL_BLEND__SRC,
+                                 wuffs_base__empty_slice_u8(), nullptr);
+    }
+
+    if (status.repr == wuffs_base__suspension__short_read) {
+      if (io_buf->meta.closed) {
+        return DecodeGifFramesResult(num_frames,
+                                     DecodeImage_UnexpectedEndOfFile);
+      }
+      std::string error_message = input.CopyIn(io_buf);
+      if (!error_message.empty()) {
+        return DecodeGifFramesResult(num_frames, std::move(error_message));
+      }
+      continue;
+    } else if ((stage == 1) && (status.repr == wuffs_base__note__end_of_data)) {
+      break;
+    } else if (!status.is_ok()) {
+      return DecodeGifFramesResult(num_frames, status.message());
+    }
+
+    if (stage == 0) {
+      std::string error_message = canvas.Init(image_config, slots);
+      if (!error_message.empty()) {
+        return DecodeGifFramesResult(num_frames, std::move(error_message));
+      }
+      stage = 1;
+    } else if (stage == 1) {
+      stage = 2;
+    } else {
+      slot.dirty_rect = dec->frame_dirty_rect();
+      std::string error_message = canvas.Composite(callbacks, slot);
+      num_frames++;
+      if (!error_message.empty()) {
+        return DecodeGifFramesResult(num_frames, std::move(error_message));
+      }
+      stage = 1;
+    }
+  }
+  return DecodeGifFramesResult(num_frames, "");
+}
+
+}  // namespace
+
+DecodeGifFramesResult  //
+DecodeGifFrames(DecodeGifFramesCallbacks& callbacks,
+                sync_io::Input& input,
+                uint32_t num_threads) {
+  if (num_threads <= 1) {
+    return DecodeGifFramesSerial(callbacks, input);
+  }
+
+  std::vector<uint8_t> storage;
+  wuffs_base__slice_u8 all = wuffs_base__empty_slice_u8();
+  std::string error_message = DecodeImageReadAll(input, storage, &all);
+  if (!error_message.empty()) {
+    return DecodeGifFramesResult(0, std::move(error_message));
+  }
+
+  // Index the frames. The indexing decoder is then the calling thread's
+  // decoder. The other threads' decoders are created lazily, as not every
+  // animation has num_threads frames.
+  std::vector<wuffs_base__image_decoder::unique_ptr> decoders;
+  decoders.push_back(wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder());
+  if (!decoders[0]) {
+    return DecodeGifFramesResult(0, DecodeGifFrames_OutOfMemory);
+  }
+  sync_io::MemoryInput memory_input(all.ptr, all.len);
+  IndexFramesResult index = IndexFrames(*decoders[0], memory_input);
+  const size_t num_frames = index.frames.size();
+  if (num_frames == 0) {
+    return DecodeGifFramesResult(0, std::move(index.error_message));
+  } else if (!index.error_message.empty()) {
+    // The indexing decoder stopped mid-way through a suspended
+    // decode_frame_config call, so it cannot restart_frame.
+    decoders.clear();
+  }
+
+  std::vector<DecodeGifFramesSlot> slots(
+      std::min<size_t>(num_threads, std::max<size_t>(num_frames, 1)));
+  DecodeGifFramesCanvas canvas;
+  error_message = canvas.Init(index.image_config, slots);
+  if (!error_message.empty()) {
+    return DecodeGifFramesResult(0, std::move(error_message));
+  }
+  while (decoders.size() < slots.size()) {
+    auto dec = wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder();
+    if (!dec) {
+      return DecodeGifFramesResult(0, DecodeGifFrames_OutOfMemory);
+    }
+    wuffs_base__io_buffer src =
+        wuffs_base__ptr_u8__reader(all.ptr, all.len, true);
+    wuffs_base__status status = dec->decode_image_config(nullptr, &src);
+    if (!status.is_ok()) {
+      return DecodeGifFramesResult(0, status.message());
+    }
+    decoders.push_back(std::move(dec));
+  }
+
+  // Decode each round's frames concurrently, the first on this thread, and
+  // then composite them in order.
+  for (size_t r0 = 0; r0 < num_frames; r0 += slots.size()) {
+    size_t r1 = std::min(num_frames, r0 + slots.size());
+    std::vector<std::thread> threads;
+    for (size_t i = r0 + 1; i < r1; i++) {
+      threads.emplace_back([&, i]() {
+        DecodeGifFramesOne(*decoders[i - r0], all, index.frames[i], i,
+                           slots[i - r0]);
+      });
+    }
+    DecodeGifFramesOne(*decoders[0], all, index.frames[r0], r0, slots[0]);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (size_t i = r0; i < r1; i++) {
+      DecodeGifFramesSlot& slot = slots[i - r0];
+      if (!slot.error_message.empty()) {
+        return DecodeGifFramesResult(i, std::move(slot.error_message));
+      }
+      error_message = canvas.Composite(callbacks, slot);
+      if (!error_message.empty()) {
+        return DecodeGifFramesResult(i + 1, std::move(error_message));
+      }
+    }
+  }
+  return DecodeGifFramesResult(num_frames, std::move(index.error_message));
+}
+
+#endif  // defined(WUFFS_AUX__DECODE_GIF_FRAMES)
+
+// --------
+
+#if !defined(WUFFS_CONFIG__MODULES) ||                                      \
+    (defined(WUFFS_CONFIG__MODULE__ADLER32) &&                              \
+     defined(WUFFS_CONFIG__MODULE__CRC32) &&                                \
+     defined(WUFFS_CONFIG__MODULE__DEFLATE) &&                              \
+     defined(WUFFS_CONFIG__MODULE__PNG))
+#define WUFFS_AUX__ENCODE_PNG
+#endif
+
+#if defined(WUFFS_AUX__ENCODE_PNG)
+
+EncodePngResult::EncodePngResult(std::string&& dst0,
+                                 std::string&& error_message0)
+    : dst(std::move(dst0)), error_message(std::move(error_message0)) {}
+
+const char EncodePng_OutOfMemory[] =  //
+    "wuffs_aux::EncodePng: out of memory";
+
+namespace {
+
+// EncodePngRows appends, to dst, either the complete PNG image (if y1 is
+// zero) or the zlib-compressed IDAT data for the rows y0 .. y1. For the
+// latter, it also sets *strip_adler32 to that data's uncompressed Adler-32
+// checksum.
+std::string  //
+EncodePngRows(std::string& dst,
+              uint32_t* strip_adler32,
+              wuffs_base__pixel_buffer& src,
+              uint32_t level,
+              uint32_t y0,
+              uint32_t y1) {
+  wuffs_png__encoder::unique_ptr enc = wuffs_png__encoder::alloc();
+  if (!enc) {
+    return EncodePng_OutOfMemory;
+  }
+  enc->set_level(level);
+  wuffs_base__status status = enc->prepare(&src);
+  if (!status.is_ok()) {
+    return status.message();
+  }
+  std::vector<uint8_t> workbuf(enc->workbuf_len().max_incl);
+  wuffs_base__slice_u8 w =
+      wuffs_base__make_slice_u8(workbuf.data(), workbuf.size());
+
+  uint8_t buf[32768];
+  while (true) {
+    wuffs_base__io_buffer io_buf = wuffs_base__ptr_u8__writer(buf, sizeof buf);
+    status = (y1 == 0) ? enc->encode_image(&io_buf, &src, w)
+                       : enc->encode_strip(&io_buf, &src, y0, y1, w);
+    dst.append(reinterpret_cast<const char*>(buf), io_buf.meta.wi);
+    if (status.repr != wuffs_base__suspension__short_write) {
+      break;
+    }
+  }
+  if (!status.is_ok()) {
+    return status.message();
+  }
+  if (strip_adler32) {
+    *strip_adler32 = enc->strip_adler32();
+  }
+  return "";
+}
+
+// EncodePngChunk appends a PNG chunk, with the given type and payload, to
+// dst. Long payloads are split over multiple chunks of the same type.
+std::string  //
+EncodePngChunk(std::string& dst, uint32_t chunk_type, std::string& data) {
+  // kMaxChunkLength is well under the PNG specification's 0x7FFF_FFFF limit.
+  static const size_t kMaxChunkLength = 0x100000;
+  auto crc32 = wuffs_crc32__ieee_hasher::alloc();
+  if (!crc32) {
+    return EncodePng_OutOfMemory;
+  }
+  size_t i = 0;
+  do {
+    size_t n = std::min(data.size() - i, kMaxChunkLength);
+    uint8_t header[8];
+    wuffs_base__poke_u32be__no_bounds_check(header + 0, (uint32_t)n);
+    wuffs_base__poke_u32be__no_bounds_check(header + 4, chunk_type);
+    crc32->update_u32(wuffs_base__make_slice_u8(header + 4, 4));
+    uint8_t footer[4];
+    wuffs_base__poke_u32be__no_bounds_check(
+        footer, crc32->update_u32(wuffs_base__make_slice_u8(
+                    reinterpret_cast<uint8_t*>(&data[0]) + i, n)));
+    dst.append(reinterpret_cast<const char*>(header), 8);
+    dst.append(data, i, n);
+    dst.append(reinterpret_cast<const char*>(footer), 4);
+    i += n;
+
+    wuffs_base__status status =
+        crc32->initialize(sizeof__wuffs_crc32__ieee_hasher(), WUFFS_VERSION, 0);
+    if (!status.is_ok()) {
+      return status.message();
+    }
+  } while (i < data.size());
+  return "";
+}
+
+}  // namespace
+
+EncodePngResult  //
+EncodePng(wuffs_base__pixel_buffer& src,
+          uint32_t level,
+          uint32_t num_threads) {
+  std::string dst;
+  uint32_t height = src.pixcfg.height();
+  uint32_t num_strips = std::min(num_threads, height);
+  if (num_strips <= 1) {
+    std::string error_message = EncodePngRows(dst, nullptr, src, level, 0, 0);
+    if (!error_message.empty()) {
+      return EncodePngResult("", std::move(error_message));
+    }
+    return EncodePngResult(std::move(dst), "");
+  }
+
+  // Compress the strips concurrently, the first on this thread.
+  std::vector<std::string> strips(num_strips);
+  std::vector<uint32_t> strip_adler32s(num_strips);
+  std::vector<std::string> error_messages(num_strips);
+  auto encode_strip = [&](uint32_t i) {
+    uint32_t y0 = (uint32_t)(((uint64_t)height * (i + 0)) / num_strips);
+    uint32_t y1 = (uint32_t)(((uint64_t)height * (i + 1)) / num_strips);
+    error_messages[i] =
+        EncodePngRows(strips[i], &strip_adler32s[i], src, level, y0, y1);
+  };
+  std::vector<std::thread> threads;
+  for (uint32_t i = 1; i < num_strips; i++) {
+    threads.emplace_back(encode_strip, i);
+  }
+  encode_strip(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& error_message : error_messages) {
+    if (!error_message.empty()) {
+      return EncodePngResult("", std::move(error_message));
+    }
+  }
+
+  // The zlib checksum is the strips' checksums, combined. Each strip's
+  // uncompressed data is one filter byte and then the pixel bytes per row.
+  auto adler32 = wuffs_adler32__hasher::alloc();
+  if (!adler32) {
+    return EncodePngResult("", EncodePng_OutOfMemory);
+  }
+  wuffs_base__pixel_format pixfmt = src.pixcfg.pixel_format();
+  uint32_t bits_per_pixel = pixfmt.bits_per_pixel();
+  uint64_t bytes_per_row =
+      1 + ((uint64_t)src.pixcfg.width() * (bits_per_pixel / 8));
+  uint32_t checksum = 1;
+  for (uint32_t i = 0; i < num_strips; i++) {
+    uint32_t y0 = (uint32_t)(((uint64_t)height * (i + 0)) / num_strips);
+    uint32_t y1 = (uint32_t)(((uint64_t)height * (i + 1)) / num_strips);
+    checksum = adler32->combine_u32(checksum, strip_adler32s[i],
+                                    (y1 - y0) * bytes_per_row);
+  }
+  uint8_t checksum_bytes[4];
+  wuffs_base__poke_u32be__no_bounds_check(checksum_bytes, checksum);
+  strips.back().append(reinterpret_cast<const char*>(checksum_bytes), 4);
+
+  // The signature, the IHDR chunk, the IDAT chunks and the IEND chunk. The
+  // pixel buffer's format was already checked by the wuffs_png__encoders.
+  dst.append("\x89PNG\r\n\x1A\n", 8);
+  uint8_t ihdr[13];
+  wuffs_base__poke_u32be__no_bounds_check(ihdr + 0, src.pixcfg.width());
+  wuffs_base__poke_u32be__no_bounds_check(ihdr + 4, height);
+  ihdr[8] = 8;
+  ihdr[9] = (bits_per_pixel == 8) ? 0 : (bits_per_pixel == 24) ? 2 : 6;
+  ihdr[10] = 0;
+  ihdr[11] = 0;
+  ihdr[12] = 0;
+  std::string chunk(reinterpret_cast<const char*>(ihdr), 13);
+  std::string error_message =
+      EncodePngChunk(dst, 0x49484452, chunk);  // "IHDR" as a big-endian u32.
+  for (uint32_t i = 0; error_message.empty() && (i < num_strips); i++) {
+    error_message = EncodePngChunk(dst, 0x49444154, strips[i]);  // "IDAT".
+    strips[i].clear();
+  }
+  if (error_message.empty()) {
+    chunk.clear();
+    error_message = EncodePngChunk(dst, 0x49454E44, chunk);  // "IEND".
+  }
+  if (!error_message.empty()) {
+    return EncodePngResult("", std::move(error_message));
+  }
+  return EncodePngResult(std::move(dst), "");
+}
+
+#endif  // defined(WUFFS_AUX__ENCODE_PNG)
+
 }  // namespace wuffs_aux
 
 #endif  // !defined(WUFFS_CONFIG__MODULES) ||
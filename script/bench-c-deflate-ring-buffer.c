@@ -0,0 +1,357 @@
+// Copyright 2021 The Wuffs Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// ----------------
+
+// This file contains a hand-written C benchmark of two strategies for a
+// bounded-memory, streaming gzip decoder. Its input is a gzip file on stdin.
+//
+// The "Flat" strategy is what example/zcat does: decode into a fixed size dst
+// buffer, consume its contents and then reset it to empty. The dst buffer
+// never holds any history, so the deflate decoder copies (up to) the last 32
+// KiB of its output into its own history array each time it suspends, and
+// back-references that reach before dst's start copy out of that array.
+//
+// The "Ring" strategy decodes into a ring buffer whose N bytes of physical
+// memory are mapped three times into contiguous virtual memory, as per the
+// script/mmap-ring-buffer.c program. Each transform_io call's dst starts (up
+// to) 32 KiB before the write position, so that dst always holds the history,
+// and the WUFFS_DEFLATE__QUIRK_DST_HOLDS_HISTORY quirk tells the decoder so.
+// The decoder's own history array is unused and wrapping around the ring is
+// implicit, so no bytes are shuffled.
+//
+// Both strategies use N = 128 KiB of dst memory. Checksum verification is
+// disabled (for both), to focus on the deflate decoder.
+//
+// This program is Linux-specific, as it uses memfd_create. Build and run it
+// with something like:
+//
+// gcc -O3 bench-c-deflate-ring-buffer.c && ./a.out < ../test/data/pi.txt.gz
+//
+// For example, with gcc 12.2 (and -O3) on a 1.3 MB file (pi.txt and
+// midsummer.txt, concatenated 12 times, then "gzip -9"):
+//
+// BenchmarkFlat/gcc  10  4491300 ns/op  296.755 MB/s
+// BenchmarkRing/gcc  10  4136000 ns/op  322.248 MB/s
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+// Wuffs ships as a "single file C library" or "header file library" as per
+// https://github.com/nothings/stb/blob/master/docs/stb_howto.txt
+//
+// To use that single file as a "foo.c"-like implementation, instead of a
+// "foo.h"-like header, #define WUFFS_IMPLEMENTATION before #include'ing or
+// compiling it.
+#define WUFFS_IMPLEMENTATION
+
+// If building this program in an environment that doesn't easily accommodate
+// relative includes, you can use the script/inline-c-relative-includes.go
+// program to generate a stand-alone C file.
+#include "../release/c/wuffs-unsupported-snapshot.c"
+
+// The order matters here. Clang also defines "__GNUC__".
+#if defined(__clang__)
+const char* g_cc = "clang";
+const char* g_cc_version = __clang_version__;
+#elif defined(__GNUC__)
+const char* g_cc = "gcc";
+const char* g_cc_version = __VERSION__;
+#elif defined(_MSC_VER)
+const char* g_cc = "cl";
+const char* g_cc_version = "???";
+#else
+const char* g_cc = "cc";
+const char* g_cc_version = "???";
+#endif
+
+// N is the ring buffer size. It must be a multiple of the page size and at
+// least 32 KiB (the DEFLATE history size) plus the 258 bytes that the deflate
+// decoder's fast paths want to be able to write.
+#define N (128 * 1024)
+#define HISTORY_SIZE (32 * 1024)
+
+#define SRC_BUFFER_ARRAY_SIZE (64 * 1024 * 1024)
+
+uint8_t g_flat_buffer_array[N] = {0};
+uint8_t g_src_buffer_array[SRC_BUFFER_ARRAY_SIZE] = {0};
+size_t g_src_len = 0;
+
+// g_ring_middle is the start of the middle of the ring buffer's three
+// mappings. g_ring_middle[i - N], g_ring_middle[i] and g_ring_middle[i + N]
+// all alias the same physical memory, for i in [0, N).
+uint8_t* g_ring_middle = NULL;
+
+#define WORK_BUFFER_ARRAY_SIZE \
+  WUFFS_GZIP__DECODER_WORKBUF_LEN_MAX_INCL_WORST_CASE
+#if WORK_BUFFER_ARRAY_SIZE > 0
+uint8_t g_work_buffer_array[WORK_BUFFER_ARRAY_SIZE];
+#else
+// Not all C/C++ compilers support 0-length arrays.
+uint8_t g_work_buffer_array[1];
+#endif
+
+// See script/mmap-ring-buffer.c for why we define our own memfd_create.
+static int  //
+my_memfd_create(const char* name, unsigned int flags) {
+  return syscall(__NR_memfd_create, name, flags);
+}
+
+const char*  //
+make_ring_buffer() {
+  int page_size = getpagesize();
+  if ((N < page_size) || (page_size <= 0) || ((N % page_size) != 0)) {
+    return "invalid page size";
+  }
+
+  int memfd = my_memfd_create("ring", 0);
+  if (memfd == -1) {
+    return strerror(errno);
+  }
+  if (ftruncate(memfd, N) == -1) {
+    return strerror(errno);
+  }
+
+  // Have the kernel find a contiguous range of unused address space.
+  uint8_t* base =
+      mmap(NULL, 3 * N, PROT_NONE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+  if (base == MAP_FAILED) {
+    return strerror(errno);
+  }
+
+  // Map that "ring" file 3 times, filling that range exactly.
+  for (int i = 0; i < 3; i++) {
+    void* p = mmap(base + (i * N), N, PROT_READ | PROT_WRITE,
+                   MAP_FIXED | MAP_SHARED, memfd, 0);
+    if (p == MAP_FAILED) {
+      return strerror(errno);
+    }
+  }
+
+  close(memfd);
+  g_ring_middle = base + N;
+  return NULL;
+}
+
+const char*  //
+read_stdin() {
+  while (g_src_len < SRC_BUFFER_ARRAY_SIZE) {
+    const int stdin_fd = 0;
+    ssize_t n = read(stdin_fd, g_src_buffer_array + g_src_len,
+                     SRC_BUFFER_ARRAY_SIZE - g_src_len);
+    if (n > 0) {
+      g_src_len += n;
+    } else if (n == 0) {
+      return NULL;
+    } else if (errno == EINTR) {
+      // No-op.
+    } else {
+      return strerror(errno);
+    }
+  }
+  return "input is too large";
+}
+
+// consume is where a real program would write the decoded output somewhere.
+// This program only checksums it, if hasher is non-NULL.
+static inline void  //
+consume(wuffs_crc32__ieee_hasher* hasher, uint8_t* ptr, size_t len) {
+  if (hasher) {
+    wuffs_crc32__ieee_hasher__update_u32(hasher,
+                                         wuffs_base__make_slice_u8(ptr, len));
+  }
+}
+
+const char*  //
+decode_once(bool ring,
+            wuffs_crc32__ieee_hasher* hasher,
+            uint64_t* num_dst_bytes) {
+  wuffs_gzip__decoder dec;
+  wuffs_base__status status =
+      wuffs_gzip__decoder__initialize(&dec, sizeof dec, WUFFS_VERSION, 0);
+  if (!wuffs_base__status__is_ok(&status)) {
+    return wuffs_base__status__message(&status);
+  }
+  wuffs_gzip__decoder__set_quirk_enabled(
+      &dec, WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, true);
+  if (ring) {
+    wuffs_gzip__decoder__set_quirk_enabled(
+        &dec, WUFFS_DEFLATE__QUIRK_DST_HOLDS_HISTORY, true);
+  }
+
+  wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+      .data = ((wuffs_base__slice_u8){
+          .ptr = g_src_buffer_array,
+          .len = g_src_len,
+      }),
+      .meta = ((wuffs_base__io_buffer_meta){
+          .wi = g_src_len,
+          .ri = 0,
+          .pos = 0,
+          .closed = true,
+      }),
+  });
+
+  uint64_t pos = 0;
+  while (true) {
+    wuffs_base__io_buffer dst;
+    size_t h = 0;
+    if (ring) {
+      // The dst holds h bytes of history and then (N - HISTORY_SIZE) bytes of
+      // space to write to. Both ends are within the three mappings, as
+      // (pos % N) is in [0, N) and h is at most HISTORY_SIZE.
+      h = (pos < HISTORY_SIZE) ? pos : HISTORY_SIZE;
+      dst = wuffs_base__ptr_u8__writer(g_ring_middle + (pos % N) - h,
+                                       h + (N - HISTORY_SIZE));
+      dst.meta.wi = h;
+      dst.meta.ri = h;
+    } else {
+      dst = wuffs_base__ptr_u8__writer(g_flat_buffer_array, N);
+    }
+
+    status = wuffs_gzip__decoder__transform_io(
+        &dec, &dst, &src,
+        wuffs_base__make_slice_u8(g_work_buffer_array, WORK_BUFFER_ARRAY_SIZE));
+    consume(hasher, dst.data.ptr + h, dst.meta.wi - h);
+    pos += dst.meta.wi - h;
+
+    if (wuffs_base__status__is_ok(&status)) {
+      break;
+    } else if (status.repr != wuffs_base__suspension__short_write) {
+      return wuffs_base__status__message(&status);
+    }
+  }
+
+  *num_dst_bytes = pos;
+  return NULL;
+}
+
+const char*  //
+verify() {
+  uint32_t checksums[2] = {0};
+  uint64_t num_dst_bytes[2] = {0};
+  for (int ring = 0; ring < 2; ring++) {
+    wuffs_crc32__ieee_hasher hasher;
+    wuffs_base__status status = wuffs_crc32__ieee_hasher__initialize(
+        &hasher, sizeof hasher, WUFFS_VERSION, 0);
+    if (!wuffs_base__status__is_ok(&status)) {
+      return wuffs_base__status__message(&status);
+    }
+    const char* msg = decode_once(ring, &hasher, &num_dst_bytes[ring]);
+    if (msg) {
+      return msg;
+    }
+    checksums[ring] = wuffs_crc32__ieee_hasher__update_u32(
+        &hasher, wuffs_base__empty_slice_u8());
+  }
+  if ((checksums[0] != checksums[1]) ||
+      (num_dst_bytes[0] != num_dst_bytes[1])) {
+    return "Flat and Ring outputs differ";
+  }
+  return NULL;
+}
+
+const char*  //
+decode(bool ring) {
+  int reps;
+  if (g_src_len < 10000) {
+    reps = 1000;
+  } else if (g_src_len < 100000) {
+    reps = 100;
+  } else if (g_src_len < 1000000) {
+    reps = 10;
+  } else {
+    reps = 1;
+  }
+
+  struct timeval bench_start_tv;
+  gettimeofday(&bench_start_tv, NULL);
+
+  uint64_t num_dst_bytes = 0;
+  int i;
+  for (i = 0; i < reps; i++) {
+    const char* msg = decode_once(ring, NULL, &num_dst_bytes);
+    if (msg) {
+      return msg;
+    }
+  }
+
+  struct timeval bench_finish_tv;
+  gettimeofday(&bench_finish_tv, NULL);
+  int64_t micros =
+      (int64_t)(bench_finish_tv.tv_sec - bench_start_tv.tv_sec) * 1000000 +
+      (int64_t)(bench_finish_tv.tv_usec - bench_start_tv.tv_usec);
+  uint64_t nanos = 1;
+  if (micros > 0) {
+    nanos = (uint64_t)(micros)*1000;
+  }
+
+  printf("Benchmark%s/%s\t%8d\t%8" PRIu64 " ns/op\t%8.3f MB/s\n",
+         ring ? "Ring" : "Flat", g_cc, reps, nanos / reps,
+         ((double)(num_dst_bytes * reps) * 1e3) / ((double)(nanos)));
+
+  return NULL;
+}
+
+int  //
+fail(const char* msg) {
+  const int stderr_fd = 2;
+  write(stderr_fd, msg, strnlen(msg, 4095));
+  write(stderr_fd, "\n", 1);
+  return 1;
+}
+
+int  //
+main(int argc, char** argv) {
+  const char* msg = read_stdin();
+  if (msg) {
+    return fail(msg);
+  }
+  msg = make_ring_buffer();
+  if (msg) {
+    return fail(msg);
+  }
+  msg = verify();
+  if (msg) {
+    return fail(msg);
+  }
+
+  printf("# %s version %s\n#\n", g_cc, g_cc_version);
+  printf(
+      "# The output format, including the \"Benchmark\" prefixes, is "
+      "compatible with the\n"
+      "# https://godoc.org/golang.org/x/perf/cmd/benchstat tool. To install "
+      "it, first\n"
+      "# install Go, then run \"go get golang.org/x/perf/cmd/benchstat\".\n");
+
+  int i;
+  for (i = 0; i < 5; i++) {
+    msg = decode(false);
+    if (msg) {
+      return fail(msg);
+    }
+    msg = decode(true);
+    if (msg) {
+      return fail(msg);
+    }
+  }
+
+  return 0;
+}
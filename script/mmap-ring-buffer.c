@@ -30,7 +30,9 @@
 // wrapping, both forwards (after the middle mapping's end) and backwards
 // (before the middle mapping's start). That web page only considers forwards
 // reads or writes. Backwards reads are useful when decoding a Lempel-Ziv style
-// compression format, copying from history (recently decoded bytes).
+// compression format, copying from history (recently decoded bytes). The
+// script/bench-c-deflate-ring-buffer.c program uses this technique with the
+// Wuffs deflate decoder's QUIRK_DST_HOLDS_HISTORY.
 //
 // Its output should be:
 //
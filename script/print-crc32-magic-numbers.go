@@ -34,14 +34,53 @@ func main() {
 }
 
 func main1() error {
-	tables := [16]crc32.Table{}
-	tables[0] = *crc32.MakeTable(crc32.IEEE)
+	fmt.Println("// IEEE_TABLE")
+	printSlicingTables(crc32.IEEE, 16)
+	fmt.Println()
 
-	// See "Multi-Byte Lookup Tables" in std/crc32/README.md for more detail on
-	// the slicing-by-M algorithm. We use an M of 16.
+	// x2n[k] is x**(2**k) modulo the CRC-32 polynomial, in the bit-reflected
+	// format. It is used by ieee_hasher.combine_u32.
+	x2n := [32]uint32{}
+	x2n[0] = 0x4000_0000
+	for k := 1; k < 32; k++ {
+		x2n[k] = multiplyModP(crc32.IEEE, x2n[k-1], x2n[k-1])
+	}
+	fmt.Println("// IEEE_X2N_TABLE")
+	for k, x := range x2n {
+		fmt.Printf("0x%08X,", x)
+		if k&3 == 3 {
+			fmt.Println()
+		}
+	}
+	fmt.Println()
+
+	fmt.Println("// CASTAGNOLI_TABLE")
+	printSlicingTables(crc32.Castagnoli, 8)
+	fmt.Println()
+
+	// castagnoli_hasher.up_x86_sse42 runs three streams of n bytes each, and
+	// then shifts the first two streams' CRCs by 2*n and n bytes. Shifting
+	// crc by n bytes is multiplying it by x**(8*n). A carry-less multiply by
+	// x**(8*n - 33), followed by the crc32 instruction's 64-to-32 bit
+	// reduction (which multiplies by x**32), does that, as the carry-less
+	// multiply (in the bit-reflected format) also multiplies by x.
+	fmt.Println("// CASTAGNOLI_X86_SSE42_SHIFT_ETC")
+	for _, n := range []int{128, 1024} {
+		fmt.Printf("n=%d: shift by 2*n: 0x%08X, shift by n: 0x%08X\n", n,
+			xPowNModP(crc32.Castagnoli, (16*n)-33),
+			xPowNModP(crc32.Castagnoli, (8*n)-33))
+	}
+	return nil
+}
+
+// printSlicingTables prints the m tables for the slicing-by-M algorithm. See
+// "Multi-Byte Lookup Tables" in std/crc32/README.md for more detail.
+func printSlicingTables(poly uint32, m int) {
+	tables := make([]crc32.Table, m)
+	tables[0] = *crc32.MakeTable(poly)
 	for i := 0; i < 256; i++ {
 		crc := tables[0][i]
-		for j := 1; j < 16; j++ {
+		for j := 1; j < m; j++ {
 			crc = tables[0][crc&0xFF] ^ (crc >> 8)
 			tables[j][i] = crc
 		}
@@ -58,5 +97,31 @@ func main1() error {
 			}
 		}
 	}
-	return nil
+	fmt.Println("]]")
+}
+
+// xPowNModP returns x**n modulo the polynomial, in the bit-reflected format.
+func xPowNModP(poly uint32, n int) (p uint32) {
+	p = 0x8000_0000
+	for ; n > 0; n-- {
+		p = multiplyModP(poly, p, 0x4000_0000)
+	}
+	return p
+}
+
+// multiplyModP returns (a * b) modulo the polynomial, where a and b are
+// polynomials in the bit-reflected format: the high bit is the x**0
+// coefficient.
+func multiplyModP(poly uint32, a uint32, b uint32) (p uint32) {
+	for m := uint32(0x8000_0000); m != 0; m >>= 1 {
+		if a&m != 0 {
+			p ^= b
+		}
+		if b&1 != 0 {
+			b = (b >> 1) ^ poly
+		} else {
+			b >>= 1
+		}
+	}
+	return p
 }
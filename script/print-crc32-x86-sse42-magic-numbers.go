@@ -45,6 +45,10 @@ package main
 // k5' = 0x1_63CD_6124
 // k6' = 0x1_DB71_0640
 // μ'  = 0x1_F701_1641
+//
+// The 2048-bit folding numbers (the bit-reflected format).
+// k1' = 0x1_1542_778A
+// k2' = 0x1_322D_1430
 
 import (
 	"fmt"
@@ -63,7 +67,7 @@ const px = "100000100110000010001110110110111"
 // P(x)' = 0x1_11011011_01110001_00000110_01000001
 const pxdash = "111011011011100010000011001000001"
 
-var spaces = strings.Repeat(" ", 1024)
+var spaces = strings.Repeat(" ", 4096)
 
 func debugf(format string, a ...interface{}) {
 	if false { // Change false to true to show the long divisions.
@@ -148,4 +152,12 @@ func main() {
 	calcKn("k5'", 64)
 	calcKn("k6'", 32)
 	calcMu("μ' ")
+
+	fmt.Println()
+
+	// The AVX-512 (VPCLMULQDQ) implementation folds four 512-bit registers
+	// at a time, for a folding distance of 4×512 = 2048 bits instead of 512.
+	fmt.Println("The 2048-bit folding numbers (the bit-reflected format).")
+	calcKn("k1'", 2048+32)
+	calcKn("k2'", 2048-32)
 }
@@ -0,0 +1,900 @@
+// Copyright 2021 The Wuffs Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// ----------------
+
+/*
+This test program checks the wuffs_aux (auxiliary C++) Deflate API: functions
+like wuffs_aux::DecodeDeflate. Unlike the test/c/std programs, it is C++, not
+C, and is not run by the "wuffs test" command.
+
+To manually run this test:
+
+for CXX in clang++ g++; do
+  $CXX -std=c++11 -Wall -Werror -pthread deflate.cc && ./a.out
+  rm -f a.out
+done
+
+Each edition should print "PASS", amongst other information, and exit(0).
+*/
+
+#if defined(__cplusplus) && (__cplusplus < 201103L)
+#error "This C++ program requires -std=c++11 or later"
+#endif
+
+#include <string>
+#include <vector>
+
+// Split the input into small chunks, so that even the small test/data files
+// are decoded in parallel.
+#define WUFFS_AUX__DECODE_DEFLATE__CHUNK_LENGTH 4096
+
+// Likewise, use small batches of gzip members.
+#define WUFFS_AUX__DECODE_GZIP_MEMBERS__BATCH_LENGTH 65536
+
+// Wuffs ships as a "single file C library" or "header file library" as per
+// https://github.com/nothings/stb/blob/master/docs/stb_howto.txt
+//
+// To use that single file as a "foo.c"-like implementation, instead of a
+// "foo.h"-like header, #define WUFFS_IMPLEMENTATION before #include'ing or
+// compiling it.
+#define WUFFS_IMPLEMENTATION
+
+// Defining the WUFFS_CONFIG__MODULE* macros are optional, but it lets users of
+// release/c/etc.c choose which parts of Wuffs to build. That file contains the
+// entire Wuffs standard library, implementing a variety of codecs and file
+// formats. Without this macro definition, an optimizing compiler or linker may
+// very well discard Wuffs code for unused codecs, but listing the Wuffs
+// modules we use makes that process explicit. Preprocessing means that such
+// code simply isn't compiled.
+#define WUFFS_CONFIG__MODULES
+#define WUFFS_CONFIG__MODULE__ADLER32
+#define WUFFS_CONFIG__MODULE__AUX__BASE
+#define WUFFS_CONFIG__MODULE__AUX__DEFLATE
+#define WUFFS_CONFIG__MODULE__BASE
+#define WUFFS_CONFIG__MODULE__CRC32
+#define WUFFS_CONFIG__MODULE__DEFLATE
+#define WUFFS_CONFIG__MODULE__GZIP
+#define WUFFS_CONFIG__MODULE__ZLIB
+
+// If building this program in an environment that doesn't easily accommodate
+// relative includes, you can use the script/inline-c-relative-includes.go
+// program to generate a stand-alone C++ file.
+#include "../../../release/c/wuffs-unsupported-snapshot.c"
+#include "../testlib/testlib.c"
+
+// ---------------- Utilities
+
+// OutputCallbacks collects the decoded output.
+class OutputCallbacks : public wuffs_aux::DecodeDeflateCallbacks {
+ public:
+  std::string Append(const uint8_t* ptr, size_t len) override {
+    m_output.append((const char*)ptr, len);
+    return "";
+  }
+
+  std::string m_output;
+};
+
+// BatchCallbacks collects the decoded output of each input.
+class BatchCallbacks : public wuffs_aux::DecodeDeflateBatchCallbacks {
+ public:
+  explicit BatchCallbacks(size_t n) : m_outputs(n) {}
+
+  std::string Append(size_t i, const uint8_t* ptr, size_t len) override {
+    m_outputs[i].append((const char*)ptr, len);
+    return "";
+  }
+
+  std::vector<std::string> m_outputs;
+};
+
+// read_file_to_string loads path (which may include "@123=45=67;" patches, as
+// per read_file) into s.
+const char*  //
+read_file_to_string(std::string* s, const char* path) {
+  wuffs_base__io_buffer src = wuffs_base__slice_u8__writer(g_src_slice_u8);
+  const char* z = read_file(&src, path);
+  if (z) {
+    return z;
+  }
+  s->assign((const char*)(src.data.ptr), src.meta.wi);
+  return nullptr;
+}
+
+// encode compresses src into dst, using Wuffs' encoders. The framing is as
+// for wuffs_aux::DecodeDeflate: 0 means raw DEFLATE.
+const char*  //
+encode(std::string* dst, const std::string& src, uint32_t framing) {
+  wuffs_base__io_transformer::unique_ptr enc(nullptr, &free);
+  switch (framing) {
+    case 0:
+      enc = wuffs_deflate__encoder::alloc_as__wuffs_base__io_transformer();
+      break;
+    case WUFFS_BASE__FOURCC__GZ:
+      enc = wuffs_gzip__encoder::alloc_as__wuffs_base__io_transformer();
+      break;
+    case WUFFS_BASE__FOURCC__ZLIB:
+      enc = wuffs_zlib__encoder::alloc_as__wuffs_base__io_transformer();
+      break;
+  }
+  if (!enc) {
+    RETURN_FAIL("encode: could not allocate the encoder");
+  }
+
+  // Stored blocks, the worst case, add 5 bytes per 32 KiB.
+  dst->resize(src.size() + (src.size() / 1024) + 1024);
+  wuffs_base__io_buffer dst_buf =
+      wuffs_base__ptr_u8__writer((uint8_t*)(&(*dst)[0]), dst->size());
+  wuffs_base__io_buffer src_buf = wuffs_base__ptr_u8__reader(
+      (uint8_t*)(const_cast<char*>(src.data())), src.size(), true);
+  CHECK_STATUS("transform_io",
+               enc->transform_io(&dst_buf, &src_buf, g_work_slice_u8));
+  dst->resize(dst_buf.meta.wi);
+  return nullptr;
+}
+
+// append_gzip_member appends a gzip member, holding the compressed original,
+// to dst. If bgzf is true, the member's header has a BGZF "BC" subfield.
+const char*  //
+append_gzip_member(std::string* dst, const std::string& original, bool bgzf) {
+  if (!bgzf) {
+    std::string member;
+    CHECK_STRING(encode(&member, original, WUFFS_BASE__FOURCC__GZ));
+    dst->append(member);
+    return nullptr;
+  }
+
+  std::string deflate;
+  CHECK_STRING(encode(&deflate, original, 0));
+  size_t member_len = 18 + deflate.size() + 8;
+  if (member_len > 65536) {
+    RETURN_FAIL("append_gzip_member: BGZF member is too long");
+  }
+  uint8_t header[18] = {
+      0x1F, 0x8B, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0xFF, 0x06, 0x00, 'B',  'C',  0x02, 0x00, 0x00, 0x00,
+  };
+  wuffs_base__poke_u16le__no_bounds_check(header + 16,
+                                          (uint16_t)(member_len - 1));
+
+  wuffs_crc32__ieee_hasher h;
+  CHECK_STATUS("initialize", h.initialize(sizeof h, WUFFS_VERSION, 0));
+  uint8_t trailer[8];
+  wuffs_base__poke_u32le__no_bounds_check(
+      trailer + 0,
+      h.update_u32(wuffs_base__make_slice_u8(
+          (uint8_t*)(const_cast<char*>(original.data())), original.size())));
+  wuffs_base__poke_u32le__no_bounds_check(trailer + 4,
+                                          (uint32_t)(original.size()));
+
+  dst->append((const char*)header, sizeof header);
+  dst->append(deflate);
+  dst->append((const char*)trailer, sizeof trailer);
+  return nullptr;
+}
+
+// ---------------- Deflate Tests
+
+// do_test_multi_threaded checks that decoding src with multiple threads gives
+// the same output and error message as decoding it with one thread. If want
+// is non-null, it also checks that the single-threaded output is *want.
+const char*  //
+do_test_multi_threaded(const char* name,
+                       const std::string& src,
+                       uint32_t framing,
+                       bool want_ok,
+                       const std::string* want) {
+  OutputCallbacks serial_callbacks;
+  wuffs_aux::sync_io::MemoryInput serial_input(src.data(), src.size());
+  wuffs_aux::DecodeDeflateResult serial =
+      wuffs_aux::DecodeDeflate(serial_callbacks, serial_input, framing, 1);
+  if (serial.error_message.empty() != want_ok) {
+    RETURN_FAIL("%s: single-threaded: error_message: \"%s\"", name,
+                serial.error_message.c_str());
+  } else if (want && (serial_callbacks.m_output != *want)) {
+    RETURN_FAIL("%s: single-threaded: output differs", name);
+  }
+
+  for (uint32_t num_threads = 2; num_threads <= 8; num_threads *= 2) {
+    OutputCallbacks have_callbacks;
+    wuffs_aux::sync_io::MemoryInput have_input(src.data(), src.size());
+    wuffs_aux::DecodeDeflateResult have = wuffs_aux::DecodeDeflate(
+        have_callbacks, have_input, framing, num_threads);
+    if (have.error_message != serial.error_message) {
+      RETURN_FAIL("%s, num_threads=%d: error_message: have \"%s\", want "
+                  "\"%s\"",
+                  name, (int)num_threads, have.error_message.c_str(),
+                  serial.error_message.c_str());
+    } else if (have.num_dst_bytes != serial.num_dst_bytes) {
+      RETURN_FAIL("%s, num_threads=%d: num_dst_bytes: have %" PRIu64
+                  ", want %" PRIu64,
+                  name, (int)num_threads, have.num_dst_bytes,
+                  serial.num_dst_bytes);
+    } else if (have_callbacks.m_output != serial_callbacks.m_output) {
+      RETURN_FAIL("%s, num_threads=%d: output differs", name,
+                  (int)num_threads);
+    }
+  }
+  return nullptr;
+}
+
+const char*  //
+test_wuffs_aux_deflate_decode_multi_threaded_golden() {
+  CHECK_FOCUS(__func__);
+
+  const uint32_t gz = WUFFS_BASE__FOURCC__GZ;
+  const uint32_t zlib = WUFFS_BASE__FOURCC__ZLIB;
+  struct {
+    const char* filename;
+    uint32_t framing;
+    // If non-zero, truncate_length is the number of input bytes to keep.
+    size_t truncate_length;
+  } test_cases[] = {
+      {"test/data/archive.tar.gz", gz, 0},
+      {"test/data/midsummer.txt.gz", gz, 0},
+      {"test/data/midsummer.txt.zlib", zlib, 0},
+      {"test/data/pi.txt.gz", gz, 0},
+      {"test/data/pi.txt.zlib", zlib, 0},
+      {"test/data/romeo.txt.gz", gz, 0},
+      {"test/data/romeo.txt.zlib", zlib, 0},
+      // Truncated inputs.
+      {"test/data/pi.txt.gz", gz, 30000},
+      {"test/data/pi.txt.zlib", zlib, 12345},
+      // Corrupted inputs.
+      {"@0000=1F=1E;test/data/pi.txt.gz", gz, 0},
+      {"@0800=5D=DD;test/data/pi.txt.gz", gz, 0},
+      {"@6000=48=49;test/data/pi.txt.gz", gz, 0},
+      {"@6000=61=60;test/data/pi.txt.zlib", zlib, 0},
+  };
+
+  for (size_t tc = 0; tc < WUFFS_TESTLIB_ARRAY_SIZE(test_cases); tc++) {
+    std::string src;
+    CHECK_STRING(read_file_to_string(&src, test_cases[tc].filename));
+    if (test_cases[tc].truncate_length > 0) {
+      src.resize(test_cases[tc].truncate_length);
+    }
+    bool want_ok = (test_cases[tc].truncate_length == 0) &&
+                   (test_cases[tc].filename[0] != '@');
+    CHECK_STRING(do_test_multi_threaded(test_cases[tc].filename, src,
+                                        test_cases[tc].framing, want_ok,
+                                        nullptr));
+  }
+  return nullptr;
+}
+
+const char*  //
+test_wuffs_aux_deflate_decode_multi_threaded_many_blocks() {
+  CHECK_FOCUS(__func__);
+
+  // The test/data *.gz and *.zlib files have few DEFLATE blocks, so the
+  // parallel decoder finds few (if any) chunk boundaries. Wuffs' encoder
+  // starts a new block for every 32 KiB of input, so re-encoding a larger
+  // file gives a stream with many block boundaries.
+  const char* filenames[] = {
+      "test/data/hibiscus.regular.bmp",
+      "test/data/pi.txt",
+  };
+  const uint32_t framings[] = {
+      0,
+      WUFFS_BASE__FOURCC__GZ,
+      WUFFS_BASE__FOURCC__ZLIB,
+  };
+
+  for (size_t f = 0; f < WUFFS_TESTLIB_ARRAY_SIZE(filenames); f++) {
+    std::string original;
+    CHECK_STRING(read_file_to_string(&original, filenames[f]));
+    for (size_t i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(framings); i++) {
+      std::string src;
+      CHECK_STRING(encode(&src, original, framings[i]));
+      if (src.size() < 100) {
+        RETURN_FAIL("%s: encoded length is too short", filenames[f]);
+      }
+      char name[256];
+      snprintf(name, sizeof(name), "%s (framing=0x%08" PRIX32 ")",
+               filenames[f], framings[i]);
+      CHECK_STRING(
+          do_test_multi_threaded(name, src, framings[i], true, &original));
+
+      std::string truncated = src.substr(0, (src.size() * 3) / 5);
+      CHECK_STRING(do_test_multi_threaded(name, truncated, framings[i],
+                                          false, nullptr));
+
+      // Flipping one bit in the middle of the stream may or may not be
+      // detected (without a checksum), but either way, the multi-threaded
+      // result should match the single-threaded one.
+      std::string corrupted = src;
+      corrupted[corrupted.size() / 2] ^= 0x10;
+      OutputCallbacks callbacks;
+      wuffs_aux::sync_io::MemoryInput input(corrupted.data(),
+                                            corrupted.size());
+      bool want_ok =
+          wuffs_aux::DecodeDeflate(callbacks, input, framings[i], 1)
+              .error_message.empty();
+      if (want_ok && (framings[i] != 0)) {
+        RETURN_FAIL("%s: corrupted: checksum mismatch was not detected",
+                    name);
+      }
+      CHECK_STRING(do_test_multi_threaded(name, corrupted, framings[i],
+                                          want_ok, nullptr));
+    }
+  }
+  return nullptr;
+}
+
+// do_test_index builds an index for the encoding of original, with the given
+// framing, and checks that decoding with the index gives original.
+const char*  //
+do_test_index(wuffs_aux::DecodeDeflateIndex* index,
+              std::string* src,
+              const std::string& original,
+              uint32_t framing,
+              uint64_t spacing) {
+  CHECK_STRING(encode(src, original, framing));
+
+  OutputCallbacks callbacks;
+  wuffs_aux::sync_io::MemoryInput input(src->data(), src->size());
+  wuffs_aux::DecodeDeflateResult result = wuffs_aux::DecodeDeflateWithIndex(
+      callbacks, input, *index, framing, spacing);
+  if (!result.error_message.empty()) {
+    RETURN_FAIL("DecodeDeflateWithIndex: \"%s\"",
+                result.error_message.c_str());
+  } else if (callbacks.m_output != original) {
+    RETURN_FAIL("DecodeDeflateWithIndex: output differs");
+  } else if (index->num_dst_bytes != original.size()) {
+    RETURN_FAIL("num_dst_bytes: have %" PRIu64 ", want %zu",
+                index->num_dst_bytes, original.size());
+  } else if ((index->framing != framing) || (index->spacing != spacing)) {
+    RETURN_FAIL("framing/spacing: have 0x%08" PRIX32 "/%" PRIu64
+                ", want 0x%08" PRIX32 "/%" PRIu64,
+                index->framing, index->spacing, framing, spacing);
+  } else if (index->checkpoints.size() < 3) {
+    RETURN_FAIL("checkpoints.size(): have %zu, want >= 3",
+                index->checkpoints.size());
+  }
+
+  uint64_t prev_dst_pos = 0;
+  for (size_t i = 0; i < index->checkpoints.size(); i++) {
+    const wuffs_aux::DecodeDeflateCheckpoint& c = index->checkpoints[i];
+    if ((i == 0) && (c.dst_pos != 0)) {
+      RETURN_FAIL("checkpoints[0].dst_pos: have %" PRIu64 ", want 0",
+                  c.dst_pos);
+    } else if ((i > 0) && (c.dst_pos < (prev_dst_pos + spacing))) {
+      RETURN_FAIL("checkpoints[%zu].dst_pos: have %" PRIu64
+                  ", want >= %" PRIu64,
+                  i, c.dst_pos, prev_dst_pos + spacing);
+    } else if ((c.src_pos > src->size()) || (c.num_pending_bits >= 8)) {
+      RETURN_FAIL("checkpoints[%zu]: bad src_pos or num_pending_bits", i);
+    }
+    size_t n = (c.dst_pos < 32768) ? ((size_t)(c.dst_pos)) : 32768;
+    if (c.history != original.substr((size_t)(c.dst_pos) - n, n)) {
+      RETURN_FAIL("checkpoints[%zu].history differs", i);
+    }
+    prev_dst_pos = c.dst_pos;
+  }
+  return nullptr;
+}
+
+const char*  //
+test_wuffs_aux_deflate_decode_range() {
+  CHECK_FOCUS(__func__);
+
+  std::string original;
+  CHECK_STRING(
+      read_file_to_string(&original, "test/data/hibiscus.regular.bmp"));
+  const uint64_t spacing = 65536;
+  const uint32_t framings[] = {
+      0,
+      WUFFS_BASE__FOURCC__GZ,
+      WUFFS_BASE__FOURCC__ZLIB,
+  };
+
+  for (size_t i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(framings); i++) {
+    wuffs_aux::DecodeDeflateIndex index;
+    std::string src;
+    CHECK_STRING(do_test_index(&index, &src, original, framings[i], spacing));
+
+    const uint64_t n = original.size();
+    const struct {
+      uint64_t dst_pos;
+      uint64_t dst_len;
+    } ranges[] = {
+        {0, 0},
+        {0, 100},
+        {12345, 1},
+        {spacing - 10, 20},
+        {spacing + 1000, 3 * spacing},
+        {n - 100, 100},
+        {n - 100, 1000},
+        {n, 10},
+        {n / 2, UINT64_MAX},
+    };
+    for (size_t r = 0; r < WUFFS_TESTLIB_ARRAY_SIZE(ranges); r++) {
+      uint64_t dst_pos = ranges[r].dst_pos;
+      uint64_t dst_len = ranges[r].dst_len;
+      const wuffs_aux::DecodeDeflateCheckpoint* c = index.Find(dst_pos);
+      if (!c) {
+        RETURN_FAIL("i=%zu, r=%zu: Find returned nullptr", i, r);
+      }
+      OutputCallbacks callbacks;
+      wuffs_aux::sync_io::MemoryInput input(src.data() + c->src_pos,
+                                            src.size() - c->src_pos);
+      wuffs_aux::DecodeDeflateResult result = wuffs_aux::DecodeDeflateRange(
+          callbacks, input, *c, dst_pos, dst_len);
+      std::string want = original.substr(
+          (size_t)dst_pos,
+          (size_t)((dst_len < (n - dst_pos)) ? dst_len : (n - dst_pos)));
+      if (!result.error_message.empty()) {
+        RETURN_FAIL("i=%zu, r=%zu: DecodeDeflateRange: \"%s\"", i, r,
+                    result.error_message.c_str());
+      } else if ((callbacks.m_output != want) ||
+                 (result.num_dst_bytes != want.size())) {
+        RETURN_FAIL("i=%zu, r=%zu: output differs", i, r);
+      }
+    }
+
+    // A checkpoint after dst_pos is rejected.
+    OutputCallbacks callbacks;
+    const wuffs_aux::DecodeDeflateCheckpoint& c = index.checkpoints.back();
+    wuffs_aux::sync_io::MemoryInput input(src.data() + c.src_pos,
+                                          src.size() - c.src_pos);
+    wuffs_aux::DecodeDeflateResult result = wuffs_aux::DecodeDeflateRange(
+        callbacks, input, c, c.dst_pos - 1, 10);
+    if (result.error_message != wuffs_aux::DecodeDeflate_BadCheckpoint) {
+      RETURN_FAIL("i=%zu: bad checkpoint: have \"%s\", want \"%s\"", i,
+                  result.error_message.c_str(),
+                  wuffs_aux::DecodeDeflate_BadCheckpoint);
+    }
+  }
+  return nullptr;
+}
+
+const char*  //
+test_wuffs_aux_deflate_decode_restore() {
+  CHECK_FOCUS(__func__);
+
+  std::string original;
+  CHECK_STRING(read_file_to_string(&original, "test/data/pi.txt"));
+  wuffs_aux::DecodeDeflateIndex index;
+  std::string src;
+  CHECK_STRING(do_test_index(&index, &src, original, 0, 16384));
+
+  wuffs_deflate__decoder::unique_ptr dec = wuffs_deflate__decoder::alloc();
+  if (!dec) {
+    RETURN_FAIL("alloc: out of memory");
+  }
+  for (size_t i = 0; i < index.checkpoints.size(); i++) {
+    const wuffs_aux::DecodeDeflateCheckpoint& c = index.checkpoints[i];
+    std::string error_message = wuffs_aux::DecodeDeflateRestore(*dec, c);
+    if (!error_message.empty()) {
+      RETURN_FAIL("i=%zu: DecodeDeflateRestore: \"%s\"", i,
+                  error_message.c_str());
+    }
+
+    // Decode the rest of the stream in one call, with a dst buffer that
+    // holds exactly what's left.
+    std::string have(original.size() - (size_t)(c.dst_pos), '\x00');
+    wuffs_base__io_buffer dst =
+        wuffs_base__ptr_u8__writer((uint8_t*)(&have[0]), have.size());
+    wuffs_base__io_buffer src_buf = wuffs_base__ptr_u8__reader(
+        (uint8_t*)(const_cast<char*>(src.data())) + c.src_pos,
+        src.size() - c.src_pos, true);
+    wuffs_base__status status =
+        dec->transform_io(&dst, &src_buf, g_work_slice_u8);
+    if (!status.is_ok()) {
+      RETURN_FAIL("i=%zu: transform_io: \"%s\"", i, status.repr);
+    } else if ((dst.meta.wi != have.size()) ||
+               (have != original.substr((size_t)(c.dst_pos)))) {
+      RETURN_FAIL("i=%zu: output differs", i);
+    }
+  }
+
+  wuffs_aux::DecodeDeflateCheckpoint bad = index.checkpoints[1];
+  bad.num_pending_bits = 8;
+  std::string error_message = wuffs_aux::DecodeDeflateRestore(*dec, bad);
+  if (error_message != wuffs_aux::DecodeDeflate_BadCheckpoint) {
+    RETURN_FAIL("bad checkpoint: have \"%s\", want \"%s\"",
+                error_message.c_str(), wuffs_aux::DecodeDeflate_BadCheckpoint);
+  }
+  return nullptr;
+}
+
+const char*  //
+test_wuffs_aux_deflate_index_serialize_parse() {
+  CHECK_FOCUS(__func__);
+
+  std::string original;
+  CHECK_STRING(read_file_to_string(&original, "test/data/pi.txt"));
+  wuffs_aux::DecodeDeflateIndex index;
+  std::string src;
+  CHECK_STRING(
+      do_test_index(&index, &src, original, WUFFS_BASE__FOURCC__GZ, 16384));
+
+  std::string serialized = index.Serialize();
+  const uint8_t* ptr = (const uint8_t*)(serialized.data());
+  wuffs_aux::DecodeDeflateIndex parsed;
+  std::string error_message = parsed.Parse(ptr, serialized.size());
+  if (!error_message.empty()) {
+    RETURN_FAIL("Parse: \"%s\"", error_message.c_str());
+  } else if ((parsed.framing != index.framing) ||
+             (parsed.spacing != index.spacing) ||
+             (parsed.num_dst_bytes != index.num_dst_bytes) ||
+             (parsed.checkpoints.size() != index.checkpoints.size())) {
+    RETURN_FAIL("Parse: header fields differ");
+  }
+  for (size_t i = 0; i < index.checkpoints.size(); i++) {
+    const wuffs_aux::DecodeDeflateCheckpoint& have = parsed.checkpoints[i];
+    const wuffs_aux::DecodeDeflateCheckpoint& want = index.checkpoints[i];
+    if ((have.dst_pos != want.dst_pos) || (have.src_pos != want.src_pos) ||
+        (have.pending_bits != want.pending_bits) ||
+        (have.num_pending_bits != want.num_pending_bits) ||
+        (have.history != want.history)) {
+      RETURN_FAIL("Parse: checkpoints[%zu] differs", i);
+    }
+  }
+
+  // The parsed index can decode a range.
+  {
+    uint64_t dst_pos = index.checkpoints.back().dst_pos + 77;
+    const wuffs_aux::DecodeDeflateCheckpoint* c = parsed.Find(dst_pos);
+    OutputCallbacks callbacks;
+    wuffs_aux::sync_io::MemoryInput input(src.data() + c->src_pos,
+                                          src.size() - c->src_pos);
+    wuffs_aux::DecodeDeflateResult result =
+        wuffs_aux::DecodeDeflateRange(callbacks, input, *c, dst_pos, 1000);
+    if (!result.error_message.empty()) {
+      RETURN_FAIL("DecodeDeflateRange: \"%s\"", result.error_message.c_str());
+    } else if (callbacks.m_output != original.substr(dst_pos, 1000)) {
+      RETURN_FAIL("DecodeDeflateRange: output differs");
+    }
+  }
+
+  // Every truncation is rejected and leaves the index empty.
+  for (size_t n = 0; n < serialized.size(); n++) {
+    parsed.num_dst_bytes = 1;
+    error_message = parsed.Parse(ptr, n);
+    if (error_message != wuffs_aux::DecodeDeflate_BadIndex) {
+      RETURN_FAIL("truncated to %zu: have \"%s\", want \"%s\"", n,
+                  error_message.c_str(), wuffs_aux::DecodeDeflate_BadIndex);
+    } else if ((parsed.num_dst_bytes != 0) || !parsed.checkpoints.empty()) {
+      RETURN_FAIL("truncated to %zu: index was not emptied", n);
+    }
+  }
+
+  // Corruptions are rejected. The first checkpoint (at offset 28) is at the
+  // start of the stream and has no history. The second one starts at offset
+  // 48: its u64 dst_pos, u64 src_pos, u8 num_pending_bits, u8 pending_bits
+  // and u16 history length are at offsets 48, 56, 64, 65 and 66.
+  const struct {
+    size_t offset;
+    uint8_t value;
+  } corruptions[] = {
+      {0, 'X'},     // Bad magic.
+      {24, 0xFF},   // Too many checkpoints.
+      {64, 0x08},   // num_pending_bits >= 8.
+      {66, 0x01},   // History length disagrees with the rest of the data.
+      {67, 0xFF},   // History length > 32768.
+      {55, 0x80},   // dst_pos is too large, so the next dst_pos decreases.
+  };
+  for (size_t i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(corruptions); i++) {
+    std::string corrupted = serialized;
+    if (((uint8_t)(corrupted[corruptions[i].offset])) ==
+        corruptions[i].value) {
+      RETURN_FAIL("i=%zu: corruption is a no-op", i);
+    }
+    corrupted[corruptions[i].offset] = (char)(corruptions[i].value);
+    error_message =
+        parsed.Parse((const uint8_t*)(corrupted.data()), corrupted.size());
+    if (error_message != wuffs_aux::DecodeDeflate_BadIndex) {
+      RETURN_FAIL("i=%zu: have \"%s\", want \"%s\"", i, error_message.c_str(),
+                  wuffs_aux::DecodeDeflate_BadIndex);
+    }
+  }
+
+  // Trailing data is rejected.
+  std::string extended = serialized + '\x00';
+  error_message =
+      parsed.Parse((const uint8_t*)(extended.data()), extended.size());
+  if (error_message != wuffs_aux::DecodeDeflate_BadIndex) {
+    RETURN_FAIL("extended: have \"%s\", want \"%s\"", error_message.c_str(),
+                wuffs_aux::DecodeDeflate_BadIndex);
+  }
+  return nullptr;
+}
+
+// do_test_gzip_members checks that DecodeGzipMembers with multiple threads
+// gives the same output and error message as with one thread, and that the
+// single-threaded error message is want_error_message.
+const char*  //
+do_test_gzip_members(const char* name,
+                     const std::string& src,
+                     const char* want_error_message,
+                     const std::string* want) {
+  OutputCallbacks serial_callbacks;
+  wuffs_aux::sync_io::MemoryInput serial_input(src.data(), src.size());
+  wuffs_aux::DecodeDeflateResult serial =
+      wuffs_aux::DecodeGzipMembers(serial_callbacks, serial_input, 1);
+  if (serial.error_message != want_error_message) {
+    RETURN_FAIL("%s: single-threaded: error_message: have \"%s\", want "
+                "\"%s\"",
+                name, serial.error_message.c_str(), want_error_message);
+  } else if (want && (serial_callbacks.m_output != *want)) {
+    RETURN_FAIL("%s: single-threaded: output differs", name);
+  } else if (serial.num_dst_bytes != serial_callbacks.m_output.size()) {
+    RETURN_FAIL("%s: single-threaded: num_dst_bytes: have %" PRIu64
+                ", want %zu",
+                name, serial.num_dst_bytes, serial_callbacks.m_output.size());
+  }
+
+  for (uint32_t num_threads = 2; num_threads <= 8; num_threads *= 2) {
+    OutputCallbacks have_callbacks;
+    wuffs_aux::sync_io::MemoryInput have_input(src.data(), src.size());
+    wuffs_aux::DecodeDeflateResult have =
+        wuffs_aux::DecodeGzipMembers(have_callbacks, have_input, num_threads);
+    if (have.error_message != serial.error_message) {
+      RETURN_FAIL("%s, num_threads=%d: error_message: have \"%s\", want "
+                  "\"%s\"",
+                  name, (int)num_threads, have.error_message.c_str(),
+                  serial.error_message.c_str());
+    } else if (have.num_dst_bytes != serial.num_dst_bytes) {
+      RETURN_FAIL("%s, num_threads=%d: num_dst_bytes: have %" PRIu64
+                  ", want %" PRIu64,
+                  name, (int)num_threads, have.num_dst_bytes,
+                  serial.num_dst_bytes);
+    } else if (have_callbacks.m_output != serial_callbacks.m_output) {
+      RETURN_FAIL("%s, num_threads=%d: output differs", name,
+                  (int)num_threads);
+    }
+  }
+  return nullptr;
+}
+
+const char*  //
+test_wuffs_aux_deflate_decode_gzip_members() {
+  CHECK_FOCUS(__func__);
+
+  // Concatenated test/data files.
+  {
+    std::string src;
+    std::string want;
+    const char* filenames[] = {
+        "test/data/pi.txt",
+        "test/data/romeo.txt",
+        "test/data/midsummer.txt",
+    };
+    for (size_t i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(filenames); i++) {
+      std::string s;
+      CHECK_STRING(read_file_to_string(&s, filenames[i]));
+      want.append(s);
+      std::string gz_filename = std::string(filenames[i]) + ".gz";
+      CHECK_STRING(read_file_to_string(&s, gz_filename.c_str()));
+      src.append(s);
+    }
+    CHECK_STRING(do_test_gzip_members("concatenated", src, "", &want));
+  }
+
+  // A BGZF file: 32 KiB pieces of a larger file, then (mixed in) a regular
+  // gzip member, a BGZF member that decodes to more than the batch length and
+  // BGZF's empty end-of-file member.
+  std::string original;
+  CHECK_STRING(
+      read_file_to_string(&original, "test/data/hibiscus.regular.bmp"));
+  std::string src;
+  std::string want;
+  std::vector<size_t> member_offsets;
+  for (size_t i = 0; i < original.size(); i += 32768) {
+    std::string piece = original.substr(i, 32768);
+    member_offsets.push_back(src.size());
+    CHECK_STRING(append_gzip_member(&src, piece, (i != 5 * 32768)));
+    want.append(piece);
+  }
+  {
+    std::string zeroes(200000, '\x00');
+    member_offsets.push_back(src.size());
+    CHECK_STRING(append_gzip_member(&src, zeroes, true));
+    want.append(zeroes);
+    member_offsets.push_back(src.size());
+    CHECK_STRING(append_gzip_member(&src, "", true));
+  }
+  CHECK_STRING(do_test_gzip_members("bgzf", src, "", &want));
+
+  const std::string bad_checksum =
+      wuffs_base__make_status(wuffs_gzip__error__bad_checksum).message();
+  const std::string bad_header =
+      wuffs_base__make_status(wuffs_gzip__error__bad_header).message();
+  const std::string unexpected_eof =
+      wuffs_aux::DecodeDeflate_UnexpectedEndOfFile;
+
+  // A bad CRC-32 in the fourth member. Its trailer is just before the fifth
+  // member.
+  {
+    std::string corrupted = src;
+    corrupted[member_offsets[4] - 8] ^= 0x01;
+    std::string prefix = want.substr(0, 4 * 32768);
+    CHECK_STRING(do_test_gzip_members("bgzf (bad CRC)", corrupted,
+                                      bad_checksum.c_str(), &prefix));
+  }
+
+  // A bad ISIZE in the third member.
+  {
+    std::string corrupted = src;
+    corrupted[member_offsets[3] - 4] ^= 0x01;
+    std::string prefix = want.substr(0, 3 * 32768);
+    CHECK_STRING(do_test_gzip_members("bgzf (bad ISIZE)", corrupted,
+                                      bad_checksum.c_str(), &prefix));
+  }
+
+  // Corrupted DEFLATE data in the middle of the seventh member.
+  {
+    std::string corrupted = src;
+    corrupted[(member_offsets[6] + member_offsets[7]) / 2] ^= 0x10;
+    OutputCallbacks callbacks;
+    wuffs_aux::sync_io::MemoryInput input(corrupted.data(), corrupted.size());
+    std::string want_error_message =
+        wuffs_aux::DecodeGzipMembers(callbacks, input, 1).error_message;
+    if (want_error_message.empty()) {
+      RETURN_FAIL("bgzf (bad DEFLATE): corruption was not detected");
+    }
+    CHECK_STRING(do_test_gzip_members("bgzf (bad DEFLATE)", corrupted,
+                                      want_error_message.c_str(), nullptr));
+  }
+
+  // Truncated in the middle of a member and in the middle of a header.
+  {
+    std::string truncated =
+        src.substr(0, (member_offsets[8] + member_offsets[9]) / 2);
+    CHECK_STRING(do_test_gzip_members("bgzf (truncated member)", truncated,
+                                      unexpected_eof.c_str(), nullptr));
+    truncated = src.substr(0, member_offsets[9] + 5);
+    std::string prefix = want.substr(0, 9 * 32768);
+    CHECK_STRING(do_test_gzip_members("bgzf (truncated header)", truncated,
+                                      unexpected_eof.c_str(), &prefix));
+  }
+
+  // Trailing garbage.
+  {
+    std::string extended = src + "garbage";
+    CHECK_STRING(do_test_gzip_members("bgzf (trailing garbage)", extended,
+                                      bad_header.c_str(), &want));
+  }
+  return nullptr;
+}
+
+const char*  //
+test_wuffs_aux_deflate_decode_batch() {
+  CHECK_FOCUS(__func__);
+
+  // A raw DEFLATE stream with two fixed-Huffman blocks: 20 literals and then
+  // a copy whose distance (25) reaches back before the start of the output.
+  static const uint8_t bad_distance[] = {
+      0x4A, 0x4C, 0x4A, 0x4E, 0x49, 0x4D, 0x4B, 0xCF, 0xC8,
+      0xCC, 0xCA, 0xCE, 0xC9, 0xCD, 0xCB, 0x2F, 0x28, 0x2C,
+      0x2A, 0x2E, 0x01, 0x0C, 0x21, 0x01, 0x00,
+  };
+
+  const char* filenames[] = {
+      "test/data/romeo.txt",
+      "test/data/hibiscus.regular.bmp",
+      "test/data/pi.txt",
+      "test/data/midsummer.txt",
+  };
+  const uint32_t framings[] = {
+      0,
+      WUFFS_BASE__FOURCC__GZ,
+      WUFFS_BASE__FOURCC__ZLIB,
+  };
+
+  for (size_t i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(framings); i++) {
+    // Alternate good and bad inputs, so that each one is decoded (and
+    // interleaved) alongside both.
+    std::vector<std::string> srcs;
+    std::vector<bool> wants_ok;
+    for (size_t f = 0; f < WUFFS_TESTLIB_ARRAY_SIZE(filenames); f++) {
+      std::string original;
+      CHECK_STRING(read_file_to_string(&original, filenames[f]));
+      std::string src;
+      CHECK_STRING(encode(&src, original, framings[i]));
+      srcs.push_back(src);
+      wants_ok.push_back(true);
+      for (size_t k = 1; k <= 2; k++) {
+        std::string corrupted = src;
+        corrupted[(k * corrupted.size()) / 3] ^= 0x04;
+        srcs.push_back(corrupted);
+        wants_ok.push_back(false);
+      }
+      srcs.push_back(src.substr(0, src.size() / 2));
+      wants_ok.push_back(false);
+    }
+    if (framings[i] == 0) {
+      srcs.push_back(std::string((const char*)bad_distance,
+                                 sizeof bad_distance));
+      wants_ok.push_back(false);
+    }
+
+    std::vector<wuffs_base__slice_u8> inputs;
+    for (auto& src : srcs) {
+      inputs.push_back(wuffs_base__make_slice_u8(
+          (uint8_t*)(const_cast<char*>(src.data())), src.size()));
+    }
+    BatchCallbacks batch_callbacks(inputs.size());
+    std::vector<wuffs_aux::DecodeDeflateResult> results =
+        wuffs_aux::DecodeDeflateBatch(batch_callbacks, inputs, framings[i]);
+    if (results.size() != inputs.size()) {
+      RETURN_FAIL("i=%zu: results.size(): have %zu, want %zu", i,
+                  results.size(), inputs.size());
+    }
+
+    for (size_t j = 0; j < srcs.size(); j++) {
+      OutputCallbacks want_callbacks;
+      wuffs_aux::sync_io::MemoryInput want_input(srcs[j].data(),
+                                                 srcs[j].size());
+      wuffs_aux::DecodeDeflateResult want =
+          wuffs_aux::DecodeDeflate(want_callbacks, want_input, framings[i]);
+      // A flipped bit in raw DEFLATE may go undetected, but a checksum or a
+      // truncation catches it otherwise.
+      if ((framings[i] != 0) && (want.error_message.empty() != wants_ok[j])) {
+        RETURN_FAIL("i=%zu, j=%zu: DecodeDeflate: error_message: \"%s\"", i,
+                    j, want.error_message.c_str());
+      }
+      if (results[j].error_message != want.error_message) {
+        RETURN_FAIL("i=%zu, j=%zu: error_message: have \"%s\", want \"%s\"",
+                    i, j, results[j].error_message.c_str(),
+                    want.error_message.c_str());
+      } else if (results[j].num_dst_bytes != want.num_dst_bytes) {
+        RETURN_FAIL("i=%zu, j=%zu: num_dst_bytes: have %" PRIu64
+                    ", want %" PRIu64,
+                    i, j, results[j].num_dst_bytes, want.num_dst_bytes);
+      } else if (batch_callbacks.m_outputs[j] != want_callbacks.m_output) {
+        RETURN_FAIL("i=%zu, j=%zu: output differs", i, j);
+      }
+    }
+
+    if (framings[i] == 0) {
+      std::string bad_distance_message =
+          wuffs_base__make_status(wuffs_deflate__error__bad_distance)
+              .message();
+      if (results.back().error_message != bad_distance_message) {
+        RETURN_FAIL("i=%zu: bad distance: have \"%s\", want \"%s\"", i,
+                    results.back().error_message.c_str(),
+                    bad_distance_message.c_str());
+      }
+    }
+  }
+  return nullptr;
+}
+
+// ---------------- Manifest
+
+proc g_tests[] = {
+
+    test_wuffs_aux_deflate_decode_batch,
+    test_wuffs_aux_deflate_decode_gzip_members,
+    test_wuffs_aux_deflate_decode_multi_threaded_golden,
+    test_wuffs_aux_deflate_decode_multi_threaded_many_blocks,
+    test_wuffs_aux_deflate_decode_range,
+    test_wuffs_aux_deflate_decode_restore,
+    test_wuffs_aux_deflate_index_serialize_parse,
+
+    nullptr,
+};
+
+proc g_benches[] = {
+    nullptr,
+};
+
+int  //
+main(int argc, char** argv) {
+  g_proc_package_name = "aux/deflate";
+  return test_main(argc, argv, g_tests, g_benches);
+}
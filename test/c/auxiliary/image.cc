@@ -0,0 +1,789 @@
+// Copyright 2021 The Wuffs Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// ----------------
+
+/*
+This test program checks the wuffs_aux (auxiliary C++) Image API: functions
+like wuffs_aux::DecodeImage, wuffs_aux::EncodePng, wuffs_aux::IndexFrames and
+wuffs_aux::DecodeGifFrames. Unlike the test/c/std programs, it is C++, not C,
+and is not run by the "wuffs test" command.
+
+To manually run this test:
+
+for CXX in clang++ g++; do
+  $CXX -std=c++11 -Wall -Werror -pthread image.cc && ./a.out
+  rm -f a.out
+done
+
+Each edition should print "PASS", amongst other information, and exit(0).
+*/
+
+#if defined(__cplusplus) && (__cplusplus < 201103L)
+#error "This C++ program requires -std=c++11 or later"
+#endif
+
+#include <string>
+#include <vector>
+
+// Wuffs ships as a "single file C library" or "header file library" as per
+// https://github.com/nothings/stb/blob/master/docs/stb_howto.txt
+//
+// To use that single file as a "foo.c"-like implementation, instead of a
+// "foo.h"-like header, #define WUFFS_IMPLEMENTATION before #include'ing or
+// compiling it.
+#define WUFFS_IMPLEMENTATION
+
+// Defining the WUFFS_CONFIG__MODULE* macros are optional, but it lets users of
+// release/c/etc.c choose which parts of Wuffs to build. That file contains the
+// entire Wuffs standard library, implementing a variety of codecs and file
+// formats. Without this macro definition, an optimizing compiler or linker may
+// very well discard Wuffs code for unused codecs, but listing the Wuffs
+// modules we use makes that process explicit. Preprocessing means that such
+// code simply isn't compiled.
+#define WUFFS_CONFIG__MODULES
+#define WUFFS_CONFIG__MODULE__ADLER32
+#define WUFFS_CONFIG__MODULE__AUX__BASE
+#define WUFFS_CONFIG__MODULE__AUX__IMAGE
+#define WUFFS_CONFIG__MODULE__BASE
+#define WUFFS_CONFIG__MODULE__BMP
+#define WUFFS_CONFIG__MODULE__CRC32
+#define WUFFS_CONFIG__MODULE__DEFLATE
+#define WUFFS_CONFIG__MODULE__GIF
+#define WUFFS_CONFIG__MODULE__LZW
+#define WUFFS_CONFIG__MODULE__PNG
+#define WUFFS_CONFIG__MODULE__ZLIB
+
+// If building this program in an environment that doesn't easily accommodate
+// relative includes, you can use the script/inline-c-relative-includes.go
+// program to generate a stand-alone C++ file.
+#include "../../../release/c/wuffs-unsupported-snapshot.c"
+#include "../testlib/testlib.c"
+
+// ---------------- Utilities
+
+// read_file_to_string loads path (which may include "@123=45=67;" patches, as
+// per read_file) into s.
+const char*  //
+read_file_to_string(std::string* s, const char* path) {
+  wuffs_base__io_buffer src = wuffs_base__slice_u8__writer(g_src_slice_u8);
+  const char* z = read_file(&src, path);
+  if (z) {
+    return z;
+  }
+  s->assign((const char*)(src.data.ptr), src.meta.wi);
+  return nullptr;
+}
+
+// pixels returns pb's pixels, row by row, without any stride padding.
+std::string  //
+pixels(const wuffs_base__pixel_buffer& pb) {
+  wuffs_base__pixel_format pixfmt = pb.pixcfg.pixel_format();
+  size_t row_len = (size_t)(pb.pixcfg.width()) * (pixfmt.bits_per_pixel() / 8);
+  wuffs_base__table_u8 tab =
+      const_cast<wuffs_base__pixel_buffer&>(pb).plane(0);
+  std::string s;
+  for (uint32_t y = 0; y < pb.pixcfg.height(); y++) {
+    s.append((const char*)(wuffs_base__table_u8__row(tab, y).ptr), row_len);
+  }
+  return s;
+}
+
+// PixfmtCallbacks decodes to a given pixel format.
+class PixfmtCallbacks : public wuffs_aux::DecodeImageCallbacks {
+ public:
+  explicit PixfmtCallbacks(uint32_t pixfmt_repr) : m_pixfmt_repr(pixfmt_repr) {}
+
+  wuffs_base__pixel_format  //
+  SelectPixfmt(const wuffs_base__image_config& image_config) override {
+    return wuffs_base__make_pixel_format(m_pixfmt_repr);
+  }
+
+  uint32_t m_pixfmt_repr;
+};
+
+// decode_image decodes src to dst's pixel buffer and error message.
+wuffs_aux::DecodeImageResult  //
+decode_image(const std::string& src,
+             uint32_t pixfmt_repr,
+             uint32_t num_threads,
+             uint32_t downscale_shift) {
+  PixfmtCallbacks callbacks(pixfmt_repr);
+  wuffs_aux::sync_io::MemoryInput input(src.data(), src.size());
+  return wuffs_aux::DecodeImage(callbacks, input, WUFFS_BASE__PIXEL_BLEND__SRC,
+                                1, 1048575, num_threads, downscale_shift);
+}
+
+// alloc_decoder returns a decoder for the filename's (GIF or PNG) format.
+wuffs_base__image_decoder::unique_ptr  //
+alloc_decoder(const char* filename) {
+  if (strstr(filename, ".gif")) {
+    return wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder();
+  }
+  return wuffs_png__decoder::alloc_as__wuffs_base__image_decoder();
+}
+
+// render composites the frames first ..= last of the animated image in src,
+// starting from a cleared canvas, and sets *canvas to the resultant pixels.
+// The image_decoder must have already indexed src, so that it can seek (via
+// restart_frame) to the first frame.
+const char*  //
+render(std::string* canvas,
+       wuffs_base__image_decoder& image_decoder,
+       const std::string& src,
+       const wuffs_aux::IndexFramesResult& index,
+       size_t first,
+       size_t last) {
+  uint32_t w = index.image_config.pixcfg.width();
+  uint32_t h = index.image_config.pixcfg.height();
+  std::vector<uint8_t> memory(4 * (size_t)w * (size_t)h, 0);
+  std::vector<uint8_t> saved;
+  wuffs_base__pixel_config pixcfg;
+  pixcfg.set(WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL,
+             WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, w, h);
+  wuffs_base__pixel_buffer pb;
+  CHECK_STATUS("set_from_slice",
+               pb.set_from_slice(&pixcfg, wuffs_base__make_slice_u8(
+                                              memory.data(), memory.size())));
+  std::vector<uint8_t> workbuf(
+      (size_t)(image_decoder.workbuf_len().max_incl));
+
+  CHECK_STATUS("restart_frame",
+               image_decoder.restart_frame(first,
+                                           index.frames[first].io_position));
+  wuffs_base__io_buffer src_buf = wuffs_base__ptr_u8__reader(
+      (uint8_t*)(const_cast<char*>(src.data())), src.size(), true);
+  src_buf.meta.ri = (size_t)(index.frames[first].io_position);
+
+  for (size_t i = first; i <= last; i++) {
+    wuffs_base__frame_config fc;
+    CHECK_STATUS("decode_frame_config",
+                 image_decoder.decode_frame_config(&fc, &src_buf));
+    if (fc.index() != i) {
+      RETURN_FAIL("frame index: have %" PRIu64 ", want %zu", fc.index(), i);
+    }
+    if (fc.disposal() == WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_PREVIOUS) {
+      saved = memory;
+    }
+    CHECK_STATUS("decode_frame",
+                 image_decoder.decode_frame(
+                     &pb, &src_buf,
+                     fc.overwrite_instead_of_blend()
+                         ? WUFFS_BASE__PIXEL_BLEND__SRC
+                         : WUFFS_BASE__PIXEL_BLEND__SRC_OVER,
+                     wuffs_base__make_slice_u8(workbuf.data(), workbuf.size()),
+                     nullptr));
+    if (i == last) {
+      break;
+    } else if (fc.disposal() ==
+               WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_BACKGROUND) {
+      wuffs_base__rect_ie_u32 b = fc.bounds().intersect(pixcfg.bounds());
+      for (uint32_t y = b.min_incl_y; y < b.max_excl_y; y++) {
+        uint8_t* p = memory.data() + (4 * (size_t)w * y);
+        for (uint32_t x = b.min_incl_x; x < b.max_excl_x; x++) {
+          wuffs_base__poke_u32le__no_bounds_check(p + (4 * (size_t)x),
+                                                  fc.background_color());
+        }
+      }
+    } else if (fc.disposal() ==
+               WUFFS_BASE__ANIMATION_DISPOSAL__RESTORE_PREVIOUS) {
+      memory = saved;
+    }
+  }
+  canvas->assign((const char*)(memory.data()), memory.size());
+  return nullptr;
+}
+
+// FramesCallbacks records each frame's index and composited canvas.
+class FramesCallbacks : public wuffs_aux::DecodeGifFramesCallbacks {
+ public:
+  std::string  //
+  Frame(const wuffs_base__frame_config& frame_config,
+        const wuffs_base__pixel_buffer& canvas) override {
+    m_indexes.push_back(frame_config.index());
+    m_canvases.push_back(pixels(canvas));
+    return "";
+  }
+
+  std::vector<uint64_t> m_indexes;
+  std::vector<std::string> m_canvases;
+};
+
+// TrailingChunksCallbacks decodes a PNG image and then, in Done, logs the
+// chunks after the image data: each chunk's type, a '=', its payload and a
+// ';'. Decoding stops just before the last IDAT chunk's CRC-32, which is
+// skipped (and which differs between single-threaded and pipelined decoding).
+class TrailingChunksCallbacks : public wuffs_aux::DecodeImageCallbacks {
+ public:
+  void  //
+  Done(wuffs_aux::DecodeImageResult& result,
+       wuffs_aux::sync_io::Input& input,
+       wuffs_aux::IOBuffer& buffer,
+       wuffs_base__image_decoder::unique_ptr image_decoder) override {
+    std::string rest;
+    while (true) {
+      rest.append((const char*)(buffer.reader_pointer()),
+                  buffer.reader_length());
+      buffer.meta.ri = buffer.meta.wi;
+      if (buffer.meta.closed || !input.CopyIn(&buffer).empty()) {
+        break;
+      }
+    }
+    size_t pos = 4;
+    while ((pos + 12) <= rest.size()) {
+      uint32_t len = wuffs_base__peek_u32be__no_bounds_check(
+          (const uint8_t*)(rest.data() + pos));
+      if ((rest.size() - pos - 12) < len) {
+        break;
+      }
+      m_log += rest.substr(pos + 4, 4) + "=" + rest.substr(pos + 8, len) + ";";
+      pos += 12 + (size_t)len;
+    }
+  }
+
+  std::string m_log;
+};
+
+// ---------------- Image Tests
+
+const char*  //
+test_wuffs_aux_image_decode_image_multi_threaded() {
+  CHECK_FOCUS(__func__);
+
+  const char* filenames[] = {
+      "test/data/animated-red-blue.apng",
+      "test/data/bricks-color.png",
+      "test/data/bricks-gray.png",
+      "test/data/harvesters.png",
+      "test/data/hat.png",
+      "test/data/hibiscus.primitive.png",
+      "test/data/hippopotamus.interlaced.png",
+      "test/data/hippopotamus.regular.png",
+      "test/data/pjw-thumbnail.metadata.png",
+      "test/data/pjw-thumbnail.png",
+      // Other formats are decoded single-threaded either way.
+      "test/data/bricks-dither.gif",
+      "test/data/hat.bmp",
+  };
+  const uint32_t pixfmts[] = {
+      WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL,
+      WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL,
+  };
+
+  for (size_t i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(filenames); i++) {
+    std::string original;
+    CHECK_STRING(read_file_to_string(&original, filenames[i]));
+
+    // The intact file, then a truncated one, then one with a flipped bit
+    // roughly two thirds of the way through (in the pixel data).
+    for (int tc = 0; tc < 3; tc++) {
+      std::string src = original;
+      if (tc == 1) {
+        src.resize(src.size() / 2);
+      } else if (tc == 2) {
+        src[(2 * src.size()) / 3] ^= 0x20;
+      }
+
+      for (size_t p = 0; p < WUFFS_TESTLIB_ARRAY_SIZE(pixfmts); p++) {
+        for (uint32_t downscale_shift = 0; downscale_shift <= 2;
+             downscale_shift += 2) {
+          wuffs_aux::DecodeImageResult want =
+              decode_image(src, pixfmts[p], 1, downscale_shift);
+          if ((tc == 0) && !want.error_message.empty()) {
+            RETURN_FAIL("%s: single-threaded: \"%s\"", filenames[i],
+                        want.error_message.c_str());
+          }
+          for (uint32_t num_threads = 2; num_threads <= 4; num_threads++) {
+            wuffs_aux::DecodeImageResult have =
+                decode_image(src, pixfmts[p], num_threads, downscale_shift);
+            if (have.error_message != want.error_message) {
+              RETURN_FAIL("%s, tc=%d, p=%zu, downscale_shift=%" PRIu32
+                          ", num_threads=%" PRIu32
+                          ": error_message: have \"%s\", want \"%s\"",
+                          filenames[i], tc, p, downscale_shift, num_threads,
+                          have.error_message.c_str(),
+                          want.error_message.c_str());
+            } else if (have.pixbuf.pixcfg.is_valid() !=
+                       want.pixbuf.pixcfg.is_valid()) {
+              RETURN_FAIL("%s, tc=%d, p=%zu, downscale_shift=%" PRIu32
+                          ", num_threads=%" PRIu32 ": pixcfg validity differs",
+                          filenames[i], tc, p, downscale_shift, num_threads);
+            } else if (!want.pixbuf.pixcfg.is_valid()) {
+              continue;
+            } else if ((have.pixbuf.pixcfg.width() !=
+                        want.pixbuf.pixcfg.width()) ||
+                       (have.pixbuf.pixcfg.height() !=
+                        want.pixbuf.pixcfg.height()) ||
+                       (pixels(have.pixbuf) != pixels(want.pixbuf))) {
+              RETURN_FAIL("%s, tc=%d, p=%zu, downscale_shift=%" PRIu32
+                          ", num_threads=%" PRIu32 ": pixels differ",
+                          filenames[i], tc, p, downscale_shift, num_threads);
+            }
+          }
+        }
+      }
+    }
+  }
+  return nullptr;
+}
+
+const char*  //
+test_wuffs_aux_image_decode_image_trailing_chunks() {
+  CHECK_FOCUS(__func__);
+
+  // Each PNG's chunks after the IDAT chunks (such as tEXt metadata) are still
+  // there for Done to read, whether or not decoding is pipelined.
+  const struct {
+    const char* filename;
+    const char* want_prefix;
+  } test_cases[] = {
+      {"test/data/bricks-gray.png", "tEXt=date:create"},
+      {"test/data/harvesters.png", "IEND=;"},
+      {"test/data/hibiscus.primitive.png", "IEND=;"},
+      {"test/data/hippopotamus.interlaced.png", "tEXt=date:create"},
+  };
+
+  for (size_t i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(test_cases); i++) {
+    std::string src;
+    CHECK_STRING(read_file_to_string(&src, test_cases[i].filename));
+    std::string want;
+    for (uint32_t num_threads = 1; num_threads <= 4; num_threads++) {
+      TrailingChunksCallbacks callbacks;
+      wuffs_aux::sync_io::MemoryInput input(src.data(), src.size());
+      wuffs_aux::DecodeImageResult result =
+          wuffs_aux::DecodeImage(callbacks, input, WUFFS_BASE__PIXEL_BLEND__SRC,
+                                 1, 1048575, num_threads);
+      if (!result.error_message.empty()) {
+        RETURN_FAIL("%s, num_threads=%" PRIu32 ": \"%s\"",
+                    test_cases[i].filename, num_threads,
+                    result.error_message.c_str());
+      } else if (num_threads == 1) {
+        want = callbacks.m_log;
+        if ((want.compare(0, strlen(test_cases[i].want_prefix),
+                          test_cases[i].want_prefix) != 0) ||
+            (want.size() < 6) || (want.compare(want.size() - 6, 6, "IEND=;"))) {
+          RETURN_FAIL("%s: chunks: have \"%s\"", test_cases[i].filename,
+                      want.c_str());
+        }
+      } else if (callbacks.m_log != want) {
+        RETURN_FAIL("%s, num_threads=%" PRIu32
+                    ": chunks: have \"%s\", want \"%s\"",
+                    test_cases[i].filename, num_threads,
+                    callbacks.m_log.c_str(), want.c_str());
+      }
+    }
+  }
+  return nullptr;
+}
+
+const char*  //
+test_wuffs_aux_image_encode_png() {
+  CHECK_FOCUS(__func__);
+
+  const char* filenames[] = {
+      "test/data/bricks-color.png",
+      "test/data/hibiscus.primitive.png",
+      "test/data/pjw-thumbnail.png",
+  };
+  const uint32_t pixfmts[] = {
+      WUFFS_BASE__PIXEL_FORMAT__BGR,
+      WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL,
+      WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL,
+  };
+  const uint32_t levels[] = {0, 1, 6, 9};
+
+  for (size_t i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(filenames); i++) {
+    std::string src;
+    CHECK_STRING(read_file_to_string(&src, filenames[i]));
+    for (size_t p = 0; p < WUFFS_TESTLIB_ARRAY_SIZE(pixfmts); p++) {
+      wuffs_aux::DecodeImageResult original =
+          decode_image(src, pixfmts[p], 1, 0);
+      if (!original.error_message.empty()) {
+        RETURN_FAIL("%s: DecodeImage: \"%s\"", filenames[i],
+                    original.error_message.c_str());
+      }
+      std::string want = pixels(original.pixbuf);
+
+      for (size_t l = 0; l < WUFFS_TESTLIB_ARRAY_SIZE(levels); l++) {
+        // Also try more threads than the image has rows.
+        const uint32_t nums_threads[] = {1, 2, 7, 1000};
+        for (size_t n = 0; n < WUFFS_TESTLIB_ARRAY_SIZE(nums_threads); n++) {
+          wuffs_aux::EncodePngResult encoded = wuffs_aux::EncodePng(
+              original.pixbuf, levels[l], nums_threads[n]);
+          if (!encoded.error_message.empty()) {
+            RETURN_FAIL("%s, p=%zu, level=%" PRIu32 ", num_threads=%" PRIu32
+                        ": EncodePng: \"%s\"",
+                        filenames[i], p, levels[l], nums_threads[n],
+                        encoded.error_message.c_str());
+          } else if (encoded.dst.compare(0, 8, "\x89PNG\r\n\x1A\n") != 0) {
+            RETURN_FAIL("%s, p=%zu, level=%" PRIu32 ", num_threads=%" PRIu32
+                        ": bad PNG signature",
+                        filenames[i], p, levels[l], nums_threads[n]);
+          }
+
+          // The round trip is lossless. Decoding also checks the CRC-32 and
+          // Adler-32 checksums, which are ignored by default.
+          wuffs_png__decoder::unique_ptr dec = wuffs_png__decoder::alloc();
+          if (!dec) {
+            RETURN_FAIL("alloc: out of memory");
+          }
+          dec->set_quirk_enabled(WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, false);
+          wuffs_base__io_buffer encoded_buf = wuffs_base__ptr_u8__reader(
+              (uint8_t*)(&encoded.dst[0]), encoded.dst.size(), true);
+          wuffs_base__image_config ic;
+          CHECK_STATUS("decode_image_config",
+                       dec->decode_image_config(&ic, &encoded_buf));
+          ic.pixcfg.set(pixfmts[p], WUFFS_BASE__PIXEL_SUBSAMPLING__NONE,
+                        ic.pixcfg.width(), ic.pixcfg.height());
+          std::vector<uint8_t> have_memory(
+              (size_t)(ic.pixcfg.pixbuf_len()));
+          std::vector<uint8_t> workbuf(
+              (size_t)(dec->workbuf_len().max_incl));
+          wuffs_base__pixel_buffer have;
+          CHECK_STATUS("set_from_slice",
+                       have.set_from_slice(
+                           &ic.pixcfg,
+                           wuffs_base__make_slice_u8(have_memory.data(),
+                                                     have_memory.size())));
+          CHECK_STATUS("decode_frame",
+                       dec->decode_frame(&have, &encoded_buf,
+                                         WUFFS_BASE__PIXEL_BLEND__SRC,
+                                         wuffs_base__make_slice_u8(
+                                             workbuf.data(), workbuf.size()),
+                                         nullptr));
+          if (pixels(have) != want) {
+            RETURN_FAIL("%s, p=%zu, level=%" PRIu32 ", num_threads=%" PRIu32
+                        ": pixels differ",
+                        filenames[i], p, levels[l], nums_threads[n]);
+          }
+        }
+      }
+    }
+  }
+
+  // Unsupported pixel formats are rejected.
+  {
+    std::string src;
+    CHECK_STRING(read_file_to_string(&src, "test/data/bricks-color.png"));
+    wuffs_aux::DecodeImageResult original =
+        decode_image(src, WUFFS_BASE__PIXEL_FORMAT__BGR_565, 1, 0);
+    if (!original.error_message.empty()) {
+      RETURN_FAIL("BGR_565: DecodeImage: \"%s\"",
+                  original.error_message.c_str());
+    }
+    for (uint32_t num_threads = 1; num_threads <= 2; num_threads++) {
+      wuffs_aux::EncodePngResult encoded =
+          wuffs_aux::EncodePng(original.pixbuf, 6, num_threads);
+      if (encoded.error_message.empty()) {
+        RETURN_FAIL("BGR_565, num_threads=%" PRIu32
+                    ": EncodePng: have no error, want one",
+                    num_threads);
+      }
+    }
+  }
+  return nullptr;
+}
+
+const char*  //
+test_wuffs_aux_image_index_frames() {
+  CHECK_FOCUS(__func__);
+
+  const char* filenames[] = {
+      "test/data/animated-red-blue.apng",
+      "test/data/animated-red-blue.gif",
+      "test/data/gifplayer-muybridge.gif",
+      "test/data/muybridge.gif",
+      // Generated below.
+      "animated-red-blue.restore-previous.gif",
+  };
+  std::string srcs[WUFFS_TESTLIB_ARRAY_SIZE(filenames)];
+  for (size_t i = 0; (i + 1) < WUFFS_TESTLIB_ARRAY_SIZE(filenames); i++) {
+    CHECK_STRING(read_file_to_string(&srcs[i], filenames[i]));
+  }
+
+  // Insert, after animated-red-blue.gif's first frame, a copy of that
+  // (opaque, whole canvas) frame whose disposal is RESTORE_PREVIOUS. The
+  // frames after that copy need the canvas from before it, so the copy is
+  // not a keyframe, even though it covers the canvas.
+  {
+    const std::string& gif = srcs[1];
+    wuffs_base__image_decoder::unique_ptr dec = alloc_decoder(filenames[1]);
+    if (!dec) {
+      RETURN_FAIL("alloc: out of memory");
+    }
+    wuffs_aux::sync_io::MemoryInput input(gif.data(), gif.size());
+    wuffs_aux::IndexFramesResult index = wuffs_aux::IndexFrames(*dec, input);
+    if (!index.error_message.empty() || (index.frames.size() < 3)) {
+      RETURN_FAIL("%s: IndexFrames failed", filenames[1]);
+    }
+    size_t frame1 = (size_t)(index.frames[1].io_position);
+    size_t gce =
+        gif.find("\x21\xF9\x04", (size_t)(index.frames[0].io_position));
+    if (gce >= frame1) {
+      RETURN_FAIL("%s: no Graphic Control Extension", filenames[1]);
+    }
+    std::string copy = gif.substr(gce, frame1 - gce);
+    copy[3] = (char)((copy[3] & ~0x1C) | 0x0C);
+    srcs[WUFFS_TESTLIB_ARRAY_SIZE(filenames) - 1] =
+        gif.substr(0, frame1) + copy + gif.substr(frame1);
+  }
+
+  for (size_t i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(filenames); i++) {
+    const std::string& src = srcs[i];
+
+    wuffs_base__image_decoder::unique_ptr dec = alloc_decoder(filenames[i]);
+    if (!dec) {
+      RETURN_FAIL("alloc: out of memory");
+    }
+    wuffs_aux::sync_io::MemoryInput input(src.data(), src.size());
+    wuffs_aux::IndexFramesResult index = wuffs_aux::IndexFrames(*dec, input);
+    if (!index.error_message.empty()) {
+      RETURN_FAIL("%s: IndexFrames: \"%s\"", filenames[i],
+                  index.error_message.c_str());
+    } else if (index.frames.size() < 2) {
+      RETURN_FAIL("%s: frames.size(): have %zu, want >= 2", filenames[i],
+                  index.frames.size());
+    } else if (!index.frames[0].keyframe) {
+      RETURN_FAIL("%s: frames[0] is not a keyframe", filenames[i]);
+    }
+
+    // Compare with walking the frames with a separate decoder.
+    {
+      wuffs_base__image_decoder::unique_ptr walker =
+          alloc_decoder(filenames[i]);
+      if (!walker) {
+        RETURN_FAIL("alloc: out of memory");
+      }
+      wuffs_base__io_buffer src_buf = wuffs_base__ptr_u8__reader(
+          (uint8_t*)(const_cast<char*>(src.data())), src.size(), true);
+      CHECK_STATUS("decode_image_config",
+                   walker->decode_image_config(nullptr, &src_buf));
+      for (size_t f = 0; true; f++) {
+        wuffs_base__frame_config fc;
+        wuffs_base__status status =
+            walker->decode_frame_config(&fc, &src_buf);
+        if (status.repr == wuffs_base__note__end_of_data) {
+          if (f != index.frames.size()) {
+            RETURN_FAIL("%s: frames.size(): have %zu, want %zu",
+                        filenames[i], index.frames.size(), f);
+          }
+          break;
+        }
+        CHECK_STATUS("decode_frame_config", status);
+        if (f >= index.frames.size()) {
+          RETURN_FAIL("%s: too few frames", filenames[i]);
+        }
+        const wuffs_aux::IndexFramesResult::Frame& frame = index.frames[f];
+        if ((frame.io_position != fc.io_position()) ||
+            !frame.bounds.equals(fc.bounds()) ||
+            (frame.duration != fc.duration()) ||
+            (frame.disposal != fc.disposal())) {
+          RETURN_FAIL("%s: frames[%zu] differs", filenames[i], f);
+        }
+      }
+    }
+
+    // Seeking to frame n via KeyframeFor(n) gives the same canvas as
+    // rendering every frame from the start.
+    for (size_t n = 0; n < index.frames.size(); n++) {
+      size_t k = index.KeyframeFor(n);
+      if ((k > n) || !index.frames[k].keyframe) {
+        RETURN_FAIL("%s: KeyframeFor(%zu): have %zu", filenames[i], n, k);
+      }
+      std::string want;
+      CHECK_STRING(render(&want, *dec, src, index, 0, n));
+      if (k == 0) {
+        continue;
+      }
+      std::string have;
+      CHECK_STRING(render(&have, *dec, src, index, k, n));
+      if (have != want) {
+        RETURN_FAIL("%s: frame %zu from keyframe %zu: canvas differs",
+                    filenames[i], n, k);
+      }
+    }
+
+    // A truncated file's index lists the frames so far.
+    {
+      std::string truncated = src.substr(0, (2 * src.size()) / 3);
+      wuffs_base__image_decoder::unique_ptr dec2 =
+          alloc_decoder(filenames[i]);
+      if (!dec2) {
+        RETURN_FAIL("alloc: out of memory");
+      }
+      wuffs_aux::sync_io::MemoryInput truncated_input(truncated.data(),
+                                                      truncated.size());
+      wuffs_aux::IndexFramesResult partial =
+          wuffs_aux::IndexFrames(*dec2, truncated_input);
+      if (partial.error_message.empty()) {
+        RETURN_FAIL("%s: truncated: have no error, want one", filenames[i]);
+      } else if (partial.frames.size() >= index.frames.size()) {
+        RETURN_FAIL("%s: truncated: frames.size(): have %zu, want < %zu",
+                    filenames[i], partial.frames.size(), index.frames.size());
+      }
+      for (size_t f = 0; f < partial.frames.size(); f++) {
+        if ((partial.frames[f].io_position != index.frames[f].io_position) ||
+            (partial.frames[f].keyframe != index.frames[f].keyframe)) {
+          RETURN_FAIL("%s: truncated: frames[%zu] differs", filenames[i], f);
+        }
+      }
+    }
+  }
+
+  // The keyframe index is clamped to the last frame.
+  {
+    std::string src;
+    CHECK_STRING(read_file_to_string(&src, "test/data/muybridge.gif"));
+    wuffs_base__image_decoder::unique_ptr dec =
+        wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder();
+    wuffs_aux::sync_io::MemoryInput input(src.data(), src.size());
+    wuffs_aux::IndexFramesResult index = wuffs_aux::IndexFrames(*dec, input);
+    size_t last = index.frames.size() - 1;
+    if (index.KeyframeFor(SIZE_MAX) != index.KeyframeFor(last)) {
+      RETURN_FAIL("KeyframeFor(SIZE_MAX): have %zu, want %zu",
+                  index.KeyframeFor(SIZE_MAX), index.KeyframeFor(last));
+    }
+  }
+  return nullptr;
+}
+
+const char*  //
+test_wuffs_aux_image_decode_gif_frames() {
+  CHECK_FOCUS(__func__);
+
+  const char* filenames[] = {
+      "test/data/animated-red-blue.gif",
+      "test/data/bricks-dither.gif",
+      "test/data/gifplayer-muybridge.gif",
+      "test/data/hippopotamus.interlaced.gif",
+      "test/data/hippopotamus.interlaced.truncated.gif",
+      "test/data/hippopotamus.masked-with-muybridge.gif",
+      "test/data/muybridge.gif",
+  };
+
+  for (size_t i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(filenames); i++) {
+    std::string original;
+    CHECK_STRING(read_file_to_string(&original, filenames[i]));
+    bool want_ok = strstr(filenames[i], ".truncated.") == nullptr;
+
+    // The intact file, then a truncated one, then one with a flipped bit
+    // roughly two thirds of the way through (in the LZW data).
+    for (int tc = 0; tc < 3; tc++) {
+      std::string src = original;
+      if (tc == 1) {
+        src.resize(src.size() / 2);
+      } else if (tc == 2) {
+        src[(2 * src.size()) / 3] ^= 0x20;
+      }
+
+      FramesCallbacks want;
+      wuffs_aux::sync_io::MemoryInput want_input(src.data(), src.size());
+      wuffs_aux::DecodeGifFramesResult want_result =
+          wuffs_aux::DecodeGifFrames(want, want_input, 1);
+      if ((tc == 0) && (want_result.error_message.empty() != want_ok)) {
+        RETURN_FAIL("%s: single-threaded: error_message: \"%s\"",
+                    filenames[i], want_result.error_message.c_str());
+      } else if (want_result.num_frames != want.m_canvases.size()) {
+        RETURN_FAIL("%s, tc=%d: single-threaded: num_frames: have %" PRIu64
+                    ", want %zu",
+                    filenames[i], tc, want_result.num_frames,
+                    want.m_canvases.size());
+      }
+      for (size_t f = 0; f < want.m_indexes.size(); f++) {
+        if (want.m_indexes[f] != f) {
+          RETURN_FAIL("%s, tc=%d: single-threaded: frames[%zu].index() is %"
+                      PRIu64,
+                      filenames[i], tc, f, want.m_indexes[f]);
+        }
+      }
+
+      // For the intact file, the canvases also match compositing the frames
+      // with the lower level C API.
+      if ((tc == 0) && want_ok) {
+        wuffs_base__image_decoder::unique_ptr dec =
+            wuffs_gif__decoder::alloc_as__wuffs_base__image_decoder();
+        wuffs_aux::sync_io::MemoryInput input(src.data(), src.size());
+        wuffs_aux::IndexFramesResult index =
+            wuffs_aux::IndexFrames(*dec, input);
+        if (index.frames.size() != want.m_canvases.size()) {
+          RETURN_FAIL("%s: IndexFrames: frames.size(): have %zu, want %zu",
+                      filenames[i], index.frames.size(),
+                      want.m_canvases.size());
+        }
+        for (size_t f = 0; f < index.frames.size(); f++) {
+          std::string canvas;
+          CHECK_STRING(render(&canvas, *dec, src, index, 0, f));
+          if (canvas != want.m_canvases[f]) {
+            RETURN_FAIL("%s: frame %zu: canvas differs from render",
+                        filenames[i], f);
+          }
+        }
+      }
+
+      for (uint32_t num_threads = 2; num_threads <= 8; num_threads *= 2) {
+        FramesCallbacks have;
+        wuffs_aux::sync_io::MemoryInput have_input(src.data(), src.size());
+        wuffs_aux::DecodeGifFramesResult have_result =
+            wuffs_aux::DecodeGifFrames(have, have_input, num_threads);
+        if (have_result.error_message != want_result.error_message) {
+          RETURN_FAIL("%s, tc=%d, num_threads=%" PRIu32
+                      ": error_message: have \"%s\", want \"%s\"",
+                      filenames[i], tc, num_threads,
+                      have_result.error_message.c_str(),
+                      want_result.error_message.c_str());
+        } else if (have_result.num_frames != want_result.num_frames) {
+          RETURN_FAIL("%s, tc=%d, num_threads=%" PRIu32
+                      ": num_frames: have %" PRIu64 ", want %" PRIu64,
+                      filenames[i], tc, num_threads, have_result.num_frames,
+                      want_result.num_frames);
+        } else if (have.m_indexes != want.m_indexes) {
+          RETURN_FAIL("%s, tc=%d, num_threads=%" PRIu32
+                      ": frame indexes differ",
+                      filenames[i], tc, num_threads);
+        }
+        for (size_t f = 0; f < want.m_canvases.size(); f++) {
+          if (have.m_canvases[f] != want.m_canvases[f]) {
+            RETURN_FAIL("%s, tc=%d, num_threads=%" PRIu32
+                        ": frame %zu: canvas differs",
+                        filenames[i], tc, num_threads, f);
+          }
+        }
+      }
+    }
+  }
+  return nullptr;
+}
+
+// ---------------- Manifest
+
+proc g_tests[] = {
+
+    test_wuffs_aux_image_decode_gif_frames,
+    test_wuffs_aux_image_decode_image_multi_threaded,
+    test_wuffs_aux_image_decode_image_trailing_chunks,
+    test_wuffs_aux_image_encode_png,
+    test_wuffs_aux_image_index_frames,
+
+    nullptr,
+};
+
+proc g_benches[] = {
+    nullptr,
+};
+
+int  //
+main(int argc, char** argv) {
+  g_proc_package_name = "aux/image";
+  return test_main(argc, argv, g_tests, g_benches);
+}
@@ -170,6 +170,33 @@ mimic_zlib_decode_with_dictionary(wuffs_base__io_buffer* dst,
   return "libdeflate does not implement zlib dictionaries";
 }
 
+const char*  //
+mimic_deflate_encode(wuffs_base__io_buffer* dst,
+                     wuffs_base__io_buffer* src,
+                     uint64_t wlimit,
+                     uint64_t rlimit,
+                     int level) {
+  if ((wlimit < UINT64_MAX) || (rlimit < UINT64_MAX)) {
+    return "unsupported I/O limit";
+  }
+  struct libdeflate_compressor* enc = libdeflate_alloc_compressor(level);
+  if (!enc) {
+    return "libdeflate: alloc failed";
+  }
+  size_t n = libdeflate_deflate_compress(
+      enc, wuffs_base__io_buffer__reader_pointer(src),
+      wuffs_base__io_buffer__reader_length(src),
+      wuffs_base__io_buffer__writer_pointer(dst),
+      wuffs_base__io_buffer__writer_length(dst));
+  libdeflate_free_compressor(enc);
+  if (n == 0) {
+    return "libdeflate: insufficient space";
+  }
+  dst->meta.wi += n;
+  src->meta.ri = src->meta.wi;
+  return NULL;
+}
+
 // -------------------------------- WUFFS_MIMICLIB_USE_XXX_INSTEAD_OF_ZLIB
 #elif defined(WUFFS_MIMICLIB_USE_MINIZ_INSTEAD_OF_ZLIB)
 #include "/path/to/your/copy/of/github.com/richgel999/miniz/miniz_tinfl.c"
@@ -260,6 +287,15 @@ mimic_zlib_decode_with_dictionary(wuffs_base__io_buffer* dst,
   return "miniz does not implement zlib dictionaries";
 }
 
+const char*  //
+mimic_deflate_encode(wuffs_base__io_buffer* dst,
+                     wuffs_base__io_buffer* src,
+                     uint64_t wlimit,
+                     uint64_t rlimit,
+                     int level) {
+  return "miniz_tinfl does not implement encoding";
+}
+
 // -------------------------------- WUFFS_MIMICLIB_USE_XXX_INSTEAD_OF_ZLIB
 #else
 #include "zlib.h"
@@ -465,5 +501,74 @@ mimic_zlib_decode_with_dictionary(wuffs_base__io_buffer* dst,
                                         UINT64_MAX, zlib_flavor_zlib);
 }
 
+const char*  //
+mimic_deflate_encode(wuffs_base__io_buffer* dst,
+                     wuffs_base__io_buffer* src,
+                     uint64_t wlimit,
+                     uint64_t rlimit,
+                     int level) {
+  const char* ret = NULL;
+  if (dst->data.len > UINT_MAX) {
+    ret = "dst length is too large";
+    goto cleanup0;
+  }
+  if (src->data.len > UINT_MAX) {
+    ret = "src length is too large";
+    goto cleanup0;
+  }
+
+  // A negative window_bits means raw DEFLATE, without a wrapper.
+  z_stream z = {0};
+  int di2_err =
+      deflateInit2(&z, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+  if (di2_err != Z_OK) {
+    ret = "deflateInit2 failed";
+    goto cleanup0;
+  }
+
+  while (true) {
+    z.next_in = src->data.ptr + src->meta.ri;
+    z.avail_in = src->meta.wi - src->meta.ri;
+    if (z.avail_in > rlimit) {
+      z.avail_in = rlimit;
+    }
+    uInt initial_avail_in = z.avail_in;
+    bool final = src->meta.closed && (initial_avail_in ==
+                                      (src->meta.wi - src->meta.ri));
+
+    z.next_out = dst->data.ptr + dst->meta.wi;
+    z.avail_out = dst->data.len - dst->meta.wi;
+    if (z.avail_out > wlimit) {
+      z.avail_out = wlimit;
+    }
+    uInt initial_avail_out = z.avail_out;
+
+    int d_err = deflate(&z, final ? Z_FINISH : Z_NO_FLUSH);
+
+    src->meta.ri += initial_avail_in - z.avail_in;
+    dst->meta.wi += initial_avail_out - z.avail_out;
+
+    if (d_err == Z_STREAM_END) {
+      break;
+    } else if ((d_err != Z_OK) && (d_err != Z_BUF_ERROR)) {
+      ret = "deflate failed";
+      goto cleanup1;
+    } else if ((initial_avail_in == z.avail_in) &&
+               (initial_avail_out == z.avail_out)) {
+      ret = "deflate made no progress";
+      goto cleanup1;
+    }
+  }
+
+cleanup1:;
+  int de_err = deflateEnd(&z);
+  if ((de_err != Z_OK) && (de_err != Z_DATA_ERROR) && !ret) {
+    ret = "deflateEnd failed";
+  }
+
+cleanup0:;
+  return ret;
+}
+
 #endif
 // -------------------------------- WUFFS_MIMICLIB_USE_XXX_INSTEAD_OF_ZLIB
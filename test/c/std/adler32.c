@@ -69,6 +69,10 @@ the first "./a.out" with "./a.out -bench". Combine these changes with the
 
 // ---------------- Golden Tests
 
+golden_test g_adler32_harvesters_gt = {
+    .src_filename = "test/data/harvesters.bmp",
+};
+
 golden_test g_adler32_midsummer_gt = {
     .src_filename = "test/data/midsummer.txt",
 };
@@ -92,6 +96,59 @@ test_wuffs_adler32_interface() {
       "test/data/hat.lossy.webp", 0, SIZE_MAX, 0xF1BB258D);
 }
 
+const char*  //
+test_wuffs_adler32_combine() {
+  CHECK_FOCUS(__func__);
+
+  wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+      .data = g_src_slice_u8,
+  });
+  CHECK_STRING(read_file(&src, "test/data/pi.txt"));
+
+  wuffs_adler32__hasher h;
+  CHECK_STATUS("initialize",
+               wuffs_adler32__hasher__initialize(
+                   &h, sizeof h, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  const uint32_t want = wuffs_adler32__hasher__update_u32(
+      &h, ((wuffs_base__slice_u8){
+              .ptr = src.data.ptr,
+              .len = src.meta.wi,
+          }));
+
+  size_t splits[] = {0,     1,     99,          255,        256,
+                     5552,  65521, 65536 + 17,  src.meta.wi - 1,  src.meta.wi};
+  int i;
+  for (i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(splits); i++) {
+    size_t n = splits[i];
+    if (n > src.meta.wi) {
+      RETURN_FAIL("i=%d: split is out of bounds", i);
+    }
+    uint32_t adlers[2] = {0};
+    int j;
+    for (j = 0; j < 2; j++) {
+      wuffs_adler32__hasher checksum;
+      CHECK_STATUS("initialize",
+                   wuffs_adler32__hasher__initialize(
+                       &checksum, sizeof checksum, WUFFS_VERSION,
+                       WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+      adlers[j] = wuffs_adler32__hasher__update_u32(
+          &checksum, ((wuffs_base__slice_u8){
+                         .ptr = src.data.ptr + (j ? n : 0),
+                         .len = j ? (src.meta.wi - n) : n,
+                     }));
+    }
+
+    uint32_t have = wuffs_adler32__hasher__combine_u32(
+        &h, adlers[0], adlers[1], src.meta.wi - n);
+    if (have != want) {
+      RETURN_FAIL("i=%d, n=%zu: have 0x%08" PRIX32 ", want 0x%08" PRIX32, i,
+                  n, have, want);
+    }
+  }
+  return NULL;
+}
+
 const char*  //
 test_wuffs_adler32_golden() {
   CHECK_FOCUS(__func__);
@@ -273,6 +330,15 @@ bench_wuffs_adler32_100k() {
       &g_adler32_pi_gt, UINT64_MAX, UINT64_MAX, 150);
 }
 
+const char*  //
+bench_wuffs_adler32_3000k() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(
+      wuffs_bench_adler32,
+      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED, tcounter_src,
+      &g_adler32_harvesters_gt, UINT64_MAX, UINT64_MAX, 5);
+}
+
 // ---------------- Mimic Benches
 
 #ifdef WUFFS_MIMIC
@@ -292,6 +358,14 @@ bench_mimic_adler32_100k() {
                              &g_adler32_pi_gt, UINT64_MAX, UINT64_MAX, 150);
 }
 
+const char*  //
+bench_mimic_adler32_3000k() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(mimic_bench_adler32, 0, tcounter_src,
+                             &g_adler32_harvesters_gt, UINT64_MAX, UINT64_MAX,
+                             5);
+}
+
 #endif  // WUFFS_MIMIC
 
 // ---------------- Manifest
@@ -301,6 +375,7 @@ bench_mimic_adler32_100k() {
 
 proc g_tests[] = {
 
+    test_wuffs_adler32_combine,
     test_wuffs_adler32_golden,
     test_wuffs_adler32_interface,
     test_wuffs_adler32_pi,
@@ -312,11 +387,13 @@ proc g_benches[] = {
 
     bench_wuffs_adler32_10k,
     bench_wuffs_adler32_100k,
+    bench_wuffs_adler32_3000k,
 
 #ifdef WUFFS_MIMIC
 
     bench_mimic_adler32_10k,
     bench_mimic_adler32_100k,
+    bench_mimic_adler32_3000k,
 
 #endif  // WUFFS_MIMIC
 
@@ -127,6 +127,78 @@ test_wuffs_bmp_decode_frame_config() {
   return NULL;
 }
 
+const char*  //
+test_wuffs_bmp_decode_roi() {
+  CHECK_FOCUS(__func__);
+
+  const char* filenames[] = {
+      "test/data/bricks-color.bmp",        // Uncompressed, 24 bits per pixel.
+      "test/data/bricks-dither.bmp",       // RLE8.
+      "test/data/hibiscus.primitive.bmp",  // Bitfields.
+      "test/data/hippopotamus.bmp",        // Uncompressed, 24 bits per pixel.
+      "test/data/pjw-thumbnail.bmp",       // 1 bit per pixel.
+  };
+  const wuffs_base__rect_ie_u32 rois[] = {
+      {.min_incl_x = 0, .min_incl_y = 0, .max_excl_x = 1, .max_excl_y = 1},
+      {.min_incl_x = 5, .min_incl_y = 3, .max_excl_x = 20, .max_excl_y = 17},
+      {.min_incl_x = 30,
+       .min_incl_y = 20,
+       .max_excl_x = 0xFFFFFFFF,
+       .max_excl_y = 0xFFFFFFFF},
+      {.min_incl_x = 7, .min_incl_y = 9, .max_excl_x = 7, .max_excl_y = 9},
+  };
+
+  int i;
+  for (i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(filenames); i++) {
+    int j;
+    for (j = 0; j < WUFFS_TESTLIB_ARRAY_SIZE(rois); j++) {
+      wuffs_bmp__decoder full;
+      CHECK_STATUS("initialize",
+                   wuffs_bmp__decoder__initialize(
+                       &full, sizeof full, WUFFS_VERSION,
+                       WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+      wuffs_bmp__decoder roi;
+      CHECK_STATUS("initialize",
+                   wuffs_bmp__decoder__initialize(
+                       &roi, sizeof roi, WUFFS_VERSION,
+                       WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+      size_t full_ri = 0;
+      size_t roi_ri = 0;
+      const char* z = do_test__wuffs_base__image_decoder_roi(
+          wuffs_bmp__decoder__upcast_as__wuffs_base__image_decoder(&full),
+          wuffs_bmp__decoder__upcast_as__wuffs_base__image_decoder(&roi),
+          filenames[i], rois[j], &full_ri, &roi_ri);
+      if (z) {
+        RETURN_FAIL("%s, roi #%d: %s", filenames[i], j, z);
+      }
+    }
+  }
+
+  // BMP rows are stored bottom-up, so decoding should stop after the ROI's
+  // top row, long before the end of the (3 MB) file.
+  wuffs_bmp__decoder full;
+  CHECK_STATUS("initialize",
+               wuffs_bmp__decoder__initialize(
+                   &full, sizeof full, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  wuffs_bmp__decoder roi;
+  CHECK_STATUS("initialize",
+               wuffs_bmp__decoder__initialize(
+                   &roi, sizeof roi, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  size_t full_ri = 0;
+  size_t roi_ri = 0;
+  CHECK_STRING(do_test__wuffs_base__image_decoder_roi(
+      wuffs_bmp__decoder__upcast_as__wuffs_base__image_decoder(&full),
+      wuffs_bmp__decoder__upcast_as__wuffs_base__image_decoder(&roi),
+      "test/data/harvesters.bmp",
+      wuffs_base__make_rect_ie_u32(512, 512, 768, 768), &full_ri, &roi_ri));
+  if ((roi_ri * 2) > full_ri) {
+    RETURN_FAIL("roi_ri: have %zu, want <= %zu", roi_ri, full_ri / 2);
+  }
+  return NULL;
+}
+
 const char*  //
 test_wuffs_bmp_decode_io_redirect() {
   CHECK_FOCUS(__func__);
@@ -213,6 +285,7 @@ proc g_tests[] = {
     test_wuffs_bmp_decode_frame_config,
     test_wuffs_bmp_decode_interface,
     test_wuffs_bmp_decode_io_redirect,
+    test_wuffs_bmp_decode_roi,
 
 #ifdef WUFFS_MIMIC
 
@@ -92,6 +92,56 @@ test_wuffs_crc32_ieee_interface() {
       "test/data/hat.lossy.webp", 0, SIZE_MAX, 0x89F53B4E);
 }
 
+const char*  //
+test_wuffs_crc32_ieee_combine() {
+  CHECK_FOCUS(__func__);
+
+  wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+      .data = g_src_slice_u8,
+  });
+  CHECK_STRING(read_file(&src, "test/data/pi.txt"));
+  // The want value is determined by script/checksum.go.
+  const uint32_t want = 0x519E8B87;
+
+  wuffs_crc32__ieee_hasher h;
+  CHECK_STATUS("initialize",
+               wuffs_crc32__ieee_hasher__initialize(
+                   &h, sizeof h, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+
+  size_t splits[] = {0,     1,     99,          255,        256,
+                     4097,  12345, 65536 + 17,  src.meta.wi - 1,  src.meta.wi};
+  int i;
+  for (i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(splits); i++) {
+    size_t n = splits[i];
+    if (n > src.meta.wi) {
+      RETURN_FAIL("i=%d: split is out of bounds", i);
+    }
+    uint32_t crcs[2] = {0};
+    int j;
+    for (j = 0; j < 2; j++) {
+      wuffs_crc32__ieee_hasher checksum;
+      CHECK_STATUS("initialize",
+                   wuffs_crc32__ieee_hasher__initialize(
+                       &checksum, sizeof checksum, WUFFS_VERSION,
+                       WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+      crcs[j] = wuffs_crc32__ieee_hasher__update_u32(
+          &checksum, ((wuffs_base__slice_u8){
+                         .ptr = src.data.ptr + (j ? n : 0),
+                         .len = j ? (src.meta.wi - n) : n,
+                     }));
+    }
+
+    uint32_t have = wuffs_crc32__ieee_hasher__combine_u32(
+        &h, crcs[0], crcs[1], src.meta.wi - n);
+    if (have != want) {
+      RETURN_FAIL("i=%d, n=%zu: have 0x%08" PRIX32 ", want 0x%08" PRIX32, i,
+                  n, have, want);
+    }
+  }
+  return NULL;
+}
+
 const char*  //
 test_wuffs_crc32_ieee_golden() {
   CHECK_FOCUS(__func__);
@@ -253,6 +303,88 @@ test_wuffs_crc32_ieee_pi() {
   return do_test_xxxxx_crc32_ieee_pi(false);
 }
 
+const char*  //
+test_wuffs_crc32_castagnoli_interface() {
+  CHECK_FOCUS(__func__);
+  wuffs_crc32__castagnoli_hasher h;
+  CHECK_STATUS("initialize",
+               wuffs_crc32__castagnoli_hasher__initialize(
+                   &h, sizeof h, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  return do_test__wuffs_base__hasher_u32(
+      wuffs_crc32__castagnoli_hasher__upcast_as__wuffs_base__hasher_u32(&h),
+      "test/data/hat.lossy.webp", 0, SIZE_MAX, 0x56A84923);
+}
+
+const char*  //
+test_wuffs_crc32_castagnoli_golden() {
+  CHECK_FOCUS(__func__);
+
+  struct {
+    const char* filename;
+    // The want values are determined by script/checksum.go.
+    uint32_t want;
+  } test_cases[] = {
+      {
+          .filename = "test/data/hat.bmp",
+          .want = 0xABF7B0E6,
+      },
+      {
+          .filename = "test/data/hat.png",
+          .want = 0xCFB87FD9,
+      },
+      {
+          .filename = "test/data/midsummer.txt",
+          .want = 0x814062F7,
+      },
+      {
+          .filename = "test/data/pi.txt",
+          .want = 0x1B963AB5,
+      },
+  };
+
+  int tc;
+  for (tc = 0; tc < WUFFS_TESTLIB_ARRAY_SIZE(test_cases); tc++) {
+    wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+        .data = g_src_slice_u8,
+    });
+    CHECK_STRING(read_file(&src, test_cases[tc].filename));
+
+    int j;
+    for (j = 0; j < 2; j++) {
+      wuffs_crc32__castagnoli_hasher checksum;
+      CHECK_STATUS("initialize",
+                   wuffs_crc32__castagnoli_hasher__initialize(
+                       &checksum, sizeof checksum, WUFFS_VERSION,
+                       WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+
+      uint32_t have = 0;
+      size_t num_fragments = 0;
+      size_t num_bytes = 0;
+      do {
+        wuffs_base__slice_u8 data = ((wuffs_base__slice_u8){
+            .ptr = src.data.ptr + num_bytes,
+            .len = src.meta.wi - num_bytes,
+        });
+        size_t limit = 101 + 1003 * num_fragments;
+        if ((j > 0) && (data.len > limit)) {
+          data.len = limit;
+        }
+        have = wuffs_crc32__castagnoli_hasher__update_u32(&checksum, data);
+        num_fragments++;
+        num_bytes += data.len;
+      } while (num_bytes < src.meta.wi);
+
+      if (have != test_cases[tc].want) {
+        RETURN_FAIL("tc=%d, j=%d, filename=\"%s\": have 0x%08" PRIX32
+                    ", want 0x%08" PRIX32,
+                    tc, j, test_cases[tc].filename, have, test_cases[tc].want);
+      }
+    }
+  }
+  return NULL;
+}
+
 // ---------------- Mimic Tests
 
 #ifdef WUFFS_MIMIC
@@ -310,6 +442,47 @@ bench_wuffs_crc32_ieee_100k() {
       &g_crc32_pi_gt, UINT64_MAX, UINT64_MAX, 150);
 }
 
+const char*  //
+wuffs_bench_crc32_castagnoli(wuffs_base__io_buffer* dst,
+                             wuffs_base__io_buffer* src,
+                             uint32_t wuffs_initialize_flags,
+                             uint64_t wlimit,
+                             uint64_t rlimit) {
+  uint64_t len = src->meta.wi - src->meta.ri;
+  if (rlimit) {
+    len = wuffs_base__u64__min(len, rlimit);
+  }
+  wuffs_crc32__castagnoli_hasher checksum;
+  CHECK_STATUS("initialize", wuffs_crc32__castagnoli_hasher__initialize(
+                                 &checksum, sizeof checksum, WUFFS_VERSION,
+                                 wuffs_initialize_flags));
+  g_wuffs_crc32_unused_u32 = wuffs_crc32__castagnoli_hasher__update_u32(
+      &checksum, ((wuffs_base__slice_u8){
+                     .ptr = src->data.ptr + src->meta.ri,
+                     .len = len,
+                 }));
+  src->meta.ri += len;
+  return NULL;
+}
+
+const char*  //
+bench_wuffs_crc32_castagnoli_10k() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(
+      wuffs_bench_crc32_castagnoli,
+      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED, tcounter_src,
+      &g_crc32_midsummer_gt, UINT64_MAX, UINT64_MAX, 1500);
+}
+
+const char*  //
+bench_wuffs_crc32_castagnoli_100k() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(
+      wuffs_bench_crc32_castagnoli,
+      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED, tcounter_src,
+      &g_crc32_pi_gt, UINT64_MAX, UINT64_MAX, 150);
+}
+
 // ---------------- Mimic Benches
 
 #ifdef WUFFS_MIMIC
@@ -338,6 +511,9 @@ bench_mimic_crc32_ieee_100k() {
 
 proc g_tests[] = {
 
+    test_wuffs_crc32_castagnoli_golden,
+    test_wuffs_crc32_castagnoli_interface,
+    test_wuffs_crc32_ieee_combine,
     test_wuffs_crc32_ieee_golden,
     test_wuffs_crc32_ieee_interface,
     test_wuffs_crc32_ieee_pi,
@@ -353,6 +529,8 @@ proc g_tests[] = {
 
 proc g_benches[] = {
 
+    bench_wuffs_crc32_castagnoli_10k,
+    bench_wuffs_crc32_castagnoli_100k,
     bench_wuffs_crc32_ieee_10k,
     bench_wuffs_crc32_ieee_100k,
 
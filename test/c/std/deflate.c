@@ -151,6 +151,14 @@ golden_test g_deflate_romeo_fixed_gt = {
     .src_filename = "test/data/romeo.txt.fixed-huff.deflate",
 };
 
+golden_test g_deflate_encode_midsummer_gt = {
+    .src_filename = "test/data/midsummer.txt",
+};
+
+golden_test g_deflate_encode_pi_gt = {
+    .src_filename = "test/data/pi.txt",
+};
+
 // ---------------- Deflate Tests
 
 const char*  //
@@ -322,6 +330,177 @@ test_wuffs_deflate_decode_pi_many_small_writes_reads() {
   return do_test_io_buffers(wuffs_deflate_decode, &g_deflate_pi_gt, 59, 61);
 }
 
+const char*  //
+test_wuffs_deflate_decode_quirk_dst_holds_history() {
+  CHECK_FOCUS(__func__);
+
+  wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+      .data = g_src_slice_u8,
+  });
+  wuffs_base__io_buffer want = ((wuffs_base__io_buffer){
+      .data = g_want_slice_u8,
+  });
+
+  golden_test* gt = &g_deflate_pi_gt;
+  CHECK_STRING(read_file(&src, gt->src_filename));
+  CHECK_STRING(read_file(&want, gt->want_filename));
+  src.meta.wi = gt->src_offset1;
+
+  // Each transform_io call writes at most 4096 bytes, to a dst that starts
+  // (when keep_history is true) up to 32 KiB before the write position, like
+  // a ring buffer would. All of the output ends up contiguous in
+  // g_have_array_u8.
+  int tc;
+  for (tc = 0; tc < 2; tc++) {
+    bool keep_history = tc == 0;
+    wuffs_deflate__decoder dec;
+    CHECK_STATUS("initialize",
+                 wuffs_deflate__decoder__initialize(
+                     &dec, sizeof dec, WUFFS_VERSION,
+                     WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+    wuffs_deflate__decoder__set_quirk_enabled(
+        &dec, WUFFS_DEFLATE__QUIRK_DST_HOLDS_HISTORY, true);
+
+    src.meta.ri = gt->src_offset0;
+    size_t pos = 0;
+    wuffs_base__status status = wuffs_base__make_status(NULL);
+    while (true) {
+      size_t h = (!keep_history) ? 0 : (pos < 32768) ? pos : 32768;
+      wuffs_base__io_buffer dst = ((wuffs_base__io_buffer){
+          .data = wuffs_base__make_slice_u8(g_have_array_u8 + pos - h,
+                                            h + 4096),
+      });
+      dst.meta.wi = h;
+      dst.meta.ri = h;
+      status = wuffs_deflate__decoder__transform_io(&dec, &dst, &src,
+                                                    g_work_slice_u8);
+      pos += dst.meta.wi - h;
+      if (status.repr != wuffs_base__suspension__short_write) {
+        break;
+      }
+    }
+
+    if (!keep_history) {
+      // The decoder does not fall back to its own copy of the history.
+      if (status.repr != wuffs_deflate__error__bad_distance) {
+        RETURN_FAIL("tc=%d: status: have \"%s\", want \"%s\"", tc,
+                    status.repr, wuffs_deflate__error__bad_distance);
+      }
+      continue;
+    } else if (status.repr) {
+      RETURN_FAIL("tc=%d: status: have \"%s\"", tc, status.repr);
+    }
+    wuffs_base__io_buffer have = ((wuffs_base__io_buffer){
+        .data = g_have_slice_u8,
+    });
+    have.meta.wi = pos;
+    CHECK_STRING(check_io_buffers_equal("", &have, &want));
+  }
+  return NULL;
+}
+
+const char*  //
+test_wuffs_deflate_decode_restart_at_block_boundaries() {
+  CHECK_FOCUS(__func__);
+
+  wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+      .data = g_src_slice_u8,
+  });
+  wuffs_base__io_buffer have = ((wuffs_base__io_buffer){
+      .data = g_have_slice_u8,
+  });
+  wuffs_base__io_buffer want = ((wuffs_base__io_buffer){
+      .data = g_want_slice_u8,
+  });
+
+  // This raw DEFLATE stream has multiple blocks, with a back-reference that
+  // crosses a block boundary.
+  golden_test* gt = &g_deflate_deflate_backref_crosses_blocks_gt;
+  CHECK_STRING(read_file(&src, gt->src_filename));
+  CHECK_STRING(read_file(&want, gt->want_filename));
+
+  wuffs_deflate__decoder dec;
+  CHECK_STATUS("initialize",
+               wuffs_deflate__decoder__initialize(
+                   &dec, sizeof dec, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  wuffs_deflate__decoder__set_quirk_enabled(
+      &dec, WUFFS_DEFLATE__QUIRK_SUSPEND_AT_BLOCK_BOUNDARIES, true);
+
+  // Decode the whole stream, noting each block boundary: the src and dst
+  // positions and the pending bits.
+  struct {
+    size_t src_ri;
+    size_t dst_wi;
+    uint32_t bits;
+    uint32_t n_bits;
+  } boundaries[16];
+  int num_boundaries = 0;
+  while (true) {
+    wuffs_base__io_buffer limited_have = make_limited_writer(have, UINT64_MAX);
+    wuffs_base__status status = wuffs_deflate__decoder__transform_io(
+        &dec, &limited_have, &src, g_work_slice_u8);
+    have.meta.wi += limited_have.meta.wi;
+    if (wuffs_base__status__is_ok(&status)) {
+      break;
+    } else if (status.repr != wuffs_deflate__suspension__block_boundary) {
+      RETURN_FAIL("transform_io: have \"%s\", want \"%s\"", status.repr,
+                  wuffs_deflate__suspension__block_boundary);
+    } else if (num_boundaries >= WUFFS_TESTLIB_ARRAY_SIZE(boundaries)) {
+      RETURN_FAIL("too many block boundaries");
+    }
+    uint32_t n_bits = wuffs_deflate__decoder__num_pending_bits(&dec);
+    if (n_bits >= 8) {
+      RETURN_FAIL("num_pending_bits: have %" PRIu32 ", want < 8", n_bits);
+    }
+    boundaries[num_boundaries].src_ri = src.meta.ri;
+    boundaries[num_boundaries].dst_wi = have.meta.wi;
+    boundaries[num_boundaries].bits =
+        wuffs_deflate__decoder__pending_bits(&dec);
+    boundaries[num_boundaries].n_bits = n_bits;
+    num_boundaries++;
+  }
+  CHECK_STRING(check_io_buffers_equal("", &have, &want));
+  if (num_boundaries < 1) {
+    RETURN_FAIL("num_boundaries: have %d, want >= 1", num_boundaries);
+  }
+
+  // Restart a fresh decoder at each block boundary, priming it with the
+  // history and pending bits. The output should match the remaining want.
+  int i;
+  for (i = 0; i < num_boundaries; i++) {
+    CHECK_STATUS("initialize",
+                 wuffs_deflate__decoder__initialize(
+                     &dec, sizeof dec, WUFFS_VERSION,
+                     WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+    size_t dst_wi = boundaries[i].dst_wi;
+    size_t hist_len = (dst_wi < 0x8000) ? dst_wi : 0x8000;
+    wuffs_deflate__decoder__add_history(
+        &dec, wuffs_base__make_slice_u8(g_want_array_u8 + dst_wi - hist_len,
+                                        hist_len));
+    wuffs_deflate__decoder__set_pending_bits(&dec, boundaries[i].bits,
+                                             boundaries[i].n_bits);
+
+    src.meta.ri = boundaries[i].src_ri;
+    wuffs_base__io_buffer restarted = ((wuffs_base__io_buffer){
+        .data = g_work_slice_u8,
+    });
+    CHECK_STATUS("transform_io", wuffs_deflate__decoder__transform_io(
+                                     &dec, &restarted, &src,
+                                     wuffs_base__empty_slice_u8()));
+
+    wuffs_base__io_buffer remaining = ((wuffs_base__io_buffer){
+        .data = wuffs_base__make_slice_u8(g_want_array_u8 + dst_wi,
+                                          want.meta.wi - dst_wi),
+    });
+    remaining.meta.wi = remaining.data.len;
+    char prefix[64];
+    snprintf(prefix, 64, "i=%d: ", i);
+    CHECK_STRING(check_io_buffers_equal(prefix, &restarted, &remaining));
+  }
+  return NULL;
+}
+
 const char*  //
 test_wuffs_deflate_decode_romeo() {
   CHECK_FOCUS(__func__);
@@ -396,6 +575,308 @@ test_wuffs_deflate_decode_split_src() {
   return NULL;
 }
 
+// do_wuffs_deflate_decode_pair decodes two golden tests' DEFLATE streams, each
+// with its own decoder. When interleave is true, it drives the decoders like
+// wuffs_aux::DecodeDeflateBatch does: each runs until it is "$ready to
+// interleave" and then the pair's blocks are decoded by decode_interleaved.
+const char*  //
+do_wuffs_deflate_decode_pair(golden_test* gt0,
+                             golden_test* gt1,
+                             bool interleave,
+                             uint64_t iters,
+                             bool bench) {
+  golden_test* gts[2] = {gt0, gt1};
+  wuffs_base__io_buffer srcs[2];
+  wuffs_base__io_buffer haves[2];
+  const size_t half = IO_BUFFER_ARRAY_SIZE / 2;
+  int j;
+  for (j = 0; j < 2; j++) {
+    srcs[j] = ((wuffs_base__io_buffer){
+        .data = wuffs_base__make_slice_u8(g_src_array_u8 + (j * half), half),
+    });
+    haves[j] = ((wuffs_base__io_buffer){
+        .data = wuffs_base__make_slice_u8(g_have_array_u8 + (j * half), half),
+    });
+    CHECK_STRING(read_file(&srcs[j], gts[j]->src_filename));
+    if (gts[j]->src_offset1) {
+      srcs[j].meta.wi = gts[j]->src_offset1;
+    }
+  }
+
+  wuffs_deflate__decoder decs[2];
+  uint64_t n_bytes = 0;
+  uint64_t n_interleaved = 0;
+  if (bench) {
+    bench_start();
+  }
+  uint64_t i;
+  for (i = 0; i < iters; i++) {
+    bool done[2] = {false, false};
+    bool ready[2] = {false, false};
+    for (j = 0; j < 2; j++) {
+      haves[j].meta.wi = 0;
+      srcs[j].meta.ri = gts[j]->src_offset0;
+      CHECK_STATUS("initialize",
+                   wuffs_deflate__decoder__initialize(
+                       &decs[j], sizeof decs[j], WUFFS_VERSION,
+                       WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+      wuffs_deflate__decoder__set_quirk_enabled(
+          &decs[j], WUFFS_DEFLATE__QUIRK_SUSPEND_FOR_INTERLEAVING, interleave);
+    }
+
+    while (!done[0] || !done[1]) {
+      for (j = 0; j < 2; j++) {
+        if (done[j] || ready[j]) {
+          continue;
+        }
+        wuffs_base__status status = wuffs_deflate__decoder__transform_io(
+            &decs[j], &haves[j], &srcs[j], g_work_slice_u8);
+        if (status.repr == wuffs_deflate__suspension__ready_to_interleave) {
+          ready[j] = true;
+        } else if (status.repr) {
+          RETURN_FAIL("j=%d: transform_io: \"%s\"", j, status.repr);
+        } else {
+          done[j] = true;
+        }
+      }
+      if (ready[0] && ready[1]) {
+        CHECK_STATUS("decode_interleaved",
+                     wuffs_deflate__decoder__decode_interleaved(
+                         &decs[0], &haves[0], &srcs[0], &decs[1], &haves[1],
+                         &srcs[1]));
+        n_interleaved++;
+      }
+      // Resume any lone ready decoder. It decodes the rest of its block by
+      // itself.
+      ready[0] = false;
+      ready[1] = false;
+    }
+    n_bytes += haves[0].meta.wi + haves[1].meta.wi;
+  }
+  if (bench) {
+    bench_finish(iters, n_bytes);
+    return NULL;
+  }
+
+  if (interleave && (n_interleaved == 0)) {
+    RETURN_FAIL("decode_interleaved was never called");
+  }
+  for (j = 0; j < 2; j++) {
+    wuffs_base__io_buffer want = ((wuffs_base__io_buffer){
+        .data = g_want_slice_u8,
+    });
+    CHECK_STRING(read_file(&want, gts[j]->want_filename));
+    char prefix[64];
+    snprintf(prefix, 64, "j=%d: ", j);
+    CHECK_STRING(check_io_buffers_equal(prefix, &haves[j], &want));
+  }
+  return NULL;
+}
+
+const char*  //
+test_wuffs_deflate_decode_interleaved_midsummer_romeo_fixed() {
+  CHECK_FOCUS(__func__);
+  return do_wuffs_deflate_decode_pair(&g_deflate_midsummer_gt,
+                                      &g_deflate_romeo_fixed_gt, true, 1,
+                                      false);
+}
+
+const char*  //
+test_wuffs_deflate_decode_interleaved_pi_pi() {
+  CHECK_FOCUS(__func__);
+  return do_wuffs_deflate_decode_pair(&g_deflate_pi_gt, &g_deflate_pi_gt, true,
+                                      1, false);
+}
+
+const char*  //
+test_wuffs_deflate_decode_interleaved_romeo_midsummer() {
+  CHECK_FOCUS(__func__);
+  return do_wuffs_deflate_decode_pair(&g_deflate_romeo_gt,
+                                      &g_deflate_midsummer_gt, true, 1, false);
+}
+
+const char*  //
+wuffs_deflate_encode(wuffs_base__io_buffer* dst,
+                     wuffs_base__io_buffer* src,
+                     uint32_t wuffs_initialize_flags,
+                     uint64_t wlimit,
+                     uint64_t rlimit,
+                     uint32_t level) {
+  wuffs_deflate__encoder enc;
+  CHECK_STATUS("initialize",
+               wuffs_deflate__encoder__initialize(
+                   &enc, sizeof enc, WUFFS_VERSION, wuffs_initialize_flags));
+  wuffs_deflate__encoder__set_level(&enc, level);
+
+  while (true) {
+    wuffs_base__io_buffer limited_dst = make_limited_writer(*dst, wlimit);
+    wuffs_base__io_buffer limited_src = make_limited_reader(*src, rlimit);
+
+    wuffs_base__status status = wuffs_deflate__encoder__transform_io(
+        &enc, &limited_dst, &limited_src, g_work_slice_u8);
+
+    dst->meta.wi += limited_dst.meta.wi;
+    src->meta.ri += limited_src.meta.ri;
+
+    if (((wlimit < UINT64_MAX) &&
+         (status.repr == wuffs_base__suspension__short_write)) ||
+        ((rlimit < UINT64_MAX) &&
+         (status.repr == wuffs_base__suspension__short_read))) {
+      continue;
+    }
+    return status.repr;
+  }
+}
+
+const char*  //
+wuffs_deflate_encode_fast(wuffs_base__io_buffer* dst,
+                          wuffs_base__io_buffer* src,
+                          uint32_t wuffs_initialize_flags,
+                          uint64_t wlimit,
+                          uint64_t rlimit) {
+  return wuffs_deflate_encode(dst, src, wuffs_initialize_flags, wlimit, rlimit,
+                              WUFFS_DEFLATE__ENCODER_LEVEL_FAST);
+}
+
+const char*  //
+wuffs_deflate_encode_default(wuffs_base__io_buffer* dst,
+                             wuffs_base__io_buffer* src,
+                             uint32_t wuffs_initialize_flags,
+                             uint64_t wlimit,
+                             uint64_t rlimit) {
+  return wuffs_deflate_encode(dst, src, wuffs_initialize_flags, wlimit, rlimit,
+                              WUFFS_DEFLATE__ENCODER_LEVEL_DEFAULT);
+}
+
+const char*  //
+wuffs_deflate_encode_high(wuffs_base__io_buffer* dst,
+                          wuffs_base__io_buffer* src,
+                          uint32_t wuffs_initialize_flags,
+                          uint64_t wlimit,
+                          uint64_t rlimit) {
+  return wuffs_deflate_encode(dst, src, wuffs_initialize_flags, wlimit, rlimit,
+                              WUFFS_DEFLATE__ENCODER_LEVEL_HIGH);
+}
+
+// do_test_wuffs_deflate_encode_round_trip encodes the filename's contents at
+// the given level, checks that decoding that reproduces the original and
+// checks that the encoded form is no longer than want_max_len bytes.
+const char*  //
+do_test_wuffs_deflate_encode_round_trip(const char* filename,
+                                        uint32_t level,
+                                        uint64_t wlimit,
+                                        uint64_t rlimit,
+                                        size_t want_max_len) {
+  wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+      .data = g_src_slice_u8,
+  });
+  wuffs_base__io_buffer enc = ((wuffs_base__io_buffer){
+      .data = g_want_slice_u8,
+  });
+  wuffs_base__io_buffer have = ((wuffs_base__io_buffer){
+      .data = g_have_slice_u8,
+  });
+  CHECK_STRING(read_file(&src, filename));
+
+  CHECK_STRING(wuffs_deflate_encode(
+      &enc, &src, WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED,
+      wlimit, rlimit, level));
+  if (src.meta.ri != src.meta.wi) {
+    RETURN_FAIL("src ri: have %zu, want %zu", src.meta.ri, src.meta.wi);
+  }
+  if (enc.meta.wi > want_max_len) {
+    RETURN_FAIL("level=%" PRIu32 ": encoded length: have %zu, want <= %zu",
+                level, enc.meta.wi, want_max_len);
+  }
+
+  enc.meta.closed = true;
+  CHECK_STRING(wuffs_deflate_decode(
+      &have, &enc, WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED,
+      UINT64_MAX, UINT64_MAX));
+  return check_io_buffers_equal("", &have, &src);
+}
+
+const char*  //
+test_wuffs_deflate_encode_interface() {
+  CHECK_FOCUS(__func__);
+  wuffs_deflate__encoder enc;
+  CHECK_STATUS("initialize",
+               wuffs_deflate__encoder__initialize(
+                   &enc, sizeof enc, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  return do_test__wuffs_base__io_transformer(
+      wuffs_deflate__encoder__upcast_as__wuffs_base__io_transformer(&enc),
+      "test/data/romeo.txt", 0, SIZE_MAX, 530, 0x00);
+}
+
+const char*  //
+test_wuffs_deflate_encode_midsummer() {
+  CHECK_FOCUS(__func__);
+  // These are the lengths of zlib's (raw) deflate output, per level.
+  static const size_t want_max_lens[10] = {
+      11070, 5531, 5417, 5343, 5208, 5144, 5142, 5142, 5142, 5142,
+  };
+  uint32_t level;
+  for (level = 0; level <= 9; level++) {
+    CHECK_STRING(do_test_wuffs_deflate_encode_round_trip(
+        "test/data/midsummer.txt", level, UINT64_MAX, UINT64_MAX,
+        want_max_lens[level]));
+  }
+  return NULL;
+}
+
+const char*  //
+test_wuffs_deflate_encode_pi_fast() {
+  CHECK_FOCUS(__func__);
+  return do_test_wuffs_deflate_encode_round_trip(
+      "test/data/pi.txt", WUFFS_DEFLATE__ENCODER_LEVEL_FAST, UINT64_MAX,
+      UINT64_MAX, 50000);
+}
+
+const char*  //
+test_wuffs_deflate_encode_pi_default() {
+  CHECK_FOCUS(__func__);
+  // The test/data/pi.txt.gz payload is 48318 bytes.
+  return do_test_wuffs_deflate_encode_round_trip(
+      "test/data/pi.txt", WUFFS_DEFLATE__ENCODER_LEVEL_DEFAULT, UINT64_MAX,
+      UINT64_MAX, 48318);
+}
+
+const char*  //
+test_wuffs_deflate_encode_pi_high() {
+  CHECK_FOCUS(__func__);
+  return do_test_wuffs_deflate_encode_round_trip(
+      "test/data/pi.txt", WUFFS_DEFLATE__ENCODER_LEVEL_HIGH, UINT64_MAX,
+      UINT64_MAX, 47000);
+}
+
+const char*  //
+test_wuffs_deflate_encode_pi_many_small_writes_reads() {
+  CHECK_FOCUS(__func__);
+  uint32_t level;
+  for (level = 0; level <= 9; level += 3) {
+    CHECK_STRING(do_test_wuffs_deflate_encode_round_trip(
+        "test/data/pi.txt", level, 59, 61, 110000));
+  }
+  return NULL;
+}
+
+const char*  //
+test_wuffs_deflate_encode_romeo() {
+  CHECK_FOCUS(__func__);
+  // These are the lengths of zlib's (raw) deflate output, per level.
+  static const size_t want_max_lens[10] = {
+      947, 541, 537, 535, 532, 530, 530, 530, 530, 530,
+  };
+  uint32_t level;
+  for (level = 0; level <= 9; level++) {
+    CHECK_STRING(do_test_wuffs_deflate_encode_round_trip(
+        "test/data/romeo.txt", level, UINT64_MAX, UINT64_MAX,
+        want_max_lens[level]));
+  }
+  return NULL;
+}
+
 const char*  //
 do_test_wuffs_deflate_history(int i,
                               golden_test* gt,
@@ -799,6 +1280,33 @@ test_mimic_deflate_decode_romeo_fixed() {
                             UINT64_MAX, UINT64_MAX);
 }
 
+const char*  //
+mimic_deflate_encode_fast(wuffs_base__io_buffer* dst,
+                          wuffs_base__io_buffer* src,
+                          uint32_t wuffs_initialize_flags,
+                          uint64_t wlimit,
+                          uint64_t rlimit) {
+  return mimic_deflate_encode(dst, src, wlimit, rlimit, 1);
+}
+
+const char*  //
+mimic_deflate_encode_default(wuffs_base__io_buffer* dst,
+                             wuffs_base__io_buffer* src,
+                             uint32_t wuffs_initialize_flags,
+                             uint64_t wlimit,
+                             uint64_t rlimit) {
+  return mimic_deflate_encode(dst, src, wlimit, rlimit, 6);
+}
+
+const char*  //
+mimic_deflate_encode_high(wuffs_base__io_buffer* dst,
+                          wuffs_base__io_buffer* src,
+                          uint32_t wuffs_initialize_flags,
+                          uint64_t wlimit,
+                          uint64_t rlimit) {
+  return mimic_deflate_encode(dst, src, wlimit, rlimit, 9);
+}
+
 #endif  // WUFFS_MIMIC
 
 // ---------------- Deflate Benches
@@ -820,6 +1328,20 @@ bench_wuffs_deflate_decode_1k_part_init() {
       &g_deflate_romeo_gt, UINT64_MAX, UINT64_MAX, 2000);
 }
 
+const char*  //
+bench_wuffs_deflate_decode_1k_pairs_interleaved() {
+  CHECK_FOCUS(__func__);
+  return do_wuffs_deflate_decode_pair(&g_deflate_romeo_gt, &g_deflate_romeo_gt,
+                                      true, 1000 * g_flags.iterscale, true);
+}
+
+const char*  //
+bench_wuffs_deflate_decode_1k_pairs_serial() {
+  CHECK_FOCUS(__func__);
+  return do_wuffs_deflate_decode_pair(&g_deflate_romeo_gt, &g_deflate_romeo_gt,
+                                      false, 1000 * g_flags.iterscale, true);
+}
+
 const char*  //
 bench_wuffs_deflate_decode_10k_full_init() {
   CHECK_FOCUS(__func__);
@@ -837,6 +1359,22 @@ bench_wuffs_deflate_decode_10k_part_init() {
       &g_deflate_midsummer_gt, UINT64_MAX, UINT64_MAX, 300);
 }
 
+const char*  //
+bench_wuffs_deflate_decode_10k_pairs_interleaved() {
+  CHECK_FOCUS(__func__);
+  return do_wuffs_deflate_decode_pair(&g_deflate_midsummer_gt,
+                                      &g_deflate_midsummer_gt, true,
+                                      150 * g_flags.iterscale, true);
+}
+
+const char*  //
+bench_wuffs_deflate_decode_10k_pairs_serial() {
+  CHECK_FOCUS(__func__);
+  return do_wuffs_deflate_decode_pair(&g_deflate_midsummer_gt,
+                                      &g_deflate_midsummer_gt, false,
+                                      150 * g_flags.iterscale, true);
+}
+
 const char*  //
 bench_wuffs_deflate_decode_100k_just_one_read() {
   CHECK_FOCUS(__func__);
@@ -855,6 +1393,60 @@ bench_wuffs_deflate_decode_100k_many_big_reads() {
       &g_deflate_pi_gt, UINT64_MAX, 4096, 30);
 }
 
+const char*  //
+bench_wuffs_deflate_encode_10k_fast() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(
+      wuffs_deflate_encode_fast,
+      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED, tcounter_src,
+      &g_deflate_encode_midsummer_gt, UINT64_MAX, UINT64_MAX, 100);
+}
+
+const char*  //
+bench_wuffs_deflate_encode_10k_default() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(
+      wuffs_deflate_encode_default,
+      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED, tcounter_src,
+      &g_deflate_encode_midsummer_gt, UINT64_MAX, UINT64_MAX, 100);
+}
+
+const char*  //
+bench_wuffs_deflate_encode_10k_high() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(
+      wuffs_deflate_encode_high,
+      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED, tcounter_src,
+      &g_deflate_encode_midsummer_gt, UINT64_MAX, UINT64_MAX, 100);
+}
+
+const char*  //
+bench_wuffs_deflate_encode_100k_fast() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(
+      wuffs_deflate_encode_fast,
+      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED, tcounter_src,
+      &g_deflate_encode_pi_gt, UINT64_MAX, UINT64_MAX, 10);
+}
+
+const char*  //
+bench_wuffs_deflate_encode_100k_default() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(
+      wuffs_deflate_encode_default,
+      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED, tcounter_src,
+      &g_deflate_encode_pi_gt, UINT64_MAX, UINT64_MAX, 10);
+}
+
+const char*  //
+bench_wuffs_deflate_encode_100k_high() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(
+      wuffs_deflate_encode_high,
+      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED, tcounter_src,
+      &g_deflate_encode_pi_gt, UINT64_MAX, UINT64_MAX, 10);
+}
+
 // ---------------- Mimic Benches
 
 #ifdef WUFFS_MIMIC
@@ -888,6 +1480,54 @@ bench_mimic_deflate_decode_100k_many_big_reads() {
                              &g_deflate_pi_gt, UINT64_MAX, 4096, 30);
 }
 
+const char*  //
+bench_mimic_deflate_encode_10k_fast() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(mimic_deflate_encode_fast, 0, tcounter_src,
+                             &g_deflate_encode_midsummer_gt, UINT64_MAX,
+                             UINT64_MAX, 100);
+}
+
+const char*  //
+bench_mimic_deflate_encode_10k_default() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(mimic_deflate_encode_default, 0, tcounter_src,
+                             &g_deflate_encode_midsummer_gt, UINT64_MAX,
+                             UINT64_MAX, 100);
+}
+
+const char*  //
+bench_mimic_deflate_encode_10k_high() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(mimic_deflate_encode_high, 0, tcounter_src,
+                             &g_deflate_encode_midsummer_gt, UINT64_MAX,
+                             UINT64_MAX, 100);
+}
+
+const char*  //
+bench_mimic_deflate_encode_100k_fast() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(mimic_deflate_encode_fast, 0, tcounter_src,
+                             &g_deflate_encode_pi_gt, UINT64_MAX, UINT64_MAX,
+                             10);
+}
+
+const char*  //
+bench_mimic_deflate_encode_100k_default() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(mimic_deflate_encode_default, 0, tcounter_src,
+                             &g_deflate_encode_pi_gt, UINT64_MAX, UINT64_MAX,
+                             10);
+}
+
+const char*  //
+bench_mimic_deflate_encode_100k_high() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(mimic_deflate_encode_high, 0, tcounter_src,
+                             &g_deflate_encode_pi_gt, UINT64_MAX, UINT64_MAX,
+                             10);
+}
+
 #endif  // WUFFS_MIMIC
 
 // ---------------- Manifest
@@ -901,14 +1541,26 @@ proc g_tests[] = {
     test_wuffs_deflate_decode_deflate_distance_code_31,
     test_wuffs_deflate_decode_deflate_huffman_primlen_9,
     test_wuffs_deflate_decode_interface,
+    test_wuffs_deflate_decode_interleaved_midsummer_romeo_fixed,
+    test_wuffs_deflate_decode_interleaved_pi_pi,
+    test_wuffs_deflate_decode_interleaved_romeo_midsummer,
     test_wuffs_deflate_decode_midsummer,
     test_wuffs_deflate_decode_pi_just_one_read,
     test_wuffs_deflate_decode_pi_many_big_reads,
     test_wuffs_deflate_decode_pi_many_medium_reads,
     test_wuffs_deflate_decode_pi_many_small_writes_reads,
+    test_wuffs_deflate_decode_quirk_dst_holds_history,
+    test_wuffs_deflate_decode_restart_at_block_boundaries,
     test_wuffs_deflate_decode_romeo,
     test_wuffs_deflate_decode_romeo_fixed,
     test_wuffs_deflate_decode_split_src,
+    test_wuffs_deflate_encode_interface,
+    test_wuffs_deflate_encode_midsummer,
+    test_wuffs_deflate_encode_pi_default,
+    test_wuffs_deflate_encode_pi_fast,
+    test_wuffs_deflate_encode_pi_high,
+    test_wuffs_deflate_encode_pi_many_small_writes_reads,
+    test_wuffs_deflate_encode_romeo,
     test_wuffs_deflate_history_full,
     test_wuffs_deflate_history_partial,
     test_wuffs_deflate_table_redirect,
@@ -937,11 +1589,21 @@ proc g_tests[] = {
 proc g_benches[] = {
 
     bench_wuffs_deflate_decode_1k_full_init,
+    bench_wuffs_deflate_decode_1k_pairs_interleaved,
+    bench_wuffs_deflate_decode_1k_pairs_serial,
     bench_wuffs_deflate_decode_1k_part_init,
     bench_wuffs_deflate_decode_10k_full_init,
+    bench_wuffs_deflate_decode_10k_pairs_interleaved,
+    bench_wuffs_deflate_decode_10k_pairs_serial,
     bench_wuffs_deflate_decode_10k_part_init,
     bench_wuffs_deflate_decode_100k_just_one_read,
     bench_wuffs_deflate_decode_100k_many_big_reads,
+    bench_wuffs_deflate_encode_10k_default,
+    bench_wuffs_deflate_encode_10k_fast,
+    bench_wuffs_deflate_encode_10k_high,
+    bench_wuffs_deflate_encode_100k_default,
+    bench_wuffs_deflate_encode_100k_fast,
+    bench_wuffs_deflate_encode_100k_high,
 
 #ifdef WUFFS_MIMIC
 
@@ -951,6 +1613,12 @@ proc g_benches[] = {
 #ifndef WUFFS_MIMICLIB_DEFLATE_DOES_NOT_SUPPORT_STREAMING
     bench_mimic_deflate_decode_100k_many_big_reads,
 #endif
+    bench_mimic_deflate_encode_10k_default,
+    bench_mimic_deflate_encode_10k_fast,
+    bench_mimic_deflate_encode_10k_high,
+    bench_mimic_deflate_encode_100k_default,
+    bench_mimic_deflate_encode_100k_fast,
+    bench_mimic_deflate_encode_100k_high,
 
 #endif  // WUFFS_MIMIC
 
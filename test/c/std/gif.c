@@ -1133,6 +1133,118 @@ test_wuffs_gif_decode_pixfmt_rgba_nonpremul() {
       wuffs_base__make_pixel_format(WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL));
 }
 
+const char*  //
+test_wuffs_gif_decode_downscale() {
+  CHECK_FOCUS(__func__);
+
+  const char* filenames[] = {
+      "test/data/bricks-dither.gif",
+      "test/data/harvesters.gif",
+      "test/data/hippopotamus.interlaced.gif",
+      "test/data/hippopotamus.regular.gif",
+      "test/data/pjw-thumbnail.gif",
+  };
+
+  int i;
+  for (i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(filenames); i++) {
+    // Interlaced frames only sample the rows of the earlier passes.
+    bool interlaced = strstr(filenames[i], ".interlaced.") != NULL;
+    uint32_t shift;
+    for (shift = 1; shift <= 3; shift++) {
+      wuffs_gif__decoder full;
+      CHECK_STATUS("initialize",
+                   wuffs_gif__decoder__initialize(
+                       &full, sizeof full, WUFFS_VERSION,
+                       WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+      wuffs_gif__decoder downscale;
+      CHECK_STATUS("initialize",
+                   wuffs_gif__decoder__initialize(
+                       &downscale, sizeof downscale, WUFFS_VERSION,
+                       WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+      const char* z = do_test__wuffs_base__image_decoder_downscale(
+          wuffs_gif__decoder__upcast_as__wuffs_base__image_decoder(&full),
+          wuffs_gif__decoder__upcast_as__wuffs_base__image_decoder(&downscale),
+          filenames[i], shift, interlaced, false);
+      if (z) {
+        RETURN_FAIL("%s, shift %" PRIu32 ": %s", filenames[i], shift, z);
+      }
+    }
+  }
+  return NULL;
+}
+
+const char*  //
+test_wuffs_gif_decode_roi() {
+  CHECK_FOCUS(__func__);
+
+  const char* filenames[] = {
+      "test/data/animated-red-blue.gif",
+      "test/data/bricks-dither.gif",
+      "test/data/hippopotamus.interlaced.gif",
+      "test/data/hippopotamus.regular.gif",
+      "test/data/pjw-thumbnail.gif",
+  };
+  const wuffs_base__rect_ie_u32 rois[] = {
+      {.min_incl_x = 0, .min_incl_y = 0, .max_excl_x = 1, .max_excl_y = 1},
+      {.min_incl_x = 5, .min_incl_y = 3, .max_excl_x = 20, .max_excl_y = 17},
+      {.min_incl_x = 30,
+       .min_incl_y = 20,
+       .max_excl_x = 0xFFFFFFFF,
+       .max_excl_y = 0xFFFFFFFF},
+      {.min_incl_x = 7, .min_incl_y = 9, .max_excl_x = 7, .max_excl_y = 9},
+  };
+
+  int i;
+  for (i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(filenames); i++) {
+    int j;
+    for (j = 0; j < WUFFS_TESTLIB_ARRAY_SIZE(rois); j++) {
+      wuffs_gif__decoder full;
+      CHECK_STATUS("initialize",
+                   wuffs_gif__decoder__initialize(
+                       &full, sizeof full, WUFFS_VERSION,
+                       WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+      wuffs_gif__decoder roi;
+      CHECK_STATUS("initialize",
+                   wuffs_gif__decoder__initialize(
+                       &roi, sizeof roi, WUFFS_VERSION,
+                       WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+      size_t full_ri = 0;
+      size_t roi_ri = 0;
+      const char* z = do_test__wuffs_base__image_decoder_roi(
+          wuffs_gif__decoder__upcast_as__wuffs_base__image_decoder(&full),
+          wuffs_gif__decoder__upcast_as__wuffs_base__image_decoder(&roi),
+          filenames[i], rois[j], &full_ri, &roi_ri);
+      if (z) {
+        RETURN_FAIL("%s, roi #%d: %s", filenames[i], j, z);
+      }
+    }
+  }
+
+  // A large, non-interlaced frame stops LZW-decoding after the ROI's bottom
+  // row, skipping (but still reading) the rest of the frame's data blocks.
+  wuffs_gif__decoder full;
+  CHECK_STATUS("initialize",
+               wuffs_gif__decoder__initialize(
+                   &full, sizeof full, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  wuffs_gif__decoder roi;
+  CHECK_STATUS("initialize",
+               wuffs_gif__decoder__initialize(
+                   &roi, sizeof roi, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  size_t full_ri = 0;
+  size_t roi_ri = 0;
+  CHECK_STRING(do_test__wuffs_base__image_decoder_roi(
+      wuffs_gif__decoder__upcast_as__wuffs_base__image_decoder(&full),
+      wuffs_gif__decoder__upcast_as__wuffs_base__image_decoder(&roi),
+      "test/data/harvesters.gif",
+      wuffs_base__make_rect_ie_u32(512, 128, 768, 384), &full_ri, &roi_ri));
+  if (roi_ri != full_ri) {
+    RETURN_FAIL("roi_ri: have %zu, want %zu", roi_ri, full_ri);
+  }
+  return NULL;
+}
+
 const char*  //
 test_wuffs_gif_decode_input_is_a_gif_just_one_read() {
   CHECK_FOCUS(__func__);
@@ -2324,6 +2436,7 @@ proc g_tests[] = {
     test_wuffs_gif_decode_animated_small,
     test_wuffs_gif_decode_background_color,
     test_wuffs_gif_decode_delay_num_frames_decoded,
+    test_wuffs_gif_decode_downscale,
     test_wuffs_gif_decode_empty_palette,
     test_wuffs_gif_decode_first_frame_is_opaque,
     test_wuffs_gif_decode_frame_out_of_bounds,
@@ -2349,6 +2462,7 @@ proc g_tests[] = {
     test_wuffs_gif_decode_pixfmt_bgra_nonpremul,
     test_wuffs_gif_decode_pixfmt_rgb,
     test_wuffs_gif_decode_pixfmt_rgba_nonpremul,
+    test_wuffs_gif_decode_roi,
     test_wuffs_gif_decode_zero_width_frame,
     test_wuffs_gif_frame_dirty_rect,
     test_wuffs_gif_num_decoded_frame_configs,
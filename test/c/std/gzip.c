@@ -127,6 +127,82 @@ wuffs_gzip_decode(wuffs_base__io_buffer* dst,
   }
 }
 
+const char*  //
+wuffs_gzip_decode_two_pass(wuffs_base__io_buffer* dst,
+                           wuffs_base__io_buffer* src,
+                           uint32_t wuffs_initialize_flags,
+                           uint64_t wlimit,
+                           uint64_t rlimit) {
+  // This is like wuffs_gzip_decode (without the limits) but, instead of the
+  // gzip decoder verifying the CRC-32 checksum as it decodes, the checksum is
+  // computed afterwards, in a second pass over the entire dst. It is only for
+  // comparing benchmark numbers.
+  wuffs_gzip__decoder dec;
+  CHECK_STATUS("initialize",
+               wuffs_gzip__decoder__initialize(&dec, sizeof dec, WUFFS_VERSION,
+                                               wuffs_initialize_flags));
+  wuffs_gzip__decoder__set_quirk_enabled(
+      &dec, WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, true);
+  size_t wi0 = dst->meta.wi;
+  CHECK_STATUS("transform_io", wuffs_gzip__decoder__transform_io(
+                                   &dec, dst, src, g_work_slice_u8));
+
+  wuffs_crc32__ieee_hasher checksum;
+  CHECK_STATUS("initialize",
+               wuffs_crc32__ieee_hasher__initialize(
+                   &checksum, sizeof checksum, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  uint32_t have = wuffs_crc32__ieee_hasher__update_u32(
+      &checksum,
+      wuffs_base__make_slice_u8(dst->data.ptr + wi0, dst->meta.wi - wi0));
+  if (src->meta.ri < 8) {
+    RETURN_FAIL("src->meta.ri: have %zu, want >= 8", src->meta.ri);
+  }
+  uint32_t want =
+      wuffs_base__peek_u32le__no_bounds_check(src->data.ptr + src->meta.ri - 8);
+  if (have != want) {
+    return wuffs_gzip__error__bad_checksum;
+  }
+  return NULL;
+}
+
+// make_large_gzip sets want to n bytes (repeating test/data/pi.txt) and src
+// to their gzip encoding. That is more than the decoder's 128 KiB per call
+// limit on output that is checksummed while still in the CPU cache.
+const char*  //
+make_large_gzip(wuffs_base__io_buffer* src,
+                wuffs_base__io_buffer* want,
+                size_t n) {
+  *want = ((wuffs_base__io_buffer){
+      .data = g_want_slice_u8,
+  });
+  CHECK_STRING(read_file(want, "test/data/pi.txt"));
+  if ((want->meta.wi == 0) || (want->data.len < n)) {
+    RETURN_FAIL("make_large_gzip: bad length");
+  }
+  size_t i;
+  for (i = want->meta.wi; i < n; i++) {
+    want->data.ptr[i] = want->data.ptr[i - want->meta.wi];
+  }
+  want->meta.wi = n;
+  want->meta.closed = true;
+
+  *src = ((wuffs_base__io_buffer){
+      .data = g_src_slice_u8,
+  });
+  wuffs_gzip__encoder enc;
+  CHECK_STATUS("initialize",
+               wuffs_gzip__encoder__initialize(
+                   &enc, sizeof enc, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  wuffs_gzip__encoder__set_level(&enc, WUFFS_DEFLATE__ENCODER_LEVEL_FAST);
+  CHECK_STATUS("transform_io", wuffs_gzip__encoder__transform_io(
+                                   &enc, src, want, g_work_slice_u8));
+  want->meta.ri = 0;
+  src->meta.closed = true;
+  return NULL;
+}
+
 const char*  //
 do_test_wuffs_gzip_checksum(bool ignore_checksum, uint32_t bad_checksum) {
   wuffs_base__io_buffer have = ((wuffs_base__io_buffer){
@@ -216,6 +292,49 @@ test_wuffs_gzip_checksum_verify_good() {
   return do_test_wuffs_gzip_checksum(false, 0);
 }
 
+const char*  //
+test_wuffs_gzip_decode_large_dst() {
+  CHECK_FOCUS(__func__);
+  wuffs_base__io_buffer src;
+  wuffs_base__io_buffer want;
+  CHECK_STRING(make_large_gzip(&src, &want, (1 << 20) + 12345));
+
+  // Decode into a single dst, which takes several deflate calls (each
+  // followed by a checksum update) per transform_io call. The tc variable's
+  // values mean:
+  //  - 0: a good checksum.
+  //  - 1: a bad checksum.
+  //  - 2: a bad checksum, ignored.
+  int tc;
+  for (tc = 0; tc < 3; tc++) {
+    if (tc == 1) {
+      src.data.ptr[src.meta.wi - 8] ^= 1;
+    }
+    wuffs_gzip__decoder dec;
+    CHECK_STATUS("initialize",
+                 wuffs_gzip__decoder__initialize(
+                     &dec, sizeof dec, WUFFS_VERSION,
+                     WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+    wuffs_gzip__decoder__set_quirk_enabled(
+        &dec, WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, tc == 2);
+    wuffs_base__io_buffer have = ((wuffs_base__io_buffer){
+        .data = g_have_slice_u8,
+    });
+    src.meta.ri = 0;
+    wuffs_base__status status =
+        wuffs_gzip__decoder__transform_io(&dec, &have, &src, g_work_slice_u8);
+    const char* want_z = (tc == 1) ? wuffs_gzip__error__bad_checksum : NULL;
+    if (status.repr != want_z) {
+      RETURN_FAIL("tc=%d: have \"%s\", want \"%s\"", tc, status.repr,
+                  want_z);
+    }
+    char prefix[64];
+    snprintf(prefix, 64, "tc=%d: ", tc);
+    CHECK_STRING(check_io_buffers_equal(prefix, &have, &want));
+  }
+  return NULL;
+}
+
 const char*  //
 test_wuffs_gzip_decode_midsummer() {
   CHECK_FOCUS(__func__);
@@ -223,6 +342,12 @@ test_wuffs_gzip_decode_midsummer() {
                             UINT64_MAX);
 }
 
+const char*  //
+test_wuffs_gzip_decode_midsummer_many_small_writes_reads() {
+  CHECK_FOCUS(__func__);
+  return do_test_io_buffers(wuffs_gzip_decode, &g_gzip_midsummer_gt, 100, 100);
+}
+
 const char*  //
 test_wuffs_gzip_decode_pi() {
   CHECK_FOCUS(__func__);
@@ -230,6 +355,73 @@ test_wuffs_gzip_decode_pi() {
                             UINT64_MAX);
 }
 
+const char*  //
+do_test_wuffs_gzip_encode(uint32_t level, uint8_t want_xfl) {
+  wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+      .data = g_src_slice_u8,
+  });
+  wuffs_base__io_buffer enc = ((wuffs_base__io_buffer){
+      .data = g_want_slice_u8,
+  });
+  wuffs_base__io_buffer have = ((wuffs_base__io_buffer){
+      .data = g_have_slice_u8,
+  });
+  CHECK_STRING(read_file(&src, "test/data/pi.txt"));
+
+  wuffs_gzip__encoder encoder;
+  CHECK_STATUS("initialize",
+               wuffs_gzip__encoder__initialize(
+                   &encoder, sizeof encoder, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  wuffs_gzip__encoder__set_level(&encoder, level);
+
+  // Use small reads and writes, to exercise suspending and resuming within
+  // the header and trailer.
+  while (true) {
+    wuffs_base__io_buffer limited_enc = make_limited_writer(enc, 3);
+    wuffs_base__io_buffer limited_src = make_limited_reader(src, 5000);
+    wuffs_base__status status = wuffs_gzip__encoder__transform_io(
+        &encoder, &limited_enc, &limited_src, g_work_slice_u8);
+    enc.meta.wi += limited_enc.meta.wi;
+    src.meta.ri += limited_src.meta.ri;
+    if ((status.repr == wuffs_base__suspension__short_write) ||
+        (status.repr == wuffs_base__suspension__short_read)) {
+      continue;
+    }
+    CHECK_STATUS("transform_io", status);
+    break;
+  }
+  if ((enc.meta.wi < 10) || (enc.data.ptr[0] != 0x1F) ||
+      (enc.data.ptr[1] != 0x8B) || (enc.data.ptr[8] != want_xfl)) {
+    RETURN_FAIL("bad header");
+  }
+
+  src.meta.ri = 0;
+  enc.meta.closed = true;
+  CHECK_STRING(wuffs_gzip_decode(
+      &have, &enc, WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED,
+      UINT64_MAX, UINT64_MAX));
+  return check_io_buffers_equal("", &have, &src);
+}
+
+const char*  //
+test_wuffs_gzip_encode_default() {
+  CHECK_FOCUS(__func__);
+  return do_test_wuffs_gzip_encode(WUFFS_DEFLATE__ENCODER_LEVEL_DEFAULT, 0);
+}
+
+const char*  //
+test_wuffs_gzip_encode_fast() {
+  CHECK_FOCUS(__func__);
+  return do_test_wuffs_gzip_encode(WUFFS_DEFLATE__ENCODER_LEVEL_FAST, 4);
+}
+
+const char*  //
+test_wuffs_gzip_encode_high() {
+  CHECK_FOCUS(__func__);
+  return do_test_wuffs_gzip_encode(WUFFS_DEFLATE__ENCODER_LEVEL_HIGH, 2);
+}
+
 // ---------------- Mimic Tests
 
 #ifdef WUFFS_MIMIC
@@ -268,6 +460,67 @@ bench_wuffs_gzip_decode_100k() {
       tcounter_dst, &g_gzip_pi_gt, UINT64_MAX, UINT64_MAX, 30);
 }
 
+const char*  //
+bench_wuffs_gzip_decode_10k_two_pass() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(
+      wuffs_gzip_decode_two_pass,
+      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED, tcounter_dst,
+      &g_gzip_midsummer_gt, UINT64_MAX, UINT64_MAX, 300);
+}
+
+const char*  //
+bench_wuffs_gzip_decode_100k_two_pass() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(
+      wuffs_gzip_decode_two_pass,
+      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED, tcounter_dst,
+      &g_gzip_pi_gt, UINT64_MAX, UINT64_MAX, 30);
+}
+
+const char*  //
+do_bench_wuffs_gzip_decode_large(
+    const char* (*codec_func)(wuffs_base__io_buffer*,
+                              wuffs_base__io_buffer*,
+                              uint32_t,
+                              uint64_t,
+                              uint64_t),
+    uint64_t iters_unscaled) {
+  wuffs_base__io_buffer src;
+  wuffs_base__io_buffer want;
+  CHECK_STRING(make_large_gzip(&src, &want, 8 << 20));
+  wuffs_base__io_buffer have = ((wuffs_base__io_buffer){
+      .data = g_have_slice_u8,
+  });
+
+  uint64_t iters = iters_unscaled * g_flags.iterscale;
+  uint64_t n_bytes = 0;
+  bench_start();
+  uint64_t i;
+  for (i = 0; i < iters; i++) {
+    have.meta.wi = 0;
+    src.meta.ri = 0;
+    CHECK_STRING((*codec_func)(
+        &have, &src, WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED,
+        UINT64_MAX, UINT64_MAX));
+    n_bytes += have.meta.wi;
+  }
+  bench_finish(iters, n_bytes);
+  return NULL;
+}
+
+const char*  //
+bench_wuffs_gzip_decode_8m() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_gzip_decode_large(wuffs_gzip_decode, 1);
+}
+
+const char*  //
+bench_wuffs_gzip_decode_8m_two_pass() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_gzip_decode_large(wuffs_gzip_decode_two_pass, 1);
+}
+
 // ---------------- Mimic Benches
 
 #ifdef WUFFS_MIMIC
@@ -300,8 +553,13 @@ proc g_tests[] = {
     test_wuffs_gzip_checksum_verify_bad7,
     test_wuffs_gzip_checksum_verify_good,
     test_wuffs_gzip_decode_interface,
+    test_wuffs_gzip_decode_large_dst,
     test_wuffs_gzip_decode_midsummer,
+    test_wuffs_gzip_decode_midsummer_many_small_writes_reads,
     test_wuffs_gzip_decode_pi,
+    test_wuffs_gzip_encode_default,
+    test_wuffs_gzip_encode_fast,
+    test_wuffs_gzip_encode_high,
 
 #ifdef WUFFS_MIMIC
 
@@ -317,6 +575,10 @@ proc g_benches[] = {
 
     bench_wuffs_gzip_decode_10k,
     bench_wuffs_gzip_decode_100k,
+    bench_wuffs_gzip_decode_10k_two_pass,
+    bench_wuffs_gzip_decode_100k_two_pass,
+    bench_wuffs_gzip_decode_8m,
+    bench_wuffs_gzip_decode_8m_two_pass,
 
 #ifdef WUFFS_MIMIC
 
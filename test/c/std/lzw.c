@@ -194,6 +194,15 @@ test_wuffs_lzw_decode_many_big_reads() {
                                   UINT64_MAX, 4096);
 }
 
+const char*  //
+test_wuffs_lzw_decode_many_big_writes_reads() {
+  CHECK_FOCUS(__func__);
+  // A wlimit just above 4105 alternates between the read_from_fast and
+  // read_from code paths.
+  return do_test_wuffs_lzw_decode("test/data/pi.txt.giflzw", 50550,
+                                  "test/data/pi.txt", 100003, 5000, 4096);
+}
+
 const char*  //
 test_wuffs_lzw_decode_many_small_writes_reads() {
   CHECK_FOCUS(__func__);
@@ -443,6 +452,7 @@ proc g_tests[] = {
     test_wuffs_lzw_decode_bricks_nodither,
     test_wuffs_lzw_decode_interface,
     test_wuffs_lzw_decode_many_big_reads,
+    test_wuffs_lzw_decode_many_big_writes_reads,
     test_wuffs_lzw_decode_many_small_writes_reads,
     test_wuffs_lzw_decode_output_bad,
     test_wuffs_lzw_decode_output_empty,
@@ -94,6 +94,45 @@ wuffs_png_decode(uint64_t* n_bytes_out,
       n_bytes_out, dst, pixfmt, quirks_ptr, quirks_len, src);
 }
 
+// wuffs_png_decode_streaming is like wuffs_png_decode but passes the smallest
+// workbuf that the decoder accepts, so that it un-filters and swizzles one row
+// at a time instead of one (multi-row) strip at a time.
+const char*  //
+wuffs_png_decode_streaming(uint64_t* n_bytes_out,
+                           wuffs_base__io_buffer* dst,
+                           uint32_t wuffs_initialize_flags,
+                           wuffs_base__pixel_format pixfmt,
+                           uint32_t* quirks_ptr,
+                           size_t quirks_len,
+                           wuffs_base__io_buffer* src) {
+  wuffs_png__decoder dec;
+  CHECK_STATUS("initialize #0",
+               wuffs_png__decoder__initialize(&dec, sizeof dec, WUFFS_VERSION,
+                                              wuffs_initialize_flags));
+  size_t src_ri = src->meta.ri;
+  wuffs_base__image_config ic = ((wuffs_base__image_config){});
+  CHECK_STATUS("decode_image_config",
+               wuffs_png__decoder__decode_image_config(&dec, &ic, src));
+  src->meta.ri = src_ri;
+  wuffs_base__range_ii_u64 workbuf_len = wuffs_png__decoder__workbuf_len(&dec);
+  if ((workbuf_len.min_incl > workbuf_len.max_incl) ||
+      (workbuf_len.max_incl > g_work_slice_u8.len)) {
+    RETURN_FAIL("workbuf_len: [%" PRIu64 " ..= %" PRIu64 "]",
+                workbuf_len.min_incl, workbuf_len.max_incl);
+  }
+
+  CHECK_STATUS("initialize #1",
+               wuffs_png__decoder__initialize(&dec, sizeof dec, WUFFS_VERSION,
+                                              wuffs_initialize_flags));
+  wuffs_base__slice_u8 saved_work_slice_u8 = g_work_slice_u8;
+  g_work_slice_u8.len = workbuf_len.min_incl;
+  const char* ret = do_run__wuffs_base__image_decoder(
+      wuffs_png__decoder__upcast_as__wuffs_base__image_decoder(&dec),
+      n_bytes_out, dst, pixfmt, quirks_ptr, quirks_len, src);
+  g_work_slice_u8 = saved_work_slice_u8;
+  return ret;
+}
+
 const char*  //
 do_test_xxxxx_png_decode_bad_crc32_checksum_critical(
     const char* (*decode_func)(uint64_t* n_bytes_out,
@@ -151,6 +190,10 @@ do_wuffs_png_swizzle(uint32_t width,
                                  WUFFS_INITIALIZE__DEFAULT_OPTIONS));
   dec.private_impl.f_width = width;
   dec.private_impl.f_height = height;
+  dec.private_impl.f_frame_rect_x1 = width;
+  dec.private_impl.f_frame_rect_y1 = height;
+  dec.private_impl.f_roi_x1 = 0xFFFFFFFF;
+  dec.private_impl.f_roi_y1 = 0xFFFFFFFF;
   dec.private_impl.f_pass_bytes_per_row = width;
   dec.private_impl.f_filter_distance = filter_distance;
   wuffs_png__decoder__choose_filter_implementations(&dec);
@@ -172,7 +215,9 @@ do_wuffs_png_swizzle(uint32_t width,
   CHECK_STATUS("set_from_slice",
                wuffs_base__pixel_buffer__set_from_slice(&pb, &pc, dst));
   CHECK_STATUS("filter_and_swizzle",
-               wuffs_png__decoder__filter_and_swizzle(&dec, &pb, workbuf));
+               wuffs_png__decoder__filter_and_swizzle(
+                   &dec, &pb, wuffs_base__empty_slice_u8(), workbuf,
+                   wuffs_base__empty_slice_u8()));
   return NULL;
 }
 
@@ -198,6 +243,262 @@ test_wuffs_png_decode_bad_crc32_checksum_critical() {
       &wuffs_png_decode);
 }
 
+const char*  //
+test_wuffs_png_decode_src_pixfmt() {
+  CHECK_FOCUS(__func__);
+
+  // Decoding to the PNG's own pixel format (Y or RGB) makes the swizzler a
+  // plain copy. Check that against decoding to BGR, which isn't.
+  struct {
+    const char* filename;
+    uint32_t pixfmt;
+  } test_cases[] = {
+      {"test/data/bricks-color.png", WUFFS_BASE__PIXEL_FORMAT__RGB},
+      {"test/data/bricks-gray.png", WUFFS_BASE__PIXEL_FORMAT__Y},
+      {"test/data/harvesters.png", WUFFS_BASE__PIXEL_FORMAT__RGB},
+      {"test/data/hat.png", WUFFS_BASE__PIXEL_FORMAT__RGB},
+      {"test/data/hibiscus.regular.png", WUFFS_BASE__PIXEL_FORMAT__RGB},
+  };
+
+  int tc;
+  for (tc = 0; tc < WUFFS_TESTLIB_ARRAY_SIZE(test_cases); tc++) {
+    wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+        .data = g_src_slice_u8,
+    });
+    CHECK_STRING(read_file(&src, test_cases[tc].filename));
+
+    wuffs_base__io_buffer have = ((wuffs_base__io_buffer){
+        .data = g_have_slice_u8,
+    });
+    CHECK_STRING(wuffs_png_decode(
+        NULL, &have, WUFFS_INITIALIZE__DEFAULT_OPTIONS,
+        wuffs_base__make_pixel_format(test_cases[tc].pixfmt), NULL, 0, &src));
+
+    src.meta.ri = 0;
+    wuffs_base__io_buffer want = ((wuffs_base__io_buffer){
+        .data = g_want_slice_u8,
+    });
+    CHECK_STRING(wuffs_png_decode(
+        NULL, &want, WUFFS_INITIALIZE__DEFAULT_OPTIONS,
+        wuffs_base__make_pixel_format(WUFFS_BASE__PIXEL_FORMAT__BGR), NULL, 0,
+        &src));
+
+    bool gray = test_cases[tc].pixfmt == WUFFS_BASE__PIXEL_FORMAT__Y;
+    size_t n = have.meta.wi / (gray ? 1 : 3);
+    if (want.meta.wi != (n * 3)) {
+      RETURN_FAIL("tc=%d: length: have %zu, want %zu", tc, have.meta.wi,
+                  want.meta.wi);
+    }
+    size_t i;
+    for (i = 0; i < n; i++) {
+      uint8_t* h = have.data.ptr + (i * (gray ? 1 : 3));
+      uint8_t* w = want.data.ptr + (i * 3);
+      if ((h[0] != w[gray ? 0 : 2]) || (h[gray ? 0 : 1] != w[1]) ||
+          (h[gray ? 0 : 2] != w[gray ? 2 : 0])) {
+        RETURN_FAIL("tc=%d: pixel #%zu differs", tc, i);
+      }
+    }
+  }
+  return NULL;
+}
+
+const char*  //
+test_wuffs_png_decode_low_bit_depth() {
+  CHECK_FOCUS(__func__);
+
+  // Build 70 × 2 gray PNGs with 1, 2 and 4 bits per pixel, so that each row
+  // is longer than the decoder's 64-pixel unpacking chunk and ends part-way
+  // through a byte. The zlib stream holds the filtered rows in one stored
+  // (uncompressed) block. Every decoded pixel is checked.
+  const uint32_t width = 70;
+  const uint32_t height = 2;
+  uint8_t filtered[2 * (1 + 35)];
+  uint32_t depth;
+  for (depth = 1; depth <= 4; depth *= 2) {
+    uint32_t bytes_per_row = ((width * depth) + 7) / 8;
+    uint32_t n = height * (1 + bytes_per_row);
+    uint32_t x = 1;
+    uint32_t i;
+    for (i = 0; i < n; i++) {
+      x = (x * 1103515245) + 12345;
+      filtered[i] = (uint8_t)(x >> 16);
+    }
+    filtered[0] = 0;
+    filtered[1 + bytes_per_row] = 0;
+
+    wuffs_crc32__ieee_hasher crc32;
+    wuffs_adler32__hasher adler32;
+    uint8_t* p = g_src_slice_u8.ptr;
+    memcpy(p + 0x00, "\x89PNG\r\n\x1A\n\x00\x00\x00\x0DIHDR", 16);
+    wuffs_base__poke_u32be__no_bounds_check(p + 0x10, width);
+    wuffs_base__poke_u32be__no_bounds_check(p + 0x14, height);
+    p[0x18] = (uint8_t)depth;
+    p[0x19] = 0;
+    p[0x1A] = 0;
+    p[0x1B] = 0;
+    p[0x1C] = 0;
+    CHECK_STATUS("initialize", wuffs_crc32__ieee_hasher__initialize(
+                                   &crc32, sizeof crc32, WUFFS_VERSION,
+                                   WUFFS_INITIALIZE__DEFAULT_OPTIONS));
+    wuffs_base__poke_u32be__no_bounds_check(
+        p + 0x1D, wuffs_crc32__ieee_hasher__update_u32(
+                      &crc32, wuffs_base__make_slice_u8(p + 0x0C, 0x11)));
+
+    wuffs_base__poke_u32be__no_bounds_check(p + 0x21, 11 + n);
+    memcpy(p + 0x25, "IDAT\x78\x01\x01", 7);
+    wuffs_base__poke_u16le__no_bounds_check(p + 0x2C, (uint16_t)n);
+    wuffs_base__poke_u16le__no_bounds_check(p + 0x2E, (uint16_t)~n);
+    memcpy(p + 0x30, filtered, n);
+    CHECK_STATUS("initialize", wuffs_adler32__hasher__initialize(
+                                   &adler32, sizeof adler32, WUFFS_VERSION,
+                                   WUFFS_INITIALIZE__DEFAULT_OPTIONS));
+    wuffs_base__poke_u32be__no_bounds_check(
+        p + 0x30 + n, wuffs_adler32__hasher__update_u32(
+                          &adler32, wuffs_base__make_slice_u8(filtered, n)));
+    CHECK_STATUS("initialize", wuffs_crc32__ieee_hasher__initialize(
+                                   &crc32, sizeof crc32, WUFFS_VERSION,
+                                   WUFFS_INITIALIZE__DEFAULT_OPTIONS));
+    wuffs_base__poke_u32be__no_bounds_check(
+        p + 0x34 + n, wuffs_crc32__ieee_hasher__update_u32(
+                          &crc32, wuffs_base__make_slice_u8(p + 0x25, 15 + n)));
+    memcpy(p + 0x38 + n, "\x00\x00\x00\x00IEND\xAE\x42\x60\x82", 12);
+
+    wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+        .data = g_src_slice_u8,
+    });
+    src.meta.wi = 0x44 + n;
+    src.meta.closed = true;
+    wuffs_base__io_buffer have = ((wuffs_base__io_buffer){
+        .data = g_have_slice_u8,
+    });
+    CHECK_STRING(wuffs_png_decode(
+        NULL, &have, WUFFS_INITIALIZE__DEFAULT_OPTIONS,
+        wuffs_base__make_pixel_format(WUFFS_BASE__PIXEL_FORMAT__Y), NULL, 0,
+        &src));
+    if (have.meta.wi != (width * height)) {
+      RETURN_FAIL("depth=%" PRIu32 ": length: have %zu, want %" PRIu32, depth,
+                  have.meta.wi, width * height);
+    }
+
+    uint32_t y;
+    for (y = 0; y < height; y++) {
+      const uint8_t* row = filtered + 1 + (y * (1 + bytes_per_row));
+      uint32_t x;
+      for (x = 0; x < width; x++) {
+        uint32_t bit = x * depth;
+        uint32_t field = (uint32_t)(row[bit / 8] >> (8 - depth - (bit % 8))) &
+                         ((1u << depth) - 1);
+        uint8_t want = (uint8_t)((field * 0xFF) / ((1u << depth) - 1));
+        uint8_t got = have.data.ptr[(y * width) + x];
+        if (got != want) {
+          RETURN_FAIL("depth=%" PRIu32 ": pixel (%" PRIu32 ", %" PRIu32
+                      "): have 0x%02X, want 0x%02X",
+                      depth, x, y, got, want);
+        }
+      }
+    }
+  }
+  return NULL;
+}
+
+typedef uint64_t (*unpack_bits_func)(wuffs_png__decoder* self,
+                                     wuffs_base__slice_u8 a_dst,
+                                     wuffs_base__slice_u8 a_src,
+                                     uint8_t a_multiplier);
+
+const char*  //
+test_wuffs_png_decode_unpack_bits_simd() {
+  CHECK_FOCUS(__func__);
+
+  // Each kernel unpacks whole groups of its own width (8 pixels for the
+  // default, 16 for SIMD), as many as fit in both dst and src, and writes
+  // nothing past them.
+  const struct {
+    unpack_bits_func func;
+    bool available;
+    uint32_t group;
+  } kernels[] = {
+      {wuffs_png__decoder__unpack_bits__choosy_default, true, 8},
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      {wuffs_png__decoder__unpack_bits_x86_sse42,
+       wuffs_base__cpu_arch__have_x86_sse42(), 16},
+#endif
+  };
+
+  wuffs_png__decoder dec;
+  CHECK_STATUS("initialize",
+               wuffs_png__decoder__initialize(
+                   &dec, sizeof dec, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+
+  uint8_t src[40];
+  uint32_t x = 1;
+  uint32_t i;
+  for (i = 0; i < sizeof src; i++) {
+    x = (x * 1103515245) + 12345;
+    src[i] = (uint8_t)(x >> 16);
+  }
+  const uint8_t multipliers[] = {0x01, 0x11, 0x55, 0xFF};
+  uint8_t dst[88];
+
+  int k;
+  for (k = 0; k < WUFFS_TESTLIB_ARRAY_SIZE(kernels); k++) {
+    if (!kernels[k].available) {
+      continue;
+    }
+    uint32_t depth;
+    for (depth = 1; depth <= 4; depth *= 2) {
+      dec.private_impl.f_depth = (uint8_t)depth;
+      int j;
+      for (j = 0; j < WUFFS_TESTLIB_ARRAY_SIZE(multipliers); j++) {
+        uint8_t m = multipliers[j];
+        if ((m != 0x01) && (m != (0xFF / ((1u << depth) - 1)))) {
+          continue;
+        }
+        size_t dst_len;
+        for (dst_len = 0; (dst_len + 8) <= sizeof dst; dst_len++) {
+          size_t src_len;
+          for (src_len = 0; src_len <= sizeof src; src_len++) {
+            memset(dst, 0xEE, sizeof dst);
+            uint64_t have = (*kernels[k].func)(
+                &dec, wuffs_base__make_slice_u8(dst, dst_len),
+                wuffs_base__make_slice_u8(src, src_len), m);
+            size_t groups = dst_len / kernels[k].group;
+            size_t src_groups = (src_len * 8) / (depth * kernels[k].group);
+            if (groups > src_groups) {
+              groups = src_groups;
+            }
+            uint64_t want = groups * kernels[k].group;
+            if (have != want) {
+              RETURN_FAIL("k=%d, depth=%" PRIu32 ", m=0x%02X, dst_len=%zu, "
+                          "src_len=%zu: have %" PRIu64 ", want %" PRIu64,
+                          k, depth, m, dst_len, src_len, have, want);
+            }
+            for (i = 0; i < sizeof dst; i++) {
+              uint8_t want_pixel = 0xEE;
+              if (i < want) {
+                uint32_t bit = i * depth;
+                uint32_t field =
+                    (uint32_t)(src[bit / 8] >> (8 - depth - (bit % 8))) &
+                    ((1u << depth) - 1);
+                want_pixel = (uint8_t)(field * m);
+              }
+              if (dst[i] != want_pixel) {
+                RETURN_FAIL("k=%d, depth=%" PRIu32 ", m=0x%02X, dst_len=%zu, "
+                            "src_len=%zu, i=%" PRIu32
+                            ": have 0x%02X, want 0x%02X",
+                            k, depth, m, dst_len, src_len, i, dst[i],
+                            want_pixel);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  return NULL;
+}
+
 const char*  //
 test_wuffs_png_decode_filters_golden() {
   CHECK_FOCUS(__func__);
@@ -446,6 +747,163 @@ test_wuffs_png_decode_filters_round_trip() {
   return NULL;
 }
 
+const char*  //
+test_wuffs_png_decode_animated() {
+  CHECK_FOCUS(__func__);
+  wuffs_png__decoder dec;
+  CHECK_STATUS("initialize",
+               wuffs_png__decoder__initialize(
+                   &dec, sizeof dec, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+
+  // animated-red-blue.apng was converted from animated-red-blue.nia, whose
+  // frames are the composited (BGRA_NONPREMUL) animation frames. Every APNG
+  // frame uses the "none" dispose_op and the "source" blend_op.
+  wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+      .data = g_src_slice_u8,
+  });
+  CHECK_STRING(read_file(&src, "test/data/animated-red-blue.apng"));
+  wuffs_base__io_buffer want = ((wuffs_base__io_buffer){
+      .data = g_want_slice_u8,
+  });
+  CHECK_STRING(read_file(&want, "test/data/animated-red-blue.nia"));
+  const size_t num_pixel_bytes = 64 * 48 * 4;
+  const size_t nia_frame_stride = 8 + 16 + num_pixel_bytes;
+  if (want.meta.wi < (16 + (4 * nia_frame_stride))) {
+    RETURN_FAIL("NIA file is too short");
+  }
+
+  wuffs_base__image_config ic = ((wuffs_base__image_config){});
+  CHECK_STATUS("decode_image_config",
+               wuffs_png__decoder__decode_image_config(&dec, &ic, &src));
+  if ((wuffs_base__pixel_config__width(&ic.pixcfg) != 64) ||
+      (wuffs_base__pixel_config__height(&ic.pixcfg) != 48)) {
+    RETURN_FAIL("image_config: bad dimensions");
+  }
+  uint32_t loops_have = wuffs_png__decoder__num_animation_loops(&dec);
+  if (loops_have != 3) {
+    RETURN_FAIL("num_animation_loops: have %" PRIu32 ", want 3", loops_have);
+  }
+
+  wuffs_base__pixel_config__set(
+      &ic.pixcfg, WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL,
+      WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, 64, 48);
+  wuffs_base__pixel_buffer pb = ((wuffs_base__pixel_buffer){});
+  CHECK_STATUS("set_from_slice", wuffs_base__pixel_buffer__set_from_slice(
+                                     &pb, &ic.pixcfg, g_pixel_slice_u8));
+  uint64_t workbuf_len = wuffs_png__decoder__workbuf_len(&dec).max_incl;
+  if (workbuf_len > g_work_slice_u8.len) {
+    RETURN_FAIL("workbuf_len: have %" PRIu64 ", want <= %zu", workbuf_len,
+                g_work_slice_u8.len);
+  }
+
+  const uint32_t rect_wants[4][4] = {
+      {0, 0, 64, 48},
+      {15, 31, 52, 40},
+      {15, 0, 64, 40},
+      {15, 0, 64, 40},
+  };
+  const uint64_t pos_wants[4] = {99, 1128, 1287, 2189};
+
+  int i;
+  for (i = 0; i < 4; i++) {
+    wuffs_base__frame_config fc = ((wuffs_base__frame_config){});
+    CHECK_STATUS("decode_frame_config",
+                 wuffs_png__decoder__decode_frame_config(&dec, &fc, &src));
+
+    wuffs_base__rect_ie_u32 r = wuffs_base__frame_config__bounds(&fc);
+    if ((r.min_incl_x != rect_wants[i][0]) ||
+        (r.min_incl_y != rect_wants[i][1]) ||
+        (r.max_excl_x != rect_wants[i][2]) ||
+        (r.max_excl_y != rect_wants[i][3])) {
+      RETURN_FAIL("bounds #%d: have (%" PRIu32 ", %" PRIu32 ")-(%" PRIu32
+                  ", %" PRIu32 ")",
+                  i, r.min_incl_x, r.min_incl_y, r.max_excl_x, r.max_excl_y);
+    }
+    uint64_t duration_have = wuffs_base__frame_config__duration(&fc);
+    uint64_t duration_want = (i + 1) * (WUFFS_BASE__FLICKS_PER_SECOND / 10);
+    if (duration_have != duration_want) {
+      RETURN_FAIL("duration #%d: have %" PRIu64 ", want %" PRIu64, i,
+                  duration_have, duration_want);
+    }
+    uint64_t pos_have = wuffs_base__frame_config__io_position(&fc);
+    if (pos_have != pos_wants[i]) {
+      RETURN_FAIL("io_position #%d: have %" PRIu64 ", want %" PRIu64, i,
+                  pos_have, pos_wants[i]);
+    }
+    if (!wuffs_base__frame_config__overwrite_instead_of_blend(&fc)) {
+      RETURN_FAIL("overwrite_instead_of_blend #%d: have false, want true", i);
+    }
+
+    CHECK_STATUS("decode_frame",
+                 wuffs_png__decoder__decode_frame(
+                     &dec, &pb, &src, WUFFS_BASE__PIXEL_BLEND__SRC,
+                     wuffs_base__make_slice_u8(g_work_slice_u8.ptr,
+                                               workbuf_len),
+                     NULL));
+    if (memcmp(g_pixel_slice_u8.ptr,
+               want.data.ptr + 16 + (i * nia_frame_stride) + 24,
+               num_pixel_bytes)) {
+      RETURN_FAIL("pixels #%d differ", i);
+    }
+  }
+
+  wuffs_base__status status =
+      wuffs_png__decoder__decode_frame_config(&dec, NULL, &src);
+  if (status.repr != wuffs_base__note__end_of_data) {
+    RETURN_FAIL("decode_frame_config EOD: have \"%s\", want \"%s\"",
+                status.repr, wuffs_base__note__end_of_data);
+  }
+
+  // Restarting from frame i, with the pixel buffer holding frame (i-1),
+  // should re-create frames i, i+1, etc.
+  for (i = 0; i < 4; i++) {
+    if (i > 0) {
+      memcpy(g_pixel_slice_u8.ptr,
+             want.data.ptr + 16 + ((i - 1) * nia_frame_stride) + 24,
+             num_pixel_bytes);
+    }
+    src.meta.ri = pos_wants[i];
+    status = wuffs_png__decoder__restart_frame(&dec, i, pos_wants[i]);
+    if (!wuffs_base__status__is_ok(&status)) {
+      RETURN_FAIL("restart_frame #%d: \"%s\"", i, status.repr);
+    }
+
+    int j;
+    for (j = i; j < 4; j++) {
+      wuffs_base__frame_config fc = ((wuffs_base__frame_config){});
+      status = wuffs_png__decoder__decode_frame_config(&dec, &fc, &src);
+      if (!wuffs_base__status__is_ok(&status)) {
+        RETURN_FAIL("decode_frame_config #%d, #%d: \"%s\"", i, j, status.repr);
+      }
+      uint64_t index_have = wuffs_base__frame_config__index(&fc);
+      if (index_have != (uint64_t)j) {
+        RETURN_FAIL("index #%d, #%d: have %" PRIu64 ", want %d", i, j,
+                    index_have, j);
+      }
+
+      status = wuffs_png__decoder__decode_frame(
+          &dec, &pb, &src, WUFFS_BASE__PIXEL_BLEND__SRC,
+          wuffs_base__make_slice_u8(g_work_slice_u8.ptr, workbuf_len), NULL);
+      if (!wuffs_base__status__is_ok(&status)) {
+        RETURN_FAIL("decode_frame #%d, #%d: \"%s\"", i, j, status.repr);
+      }
+      if (memcmp(g_pixel_slice_u8.ptr,
+                 want.data.ptr + 16 + (j * nia_frame_stride) + 24,
+                 num_pixel_bytes)) {
+        RETURN_FAIL("pixels #%d, #%d differ", i, j);
+      }
+    }
+
+    status = wuffs_png__decoder__decode_frame_config(&dec, NULL, &src);
+    if (status.repr != wuffs_base__note__end_of_data) {
+      RETURN_FAIL("decode_frame_config #%d: have \"%s\", want \"%s\"", i,
+                  status.repr, wuffs_base__note__end_of_data);
+    }
+  }
+  return NULL;
+}
+
 const char*  //
 test_wuffs_png_decode_frame_config() {
   CHECK_FOCUS(__func__);
@@ -472,6 +930,659 @@ test_wuffs_png_decode_frame_config() {
   return NULL;
 }
 
+const char*  //
+test_wuffs_png_decode_downscale() {
+  CHECK_FOCUS(__func__);
+
+  const char* filenames[] = {
+      "test/data/bricks-dither.png",
+      "test/data/bricks-gray.png",
+      "test/data/harvesters.png",
+      "test/data/hat.png",
+      "test/data/hibiscus.regular.png",
+      "test/data/hippopotamus.interlaced.png",
+      "test/data/hippopotamus.regular.png",
+      "test/data/pjw-thumbnail.png",
+  };
+
+  int i;
+  for (i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(filenames); i++) {
+    // Interlaced images are sampled (one pixel per block) from the earlier
+    // Adam7 passes instead of being averaged.
+    bool interlaced = strstr(filenames[i], ".interlaced.") != NULL;
+    uint32_t shift;
+    for (shift = 1; shift <= 3; shift++) {
+      wuffs_png__decoder full;
+      CHECK_STATUS("initialize",
+                   wuffs_png__decoder__initialize(
+                       &full, sizeof full, WUFFS_VERSION,
+                       WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+      wuffs_png__decoder downscale;
+      CHECK_STATUS("initialize",
+                   wuffs_png__decoder__initialize(
+                       &downscale, sizeof downscale, WUFFS_VERSION,
+                       WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+      const char* z = do_test__wuffs_base__image_decoder_downscale(
+          wuffs_png__decoder__upcast_as__wuffs_base__image_decoder(&full),
+          wuffs_png__decoder__upcast_as__wuffs_base__image_decoder(&downscale),
+          filenames[i], shift, interlaced, interlaced);
+      if (z) {
+        RETURN_FAIL("%s, shift %" PRIu32 ": %s", filenames[i], shift, z);
+      }
+    }
+  }
+  return NULL;
+}
+
+const char*  //
+test_wuffs_png_decode_metadata() {
+  CHECK_FOCUS(__func__);
+
+  wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+      .data = g_src_slice_u8,
+  });
+  CHECK_STRING(read_file(&src, "test/data/pjw-thumbnail.metadata.png"));
+
+  // Each metadata chunk is logged as its FourCC, an optional "/ZLIB" suffix
+  // (in which case the payload is logged after decompression), a '=', the
+  // payload and a ';'.
+  const char want[] =
+      "GAMA=\x00\x00\xB1\x8F;"
+      "ICCP/ZLIB=not really an ICC profile;"
+      "KVP =Title\x00PJW;"
+      "EXIF=MM\x00\x2A\x00\x00\x00\x08\x00\x00;"
+      "KVP =Author\x00Rob Pike;";
+  const size_t want_length = sizeof(want) - 1;
+
+  uint64_t want_io_position = 0;
+  int report;
+  for (report = 0; report < 3; report++) {
+    // The report variable's values mean:
+    //  - 0: report nothing.
+    //  - 1: report everything, consuming each payload.
+    //  - 2: report everything, leaving decode_image_config to skip each
+    //       payload.
+    wuffs_png__decoder dec;
+    CHECK_STATUS("initialize",
+                 wuffs_png__decoder__initialize(
+                     &dec, sizeof dec, WUFFS_VERSION,
+                     WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+    if (report) {
+      wuffs_png__decoder__set_report_metadata(&dec, WUFFS_BASE__FOURCC__EXIF,
+                                              true);
+      wuffs_png__decoder__set_report_metadata(&dec, WUFFS_BASE__FOURCC__GAMA,
+                                              true);
+      wuffs_png__decoder__set_report_metadata(&dec, WUFFS_BASE__FOURCC__ICCP,
+                                              true);
+      wuffs_png__decoder__set_report_metadata(&dec, WUFFS_BASE__FOURCC__KVP,
+                                              true);
+    }
+
+    char have[256];
+    size_t have_length = 0;
+    wuffs_base__image_config ic = ((wuffs_base__image_config){});
+    src.meta.ri = 0;
+
+    while (true) {
+      wuffs_base__status status =
+          wuffs_png__decoder__decode_image_config(&dec, &ic, &src);
+      if (wuffs_base__status__is_ok(&status)) {
+        break;
+      } else if (status.repr != wuffs_base__note__metadata_reported) {
+        RETURN_FAIL("decode_image_config (report=%d): have \"%s\", want \"%s\"",
+                    report, status.repr, wuffs_base__note__metadata_reported);
+      }
+
+      wuffs_base__io_buffer empty = wuffs_base__empty_io_buffer();
+      wuffs_base__more_information minfo =
+          wuffs_base__empty_more_information();
+      CHECK_STATUS("tell_me_more", wuffs_png__decoder__tell_me_more(
+                                       &dec, &empty, &minfo, &src));
+      if (minfo.flavor != WUFFS_BASE__MORE_INFORMATION__FLAVOR__METADATA) {
+        RETURN_FAIL("tell_me_more (report=%d): flavor: have %" PRIu32
+                    ", want %" PRIu32,
+                    report, minfo.flavor,
+                    WUFFS_BASE__MORE_INFORMATION__FLAVOR__METADATA);
+      }
+
+      uint32_t fourcc = wuffs_base__more_information__metadata__fourcc(&minfo);
+      wuffs_base__range_ie_u64 r =
+          wuffs_base__more_information__metadata__range(&minfo);
+      if ((r.min_incl < src.meta.pos) || (r.min_incl > r.max_excl) ||
+          (r.max_excl > (src.meta.pos + src.meta.wi))) {
+        RETURN_FAIL("tell_me_more (report=%d): bad range", report);
+      }
+      uint8_t* ptr = src.data.ptr + (r.min_incl - src.meta.pos);
+      size_t n = r.max_excl - r.min_incl;
+      if ((sizeof(have) - have_length) < (n + 11)) {
+        RETURN_FAIL("tell_me_more (report=%d): too much metadata", report);
+      }
+
+      have[have_length++] = (char)(fourcc >> 24);
+      have[have_length++] = (char)(fourcc >> 16);
+      have[have_length++] = (char)(fourcc >> 8);
+      have[have_length++] = (char)(fourcc >> 0);
+      if (minfo.x == WUFFS_BASE__FOURCC__ZLIB) {
+        memcpy(have + have_length, "/ZLIB=", 6);
+        have_length += 6;
+
+        wuffs_zlib__decoder zdec;
+        CHECK_STATUS(
+            "initialize",
+            wuffs_zlib__decoder__initialize(
+                &zdec, sizeof zdec, WUFFS_VERSION,
+                WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+        wuffs_base__io_buffer zsrc = wuffs_base__ptr_u8__reader(ptr, n, true);
+        wuffs_base__io_buffer zdst = wuffs_base__ptr_u8__writer(
+            (uint8_t*)(have + have_length), sizeof(have) - have_length - 1);
+        CHECK_STATUS("transform_io", wuffs_zlib__decoder__transform_io(
+                                         &zdec, &zdst, &zsrc, g_work_slice_u8));
+        have_length += zdst.meta.wi;
+      } else {
+        have[have_length++] = '=';
+        memcpy(have + have_length, ptr, n);
+        have_length += n;
+      }
+      have[have_length++] = ';';
+
+      if (report == 1) {
+        src.meta.ri = r.max_excl - src.meta.pos;
+      }
+    }
+
+    size_t expected_length = report ? want_length : 0;
+    if ((have_length != expected_length) ||
+        memcmp(have, want, expected_length)) {
+      RETURN_FAIL("report=%d: metadata log differs from expected", report);
+    }
+
+    uint64_t io_position =
+        wuffs_base__image_config__first_frame_io_position(&ic);
+    if (report == 0) {
+      want_io_position = io_position;
+    } else if (io_position != want_io_position) {
+      RETURN_FAIL("report=%d: first_frame_io_position: have %" PRIu64
+                  ", want %" PRIu64,
+                  report, io_position, want_io_position);
+    }
+    CHECK_STATUS("decode_frame_config",
+                 wuffs_png__decoder__decode_frame_config(&dec, NULL, &src));
+  }
+  return NULL;
+}
+
+const char*  //
+test_wuffs_png_decode_roi() {
+  CHECK_FOCUS(__func__);
+
+  const char* filenames[] = {
+      "test/data/bricks-dither.png",
+      "test/data/bricks-gray.png",
+      "test/data/hippopotamus.interlaced.png",
+      "test/data/hippopotamus.regular.png",
+      "test/data/pjw-thumbnail.png",
+  };
+  const wuffs_base__rect_ie_u32 rois[] = {
+      {.min_incl_x = 0, .min_incl_y = 0, .max_excl_x = 1, .max_excl_y = 1},
+      {.min_incl_x = 5, .min_incl_y = 3, .max_excl_x = 20, .max_excl_y = 17},
+      {.min_incl_x = 30,
+       .min_incl_y = 20,
+       .max_excl_x = 0xFFFFFFFF,
+       .max_excl_y = 0xFFFFFFFF},
+      {.min_incl_x = 7, .min_incl_y = 9, .max_excl_x = 7, .max_excl_y = 9},
+  };
+
+  int i;
+  for (i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(filenames); i++) {
+    int j;
+    for (j = 0; j < WUFFS_TESTLIB_ARRAY_SIZE(rois); j++) {
+      wuffs_png__decoder full;
+      CHECK_STATUS("initialize",
+                   wuffs_png__decoder__initialize(
+                       &full, sizeof full, WUFFS_VERSION,
+                       WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+      wuffs_png__decoder roi;
+      CHECK_STATUS("initialize",
+                   wuffs_png__decoder__initialize(
+                       &roi, sizeof roi, WUFFS_VERSION,
+                       WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+      size_t full_ri = 0;
+      size_t roi_ri = 0;
+      const char* z = do_test__wuffs_base__image_decoder_roi(
+          wuffs_png__decoder__upcast_as__wuffs_base__image_decoder(&full),
+          wuffs_png__decoder__upcast_as__wuffs_base__image_decoder(&roi),
+          filenames[i], rois[j], &full_ri, &roi_ri);
+      if (z) {
+        RETURN_FAIL("%s, roi #%d: %s", filenames[i], j, z);
+      }
+    }
+  }
+
+  // For a non-interlaced image, decoding should stop after the ROI's bottom
+  // row, long before the end of the (2 MB) file.
+  wuffs_png__decoder full;
+  CHECK_STATUS("initialize",
+               wuffs_png__decoder__initialize(
+                   &full, sizeof full, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  wuffs_png__decoder roi;
+  CHECK_STATUS("initialize",
+               wuffs_png__decoder__initialize(
+                   &roi, sizeof roi, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  size_t full_ri = 0;
+  size_t roi_ri = 0;
+  CHECK_STRING(do_test__wuffs_base__image_decoder_roi(
+      wuffs_png__decoder__upcast_as__wuffs_base__image_decoder(&full),
+      wuffs_png__decoder__upcast_as__wuffs_base__image_decoder(&roi),
+      "test/data/harvesters.png",
+      wuffs_base__make_rect_ie_u32(512, 128, 768, 384), &full_ri, &roi_ri));
+  if ((roi_ri * 2) > full_ri) {
+    RETURN_FAIL("roi_ri: have %zu, want <= %zu", roi_ri, full_ri / 2);
+  }
+  return NULL;
+}
+
+const char*  //
+test_wuffs_png_decode_streaming() {
+  CHECK_FOCUS(__func__);
+
+  const char* filenames[] = {
+      "test/data/bricks-dither.png",
+      "test/data/bricks-gray.png",
+      "test/data/harvesters.png",
+      "test/data/hat.png",
+      "test/data/hibiscus.primitive.png",
+      "test/data/hippopotamus.interlaced.png",
+      "test/data/hippopotamus.regular.png",
+      "test/data/pjw-thumbnail.png",
+  };
+
+  int i;
+  for (i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(filenames); i++) {
+    wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+        .data = g_src_slice_u8,
+    });
+    CHECK_STRING(read_file(&src, filenames[i]));
+
+    wuffs_base__io_buffer have = ((wuffs_base__io_buffer){
+        .data = g_have_slice_u8,
+    });
+    CHECK_STRING(wuffs_png_decode_streaming(
+        NULL, &have, WUFFS_INITIALIZE__DEFAULT_OPTIONS,
+        wuffs_base__make_pixel_format(WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL),
+        NULL, 0, &src));
+
+    src.meta.ri = 0;
+    wuffs_base__io_buffer want = ((wuffs_base__io_buffer){
+        .data = g_want_slice_u8,
+    });
+    CHECK_STRING(wuffs_png_decode(
+        NULL, &want, WUFFS_INITIALIZE__DEFAULT_OPTIONS,
+        wuffs_base__make_pixel_format(WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL),
+        NULL, 0, &src));
+
+    CHECK_STRING(check_io_buffers_equal(filenames[i], &have, &want));
+  }
+  return NULL;
+}
+
+const char*  //
+test_wuffs_png_decode_workbuf_len() {
+  CHECK_FOCUS(__func__);
+  wuffs_png__decoder dec;
+  CHECK_STATUS("initialize",
+               wuffs_png__decoder__initialize(
+                   &dec, sizeof dec, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+
+  wuffs_base__image_config ic = ((wuffs_base__image_config){});
+  wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+      .data = g_src_slice_u8,
+  });
+  CHECK_STRING(read_file(&src, "test/data/harvesters.png"));
+  CHECK_STATUS("decode_image_config",
+               wuffs_png__decoder__decode_image_config(&dec, &ic, &src));
+
+  // harvesters.png is 1165 × 859 RGB (3 bytes per pixel). Each filtered row
+  // is 1 + (1165 * 3) = 3496 bytes long. Streaming needs two rows' worth. Two
+  // full strips are two lots of 9 rows: the most that fit in 32 KiB.
+  // Downscaling needs another (12 * 1165) + 16 = 13996 bytes.
+  wuffs_base__range_ii_u64 have = wuffs_png__decoder__workbuf_len(&dec);
+  if (have.min_incl != 6992) {
+    RETURN_FAIL("min_incl: have %" PRIu64 ", want 6992", have.min_incl);
+  }
+  if (have.max_incl != 76924) {
+    RETURN_FAIL("max_incl: have %" PRIu64 ", want 76924", have.max_incl);
+  }
+  return NULL;
+}
+
+// wuffs_png_encode encodes src to dst as a PNG file. If num_strips is zero,
+// it makes a single encode_image call. Otherwise, it splits the image into
+// num_strips horizontal strips, each encoded by its own encoder's encode_strip
+// call, and writes the PNG framing itself, with one IDAT chunk per strip. The
+// strips could be encoded concurrently but here they are encoded in turn.
+const char*  //
+wuffs_png_encode(wuffs_base__io_buffer* dst,
+                 wuffs_base__pixel_buffer* src,
+                 uint32_t level,
+                 uint32_t num_strips) {
+  wuffs_png__encoder enc;
+  if (num_strips == 0) {
+    CHECK_STATUS("initialize",
+                 wuffs_png__encoder__initialize(
+                     &enc, sizeof enc, WUFFS_VERSION,
+                     WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+    wuffs_png__encoder__set_level(&enc, level);
+    CHECK_STATUS("prepare", wuffs_png__encoder__prepare(&enc, src));
+    CHECK_STATUS("encode_image", wuffs_png__encoder__encode_image(
+                                     &enc, dst, src, g_work_slice_u8));
+    return NULL;
+  }
+
+  uint32_t height = wuffs_base__pixel_config__height(&src->pixcfg);
+  if (num_strips > height) {
+    num_strips = height;
+  }
+  uint8_t* p = wuffs_base__io_buffer__writer_pointer(dst);
+  if (wuffs_base__io_buffer__writer_length(dst) < 33) {
+    return "dst is too short";
+  }
+
+  // The signature and the IHDR chunk.
+  wuffs_crc32__ieee_hasher crc32;
+  CHECK_STATUS("initialize", wuffs_crc32__ieee_hasher__initialize(
+                                 &crc32, sizeof crc32, WUFFS_VERSION,
+                                 WUFFS_INITIALIZE__DEFAULT_OPTIONS));
+  wuffs_base__pixel_format pixfmt =
+      wuffs_base__pixel_config__pixel_format(&src->pixcfg);
+  uint32_t bpp = wuffs_base__pixel_format__bits_per_pixel(&pixfmt);
+  uint64_t bytes_per_row =
+      (uint64_t)wuffs_base__pixel_config__width(&src->pixcfg) * (bpp / 8);
+  memcpy(p + 0x00, "\x89PNG\r\n\x1A\n\x00\x00\x00\x0DIHDR", 16);
+  wuffs_base__poke_u32be__no_bounds_check(
+      p + 0x10, wuffs_base__pixel_config__width(&src->pixcfg));
+  wuffs_base__poke_u32be__no_bounds_check(p + 0x14, height);
+  p[0x18] = 8;
+  p[0x19] = (bpp == 8) ? 0 : ((bpp == 24) ? 2 : 6);
+  p[0x1A] = 0;
+  p[0x1B] = 0;
+  p[0x1C] = 0;
+  wuffs_base__poke_u32be__no_bounds_check(
+      p + 0x1D, wuffs_crc32__ieee_hasher__update_u32(
+                    &crc32, wuffs_base__make_slice_u8(p + 0x0C, 0x11)));
+  dst->meta.wi += 0x21;
+
+  // The IDAT chunks.
+  wuffs_adler32__hasher adler32;
+  CHECK_STATUS("initialize", wuffs_adler32__hasher__initialize(
+                                 &adler32, sizeof adler32, WUFFS_VERSION,
+                                 WUFFS_INITIALIZE__DEFAULT_OPTIONS));
+  uint32_t checksum = 1;
+  uint32_t i;
+  for (i = 0; i < num_strips; i++) {
+    uint32_t y0 = (uint32_t)(((uint64_t)height * (i + 0)) / num_strips);
+    uint32_t y1 = (uint32_t)(((uint64_t)height * (i + 1)) / num_strips);
+    if (wuffs_base__io_buffer__writer_length(dst) < 16) {
+      return "dst is too short";
+    }
+    size_t chunk_wi = dst->meta.wi;
+    dst->meta.wi += 8;
+
+    CHECK_STATUS("initialize",
+                 wuffs_png__encoder__initialize(
+                     &enc, sizeof enc, WUFFS_VERSION,
+                     WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+    wuffs_png__encoder__set_level(&enc, level);
+    CHECK_STATUS("prepare", wuffs_png__encoder__prepare(&enc, src));
+    CHECK_STATUS("encode_strip", wuffs_png__encoder__encode_strip(
+                                     &enc, dst, src, y0, y1, g_work_slice_u8));
+    checksum = wuffs_adler32__hasher__combine_u32(
+        &adler32, checksum, wuffs_png__encoder__strip_adler32(&enc),
+        (y1 - y0) * (1 + bytes_per_row));
+
+    if (wuffs_base__io_buffer__writer_length(dst) < 16) {
+      return "dst is too short";
+    }
+    if ((i + 1) == num_strips) {
+      wuffs_base__poke_u32be__no_bounds_check(
+          wuffs_base__io_buffer__writer_pointer(dst), checksum);
+      dst->meta.wi += 4;
+    }
+    p = dst->data.ptr + chunk_wi;
+    size_t n = dst->meta.wi - chunk_wi - 8;
+    wuffs_base__poke_u32be__no_bounds_check(p + 0, (uint32_t)n);
+    memcpy(p + 4, "IDAT", 4);
+    CHECK_STATUS("initialize", wuffs_crc32__ieee_hasher__initialize(
+                                   &crc32, sizeof crc32, WUFFS_VERSION,
+                                   WUFFS_INITIALIZE__DEFAULT_OPTIONS));
+    wuffs_base__poke_u32be__no_bounds_check(
+        p + 8 + n, wuffs_crc32__ieee_hasher__update_u32(
+                       &crc32, wuffs_base__make_slice_u8(p + 4, 4 + n)));
+    dst->meta.wi += 4;
+  }
+
+  // The IEND chunk.
+  if (wuffs_base__io_buffer__writer_length(dst) < 12) {
+    return "dst is too short";
+  }
+  memcpy(wuffs_base__io_buffer__writer_pointer(dst),
+         "\x00\x00\x00\x00IEND\xAE\x42\x60\x82", 12);
+  dst->meta.wi += 12;
+  return NULL;
+}
+
+const char*  //
+test_wuffs_png_decode_wide_rows() {
+  CHECK_FOCUS(__func__);
+
+  // Each filtered row (1 + 32769 or 1 + 32768 bytes) is longer than the
+  // decoder's 32 KiB strips, so each strip holds a single row.
+  const struct {
+    uint32_t pixfmt_repr;
+    uint32_t bytes_per_pixel;
+    uint32_t width;
+  } tests[] = {
+      {WUFFS_BASE__PIXEL_FORMAT__RGB, 3, 10923},
+      {WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL, 4, 8192},
+  };
+  const uint32_t height = 3;
+
+  int i;
+  for (i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(tests); i++) {
+    uint64_t bytes_per_row = (uint64_t)(tests[i].width) *
+                             (uint64_t)(tests[i].bytes_per_pixel);
+    uint64_t row_length = 1 + bytes_per_row;
+    size_t n = (size_t)(bytes_per_row * height);
+    size_t j;
+    for (j = 0; j < n; j++) {
+      g_want_slice_u8.ptr[j] = (uint8_t)((j * 7) ^ (j >> 9));
+    }
+
+    wuffs_base__pixel_config pixcfg = ((wuffs_base__pixel_config){});
+    wuffs_base__pixel_config__set(&pixcfg, tests[i].pixfmt_repr,
+                                  WUFFS_BASE__PIXEL_SUBSAMPLING__NONE,
+                                  tests[i].width, height);
+    wuffs_base__pixel_buffer want_pb = ((wuffs_base__pixel_buffer){});
+    CHECK_STATUS("set_from_slice",
+                 wuffs_base__pixel_buffer__set_from_slice(
+                     &want_pb, &pixcfg,
+                     wuffs_base__make_slice_u8(g_want_slice_u8.ptr, n)));
+    wuffs_base__io_buffer encoded = ((wuffs_base__io_buffer){
+        .data = g_src_slice_u8,
+    });
+    CHECK_STRING(wuffs_png_encode(&encoded, &want_pb, 6, 0));
+    encoded.meta.closed = true;
+
+    int tc;
+    for (tc = 0; tc < 4; tc++) {
+      wuffs_png__decoder dec;
+      CHECK_STATUS("initialize",
+                   wuffs_png__decoder__initialize(
+                       &dec, sizeof dec, WUFFS_VERSION,
+                       WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+      encoded.meta.ri = 0;
+      wuffs_base__image_config ic = ((wuffs_base__image_config){});
+      CHECK_STATUS("decode_image_config",
+                   wuffs_png__decoder__decode_image_config(&dec, &ic,
+                                                           &encoded));
+      // The max_incl also covers downscaling: (12 * width) + 16 bytes.
+      wuffs_base__range_ii_u64 r = wuffs_png__decoder__workbuf_len(&dec);
+      uint64_t want_max_incl = (2 * row_length) + (12 * tests[i].width) + 16;
+      if ((r.min_incl != (2 * row_length)) || (r.max_incl != want_max_incl)) {
+        RETURN_FAIL("i=%d: workbuf_len: have [%" PRIu64 ", %" PRIu64
+                    "], want [%" PRIu64 ", %" PRIu64 "]",
+                    i, r.min_incl, r.max_incl, 2 * row_length, want_max_incl);
+      }
+
+      // Try the min_incl and max_incl workbuf lengths, a longer one and a
+      // too-short one.
+      uint64_t workbuf_len = (tc == 0)   ? r.min_incl
+                             : (tc == 1) ? r.max_incl
+                             : (tc == 2) ? (r.max_incl + 12345)
+                                         : (r.min_incl - 1);
+
+      wuffs_base__pixel_buffer have_pb = ((wuffs_base__pixel_buffer){});
+      CHECK_STATUS("set_from_slice",
+                   wuffs_base__pixel_buffer__set_from_slice(
+                       &have_pb, &pixcfg,
+                       wuffs_base__make_slice_u8(g_have_slice_u8.ptr, n)));
+      wuffs_base__status status = wuffs_png__decoder__decode_frame(
+          &dec, &have_pb, &encoded, WUFFS_BASE__PIXEL_BLEND__SRC,
+          wuffs_base__make_slice_u8(g_work_slice_u8.ptr, workbuf_len), NULL);
+      if (tc == 3) {
+        if (status.repr != wuffs_base__error__bad_workbuf_length) {
+          RETURN_FAIL("i=%d, tc=%d: decode_frame: have \"%s\", want \"%s\"",
+                      i, tc, status.repr,
+                      wuffs_base__error__bad_workbuf_length);
+        }
+        continue;
+      } else if (status.repr) {
+        RETURN_FAIL("i=%d, tc=%d: decode_frame: \"%s\"", i, tc, status.repr);
+      } else if (memcmp(g_have_slice_u8.ptr, g_want_slice_u8.ptr, n)) {
+        RETURN_FAIL("i=%d, tc=%d: pixels differ", i, tc);
+      }
+    }
+  }
+  return NULL;
+}
+
+// do_test_wuffs_png_encode_round_trip decodes filename to pixfmt, encodes that
+// and decodes the encoding, checking that the pixels match.
+const char*  //
+do_test_wuffs_png_encode_round_trip(const char* filename,
+                                    uint32_t pixfmt_repr,
+                                    uint32_t level,
+                                    uint32_t num_strips) {
+  wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+      .data = g_src_slice_u8,
+  });
+  CHECK_STRING(read_file(&src, filename));
+
+  wuffs_png__decoder dec;
+  CHECK_STATUS("initialize",
+               wuffs_png__decoder__initialize(
+                   &dec, sizeof dec, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  wuffs_base__image_config ic = ((wuffs_base__image_config){});
+  CHECK_STATUS("decode_image_config",
+               wuffs_png__decoder__decode_image_config(&dec, &ic, &src));
+  src.meta.ri = 0;
+  wuffs_base__pixel_format pixfmt = wuffs_base__make_pixel_format(pixfmt_repr);
+  wuffs_base__io_buffer want = ((wuffs_base__io_buffer){
+      .data = g_want_slice_u8,
+  });
+  CHECK_STRING(wuffs_png_decode(NULL, &want, WUFFS_INITIALIZE__DEFAULT_OPTIONS,
+                                pixfmt, NULL, 0, &src));
+
+  wuffs_base__pixel_config__set(&ic.pixcfg, pixfmt_repr,
+                                WUFFS_BASE__PIXEL_SUBSAMPLING__NONE,
+                                wuffs_base__pixel_config__width(&ic.pixcfg),
+                                wuffs_base__pixel_config__height(&ic.pixcfg));
+  wuffs_base__pixel_buffer pb = ((wuffs_base__pixel_buffer){});
+  CHECK_STATUS("set_from_slice",
+               wuffs_base__pixel_buffer__set_from_slice(
+                   &pb, &ic.pixcfg,
+                   wuffs_base__make_slice_u8(want.data.ptr, want.meta.wi)));
+
+  wuffs_base__io_buffer encoded = ((wuffs_base__io_buffer){
+      .data = g_have_slice_u8,
+  });
+  CHECK_STRING(wuffs_png_encode(&encoded, &pb, level, num_strips));
+  encoded.meta.closed = true;
+
+  wuffs_base__io_buffer have = ((wuffs_base__io_buffer){
+      .data = g_src_slice_u8,
+  });
+  CHECK_STRING(wuffs_png_decode(NULL, &have, WUFFS_INITIALIZE__DEFAULT_OPTIONS,
+                                pixfmt, NULL, 0, &encoded));
+  return check_io_buffers_equal("", &have, &want);
+}
+
+const char*  //
+test_wuffs_png_encode_round_trip() {
+  CHECK_FOCUS(__func__);
+
+  const struct {
+    const char* filename;
+    uint32_t pixfmt_repr;
+  } tests[] = {
+      {"test/data/bricks-gray.png", WUFFS_BASE__PIXEL_FORMAT__Y},
+      {"test/data/bricks-dither.png", WUFFS_BASE__PIXEL_FORMAT__BGR},
+      {"test/data/hat.png", WUFFS_BASE__PIXEL_FORMAT__RGB},
+      {"test/data/hibiscus.primitive.png",
+       WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL},
+      {"test/data/hibiscus.primitive.png",
+       WUFFS_BASE__PIXEL_FORMAT__RGBA_NONPREMUL},
+      {"test/data/hippopotamus.regular.png", WUFFS_BASE__PIXEL_FORMAT__BGR},
+      {"test/data/pjw-thumbnail.png", WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL},
+  };
+  const uint32_t levels[] = {0, 1, 6, 9};
+
+  int i;
+  for (i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(tests); i++) {
+    int j;
+    for (j = 0; j < WUFFS_TESTLIB_ARRAY_SIZE(levels); j++) {
+      const char* z = do_test_wuffs_png_encode_round_trip(
+          tests[i].filename, tests[i].pixfmt_repr, levels[j], 0);
+      if (z) {
+        RETURN_FAIL("%s, level %" PRIu32 ": %s", tests[i].filename,
+                    levels[j], z);
+      }
+    }
+  }
+  return NULL;
+}
+
+const char*  //
+test_wuffs_png_encode_strips() {
+  CHECK_FOCUS(__func__);
+
+  const char* filenames[] = {
+      "test/data/bricks-gray.png",
+      "test/data/harvesters.png",
+      "test/data/hibiscus.primitive.png",
+  };
+  const uint32_t nums_strips[] = {1, 2, 7, 1000};
+
+  int i;
+  for (i = 0; i < WUFFS_TESTLIB_ARRAY_SIZE(filenames); i++) {
+    uint32_t pixfmt_repr = (i == 0) ? WUFFS_BASE__PIXEL_FORMAT__Y
+                                    : WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL;
+    int j;
+    for (j = 0; j < WUFFS_TESTLIB_ARRAY_SIZE(nums_strips); j++) {
+      const char* z = do_test_wuffs_png_encode_round_trip(
+          filenames[i], pixfmt_repr, 6, nums_strips[j]);
+      if (z) {
+        RETURN_FAIL("%s, %" PRIu32 " strips: %s", filenames[i],
+                    nums_strips[j], z);
+      }
+    }
+  }
+  return NULL;
+}
+
 // ---------------- Mimic Tests
 
 #ifdef WUFFS_MIMIC
@@ -620,6 +1731,26 @@ bench_wuffs_png_decode_image_4002k_24bpp() {
       NULL, 0, "test/data/harvesters.png", 0, SIZE_MAX, 1);
 }
 
+const char*  //
+bench_wuffs_png_decode_image_552k_32bpp_streaming() {
+  CHECK_FOCUS(__func__);
+  return do_bench_image_decode(
+      &wuffs_png_decode_streaming,
+      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED,
+      wuffs_base__make_pixel_format(WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL),
+      NULL, 0, "test/data/hibiscus.primitive.png", 0, SIZE_MAX, 4);
+}
+
+const char*  //
+bench_wuffs_png_decode_image_4002k_24bpp_streaming() {
+  CHECK_FOCUS(__func__);
+  return do_bench_image_decode(
+      &wuffs_png_decode_streaming,
+      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED,
+      wuffs_base__make_pixel_format(WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL),
+      NULL, 0, "test/data/harvesters.png", 0, SIZE_MAX, 1);
+}
+
 const char*  //
 do_bench_wuffs_png_decode_filter(uint8_t filter,
                                  uint8_t filter_distance,
@@ -653,6 +1784,10 @@ do_bench_wuffs_png_decode_filter(uint8_t filter,
                                  WUFFS_INITIALIZE__DEFAULT_OPTIONS));
   dec.private_impl.f_width = width;
   dec.private_impl.f_height = height;
+  dec.private_impl.f_frame_rect_x1 = width;
+  dec.private_impl.f_frame_rect_y1 = height;
+  dec.private_impl.f_roi_x1 = 0xFFFFFFFF;
+  dec.private_impl.f_roi_y1 = 0xFFFFFFFF;
   dec.private_impl.f_pass_bytes_per_row = bytes_per_row;
   dec.private_impl.f_filter_distance = filter_distance;
   wuffs_png__decoder__choose_filter_implementations(&dec);
@@ -679,16 +1814,32 @@ do_bench_wuffs_png_decode_filter(uint8_t filter,
   uint64_t i;
   uint64_t iters = iters_unscaled * g_flags.iterscale;
   for (i = 0; i < iters; i++) {
+    // Each filter_and_swizzle call advances dst_y. Start again at the top.
+    dec.private_impl.f_dst_y = 0;
     CHECK_STATUS(
         "filter_and_swizzle",
         wuffs_png__decoder__filter_and_swizzle(
-            &dec, &pb, wuffs_base__make_slice_u8(workbuf.data.ptr, n)));
+            &dec, &pb, wuffs_base__empty_slice_u8(),
+            wuffs_base__make_slice_u8(workbuf.data.ptr, n),
+            wuffs_base__empty_slice_u8()));
     n_bytes += n;
   }
   bench_finish(iters, n_bytes);
   return NULL;
 }
 
+const char*  //
+bench_wuffs_png_decode_filt_1_dist_1() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_decode_filter(1, 1, 200);
+}
+
+const char*  //
+bench_wuffs_png_decode_filt_1_dist_2() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_decode_filter(1, 2, 200);
+}
+
 const char*  //
 bench_wuffs_png_decode_filt_1_dist_3() {
   CHECK_FOCUS(__func__);
@@ -701,6 +1852,30 @@ bench_wuffs_png_decode_filt_1_dist_4() {
   return do_bench_wuffs_png_decode_filter(1, 4, 200);
 }
 
+const char*  //
+bench_wuffs_png_decode_filt_1_dist_6() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_decode_filter(1, 6, 200);
+}
+
+const char*  //
+bench_wuffs_png_decode_filt_1_dist_8() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_decode_filter(1, 8, 200);
+}
+
+const char*  //
+bench_wuffs_png_decode_filt_2_dist_1() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_decode_filter(2, 1, 1000);
+}
+
+const char*  //
+bench_wuffs_png_decode_filt_2_dist_2() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_decode_filter(2, 2, 1000);
+}
+
 const char*  //
 bench_wuffs_png_decode_filt_2_dist_3() {
   CHECK_FOCUS(__func__);
@@ -713,6 +1888,30 @@ bench_wuffs_png_decode_filt_2_dist_4() {
   return do_bench_wuffs_png_decode_filter(2, 4, 1000);
 }
 
+const char*  //
+bench_wuffs_png_decode_filt_2_dist_6() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_decode_filter(2, 6, 1000);
+}
+
+const char*  //
+bench_wuffs_png_decode_filt_2_dist_8() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_decode_filter(2, 8, 1000);
+}
+
+const char*  //
+bench_wuffs_png_decode_filt_3_dist_1() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_decode_filter(3, 1, 100);
+}
+
+const char*  //
+bench_wuffs_png_decode_filt_3_dist_2() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_decode_filter(3, 2, 100);
+}
+
 const char*  //
 bench_wuffs_png_decode_filt_3_dist_3() {
   CHECK_FOCUS(__func__);
@@ -725,6 +1924,30 @@ bench_wuffs_png_decode_filt_3_dist_4() {
   return do_bench_wuffs_png_decode_filter(3, 4, 100);
 }
 
+const char*  //
+bench_wuffs_png_decode_filt_3_dist_6() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_decode_filter(3, 6, 100);
+}
+
+const char*  //
+bench_wuffs_png_decode_filt_3_dist_8() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_decode_filter(3, 8, 100);
+}
+
+const char*  //
+bench_wuffs_png_decode_filt_4_dist_1() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_decode_filter(4, 1, 20);
+}
+
+const char*  //
+bench_wuffs_png_decode_filt_4_dist_2() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_decode_filter(4, 2, 20);
+}
+
 const char*  //
 bench_wuffs_png_decode_filt_4_dist_3() {
   CHECK_FOCUS(__func__);
@@ -737,6 +1960,112 @@ bench_wuffs_png_decode_filt_4_dist_4() {
   return do_bench_wuffs_png_decode_filter(4, 4, 20);
 }
 
+const char*  //
+bench_wuffs_png_decode_filt_4_dist_6() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_decode_filter(4, 6, 20);
+}
+
+const char*  //
+bench_wuffs_png_decode_filt_4_dist_8() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_decode_filter(4, 8, 20);
+}
+
+// --------
+
+const char*  //
+do_bench_wuffs_png_encode(const char* filename,
+                          uint32_t pixfmt_repr,
+                          uint32_t level,
+                          uint32_t num_strips,
+                          uint64_t iters_unscaled) {
+  wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+      .data = g_src_slice_u8,
+  });
+  CHECK_STRING(read_file(&src, filename));
+
+  wuffs_png__decoder dec;
+  CHECK_STATUS("initialize",
+               wuffs_png__decoder__initialize(
+                   &dec, sizeof dec, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  wuffs_base__image_config ic = ((wuffs_base__image_config){});
+  CHECK_STATUS("decode_image_config",
+               wuffs_png__decoder__decode_image_config(&dec, &ic, &src));
+  src.meta.ri = 0;
+  wuffs_base__io_buffer pixels = ((wuffs_base__io_buffer){
+      .data = g_want_slice_u8,
+  });
+  CHECK_STRING(wuffs_png_decode(NULL, &pixels,
+                                WUFFS_INITIALIZE__DEFAULT_OPTIONS,
+                                wuffs_base__make_pixel_format(pixfmt_repr),
+                                NULL, 0, &src));
+
+  wuffs_base__pixel_config__set(&ic.pixcfg, pixfmt_repr,
+                                WUFFS_BASE__PIXEL_SUBSAMPLING__NONE,
+                                wuffs_base__pixel_config__width(&ic.pixcfg),
+                                wuffs_base__pixel_config__height(&ic.pixcfg));
+  wuffs_base__pixel_buffer pb = ((wuffs_base__pixel_buffer){});
+  CHECK_STATUS("set_from_slice",
+               wuffs_base__pixel_buffer__set_from_slice(
+                   &pb, &ic.pixcfg,
+                   wuffs_base__make_slice_u8(pixels.data.ptr, pixels.meta.wi)));
+
+  bench_start();
+  uint64_t n_bytes = 0;
+  uint64_t i;
+  uint64_t iters = iters_unscaled * g_flags.iterscale;
+  for (i = 0; i < iters; i++) {
+    wuffs_base__io_buffer dst = ((wuffs_base__io_buffer){
+        .data = g_have_slice_u8,
+    });
+    CHECK_STRING(wuffs_png_encode(&dst, &pb, level, num_strips));
+    n_bytes += pixels.meta.wi;
+  }
+  bench_finish(iters, n_bytes);
+  return NULL;
+}
+
+const char*  //
+bench_wuffs_png_encode_image_19k_8bpp() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_encode("test/data/bricks-gray.png",
+                                   WUFFS_BASE__PIXEL_FORMAT__Y, 6, 0, 10);
+}
+
+const char*  //
+bench_wuffs_png_encode_image_552k_32bpp() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_encode("test/data/hibiscus.primitive.png",
+                                   WUFFS_BASE__PIXEL_FORMAT__BGRA_NONPREMUL, 6,
+                                   0, 4);
+}
+
+const char*  //
+bench_wuffs_png_encode_image_4002k_24bpp() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_encode("test/data/harvesters.png",
+                                   WUFFS_BASE__PIXEL_FORMAT__RGB, 6, 0, 1);
+}
+
+const char*  //
+bench_wuffs_png_encode_image_4002k_24bpp_level_1() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_encode("test/data/harvesters.png",
+                                   WUFFS_BASE__PIXEL_FORMAT__RGB, 1, 0, 1);
+}
+
+// The strips are encoded in turn, not concurrently, so this measures the
+// overhead (in time) of splitting an image into strips. The time taken with
+// concurrent strips is roughly this divided by the number of threads.
+const char*  //
+bench_wuffs_png_encode_image_4002k_24bpp_8_strips() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_png_encode("test/data/harvesters.png",
+                                   WUFFS_BASE__PIXEL_FORMAT__RGB, 6, 8, 1);
+}
+
 // ---------------- Mimic Benches
 
 #ifdef WUFFS_MIMIC
@@ -806,11 +2135,23 @@ bench_mimic_png_decode_image_4002k_24bpp() {
 
 proc g_tests[] = {
 
+    test_wuffs_png_decode_animated,
     test_wuffs_png_decode_bad_crc32_checksum_critical,
+    test_wuffs_png_decode_downscale,
     test_wuffs_png_decode_filters_golden,
     test_wuffs_png_decode_filters_round_trip,
     test_wuffs_png_decode_frame_config,
     test_wuffs_png_decode_interface,
+    test_wuffs_png_decode_low_bit_depth,
+    test_wuffs_png_decode_metadata,
+    test_wuffs_png_decode_roi,
+    test_wuffs_png_decode_src_pixfmt,
+    test_wuffs_png_decode_streaming,
+    test_wuffs_png_decode_unpack_bits_simd,
+    test_wuffs_png_decode_wide_rows,
+    test_wuffs_png_decode_workbuf_len,
+    test_wuffs_png_encode_round_trip,
+    test_wuffs_png_encode_strips,
 
 #ifdef WUFFS_MIMIC
 
@@ -831,20 +2172,43 @@ proc g_tests[] = {
 
 proc g_benches[] = {
 
+    bench_wuffs_png_decode_filt_1_dist_1,
+    bench_wuffs_png_decode_filt_1_dist_2,
     bench_wuffs_png_decode_filt_1_dist_3,
     bench_wuffs_png_decode_filt_1_dist_4,
+    bench_wuffs_png_decode_filt_1_dist_6,
+    bench_wuffs_png_decode_filt_1_dist_8,
+    bench_wuffs_png_decode_filt_2_dist_1,
+    bench_wuffs_png_decode_filt_2_dist_2,
     bench_wuffs_png_decode_filt_2_dist_3,
     bench_wuffs_png_decode_filt_2_dist_4,
+    bench_wuffs_png_decode_filt_2_dist_6,
+    bench_wuffs_png_decode_filt_2_dist_8,
+    bench_wuffs_png_decode_filt_3_dist_1,
+    bench_wuffs_png_decode_filt_3_dist_2,
     bench_wuffs_png_decode_filt_3_dist_3,
     bench_wuffs_png_decode_filt_3_dist_4,
+    bench_wuffs_png_decode_filt_3_dist_6,
+    bench_wuffs_png_decode_filt_3_dist_8,
+    bench_wuffs_png_decode_filt_4_dist_1,
+    bench_wuffs_png_decode_filt_4_dist_2,
     bench_wuffs_png_decode_filt_4_dist_3,
     bench_wuffs_png_decode_filt_4_dist_4,
+    bench_wuffs_png_decode_filt_4_dist_6,
+    bench_wuffs_png_decode_filt_4_dist_8,
     bench_wuffs_png_decode_image_19k_8bpp,
     bench_wuffs_png_decode_image_40k_24bpp,
     bench_wuffs_png_decode_image_77k_8bpp,
     bench_wuffs_png_decode_image_552k_32bpp_ignore_checksum,
+    bench_wuffs_png_decode_image_552k_32bpp_streaming,
     bench_wuffs_png_decode_image_552k_32bpp_verify_checksum,
     bench_wuffs_png_decode_image_4002k_24bpp,
+    bench_wuffs_png_decode_image_4002k_24bpp_streaming,
+    bench_wuffs_png_encode_image_19k_8bpp,
+    bench_wuffs_png_encode_image_552k_32bpp,
+    bench_wuffs_png_encode_image_4002k_24bpp,
+    bench_wuffs_png_encode_image_4002k_24bpp_level_1,
+    bench_wuffs_png_encode_image_4002k_24bpp_8_strips,
 
 #ifdef WUFFS_MIMIC
 
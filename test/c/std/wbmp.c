@@ -213,6 +213,203 @@ test_wuffs_pixel_buffer_fill_rect() {
   return NULL;
 }
 
+// fill_u32le_func is the signature of the scalar and SIMD kernels behind
+// wuffs_base__pixel_buffer__set_color_u32_fill_rect's 4-bytes-per-pixel case.
+typedef void (*fill_u32le_func)(uint8_t* ptr, size_t n, uint32_t color);
+
+const char*  //
+test_wuffs_pixel_buffer_fill_rect_simd() {
+  CHECK_FOCUS(__func__);
+
+  const struct {
+    fill_u32le_func func;
+    bool available;
+  } kernels[] = {
+      {wuffs_base__pixel_buffer__fill_u32le, true},
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      {wuffs_base__pixel_buffer__fill_u32le__sse42,
+       wuffs_base__cpu_arch__have_x86_sse42()},
+      {wuffs_base__pixel_buffer__fill_u32le__avx2,
+       wuffs_base__cpu_arch__have_x86_avx2()},
+#endif
+  };
+
+  const uint32_t color = 0x88123456;
+  const size_t max_n = 200;
+  if (g_have_slice_u8.len < (4 * (max_n + 8))) {
+    RETURN_FAIL("g_have_slice_u8 is too short");
+  }
+
+  // Every length up to and past several SIMD registers' worth, at every
+  // alignment, fills exactly n pixels.
+  int k;
+  for (k = 0; k < WUFFS_TESTLIB_ARRAY_SIZE(kernels); k++) {
+    if (!kernels[k].available) {
+      continue;
+    }
+    size_t offset;
+    for (offset = 0; offset < 4; offset++) {
+      size_t n;
+      for (n = 0; n <= max_n; n++) {
+        memset(g_have_slice_u8.ptr, 0xEE, 4 * (max_n + 8));
+        (*kernels[k].func)(g_have_slice_u8.ptr + (4 * offset), n, color);
+        size_t i;
+        for (i = 0; i < (max_n + 8); i++) {
+          uint32_t want = ((offset <= i) && (i < (offset + n)))
+                              ? color
+                              : 0xEEEEEEEE;
+          uint32_t have = wuffs_base__peek_u32le__no_bounds_check(
+              g_have_slice_u8.ptr + (4 * i));
+          if (have != want) {
+            RETURN_FAIL("k=%d, offset=%zu, n=%zu, i=%zu: have 0x%08" PRIX32
+                        ", want 0x%08" PRIX32,
+                        k, offset, n, i, have, want);
+          }
+        }
+      }
+    }
+  }
+
+  // Fills of 64 or more pixels take the SIMD path, both for whole rows (one
+  // contiguous run) and for sub-rectangles (one run per row).
+  const uint32_t width = 40;
+  const uint32_t height = 30;
+  wuffs_base__pixel_config pixcfg = ((wuffs_base__pixel_config){});
+  wuffs_base__pixel_config__set(&pixcfg, WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL,
+                                WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, width,
+                                height);
+  wuffs_base__pixel_buffer pixbuf = ((wuffs_base__pixel_buffer){});
+  CHECK_STATUS("set_from_slice", wuffs_base__pixel_buffer__set_from_slice(
+                                     &pixbuf, &pixcfg, g_have_slice_u8));
+  const wuffs_base__rect_ie_u32 rects[] = {
+      wuffs_base__make_rect_ie_u32(0, 3, width, 9),
+      wuffs_base__make_rect_ie_u32(5, 2, 35, 27),
+  };
+  int r;
+  for (r = 0; r < WUFFS_TESTLIB_ARRAY_SIZE(rects); r++) {
+    memset(g_have_slice_u8.ptr, 0, 4 * width * height);
+    CHECK_STATUS("set_color_u32_fill_rect",
+                 wuffs_base__pixel_buffer__set_color_u32_fill_rect(
+                     &pixbuf, rects[r], color));
+    uint32_t y;
+    for (y = 0; y < height; y++) {
+      uint32_t x;
+      for (x = 0; x < width; x++) {
+        uint32_t want =
+            wuffs_base__rect_ie_u32__contains(&rects[r], x, y) ? color : 0;
+        uint32_t have = wuffs_base__pixel_buffer__color_u32_at(&pixbuf, x, y);
+        if (have != want) {
+          RETURN_FAIL("r=%d, x=%" PRIu32 ", y=%" PRIu32 ": have 0x%08" PRIX32
+                      ", want 0x%08" PRIX32,
+                      r, x, y, have, want);
+        }
+      }
+    }
+  }
+  return NULL;
+}
+
+const char*  //
+test_wuffs_pixel_buffer_composite() {
+  CHECK_FOCUS(__func__);
+
+  const uint32_t dst_width = 40;
+  const uint32_t dst_height = 30;
+  const uint32_t src_width = 20;
+  const uint32_t src_height = 10;
+  const uint32_t dst_x = 25;
+  const uint32_t dst_y = 5;
+  const wuffs_base__rect_ie_u32 clip =
+      wuffs_base__make_rect_ie_u32(0, 0, dst_width, 12);
+
+  wuffs_base__pixel_config dst_pixcfg = ((wuffs_base__pixel_config){});
+  wuffs_base__pixel_config__set(
+      &dst_pixcfg, WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL,
+      WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, dst_width, dst_height);
+  wuffs_base__pixel_buffer dst_pixbuf = ((wuffs_base__pixel_buffer){});
+  CHECK_STATUS("set_from_slice",
+               wuffs_base__pixel_buffer__set_from_slice(
+                   &dst_pixbuf, &dst_pixcfg, g_have_slice_u8));
+
+  wuffs_base__pixel_config src_pixcfg = ((wuffs_base__pixel_config){});
+  wuffs_base__pixel_config__set(
+      &src_pixcfg, WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL,
+      WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, src_width, src_height);
+  wuffs_base__pixel_buffer src_pixbuf = ((wuffs_base__pixel_buffer){});
+  CHECK_STATUS("set_from_slice",
+               wuffs_base__pixel_buffer__set_from_slice(
+                   &src_pixbuf, &src_pixcfg, g_src_slice_u8));
+
+  const wuffs_base__pixel_blend blends[] = {
+      WUFFS_BASE__PIXEL_BLEND__SRC,
+      WUFFS_BASE__PIXEL_BLEND__SRC_OVER,
+  };
+
+  int b;
+  for (b = 0; b < WUFFS_TESTLIB_ARRAY_SIZE(blends); b++) {
+    // Fill both pixel buffers with pseudo-random premultiplied colors. Each
+    // color channel value is no more than the alpha value.
+    uint32_t rng = 0x12345678;
+    uint32_t y;
+    for (y = 0; y < dst_height; y++) {
+      uint32_t x;
+      for (x = 0; x < dst_width; x++) {
+        rng = (rng * 1664525) + 1013904223;
+        uint32_t a = rng >> 24;
+        uint32_t c = (a * (0xFFFFFF & rng)) / 0xFFFFFF;
+        CHECK_STATUS("set_color_u32_at",
+                     wuffs_base__pixel_buffer__set_color_u32_at(
+                         &dst_pixbuf, x, y,
+                         (a << 24) | (c << 16) | ((c / 2) << 8) | (c / 3)));
+        if ((x < src_width) && (y < src_height)) {
+          wuffs_base__pixel_buffer__set_color_u32_at(
+              &src_pixbuf, x, y,
+              (a << 24) | ((a - c) << 16) | (c << 8) | ((a / 2) + (c / 2)));
+        }
+      }
+    }
+
+    // Take a copy of the dst pixels before compositing.
+    const size_t n = 4 * dst_width * dst_height;
+    if ((g_want_slice_u8.len < n) || (g_have_slice_u8.len < n)) {
+      RETURN_FAIL("b=%d: buffers are too short", b);
+    }
+    memcpy(g_want_slice_u8.ptr, g_have_slice_u8.ptr, n);
+
+    CHECK_STATUS("composite", wuffs_base__pixel_buffer__composite(
+                                  &dst_pixbuf, &src_pixbuf, dst_x, dst_y,
+                                  clip, blends[b]));
+
+    for (y = 0; y < dst_height; y++) {
+      uint32_t x;
+      for (x = 0; x < dst_width; x++) {
+        wuffs_base__color_u32_argb_premul want_dst_pixel =
+            wuffs_base__peek_u32le__no_bounds_check(
+                g_want_slice_u8.ptr + (4 * ((dst_width * y) + x)));
+        if ((dst_x <= x) && (x < (dst_x + src_width)) && (dst_y <= y) &&
+            (y < (dst_y + src_height)) && (y < clip.max_excl_y)) {
+          wuffs_base__color_u32_argb_premul src_pixel =
+              wuffs_base__pixel_buffer__color_u32_at(&src_pixbuf, x - dst_x,
+                                                     y - dst_y);
+          want_dst_pixel =
+              (blends[b] == WUFFS_BASE__PIXEL_BLEND__SRC)
+                  ? src_pixel
+                  : wuffs_base__composite_premul_premul_u32_axxx(
+                        want_dst_pixel, src_pixel);
+        }
+        wuffs_base__color_u32_argb_premul have_dst_pixel =
+            wuffs_base__pixel_buffer__color_u32_at(&dst_pixbuf, x, y);
+        if (have_dst_pixel != want_dst_pixel) {
+          RETURN_FAIL("b=%d, x=%" PRIu32 ", y=%" PRIu32
+                      ": dst_pixel: have 0x%08" PRIX32 ", want 0x%08" PRIX32,
+                      b, x, y, have_dst_pixel, want_dst_pixel);
+        }
+      }
+    }
+  }
+  return NULL;
+}
+
 const char*  //
 test_wuffs_pixel_swizzler_swizzle() {
   CHECK_FOCUS(__func__);
@@ -430,6 +627,110 @@ test_wuffs_pixel_swizzler_swizzle() {
   return NULL;
 }
 
+// swizzle_func is the signature of the pixel swizzler's row functions.
+typedef uint64_t (*swizzle_func)(uint8_t* dst_ptr,
+                                 size_t dst_len,
+                                 uint8_t* dst_palette_ptr,
+                                 size_t dst_palette_len,
+                                 const uint8_t* src_ptr,
+                                 size_t src_len);
+
+const char*  //
+test_wuffs_pixel_swizzler_src_over_simd() {
+  CHECK_FOCUS(__func__);
+
+  const struct {
+    swizzle_func func;
+    bool available;
+  } kernels[] = {
+      {wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over, true},
+#if defined(WUFFS_BASE__CPU_ARCH__X86_64)
+      {wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__sse42,
+       wuffs_base__cpu_arch__have_x86_sse42()},
+      {wuffs_base__pixel_swizzler__bgra_premul__bgra_premul__src_over__avx2,
+       wuffs_base__cpu_arch__have_x86_avx2()},
+#endif
+  };
+
+  const size_t max_n = 100;
+  if ((g_src_slice_u8.len < (4 * max_n)) ||
+      (g_want_slice_u8.len < (4 * (max_n + 1))) ||
+      (g_have_slice_u8.len < (4 * (max_n + 1)))) {
+    RETURN_FAIL("buffers are too short");
+  }
+
+  // Fill the src and the original dst with pseudo-random validly
+  // premultiplied colors (each color channel value is no more than the
+  // alpha value), including fully transparent and fully opaque ones.
+  uint32_t rng = 0x12345678;
+  size_t i;
+  for (i = 0; i < max_n; i++) {
+    uint32_t c[2];
+    int j;
+    for (j = 0; j < 2; j++) {
+      rng = (rng * 1664525) + 1013904223;
+      uint32_t a = rng >> 24;
+      if ((i % 7) == 0) {
+        a = (j == 0) ? 0x00 : 0xFF;
+      } else if ((i % 7) == 1) {
+        a = (j == 0) ? 0xFF : 0x00;
+      }
+      uint32_t r = (a * (0xFF & (rng >> 16))) / 0xFF;
+      uint32_t g = (a * (0xFF & (rng >> 8))) / 0xFF;
+      uint32_t b = (a * (0xFF & (rng >> 0))) / 0xFF;
+      c[j] = (a << 24) | (r << 16) | (g << 8) | b;
+    }
+    wuffs_base__poke_u32le__no_bounds_check(g_src_slice_u8.ptr + (4 * i),
+                                            c[0]);
+    wuffs_base__poke_u32le__no_bounds_check(g_want_slice_u8.ptr + (4 * i),
+                                            c[1]);
+  }
+
+  // Each kernel, for every row length (with the dst or src the shorter),
+  // gives the same result as the scalar per-pixel composite, and leaves the
+  // rest of dst untouched.
+  int k;
+  for (k = 0; k < WUFFS_TESTLIB_ARRAY_SIZE(kernels); k++) {
+    if (!kernels[k].available) {
+      continue;
+    }
+    size_t n;
+    for (n = 0; n <= max_n; n++) {
+      int longer_src;
+      for (longer_src = 0; longer_src < 2; longer_src++) {
+        memcpy(g_have_slice_u8.ptr, g_want_slice_u8.ptr, 4 * (max_n + 1));
+        size_t dst_len = 4 * (longer_src ? n : max_n);
+        size_t src_len = 4 * (longer_src ? max_n : n);
+        uint64_t have_n = (*kernels[k].func)(g_have_slice_u8.ptr, dst_len,
+                                             NULL, 0, g_src_slice_u8.ptr,
+                                             src_len);
+        if (have_n != n) {
+          RETURN_FAIL("k=%d, n=%zu, longer_src=%d: have %" PRIu64
+                      " pixels, want %zu",
+                      k, n, longer_src, have_n, n);
+        }
+        for (i = 0; i <= max_n; i++) {
+          uint32_t want = wuffs_base__peek_u32le__no_bounds_check(
+              g_want_slice_u8.ptr + (4 * i));
+          if (i < n) {
+            want = wuffs_base__composite_premul_premul_u32_axxx(
+                want, wuffs_base__peek_u32le__no_bounds_check(
+                          g_src_slice_u8.ptr + (4 * i)));
+          }
+          uint32_t have = wuffs_base__peek_u32le__no_bounds_check(
+              g_have_slice_u8.ptr + (4 * i));
+          if (have != want) {
+            RETURN_FAIL("k=%d, n=%zu, longer_src=%d, i=%zu: have 0x%08" PRIX32
+                        ", want 0x%08" PRIX32,
+                        k, n, longer_src, i, have, want);
+          }
+        }
+      }
+    }
+  }
+  return NULL;
+}
+
 // ---------------- WBMP Tests
 
 const char*  //
@@ -602,6 +903,14 @@ bench_wuffs_pixel_swizzler_bgra_nonpremul_rgba_nonpremul_src() {
                                        WUFFS_BASE__PIXEL_BLEND__SRC, 8000);
 }
 
+const char*  //
+bench_wuffs_pixel_swizzler_bgra_premul_bgra_premul_src_over() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_pixel_swizzler(WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL,
+                                       WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL,
+                                       WUFFS_BASE__PIXEL_BLEND__SRC_OVER, 1000);
+}
+
 const char*  //
 bench_wuffs_pixel_swizzler_bgra_premul_y_src() {
   CHECK_FOCUS(__func__);
@@ -658,7 +967,10 @@ proc g_tests[] = {
     // These pixel_buffer / pixel_swizzler tests are really testing the Wuffs
     // base library. They aren't specific to the std/wbmp code, but putting
     // them here is as good as any other place.
+    test_wuffs_pixel_buffer_composite,
     test_wuffs_pixel_buffer_fill_rect,
+    test_wuffs_pixel_buffer_fill_rect_simd,
+    test_wuffs_pixel_swizzler_src_over_simd,
     test_wuffs_pixel_swizzler_swizzle,
 
     test_wuffs_wbmp_decode_frame_config,
@@ -679,6 +991,7 @@ proc g_benches[] = {
     bench_wuffs_pixel_swizzler_bgr_565_rgba_nonpremul_src,
     bench_wuffs_pixel_swizzler_bgr_rgba_nonpremul_src,
     bench_wuffs_pixel_swizzler_bgra_nonpremul_rgba_nonpremul_src,
+    bench_wuffs_pixel_swizzler_bgra_premul_bgra_premul_src_over,
     bench_wuffs_pixel_swizzler_bgra_premul_y_src,
     bench_wuffs_pixel_swizzler_bgra_premul_indexed_bgra_binary_src,
     bench_wuffs_pixel_swizzler_bgra_premul_rgb_src,
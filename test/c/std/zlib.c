@@ -138,6 +138,82 @@ wuffs_zlib_decode(wuffs_base__io_buffer* dst,
   }
 }
 
+const char*  //
+wuffs_zlib_decode_two_pass(wuffs_base__io_buffer* dst,
+                           wuffs_base__io_buffer* src,
+                           uint32_t wuffs_initialize_flags,
+                           uint64_t wlimit,
+                           uint64_t rlimit) {
+  // This is like wuffs_zlib_decode (without the limits) but, instead of the
+  // zlib decoder verifying the Adler-32 checksum as it decodes, the checksum
+  // is computed afterwards, in a second pass over the entire dst. It is only
+  // for comparing benchmark numbers.
+  wuffs_zlib__decoder dec;
+  CHECK_STATUS("initialize",
+               wuffs_zlib__decoder__initialize(&dec, sizeof dec, WUFFS_VERSION,
+                                               wuffs_initialize_flags));
+  wuffs_zlib__decoder__set_quirk_enabled(
+      &dec, WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, true);
+  size_t wi0 = dst->meta.wi;
+  CHECK_STATUS("transform_io", wuffs_zlib__decoder__transform_io(
+                                   &dec, dst, src, g_work_slice_u8));
+
+  wuffs_adler32__hasher checksum;
+  CHECK_STATUS("initialize",
+               wuffs_adler32__hasher__initialize(
+                   &checksum, sizeof checksum, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  uint32_t have = wuffs_adler32__hasher__update_u32(
+      &checksum,
+      wuffs_base__make_slice_u8(dst->data.ptr + wi0, dst->meta.wi - wi0));
+  if (src->meta.ri < 4) {
+    RETURN_FAIL("src->meta.ri: have %zu, want >= 4", src->meta.ri);
+  }
+  uint32_t want =
+      wuffs_base__peek_u32be__no_bounds_check(src->data.ptr + src->meta.ri - 4);
+  if (have != want) {
+    return wuffs_zlib__error__bad_checksum;
+  }
+  return NULL;
+}
+
+// make_large_zlib sets want to n bytes (repeating test/data/pi.txt) and src
+// to their zlib encoding. That is more than the decoder's 128 KiB per call
+// limit on output that is checksummed while still in the CPU cache.
+const char*  //
+make_large_zlib(wuffs_base__io_buffer* src,
+                wuffs_base__io_buffer* want,
+                size_t n) {
+  *want = ((wuffs_base__io_buffer){
+      .data = g_want_slice_u8,
+  });
+  CHECK_STRING(read_file(want, "test/data/pi.txt"));
+  if ((want->meta.wi == 0) || (want->data.len < n)) {
+    RETURN_FAIL("make_large_zlib: bad length");
+  }
+  size_t i;
+  for (i = want->meta.wi; i < n; i++) {
+    want->data.ptr[i] = want->data.ptr[i - want->meta.wi];
+  }
+  want->meta.wi = n;
+  want->meta.closed = true;
+
+  *src = ((wuffs_base__io_buffer){
+      .data = g_src_slice_u8,
+  });
+  wuffs_zlib__encoder enc;
+  CHECK_STATUS("initialize",
+               wuffs_zlib__encoder__initialize(
+                   &enc, sizeof enc, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  wuffs_zlib__encoder__set_level(&enc, WUFFS_DEFLATE__ENCODER_LEVEL_FAST);
+  CHECK_STATUS("transform_io", wuffs_zlib__encoder__transform_io(
+                                   &enc, src, want, g_work_slice_u8));
+  want->meta.ri = 0;
+  src->meta.closed = true;
+  return NULL;
+}
+
 const char*  //
 do_test_wuffs_zlib_checksum(bool ignore_checksum, uint32_t bad_checksum) {
   wuffs_base__io_buffer have = ((wuffs_base__io_buffer){
@@ -227,6 +303,49 @@ test_wuffs_zlib_checksum_verify_good() {
   return do_test_wuffs_zlib_checksum(false, 0);
 }
 
+const char*  //
+test_wuffs_zlib_decode_large_dst() {
+  CHECK_FOCUS(__func__);
+  wuffs_base__io_buffer src;
+  wuffs_base__io_buffer want;
+  CHECK_STRING(make_large_zlib(&src, &want, (1 << 20) + 12345));
+
+  // Decode into a single dst, which takes several deflate calls (each
+  // followed by a checksum update) per transform_io call. The tc variable's
+  // values mean:
+  //  - 0: a good checksum.
+  //  - 1: a bad checksum.
+  //  - 2: a bad checksum, ignored.
+  int tc;
+  for (tc = 0; tc < 3; tc++) {
+    if (tc == 1) {
+      src.data.ptr[src.meta.wi - 1] ^= 1;
+    }
+    wuffs_zlib__decoder dec;
+    CHECK_STATUS("initialize",
+                 wuffs_zlib__decoder__initialize(
+                     &dec, sizeof dec, WUFFS_VERSION,
+                     WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+    wuffs_zlib__decoder__set_quirk_enabled(
+        &dec, WUFFS_BASE__QUIRK_IGNORE_CHECKSUM, tc == 2);
+    wuffs_base__io_buffer have = ((wuffs_base__io_buffer){
+        .data = g_have_slice_u8,
+    });
+    src.meta.ri = 0;
+    wuffs_base__status status =
+        wuffs_zlib__decoder__transform_io(&dec, &have, &src, g_work_slice_u8);
+    const char* want_z = (tc == 1) ? wuffs_zlib__error__bad_checksum : NULL;
+    if (status.repr != want_z) {
+      RETURN_FAIL("tc=%d: have \"%s\", want \"%s\"", tc, status.repr,
+                  want_z);
+    }
+    char prefix[64];
+    snprintf(prefix, 64, "tc=%d: ", tc);
+    CHECK_STRING(check_io_buffers_equal(prefix, &have, &want));
+  }
+  return NULL;
+}
+
 const char*  //
 test_wuffs_zlib_decode_midsummer() {
   CHECK_FOCUS(__func__);
@@ -234,6 +353,12 @@ test_wuffs_zlib_decode_midsummer() {
                             UINT64_MAX);
 }
 
+const char*  //
+test_wuffs_zlib_decode_midsummer_many_small_writes_reads() {
+  CHECK_FOCUS(__func__);
+  return do_test_io_buffers(wuffs_zlib_decode, &g_zlib_midsummer_gt, 100, 100);
+}
+
 const char*  //
 test_wuffs_zlib_decode_pi() {
   CHECK_FOCUS(__func__);
@@ -288,6 +413,73 @@ test_wuffs_zlib_decode_sheep() {
   return check_io_buffers_equal("", &have, &want);
 }
 
+const char*  //
+do_test_wuffs_zlib_encode(uint32_t level, uint8_t want_flg) {
+  wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+      .data = g_src_slice_u8,
+  });
+  wuffs_base__io_buffer enc = ((wuffs_base__io_buffer){
+      .data = g_want_slice_u8,
+  });
+  wuffs_base__io_buffer have = ((wuffs_base__io_buffer){
+      .data = g_have_slice_u8,
+  });
+  CHECK_STRING(read_file(&src, "test/data/pi.txt"));
+
+  wuffs_zlib__encoder encoder;
+  CHECK_STATUS("initialize",
+               wuffs_zlib__encoder__initialize(
+                   &encoder, sizeof encoder, WUFFS_VERSION,
+                   WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED));
+  wuffs_zlib__encoder__set_level(&encoder, level);
+
+  // Use small reads and writes, to exercise suspending and resuming within
+  // the header and trailer.
+  while (true) {
+    wuffs_base__io_buffer limited_enc = make_limited_writer(enc, 3);
+    wuffs_base__io_buffer limited_src = make_limited_reader(src, 5000);
+    wuffs_base__status status = wuffs_zlib__encoder__transform_io(
+        &encoder, &limited_enc, &limited_src, g_work_slice_u8);
+    enc.meta.wi += limited_enc.meta.wi;
+    src.meta.ri += limited_src.meta.ri;
+    if ((status.repr == wuffs_base__suspension__short_write) ||
+        (status.repr == wuffs_base__suspension__short_read)) {
+      continue;
+    }
+    CHECK_STATUS("transform_io", status);
+    break;
+  }
+  if ((enc.meta.wi < 2) || (enc.data.ptr[0] != 0x78) ||
+      (enc.data.ptr[1] != want_flg)) {
+    RETURN_FAIL("bad header");
+  }
+
+  src.meta.ri = 0;
+  enc.meta.closed = true;
+  CHECK_STRING(wuffs_zlib_decode(
+      &have, &enc, WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED,
+      UINT64_MAX, UINT64_MAX));
+  return check_io_buffers_equal("", &have, &src);
+}
+
+const char*  //
+test_wuffs_zlib_encode_default() {
+  CHECK_FOCUS(__func__);
+  return do_test_wuffs_zlib_encode(WUFFS_DEFLATE__ENCODER_LEVEL_DEFAULT, 0x9C);
+}
+
+const char*  //
+test_wuffs_zlib_encode_fast() {
+  CHECK_FOCUS(__func__);
+  return do_test_wuffs_zlib_encode(WUFFS_DEFLATE__ENCODER_LEVEL_FAST, 0x01);
+}
+
+const char*  //
+test_wuffs_zlib_encode_high() {
+  CHECK_FOCUS(__func__);
+  return do_test_wuffs_zlib_encode(WUFFS_DEFLATE__ENCODER_LEVEL_HIGH, 0xDA);
+}
+
 // ---------------- Mimic Tests
 
 #ifdef WUFFS_MIMIC
@@ -347,6 +539,67 @@ bench_wuffs_zlib_decode_100k() {
       tcounter_dst, &g_zlib_pi_gt, UINT64_MAX, UINT64_MAX, 30);
 }
 
+const char*  //
+bench_wuffs_zlib_decode_10k_two_pass() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(
+      wuffs_zlib_decode_two_pass,
+      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED, tcounter_dst,
+      &g_zlib_midsummer_gt, UINT64_MAX, UINT64_MAX, 300);
+}
+
+const char*  //
+bench_wuffs_zlib_decode_100k_two_pass() {
+  CHECK_FOCUS(__func__);
+  return do_bench_io_buffers(
+      wuffs_zlib_decode_two_pass,
+      WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED, tcounter_dst,
+      &g_zlib_pi_gt, UINT64_MAX, UINT64_MAX, 30);
+}
+
+const char*  //
+do_bench_wuffs_zlib_decode_large(
+    const char* (*codec_func)(wuffs_base__io_buffer*,
+                              wuffs_base__io_buffer*,
+                              uint32_t,
+                              uint64_t,
+                              uint64_t),
+    uint64_t iters_unscaled) {
+  wuffs_base__io_buffer src;
+  wuffs_base__io_buffer want;
+  CHECK_STRING(make_large_zlib(&src, &want, 8 << 20));
+  wuffs_base__io_buffer have = ((wuffs_base__io_buffer){
+      .data = g_have_slice_u8,
+  });
+
+  uint64_t iters = iters_unscaled * g_flags.iterscale;
+  uint64_t n_bytes = 0;
+  bench_start();
+  uint64_t i;
+  for (i = 0; i < iters; i++) {
+    have.meta.wi = 0;
+    src.meta.ri = 0;
+    CHECK_STRING((*codec_func)(
+        &have, &src, WUFFS_INITIALIZE__LEAVE_INTERNAL_BUFFERS_UNINITIALIZED,
+        UINT64_MAX, UINT64_MAX));
+    n_bytes += have.meta.wi;
+  }
+  bench_finish(iters, n_bytes);
+  return NULL;
+}
+
+const char*  //
+bench_wuffs_zlib_decode_8m() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_zlib_decode_large(wuffs_zlib_decode, 1);
+}
+
+const char*  //
+bench_wuffs_zlib_decode_8m_two_pass() {
+  CHECK_FOCUS(__func__);
+  return do_bench_wuffs_zlib_decode_large(wuffs_zlib_decode_two_pass, 1);
+}
+
 // ---------------- Mimic Benches
 
 #ifdef WUFFS_MIMIC
@@ -376,9 +629,14 @@ proc g_tests[] = {
     test_wuffs_zlib_checksum_verify_bad3,
     test_wuffs_zlib_checksum_verify_good,
     test_wuffs_zlib_decode_interface,
+    test_wuffs_zlib_decode_large_dst,
     test_wuffs_zlib_decode_midsummer,
+    test_wuffs_zlib_decode_midsummer_many_small_writes_reads,
     test_wuffs_zlib_decode_pi,
     test_wuffs_zlib_decode_sheep,
+    test_wuffs_zlib_encode_default,
+    test_wuffs_zlib_encode_fast,
+    test_wuffs_zlib_encode_high,
 
 #ifdef WUFFS_MIMIC
 
@@ -397,6 +655,10 @@ proc g_benches[] = {
 
     bench_wuffs_zlib_decode_10k,
     bench_wuffs_zlib_decode_100k,
+    bench_wuffs_zlib_decode_10k_two_pass,
+    bench_wuffs_zlib_decode_100k_two_pass,
+    bench_wuffs_zlib_decode_8m,
+    bench_wuffs_zlib_decode_8m_two_pass,
 
 #ifdef WUFFS_MIMIC
 
@@ -270,20 +270,21 @@ check_focus() {
 
       // See if g_proc_func_name (with or without a "test_" or "bench_" prefix)
       // starts with the [p, q) string.
-      if ((n >= q - p) && !strncmp(g_proc_func_name, p, q - p)) {
+      size_t pq = (size_t)(q - p);
+      if ((n >= pq) && !strncmp(g_proc_func_name, p, pq)) {
         return true;
       }
       const char* unprefixed_proc_func_name = NULL;
       size_t unprefixed_n = 0;
-      if ((n >= q - p) && !strncmp(g_proc_func_name, "test_", 5)) {
+      if ((n >= pq) && !strncmp(g_proc_func_name, "test_", 5)) {
         unprefixed_proc_func_name = g_proc_func_name + 5;
         unprefixed_n = n - 5;
-      } else if ((n >= q - p) && !strncmp(g_proc_func_name, "bench_", 6)) {
+      } else if ((n >= pq) && !strncmp(g_proc_func_name, "bench_", 6)) {
         unprefixed_proc_func_name = g_proc_func_name + 6;
         unprefixed_n = n - 6;
       }
-      if (unprefixed_proc_func_name && (unprefixed_n >= q - p) &&
-          !strncmp(unprefixed_proc_func_name, p, q - p)) {
+      if (unprefixed_proc_func_name && (unprefixed_n >= pq) &&
+          !strncmp(unprefixed_proc_func_name, p, pq)) {
         return true;
       }
     }
@@ -742,7 +743,8 @@ read_file_fragment(wuffs_base__io_buffer* dst,
 char*  //
 hex_dump(char* msg, wuffs_base__io_buffer* buf, size_t i) {
   if (!msg || !buf) {
-    RETURN_FAIL("hex_dump: NULL argument");
+    snprintf(g_fail_msg, sizeof(g_fail_msg), "hex_dump: NULL argument");
+    return g_fail_msg;
   }
   if (buf->meta.wi == 0) {
     return msg;
@@ -1248,6 +1250,176 @@ do_test__wuffs_base__image_decoder(
   return NULL;
 }
 
+static const char*  //
+decode_first_frame_bgra_premul(wuffs_base__image_decoder* b,
+                               const char* src_filename,
+                               wuffs_base__slice_u8 pixbuf,
+                               wuffs_base__decode_frame_options* opts,
+                               wuffs_base__pixel_config* pc,
+                               size_t* src_ri) {
+  wuffs_base__image_config ic = ((wuffs_base__image_config){});
+  wuffs_base__io_buffer src = ((wuffs_base__io_buffer){
+      .data = g_src_slice_u8,
+  });
+  CHECK_STRING(read_file(&src, src_filename));
+  CHECK_STATUS("decode_image_config",
+               wuffs_base__image_decoder__decode_image_config(b, &ic, &src));
+  uint32_t width = wuffs_base__pixel_config__width(&ic.pixcfg);
+  uint32_t height = wuffs_base__pixel_config__height(&ic.pixcfg);
+  if ((width > 16384) || (height > 16384) ||
+      ((width * height * 4) > pixbuf.len)) {
+    return "dimensions are too large";
+  }
+  uint32_t shift = wuffs_base__decode_frame_options__downscale_shift(opts);
+  if (shift > 0) {
+    width = (width + (1u << shift) - 1) >> shift;
+    height = (height + (1u << shift) - 1) >> shift;
+  }
+  wuffs_base__pixel_config__set(
+      &ic.pixcfg, WUFFS_BASE__PIXEL_FORMAT__BGRA_PREMUL,
+      WUFFS_BASE__PIXEL_SUBSAMPLING__NONE, width, height);
+
+  wuffs_base__pixel_buffer pb = ((wuffs_base__pixel_buffer){});
+  CHECK_STATUS("set_from_slice",
+               wuffs_base__pixel_buffer__set_from_slice(&pb, &ic.pixcfg,
+                                                        pixbuf));
+  CHECK_STATUS("decode_frame", wuffs_base__image_decoder__decode_frame(
+                                   b, &pb, &src, WUFFS_BASE__PIXEL_BLEND__SRC,
+                                   g_work_slice_u8, opts));
+  *pc = ic.pixcfg;
+  *src_ri = src.meta.ri;
+  return NULL;
+}
+
+// do_test__wuffs_base__image_decoder_roi decodes the first frame twice: once
+// in full by b_full and once by b_roi with a region of interest. Within the
+// ROI, the pixels should match. Outside of it, they should be untouched. It
+// sets *full_ri and *roi_ri to how far into the source each decode read.
+const char*  //
+do_test__wuffs_base__image_decoder_roi(wuffs_base__image_decoder* b_full,
+                                       wuffs_base__image_decoder* b_roi,
+                                       const char* src_filename,
+                                       wuffs_base__rect_ie_u32 roi,
+                                       size_t* full_ri,
+                                       size_t* roi_ri) {
+  wuffs_base__pixel_config want_pc = ((wuffs_base__pixel_config){});
+  memset(g_want_slice_u8.ptr, 0, g_want_slice_u8.len);
+  CHECK_STRING(decode_first_frame_bgra_premul(
+      b_full, src_filename, g_want_slice_u8, NULL, &want_pc, full_ri));
+
+  const uint8_t untouched = 0x5A;
+  wuffs_base__pixel_config have_pc = ((wuffs_base__pixel_config){});
+  wuffs_base__decode_frame_options opts =
+      ((wuffs_base__decode_frame_options){});
+  wuffs_base__decode_frame_options__set_roi(&opts, roi);
+  memset(g_pixel_slice_u8.ptr, untouched, g_pixel_slice_u8.len);
+  CHECK_STRING(decode_first_frame_bgra_premul(b_roi, src_filename,
+                                              g_pixel_slice_u8, &opts,
+                                              &have_pc, roi_ri));
+
+  uint32_t width = wuffs_base__pixel_config__width(&have_pc);
+  uint32_t height = wuffs_base__pixel_config__height(&have_pc);
+  uint32_t y;
+  for (y = 0; y < height; y++) {
+    uint32_t x;
+    for (x = 0; x < width; x++) {
+      size_t i = 4 * ((((size_t)y) * width) + x);
+      const uint8_t* have = g_pixel_slice_u8.ptr + i;
+      if (wuffs_base__rect_ie_u32__contains(&roi, x, y)) {
+        if (memcmp(have, g_want_slice_u8.ptr + i, 4)) {
+          RETURN_FAIL("pixel (%" PRIu32 ", %" PRIu32 ") differs", x, y);
+        }
+      } else if ((have[0] != untouched) || (have[1] != untouched) ||
+                 (have[2] != untouched) || (have[3] != untouched)) {
+        RETURN_FAIL("pixel (%" PRIu32 ", %" PRIu32 ") was written", x, y);
+      }
+    }
+  }
+  return NULL;
+}
+
+// do_test__wuffs_base__image_decoder_downscale decodes the first frame twice:
+// once in full by b_full and once by b_downscale with a downscale shift. Each
+// downscaled pixel should be the (rounded) average of its block of full-size
+// pixels, or of only the block's top row and/or left column when the decoder
+// samples them instead (e.g. for interlaced images).
+const char*  //
+do_test__wuffs_base__image_decoder_downscale(
+    wuffs_base__image_decoder* b_full,
+    wuffs_base__image_decoder* b_downscale,
+    const char* src_filename,
+    uint32_t shift,
+    bool top_row_only,
+    bool left_column_only) {
+  wuffs_base__pixel_config want_pc = ((wuffs_base__pixel_config){});
+  size_t want_ri = 0;
+  memset(g_want_slice_u8.ptr, 0, g_want_slice_u8.len);
+  CHECK_STRING(decode_first_frame_bgra_premul(
+      b_full, src_filename, g_want_slice_u8, NULL, &want_pc, &want_ri));
+
+  wuffs_base__pixel_config have_pc = ((wuffs_base__pixel_config){});
+  size_t have_ri = 0;
+  wuffs_base__decode_frame_options opts =
+      ((wuffs_base__decode_frame_options){});
+  wuffs_base__decode_frame_options__set_downscale_shift(&opts, shift);
+  memset(g_pixel_slice_u8.ptr, 0, g_pixel_slice_u8.len);
+  CHECK_STRING(decode_first_frame_bgra_premul(b_downscale, src_filename,
+                                              g_pixel_slice_u8, &opts,
+                                              &have_pc, &have_ri));
+
+  uint32_t full_width = wuffs_base__pixel_config__width(&want_pc);
+  uint32_t full_height = wuffs_base__pixel_config__height(&want_pc);
+  uint32_t width = wuffs_base__pixel_config__width(&have_pc);
+  uint32_t height = wuffs_base__pixel_config__height(&have_pc);
+  if ((width != ((full_width + (1u << shift) - 1) >> shift)) ||
+      (height != ((full_height + (1u << shift) - 1) >> shift))) {
+    RETURN_FAIL("dimensions: have %" PRIu32 " × %" PRIu32, width, height);
+  }
+
+  uint32_t dy;
+  for (dy = 0; dy < height; dy++) {
+    uint32_t y0 = dy << shift;
+    uint32_t y1 = top_row_only ? (y0 + 1) : (y0 + (1u << shift));
+    if (y1 > full_height) {
+      y1 = full_height;
+    }
+    uint32_t dx;
+    for (dx = 0; dx < width; dx++) {
+      uint32_t x0 = dx << shift;
+      uint32_t x1 = left_column_only ? (x0 + 1) : (x0 + (1u << shift));
+      if (x1 > full_width) {
+        x1 = full_width;
+      }
+      uint32_t sums[4] = {0};
+      uint32_t y;
+      for (y = y0; y < y1; y++) {
+        uint32_t x;
+        for (x = x0; x < x1; x++) {
+          const uint8_t* p =
+              g_want_slice_u8.ptr + (4 * ((((size_t)y) * full_width) + x));
+          sums[0] += p[0];
+          sums[1] += p[1];
+          sums[2] += p[2];
+          sums[3] += p[3];
+        }
+      }
+      uint32_t count = (x1 - x0) * (y1 - y0);
+      const uint8_t* have =
+          g_pixel_slice_u8.ptr + (4 * ((((size_t)dy) * width) + dx));
+      int c;
+      for (c = 0; c < 4; c++) {
+        uint32_t want = (sums[c] + (count / 2)) / count;
+        if (have[c] != want) {
+          RETURN_FAIL("pixel (%" PRIu32 ", %" PRIu32 ") channel %d: have "
+                      "0x%02X, want 0x%02X",
+                      dx, dy, c, have[c], want);
+        }
+      }
+    }
+  }
+  return NULL;
+}
+
 const char*  //
 do_test__wuffs_base__io_transformer(wuffs_base__io_transformer* b,
                                     const char* src_filename,